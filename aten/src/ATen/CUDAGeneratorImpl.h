@@ -7,6 +7,43 @@
 
 namespace at {
 
+/**
+ * Philox seed and offset of one kernel launch.
+ *
+ * Outside of CUDA graph capture it holds the values returned by
+ * philox_engine_inputs. While a graph is being captured, values baked into
+ * the graph would repeat the same random numbers on every replay, so the seed
+ * and the base offset are instead read on the device from tensors that
+ * CUDAGraph::replay fills before launching the graph; offset_intragraph_ is
+ * the launch's offset relative to the start of the graph. Kernels read it with
+ * at::cuda::philox::unpack (see ATen/cuda/CUDAGraphsUtils.cuh).
+ */
+struct PhiloxCudaState {
+  PhiloxCudaState() = default;
+  // Called if graph capture is not underway
+  PhiloxCudaState(uint64_t seed, uint64_t offset) {
+    seed_.val = seed;
+    offset_.val = offset;
+  }
+  // Called if graph capture is underway
+  PhiloxCudaState(int64_t* seed, int64_t* offset_extragraph, uint32_t offset_intragraph) {
+    seed_.ptr = seed;
+    offset_.ptr = offset_extragraph;
+    offset_intragraph_ = offset_intragraph;
+    captured_ = true;
+  }
+
+  union Payload {
+    uint64_t val;
+    int64_t* ptr;
+  };
+
+  Payload seed_{};
+  Payload offset_{};
+  uint32_t offset_intragraph_ = 0;
+  bool captured_ = false;
+};
+
 struct TORCH_CUDA_API CUDAGeneratorImpl : public c10::GeneratorImpl {
   // Constructors
   CUDAGeneratorImpl(DeviceIndex device_index = -1);
@@ -20,12 +57,20 @@ struct TORCH_CUDA_API CUDAGeneratorImpl : public c10::GeneratorImpl {
   void set_philox_offset_per_thread(uint64_t offset);
   uint64_t philox_offset_per_thread();
   std::pair<uint64_t, uint64_t> philox_engine_inputs(uint64_t increment);
+  PhiloxCudaState philox_cuda_state(uint64_t increment);
+  void capture_prologue(int64_t* seed_extragraph, int64_t* offset_extragraph);
+  uint64_t capture_epilogue();
   static DeviceType device_type();
 
 private:
   CUDAGeneratorImpl* clone_impl() const override;
   uint64_t seed_ = default_rng_seed_val;
   uint64_t philox_offset_per_thread_ = 0;
+  // graph capture state, see capture_prologue
+  int64_t* seed_extragraph_ = nullptr;
+  int64_t* offset_extragraph_ = nullptr;
+  uint32_t offset_intragraph_ = 0;
+  bool graph_expects_this_gen_ = false;
 };
 
 namespace cuda {
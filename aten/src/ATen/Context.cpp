@@ -59,6 +59,14 @@ void Context::setDeterministicCuDNN(bool b) {
   deterministic_cudnn = b;
 }
 
+bool Context::deterministic() const {
+  return deterministic_ops;
+}
+
+void Context::setDeterministic(bool b) {
+  deterministic_ops = b;
+}
+
 bool Context::benchmarkCuDNN() const {
   return benchmark_cudnn;
 }
@@ -106,6 +106,11 @@ class CAFFE2_API Context {
   void setBenchmarkCuDNN(bool);
   bool deterministicCuDNN() const;
   void setDeterministicCuDNN(bool);
+  // Whether operators with both a fast nondeterministic implementation and a
+  // deterministic one (e.g. atomics versus a sort-based reduction on CUDA)
+  // should use the deterministic one.
+  bool deterministic() const;
+  void setDeterministic(bool);
   at::QEngine qEngine() const;
   void setQEngine(at::QEngine e);
   const std::vector<at::QEngine>& supportedQEngines() const;
@@ -131,6 +136,7 @@ class CAFFE2_API Context {
   std::once_flag thh_init;
   bool enabled_cudnn = true;
   bool deterministic_cudnn = false;
+  bool deterministic_ops = false;
   bool benchmark_cudnn = false;
   bool enabled_mkldnn = true;
   #ifdef C10_MOBILE
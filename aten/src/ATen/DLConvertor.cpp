@@ -189,18 +189,78 @@ Tensor fromDLPack(const DLManagedTensor* src) {
   auto deleter = [src](void* self) {
     src->deleter(const_cast<DLManagedTensor*>(src));
   };
+  void* data =
+      static_cast<char*>(src->dl_tensor.data) + src->dl_tensor.byte_offset;
   if (!src->dl_tensor.strides) {
-    return at::from_blob(src->dl_tensor.data,
+    return at::from_blob(data,
         IntArrayRef(src->dl_tensor.shape, src->dl_tensor.ndim),
         deleter,
         at::device(device).dtype(stype));
   }
   return at::from_blob(
-      src->dl_tensor.data,
+      data,
       IntArrayRef(src->dl_tensor.shape, src->dl_tensor.ndim),
       IntArrayRef(src->dl_tensor.strides, src->dl_tensor.ndim),
       deleter,
       at::device(device).dtype(stype),
       { device });
 }
+
+ScalarType toScalarType(const ArrowSchema& schema) {
+  TORCH_CHECK(schema.format != nullptr, "Arrow schema without a format");
+  const std::string format = schema.format;
+  if (format == "c") {
+    return ScalarType::Char;
+  } else if (format == "C") {
+    return ScalarType::Byte;
+  } else if (format == "s") {
+    return ScalarType::Short;
+  } else if (format == "i") {
+    return ScalarType::Int;
+  } else if (format == "l") {
+    return ScalarType::Long;
+  } else if (format == "e") {
+    return ScalarType::Half;
+  } else if (format == "f") {
+    return ScalarType::Float;
+  } else if (format == "g") {
+    return ScalarType::Double;
+  }
+  // Booleans are bit-packed, and unsigned types other than uint8 have no
+  // ScalarType.
+  TORCH_CHECK(false, "Unsupported Arrow format \"", format, "\"");
+}
+
+Tensor fromArrowArray(ArrowArray* array, const ArrowSchema* schema) {
+  TORCH_CHECK(array->release != nullptr, "The Arrow array was already released");
+  ScalarType stype = toScalarType(*schema);
+  TORCH_CHECK(
+      array->n_buffers == 2 && array->n_children == 0,
+      "Expected a primitive Arrow array, with a validity and a data buffer, "
+      "but got an array with ", array->n_buffers, " buffers and ",
+      array->n_children, " children");
+  // The null count may be unknown (-1) when there is a validity bitmap.
+  TORCH_CHECK(
+      array->null_count == 0 ||
+          (array->null_count == -1 && array->buffers[0] == nullptr),
+      "Arrow arrays with nulls are not supported");
+  const char* data = static_cast<const char*>(array->buffers[1]);
+  if (data != nullptr) {
+    data += array->offset * elementSize(stype);
+  }
+
+  // Move the array, as the Arrow C data interface specifies, so that the
+  // tensor releases it.
+  auto owned = new ArrowArray(*array);
+  array->release = nullptr;
+  auto deleter = [owned](void*) {
+    owned->release(owned);
+    delete owned;
+  };
+  return at::from_blob(
+      const_cast<char*>(data),
+      {array->length},
+      deleter,
+      at::device(kCPU).dtype(stype));
+}
 } // namespace at
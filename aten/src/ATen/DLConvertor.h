@@ -2,11 +2,15 @@
 
 #include <ATen/Tensor.h>
 #include <ATen/ATen.h>
+#include <ATen/arrow_c_data.h>
 #include <ATen/dlpack.h>
 
 // this convertor will:
 // 1) take a Tensor object and wrap it in the DLPack tensor
 // 2) take a dlpack tensor and convert it to the ATen Tensor
+// 3) take an Arrow array and convert it to the ATen Tensor
+// The conversions to ATen Tensors don't copy: the tensors keep the memory of
+// the source alive until their storage is freed.
 
 namespace at {
 
@@ -16,4 +20,10 @@ CAFFE2_API Tensor fromDLPack(const DLManagedTensor* src);
 CAFFE2_API DLDataType getDLDataType(const Tensor& t);
 CAFFE2_API DLContext getDLContext(const Tensor& tensor, const int64_t& device_id);
 
+// Returns a 1-D CPU tensor with the data buffer of a primitive Arrow array
+// without nulls, described by schema. The tensor takes ownership of the
+// array, leaving *array released; the schema stays with the caller.
+CAFFE2_API ScalarType toScalarType(const ArrowSchema& schema);
+CAFFE2_API Tensor fromArrowArray(ArrowArray* array, const ArrowSchema* schema);
+
 } //namespace at
@@ -3,6 +3,9 @@
 #include <ATen/core/ivalue.h>
 #include <c10/macros/Macros.h>
 
+#include <algorithm>
+#include <atomic>
+
 namespace at {
 namespace internal {
 // This parameter is heuristically chosen to determine the minimum number of
@@ -11,6 +14,53 @@ namespace internal {
 // no parallel algorithm (such as parallel_reduce) should split work into
 // smaller than GRAIN_SIZE chunks.
 constexpr int64_t GRAIN_SIZE = 32768;
+
+// Grain size for an element-wise operation whose per-element work is about
+// `cost` times that of a simple arithmetic op (e.g. ~10 for transcendental
+// functions, more for special functions such as digamma). Expensive ops
+// reach the point where parallelism pays off with fewer elements.
+inline int64_t grain_size_for_cost(int64_t cost) {
+  return cost > 1 ? std::max<int64_t>(GRAIN_SIZE / cost, 1) : GRAIN_SIZE;
+}
+
+// Parallel reductions split their input into chunks whose boundaries only
+// depend on the number of elements: at most MAX_REDUCTION_CHUNKS chunks,
+// each of at least GRAIN_SIZE elements. The chunk results are combined in
+// chunk order, so that the result is the same for any number of threads.
+constexpr int64_t MAX_REDUCTION_CHUNKS = 256;
+
+inline int64_t reduction_chunk_size(int64_t numel) {
+  return std::max<int64_t>(
+      GRAIN_SIZE, (numel + MAX_REDUCTION_CHUNKS - 1) / MAX_REDUCTION_CHUNKS);
+}
+
+// Learns a grain size for one operation from the time its first invocations
+// take per element. The grain size is chosen so that a chunk takes about
+// kTargetChunkNs, which keeps cheap ops on small tensors single-threaded
+// (waking up the pool costs more than the work) and lets expensive ops be
+// split over all threads. An estimator is meant to be a function-local
+// static shared by every call of one kernel; updates are racy but benign.
+class CAFFE2_API GrainSizeEstimator {
+ public:
+  // Number of timed invocations the estimate is based on.
+  static constexpr int kNumSamples = 4;
+  // Invocations with fewer elements than this are not timed.
+  static constexpr int64_t kMinSampleSize = 1024;
+  // Target duration of one parallel chunk, in nanoseconds.
+  static constexpr int64_t kTargetChunkNs = 10000;
+
+  // Returns the learned grain size, or 0 while still sampling.
+  int64_t grain_size() const;
+
+  // Records that processing `numel` elements took `elapsed_ns`.
+  void record(int64_t numel, int64_t elapsed_ns);
+
+ private:
+  std::atomic<int> num_samples_{0};
+  std::atomic<int64_t> total_numel_{0};
+  std::atomic<int64_t> total_ns_{0};
+};
+
 } // namespace internal
 
 inline int64_t divup(int64_t x, int64_t y) {
@@ -33,6 +83,14 @@ CAFFE2_API int get_thread_num();
 // Checks whether the code runs in parallel region
 CAFFE2_API bool in_parallel_region();
 
+// Enables or disables adaptive grain sizes for element-wise CPU kernels
+// (see internal::GrainSizeEstimator). Disabled by default, can also be
+// enabled by setting ATEN_ADAPTIVE_GRAIN_SIZE=1.
+CAFFE2_API void set_adaptive_grain_size(bool enabled);
+
+// Returns whether adaptive grain sizes are enabled
+CAFFE2_API bool get_adaptive_grain_size();
+
 namespace internal {
 
 // Initialise num_threads lazily at first parallel call
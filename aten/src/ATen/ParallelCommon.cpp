@@ -4,6 +4,8 @@
 #include <ATen/PTThreadPool.h>
 #include <ATen/Version.h>
 
+#include <algorithm>
+#include <atomic>
 #include <sstream>
 #include <thread>
 
@@ -40,8 +42,51 @@ size_t get_env_num_threads(const char* var_name, size_t def_value = 0) {
   return def_value;
 }
 
+std::atomic<bool>& adaptive_grain_size_flag() {
+  static std::atomic<bool> enabled([]() {
+    const char* value = std::getenv("ATEN_ADAPTIVE_GRAIN_SIZE");
+    return value && std::string(value) == "1";
+  }());
+  return enabled;
+}
+
 } // namespace
 
+void set_adaptive_grain_size(bool enabled) {
+  adaptive_grain_size_flag() = enabled;
+}
+
+bool get_adaptive_grain_size() {
+  return adaptive_grain_size_flag();
+}
+
+namespace internal {
+
+int64_t GrainSizeEstimator::grain_size() const {
+  if (num_samples_.load(std::memory_order_relaxed) < kNumSamples) {
+    return 0;
+  }
+  const int64_t numel = total_numel_.load(std::memory_order_relaxed);
+  const int64_t ns = std::max<int64_t>(total_ns_.load(std::memory_order_relaxed), 1);
+  // Number of elements that take kTargetChunkNs, capped so that very cheap
+  // ops still get split on large tensors.
+  const double grain = static_cast<double>(numel) * kTargetChunkNs / ns;
+  return static_cast<int64_t>(
+      std::max(std::min(grain, static_cast<double>(GRAIN_SIZE * 16)), 1.0));
+}
+
+void GrainSizeEstimator::record(int64_t numel, int64_t elapsed_ns) {
+  if (numel < kMinSampleSize ||
+      num_samples_.load(std::memory_order_relaxed) >= kNumSamples) {
+    return;
+  }
+  total_numel_ += numel;
+  total_ns_ += elapsed_ns;
+  ++num_samples_;
+}
+
+} // namespace internal
+
 std::string get_parallel_info() {
   std::ostringstream ss;
 
@@ -70,6 +115,10 @@ std::string get_parallel_info() {
      << get_env_var("OMP_NUM_THREADS", "[not set]") << std::endl;
   ss << "\tMKL_NUM_THREADS : "
      << get_env_var("MKL_NUM_THREADS", "[not set]") << std::endl;
+  ss << "\tTORCH_INTRAOP_POOL : "
+     << get_env_var("TORCH_INTRAOP_POOL", "[not set]") << std::endl;
+  ss << "\tATEN_ADAPTIVE_GRAIN_SIZE : "
+     << get_env_var("ATEN_ADAPTIVE_GRAIN_SIZE", "[not set]") << std::endl;
 
   ss << "ATen parallel backend: ";
   #if AT_PARALLEL_OPENMP
@@ -3,13 +3,19 @@
 #include <ATen/PTThreadPool.h>
 
 #ifndef C10_MOBILE
+#include <c10/core/WorkStealingThreadPool.h>
 #include <c10/core/thread_pool.h>
+#include <c10/util/numa.h>
 #else
 #include <caffe2/utils/threadpool/ThreadPool.h>
 #include <caffe2/utils/threadpool/ThreadPoolMobile.h>
 #endif // C10_MOBILE
 
 #include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -65,24 +71,126 @@ int _num_pool_threads(int nthreads) {
   return nthreads - 1;
 }
 
+// Intra-op pool used in NUMA mode (see c10::IsNUMAEnabled): one sub-pool
+// per NUMA node, with the workers of each sub-pool bound to their node.
+// Task i of a parallel region runs on node GetNUMANodeForWorker(i, num_tasks),
+// so contiguous chunks of the iteration space stay on the same socket.
+class NUMAThreadPool : public TaskThreadPoolBase {
+ public:
+  NUMAThreadPool(size_t pool_size, size_t num_nodes) {
+    num_nodes = std::min(num_nodes, pool_size);
+    for (size_t node = 0; node < num_nodes; ++node) {
+      size_t begin = pool_size * node / num_nodes;
+      size_t end = pool_size * (node + 1) / num_nodes;
+      pools_.emplace_back(
+          std::make_unique<PTThreadPool>(end - begin, node));
+    }
+  }
+
+  void run(std::function<void()> func) override {
+    size_t next = next_pool_.fetch_add(1, std::memory_order_relaxed);
+    pools_[next % pools_.size()]->run(std::move(func));
+  }
+
+  void runOnNode(int numa_node_id, std::function<void()> func) {
+    if (numa_node_id < 0) {
+      run(std::move(func));
+    } else {
+      pools_[numa_node_id % pools_.size()]->run(std::move(func));
+    }
+  }
+
+  size_t size() const override {
+    size_t total = 0;
+    for (const auto& pool : pools_) {
+      total += pool->size();
+    }
+    return total;
+  }
+
+  size_t numAvailable() const override {
+    size_t total = 0;
+    for (const auto& pool : pools_) {
+      total += pool->numAvailable();
+    }
+    return total;
+  }
+
+  bool inThreadPool() const override {
+    for (const auto& pool : pools_) {
+      if (pool->inThreadPool()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  std::vector<std::unique_ptr<PTThreadPool>> pools_;
+  std::atomic<size_t> next_pool_{0};
+};
+
+// TORCH_INTRAOP_POOL=work_stealing selects c10::WorkStealingThreadPool as
+// the intra-op pool, which scales better than the single-queue
+// c10::ThreadPool with many cores and fine-grained parallel_for chunks.
+bool _use_work_stealing_pool() {
+  const char* value = std::getenv("TORCH_INTRAOP_POOL");
+  return value && std::strcmp(value, "work_stealing") == 0;
+}
+
+std::shared_ptr<TaskThreadPoolBase> _create_intraop_pool() {
+  int pool_size = _num_pool_threads(num_intraop_threads.exchange(CONSUMED));
+  int num_nodes = c10::GetNumNUMANodes();
+  if (c10::IsNUMAEnabled() && num_nodes > 1 && pool_size > 1) {
+    return std::make_shared<NUMAThreadPool>(pool_size, num_nodes);
+  }
+  if (_use_work_stealing_pool()) {
+    return std::make_shared<c10::WorkStealingThreadPool>(
+        pool_size, /* numa_node_id */ -1, []() {
+          c10::setThreadName("PTThreadPool");
+          at::init_num_threads();
+        });
+  }
+  return ThreadPoolRegistry()->Create(
+      "C10",
+      /* device_id */ 0,
+      /* pool_size */ pool_size,
+      /* create_new */ true); // create a separate thread pool for intra-op
+}
+
 TaskThreadPoolBase& _get_intraop_pool() {
-  static std::shared_ptr<TaskThreadPoolBase> pool =
-      ThreadPoolRegistry()->Create(
-          "C10",
-          /* device_id */ 0,
-          /* pool_size */ _num_pool_threads(num_intraop_threads.exchange(CONSUMED)),
-          /* create_new */ true); // create a separate thread pool for intra-op
+  static std::shared_ptr<TaskThreadPoolBase> pool = _create_intraop_pool();
   return *pool;
 }
 
+// Returns the intra-op pool if it is partitioned by NUMA node, or nullptr.
+NUMAThreadPool* _get_numa_intraop_pool() {
+  static NUMAThreadPool* pool =
+      dynamic_cast<NUMAThreadPool*>(&_get_intraop_pool());
+  return pool;
+}
+
+// Returns the intra-op pool if it is work-stealing, or nullptr.
+c10::WorkStealingThreadPool* _get_work_stealing_intraop_pool() {
+  static c10::WorkStealingThreadPool* pool =
+      dynamic_cast<c10::WorkStealingThreadPool*>(&_get_intraop_pool());
+  return pool;
+}
+
 #endif // C10_MOBILE
 
 // Run lambda function `fn` over `task_id` in [0, `range`) with threadpool.
 // `fn` will be called with params: (thread_pool_task_id, task_id).
 void _run_with_pool(const std::function<void(int, size_t)>& fn, size_t range) {
 #ifndef C10_MOBILE
+  NUMAThreadPool* numa_pool = _get_numa_intraop_pool();
   for (size_t i = 1; i < range; ++i) {
-    _get_intraop_pool().run([fn, i]() { fn((int)i, i); });
+    if (numa_pool) {
+      numa_pool->runOnNode(
+          c10::GetNUMANodeForWorker(i, range), [fn, i]() { fn((int)i, i); });
+    } else {
+      _get_intraop_pool().run([fn, i]() { fn((int)i, i); });
+    }
   }
   // Run the first task on the current thread directly.
   fn(0, 0);
@@ -160,11 +268,16 @@ void _parallel_run(
   _run_with_pool(task, num_tasks);
 
   // Wait for all tasks to finish.
+#ifndef C10_MOBILE
+  // With a work-stealing pool, help with queued tasks instead of blocking.
+  if (auto* pool = _get_work_stealing_intraop_pool()) {
+    while (state.remaining != 0 && pool->runPendingTask()) {
+    }
+  }
+#endif // C10_MOBILE
   {
     std::unique_lock<std::mutex> lk(state.mutex);
-    if (state.remaining != 0) {
-      state.cv.wait(lk);
-    }
+    state.cv.wait(lk, [&state]() { return state.remaining == 0; });
   }
   if (state.eptr) {
     std::rethrow_exception(state.eptr);
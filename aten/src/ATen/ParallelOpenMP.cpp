@@ -1,5 +1,6 @@
 #if AT_PARALLEL_OPENMP
 #include <ATen/Parallel.h>
+#include <c10/util/numa.h>
 
 #include <atomic>
 
@@ -13,6 +14,25 @@ namespace {
 // Number of threads set by the user
 std::atomic<int> num_threads{-1};
 
+// In NUMA mode (see c10::IsNUMAEnabled), bind the OpenMP workers to NUMA
+// nodes, splitting the team into contiguous groups, one per node, to match
+// the static schedule used by parallel_for. The master thread keeps its
+// affinity.
+void bind_threads_to_numa_nodes() {
+#ifdef _OPENMP
+  if (!c10::IsNUMAEnabled()) {
+    return;
+  }
+#pragma omp parallel
+  {
+    int tid = omp_get_thread_num();
+    if (tid != 0) {
+      c10::NUMABind(c10::GetNUMANodeForWorker(tid, omp_get_num_threads()));
+    }
+  }
+#endif
+}
+
 } // namespace
 
 void init_num_threads() {
@@ -29,6 +49,7 @@ void init_num_threads() {
 #elif defined(_OPENMP)
     omp_set_num_threads(intraop_default_num_threads());
 #endif
+    bind_threads_to_numa_nodes();
   }
 }
 
@@ -48,6 +69,7 @@ void set_num_threads(int nthreads) {
   // See https://github.com/pytorch/pytorch/issues/13757
   mkl_set_dynamic(false);
 #endif
+  bind_threads_to_numa_nodes();
 }
 
 // Explicitly calling omp_get_max_threads() as the size of the parallel
@@ -6,32 +6,78 @@
 
 namespace at {
 
-ThreadLocalState::ThreadLocalState(bool keep_grad_mode)
+ThreadLocalState::Snapshot::Snapshot()
     : dispatch_key_(c10::impl::tls_local_dispatch_key_set()),
-      debug_info_(c10::ThreadLocalDebugInfo::current()) {
-  callbacks_ = _getTLSCallbacks();
+      debug_info_(c10::ThreadLocalDebugInfo::current()),
+      callbacks_(_getTLSCallbacks()),
+      inference_mode_enabled_(c10::InferenceMode::is_enabled()) {
 #if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
-  keep_grad_mode_ = keep_grad_mode;
-  if (keep_grad_mode_) {
-    grad_mode_enabled_ = GradMode::is_enabled();
+  grad_mode_enabled_ = GradMode::is_enabled();
+#endif
+}
+
+bool ThreadLocalState::Snapshot::isCurrent() const {
+  auto dispatch_key = c10::impl::tls_local_dispatch_key_set();
+  return dispatch_key.included_ == dispatch_key_.included_ &&
+      dispatch_key.excluded_ == dispatch_key_.excluded_ &&
+      c10::ThreadLocalDebugInfo::current() == debug_info_ &&
+      _getTLSCallbacks() == callbacks_ &&
+      c10::InferenceMode::is_enabled() == inference_mode_enabled_
+#if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
+      && GradMode::is_enabled() == grad_mode_enabled_
+#endif
+      ;
+}
+
+/* static */
+std::weak_ptr<const ThreadLocalState::Snapshot>& ThreadLocalState::
+    lastSnapshot() {
+  // weak, so that the debug info and callbacks are released once no state
+  // uses them
+  static thread_local std::weak_ptr<const Snapshot> snapshot;
+  return snapshot;
+}
+
+/* static */
+std::shared_ptr<const ThreadLocalState::Snapshot> ThreadLocalState::
+    currentSnapshot() {
+  auto& last = lastSnapshot();
+  auto snapshot = last.lock();
+  if (!snapshot || !snapshot->isCurrent()) {
+    snapshot = std::make_shared<const Snapshot>();
+    last = snapshot;
   }
+  return snapshot;
+}
+
+ThreadLocalState::ThreadLocalState(bool keep_grad_mode)
+    : snapshot_(currentSnapshot()) {
+#if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
+  keep_grad_mode_ = keep_grad_mode;
 #endif
 }
 
 /* static */
 void ThreadLocalState::setThreadLocalState(
     const ThreadLocalState& state) {
+  const auto& snapshot = *state.snapshot_;
 #if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
   if (state.keep_grad_mode_) {
-    GradMode::set_enabled(state.grad_mode_enabled_);
+    GradMode::set_enabled(snapshot.grad_mode_enabled_);
   }
 #endif
 
-  _setTLSCallbacks(state.callbacks_);
+  _setTLSCallbacks(snapshot.callbacks_);
+
+  c10::InferenceMode::set_enabled(snapshot.inference_mode_enabled_);
+
+  c10::ThreadLocalDebugInfo::_forceCurrentDebugInfo(snapshot.debug_info_);
 
-  c10::ThreadLocalDebugInfo::_forceCurrentDebugInfo(state.debug_info_);
+  c10::impl::_force_tls_local_dispatch_key_set(snapshot.dispatch_key_);
 
-  c10::impl::_force_tls_local_dispatch_key_set(state.dispatch_key_);
+  // States taken by the tasks run from here share the snapshot; it is
+  // checked again before being reused, since grad mode may not have been set
+  lastSnapshot() = state.snapshot_;
 }
 
 } // namespace at
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <c10/core/InferenceMode.h>
 #include <c10/core/impl/LocalDispatchKeySet.h>
 #include <c10/util/Exception.h>
 #include <c10/util/ThreadLocalDebugInfo.h>
@@ -24,18 +25,44 @@ class TORCH_API ThreadLocalState {
   static void setThreadLocalState(const ThreadLocalState& state);
 
  private:
-  c10::impl::LocalDispatchKeySet dispatch_key_;
+  // The values of the propagated thread local variables. Snapshots are
+  // immutable and shared by the states taken while the variables keep the
+  // same values, so that taking, copying and passing a state to a task costs
+  // a reference count increment.
+  struct Snapshot {
+    c10::impl::LocalDispatchKeySet dispatch_key_;
 
-  // ThreadLocalDebugInfo does not change after being created
-  // with DebugInfoGuard
-  std::shared_ptr<c10::ThreadLocalDebugInfo> debug_info_;
+    // ThreadLocalDebugInfo does not change after being created
+    // with DebugInfoGuard
+    std::shared_ptr<c10::ThreadLocalDebugInfo> debug_info_;
 
-  // RecordFunction TLS callbacks
-  RecordFunctionCallbacks callbacks_;
+    // RecordFunction TLS callbacks
+    std::shared_ptr<const RecordFunctionCallbacks> callbacks_;
+
+    bool inference_mode_enabled_;
+
+#if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
+    bool grad_mode_enabled_;
+#endif
+
+    // Takes the values of the current thread
+    Snapshot();
+
+    // Whether the current thread's values are the same
+    bool isCurrent() const;
+  };
+
+  // The snapshot last taken or set by the current thread
+  static std::weak_ptr<const Snapshot>& lastSnapshot();
+
+  // Returns the last snapshot of the current thread if it is still current,
+  // or a new one
+  static std::shared_ptr<const Snapshot> currentSnapshot();
+
+  std::shared_ptr<const Snapshot> snapshot_;
 
 #if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
   bool keep_grad_mode_ = true;
-  bool grad_mode_enabled_;
 #endif
 
   friend class ThreadLocalStateGuard;
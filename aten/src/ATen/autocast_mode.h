@@ -5,7 +5,11 @@ namespace autocast {
 
 TORCH_API bool is_enabled();
 TORCH_API void set_enabled(bool enabled);
+TORCH_API bool is_cpu_enabled();
+TORCH_API void set_cpu_enabled(bool enabled);
 TORCH_API void clear_cache();
+// Drops the cached casts whose source tensor was freed or modified in place.
+TORCH_API void prune_cache();
 TORCH_API int increment_nesting();
 TORCH_API int decrement_nesting();
 
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helpers shared by the CPU kernel benchmarks in this directory.
+//
+// Every benchmark calls an ATen op on inputs (and, where the op has one, an
+// out= tensor) that are created before the timed loop, so that for all but
+// the smallest sizes the time is the time of the kernel. The arguments of a
+// run are (sizes..., dtype, layout, threads), with dtype an index into the
+// list of dtypes of the benchmark and layout a Layout; the label of the run
+// spells them out. Run with --benchmark_format=json (or --benchmark_out=<file>
+// --benchmark_out_format=json) for results that can be compared across
+// builds, e.g. with tools/compare.py of google benchmark.
+
+namespace at {
+namespace benchmarks {
+
+enum class Layout : int64_t {
+  Contiguous = 0,
+  // the dimensions of a contiguous tensor in reverse order
+  Transposed = 1,
+  // every other element along the last dimension of a contiguous tensor
+  Strided = 2,
+  // channels last, only for 4d sizes
+  ChannelsLast = 3,
+};
+
+inline const char* layout_name(Layout layout) {
+  switch (layout) {
+    case Layout::Contiguous:
+      return "contiguous";
+    case Layout::Transposed:
+      return "transposed";
+    case Layout::Strided:
+      return "strided";
+    case Layout::ChannelsLast:
+      return "channels_last";
+  }
+  return "unknown";
+}
+
+// A tensor of the given sizes, dtype and layout, with values uniform in
+// [0, 1) for floating types and in [0, 100) otherwise.
+inline Tensor make_input(IntArrayRef sizes, ScalarType dtype, Layout layout) {
+  auto options = at::dtype(dtype);
+  std::vector<int64_t> shape(sizes.begin(), sizes.end());
+  Tensor t;
+  switch (layout) {
+    case Layout::Contiguous:
+      t = at::empty(shape, options);
+      break;
+    case Layout::Transposed: {
+      std::vector<int64_t> reversed(shape.rbegin(), shape.rend());
+      std::vector<int64_t> dims(shape.size());
+      for (size_t i = 0; i < dims.size(); i++) {
+        dims[i] = dims.size() - 1 - i;
+      }
+      t = at::empty(reversed, options).permute(dims);
+      break;
+    }
+    case Layout::Strided: {
+      std::vector<int64_t> wide = shape;
+      wide.back() *= 2;
+      t = at::empty(wide, options).slice(-1, 0, wide.back(), 2);
+      break;
+    }
+    case Layout::ChannelsLast:
+      TORCH_CHECK(shape.size() == 4, "channels last needs 4d sizes");
+      t = at::empty(shape, options.memory_format(MemoryFormat::ChannelsLast));
+      break;
+  }
+  if (isFloatingType(dtype)) {
+    t.uniform_(0, 1);
+  } else {
+    t.random_(0, 100);
+  }
+  return t;
+}
+
+inline int64_t max_threads() {
+  return std::max<int64_t>(1, std::thread::hardware_concurrency());
+}
+
+// Sets the number of intra-op threads of a run. The native parallel backend
+// cannot change it after parallel work has started, in which case the run is
+// skipped; run a benchmark binary with --benchmark_filter=.../<threads>$ to get
+// a given thread count there.
+inline bool set_num_threads(benchmark::State& state, int64_t threads) {
+  at::set_num_threads(threads);
+  if (at::get_num_threads() != threads) {
+    state.SkipWithError("cannot change the number of intra-op threads");
+    return false;
+  }
+  return true;
+}
+
+inline void set_label(
+    benchmark::State& state,
+    ScalarType dtype,
+    Layout layout,
+    int64_t threads) {
+  state.SetLabel(
+      std::string(toString(dtype)) + "/" + layout_name(layout) + "/" +
+      std::to_string(threads) + "_threads");
+}
+
+// Registers the runs of `b` for every combination of `sizes`, the first
+// `num_dtypes` dtypes, `layouts`, and a single thread and all threads. The
+// time is wall time, as the work of a run is spread over the threads.
+inline void add_runs(
+    benchmark::internal::Benchmark* b,
+    const std::vector<std::vector<int64_t>>& sizes,
+    size_t num_dtypes,
+    const std::vector<Layout>& layouts) {
+  std::vector<int64_t> threads = {1};
+  if (max_threads() > 1) {
+    threads.push_back(max_threads());
+  }
+  for (const auto& size : sizes) {
+    for (size_t dtype = 0; dtype < num_dtypes; dtype++) {
+      for (auto layout : layouts) {
+        for (auto num_threads : threads) {
+          std::vector<int64_t> args = size;
+          args.push_back(dtype);
+          args.push_back(static_cast<int64_t>(layout));
+          args.push_back(num_threads);
+          b->Args(args);
+        }
+      }
+    }
+  }
+  b->UseRealTime();
+}
+
+// Reads the (sizes..., dtype, layout, threads) arguments of a run with
+// `num_sizes` sizes.
+struct RunArgs {
+  RunArgs(
+      benchmark::State& state,
+      size_t num_sizes,
+      const std::vector<ScalarType>& dtypes) {
+    for (size_t i = 0; i < num_sizes; i++) {
+      sizes.push_back(state.range(i));
+    }
+    dtype = dtypes.at(state.range(num_sizes));
+    layout = static_cast<Layout>(state.range(num_sizes + 1));
+    threads = state.range(num_sizes + 2);
+  }
+
+  std::vector<int64_t> sizes;
+  ScalarType dtype;
+  Layout layout;
+  int64_t threads;
+};
+
+} // namespace benchmarks
+} // namespace at
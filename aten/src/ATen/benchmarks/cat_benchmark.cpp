@@ -0,0 +1,50 @@
+#include <ATen/benchmarks/benchmark_utils.h>
+
+// cat of equally sized inputs. The sizes of a run are (number of inputs,
+// rows, columns, dimension to concatenate along).
+
+using namespace at::benchmarks;
+
+namespace {
+
+const std::vector<at::ScalarType> kDtypes = {at::kFloat, at::kHalf};
+const std::vector<Layout> kLayouts = {Layout::Contiguous, Layout::Transposed};
+
+void cat(benchmark::State& state) {
+  RunArgs args(state, 4, kDtypes);
+  if (!set_num_threads(state, args.threads)) {
+    return;
+  }
+  set_label(state, args.dtype, args.layout, args.threads);
+  const int64_t num_inputs = args.sizes[0];
+  const int64_t dim = args.sizes[3];
+  std::vector<at::Tensor> inputs;
+  for (int64_t i = 0; i < num_inputs; i++) {
+    inputs.push_back(
+        make_input({args.sizes[1], args.sizes[2]}, args.dtype, args.layout));
+  }
+  std::vector<int64_t> out_sizes = {args.sizes[1], args.sizes[2]};
+  out_sizes[dim] *= num_inputs;
+  auto out = at::empty(out_sizes, at::dtype(args.dtype));
+  for (auto _ : state) {
+    at::cat_out(out, inputs, dim);
+  }
+  state.SetItemsProcessed(state.iterations() * out.numel());
+  state.SetBytesProcessed(
+      state.iterations() * out.numel() * out.element_size() * 2);
+}
+
+BENCHMARK(cat)->Apply([](benchmark::internal::Benchmark* b) {
+  add_runs(
+      b,
+      {{2, 1024, 1024, 0},
+       {2, 1024, 1024, 1},
+       {64, 128, 128, 0},
+       {64, 128, 128, 1},
+       {1024, 16, 16, 1}},
+      kDtypes.size(), kLayouts);
+});
+
+} // namespace
+
+BENCHMARK_MAIN();
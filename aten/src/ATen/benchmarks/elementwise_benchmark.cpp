@@ -0,0 +1,168 @@
+#include <ATen/benchmarks/benchmark_utils.h>
+
+// Unary and binary pointwise ops, and copies between layouts and dtypes.
+
+using namespace at::benchmarks;
+
+namespace {
+
+const std::vector<at::ScalarType> kDtypes = {
+    at::kFloat, at::kDouble, at::kHalf, at::kBFloat16};
+const std::vector<std::vector<int64_t>> kSizes = {
+    {64, 64}, {1024, 1024}, {4096, 4096}};
+const std::vector<Layout> kLayouts = {
+    Layout::Contiguous, Layout::Transposed, Layout::Strided};
+
+void add_elementwise_runs(benchmark::internal::Benchmark* b) {
+  add_runs(b, kSizes, kDtypes.size(), kLayouts);
+}
+
+void set_processed(benchmark::State& state, const at::Tensor& t, int64_t tensors) {
+  state.SetItemsProcessed(state.iterations() * t.numel());
+  state.SetBytesProcessed(
+      state.iterations() * t.numel() * t.element_size() * tensors);
+}
+
+template <at::Tensor& (*op)(at::Tensor&, const at::Tensor&)>
+void unary(benchmark::State& state) {
+  RunArgs args(state, 2, kDtypes);
+  if (!set_num_threads(state, args.threads)) {
+    return;
+  }
+  set_label(state, args.dtype, args.layout, args.threads);
+  auto self = make_input(args.sizes, args.dtype, args.layout);
+  auto out = at::empty_like(self);
+  for (auto _ : state) {
+    op(out, self);
+  }
+  set_processed(state, self, 2);
+}
+
+at::Tensor& exp_out(at::Tensor& out, const at::Tensor& self) {
+  return at::exp_out(out, self);
+}
+at::Tensor& sigmoid_out(at::Tensor& out, const at::Tensor& self) {
+  return at::sigmoid_out(out, self);
+}
+at::Tensor& tanh_out(at::Tensor& out, const at::Tensor& self) {
+  return at::tanh_out(out, self);
+}
+at::Tensor& abs_out(at::Tensor& out, const at::Tensor& self) {
+  return at::abs_out(out, self);
+}
+
+BENCHMARK_TEMPLATE(unary, exp_out)->Apply(add_elementwise_runs);
+BENCHMARK_TEMPLATE(unary, sigmoid_out)->Apply(add_elementwise_runs);
+BENCHMARK_TEMPLATE(unary, tanh_out)->Apply(add_elementwise_runs);
+BENCHMARK_TEMPLATE(unary, abs_out)->Apply(add_elementwise_runs);
+
+template <at::Tensor& (*op)(at::Tensor&, const at::Tensor&, const at::Tensor&)>
+void binary(benchmark::State& state) {
+  RunArgs args(state, 2, kDtypes);
+  if (!set_num_threads(state, args.threads)) {
+    return;
+  }
+  set_label(state, args.dtype, args.layout, args.threads);
+  auto self = make_input(args.sizes, args.dtype, args.layout);
+  auto other = make_input(args.sizes, args.dtype, args.layout);
+  auto out = at::empty_like(self);
+  for (auto _ : state) {
+    op(out, self, other);
+  }
+  set_processed(state, self, 3);
+}
+
+// The second operand is a row, broadcast along the first dimension.
+template <at::Tensor& (*op)(at::Tensor&, const at::Tensor&, const at::Tensor&)>
+void binary_broadcast(benchmark::State& state) {
+  RunArgs args(state, 2, kDtypes);
+  if (!set_num_threads(state, args.threads)) {
+    return;
+  }
+  set_label(state, args.dtype, args.layout, args.threads);
+  auto self = make_input(args.sizes, args.dtype, args.layout);
+  auto other = make_input({args.sizes[1]}, args.dtype, Layout::Contiguous);
+  auto out = at::empty_like(self);
+  for (auto _ : state) {
+    op(out, self, other);
+  }
+  set_processed(state, self, 2);
+}
+
+at::Tensor& add_out(at::Tensor& out, const at::Tensor& self, const at::Tensor& other) {
+  return at::add_out(out, self, other);
+}
+at::Tensor& mul_out(at::Tensor& out, const at::Tensor& self, const at::Tensor& other) {
+  return at::mul_out(out, self, other);
+}
+at::Tensor& div_out(at::Tensor& out, const at::Tensor& self, const at::Tensor& other) {
+  return at::div_out(out, self, other);
+}
+
+BENCHMARK_TEMPLATE(binary, add_out)->Apply(add_elementwise_runs);
+BENCHMARK_TEMPLATE(binary, mul_out)->Apply(add_elementwise_runs);
+BENCHMARK_TEMPLATE(binary, div_out)->Apply(add_elementwise_runs);
+BENCHMARK_TEMPLATE(binary_broadcast, add_out)->Apply(add_elementwise_runs);
+BENCHMARK_TEMPLATE(binary_broadcast, mul_out)->Apply(add_elementwise_runs);
+
+// Copies the input of the given layout into a contiguous tensor.
+void copy(benchmark::State& state) {
+  RunArgs args(state, 2, kDtypes);
+  if (!set_num_threads(state, args.threads)) {
+    return;
+  }
+  set_label(state, args.dtype, args.layout, args.threads);
+  auto self = make_input(args.sizes, args.dtype, args.layout);
+  auto out = at::empty(args.sizes, self.options());
+  for (auto _ : state) {
+    out.copy_(self);
+  }
+  set_processed(state, self, 2);
+}
+
+BENCHMARK(copy)->Apply(add_elementwise_runs);
+
+// Copies between channels first and channels last 4d tensors.
+void copy_channels_last(benchmark::State& state) {
+  RunArgs args(state, 4, kDtypes);
+  if (!set_num_threads(state, args.threads)) {
+    return;
+  }
+  set_label(state, args.dtype, args.layout, args.threads);
+  auto self = make_input(args.sizes, args.dtype, args.layout);
+  auto out = at::empty(args.sizes, self.options());
+  for (auto _ : state) {
+    out.copy_(self);
+  }
+  set_processed(state, self, 2);
+}
+
+BENCHMARK(copy_channels_last)->Apply([](benchmark::internal::Benchmark* b) {
+  add_runs(
+      b, {{8, 64, 56, 56}, {32, 256, 14, 14}}, kDtypes.size(),
+      {Layout::ChannelsLast});
+});
+
+// Casts a float input to the benchmarked dtype.
+void copy_cast(benchmark::State& state) {
+  RunArgs args(state, 2, kDtypes);
+  if (!set_num_threads(state, args.threads)) {
+    return;
+  }
+  set_label(state, args.dtype, args.layout, args.threads);
+  auto self = make_input(args.sizes, at::kFloat, args.layout);
+  auto out = at::empty(args.sizes, at::dtype(args.dtype));
+  for (auto _ : state) {
+    out.copy_(self);
+  }
+  state.SetItemsProcessed(state.iterations() * self.numel());
+  state.SetBytesProcessed(
+      state.iterations() * self.numel() *
+      (self.element_size() + out.element_size()));
+}
+
+BENCHMARK(copy_cast)->Apply(add_elementwise_runs);
+
+} // namespace
+
+BENCHMARK_MAIN();
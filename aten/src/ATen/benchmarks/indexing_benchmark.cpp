@@ -0,0 +1,122 @@
+#include <ATen/benchmarks/benchmark_utils.h>
+
+// Gathers and scatters along the first dimension of a table, and
+// embedding_bag. The sizes of a run are (rows of the table, row width,
+// number of indices); the indices are uniform over the rows.
+
+using namespace at::benchmarks;
+
+namespace {
+
+const std::vector<at::ScalarType> kDtypes = {at::kFloat, at::kDouble};
+const std::vector<std::vector<int64_t>> kSizes = {
+    {1000, 64, 10000}, {100000, 64, 10000}, {100000, 512, 100000}};
+const std::vector<Layout> kLayouts = {Layout::Contiguous};
+
+void add_indexing_runs(benchmark::internal::Benchmark* b) {
+  add_runs(b, kSizes, kDtypes.size(), kLayouts);
+}
+
+struct IndexingInputs {
+  IndexingInputs(benchmark::State& state) : args(state, 3, kDtypes) {
+    rows = args.sizes[0];
+    width = args.sizes[1];
+    num_indices = args.sizes[2];
+    table = make_input({rows, width}, args.dtype, args.layout);
+    index = at::randint(rows, {num_indices}, at::kLong);
+  }
+
+  // The number of bytes of the rows that a run reads or writes.
+  int64_t row_bytes() const {
+    return num_indices * width * table.element_size();
+  }
+
+  RunArgs args;
+  int64_t rows;
+  int64_t width;
+  int64_t num_indices;
+  at::Tensor table;
+  at::Tensor index;
+};
+
+template <typename F>
+void run_indexing(benchmark::State& state, const F& op) {
+  IndexingInputs in(state);
+  if (!set_num_threads(state, in.args.threads)) {
+    return;
+  }
+  set_label(state, in.args.dtype, in.args.layout, in.args.threads);
+  op(state, in);
+  state.SetItemsProcessed(state.iterations() * in.num_indices);
+  state.SetBytesProcessed(state.iterations() * in.row_bytes());
+}
+
+void index_select(benchmark::State& state) {
+  run_indexing(state, [](benchmark::State& state, IndexingInputs& in) {
+    auto out = at::empty({in.num_indices, in.width}, in.table.options());
+    for (auto _ : state) {
+      at::index_select_out(out, in.table, 0, in.index);
+    }
+  });
+}
+
+// Advanced indexing with a tensor, table[index].
+void index(benchmark::State& state) {
+  run_indexing(state, [](benchmark::State& state, IndexingInputs& in) {
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(at::index(in.table, {in.index}));
+    }
+  });
+}
+
+void index_add(benchmark::State& state) {
+  run_indexing(state, [](benchmark::State& state, IndexingInputs& in) {
+    auto source = make_input({in.num_indices, in.width}, in.args.dtype, in.args.layout);
+    for (auto _ : state) {
+      in.table.index_add_(0, in.index, source);
+    }
+  });
+}
+
+void gather(benchmark::State& state) {
+  run_indexing(state, [](benchmark::State& state, IndexingInputs& in) {
+    auto index = in.index.unsqueeze(1).expand({in.num_indices, in.width}).contiguous();
+    auto out = at::empty({in.num_indices, in.width}, in.table.options());
+    for (auto _ : state) {
+      at::gather_out(out, in.table, 0, index);
+    }
+  });
+}
+
+void scatter_add(benchmark::State& state) {
+  run_indexing(state, [](benchmark::State& state, IndexingInputs& in) {
+    auto index = in.index.unsqueeze(1).expand({in.num_indices, in.width}).contiguous();
+    auto source = make_input({in.num_indices, in.width}, in.args.dtype, in.args.layout);
+    for (auto _ : state) {
+      in.table.scatter_add_(0, index, source);
+    }
+  });
+}
+
+// Sums bags of 20 indices each.
+void embedding_bag(benchmark::State& state) {
+  run_indexing(state, [](benchmark::State& state, IndexingInputs& in) {
+    constexpr int64_t kBagSize = 20;
+    auto offsets = at::arange(0, in.num_indices, kBagSize, at::kLong);
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(
+          at::embedding_bag(in.table, in.index, offsets, false, /*mode=*/0));
+    }
+  });
+}
+
+BENCHMARK(index_select)->Apply(add_indexing_runs);
+BENCHMARK(index)->Apply(add_indexing_runs);
+BENCHMARK(index_add)->Apply(add_indexing_runs);
+BENCHMARK(gather)->Apply(add_indexing_runs);
+BENCHMARK(scatter_add)->Apply(add_indexing_runs);
+BENCHMARK(embedding_bag)->Apply(add_indexing_runs);
+
+} // namespace
+
+BENCHMARK_MAIN();
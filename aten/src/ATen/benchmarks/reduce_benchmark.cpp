@@ -0,0 +1,80 @@
+#include <ATen/benchmarks/benchmark_utils.h>
+
+// Full and per-dimension reductions.
+
+using namespace at::benchmarks;
+
+namespace {
+
+const std::vector<at::ScalarType> kDtypes = {at::kFloat, at::kDouble};
+const std::vector<std::vector<int64_t>> kSizes = {
+    {64, 64}, {1024, 1024}, {4096, 4096}, {64, 262144}, {262144, 64}};
+const std::vector<Layout> kLayouts = {Layout::Contiguous, Layout::Transposed};
+
+void add_reduce_runs(benchmark::internal::Benchmark* b) {
+  add_runs(b, kSizes, kDtypes.size(), kLayouts);
+}
+
+// Runs `op` on the input of a run. `op` returns a tensor, as for the
+// reductions the out= variants resize their output on every call anyway.
+template <typename F>
+void run_reduction(benchmark::State& state, const F& op) {
+  RunArgs args(state, 2, kDtypes);
+  if (!set_num_threads(state, args.threads)) {
+    return;
+  }
+  set_label(state, args.dtype, args.layout, args.threads);
+  auto self = make_input(args.sizes, args.dtype, args.layout);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(op(self));
+  }
+  state.SetItemsProcessed(state.iterations() * self.numel());
+  state.SetBytesProcessed(
+      state.iterations() * self.numel() * self.element_size());
+}
+
+void sum(benchmark::State& state) {
+  run_reduction(state, [](const at::Tensor& t) { return t.sum(); });
+}
+
+void sum_dim0(benchmark::State& state) {
+  run_reduction(state, [](const at::Tensor& t) { return t.sum(0); });
+}
+
+void sum_dim1(benchmark::State& state) {
+  run_reduction(state, [](const at::Tensor& t) { return t.sum(1); });
+}
+
+void mean_dim1(benchmark::State& state) {
+  run_reduction(state, [](const at::Tensor& t) { return t.mean(1); });
+}
+
+void max_dim1(benchmark::State& state) {
+  run_reduction(
+      state, [](const at::Tensor& t) { return std::get<0>(t.max(1)); });
+}
+
+void argmax_dim1(benchmark::State& state) {
+  run_reduction(state, [](const at::Tensor& t) { return t.argmax(1); });
+}
+
+void norm(benchmark::State& state) {
+  run_reduction(state, [](const at::Tensor& t) { return t.norm(); });
+}
+
+void norm_dim1(benchmark::State& state) {
+  run_reduction(state, [](const at::Tensor& t) { return t.norm(2, 1); });
+}
+
+BENCHMARK(sum)->Apply(add_reduce_runs);
+BENCHMARK(sum_dim0)->Apply(add_reduce_runs);
+BENCHMARK(sum_dim1)->Apply(add_reduce_runs);
+BENCHMARK(mean_dim1)->Apply(add_reduce_runs);
+BENCHMARK(max_dim1)->Apply(add_reduce_runs);
+BENCHMARK(argmax_dim1)->Apply(add_reduce_runs);
+BENCHMARK(norm)->Apply(add_reduce_runs);
+BENCHMARK(norm_dim1)->Apply(add_reduce_runs);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,61 @@
+#include <ATen/benchmarks/benchmark_utils.h>
+
+// sort and topk along the last dimension. For topk the sizes of a run are
+// (rows, row length, k).
+
+using namespace at::benchmarks;
+
+namespace {
+
+const std::vector<at::ScalarType> kDtypes = {at::kFloat, at::kLong};
+const std::vector<Layout> kLayouts = {Layout::Contiguous, Layout::Transposed};
+
+void sort(benchmark::State& state) {
+  RunArgs args(state, 2, kDtypes);
+  if (!set_num_threads(state, args.threads)) {
+    return;
+  }
+  set_label(state, args.dtype, args.layout, args.threads);
+  auto self = make_input(args.sizes, args.dtype, args.layout);
+  auto values = at::empty_like(self);
+  auto indices = at::empty(self.sizes(), at::kLong);
+  for (auto _ : state) {
+    at::sort_out(values, indices, self, -1);
+  }
+  state.SetItemsProcessed(state.iterations() * self.numel());
+  state.SetBytesProcessed(
+      state.iterations() * self.numel() * self.element_size());
+}
+
+BENCHMARK(sort)->Apply([](benchmark::internal::Benchmark* b) {
+  add_runs(
+      b, {{1, 1000000}, {1000, 1000}, {100000, 10}}, kDtypes.size(), kLayouts);
+});
+
+void topk(benchmark::State& state) {
+  RunArgs args(state, 3, kDtypes);
+  if (!set_num_threads(state, args.threads)) {
+    return;
+  }
+  set_label(state, args.dtype, args.layout, args.threads);
+  auto self = make_input({args.sizes[0], args.sizes[1]}, args.dtype, args.layout);
+  const int64_t k = args.sizes[2];
+  auto values = at::empty({args.sizes[0], k}, self.options());
+  auto indices = at::empty({args.sizes[0], k}, at::kLong);
+  for (auto _ : state) {
+    at::topk_out(values, indices, self, k, -1);
+  }
+  state.SetItemsProcessed(state.iterations() * self.numel());
+  state.SetBytesProcessed(
+      state.iterations() * self.numel() * self.element_size());
+}
+
+BENCHMARK(topk)->Apply([](benchmark::internal::Benchmark* b) {
+  add_runs(
+      b, {{1, 1000000, 10}, {1, 1000000, 10000}, {1000, 1000, 10}},
+      kDtypes.size(), kLayouts);
+});
+
+} // namespace
+
+BENCHMARK_MAIN();
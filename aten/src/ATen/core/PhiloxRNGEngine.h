@@ -37,9 +37,9 @@ typedef at::detail::Array<float, 2> FLOAT2;
  * Refer to: http://www.thesalmons.org/john/random123/papers/random123sc11.pdf
  * for details regarding the engine.
  *
- * Note that currently this implementation of the philox engine is not used
- * anywhere except for tests in cpu_generator_test.cpp. However, this engine
- * will replace curandStatePhilox4_32_10_t in the future.
+ * On CPU, this engine generates large tensors in parallel, one substream
+ * per chunk of elements (see native/cpu/DistributionTemplates.h). It will
+ * also replace curandStatePhilox4_32_10_t in the future.
  * 
  * The philox engine takes a seed value, a subsequeunce
  * for starting the generation and an offset for the subsequence.
@@ -3,6 +3,8 @@
 // This file contains boxing (not unboxing) logic,
 // i.e. how to make a vector<IValue> from a set of concrete arguments.
 
+#include <algorithm>
+
 #include <ATen/core/ivalue.h>
 #include <c10/core/TensorOptions.h>
 #include <ATen/core/boxing/KernelFunction.h>
@@ -35,6 +37,21 @@ using supports_boxing =
     not_ok_to_box<std::decay_t<Args>>...
   >>;
 
+// The number of IValues torch::jit::push puts on the stack for the given
+// arguments, used to allocate the stack of a boxed call only once.
+// Assume T is decayed
+template <class T>
+struct boxed_size_one : std::integral_constant<size_t, 1> {};
+// TensorOptions are pushed as dtype, layout, device and pin_memory.
+template <>
+struct boxed_size_one<TensorOptions> : std::integral_constant<size_t, 4> {};
+
+template <class... Args>
+struct boxed_size : std::integral_constant<size_t, 0> {};
+template <class Arg, class... Args>
+struct boxed_size<Arg, Args...> : std::integral_constant<size_t,
+    boxed_size_one<std::decay_t<Arg>>::value + boxed_size<Args...>::value> {};
+
 template<class Result, class... Args>
 Result boxAndCallBoxedFunc(KernelFunction::InternalBoxedKernelFunction* boxed_kernel_func, OperatorKernel* functor, const OperatorHandle& opHandle, Args... args, std::enable_if_t<!supports_boxing<Result, Args...>::value, int> = 0) {
   TORCH_INTERNAL_ASSERT(false, "Tried to call KernelFunction::call() for a kernel that only has a boxed kernel and doesn't support calling from an unboxed API yet.");
@@ -44,8 +61,9 @@ Result boxAndCallBoxedFunc(KernelFunction::InternalBoxedKernelFunction* boxed_ke
 template<class Result, class... Args>
 std::enable_if_t<supports_boxing<Result, Args...>::value && !std::is_same<void, Result>::value, Result>
 boxAndCallBoxedFunc(KernelFunction::InternalBoxedKernelFunction* boxed_kernel_func, OperatorKernel* functor, const OperatorHandle& opHandle, Args... args) {
-  // TODO Reuse stack vector instead of allocating?
   torch::jit::Stack stack;
+  // Room for the arguments and a return, so the kernel doesn't reallocate.
+  stack.reserve(std::max<size_t>(boxed_size<Args...>::value, 1));
   torch::jit::push(stack, std::forward<Args>(args)...);
 
   (*boxed_kernel_func)(functor, opHandle, &stack);
@@ -58,8 +76,8 @@ boxAndCallBoxedFunc(KernelFunction::InternalBoxedKernelFunction* boxed_kernel_fu
 template<class Result, class... Args>
 std::enable_if_t<supports_boxing<Result, Args...>::value && std::is_same<void, Result>::value, Result>
 boxAndCallBoxedFunc(KernelFunction::InternalBoxedKernelFunction* boxed_kernel_func, OperatorKernel* functor, const OperatorHandle& opHandle, Args... args) {
-  // TODO Reuse stack vector instead of allocating?
   torch::jit::Stack stack;
+  stack.reserve(boxed_size<Args...>::value);
   torch::jit::push(stack, std::forward<Args>(args)...);
 
   (*boxed_kernel_func)(functor, opHandle, &stack);
@@ -392,6 +392,31 @@ TEST(OperatorRegistrationTest_FunctionBasedKernel, givenKernelWithIntListInput_w
   EXPECT_EQ(3, outputs[0].toInt());
 }
 
+int64_t kernelWithIntArrayRefInputWithOutput(Tensor, c10::IntArrayRef input1) {
+  int64_t sum = 0;
+  for (int64_t v : input1) {
+    sum += v;
+  }
+  return sum;
+}
+
+TEST(OperatorRegistrationTest_FunctionBasedKernel, givenKernelWithIntArrayRefInput_withOutput_whenRegistered_thenCanBeCalled) {
+  auto registrar = RegisterOperators()
+      .op("_test::int_array_ref_input(Tensor dummy, int[] input) -> int", RegisterOperators::options().kernel<decltype(kernelWithIntArrayRefInputWithOutput), &kernelWithIntArrayRefInputWithOutput>(DispatchKey::CPU));
+
+  auto op = c10::Dispatcher::singleton().findSchema({"_test::int_array_ref_input", ""});
+  ASSERT_TRUE(op.has_value());
+
+  // Lists that fit inline and lists that don't
+  auto outputs = callOp(*op, dummyTensor(DispatchKey::CPU), c10::List<int64_t>({2, 4, 6}));
+  EXPECT_EQ(1, outputs.size());
+  EXPECT_EQ(12, outputs[0].toInt());
+
+  outputs = callOp(*op, dummyTensor(DispatchKey::CPU), c10::List<int64_t>({1, 2, 3, 4, 5, 6, 7, 8}));
+  EXPECT_EQ(1, outputs.size());
+  EXPECT_EQ(36, outputs[0].toInt());
+}
+
 void kernelWithTensorListInputWithoutOutput(const c10::List<Tensor>& input1) {
   captured_input_list_size = input1.size();
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <ATen/core/DimVector.h>
 #include <ATen/core/ivalue.h>
 #include <ATen/core/stack.h>
 #include <c10/util/Metaprogramming.h>
@@ -222,6 +223,29 @@ using supported_primitive_arg_types = guts::typelist::typelist<
     }
   };
 
+  // Int and float lists are mostly short, e.g., sizes or strides, so unbox
+  // them into an inline buffer instead of a heap-allocated std::vector.
+  template<class T>
+  struct ivalue_to_small_vector_arg {
+    static SmallVector<T, at::kDimVectorStaticSize> call(IValue&& v) {
+      ArrayRef<IValue> list = v.toListRef();
+      SmallVector<T, at::kDimVectorStaticSize> result;
+      result.reserve(list.size());
+      for (const IValue& elem : list) {
+        result.push_back(elem.to<T>());
+      }
+      return result;
+    }
+  };
+
+  template<bool AllowDeprecatedTypes>
+  struct ivalue_to_arg<ArrayRef<int64_t>, AllowDeprecatedTypes> final
+  : ivalue_to_small_vector_arg<int64_t> {};
+
+  template<bool AllowDeprecatedTypes>
+  struct ivalue_to_arg<ArrayRef<double>, AllowDeprecatedTypes> final
+  : ivalue_to_small_vector_arg<double> {};
+
   template<class T, bool AllowDeprecatedTypes>
   IValue return_to_ivalue(T&& v) {
     assert_is_valid_output_type<T, AllowDeprecatedTypes>();
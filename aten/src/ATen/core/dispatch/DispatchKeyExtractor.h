@@ -128,8 +128,9 @@ public:
         // no safe toTensorRef method, alas)
         ks = ks | ivalue.unsafeToTensorImpl()->key_set();
       } else if (C10_UNLIKELY(ivalue.isTensorList())) {
-        for (const at::Tensor& tensor : ivalue.toTensorList()) {
-          ks = ks | tensor.key_set();
+        // Same for the list and its elements.
+        for (const IValue& elem : ivalue.toListRef()) {
+          ks = ks | elem.unsafeToTensorImpl()->key_set();
         }
       }
     });
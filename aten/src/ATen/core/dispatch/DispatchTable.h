@@ -178,6 +178,53 @@ class DispatchTable final {
     }
   }
 
+  /**
+   * Returns the kernel a call with the given dispatch key runs, as computed
+   * by the last updateResolvedKernels, or nullptr if there is none or the
+   * resolved kernels are stale.
+   */
+  const KernelFunction* lookupResolved(DispatchKey dispatchKey) const {
+    return resolvedKernels_[static_cast<uint8_t>(dispatchKey)];
+  }
+
+  /**
+   * Marks the resolved kernels as stale, so lookupResolved misses until
+   * updateResolvedKernels is called. The dispatcher calls this after every
+   * change to the kernels of this table or to the backend fallbacks, and
+   * resolves the kernels again on the first miss, so that registrations
+   * don't pay for resolving tables which may never be used.
+   */
+  void invalidateResolvedKernels() {
+    resolvedKernels_.fill(nullptr);
+    resolvedKernelsStale_ = true;
+  }
+
+  bool resolvedKernelsStale() const {
+    return resolvedKernelsStale_;
+  }
+
+  /**
+   * Recomputes, for every dispatch key, the kernel a call with that key
+   * runs: the kernel registered for the key if any, or else the backend
+   * fallback kernel, or else the catch-all kernel. This moves these checks
+   * out of every call. It is const because the result is a cache of the
+   * kernels; the dispatcher must hold its mutex while calling it.
+   */
+  void updateResolvedKernels(const impl::KernelFunctionTable& backendFallbackKernels) const {
+    for (uint8_t iter = 0; iter != static_cast<uint8_t>(DispatchKey::NumDispatchKeys); ++iter) {
+      const auto dispatchKey = static_cast<DispatchKey>(iter);
+      const KernelFunction* kernel = lookup(dispatchKey);
+      if (kernel == nullptr && backendFallbackKernels[dispatchKey].isValid()) {
+        kernel = &backendFallbackKernels[dispatchKey];
+      }
+      if (kernel == nullptr) {
+        kernel = lookupCatchallKernel();
+      }
+      resolvedKernels_[iter] = kernel;
+    }
+    resolvedKernelsStale_ = false;
+  }
+
   const KernelFunction* lookupCatchallKernel() const {
     // TODO: this condition shouldn't be necessary
     if (!catchallKernel_.isValid()) {
@@ -230,6 +277,10 @@ private:
 
   impl::KernelFunctionTable kernels_;
   KernelFunction catchallKernel_;
+  // Points into kernels_, catchallKernel_ or the backend fallbacks of the
+  // dispatcher, see updateResolvedKernels.
+  mutable std::array<const KernelFunction*, static_cast<uint8_t>(DispatchKey::NumDispatchKeys)> resolvedKernels_{};
+  mutable bool resolvedKernelsStale_ = true;
   DispatchKeyExtractor dispatchKeyExtractor_;
   OperatorName operatorName_;
 
@@ -142,6 +142,30 @@ RegistrationHandleRAII Dispatcher::registerDef(FunctionSchema schema, std::strin
   } else {
     checkSchemaCompatibility(op, schema, debug);
   }
+  return finishRegisterDef_(op, std::move(op_name));
+}
+
+RegistrationHandleRAII Dispatcher::registerDef(OperatorName op_name, std::string schema_string, std::string debug) {
+  // we need a lock to avoid concurrent writes
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto op = findOrRegisterName_(op_name);
+
+  if (op.operatorIterator_->def_count == 0) {
+    // NB: registerUnparsedSchema is not idempotent! Only do it once!
+    op.operatorIterator_->op.registerUnparsedSchema(std::move(schema_string), std::move(debug));
+    listeners_->callOnOperatorRegistered(op);
+  } else {
+    // Redefinitions are rare, so they are checked right away
+    checkSchemaCompatibility(op, impl::OperatorEntry::parseSchema(schema_string), debug);
+  }
+  return finishRegisterDef_(op, std::move(op_name));
+}
+
+// Must be called with mutex_ held, once the schema of op is registered or
+// checked against the one registered before
+RegistrationHandleRAII Dispatcher::finishRegisterDef_(const OperatorHandle& op, OperatorName op_name) {
+  invalidateResolvedKernels_(op);
 
   // NB: do not increment the counts until AFTER error checking
   ++op.operatorIterator_->def_count;
@@ -175,7 +199,7 @@ void Dispatcher::deregisterDef_(const OperatorHandle& op, const OperatorName& op
   // we need a lock to avoid concurrent writes
   std::lock_guard<std::mutex> lock(mutex_);
 
-  TORCH_INTERNAL_ASSERT(op.schema().operator_name() == op_name);
+  TORCH_INTERNAL_ASSERT(op.operator_name() == op_name);
 
   // reduce def_count and actually deregister if no references left
   TORCH_INTERNAL_ASSERT(op.operatorIterator_->def_count > 0);
@@ -190,6 +214,7 @@ void Dispatcher::deregisterDef_(const OperatorHandle& op, const OperatorName& op
     listeners_->callOnOperatorDeregistered(op);
     op.operatorIterator_->op.deregisterSchema();
   }
+  invalidateResolvedKernels_(op);
 
   cleanup(op, op_name);
 }
@@ -206,6 +231,7 @@ RegistrationHandleRAII Dispatcher::registerImpl(
   auto op = findOrRegisterName_(op_name);
 
   auto handle = op.operatorIterator_->op.registerKernel(dispatch_key, std::move(kernel), std::move(inferred_function_schema), std::move(debug));
+  invalidateResolvedKernels_(op);
 
   ++op.operatorIterator_->def_and_impl_count;
 
@@ -218,6 +244,7 @@ void Dispatcher::deregisterImpl_(const OperatorHandle& op, const OperatorName& o
   std::lock_guard<std::mutex> lock(mutex_);
 
   op.operatorIterator_->op.deregisterKernel_(dispatch_key, handle);
+  invalidateResolvedKernels_(op);
 
   TORCH_INTERNAL_ASSERT(op.operator_name() == op_name);
 
@@ -248,6 +275,7 @@ RegistrationHandleRAII Dispatcher::registerFallback(DispatchKey dispatchKey, Ker
   if (kernel.isFallthrough()) {
     backendsWithoutFallthrough_ = backendsWithoutFallthrough_.remove(dispatchKey);
   }
+  invalidateResolvedKernelsForAllOperators_();
 
   return RegistrationHandleRAII([this, dispatchKey] {
     deregisterFallback_(dispatchKey);
@@ -259,6 +287,35 @@ void Dispatcher::deregisterFallback_(DispatchKey dispatchKey) {
 
   backendFallbackKernels_.removeKernelIfExists(dispatchKey);
   backendsWithoutFallthrough_ = backendsWithoutFallthrough_.add(dispatchKey);
+  invalidateResolvedKernelsForAllOperators_();
+}
+
+void Dispatcher::invalidateResolvedKernels_(const OperatorHandle& op) {
+  op.operatorIterator_->op.invalidateResolvedKernels_();
+}
+
+void Dispatcher::invalidateResolvedKernelsForAllOperators_() {
+  for (auto& op : operators_) {
+    op.op.invalidateResolvedKernels_();
+  }
+}
+
+const KernelFunction& Dispatcher::dispatchSlow_(const DispatchTable& dispatchTable, DispatchKey dispatchKey) const {
+  const KernelFunction* kernel = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The first call after a registration resolves the kernels of the table
+    // for all dispatch keys, so later calls take the fast path again.
+    if (dispatchTable.resolvedKernelsStale()) {
+      dispatchTable.updateResolvedKernels(backendFallbackKernels_);
+    }
+    kernel = dispatchTable.lookupResolved(dispatchKey);
+  }
+  if (nullptr != kernel) {
+    return *kernel;
+  }
+
+  reportError(dispatchTable, dispatchKey);
 }
 
 
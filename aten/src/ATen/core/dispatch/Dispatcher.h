@@ -139,6 +139,15 @@ public:
    */
   RegistrationHandleRAII registerDef(FunctionSchema schema, std::string debug);
 
+  /**
+   * Like registerDef above, but for a schema that hasn't been parsed yet;
+   * op_name must be the operator name at the start of schema_string.
+   * Parsing is deferred until the schema is first needed, see
+   * OperatorEntry::schema(), so that an error in schema_string is only
+   * reported then.
+   */
+  RegistrationHandleRAII registerDef(OperatorName op_name, std::string schema_string, std::string debug);
+
   /**
    * Register a kernel to the dispatch table for an operator.
    * If dispatch_key is nullopt, then this registers a fallback kernel.
@@ -193,6 +202,7 @@ private:
   OperatorHandle findOrRegisterSchema_(FunctionSchema&& schema);
   OperatorHandle findOrRegisterName_(const OperatorName& op_name);
 
+  RegistrationHandleRAII finishRegisterDef_(const OperatorHandle& op, OperatorName op_name);
   void deregisterDef_(const OperatorHandle& op, const OperatorName& op_name);
   void deregisterImpl_(
     const OperatorHandle& op,
@@ -202,11 +212,17 @@ private:
   void deregisterFallback_(DispatchKey dispatchKey);
   void deregisterLibrary_(const std::string& ns);
   void cleanup(const OperatorHandle& op, const OperatorName& op_name);
+  // Must be called with mutex_ held after any change to the kernels of op,
+  // or, for all operators, to the backend fallbacks. The resolved kernels
+  // are only recomputed by the next call that misses them, see dispatchSlow_.
+  void invalidateResolvedKernels_(const OperatorHandle& op);
+  void invalidateResolvedKernelsForAllOperators_();
   void checkSchemaCompatibility(const OperatorHandle& op, const FunctionSchema& schema, const std::string& debug);
 
   [[noreturn]] static void reportError(const DispatchTable& dispatchTable, DispatchKey dispatchKey);
 
   const KernelFunction& dispatch_(const DispatchTable& dispatchTable, DispatchKey dispatch_key) const;
+  C10_NOINLINE const KernelFunction& dispatchSlow_(const DispatchTable& dispatchTable, DispatchKey dispatch_key) const;
 
   std::list<OperatorDef> operators_;
   LeftRight<ska::flat_hash_map<OperatorName, OperatorHandle>> operatorLookupTable_;
@@ -218,7 +234,8 @@ private:
   // masking)
   DispatchKeySet backendsWithoutFallthrough_;
   std::unique_ptr<detail::RegistrationListenerList> listeners_;
-  std::mutex mutex_;
+  // mutable because dispatchSlow_ takes it to resolve kernels
+  mutable std::mutex mutex_;
 };
 
 /**
@@ -313,6 +330,9 @@ inline Return Dispatcher::redispatch(const OperatorHandle& op, DispatchKey curre
 
 inline void Dispatcher::callBoxed(const OperatorHandle& op, Stack* stack) const {
   // note: this doesn't need the mutex because write operations on the list keep iterators intact.
+  // Boxed dispatch needs the schema to find the tensor arguments on the stack,
+  // so make sure it has been parsed.
+  op.operatorIterator_->op.schema();
   const auto& dispatchTable = op.operatorIterator_->op.dispatch_table();
   auto dispatchKey = dispatchTable.dispatchKeyExtractor().getDispatchKeyBoxed(backendsWithoutFallthrough_, stack);
   const KernelFunction& kernel = dispatch_(dispatchTable, dispatchKey);
@@ -320,23 +340,14 @@ inline void Dispatcher::callBoxed(const OperatorHandle& op, Stack* stack) const
 }
 
 inline const KernelFunction& Dispatcher::dispatch_(const DispatchTable& dispatchTable, DispatchKey dispatchKey) const {
-  const KernelFunction* backendKernel = dispatchTable.lookup(dispatchKey);
-
-  if (nullptr != backendKernel) {
-    return *backendKernel;
-  }
-
-  const auto& backendFallbackKernel = backendFallbackKernels_[dispatchKey];
-  if (backendFallbackKernel.isValid()) {
-    return backendFallbackKernel;
-  }
-
-  const KernelFunction* catchallKernel = dispatchTable.lookupCatchallKernel();
-  if (C10_LIKELY(nullptr != catchallKernel)) {
-    return *catchallKernel;
+  // The backend kernel, backend fallback and catch-all kernel checks are
+  // done ahead of time, see invalidateResolvedKernels_.
+  const KernelFunction* kernel = dispatchTable.lookupResolved(dispatchKey);
+  if (C10_LIKELY(nullptr != kernel)) {
+    return *kernel;
   }
 
-  reportError(dispatchTable, dispatchKey);
+  return dispatchSlow_(dispatchTable, dispatchKey);
 }
 
 } // namespace c10
@@ -1,5 +1,6 @@
 #include <ATen/core/dispatch/OperatorEntry.h>
 #include <ATen/core/op_registration/infer_schema.h>
+#include <torch/csrc/jit/frontend/function_schema_parser.h>
 
 namespace c10 {
 namespace impl {
@@ -30,7 +31,10 @@ namespace {
 OperatorEntry::OperatorEntry(OperatorName&& operator_name)
 : name_(std::move(operator_name))
 , schema_()
+, unparsedSchema_()
 , debug_()
+, schemaParsed_(false)
+, schemaMutex_()
 , dispatchTable_(name_)
 , kernels_() {
 }
@@ -54,8 +58,7 @@ namespace {
   }
 }
 
-void OperatorEntry::registerSchema(FunctionSchema&& schema, std::string&& debug) {
-  TORCH_INTERNAL_ASSERT(!schema_.has_value());
+void OperatorEntry::checkKernelSchemas_(const FunctionSchema& schema, const std::string& debug) const {
   for (auto i = kernels_.begin(); i != kernels_.end(); ++i) {
     for (auto j = i->second.begin(); j != i->second.end(); ++j) {
       if (j->inferred_function_schema != nullptr) {
@@ -63,17 +66,59 @@ void OperatorEntry::registerSchema(FunctionSchema&& schema, std::string&& debug)
       }
     }
   }
+}
+
+void OperatorEntry::registerSchema(FunctionSchema&& schema, std::string&& debug) {
+  TORCH_INTERNAL_ASSERT(!hasSchema());
+  checkKernelSchemas_(schema, debug);
   // NB: don't register schema until after we've checked everything!
   schema_ = std::move(schema);
   debug_ = std::move(debug);
   dispatchTable_.registerSchema(*schema_);
+  schemaParsed_.store(true, std::memory_order_release);
+}
+
+void OperatorEntry::registerUnparsedSchema(std::string&& schema_string, std::string&& debug) {
+  TORCH_INTERNAL_ASSERT(!hasSchema());
+  unparsedSchema_ = std::move(schema_string);
+  debug_ = std::move(debug);
+}
+
+FunctionSchema OperatorEntry::parseSchema(const std::string& schema_string) {
+  FunctionSchema schema = torch::jit::parseSchema(schema_string);
+  schema.setAliasAnalysis(AliasAnalysisKind::FROM_SCHEMA);
+  return schema;
+}
+
+void OperatorEntry::parseSchema_() const {
+  std::lock_guard<std::mutex> lock(schemaMutex_);
+  if (schemaParsed_.load(std::memory_order_relaxed)) {
+    // another thread parsed it while we were waiting for the lock
+    return;
+  }
+  TORCH_INTERNAL_ASSERT(unparsedSchema_.has_value());
+  FunctionSchema schema = parseSchema(*unparsedSchema_);
+  TORCH_INTERNAL_ASSERT(schema.operator_name() == name_,
+    "Registered the schema \"", *unparsedSchema_, "\" for operator ", name_);
+
+  // Kernels registered before the schema was parsed weren't checked against it
+  std::lock_guard<std::mutex> kernels_lock(kernelsMutex_);
+  checkKernelSchemas_(schema, *debug_);
+  schema_ = std::move(schema);
+  unparsedSchema_ = c10::nullopt;
+  dispatchTable_.registerSchema(*schema_);
+  schemaParsed_.store(true, std::memory_order_release);
 }
 
 void OperatorEntry::deregisterSchema() {
-  TORCH_INTERNAL_ASSERT(schema_.has_value());
+  TORCH_INTERNAL_ASSERT(hasSchema());
+  if (schemaParsed_.load(std::memory_order_acquire)) {
+    dispatchTable_.deregisterSchema();
+  }
+  schemaParsed_.store(false, std::memory_order_release);
   schema_ = c10::nullopt;
+  unparsedSchema_ = c10::nullopt;
   debug_ = c10::nullopt;
-  dispatchTable_.deregisterSchema();
 }
 
 std::list<OperatorEntry::KernelEntry>::iterator OperatorEntry::registerKernel(
@@ -84,7 +129,9 @@ std::list<OperatorEntry::KernelEntry>::iterator OperatorEntry::registerKernel(
 ) {
   std::unique_lock<std::mutex> lock(kernelsMutex_);
 
-  if (schema_ && inferred_function_schema) {
+  // If the schema hasn't been parsed yet, the kernel is checked against it
+  // once it is, see parseSchema_
+  if (schemaParsed_.load(std::memory_order_acquire) && hasSchema() && inferred_function_schema) {
     checkSchema(name_, *schema_, *debug_, *inferred_function_schema, debug);
   }
 
@@ -142,11 +189,12 @@ void OperatorEntry::updateDispatchTable_(c10::optional<DispatchKey> dispatch_key
 }
 
 void OperatorEntry::checkInvariants() const {
-  if (schema_) {
+  if (schemaParsed_.load(std::memory_order_acquire)) {
+    TORCH_INTERNAL_ASSERT(schema_.has_value());
     TORCH_INTERNAL_ASSERT(schema_->operator_name() == name_);
     dispatchTable_.dispatchKeyExtractor().checkInvariants(*schema_);
   }
-  TORCH_INTERNAL_ASSERT(schema_.has_value() == debug_.has_value());
+  TORCH_INTERNAL_ASSERT(debug_.has_value() == (schema_.has_value() || unparsedSchema_.has_value()));
   TORCH_INTERNAL_ASSERT(name_ == dispatchTable_.operatorName());
   TORCH_INTERNAL_ASSERT(kernels_.find(DispatchKey::Undefined) == kernels_.end());
   for (const auto& kv : kernels_) {
@@ -166,10 +214,11 @@ void OperatorEntry::checkInvariants() const {
 std::string OperatorEntry::dumpState() const {
   std::ostringstream oss;
   oss << "name: " << name_ << "\n";
-  if (schema_) {
-    oss << "schema: " << *schema_ << "\n";
+  if (hasSchema()) {
+    const FunctionSchema& schema = this->schema();
+    oss << "schema: " << schema << "\n";
     oss << "debug: " << *debug_ << "\n";
-    oss << "alias analysis kind: " << toString(schema_->aliasAnalysis()) << (schema_->isDefaultAliasAnalysisKind() ? " (default)" : "") << "\n";
+    oss << "alias analysis kind: " << toString(schema.aliasAnalysis()) << (schema.isDefaultAliasAnalysisKind() ? " (default)" : "") << "\n";
   } else {
     oss << "schema: (none)\n";
   }
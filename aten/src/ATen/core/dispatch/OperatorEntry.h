@@ -3,7 +3,9 @@
 #include <ATen/core/dispatch/DispatchTable.h>
 #include <ATen/core/dispatch/OperatorOptions.h>
 #include <ATen/core/dispatch/RegistrationHandleRAII.h>
+#include <atomic>
 #include <list>
+#include <mutex>
 
 namespace c10 {
 namespace impl {
@@ -37,8 +39,13 @@ public:
   OperatorEntry& operator=(const OperatorEntry&) = delete;
   OperatorEntry& operator=(OperatorEntry&&) noexcept = delete;
 
+  // Parses the schema first if it was registered as a string, see
+  // registerUnparsedSchema.
   const FunctionSchema& schema() const {
-    TORCH_INTERNAL_ASSERT(schema_.has_value(), "Tried to access the schema for ", name_, " which doesn't have a schema registered yet");
+    TORCH_INTERNAL_ASSERT(debug_.has_value(), "Tried to access the schema for ", name_, " which doesn't have a schema registered yet");
+    if (C10_UNLIKELY(!schemaParsed_.load(std::memory_order_acquire))) {
+      parseSchema_();
+    }
     return *schema_;
   }
   const std::string& debug() const {
@@ -46,7 +53,7 @@ public:
     return *debug_;
   }
   bool hasSchema() const {
-    return schema_.has_value();
+    return debug_.has_value();
   }
 
   // An OperatorEntry may be initialized with only an OperatorName.
@@ -71,6 +78,16 @@ public:
   void registerSchema(FunctionSchema&&, std::string&& debug);
   void deregisterSchema();
 
+  // Like registerSchema, but the schema is only parsed from schema_string
+  // once schema() is first called. Most operators are never called boxed or
+  // looked up by the JIT, so this takes schema parsing out of static
+  // initialization. Mismatches with the inferred schemas of kernels are
+  // reported when the schema is parsed.
+  void registerUnparsedSchema(std::string&& schema_string, std::string&& debug);
+
+  // Parses a schema string the way registerUnparsedSchema does.
+  static FunctionSchema parseSchema(const std::string& schema_string);
+
   const OperatorName& operator_name() const {
     return name_;
   }
@@ -85,8 +102,12 @@ public:
   std::list<KernelEntry>::iterator registerKernel(c10::optional<DispatchKey> dispatch_key, KernelFunction kernel, std::unique_ptr<FunctionSchema> inferred_function_schema, std::string debug);
   void deregisterKernel_(c10::optional<DispatchKey> dispatch_key, std::list<KernelEntry>::iterator kernel);
 
+  void invalidateResolvedKernels_() {
+    dispatchTable_.invalidateResolvedKernels();
+  }
+
   void updateSchemaAliasAnalysis(AliasAnalysisKind a) {
-    TORCH_INTERNAL_ASSERT(schema_.has_value());
+    schema();
     schema_->setAliasAnalysis(a);
   }
 
@@ -104,12 +125,17 @@ public:
 private:
 
   OperatorName name_;
-  c10::optional<FunctionSchema> schema_;
+  // schema_ and dispatchTable_'s schema are set by schema() if the schema
+  // was registered unparsed
+  mutable c10::optional<FunctionSchema> schema_;
+  mutable c10::optional<std::string> unparsedSchema_;
   c10::optional<std::string> debug_;
-  // INVARIANT: schema_.has_value() == debug_.has_value()
+  // INVARIANT: debug_.has_value() == (schemaParsed_ ? schema_ : unparsedSchema_).has_value()
+  mutable std::atomic<bool> schemaParsed_;
+  mutable std::mutex schemaMutex_; // protects parsing the schema
 
   // The dispatchTable stores the current kernel for each dispatch key
-  DispatchTable dispatchTable_;
+  mutable DispatchTable dispatchTable_;
 
   // kernels_ stores all registered kernels for the corresponding dispatch key
   // and catchAllKernels_ stores the catch-all kernels.
@@ -144,11 +170,14 @@ private:
   // currently not high-pri.
   ska::flat_hash_map<c10::optional<DispatchKey>, std::list<KernelEntry>> kernels_;
 
-  std::mutex kernelsMutex_; // protects kernels_
+  mutable std::mutex kernelsMutex_; // protects kernels_
 
   // This function re-establishes the invariant that dispatchTable
   // contains the front element from the kernels list for a given dispatch key.
   void updateDispatchTable_(c10::optional<DispatchKey> dispatch_key);
+
+  C10_NOINLINE void parseSchema_() const;
+  void checkKernelSchemas_(const FunctionSchema& schema, const std::string& debug) const;
 };
 
 }
@@ -2,6 +2,7 @@
 #include <ATen/core/jit_type.h>
 #include <ATen/core/Formatting.h>
 #include <c10/util/StringUtil.h>
+#include <atomic>
 #include <cmath>
 #include <ATen/core/Dict.h>
 
@@ -585,6 +586,80 @@ c10::intrusive_ptr<ivalue::Object> ivalue::Object::deepcopy(IValue::HashAliasedI
   return object;
 }
 
+c10::intrusive_ptr<ivalue::Future> collectAll(
+    c10::ArrayRef<c10::intrusive_ptr<ivalue::Future>> srcs) {
+  struct Ctx {
+    explicit Ctx(c10::ArrayRef<c10::intrusive_ptr<ivalue::Future>> srcs)
+        : remaining(srcs.size()),
+          srcFutures(FutureType::create(AnyType::get())) {
+      srcFutures.reserve(srcs.size());
+      for (const auto& src : srcs) {
+        srcFutures.push_back(src);
+      }
+      dstFuture = c10::make_intrusive<ivalue::Future>(
+          ListType::create(srcFutures.elementType()));
+    }
+    std::atomic<size_t> remaining;
+    // Set by whichever callback completes dstFuture, as a failing source
+    // completes it before the others are done.
+    std::atomic_flag done = ATOMIC_FLAG_INIT;
+    c10::impl::GenericList srcFutures;
+    c10::intrusive_ptr<ivalue::Future> dstFuture;
+  };
+
+  auto ctx = std::make_shared<Ctx>(srcs);
+  if (srcs.empty()) {
+    ctx->dstFuture->markCompleted(ctx->srcFutures);
+    return ctx->dstFuture;
+  }
+  for (const auto& src : srcs) {
+    // The callbacks hold the sources through ctx, so capture a raw pointer.
+    ivalue::Future* srcPtr = src.get();
+    src->addCallback([ctx, srcPtr]() {
+      if (srcPtr->hasError()) {
+        if (!ctx->done.test_and_set()) {
+          ctx->dstFuture->setError(srcPtr->error()->what());
+        }
+      } else if (--ctx->remaining == 0 && !ctx->done.test_and_set()) {
+        ctx->dstFuture->markCompleted(ctx->srcFutures);
+      }
+    });
+  }
+  return ctx->dstFuture;
+}
+
+c10::intrusive_ptr<ivalue::Future> collectAny(
+    c10::ArrayRef<c10::intrusive_ptr<ivalue::Future>> srcs) {
+  TORCH_CHECK(!srcs.empty(), "collectAny() expects at least one future");
+  TypePtr type = srcs[0]->type();
+  for (const auto& src : srcs) {
+    if (*src->type() != *type) {
+      type = AnyType::get();
+      break;
+    }
+  }
+  struct Ctx {
+    std::atomic_flag done = ATOMIC_FLAG_INIT;
+    c10::intrusive_ptr<ivalue::Future> dstFuture;
+  };
+  auto ctx = std::make_shared<Ctx>();
+  ctx->dstFuture = c10::make_intrusive<ivalue::Future>(type);
+  for (const auto& src : srcs) {
+    ivalue::Future* srcPtr = src.get();
+    src->addCallback([ctx, srcPtr]() {
+      if (ctx->done.test_and_set()) {
+        return;
+      }
+      if (srcPtr->hasError()) {
+        ctx->dstFuture->setError(srcPtr->error()->what());
+      } else {
+        ctx->dstFuture->markCompleted(srcPtr->constValue());
+      }
+    });
+  }
+  return ctx->dstFuture;
+}
+
 StrongTypePtr::StrongTypePtr(
     std::shared_ptr<torch::jit::CompilationUnit> cu,
     std::shared_ptr<Type> type) {
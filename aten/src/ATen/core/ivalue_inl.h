@@ -244,6 +244,11 @@ struct C10_EXPORT ivalue::Future final : c10::intrusive_ptr_target {
     std::string error_msg;
   };
 
+  // Runs a callback on some thread, e.g. by enqueueing it on a thread pool.
+  // Callbacks added with an executor run there instead of inline on the
+  // thread that completes the future.
+  using Executor = std::function<void(std::function<void(void)>)>;
+
   /**
    * Wait on the future until it completes.
    */
@@ -334,27 +339,51 @@ struct C10_EXPORT ivalue::Future final : c10::intrusive_ptr_target {
     callbacks_.emplace_back(std::move(callback));
   }
 
+  /**
+   * Add a callback to the future, to be run by `executor` once the future
+   * completes. If the future has already completed, the callback is handed to
+   * the executor immediately. An empty executor runs the callback inline,
+   * like the overload above.
+   */
+  void addCallback(std::function<void(void)> callback, Executor executor) {
+    if (!executor) {
+      addCallback(std::move(callback));
+      return;
+    }
+    addCallback(std::bind(
+        [](const Executor& exec, std::function<void(void)>& cb) {
+          exec(std::move(cb));
+        },
+        std::move(executor),
+        std::move(callback)));
+  }
+
   /**
    * Add a callback to the future, and return another Future to hold the return
    * value of the callback. This is necessary when the callback provider needs
-   * to know for sure when the callback has finished.
+   * to know for sure when the callback has finished. If `executor` is given,
+   * the callback runs there rather than on the thread completing this future,
+   * so a long continuation doesn't hold up e.g. an RPC I/O thread.
    */
   c10::intrusive_ptr<Future> then(
       std::function<IValue(void)> callback,
-      TypePtr type) {
+      TypePtr type,
+      Executor executor = nullptr) {
     auto fut = c10::make_intrusive<Future>(type);
     // Cannot move capture std::function in lambda, because it cannot deduce
     // the template type for std::function. Hence use std::bind to explicitly
     // specify types.
-    addCallback(std::bind(
-        [fut](std::function<IValue(void)> cb) {
-          try {
-            fut->markCompleted(cb());
-          } catch (std::exception& e) {
-            fut->setError(e.what());
-          }
-        },
-        std::move(callback)));
+    addCallback(
+        std::bind(
+            [fut](std::function<IValue(void)> cb) {
+              try {
+                fut->markCompleted(cb());
+              } catch (std::exception& e) {
+                fut->setError(e.what());
+              }
+            },
+            std::move(callback)),
+        std::move(executor));
     return fut;
   }
 
@@ -409,6 +438,17 @@ struct C10_EXPORT ivalue::Future final : c10::intrusive_ptr_target {
   c10::optional<FutureError> error_;
 };
 
+// Returns a future that completes once all of `srcs` have completed, with a
+// list holding `srcs`, so the caller can read each value. It completes with
+// the error of the first source that fails, without waiting for the others.
+CAFFE2_API c10::intrusive_ptr<ivalue::Future> collectAll(
+    c10::ArrayRef<c10::intrusive_ptr<ivalue::Future>> srcs);
+
+// Returns a future that completes with the value, or the error, of the first
+// of `srcs` to complete. `srcs` must not be empty.
+CAFFE2_API c10::intrusive_ptr<ivalue::Future> collectAny(
+    c10::ArrayRef<c10::intrusive_ptr<ivalue::Future>> srcs);
+
 // User-defined object.
 struct C10_EXPORT ivalue::Object final : c10::intrusive_ptr_target {
  public:
@@ -77,8 +77,8 @@ Library::Library(Kind kind, std::string ns, c10::optional<c10::DispatchKey> k, c
 // TODO: Error if an operator is def'ed multiple times.  Right now we just
 // merge everything
 
-#define DEF_PRELUDE "def(\"", schema.operator_name(), "\"): "
-Library& Library::_def(c10::FunctionSchema&& schema, c10::OperatorName* out_name) & {
+#define DEF_PRELUDE "def(\"", name, "\"): "
+void Library::_checkDef(const c10::OperatorName& name) const {
   TORCH_CHECK(kind_ == DEF || kind_ == FRAGMENT,
     DEF_PRELUDE,
     "Cannot define an operator inside of a ", kind_, " block.  "
@@ -87,7 +87,7 @@ Library& Library::_def(c10::FunctionSchema&& schema, c10::OperatorName* out_name
   );
   TORCH_INTERNAL_ASSERT(ns_.has_value(), ERROR_CONTEXT);
   TORCH_INTERNAL_ASSERT(!dispatch_key_.has_value(), ERROR_CONTEXT);
-  auto ns_opt = schema.getNamespace();
+  auto ns_opt = name.getNamespace();
   if (ns_opt.has_value()) {
     // Note [Redundancy in registration code is OK]
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -108,10 +108,14 @@ Library& Library::_def(c10::FunctionSchema&& schema, c10::OperatorName* out_name
       "(and consider deleting the namespace from your schema string.)  ",
       ERROR_CONTEXT
     );
-  } else {
-    bool b = schema.setNamespaceIfNotSet(ns_->c_str());
-    TORCH_INTERNAL_ASSERT(b, ERROR_CONTEXT);
   }
+}
+#undef DEF_PRELUDE
+
+Library& Library::_def(c10::FunctionSchema&& schema, c10::OperatorName* out_name) & {
+  _checkDef(schema.operator_name());
+  bool b = schema.setNamespaceIfNotSet(ns_->c_str());
+  TORCH_INTERNAL_ASSERT(b, ERROR_CONTEXT);
   if (out_name) {
     *out_name = schema.operator_name(); // copy!
   }
@@ -123,7 +127,23 @@ Library& Library::_def(c10::FunctionSchema&& schema, c10::OperatorName* out_name
   );
   return *this;
 }
-#undef DEF_PRELUDE
+
+Library& Library::def(const char* raw_schema) & {
+  // Only the name is needed to register the operator; the dispatcher parses
+  // the full schema when it is first asked for it.
+  c10::OperatorName name = torch::jit::parseSchemaName(raw_schema);
+  _checkDef(name);
+  bool b = name.setNamespaceIfNotSet(ns_->c_str());
+  TORCH_INTERNAL_ASSERT(b, ERROR_CONTEXT);
+  registrars_.emplace_back(
+    c10::Dispatcher::singleton().registerDef(
+      std::move(name),
+      c10::str(*ns_, "::", raw_schema),
+      debugString("", file_, line_)
+    )
+  );
+  return *this;
+}
 
 Library& Library::_def(c10::either<c10::OperatorName, c10::FunctionSchema>&& name_or_schema, CppFunction&& f) & {
   c10::FunctionSchema schema = [&] {
@@ -792,6 +792,27 @@ TEST(OperatorRegistrationTest, whenRegisteringBackendFallbackKernelAndCatchallKe
   EXPECT_EQ("hello _test::dummy", stack[1].toString()->string());
 }
 
+TEST(OperatorRegistrationTest, whenRegisteringBackendFallbackKernelAfterCatchallKernel_thenCallsFallbackKernelUntilDeregistered) {
+  auto registrar1 = c10::RegisterOperators().op("_test::dummy(Tensor dummy, str input) -> ()", c10::RegisterOperators::options()
+      .catchAllKernel([] (Tensor, std::string) {
+        called = true;
+      }));
+  auto op = Dispatcher::singleton().findSchema({"_test::dummy", ""});
+  ASSERT_TRUE(op.has_value());
+
+  {
+    auto registrar = c10::Dispatcher::singleton().registerFallback(c10::DispatchKey::CPU, c10::KernelFunction::makeFromBoxedFunction<&backend_fallback_kernel>(), "");
+    called = false;
+    auto stack = callOp(*op, dummyTensor(c10::DispatchKey::CPU), "hello ");
+    EXPECT_FALSE(called);
+    EXPECT_EQ("hello _test::dummy", stack[1].toString()->string());
+  }
+
+  called = false;
+  callOp(*op, dummyTensor(c10::DispatchKey::CPU), "hello ");
+  EXPECT_TRUE(called);
+}
+
 bool called_autograd = false;
 bool called_nonautograd = false;
 
@@ -1479,6 +1500,24 @@ TEST(NewOperatorRegistrationTest, schema) {
   ASSERT_TRUE(Dispatcher::singleton().findSchema({"test::def4", ""})->schema().isDefaultAliasAnalysisKind());
 }
 
+TEST(NewOperatorRegistrationTest, schemaStringIsParsedOnFirstUse) {
+  auto m = MAKE_TORCH_LIBRARY(test);
+  m.def("fn(Tensor self, int dim) -> Tensor");
+  m.def("malformed(Tensor self, ) -> Tensor");
+  // The kernel is only checked against the schema once it is parsed
+  m.impl("fn", c10::DispatchKey::CPU, [](const Tensor& x) { return x; });
+
+  auto op = Dispatcher::singleton().findSchema({"test::fn", ""});
+  ASSERT_TRUE(op.has_value());
+  expectThrows<c10::Error>([&] {
+    op->schema();
+  }, "expected schema of operator to be \"test::fn(Tensor self, int dim) -> (Tensor)\"");
+
+  auto malformed = Dispatcher::singleton().findSchema({"test::malformed", ""});
+  ASSERT_TRUE(malformed.has_value());
+  EXPECT_ANY_THROW(malformed->schema());
+}
+
 TEST(NewOperatorRegistrationTest, dispatch) {
   bool cpu_called = false;
   bool cuda_called = false;
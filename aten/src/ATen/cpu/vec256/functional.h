@@ -5,6 +5,9 @@
 
 #include <ATen/cpu/vec256/vec256.h>
 
+#include <tuple>
+#include <utility>
+
 namespace at { namespace vec256 {
 
 // TODO: Make this more efficient
@@ -27,7 +30,7 @@ inline scalar_t vec_reduce_all(
 }
 
 template <typename scalar_t, typename Op>
-inline scalar_t reduce_all(const Op& vec_fun, scalar_t* data, int64_t size) {
+inline scalar_t reduce_all(const Op& vec_fun, const scalar_t* data, int64_t size) {
   using Vec = vec256::Vec256<scalar_t>;
   if (size < Vec::size())
     return vec_reduce_all(vec_fun, Vec::loadu(data, size), size);
@@ -48,7 +51,7 @@ template <typename scalar_t, typename MapOp, typename ReduceOp>
 inline scalar_t map_reduce_all(
     const MapOp& map_fun,
     const ReduceOp& red_fun,
-    scalar_t* data,
+    const scalar_t* data,
     int64_t size) {
   using Vec = vec256::Vec256<scalar_t>;
   if (size < Vec::size())
@@ -121,8 +124,8 @@ template <typename scalar_t, typename Op>
 inline void map2(
     const Op& vec_fun,
     scalar_t* output_data,
-    scalar_t* input_data,
-    scalar_t* input_data2,
+    const scalar_t* input_data,
+    const scalar_t* input_data2,
     int64_t size) {
   using Vec = vec256::Vec256<scalar_t>;
   int64_t d = 0;
@@ -140,4 +143,370 @@ inline void map2(
   }
 }
 
+// BFloat16 and Half versions of the functions above. Every Vec256<BFloat16>
+// or Vec256<Half> is converted to two Vec256<float> when it is loaded and the
+// ops are called on Vec256<float>, so reductions accumulate in float and
+// results are rounded only once, when they are stored. They are picked by
+// calls on BFloat16 or Half data that do not spell out the template
+// arguments, e.g.
+//
+//   float sum = vec256::reduce_all(
+//       [](Vec256<float>& x, Vec256<float>& y) { return x + y; }, data, size);
+//
+// Calls whose ops take Vec256<BFloat16> or Vec256<Half> keep using the
+// generic versions.
+// vec_compute_t<scalar_t> is the type the ops see for a given scalar_t.
+
+template <typename scalar_t>
+struct VecComputeType {
+  using type = scalar_t;
+};
+
+template <>
+struct VecComputeType<BFloat16> {
+  using type = float;
+};
+
+template <>
+struct VecComputeType<Half> {
+  using type = float;
+};
+
+template <typename scalar_t>
+using vec_compute_t = typename VecComputeType<scalar_t>::type;
+
+template <typename Op>
+using map_fun_on_float_t = decltype(std::declval<const Op&>()(
+    std::declval<vec256::Vec256<float>&>()));
+
+template <typename Op>
+using reduce_fun_on_float_t = decltype(std::declval<const Op&>()(
+    std::declval<vec256::Vec256<float>&>(),
+    std::declval<vec256::Vec256<float>&>()));
+
+// Splits a vector of reduced floating point type into two Vec256<float>, and
+// back.
+inline std::tuple<Vec256<float>, Vec256<float>> convert_to_float(const Vec256<BFloat16>& a) {
+  return convert_bfloat16_float(a);
+}
+
+inline std::tuple<Vec256<float>, Vec256<float>> convert_to_float(const Vec256<Half>& a) {
+  return convert_half_float(a);
+}
+
+template <typename scalar_t>
+inline Vec256<scalar_t> convert_from_float(const Vec256<float>& a, const Vec256<float>& b);
+
+template <>
+inline Vec256<BFloat16> convert_from_float<BFloat16>(const Vec256<float>& a, const Vec256<float>& b) {
+  return convert_float_bfloat16(a, b);
+}
+
+template <>
+inline Vec256<Half> convert_from_float<Half>(const Vec256<float>& a, const Vec256<float>& b) {
+  return convert_float_half(a, b);
+}
+
+namespace detail {
+
+template <typename scalar_t, typename Op>
+inline float reduce_all(const Op& vec_fun, const scalar_t* data, int64_t size) {
+  using bVec = vec256::Vec256<scalar_t>;
+  using fVec = vec256::Vec256<float>;
+  if (size < bVec::size()) {
+    fVec data_fvec0, data_fvec1;
+    std::tie(data_fvec0, data_fvec1) = convert_to_float(bVec::loadu(data, size));
+    if (size > fVec::size()) {
+      data_fvec0 = fVec::set(data_fvec0, vec_fun(data_fvec0, data_fvec1), size - fVec::size());
+      return vec_reduce_all<float>(vec_fun, data_fvec0, fVec::size());
+    }
+    return vec_reduce_all<float>(vec_fun, data_fvec0, size);
+  }
+  int64_t d = bVec::size();
+  fVec acc_fvec0, acc_fvec1;
+  std::tie(acc_fvec0, acc_fvec1) = convert_to_float(bVec::loadu(data));
+  for (; d < size - (size % bVec::size()); d += bVec::size()) {
+    fVec data_fvec0, data_fvec1;
+    std::tie(data_fvec0, data_fvec1) = convert_to_float(bVec::loadu(data + d));
+    acc_fvec0 = vec_fun(acc_fvec0, data_fvec0);
+    acc_fvec1 = vec_fun(acc_fvec1, data_fvec1);
+  }
+  if (size - d > 0) {
+    fVec data_fvec0, data_fvec1;
+    std::tie(data_fvec0, data_fvec1) = convert_to_float(bVec::loadu(data + d, size - d));
+    if (size - d > fVec::size()) {
+      acc_fvec0 = vec_fun(acc_fvec0, data_fvec0);
+      acc_fvec1 = fVec::set(acc_fvec1, vec_fun(acc_fvec1, data_fvec1), size - d - fVec::size());
+    } else {
+      acc_fvec0 = fVec::set(acc_fvec0, vec_fun(acc_fvec0, data_fvec0), size - d);
+    }
+  }
+  acc_fvec0 = vec_fun(acc_fvec0, acc_fvec1);
+  return vec_reduce_all<float>(vec_fun, acc_fvec0, fVec::size());
+}
+
+template <typename scalar_t, typename MapOp, typename ReduceOp>
+inline float map_reduce_all(
+    const MapOp& map_fun,
+    const ReduceOp& red_fun,
+    const scalar_t* data,
+    int64_t size) {
+  using bVec = vec256::Vec256<scalar_t>;
+  using fVec = vec256::Vec256<float>;
+  if (size < bVec::size()) {
+    fVec data_fvec0, data_fvec1;
+    std::tie(data_fvec0, data_fvec1) = convert_to_float(bVec::loadu(data, size));
+    if (size > fVec::size()) {
+      data_fvec0 = map_fun(data_fvec0);
+      data_fvec1 = map_fun(data_fvec1);
+      data_fvec0 = fVec::set(data_fvec0, red_fun(data_fvec0, data_fvec1), size - fVec::size());
+      return vec_reduce_all<float>(red_fun, data_fvec0, fVec::size());
+    }
+    data_fvec0 = map_fun(data_fvec0);
+    return vec_reduce_all<float>(red_fun, data_fvec0, size);
+  }
+  int64_t d = bVec::size();
+  fVec acc_fvec0, acc_fvec1;
+  std::tie(acc_fvec0, acc_fvec1) = convert_to_float(bVec::loadu(data));
+  acc_fvec0 = map_fun(acc_fvec0);
+  acc_fvec1 = map_fun(acc_fvec1);
+  for (; d < size - (size % bVec::size()); d += bVec::size()) {
+    fVec data_fvec0, data_fvec1;
+    std::tie(data_fvec0, data_fvec1) = convert_to_float(bVec::loadu(data + d));
+    data_fvec0 = map_fun(data_fvec0);
+    data_fvec1 = map_fun(data_fvec1);
+    acc_fvec0 = red_fun(acc_fvec0, data_fvec0);
+    acc_fvec1 = red_fun(acc_fvec1, data_fvec1);
+  }
+  if (size - d > 0) {
+    fVec data_fvec0, data_fvec1;
+    std::tie(data_fvec0, data_fvec1) = convert_to_float(bVec::loadu(data + d, size - d));
+    if (size - d > fVec::size()) {
+      data_fvec0 = map_fun(data_fvec0);
+      data_fvec1 = map_fun(data_fvec1);
+      acc_fvec0 = red_fun(acc_fvec0, data_fvec0);
+      acc_fvec1 = fVec::set(acc_fvec1, red_fun(acc_fvec1, data_fvec1), size - d - fVec::size());
+    } else {
+      data_fvec0 = map_fun(data_fvec0);
+      acc_fvec0 = fVec::set(acc_fvec0, red_fun(acc_fvec0, data_fvec0), size - d);
+    }
+  }
+  acc_fvec0 = red_fun(acc_fvec0, acc_fvec1);
+  return vec_reduce_all<float>(red_fun, acc_fvec0, fVec::size());
+}
+
+template <typename scalar_t, typename MapOp, typename ReduceOp>
+inline float map2_reduce_all(
+    const MapOp& map_fun,
+    const ReduceOp& red_fun,
+    const scalar_t* data,
+    const scalar_t* data2,
+    int64_t size) {
+  using bVec = vec256::Vec256<scalar_t>;
+  using fVec = vec256::Vec256<float>;
+  if (size < bVec::size()) {
+    fVec data_fvec0, data_fvec1;
+    fVec data2_fvec0, data2_fvec1;
+    std::tie(data_fvec0, data_fvec1) = convert_to_float(bVec::loadu(data, size));
+    std::tie(data2_fvec0, data2_fvec1) = convert_to_float(bVec::loadu(data2, size));
+    if (size > fVec::size()) {
+      data_fvec0 = map_fun(data_fvec0, data2_fvec0);
+      data_fvec1 = map_fun(data_fvec1, data2_fvec1);
+      data_fvec0 = fVec::set(data_fvec0, red_fun(data_fvec0, data_fvec1), size - fVec::size());
+      return vec_reduce_all<float>(red_fun, data_fvec0, fVec::size());
+    }
+    data_fvec0 = map_fun(data_fvec0, data2_fvec0);
+    return vec_reduce_all<float>(red_fun, data_fvec0, size);
+  }
+  int64_t d = bVec::size();
+  fVec acc_fvec0, acc_fvec1;
+  fVec data2_fvec0, data2_fvec1;
+  std::tie(acc_fvec0, acc_fvec1) = convert_to_float(bVec::loadu(data));
+  std::tie(data2_fvec0, data2_fvec1) = convert_to_float(bVec::loadu(data2));
+  acc_fvec0 = map_fun(acc_fvec0, data2_fvec0);
+  acc_fvec1 = map_fun(acc_fvec1, data2_fvec1);
+  for (; d < size - (size % bVec::size()); d += bVec::size()) {
+    fVec data_fvec0, data_fvec1;
+    std::tie(data_fvec0, data_fvec1) = convert_to_float(bVec::loadu(data + d));
+    std::tie(data2_fvec0, data2_fvec1) = convert_to_float(bVec::loadu(data2 + d));
+    data_fvec0 = map_fun(data_fvec0, data2_fvec0);
+    data_fvec1 = map_fun(data_fvec1, data2_fvec1);
+    acc_fvec0 = red_fun(acc_fvec0, data_fvec0);
+    acc_fvec1 = red_fun(acc_fvec1, data_fvec1);
+  }
+  if (size - d > 0) {
+    fVec data_fvec0, data_fvec1;
+    std::tie(data_fvec0, data_fvec1) = convert_to_float(bVec::loadu(data + d, size - d));
+    std::tie(data2_fvec0, data2_fvec1) = convert_to_float(bVec::loadu(data2 + d, size - d));
+    if (size - d > fVec::size()) {
+      data_fvec0 = map_fun(data_fvec0, data2_fvec0);
+      data_fvec1 = map_fun(data_fvec1, data2_fvec1);
+      acc_fvec0 = red_fun(acc_fvec0, data_fvec0);
+      acc_fvec1 = fVec::set(acc_fvec1, red_fun(acc_fvec1, data_fvec1), size - d - fVec::size());
+    } else {
+      data_fvec0 = map_fun(data_fvec0, data2_fvec0);
+      acc_fvec0 = fVec::set(acc_fvec0, red_fun(acc_fvec0, data_fvec0), size - d);
+    }
+  }
+  acc_fvec0 = red_fun(acc_fvec0, acc_fvec1);
+  return vec_reduce_all<float>(red_fun, acc_fvec0, fVec::size());
+}
+
+template <typename scalar_t, typename Op>
+inline void map(
+    const Op& vec_fun,
+    scalar_t* output_data,
+    const scalar_t* input_data,
+    int64_t size) {
+  using bVec = vec256::Vec256<scalar_t>;
+  using fVec = vec256::Vec256<float>;
+  int64_t d = 0;
+  for (; d < size - (size % bVec::size()); d += bVec::size()) {
+    fVec data_fvec0, data_fvec1;
+    std::tie(data_fvec0, data_fvec1) = convert_to_float(bVec::loadu(input_data + d));
+    bVec output_bvec = convert_from_float<scalar_t>(vec_fun(data_fvec0), vec_fun(data_fvec1));
+    output_bvec.store(output_data + d);
+  }
+  if (size - d > 0) {
+    fVec data_fvec0, data_fvec1;
+    std::tie(data_fvec0, data_fvec1) = convert_to_float(bVec::loadu(input_data + d, size - d));
+    bVec output_bvec = convert_from_float<scalar_t>(vec_fun(data_fvec0), vec_fun(data_fvec1));
+    output_bvec.store(output_data + d, size - d);
+  }
+}
+
+template <typename scalar_t, typename Op>
+inline void map2(
+    const Op& vec_fun,
+    scalar_t* output_data,
+    const scalar_t* input_data,
+    const scalar_t* input_data2,
+    int64_t size) {
+  using bVec = vec256::Vec256<scalar_t>;
+  using fVec = vec256::Vec256<float>;
+  int64_t d = 0;
+  for (; d < size - (size % bVec::size()); d += bVec::size()) {
+    fVec data_fvec0, data_fvec1;
+    fVec data2_fvec0, data2_fvec1;
+    std::tie(data_fvec0, data_fvec1) = convert_to_float(bVec::loadu(input_data + d));
+    std::tie(data2_fvec0, data2_fvec1) = convert_to_float(bVec::loadu(input_data2 + d));
+    bVec output_bvec = convert_from_float<scalar_t>(
+        vec_fun(data_fvec0, data2_fvec0), vec_fun(data_fvec1, data2_fvec1));
+    output_bvec.store(output_data + d);
+  }
+  if (size - d > 0) {
+    fVec data_fvec0, data_fvec1;
+    fVec data2_fvec0, data2_fvec1;
+    std::tie(data_fvec0, data_fvec1) = convert_to_float(bVec::loadu(input_data + d, size - d));
+    std::tie(data2_fvec0, data2_fvec1) = convert_to_float(bVec::loadu(input_data2 + d, size - d));
+    bVec output_bvec = convert_from_float<scalar_t>(
+        vec_fun(data_fvec0, data2_fvec0), vec_fun(data_fvec1, data2_fvec1));
+    output_bvec.store(output_data + d, size - d);
+  }
+}
+
+} // namespace detail
+
+template <typename Op, typename = reduce_fun_on_float_t<Op>>
+inline float reduce_all(const Op& vec_fun, const BFloat16* data, int64_t size) {
+  return detail::reduce_all<BFloat16>(vec_fun, data, size);
+}
+
+template <
+    typename MapOp,
+    typename ReduceOp,
+    typename = map_fun_on_float_t<MapOp>,
+    typename = reduce_fun_on_float_t<ReduceOp>>
+inline float map_reduce_all(
+    const MapOp& map_fun,
+    const ReduceOp& red_fun,
+    const BFloat16* data,
+    int64_t size) {
+  return detail::map_reduce_all<BFloat16>(map_fun, red_fun, data, size);
+}
+
+template <
+    typename MapOp,
+    typename ReduceOp,
+    typename = reduce_fun_on_float_t<MapOp>,
+    typename = reduce_fun_on_float_t<ReduceOp>>
+inline float map2_reduce_all(
+    const MapOp& map_fun,
+    const ReduceOp& red_fun,
+    const BFloat16* data,
+    const BFloat16* data2,
+    int64_t size) {
+  return detail::map2_reduce_all<BFloat16>(map_fun, red_fun, data, data2, size);
+}
+
+template <typename Op, typename = map_fun_on_float_t<Op>>
+inline void map(
+    const Op& vec_fun,
+    BFloat16* output_data,
+    const BFloat16* input_data,
+    int64_t size) {
+  detail::map<BFloat16>(vec_fun, output_data, input_data, size);
+}
+
+template <typename Op, typename = reduce_fun_on_float_t<Op>>
+inline void map2(
+    const Op& vec_fun,
+    BFloat16* output_data,
+    const BFloat16* input_data,
+    const BFloat16* input_data2,
+    int64_t size) {
+  detail::map2<BFloat16>(vec_fun, output_data, input_data, input_data2, size);
+}
+
+template <typename Op, typename = reduce_fun_on_float_t<Op>>
+inline float reduce_all(const Op& vec_fun, const Half* data, int64_t size) {
+  return detail::reduce_all<Half>(vec_fun, data, size);
+}
+
+template <
+    typename MapOp,
+    typename ReduceOp,
+    typename = map_fun_on_float_t<MapOp>,
+    typename = reduce_fun_on_float_t<ReduceOp>>
+inline float map_reduce_all(
+    const MapOp& map_fun,
+    const ReduceOp& red_fun,
+    const Half* data,
+    int64_t size) {
+  return detail::map_reduce_all<Half>(map_fun, red_fun, data, size);
+}
+
+template <
+    typename MapOp,
+    typename ReduceOp,
+    typename = reduce_fun_on_float_t<MapOp>,
+    typename = reduce_fun_on_float_t<ReduceOp>>
+inline float map2_reduce_all(
+    const MapOp& map_fun,
+    const ReduceOp& red_fun,
+    const Half* data,
+    const Half* data2,
+    int64_t size) {
+  return detail::map2_reduce_all<Half>(map_fun, red_fun, data, data2, size);
+}
+
+template <typename Op, typename = map_fun_on_float_t<Op>>
+inline void map(
+    const Op& vec_fun,
+    Half* output_data,
+    const Half* input_data,
+    int64_t size) {
+  detail::map<Half>(vec_fun, output_data, input_data, size);
+}
+
+template <typename Op, typename = reduce_fun_on_float_t<Op>>
+inline void map2(
+    const Op& vec_fun,
+    Half* output_data,
+    const Half* input_data,
+    const Half* input_data2,
+    int64_t size) {
+  detail::map2<Half>(vec_fun, output_data, input_data, input_data2, size);
+}
+
 }} // namespace at::vec256
@@ -8,6 +8,7 @@
 #include <ATen/cpu/vec256/vec256_base.h>
 #include <ATen/cpu/vec256/vec256_float.h>
 #include <ATen/cpu/vec256/vec256_bfloat16.h>
+#include <ATen/cpu/vec256/vec256_half.h>
 #include <ATen/cpu/vec256/vec256_double.h>
 #include <ATen/cpu/vec256/vec256_int.h>
 #include <ATen/cpu/vec256/vec256_qint.h>
@@ -15,6 +16,7 @@
 #include <ATen/cpu/vec256/vec256_std_complex_double.h>
 #include <ATen/cpu/vec256/vec256_complex_float.h>
 #include <ATen/cpu/vec256/vec256_complex_double.h>
+#include <ATen/cpu/vec512/vec512.h>
 
 #include <algorithm>
 #include <cstddef>
@@ -5,10 +5,13 @@
 
 #include <ATen/cpu/vec256/intrinsics.h>
 #include <ATen/cpu/vec256/vec256_base.h>
+#include <ATen/cpu/vec256/vec256_float.h>
 #if defined(CPU_CAPABILITY_AVX2) && !defined(_MSC_VER)
 #include <sleef.h>
 #endif
 
+#include <tuple>
+
 namespace at {
 namespace vec256 {
 // See Note [Acceptable use of anonymous namespace in header]
@@ -195,12 +198,8 @@ public:
     return cvtfp32_bf16(o1, o2);
   }
   Vec256<BFloat16> abs() const {
-    __m256 lo, hi;
-    cvtbf16_fp32(values, lo, hi);
-    auto mask = _mm256_set1_ps(-0.f);
-    auto o1 = _mm256_andnot_ps(mask, lo);
-    auto o2 = _mm256_andnot_ps(mask, hi);
-    return cvtfp32_bf16(o1, o2);
+    // Only the sign bit changes, no need to go through float.
+    return _mm256_andnot_si256(_mm256_set1_epi16(0x8000), values);
   }
   Vec256<BFloat16> angle() const {
     return _mm256_set1_epi16(0);
@@ -239,10 +238,10 @@ public:
     return map(Sleef_erfcf8_u15);
   }
   Vec256<BFloat16> erfinv() const {
-    __at_align32__ int16_t tmp[size()];
+    __at_align32__ BFloat16 tmp[size()];
     store(tmp);
     for (int64_t i = 0; i < size(); i++) {
-      tmp[i] = calc_erfinv((float)tmp[i]);
+      tmp[i] = calc_erfinv(static_cast<float>(tmp[i]));
     }
     return loadu(tmp);
   }
@@ -301,12 +300,7 @@ public:
     return cvtfp32_bf16(o1, o2);
   }
   Vec256<BFloat16> neg() const {
-    __m256 lo, hi;
-    cvtbf16_fp32(values, lo, hi);
-    auto mask = _mm256_set1_ps(-0.f);
-    auto o1 = _mm256_xor_ps(mask, lo);
-    auto o2 = _mm256_xor_ps(mask, hi);
-    return cvtfp32_bf16(o1, o2);
+    return _mm256_xor_si256(_mm256_set1_epi16(0x8000), values);
   }
   Vec256<BFloat16> round() const {
     __m256 lo, hi;
@@ -573,6 +567,40 @@ Vec256<BFloat16> inline fmadd(const Vec256<BFloat16>& a,
   return cvtfp32_bf16(o1, o2);
 }
 
+inline std::tuple<Vec256<float>, Vec256<float>> convert_bfloat16_float(const Vec256<BFloat16>& a) {
+  __m256 o1, o2;
+  cvtbf16_fp32(__m256i(a), o1, o2);
+  return std::make_tuple(o1, o2);
+}
+
+inline Vec256<BFloat16> convert_float_bfloat16(const Vec256<float>& a, const Vec256<float>& b) {
+  return cvtfp32_bf16(__m256(a), __m256(b));
+}
+
+#elif !defined(CPU_CAPABILITY_AVX512) || defined(_MSC_VER)
+// The AVX512 versions live in ATen/cpu/vec512/vec512_bfloat16.h.
+
+inline std::tuple<Vec256<float>, Vec256<float>> convert_bfloat16_float(const Vec256<BFloat16>& a) {
+  constexpr int64_t K = Vec256<BFloat16>::size();
+  __at_align32__ float arr[K];
+  __at_align32__ BFloat16 arr2[K];
+  a.store(arr2);
+  convert(arr2, arr, K);
+  return std::make_tuple(
+      Vec256<float>::loadu(arr),
+      Vec256<float>::loadu(arr + Vec256<float>::size()));
+}
+
+inline Vec256<BFloat16> convert_float_bfloat16(const Vec256<float>& a, const Vec256<float>& b) {
+  constexpr int64_t K = Vec256<BFloat16>::size();
+  __at_align32__ float arr[K];
+  __at_align32__ BFloat16 arr2[K];
+  a.store(arr);
+  b.store(arr + Vec256<float>::size());
+  convert(arr, arr2, K);
+  return Vec256<BFloat16>::loadu(arr2);
+}
+
 #endif
 
 }}}
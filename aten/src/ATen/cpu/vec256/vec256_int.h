@@ -29,7 +29,7 @@ public:
   }
 };
 
-#else
+#elif !defined(CPU_CAPABILITY_AVX512) || defined(_MSC_VER)
 
 struct Vec256i {};  // dummy definition to make Vec256i always defined
 
@@ -1039,8 +1039,10 @@ Vec256<c10::quint8> inline maximum(const Vec256<c10::quint8>& a, const Vec256<c1
   return a.maximum(b);
 }
 
-#else
+#elif !defined(CPU_CAPABILITY_AVX512) || defined(_MSC_VER)
 
+// The AVX512 versions live in ATen/cpu/vec512/vec512_qint.h.
+//
 // NOTE: These are low-performance implementations that we fall back on
 // if we are not building with AVX2. This may not be an issue, because
 // currently for quantization we assume the user has at least AVX512
@@ -0,0 +1,520 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256_base.h>
+#include <ATen/cpu/vec512/vec512_float.h>
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+#include <sleef.h>
+#endif
+
+#include <tuple>
+
+namespace at {
+namespace vec256 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+static inline void cvtfp16_fp32(const __m512i& a, __m512& o1, __m512& o2) {
+  o1 = _mm512_cvtph_ps(_mm512_extracti64x4_epi64(a, 0));
+  o2 = _mm512_cvtph_ps(_mm512_extracti64x4_epi64(a, 1));
+}
+static inline __m512i cvtfp32_fp16(const __m512& a, const __m512& b) {
+  __m256i lo = _mm512_cvtps_ph(a, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  __m256i hi = _mm512_cvtps_ph(b, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  return _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+}
+
+template <> class Vec256<Half> {
+private:
+  __m512i values;
+public:
+  using value_type = uint16_t;
+  static constexpr int size() {
+    return 32;
+  }
+  Vec256() {}
+  Vec256(__m512i v) : values(v) {}
+  Vec256(Half val) {
+    value_type uw = val.x;
+    values = _mm512_set1_epi16(uw);
+  }
+  operator __m512i() const {
+    return values;
+  }
+  Half& operator[](int idx) = delete;
+  const Half& operator[](int idx) const  = delete;
+  int zero_mask() const {
+    // returns an integer mask where all zero elements are translated to 1-bit and others are translated to 0-bit
+    return _mm512_cmpeq_epi16_mask(values, _mm512_set1_epi16(0));
+  }
+  static Vec256<Half> loadu(const void* ptr) {
+    return _mm512_loadu_si512(reinterpret_cast<const __m512i*>(ptr));
+  }
+  static Vec256<Half> loadu(const void* ptr, int16_t count) {
+    __mmask32 mask = (1ULL << count) - 1;
+    return _mm512_maskz_loadu_epi16(mask, ptr);
+  }
+  void store(void* ptr, int count = size()) const {
+    if (count == size()) {
+      _mm512_storeu_si512(reinterpret_cast<__m512i*>(ptr), values);
+    } else if (count > 0) {
+      __mmask32 mask = (1ULL << count) - 1;
+      _mm512_mask_storeu_epi16(ptr, mask, values);
+    }
+  }
+  template <int64_t mask>
+  static Vec256<Half> blend(const Vec256<Half>& a, const Vec256<Half>& b) {
+    return _mm512_mask_blend_epi16(mask, a.values, b.values);
+  }
+  static Vec256<Half> blendv(const Vec256<Half>& a,
+      const Vec256<Half>& b, const Vec256<Half>& mask) {
+    auto mmask = _mm512_movepi16_mask(mask.values);
+    return _mm512_mask_blend_epi16(mmask, a.values, b.values);
+  }
+  template<typename step_t>
+  static Vec256<Half> arange(Half base = 0.f, step_t step = static_cast<step_t>(1)) {
+    // There is no 32-argument setr for 16-bit elements, go through memory.
+    __at_align64__ Half tmp_values[size()];
+    for (int64_t i = 0; i < size(); i++) {
+      tmp_values[i] = base + i * step;
+    }
+    return loadu(tmp_values);
+  }
+  static Vec256<Half> set(const Vec256<Half>& a,
+      const Vec256<Half>& b, int64_t count = size()) {
+    if (count >= size()) {
+      return b;
+    }
+    __mmask32 mask = (1ULL << count) - 1;
+    return _mm512_mask_blend_epi16(mask, a.values, b.values);
+  }
+  Vec256<Half> map(const __m512 (*vop)(__m512)) const {
+    __m512 lo, hi;
+    cvtfp16_fp32(values, lo, hi);
+    auto o1 = vop(lo);
+    auto o2 = vop(hi);
+    return cvtfp32_fp16(o1, o2);
+  }
+  Vec256<Half> abs() const {
+    // Only the sign bit changes, no need to go through float.
+    return _mm512_andnot_si512(_mm512_set1_epi16(0x8000), values);
+  }
+  Vec256<Half> angle() const {
+    return _mm512_set1_epi16(0);
+  }
+  Vec256<Half> real() const {
+    return *this;
+  }
+  Vec256<Half> imag() const {
+    return _mm512_set1_epi16(0);
+  }
+  Vec256<Half> conj() const {
+    return *this;
+  }
+  Vec256<Half> acos() const {
+    return map(Sleef_acosf16_u10);
+  }
+  Vec256<Half> asin() const {
+    return map(Sleef_asinf16_u10);
+  }
+  Vec256<Half> atan() const {
+    return map(Sleef_atanf16_u10);
+  }
+  Vec256<Half> atan2(const Vec256<Half> &b) const {
+    __m512 lo, hi;
+    __m512 b1, b2;
+    cvtfp16_fp32(values, lo, hi);
+    cvtfp16_fp32(b.values, b1, b2);
+    auto o1 = Sleef_atan2f16_u10(lo, b1);
+    auto o2 = Sleef_atan2f16_u10(hi, b2);
+    return cvtfp32_fp16(o1, o2);
+  }
+  Vec256<Half> erf() const {
+    return map(Sleef_erff16_u10);
+  }
+  Vec256<Half> erfc() const {
+    return map(Sleef_erfcf16_u15);
+  }
+  Vec256<Half> erfinv() const {
+    __at_align64__ Half tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); i++) {
+      tmp[i] = calc_erfinv(static_cast<float>(tmp[i]));
+    }
+    return loadu(tmp);
+  }
+  Vec256<Half> exp() const {
+    return map(Sleef_expf16_u10);
+  }
+  Vec256<Half> expm1() const {
+    return map(Sleef_expm1f16_u10);
+  }
+  Vec256<Half> fmod(const Vec256<Half> & q) const {
+    __m512 x_lo, x_hi;
+    cvtfp16_fp32(values, x_lo, x_hi);
+    __m512 q_lo, q_hi;
+    cvtfp16_fp32(q.values, q_lo, q_hi);
+    auto o1 = Sleef_fmodf16(x_lo, q_lo);
+    auto o2 = Sleef_fmodf16(x_hi, q_hi);
+    return cvtfp32_fp16(o1, o2);
+  }
+  Vec256<Half> log() const {
+    return map(Sleef_logf16_u10);
+  }
+  Vec256<Half> log2() const {
+    return map(Sleef_log2f16_u10);
+  }
+  Vec256<Half> log10() const {
+    return map(Sleef_log10f16_u10);
+  }
+  Vec256<Half> log1p() const {
+    return map(Sleef_log1pf16_u10);
+  }
+  Vec256<Half> frac() const;
+  Vec256<Half> sin() const {
+    return map(Sleef_sinf16_u10);
+  }
+  Vec256<Half> sinh() const {
+    return map(Sleef_sinhf16_u10);
+  }
+  Vec256<Half> cos() const {
+    return map(Sleef_cosf16_u10);
+  }
+  Vec256<Half> cosh() const {
+    return map(Sleef_coshf16_u10);
+  }
+  Vec256<Half> ceil() const {
+    __m512 lo, hi;
+    cvtfp16_fp32(values, lo, hi);
+    auto o1 = _mm512_roundscale_ps(lo, (_MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC));
+    auto o2 = _mm512_roundscale_ps(hi, (_MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC));
+    return cvtfp32_fp16(o1, o2);
+  }
+  Vec256<Half> floor() const {
+    __m512 lo, hi;
+    cvtfp16_fp32(values, lo, hi);
+    auto o1 = _mm512_roundscale_ps(lo, (_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+    auto o2 = _mm512_roundscale_ps(hi, (_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+    return cvtfp32_fp16(o1, o2);
+  }
+  Vec256<Half> neg() const {
+    return _mm512_xor_si512(_mm512_set1_epi16(0x8000), values);
+  }
+  Vec256<Half> round() const {
+    __m512 lo, hi;
+    cvtfp16_fp32(values, lo, hi);
+    auto o1 = _mm512_roundscale_ps(lo, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    auto o2 = _mm512_roundscale_ps(hi, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    return cvtfp32_fp16(o1, o2);
+  }
+  Vec256<Half> tan() const {
+    return map(Sleef_tanf16_u10);
+  }
+  Vec256<Half> tanh() const {
+    return map(Sleef_tanhf16_u10);
+  }
+  Vec256<Half> trunc() const {
+    __m512 lo, hi;
+    cvtfp16_fp32(values, lo, hi);
+    auto o1 = _mm512_roundscale_ps(lo, (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+    auto o2 = _mm512_roundscale_ps(hi, (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+    return cvtfp32_fp16(o1, o2);
+  }
+  Vec256<Half> lgamma() const {
+    return map(Sleef_lgammaf16_u10);
+  }
+  Vec256<Half> sqrt() const {
+    __m512 lo, hi;
+    cvtfp16_fp32(values, lo, hi);
+    auto o1 = _mm512_sqrt_ps(lo);
+    auto o2 = _mm512_sqrt_ps(hi);
+    return cvtfp32_fp16(o1, o2);
+  }
+  Vec256<Half> reciprocal() const {
+    __m512 lo, hi;
+    cvtfp16_fp32(values, lo, hi);
+    auto ones = _mm512_set1_ps(1);
+    auto o1 = _mm512_div_ps(ones, lo);
+    auto o2 = _mm512_div_ps(ones, hi);
+    return cvtfp32_fp16(o1, o2);
+  }
+  Vec256<Half> rsqrt() const {
+    __m512 lo, hi;
+    cvtfp16_fp32(values, lo, hi);
+    auto ones = _mm512_set1_ps(1);
+    auto o1 = _mm512_div_ps(ones, _mm512_sqrt_ps(lo));
+    auto o2 = _mm512_div_ps(ones, _mm512_sqrt_ps(hi));
+    return cvtfp32_fp16(o1, o2);
+  }
+  Vec256<Half> pow(const Vec256<Half> &b) const {
+    __m512 lo, hi;
+    __m512 b1, b2;
+    cvtfp16_fp32(values, lo, hi);
+    cvtfp16_fp32(b.values, b1, b2);
+    auto o1 = Sleef_powf16_u10(lo, b1);
+    auto o2 = Sleef_powf16_u10(hi, b2);
+    return cvtfp32_fp16(o1, o2);
+  }
+
+  Vec256<Half> inline operator>(const Vec256<Half>& other) const;
+  Vec256<Half> inline operator<(const Vec256<Half>& other) const;
+  Vec256<Half> inline operator>=(const Vec256<Half>& other) const;
+  Vec256<Half> inline operator<=(const Vec256<Half>& other) const;
+  Vec256<Half> inline operator==(const Vec256<Half>& other) const;
+  Vec256<Half> inline operator!=(const Vec256<Half>& other) const;
+
+  Vec256<Half> eq(const Vec256<Half>& other) const;
+  Vec256<Half> ne(const Vec256<Half>& other) const;
+  Vec256<Half> gt(const Vec256<Half>& other) const;
+  Vec256<Half> ge(const Vec256<Half>& other) const;
+  Vec256<Half> lt(const Vec256<Half>& other) const;
+  Vec256<Half> le(const Vec256<Half>& other) const;
+};
+
+template<typename Op>
+Vec256<Half> static inline half_binary_op_as_fp32(const Vec256<Half>& a, const Vec256<Half>& b, Op op) {
+  __m512 a_lo, a_hi;
+  __m512 b_lo, b_hi;
+  cvtfp16_fp32(__m512i(a), a_lo, a_hi);
+  cvtfp16_fp32(__m512i(b), b_lo, b_hi);
+  auto o1 = op(a_lo, b_lo);
+  auto o2 = op(a_hi, b_hi);
+  return cvtfp32_fp16(o1, o2);
+}
+
+Vec256<Half> inline Vec256<Half>::operator>(const Vec256<Half>& other) const {
+  return half_binary_op_as_fp32(*this, other, [](__m512 x, __m512 y) {
+    auto mask = _mm512_cmp_ps_mask(x, y, _CMP_GT_OQ);
+    return _mm512_castsi512_ps(_mm512_movm_epi32(mask));
+  });
+}
+Vec256<Half> inline Vec256<Half>::operator<(const Vec256<Half>& other) const {
+  return half_binary_op_as_fp32(*this, other, [](__m512 x, __m512 y) {
+    auto mask = _mm512_cmp_ps_mask(x, y, _CMP_LT_OQ);
+    return _mm512_castsi512_ps(_mm512_movm_epi32(mask));
+  });
+}
+Vec256<Half> inline Vec256<Half>::operator>=(const Vec256<Half>& other) const {
+  return half_binary_op_as_fp32(*this, other, [](__m512 x, __m512 y) {
+    auto mask = _mm512_cmp_ps_mask(x, y, _CMP_GE_OQ);
+    return _mm512_castsi512_ps(_mm512_movm_epi32(mask));
+  });
+}
+Vec256<Half> inline Vec256<Half>::operator<=(const Vec256<Half>& other) const {
+  return half_binary_op_as_fp32(*this, other, [](__m512 x, __m512 y) {
+    auto mask = _mm512_cmp_ps_mask(x, y, _CMP_LE_OQ);
+    return _mm512_castsi512_ps(_mm512_movm_epi32(mask));
+  });
+}
+Vec256<Half> inline Vec256<Half>::operator==(const Vec256<Half>& other) const {
+  return half_binary_op_as_fp32(*this, other, [](__m512 x, __m512 y) {
+    auto mask = _mm512_cmp_ps_mask(x, y, _CMP_EQ_OQ);
+    return _mm512_castsi512_ps(_mm512_movm_epi32(mask));
+  });
+}
+Vec256<Half> inline Vec256<Half>::operator!=(const Vec256<Half>& other) const {
+  return half_binary_op_as_fp32(*this, other, [](__m512 x, __m512 y) {
+    auto mask = _mm512_cmp_ps_mask(x, y, _CMP_NEQ_OQ);
+    return _mm512_castsi512_ps(_mm512_movm_epi32(mask));
+  });
+}
+
+Vec256<Half> inline operator+(const Vec256<Half>& a, const Vec256<Half>& b) {
+  return half_binary_op_as_fp32(a, b, [](const __m512& x, const __m512& y) { return _mm512_add_ps(x, y); });
+}
+Vec256<Half> inline operator-(const Vec256<Half>& a, const Vec256<Half>& b) {
+  return half_binary_op_as_fp32(a, b, [](const __m512& x, const __m512& y) { return _mm512_sub_ps(x, y); });
+}
+Vec256<Half> inline operator*(const Vec256<Half>& a, const Vec256<Half>& b) {
+  return half_binary_op_as_fp32(a, b, [](const __m512& x, const __m512& y) { return _mm512_mul_ps(x, y); });
+}
+Vec256<Half> inline operator/(const Vec256<Half>& a, const Vec256<Half>& b) {
+  return half_binary_op_as_fp32(a, b, [](const __m512& x, const __m512& y) { return _mm512_div_ps(x, y); });
+}
+
+Vec256<Half> inline operator&(const Vec256<Half>& a, const Vec256<Half>& b) {
+  return _mm512_and_si512(a, b);
+}
+Vec256<Half> inline operator|(const Vec256<Half>& a, const Vec256<Half>& b) {
+  return _mm512_or_si512(a, b);
+}
+Vec256<Half> inline operator^(const Vec256<Half>& a, const Vec256<Half>& b) {
+  return _mm512_xor_si512(a, b);
+}
+
+Vec256<Half> Vec256<Half>::eq(const Vec256<Half>& other) const {
+  return (*this == other) & Vec256<Half>(1.0f);
+}
+
+Vec256<Half> Vec256<Half>::ne(const Vec256<Half>& other) const {
+  return (*this != other) & Vec256<Half>(1.0f);
+}
+
+Vec256<Half> Vec256<Half>::gt(const Vec256<Half>& other) const {
+  return (*this > other) & Vec256<Half>(1.0f);
+}
+
+Vec256<Half> Vec256<Half>::ge(const Vec256<Half>& other) const {
+  return (*this >= other) & Vec256<Half>(1.0f);
+}
+
+Vec256<Half> Vec256<Half>::lt(const Vec256<Half>& other) const {
+  return (*this < other) & Vec256<Half>(1.0f);
+}
+
+Vec256<Half> Vec256<Half>::le(const Vec256<Half>& other) const {
+  return (*this <= other) & Vec256<Half>(1.0f);
+}
+
+// frac. Implement this here so we can use subtraction
+Vec256<Half> Vec256<Half>::frac() const {
+  return *this - this->trunc();
+}
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vec256<Half> inline maximum(const Vec256<Half>& a, const Vec256<Half>& b) {
+  __m512 a_lo, a_hi;
+  __m512 b_lo, b_hi;
+  cvtfp16_fp32(__m512i(a), a_lo, a_hi);
+  cvtfp16_fp32(__m512i(b), b_lo, b_hi);
+  auto max_lo = _mm512_max_ps(a_lo, b_lo);
+  auto max_hi = _mm512_max_ps(a_hi, b_hi);
+  auto nan_lo = _mm512_castsi512_ps(_mm512_movm_epi32(_mm512_cmp_ps_mask(a_lo, b_lo, _CMP_UNORD_Q)));
+  auto nan_hi = _mm512_castsi512_ps(_mm512_movm_epi32(_mm512_cmp_ps_mask(a_hi, b_hi, _CMP_UNORD_Q)));
+  // Exploit the fact that all-ones is a NaN.
+  auto o1 = _mm512_or_ps(max_lo, nan_lo);
+  auto o2 = _mm512_or_ps(max_hi, nan_hi);
+  return cvtfp32_fp16(o1, o2);
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vec256<Half> inline minimum(const Vec256<Half>& a, const Vec256<Half>& b) {
+  __m512 a_lo, a_hi;
+  __m512 b_lo, b_hi;
+  cvtfp16_fp32(__m512i(a), a_lo, a_hi);
+  cvtfp16_fp32(__m512i(b), b_lo, b_hi);
+  auto min_lo = _mm512_min_ps(a_lo, b_lo);
+  auto min_hi = _mm512_min_ps(a_hi, b_hi);
+  auto nan_lo = _mm512_castsi512_ps(_mm512_movm_epi32(_mm512_cmp_ps_mask(a_lo, b_lo, _CMP_UNORD_Q)));
+  auto nan_hi = _mm512_castsi512_ps(_mm512_movm_epi32(_mm512_cmp_ps_mask(a_hi, b_hi, _CMP_UNORD_Q)));
+  // Exploit the fact that all-ones is a NaN.
+  auto o1 = _mm512_or_ps(min_lo, nan_lo);
+  auto o2 = _mm512_or_ps(min_hi, nan_hi);
+  return cvtfp32_fp16(o1, o2);
+}
+
+template <>
+Vec256<Half> inline clamp(const Vec256<Half>& a,
+    const Vec256<Half>& min, const Vec256<Half>& max) {
+  __m512 a_lo, a_hi;
+  __m512 min_lo, min_hi;
+  __m512 max_lo, max_hi;
+  cvtfp16_fp32(__m512i(a), a_lo, a_hi);
+  cvtfp16_fp32(__m512i(min), min_lo, min_hi);
+  cvtfp16_fp32(__m512i(max), max_lo, max_hi);
+  auto o1 = _mm512_min_ps(max_lo, _mm512_max_ps(min_lo, a_lo));
+  auto o2 = _mm512_min_ps(max_hi, _mm512_max_ps(min_hi, a_hi));
+  return cvtfp32_fp16(o1, o2);
+}
+
+template <>
+Vec256<Half> inline clamp_max(const Vec256<Half>& a, const Vec256<Half>& max) {
+  __m512 a_lo, a_hi;
+  __m512 max_lo, max_hi;
+  cvtfp16_fp32(__m512i(a), a_lo, a_hi);
+  cvtfp16_fp32(__m512i(max), max_lo, max_hi);
+  auto o1 = _mm512_min_ps(max_lo, a_lo);
+  auto o2 = _mm512_min_ps(max_hi, a_hi);
+  return cvtfp32_fp16(o1, o2);
+}
+
+template <>
+Vec256<Half> inline clamp_min(const Vec256<Half>& a, const Vec256<Half>& min) {
+  __m512 a_lo, a_hi;
+  __m512 min_lo, min_hi;
+  cvtfp16_fp32(__m512i(a), a_lo, a_hi);
+  cvtfp16_fp32(__m512i(min), min_lo, min_hi);
+  auto o1 = _mm512_max_ps(min_lo, a_lo);
+  auto o2 = _mm512_max_ps(min_hi, a_hi);
+  return cvtfp32_fp16(o1, o2);
+}
+
+template <>
+inline void convert(const Half* src, Half* dst, int64_t n) {
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - Vec256<Half>::size()); i += Vec256<Half>::size()) {
+    auto vsrc = _mm512_loadu_si512(reinterpret_cast<__m512i*>((void*)(src + i)));
+    _mm512_storeu_si512(reinterpret_cast<__m512i*>((void*)(dst + i)), vsrc);
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = src[i];
+  }
+}
+
+template <>
+inline void convert(const Half* src, float* dst, int64_t n) {
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - Vec256<float>::size()); i += Vec256<float>::size()) {
+    auto vsrc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>((const void*)(src + i)));
+    _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(vsrc));
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const float* src, Half* dst, int64_t n) {
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - Vec256<float>::size()); i += Vec256<float>::size()) {
+    auto vsrc = _mm512_loadu_ps(src + i);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>((void*)(dst + i)),
+        _mm512_cvtps_ph(vsrc, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)));
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = static_cast<Half>(src[i]);
+  }
+}
+
+template <>
+Vec256<Half> inline fmadd(const Vec256<Half>& a,
+    const Vec256<Half>& b, const Vec256<Half>& c) {
+  __m512 a_lo, a_hi;
+  __m512 b_lo, b_hi;
+  __m512 c_lo, c_hi;
+  cvtfp16_fp32(__m512i(a), a_lo, a_hi);
+  cvtfp16_fp32(__m512i(b), b_lo, b_hi);
+  cvtfp16_fp32(__m512i(c), c_lo, c_hi);
+  auto o1 = _mm512_fmadd_ps(a_lo, b_lo, c_lo);
+  auto o2 = _mm512_fmadd_ps(a_hi, b_hi, c_hi);
+  return cvtfp32_fp16(o1, o2);
+}
+
+inline std::tuple<Vec256<float>, Vec256<float>> convert_half_float(const Vec256<Half>& a) {
+  __m512 o1, o2;
+  cvtfp16_fp32(__m512i(a), o1, o2);
+  return std::make_tuple(o1, o2);
+}
+
+inline Vec256<Half> convert_float_half(const Vec256<float>& a, const Vec256<float>& b) {
+  return cvtfp32_fp16(__m512(a), __m512(b));
+}
+
+#endif
+
+}}}
@@ -0,0 +1,547 @@
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256_base.h>
+#include <ATen/native/quantized/affine_quantizer.h>
+#include <c10/util/qint32.h>
+#include <c10/util/qint8.h>
+#include <c10/util/quint8.h>
+
+#include <array>
+
+// This file defines Vec256<> for the quantized types when compiling for
+// AVX512, see ATen/cpu/vec256/vec256_qint.h for the interface. A vector holds
+// 512 bits, so the conversions are:
+//  Vec256<qint8> (64 elements) -> 4x Vec256<float> (16 elements)
+//  Vec256<quint8> (64 elements) -> 4x Vec256<float> (16 elements)
+//  Vec256<qint32> (16 elements) -> 1x Vec256<float> (16 elements)
+
+namespace at {
+namespace vec256 {
+namespace {
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+struct Vec256qi {
+ protected:
+  __m512i vals __attribute__((aligned(64)));
+
+ public:
+  Vec256qi() {}
+  Vec256qi(__m512i v) : vals(v) {}
+  operator __m512i() const {
+    return vals;
+  }
+};
+
+template <typename T>
+inline void __attribute__((always_inline)) QuantizeAvx512(
+    const float* src,
+    typename T::underlying* dst,
+    int len,
+    float inverse_scale,
+    int64_t zero_point) {
+  constexpr int VLEN = 16;
+  constexpr auto min_val = std::numeric_limits<typename T::underlying>::min();
+  constexpr auto max_val = std::numeric_limits<typename T::underlying>::max();
+  const __m512i min_v = _mm512_set1_epi32(min_val);
+  const __m512i max_v = _mm512_set1_epi32(max_val);
+  // This is the largest int32 value < int32_max exactly representable in float
+  constexpr int32_t int32_float_max_val =
+      std::numeric_limits<int32_t>::max() - 127;
+  const __m512 inverse_scale_v = _mm512_set1_ps(inverse_scale);
+  const __m512i zero_point_v = _mm512_set1_epi32(zero_point);
+  int i = 0;
+  for (; i < len / VLEN * VLEN; i += VLEN) {
+    __m512 x_vals = _mm512_loadu_ps(src + i);
+    __m512 x_transformed_v = _mm512_mul_ps(x_vals, inverse_scale_v);
+    // If the floating point value is greater than int32_max,
+    // _mm512_cvtps_epi32 converts them to -ve. Clip at int32_float_max_val to
+    // avoid this.
+    x_transformed_v =
+        _mm512_min_ps(x_transformed_v, _mm512_set1_ps(int32_float_max_val));
+    __m512i x_rounded_v = _mm512_cvtps_epi32(x_transformed_v);
+    x_rounded_v = _mm512_add_epi32(x_rounded_v, zero_point_v);
+    __m512i x_clipped_v =
+        _mm512_max_epi32(min_v, _mm512_min_epi32(max_v, x_rounded_v));
+    // The values are already clipped, so a truncating narrow is exact and,
+    // unlike the AVX2 pack instructions, keeps the elements in order.
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + i), _mm512_cvtepi32_epi8(x_clipped_v));
+  }
+
+  for (; i < len; ++i) {
+    float transformed = src[i] * inverse_scale;
+    // See the note in QuantizeAvx2 about the rounding mode.
+    transformed = zero_point + nearbyint(transformed);
+    float clipped =
+        std::min(std::max(transformed, float(min_val)), float(max_val));
+    dst[i] = clipped;
+  }
+}
+
+template<>
+struct Vec256<c10::qint32> : public Vec256qi {
+    static constexpr int size() {
+        return 16;
+    }
+
+    static constexpr int float_num_vecs() {
+        return 1;
+    }
+
+    static constexpr int int_num_vecs() {
+        return 1;
+    }
+
+    using float_vec_return_type = std::array<Vec256<float>, 1>;
+    using int_vec_return_type = std::array<Vec256<c10::qint32>, 1>;
+    using value_type = c10::qint32::underlying;
+
+ public:
+    using Vec256qi::Vec256qi;
+    Vec256() {}
+
+    Vec256(__m512i vals_) { vals = vals_;}
+
+    // Broadcast constructor
+    Vec256(const c10::qint32& val) {
+        value_type uw = val.val_;
+        vals = _mm512_set1_epi32(uw);
+    }
+
+    void store(void* ptr, int count = size()) const {
+      if (count != size()) {
+        memcpy(ptr, &vals, count * sizeof(value_type));
+      } else {
+        _mm512_storeu_si512((__m512i*)ptr, vals);
+      }
+    }
+
+    static Vec256<c10::qint32> loadu(const void* ptr) {
+        return Vec256<c10::qint32>(ptr);
+    }
+
+    float_vec_return_type dequantize(
+        Vec256<float> scale,
+        Vec256<float> zero_point,
+        Vec256<float> scale_zp_premul) const {
+      __m512 float_vals = _mm512_cvtepi32_ps(vals);
+      return {vec256::fmadd(scale, Vec256<float>(float_vals), scale_zp_premul)};
+    }
+
+    static Vec256<c10::qint32> quantize(
+        const float_vec_return_type& rhs,
+        float scale,
+        int32_t zero_point,
+        float inverse_scale) {
+      Vec256<c10::qint32> retval;
+      auto rhs_data = (__m512)rhs[0];
+      at::native::quantize_vec<c10::qint32, /*precision=*/32>(
+          scale, zero_point, (float*)&rhs_data, (c10::qint32*)&retval.vals, 16);
+      return retval;
+    }
+
+    Vec256<c10::qint32> maximum(Vec256<c10::qint32> b) const {
+      return _mm512_max_epi32(vals, b.vals);
+    }
+
+    Vec256<c10::qint32> minimum(Vec256<c10::qint32> b) const {
+      return _mm512_min_epi32(vals, b.vals);
+    }
+
+    Vec256<c10::qint32> relu(Vec256<c10::qint32> zero_point) const {
+        return maximum(zero_point);
+    }
+
+    Vec256<c10::qint32> relu6(
+        Vec256<c10::qint32> zero_point,
+        Vec256<c10::qint32> q_six) {
+      return _mm512_min_epi32(
+          _mm512_max_epi32(vals, zero_point.vals), q_six.vals);
+    }
+
+    int_vec_return_type widening_subtract(Vec256<c10::qint32> b) const {
+      return {_mm512_sub_epi32(vals, b)};
+    }
+
+    static Vec256<c10::qint32> requantize_from_int(
+        const int_vec_return_type& inp,
+        float multiplier,
+        int32_t zero_point) {
+      __m512 multiplier_v = _mm512_set1_ps(multiplier);
+      __m512i zero_point_v = _mm512_set1_epi32(zero_point);
+
+      __m512 scaled = _mm512_mul_ps(_mm512_cvtepi32_ps(inp[0]), multiplier_v);
+      __m512i rounded = _mm512_cvtps_epi32(scaled);
+      return _mm512_add_epi32(rounded, zero_point_v);
+    }
+
+    void dump() const {
+        for (size_t i = 0; i < size(); ++i) {
+          std::cout << ((int32_t*)&vals)[i] << " ";
+        }
+        std::cout << std::endl;
+    }
+ private:
+    // Load from memory constructor
+    Vec256(const void* ptr) {
+      vals = _mm512_loadu_si512((const __m512i*)ptr);
+    }
+};
+
+template <>
+Vec256<c10::qint32> inline maximum(const Vec256<c10::qint32>& a, const Vec256<c10::qint32>& b) {
+  return a.maximum(b);
+}
+
+template <>
+Vec256<c10::qint32> inline operator*(
+    const Vec256<c10::qint32>& a,
+    const Vec256<c10::qint32>& b) {
+  return _mm512_mullo_epi32(a, b);
+}
+
+template <>
+Vec256<c10::qint32> inline operator+(
+    const Vec256<c10::qint32>& a,
+    const Vec256<c10::qint32>& b) {
+  return _mm512_add_epi32(a, b);
+}
+
+/*
+ * Convert values from int32 back to int8/uint8
+ */
+template <typename T>
+__m512i RequantizeAvx512(
+    const std::array<Vec256<c10::qint32>, 4>& inp,
+    __m512 multiplier,
+    __m512i zp) {
+  static_assert(
+      std::is_same<T, int8_t>::value || std::is_same<T, uint8_t>::value,
+      "Only int8_t/uint8_t are supported");
+  constexpr auto min_val = std::numeric_limits<T>::min();
+  constexpr auto max_val = std::numeric_limits<T>::max();
+  const __m512i min_v = _mm512_set1_epi32(min_val);
+  const __m512i max_v = _mm512_set1_epi32(max_val);
+  __m512 x_scaled_v = _mm512_mul_ps(_mm512_cvtepi32_ps(inp[0]), multiplier);
+  __m512 y_scaled_v = _mm512_mul_ps(_mm512_cvtepi32_ps(inp[1]), multiplier);
+  __m512 z_scaled_v = _mm512_mul_ps(_mm512_cvtepi32_ps(inp[2]), multiplier);
+  __m512 w_scaled_v = _mm512_mul_ps(_mm512_cvtepi32_ps(inp[3]), multiplier);
+
+  /* Round and add zero point */
+  __m512i x_v = _mm512_add_epi32(_mm512_cvtps_epi32(x_scaled_v), zp);
+  __m512i y_v = _mm512_add_epi32(_mm512_cvtps_epi32(y_scaled_v), zp);
+  __m512i z_v = _mm512_add_epi32(_mm512_cvtps_epi32(z_scaled_v), zp);
+  __m512i w_v = _mm512_add_epi32(_mm512_cvtps_epi32(w_scaled_v), zp);
+
+  /* Clamp */
+  x_v = _mm512_max_epi32(min_v, _mm512_min_epi32(max_v, x_v));
+  y_v = _mm512_max_epi32(min_v, _mm512_min_epi32(max_v, y_v));
+  z_v = _mm512_max_epi32(min_v, _mm512_min_epi32(max_v, z_v));
+  w_v = _mm512_max_epi32(min_v, _mm512_min_epi32(max_v, w_v));
+
+  /*
+   * Narrow to 8 bits, the values are in range after clamping. Unlike the
+   * AVX2 pack instructions this keeps the elements in order, so no permute
+   * is needed: x0-15 y0-15 z0-15 w0-15
+   */
+  __m512i xyzw_v = _mm512_castsi128_si512(_mm512_cvtepi32_epi8(x_v));
+  xyzw_v = _mm512_inserti32x4(xyzw_v, _mm512_cvtepi32_epi8(y_v), 1);
+  xyzw_v = _mm512_inserti32x4(xyzw_v, _mm512_cvtepi32_epi8(z_v), 2);
+  xyzw_v = _mm512_inserti32x4(xyzw_v, _mm512_cvtepi32_epi8(w_v), 3);
+  return xyzw_v;
+}
+
+template<>
+struct Vec256<c10::qint8> : public Vec256qi {
+    static constexpr int size() {
+        return 64;
+    }
+
+    static constexpr int float_num_vecs() {
+        return 4;
+    }
+
+    static constexpr int int_num_vecs() {
+        return 4;
+    }
+
+    using float_vec_return_type = std::array<Vec256<float>, 4>;
+    using int_vec_return_type = std::array<Vec256<c10::qint32>, 4>;
+    using value_type = typename c10::qint8::underlying;
+
+ public:
+    using Vec256qi::Vec256qi;
+
+    Vec256() {}
+    Vec256(__m512i vals_) { vals = vals_;}
+
+    // Broadcast constructor
+    Vec256(const c10::qint8& val) {
+        value_type uw = val.val_;
+        vals = _mm512_set1_epi8(uw);
+    }
+
+    // This is needed because the compiler emits awful code for the default
+    // constructor for moving the enum
+    Vec256(const Vec256<c10::qint8>& other) : Vec256qi(other.vals) { }
+
+    void store(void* ptr, int count = size()) const {
+        if (count != size()) {
+            memcpy(ptr, &vals, count * sizeof(value_type));
+        } else {
+            _mm512_storeu_si512((__m512i*)ptr, vals);
+        }
+    }
+
+    static Vec256<c10::qint8> loadu(const void* ptr) {
+        return Vec256<c10::qint8>(ptr);
+    }
+
+ private:
+    // Sign-extends the 16 int8 values of the 128-bit lane `lane` to int32.
+    template <int lane>
+    static __m512i cvtepi8_epi32(__m512i epi8_vals) {
+        return _mm512_cvtepi8_epi32(_mm512_extracti32x4_epi32(epi8_vals, lane));
+    }
+
+ public:
+  float_vec_return_type dequantize(
+      Vec256<float> scale,
+      Vec256<float> zero_point,
+      Vec256<float> scale_neg_zp_premul) const {
+    __m512 float_val0 = _mm512_cvtepi32_ps(cvtepi8_epi32<0>(vals));
+    __m512 float_val1 = _mm512_cvtepi32_ps(cvtepi8_epi32<1>(vals));
+    __m512 float_val2 = _mm512_cvtepi32_ps(cvtepi8_epi32<2>(vals));
+    __m512 float_val3 = _mm512_cvtepi32_ps(cvtepi8_epi32<3>(vals));
+
+    auto val0 =
+        vec256::fmadd(scale, Vec256<float>(float_val0), scale_neg_zp_premul);
+    auto val1 =
+        vec256::fmadd(scale, Vec256<float>(float_val1), scale_neg_zp_premul);
+    auto val2 =
+        vec256::fmadd(scale, Vec256<float>(float_val2), scale_neg_zp_premul);
+    auto val3 =
+        vec256::fmadd(scale, Vec256<float>(float_val3), scale_neg_zp_premul);
+    return {val0, val1, val2, val3};
+  }
+
+  static Vec256<c10::qint8> quantize(
+      const float_vec_return_type& rhs,
+      float scale,
+      int32_t zero_point,
+      float inverse_scale) {
+    auto* rhs_data = (float*)rhs.data();
+    int8_t quantized_values[64];
+    QuantizeAvx512<c10::qint8>(
+        rhs_data, quantized_values, 64, inverse_scale, zero_point);
+    return Vec256<c10::qint8>::loadu(quantized_values);
+  }
+
+  Vec256<c10::qint8> maximum(Vec256<c10::qint8> b) const {
+      return _mm512_max_epi8(vals, b.vals);
+    }
+
+  Vec256<c10::qint8> minimum(Vec256<c10::qint8> b) const {
+      return _mm512_min_epi8(vals, b.vals);
+    }
+
+    Vec256<c10::qint8> relu(Vec256<c10::qint8> zero_point) const {
+        return maximum(zero_point);
+    }
+
+    Vec256<c10::qint8> relu6(
+        Vec256<c10::qint8> zero_point,
+        Vec256<c10::qint8> q_six) {
+      return _mm512_min_epi8(
+          _mm512_max_epi8(vals, zero_point.vals), q_six.vals);
+    }
+
+    int_vec_return_type widening_subtract(Vec256<c10::qint8> b) const {
+      __m512i res_0 = _mm512_sub_epi32(cvtepi8_epi32<0>(vals), cvtepi8_epi32<0>(b));
+      __m512i res_1 = _mm512_sub_epi32(cvtepi8_epi32<1>(vals), cvtepi8_epi32<1>(b));
+      __m512i res_2 = _mm512_sub_epi32(cvtepi8_epi32<2>(vals), cvtepi8_epi32<2>(b));
+      __m512i res_3 = _mm512_sub_epi32(cvtepi8_epi32<3>(vals), cvtepi8_epi32<3>(b));
+
+      return {Vec256<c10::qint32>(res_0),
+              Vec256<c10::qint32>(res_1),
+              Vec256<c10::qint32>(res_2),
+              Vec256<c10::qint32>(res_3)};
+    }
+
+    static Vec256<c10::qint8> requantize_from_int(
+        const int_vec_return_type& inp,
+        float multiplier,
+        int32_t zero_point) {
+      __m512 multiplier_v = _mm512_set1_ps(multiplier);
+      __m512i zero_point_v = _mm512_set1_epi32(zero_point);
+      return RequantizeAvx512<value_type>(inp, multiplier_v, zero_point_v);
+    }
+
+    void dump() const {
+        for (size_t i = 0; i < size(); ++i) {
+            std::cout << (int)((value_type*)&vals)[i] << " ";
+        }
+        std::cout << std::endl;
+    }
+ private:
+    // Load from memory constructor
+    Vec256(const void* ptr) {
+        vals = _mm512_loadu_si512((const __m512i*)ptr);
+    }
+};
+
+template <>
+Vec256<c10::qint8> inline maximum(const Vec256<c10::qint8>& a, const Vec256<c10::qint8>& b) {
+  return a.maximum(b);
+}
+
+template<>
+struct Vec256<c10::quint8> : public Vec256qi {
+    static constexpr int size() {
+        return 64;
+    }
+
+    static constexpr int float_num_vecs() {
+        return 4;
+    }
+
+    static constexpr int int_num_vecs() {
+        return 4;
+    }
+
+    using float_vec_return_type = std::array<Vec256<float>, 4>;
+    using int_vec_return_type = std::array<Vec256<c10::qint32>, 4>;
+    using value_type = typename c10::quint8::underlying;
+
+ public:
+    using Vec256qi::Vec256qi;
+    Vec256() {}
+
+    Vec256(__m512i vals_) { vals = vals_;}
+
+    // Broadcast constructor
+    Vec256(const c10::quint8& val) {
+        value_type uw = val.val_;
+        vals = _mm512_set1_epi8(uw);
+    }
+
+    Vec256(const Vec256<c10::quint8>& other) : Vec256qi(other.vals) { }
+
+    void store(void* ptr, int count = size()) const {
+        if (count != size()) {
+            memcpy(ptr, &vals, count * sizeof(value_type));
+        } else {
+            _mm512_storeu_si512((__m512i*)ptr, vals);
+        }
+    }
+
+    static Vec256<c10::quint8> loadu(const void* ptr) {
+        return Vec256<c10::quint8>(ptr);
+    }
+
+ private:
+    // Zero-extends the 16 uint8 values of the 128-bit lane `lane` to int32.
+    template <int lane>
+    static __m512i cvtepu8_epi32(__m512i epu8_vals) {
+        return _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(epu8_vals, lane));
+    }
+
+ public:
+  float_vec_return_type dequantize(
+      Vec256<float> scale,
+      Vec256<float> zero_point,
+      Vec256<float> scale_zp_premul) const {
+    __m512 float_val0 = _mm512_cvtepi32_ps(cvtepu8_epi32<0>(vals));
+    __m512 float_val1 = _mm512_cvtepi32_ps(cvtepu8_epi32<1>(vals));
+    __m512 float_val2 = _mm512_cvtepi32_ps(cvtepu8_epi32<2>(vals));
+    __m512 float_val3 = _mm512_cvtepi32_ps(cvtepu8_epi32<3>(vals));
+
+    auto val0 =
+        vec256::fmadd(scale, Vec256<float>(float_val0), scale_zp_premul);
+    auto val1 =
+        vec256::fmadd(scale, Vec256<float>(float_val1), scale_zp_premul);
+    auto val2 =
+        vec256::fmadd(scale, Vec256<float>(float_val2), scale_zp_premul);
+    auto val3 =
+        vec256::fmadd(scale, Vec256<float>(float_val3), scale_zp_premul);
+    return {val0, val1, val2, val3};
+  }
+
+  static Vec256<c10::quint8> quantize(
+      const float_vec_return_type& rhs,
+      float scale,
+      int32_t zero_point,
+      float inverse_scale) {
+    auto* rhs_data = (float*)rhs.data();
+    uint8_t quantized_values[64];
+    QuantizeAvx512<c10::quint8>(
+        rhs_data, quantized_values, 64, inverse_scale, zero_point);
+    return Vec256<c10::quint8>::loadu(quantized_values);
+  }
+
+  Vec256<c10::quint8> maximum(Vec256<c10::quint8> b) const {
+      return _mm512_max_epu8(vals, b.vals);
+    }
+
+  Vec256<c10::quint8> minimum(Vec256<c10::quint8> b) const {
+      return _mm512_min_epu8(vals, b.vals);
+    }
+
+    Vec256<c10::quint8> relu(Vec256<c10::quint8> zero_point) const {
+        return maximum(zero_point);
+    }
+
+    Vec256<c10::quint8> relu6(
+        Vec256<c10::quint8> zero_point,
+        Vec256<c10::quint8> q_six) {
+      return _mm512_min_epu8(
+          _mm512_max_epu8(vals, zero_point.vals), q_six.vals);
+    }
+
+    int_vec_return_type widening_subtract(Vec256<c10::quint8> b) const {
+      __m512i res_0 = _mm512_sub_epi32(cvtepu8_epi32<0>(vals), cvtepu8_epi32<0>(b));
+      __m512i res_1 = _mm512_sub_epi32(cvtepu8_epi32<1>(vals), cvtepu8_epi32<1>(b));
+      __m512i res_2 = _mm512_sub_epi32(cvtepu8_epi32<2>(vals), cvtepu8_epi32<2>(b));
+      __m512i res_3 = _mm512_sub_epi32(cvtepu8_epi32<3>(vals), cvtepu8_epi32<3>(b));
+
+      return {Vec256<c10::qint32>(res_0),
+              Vec256<c10::qint32>(res_1),
+              Vec256<c10::qint32>(res_2),
+              Vec256<c10::qint32>(res_3)};
+    }
+
+    static Vec256<c10::quint8> requantize_from_int(
+        const int_vec_return_type& inp,
+        float multiplier,
+        int32_t zero_point) {
+      __m512 multiplier_v = _mm512_set1_ps(multiplier);
+      __m512i zero_point_v = _mm512_set1_epi32(zero_point);
+      return RequantizeAvx512<value_type>(inp, multiplier_v, zero_point_v);
+    }
+
+    void dump() const {
+        for (size_t i = 0; i < size(); ++i) {
+            std::cout << (int)((value_type*)&vals)[i] << " ";
+        }
+        std::cout << std::endl;
+    }
+ private:
+    // Load from memory constructor
+    Vec256(const void* ptr) {
+        vals = _mm512_loadu_si512((const __m512i*)ptr);
+    }
+};
+
+template <>
+Vec256<c10::quint8> inline maximum(const Vec256<c10::quint8>& a, const Vec256<c10::quint8>& b) {
+  return a.maximum(b);
+}
+
+#endif // defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+}}}
@@ -44,10 +44,10 @@
   volatile value_t x = (value_t)(1);                          \
   x = std::op(x);                                             \
   _mm256_zeroall();
-#define DL_RUNTIME_BUG_BFLOAT16() _mm256_zeroall();
+#define DL_RUNTIME_BUG_REDUCED_FLOAT() _mm256_zeroall();
 #else
 #define DL_RUNTIME_BUG(op, type)
-#define DL_RUNTIME_BUG_BFLOAT16()
+#define DL_RUNTIME_BUG_REDUCED_FLOAT()
 #endif
 
 namespace at {
@@ -77,8 +77,8 @@ inline void vrsqrt(scalar_t* out, scalar_t* in, int64_t size) {
 // this. This duplication is also necessary since not all functions (e.g. rsqrt)
 // might be part of cmath.
 
-// for BFloat16, we need specialize it, the reason is that avx/avx2 and glic=2.23,
-// we can't give DL_RUNTIME_BUG volatile type in x = std::op(x);
+// for BFloat16 and Half, we need specialize it, the reason is that avx/avx2 and
+// glic=2.23, we can't give DL_RUNTIME_BUG volatile type in x = std::op(x);
 
 #define IMPLEMENT_VML_BUG(op)                                                     \
   template <typename scalar_t>                                                    \
@@ -95,12 +95,23 @@ inline void vrsqrt(scalar_t* out, scalar_t* in, int64_t size) {
   inline void v##op<c10::BFloat16>(                                               \
       c10::BFloat16* out, const c10::BFloat16* in, int64_t size) {                \
     parallel_for(0, size, 2048, [out, in](int64_t begin, int64_t end) {           \
-      DL_RUNTIME_BUG_BFLOAT16()                                                   \
+      DL_RUNTIME_BUG_REDUCED_FLOAT()                                              \
       map([](const Vec256<c10::BFloat16>& x) { return x.op(); },                  \
           out + begin,                                                            \
           in + begin,                                                             \
           end - begin);                                                           \
     });                                                                           \
+  }                                                                               \
+  template <>                                                                     \
+  inline void v##op<c10::Half>(                                                   \
+      c10::Half* out, const c10::Half* in, int64_t size) {                        \
+    parallel_for(0, size, 2048, [out, in](int64_t begin, int64_t end) {           \
+      DL_RUNTIME_BUG_REDUCED_FLOAT()                                              \
+      map([](const Vec256<c10::Half>& x) { return x.op(); },                      \
+          out + begin,                                                            \
+          in + begin,                                                             \
+          end - begin);                                                           \
+    });                                                                           \
   }
 
 #define IMPLEMENT_VML(op)                                              \
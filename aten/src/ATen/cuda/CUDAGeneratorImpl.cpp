@@ -2,6 +2,8 @@
 #include <c10/cuda/CUDAFunctions.h>
 #include <ATen/Utils.h>
 
+#include <limits>
+
 namespace at {
 
 namespace cuda { namespace detail {
@@ -144,11 +146,68 @@ uint64_t CUDAGeneratorImpl::philox_offset_per_thread() {
  * See Note [Acquire lock when using random generators]
  */
 std::pair<uint64_t, uint64_t> CUDAGeneratorImpl::philox_engine_inputs(uint64_t increment) {
+  TORCH_CHECK(!graph_expects_this_gen_,
+              "This random number generator operation does not support CUDA graph capture. "
+              "Only operations that read their philox inputs through philox_cuda_state, "
+              "such as dropout, can be captured.");
   uint64_t offset = this->philox_offset_per_thread_;
   this->philox_offset_per_thread_ += increment;
   return std::make_pair(this->seed_, offset);
 }
 
+/**
+ * Like philox_engine_inputs, but returns a PhiloxCudaState that stays valid
+ * when the kernel launch is captured into a CUDA graph. Kernels must read it
+ * with at::cuda::philox::unpack.
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+PhiloxCudaState CUDAGeneratorImpl::philox_cuda_state(uint64_t increment) {
+  // curand consumes philox outputs four at a time; keep every launch's
+  // offset aligned so that replays reproduce eager results.
+  increment = ((increment + 3) / 4) * 4;
+  if (graph_expects_this_gen_) {
+    TORCH_INTERNAL_ASSERT(this->offset_intragraph_ % 4 == 0);
+    uint32_t offset = this->offset_intragraph_;
+    TORCH_INTERNAL_ASSERT(this->offset_intragraph_ <=
+                          std::numeric_limits<uint32_t>::max() - increment);
+    this->offset_intragraph_ += increment;
+    return PhiloxCudaState(this->seed_extragraph_, this->offset_extragraph_, offset);
+  } else {
+    uint64_t offset = this->philox_offset_per_thread_;
+    this->philox_offset_per_thread_ += increment;
+    return PhiloxCudaState(this->seed_, offset);
+  }
+}
+
+/**
+ * Called by CUDAGraph before capture begins. Until capture_epilogue,
+ * philox_cuda_state hands out device pointers to seed_extragraph and
+ * offset_extragraph, which CUDAGraph::replay fills before each launch, and
+ * philox_engine_inputs refuses to run.
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+void CUDAGeneratorImpl::capture_prologue(int64_t* seed_extragraph, int64_t* offset_extragraph) {
+  TORCH_CHECK(!graph_expects_this_gen_,
+              "The CUDA generator is already used by a graph capture underway");
+  seed_extragraph_ = seed_extragraph;
+  offset_extragraph_ = offset_extragraph;
+  offset_intragraph_ = 0;
+  graph_expects_this_gen_ = true;
+}
+
+/**
+ * Called by CUDAGraph when capture ends. Returns the philox offset consumed by
+ * one replay of the graph, by which each replay advances the generator.
+ */
+uint64_t CUDAGeneratorImpl::capture_epilogue() {
+  graph_expects_this_gen_ = false;
+  seed_extragraph_ = nullptr;
+  offset_extragraph_ = nullptr;
+  return offset_intragraph_;
+}
+
 /*
  * Gets the DeviceType of CUDAGeneratorImpl.
  * Used for type checking during run time.
@@ -0,0 +1,159 @@
+#include <ATen/cuda/CUDAGraph.h>
+
+#include <ATen/ATen.h>
+#include <ATen/CUDAGeneratorImpl.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+#include <ATen/Utils.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace at {
+namespace cuda {
+
+namespace {
+
+#if defined(CUDART_VERSION) && CUDART_VERSION >= 11000
+CUDAGeneratorImpl* current_generator() {
+  return at::check_generator<CUDAGeneratorImpl>(
+      cuda::detail::getDefaultCUDAGenerator());
+}
+#endif
+
+void check_graphs_supported() {
+#if !defined(CUDART_VERSION) || CUDART_VERSION < 11000
+  TORCH_CHECK(false, "CUDA graphs may only be used in PyTorch built with CUDA >= 11.0");
+#endif
+}
+
+} // namespace
+
+CUDAGraph::CUDAGraph() {
+  check_graphs_supported();
+}
+
+void CUDAGraph::capture_begin() {
+#if defined(CUDART_VERSION) && CUDART_VERSION >= 11000
+  TORCH_CHECK(!has_graph_exec_,
+              "This CUDAGraph instance already owns a captured graph. "
+              "To capture a new graph, create a new instance or call reset() first.");
+
+  auto stream = at::cuda::getCurrentCUDAStream();
+  TORCH_CHECK(stream != at::cuda::getDefaultCUDAStream(),
+              "CUDA graphs must be captured on a non-default stream. "
+              "(However, after capture, it's ok to replay them on the default stream.)");
+  capture_stream_ = stream;
+  capture_dev_ = c10::cuda::current_device();
+
+  // The seed and offset of each replay are written to these tensors before
+  // the graph is launched, see replay().
+  auto options = TensorOptions().device(at::kCUDA).dtype(at::kLong);
+  seed_extragraph_ = at::empty({1}, options);
+  offset_extragraph_ = at::empty({1}, options);
+
+  auto* gen = current_generator();
+  {
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    gen->capture_prologue(seed_extragraph_.data_ptr<int64_t>(),
+                          offset_extragraph_.data_ptr<int64_t>());
+  }
+
+  // Each graph gets its own pool, so that memory freed during capture is
+  // only ever reused by later allocations of the same capture.
+  static std::atomic<uint64_t> graph_count{0};
+  mempool_ = "__cuda_graph_" + std::to_string(graph_count++);
+
+  // Relaxed mode lets the caching allocator call cudaMalloc (and query
+  // events of other streams) while the capture is underway.
+  AT_CUDA_CHECK(cudaStreamBeginCapture(stream, cudaStreamCaptureModeRelaxed));
+
+  cudaStreamCaptureStatus status;
+  AT_CUDA_CHECK(cudaStreamGetCaptureInfo(stream, &status, &id_));
+  TORCH_INTERNAL_ASSERT(status == cudaStreamCaptureStatusActive);
+
+  c10::cuda::CUDACachingAllocator::notifyCaptureBegin(capture_dev_, id_, mempool_);
+#endif
+}
+
+void CUDAGraph::capture_end() {
+#if defined(CUDART_VERSION) && CUDART_VERSION >= 11000
+  auto stream = at::cuda::getCurrentCUDAStream();
+
+  TORCH_CHECK(capture_stream_.has_value() && stream == *capture_stream_,
+              "Capture must end on the same stream it began on.");
+
+  c10::cuda::CUDACachingAllocator::notifyCaptureEnd(capture_dev_, id_);
+
+  auto* gen = current_generator();
+  {
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    wholegraph_increment_ = gen->capture_epilogue();
+  }
+
+  AT_CUDA_CHECK(cudaStreamEndCapture(stream, &graph_));
+  TORCH_CHECK(graph_ != nullptr, "Invalid capturing.");
+  has_graph_ = true;
+
+  AT_CUDA_CHECK(cudaGraphInstantiate(&graph_exec_, graph_, nullptr, nullptr, 0));
+  has_graph_exec_ = true;
+
+  // The executable graph holds everything replay needs.
+  AT_CUDA_CHECK(cudaGraphDestroy(graph_));
+  has_graph_ = false;
+#endif
+}
+
+void CUDAGraph::replay() {
+#if defined(CUDART_VERSION) && CUDART_VERSION >= 11000
+  TORCH_CHECK(has_graph_exec_,
+              "Called CUDAGraph::replay without a preceding successful capture.");
+
+  c10::cuda::CUDAGuard device_guard{static_cast<c10::DeviceIndex>(capture_dev_)};
+
+  // Advance the generator as if the captured kernels ran eagerly, and tell
+  // them where to start.
+  auto* gen = current_generator();
+  {
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    seed_extragraph_.fill_(static_cast<int64_t>(gen->current_seed()));
+    const uint64_t offset = gen->philox_offset_per_thread();
+    offset_extragraph_.fill_(static_cast<int64_t>(offset));
+    gen->set_philox_offset_per_thread(offset + wholegraph_increment_);
+  }
+
+  // The fills above and the launch below are ordered on the current stream.
+  AT_CUDA_CHECK(cudaGraphLaunch(graph_exec_, at::cuda::getCurrentCUDAStream()));
+#endif
+}
+
+void CUDAGraph::reset() {
+#if defined(CUDART_VERSION) && CUDART_VERSION >= 11000
+  // Called by the destructor, so errors are only warned about.
+  if (has_graph_) {
+    C10_CUDA_CHECK_WARN(cudaGraphDestroy(graph_));
+    has_graph_ = false;
+  }
+  if (has_graph_exec_) {
+    C10_CUDA_CHECK_WARN(cudaGraphExecDestroy(graph_exec_));
+    has_graph_exec_ = false;
+  }
+  if (!mempool_.empty()) {
+    // Let the allocator return the graph's memory once nothing uses it.
+    c10::cuda::CUDACachingAllocator::notifyCaptureDestroy(capture_dev_, mempool_);
+    mempool_.clear();
+  }
+  seed_extragraph_.reset();
+  offset_extragraph_.reset();
+  wholegraph_increment_ = 0;
+#endif
+}
+
+CUDAGraph::~CUDAGraph() {
+  reset();
+}
+
+} // namespace cuda
+} // namespace at
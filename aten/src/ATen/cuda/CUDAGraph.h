@@ -0,0 +1,77 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <ATen/cuda/ATenCUDAGeneral.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAStream.h>
+#include <c10/util/Optional.h>
+
+#include <cuda_runtime_api.h>
+
+#include <string>
+
+namespace at {
+namespace cuda {
+
+/*
+* CUDAGraph captures the CUDA work issued on the current stream between
+* capture_begin() and capture_end(), and replays it with a single
+* cudaGraphLaunch. Replays skip the CPU overhead of launching every kernel, so
+* static-shape workloads made of many small kernels (inference, or a whole
+* training step with fixed inputs) run faster.
+*
+* A replay reads and writes the same memory as the capture: new data is copied
+* into the tensors that were used as inputs during capture, and the outputs of
+* the captured work are read back from the tensors produced during capture.
+* Memory allocated during capture comes from a private pool of the caching
+* allocator, which is reserved for the graph until it is reset or destroyed.
+* Kernels drawing random numbers through CUDAGeneratorImpl::philox_cuda_state
+* (e.g. dropout) get fresh random numbers on each replay; other random number
+* generator operations fail during capture.
+*
+* Capture must happen on a non-default stream, and the captured work must not
+* synchronize with the CPU. Requires CUDA 11.
+*/
+struct TORCH_CUDA_API CUDAGraph {
+  CUDAGraph();
+  ~CUDAGraph();
+
+  CUDAGraph(const CUDAGraph&) = delete;
+  CUDAGraph& operator=(const CUDAGraph&) = delete;
+
+  void capture_begin();
+  void capture_end();
+  void replay();
+  void reset();
+
+ protected:
+#if defined(CUDART_VERSION) && CUDART_VERSION >= 11000
+  cudaGraph_t graph_ = nullptr;
+  cudaGraphExec_t graph_exec_ = nullptr;
+#endif
+
+  // internal states for error checking
+  bool has_graph_ = false;
+  bool has_graph_exec_ = false;
+
+  // id of the capture, used by the caching allocator to route allocations
+  c10::cuda::CUDACachingAllocator::CaptureId_t id_ = 0;
+
+  // the caching allocator pool holding the memory used by the graph
+  std::string mempool_;
+
+  // stream on which capture began
+  c10::optional<c10::cuda::CUDAStream> capture_stream_;
+
+  // device on which capture occurred
+  int capture_dev_ = -1;
+
+  // philox seed and base offset of each replay, read by the captured kernels
+  at::Tensor seed_extragraph_;
+  at::Tensor offset_extragraph_;
+  // philox offset consumed by one replay
+  uint64_t wholegraph_increment_ = 0;
+};
+
+} // namespace cuda
+} // namespace at
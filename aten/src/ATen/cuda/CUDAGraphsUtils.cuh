@@ -0,0 +1,48 @@
+#pragma once
+
+#include <ATen/CUDAGeneratorImpl.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+
+#include <tuple>
+
+namespace at {
+namespace cuda {
+namespace philox {
+
+// In-kernel call to retrieve the philox seed and offset of a launch from a
+// PhiloxCudaState: for captured launches they are read from the tensors
+// filled by CUDAGraph::replay.
+__device__ __forceinline__ std::tuple<uint64_t, uint64_t>
+unpack(at::PhiloxCudaState arg) {
+  if (arg.captured_) {
+    return std::make_tuple(
+        static_cast<uint64_t>(*arg.seed_.ptr),
+        static_cast<uint64_t>(*(arg.offset_.ptr) + arg.offset_intragraph_));
+  } else {
+    return std::make_tuple(arg.seed_.val, arg.offset_.val);
+  }
+}
+
+} // namespace philox
+
+// Whether the current stream is being captured into a CUDA graph.
+inline bool currentStreamIsCapturing() {
+#if defined(CUDART_VERSION) && CUDART_VERSION >= 11000
+  cudaStreamCaptureStatus status;
+  AT_CUDA_CHECK(cudaStreamIsCapturing(at::cuda::getCurrentCUDAStream(), &status));
+  return status != cudaStreamCaptureStatusNone;
+#else
+  return false;
+#endif
+}
+
+// Fails if the current stream is being captured, for operations that
+// cannot be replayed from a CUDA graph.
+inline void assertNotCapturing(const char* op) {
+  TORCH_CHECK(!currentStreamIsCapturing(),
+              op, " is not supported during CUDA graph capture");
+}
+
+} // namespace cuda
+} // namespace at
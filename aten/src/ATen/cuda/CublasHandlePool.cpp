@@ -1,5 +1,11 @@
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/detail/DeviceThreadHandles.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <utility>
 
 namespace at { namespace cuda {
 namespace {
@@ -30,6 +36,64 @@ auto pool = std::make_shared<DeviceThreadHandlePool<cublasHandle_t, createCublas
 // releasing its reserved handles back to the pool.
 thread_local std::unique_ptr<decltype(pool)::element_type::PoolWindow> myPoolWindow;
 
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+// Size of the workspace given to cuBLAS, read from CUBLAS_WORKSPACE_CONFIG
+// (":SIZE:COUNT" pairs, SIZE in KiB, e.g. ":4096:8") like cuBLAS itself does.
+// Defaults to the size cuBLAS reserves for its own default workspace.
+size_t parseChosenWorkspaceSize() {
+  constexpr size_t kDefaultWorkspaceSize = 4096 * 1024 * 2 + 16 * 1024 * 8;
+  const char* env = std::getenv("CUBLAS_WORKSPACE_CONFIG");
+  if (!env) {
+    return kDefaultWorkspaceSize;
+  }
+  const std::string config(env);
+  size_t total_size = 0;
+  size_t pos = 0;
+  try {
+    while (pos < config.size()) {
+      TORCH_CHECK(config[pos] == ':', "expected ':'");
+      size_t len = 0;
+      const size_t size_kib = std::stoul(config.substr(pos + 1), &len);
+      pos += 1 + len;
+      TORCH_CHECK(pos < config.size() && config[pos] == ':', "expected ':'");
+      const size_t count = std::stoul(config.substr(pos + 1), &len);
+      pos += 1 + len;
+      total_size += size_kib * 1024 * count;
+    }
+  } catch (const std::exception&) {
+    TORCH_CHECK(
+        false,
+        "CUBLAS_WORKSPACE_CONFIG: expected \":SIZE:COUNT\" pairs, got ",
+        config);
+  }
+  return total_size > 0 ? total_size : kDefaultWorkspaceSize;
+}
+
+size_t getChosenWorkspaceSize() {
+  static size_t workspace_size = parseChosenWorkspaceSize();
+  return workspace_size;
+}
+
+// cublasSetStream resets the handle to the library's default workspace, which
+// cuBLAS allocates and frees behind our back. Instead each (handle, stream)
+// pair of a thread gets one workspace from the caching allocator, allocated
+// on that stream, so that it is reused by every call and shows up in the
+// allocator stats. Kernels using a workspace are ordered on its stream, so it
+// can go back to the allocator when the thread exits.
+using CublasHandleStreamKey = std::pair<cublasHandle_t, cudaStream_t>;
+thread_local std::map<CublasHandleStreamKey, at::DataPtr> myWorkspaces;
+
+void* getWorkspace(cublasHandle_t handle, cudaStream_t stream) {
+  auto key = std::make_pair(handle, stream);
+  auto it = myWorkspaces.find(key);
+  if (it == myWorkspaces.end()) {
+    it = myWorkspaces.emplace(
+        key, c10::cuda::CUDACachingAllocator::get()->allocate(getChosenWorkspaceSize())).first;
+  }
+  return it->second.get();
+}
+#endif
+
 } // namespace
 
 cublasHandle_t getCurrentCUDABlasHandle() {
@@ -41,6 +105,10 @@ cublasHandle_t getCurrentCUDABlasHandle() {
   auto handle = myPoolWindow->reserve(device);
   auto stream = c10::cuda::getCurrentCUDAStream();
   TORCH_CUDABLAS_CHECK(cublasSetStream(handle, stream));
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+  TORCH_CUDABLAS_CHECK(cublasSetWorkspace(
+      handle, getWorkspace(handle, stream), getChosenWorkspaceSize()));
+#endif
   return handle;
 }
 
@@ -333,6 +333,39 @@ void CUDAHooks::cuFFTClearPlanCache(int64_t device_index) const {
 #endif
 }
 
+std::tuple<int64_t, int64_t, int64_t> CUDAHooks::cuFFTGetPlanCacheStats(int64_t device_index) const {
+#ifndef __HIP_PLATFORM_HCC__
+  auto stats = at::native::detail::cufft_get_plan_cache_stats_impl(device_index);
+  return std::make_tuple(stats.hits, stats.misses, stats.evictions);
+#else
+  AT_ERROR("cuFFT with HIP is not supported");
+#endif
+}
+
+void CUDAHooks::cuFFTResetPlanCacheStats(int64_t device_index) const {
+#ifndef __HIP_PLATFORM_HCC__
+  at::native::detail::cufft_reset_plan_cache_stats_impl(device_index);
+#else
+  AT_ERROR("cuFFT with HIP is not supported");
+#endif
+}
+
+bool CUDAHooks::cuFFTGetPlanCacheBatchedPlans(int64_t device_index) const {
+#ifndef __HIP_PLATFORM_HCC__
+  return at::native::detail::cufft_get_plan_cache_batched_plans_impl(device_index);
+#else
+  AT_ERROR("cuFFT with HIP is not supported");
+#endif
+}
+
+void CUDAHooks::cuFFTSetPlanCacheBatchedPlans(int64_t device_index, bool enabled) const {
+#ifndef __HIP_PLATFORM_HCC__
+  at::native::detail::cufft_set_plan_cache_batched_plans_impl(device_index, enabled);
+#else
+  AT_ERROR("cuFFT with HIP is not supported");
+#endif
+}
+
 int CUDAHooks::getNumGPUs() const {
   return at::cuda::device_count();
 }
@@ -34,6 +34,10 @@ struct CUDAHooks : public at::CUDAHooksInterface {
   void cuFFTSetPlanCacheMaxSize(int64_t device_index, int64_t max_size) const override;
   int64_t cuFFTGetPlanCacheSize(int64_t device_index) const override;
   void cuFFTClearPlanCache(int64_t device_index) const override;
+  std::tuple<int64_t, int64_t, int64_t> cuFFTGetPlanCacheStats(int64_t device_index) const override;
+  void cuFFTResetPlanCacheStats(int64_t device_index) const override;
+  bool cuFFTGetPlanCacheBatchedPlans(int64_t device_index) const override;
+  void cuFFTSetPlanCacheBatchedPlans(int64_t device_index, bool enabled) const override;
   int getNumGPUs() const override;
 };
 
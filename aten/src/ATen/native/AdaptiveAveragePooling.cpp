@@ -1,6 +1,7 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
+#include <ATen/native/xnnpack/Engine.h>
 #include <tuple>
 
 
@@ -326,6 +327,14 @@ namespace {
       return at::mkldnn_adaptive_avg_pool2d(input, output_size);
     }
 
+    // Disable the xnnpack operators for both iOS and macOS temporarily due to the crash in pthreadpool
+    // TODO:T66297472 remove `!defined(__APPLE__)` once we figure out the root cause of the crash.
+#if defined(C10_MOBILE) && !defined(__APPLE__)
+    if (output_size.size() == 2 && output_size[0] == 1 && output_size[1] == 1 &&
+        xnnpack::use_global_average_pool(input)) {
+      return xnnpack::global_average_pool(input);
+    }
+#endif
     // TODO: fastpath for Channels_last should be explored later;
     if (input.suggest_memory_format() == at::MemoryFormat::Contiguous && !input.is_quantized() && output_size[0] == 1 && output_size[1] == 1) {
       // in this case, adaptive pooling is just computing mean over hw
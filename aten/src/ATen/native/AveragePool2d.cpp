@@ -2,6 +2,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/Pool.h>
+#include <ATen/native/xnnpack/Engine.h>
 #include <tuple>
 
 
@@ -361,6 +362,14 @@ Tensor avg_pool2d_cpu(
   bool count_include_pad,
   c10::optional<int64_t> divisor_override)
 {
+// Disable the xnnpack operators for both iOS and macOS temporarily due to the crash in pthreadpool
+// TODO:T66297472 remove `!defined(__APPLE__)` once we figure out the root cause of the crash.
+#if defined(C10_MOBILE) && !defined(__APPLE__)
+  if (xnnpack::use_avg_pool2d(input, kernel_size, padding, stride, ceil_mode,
+                              count_include_pad, divisor_override)) {
+    return xnnpack::avg_pool2d(input, kernel_size, padding, stride);
+  }
+#endif
   Tensor output = at::empty({0}, input.options());
   avg_pool2d_out_cpu_template(
     output,
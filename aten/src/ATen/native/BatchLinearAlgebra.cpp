@@ -10,6 +10,8 @@
 
 #include <TH/TH.h>  // for USE_LAPACK
 
+#include <algorithm>
+#include <type_traits>
 #include <vector>
 
 // First the required LAPACK implementations are registered here.
@@ -300,6 +302,201 @@ template<> void lapackLuSolve<float>(char trans, int n, int nrhs, float *a, int
 }
 #endif
 
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ small matrices ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// Batches of tiny matrices spend most of their time in the per call overhead
+// of LAPACK, so real square matrices of order up to kSmallMatrixMaxOrder are
+// handled by the kernels below instead. They take the order N as a template
+// argument, so that their loops are fully unrolled, and work in place on the
+// same column-major working copies as LAPACK. The factorizations follow the
+// unblocked LAPACK algorithms (getf2 and potf2), with the same pivots and the
+// same info codes.
+constexpr int64_t kSmallMatrixMaxOrder = 8;
+
+// LAPACK is called from several threads only for matrices up to this order;
+// larger ones are factorized one after another, and left to the threading of
+// LAPACK itself.
+constexpr int64_t kParallelBatchMaxOrder = 64;
+
+// Calls f(begin, end) on ranges of the batch_size matrices of order n of a batch.
+template <typename F>
+static void parallel_for_each_matrix(int64_t batch_size, int64_t n, const F& f) {
+  if (n > kParallelBatchMaxOrder) {
+    f(0, batch_size);
+    return;
+  }
+  const int64_t grain_size =
+      std::max<int64_t>(internal::GRAIN_SIZE / std::max<int64_t>(n * n * n, 1), 1);
+  at::parallel_for(0, batch_size, grain_size, f);
+}
+
+template <int64_t N, typename F>
+struct SmallMatrixOrderDispatch {
+  static bool run(int64_t n, const F& f) {
+    if (n == N) {
+      f(std::integral_constant<int64_t, N>());
+      return true;
+    }
+    return SmallMatrixOrderDispatch<N + 1, F>::run(n, f);
+  }
+};
+
+template <typename F>
+struct SmallMatrixOrderDispatch<kSmallMatrixMaxOrder + 1, F> {
+  static bool run(int64_t /* n */, const F& /* f */) {
+    return false;
+  }
+};
+
+template <typename F>
+static bool dispatch_small_matrix(int64_t n, const F& f, std::true_type /* is_real */) {
+  return SmallMatrixOrderDispatch<1, F>::run(n, f);
+}
+
+template <typename F>
+static bool dispatch_small_matrix(int64_t /* n */, const F& /* f */, std::false_type /* is_real */) {
+  return false;
+}
+
+// Calls f(std::integral_constant<int64_t, n>()) and returns true if scalar_t is
+// a real type and n is at most kSmallMatrixMaxOrder, and returns false otherwise.
+template <typename scalar_t, typename F>
+static bool dispatch_small_matrix(int64_t n, const F& f) {
+  return dispatch_small_matrix(n, f, std::is_floating_point<scalar_t>());
+}
+
+// LU factorization with partial pivoting of the N x N matrix a, as in getf2.
+template <typename scalar_t, int64_t N>
+static void small_lu(scalar_t* a, int* ipiv, int* info) {
+  *info = 0;
+  for (int64_t j = 0; j < N; j++) {
+    int64_t p = j;
+    scalar_t pmax = std::abs(a[j + j * N]);
+    for (int64_t i = j + 1; i < N; i++) {
+      if (std::abs(a[i + j * N]) > pmax) {
+        p = i;
+        pmax = std::abs(a[i + j * N]);
+      }
+    }
+    ipiv[j] = static_cast<int>(p + 1);
+    if (a[p + j * N] != scalar_t(0)) {
+      if (p != j) {
+        for (int64_t k = 0; k < N; k++) {
+          std::swap(a[j + k * N], a[p + k * N]);
+        }
+      }
+      const scalar_t pivot = a[j + j * N];
+      for (int64_t i = j + 1; i < N; i++) {
+        a[i + j * N] /= pivot;
+      }
+    } else if (*info == 0) {
+      *info = static_cast<int>(j + 1);
+    }
+    for (int64_t k = j + 1; k < N; k++) {
+      const scalar_t akj = a[j + k * N];
+      for (int64_t i = j + 1; i < N; i++) {
+        a[i + k * N] -= a[i + j * N] * akj;
+      }
+    }
+  }
+}
+
+// Solves A X = B for the nrhs columns of the N x nrhs matrix b, given the LU
+// factorization of A and its pivots from small_lu, as in getrs.
+template <typename scalar_t, int64_t N>
+static void small_lu_solve(const scalar_t* lu, const int* ipiv, scalar_t* b, int64_t nrhs) {
+  for (int64_t c = 0; c < nrhs; c++) {
+    scalar_t* x = b + c * N;
+    for (int64_t i = 0; i < N; i++) {
+      std::swap(x[i], x[ipiv[i] - 1]);
+    }
+    for (int64_t k = 0; k < N; k++) {
+      for (int64_t i = k + 1; i < N; i++) {
+        x[i] -= lu[i + k * N] * x[k];
+      }
+    }
+    for (int64_t k = N - 1; k >= 0; k--) {
+      x[k] /= lu[k + k * N];
+      for (int64_t i = 0; i < k; i++) {
+        x[i] -= lu[i + k * N] * x[k];
+      }
+    }
+  }
+}
+
+// Inverts the N x N matrix a, as getrf followed by getri do.
+template <typename scalar_t, int64_t N>
+static void small_inverse(scalar_t* a, int* info) {
+  int ipiv[N];
+  small_lu<scalar_t, N>(a, ipiv, info);
+  if (*info != 0) {
+    return;
+  }
+  scalar_t inv[N * N];
+  for (int64_t i = 0; i < N * N; i++) {
+    inv[i] = (i % (N + 1) == 0) ? scalar_t(1) : scalar_t(0);
+  }
+  small_lu_solve<scalar_t, N>(a, ipiv, inv, N);
+  std::copy(inv, inv + N * N, a);
+}
+
+// Position of the element (i, k), with i >= k, of the lower triangular factor
+// L of a Cholesky factorization. The upper factor U is L^T, so that element is
+// also U(k, i).
+template <int64_t N>
+static inline int64_t small_cholesky_index(int64_t i, int64_t k, bool upper) {
+  return upper ? k + i * N : i + k * N;
+}
+
+// Cholesky factorization of the N x N matrix a, as in potf2. Only the triangle
+// given by upper is read and written.
+template <typename scalar_t, int64_t N>
+static void small_cholesky(scalar_t* a, bool upper, int* info) {
+  *info = 0;
+  for (int64_t j = 0; j < N; j++) {
+    scalar_t ajj = a[j + j * N];
+    for (int64_t k = 0; k < j; k++) {
+      const scalar_t ljk = a[small_cholesky_index<N>(j, k, upper)];
+      ajj -= ljk * ljk;
+    }
+    if (!(ajj > scalar_t(0))) {
+      a[j + j * N] = ajj;
+      *info = static_cast<int>(j + 1);
+      return;
+    }
+    ajj = std::sqrt(ajj);
+    a[j + j * N] = ajj;
+    for (int64_t i = j + 1; i < N; i++) {
+      scalar_t aij = a[small_cholesky_index<N>(i, j, upper)];
+      for (int64_t k = 0; k < j; k++) {
+        aij -= a[small_cholesky_index<N>(i, k, upper)] * a[small_cholesky_index<N>(j, k, upper)];
+      }
+      a[small_cholesky_index<N>(i, j, upper)] = aij / ajj;
+    }
+  }
+}
+
+// Solves A X = B for the nrhs columns of the N x nrhs matrix b, given the
+// Cholesky factor of A from small_cholesky, as in potrs.
+template <typename scalar_t, int64_t N>
+static void small_cholesky_solve(const scalar_t* a, bool upper, scalar_t* b, int64_t nrhs) {
+  for (int64_t c = 0; c < nrhs; c++) {
+    scalar_t* x = b + c * N;
+    for (int64_t k = 0; k < N; k++) {
+      x[k] /= a[k + k * N];
+      for (int64_t i = k + 1; i < N; i++) {
+        x[i] -= a[small_cholesky_index<N>(i, k, upper)] * x[k];
+      }
+    }
+    for (int64_t k = N - 1; k >= 0; k--) {
+      for (int64_t i = k + 1; i < N; i++) {
+        x[k] -= a[small_cholesky_index<N>(i, k, upper)] * x[i];
+      }
+      x[k] /= a[k + k * N];
+    }
+  }
+}
+
 // Below of the definitions of the functions operating on a batch that are going to be dispatched
 // in the main helper functions for the linear algebra operations
 
@@ -318,19 +515,37 @@ static void apply_solve(Tensor& b, Tensor& A, std::vector<int64_t>& infos) {
   auto n = A.size(-2);
   auto nrhs = b.size(-1);
 
-  auto ipiv = at::empty({n}, b.options().dtype(kInt));
+  auto ipiv = at::empty({batch_size, n}, b.options().dtype(kInt));
   auto ipiv_data = ipiv.data_ptr<int>();
 
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
-    scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
-    lapackSolve<scalar_t>(n, nrhs, A_working_ptr, n, ipiv_data, b_working_ptr, n, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
-    }
+  const bool is_small = dispatch_small_matrix<scalar_t>(n, [&](auto order) {
+    constexpr int64_t N = decltype(order)::value;
+    parallel_for_each_matrix(batch_size, N, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
+        int* ipiv_working_ptr = &ipiv_data[i * N];
+        int info;
+        small_lu<scalar_t, N>(A_working_ptr, ipiv_working_ptr, &info);
+        infos[i] = info;
+        if (info == 0) {
+          small_lu_solve<scalar_t, N>(A_working_ptr, ipiv_working_ptr, &b_data[i * b_mat_stride], nrhs);
+        }
+      }
+    });
+  });
+  if (is_small) {
+    return;
   }
+
+  parallel_for_each_matrix(batch_size, n, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
+      scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
+      int info;
+      lapackSolve<scalar_t>(n, nrhs, A_working_ptr, n, &ipiv_data[i * n], b_working_ptr, n, &info);
+      infos[i] = info;
+    }
+  });
 #endif
 }
 
@@ -381,36 +596,52 @@ static void apply_inverse(Tensor& self, std::vector<int64_t>& infos) {
   auto batch_size = batchCount(self);
   auto n = self.size(-2);
 
-  auto ipiv = at::empty({n}, self.options().dtype(kInt));
+  const bool is_small = dispatch_small_matrix<scalar_t>(n, [&](auto order) {
+    constexpr int64_t N = decltype(order)::value;
+    parallel_for_each_matrix(batch_size, N, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        int info;
+        small_inverse<scalar_t, N>(&self_data[i * self_matrix_stride], &info);
+        infos[i] = info;
+      }
+    });
+  });
+  if (is_small) {
+    return;
+  }
+
+  auto ipiv = at::empty({batch_size, n}, self.options().dtype(kInt));
   auto ipiv_data = ipiv.data_ptr<int>();
 
-  int info;
+  int query_info;
   // Run once, first to get the optimum work size
   // Since we deal with batches of matrices with the same dimensions, doing this outside
   // the loop saves (batch_size - 1) workspace queries which would provide the same result
-  // and (batch_size - 1) calls to allocate and deallocate workspace using at::empty()
+  // and (batch_size - 1) calls to allocate and deallocate workspace using at::empty().
+  // Every matrix has its own pivots, and every range of the batch its own workspace.
   int lwork = -1;
   scalar_t wkopt;
-  lapackGetri<scalar_t>(n, self_data, n, ipiv_data, &wkopt, lwork, &info);
+  lapackGetri<scalar_t>(n, self_data, n, ipiv_data, &wkopt, lwork, &query_info);
   lwork = static_cast<int>(real_impl<scalar_t, value_t>(wkopt));
-  Tensor work = at::empty({lwork}, self.options());
-  auto work_data = work.data_ptr<scalar_t>();
 
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    lapackLu<scalar_t>(n, n, self_working_ptr, n, ipiv_data, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
-    }
+  parallel_for_each_matrix(batch_size, n, [&](int64_t begin, int64_t end) {
+    Tensor work = at::empty({lwork}, self.options());
+    auto work_data = work.data_ptr<scalar_t>();
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      int* ipiv_working_ptr = &ipiv_data[i * n];
+      int info;
+      lapackLu<scalar_t>(n, n, self_working_ptr, n, ipiv_working_ptr, &info);
+      infos[i] = info;
+      if (info != 0) {
+        continue;
+      }
 
-    // now compute the actual inverse
-    lapackGetri<scalar_t>(n, self_working_ptr, n, ipiv_data, work_data, lwork, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
+      // now compute the actual inverse
+      lapackGetri<scalar_t>(n, self_working_ptr, n, ipiv_working_ptr, work_data, lwork, &info);
+      infos[i] = info;
     }
-  }
+  });
 #endif
 }
 
@@ -461,16 +692,27 @@ static void apply_cholesky_solve(Tensor& b, Tensor& A, bool upper, std::vector<i
   auto n = A.size(-2);
   auto nrhs = b.size(-1);
 
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
-    scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
-    lapackCholeskySolve<scalar_t>(uplo, n, nrhs, A_working_ptr, n, b_working_ptr, n, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
-    }
+  const bool is_small = dispatch_small_matrix<scalar_t>(n, [&](auto order) {
+    constexpr int64_t N = decltype(order)::value;
+    parallel_for_each_matrix(batch_size, N, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        small_cholesky_solve<scalar_t, N>(&A_data[i * A_mat_stride], upper, &b_data[i * b_mat_stride], nrhs);
+      }
+    });
+  });
+  if (is_small) {
+    return;
   }
+
+  parallel_for_each_matrix(batch_size, n, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
+      scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
+      int info;
+      lapackCholeskySolve<scalar_t>(uplo, n, nrhs, A_working_ptr, n, b_working_ptr, n, &info);
+      infos[i] = info;
+    }
+  });
 #endif
 }
 
@@ -521,15 +763,28 @@ static void apply_cholesky(Tensor& self, bool upper, std::vector<int64_t>& infos
   auto batch_size = batchCount(self);
   auto n = self.size(-2);
 
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    lapackCholesky<scalar_t>(uplo, n, self_working_ptr, n, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
-    }
+  const bool is_small = dispatch_small_matrix<scalar_t>(n, [&](auto order) {
+    constexpr int64_t N = decltype(order)::value;
+    parallel_for_each_matrix(batch_size, N, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        int info;
+        small_cholesky<scalar_t, N>(&self_data[i * self_matrix_stride], upper, &info);
+        infos[i] = info;
+      }
+    });
+  });
+  if (is_small) {
+    return;
   }
+
+  parallel_for_each_matrix(batch_size, n, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      int info;
+      lapackCholesky<scalar_t>(uplo, n, self_working_ptr, n, &info);
+      infos[i] = info;
+    }
+  });
 #endif
 }
 
@@ -585,12 +840,27 @@ static void apply_lu(Tensor& self, Tensor& pivots, Tensor& infos) {
   auto m = self.size(-2);
   auto n = self.size(-1);
 
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    int* pivots_working_ptr = &pivots_data[i * pivots_matrix_stride];
-    int* infos_working_ptr = &infos_data[i];
-    lapackLu<scalar_t>(m, n, self_working_ptr, m, pivots_working_ptr, infos_working_ptr);
+  const bool is_small = m == n && dispatch_small_matrix<scalar_t>(n, [&](auto order) {
+    constexpr int64_t N = decltype(order)::value;
+    parallel_for_each_matrix(batch_size, N, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        small_lu<scalar_t, N>(&self_data[i * self_matrix_stride],
+                              &pivots_data[i * pivots_matrix_stride], &infos_data[i]);
+      }
+    });
+  });
+  if (is_small) {
+    return;
   }
+
+  parallel_for_each_matrix(batch_size, std::max(m, n), [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      int* pivots_working_ptr = &pivots_data[i * pivots_matrix_stride];
+      int* infos_working_ptr = &infos_data[i];
+      lapackLu<scalar_t>(m, n, self_working_ptr, m, pivots_working_ptr, infos_working_ptr);
+    }
+  });
 #endif
 }
 
@@ -1069,18 +1339,30 @@ static void apply_lu_solve(Tensor& b, const Tensor& lu, const Tensor& pivots, st
   auto n = lu.size(-2);
   auto nrhs = b.size(-1);
 
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* b_working_ptr = &b_data[i * b_stride];
-    scalar_t* lu_working_ptr = &lu_data[i * lu_stride];
-    int* pivots_working_ptr = &pivots_data[i * pivots_stride];
-    lapackLuSolve<scalar_t>('N', n, nrhs, lu_working_ptr, n, pivots_working_ptr,
-                            b_working_ptr, n, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
-    }
+  const bool is_small = dispatch_small_matrix<scalar_t>(n, [&](auto order) {
+    constexpr int64_t N = decltype(order)::value;
+    parallel_for_each_matrix(batch_size, N, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        small_lu_solve<scalar_t, N>(&lu_data[i * lu_stride], &pivots_data[i * pivots_stride],
+                                    &b_data[i * b_stride], nrhs);
+      }
+    });
+  });
+  if (is_small) {
+    return;
   }
+
+  parallel_for_each_matrix(batch_size, n, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* b_working_ptr = &b_data[i * b_stride];
+      scalar_t* lu_working_ptr = &lu_data[i * lu_stride];
+      int* pivots_working_ptr = &pivots_data[i * pivots_stride];
+      int info;
+      lapackLuSolve<scalar_t>('N', n, nrhs, lu_working_ptr, n, pivots_working_ptr,
+                              b_working_ptr, n, &info);
+      infos[i] = info;
+    }
+  });
 #endif
 }
 
@@ -6,6 +6,7 @@
 #include <ATen/MemoryOverlap.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/TensorIterator.h>
+#include <ATen/native/xnnpack/Engine.h>
 
 namespace at {
 namespace native {
@@ -47,6 +48,13 @@ Tensor& add_out(Tensor& result, const Tensor& self, const Tensor& other, Scalar
 }
 
 Tensor add(const Tensor& self, const Tensor& other, Scalar alpha) {
+// Disable the xnnpack operators for both iOS and macOS temporarily due to the crash in pthreadpool
+// TODO:T66297472 remove `!defined(__APPLE__)` once we figure out the root cause of the crash.
+#if defined(C10_MOBILE) && !defined(__APPLE__)
+  if (xnnpack::use_add(self, other, alpha)) {
+    return xnnpack::add(self, other);
+  }
+#endif
   Tensor result;
   auto iter = TensorIterator::binary_op(result, self, other);
   alpha_check(iter.dtype(), alpha);
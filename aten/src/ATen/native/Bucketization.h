@@ -0,0 +1,21 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at {
+namespace native {
+
+// (result, input, boundaries, out_int32, right); the input and boundaries are
+// contiguous tensors of the same dtype, and result has the size of input.
+using searchsorted_fn = void (*)(
+    Tensor& result,
+    const Tensor& input,
+    const Tensor& boundaries,
+    bool out_int32,
+    bool right);
+
+DECLARE_DISPATCH(searchsorted_fn, searchsorted_stub);
+
+} // namespace native
+} // namespace at
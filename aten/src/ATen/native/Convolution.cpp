@@ -1,6 +1,7 @@
 #include <limits>
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/core/grad_mode.h>
 #include <ATen/native/cpu/DepthwiseConvKernel.h>
 #include <ATen/native/utils/ParamUtils.h>
 #include <ATen/native/ConvUtils.h>
@@ -40,6 +41,8 @@ struct ConvParams {
   bool is_stride_nonpos() const;
   void view1d_as_2d();
   bool use_cpu_depthwise3x3_winograd(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_depthwise(const at::Tensor& input, const at::Tensor& weight) const;
+  bool use_cpu_direct_grouped(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
   bool needs_64bit_indexing_no_split(const at::Tensor& input, const at::Tensor& weight) const;
   bool use_cudnn(const at::Tensor& input, const at::Tensor& weight) const;
   bool use_cudnn_depthwise(const at::Tensor& input, const at::Tensor& weight) const;
@@ -159,6 +162,48 @@ auto ConvParams::use_cpu_depthwise3x3_winograd(
 #endif
 }
 
+// The direct kernels of DepthwiseConvKernel.cpp read a few input planes per
+// output plane, so they avoid the im2col buffers of the group loop.
+static bool is_cpu_direct_conv2d_input(const at::Tensor& input, const at::Tensor& weight) {
+  return input.device().type() == c10::DeviceType::CPU &&
+         input.layout() == at::kStrided &&
+         (input.scalar_type() == at::kFloat || input.scalar_type() == at::kDouble) &&
+         weight.scalar_type() == input.scalar_type() &&
+         input.ndimension() == 4 &&
+         weight.ndimension() == 4;
+}
+
+auto ConvParams::use_cpu_depthwise(
+    const at::Tensor& input,
+    const at::Tensor& weight) const -> bool {
+  return is_cpu_direct_conv2d_input(input, weight) &&
+         !transposed &&
+         input.size(1) == groups &&
+         groups > 1 && // no point if there is only a single group
+         weight.size(0) % input.size(1) == 0; // output channels must be a multiple of input channels
+}
+
+// Without autograd the group loop of grouped convolutions, with one im2col
+// per group, is replaced by a single direct kernel for groups of up to
+// kMaxDirectGroupedChannels input channels. With autograd each group still
+// goes through _convolution_nogroup, whose backward is differentiable.
+constexpr int64_t kMaxDirectGroupedChannels = 8;
+
+auto ConvParams::use_cpu_direct_grouped(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> bool {
+  return is_cpu_direct_conv2d_input(input, weight) &&
+         !transposed &&
+         groups > 1 &&
+         input.size(1) % groups == 0 &&
+         weight.size(0) % groups == 0 &&
+         input.size(1) / groups <= kMaxDirectGroupedChannels &&
+         !(at::GradMode::is_enabled() &&
+           (input.requires_grad() || weight.requires_grad() ||
+            (bias.defined() && bias.requires_grad())));
+}
+
 auto ConvParams::needs_64bit_indexing_no_split(const at::Tensor& input, const at::Tensor& weight) const -> bool {
   constexpr int64_t int_max = std::numeric_limits<int>::max();
   int64_t numel_input = input.numel();
@@ -672,6 +717,13 @@ at::Tensor _convolution(
       } else {
           output = at::thnn_conv_depthwise2d(input.contiguous(), weight, kernel_size, bias, stride, padding, dilation);
       }
+  } else if (params.use_cpu_depthwise(input, weight) &&
+             !params.use_xnnpack(input, weight, bias) &&
+             !params.use_cpu_depthwise3x3_winograd(input, weight, bias)) {
+    // Before mkldnn, which runs depthwise convolutions as grouped ones.
+    output = at::thnn_conv_depthwise2d(
+        input.contiguous(), weight, weight.sizes().slice(2), bias,
+        params.stride, params.padding, params.dilation);
   } else if (params.use_cudnn(input, weight)) {
     TORCH_CHECK(input.options().type_equal(weight.options()),
              "Input type (", input.toString(), ") and weight type (", weight.toString(),
@@ -721,7 +773,11 @@ at::Tensor _convolution(
              "Input type (", input.toString(), ") and bias type (", bias.toString(),
              ") should be the same");
     if (!input_is_mkldnn) {
-      output = at::mkldnn_convolution(input.contiguous(), weight.contiguous(), bias.defined() ? bias.contiguous() : bias,
+      // mkldnn reads channels last input and weight directly, and caches the
+      // reordered weight, so neither is made contiguous here.
+      output = at::mkldnn_convolution(input.contiguous(input.suggest_memory_format()),
+                                      weight.is_contiguous() || weight.is_contiguous(at::MemoryFormat::ChannelsLast) ? weight : weight.contiguous(),
+                                      bias.defined() ? bias.contiguous() : bias,
                                       params.padding, params.stride, params.dilation, params.groups);
     } else {
       // do not call contiguous on mkldnn tensor
@@ -765,6 +821,17 @@ at::Tensor _convolution(
     if (params.groups == 1) {
       output = at::_convolution_nogroup(
           input.contiguous(), weight, bias, params.stride, params.padding, params.dilation, params.transposed, params.output_padding);
+    } else if (params.use_cpu_direct_grouped(input, weight, bias)) {
+      input = input.contiguous();
+      output = at::empty(
+          conv_output_size(input.sizes(), weight.sizes(), params.padding, params.stride, params.dilation),
+          input.options());
+      if (output.numel() > 0) {
+        direct_grouped_conv2d_stub(
+            kCPU, output, input, weight.contiguous(),
+            bias.defined() ? bias.contiguous() : bias,
+            params.stride, params.padding, params.dilation, params.groups);
+      }
     } else {
       std::vector<Tensor> outputs(params.groups);
       input = input.contiguous();
@@ -0,0 +1,189 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/ConvUtils.h>
+#include <ATen/native/cpu/DepthwiseConvKernel.h>
+
+#include <tuple>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(direct_grouped_conv2d_stub);
+DEFINE_DISPATCH(direct_grouped_conv2d_backward_input_stub);
+DEFINE_DISPATCH(direct_grouped_conv2d_backward_weight_stub);
+
+namespace {
+
+void check_depthwise2d_cpu_args(
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  TORCH_CHECK(
+      self.dim() == 4,
+      "thnn_conv_depthwise2d: expected a 4D input, but got ", self.dim(), "D");
+  TORCH_CHECK(
+      weight.dim() == 4 && weight.size(1) == 1,
+      "thnn_conv_depthwise2d: expected a weight of size [out_channels, 1, kH, kW], but got ",
+      weight.sizes());
+  TORCH_CHECK(
+      self.size(1) > 0 && weight.size(0) % self.size(1) == 0,
+      "thnn_conv_depthwise2d: expected the output channels ", weight.size(0),
+      " to be a multiple of the input channels ", self.size(1));
+  TORCH_CHECK(
+      kernel_size.size() == 2 && kernel_size[0] == weight.size(2) &&
+          kernel_size[1] == weight.size(3),
+      "thnn_conv_depthwise2d: kernel_size ", kernel_size,
+      " doesn't match the weight ", weight.sizes());
+  TORCH_CHECK(
+      stride.size() == 2 && stride[0] > 0 && stride[1] > 0,
+      "thnn_conv_depthwise2d: expected a positive stride of 2 elements, but got ", stride);
+  TORCH_CHECK(
+      padding.size() == 2 && padding[0] >= 0 && padding[1] >= 0,
+      "thnn_conv_depthwise2d: expected a non-negative padding of 2 elements, but got ", padding);
+  TORCH_CHECK(
+      dilation.size() == 2 && dilation[0] > 0 && dilation[1] > 0,
+      "thnn_conv_depthwise2d: expected a positive dilation of 2 elements, but got ", dilation);
+  TORCH_CHECK(
+      self.scalar_type() == weight.scalar_type(),
+      "thnn_conv_depthwise2d: expected the input and the weight to have the same dtype, but got ",
+      self.scalar_type(), " and ", weight.scalar_type());
+}
+
+std::vector<int64_t> depthwise2d_output_size(
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  auto output_size =
+      conv_output_size(self.sizes(), weight.sizes(), padding, stride, dilation);
+  TORCH_CHECK(
+      output_size[2] > 0 && output_size[3] > 0,
+      "thnn_conv_depthwise2d: the input ", self.sizes(),
+      " is too small for the kernel ", weight.sizes().slice(2));
+  return output_size;
+}
+
+} // namespace
+
+Tensor& thnn_conv_depthwise2d_forward_out_cpu(
+    Tensor& output,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  check_depthwise2d_cpu_args(self, weight, kernel_size, stride, padding, dilation);
+  TORCH_CHECK(
+      !bias.defined() || (bias.dim() == 1 && bias.size(0) == weight.size(0)),
+      "thnn_conv_depthwise2d: expected a bias of ", weight.size(0),
+      " elements, but got ", bias.sizes());
+  output.resize_(depthwise2d_output_size(self, weight, stride, padding, dilation));
+  if (output.numel() == 0) {
+    return output;
+  }
+  // The kernel writes contiguous outputs.
+  Tensor output_c = output.is_contiguous() ? output : at::empty_like(output, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  direct_grouped_conv2d_stub(
+      kCPU, output_c, self.contiguous(), weight.contiguous(),
+      bias.defined() ? bias.contiguous() : bias,
+      stride, padding, dilation, self.size(1));
+  if (!output.is_same(output_c)) {
+    output.copy_(output_c);
+  }
+  return output;
+}
+
+Tensor thnn_conv_depthwise2d_forward_cpu(
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  Tensor output = at::empty({0}, self.options());
+  thnn_conv_depthwise2d_forward_out_cpu(
+      output, self, weight, kernel_size, bias, stride, padding, dilation);
+  return output;
+}
+
+std::tuple<Tensor&, Tensor&> thnn_conv_depthwise2d_backward_out_cpu(
+    Tensor& grad_input,
+    Tensor& grad_weight,
+    const Tensor& grad_output,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  check_depthwise2d_cpu_args(self, weight, kernel_size, stride, padding, dilation);
+  auto output_size = depthwise2d_output_size(self, weight, stride, padding, dilation);
+  TORCH_CHECK(
+      grad_output.sizes() == IntArrayRef(output_size),
+      "thnn_conv_depthwise2d: expected grad_output of size ", IntArrayRef(output_size),
+      ", but got ", grad_output.sizes());
+  const Tensor grad_output_c = grad_output.contiguous();
+  if (grad_input.defined()) {
+    grad_input.resize_(self.sizes());
+    Tensor grad_input_c = grad_input.is_contiguous() ? grad_input : at::empty_like(grad_input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    if (grad_input_c.numel() > 0) {
+      direct_grouped_conv2d_backward_input_stub(
+          kCPU, grad_input_c, grad_output_c, weight.contiguous(),
+          stride, padding, dilation, self.size(1));
+    }
+    if (!grad_input.is_same(grad_input_c)) {
+      grad_input.copy_(grad_input_c);
+    }
+  }
+  if (grad_weight.defined()) {
+    grad_weight.resize_(weight.sizes());
+    Tensor grad_weight_c = grad_weight.is_contiguous() ? grad_weight : at::empty_like(grad_weight, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    if (self.numel() == 0) {
+      grad_weight_c.zero_();
+    } else {
+      direct_grouped_conv2d_backward_weight_stub(
+          kCPU, grad_weight_c, grad_output_c, self.contiguous(),
+          stride, padding, dilation, self.size(1));
+    }
+    if (!grad_weight.is_same(grad_weight_c)) {
+      grad_weight.copy_(grad_weight_c);
+    }
+  }
+  return std::tuple<Tensor&, Tensor&>(grad_input, grad_weight);
+}
+
+std::tuple<Tensor, Tensor> thnn_conv_depthwise2d_backward_cpu(
+    const Tensor& grad_output,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    std::array<bool, 2> output_mask) {
+  Tensor grad_input;
+  Tensor grad_weight;
+
+  if (output_mask[0]) {
+    grad_input = at::empty({0}, grad_output.options());
+  }
+
+  if (output_mask[1]) {
+    grad_weight = at::empty({0}, grad_output.options());
+  }
+
+  thnn_conv_depthwise2d_backward_out_cpu(
+      grad_input, grad_weight, grad_output, self, weight,
+      kernel_size, stride, padding, dilation);
+  return std::make_tuple(grad_input, grad_weight);
+}
+
+} // namespace native
+} // namespace at
@@ -118,6 +118,70 @@ static void max_pool2d_with_indices_out_frame(
   });
 }
 
+template <typename scalar_t>
+static void max_pool2d_with_indices_out_frame_channels_last(
+          scalar_t *input_data,
+          scalar_t *output_data,
+          int64_t *indices_data,
+          int64_t nbatch,
+          int64_t nInputPlane,
+          int64_t inputWidth,
+          int64_t inputHeight,
+          int64_t outputWidth,
+          int64_t outputHeight,
+          int kW,
+          int kH,
+          int dW,
+          int dH,
+          int padW,
+          int padH,
+          int dilationW,
+          int dilationH)
+{
+  /* NHWC: every output pixel reduces over contiguous rows of nInputPlane
+   * channels, and indices use the same H * W offsets as the NCHW path */
+  at::parallel_for(0, nbatch * outputHeight * outputWidth, 0, [&](int64_t start, int64_t end) {
+    for (auto o = start; o < end; o++)
+    {
+      const int64_t p = o / (outputHeight * outputWidth);
+      const int64_t i = (o / outputWidth) % outputHeight;
+      const int64_t j = o % outputWidth;
+
+      int64_t hstart = i * dH - padH;
+      int64_t wstart = j * dW - padW;
+      int64_t hend = std::min(hstart + (kH - 1) * dilationH + 1, inputHeight);
+      int64_t wend = std::min(wstart + (kW - 1) * dilationW + 1, inputWidth);
+      while(hstart < 0)
+        hstart += dilationH;
+      while(wstart < 0)
+        wstart += dilationW;
+
+      scalar_t *op = output_data + o * nInputPlane;
+      int64_t *indp = indices_data + o * nInputPlane;
+      std::fill(op, op + nInputPlane, -std::numeric_limits<scalar_t>::infinity());
+      std::fill(indp, indp + nInputPlane, hstart * inputWidth + wstart);
+
+      for(int64_t y = hstart; y < hend; y += dilationH)
+      {
+        for(int64_t x = wstart; x < wend; x += dilationW)
+        {
+          const int64_t tcntr = y * inputWidth + x;
+          const scalar_t *ip = input_data + (p * inputHeight * inputWidth + tcntr) * nInputPlane;
+          for (int64_t c = 0; c < nInputPlane; c++)
+          {
+            const scalar_t val = ip[c];
+            if ((val > op[c]) || std::isnan(val))
+            {
+              op[c] = val;
+              indp[c] = tcntr;
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
 void max_pool2d_with_indices_out_cpu_template(
           Tensor& output,
           Tensor& indices,
@@ -171,6 +235,32 @@ void max_pool2d_with_indices_out_cpu_template(
     inputHeight, inputWidth,
     outputHeight, outputWidth);
 
+  if (input_.ndimension() == 4 &&
+      input_.suggest_memory_format() == at::MemoryFormat::ChannelsLast)
+  {
+    /* keep channels last inputs in their layout */
+    Tensor input = input_.contiguous(at::MemoryFormat::ChannelsLast);
+    output.resize_({nbatch, nInputPlane, outputHeight, outputWidth}, at::MemoryFormat::ChannelsLast);
+    indices.resize_({nbatch, nInputPlane, outputHeight, outputWidth}, at::MemoryFormat::ChannelsLast);
+
+    AT_DISPATCH_FLOATING_TYPES(input.scalar_type(),
+      "max_pool2d_with_indices_cpu",
+      [&] {
+        max_pool2d_with_indices_out_frame_channels_last(
+          input.data_ptr<scalar_t>(),
+          output.data_ptr<scalar_t>(),
+          indices.data_ptr<int64_t>(),
+          nbatch,
+          nInputPlane,
+          inputWidth, inputHeight,
+          outputWidth, outputHeight,
+          kW, kH, dW, dH,
+          padW, padH,
+          dilationW, dilationH); }
+    );
+    return;
+  }
+
   /* get contiguous input */
   Tensor input = input_.contiguous();
 
@@ -295,11 +385,40 @@ static void max_pool2d_with_indices_backward_out_frame(
   });
 }
 
+template <typename scalar_t>
+static void max_pool2d_with_indices_backward_out_frame_channels_last(
+          scalar_t *gradInput_data,
+          scalar_t *gradOutput_data,
+          int64_t *indices_data,
+          int64_t nbatch,
+          int64_t nInputPlane,
+          int64_t inputWidth,
+          int64_t inputHeight,
+          int64_t outputWidth,
+          int64_t outputHeight)
+{
+  /* samples never share gradInput, so they can be processed in parallel */
+  at::parallel_for(0, nbatch, 0, [&](int64_t start, int64_t end) {
+    for (auto p = start; p < end; p++) {
+      scalar_t *gradInput_p = gradInput_data + p * inputHeight * inputWidth * nInputPlane;
+      for (int64_t o = 0; o < outputHeight * outputWidth; o++) {
+        const int64_t offset = (p * outputHeight * outputWidth + o) * nInputPlane;
+        for (int64_t c = 0; c < nInputPlane; c++) {
+          const int64_t maxp = indices_data[offset + c];
+          if (maxp != -1) {
+            gradInput_p[maxp * nInputPlane + c] += gradOutput_data[offset + c];
+          }
+        }
+      }
+    }
+  });
+}
+
 Tensor& max_pool2d_with_indices_backward_out_cpu_template(
           Tensor& gradInput,
           const Tensor& gradOutput_,
           const Tensor& input,
-          const Tensor& indices,
+          const Tensor& indices_,
           IntArrayRef kernel_size,
           IntArrayRef stride,
           IntArrayRef padding,
@@ -333,11 +452,16 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
   TORCH_CHECK((input.ndimension() == 3 || input.ndimension() == 4),
     "non-empty 3D or 4D (batch mode) tensor expected for input");
 
+  const bool channels_last = input.ndimension() == 4 &&
+    input.suggest_memory_format() == at::MemoryFormat::ChannelsLast;
+  const auto memory_format = channels_last ? at::MemoryFormat::ChannelsLast : at::MemoryFormat::Contiguous;
+
   /* get contiguous gradOutput */
-  const Tensor gradOutput = gradOutput_.contiguous();
+  const Tensor gradOutput = gradOutput_.contiguous(memory_format);
+  const Tensor indices = indices_.contiguous(memory_format);
 
   /* resize */
-  gradInput.resize_as_(input);
+  gradInput.resize_as_(input, memory_format);
   gradInput.zero_();
 
   /* sizes */
@@ -363,7 +487,23 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
     outputHeight_for_shape_check, outputWidth_for_shape_check);
 
   /* backprop */
-  if (input.ndimension() == 3)
+  if (channels_last)
+  {
+    AT_DISPATCH_FLOATING_TYPES(input.scalar_type(),
+      "max_pool2d_with_indices_backward",
+      [&] {
+        max_pool2d_with_indices_backward_out_frame_channels_last<scalar_t>(
+          gradInput.data_ptr<scalar_t>(),
+          gradOutput.data_ptr<scalar_t>(),
+          indices.data_ptr<int64_t>(),
+          nbatch,
+          nInputPlane,
+          inputWidth, inputHeight,
+          outputWidth, outputHeight);
+      }
+    );
+  }
+  else if (input.ndimension() == 3)
   {
     AT_DISPATCH_FLOATING_TYPES(input.scalar_type(),
       "max_pool2d_with_indices_backward",
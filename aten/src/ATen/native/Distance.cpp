@@ -135,6 +135,56 @@ Tensor _cdist_forward(const Tensor& x1, const Tensor& x2, const double p, c10::o
   return result;
 }
 
+// cdist_topk walks the distance matrix in tiles of this many rows of x1 by
+// this many rows of x2, and merges every tile into the running k nearest
+// neighbors of its rows, so that at most one tile of distances is held at a time.
+constexpr int64_t kCdistTopkRowBlock = 1024;
+constexpr int64_t kCdistTopkColBlock = 4096;
+
+std::tuple<Tensor, Tensor> cdist_topk(const Tensor& x1, const Tensor& x2, int64_t k, const double p, c10::optional<int64_t> compute_mode) {
+  TORCH_CHECK(x1.dim() >= 2, "cdist_topk only supports at least 2D tensors, X1 got: ", x1.dim(), "D");
+  TORCH_CHECK(x2.dim() >= 2, "cdist_topk only supports at least 2D tensors, X2 got: ", x2.dim(), "D");
+  TORCH_CHECK(x1.size(-1) == x2.size(-1), "X1 and X2 must have the same number of columns. X1: ", x1.size(-1), " X2: ", x2.size(-1));
+  const int64_t r1 = x1.size(-2);
+  const int64_t r2 = x2.size(-2);
+  TORCH_CHECK(k >= 0 && k <= r2, "cdist_topk: k (", k, ") must be in the range [0, ", r2, "]");
+
+  IntArrayRef batch_tensor1(x1.sizes().data(), x1.dim() - 2);
+  IntArrayRef batch_tensor2(x2.sizes().data(), x2.dim() - 2);
+  std::vector<int64_t> output_shape = infer_size(batch_tensor1, batch_tensor2);
+  output_shape.insert(output_shape.end(), {r1, k});
+  if (r1 == 0 || k == 0) {
+    return std::make_tuple(at::empty(output_shape, x1.options()),
+                           at::empty(output_shape, x1.options().dtype(kLong)));
+  }
+
+  std::vector<Tensor> values_blocks;
+  std::vector<Tensor> indices_blocks;
+  for (int64_t i = 0; i < r1; i += kCdistTopkRowBlock) {
+    const Tensor rows = x1.narrow(-2, i, std::min(kCdistTopkRowBlock, r1 - i));
+    Tensor best_values, best_indices;
+    for (int64_t j = 0; j < r2; j += kCdistTopkColBlock) {
+      const int64_t cols = std::min(kCdistTopkColBlock, r2 - j);
+      Tensor values = at::cdist(rows, x2.narrow(-2, j, cols), p, compute_mode);
+      Tensor indices = at::arange(j, j + cols, x1.options().dtype(kLong)).expand_as(values);
+      if (best_values.defined()) {
+        values = at::cat({best_values, values}, -1);
+        indices = at::cat({best_indices, indices}, -1);
+      }
+      Tensor top_positions;
+      std::tie(best_values, top_positions) =
+          values.topk(std::min(k, values.size(-1)), -1, /*largest=*/false, /*sorted=*/true);
+      best_indices = indices.gather(-1, top_positions);
+    }
+    values_blocks.push_back(best_values);
+    indices_blocks.push_back(best_indices);
+  }
+  if (values_blocks.size() == 1) {
+    return std::make_tuple(values_blocks[0], indices_blocks[0]);
+  }
+  return std::make_tuple(at::cat(values_blocks, -2), at::cat(indices_blocks, -2));
+}
+
 Tensor _cdist_backward(const Tensor& grad, const Tensor& x1, const Tensor& x2, const double p, const Tensor& cdist) {
   TORCH_CHECK(x1.is_contiguous(), "_cdist_backward requires X1 to be contiguous");
   TORCH_CHECK(x2.is_contiguous(), "_cdist_backward requires X2 to be contiguous");
@@ -2,6 +2,8 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/native/EmbeddingFusedUpdate.h>
+#include <ATen/native/cpu/EmbeddingBagKernel.h>
 
 #include <TH/THBlasUtils.h>
 
@@ -35,14 +37,33 @@ static void make_offset2bag(const Tensor &offsets, const Tensor &indices, Tensor
   offset2bag = offset2bag.cumsum(0);     // offset2bag = [0 0 1 1 2]
 }
 
+DEFINE_DISPATCH(embedding_bag_sum_stub);
+DEFINE_DISPATCH(embedding_bag_max_stub);
+
 namespace {
 
 bool isFastPathIndexSelect(const Tensor& src, Tensor& output) {
-  return src.scalar_type() == kFloat && src.stride(1) == 1 && output.stride(1) == 1;
+  return (src.scalar_type() == kFloat || src.scalar_type() == kDouble) &&
+      src.stride(1) == 1 && output.stride(1) == 1;
 }
 
 bool isFastPathIndexSelectScale(const Tensor& src, const Tensor& scale, Tensor& output) {
-  return src.scalar_type() == kFloat && src.stride(1) == 1 && output.stride(1) == 1 && scale.stride(0) == 1;
+  return isFastPathIndexSelect(src, output) && scale.stride(0) == 1;
+}
+
+// The fast path kernels take the start of every bag followed by the end of
+// the last one.
+Tensor offsets_include_last(const Tensor& offsets, const Tensor& indices, bool include_last_offset) {
+  if (include_last_offset) {
+    return offsets;
+  }
+  auto result = at::empty({offsets.numel() + 1}, offsets.options());
+  std::memcpy(
+      result.data_ptr<int64_t>(),
+      offsets.data_ptr<int64_t>(),
+      sizeof(int64_t) * offsets.numel());
+  result.data_ptr<int64_t>()[offsets.numel()] = indices.numel();
+  return result;
 }
 
 // This function combines index_select (using select_indices as the index) and
@@ -53,8 +74,16 @@ void index_select_add(const Tensor &select_indices,
                              const Tensor &add_indices,
                              const Tensor &src,
                              Tensor &output,
-                             const Tensor& /*offsets*/,
-                             bool /*include_last_offset*/) {
+                             const Tensor& offsets,
+                             bool include_last_offset,
+                             bool normalize_by_lengths) {
+  if (isFastPathIndexSelect(src, output)) {
+    embedding_bag_sum_stub(
+        kCPU, output, src, select_indices,
+        offsets_include_last(offsets, select_indices, include_last_offset),
+        Tensor(), normalize_by_lengths);
+    return;
+  }
   AT_ASSERT(select_indices.numel() == add_indices.numel());
   auto* add_indices_data = add_indices.data_ptr<int64_t>();
   auto* select_indices_data = select_indices.data_ptr<int64_t>();
@@ -80,43 +109,33 @@ void index_select_add<float>(const Tensor &select_indices,
                              const Tensor &src,
                              Tensor &output,
                              const Tensor& offsets,
-                             bool include_last_offset) {
+                             bool include_last_offset,
+                             bool normalize_by_lengths) {
   int64_t ddim = src.size(1);
   auto* src_data = src.data_ptr<float>();
   auto* select_indices_data = select_indices.data_ptr<int64_t>();
   auto* output_data = output.data_ptr<float>();
 
   if (isFastPathIndexSelect(src, output)) {
-    int64_t output_size = offsets.numel() - 1;
-    auto* offsets_data = offsets.data_ptr<int64_t>();
-    std::vector<int64_t> offsets_include_last;
-
-    if (include_last_offset) {
-      output_size = offsets.numel() - 1;
-    } else {
-      output_size = offsets.numel();
-      offsets_include_last.resize(offsets.numel() + 1);
-      std::memcpy(
-          offsets_include_last.data(),
-          offsets.data_ptr<int64_t>(),
-          sizeof(int64_t) * offsets.numel());
-      offsets_include_last[offsets.numel()] = select_indices.numel();
-      offsets_data = offsets_include_last.data();
-    }
+    auto bag_offsets = offsets_include_last(offsets, select_indices, include_last_offset);
+    int64_t output_size = bag_offsets.numel() - 1;
+    auto* offsets_data = bag_offsets.data_ptr<int64_t>();
 
 #ifdef USE_FBGEMM
     auto kernel_fp32_i64 =
       fbgemm::GenerateEmbeddingSpMDM<float, int64_t, int64_t>(
         /* block_size */ddim,
         /* has_weight */false,
-        /* normalize_by_lengths */false,
+        /* normalize_by_lengths */normalize_by_lengths,
         /* prefetch */16,
         /* is_weight_positional */false,
         /* use_offsets */true
       );
 #endif
     at::parallel_for(
-        0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
+        0, output_size,
+        embedding_bag_grain_size(offsets_data[output_size], output_size, ddim),
+        [&](int64_t start_idx, int64_t end_idx) {
 #ifdef USE_FBGEMM
           kernel_fp32_i64(
             /* output_size */end_idx - start_idx,
@@ -138,7 +157,7 @@ void index_select_add<float>(const Tensor &select_indices,
               /*offsets=*/offsets_data + start_idx,
               /*weights=*/nullptr,
               /*scale_bias=*/nullptr,
-              /*normalize_by_lengths=*/false,
+              /*normalize_by_lengths=*/normalize_by_lengths,
               /*out=*/output_data + start_idx * ddim);
 #endif
         });
@@ -172,8 +191,15 @@ static void index_select_scale_add(const Tensor &select_indices,
                                    const Tensor &scale,
                                    const Tensor &src,
                                    Tensor &output,
-                                   const Tensor& /*offsets*/,
-                                   bool /*include_last_offset*/) {
+                                   const Tensor& offsets,
+                                   bool include_last_offset) {
+  if (isFastPathIndexSelectScale(src, scale, output)) {
+    embedding_bag_sum_stub(
+        kCPU, output, src, select_indices,
+        offsets_include_last(offsets, select_indices, include_last_offset),
+        scale, /*normalize_by_lengths=*/false);
+    return;
+  }
   AT_ASSERT(select_indices.numel() == add_indices.numel());
   auto* add_indices_data = add_indices.data_ptr<int64_t>();
   auto* select_indices_data = select_indices.data_ptr<int64_t>();
@@ -214,22 +240,9 @@ void index_select_scale_add<float>(const Tensor &select_indices,
   auto* output_data = output.data_ptr<float>();
 
   if (isFastPathIndexSelectScale(src, scale, output)) {
-    int64_t output_size = offsets.numel() - 1;
-    auto* offsets_data = offsets.data_ptr<int64_t>();
-    std::vector<int64_t> offsets_include_last;
-
-    if (include_last_offset) {
-      output_size = offsets.numel() - 1;
-    } else {
-      output_size = offsets.numel();
-      offsets_include_last.resize(offsets.numel() + 1);
-      std::memcpy(
-          offsets_include_last.data(),
-          offsets.data_ptr<int64_t>(),
-          sizeof(int64_t) * offsets.numel());
-      offsets_include_last[offsets.numel()] = select_indices.numel();
-      offsets_data = offsets_include_last.data();
-    }
+    auto bag_offsets = offsets_include_last(offsets, select_indices, include_last_offset);
+    int64_t output_size = bag_offsets.numel() - 1;
+    auto* offsets_data = bag_offsets.data_ptr<int64_t>();
 
 #ifdef USE_FBGEMM
     auto kernel_fp32_i64 =
@@ -243,7 +256,9 @@ void index_select_scale_add<float>(const Tensor &select_indices,
       );
 #endif
     at::parallel_for(
-        0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
+        0, output_size,
+        embedding_bag_grain_size(offsets_data[output_size], output_size, ddim),
+        [&](int64_t start_idx, int64_t end_idx) {
 #ifdef USE_FBGEMM
           kernel_fp32_i64(
             /* output_size */end_idx - start_idx,
@@ -456,21 +471,19 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
        weight.size(1)},
       weight.options());
 
-  // To save compute, if we are going to go down the fast path case for the 'sum'
-  // mode, we skip calculating offset2bag, since it is not going to be used.
-  auto fast_path_sum = [&weight, &per_sample_weights, &output]() {
-    if (per_sample_weights.defined()) {
-      return isFastPathIndexSelectScale(weight, per_sample_weights, output);
-    } else {
-      return isFastPathIndexSelect(weight, output);
-    }
-  };
+  // The fast path kernels reduce each bag straight from `offsets`, write every
+  // row of `output` and divide by the bag lengths in mode 'mean' themselves.
+  // In modes 'sum' and 'max' we also skip calculating offset2bag, since it is
+  // not going to be used.
+  const bool fast_path = per_sample_weights.defined()
+      ? isFastPathIndexSelectScale(weight, per_sample_weights, output)
+      : isFastPathIndexSelect(weight, output);
 
   // Use an empty 0-element tensor as a sentinel that we have skipped the
   // creation of offset2bag because autograd chokes when trying to use an
   // undefined tensor as an input to a backward op.
   Tensor offset2bag = at::empty({0}, offsets.options());
-  if (mode == MODE_MEAN || mode == MODE_MAX || !fast_path_sum()) {
+  if (mode == MODE_MEAN || !fast_path) {
     // If the last entries are empty, that the last offsets are irrelevant as they
     // won't change anything in the assignment of ID -> bag, but index_add would
     // throw out of bounds error. So to keep it simple we just add one more
@@ -481,8 +494,8 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
     make_offset2bag(offsets, indices, offset2bag);
 
     offset2bag.resize_({indices.sizes()[0]});
-
-    // only initialize output in slow path
+  }
+  if (!fast_path) {
     output.zero_();
   }
 
@@ -493,15 +506,22 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
         index_select_scale_add<scalar_t>(
             indices, offset2bag, per_sample_weights, weight, output, offsets, include_last_offset);
       } else {
-        index_select_add<scalar_t>(indices, offset2bag, weight, output, offsets, include_last_offset);
+        index_select_add<scalar_t>(
+            indices, offset2bag, weight, output, offsets, include_last_offset,
+            /*normalize_by_lengths=*/mode == MODE_MEAN);
       }
     });
-    auto ret = apply_bag_size(offsets, indices, mode, output, bag_size);
-    return std::tuple<Tensor, Tensor, Tensor, Tensor>(ret, offset2bag, bag_size, bag_size);
+    if (!fast_path) {
+      apply_bag_size(offsets, indices, mode, output, bag_size);
+    }
+    return std::tuple<Tensor, Tensor, Tensor, Tensor>(output, offset2bag, bag_size, bag_size);
   } else { // MODE_MAX
-    at::optional<Tensor> maybe_per_sample_weights;
-    if (per_sample_weights.defined()) {
-      maybe_per_sample_weights = per_sample_weights;
+    if (fast_path) {
+      auto max_indices = at::zeros({offsets.size(0), weight.size(1)}, indices.options());
+      embedding_bag_max_stub(
+          kCPU, output, max_indices, weight, indices,
+          offsets_include_last(offsets, indices, include_last_offset));
+      return std::tuple<Tensor, Tensor, Tensor, Tensor>(output, offset2bag, bag_size, max_indices);
     }
     return AT_DISPATCH_FLOATING_TYPES_AND_HALF(
       weight.scalar_type(), "embedding_bag_cpu_max", [&]() {
@@ -828,5 +848,62 @@ Tensor _embedding_bag_sparse_backward(
   return native::embedding_backward(index_grad, indices, num_weights, -1,
                                     scale_grad_by_freq, true);
 }
+
+// The CPU version applies the optimizer to the rows of the coalesced sparse
+// gradient; the CUDA one fuses it into the backward kernel.
+void _embedding_bag_fused_update_cpu_(
+    Tensor& weight,
+    Tensor& optimizer_state,
+    const Tensor& grad,
+    const Tensor& indices,
+    const Tensor& offsets,
+    const Tensor& offset2bag,
+    const Tensor& bag_size,
+    bool scale_grad_by_freq,
+    int64_t mode,
+    const Tensor& per_sample_weights,
+    std::string optimizer_name,
+    double lr,
+    double eps) {
+  const auto optimizer = embedding_fused_optimizer_from_string(optimizer_name);
+  check_embedding_fused_update_args(weight, optimizer_state, optimizer, mode);
+  auto indices_arg = TensorArg(indices, "indices", 4);
+  checkScalarType("_embedding_bag_fused_update_", indices_arg, kLong);
+  checkContiguous("_embedding_bag_fused_update_", indices_arg);
+  if (indices.numel() == 0) {
+    return;
+  }
+
+  Tensor offset2bag_ = offset2bag;
+  if (offset2bag.numel() == 0) {
+    offset2bag_ = at::zeros({indices.size(0) + 1}, indices.options());
+    make_offset2bag(offsets, indices, offset2bag_);
+    offset2bag_.resize_({indices.size(0)});
+  }
+
+  auto sparse_grad = at::_embedding_bag_sparse_backward(
+      grad, indices, offsets, offset2bag_, bag_size, weight.size(0),
+      scale_grad_by_freq, mode, per_sample_weights).coalesce();
+  auto rows = sparse_grad._indices()[0];
+  auto values = sparse_grad._values();
+
+  switch (optimizer) {
+    case EmbeddingFusedOptimizer::SGD:
+      weight.index_add_(0, rows, values.mul(-lr));
+      break;
+    case EmbeddingFusedOptimizer::Adagrad: {
+      optimizer_state.index_add_(0, rows, values.mul(values));
+      auto std = optimizer_state.index_select(0, rows).sqrt_().add_(eps);
+      weight.index_add_(0, rows, values.div(std).mul_(-lr));
+      break;
+    }
+    case EmbeddingFusedOptimizer::RowWiseAdagrad: {
+      optimizer_state.index_add_(0, rows, values.mul(values).mean(1));
+      auto std = optimizer_state.index_select(0, rows).sqrt_().add_(eps);
+      weight.index_add_(0, rows, values.div(std.unsqueeze(1)).mul_(-lr));
+      break;
+    }
+  }
+}
 }
 } // namespace at::native
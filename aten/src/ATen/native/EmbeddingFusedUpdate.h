@@ -0,0 +1,77 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+#include <string>
+
+// The optimizers that _embedding_bag_fused_update_ applies to the rows of an
+// embedding weight, straight from the segment reduction of the backward of
+// embedding_bag instead of through a (sparse) gradient:
+//
+//   SGD:              w -= lr * g
+//   Adagrad:          s += g * g;           w -= lr * g / (sqrt(s) + eps)
+//   RowWiseAdagrad:   s += mean(g * g);     w -= lr * g / (sqrt(s) + eps)
+//
+// where g is the gradient of a row, and s is the optimizer state: unused for
+// SGD, of the size of the weight for Adagrad, and one element per row for
+// row-wise Adagrad. The state is in the accumulate type of the weight.
+
+namespace at {
+namespace native {
+
+enum class EmbeddingFusedOptimizer { SGD, Adagrad, RowWiseAdagrad };
+
+inline EmbeddingFusedOptimizer embedding_fused_optimizer_from_string(
+    const std::string& optimizer) {
+  if (optimizer == "sgd") {
+    return EmbeddingFusedOptimizer::SGD;
+  } else if (optimizer == "adagrad") {
+    return EmbeddingFusedOptimizer::Adagrad;
+  } else if (optimizer == "rowwise_adagrad") {
+    return EmbeddingFusedOptimizer::RowWiseAdagrad;
+  }
+  TORCH_CHECK(
+      false,
+      "_embedding_bag_fused_update_: optimizer has to be one of sgd, adagrad "
+      "or rowwise_adagrad, but got ", optimizer);
+}
+
+inline void check_embedding_fused_update_args(
+    const Tensor& weight,
+    const Tensor& optimizer_state,
+    EmbeddingFusedOptimizer optimizer,
+    int64_t mode) {
+  TORCH_CHECK(
+      weight.dim() == 2 && weight.is_contiguous(),
+      "_embedding_bag_fused_update_: expected a contiguous 2D weight");
+  TORCH_CHECK(
+      mode == 0 || mode == 1,
+      "_embedding_bag_fused_update_: only the sum and mean modes are supported");
+  if (optimizer == EmbeddingFusedOptimizer::SGD) {
+    return;
+  }
+  const auto state_type = toValueType(
+      weight.scalar_type() == kHalf || weight.scalar_type() == kBFloat16
+          ? kFloat
+          : weight.scalar_type());
+  TORCH_CHECK(
+      optimizer_state.scalar_type() == state_type &&
+          optimizer_state.device() == weight.device() &&
+          optimizer_state.is_contiguous(),
+      "_embedding_bag_fused_update_: expected a contiguous optimizer state of type ",
+      state_type, " on ", weight.device());
+  if (optimizer == EmbeddingFusedOptimizer::Adagrad) {
+    TORCH_CHECK(
+        optimizer_state.sizes() == weight.sizes(),
+        "_embedding_bag_fused_update_: expected an Adagrad state of size ",
+        weight.sizes(), ", but got ", optimizer_state.sizes());
+  } else {
+    TORCH_CHECK(
+        optimizer_state.dim() == 1 && optimizer_state.size(0) == weight.size(0),
+        "_embedding_bag_fused_update_: expected a row-wise Adagrad state of size [",
+        weight.size(0), "], but got ", optimizer_state.sizes());
+  }
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,140 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/ThreadLocalState.h>
+#include <ATen/native/ForeachUtils.h>
+
+#include <algorithm>
+
+// The _foreach ops, op by op. These are the CPU kernels, and the fallback of
+// the CUDA kernels for inputs the multi-tensor apply kernels don't handle.
+
+namespace at { namespace native {
+
+namespace {
+
+// Runs fn(i) for each position i of the tensor lists. On CPU, lists of small
+// tensors are split across threads, with each tensor handled by one thread, so
+// that a list of thousands of parameters doesn't run thousands of tiny ops in
+// order. Lists with a large tensor run in order, so that every op can use all
+// threads.
+template <typename F>
+void foreach_tensor_apply(TensorList tensors, const F& fn) {
+  const int64_t n = tensors.size();
+  int64_t total_numel = 0;
+  bool small = tensors[0].device().is_cpu();
+  for (const auto& tensor : tensors) {
+    if (!small) {
+      break;
+    }
+    small = tensor.numel() < internal::GRAIN_SIZE;
+    total_numel += tensor.numel();
+  }
+  if (!small || n == 1) {
+    for (int64_t i = 0; i < n; i++) {
+      fn(i);
+    }
+    return;
+  }
+  // Give every thread at least GRAIN_SIZE elements.
+  const int64_t grain_size = std::max<int64_t>(
+      1, internal::GRAIN_SIZE * n / std::max<int64_t>(total_numel, 1));
+  const ThreadLocalState state;
+  at::parallel_for(0, n, grain_size, [&](int64_t begin, int64_t end) {
+    ThreadLocalStateGuard guard(state);
+    for (int64_t i = begin; i < end; i++) {
+      fn(i);
+    }
+  });
+}
+
+} // namespace
+
+#define FOREACH_BINARY_OP_SCALAR(NAME)                                                       \
+std::vector<Tensor> foreach_tensor_##NAME##_scalar_kernel_slow(TensorList tensors, Scalar scalar) { \
+  check_foreach_api_restrictions(tensors);                                                 \
+  std::vector<Tensor> result(tensors.size());                                              \
+  foreach_tensor_apply(tensors, [&](int64_t i) { result[i] = tensors[i].NAME(scalar); });  \
+  return result;                                                                           \
+}                                                                                          \
+                                                                                           \
+void foreach_tensor_##NAME##_scalar_kernel_slow_(TensorList tensors, Scalar scalar) {      \
+  check_foreach_api_restrictions(tensors);                                                 \
+  foreach_tensor_apply(tensors, [&](int64_t i) { tensors[i].NAME##_(scalar); });           \
+}
+
+#define FOREACH_BINARY_OP_LIST_ALPHA(NAME)                                                   \
+std::vector<Tensor> foreach_tensor_##NAME##_list_kernel_slow(                              \
+    TensorList tensors1, TensorList tensors2, Scalar alpha) {                              \
+  check_foreach_api_restrictions(tensors1, tensors2);                                      \
+  std::vector<Tensor> result(tensors1.size());                                             \
+  foreach_tensor_apply(tensors1, [&](int64_t i) {                                          \
+    result[i] = tensors1[i].NAME(tensors2[i], alpha);                                      \
+  });                                                                                      \
+  return result;                                                                           \
+}                                                                                          \
+                                                                                           \
+void foreach_tensor_##NAME##_list_kernel_slow_(TensorList self, TensorList other, Scalar alpha) { \
+  check_foreach_api_restrictions(self, other);                                             \
+  foreach_tensor_apply(self, [&](int64_t i) { self[i].NAME##_(other[i], alpha); });        \
+}
+
+#define FOREACH_BINARY_OP_LIST(NAME)                                                         \
+std::vector<Tensor> foreach_tensor_##NAME##_list_kernel_slow(                              \
+    TensorList tensors1, TensorList tensors2) {                                            \
+  check_foreach_api_restrictions(tensors1, tensors2);                                      \
+  std::vector<Tensor> result(tensors1.size());                                             \
+  foreach_tensor_apply(tensors1, [&](int64_t i) { result[i] = tensors1[i].NAME(tensors2[i]); }); \
+  return result;                                                                           \
+}                                                                                          \
+                                                                                           \
+void foreach_tensor_##NAME##_list_kernel_slow_(TensorList self, TensorList other) {        \
+  check_foreach_api_restrictions(self, other);                                             \
+  foreach_tensor_apply(self, [&](int64_t i) { self[i].NAME##_(other[i]); });               \
+}
+
+#define FOREACH_POINTWISE_OP(NAME)                                                           \
+std::vector<Tensor> foreach_tensor_##NAME##_kernel_slow(                                   \
+    TensorList input, TensorList tensors1, TensorList tensors2, Scalar value) {            \
+  check_foreach_api_restrictions(input, tensors1, tensors2);                               \
+  std::vector<Tensor> result(input.size());                                                \
+  foreach_tensor_apply(input, [&](int64_t i) {                                             \
+    result[i] = input[i].NAME(tensors1[i], tensors2[i], value);                            \
+  });                                                                                      \
+  return result;                                                                           \
+}                                                                                          \
+                                                                                           \
+void foreach_tensor_##NAME##_kernel_slow_(                                                 \
+    TensorList self, TensorList tensors1, TensorList tensors2, Scalar value) {             \
+  check_foreach_api_restrictions(self, tensors1, tensors2);                                \
+  foreach_tensor_apply(self, [&](int64_t i) {                                              \
+    self[i].NAME##_(tensors1[i], tensors2[i], value);                                      \
+  });                                                                                      \
+}
+
+#define FOREACH_UNARY_OP(NAME)                                                               \
+std::vector<Tensor> foreach_tensor_##NAME##_kernel_slow(TensorList tensors) {              \
+  check_foreach_api_restrictions(tensors);                                                 \
+  std::vector<Tensor> result(tensors.size());                                              \
+  foreach_tensor_apply(tensors, [&](int64_t i) { result[i] = tensors[i].NAME(); });        \
+  return result;                                                                           \
+}                                                                                          \
+                                                                                           \
+void foreach_tensor_##NAME##_kernel_slow_(TensorList tensors) {                            \
+  check_foreach_api_restrictions(tensors);                                                 \
+  foreach_tensor_apply(tensors, [&](int64_t i) { tensors[i].NAME##_(); });                 \
+}
+
+FOREACH_BINARY_OP_SCALAR(add);
+FOREACH_BINARY_OP_SCALAR(sub);
+FOREACH_BINARY_OP_SCALAR(mul);
+FOREACH_BINARY_OP_SCALAR(div);
+FOREACH_BINARY_OP_LIST_ALPHA(add);
+FOREACH_BINARY_OP_LIST_ALPHA(sub);
+FOREACH_BINARY_OP_LIST(mul);
+FOREACH_BINARY_OP_LIST(div);
+FOREACH_POINTWISE_OP(addcmul);
+FOREACH_POINTWISE_OP(addcdiv);
+FOREACH_UNARY_OP(sqrt);
+
+}} // namespace at::native
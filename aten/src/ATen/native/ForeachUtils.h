@@ -0,0 +1,57 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at { namespace native {
+
+// Argument checks and the choice of kernel shared by the _foreach ops.
+
+static inline void check_foreach_api_restrictions(TensorList tensors) {
+  TORCH_CHECK(tensors.size() > 0, "Tensor list must have at least one tensor.");
+}
+
+static inline void check_foreach_api_restrictions(TensorList tensors1, TensorList tensors2) {
+  check_foreach_api_restrictions(tensors1);
+  TORCH_CHECK(tensors1.size() == tensors2.size(),
+              "Tensor lists must have the same number of tensors, got ",
+              tensors1.size(), " and ", tensors2.size());
+}
+
+static inline void check_foreach_api_restrictions(
+    TensorList tensors1, TensorList tensors2, TensorList tensors3) {
+  check_foreach_api_restrictions(tensors1, tensors2);
+  check_foreach_api_restrictions(tensors1, tensors3);
+}
+
+// Whether the multi-tensor apply CUDA kernels can run the op: all tensors are
+// dense, contiguous, floating point tensors of the same dtype on the same CUDA
+// device, the tensors at each position of the lists have the same sizes, so
+// that nothing broadcasts, and the scalars don't promote the result type.
+// Everything else runs op by op.
+static inline bool can_use_fast_route(
+    ArrayRef<TensorList> tensor_lists, ArrayRef<Scalar> scalars = {}) {
+  const auto& first = tensor_lists[0][0];
+  const auto dtype = first.scalar_type();
+  if (!first.is_cuda() || (dtype != kFloat && dtype != kDouble && dtype != kHalf)) {
+    return false;
+  }
+  for (const auto& scalar : scalars) {
+    if (scalar.isComplex()) {
+      return false;
+    }
+  }
+  for (size_t t = 0; t < tensor_lists[0].size(); t++) {
+    for (const auto& tensor_list : tensor_lists) {
+      const auto& tensor = tensor_list[t];
+      if (tensor.device() != first.device() ||
+          tensor.scalar_type() != first.scalar_type() ||
+          tensor.layout() != kStrided || !tensor.is_contiguous() ||
+          tensor.sizes() != tensor_lists[0][t].sizes()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}} // namespace at::native
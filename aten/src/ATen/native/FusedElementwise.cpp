@@ -0,0 +1,119 @@
+#include <ATen/native/FusedElementwise.h>
+
+#include <ATen/ATen.h>
+#include <ATen/native/TensorIterator.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(fused_elementwise_stub);
+
+FusedElementwiseProgram::FusedElementwiseProgram(int64_t num_inputs)
+  : num_inputs_(num_inputs) {
+  TORCH_CHECK(num_inputs > 0, "fused_elementwise: expected at least one input, got ", num_inputs);
+}
+
+void FusedElementwiseProgram::check_value(Value v) const {
+  TORCH_CHECK(v >= 0 && v < num_values(),
+      "fused_elementwise: value ", v, " is not defined; the program has ",
+      num_values(), " values");
+}
+
+FusedElementwiseProgram::Value FusedElementwiseProgram::append(FusedInstruction instruction) {
+  instructions_.push_back(instruction);
+  return num_values() - 1;
+}
+
+FusedElementwiseProgram::Value FusedElementwiseProgram::input(int64_t i) const {
+  TORCH_CHECK(i >= 0 && i < num_inputs_,
+      "fused_elementwise: input ", i, " is out of range for a program with ",
+      num_inputs_, " inputs");
+  return i;
+}
+
+FusedElementwiseProgram::Value FusedElementwiseProgram::constant(double value) {
+  FusedInstruction instruction;
+  instruction.op = FusedOp::Constant;
+  instruction.scalar = value;
+  return append(instruction);
+}
+
+FusedElementwiseProgram::Value FusedElementwiseProgram::unary(FusedOp op, Value a) {
+  check_value(a);
+  FusedInstruction instruction;
+  instruction.op = op;
+  instruction.a = a;
+  return append(instruction);
+}
+
+FusedElementwiseProgram::Value FusedElementwiseProgram::binary(FusedOp op, Value a, Value b) {
+  check_value(a);
+  check_value(b);
+  FusedInstruction instruction;
+  instruction.op = op;
+  instruction.a = a;
+  instruction.b = b;
+  return append(instruction);
+}
+
+FusedElementwiseProgram::Value FusedElementwiseProgram::clamp(Value a, double min, double max) {
+  check_value(a);
+  TORCH_CHECK(min <= max, "fused_elementwise: clamp expects min <= max, got ", min, " and ", max);
+  FusedInstruction instruction;
+  instruction.op = FusedOp::Clamp;
+  instruction.a = a;
+  instruction.scalar = min;
+  instruction.scalar2 = max;
+  return append(instruction);
+}
+
+FusedElementwiseProgram::Value FusedElementwiseProgram::fmadd(Value a, Value b, Value c) {
+  check_value(a);
+  check_value(b);
+  check_value(c);
+  FusedInstruction instruction;
+  instruction.op = FusedOp::Fmadd;
+  instruction.a = a;
+  instruction.b = b;
+  instruction.c = c;
+  return append(instruction);
+}
+
+void FusedElementwiseProgram::add_output(Value v) {
+  check_value(v);
+  outputs_.push_back(v);
+}
+
+std::vector<Tensor> fused_elementwise(
+    const FusedElementwiseProgram& program,
+    TensorList inputs) {
+  TORCH_CHECK(static_cast<int64_t>(inputs.size()) == program.num_inputs(),
+      "fused_elementwise: the program expects ", program.num_inputs(),
+      " inputs, but got ", inputs.size());
+  TORCH_CHECK(!program.outputs().empty(), "fused_elementwise: the program has no outputs");
+
+  auto iter = TensorIterator();
+  iter.set_check_mem_overlap(true);
+  for (size_t i = 0; i < program.outputs().size(); i++) {
+    iter.add_output(Tensor());
+  }
+  for (const auto& input : inputs) {
+    iter.add_input(input);
+  }
+  iter.promote_common_dtype();
+  iter.build();
+  TORCH_CHECK(isFloatingType(iter.dtype()),
+      "fused_elementwise: expected floating point inputs, got ", iter.dtype());
+
+  fused_elementwise_stub(iter.device_type(), iter, program);
+
+  std::vector<Tensor> outputs;
+  outputs.reserve(iter.noutputs());
+  for (int i = 0; i < iter.noutputs(); i++) {
+    outputs.push_back(iter.output(i));
+  }
+  return outputs;
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+#include <vector>
+
+namespace at { struct TensorIterator; }
+
+// A fused element-wise kernel evaluates a small straight-line program over
+// its (broadcast) inputs in a single pass of TensorIterator, producing one or
+// more outputs. An expression such as `x * sigmoid(x)` or `a * b + c` written
+// with separate ATen ops streams the tensors through memory once per op; as a
+// program it reads every input once and writes every output once, and the
+// intermediates only live in small per-thread buffers.
+//
+// Because the program is data rather than a C++ lambda it can be built at
+// runtime, e.g. by a JIT fuser:
+//
+//   FusedElementwiseProgram program(/*num_inputs=*/1);
+//   auto x = program.input(0);
+//   auto y = program.mul(x, program.sigmoid(x));
+//   program.add_output(y);
+//   std::vector<Tensor> outputs = at::native::fused_elementwise(program, {t});
+//
+// Values are numbered registers; inputs occupy the first registers and every
+// instruction defines a new one. All inputs are promoted to their common
+// dtype, which must be a floating point type, and the computation is done in
+// that dtype. The kernel is not differentiable.
+
+namespace at {
+namespace native {
+
+enum class FusedOp : uint8_t {
+  // holds `scalar`
+  Constant,
+  // unary
+  Neg,
+  Abs,
+  Exp,
+  Log,
+  Sqrt,
+  Rsqrt,
+  Reciprocal,
+  Sigmoid,
+  Tanh,
+  Relu,
+  // clamps `a` to [scalar, scalar2]
+  Clamp,
+  // binary
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Minimum,
+  Maximum,
+  // a * b + c
+  Fmadd,
+};
+
+struct FusedInstruction {
+  FusedOp op;
+  int64_t a = -1;
+  int64_t b = -1;
+  int64_t c = -1;
+  double scalar = 0;
+  double scalar2 = 0;
+};
+
+struct CAFFE2_API FusedElementwiseProgram {
+  using Value = int64_t;
+
+  explicit FusedElementwiseProgram(int64_t num_inputs);
+
+  Value input(int64_t i) const;
+  Value constant(double value);
+
+  Value neg(Value a) { return unary(FusedOp::Neg, a); }
+  Value abs(Value a) { return unary(FusedOp::Abs, a); }
+  Value exp(Value a) { return unary(FusedOp::Exp, a); }
+  Value log(Value a) { return unary(FusedOp::Log, a); }
+  Value sqrt(Value a) { return unary(FusedOp::Sqrt, a); }
+  Value rsqrt(Value a) { return unary(FusedOp::Rsqrt, a); }
+  Value reciprocal(Value a) { return unary(FusedOp::Reciprocal, a); }
+  Value sigmoid(Value a) { return unary(FusedOp::Sigmoid, a); }
+  Value tanh(Value a) { return unary(FusedOp::Tanh, a); }
+  Value relu(Value a) { return unary(FusedOp::Relu, a); }
+  Value clamp(Value a, double min, double max);
+
+  Value add(Value a, Value b) { return binary(FusedOp::Add, a, b); }
+  Value sub(Value a, Value b) { return binary(FusedOp::Sub, a, b); }
+  Value mul(Value a, Value b) { return binary(FusedOp::Mul, a, b); }
+  Value div(Value a, Value b) { return binary(FusedOp::Div, a, b); }
+  Value minimum(Value a, Value b) { return binary(FusedOp::Minimum, a, b); }
+  Value maximum(Value a, Value b) { return binary(FusedOp::Maximum, a, b); }
+  Value fmadd(Value a, Value b, Value c);
+
+  /// Marks `v` as the next output; outputs are returned in this order.
+  void add_output(Value v);
+
+  int64_t num_inputs() const { return num_inputs_; }
+  /// number of registers, inputs included
+  int64_t num_values() const { return num_inputs_ + instructions_.size(); }
+  const std::vector<FusedInstruction>& instructions() const { return instructions_; }
+  const std::vector<Value>& outputs() const { return outputs_; }
+
+ private:
+  Value unary(FusedOp op, Value a);
+  Value binary(FusedOp op, Value a, Value b);
+  Value append(FusedInstruction instruction);
+  void check_value(Value v) const;
+
+  int64_t num_inputs_;
+  // instruction i defines register num_inputs_ + i
+  std::vector<FusedInstruction> instructions_;
+  std::vector<Value> outputs_;
+};
+
+/// Evaluates `program` on `inputs` and returns its outputs, which have the
+/// broadcast shape of the inputs.
+CAFFE2_API std::vector<Tensor> fused_elementwise(
+    const FusedElementwiseProgram& program,
+    TensorList inputs);
+
+using fused_elementwise_fn =
+    void (*)(TensorIterator&, const FusedElementwiseProgram&);
+
+DECLARE_DISPATCH(fused_elementwise_fn, fused_elementwise_stub);
+
+} // namespace native
+} // namespace at
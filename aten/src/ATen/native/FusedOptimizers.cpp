@@ -0,0 +1,184 @@
+#include <ATen/native/FusedOptimizers.h>
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+
+#include <cmath>
+#include <vector>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(fused_adam_stub);
+DEFINE_DISPATCH(fused_sgd_stub);
+DEFINE_DISPATCH(fused_adagrad_stub);
+DEFINE_DISPATCH(fused_rmsprop_stub);
+
+namespace {
+
+// Checks that every list holds as many tensors as the first one, and that
+// the tensors of all lists are contiguous CPU tensors of one floating point
+// type, with as many elements as the corresponding parameter. Empty lists
+// stand for unused state and are skipped.
+void check_fused_optimizer_inputs(
+    const char* name,
+    const std::vector<TensorList>& tensor_lists) {
+  const auto& params = tensor_lists[0];
+  TORCH_CHECK(!params.empty(), name, ": expected a non-empty list of tensors");
+  const auto& first = params[0];
+  TORCH_CHECK(
+      first.scalar_type() == kFloat || first.scalar_type() == kDouble,
+      name, ": expected float or double tensors, but got ", first.scalar_type());
+  for (size_t d = 0; d < tensor_lists.size(); d++) {
+    const auto& list = tensor_lists[d];
+    if (d > 1 && list.empty()) {
+      continue;
+    }
+    TORCH_CHECK(
+        list.size() == params.size(),
+        name, ": expected all tensor lists to have ", params.size(),
+        " tensors, but list ", d, " has ", list.size());
+    for (size_t t = 0; t < list.size(); t++) {
+      const auto& tensor = list[t];
+      TORCH_CHECK(
+          tensor.device().is_cpu(),
+          name, ": expected all tensors on CPU, but got a tensor on ",
+          tensor.device());
+      TORCH_CHECK(
+          tensor.scalar_type() == first.scalar_type(),
+          name, ": expected all tensors of type ", first.scalar_type(),
+          ", but got a tensor of type ", tensor.scalar_type());
+      TORCH_CHECK(
+          tensor.layout() == kStrided && tensor.is_contiguous(),
+          name, ": expected dense contiguous tensors");
+      TORCH_CHECK(
+          tensor.numel() == params[t].numel(),
+          name, ": expected tensor ", t, " of every list to have ",
+          params[t].numel(), " elements, but the one in list ", d, " has ",
+          tensor.numel());
+    }
+  }
+}
+
+Tensor at_or_undefined(TensorList list, size_t i) {
+  return list.empty() ? Tensor() : list[i];
+}
+
+// Whether an optional found_inf says to skip the step. On CPU reading it
+// costs no sync.
+bool skip_step(const Tensor& found_inf) {
+  if (!found_inf.defined()) {
+    return false;
+  }
+  TORCH_CHECK(
+      found_inf.numel() == 1 && found_inf.scalar_type() == kFloat,
+      "found_inf must be a 1-element float tensor.");
+  return found_inf.item<float>() != 0;
+}
+
+} // namespace
+
+void _fused_adam_cpu_(
+    TensorList self, TensorList grads, TensorList exp_avgs, TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs, double lr, double beta1, double beta2, double eps,
+    double weight_decay, int64_t step, bool amsgrad, bool decoupled_weight_decay,
+    const Tensor& found_inf) {
+  TORCH_CHECK(
+      amsgrad != max_exp_avg_sqs.empty(),
+      "_fused_adam_: max_exp_avg_sqs must be given if and only if amsgrad is True");
+  check_fused_optimizer_inputs(
+      "_fused_adam_", {self, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs});
+  TORCH_CHECK(step > 0, "expected step > 0, but got ", step);
+  if (skip_step(found_inf)) {
+    return;
+  }
+  FusedAdamOptions options;
+  options.lr = lr;
+  options.beta1 = beta1;
+  options.beta2 = beta2;
+  options.eps = eps;
+  options.weight_decay = weight_decay;
+  options.bias_correction1 = 1 - std::pow(beta1, step);
+  options.sqrt_bias_correction2 = std::sqrt(1 - std::pow(beta2, step));
+  options.decoupled_weight_decay = decoupled_weight_decay;
+  for (size_t i = 0; i < self.size(); i++) {
+    fused_adam_stub(
+        kCPU, self[i], grads[i], exp_avgs[i], exp_avg_sqs[i],
+        at_or_undefined(max_exp_avg_sqs, i), options);
+  }
+}
+
+void _fused_sgd_cpu_(
+    TensorList self, TensorList grads, TensorList momentum_buffers, double lr,
+    double momentum, double dampening, double weight_decay, bool nesterov,
+    bool first_run, const Tensor& found_inf) {
+  TORCH_CHECK(!nesterov || (momentum > 0 && dampening == 0),
+              "_fused_sgd_: Nesterov momentum requires a momentum and zero dampening");
+  TORCH_CHECK(
+      (momentum != 0) != momentum_buffers.empty(),
+      "_fused_sgd_: momentum_buffers must be given if and only if momentum is not 0");
+  check_fused_optimizer_inputs("_fused_sgd_", {self, grads, momentum_buffers});
+  if (skip_step(found_inf)) {
+    return;
+  }
+  FusedSGDOptions options;
+  options.lr = lr;
+  options.momentum = momentum;
+  options.dampening = dampening;
+  options.weight_decay = weight_decay;
+  options.nesterov = nesterov;
+  options.first_run = first_run;
+  for (size_t i = 0; i < self.size(); i++) {
+    fused_sgd_stub(
+        kCPU, self[i], grads[i], at_or_undefined(momentum_buffers, i), options);
+  }
+}
+
+void _fused_adagrad_cpu_(
+    TensorList self, TensorList grads, TensorList state_sums, double lr,
+    double lr_decay, double weight_decay, double eps, int64_t step) {
+  check_fused_optimizer_inputs("_fused_adagrad_", {self, grads, state_sums});
+  TORCH_CHECK(
+      state_sums.size() == self.size(),
+      "_fused_adagrad_: expected a state sum for every parameter");
+  TORCH_CHECK(step > 0, "expected step > 0, but got ", step);
+  FusedAdagradOptions options;
+  options.clr = lr / (1 + static_cast<double>(step - 1) * lr_decay);
+  options.weight_decay = weight_decay;
+  options.eps = eps;
+  for (size_t i = 0; i < self.size(); i++) {
+    fused_adagrad_stub(kCPU, self[i], grads[i], state_sums[i], options);
+  }
+}
+
+void _fused_rmsprop_cpu_(
+    TensorList self, TensorList grads, TensorList square_avgs,
+    TensorList momentum_buffers, TensorList grad_avgs, double lr, double alpha,
+    double eps, double weight_decay, double momentum, bool centered) {
+  TORCH_CHECK(
+      (momentum > 0) != momentum_buffers.empty(),
+      "_fused_rmsprop_: momentum_buffers must be given if and only if momentum is positive");
+  TORCH_CHECK(
+      centered != grad_avgs.empty(),
+      "_fused_rmsprop_: grad_avgs must be given if and only if centered is True");
+  check_fused_optimizer_inputs(
+      "_fused_rmsprop_", {self, grads, square_avgs, momentum_buffers, grad_avgs});
+  TORCH_CHECK(
+      square_avgs.size() == self.size(),
+      "_fused_rmsprop_: expected a square average for every parameter");
+  FusedRMSpropOptions options;
+  options.lr = lr;
+  options.alpha = alpha;
+  options.eps = eps;
+  options.weight_decay = weight_decay;
+  options.momentum = momentum;
+  for (size_t i = 0; i < self.size(); i++) {
+    fused_rmsprop_stub(
+        kCPU, self[i], grads[i], square_avgs[i],
+        at_or_undefined(momentum_buffers, i), at_or_undefined(grad_avgs, i),
+        options);
+  }
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+// CPU kernels of the fused optimizer steps (_fused_adam_, _fused_sgd_,
+// _fused_adagrad_ and _fused_rmsprop_). Each kernel updates one parameter and
+// its optimizer state in a single vectorized pass, split across threads with
+// parallel_for; the entry points in FusedOptimizers.cpp check the tensor
+// lists and call the kernel for every parameter. The math matches the
+// multi-tensor CUDA kernels in cuda/FusedOptimizers.cu.
+//
+// All tensors passed to a kernel are contiguous CPU tensors of the same
+// floating point type and size. Optional state tensors are undefined when the
+// options don't use them.
+
+namespace at {
+namespace native {
+
+struct FusedAdamOptions {
+  double lr;
+  double beta1;
+  double beta2;
+  double eps;
+  double weight_decay;
+  double bias_correction1;
+  double sqrt_bias_correction2;
+  bool decoupled_weight_decay;
+};
+
+struct FusedSGDOptions {
+  double lr;
+  double momentum;
+  double dampening;
+  double weight_decay;
+  bool nesterov;
+  bool first_run;
+};
+
+struct FusedAdagradOptions {
+  // The learning rate after decay for the current step.
+  double clr;
+  double weight_decay;
+  double eps;
+};
+
+struct FusedRMSpropOptions {
+  double lr;
+  double alpha;
+  double eps;
+  double weight_decay;
+  double momentum;
+};
+
+// (param, grad, exp_avg, exp_avg_sq, max_exp_avg_sq)
+using fused_adam_fn = void (*)(
+    const Tensor&, const Tensor&, const Tensor&, const Tensor&, const Tensor&,
+    const FusedAdamOptions&);
+// (param, grad, momentum_buffer)
+using fused_sgd_fn = void (*)(
+    const Tensor&, const Tensor&, const Tensor&, const FusedSGDOptions&);
+// (param, grad, state_sum)
+using fused_adagrad_fn = void (*)(
+    const Tensor&, const Tensor&, const Tensor&, const FusedAdagradOptions&);
+// (param, grad, square_avg, momentum_buffer, grad_avg)
+using fused_rmsprop_fn = void (*)(
+    const Tensor&, const Tensor&, const Tensor&, const Tensor&, const Tensor&,
+    const FusedRMSpropOptions&);
+
+DECLARE_DISPATCH(fused_adam_fn, fused_adam_stub);
+DECLARE_DISPATCH(fused_sgd_fn, fused_sgd_stub);
+DECLARE_DISPATCH(fused_adagrad_fn, fused_adagrad_stub);
+DECLARE_DISPATCH(fused_rmsprop_fn, fused_rmsprop_stub);
+
+} // namespace native
+} // namespace at
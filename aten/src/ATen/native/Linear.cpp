@@ -2,13 +2,19 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/xnnpack/Engine.h>
 #include <ATen/WrapDimUtilsMulti.h>
+#include <ATen/TensorUtils.h>
 #include <c10/macros/Macros.h>
 
 #include <array>
+#include <bitset>
 #include <cctype>
 #include <cstddef>
+#include <limits>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace at { namespace native {
@@ -35,6 +41,29 @@ Tensor linear(const Tensor& input, const Tensor& weight, const Tensor& bias) {
   return output;
 }
 
+// flatten_for_bmm permutes t to "batch, rows, cols" and flattens each of the three groups
+// of dimensions, giving the {batch, rows, cols} operand of a bmm.
+// If that needs a copy but flattening "batch, cols, rows" does not, the latter is flattened
+// and transposed instead: bmm takes transposed operands without copying them.
+static Tensor flatten_for_bmm(const Tensor& t, IntArrayRef batch, IntArrayRef rows, IntArrayRef cols, IntArrayRef shape) {
+  std::vector<int64_t> permutation(batch.begin(), batch.end());
+  permutation.insert(permutation.end(), rows.begin(), rows.end());
+  permutation.insert(permutation.end(), cols.begin(), cols.end());
+  auto permuted = t.permute(permutation);
+  if (detail::computeStride(permuted.sizes(), permuted.strides(), shape)) {
+    return permuted.view(shape);
+  }
+  std::vector<int64_t> transposed_permutation(batch.begin(), batch.end());
+  transposed_permutation.insert(transposed_permutation.end(), cols.begin(), cols.end());
+  transposed_permutation.insert(transposed_permutation.end(), rows.begin(), rows.end());
+  auto transposed = t.permute(transposed_permutation);
+  std::vector<int64_t> transposed_shape{shape[0], shape[2], shape[1]};
+  if (detail::computeStride(transposed.sizes(), transposed.strides(), transposed_shape)) {
+    return transposed.view(transposed_shape).transpose(1, 2);
+  }
+  return permuted.reshape(shape);
+}
+
 // sumproduct_pair computes `(left*right).sum(sumdims)` by means of permutation and
 // batch matrix multiplication
 // its main purpose is to provide a pairwise reduction for einsum
@@ -81,8 +110,8 @@ static Tensor sumproduct_pair(const Tensor& left_, const Tensor& right_, IntArra
   // we now work with the following permutations / shapes.
   // the pipeline is permute inputs -> reshape inputs -> batch matrix mul -> reshape(view) output -> permute output
   // output: "lro, lo, 1-for-summed-dims, ro" with orgiginal shape dimensions
-  // left:   "lro, lo, summed" permuted with lpermutation and the three flattened
-  // right:  "lro, summed, ro" permuted with rpermutation and the three flattened
+  // left:   "lro, lo, summed" permuted and the three flattened (see flatten_for_bmm)
+  // right:  "lro, summed, ro" permuted and the three flattened
   // then the permuted output is a view of bmm(left, right)
   // finally, opermutation reverts the permutation to the original order of dimensions
   std::vector<int64_t> out_size;
@@ -91,16 +120,6 @@ static Tensor sumproduct_pair(const Tensor& left_, const Tensor& right_, IntArra
   for (auto& d : sum_dims_) { out_size.push_back(1); (void)(d); }; // avoid warining about not using d
   for (auto& d : ro) out_size.push_back(right.size(d));
 
-  std::vector<int64_t> lpermutation(lro);
-  lpermutation.insert(lpermutation.end(), lo.begin(), lo.end());
-  lpermutation.insert(lpermutation.end(), sum_dims_.begin(), sum_dims_.end());
-  lpermutation.insert(lpermutation.end(), ro.begin(), ro.end());
-
-  std::vector<int64_t> rpermutation(lro);
-  rpermutation.insert(rpermutation.end(), sum_dims_.begin(), sum_dims_.end());
-  rpermutation.insert(rpermutation.end(), ro.begin(), ro.end());
-  rpermutation.insert(rpermutation.end(), lo.begin(), lo.end());
-
   std::vector<int64_t> opermutation(lro.size()+lo.size()+sum_dims_.size()+ro.size(), -1);
   {
   int64_t i = 0;
@@ -120,8 +139,13 @@ static Tensor sumproduct_pair(const Tensor& left_, const Tensor& right_, IntArra
   }
 
   // now we can execute the operations above
-  left = left.permute(lpermutation).reshape({lro_size, lo_size, sum_size});
-  right = right.permute(rpermutation).reshape({lro_size, sum_size, ro_size});
+  // the trailing dimensions of lpermutation and rpermutation are broadcast (size 1) ones
+  std::vector<int64_t> lcols(sum_dims_.begin(), sum_dims_.end());
+  lcols.insert(lcols.end(), ro.begin(), ro.end());
+  std::vector<int64_t> rcols(ro);
+  rcols.insert(rcols.end(), lo.begin(), lo.end());
+  left = flatten_for_bmm(left, lro, lo, lcols, {lro_size, lo_size, sum_size});
+  right = flatten_for_bmm(right, lro, sum_dims_, rcols, {lro_size, sum_size, ro_size});
   Tensor result = at::bmm(left, right);
   result = result.view(out_size).permute(opermutation);
 
@@ -138,6 +162,95 @@ static Tensor sumproduct_pair(const Tensor& left_, const Tensor& right_, IntArra
   return result;
 }
 
+namespace {
+
+// einsum contraction paths are cached by equation and operand shapes, so that repeated calls
+// e.g. in a training loop do not search again. The cache is cleared when it is full.
+constexpr size_t kMaxCachedEinsumPaths = 1024;
+std::mutex einsum_path_cache_mutex;
+std::unordered_map<std::string, std::vector<std::pair<int64_t, int64_t>>> einsum_path_cache;
+
+double einsum_dims_numel(const std::bitset<dim_bitset_size>& dims, const std::vector<int64_t>& dim_sizes) {
+  double numel = 1;
+  for (size_t dim = 0; dim < dim_sizes.size(); dim++) {
+    if (dims[dim]) {
+      numel *= dim_sizes[dim];
+    }
+  }
+  return numel;
+}
+
+// einsum_contraction_path greedily picks the order in which einsum contracts its operands
+// (in the spirit of numpy's and opt_einsum's "greedy" strategy). Each step contracts the pair
+// whose result is smallest compared to the two operands, breaking ties by the size of the
+// bmm that computes it. The pairs (i, j), i < j, index into the list of remaining operands,
+// where each contraction removes i and j and appends its result.
+std::vector<std::pair<int64_t, int64_t>> einsum_contraction_path(
+    const std::string& eqn,
+    TensorList tensors,
+    std::vector<std::bitset<dim_bitset_size>> op_dims,
+    const std::vector<int64_t>& dim_sizes,
+    const std::bitset<dim_bitset_size>& output_dims) {
+  if (op_dims.size() == 2) {
+    return {{0, 1}};
+  }
+  std::ostringstream key_stream;
+  key_stream << eqn;
+  for (auto& tensor : tensors) {
+    key_stream << ';' << tensor.sizes();
+  }
+  auto key = key_stream.str();
+  {
+    std::lock_guard<std::mutex> guard(einsum_path_cache_mutex);
+    auto it = einsum_path_cache.find(key);
+    if (it != einsum_path_cache.end()) {
+      return it->second;
+    }
+  }
+
+  std::vector<std::pair<int64_t, int64_t>> path;
+  while (op_dims.size() > 1) {
+    int64_t num_ops = op_dims.size();
+    std::pair<int64_t, int64_t> best(0, 1);
+    std::bitset<dim_bitset_size> best_result_dims;
+    double best_removed = std::numeric_limits<double>::infinity();
+    double best_flops = std::numeric_limits<double>::infinity();
+    for (int64_t i = 0; i < num_ops; i++) {
+      for (int64_t j = i + 1; j < num_ops; j++) {
+        auto kept_dims = output_dims;
+        for (int64_t op = 0; op < num_ops; op++) {
+          if (op != i && op != j) {
+            kept_dims |= op_dims[op];
+          }
+        }
+        auto result_dims = (op_dims[i] | op_dims[j]) & kept_dims;
+        double removed = einsum_dims_numel(result_dims, dim_sizes) -
+            einsum_dims_numel(op_dims[i], dim_sizes) - einsum_dims_numel(op_dims[j], dim_sizes);
+        double flops = einsum_dims_numel(op_dims[i] | op_dims[j], dim_sizes);
+        if (removed < best_removed || (removed == best_removed && flops < best_flops)) {
+          best = {i, j};
+          best_result_dims = result_dims;
+          best_removed = removed;
+          best_flops = flops;
+        }
+      }
+    }
+    path.push_back(best);
+    op_dims.erase(op_dims.begin() + best.second);
+    op_dims.erase(op_dims.begin() + best.first);
+    op_dims.push_back(best_result_dims);
+  }
+
+  std::lock_guard<std::mutex> guard(einsum_path_cache_mutex);
+  if (einsum_path_cache.size() >= kMaxCachedEinsumPaths) {
+    einsum_path_cache.clear();
+  }
+  einsum_path_cache.emplace(std::move(key), path);
+  return path;
+}
+
+} // namespace
+
 Tensor einsum(std::string eqn, TensorList tensors) {
   constexpr size_t number_of_letters = 26;
   std::string in_eqn;
@@ -158,12 +271,10 @@ Tensor einsum(std::string eqn, TensorList tensors) {
 
   // The internal representation of the left hand side fo the equation (with ellipsis expanded) is stored in input_op_idxes.
   // For each operand, we have a vector mapping each dimension to an internal index.
-  // We also keep track of the number of occurrences for each letter (to infer a right hand side if not given) and
-  // of the last occurrence of each index.
+  // We also keep track of the number of occurrences for each letter (to infer a right hand side if not given).
   std::vector<std::vector<int64_t>> input_op_idxes;                   // the parsed operand indices
   std::array<std::int64_t, number_of_letters> num_letter_occurrences; // number of occurrence in the equation of this letter
   num_letter_occurrences.fill(0);
-  std::vector<std::int64_t> last_idx_occurrence;                      // the last operator (left to right) using this index
 
   if ((pos = eqn.find("->")) != std::string::npos) { // check whether we have a right hand side. in_eq is the left hand side
     in_eqn = eqn.substr(0, pos);
@@ -203,7 +314,6 @@ Tensor einsum(std::string eqn, TensorList tensors) {
           }
           for (int64_t i = 0; i < num_ell_idxes; ++i) { // map ellipsis dimensions in operand to indices
             current_op_idxes.push_back(first_ell_idx + i);
-            last_idx_occurrence.push_back(operand);
           }
           dims_in_term += num_ell_idxes;                // keep track of dimensions
         }
@@ -214,9 +324,6 @@ Tensor einsum(std::string eqn, TensorList tensors) {
         if (letter_mapping[letter_num] == -1) {         // new letter, add internal index and mapping
           letter_mapping[letter_num] = num_total_idxes;
           num_total_idxes++;
-          last_idx_occurrence.push_back(operand);
-        } else {                                        // letter we have already seen
-          last_idx_occurrence[letter_mapping[letter_num]] = operand;
         }
         num_letter_occurrences[letter_num]++;
         current_op_idxes.push_back(letter_mapping[letter_num]);
@@ -342,30 +449,72 @@ Tensor einsum(std::string eqn, TensorList tensors) {
     preprocessed_operands.push_back(std::move(preprocessed_op));
   }
 
-  // now we reduce the indices from left to right
-  // numpy allows to optimize the path using various
-  // algorithms (see eigen_path in numpy docs)
-  // we start with the leftmost operator and reduce indices that
-  // appear only there
-  Tensor result = std::move(preprocessed_operands[0]);
-  for (int64_t idx = 0; idx < num_total_idxes; idx++) {
-    if ((last_idx_occurrence[idx] == 0)
-        && (idxes_to_preprocessed_dims[idx]>=num_output_dims)) {
-      result = result.sum(idxes_to_preprocessed_dims[idx], true);
+  // we record which (preprocessed) dimensions each operand actually has
+  // and sum out right away those that are in neither the output nor any other operand
+  TORCH_CHECK(num_total_idxes <= (int64_t) dim_bitset_size,
+              "einsum supports at most ", dim_bitset_size, " distinct indices");
+  int64_t num_ops = preprocessed_operands.size();
+  std::vector<std::int64_t> size_of_preprocessed_dims(num_total_idxes, 1);
+  std::vector<std::bitset<dim_bitset_size>> op_dims(num_ops);
+  for (int64_t op = 0; op < num_ops; op++) {
+    for (auto idx : input_op_idxes[op]) {
+      op_dims[op].set(idxes_to_preprocessed_dims[idx]);
+      size_of_preprocessed_dims[idxes_to_preprocessed_dims[idx]] = size_of_dims[idx];
+    }
+  }
+  for (int64_t op = 0; op < num_ops; op++) {
+    for (int64_t dim = num_output_dims; dim < num_total_idxes; dim++) {
+      if (!op_dims[op][dim]) {
+        continue;
+      }
+      bool in_other_op = false;
+      for (int64_t other = 0; other < num_ops; other++) {
+        in_other_op |= (other != op) && op_dims[other][dim];
+      }
+      if (!in_other_op) {
+        preprocessed_operands[op] = preprocessed_operands[op].sum(dim, true);
+        op_dims[op].reset(dim);
+      }
     }
   }
 
-  // now we process each tensor using sumproduct_pair
-  for (int64_t i = 1; i < (int64_t) preprocessed_operands.size(); i++) {
+  // now we contract the operands pairwise with sumproduct_pair, in the order given by
+  // einsum_contraction_path. each contracted pair is replaced by its result at the end
+  // of the list, and a non-output dimension is summed over when no remaining operand has it.
+  std::bitset<dim_bitset_size> output_dims;
+  for (int64_t dim = 0; dim < num_output_dims; dim++) {
+    output_dims.set(dim);
+  }
+  std::vector<std::pair<int64_t, int64_t>> path;
+  if (num_ops > 1) {
+    path = einsum_contraction_path(eqn, tensors, op_dims, size_of_preprocessed_dims, output_dims);
+  }
+  for (auto& contraction : path) {
+    auto i = contraction.first, j = contraction.second;
+    auto kept_dims = output_dims;
+    for (int64_t op = 0; op < (int64_t) op_dims.size(); op++) {
+      if (op != i && op != j) {
+        kept_dims |= op_dims[op];
+      }
+    }
+    auto contracted_dims = (op_dims[i] | op_dims[j]) & ~kept_dims;
     std::vector<int64_t> sum_dims;
-    for (int64_t idx = 0; idx < num_total_idxes; idx++) {
-      if ((last_idx_occurrence[idx] == i)
-          && (idxes_to_preprocessed_dims[idx]>=num_output_dims)) {
-        sum_dims.push_back(idxes_to_preprocessed_dims[idx]);
+    for (int64_t dim = num_output_dims; dim < num_total_idxes; dim++) {
+      if (contracted_dims[dim]) {
+        sum_dims.push_back(dim);
       }
     }
-    result = at::native::sumproduct_pair(result, std::move(preprocessed_operands[i]), sum_dims, true);
+    auto result = at::native::sumproduct_pair(preprocessed_operands[i], preprocessed_operands[j], sum_dims, true);
+    auto result_dims = (op_dims[i] | op_dims[j]) & kept_dims;
+    preprocessed_operands.erase(preprocessed_operands.begin() + j);
+    preprocessed_operands.erase(preprocessed_operands.begin() + i);
+    op_dims.erase(op_dims.begin() + j);
+    op_dims.erase(op_dims.begin() + i);
+    preprocessed_operands.push_back(std::move(result));
+    op_dims.push_back(result_dims);
   }
+  Tensor result = std::move(preprocessed_operands[0]);
+
   // finally, we squeeze out all non-result dimensions
   auto sizes = result.sizes().vec();
   for (int64_t dim = num_total_idxes-1; dim >= num_output_dims; dim--) {
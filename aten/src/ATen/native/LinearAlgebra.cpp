@@ -195,6 +195,16 @@ Tensor& addmm_cpu_out(Tensor &result, const Tensor& self, const Tensor& mat1, co
   return legacy::cpu::_th_addmm_out(result, b_self, mat1, mat2, beta, alpha);
 }
 
+std::vector<Tensor> _grouped_mm_cpu(TensorList self, TensorList mat2) {
+  groupedMMCheckInputs(self, mat2);
+  std::vector<Tensor> result;
+  result.reserve(self.size());
+  for (size_t i = 0; i < self.size(); ++i) {
+    result.push_back(at::mm(self[i], mat2[i]));
+  }
+  return result;
+}
+
 template <typename scalar_t, bool is_bmm>
 inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const Tensor& mat2, Scalar beta_, Scalar alpha_) {
   int64_t bs = result.size(0);
@@ -74,6 +74,30 @@ static inline void linearSolveCheckInputs(const Tensor& self, const Tensor& A, c
               " but each b matrix is ", self.size(-2), " by ", self.size(-1));
 }
 
+// Validates the inputs of _grouped_mm: pairs of 2-d matrices with matching
+// inner dimensions, all on the same device and of the same dtype
+static inline void groupedMMCheckInputs(TensorList self, TensorList mat2) {
+  TORCH_CHECK(self.size() == mat2.size(),
+              "_grouped_mm: expected as many matrices in self as in mat2, got ",
+              self.size(), " and ", mat2.size());
+  for (size_t i = 0; i < self.size(); ++i) {
+    TORCH_CHECK(self[i].dim() == 2 && mat2[i].dim() == 2,
+                "_grouped_mm: expected 2-d matrices, got ", self[i].dim(),
+                "-d and ", mat2[i].dim(), "-d tensors for pair ", i);
+    TORCH_CHECK(self[i].size(1) == mat2[i].size(0),
+                "_grouped_mm: size mismatch for pair ", i, ", got ",
+                self[i].sizes(), " and ", mat2[i].sizes());
+    TORCH_CHECK(self[i].device() == self[0].device() && mat2[i].device() == self[0].device(),
+                "_grouped_mm: expected all matrices on ", self[0].device(),
+                " but pair ", i, " is on ", self[i].device(), " and ", mat2[i].device());
+    TORCH_CHECK(self[i].scalar_type() == self[0].scalar_type() &&
+                mat2[i].scalar_type() == self[0].scalar_type(),
+                "_grouped_mm: expected all matrices of type ", self[0].scalar_type(),
+                " but pair ", i, " has types ", self[i].scalar_type(), " and ",
+                mat2[i].scalar_type());
+  }
+}
+
 // Validates input shapes for operations on batches of square matrices (inverse, cholesky, symeig)
 static inline void squareCheckInputs(const Tensor& self) {
   TORCH_CHECK(self.size(-1) == self.size(-2),
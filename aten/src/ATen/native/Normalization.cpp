@@ -17,6 +17,10 @@ static const int MIOPEN_DIM_MAX = 5;
 namespace at { namespace native {
 
 DEFINE_DISPATCH(batch_norm_cpu_inference_contiguous_stub);
+DEFINE_DISPATCH(batch_norm_cpu_collect_stats_channels_last_stub);
+DEFINE_DISPATCH(batch_norm_cpu_transform_channels_last_stub);
+DEFINE_DISPATCH(batch_norm_cpu_backward_reduce_channels_last_stub);
+DEFINE_DISPATCH(batch_norm_cpu_backward_elemt_channels_last_stub);
 
 namespace {
   void check_dims_match_num_input_features(const char* arg_name, int64_t expected, int64_t actual){
@@ -32,6 +36,15 @@ namespace {
   }
 }
 
+// True if input is a [M, C] matrix with contiguous rows, which the channels
+// last kernels of batch_norm.h take: a 2-D contiguous input, or a 4-D channels
+// last one.
+static bool batch_norm_use_channels_last_kernels(const Tensor& input) {
+  return input.numel() > 0 &&
+      ((input.dim() == 2 && input.is_contiguous()) ||
+       (input.dim() == 4 && input.is_contiguous(at::MemoryFormat::ChannelsLast)));
+}
+
 // TensorAccessor when it is defined to work around undefined...
 template <typename scalar_t>
 static TensorAccessor<scalar_t, 1> conditional_accessor_1d(const Tensor& t) {
@@ -175,10 +188,31 @@ std::tuple<Tensor,Tensor,Tensor> batch_norm_cpu_transform_input_template(
     return std::make_tuple(output, save_mean, save_invstd);
   }
 
-  Tensor output = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-
   int64_t n_input = input.size(1);
 
+  if (batch_norm_use_channels_last_kernels(input)) {
+    Tensor output = at::empty_like(input, input.suggest_memory_format());
+    Tensor alpha = at::empty({n_input}, input.options());
+    Tensor beta = at::empty({n_input}, input.options());
+    auto alpha_a = alpha.accessor<scalar_t, 1>();
+    auto beta_a = beta.accessor<scalar_t, 1>();
+    auto weight_a = conditional_accessor_1d<scalar_t>(weight);
+    auto bias_a = conditional_accessor_1d<scalar_t>(bias);
+    auto mean_a = conditional_accessor_1d<scalar_t>(train ? save_mean : running_mean);
+    auto var_a = conditional_accessor_1d<scalar_t>(train ? save_invstd : running_var);
+    for (int64_t f = 0; f < n_input; ++f) {
+      scalar_t invstd = train ? var_a[f] : 1 / std::sqrt(var_a[f] + eps);
+      scalar_t w = weight.defined() ? weight_a[f] : 1;
+      scalar_t b = bias.defined() ? bias_a[f] : 0;
+      alpha_a[f] = invstd * w;
+      beta_a[f] = b - mean_a[f] * invstd * w;
+    }
+    batch_norm_cpu_transform_channels_last_stub(kCPU, output, input, alpha, beta);
+    return std::make_tuple(output, save_mean, save_invstd);
+  }
+
+  Tensor output = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+
   auto save_mean_a = conditional_accessor_1d<scalar_t>(save_mean);
   auto save_invstd_a = conditional_accessor_1d<scalar_t>(save_invstd);
 
@@ -230,6 +264,25 @@ std::tuple<Tensor,Tensor> batch_norm_cpu_update_stats_template(
   auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
   auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
 
+  if (batch_norm_use_channels_last_kernels(input)) {
+    Tensor var_sum = at::empty({n_input}, input.options());
+    batch_norm_cpu_collect_stats_channels_last_stub(kCPU, save_mean, var_sum, input);
+    auto var_sum_a = var_sum.accessor<scalar_t, 1>();
+    for (int64_t f = 0; f < n_input; ++f) {
+      accscalar_t mean = save_mean_a[f];
+      accscalar_t var_sum_f = var_sum_a[f];
+      save_var_transform_a[f] = VarTransform<accscalar_t>{}(var_sum_f / n, eps);
+      if (running_mean.defined()) {
+        running_mean_a[f] = momentum * mean + (1 - momentum) * running_mean_a[f];
+      }
+      if (running_var.defined()) {
+        accscalar_t unbiased_var = var_sum_f / (n - 1);
+        running_var_a[f] = momentum * unbiased_var + (1 - momentum) * running_var_a[f];
+      }
+    }
+    return std::make_tuple(save_mean, save_var_transform);
+  }
+
   parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
     for (int64_t f = b_begin; f < b_end; ++f) {
       Tensor in = input.select(1, f);
@@ -280,7 +333,9 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor
   Tensor grad_weight;
   Tensor grad_bias;
   if (grad_input_mask[0]) {
-    grad_input = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    grad_input = batch_norm_use_channels_last_kernels(input)
+        ? at::empty_like(input, input.suggest_memory_format())
+        : at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   }
   if (grad_input_mask[1]) {
     grad_weight = at::empty_like(weight, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
@@ -302,6 +357,53 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor
   auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
   auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
 
+  if (batch_norm_use_channels_last_kernels(input)) {
+    const Tensor grad_out = grad_out_.contiguous(input.suggest_memory_format());
+    Tensor mean = at::empty({n_input}, input.options());
+    Tensor invstd = at::empty({n_input}, input.options());
+    auto mean_a = mean.accessor<scalar_t, 1>();
+    auto invstd_a = invstd.accessor<scalar_t, 1>();
+    for (int64_t f = 0; f < n_input; ++f) {
+      mean_a[f] = train ? save_mean_a[f] : running_mean_a[f];
+      invstd_a[f] = train ? save_invstd_a[f] : 1 / std::sqrt(running_var_a[f] + eps);
+    }
+    Tensor sum_dy = at::empty({n_input}, input.options());
+    Tensor dot_p = at::empty({n_input}, input.options());
+    batch_norm_cpu_backward_reduce_channels_last_stub(kCPU, sum_dy, dot_p, grad_out, input, mean);
+    auto sum_dy_a = sum_dy.accessor<scalar_t, 1>();
+    auto dot_p_a = dot_p.accessor<scalar_t, 1>();
+
+    if (grad_input_mask[0]) {
+      // grad_input = grad_out * a + input * b + c, with the terms of the loops
+      // above collected per channel
+      Tensor a = at::empty({n_input}, input.options());
+      Tensor b = at::zeros({n_input}, input.options());
+      Tensor c = at::zeros({n_input}, input.options());
+      auto a_a = a.accessor<scalar_t, 1>();
+      auto b_a = b.accessor<scalar_t, 1>();
+      auto c_a = c.accessor<scalar_t, 1>();
+      for (int64_t f = 0; f < n_input; ++f) {
+        scalar_t w = weight.defined() ? weight_a[f] : 1;
+        a_a[f] = invstd_a[f] * w;
+        if (train) {
+          scalar_t k = dot_p_a[f] * invstd_a[f] * invstd_a[f] / n;
+          scalar_t grad_mean = sum_dy_a[f] / n;
+          b_a[f] = -k * invstd_a[f] * w;
+          c_a[f] = (mean_a[f] * k - grad_mean) * invstd_a[f] * w;
+        }
+      }
+      batch_norm_cpu_backward_elemt_channels_last_stub(kCPU, grad_input, grad_out, input, a, b, c);
+    }
+    for (int64_t f = 0; f < n_input; ++f) {
+      if (grad_input_mask[1]) {
+        grad_weight_a[f] = dot_p_a[f] * invstd_a[f];
+      }
+      if (grad_input_mask[2]) {
+        grad_bias_a[f] = sum_dy_a[f];
+      }
+    }
+    return std::make_tuple(grad_input, grad_weight, grad_bias);
+  }
 
   parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
       for (int64_t f = b_begin; f < b_end; ++f) {
@@ -529,52 +631,6 @@ Tensor instance_norm(
   return out.view(input.sizes());
 }
 
-Tensor group_norm(const Tensor& input, int64_t num_groups,
-    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
-    double eps, bool cudnn_enabled) {
-
-    auto input_shape = input.sizes();
-    int64_t b = input.size(0);
-    int64_t c = input.size(1);
-
-    TORCH_CHECK(c % num_groups == 0,
-             "Expected number of channels in input to be divisible by ",
-             "num_groups, but got input of shape ", input.sizes(), " and "
-             "num_groups=", num_groups);
-
-    TORCH_CHECK(!weight.defined() || (weight.dim() == 1 && weight.numel() == c),
-             "Expected weight to be a vector of size equal to the number of ",
-             "channels in input, but got weight of shape ", weight.sizes(),
-             " and input of shape ", input.sizes());
-    TORCH_CHECK(!bias.defined() || (bias.dim() == 1 && bias.numel() == c),
-             "Expected bias to be a vector of size equal to the number of ",
-             "channels in input, but got bias of shape ", weight.sizes(),
-             " and input of shape ", input.sizes());
-
-    // Apply group norm
-    // view(..., -1) does not work for empty tensor
-    auto input_reshaped = input.contiguous().view({1, b * num_groups, b ? -1 : 1});
-
-    auto out = at::batch_norm(input_reshaped, {}, {}, {}, {}, true, 0, eps,
-                              cudnn_enabled);
-    out = out.view(input_shape);
-
-    if (!weight.defined() && !bias.defined()) {
-      return out;
-    }
-
-    std::vector<int64_t> affine_param_shape(input.dim(), 1);
-    affine_param_shape[1] = c;
-
-    if (weight.defined() && bias.defined()) {
-      return bias.view(affine_param_shape).addcmul(out, weight.view(affine_param_shape), 1);
-    } else if (weight.defined()) {
-      return out.mul(weight.view(affine_param_shape));
-    } else {
-      return out.add(bias.view(affine_param_shape));
-    }
-}
-
 std::tuple<Tensor, Tensor> batch_norm_update_stats_cpu(
         const Tensor& self, const Tensor& running_mean, const Tensor& running_var, double momentum) {
   return AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "batch_norm_update_stats_cpu", [&] {
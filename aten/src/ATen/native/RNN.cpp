@@ -1,7 +1,9 @@
 #include <ATen/native/RNN.h>
 
 #include <ATen/ATen.h>
+#include <ATen/Config.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/core/grad_mode.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/c10_utils.h>
@@ -10,6 +12,10 @@
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
 #include <torch/custom_class.h>
 
+#if AT_MKL_ENABLED()
+#include <mkl.h>
+#endif
+
 torch::jit::class_<LinearPackedParamsBase> register_linear_params();
 
 namespace at { namespace native {
@@ -770,6 +776,200 @@ struct Layer {
       const param_type& params) const = 0;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// FUSED CPU LAYERS
+//
+// Full LSTM and GRU layers on CPU that don't need autograd run without the
+// per-step allocations of the cells above: the input projection of all time
+// steps is one GEMM, the recurrent GEMM of every step writes into a buffer of
+// the layer (with w_hh packed once per layer when MKL is available), and a
+// vectorized kernel applies all gate nonlinearities in one pass, writing the
+// new hidden state straight into the output of the layer.
+
+// Computes h @ w_hh^T for the steps of one layer.
+class RecurrentGemm {
+ public:
+  RecurrentGemm(const Tensor& w_hh, int64_t batch_size, int64_t seq_len)
+      : w_hh_(w_hh.contiguous()) {
+#if AT_MKL_ENABLED()
+    // Packing only pays off if the weight is used for more than one step.
+    if (w_hh_.scalar_type() == kFloat && batch_size > 0 && seq_len > 1) {
+      const auto m = static_cast<MKL_INT>(batch_size);
+      const auto n = static_cast<MKL_INT>(w_hh_.size(0));
+      const auto k = static_cast<MKL_INT>(w_hh_.size(1));
+      const auto packed_size = cblas_sgemm_pack_get_size(CblasBMatrix, m, n, k);
+      packed_ = at::empty(
+          {static_cast<int64_t>(packed_size)}, w_hh_.options().dtype(kByte));
+      cblas_sgemm_pack(
+          CblasRowMajor, CblasBMatrix, CblasTrans, m, n, k, 1.0f,
+          w_hh_.data_ptr<float>(), k, reinterpret_cast<float*>(packed_.data_ptr()));
+    }
+#endif
+  }
+
+  // Writes h @ w_hh^T into `gates`, or adds it to `gates` if `accumulate` is
+  // true. `h` and `gates` must have contiguous rows.
+  void run(Tensor& gates, const Tensor& h, bool accumulate) const {
+#if AT_MKL_ENABLED()
+    if (packed_.defined()) {
+      cblas_sgemm_compute(
+          CblasRowMajor, CblasNoTrans, CblasPacked,
+          static_cast<MKL_INT>(h.size(0)),
+          static_cast<MKL_INT>(w_hh_.size(0)),
+          static_cast<MKL_INT>(w_hh_.size(1)),
+          h.data_ptr<float>(), static_cast<MKL_INT>(h.stride(0)),
+          reinterpret_cast<const float*>(packed_.data_ptr()),
+          static_cast<MKL_INT>(w_hh_.size(0)),
+          accumulate ? 1.0f : 0.0f,
+          gates.data_ptr<float>(), static_cast<MKL_INT>(gates.stride(0)));
+      return;
+    }
+#endif
+    if (accumulate) {
+      gates.addmm_(h, w_hh_.t());
+    } else {
+      at::mm_out(gates, h, w_hh_.t());
+    }
+  }
+
+ private:
+  Tensor w_hh_;
+  Tensor packed_;
+};
+
+// Whether the fused layer can run `input` through a layer of cells with
+// `gate_count` gates. Anything else takes the generic path, which also
+// reports invalid arguments.
+bool use_fused_cpu_layer(
+    const Tensor& input,
+    ArrayRef<Tensor> hiddens,
+    const CellParams& params,
+    int64_t gate_count) {
+  if (!input.device().is_cpu() || input.dim() != 3 ||
+      (input.scalar_type() != kFloat && input.scalar_type() != kDouble)) {
+    return false;
+  }
+  const int64_t batch_size = input.size(1);
+  const int64_t hidden_size = hiddens[0].dim() == 2 ? hiddens[0].size(1) : -1;
+  const int64_t gates_size = gate_count * hidden_size;
+  const bool needs_grad = at::GradMode::is_enabled();
+  auto usable = [&](const Tensor& t) {
+    return t.device().is_cpu() && t.layout() == kStrided &&
+        t.scalar_type() == input.scalar_type() &&
+        !(needs_grad && t.requires_grad());
+  };
+  if (!usable(input)) {
+    return false;
+  }
+  for (const auto& hidden : hiddens) {
+    if (!usable(hidden) || hidden.dim() != 2 ||
+        hidden.size(0) != batch_size || hidden.size(1) != hidden_size) {
+      return false;
+    }
+  }
+  if (!usable(params.w_ih) || params.w_ih.dim() != 2 ||
+      params.w_ih.size(0) != gates_size ||
+      params.w_ih.size(1) != input.size(2) ||
+      !usable(params.w_hh) || params.w_hh.dim() != 2 ||
+      params.w_hh.size(0) != gates_size ||
+      params.w_hh.size(1) != hidden_size) {
+    return false;
+  }
+  for (const Tensor* bias : {&params.b_ih(), &params.b_hh()}) {
+    if (bias->defined() &&
+        (!usable(*bias) || bias->dim() != 1 || bias->size(0) != gates_size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename hidden_type, typename cell_params>
+c10::optional<LayerOutput<Tensor, hidden_type>> fused_cpu_layer(
+    const Cell<hidden_type, cell_params>& cell,
+    const Tensor& input,
+    const hidden_type& input_hidden,
+    const cell_params& params,
+    bool reverse) {
+  return c10::nullopt;
+}
+
+// Runs `input` through a layer of LSTM cells, from the last step to the
+// first if `reverse` is true.
+c10::optional<LayerOutput<Tensor, tpair_of<Tensor>>> fused_cpu_layer(
+    const Cell<tpair_of<Tensor>, CellParams>& cell,
+    const Tensor& input,
+    const tpair_of<Tensor>& input_hidden,
+    const CellParams& params,
+    bool reverse) {
+  if (!dynamic_cast<const LSTMCell<CellParams>*>(&cell) ||
+      !use_fused_cpu_layer(
+          input, {std::get<0>(input_hidden), std::get<1>(input_hidden)},
+          params, 4)) {
+    return c10::nullopt;
+  }
+  const int64_t seq_len = input.size(0);
+  auto gates = params.linear_ih(input).contiguous();
+  if (params.b_hh().defined()) {
+    gates.add_(params.b_hh());
+  }
+  auto hx = std::get<0>(input_hidden).contiguous();
+  auto cx = std::get<1>(input_hidden).contiguous();
+  auto output = at::empty({seq_len, hx.size(0), hx.size(1)}, hx.options());
+  // The cell state alternates between two buffers.
+  Tensor cy[2];
+  if (seq_len > 0) {
+    cy[0] = at::empty_like(cx);
+    cy[1] = at::empty_like(cx);
+  }
+  RecurrentGemm recurrent(params.w_hh, hx.size(0), seq_len);
+  for (int64_t step = 0; step < seq_len; ++step) {
+    const int64_t t = reverse ? seq_len - 1 - step : step;
+    auto step_gates = gates[t];
+    recurrent.run(step_gates, hx, /*accumulate=*/true);
+    auto hy = output[t];
+    fused_lstm_cell_cpu_stub(kCPU, hy, cy[step % 2], step_gates, cx);
+    hx = hy;
+    cx = cy[step % 2];
+  }
+  return LayerOutput<Tensor, tpair_of<Tensor>>{
+      std::move(output), std::make_tuple(std::move(hx), std::move(cx))};
+}
+
+// Runs `input` through a layer of GRU cells, from the last step to the
+// first if `reverse` is true.
+c10::optional<LayerOutput<Tensor, Tensor>> fused_cpu_layer(
+    const Cell<Tensor, CellParams>& cell,
+    const Tensor& input,
+    const Tensor& input_hidden,
+    const CellParams& params,
+    bool reverse) {
+  if (!dynamic_cast<const GRUCell<CellParams>*>(&cell) ||
+      !use_fused_cpu_layer(input, {input_hidden}, params, 3)) {
+    return c10::nullopt;
+  }
+  const int64_t seq_len = input.size(0);
+  const auto igates = params.linear_ih(input).contiguous();
+  auto hx = input_hidden.contiguous();
+  auto output = at::empty({seq_len, hx.size(0), hx.size(1)}, hx.options());
+  // The hidden gates are kept apart, since the reset gate only scales the
+  // hidden part of the new gate.
+  auto hgates = at::empty({hx.size(0), igates.size(2)}, hx.options());
+  const auto& b_hh = params.b_hh();
+  RecurrentGemm recurrent(params.w_hh, hx.size(0), seq_len);
+  for (int64_t step = 0; step < seq_len; ++step) {
+    const int64_t t = reverse ? seq_len - 1 - step : step;
+    if (b_hh.defined()) {
+      hgates.copy_(b_hh.expand_as(hgates));
+    }
+    recurrent.run(hgates, hx, /*accumulate=*/b_hh.defined());
+    auto hy = output[t];
+    fused_gru_cell_cpu_stub(kCPU, hy, igates[t], hgates, hx);
+    hx = hy;
+  }
+  return LayerOutput<Tensor, Tensor>{std::move(output), std::move(hx)};
+}
+
 template<typename hidden_type, typename cell_params>
 struct FullLayer : Layer<Tensor, hidden_type, cell_params> {
   using output_type =
@@ -798,6 +998,10 @@ struct FullLayer : Layer<Tensor, hidden_type, cell_params> {
       const hidden_type& input_hidden,
       const cell_params& params) const override {
     if (inputs.device().is_cpu()) {
+      auto fused = fused_cpu_layer(cell_, inputs, input_hidden, params, false);
+      if (fused) {
+        return std::move(*fused);
+      }
       const auto inputs_w = params.linear_ih(inputs);
       auto unstacked_output =
           (*this)(inputs_w.unbind(0), input_hidden, params, true);
@@ -828,6 +1032,18 @@ struct FullBidirectionalLayer
       const param_type& params) const override {
     std::vector<Tensor> step_inputs;
     if (input.device().is_cpu()) {
+      auto fw_fused = fused_cpu_layer(
+          layer_.cell_, input, input_hidden.first, params.first, false);
+      auto rev_fused = fw_fused
+          ? fused_cpu_layer(
+                layer_.cell_, input, input_hidden.second, params.second, true)
+          : c10::nullopt;
+      if (fw_fused && rev_fused) {
+        auto& fw_output = fw_fused->outputs;
+        return {at::cat({fw_output, rev_fused->outputs}, fw_output.dim() - 1),
+                std::make_pair(std::move(fw_fused->final_hidden),
+                               std::move(rev_fused->final_hidden))};
+      }
       auto input_w = params.first.linear_ih(input);
       step_inputs = input_w.unbind(0);
       auto fw_result = layer_(
@@ -1374,6 +1590,8 @@ ONE_HIDDEN_RNN(rnn_tanh, tanf_cell_type)
 using relu_cell_type = SimpleCell<relu_f, CellParams>;
 ONE_HIDDEN_RNN(rnn_relu, relu_cell_type);
 
+DEFINE_DISPATCH(fused_lstm_cell_cpu_stub);
+DEFINE_DISPATCH(fused_gru_cell_cpu_stub);
 DEFINE_DISPATCH(lstm_cudnn_stub);
 DEFINE_DISPATCH(lstm_packed_cudnn_stub);
 DEFINE_DISPATCH(lstm_miopen_stub);
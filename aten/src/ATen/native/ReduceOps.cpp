@@ -8,7 +8,6 @@
 #include <ATen/native/ReduceOpsUtils.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/NamedTensorUtils.h>
-#include <ATen/native/TensorDimApply.h>
 #include <ATen/native/SharedReduceOps.h>
 
 #include <algorithm>
@@ -37,6 +36,9 @@ DEFINE_DISPATCH(argmax_stub);
 DEFINE_DISPATCH(argmin_stub);
 DEFINE_DISPATCH(cumsum_stub);
 DEFINE_DISPATCH(cumprod_stub);
+DEFINE_DISPATCH(logcumsumexp_stub);
+DEFINE_DISPATCH(cummax_stub);
+DEFINE_DISPATCH(cummin_stub);
 
 #define OPTION_TYPE_EQUALITY_CHECK(option, out, self) \
 { \
@@ -260,48 +262,8 @@ Tensor& cumprod_out(Tensor& result, const Tensor& self, int64_t dim, c10::option
   return result;
 }
 
-// Implement std::is_nan<IntegralType> for MSVC.
-namespace {
-#ifdef _MSC_VER
-template<typename T>
-inline typename std::enable_if<std::is_integral<T>::value, bool>::type isnan_(T x) {
-  return false;
-}
-template<typename T>
-inline typename std::enable_if<!std::is_integral<T>::value, bool>::type isnan_(T x) {
-  return std::isnan(x);
-}
-#else
-template<typename T>
-inline bool isnan_(T x) {
-  return std::isnan(x);
-}
-#endif
-}
-
-template<typename T1, typename T2, typename Operation>
-void cummax_cummin_helper(const T1* self_data, T1* values_data, T2* indices_data,
-          int self_dim_size, int self_stride, int values_stride, int indices_stride) {
-      Operation op;
-      T1 out = self_data[0];
-      int idx = 0;
-      for(int i = 0; i < self_dim_size; i++) {
-        T1 curr_elem = self_data[i*self_stride];
-        if(isnan_(curr_elem) || (!isnan_(out) && op(curr_elem, out))) {
-            out = self_data[i*self_stride];
-            idx = i;
-        }
-        values_data[i*values_stride] = out;
-        indices_data[i*indices_stride] = idx;
-      }
-}
-
 void cummax_helper_cpu(const Tensor& self, Tensor& values, Tensor& indices, int64_t dim) {
-  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool,
-    self.scalar_type(), "cummax_cpu",
-    [&] {
-      at::native::tensor_dim_apply3<scalar_t, int64_t>(self, values, indices, dim, cummax_cummin_helper<scalar_t, int64_t, std::greater_equal<scalar_t>>);
-    });
+  cummax_stub(kCPU, values, indices, self, dim);
 }
 
 std::tuple<Tensor&, Tensor&> cummax_out(Tensor& values, Tensor& indices, const Tensor& self, int64_t dim) {
@@ -332,11 +294,7 @@ std::tuple<Tensor, Tensor> cummax(const Tensor& self, int64_t dim) {
 }
 
 void cummin_helper_cpu(const Tensor& self, Tensor& values, Tensor& indices, int64_t dim) {
-  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool,
-    self.scalar_type(), "cummin_cpu",
-    [&] {
-      at::native::tensor_dim_apply3<scalar_t, int64_t>(self, values, indices, dim, cummax_cummin_helper<scalar_t, int64_t, std::less_equal<scalar_t>>);
-    });
+  cummin_stub(kCPU, values, indices, self, dim);
 }
 
 std::tuple<Tensor&, Tensor&> cummin_out(Tensor& values, Tensor& indices, const Tensor& self, int64_t dim) {
@@ -365,6 +323,39 @@ std::tuple<Tensor, Tensor> cummin(const Tensor& self, int64_t dim) {
   at::cummin_out(values, indices, self, dim);
   return std::make_tuple(values, indices);
 }
+Tensor _logcumsumexp_cpu(const Tensor& self, int64_t dim) {
+  Tensor result = at::empty_like(self, MemoryFormat::Contiguous);
+  logcumsumexp_stub(self.device().type(), result, self, dim);
+  return result;
+}
+
+Tensor& _logcumsumexp_out_cpu(Tensor& result, const Tensor& self, int64_t dim) {
+  logcumsumexp_stub(self.device().type(), result, self, dim);
+  return result;
+}
+
+Tensor logcumsumexp(const Tensor& self, int64_t dim) {
+  TORCH_CHECK(
+      at::isFloatingType(self.scalar_type()),
+      "logcumsumexp(): expected a floating point input, but got ", self.scalar_type());
+  auto result = [&]() {
+    NoNamesGuard guard;
+    return at::_logcumsumexp(self, dim);
+  }();
+  namedinference::propagate_names(result, self);
+  return result;
+}
+
+Tensor& logcumsumexp_out(Tensor& result, const Tensor& self, int64_t dim) {
+  check_scalar_type_device_layout_equal(result, self);
+  {
+    NoNamesGuard guard;
+    at::_logcumsumexp_out(result, self, dim);
+  }
+  namedinference::propagate_names(result, self);
+  return result;
+}
+
 // ALL REDUCE #################################################################
 
 static ScalarType get_dtype(Tensor& result, const Tensor& self, optional<ScalarType> dtype,
@@ -1025,6 +1016,12 @@ Tensor cumprod(const Tensor& self, Dimname dim, c10::optional<ScalarType> dtype)
 Tensor& cumprod_out(Tensor& result, const Tensor& self, Dimname dim, c10::optional<ScalarType> dtype) {
   return at::cumprod_out(result, self, dimname_to_position(self, dim), dtype);
 }
+Tensor logcumsumexp(const Tensor& self, Dimname dim) {
+  return at::logcumsumexp(self, dimname_to_position(self, dim));
+}
+Tensor& logcumsumexp_out(Tensor& result, const Tensor& self, Dimname dim) {
+  return at::logcumsumexp_out(result, self, dimname_to_position(self, dim));
+}
 std::tuple<Tensor, Tensor> cummax(const Tensor& self, Dimname dim) {
   return at::cummax(self, dimname_to_position(self, dim));
 }
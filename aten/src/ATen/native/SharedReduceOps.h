@@ -374,6 +374,38 @@ struct ArgMinOps :
   public detail::ArgReductionOps<detail::LessOrNan<scalar_t>> {
 };
 
+// Reduces to the (min, max) pair in a single pass, NaNs propagate to both.
+// res_t is a two-element tuple, one element for each of the two outputs.
+template <typename acc_t, typename res_t>
+struct MinMaxOps {
+  using arg_t = detail::pair<acc_t, acc_t>;
+
+  static C10_DEVICE arg_t reduce(arg_t acc, acc_t data, int64_t /*idx*/) {
+    return combine(acc, arg_t(data, data));
+  }
+
+  static C10_DEVICE arg_t combine(arg_t a, arg_t b) {
+    return arg_t(
+        detail::LessOrNan<acc_t>{}(a.first, b.first) ? a.first : b.first,
+        detail::GreaterOrNan<acc_t>{}(a.second, b.second) ? a.second : b.second);
+  }
+
+  static C10_DEVICE res_t project(arg_t a) {
+    return res_t(a.first, a.second);
+  }
+
+  static C10_DEVICE arg_t translate_idx(arg_t a, int64_t /*base_idx*/) {
+    return a;
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  static C10_DEVICE arg_t warp_shfl_down(arg_t arg, int offset) {
+    return arg_t(WARP_SHFL_DOWN(arg.first, offset),
+                 WARP_SHFL_DOWN(arg.second, offset));
+  }
+#endif
+};
+
 }} // namespace at::native
 
 #undef MAX
@@ -5,8 +5,14 @@
 
 namespace at { namespace native {
 
+// sorts `values` along `dim` in place and writes the permutation to `indices`
+using sort_fn = void(*)(Tensor& values, Tensor& indices, int64_t dim, bool descending);
 using topk_fn = void(*)(Tensor&, Tensor&, const Tensor&, int64_t, int64_t, bool, bool);
+// `values` and `indices` have size 1 in `dim`; k counts from 1
+using kthvalue_fn = void(*)(Tensor& values, Tensor& indices, const Tensor& self, int64_t k, int64_t dim);
 
+DECLARE_DISPATCH(sort_fn, sort_stub);
 DECLARE_DISPATCH(topk_fn, topk_stub);
+DECLARE_DISPATCH(kthvalue_fn, kthvalue_stub);
 
 }} // at::native
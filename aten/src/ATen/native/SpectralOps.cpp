@@ -148,6 +148,22 @@ void _cufft_clear_plan_cache(int64_t device_index) {
   detail::getCUDAHooks().cuFFTClearPlanCache(device_index);
 }
 
+std::tuple<int64_t, int64_t, int64_t> _cufft_get_plan_cache_stats(int64_t device_index) {
+  return detail::getCUDAHooks().cuFFTGetPlanCacheStats(device_index);
+}
+
+void _cufft_reset_plan_cache_stats(int64_t device_index) {
+  detail::getCUDAHooks().cuFFTResetPlanCacheStats(device_index);
+}
+
+bool _cufft_get_plan_cache_batched_plans(int64_t device_index) {
+  return detail::getCUDAHooks().cuFFTGetPlanCacheBatchedPlans(device_index);
+}
+
+void _cufft_set_plan_cache_batched_plans(int64_t device_index, bool enabled) {
+  detail::getCUDAHooks().cuFFTSetPlanCacheBatchedPlans(device_index, enabled);
+}
+
 Tensor fft(const Tensor& self, const int64_t signal_ndim, const bool normalized) {
   return _fft(self, signal_ndim, /* complex_input */ true,
               /* complex_output */ true, /* inverse */ false, {}, normalized,
@@ -1,16 +1,22 @@
 // Returns the frequency of elements of input non-negative integer tensor.
 
+#include <ATen/native/SummaryOps.h>
+
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
 
+#include <cmath>
 #include <tuple>
 
 namespace at { namespace native {
 
+DEFINE_DISPATCH(histc_stub);
+DEFINE_DISPATCH(bincount_stub);
+
 ///////////////// bincount /////////////////
 namespace {
 
-template <typename input_t, typename weights_t>
+template <typename input_t>
 Tensor _bincount_cpu_template(
     const Tensor& self,
     const Tensor& weights,
@@ -30,26 +36,12 @@ Tensor _bincount_cpu_template(
     AT_ERROR("input and weights should have the same length");
   }
 
-  Tensor output;
-  int64_t self_size = self.size(0);
   int64_t nbins = static_cast<int64_t>(*self.max().data_ptr<input_t>()) + 1L;
   nbins = std::max(nbins, minlength); // at least minlength # of bins
 
-  const input_t* self_p = self.data_ptr<input_t>();
-  if (has_weights) {
-    output = native::zeros({nbins}, weights.options());
-    weights_t* output_p = output.data_ptr<weights_t>();
-    const weights_t* weights_p = weights.data_ptr<weights_t>();
-    for (int64_t i = 0; i < self_size; i++) {
-      output_p[self_p[i]] += weights_p[i];
-    }
-  } else {
-    output = native::zeros({nbins}, kLong);
-    int64_t* output_p = output.data_ptr<int64_t>();
-    for (int64_t i = 0; i < self_size; i++) {
-      output_p[self_p[i]] += 1L;
-    }
-  }
+  Tensor output = native::zeros(
+      {nbins}, has_weights ? weights.options() : self.options().dtype(kLong));
+  bincount_stub(kCPU, output, self, weights);
   return output;
 }
 } // namespace
@@ -59,10 +51,61 @@ _bincount_cpu(const Tensor& self, const Tensor& weights, int64_t minlength) {
   return AT_DISPATCH_INTEGRAL_TYPES(self.scalar_type(), "bincount_cpu", [&] {
     const auto scalar = weights.scalar_type();
     if (scalar == ScalarType::Undefined || scalar == ScalarType::Float)
-      return _bincount_cpu_template<scalar_t, float>(self.contiguous(), weights.contiguous(), minlength);
-    return _bincount_cpu_template<scalar_t, double>(
+      return _bincount_cpu_template<scalar_t>(self.contiguous(), weights.contiguous(), minlength);
+    return _bincount_cpu_template<scalar_t>(
         self.contiguous(), weights.contiguous().to(kDouble), minlength);
   });
 }
 
+///////////////// histc /////////////////
+namespace {
+
+template <typename input_t>
+void _histc_cpu_template(
+    Tensor& hist,
+    const Tensor& self,
+    int64_t nbins,
+    input_t min,
+    input_t max) {
+  input_t minvalue = min;
+  input_t maxvalue = max;
+  if (min == max) {
+    minvalue = *self.min().data_ptr<input_t>();
+    maxvalue = *self.max().data_ptr<input_t>();
+  }
+  if (minvalue == maxvalue) {
+    minvalue = minvalue - 1;
+    maxvalue = maxvalue + 1;
+  }
+
+  TORCH_CHECK(
+      !(std::isinf(minvalue) || std::isinf(maxvalue) || std::isnan(minvalue) ||
+        std::isnan(maxvalue)),
+      "range of [", minvalue, ", ", maxvalue, "] is not finite");
+  TORCH_CHECK(minvalue < maxvalue, "max must be larger than min");
+
+  hist.resize_({nbins});
+  hist.zero_();
+  histc_stub(kCPU, hist, self, minvalue, maxvalue);
+}
+} // namespace
+
+Tensor& _histc_out_cpu(Tensor& result, const Tensor& self, int64_t bins, Scalar min, Scalar max) {
+  TORCH_CHECK(bins > 0, "bins must be > 0");
+  TORCH_CHECK(
+      result.scalar_type() == self.scalar_type(),
+      "histc: expected out to have dtype ", self.scalar_type(),
+      ", but got ", result.scalar_type());
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "histc_cpu", [&] {
+    _histc_cpu_template<scalar_t>(
+        result, self.contiguous(), bins, min.to<scalar_t>(), max.to<scalar_t>());
+  });
+  return result;
+}
+
+Tensor _histc_cpu(const Tensor& self, int64_t bins, Scalar min, Scalar max) {
+  Tensor result = at::empty({0}, self.options());
+  return _histc_out_cpu(result, self, bins, min, max);
+}
+
 }} // namespace at::native
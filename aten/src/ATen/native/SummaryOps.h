@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+// CPU kernels of histc and bincount. Both split the input across threads
+// with parallel_for, count into a private histogram per thread and merge the
+// histograms at the end, so threads never write to shared bins.
+//
+// The input is contiguous, and the output is a zeroed tensor of nbins
+// elements. For histc the range is already checked to be finite and
+// non-empty; for bincount the input is checked to be in [0, nbins).
+
+namespace at {
+namespace native {
+
+// (hist, self, min, max)
+using histc_fn = void (*)(Tensor&, const Tensor&, Scalar, Scalar);
+// (output, self, weights); weights is undefined for an unweighted count.
+using bincount_fn = void (*)(Tensor&, const Tensor&, const Tensor&);
+
+DECLARE_DISPATCH(histc_fn, histc_stub);
+DECLARE_DISPATCH(bincount_fn, bincount_stub);
+
+} // namespace native
+} // namespace at
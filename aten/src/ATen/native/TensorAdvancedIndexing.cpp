@@ -61,6 +61,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <limits>
 #include <numeric>
 #include <vector>
 
@@ -76,6 +77,7 @@ DEFINE_DISPATCH(gather_stub);
 DEFINE_DISPATCH(scatter_stub);
 DEFINE_DISPATCH(scatter_fill_stub);
 DEFINE_DISPATCH(scatter_add_stub);
+DEFINE_DISPATCH(scatter_reduce_stub);
 
 static bool all_strides_match(TensorList tensors) {
   TORCH_CHECK(tensors.size() >= 1);
@@ -563,6 +565,68 @@ Tensor scatter_add(const Tensor & self, int64_t dim, const Tensor & index, const
   return self.clone(at::MemoryFormat::Preserve).scatter_add_(dim, index, source);
 }
 
+Tensor _scatter_reduce_cpu(const Tensor& src, int64_t dim, const Tensor& index, std::string reduce,
+                           c10::optional<int64_t> output_size) {
+  TORCH_CHECK_INDEX(index.scalar_type() == ScalarType::Long, "_scatter_reduce(): Expected dtype int64 for index");
+  TORCH_CHECK(index.sizes() == src.sizes(),
+              "_scatter_reduce(): Expected index of the shape of src ", src.sizes(), ", but got ", index.sizes());
+  dim = maybe_wrap_dim(dim, src.dim());
+  const bool mean = reduce == "mean";
+  ScatterReduction reduction;
+  if (reduce == "sum" || mean) {
+    reduction = ScatterReduction::SUM;
+  } else if (reduce == "max") {
+    reduction = ScatterReduction::MAX;
+  } else if (reduce == "min") {
+    reduction = ScatterReduction::MIN;
+  } else {
+    TORCH_CHECK(false, "_scatter_reduce(): Expected reduce to be one of sum, mean, max or min, but got ", reduce);
+  }
+  TORCH_CHECK(!mean || at::isFloatingType(src.scalar_type()),
+              "_scatter_reduce(): mean is only supported for floating point types, but got ", src.scalar_type());
+  int64_t size = 0;
+  if (output_size.has_value()) {
+    size = output_size.value();
+    TORCH_CHECK(size >= 0, "_scatter_reduce(): Expected a non-negative output_size, but got ", size);
+  } else if (index.numel() > 0) {
+    size = index.max().item<int64_t>() + 1;
+  }
+  auto sizes = src.sizes().vec();
+  if (src.dim() > 0) {
+    sizes[dim] = size;
+  }
+
+  if (reduction == ScatterReduction::SUM) {
+    Tensor result = at::zeros(sizes, src.options());
+    scatter_reduce_stub(kCPU, result, dim, index, src, reduction);
+    if (mean) {
+      Tensor counts = at::zeros(sizes, src.options());
+      scatter_reduce_stub(kCPU, counts, dim, index, at::ones_like(src), reduction);
+      result.div_(counts.clamp_min_(1));
+    }
+    return result;
+  }
+
+  // max and min start from the identity of the reduction, and the positions
+  // no slice goes to are reset to zero afterwards.
+  Scalar identity;
+  AT_DISPATCH_ALL_TYPES_AND2(ScalarType::Bool, ScalarType::Half, src.scalar_type(), "_scatter_reduce", [&] {
+    using limits = std::numeric_limits<scalar_t>;
+    const bool is_max = reduction == ScatterReduction::MAX;
+    if (limits::has_infinity) {
+      identity = is_max ? Scalar(-limits::infinity()) : Scalar(limits::infinity());
+    } else {
+      identity = is_max ? Scalar(limits::lowest()) : Scalar(limits::max());
+    }
+  });
+  Tensor result = at::full(sizes, identity, src.options());
+  scatter_reduce_stub(kCPU, result, dim, index, src, reduction);
+  Tensor counts = at::zeros(sizes, src.options().dtype(kLong));
+  scatter_reduce_stub(kCPU, counts, dim, index, at::ones_like(src, counts.options()), ScatterReduction::SUM);
+  result.masked_fill_(counts == 0, 0);
+  return result;
+}
+
 Tensor masked_scatter(const Tensor & self, const Tensor & mask, const Tensor & source) {
   Tensor _mask, _self;
   std::tie(_mask, _self) = expand_outplace(mask, self);
@@ -113,6 +113,21 @@ Tensor isfinite(const Tensor& self) {
   });
 }
 
+void _record_nonfinite_cpu_(Tensor& found, TensorList tensors, int64_t value) {
+  TORCH_CHECK(value >= 0, "_record_nonfinite_: value must be non-negative, but got ", value);
+  TORCH_CHECK(found.device().is_cpu() && found.scalar_type() == kLong && found.numel() == 1,
+              "_record_nonfinite_: found must be a one-element int64 CPU tensor");
+  auto* found_ptr = found.data_ptr<int64_t>();
+  for (const auto& tensor : tensors) {
+    TORCH_CHECK(tensor.device().is_cpu(), "_record_nonfinite_: expected all tensors on CPU, "
+                "but got a tensor on ", tensor.device());
+    if (tensor.numel() > 0 && !at::isfinite(tensor).all().item<bool>()) {
+      *found_ptr = std::max(*found_ptr, value);
+      return;
+    }
+  }
+}
+
 bool is_nonzero(const Tensor& self) {
   auto n = self.numel();
   TORCH_CHECK(n != 0, "Boolean value of Tensor with no values is ambiguous");
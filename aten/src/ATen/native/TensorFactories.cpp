@@ -16,6 +16,7 @@
 #include <ATen/native/Resize.h>
 #include <ATen/native/TensorFactories.h>
 #include <c10/core/TensorOptions.h>
+#include <c10/core/impl/COW.h>
 #include <TH/THAllocator.h>
 #include <ATen/detail/CUDAHooksInterface.h>
 #include <c10/util/Exception.h>
@@ -1015,6 +1016,21 @@ Tensor clone(const Tensor& src, c10::optional<c10::MemoryFormat> optional_memory
   return self;
 }
 
+Tensor _lazy_clone(const Tensor& self) {
+  if (!self.device().is_cpu()) {
+    return self.clone(MemoryFormat::Preserve);
+  }
+  auto storage = c10::impl::cow::lazy_clone_storage(
+      *self.storage().unsafeGetStorageImpl());
+  auto impl = c10::make_intrusive<TensorImpl>(
+      Storage(std::move(storage)), self.key_set());
+  impl->set_storage_offset(self.storage_offset());
+  impl->set_sizes_and_strides(self.sizes(), self.strides());
+  Tensor result(std::move(impl));
+  namedinference::propagate_names(result, self);
+  return result;
+}
+
 // ~~~~~~~~~~~~~~~~~~~~~~~~~ named tensor overloads ~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // In the short term, these exist.
 // In the long term, we should move DimnameList into TensorOptions to avoid
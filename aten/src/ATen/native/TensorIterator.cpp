@@ -1,6 +1,12 @@
 #include <ATen/native/TensorIterator.h>
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <ATen/ExpandUtils.h>
 #include <ATen/Parallel.h>
 #include <ATen/native/TypeProperties.h>
@@ -535,7 +541,7 @@ void TensorIterator::for_each(loop2d_t loop, int64_t grain_size) {
   int64_t numel = this->numel();
   if (numel == 0) {
     return;
-  } else if (numel < internal::GRAIN_SIZE || at::get_num_threads() == 1) {
+  } else if (numel < grain_size || at::get_num_threads() == 1) {
     return serial_for_each(loop, {0, numel});
   } else {
     at::parallel_for(0, numel, grain_size, [&](int64_t begin, int64_t end) {
@@ -544,6 +550,39 @@ void TensorIterator::for_each(loop2d_t loop, int64_t grain_size) {
   }
 }
 
+void TensorIterator::for_each(loop_t loop, internal::GrainSizeEstimator& estimator) {
+  for_each(LOOP_WRAPPER(ntensors(), loop), estimator);
+}
+
+void TensorIterator::for_each(loop2d_t loop, internal::GrainSizeEstimator& estimator) {
+  if (!at::get_adaptive_grain_size()) {
+    return for_each(loop);
+  }
+  int64_t grain_size = estimator.grain_size();
+  if (grain_size > 0) {
+    return for_each(loop, grain_size);
+  }
+
+  int64_t numel = this->numel();
+  if (numel < internal::GrainSizeEstimator::kMinSampleSize ||
+      at::get_num_threads() == 1 || at::in_parallel_region()) {
+    return for_each(loop);
+  }
+  // Still sampling: time a serial prefix of the iteration space and run the
+  // remainder with the default grain size.
+  int64_t sample_end = std::min(numel, internal::GRAIN_SIZE);
+  auto start = std::chrono::steady_clock::now();
+  serial_for_each(loop, {0, sample_end});
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+  estimator.record(sample_end, elapsed.count());
+  if (sample_end < numel) {
+    at::parallel_for(sample_end, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      serial_for_each(loop, {begin, end});
+    });
+  }
+}
+
 StrideVector TensorIterator::get_strides() const {
   StrideVector strides;
   for (int dim = 0; dim < ndim(); dim++) {
@@ -1043,14 +1082,231 @@ FastSetupType TensorIterator::compute_fast_setup_type() {
   return FastSetupType::NONE;
 }
 
+namespace {
+
+std::atomic<bool>& plan_cache_flag() {
+  static std::atomic<bool> enabled([]() {
+    const char* value = std::getenv("ATEN_TENSOR_ITERATOR_CACHE");
+    return value && std::string(value) == "1";
+  }());
+  return enabled;
+}
+
+// Beyond this many plans the cache is more likely to be thrashed by varying
+// shapes than to help, so it is simply dropped and refilled.
+constexpr size_t kMaxCachedPlans = 1024;
+
+} // namespace
+
+void set_tensor_iterator_plan_cache_enabled(bool enabled) {
+  plan_cache_flag() = enabled;
+}
+
+bool get_tensor_iterator_plan_cache_enabled() {
+  return plan_cache_flag();
+}
+
+// The result of TensorIterator::build_plan() for one configuration of
+// operands, i.e. everything build() computes except the data pointers.
+struct TensorIteratorPlan {
+  using Key = std::vector<int64_t>;
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      size_t hash = key.size();
+      for (auto value : key) {
+        hash ^= std::hash<int64_t>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      }
+      return hash;
+    }
+  };
+
+  using Cache = std::unordered_map<Key, TensorIteratorPlan, KeyHash>;
+
+  struct Operand {
+    StrideVector stride_bytes;
+    Device device = kCPU;
+    ScalarType target_dtype = ScalarType::Undefined;
+    ScalarType current_dtype = ScalarType::Undefined;
+    // set for outputs allocated by the iterator
+    bool allocate = false;
+    bool allocate_contiguous = false;
+    DimVector sizes;
+    DimVector strides;
+  };
+
+  DimVector shape;
+  DimVector perm;
+  ScalarType common_dtype;
+  bool has_coalesced_dimensions;
+  bool all_ops_same_shape;
+  bool requires_channels_last_output;
+  bool requires_channels_last_3d_output;
+  SmallVector<Operand, 4> operands;
+
+  static Cache& cache() {
+    static thread_local Cache cache;
+    return cache;
+  }
+
+  // Describes everything build_plan() depends on. Returns false if the
+  // iterator can't be cached.
+  static bool compute_key(const TensorIterator& iter, Key& key) {
+    if (iter.is_reduction_ || iter.static_shape_) {
+      return false;
+    }
+    key.push_back(iter.num_outputs_);
+    key.push_back(static_cast<int64_t>(iter.common_dtype_strategy_));
+    key.push_back(iter.resize_outputs_ | iter.allow_cpu_scalars_ << 1 |
+                  iter.promote_gpu_output_dtypes_ << 2);
+    for (const auto& op : iter.operands_) {
+      key.push_back(static_cast<int64_t>(op.target_dtype));
+      key.push_back(static_cast<int64_t>(op.device.type()));
+      key.push_back(op.device.index());
+      const auto& tensor = op.tensor;
+      if (!tensor.defined()) {
+        key.push_back(-1);
+        continue;
+      }
+      if (tensor.has_names()) {
+        return false;
+      }
+      key.push_back(tensor.dim());
+      key.push_back(static_cast<int64_t>(op.current_dtype));
+      key.push_back(static_cast<int64_t>(tensor.device().type()));
+      key.push_back(tensor.device().index());
+      key.push_back(op.is_read_write | tensor.unsafeGetTensorImpl()->is_wrapped_number() << 1);
+      key.insert(key.end(), tensor.sizes().begin(), tensor.sizes().end());
+      key.insert(key.end(), tensor.strides().begin(), tensor.strides().end());
+    }
+    return true;
+  }
+
+  static void build_cached(TensorIterator& iter) {
+    static thread_local Key key;
+    key.clear();
+    if (!compute_key(iter, key)) {
+      return iter.build_plan();
+    }
+    auto& plans = cache();
+    auto it = plans.find(key);
+    if (it != plans.end()) {
+      return it->second.apply(iter);
+    }
+
+    // build_plan() may replace operands, e.g. to cast them, or resize
+    // outputs; such plans depend on more than the key and are not cached.
+    SmallVector<TensorImpl*, 4> impls;
+    SmallVector<std::pair<DimVector, DimVector>, 1> output_geometry;
+    for (int i = 0; i < iter.ntensors(); i++) {
+      const auto& tensor = iter.operands_[i].tensor;
+      impls.push_back(tensor.defined() ? tensor.unsafeGetTensorImpl() : nullptr);
+      if (i < iter.num_outputs_ && tensor.defined()) {
+        output_geometry.emplace_back(DimVector(tensor.sizes()), DimVector(tensor.strides()));
+      }
+    }
+    iter.build_plan();
+    if (!iter.names_.empty()) {
+      return;
+    }
+    int defined_output = 0;
+    for (int i = 0; i < iter.ntensors(); i++) {
+      const auto& op = iter.operands_[i];
+      if (op.original_tensor.defined()) {
+        return;
+      }
+      if (impls[i] == nullptr) {
+        continue;
+      }
+      if (op.tensor.unsafeGetTensorImpl() != impls[i]) {
+        return;
+      }
+      if (i < iter.num_outputs_) {
+        const auto& geometry = output_geometry[defined_output++];
+        if (!op.tensor.sizes().equals(geometry.first) ||
+            !op.tensor.strides().equals(geometry.second)) {
+          return;
+        }
+      }
+    }
+    if (plans.size() >= kMaxCachedPlans) {
+      plans.clear();
+    }
+    plans.emplace(key, capture(iter, impls));
+  }
+
+  static TensorIteratorPlan capture(const TensorIterator& iter, ArrayRef<TensorImpl*> impls) {
+    TensorIteratorPlan plan;
+    plan.shape = iter.shape_;
+    plan.perm = iter.perm_;
+    plan.common_dtype = iter.common_dtype_;
+    plan.has_coalesced_dimensions = iter.has_coalesced_dimensions_;
+    plan.all_ops_same_shape = iter.all_ops_same_shape_;
+    plan.requires_channels_last_output = iter.requires_channels_last_output_;
+    plan.requires_channels_last_3d_output = iter.requires_channels_last_3d_output_;
+    for (int i = 0; i < iter.ntensors(); i++) {
+      const auto& op = iter.operands_[i];
+      Operand operand;
+      operand.stride_bytes = op.stride_bytes;
+      operand.device = op.device;
+      operand.target_dtype = op.target_dtype;
+      operand.current_dtype = op.current_dtype;
+      if (impls[i] == nullptr) {
+        operand.allocate = true;
+        operand.allocate_contiguous = op.tensor.is_contiguous();
+        operand.sizes = op.tensor.sizes();
+        operand.strides = op.tensor.strides();
+      }
+      plan.operands.push_back(std::move(operand));
+    }
+    return plan;
+  }
+
+  void apply(TensorIterator& iter) const {
+    iter.shape_ = shape;
+    iter.perm_ = perm;
+    iter.common_dtype_ = common_dtype;
+    iter.has_coalesced_dimensions_ = has_coalesced_dimensions;
+    iter.all_ops_same_shape_ = all_ops_same_shape;
+    iter.requires_channels_last_output_ = requires_channels_last_output;
+    iter.requires_channels_last_3d_output_ = requires_channels_last_3d_output;
+    for (int i = 0; i < iter.ntensors(); i++) {
+      auto& op = iter.operands_[i];
+      const auto& operand = operands[i];
+      op.stride_bytes = operand.stride_bytes;
+      op.device = operand.device;
+      op.target_dtype = operand.target_dtype;
+      op.current_dtype = operand.current_dtype;
+      if (operand.allocate) {
+        op.tensor = operand.allocate_contiguous
+            ? at::empty(operand.sizes, op.options())
+            : at::empty_strided(operand.sizes, operand.strides, op.options());
+      }
+    }
+  }
+};
+
+void clear_tensor_iterator_plan_cache() {
+  TensorIteratorPlan::cache().clear();
+}
+
 void TensorIterator::build() {
-  // check input tensors memory format to use it during output allocation
-  analyze_memory_format();
   // set is_output and is_read_write flags on appropriate tensors
   mark_outputs();
   // Check that the outputs have no internal overlap
   // and do not share memory with inputs.
   check_mem_overlaps();
+  if (get_tensor_iterator_plan_cache_enabled()) {
+    TensorIteratorPlan::build_cached(*this);
+  } else {
+    build_plan();
+  }
+  set_data_ptrs();
+}
+
+void TensorIterator::build_plan() {
+  // check input tensors memory format to use it during output allocation
+  analyze_memory_format();
   // Check that input dimensions are aligned correctly & compute outnames.
   compute_names();
   // compute the broadcasted shape
@@ -1070,7 +1326,9 @@ void TensorIterator::build() {
   }
   // perform name inference
   propagate_names_to_outputs();
+}
 
+void TensorIterator::set_data_ptrs() {
   for (auto& op : operands_) {
     TORCH_INTERNAL_ASSERT(op.tensor.defined());
     op.data = op.tensor.data_ptr();
@@ -55,6 +55,21 @@
 
 namespace at {
 
+// Enables or disables the TensorIterator plan cache. When enabled, build()
+// remembers the iteration plan (broadcast shape, strides, dimension order and
+// dtypes) computed for a configuration of operand sizes, strides, dtypes and
+// devices, and reuses it when the same configuration is built again, e.g. for
+// the recurring shapes of an inference loop. Plans are cached per thread.
+// Disabled by default, can also be enabled by setting
+// ATEN_TENSOR_ITERATOR_CACHE=1.
+CAFFE2_API void set_tensor_iterator_plan_cache_enabled(bool enabled);
+
+// Returns whether the TensorIterator plan cache is enabled
+CAFFE2_API bool get_tensor_iterator_plan_cache_enabled();
+
+// Drops the calling thread's cached TensorIterator plans
+CAFFE2_API void clear_tensor_iterator_plan_cache();
+
 struct DimCounter {
   DimCounter(IntArrayRef shape, Range range);
 
@@ -130,6 +145,7 @@ struct CAFFE2_API OperandInfo {
 };
 
 struct SplitUntil32Bit;
+struct TensorIteratorPlan;
 
 enum class FastSetupType : uint8_t {
   NONE,
@@ -264,6 +280,10 @@ struct CAFFE2_API TensorIterator {
 
   void for_each(loop_t loop, int64_t grain_size = at::internal::GRAIN_SIZE);
   void for_each(loop2d_t loop, int64_t grain_size = at::internal::GRAIN_SIZE);
+  /// Like for_each, but with a grain size learned by `estimator` from the
+  /// first invocations if at::get_adaptive_grain_size() is set.
+  void for_each(loop_t loop, at::internal::GrainSizeEstimator& estimator);
+  void for_each(loop2d_t loop, at::internal::GrainSizeEstimator& estimator);
 
   void parallel_reduce(loop2d_t loop);
 
@@ -375,6 +395,8 @@ struct CAFFE2_API TensorIterator {
   void build();
 
 protected:
+  friend struct TensorIteratorPlan;
+
   void mark_outputs();
   void check_mem_overlaps();
   void compute_shape();
@@ -390,6 +412,8 @@ protected:
   void propagate_names_to_outputs();
   void coalesce_dimensions();
   void analyze_memory_format();
+  void build_plan();
+  void set_data_ptrs();
 
 protected:
   DimVector shape_;
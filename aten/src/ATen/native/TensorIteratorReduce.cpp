@@ -30,37 +30,32 @@ static bool use_two_pass_reduction(TensorIterator& iter) {
   return iter.output(0).numel() == 1;
 }
 
+// Each chunk (see internal::reduction_chunk_size) is reduced into its own
+// slice of a buffer, which is then reduced into the output in chunk order.
 static void two_pass_reduction(TensorIterator& iter, loop2d_t loop) {
-  int max_threads = at::get_num_threads();
+  const int64_t numel = iter.numel();
+  const int64_t chunk_size = internal::reduction_chunk_size(numel);
+  const int64_t num_chunks = divup(numel, chunk_size);
 
   auto dst = iter.output(0);
   auto buffer_shape = DimVector(dst.sizes());
-  buffer_shape.insert(buffer_shape.begin(), max_threads);
+  buffer_shape.insert(buffer_shape.begin(), num_chunks);
   auto buffer = at::empty(buffer_shape, dst.options());
 
-  std::unique_ptr<bool[]> written(new bool[max_threads]);
-  std::fill(written.get(), written.get() + max_threads, false);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; chunk++) {
+      auto slice = buffer[chunk];
+      slice.copy_(dst);
 
-  at::parallel_for(0, iter.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
-    int thread_num = at::get_thread_num();
-    written[thread_num] = true;
-    auto slice = buffer[thread_num];
-    slice.copy_(dst);
-
-    auto sub_iter = TensorIterator::reduce_op(slice, iter.input(0));
-    sub_iter.serial_for_each(loop, {begin, end});
-  });
-
-  // fill any unwritten slices of the buffer with the identity
-  for (int thread_num = 0; thread_num < max_threads; thread_num++) {
-    if (!written[thread_num]) {
-      buffer[thread_num].copy_(dst);
+      auto sub_iter = TensorIterator::reduce_op(slice, iter.input(0));
+      sub_iter.serial_for_each(
+          loop, {chunk * chunk_size, std::min(numel, (chunk + 1) * chunk_size)});
     }
-  }
+  });
 
   auto unsqueezed = dst.unsqueeze(0);
   auto final_reduce = TensorIterator::reduce_op(unsqueezed, buffer);
-  final_reduce.for_each(loop);
+  final_reduce.serial_for_each(loop, {0, final_reduce.numel()});
 }
 
 /// Chooses a dimension over which to parallelize. Prefers the outer-most
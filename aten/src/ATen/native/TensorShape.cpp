@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <numeric>
 #include <vector>
 #include <ATen/ATen.h>
 #include <ATen/ExpandUtils.h>
@@ -21,7 +22,7 @@
 namespace at {
 namespace native {
 
-DEFINE_DISPATCH(cat_serial_stub);
+DEFINE_DISPATCH(cat_contiguous_stub);
 
 Tensor _reshape_from_tensor(const Tensor& self, const Tensor& shape_tensor) {
   TORCH_CHECK(shape_tensor.dim() == 1);
@@ -97,6 +98,23 @@ static inline void check_cat_shape_except_dim(const Tensor & first, const Tensor
   }
 }
 
+// The memory format all the inputs suggest, or Contiguous if they differ.
+template <typename SkipFn>
+static MemoryFormat compute_cat_memory_format(TensorList tensors, const SkipFn& should_skip) {
+  c10::optional<MemoryFormat> format;
+  for (auto const &tensor : tensors) {
+    if (should_skip(tensor)) {
+      continue;
+    }
+    const MemoryFormat f = tensor.suggest_memory_format();
+    if (format.has_value() && format.value() != f) {
+      return MemoryFormat::Contiguous;
+    }
+    format = f;
+  }
+  return format.value_or(MemoryFormat::Contiguous);
+}
+
 Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
   // previously, size [0] tensors were the only possible empty tensors; thus, it wasn't possible
   // to cat empty tensors unless all the other tensors were 1-dimensional, so we allowed these tensors
@@ -104,7 +122,6 @@ Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
   // size (i.e. other empty sizes are not skipped).
   // FIXME: warn if this is the case
   bool allSkipped = true;
-  bool allContiguous = true;
   Tensor notSkippedTensor;
 
   // Inputs cannot alias the output tensor
@@ -141,17 +158,11 @@ Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
   int64_t cat_dim_size = 0;
   for (auto const &tensor : tensors) {
     if (should_skip(tensor)) {
-      // don't use fast path for empty tensor
-      allContiguous = false;
       continue;
     }
     check_cat_shape_except_dim(notSkippedTensor, tensor, dim);
     cat_dim_size += tensor.size(dim);
 
-    if (!tensor.is_contiguous()) {
-      allContiguous = false;
-    }
-
     if (tensor.sizes() != notSkippedTensor.sizes() ||
         tensor.strides() != notSkippedTensor.strides() ||
         tensor.dtype() != notSkippedTensor.dtype()) {
@@ -159,18 +170,51 @@ Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
     }
   }
 
-  // compute the size of the result
+  // compute the size of the result, which keeps the memory format the
+  // inputs share, like on CUDA
   auto result_size = notSkippedTensor.sizes().vec();
   result_size[dim] = cat_dim_size;
-  result.resize_(result_size);
-
-  // fast path for single thread when both inputs and result are contiguous and not empty
-  bool use_serial_kernel = result.numel() < at::internal::GRAIN_SIZE || at::get_num_threads() == 1;
-  allContiguous = allContiguous && result.is_contiguous();
-  ScalarType dtype = notSkippedTensor.scalar_type();
-  if (use_serial_kernel && allContiguous && (dtype == ScalarType::Double || dtype == ScalarType::Float)) {
-    cat_serial_stub(kCPU, result, tensors, dim);
-    return result;
+  const MemoryFormat memory_format = compute_cat_memory_format(tensors, should_skip);
+  if (memory_format == MemoryFormat::Contiguous) {
+    result.resize_(result_size);
+  } else {
+    result.resize_(result_size, memory_format);
+  }
+
+  // fast path when the inputs and the result have one type and are dense in
+  // the same memory format: the tensors are then contiguous once the
+  // channels are moved last, and all inputs are copied in one parallel pass
+  if (!result.is_quantized()) {
+    std::vector<Tensor> inputs;
+    inputs.reserve(tensors.size());
+    bool sameType = true;
+    for (auto const &tensor : tensors) {
+      if (!should_skip(tensor)) {
+        sameType = sameType && tensor.scalar_type() == result.scalar_type();
+        inputs.push_back(tensor);
+      }
+    }
+    auto inContiguousFormat = [&](MemoryFormat format) {
+      return result.is_contiguous(format) &&
+          std::all_of(inputs.begin(), inputs.end(), [&](const Tensor& t) { return t.is_contiguous(format); });
+    };
+    if (sameType && inContiguousFormat(MemoryFormat::Contiguous)) {
+      cat_contiguous_stub(kCPU, result, inputs, dim);
+      return result;
+    }
+    if (sameType && result.dim() >= 4 && result.dim() <= 5 &&
+        inContiguousFormat(result.dim() == 4 ? MemoryFormat::ChannelsLast : MemoryFormat::ChannelsLast3d)) {
+      std::vector<int64_t> perm(result.dim());
+      std::iota(perm.begin() + 1, perm.end() - 1, 2);
+      perm.back() = 1;
+      for (auto& input : inputs) {
+        input = input.permute(perm);
+      }
+      Tensor result_permuted = result.permute(perm);
+      const int64_t permuted_dim = std::find(perm.begin(), perm.end(), dim) - perm.begin();
+      cat_contiguous_stub(kCPU, result_permuted, inputs, permuted_dim);
+      return result;
+    }
   }
 
   int64_t offset = 0;
@@ -18,6 +18,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/native/UnaryOps.h>
 #include <ATen/native/TensorIterator.h>
+#include <ATen/native/xnnpack/Engine.h>
 #include <ATen/NamedTensorUtils.h>
 
 #include <algorithm>
@@ -330,6 +331,13 @@ Tensor& clamp_out(Tensor& result, const Tensor& self, optional<Scalar> min, opti
 }
 
 Tensor clamp(const Tensor& self, optional<Scalar> min, optional<Scalar> max) {
+// Disable the xnnpack operators for both iOS and macOS temporarily due to the crash in pthreadpool
+// TODO:T66297472 remove `!defined(__APPLE__)` once we figure out the root cause of the crash.
+#if defined(C10_MOBILE) && !defined(__APPLE__)
+  if (xnnpack::use_clamp(self, min, max)) {
+    return xnnpack::clamp(self, min, max);
+  }
+#endif
   Tensor result = at::empty({0}, self.options());
   return at::clamp_out(result, self, min, max);
 }
@@ -2,69 +2,136 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <c10/util/flat_hash_map.h>
 
-#include <set>
+#include <algorithm>
+#include <numeric>
 #include <tuple>
-#include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 namespace at {
 namespace native{
 
 namespace {
 
+// Assigns values to one of num_partitions partitions, with a hash mixed
+// differently from the one of the hash maps, so that the keys of a partition
+// still spread over the slots of its map.
+template <typename scalar_t>
+inline int64_t unique_partition(scalar_t value, int64_t num_partitions) {
+  if (num_partitions == 1) {
+    return 0;
+  }
+  uint64_t h = std::hash<scalar_t>()(value);
+  h = (h ^ (h >> 31)) * 0xbf58476d1ce4e5b9ULL;
+  return static_cast<int64_t>((h >> 32) % static_cast<uint64_t>(num_partitions));
+}
+
+// Every task counts the values of a chunk of the input into one hash map per
+// partition of the values, then merges the maps of one partition across the
+// chunks, so that no two tasks touch the same map. The merged maps give the
+// unique values and their counts, and then map every value to its position
+// in the output for the inverse indices. With sorted, only the unique values
+// are sorted.
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const Tensor& self,
     const bool sorted,
     const bool return_inverse,
     const bool return_counts) {
+  using CountMap = ska::flat_hash_map<scalar_t, int64_t>;
   const Tensor& input = self.contiguous();
   const scalar_t* input_data = input.data_ptr<scalar_t>();
   int64_t numel = input.numel();
-  Tensor output;
   Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
   Tensor counts = at::empty({0}, self.options().dtype(kLong));
 
-  std::unordered_set<scalar_t> set(input_data, input_data + numel);
-  output = at::empty({static_cast<int64_t>(set.size())}, input.options());
-  scalar_t *output_data = output.data_ptr<scalar_t>();
+  const int64_t num_tasks = std::max<int64_t>(
+      std::min<int64_t>(at::get_num_threads(), divup(numel, internal::GRAIN_SIZE)), 1);
+  const int64_t chunk_size = divup(numel, num_tasks);
+  std::vector<CountMap> chunk_maps(num_tasks * num_tasks);
+  at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t t = begin; t < end; t++) {
+      CountMap* maps = chunk_maps.data() + t * num_tasks;
+      const int64_t chunk_end = std::min(numel, (t + 1) * chunk_size);
+      for (int64_t i = t * chunk_size; i < chunk_end; i++) {
+        maps[unique_partition(input_data[i], num_tasks)][input_data[i]]++;
+      }
+    }
+  });
 
+  std::vector<CountMap> maps(num_tasks);
+  at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      maps[p] = std::move(chunk_maps[p]);
+      for (int64_t t = 1; t < num_tasks; t++) {
+        CountMap& chunk_map = chunk_maps[t * num_tasks + p];
+        for (const auto& entry : chunk_map) {
+          maps[p][entry.first] += entry.second;
+        }
+        chunk_map = CountMap();
+      }
+    }
+  });
+
+  std::vector<int64_t> offsets(num_tasks + 1, 0);
+  for (int64_t p = 0; p < num_tasks; p++) {
+    offsets[p + 1] = offsets[p] + static_cast<int64_t>(maps[p].size());
+  }
+  const int64_t num_unique = offsets[num_tasks];
+  Tensor output = at::empty({num_unique}, input.options());
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  int64_t* counts_data = nullptr;
+  if (return_counts) {
+    counts.resize_({num_unique});
+    counts_data = counts.data_ptr<int64_t>();
+  }
+
+  // From here on, the maps hold the position of every value in the output
+  // instead of its count.
+  at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      int64_t k = offsets[p];
+      for (auto& entry : maps[p]) {
+        output_data[k] = entry.first;
+        if (!sorted) {
+          if (return_counts) {
+            counts_data[k] = entry.second;
+          }
+          entry.second = k;
+        }
+        k++;
+      }
+    }
+  });
   if (sorted) {
-    std::vector<scalar_t> vec(set.begin(), set.end());
-    std::sort(vec.begin(), vec.end());
-    std::copy(vec.begin(), vec.end(), output_data);
-  } else {
-    std::copy(set.begin(), set.end(), output_data);
+    std::sort(output_data, output_data + num_unique);
+    at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; p++) {
+        for (auto& entry : maps[p]) {
+          const int64_t k =
+              std::lower_bound(output_data, output_data + num_unique, entry.first) - output_data;
+          if (return_counts) {
+            counts_data[k] = entry.second;
+          }
+          entry.second = k;
+        }
+      }
+    });
   }
 
-  if (return_inverse || return_counts) {
+  if (return_inverse) {
     inverse_indices.resize_(input.sizes());
     int64_t* inverse_indices_data = inverse_indices.data_ptr<int64_t>();
-    std::unordered_map<scalar_t, int64_t> inverse_map;
-    inverse_map.reserve(output.numel());
-    for (int64_t i = 0; i < output.numel(); ++i) {
-      inverse_map[output_data[i]] = i;
-    }
-    for(int64_t i = 0; i < numel; ++i) {
-      inverse_indices_data[i] = inverse_map[input_data[i]];
-    }
-    if (return_counts) {
-      std::unordered_map<scalar_t, int64_t> counts_map;
-      counts_map.reserve(output.numel());
-      for (int64_t i = 0; i < output.numel(); ++i) {
-        counts_map[output_data[i]] = 0;
-      }
-      for(int64_t i = 0; i < numel; i++) {
-        counts_map[input_data[i]] += 1;
+    at::parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        const CountMap& map = maps[unique_partition(input_data[i], num_tasks)];
+        auto it = map.find(input_data[i]);
+        // NaN is not equal to itself, so it is never found
+        inverse_indices_data[i] = it != map.end() ? it->second : 0;
       }
-      counts.resize_(output.sizes());
-      counts.fill_(0);
-      int64_t *counts_data = counts.data_ptr<int64_t>();
-      for(int64_t i = 0; i < output.numel(); i++) {
-        counts_data[i] = counts_map[output_data[i]];
-      }
-    }
+    });
   }
   return std::make_tuple(output, inverse_indices, counts);
 }
@@ -205,10 +272,8 @@ std::tuple<Tensor, Tensor, Tensor> _unique_dim_cpu_template(
 
   Tensor input_sorted;
   if (!consecutive) {
-    input_sorted = at::empty(input_flat.sizes(), input_flat.options());
-    for (size_t i = 0; i < indices.size(); ++i) {
-      input_sorted[i] = input_flat[indices[i]];
-    }
+    input_sorted = input_flat.index_select(
+        0, at::tensor(indices, self.options().dtype(kLong)));
   } else {
     input_sorted = input_flat;
   }
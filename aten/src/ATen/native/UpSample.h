@@ -56,6 +56,17 @@ DECLARE_DISPATCH(upsampling_1d, upsample_nearest1d_backward_kernel);
 DECLARE_DISPATCH(upsampling_2d, upsample_nearest2d_backward_kernel);
 DECLARE_DISPATCH(upsampling_3d, upsample_nearest3d_backward_kernel);
 
+// Interpolating modes take align_corners; bicubic2d shares the bilinear2d
+// signature. The CPU kernels handle float and double inputs in either
+// contiguous or channels last memory format.
+using upsampling_linear_1d = void(*)(Tensor& output, const Tensor& input, bool align_corners, scale_t scales_w);
+using upsampling_linear_2d = void(*)(Tensor& output, const Tensor& input, bool align_corners, scale_t scales_h, scale_t scales_w);
+using upsampling_linear_3d = void(*)(Tensor& output, const Tensor& input, bool align_corners, scale_t scales_d, scale_t scales_h, scale_t scales_w);
+DECLARE_DISPATCH(upsampling_linear_1d, upsample_linear1d_kernel);
+DECLARE_DISPATCH(upsampling_linear_2d, upsample_bilinear2d_kernel);
+DECLARE_DISPATCH(upsampling_linear_3d, upsample_trilinear3d_kernel);
+DECLARE_DISPATCH(upsampling_linear_2d, upsample_bicubic2d_kernel);
+
 static inline void upsample_1d_shape_check(
     const Tensor& input,
     const Tensor& grad_output,
@@ -195,6 +195,13 @@ static void upsample_bicubic2d_out_cpu_template(
       output_height,
       output_width);
 
+  if (input_.scalar_type() != kHalf) {
+    output.resize_({nbatch, channels, output_height, output_width}, input_.suggest_memory_format());
+    upsample_bicubic2d_kernel(kCPU, output, input_, align_corners, scales_h, scales_w);
+    return;
+  }
+
+  // Half inputs, which have no vectorized kernel, take the loops above.
   auto input = input_.contiguous();
 
   output.resize_({nbatch, channels, output_height, output_width});
@@ -331,5 +338,7 @@ Tensor upsample_bicubic2d_backward_cpu(
   return grad_input;
 }
 
+DEFINE_DISPATCH(upsample_bicubic2d_kernel);
+
 } // namespace native
 } // namespace at
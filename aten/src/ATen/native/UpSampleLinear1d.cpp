@@ -134,6 +134,13 @@ static void upsample_linear1d_out_cpu_template(
       input_width,
       output_width);
 
+  if (input_.scalar_type() != kHalf) {
+    output.resize_({nbatch, channels, output_width}, input_.suggest_memory_format());
+    upsample_linear1d_kernel(kCPU, output, input_, align_corners, scales);
+    return;
+  }
+
+  // Half inputs, which have no vectorized kernel, take the loops above.
   auto input = input_.contiguous();
 
   output.resize_({nbatch, channels, output_width});
@@ -255,5 +262,7 @@ Tensor upsample_linear1d_backward_cpu(
   return grad_input;
 }
 
+DEFINE_DISPATCH(upsample_linear1d_kernel);
+
 } // namespace native
 } // namespace at
@@ -12,6 +12,29 @@ using batch_norm_fn = void (*)(Tensor&, const Tensor&, const Tensor&,
 
 DECLARE_DISPATCH(batch_norm_fn, batch_norm_cpu_inference_contiguous_stub);
 
+// Kernels for inputs that are [M, C] matrices with contiguous rows, i.e. 2-D
+// contiguous inputs and 4-D channels last inputs, where M = N * H * W. The
+// per-channel tensors are contiguous and of the type of the input.
+
+// (mean, var_sum, input): the mean of every channel, and the sum of the
+// squared deviations from it.
+using batch_norm_collect_stats_fn = void (*)(Tensor&, Tensor&, const Tensor&);
+// (output, input, alpha, beta): output = input * alpha(c) + beta(c).
+using batch_norm_transform_fn = void (*)(Tensor&, const Tensor&, const Tensor&, const Tensor&);
+// (sum_dy, dot_p, grad_out, input, mean): the sum of grad_out, and of
+// (input - mean(c)) * grad_out over every channel.
+using batch_norm_backward_reduce_fn = void (*)(Tensor&, Tensor&, const Tensor&,
+    const Tensor&, const Tensor&);
+// (grad_input, grad_out, input, a, b, c):
+// grad_input = grad_out * a(c) + input * b(c) + c(c).
+using batch_norm_backward_elemt_fn = void (*)(Tensor&, const Tensor&, const Tensor&,
+    const Tensor&, const Tensor&, const Tensor&);
+
+DECLARE_DISPATCH(batch_norm_collect_stats_fn, batch_norm_cpu_collect_stats_channels_last_stub);
+DECLARE_DISPATCH(batch_norm_transform_fn, batch_norm_cpu_transform_channels_last_stub);
+DECLARE_DISPATCH(batch_norm_backward_reduce_fn, batch_norm_cpu_backward_reduce_channels_last_stub);
+DECLARE_DISPATCH(batch_norm_backward_elemt_fn, batch_norm_cpu_backward_elemt_channels_last_stub);
+
 } // namespace native
 
 } // namespace at
@@ -14,6 +14,25 @@ namespace {
 
 using namespace vec256;
 
+// Keep alpha in float rather than rounding it to BFloat16 or Half, and do the
+// fused multiply-add in float with a single rounding of the result.
+template <typename scalar_t>
+void add_reduced_float_kernel(TensorIterator& iter, Scalar alpha_scalar) {
+  auto alpha = alpha_scalar.to<float>();
+  auto alpha_vec = Vec256<float>(alpha);
+  cpu_kernel_vec(iter,
+    [=](scalar_t a, scalar_t b) -> scalar_t {
+      return static_cast<float>(a) + alpha * static_cast<float>(b);
+    },
+    [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+      Vec256<float> a0, a1, b0, b1;
+      std::tie(a0, a1) = convert_to_float(a);
+      std::tie(b0, b1) = convert_to_float(b);
+      return convert_from_float<scalar_t>(
+          vec256::fmadd(b0, alpha_vec, a0), vec256::fmadd(b1, alpha_vec, a1));
+    });
+}
+
 // Note: Undefined behavior when performing addition is intentionally
 // ignored.
 void add_kernel(TensorIterator& iter, Scalar alpha_scalar) {
@@ -22,8 +41,12 @@ void add_kernel(TensorIterator& iter, Scalar alpha_scalar) {
       auto alpha = alpha_scalar.to<scalar_t>();
       cpu_kernel(iter,
         [=](scalar_t a, scalar_t b) __ubsan_ignore_undefined__ -> scalar_t { return a + alpha * b; });
+  } else if (iter.dtype() == ScalarType::BFloat16) {
+    add_reduced_float_kernel<BFloat16>(iter, alpha_scalar);
+  } else if (iter.dtype() == ScalarType::Half) {
+    add_reduced_float_kernel<Half>(iter, alpha_scalar);
   } else {
-    AT_DISPATCH_ALL_TYPES_AND_C10_COMPLEX_AND2(kBFloat16, kHalf, iter.dtype(), "add_cpu/sub_cpu", [&]() {
+    AT_DISPATCH_ALL_TYPES_AND_C10_COMPLEX(iter.dtype(), "add_cpu/sub_cpu", [&]() {
       auto alpha = alpha_scalar.to<scalar_t>();
       auto alpha_vec = Vec256<scalar_t>(alpha);
       cpu_kernel_vec(iter,
@@ -0,0 +1,107 @@
+#include <ATen/native/cpu/BlockSparseLinearKernel.h>
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace at {
+namespace native {
+namespace {
+
+// Each task computes whole block rows, i.e. block_rows output features of
+// every sample, so outputs are written by one thread only. When a block row
+// is a whole number of vectors, the outputs are accumulated in registers
+// with one fmadd per weight.
+template <typename scalar_t>
+void block_sparse_linear_kernel_impl(
+    Tensor& output,
+    const Tensor& input,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& bias) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t batch = input.size(0);
+  const int64_t in_features = input.size(1);
+  const int64_t out_features = output.size(1);
+  const int64_t num_block_rows = crow_indices.size(0) - 1;
+  const int64_t block_cols = values.size(1);
+  const int64_t block_rows = values.size(2);
+  const int64_t block_size = block_rows * block_cols;
+
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const int64_t* crow_data = crow_indices.data_ptr<int64_t>();
+  const int64_t* col_data = col_indices.data_ptr<int64_t>();
+  const scalar_t* values_data = values.data_ptr<scalar_t>();
+  const scalar_t* bias_data = bias.defined() ? bias.data_ptr<scalar_t>() : nullptr;
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+
+  const int64_t work_per_block_row =
+      std::max<int64_t>(1, batch * values.numel() / std::max<int64_t>(1, num_block_rows));
+  const int64_t grain_size =
+      std::max<int64_t>(1, internal::GRAIN_SIZE / work_per_block_row);
+
+  parallel_for(0, num_block_rows, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> acc(block_rows);
+    for (int64_t r = begin; r < end; r++) {
+      const int64_t row_begin = crow_data[r];
+      const int64_t row_end = crow_data[r + 1];
+      const int64_t out_offset = r * block_rows;
+      for (int64_t n = 0; n < batch; n++) {
+        const scalar_t* x = input_data + n * in_features;
+        scalar_t* y = output_data + n * out_features + out_offset;
+        if (block_rows % Vec::size() == 0) {
+          for (int64_t i = 0; i < block_rows; i += Vec::size()) {
+            Vec sum = bias_data ? Vec::loadu(bias_data + out_offset + i) : Vec(0);
+            for (int64_t b = row_begin; b < row_end; b++) {
+              const scalar_t* x_block = x + col_data[b] * block_cols;
+              const scalar_t* w = values_data + b * block_size + i;
+              for (int64_t j = 0; j < block_cols; j++) {
+                sum = vec256::fmadd(Vec(x_block[j]), Vec::loadu(w + j * block_rows), sum);
+              }
+            }
+            sum.store(y + i);
+          }
+        } else {
+          for (int64_t i = 0; i < block_rows; i++) {
+            acc[i] = bias_data ? bias_data[out_offset + i] : scalar_t(0);
+          }
+          for (int64_t b = row_begin; b < row_end; b++) {
+            const scalar_t* x_block = x + col_data[b] * block_cols;
+            const scalar_t* w = values_data + b * block_size;
+            for (int64_t j = 0; j < block_cols; j++) {
+              const scalar_t xj = x_block[j];
+              for (int64_t i = 0; i < block_rows; i++) {
+                acc[i] += xj * w[j * block_rows + i];
+              }
+            }
+          }
+          std::copy(acc.begin(), acc.end(), y);
+        }
+      }
+    }
+  });
+}
+
+void block_sparse_linear_kernel(
+    Tensor& output,
+    const Tensor& input,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& bias) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "block_sparse_linear", [&] {
+    block_sparse_linear_kernel_impl<scalar_t>(
+        output, input, crow_indices, col_indices, values, bias);
+  });
+}
+
+}  // namespace
+
+REGISTER_DISPATCH(block_sparse_linear_stub, &block_sparse_linear_kernel);
+
+}  // namespace native
+}  // namespace at
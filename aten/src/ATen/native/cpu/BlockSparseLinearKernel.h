@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+/*
+  Linear layer on a block-sparse weight, as packed by
+  _block_sparse_linear_pack: the [out_features, in_features] weight is cut
+  into block_rows x block_cols blocks, and only the nonzero blocks are kept,
+  by block row. Block row r has the blocks crow_indices[r] up to
+  crow_indices[r + 1], which are in the block columns col_indices[b], and
+  values[b] holds block b transposed (block_cols x block_rows), so that the
+  weights of one input feature are contiguous.
+*/
+
+namespace at {
+namespace native {
+
+// (output, input, crow_indices, col_indices, values, bias)
+// output is [batch, out_features] and input is a contiguous
+// [batch, in_features] matrix. bias is undefined or a contiguous vector.
+using block_sparse_linear_fn = void (*)(
+    Tensor&, const Tensor&, const Tensor&, const Tensor&, const Tensor&,
+    const Tensor&);
+
+DECLARE_DISPATCH(block_sparse_linear_fn, block_sparse_linear_stub);
+
+}  // namespace native
+}  // namespace at
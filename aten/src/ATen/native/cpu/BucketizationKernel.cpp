@@ -0,0 +1,160 @@
+#include <ATen/native/Bucketization.h>
+
+#include <algorithm>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at {
+namespace native {
+
+namespace {
+
+using namespace vec256;
+
+// minimal size for searchsorted_cpu_contiguous to run parallel (multithread)
+constexpr int64_t SEARCHSORTED_GRAIN_SIZE = 200;
+
+// Number of values searched together by batched_search, so that the loads of
+// their searches overlap.
+constexpr int64_t kSearchBatch = 8;
+
+// Whether boundary `bd` is before the position of `val`, i.e. whether it is
+// smaller than (lower bound) or not larger than (upper bound) val. Written
+// with negated comparisons so that a 'nan' value is after every boundary,
+// like in the lower bound of the CUDA kernel.
+template <bool right, typename input_t>
+inline bool before(input_t bd, input_t val) {
+  return right ? !(val < bd) : !(bd >= val);
+}
+
+// Binary search without branches on the comparison: the half of the range is
+// picked with a conditional move, so the loop runs ceil(log2(n)) times for
+// every value. Values are searched kSearchBatch at a time.
+template <bool right, typename input_t, typename output_t>
+void batched_search(
+    const input_t* bd,
+    int64_t n,
+    const input_t* in,
+    output_t* out,
+    int64_t len) {
+  if (n == 0) {
+    std::fill(out, out + len, output_t(0));
+    return;
+  }
+  for (int64_t i = 0; i < len; i += kSearchBatch) {
+    const int64_t batch = std::min(kSearchBatch, len - i);
+    const input_t* base[kSearchBatch];
+    std::fill(base, base + kSearchBatch, bd);
+    for (int64_t remaining = n; remaining > 1;) {
+      const int64_t half = remaining >> 1;
+      for (int64_t k = 0; k < batch; k++) {
+        base[k] = before<right>(base[k][half], in[i + k]) ? base[k] + half : base[k];
+      }
+      remaining -= half;
+    }
+    for (int64_t k = 0; k < batch; k++) {
+      // type conversion might happen here
+      out[i + k] = (base[k] - bd) + before<right>(*base[k], in[i + k]);
+    }
+  }
+}
+
+// For a few boundaries, comparing Vec256::size() values to all of them at once
+// beats a binary search: the position of a value is the number of boundaries
+// before it.
+template <typename input_t>
+inline int64_t linear_search_max_boundaries() {
+  // The counts are kept in input_t, which covers the count of 64 boundaries
+  // for every type.
+  return std::min<int64_t>(4 * Vec256<input_t>::size(), 64);
+}
+
+template <bool right, typename input_t, typename output_t>
+void linear_search(
+    const input_t* bd,
+    int64_t n,
+    const input_t* in,
+    output_t* out,
+    int64_t len) {
+  using Vec = Vec256<input_t>;
+  const Vec one(input_t(1));
+  int64_t i = 0;
+  for (; i + Vec::size() <= len; i += Vec::size()) {
+    const Vec val = Vec::loadu(in + i);
+    // the number of boundaries that are not before the values
+    Vec after(input_t(0));
+    for (int64_t j = 0; j < n; j++) {
+      const Vec b(bd[j]);
+      after = Vec::blendv(after, after + one, right ? val < b : val <= b);
+    }
+    input_t counts[Vec::size()];
+    after.store(counts);
+    for (int64_t k = 0; k < Vec::size(); k++) {
+      out[i + k] = n - static_cast<int64_t>(counts[k]);
+    }
+  }
+  batched_search<right>(bd, n, in + i, out + i, len - i);
+}
+
+template <bool right, typename input_t, typename output_t>
+void searchsorted_cpu_contiguous(Tensor& result, const Tensor& input, const Tensor& boundaries) {
+  int64_t numel_in = input.numel();
+  bool is_scalar_input = input.dim() == 0 && numel_in == 1;
+  // inner most dim size of input and boundaries
+  int64_t idim_in = is_scalar_input ? 1 : input.sizes().back();
+  int64_t idim_bd = boundaries.sizes().back();
+
+  const input_t *data_in = input.data_ptr<input_t>();
+  const input_t *data_bd = boundaries.data_ptr<input_t>();
+  output_t *data_out = result.data_ptr<output_t>();
+
+  bool is_1d_boundaries = boundaries.dim() == 1;
+  const bool use_linear_search = idim_bd <= linear_search_max_boundaries<input_t>();
+  at::parallel_for(0, numel_in, SEARCHSORTED_GRAIN_SIZE, [&](int64_t start, int64_t end) {
+    // The values are searched in runs that share their boundaries: a single
+    // run if boundaries tensor is 1d, and the part of each row otherwise.
+    for (int64_t i = start; i < end;) {
+      const int64_t row = is_1d_boundaries ? 0 : i / idim_in;
+      const int64_t run_end = is_1d_boundaries ? end : std::min(end, (row + 1) * idim_in);
+      const input_t *data_bd_start = data_bd + row * idim_bd;
+      if (use_linear_search) {
+        linear_search<right>(data_bd_start, idim_bd, data_in + i, data_out + i, run_end - i);
+      } else {
+        batched_search<right>(data_bd_start, idim_bd, data_in + i, data_out + i, run_end - i);
+      }
+      i = run_end;
+    }
+  });
+}
+
+template <typename input_t, typename output_t>
+void searchsorted_cpu_dispatch_right(Tensor& result, const Tensor& input, const Tensor& boundaries, bool right) {
+  if (right) {
+    searchsorted_cpu_contiguous<true, input_t, output_t>(result, input, boundaries);
+  } else {
+    searchsorted_cpu_contiguous<false, input_t, output_t>(result, input, boundaries);
+  }
+}
+
+void searchsorted_kernel(Tensor& result, const Tensor& input, const Tensor& boundaries, bool out_int32, bool right) {
+  if (!out_int32) {
+    AT_DISPATCH_ALL_TYPES(input.scalar_type(), "searchsorted_out_cpu", [&] {
+      searchsorted_cpu_dispatch_right<scalar_t, int64_t>(result, input, boundaries, right);
+    });
+  }
+  else {
+    AT_DISPATCH_ALL_TYPES(input.scalar_type(), "searchsorted_out_cpu", [&] {
+      searchsorted_cpu_dispatch_right<scalar_t, int>(result, input, boundaries, right);
+    });
+  }
+}
+
+} // namespace
+
+REGISTER_DISPATCH(searchsorted_stub, &searchsorted_kernel);
+
+} // namespace native
+} // namespace at
@@ -1,26 +1,30 @@
 #include <ATen/ATen.h>
 
-#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/cpu/CatKernel.h>
-#include <ATen/cpu/vec256/functional.h>
-#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+#include <cstring>
 
 namespace at { namespace native {
 
 namespace {
 
+// An input fills a block of inner_bytes at col_offset in every one of the
+// `outer` rows of the result.
 struct InputMeta {
-  void* data_ptr;
-  int64_t inner_size;
-
-  InputMeta(const Tensor& t, int64_t dim, int64_t inner)
-    : data_ptr(t.data_ptr())
-    , inner_size(t.size(dim) * inner) {}
+  const char* data_ptr;
+  int64_t inner_bytes;
+  int64_t col_offset;
 };
 
-template <typename scalar_t>
-void cat_serial_kernel_impl(Tensor& result, TensorList tensors, int64_t dim) {
-  auto size = result.sizes().vec();
+// The result is split across threads by ranges of bytes, independently of
+// the sizes of the inputs, so that many small inputs and a few large ones are
+// balanced alike. A range starts at the input found by a binary search over
+// the offsets, and is then copied with one memcpy per block of an input.
+void cat_contiguous_kernel(Tensor& result, TensorList tensors, int64_t dim) {
+  auto size = result.sizes();
+  const int64_t elem_size = result.element_size();
   int64_t outer = 1, inner = 1;
   for (int64_t i = 0; i < dim; i++) {
     outer *= size[i];
@@ -28,48 +32,44 @@ void cat_serial_kernel_impl(Tensor& result, TensorList tensors, int64_t dim) {
   for (int64_t i = dim + 1; i < size.size(); i++) {
     inner *= size[i];
   }
-  scalar_t* result_data = result.data_ptr<scalar_t>();
-  int64_t ninputs = tensors.size();
   std::vector<InputMeta> inputs;
-  inputs.reserve(ninputs);
+  inputs.reserve(tensors.size());
+  int64_t row_bytes = 0;
   for (auto const &tensor : tensors) {
-    inputs.emplace_back(tensor, dim, inner);
+    const int64_t inner_bytes = tensor.size(dim) * inner * elem_size;
+    inputs.push_back({static_cast<const char*>(tensor.data_ptr()), inner_bytes, row_bytes});
+    row_bytes += inner_bytes;
   }
- 
-  using Vec = vec256::Vec256<scalar_t>;
-  int64_t offset = 0;
-  for (int64_t i = 0; i < outer; i++) {
-    for (int64_t j = 0; j < ninputs; j++) {
-      scalar_t* result_ptr = result_data + offset;
-      int64_t local_inner = inputs[j].inner_size;
-      scalar_t* input_ptr = (scalar_t*)(inputs[j].data_ptr) + i * local_inner;
-      if (local_inner < Vec::size()) {
-        #ifndef _MSC_VER
-        # pragma unroll
-        #endif
-        for (int64_t k = 0; k < local_inner; k++) {
-          result_ptr[k] = input_ptr[k];
-        }
-      } else {
-        vec256::map(
-            [](Vec x) { return x; },
-            result_ptr,
-            input_ptr,
-            local_inner);
-      }
-      offset += local_inner;
-    }
+  if (inputs.empty() || outer * row_bytes == 0) {
+    return;
   }
-}
 
-void cat_serial_kernel(Tensor& result, TensorList tensors, int64_t dim) {
-  AT_DISPATCH_FLOATING_TYPES(result.scalar_type(), "cat_serial_kernel", [&]() {
-    cat_serial_kernel_impl<scalar_t>(result, tensors, dim);
+  char* result_data = static_cast<char*>(result.data_ptr());
+  const int64_t ninputs = inputs.size();
+  at::parallel_for(0, outer * row_bytes, internal::GRAIN_SIZE * elem_size, [&](int64_t begin, int64_t end) {
+    int64_t i = begin / row_bytes;
+    int64_t pos = begin - i * row_bytes;
+    int64_t j = std::upper_bound(
+        inputs.begin(), inputs.end(), pos,
+        [](int64_t p, const InputMeta& input) { return p < input.col_offset; }) - inputs.begin() - 1;
+    while (begin < end) {
+      const InputMeta& input = inputs[j];
+      const int64_t input_pos = pos - input.col_offset;
+      const int64_t n = std::min(input.inner_bytes - input_pos, end - begin);
+      std::memcpy(result_data + begin, input.data_ptr + i * input.inner_bytes + input_pos, n);
+      begin += n;
+      pos += n;
+      if (pos == input.col_offset + input.inner_bytes && ++j == ninputs) {
+        j = 0;
+        pos = 0;
+        i++;
+      }
+    }
   });
 }
 
 } // anonymous namespace
 
-REGISTER_DISPATCH(cat_serial_stub, &cat_serial_kernel);
+REGISTER_DISPATCH(cat_contiguous_stub, &cat_contiguous_kernel);
 
 }} // at::native
@@ -1,18 +1,253 @@
 #include <ATen/ATen.h>
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 #include <c10/util/TypeCast.h>
 
+#include <algorithm>
+#include <cstdint>
+
 namespace at {
 namespace native {
 namespace {
 
+// Permuted copies, like permute(...).contiguous() or NCHW <-> NHWC, where the
+// output is contiguous along one dimension of the iterator and the input
+// along another one, are copied by tiles of both dimensions, so that the
+// reads and the writes of a tile stay in cache. The tiles are split across
+// threads, and transposed by blocks of 8x8 elements in registers when the
+// elements have 2 or 4 bytes.
+constexpr int64_t kPermuteTileSize = 64;
+constexpr int64_t kPermuteMinSize = 60 * 60;
+
+// Transposes the 8x8 block of src, whose rows are ld_src elements apart, into
+// dst, whose rows are ld_dst elements apart.
+template <typename T>
+inline void transpose_block_8x8(const T* src, int64_t ld_src, T* dst, int64_t ld_dst) {
+  for (int64_t r = 0; r < 8; r++) {
+    for (int64_t c = 0; c < 8; c++) {
+      dst[r * ld_dst + c] = src[c * ld_src + r];
+    }
+  }
+}
+
+#if defined(CPU_CAPABILITY_AVX2) && !defined(_MSC_VER)
+
+template <>
+inline void transpose_block_8x8<uint32_t>(
+    const uint32_t* src, int64_t ld_src, uint32_t* dst, int64_t ld_dst) {
+  // the elements are only moved, so any 4 byte type goes through floats
+  const float* s = reinterpret_cast<const float*>(src);
+  float* d = reinterpret_cast<float*>(dst);
+  __m256 r0 = _mm256_loadu_ps(s + 0 * ld_src);
+  __m256 r1 = _mm256_loadu_ps(s + 1 * ld_src);
+  __m256 r2 = _mm256_loadu_ps(s + 2 * ld_src);
+  __m256 r3 = _mm256_loadu_ps(s + 3 * ld_src);
+  __m256 r4 = _mm256_loadu_ps(s + 4 * ld_src);
+  __m256 r5 = _mm256_loadu_ps(s + 5 * ld_src);
+  __m256 r6 = _mm256_loadu_ps(s + 6 * ld_src);
+  __m256 r7 = _mm256_loadu_ps(s + 7 * ld_src);
+  __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+  __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+  __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+  __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+  __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+  __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+  __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+  __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+  r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  r4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  r5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  r6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  r7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+  _mm256_storeu_ps(d + 0 * ld_dst, _mm256_permute2f128_ps(r0, r4, 0x20));
+  _mm256_storeu_ps(d + 1 * ld_dst, _mm256_permute2f128_ps(r1, r5, 0x20));
+  _mm256_storeu_ps(d + 2 * ld_dst, _mm256_permute2f128_ps(r2, r6, 0x20));
+  _mm256_storeu_ps(d + 3 * ld_dst, _mm256_permute2f128_ps(r3, r7, 0x20));
+  _mm256_storeu_ps(d + 4 * ld_dst, _mm256_permute2f128_ps(r0, r4, 0x31));
+  _mm256_storeu_ps(d + 5 * ld_dst, _mm256_permute2f128_ps(r1, r5, 0x31));
+  _mm256_storeu_ps(d + 6 * ld_dst, _mm256_permute2f128_ps(r2, r6, 0x31));
+  _mm256_storeu_ps(d + 7 * ld_dst, _mm256_permute2f128_ps(r3, r7, 0x31));
+}
+
+template <>
+inline void transpose_block_8x8<uint16_t>(
+    const uint16_t* src, int64_t ld_src, uint16_t* dst, int64_t ld_dst) {
+  auto load = [&](int64_t r) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + r * ld_src));
+  };
+  auto store = [&](int64_t r, __m128i v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + r * ld_dst), v);
+  };
+  const __m128i a0 = load(0), a1 = load(1), a2 = load(2), a3 = load(3);
+  const __m128i a4 = load(4), a5 = load(5), a6 = load(6), a7 = load(7);
+  const __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+  const __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+  const __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+  const __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+  const __m128i b4 = _mm_unpacklo_epi16(a4, a5);
+  const __m128i b5 = _mm_unpackhi_epi16(a4, a5);
+  const __m128i b6 = _mm_unpacklo_epi16(a6, a7);
+  const __m128i b7 = _mm_unpackhi_epi16(a6, a7);
+  const __m128i c0 = _mm_unpacklo_epi32(b0, b2);
+  const __m128i c1 = _mm_unpackhi_epi32(b0, b2);
+  const __m128i c2 = _mm_unpacklo_epi32(b1, b3);
+  const __m128i c3 = _mm_unpackhi_epi32(b1, b3);
+  const __m128i c4 = _mm_unpacklo_epi32(b4, b6);
+  const __m128i c5 = _mm_unpackhi_epi32(b4, b6);
+  const __m128i c6 = _mm_unpacklo_epi32(b5, b7);
+  const __m128i c7 = _mm_unpackhi_epi32(b5, b7);
+  store(0, _mm_unpacklo_epi64(c0, c4));
+  store(1, _mm_unpackhi_epi64(c0, c4));
+  store(2, _mm_unpacklo_epi64(c1, c5));
+  store(3, _mm_unpackhi_epi64(c1, c5));
+  store(4, _mm_unpacklo_epi64(c2, c6));
+  store(5, _mm_unpackhi_epi64(c2, c6));
+  store(6, _mm_unpacklo_epi64(c3, c7));
+  store(7, _mm_unpackhi_epi64(c3, c7));
+}
+
+#endif
+
+// Copies the tile of src with n_in rows, ld_src elements apart, and n_out
+// contiguous columns into dst, transposed.
+template <typename T>
+void transpose_tile(const T* src, int64_t ld_src, T* dst, int64_t ld_dst,
+                    int64_t n_in, int64_t n_out) {
+  int64_t r = 0;
+  for (; r + 8 <= n_out; r += 8) {
+    int64_t c = 0;
+    for (; c + 8 <= n_in; c += 8) {
+      transpose_block_8x8(src + c * ld_src + r, ld_src, dst + r * ld_dst + c, ld_dst);
+    }
+    for (int64_t rr = r; rr < r + 8; rr++) {
+      for (int64_t cc = c; cc < n_in; cc++) {
+        dst[rr * ld_dst + cc] = src[cc * ld_src + rr];
+      }
+    }
+  }
+  for (; r < n_out; r++) {
+    for (int64_t c = 0; c < n_in; c++) {
+      dst[r * ld_dst + c] = src[c * ld_src + r];
+    }
+  }
+}
+
+// Tries the tiled copy of a same type copy, and returns false when the
+// iterator isn't a permuted copy.
+template <typename T>
+bool permute_copy(TensorIterator& iter) {
+  const int64_t ndim = iter.ndim();
+  const auto shape = iter.shape();
+  const auto out_strides = iter.strides(0);
+  const auto in_strides = iter.strides(1);
+  constexpr int64_t es = sizeof(T);
+  // the iterator puts the dimension the output is contiguous along first
+  if (ndim < 2 || iter.numel() < kPermuteMinSize ||
+      out_strides[0] != es || in_strides[0] == es || shape[0] < 8) {
+    return false;
+  }
+  int64_t k = 1;
+  while (k < ndim && in_strides[k] != es) {
+    k++;
+  }
+  if (k == ndim || shape[k] < 8) {
+    return false;
+  }
+
+  const int64_t tiles_out = divup(shape[k], kPermuteTileSize);
+  const int64_t tiles_in = divup(shape[0], kPermuteTileSize);
+  const int64_t outer = iter.numel() / (shape[0] * shape[k]);
+  char* out_data = static_cast<char*>(iter.data_ptr(0));
+  const char* in_data = static_cast<const char*>(iter.data_ptr(1));
+  const int64_t grain_size = std::max<int64_t>(
+      internal::GRAIN_SIZE / (kPermuteTileSize * kPermuteTileSize), 1);
+  at::parallel_for(0, outer * tiles_out * tiles_in, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t w = begin; w < end; w++) {
+      const int64_t tile_in = w % tiles_in;
+      const int64_t tile_out = (w / tiles_in) % tiles_out;
+      int64_t o = w / (tiles_in * tiles_out);
+      int64_t out_offset = 0;
+      int64_t in_offset = 0;
+      for (int64_t d = 1; d < ndim; d++) {
+        if (d == k) {
+          continue;
+        }
+        const int64_t i = o % shape[d];
+        o /= shape[d];
+        out_offset += i * out_strides[d];
+        in_offset += i * in_strides[d];
+      }
+      const int64_t begin_in = tile_in * kPermuteTileSize;
+      const int64_t begin_out = tile_out * kPermuteTileSize;
+      out_offset += begin_in * es + begin_out * out_strides[k];
+      in_offset += begin_in * in_strides[0] + begin_out * es;
+      transpose_tile(
+          reinterpret_cast<const T*>(in_data + in_offset), in_strides[0] / es,
+          reinterpret_cast<T*>(out_data + out_offset), out_strides[k] / es,
+          std::min(kPermuteTileSize, shape[0] - begin_in),
+          std::min(kPermuteTileSize, shape[k] - begin_out));
+    }
+  });
+  return true;
+}
+
+bool try_permute_copy(TensorIterator& iter) {
+  for (int64_t d = 0; d < iter.ndim(); d++) {
+    // the strides of a tile are in elements
+    if (iter.strides(0)[d] % iter.element_size(0) != 0 ||
+        iter.strides(1)[d] % iter.element_size(1) != 0) {
+      return false;
+    }
+  }
+  switch (iter.element_size(0)) {
+    case 1:
+      return permute_copy<uint8_t>(iter);
+    case 2:
+      return permute_copy<uint16_t>(iter);
+    case 4:
+      return permute_copy<uint32_t>(iter);
+    case 8:
+      return permute_copy<uint64_t>(iter);
+    default:
+      return false;
+  }
+}
+
+// Half <-> float copies, e.g. when loading fp16 weights, convert contiguous
+// runs with vec256::convert, which uses F16C where available, instead of one
+// software conversion per element.
+template <typename dest_t, typename src_t>
+void convert_copy(TensorIterator& iter) {
+  iter.for_each([](char** data, const int64_t* strides, int64_t n) {
+    if (strides[0] == sizeof(dest_t) && strides[1] == sizeof(src_t)) {
+      vec256::convert(
+          reinterpret_cast<const src_t*>(data[1]),
+          reinterpret_cast<dest_t*>(data[0]),
+          n);
+      return;
+    }
+    for (int64_t i = 0; i < n; i++) {
+      *reinterpret_cast<dest_t*>(data[0] + i * strides[0]) = static_cast<dest_t>(
+          *reinterpret_cast<const src_t*>(data[1] + i * strides[1]));
+    }
+  });
+}
+
 static void copy_kernel(TensorIterator& iter, bool non_blocking) {
   ScalarType dtype = iter.dtype(0);
   if (dtype == iter.dtype(1)) {
+    if (try_permute_copy(iter)) {
+      return;
+    }
     if (dtype == ScalarType::Half) {
       cpu_kernel(iter, [=](at::Half a) -> at::Half { return a; });
     } else if (dtype == ScalarType::BFloat16) {
@@ -39,6 +274,10 @@ static void copy_kernel(TensorIterator& iter, bool non_blocking) {
                 [=](Vec256<scalar_t> a) { return a; });
           });
     }
+  } else if (dtype == ScalarType::Float && iter.dtype(1) == ScalarType::Half) {
+    convert_copy<float, at::Half>(iter);
+  } else if (dtype == ScalarType::Half && iter.dtype(1) == ScalarType::Float) {
+    convert_copy<at::Half, float>(iter);
   } else {
     AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(ScalarType::Half, ScalarType::Bool, ScalarType::BFloat16, dtype, "copy_", [&] {
       using dest_t = scalar_t;
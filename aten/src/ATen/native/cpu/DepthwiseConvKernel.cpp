@@ -1,6 +1,14 @@
 #include <ATen/native/cpu/DepthwiseConvKernel.h>
 #include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 #ifdef __ARM_NEON__
 #include <arm_neon.h>
@@ -297,9 +305,322 @@ Tensor _convolution_depthwise3x3_winograd(
   return output;
 }
 
+// The geometry of a direct grouped convolution. Output column ow reads input
+// column ow * stride_w - pad_w + kw * dilation_w for kernel column kw, and
+// likewise for rows.
+struct DirectConv2dGeometry {
+  int64_t batch;
+  int64_t channels;
+  int64_t height;
+  int64_t width;
+  int64_t out_channels;
+  int64_t out_height;
+  int64_t out_width;
+  int64_t groups;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t pad_h;
+  int64_t pad_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+
+  DirectConv2dGeometry(
+      IntArrayRef input_sizes,
+      IntArrayRef output_sizes,
+      IntArrayRef weight_sizes,
+      IntArrayRef stride,
+      IntArrayRef padding,
+      IntArrayRef dilation,
+      int64_t groups)
+      : batch(input_sizes[0]),
+        channels(input_sizes[1]),
+        height(input_sizes[2]),
+        width(input_sizes[3]),
+        out_channels(output_sizes[1]),
+        out_height(output_sizes[2]),
+        out_width(output_sizes[3]),
+        groups(groups),
+        kernel_h(weight_sizes[2]),
+        kernel_w(weight_sizes[3]),
+        stride_h(stride[0]),
+        stride_w(stride[1]),
+        pad_h(padding[0]),
+        pad_w(padding[1]),
+        dilation_h(dilation[0]),
+        dilation_w(dilation[1]) {}
+
+  int64_t in_channels_per_group() const {
+    return channels / groups;
+  }
+
+  int64_t out_channels_per_group() const {
+    return out_channels / groups;
+  }
+
+  // The input row of output row oh and kernel row kh, or -1 if it is padding.
+  int64_t input_row(int64_t oh, int64_t kh) const {
+    const int64_t ih = oh * stride_h - pad_h + kh * dilation_h;
+    return ih >= 0 && ih < height ? ih : -1;
+  }
+
+  // The output columns [begin, end) whose input column for kernel column kw
+  // is inside the input.
+  std::pair<int64_t, int64_t> valid_columns(int64_t kw) const {
+    const int64_t offset = kw * dilation_w - pad_w;
+    const int64_t begin = offset >= 0 ? 0 : (-offset + stride_w - 1) / stride_w;
+    const int64_t end = offset >= width
+        ? 0
+        : std::min(out_width, (width - offset - 1) / stride_w + 1);
+    return {std::min(begin, end), end};
+  }
+
+  int64_t input_column(int64_t ow, int64_t kw) const {
+    return ow * stride_w - pad_w + kw * dilation_w;
+  }
+};
+
+// y[i * incy] += a * x[i * incx] for i in [0, n)
+template <typename scalar_t>
+inline void axpy(
+    int64_t n, scalar_t a, const scalar_t* x, int64_t incx, scalar_t* y, int64_t incy) {
+  if (incx == 1 && incy == 1) {
+    using Vec = vec256::Vec256<scalar_t>;
+    const Vec a_vec(a);
+    int64_t i = 0;
+    for (; i + Vec::size() <= n; i += Vec::size()) {
+      vec256::fmadd(a_vec, Vec::loadu(x + i), Vec::loadu(y + i)).store(y + i);
+    }
+    for (; i < n; i++) {
+      y[i] += a * x[i];
+    }
+  } else {
+    for (int64_t i = 0; i < n; i++) {
+      y[i * incy] += a * x[i * incx];
+    }
+  }
+}
+
+// The sum of x[i] * y[i * incy] for i in [0, n)
+template <typename scalar_t>
+inline scalar_t dot(int64_t n, const scalar_t* x, const scalar_t* y, int64_t incy) {
+  scalar_t sum = 0;
+  int64_t i = 0;
+  if (incy == 1) {
+    using Vec = vec256::Vec256<scalar_t>;
+    Vec sum_vec(scalar_t(0));
+    for (; i + Vec::size() <= n; i += Vec::size()) {
+      sum_vec = vec256::fmadd(Vec::loadu(x + i), Vec::loadu(y + i), sum_vec);
+    }
+    sum = vec256::vec_reduce_all<scalar_t>(
+        [](Vec& a, Vec& b) { return a + b; }, sum_vec, Vec::size());
+  }
+  for (; i < n; i++) {
+    sum += x[i] * y[i * incy];
+  }
+  return sum;
+}
+
+// Every thread computes whole output planes. A row of an output plane is
+// accumulated from one input row per kernel tap, so it stays in cache while
+// all the taps of all the input channels of the group are added to it.
+template <typename scalar_t>
+void direct_grouped_conv2d_impl(
+    Tensor& output, const Tensor& input, const Tensor& weight,
+    const Tensor& bias, const DirectConv2dGeometry& g) {
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const scalar_t* weight_data = weight.data_ptr<scalar_t>();
+  const scalar_t* bias_data = bias.defined() ? bias.data_ptr<scalar_t>() : nullptr;
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  const int64_t in_plane = g.height * g.width;
+  const int64_t out_plane = g.out_height * g.out_width;
+  const int64_t kernel_plane = g.kernel_h * g.kernel_w;
+  const int64_t cpg = g.in_channels_per_group();
+  const int64_t ocpg = g.out_channels_per_group();
+  std::vector<std::pair<int64_t, int64_t>> columns(g.kernel_w);
+  for (int64_t kw = 0; kw < g.kernel_w; kw++) {
+    columns[kw] = g.valid_columns(kw);
+  }
+  const int64_t grain_size = std::max<int64_t>(
+      internal::GRAIN_SIZE / std::max<int64_t>(out_plane * cpg * kernel_plane, 1), 1);
+  at::parallel_for(0, g.batch * g.out_channels, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t k = begin; k < end; k++) {
+      const int64_t n = k / g.out_channels;
+      const int64_t oc = k % g.out_channels;
+      const int64_t group = oc / ocpg;
+      scalar_t* out_p = output_data + k * out_plane;
+      std::fill(out_p, out_p + out_plane, bias_data ? bias_data[oc] : scalar_t(0));
+      for (int64_t oh = 0; oh < g.out_height; oh++) {
+        scalar_t* out_row = out_p + oh * g.out_width;
+        for (int64_t icl = 0; icl < cpg; icl++) {
+          const scalar_t* in_p = input_data + (n * g.channels + group * cpg + icl) * in_plane;
+          const scalar_t* w_p = weight_data + (oc * cpg + icl) * kernel_plane;
+          for (int64_t kh = 0; kh < g.kernel_h; kh++) {
+            const int64_t ih = g.input_row(oh, kh);
+            if (ih < 0) {
+              continue;
+            }
+            for (int64_t kw = 0; kw < g.kernel_w; kw++) {
+              const int64_t ow_begin = columns[kw].first;
+              const int64_t ow_end = columns[kw].second;
+              axpy(ow_end - ow_begin, w_p[kh * g.kernel_w + kw],
+                   in_p + ih * g.width + g.input_column(ow_begin, kw), g.stride_w,
+                   out_row + ow_begin, 1);
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+// Every thread computes whole input gradient planes, scattering the output
+// gradient rows of the output channels that read the plane.
+template <typename scalar_t>
+void direct_grouped_conv2d_backward_input_impl(
+    Tensor& grad_input, const Tensor& grad_output, const Tensor& weight,
+    const DirectConv2dGeometry& g) {
+  const scalar_t* grad_output_data = grad_output.data_ptr<scalar_t>();
+  const scalar_t* weight_data = weight.data_ptr<scalar_t>();
+  scalar_t* grad_input_data = grad_input.data_ptr<scalar_t>();
+  const int64_t in_plane = g.height * g.width;
+  const int64_t out_plane = g.out_height * g.out_width;
+  const int64_t kernel_plane = g.kernel_h * g.kernel_w;
+  const int64_t cpg = g.in_channels_per_group();
+  const int64_t ocpg = g.out_channels_per_group();
+  std::vector<std::pair<int64_t, int64_t>> columns(g.kernel_w);
+  for (int64_t kw = 0; kw < g.kernel_w; kw++) {
+    columns[kw] = g.valid_columns(kw);
+  }
+  const int64_t grain_size = std::max<int64_t>(
+      internal::GRAIN_SIZE / std::max<int64_t>(out_plane * ocpg * kernel_plane, 1), 1);
+  at::parallel_for(0, g.batch * g.channels, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t k = begin; k < end; k++) {
+      const int64_t n = k / g.channels;
+      const int64_t ic = k % g.channels;
+      const int64_t group = ic / cpg;
+      const int64_t icl = ic % cpg;
+      scalar_t* grad_in_p = grad_input_data + k * in_plane;
+      std::fill(grad_in_p, grad_in_p + in_plane, scalar_t(0));
+      for (int64_t j = 0; j < ocpg; j++) {
+        const int64_t oc = group * ocpg + j;
+        const scalar_t* grad_out_p = grad_output_data + (n * g.out_channels + oc) * out_plane;
+        const scalar_t* w_p = weight_data + (oc * cpg + icl) * kernel_plane;
+        for (int64_t oh = 0; oh < g.out_height; oh++) {
+          const scalar_t* grad_out_row = grad_out_p + oh * g.out_width;
+          for (int64_t kh = 0; kh < g.kernel_h; kh++) {
+            const int64_t ih = g.input_row(oh, kh);
+            if (ih < 0) {
+              continue;
+            }
+            for (int64_t kw = 0; kw < g.kernel_w; kw++) {
+              const int64_t ow_begin = columns[kw].first;
+              const int64_t ow_end = columns[kw].second;
+              axpy(ow_end - ow_begin, w_p[kh * g.kernel_w + kw],
+                   grad_out_row + ow_begin, 1,
+                   grad_in_p + ih * g.width + g.input_column(ow_begin, kw), g.stride_w);
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+// Every thread computes the weight gradient of whole output channels,
+// accumulating the dot products of output gradient rows with input rows over
+// the batch in the accumulate type.
+template <typename scalar_t>
+void direct_grouped_conv2d_backward_weight_impl(
+    Tensor& grad_weight, const Tensor& grad_output, const Tensor& input,
+    const DirectConv2dGeometry& g) {
+  using acc_t = at::acc_type<scalar_t, /*is_cuda=*/false>;
+  const scalar_t* grad_output_data = grad_output.data_ptr<scalar_t>();
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  scalar_t* grad_weight_data = grad_weight.data_ptr<scalar_t>();
+  const int64_t in_plane = g.height * g.width;
+  const int64_t out_plane = g.out_height * g.out_width;
+  const int64_t kernel_plane = g.kernel_h * g.kernel_w;
+  const int64_t cpg = g.in_channels_per_group();
+  const int64_t ocpg = g.out_channels_per_group();
+  std::vector<std::pair<int64_t, int64_t>> columns(g.kernel_w);
+  for (int64_t kw = 0; kw < g.kernel_w; kw++) {
+    columns[kw] = g.valid_columns(kw);
+  }
+  const int64_t grain_size = std::max<int64_t>(
+      internal::GRAIN_SIZE /
+          std::max<int64_t>(g.batch * out_plane * cpg * kernel_plane, 1),
+      1);
+  at::parallel_for(0, g.out_channels, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<acc_t> acc(cpg * kernel_plane);
+    for (int64_t oc = begin; oc < end; oc++) {
+      const int64_t group = oc / ocpg;
+      std::fill(acc.begin(), acc.end(), acc_t(0));
+      for (int64_t n = 0; n < g.batch; n++) {
+        const scalar_t* grad_out_p = grad_output_data + (n * g.out_channels + oc) * out_plane;
+        for (int64_t icl = 0; icl < cpg; icl++) {
+          const scalar_t* in_p = input_data + (n * g.channels + group * cpg + icl) * in_plane;
+          acc_t* acc_p = acc.data() + icl * kernel_plane;
+          for (int64_t oh = 0; oh < g.out_height; oh++) {
+            const scalar_t* grad_out_row = grad_out_p + oh * g.out_width;
+            for (int64_t kh = 0; kh < g.kernel_h; kh++) {
+              const int64_t ih = g.input_row(oh, kh);
+              if (ih < 0) {
+                continue;
+              }
+              for (int64_t kw = 0; kw < g.kernel_w; kw++) {
+                const int64_t ow_begin = columns[kw].first;
+                const int64_t ow_end = columns[kw].second;
+                acc_p[kh * g.kernel_w + kw] += dot(
+                    ow_end - ow_begin, grad_out_row + ow_begin,
+                    in_p + ih * g.width + g.input_column(ow_begin, kw), g.stride_w);
+              }
+            }
+          }
+        }
+      }
+      std::copy(acc.begin(), acc.end(), grad_weight_data + oc * cpg * kernel_plane);
+    }
+  });
+}
+
+void direct_grouped_conv2d_kernel(
+    Tensor& output, const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  const DirectConv2dGeometry g(
+      input.sizes(), output.sizes(), weight.sizes(), stride, padding, dilation, groups);
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "direct_grouped_conv2d", [&] {
+    direct_grouped_conv2d_impl<scalar_t>(output, input, weight, bias, g);
+  });
+}
+
+void direct_grouped_conv2d_backward_input_kernel(
+    Tensor& grad_input, const Tensor& grad_output, const Tensor& weight,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  const DirectConv2dGeometry g(
+      grad_input.sizes(), grad_output.sizes(), weight.sizes(), stride, padding, dilation, groups);
+  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "direct_grouped_conv2d_backward_input", [&] {
+    direct_grouped_conv2d_backward_input_impl<scalar_t>(grad_input, grad_output, weight, g);
+  });
+}
+
+void direct_grouped_conv2d_backward_weight_kernel(
+    Tensor& grad_weight, const Tensor& grad_output, const Tensor& input,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  const DirectConv2dGeometry g(
+      input.sizes(), grad_output.sizes(), grad_weight.sizes(), stride, padding, dilation, groups);
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "direct_grouped_conv2d_backward_weight", [&] {
+    direct_grouped_conv2d_backward_weight_impl<scalar_t>(grad_weight, grad_output, input, g);
+  });
+}
+
 }  // namespace
 
 REGISTER_DISPATCH(convolution_depthwise3x3_winograd_stub, &_convolution_depthwise3x3_winograd);
+REGISTER_DISPATCH(direct_grouped_conv2d_stub, &direct_grouped_conv2d_kernel);
+REGISTER_DISPATCH(direct_grouped_conv2d_backward_input_stub, &direct_grouped_conv2d_backward_input_kernel);
+REGISTER_DISPATCH(direct_grouped_conv2d_backward_weight_stub, &direct_grouped_conv2d_backward_weight_kernel);
 
 }  // namespace native
 }  // namespace at
@@ -15,5 +15,31 @@ using convolution_depthwise3x3_winograd_fn =
 
 DECLARE_DISPATCH(convolution_depthwise3x3_winograd_fn, convolution_depthwise3x3_winograd_stub);
 
+/*
+  Direct 2d convolution of groups with few input channels each, without
+  im2col. Each output plane is accumulated from shifted rows of the input
+  planes of its group, vectorized along the rows when the stride is 1. It is
+  the CPU kernel of thnn_conv_depthwise2d (groups == input channels) and of
+  grouped convolutions that don't need autograd. The tensors are contiguous
+  NCHW tensors, and the outputs have their final sizes.
+*/
+
+// (output, input, weight, bias, stride, padding, dilation, groups)
+using direct_grouped_conv2d_fn = void (*)(
+    Tensor&, const Tensor&, const Tensor&, const Tensor&,
+    IntArrayRef, IntArrayRef, IntArrayRef, int64_t);
+// (grad_input, grad_output, weight, stride, padding, dilation, groups)
+using direct_grouped_conv2d_backward_input_fn = void (*)(
+    Tensor&, const Tensor&, const Tensor&,
+    IntArrayRef, IntArrayRef, IntArrayRef, int64_t);
+// (grad_weight, grad_output, input, stride, padding, dilation, groups)
+using direct_grouped_conv2d_backward_weight_fn = void (*)(
+    Tensor&, const Tensor&, const Tensor&,
+    IntArrayRef, IntArrayRef, IntArrayRef, int64_t);
+
+DECLARE_DISPATCH(direct_grouped_conv2d_fn, direct_grouped_conv2d_stub);
+DECLARE_DISPATCH(direct_grouped_conv2d_backward_input_fn, direct_grouped_conv2d_backward_input_stub);
+DECLARE_DISPATCH(direct_grouped_conv2d_backward_weight_fn, direct_grouped_conv2d_backward_weight_stub);
+
 }  // namespace native
 }  // namespace at
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/core/DistributionsHelper.h>
+#include <ATen/core/PhiloxRNGEngine.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
+#include <algorithm>
 #include <limits>
 #include <mutex>
 
@@ -18,15 +21,102 @@ namespace templates {
 namespace cpu {
 namespace {
 
+// ============================================== Parallel generation =================================================
+
+// Large tensors are generated in parallel from counter-based Philox streams:
+// the elements are split in chunks of kRandomChunkSize, and every chunk draws
+// from the substream of its index under a Philox key taken from the
+// generator. The values don't depend on the number of threads, and the
+// generator only advances by the key, so that its state still determines all
+// the values that follow and needs nothing more to be saved and restored.
+// Smaller tensors keep drawing from the generator itself.
+constexpr int64_t kRandomChunkSize = 16384;
+constexpr int64_t kParallelRandomMinSize = 4 * kRandomChunkSize;
+
+// Draws from one Philox substream, with the interface the distributions of
+// DistributionsHelper.h expect from a generator.
+struct PhiloxSubstream {
+  PhiloxSubstream(uint64_t key, uint64_t subsequence) : engine_(key, subsequence) {}
+
+  uint32_t random() {
+    return engine_();
+  }
+  uint64_t random64() {
+    const uint64_t hi = engine_();
+    return (hi << 32) | engine_();
+  }
+  c10::optional<float> next_float_normal_sample() {
+    return next_float_normal_sample_;
+  }
+  c10::optional<double> next_double_normal_sample() {
+    return next_double_normal_sample_;
+  }
+  void set_next_float_normal_sample(c10::optional<float> randn) {
+    next_float_normal_sample_ = randn;
+  }
+  void set_next_double_normal_sample(c10::optional<double> randn) {
+    next_double_normal_sample_ = randn;
+  }
+
+ private:
+  at::philox_engine engine_;
+  c10::optional<float> next_float_normal_sample_;
+  c10::optional<double> next_double_normal_sample_;
+};
+
+template<typename RNG>
+uint64_t philox_key(RNG generator) {
+  // See Note [Acquire lock when using random generators]
+  std::lock_guard<std::mutex> lock(generator->mutex_);
+  return generator->random64();
+}
+
+// Calls f(i, n) for every chunk [begin, begin + n) of [0, numel) across
+// threads, where begin is i * kRandomChunkSize; the last chunk takes the
+// remainder, so that every chunk has at least kRandomChunkSize elements.
+template<typename func_t>
+void for_each_random_chunk(int64_t numel, const func_t& f) {
+  const int64_t num_chunks = std::max<int64_t>(numel / kRandomChunkSize, 1);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      const int64_t n = c == num_chunks - 1 ? numel - c * kRandomChunkSize : kRandomChunkSize;
+      f(c, n);
+    }
+  });
+}
+
+// Fills the output of the nullary iter with sample(gen), where gen is the
+// generator or a Philox substream of it.
+template<typename scalar_t, typename RNG, typename sample_t>
+void random_nullary_kernel(TensorIterator& iter, RNG generator, const sample_t& sample) {
+  const int64_t numel = iter.numel();
+  if (numel < kParallelRandomMinSize) {
+    std::lock_guard<std::mutex> lock(generator->mutex_);
+    cpu_serial_kernel(iter, [&sample, generator]() -> scalar_t {
+      return sample(generator);
+    });
+    return;
+  }
+  const uint64_t key = philox_key(generator);
+  for_each_random_chunk(numel, [&](int64_t c, int64_t n) {
+    PhiloxSubstream substream(key, c);
+    const int64_t begin = c * kRandomChunkSize;
+    iter.serial_for_each([&](char** data, const int64_t* strides, int64_t size) {
+      for (int64_t i = 0; i < size; i++) {
+        *reinterpret_cast<scalar_t*>(data[0] + i * strides[0]) = sample(&substream);
+      }
+    }, {begin, begin + n});
+  });
+}
+
 // ==================================================== Random ========================================================
 
 template<typename RNG>
 void random_from_to_kernel(TensorIterator& iter, uint64_t range, int64_t base, RNG generator) {
   AT_DISPATCH_ALL_TYPES_AND3(at::ScalarType::Bool, at::ScalarType::Half, at::ScalarType::BFloat16, iter.dtype(), "random_from_to_kernel_cpu", [&] {
-    std::lock_guard<std::mutex> lock(generator->mutex_);
-    cpu_serial_kernel(iter, [range, base, generator]() -> scalar_t {
+    random_nullary_kernel<scalar_t>(iter, generator, [range, base](auto gen) -> scalar_t {
       uniform_int_from_to_distribution<scalar_t> random(range, base);
-      return random(generator);
+      return random(gen);
     });
   });
 }
@@ -37,14 +127,13 @@ void random_from_to_kernel(TensorIterator& iter, uint64_t range, int64_t base, R
 template<typename RNG>
 void random_full_64_bits_range_kernel(TensorIterator& iter, RNG generator) {
   AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::BFloat16, iter.dtype(), "random_full_64_bits_range_kernel_cpu", [&] {
-    std::lock_guard<std::mutex> lock(generator->mutex_);
     if (std::is_same<scalar_t, int64_t>::value ||
         std::is_same<scalar_t, double>::value ||
         std::is_same<scalar_t, float>::value ||
         std::is_same<scalar_t, at::BFloat16>::value) {
-      cpu_serial_kernel(iter, [generator]() -> scalar_t {
+      random_nullary_kernel<scalar_t>(iter, generator, [](auto gen) -> scalar_t {
         uniform_int_full_range_distribution<scalar_t> random;
-        return random(generator);
+        return random(gen);
       });
     } else {
       TORCH_CHECK(false, "random_full_64_bits_range_kernel_cpu handles only int64, double, float and bfloat16");
@@ -64,11 +153,10 @@ struct RandomFromToKernel {
 
 template<typename RNG>
 void random_kernel(TensorIterator& iter, RNG generator) {
-  std::lock_guard<std::mutex> lock(generator->mutex_);
   AT_DISPATCH_ALL_TYPES_AND3(at::ScalarType::Half, at::ScalarType::BFloat16, at::ScalarType::Bool, iter.dtype(), "random_kernel_cpu", [&] {
-    cpu_serial_kernel(iter, [generator]() -> scalar_t {
+    random_nullary_kernel<scalar_t>(iter, generator, [](auto gen) -> scalar_t {
       uniform_int_distribution<scalar_t> random;
-      return random(generator);
+      return random(gen);
     });
   });
 }
@@ -102,14 +190,12 @@ static void normal_fill_16_AVX2(float *data,
   _mm256_storeu_ps(data + 8, _mm256_fmadd_ps(n2, *std_v, *mean));
 }
 
+// Fills the size >= 16 elements of data from gen.
 template<typename RNG>
-void normal_fill_AVX2(Tensor& self, const float mean, const float std, RNG generator) {
-  float *data = self.data_ptr<float>();
-  auto size = self.numel();
-  std::lock_guard<std::mutex> lock(generator->mutex_);
+void normal_fill_AVX2(float *data, int64_t size, const float mean, const float std, RNG gen) {
   for (int64_t i = 0; i < size; ++i) {
     at::uniform_real_distribution<float> uniform(0, 1);
-    data[i] = uniform(generator);
+    data[i] = uniform(gen);
   }
   const __m256 two_pi = _mm256_set1_ps(2.0f * M_PI);
   const __m256 one = _mm256_set1_ps(1.0f);
@@ -126,7 +212,7 @@ void normal_fill_AVX2(Tensor& self, const float mean, const float std, RNG gener
     data = data + size - 16;
     for (int64_t i = 0; i < 16; ++i) {
       at::uniform_real_distribution<float> uniform(0, 1);
-      data[i] = uniform(generator);
+      data[i] = uniform(gen);
     }
     normal_fill_16_AVX2(data, &two_pi, &one, &minus_two, &mean_v, &std_v);
   }
@@ -145,14 +231,12 @@ static void normal_fill_16(scalar_t *data, const scalar_t mean, const scalar_t s
   }
 }
 
+// Fills the size >= 16 elements of data from gen.
 template <typename scalar_t, typename RNG>
-void normal_fill(Tensor& self, const scalar_t mean, const scalar_t std, RNG generator) {
-  scalar_t *data = self.data_ptr<scalar_t>();
-  auto size = self.numel();
-  std::lock_guard<std::mutex> lock(generator->mutex_);
+void normal_fill(scalar_t *data, int64_t size, const scalar_t mean, const scalar_t std, RNG gen) {
   for (int64_t i = 0; i < size; ++i) {
     at::uniform_real_distribution<scalar_t> uniform(0, 1);
-    data[i] = uniform(generator);
+    data[i] = uniform(gen);
   }
 
   for (int64_t i = 0; i < size - 15; i += 16) {
@@ -163,33 +247,54 @@ void normal_fill(Tensor& self, const scalar_t mean, const scalar_t std, RNG gene
     data = data + size - 16;
     for (int64_t i = 0; i < 16; ++i) {
       at::uniform_real_distribution<scalar_t> uniform(0, 1);
-      data[i] = uniform(generator);
+      data[i] = uniform(gen);
     }
     normal_fill_16<scalar_t>(data, mean, std);
   }
 }
 
+// Fills the contiguous self with at least 16 elements, chunk by chunk in
+// parallel when it is large.
+template <typename scalar_t, typename RNG, typename fill_t>
+void normal_fill_contiguous(Tensor& self, RNG generator, const fill_t& fill) {
+  scalar_t *data = self.data_ptr<scalar_t>();
+  const int64_t size = self.numel();
+  if (size < kParallelRandomMinSize) {
+    std::lock_guard<std::mutex> lock(generator->mutex_);
+    fill(data, size, generator);
+    return;
+  }
+  const uint64_t key = philox_key(generator);
+  for_each_random_chunk(size, [&](int64_t c, int64_t n) {
+    PhiloxSubstream substream(key, c);
+    fill(data + c * kRandomChunkSize, n, &substream);
+  });
+}
+
 template<typename RNG>
 void normal_kernel(Tensor& self, double mean, double std, RNG generator) {
   auto size = self.numel();
   if (self.scalar_type() == ScalarType::Float && size >= 16 && self.is_contiguous()) {
+    normal_fill_contiguous<float>(self, generator, [mean, std](float* data, int64_t n, auto gen) {
 #ifdef CPU_CAPABILITY_AVX2
-    normal_fill_AVX2(self, static_cast<float>(mean), static_cast<float>(std), generator);
+      normal_fill_AVX2(data, n, static_cast<float>(mean), static_cast<float>(std), gen);
 #else
-    normal_fill(self, static_cast<float>(mean), static_cast<float>(std), generator);
+      normal_fill(data, n, static_cast<float>(mean), static_cast<float>(std), gen);
 #endif
+    });
   } else {
     // bfloat16 cannot be properly tested due to the lack of other operations
     // like add/sub/mean implemented for half
     AT_DISPATCH_FLOATING_TYPES_AND_HALF(self.scalar_type(), "normal_kernel_cpu", [&] {
       if (size >= 16 && self.is_contiguous()) {
-        normal_fill<scalar_t>(self, static_cast<scalar_t>(mean), static_cast<scalar_t>(std), generator);
+        normal_fill_contiguous<scalar_t>(self, generator, [mean, std](scalar_t* data, int64_t n, auto gen) {
+          normal_fill<scalar_t>(data, n, static_cast<scalar_t>(mean), static_cast<scalar_t>(std), gen);
+        });
       } else {
         auto iter = TensorIterator::nullary_op(self);
-        std::lock_guard<std::mutex> lock(generator->mutex_);
-        cpu_serial_kernel(iter, [mean, std, generator]() -> scalar_t {
+        random_nullary_kernel<scalar_t>(iter, generator, [mean, std](auto gen) -> scalar_t {
           at::normal_distribution<double> normal(mean, std);
-          return (scalar_t)normal(generator);
+          return (scalar_t)normal(gen);
         });
       }
     });
@@ -208,10 +313,9 @@ struct NormalKernel {
 template<typename RNG>
 void uniform_kernel(TensorIterator& iter, double from, double to, RNG generator) {
   AT_DISPATCH_FLOATING_TYPES_AND_HALF(iter.dtype(), "uniform_kernel_cpu", [&]() {
-    std::lock_guard<std::mutex> lock(generator->mutex_);
     at::uniform_real_distribution<scalar_t> uniform(static_cast<scalar_t>(from), static_cast<scalar_t>(to));
-    cpu_serial_kernel(iter, [&uniform, generator]() -> scalar_t {
-      return static_cast<scalar_t>(uniform(generator));
+    random_nullary_kernel<scalar_t>(iter, generator, [&uniform](auto gen) -> scalar_t {
+      return static_cast<scalar_t>(uniform(gen));
     });
   });
 }
@@ -228,10 +332,9 @@ struct UniformKernel {
 template<typename RNG>
 void cauchy_kernel(TensorIterator& iter, double median, double sigma, RNG generator) {
   AT_DISPATCH_FLOATING_TYPES_AND_HALF(iter.dtype(), "cauchy_cpu", [&]() {
-    std::lock_guard<std::mutex> lock(generator->mutex_);
-    cpu_serial_kernel(iter, [median, sigma, generator]() -> scalar_t {
+    random_nullary_kernel<scalar_t>(iter, generator, [median, sigma](auto gen) -> scalar_t {
       at::cauchy_distribution<double> cauchy(median, sigma);
-      return (scalar_t)cauchy(generator);
+      return (scalar_t)cauchy(gen);
     });
   });
 }
@@ -248,10 +351,9 @@ struct CauchyKernel {
 template<typename RNG>
 void log_normal_kernel(TensorIterator& iter, double mean, double std, RNG generator) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "log_normal_cpu", [&]() {
-    std::lock_guard<std::mutex> lock(generator->mutex_);
-    cpu_serial_kernel(iter, [mean, std, generator]() -> scalar_t {
+    random_nullary_kernel<scalar_t>(iter, generator, [mean, std](auto gen) -> scalar_t {
       at::lognormal_distribution<double> logNormal(mean, std);
-      return static_cast<scalar_t>(logNormal(generator));
+      return static_cast<scalar_t>(logNormal(gen));
     });
   });
 }
@@ -268,10 +370,9 @@ struct LogNormalKernel {
 template<typename RNG>
 void geometric_kernel(TensorIterator& iter, double p, RNG generator) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "geometric_cpu", [&]() {
-    std::lock_guard<std::mutex> lock(generator->mutex_);
-    cpu_serial_kernel(iter, [p, generator]() -> scalar_t {
+    random_nullary_kernel<scalar_t>(iter, generator, [p](auto gen) -> scalar_t {
       at::geometric_distribution<double> geometric(p);
-      return (scalar_t)geometric(generator);
+      return (scalar_t)geometric(gen);
     });
   });
 }
@@ -288,10 +389,9 @@ struct GeometricKernel {
 template<typename RNG>
 void exponential_kernel(TensorIterator& iter, double lambda, RNG generator) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "exponential_cpu", [&]() {
-    std::lock_guard<std::mutex> lock(generator->mutex_);
     at::exponential_distribution<double> exponential(lambda);
-    cpu_serial_kernel(iter, [&exponential, generator]() -> scalar_t {
-      return static_cast<scalar_t>(exponential(generator));
+    random_nullary_kernel<scalar_t>(iter, generator, [&exponential](auto gen) -> scalar_t {
+      return static_cast<scalar_t>(exponential(gen));
     });
   });
 }
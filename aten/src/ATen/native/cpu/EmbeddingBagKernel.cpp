@@ -0,0 +1,227 @@
+#include <ATen/native/cpu/EmbeddingBagKernel.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <ATen/Dispatch.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Rows are prefetched this many indices ahead of the one being reduced, the
+// distance fbgemm uses for its kernels.
+constexpr int64_t kPrefetchDistance = 16;
+
+inline void prefetch_row(const void* row, int64_t bytes) {
+#if defined(__GNUC__)
+  const char* ptr = static_cast<const char*>(row);
+  for (int64_t offset = 0; offset < bytes; offset += 64) {
+    __builtin_prefetch(ptr + offset, /*rw=*/0, /*locality=*/1);
+  }
+#endif
+}
+
+inline void check_index(int64_t index, int64_t num_rows) {
+  TORCH_CHECK(index >= 0 && index < num_rows,
+      "embedding_bag: index ", index, " is out of bounds for weight with ",
+      num_rows, " rows");
+}
+
+template <typename scalar_t>
+void embedding_bag_sum_impl(
+    Tensor& output,
+    const Tensor& weight,
+    const Tensor& indices,
+    const Tensor& offsets,
+    const Tensor& per_sample_weights,
+    bool normalize_by_lengths) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t num_bags = offsets.numel() - 1;
+  const int64_t ddim = weight.size(1);
+  const int64_t num_rows = weight.size(0);
+  const int64_t weight_stride = weight.stride(0);
+  const int64_t output_stride = output.stride(0);
+  const scalar_t* weight_data = weight.data_ptr<scalar_t>();
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  const int64_t* indices_data = indices.data_ptr<int64_t>();
+  const int64_t* offsets_data = offsets.data_ptr<int64_t>();
+  const scalar_t* scale_data = per_sample_weights.defined()
+      ? per_sample_weights.data_ptr<scalar_t>() : nullptr;
+  const int64_t scale_stride = per_sample_weights.defined() ? per_sample_weights.stride(0) : 0;
+
+  const int64_t grain_size = embedding_bag_grain_size(offsets_data[num_bags], num_bags, ddim);
+  at::parallel_for(0, num_bags, grain_size, [&](int64_t begin, int64_t end) {
+    const int64_t last = offsets_data[end];
+    for (int64_t bag = begin; bag < end; bag++) {
+      scalar_t* out = output_data + bag * output_stride;
+      std::fill_n(out, ddim, scalar_t(0));
+      const int64_t start = offsets_data[bag];
+      const int64_t stop = offsets_data[bag + 1];
+      for (int64_t i = start; i < stop; i++) {
+        if (i + kPrefetchDistance < last) {
+          prefetch_row(weight_data + indices_data[i + kPrefetchDistance] * weight_stride,
+                       ddim * sizeof(scalar_t));
+        }
+        const int64_t index = indices_data[i];
+        check_index(index, num_rows);
+        const scalar_t* row = weight_data + index * weight_stride;
+        int64_t d = 0;
+        if (scale_data) {
+          const scalar_t scale = scale_data[i * scale_stride];
+          const Vec scale_vec(scale);
+          for (; d + Vec::size() <= ddim; d += Vec::size()) {
+            fmadd(Vec::loadu(row + d), scale_vec, Vec::loadu(out + d)).store(out + d);
+          }
+          for (; d < ddim; d++) {
+            out[d] += row[d] * scale;
+          }
+        } else {
+          for (; d + Vec::size() <= ddim; d += Vec::size()) {
+            (Vec::loadu(out + d) + Vec::loadu(row + d)).store(out + d);
+          }
+          for (; d < ddim; d++) {
+            out[d] += row[d];
+          }
+        }
+      }
+      if (normalize_by_lengths && stop > start) {
+        const scalar_t scale = scalar_t(1) / (stop - start);
+        const Vec scale_vec(scale);
+        int64_t d = 0;
+        for (; d + Vec::size() <= ddim; d += Vec::size()) {
+          (Vec::loadu(out + d) * scale_vec).store(out + d);
+        }
+        for (; d < ddim; d++) {
+          out[d] *= scale;
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void embedding_bag_max_impl(
+    Tensor& output,
+    Tensor& max_indices,
+    const Tensor& weight,
+    const Tensor& indices,
+    const Tensor& offsets) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t num_bags = offsets.numel() - 1;
+  const int64_t ddim = weight.size(1);
+  const int64_t num_rows = weight.size(0);
+  const int64_t weight_stride = weight.stride(0);
+  const int64_t output_stride = output.stride(0);
+  const int64_t max_indices_stride = max_indices.stride(0);
+  const scalar_t* weight_data = weight.data_ptr<scalar_t>();
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  int64_t* max_indices_data = max_indices.data_ptr<int64_t>();
+  const int64_t* indices_data = indices.data_ptr<int64_t>();
+  const int64_t* offsets_data = offsets.data_ptr<int64_t>();
+  // Positions within a bag are blended alongside the values as scalar_t,
+  // which is exact below this bag length.
+  constexpr int64_t kMaxExactPosition = int64_t(1) << std::numeric_limits<scalar_t>::digits;
+
+  const int64_t grain_size = embedding_bag_grain_size(offsets_data[num_bags], num_bags, ddim);
+  at::parallel_for(0, num_bags, grain_size, [&](int64_t begin, int64_t end) {
+    const int64_t last = offsets_data[end];
+    std::vector<scalar_t> positions(ddim);
+    for (int64_t bag = begin; bag < end; bag++) {
+      scalar_t* out = output_data + bag * output_stride;
+      int64_t* out_indices = max_indices_data + bag * max_indices_stride;
+      const int64_t start = offsets_data[bag];
+      const int64_t stop = offsets_data[bag + 1];
+      if (start == stop) {
+        std::fill_n(out, ddim, scalar_t(0));
+        std::fill_n(out_indices, ddim, 0);
+        continue;
+      }
+
+      check_index(indices_data[start], num_rows);
+      std::copy_n(weight_data + indices_data[start] * weight_stride, ddim, out);
+      std::fill(positions.begin(), positions.end(), scalar_t(0));
+      if (stop - start >= kMaxExactPosition) {
+        std::fill_n(out_indices, ddim, indices_data[start]);
+      }
+
+      for (int64_t i = start + 1; i < stop; i++) {
+        if (i + kPrefetchDistance < last) {
+          prefetch_row(weight_data + indices_data[i + kPrefetchDistance] * weight_stride,
+                       ddim * sizeof(scalar_t));
+        }
+        const int64_t index = indices_data[i];
+        check_index(index, num_rows);
+        const scalar_t* row = weight_data + index * weight_stride;
+        if (stop - start >= kMaxExactPosition) {
+          for (int64_t d = 0; d < ddim; d++) {
+            if (row[d] > out[d]) {
+              out[d] = row[d];
+              out_indices[d] = index;
+            }
+          }
+          continue;
+        }
+        // As in the scalar comparison, NaN only wins as the first row of a bag
+        // and ties keep the earlier row.
+        const scalar_t position = static_cast<scalar_t>(i - start);
+        const Vec position_vec(position);
+        int64_t d = 0;
+        for (; d + Vec::size() <= ddim; d += Vec::size()) {
+          const Vec value = Vec::loadu(row + d);
+          const Vec current = Vec::loadu(out + d);
+          const Vec mask = value > current;
+          Vec::blendv(current, value, mask).store(out + d);
+          Vec::blendv(Vec::loadu(positions.data() + d), position_vec, mask)
+              .store(positions.data() + d);
+        }
+        for (; d < ddim; d++) {
+          if (row[d] > out[d]) {
+            out[d] = row[d];
+            positions[d] = position;
+          }
+        }
+      }
+
+      if (stop - start < kMaxExactPosition) {
+        for (int64_t d = 0; d < ddim; d++) {
+          out_indices[d] = indices_data[start + static_cast<int64_t>(positions[d])];
+        }
+      }
+    }
+  });
+}
+
+void embedding_bag_sum_kernel(
+    Tensor& output,
+    const Tensor& weight,
+    const Tensor& indices,
+    const Tensor& offsets,
+    const Tensor& per_sample_weights,
+    bool normalize_by_lengths) {
+  AT_DISPATCH_FLOATING_TYPES(weight.scalar_type(), "embedding_bag_sum_cpu", [&] {
+    embedding_bag_sum_impl<scalar_t>(
+        output, weight, indices, offsets, per_sample_weights, normalize_by_lengths);
+  });
+}
+
+void embedding_bag_max_kernel(
+    Tensor& output,
+    Tensor& max_indices,
+    const Tensor& weight,
+    const Tensor& indices,
+    const Tensor& offsets) {
+  AT_DISPATCH_FLOATING_TYPES(weight.scalar_type(), "embedding_bag_max_cpu", [&] {
+    embedding_bag_max_impl<scalar_t>(output, max_indices, weight, indices, offsets);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(embedding_bag_sum_stub, &embedding_bag_sum_kernel);
+REGISTER_DISPATCH(embedding_bag_max_stub, &embedding_bag_max_kernel);
+
+}} // namespace at::native
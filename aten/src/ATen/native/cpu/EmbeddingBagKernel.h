@@ -0,0 +1,44 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Both kernels reduce the rows of `weight` selected by
+// indices[offsets[b] .. offsets[b + 1]) into row b of `output`, for every one
+// of the offsets.numel() - 1 bags. `weight` and `output` must have unit
+// stride in dim 1; `indices` and `offsets` are contiguous int64.
+
+// Sum of the rows, each scaled by per_sample_weights (if defined), and
+// divided by the length of its bag if `normalize_by_lengths`. Empty bags
+// produce zeros.
+using embedding_bag_sum_fn = void(*)(
+    Tensor& output,
+    const Tensor& weight,
+    const Tensor& indices,
+    const Tensor& offsets,
+    const Tensor& per_sample_weights,
+    bool normalize_by_lengths);
+
+// Element-wise maximum of the rows, with max_indices[b][d] set to the index
+// of the first row reaching it. Empty bags produce zeros.
+using embedding_bag_max_fn = void(*)(
+    Tensor& output,
+    Tensor& max_indices,
+    const Tensor& weight,
+    const Tensor& indices,
+    const Tensor& offsets);
+
+DECLARE_DISPATCH(embedding_bag_sum_fn, embedding_bag_sum_stub);
+DECLARE_DISPATCH(embedding_bag_max_fn, embedding_bag_max_stub);
+
+// Number of bags per task such that each task reduces about GRAIN_SIZE
+// elements.
+inline int64_t embedding_bag_grain_size(int64_t num_indices, int64_t num_bags, int64_t ddim) {
+  const int64_t indices_per_bag = std::max<int64_t>(1, num_indices / std::max<int64_t>(1, num_bags));
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, indices_per_bag * ddim));
+}
+
+}}  // namespace at::native
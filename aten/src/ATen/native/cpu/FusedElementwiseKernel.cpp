@@ -0,0 +1,207 @@
+#include <ATen/native/FusedElementwise.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <ATen/Dispatch.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/TensorIterator.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Number of elements evaluated per instruction before moving on to the next
+// one. Large enough to amortize the dispatch on the opcode, small enough that
+// the registers of a typical program stay in L1.
+constexpr int64_t kFusedChunkSize = 256;
+
+template <typename scalar_t, typename vec_op_t>
+inline void fused_unary(scalar_t* out, const scalar_t* a, int64_t n, const vec_op_t& op) {
+  using Vec = Vec256<scalar_t>;
+  for (int64_t i = 0; i < n; i += Vec::size()) {
+    int64_t count = std::min<int64_t>(Vec::size(), n - i);
+    op(Vec::loadu(a + i, count)).store(out + i, count);
+  }
+}
+
+template <typename scalar_t, typename vec_op_t>
+inline void fused_binary(scalar_t* out, const scalar_t* a, const scalar_t* b, int64_t n, const vec_op_t& op) {
+  using Vec = Vec256<scalar_t>;
+  for (int64_t i = 0; i < n; i += Vec::size()) {
+    int64_t count = std::min<int64_t>(Vec::size(), n - i);
+    op(Vec::loadu(a + i, count), Vec::loadu(b + i, count)).store(out + i, count);
+  }
+}
+
+template <typename scalar_t>
+void fused_execute(
+    const FusedInstruction& instruction,
+    scalar_t* out,
+    const std::vector<const scalar_t*>& regs,
+    int64_t n) {
+  using Vec = Vec256<scalar_t>;
+  const scalar_t* a = instruction.a >= 0 ? regs[instruction.a] : nullptr;
+  const scalar_t* b = instruction.b >= 0 ? regs[instruction.b] : nullptr;
+  switch (instruction.op) {
+    case FusedOp::Constant:
+      // filled once per loop call, see fused_elementwise_loop
+      break;
+    case FusedOp::Neg:
+      fused_unary(out, a, n, [](Vec x) { return x.neg(); });
+      break;
+    case FusedOp::Abs:
+      fused_unary(out, a, n, [](Vec x) { return x.abs(); });
+      break;
+    case FusedOp::Exp:
+      fused_unary(out, a, n, [](Vec x) { return x.exp(); });
+      break;
+    case FusedOp::Log:
+      fused_unary(out, a, n, [](Vec x) { return x.log(); });
+      break;
+    case FusedOp::Sqrt:
+      fused_unary(out, a, n, [](Vec x) { return x.sqrt(); });
+      break;
+    case FusedOp::Rsqrt:
+      fused_unary(out, a, n, [](Vec x) { return x.rsqrt(); });
+      break;
+    case FusedOp::Reciprocal:
+      fused_unary(out, a, n, [](Vec x) { return x.reciprocal(); });
+      break;
+    case FusedOp::Sigmoid: {
+      const Vec one(static_cast<scalar_t>(1));
+      fused_unary(out, a, n, [=](Vec x) { return one / (one + x.neg().exp()); });
+      break;
+    }
+    case FusedOp::Tanh:
+      fused_unary(out, a, n, [](Vec x) { return x.tanh(); });
+      break;
+    case FusedOp::Relu: {
+      // maximum propagates NaN like at::relu
+      const Vec zero(static_cast<scalar_t>(0));
+      fused_unary(out, a, n, [=](Vec x) { return maximum(x, zero); });
+      break;
+    }
+    case FusedOp::Clamp: {
+      const Vec min_vec(static_cast<scalar_t>(instruction.scalar));
+      const Vec max_vec(static_cast<scalar_t>(instruction.scalar2));
+      fused_unary(out, a, n, [=](Vec x) { return clamp(x, min_vec, max_vec); });
+      break;
+    }
+    case FusedOp::Add:
+      fused_binary(out, a, b, n, [](Vec x, Vec y) { return x + y; });
+      break;
+    case FusedOp::Sub:
+      fused_binary(out, a, b, n, [](Vec x, Vec y) { return x - y; });
+      break;
+    case FusedOp::Mul:
+      fused_binary(out, a, b, n, [](Vec x, Vec y) { return x * y; });
+      break;
+    case FusedOp::Div:
+      fused_binary(out, a, b, n, [](Vec x, Vec y) { return x / y; });
+      break;
+    case FusedOp::Minimum:
+      fused_binary(out, a, b, n, [](Vec x, Vec y) { return minimum(x, y); });
+      break;
+    case FusedOp::Maximum:
+      fused_binary(out, a, b, n, [](Vec x, Vec y) { return maximum(x, y); });
+      break;
+    case FusedOp::Fmadd: {
+      const scalar_t* c = regs[instruction.c];
+      for (int64_t i = 0; i < n; i += Vec::size()) {
+        int64_t count = std::min<int64_t>(Vec::size(), n - i);
+        fmadd(Vec::loadu(a + i, count), Vec::loadu(b + i, count), Vec::loadu(c + i, count))
+            .store(out + i, count);
+      }
+      break;
+    }
+  }
+}
+
+// Evaluates the program over one 1-d slice of the iteration space. Registers
+// are kFusedChunkSize-element buffers; a contiguous input is used in place and
+// broadcast inputs and constants are materialized once per call, so only
+// strided inputs are copied.
+template <typename scalar_t>
+void fused_elementwise_loop(
+    const FusedElementwiseProgram& program,
+    int noutputs,
+    char** data,
+    const int64_t* strides,
+    int64_t n) {
+  const int64_t num_inputs = program.num_inputs();
+  const int64_t num_values = program.num_values();
+  const auto& instructions = program.instructions();
+  const auto& outputs = program.outputs();
+  constexpr int64_t elem_size = sizeof(scalar_t);
+
+  std::vector<scalar_t> buffer(num_values * kFusedChunkSize);
+  std::vector<const scalar_t*> regs(num_values);
+  auto reg_buffer = [&](int64_t v) { return buffer.data() + v * kFusedChunkSize; };
+
+  for (int64_t i = 0; i < num_inputs; i++) {
+    regs[i] = reg_buffer(i);
+    if (strides[noutputs + i] == 0) {
+      auto value = *reinterpret_cast<const scalar_t*>(data[noutputs + i]);
+      std::fill_n(reg_buffer(i), kFusedChunkSize, value);
+    }
+  }
+  for (size_t k = 0; k < instructions.size(); k++) {
+    int64_t v = num_inputs + k;
+    regs[v] = reg_buffer(v);
+    if (instructions[k].op == FusedOp::Constant) {
+      std::fill_n(reg_buffer(v), kFusedChunkSize, static_cast<scalar_t>(instructions[k].scalar));
+    }
+  }
+
+  for (int64_t begin = 0; begin < n; begin += kFusedChunkSize) {
+    const int64_t len = std::min(kFusedChunkSize, n - begin);
+
+    for (int64_t i = 0; i < num_inputs; i++) {
+      const int64_t stride = strides[noutputs + i];
+      const char* in = data[noutputs + i] + begin * stride;
+      if (stride == elem_size) {
+        regs[i] = reinterpret_cast<const scalar_t*>(in);
+      } else if (stride != 0) {
+        scalar_t* dst = reg_buffer(i);
+        for (int64_t j = 0; j < len; j++) {
+          dst[j] = *reinterpret_cast<const scalar_t*>(in + j * stride);
+        }
+      }
+    }
+
+    for (size_t k = 0; k < instructions.size(); k++) {
+      fused_execute(instructions[k], reg_buffer(num_inputs + k), regs, len);
+    }
+
+    for (int o = 0; o < noutputs; o++) {
+      const int64_t stride = strides[o];
+      const scalar_t* src = regs[outputs[o]];
+      char* out = data[o] + begin * stride;
+      if (stride == elem_size) {
+        std::memcpy(out, src, len * elem_size);
+      } else {
+        for (int64_t j = 0; j < len; j++) {
+          *reinterpret_cast<scalar_t*>(out + j * stride) = src[j];
+        }
+      }
+    }
+  }
+}
+
+void fused_elementwise_kernel(TensorIterator& iter, const FusedElementwiseProgram& program) {
+  const int noutputs = iter.noutputs();
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "fused_elementwise_cpu", [&]() {
+    iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+      fused_elementwise_loop<scalar_t>(program, noutputs, data, strides, n);
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(fused_elementwise_stub, &fused_elementwise_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,224 @@
+#include <ATen/native/FusedOptimizers.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at {
+namespace native {
+
+namespace {
+
+using namespace vec256;
+
+// The update of every element is written once, as a generic lambda over the
+// type of its operands, and run on Vec256 for the bulk of the tensor and on
+// scalars for the tail.
+template <typename scalar_t>
+inline scalar_t load(const scalar_t* ptr, scalar_t /* tag */) {
+  return *ptr;
+}
+
+template <typename scalar_t>
+inline Vec256<scalar_t> load(const scalar_t* ptr, Vec256<scalar_t> /* tag */) {
+  return Vec256<scalar_t>::loadu(ptr);
+}
+
+template <typename scalar_t>
+inline void store(scalar_t* ptr, scalar_t value) {
+  *ptr = value;
+}
+
+template <typename scalar_t>
+inline void store(scalar_t* ptr, Vec256<scalar_t> value) {
+  value.store(ptr);
+}
+
+template <typename scalar_t>
+inline scalar_t sqrt_(scalar_t x) {
+  return std::sqrt(x);
+}
+
+template <typename scalar_t>
+inline Vec256<scalar_t> sqrt_(Vec256<scalar_t> x) {
+  return x.sqrt();
+}
+
+template <typename scalar_t>
+inline scalar_t max_(scalar_t a, scalar_t b) {
+  return std::max(a, b);
+}
+
+template <typename scalar_t>
+inline Vec256<scalar_t> max_(Vec256<scalar_t> a, Vec256<scalar_t> b) {
+  return maximum(a, b);
+}
+
+// Calls update(i, tag) for every vector, then every scalar, of the elements
+// [0, numel), where tag is a Vec256<scalar_t> or a scalar_t.
+template <typename scalar_t, typename F>
+void for_each_element(int64_t numel, const F& update) {
+  using Vec = Vec256<scalar_t>;
+  parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    int64_t i = begin;
+    for (; i + Vec::size() <= end; i += Vec::size()) {
+      update(i, Vec());
+    }
+    for (; i < end; i++) {
+      update(i, scalar_t());
+    }
+  });
+}
+
+void fused_adam_kernel(
+    const Tensor& param, const Tensor& grad, const Tensor& exp_avg,
+    const Tensor& exp_avg_sq, const Tensor& max_exp_avg_sq,
+    const FusedAdamOptions& options) {
+  AT_DISPATCH_FLOATING_TYPES(param.scalar_type(), "fused_adam_cpu", [&] {
+    auto* param_data = param.data_ptr<scalar_t>();
+    const auto* grad_data = grad.data_ptr<scalar_t>();
+    auto* exp_avg_data = exp_avg.data_ptr<scalar_t>();
+    auto* exp_avg_sq_data = exp_avg_sq.data_ptr<scalar_t>();
+    auto* max_exp_avg_sq_data =
+        max_exp_avg_sq.defined() ? max_exp_avg_sq.data_ptr<scalar_t>() : nullptr;
+    const auto beta1 = static_cast<scalar_t>(options.beta1);
+    const auto beta2 = static_cast<scalar_t>(options.beta2);
+    const auto weight_decay = static_cast<scalar_t>(options.weight_decay);
+    const auto decay_factor =
+        static_cast<scalar_t>(1 - options.lr * options.weight_decay);
+    const auto step_size =
+        static_cast<scalar_t>(options.lr / options.bias_correction1);
+    const auto sqrt_bias_correction2 =
+        static_cast<scalar_t>(options.sqrt_bias_correction2);
+    const auto eps = static_cast<scalar_t>(options.eps);
+    for_each_element<scalar_t>(param.numel(), [&](int64_t i, auto tag) {
+      using T = decltype(tag);
+      T p = load(param_data + i, tag);
+      T g = load(grad_data + i, tag);
+      if (options.weight_decay != 0) {
+        if (options.decoupled_weight_decay) {
+          p = p * T(decay_factor);
+        } else {
+          g = g + T(weight_decay) * p;
+        }
+      }
+      const T m = T(beta1) * load(exp_avg_data + i, tag) + T(1 - beta1) * g;
+      T v = T(beta2) * load(exp_avg_sq_data + i, tag) + T(1 - beta2) * g * g;
+      store(exp_avg_data + i, m);
+      store(exp_avg_sq_data + i, v);
+      if (max_exp_avg_sq_data != nullptr) {
+        v = max_(load(max_exp_avg_sq_data + i, tag), v);
+        store(max_exp_avg_sq_data + i, v);
+      }
+      const T denom = sqrt_(v) / T(sqrt_bias_correction2) + T(eps);
+      store(param_data + i, p - T(step_size) * m / denom);
+    });
+  });
+}
+
+void fused_sgd_kernel(
+    const Tensor& param, const Tensor& grad, const Tensor& momentum_buffer,
+    const FusedSGDOptions& options) {
+  AT_DISPATCH_FLOATING_TYPES(param.scalar_type(), "fused_sgd_cpu", [&] {
+    auto* param_data = param.data_ptr<scalar_t>();
+    const auto* grad_data = grad.data_ptr<scalar_t>();
+    auto* buf_data = momentum_buffer.defined()
+        ? momentum_buffer.data_ptr<scalar_t>()
+        : nullptr;
+    const auto lr = static_cast<scalar_t>(options.lr);
+    const auto momentum = static_cast<scalar_t>(options.momentum);
+    const auto dampening = static_cast<scalar_t>(options.dampening);
+    const auto weight_decay = static_cast<scalar_t>(options.weight_decay);
+    for_each_element<scalar_t>(param.numel(), [&](int64_t i, auto tag) {
+      using T = decltype(tag);
+      const T p = load(param_data + i, tag);
+      T d_p = load(grad_data + i, tag) + T(weight_decay) * p;
+      if (buf_data != nullptr) {
+        const T buf = options.first_run
+            ? d_p
+            : T(momentum) * load(buf_data + i, tag) + T(1 - dampening) * d_p;
+        store(buf_data + i, buf);
+        d_p = options.nesterov ? d_p + T(momentum) * buf : buf;
+      }
+      store(param_data + i, p - T(lr) * d_p);
+    });
+  });
+}
+
+void fused_adagrad_kernel(
+    const Tensor& param, const Tensor& grad, const Tensor& state_sum,
+    const FusedAdagradOptions& options) {
+  AT_DISPATCH_FLOATING_TYPES(param.scalar_type(), "fused_adagrad_cpu", [&] {
+    auto* param_data = param.data_ptr<scalar_t>();
+    const auto* grad_data = grad.data_ptr<scalar_t>();
+    auto* sum_data = state_sum.data_ptr<scalar_t>();
+    const auto clr = static_cast<scalar_t>(options.clr);
+    const auto weight_decay = static_cast<scalar_t>(options.weight_decay);
+    const auto eps = static_cast<scalar_t>(options.eps);
+    for_each_element<scalar_t>(param.numel(), [&](int64_t i, auto tag) {
+      using T = decltype(tag);
+      const T p = load(param_data + i, tag);
+      const T g = load(grad_data + i, tag) + T(weight_decay) * p;
+      const T sum = load(sum_data + i, tag) + g * g;
+      store(sum_data + i, sum);
+      store(param_data + i, p - T(clr) * g / (sqrt_(sum) + T(eps)));
+    });
+  });
+}
+
+void fused_rmsprop_kernel(
+    const Tensor& param, const Tensor& grad, const Tensor& square_avg,
+    const Tensor& momentum_buffer, const Tensor& grad_avg,
+    const FusedRMSpropOptions& options) {
+  AT_DISPATCH_FLOATING_TYPES(param.scalar_type(), "fused_rmsprop_cpu", [&] {
+    auto* param_data = param.data_ptr<scalar_t>();
+    const auto* grad_data = grad.data_ptr<scalar_t>();
+    auto* square_avg_data = square_avg.data_ptr<scalar_t>();
+    auto* buf_data = momentum_buffer.defined()
+        ? momentum_buffer.data_ptr<scalar_t>()
+        : nullptr;
+    auto* grad_avg_data =
+        grad_avg.defined() ? grad_avg.data_ptr<scalar_t>() : nullptr;
+    const auto lr = static_cast<scalar_t>(options.lr);
+    const auto alpha = static_cast<scalar_t>(options.alpha);
+    const auto eps = static_cast<scalar_t>(options.eps);
+    const auto weight_decay = static_cast<scalar_t>(options.weight_decay);
+    const auto momentum = static_cast<scalar_t>(options.momentum);
+    for_each_element<scalar_t>(param.numel(), [&](int64_t i, auto tag) {
+      using T = decltype(tag);
+      const T p = load(param_data + i, tag);
+      const T g = load(grad_data + i, tag) + T(weight_decay) * p;
+      const T sq = T(alpha) * load(square_avg_data + i, tag) + T(1 - alpha) * g * g;
+      store(square_avg_data + i, sq);
+      T avg;
+      if (grad_avg_data != nullptr) {
+        const T ga = T(alpha) * load(grad_avg_data + i, tag) + T(1 - alpha) * g;
+        store(grad_avg_data + i, ga);
+        avg = sqrt_(sq - ga * ga) + T(eps);
+      } else {
+        avg = sqrt_(sq) + T(eps);
+      }
+      if (buf_data != nullptr) {
+        const T buf = T(momentum) * load(buf_data + i, tag) + g / avg;
+        store(buf_data + i, buf);
+        store(param_data + i, p - T(lr) * buf);
+      } else {
+        store(param_data + i, p - T(lr) * g / avg);
+      }
+    });
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(fused_adam_stub, &fused_adam_kernel);
+REGISTER_DISPATCH(fused_sgd_stub, &fused_sgd_kernel);
+REGISTER_DISPATCH(fused_adagrad_stub, &fused_adagrad_kernel);
+REGISTER_DISPATCH(fused_rmsprop_stub, &fused_rmsprop_kernel);
+
+} // namespace native
+} // namespace at
@@ -1,7 +1,10 @@
 #include <ATen/native/TensorAdvancedIndexing.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <vector>
 #include <ATen/Dispatch.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/Parallel.h>
@@ -97,6 +100,102 @@ void cpu_index_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef
   }
 }
 
+// Parallel index_put_ with accumulate=True for types without an atomic add.
+// The updates are first gathered as (destination, source) pairs, then
+// bucketed by the range of destination addresses they fall in, with a
+// counting sort that keeps the order of the elements. Every task then applies
+// the updates of one range, which no other task touches, so duplicate indices
+// need no synchronization and every destination is accumulated in the same
+// order as in the serial loop.
+template <typename scalar_t>
+void cpu_index_put_accumulate_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef index_stride) {
+  struct Update {
+    char* dst;
+    char* src;
+  };
+  int ntensor = iter.ntensors();
+  const int64_t numel = iter.numel();
+  const int64_t num_tasks = std::min<int64_t>(
+      at::get_num_threads(), divup(numel, internal::GRAIN_SIZE));
+  const int64_t chunk_size = divup(numel, num_tasks);
+  std::vector<Update> updates(numel);
+  std::vector<uintptr_t> chunk_min(num_tasks, UINTPTR_MAX);
+  std::vector<uintptr_t> chunk_max(num_tasks, 0);
+  at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t t = begin; t < end; t++) {
+      const int64_t chunk_begin = t * chunk_size;
+      const int64_t chunk_end = std::min(numel, chunk_begin + chunk_size);
+      if (chunk_begin >= chunk_end) {
+        continue;
+      }
+      Update* out = updates.data() + chunk_begin;
+      uintptr_t lo = UINTPTR_MAX;
+      uintptr_t hi = 0;
+      iter.serial_for_each([&](char** data, const int64_t* strides, int64_t n) {
+        auto indexer = Indexer(ntensor - 2, &data[2], &strides[2], index_size, index_stride);
+        for (int64_t i = 0; i < n; i++) {
+          char* dst = data[0] + strides[0] * i + indexer.get(i);
+          *out++ = {dst, data[1] + strides[1] * i};
+          lo = std::min(lo, reinterpret_cast<uintptr_t>(dst));
+          hi = std::max(hi, reinterpret_cast<uintptr_t>(dst));
+        }
+      }, {chunk_begin, chunk_end});
+      chunk_min[t] = lo;
+      chunk_max[t] = hi;
+    }
+  });
+
+  const uintptr_t lo = *std::min_element(chunk_min.begin(), chunk_min.end());
+  const uintptr_t hi = *std::max_element(chunk_max.begin(), chunk_max.end());
+  const uint64_t span = static_cast<uint64_t>(hi - lo) + 1;
+  auto owner = [&](const Update& u) {
+    return static_cast<int64_t>(
+        static_cast<uint64_t>(reinterpret_cast<uintptr_t>(u.dst) - lo) * num_tasks / span);
+  };
+
+  // offsets[t * num_tasks + o] is where chunk t writes its updates to range o.
+  std::vector<int64_t> offsets(num_tasks * num_tasks + 1, 0);
+  at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t t = begin; t < end; t++) {
+      const int64_t chunk_begin = t * chunk_size;
+      const int64_t chunk_end = std::min(numel, chunk_begin + chunk_size);
+      for (int64_t i = chunk_begin; i < chunk_end; i++) {
+        offsets[t * num_tasks + owner(updates[i])]++;
+      }
+    }
+  });
+  // range_begin[o] is where the updates of range o start.
+  std::vector<int64_t> range_begin(num_tasks + 1, 0);
+  int64_t total = 0;
+  for (int64_t o = 0; o < num_tasks; o++) {
+    range_begin[o] = total;
+    for (int64_t t = 0; t < num_tasks; t++) {
+      const int64_t count = offsets[t * num_tasks + o];
+      offsets[t * num_tasks + o] = total;
+      total += count;
+    }
+  }
+  range_begin[num_tasks] = total;
+
+  std::vector<Update> sorted(numel);
+  at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t t = begin; t < end; t++) {
+      const int64_t chunk_begin = t * chunk_size;
+      const int64_t chunk_end = std::min(numel, chunk_begin + chunk_size);
+      for (int64_t i = chunk_begin; i < chunk_end; i++) {
+        sorted[offsets[t * num_tasks + owner(updates[i])]++] = updates[i];
+      }
+    }
+  });
+  at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t o = begin; o < end; o++) {
+      for (int64_t i = range_begin[o]; i < range_begin[o + 1]; i++) {
+        *(scalar_t*)sorted[i].dst += *(scalar_t*)sorted[i].src;
+      }
+    }
+  });
+}
+
 void index_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef index_stride) {
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(at::ScalarType::Half, at::ScalarType::Bool, at::ScalarType::BFloat16,
     iter.dtype(), "index_cpu", [&] {
@@ -113,12 +212,14 @@ void index_put_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef
     if (accumulate) {
       bool use_parallel_for = ((iter.numel() >= internal::GRAIN_SIZE) && (at::get_num_threads() > 1));
       if (iter.dtype() == at::ScalarType::Float && use_parallel_for) {
+        // Collisions are rare for large updates, so a compare-and-swap add is
+        // cheaper than bucketing the updates.
         cpu_index_kernel<float>(iter, index_size, index_stride, [](char* dst, char* src, int64_t offset) {
           cpu_atomic_add_float((float*)(dst + offset), *(float*)src);
         });
+      } else if (use_parallel_for) {
+        cpu_index_put_accumulate_kernel<scalar_t>(iter, index_size, index_stride);
       } else {
-        // TODO: investigate parallelization of the accumulate kernel. Unlike the non-accumulate case,
-        // this needs to be thread-safe.
         cpu_index_kernel<scalar_t>(iter, index_size, index_stride, [](char* dst, char* src, int64_t offset) {
           *(scalar_t*)(dst + offset) += *(scalar_t*)src;
         }, /*serial_execution=*/true);
@@ -24,9 +24,30 @@
 //
 // See BinaryOpsKernel.cpp for the complete implementation
 //
+// Both functions take an optional grain_size. Kernels that are much more
+// expensive per element than simple arithmetic should pass
+// at::internal::grain_size_for_cost(cost) so that they are parallelized on
+// smaller tensors. Without it, the default grain size is used, or, if
+// at::set_adaptive_grain_size(true) was called, one learned from timing the
+// kernel's first invocations.
+//
+// A chain of element-wise functions can be run in a single pass with
+// compose(f, g, ...), which returns a function computing g(f(args...)) with the
+// signature of f:
+//
+//   cpu_kernel_vec(iter,
+//     compose([=](float a) { return std::min(std::max(a, lo), hi); },
+//             [=](float a) { return a * scale; }),
+//     compose([=](Vec256<float> a) { return clamp(a, lo_vec, hi_vec); },
+//             [=](Vec256<float> a) { return a * scale_vec; }));
+//
+// For chains built at runtime, see ATen/native/FusedElementwise.h.
 //
 
 #include <stdint.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <c10/util/C++17.h>
 #include <ATen/detail/FunctionTraits.h>
 #include <ATen/native/cpu/IsContiguous.h>
@@ -183,12 +204,57 @@ static inline void unroll_contiguous_scalar_checks(
   }
 }
 
+template <typename func_t, typename stage_t, typename args_t>
+struct composed_function;
+
+template <typename func_t, typename stage_t, typename... Args>
+struct composed_function<func_t, stage_t, std::tuple<Args...>> {
+  func_t op;
+  stage_t stage;
+
+  // A concrete (non-template) operator() so that function_traits can see the
+  // argument types, as for a lambda.
+  auto operator()(Args... args) const
+      -> decltype(std::declval<const stage_t&>()(std::declval<const func_t&>()(args...))) {
+    return stage(op(args...));
+  }
+};
+
+template <typename func_t, typename stage_t>
+composed_function<
+    typename std::decay<func_t>::type,
+    typename std::decay<stage_t>::type,
+    typename function_traits<typename std::decay<func_t>::type>::ArgsTuple>
+compose(func_t&& op, stage_t&& stage) {
+  return {std::forward<func_t>(op), std::forward<stage_t>(stage)};
+}
+
+template <typename func_t, typename stage_t, typename... stages_t>
+auto compose(func_t&& op, stage_t&& stage, stages_t&&... stages) {
+  return compose(
+      compose(std::forward<func_t>(op), std::forward<stage_t>(stage)),
+      std::forward<stages_t>(stages)...);
+}
+
+// Runs `loop` over `iter` with `grain_size` if it is positive, otherwise with
+// a grain size learned for the calling kernel (see GrainSizeEstimator).
+template <typename func_t, typename loop_t>
+static inline void for_each_with_grain_size(TensorIterator& iter, const loop_t& loop, int64_t grain_size) {
+  if (grain_size > 0) {
+    iter.for_each(loop, grain_size);
+  } else {
+    // One estimator per kernel instantiation
+    static internal::GrainSizeEstimator estimator;
+    iter.for_each(loop, estimator);
+  }
+}
+
 template <typename func_t>
-void cpu_kernel(TensorIterator& iter, func_t&& op) {
+void cpu_kernel(TensorIterator& iter, func_t&& op, int64_t grain_size = -1) {
   using traits = function_traits<func_t>;
   TORCH_INTERNAL_ASSERT(iter.ntensors() >= traits::arity + 1);
 
-  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+  auto loop = [&](char** data, const int64_t* strides, int64_t n) {
     if (is_contiguous<traits>(strides)) {
       basic_loop(data, strides, 0, n, std::forward<func_t>(op));
     } else {
@@ -197,16 +263,17 @@ void cpu_kernel(TensorIterator& iter, func_t&& op) {
         basic_loop(data, strides, 0, n, std::forward<func_t>(op));
       });
     }
-  });
+  };
+  for_each_with_grain_size<func_t>(iter, loop, grain_size);
   iter.cast_outputs();
 }
 
 template <typename func_t, typename vec_func_t>
-void cpu_kernel_vec(TensorIterator& iter, func_t&& op, vec_func_t&& vop) {
+void cpu_kernel_vec(TensorIterator& iter, func_t&& op, vec_func_t&& vop, int64_t grain_size = -1) {
   using traits = function_traits<func_t>;
   TORCH_INTERNAL_ASSERT(iter.ntensors() >= traits::arity + 1);
 
-  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+  auto loop = [&](char** data, const int64_t* strides, int64_t n) {
     if (is_contiguous<traits>(strides)) {
       return vectorized_loop(data, n, 0, std::forward<func_t>(op), std::forward<vec_func_t>(vop));
     } else {
@@ -219,7 +286,8 @@ void cpu_kernel_vec(TensorIterator& iter, func_t&& op, vec_func_t&& vop) {
         }
       });
     }
-  });
+  };
+  for_each_with_grain_size<func_t>(iter, loop, grain_size);
   iter.cast_outputs();
 }
 
@@ -0,0 +1,152 @@
+#include <ATen/native/RNN.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at {
+namespace native {
+
+namespace {
+
+using namespace vec256;
+
+template <typename scalar_t>
+inline scalar_t sigmoid(scalar_t x) {
+  return scalar_t(1) / (scalar_t(1) + std::exp(-x));
+}
+
+template <typename scalar_t>
+inline Vec256<scalar_t> sigmoid(Vec256<scalar_t> x) {
+  const Vec256<scalar_t> one(scalar_t(1));
+  return (one + x.neg().exp()).reciprocal();
+}
+
+// Every tensor is a [batch, n * hidden_size] matrix with contiguous rows, so
+// the batch is split across threads, and the gates of a row are computed
+// together in one pass.
+template <typename scalar_t>
+void fused_lstm_cell_cpu_impl(
+    Tensor& hy,
+    Tensor& cy,
+    const Tensor& gates,
+    const Tensor& cx) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t batch_size = cx.size(0);
+  const int64_t hidden_size = cx.size(1);
+  const int64_t gates_stride = gates.stride(0);
+  const int64_t cx_stride = cx.stride(0);
+  const int64_t hy_stride = hy.stride(0);
+  const int64_t cy_stride = cy.stride(0);
+  const scalar_t* gates_data = gates.data_ptr<scalar_t>();
+  const scalar_t* cx_data = cx.data_ptr<scalar_t>();
+  scalar_t* hy_data = hy.data_ptr<scalar_t>();
+  scalar_t* cy_data = cy.data_ptr<scalar_t>();
+  const int64_t grain_size =
+      std::max<int64_t>(internal::GRAIN_SIZE / (4 * hidden_size), 1);
+  parallel_for(0, batch_size, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      const scalar_t* in = gates_data + b * gates_stride;
+      const scalar_t* forget = in + hidden_size;
+      const scalar_t* cell = in + 2 * hidden_size;
+      const scalar_t* out = in + 3 * hidden_size;
+      const scalar_t* c = cx_data + b * cx_stride;
+      scalar_t* h_next = hy_data + b * hy_stride;
+      scalar_t* c_next = cy_data + b * cy_stride;
+      int64_t j = 0;
+      for (; j < hidden_size - (hidden_size % Vec::size()); j += Vec::size()) {
+        const Vec ingate = sigmoid(Vec::loadu(in + j));
+        const Vec forgetgate = sigmoid(Vec::loadu(forget + j));
+        const Vec cellgate = Vec::loadu(cell + j).tanh();
+        const Vec outgate = sigmoid(Vec::loadu(out + j));
+        const Vec c_new = forgetgate * Vec::loadu(c + j) + ingate * cellgate;
+        c_new.store(c_next + j);
+        (outgate * c_new.tanh()).store(h_next + j);
+      }
+      for (; j < hidden_size; ++j) {
+        const scalar_t c_new = sigmoid(forget[j]) * c[j] +
+            sigmoid(in[j]) * std::tanh(cell[j]);
+        c_next[j] = c_new;
+        h_next[j] = sigmoid(out[j]) * std::tanh(c_new);
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void fused_gru_cell_cpu_impl(
+    Tensor& hy,
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& hx) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t batch_size = hx.size(0);
+  const int64_t hidden_size = hx.size(1);
+  const int64_t igates_stride = igates.stride(0);
+  const int64_t hgates_stride = hgates.stride(0);
+  const int64_t hx_stride = hx.stride(0);
+  const int64_t hy_stride = hy.stride(0);
+  const scalar_t* igates_data = igates.data_ptr<scalar_t>();
+  const scalar_t* hgates_data = hgates.data_ptr<scalar_t>();
+  const scalar_t* hx_data = hx.data_ptr<scalar_t>();
+  scalar_t* hy_data = hy.data_ptr<scalar_t>();
+  const int64_t grain_size =
+      std::max<int64_t>(internal::GRAIN_SIZE / (3 * hidden_size), 1);
+  parallel_for(0, batch_size, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      const scalar_t* ig = igates_data + b * igates_stride;
+      const scalar_t* hg = hgates_data + b * hgates_stride;
+      const scalar_t* h = hx_data + b * hx_stride;
+      scalar_t* h_next = hy_data + b * hy_stride;
+      const int64_t n = 2 * hidden_size;
+      int64_t j = 0;
+      for (; j < hidden_size - (hidden_size % Vec::size()); j += Vec::size()) {
+        const Vec resetgate =
+            sigmoid(Vec::loadu(ig + j) + Vec::loadu(hg + j));
+        const Vec inputgate = sigmoid(
+            Vec::loadu(ig + hidden_size + j) + Vec::loadu(hg + hidden_size + j));
+        const Vec newgate =
+            (Vec::loadu(ig + n + j) + resetgate * Vec::loadu(hg + n + j)).tanh();
+        ((Vec::loadu(h + j) - newgate) * inputgate + newgate).store(h_next + j);
+      }
+      for (; j < hidden_size; ++j) {
+        const scalar_t resetgate = sigmoid(ig[j] + hg[j]);
+        const scalar_t inputgate = sigmoid(ig[hidden_size + j] + hg[hidden_size + j]);
+        const scalar_t newgate = std::tanh(ig[n + j] + resetgate * hg[n + j]);
+        h_next[j] = (h[j] - newgate) * inputgate + newgate;
+      }
+    }
+  });
+}
+
+void fused_lstm_cell_cpu_kernel(
+    Tensor& hy,
+    Tensor& cy,
+    const Tensor& gates,
+    const Tensor& cx) {
+  AT_DISPATCH_FLOATING_TYPES(gates.scalar_type(), "fused_lstm_cell_cpu", [&] {
+    fused_lstm_cell_cpu_impl<scalar_t>(hy, cy, gates, cx);
+  });
+}
+
+void fused_gru_cell_cpu_kernel(
+    Tensor& hy,
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& hx) {
+  AT_DISPATCH_FLOATING_TYPES(igates.scalar_type(), "fused_gru_cell_cpu", [&] {
+    fused_gru_cell_cpu_impl<scalar_t>(hy, igates, hgates, hx);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(fused_lstm_cell_cpu_stub, &fused_lstm_cell_cpu_kernel);
+REGISTER_DISPATCH(fused_gru_cell_cpu_stub, &fused_gru_cell_cpu_kernel);
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,283 @@
+#pragma once
+
+// Radix sort and radix select on order-preserving unsigned integer keys, used
+// by the CPU sort, topk and kthvalue kernels.
+//
+// Every element is mapped to an unsigned key of the same width whose integer
+// order is the order of the elements, with NaN larger than everything else
+// (for numpy compatibility). Sorting the keys paired with int64 indices is then
+// a stable LSD radix sort over their bytes, and the k-th smallest key is found
+// with one histogram pass per byte, from the most significant one down. Both
+// work on plain arrays of keys and indices rather than on a vector of
+// (value, index) pairs, and parallelize the histogram and scatter passes over
+// contiguous chunks of the input.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <ATen/Parallel.h>
+#include <c10/util/BFloat16.h>
+#include <c10/util/Half.h>
+
+namespace at { namespace native {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+// Inputs shorter than this are not split into chunks for the radix passes.
+constexpr int64_t kRadixMinChunkSize = 1 << 14;
+// Below this size an insertion sort beats the 256-bucket histograms.
+constexpr int64_t kRadixSortMinSize = 64;
+
+template <typename scalar_t, typename = void>
+struct radix_traits;
+
+template <>
+struct radix_traits<bool> {
+  using key_t = uint8_t;
+  static key_t to_key(bool x) { return x; }
+  static bool from_key(key_t k) { return k != 0; }
+};
+
+template <typename scalar_t>
+struct radix_traits<scalar_t, typename std::enable_if<
+    std::is_integral<scalar_t>::value && !std::is_same<scalar_t, bool>::value>::type> {
+  using key_t = typename std::make_unsigned<scalar_t>::type;
+  // flipping the sign bit maps two's complement order to unsigned order
+  static constexpr key_t flip = std::is_signed<scalar_t>::value
+      ? static_cast<key_t>(key_t(1) << (sizeof(key_t) * 8 - 1))
+      : key_t(0);
+  static key_t to_key(scalar_t x) { return static_cast<key_t>(x) ^ flip; }
+  static scalar_t from_key(key_t k) { return static_cast<scalar_t>(k ^ flip); }
+};
+
+// IEEE floats: positive values get their sign bit set, negative values are
+// bitwise inverted so that larger magnitudes sort first. NaNs are replaced by
+// the positive quiet NaN, which maps above +inf.
+template <typename scalar_t, typename bits_t, bits_t nan_bits>
+struct float_radix_traits {
+  using key_t = bits_t;
+  static constexpr key_t sign = static_cast<key_t>(key_t(1) << (sizeof(key_t) * 8 - 1));
+
+  static key_t to_key(scalar_t x) {
+    bits_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    const key_t sign_bit = sign;
+    bits = x != x ? nan_bits : bits;
+    return bits ^ ((bits & sign_bit) ? static_cast<key_t>(~key_t(0)) : sign_bit);
+  }
+  static scalar_t from_key(key_t k) {
+    const key_t sign_bit = sign;
+    bits_t bits = k ^ ((k & sign_bit) ? sign_bit : static_cast<key_t>(~key_t(0)));
+    scalar_t x;
+    std::memcpy(&x, &bits, sizeof(bits));
+    return x;
+  }
+};
+
+template <>
+struct radix_traits<float> : float_radix_traits<float, uint32_t, 0x7fc00000u> {};
+template <>
+struct radix_traits<double> : float_radix_traits<double, uint64_t, 0x7ff8000000000000ull> {};
+// Half and BFloat16 are trivially copyable wrappers around their bits, and
+// x != x is evaluated in float.
+template <>
+struct radix_traits<c10::Half> : float_radix_traits<c10::Half, uint16_t, 0x7e00> {};
+template <>
+struct radix_traits<c10::BFloat16> : float_radix_traits<c10::BFloat16, uint16_t, 0x7fc0> {};
+
+// Key of `x` in ascending order, or in descending order if `descending`.
+template <typename scalar_t>
+inline typename radix_traits<scalar_t>::key_t radix_key(scalar_t x, bool descending) {
+  using key_t = typename radix_traits<scalar_t>::key_t;
+  auto key = radix_traits<scalar_t>::to_key(x);
+  return descending ? static_cast<key_t>(~key) : key;
+}
+
+template <typename scalar_t>
+inline scalar_t radix_value(typename radix_traits<scalar_t>::key_t key, bool descending) {
+  using key_t = typename radix_traits<scalar_t>::key_t;
+  return radix_traits<scalar_t>::from_key(descending ? static_cast<key_t>(~key) : key);
+}
+
+// Fills keys[i] with the key of data[i * stride]. The branch-free key mapping
+// lets the contiguous case auto-vectorize.
+template <typename scalar_t>
+inline void extract_radix_keys(
+    typename radix_traits<scalar_t>::key_t* keys,
+    const scalar_t* data,
+    int64_t stride,
+    int64_t n,
+    bool descending) {
+  if (stride == 1) {
+    for (int64_t i = 0; i < n; i++) {
+      keys[i] = radix_key(data[i], descending);
+    }
+  } else {
+    for (int64_t i = 0; i < n; i++) {
+      keys[i] = radix_key(data[i * stride], descending);
+    }
+  }
+}
+
+inline int64_t radix_num_chunks(int64_t n, bool parallel) {
+  if (!parallel || at::in_parallel_region()) {
+    return 1;
+  }
+  return std::max<int64_t>(1, std::min<int64_t>(at::get_num_threads(), n / kRadixMinChunkSize));
+}
+
+// Runs f(chunk, begin, end) for `num_chunks` contiguous chunks of [0, n), in
+// parallel if there is more than one chunk.
+template <typename func_t>
+inline void radix_for_each_chunk(int64_t n, int64_t num_chunks, const func_t& f) {
+  const int64_t chunk_size = num_chunks > 0 ? (n + num_chunks - 1) / num_chunks : n;
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      f(c, c * chunk_size, std::min(n, (c + 1) * chunk_size));
+    }
+  });
+}
+
+// Stable sort of (keys[i], indices[i]) by key, using keys_buffer and
+// indices_buffer (of size n) as scratch space. Returns whether the result ended
+// up in the buffers rather than in keys and indices.
+template <typename key_t>
+bool radix_sort_pairs(
+    key_t* keys,
+    int64_t* indices,
+    key_t* keys_buffer,
+    int64_t* indices_buffer,
+    int64_t n,
+    bool parallel) {
+  const int64_t num_chunks = radix_num_chunks(n, parallel);
+  std::vector<std::array<int64_t, 256>> histograms(num_chunks);
+  key_t* src_keys = keys;
+  int64_t* src_indices = indices;
+  key_t* dst_keys = keys_buffer;
+  int64_t* dst_indices = indices_buffer;
+  bool in_buffer = false;
+
+  for (size_t shift = 0; shift < sizeof(key_t) * 8; shift += 8) {
+    radix_for_each_chunk(n, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+      auto& histogram = histograms[c];
+      histogram.fill(0);
+      for (int64_t i = begin; i < end; i++) {
+        histogram[(src_keys[i] >> shift) & 0xff]++;
+      }
+    });
+
+    // Turn the counts into each chunk's first output position per digit,
+    // skipping the pass if every key has the same digit.
+    bool trivial = false;
+    int64_t offset = 0;
+    for (int digit = 0; digit < 256; digit++) {
+      int64_t digit_count = 0;
+      for (int64_t c = 0; c < num_chunks; c++) {
+        int64_t count = histograms[c][digit];
+        histograms[c][digit] = offset + digit_count;
+        digit_count += count;
+      }
+      if (digit_count == n) {
+        trivial = true;
+        break;
+      }
+      offset += digit_count;
+    }
+    if (trivial) {
+      continue;
+    }
+
+    radix_for_each_chunk(n, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+      auto& position = histograms[c];
+      for (int64_t i = begin; i < end; i++) {
+        int64_t pos = position[(src_keys[i] >> shift) & 0xff]++;
+        dst_keys[pos] = src_keys[i];
+        dst_indices[pos] = src_indices[i];
+      }
+    });
+    std::swap(src_keys, dst_keys);
+    std::swap(src_indices, dst_indices);
+    in_buffer = !in_buffer;
+  }
+  return in_buffer;
+}
+
+// Stable sort of (keys[i], indices[i]) by key: insertion sort for short
+// inputs, radix_sort_pairs otherwise. Returns whether the result ended up in
+// the buffers.
+template <typename key_t>
+bool sort_keys_with_indices(
+    key_t* keys,
+    int64_t* indices,
+    key_t* keys_buffer,
+    int64_t* indices_buffer,
+    int64_t n,
+    bool parallel) {
+  if (n >= kRadixSortMinSize) {
+    return radix_sort_pairs(keys, indices, keys_buffer, indices_buffer, n, parallel);
+  }
+  for (int64_t i = 1; i < n; i++) {
+    key_t key = keys[i];
+    int64_t index = indices[i];
+    int64_t j = i;
+    for (; j > 0 && keys[j - 1] > key; j--) {
+      keys[j] = keys[j - 1];
+      indices[j] = indices[j - 1];
+    }
+    keys[j] = key;
+    indices[j] = index;
+  }
+  return false;
+}
+
+// Returns the key of rank k (0-based) among the keys of data[i * stride],
+// i < n, and sets *num_less to the number of keys smaller than it.
+template <typename scalar_t>
+typename radix_traits<scalar_t>::key_t radix_select(
+    const scalar_t* data,
+    int64_t stride,
+    int64_t n,
+    int64_t k,
+    bool descending,
+    bool parallel,
+    int64_t* num_less) {
+  using key_t = typename radix_traits<scalar_t>::key_t;
+  const int64_t num_chunks = radix_num_chunks(n, parallel);
+  std::vector<std::array<int64_t, 256>> histograms(num_chunks);
+  key_t prefix = 0;
+  key_t prefix_mask = 0;
+  int64_t rank = k;
+
+  for (int shift = static_cast<int>(sizeof(key_t) * 8) - 8; shift >= 0; shift -= 8) {
+    radix_for_each_chunk(n, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+      auto& histogram = histograms[c];
+      histogram.fill(0);
+      for (int64_t i = begin; i < end; i++) {
+        key_t key = radix_key(data[i * stride], descending);
+        if ((key & prefix_mask) == prefix) {
+          histogram[(key >> shift) & 0xff]++;
+        }
+      }
+    });
+    for (int digit = 0; digit < 256; digit++) {
+      int64_t count = 0;
+      for (int64_t c = 0; c < num_chunks; c++) {
+        count += histograms[c][digit];
+      }
+      if (rank < count) {
+        prefix |= static_cast<key_t>(static_cast<key_t>(digit) << shift);
+        break;
+      }
+      rank -= count;
+    }
+    prefix_mask |= static_cast<key_t>(static_cast<key_t>(0xff) << shift);
+  }
+  *num_less = k - rank;
+  return prefix;
+}
+
+}}}  // namespace at::native::<anonymous>
@@ -4,6 +4,7 @@
 #include <ATen/Parallel.h>
 #include <c10/util/TypeList.h>
 
+#include <algorithm>
 #include <sstream>
 
 namespace at { namespace native { namespace {
@@ -175,7 +176,10 @@ struct all_same : guts::conjunction<
 // which means that `combine` will never be called.
 //
 // If, on the other hand, there is only one, then we split the input into
-// into several pieces, reduce each separately, and then combine them.
+// into several pieces, reduce each separately, and then combine them. The
+// pieces only depend on the number of elements (see
+// internal::reduction_chunk_size) and are combined in order, so that the
+// result does not depend on the number of threads.
 
 template <typename ops_t, typename init_t>
 void binary_kernel_reduce(TensorIterator& iter, ops_t ops, init_t init) {
@@ -222,21 +226,21 @@ void binary_kernel_reduce(TensorIterator& iter, ops_t ops, init_t init) {
         at::in_parallel_region()) {
       total_acc = reduction_body(total_acc, 0, numel);
     } else {
-      int max_threads = at::get_num_threads();
-      AT_ASSERT(max_threads > 0);
+      const int64_t chunk_size = internal::reduction_chunk_size(numel);
+      const int64_t num_chunks = divup(numel, chunk_size);
       static_assert(
         !std::is_same<acc_t, bool>::value,
         "Concurrently modifying different references into std::vector<bool> is UB."
       );
-      std::vector<acc_t> buffer((unsigned)max_threads, init);
-      at::parallel_for(0, numel, internal::GRAIN_SIZE,
-        [&](int64_t begin, int64_t end) {
-          auto& acc = buffer[at::get_thread_num()];
-          acc = reduction_body(acc, begin, end);
+      std::vector<acc_t> buffer((size_t)num_chunks, init);
+      at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t chunk = begin; chunk < end; chunk++) {
+          buffer[chunk] = reduction_body(
+              buffer[chunk], chunk * chunk_size, std::min(numel, (chunk + 1) * chunk_size));
         }
-      );
-      for (int i = 0; i < max_threads; ++i) {
-        total_acc = ops.combine(total_acc, buffer[i]);
+      });
+      for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+        total_acc = ops.combine(total_acc, buffer[chunk]);
       }
     }
     set_results<r_traits>(ops.project(total_acc), sub_iter, num_outputs);
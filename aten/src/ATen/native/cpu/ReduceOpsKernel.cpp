@@ -1,6 +1,10 @@
 #include <numeric>
 #include <iterator>
 #include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <vector>
 
 #include <ATen/Dispatch.h>
 #include <ATen/cpu/vec256/vec256.h>
@@ -13,94 +17,456 @@
 
 #include <c10/util/Optional.h>
 #include <ATen/AccumulateType.h>
+#include <ATen/NumericUtils.h>
+#include <ATen/Parallel.h>
+#include <ATen/Utils.h>
 
 namespace at { namespace native { namespace {
 
 using namespace vec256;
 
-template <typename scalar_t, typename func_t>
-static inline void cpu_cum_base_kernel(Tensor& result,
+// Operations of the scans below, in the style of SharedReduceOps.h:
+// reduce(acc, x, i) folds the element x at index i of the scanned dimension
+// into acc, combine(a, b) folds the accumulation b of a block of elements
+// into the accumulation a of all the elements before the block, and
+// project(acc, values, indices, j) writes out the accumulation of column j.
+template <typename scalar_t>
+struct CumSumOps {
+  using acc_t = at::acc_type<scalar_t, false>;
+  acc_t identity() const {
+    return acc_t(0);
+  }
+  acc_t reduce(acc_t acc, scalar_t x, int64_t /*index*/) const {
+    acc += x;
+    return acc;
+  }
+  acc_t combine(acc_t a, acc_t b) const {
+    a += b;
+    return a;
+  }
+  void project(acc_t acc, scalar_t* values, int64_t* /*indices*/, int64_t j) const {
+    values[j] = static_cast<scalar_t>(acc);
+  }
+};
+
+template <typename scalar_t>
+struct CumProdOps {
+  using acc_t = at::acc_type<scalar_t, false>;
+  acc_t identity() const {
+    return acc_t(1);
+  }
+  acc_t reduce(acc_t acc, scalar_t x, int64_t /*index*/) const {
+    acc *= x;
+    return acc;
+  }
+  acc_t combine(acc_t a, acc_t b) const {
+    a *= b;
+    return a;
+  }
+  void project(acc_t acc, scalar_t* values, int64_t* /*indices*/, int64_t j) const {
+    values[j] = static_cast<scalar_t>(acc);
+  }
+};
+
+template <typename scalar_t>
+struct LogCumSumExpOps {
+  using acc_t = at::acc_type<scalar_t, false>;
+  acc_t identity() const {
+    return -std::numeric_limits<acc_t>::infinity();
+  }
+  static acc_t log_add_exp(acc_t a, acc_t b) {
+    if (std::isnan(a) || std::isnan(b)) {
+      return std::numeric_limits<acc_t>::quiet_NaN();
+    }
+    const acc_t max = std::max(a, b);
+    const acc_t min = std::min(a, b);
+    if (std::isinf(min) && min == max) {
+      return max;
+    }
+    return max + std::log1p(std::exp(min - max));
+  }
+  acc_t reduce(acc_t acc, scalar_t x, int64_t /*index*/) const {
+    return log_add_exp(acc, x);
+  }
+  acc_t combine(acc_t a, acc_t b) const {
+    return log_add_exp(a, b);
+  }
+  void project(acc_t acc, scalar_t* values, int64_t* /*indices*/, int64_t j) const {
+    values[j] = static_cast<scalar_t>(acc);
+  }
+};
+
+// cummax and cummin: the running extremum and the index of its last
+// occurrence. NaN propagates and counts as the extremum.
+template <typename scalar_t, typename comp_t>
+struct CumMaxMinOps {
+  struct acc_t {
+    scalar_t value;
+    int64_t index;
+  };
+  scalar_t init;
+  acc_t identity() const {
+    return {init, 0};
+  }
+  static bool replaces(scalar_t x, scalar_t current) {
+    return _isnan(x) || (!_isnan(current) && comp_t()(x, current));
+  }
+  acc_t reduce(acc_t acc, scalar_t x, int64_t index) const {
+    return replaces(x, acc.value) ? acc_t{x, index} : acc;
+  }
+  acc_t combine(acc_t a, acc_t b) const {
+    return replaces(b.value, a.value) ? b : a;
+  }
+  void project(acc_t acc, scalar_t* values, int64_t* indices, int64_t j) const {
+    values[j] = acc.value;
+    indices[j] = acc.index;
+  }
+};
+
+// Columns of a panel given to each thread when the scan is split by columns.
+constexpr int64_t kScanColumnBlock = 64;
+
+// Scans `self` along `dim` into `result`, and into `indices` when the
+// operation has them; both are already resized like `self`.
+//
+// The input is viewed as [outer, size, inner] panels, with the scanned
+// dimension in the middle. A scan folds the rows of a panel into one
+// accumulator per column, so its inner loop runs over independent contiguous
+// columns. Panels are split across threads when there are enough of them.
+// Otherwise every panel is split by columns when it is wide, or else into
+// blocks of rows scanned in two passes: the first reduces every block, a
+// serial scan over the block results gives the carry into every block, and
+// the second scans every block starting from its carry.
+template <typename scalar_t, typename ops_t>
+void cpu_scan_kernel(
+    Tensor& result,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim,
+    const ops_t& ops) {
+  using acc_t = typename ops_t::acc_t;
+  const auto input = self.contiguous();
+  auto values = result.contiguous();
+  auto values_indices = indices.defined() ? indices.contiguous() : Tensor();
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  scalar_t* values_data = values.data_ptr<scalar_t>();
+  int64_t* indices_data =
+      values_indices.defined() ? values_indices.data_ptr<int64_t>() : nullptr;
+
+  const auto sizes = self.sizes();
+  const int64_t size = sizes[dim];
+  const int64_t outer = prod_intlist(sizes.slice(0, dim));
+  const int64_t inner = prod_intlist(sizes.slice(dim + 1));
+  const int64_t panel_size = size * inner;
+
+  auto reduce_rows = [&](int64_t panel, int64_t row_begin, int64_t row_end,
+                         int64_t col_begin, int64_t col_end, acc_t* acc) {
+    const scalar_t* in = input_data + panel * panel_size;
+    for (int64_t i = row_begin; i < row_end; i++) {
+      for (int64_t j = col_begin; j < col_end; j++) {
+        acc[j - col_begin] = ops.reduce(acc[j - col_begin], in[i * inner + j], i);
+      }
+    }
+  };
+  auto scan_rows = [&](int64_t panel, int64_t row_begin, int64_t row_end,
+                       int64_t col_begin, int64_t col_end, acc_t* acc) {
+    const scalar_t* in = input_data + panel * panel_size;
+    scalar_t* out = values_data + panel * panel_size;
+    int64_t* out_indices =
+        indices_data != nullptr ? indices_data + panel * panel_size : nullptr;
+    for (int64_t i = row_begin; i < row_end; i++) {
+      scalar_t* row = out + i * inner;
+      int64_t* row_indices = out_indices != nullptr ? out_indices + i * inner : nullptr;
+      for (int64_t j = col_begin; j < col_end; j++) {
+        acc[j - col_begin] = ops.reduce(acc[j - col_begin], in[i * inner + j], i);
+        ops.project(acc[j - col_begin], row, row_indices, j);
+      }
+    }
+  };
+
+  const int64_t num_threads = at::get_num_threads();
+  if (outer >= num_threads || outer * panel_size <= internal::GRAIN_SIZE) {
+    const int64_t grain_size = std::max<int64_t>(internal::GRAIN_SIZE / panel_size, 1);
+    at::parallel_for(0, outer, grain_size, [&](int64_t begin, int64_t end) {
+      std::vector<acc_t> acc(inner);
+      for (int64_t panel = begin; panel < end; panel++) {
+        std::fill(acc.begin(), acc.end(), ops.identity());
+        scan_rows(panel, 0, size, 0, inner, acc.data());
+      }
+    });
+  } else if (inner >= num_threads * kScanColumnBlock) {
+    for (int64_t panel = 0; panel < outer; panel++) {
+      at::parallel_for(0, inner, kScanColumnBlock, [&](int64_t begin, int64_t end) {
+        std::vector<acc_t> acc(end - begin, ops.identity());
+        scan_rows(panel, 0, size, begin, end, acc.data());
+      });
+    }
+  } else {
+    const int64_t max_blocks = std::min(
+        num_threads, std::max<int64_t>(panel_size / internal::GRAIN_SIZE, 1));
+    const int64_t block_rows = divup(size, max_blocks);
+    const int64_t num_blocks = divup(size, block_rows);
+    std::vector<acc_t> carry(num_blocks * inner);
+    for (int64_t panel = 0; panel < outer; panel++) {
+      std::fill(carry.begin(), carry.end(), ops.identity());
+      // The sum of block b - 1 goes into the carry of block b; the last block
+      // has no successor to reduce for.
+      at::parallel_for(0, num_blocks - 1, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t block = begin; block < end; block++) {
+          reduce_rows(
+              panel, block * block_rows, (block + 1) * block_rows, 0, inner,
+              &carry[(block + 1) * inner]);
+        }
+      });
+      for (int64_t block = 1; block < num_blocks; block++) {
+        for (int64_t j = 0; j < inner; j++) {
+          carry[block * inner + j] =
+              ops.combine(carry[(block - 1) * inner + j], carry[block * inner + j]);
+        }
+      }
+      at::parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t block = begin; block < end; block++) {
+          scan_rows(
+              panel, block * block_rows, std::min(size, (block + 1) * block_rows),
+              0, inner, &carry[block * inner]);
+        }
+      });
+    }
+  }
+
+  if (!result.is_contiguous()) {
+    result.copy_(values);
+  }
+  if (indices.defined() && !indices.is_contiguous()) {
+    indices.copy_(values_indices);
+  }
+}
+
+// Resizes the outputs of a scan and handles the inputs that need no scan.
+template <typename scalar_t, typename ops_t>
+void cpu_scan(
+    Tensor& result,
+    Tensor& indices,
     const Tensor& self,
     int64_t dim,
-    const func_t& f,
-    scalar_t init_val) {
+    const ops_t& ops) {
   if (result.sizes() != self.sizes()) {
     result.resize_as_(self);
   }
+  if (indices.defined() && indices.sizes() != self.sizes()) {
+    indices.resize_as_(self);
+  }
   if (self.numel() == 0) {
     return;
   }
-  const auto input_ndim = self.dim();
-  if (input_ndim == 0) {
+  if (self.dim() == 0) {
     result.fill_(self);
+    if (indices.defined()) {
+      indices.fill_(0);
+    }
     return;
   }
+  cpu_scan_kernel<scalar_t>(result, indices, self, maybe_wrap_dim(dim, self.dim()), ops);
+}
 
-  auto iter = TensorIterator();
-  iter.dont_compute_common_dtype();
-  iter.dont_resize_outputs();
-  iter.declare_static_shape(self.sizes(), /*squash_dim=*/dim);
-  iter.add_output(result);
-  iter.add_input(self);
-  iter.build();
+static void cumsum_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
+  AT_DISPATCH_ALL_TYPES_AND_C10_COMPLEX(self.scalar_type(), "cumsum_out_cpu", [&] {
+    Tensor no_indices;
+    cpu_scan<scalar_t>(result, no_indices, self, dim, CumSumOps<scalar_t>());
+  });
+}
 
-  auto result_dim_stride = ensure_nonempty_stride(result, dim);
-  auto self_dim_stride = ensure_nonempty_stride(self, dim);
+static void cumprod_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
+  AT_DISPATCH_ALL_TYPES_AND_C10_COMPLEX(self.scalar_type(), "cumprod_out_cpu", [&] {
+    Tensor no_indices;
+    cpu_scan<scalar_t>(result, no_indices, self, dim, CumProdOps<scalar_t>());
+  });
+}
 
-  auto loop = [&](char** data, const int64_t* strides, int64_t n) {
-    auto* result_data_bytes = data[0];
-    const auto* self_data_bytes = data[1];
+static void logcumsumexp_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "logcumsumexp_out_cpu", [&] {
+    Tensor no_indices;
+    cpu_scan<scalar_t>(result, no_indices, self, dim, LogCumSumExpOps<scalar_t>());
+  });
+}
 
-    for (int64_t i = 0; i < n; ++i) {
-      f(
-        (scalar_t*)result_data_bytes, result_dim_stride,
-        (scalar_t*)self_data_bytes, self_dim_stride, init_val
-      );
-      result_data_bytes += strides[0];
-      self_data_bytes += strides[1];
-    }
-  };
+// The initial value is below (above) every value that is not NaN, so the
+// first element always replaces it.
+template <typename scalar_t>
+scalar_t cummax_init() {
+  return std::numeric_limits<scalar_t>::has_infinity
+      ? -std::numeric_limits<scalar_t>::infinity()
+      : std::numeric_limits<scalar_t>::lowest();
+}
 
-  iter.for_each(loop);
+template <typename scalar_t>
+scalar_t cummin_init() {
+  return std::numeric_limits<scalar_t>::has_infinity
+      ? std::numeric_limits<scalar_t>::infinity()
+      : std::numeric_limits<scalar_t>::max();
 }
 
-static void cumsum_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
-  auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
+static void cummax_cpu_kernel(Tensor& values, Tensor& indices, const Tensor& self, int64_t dim) {
+  AT_DISPATCH_ALL_TYPES_AND(ScalarType::Bool, self.scalar_type(), "cummax_cpu", [&] {
+    cpu_scan<scalar_t>(
+        values, indices, self, dim,
+        CumMaxMinOps<scalar_t, std::greater_equal<scalar_t>>{cummax_init<scalar_t>()});
+  });
+}
 
-  AT_DISPATCH_ALL_TYPES_AND_C10_COMPLEX(self.scalar_type(), "cumsum_out_cpu", [&] {
-    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
-      scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        auto cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
-          cum_number += self_data[i * self_dim_stride];
-          result_data[i * result_dim_stride] = (scalar_t)cum_number;
-        }
-      }, /*init_val=*/ 0
-    );
+static void cummin_cpu_kernel(Tensor& values, Tensor& indices, const Tensor& self, int64_t dim) {
+  AT_DISPATCH_ALL_TYPES_AND(ScalarType::Bool, self.scalar_type(), "cummin_cpu", [&] {
+    cpu_scan<scalar_t>(
+        values, indices, self, dim,
+        CumMaxMinOps<scalar_t, std::less_equal<scalar_t>>{cummin_init<scalar_t>()});
   });
 }
 
-static void cumprod_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
-  auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
+// Floating point sums use cascade (pairwise) summation: the reduced elements
+// are split in halves until at most kCascadeLeafSize are left, which are
+// added with several vector accumulators, so that the rounding error grows
+// with the log of the number of elements rather than linearly. The splits
+// only depend on the number of elements, and the vector and scalar loops
+// over the columns of an outer reduction add the same elements in the same
+// order, so the sums do not depend on how the work is split between threads.
+constexpr int64_t kCascadeLeafSize = 256;
 
-  AT_DISPATCH_ALL_TYPES_AND_C10_COMPLEX(self.scalar_type(), "cumprod_out_cpu", [&] {
-    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
-      scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        auto cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
-          cum_number *= self_data[i * self_dim_stride];
-          result_data[i * result_dim_stride] = (scalar_t)cum_number;
+// Splits n > kCascadeLeafSize elements at a multiple of kCascadeLeafSize,
+// which keeps the leaves of a contiguous sum a whole number of vectors.
+inline int64_t cascade_split(int64_t n) {
+  return divup(n / 2, kCascadeLeafSize) * kCascadeLeafSize;
+}
+
+template <typename scalar_t>
+scalar_t cascade_contiguous_sum(const scalar_t* data, int64_t n) {
+  using Vec = Vec256<scalar_t>;
+  if (n > kCascadeLeafSize) {
+    const int64_t half = cascade_split(n);
+    return cascade_contiguous_sum(data, half) +
+        cascade_contiguous_sum(data + half, n - half);
+  }
+  constexpr int64_t kStep = 4 * Vec::size();
+  Vec acc[4] = {Vec(0), Vec(0), Vec(0), Vec(0)};
+  int64_t i = 0;
+  for (; i + kStep <= n; i += kStep) {
+    for (int64_t j = 0; j < 4; j++) {
+      acc[j] = acc[j] + Vec::loadu(data + i + j * Vec::size());
+    }
+  }
+  acc[0] = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+  scalar_t buffer[Vec::size()];
+  acc[0].store(buffer);
+  scalar_t sum = 0;
+  for (int64_t j = 0; j < Vec::size(); j++) {
+    sum += buffer[j];
+  }
+  for (; i < n; i++) {
+    sum += data[i];
+  }
+  return sum;
+}
+
+// Adds the elements one after the other within a leaf, like each lane of
+// cascade_columns_sum does.
+template <typename scalar_t>
+scalar_t cascade_strided_sum(const char* data, int64_t stride, int64_t n) {
+  if (n > kCascadeLeafSize) {
+    const int64_t half = cascade_split(n);
+    return cascade_strided_sum<scalar_t>(data, stride, half) +
+        cascade_strided_sum<scalar_t>(data + half * stride, stride, n - half);
+  }
+  scalar_t sum = 0;
+  for (int64_t i = 0; i < n; i++) {
+    sum += *reinterpret_cast<const scalar_t*>(data + i * stride);
+  }
+  return sum;
+}
+
+// Sums n rows, row_stride bytes apart, of 4 * Vec::size() contiguous
+// columns into acc.
+template <typename scalar_t>
+void cascade_columns_sum(
+    const char* data, int64_t row_stride, int64_t n, Vec256<scalar_t>* acc) {
+  using Vec = Vec256<scalar_t>;
+  if (n > kCascadeLeafSize) {
+    const int64_t half = cascade_split(n);
+    Vec acc_hi[4];
+    cascade_columns_sum<scalar_t>(data, row_stride, half, acc);
+    cascade_columns_sum<scalar_t>(data + half * row_stride, row_stride, n - half, acc_hi);
+    for (int64_t j = 0; j < 4; j++) {
+      acc[j] = acc[j] + acc_hi[j];
+    }
+    return;
+  }
+  for (int64_t j = 0; j < 4; j++) {
+    acc[j] = Vec(0);
+  }
+  for (int64_t i = 0; i < n; i++) {
+    const scalar_t* row = reinterpret_cast<const scalar_t*>(data + i * row_stride);
+    for (int64_t j = 0; j < 4; j++) {
+      acc[j] = acc[j] + Vec::loadu(row + j * Vec::size());
+    }
+  }
+}
+
+template <typename scalar_t>
+void cascade_sum(TensorIterator& iter) {
+  using Vec = Vec256<scalar_t>;
+  iter.output().fill_(0);
+  iter.parallel_reduce([&](char** data, const int64_t* strides, int64_t size0, int64_t size1) {
+    char* out = data[0];
+    const char* in = data[1];
+    const int64_t out_strides[] = { strides[0], strides[2] };
+    const int64_t in_strides[] = { strides[1], strides[3] };
+    auto out_at = [&](int64_t j) {
+      return reinterpret_cast<scalar_t*>(out + j * out_strides[1]);
+    };
+    if (out_strides[0] != 0) {
+      // dim 0 is not reduced, accumulate element-wise
+      for (int64_t j = 0; j < size1; j++) {
+        for (int64_t i = 0; i < size0; i++) {
+          *reinterpret_cast<scalar_t*>(out + i * out_strides[0] + j * out_strides[1]) +=
+              *reinterpret_cast<const scalar_t*>(in + i * in_strides[0] + j * in_strides[1]);
         }
-      }, /*init_val=*/ 1
-    );
+      }
+    } else if (in_strides[0] == sizeof(scalar_t)) {
+      // input is contiguous along the reduced dim 0
+      for (int64_t j = 0; j < size1; j++) {
+        *out_at(j) += cascade_contiguous_sum(
+            reinterpret_cast<const scalar_t*>(in + j * in_strides[1]), size0);
+      }
+    } else if (out_strides[1] == sizeof(scalar_t) && in_strides[1] == sizeof(scalar_t)) {
+      // input and output are contiguous in dim 1, sum the rows of columns
+      constexpr int64_t kStep = 4 * Vec::size();
+      int64_t j = 0;
+      for (; j + kStep <= size1; j += kStep) {
+        Vec acc[4];
+        cascade_columns_sum<scalar_t>(in + j * sizeof(scalar_t), in_strides[0], size0, acc);
+        for (int64_t k = 0; k < 4; k++) {
+          scalar_t* dst = out_at(j + k * Vec::size());
+          (Vec::loadu(dst) + acc[k]).store(dst);
+        }
+      }
+      for (; j < size1; j++) {
+        *out_at(j) += cascade_strided_sum<scalar_t>(
+            in + j * sizeof(scalar_t), in_strides[0], size0);
+      }
+    } else {
+      for (int64_t j = 0; j < size1; j++) {
+        *out_at(j) += cascade_strided_sum<scalar_t>(
+            in + j * in_strides[1], in_strides[0], size0);
+      }
+    }
   });
 }
 
 static void sum_kernel_impl(TensorIterator& iter) {
+  if (iter.dtype() == ScalarType::Float || iter.dtype() == ScalarType::Double) {
+    AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "sum_cpu", [&] {
+      cascade_sum<scalar_t>(iter);
+    });
+    return;
+  }
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(
       ScalarType::BFloat16, ScalarType::Half, ScalarType::Bool, iter.dtype(), "sum_cpu", [&] {
         binary_kernel_reduce_vec(
@@ -293,5 +659,8 @@ REGISTER_DISPATCH(argmax_stub, &argmax_kernel_impl);
 REGISTER_DISPATCH(argmin_stub, &argmin_kernel_impl);
 REGISTER_DISPATCH(cumprod_stub, &cumprod_cpu_kernel);
 REGISTER_DISPATCH(cumsum_stub, &cumsum_cpu_kernel);
+REGISTER_DISPATCH(logcumsumexp_stub, &logcumsumexp_cpu_kernel);
+REGISTER_DISPATCH(cummax_stub, &cummax_cpu_kernel);
+REGISTER_DISPATCH(cummin_stub, &cummin_cpu_kernel);
 
 }}  // namespace at::native
@@ -1,8 +1,12 @@
 #include <ATen/native/ScatterGatherShapeChecks.h>
 #include <ATen/native/DispatchStub.h>
+#include <ATen/native/TensorAdvancedIndexing.h>
 #include <ATen/native/TensorIterator.h>
+#include <ATen/MemoryOverlap.h>
 #include <ATen/Parallel.h>
 
+#include <algorithm>
+
 namespace at { namespace native {
 
 namespace {
@@ -93,11 +97,35 @@ struct cpu_scatter_gather_base_kernel {
           auto* index_data_bytes = data[INDEX_ITER_STRIDE_IDX];
           auto* src_data_bytes = data[SRC_ITER_STRIDE_IDX];
 
+          // when the index is the same along the contiguous inner
+          // dimension, as for an index expanded over the feature dimension,
+          // every index entry selects a contiguous row, which is checked
+          // once and copied or reduced with a vectorizable inner loop
+          if ((dim != self.dim() - 1) &&
+              (strides[INDEX_ITER_STRIDE_IDX] == 0) &&
+              (strides[SELF_ITER_STRIDE_IDX] == sizeof(scalar_t)) &&
+              (strides[SRC_ITER_STRIDE_IDX] == sizeof(scalar_t))) {
+            for (int64_t i = 0; i < index_dim_size; ++i) {
+              int64_t idx_dim = ((int64_t*)index_data_bytes)[i * index_dim_stride];
+              TORCH_CHECK(idx_dim >= 0 && idx_dim < index_upper_bound,
+                "index ", idx_dim,
+                " is out of bounds for dimension ", dim,
+                " with size ", index_upper_bound
+              );
+              auto* self_row = (scalar_t*)self_data_bytes
+                + (is_scatter_like ? idx_dim : i) * self_dim_stride;
+              auto* src_row = (scalar_t*)src_data_bytes
+                + (is_scatter_like ? i : idx_dim) * src_dim_stride;
+              for (int64_t nelem = 0; nelem < n; ++nelem) {
+                f(self_row + nelem, src_row + nelem);
+              }
+            }
+          }
           // we change the order of TensorIterator-dim loop
           // vs dim-TensorIterator loop order depending on
           // whether dim is the last dimension and/or
           // whether `n` is smaller than `index_dim_size`
-          if ((dim == self.dim() - 1) || (n < index_dim_size)) {
+          else if ((dim == self.dim() - 1) || (n < index_dim_size)) {
             for (int64_t nelem = 0; nelem < n; ++nelem) {
               // dim loop is a separate code block
               // for better performance
@@ -147,7 +175,10 @@ struct cpu_scatter_gather_base_kernel {
           iter.serial_for_each(loop, {0, iter.numel()});
         }
         else {
-          iter.for_each(loop);
+          // every element of the iterator runs over the whole `dim`, so
+          // the grain size accounts for it
+          iter.for_each(loop, std::max<int64_t>(
+            internal::GRAIN_SIZE / std::max<int64_t>(index_dim_size, 1), 1));
         }
       }
     );
@@ -185,21 +216,59 @@ void scatter_fill_cpu_kernel(Tensor& self, int64_t dim, const Tensor& index, Sca
   );
 }
 
+// Different elements of the iterator differ in a dimension other than `dim`,
+// so they update different elements of `self` unless `self` overlaps with
+// itself: the reductions are split across them without conflicts, and every
+// element of `self` is reduced in the order of `dim`.
 void scatter_add_cpu_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
   cpu_scatter_gather_base_kernel<>()(
     self, dim, index, src,
     "scatter_add_", [] (auto* lhs, const auto* rhs) {
       *lhs += *rhs;
     },
-    /*serial_exec=*/true
+    /*serial_exec=*/has_internal_overlap(self) != MemOverlap::NO
   );
 }
 
+void scatter_reduce_cpu_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src,
+                               ScatterReduction reduce) {
+  const bool serial_exec = has_internal_overlap(self) != MemOverlap::NO;
+  switch (reduce) {
+    case ScatterReduction::SUM:
+      scatter_add_cpu_kernel(self, dim, index, src);
+      break;
+    case ScatterReduction::MAX:
+      cpu_scatter_gather_base_kernel<>()(
+        self, dim, index, src,
+        "scatter_max_", [] (auto* lhs, const auto* rhs) {
+          // propagates NaN, like max
+          if (*rhs > *lhs || *rhs != *rhs) {
+            *lhs = *rhs;
+          }
+        },
+        serial_exec
+      );
+      break;
+    case ScatterReduction::MIN:
+      cpu_scatter_gather_base_kernel<>()(
+        self, dim, index, src,
+        "scatter_min_", [] (auto* lhs, const auto* rhs) {
+          if (*rhs < *lhs || *rhs != *rhs) {
+            *lhs = *rhs;
+          }
+        },
+        serial_exec
+      );
+      break;
+  }
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(gather_stub, &gather_cpu_kernel);
 REGISTER_DISPATCH(scatter_stub, &scatter_cpu_kernel);
 REGISTER_DISPATCH(scatter_fill_stub, &scatter_fill_cpu_kernel);
 REGISTER_DISPATCH(scatter_add_stub, &scatter_add_cpu_kernel);
+REGISTER_DISPATCH(scatter_reduce_stub, &scatter_reduce_cpu_kernel);
 
 }} // namespace at::native
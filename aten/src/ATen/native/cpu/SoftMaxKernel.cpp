@@ -22,13 +22,18 @@
 namespace at { namespace native {
 namespace {
 
+// The kernels below compute in vec_compute_t<scalar_t>, which is float for
+// BFloat16: the vec256 helpers convert BFloat16 to float on load and back on
+// store, so the max and sum reductions accumulate in float.
+
 template <typename scalar_t>
 inline void _vec_log_softmax_lastdim(
     scalar_t* input_data_base,
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using accscalar_t = vec256::vec_compute_t<scalar_t>;
+  using Vec = vec256::Vec256<accscalar_t>;
   static constexpr int64_t CHUNK_SIZE = (128 / sizeof(scalar_t)) * Vec::size();
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size * CHUNK_SIZE);
   if (grain_size < CHUNK_SIZE)
@@ -40,24 +45,24 @@ inline void _vec_log_softmax_lastdim(
       grain_size,
       [&](int64_t begin, int64_t end) {
         for (int64_t ii = begin; ii < end; ii += CHUNK_SIZE) {
-          scalar_t tmp_sum_scalar[CHUNK_SIZE];
-          scalar_t max_input_arr[CHUNK_SIZE];
+          accscalar_t tmp_sum_scalar[CHUNK_SIZE];
+          accscalar_t max_input_arr[CHUNK_SIZE];
           int64_t loop_end = CHUNK_SIZE;
           if (ii + CHUNK_SIZE > end)
             loop_end = end - ii;
           for (int64_t j = 0; j < loop_end; j++) {
             int64_t i = ii + j;
-            scalar_t* input_data = input_data_base + i * dim_size;
-            max_input_arr[j] = vec256::reduce_all<scalar_t>(
+            const scalar_t* input_data = input_data_base + i * dim_size;
+            max_input_arr[j] = vec256::reduce_all(
                 [](Vec& x, Vec& y) { return vec256::maximum(x, y); },
                 input_data,
                 dim_size);
           }
           for (int64_t j = 0; j < loop_end; j++) {
             int64_t i = ii + j;
-            scalar_t* input_data = input_data_base + i * dim_size;
-            scalar_t max_input = max_input_arr[j];
-            tmp_sum_scalar[j] = vec256::map_reduce_all<scalar_t>(
+            const scalar_t* input_data = input_data_base + i * dim_size;
+            accscalar_t max_input = max_input_arr[j];
+            tmp_sum_scalar[j] = vec256::map_reduce_all(
                 [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
                 [](Vec x, Vec y) { return x + y; },
                 input_data,
@@ -72,11 +77,11 @@ inline void _vec_log_softmax_lastdim(
               loop_end);
           for (int64_t j = 0; j < loop_end; j++) {
             int64_t i = ii + j;
-            scalar_t* input_data = input_data_base + i * dim_size;
+            const scalar_t* input_data = input_data_base + i * dim_size;
             scalar_t* output_data = output_data_base + i * dim_size;
-            scalar_t tmp_sum = tmp_sum_scalar[j];
-            scalar_t max_input = max_input_arr[j];
-            
+            accscalar_t tmp_sum = tmp_sum_scalar[j];
+            accscalar_t max_input = max_input_arr[j];
+
             // It's necessary to keep the order of the operations below.
             // In some cases that input is large digits and the difference
             // is small, if we compute `max_input` plus `tmp_sum` before,
@@ -98,7 +103,8 @@ inline void _vec_softmax_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using accscalar_t = vec256::vec_compute_t<scalar_t>;
+  using Vec = vec256::Vec256<accscalar_t>;
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
   if (grain_size < 1)
     grain_size = 1;
@@ -109,9 +115,9 @@ inline void _vec_softmax_lastdim(
       grain_size,
       [&](int64_t begin, int64_t end) {
         for (int64_t i = begin; i < end; i++) {
-          scalar_t* input_data = input_data_base + i * dim_size;
+          const scalar_t* input_data = input_data_base + i * dim_size;
           scalar_t* output_data = output_data_base + i * dim_size;
-          scalar_t max_input = vec256::reduce_all<scalar_t>(
+          accscalar_t max_input = vec256::reduce_all(
               [](Vec& x, Vec& y) { return vec256::maximum(x, y); },
               input_data,
               dim_size);
@@ -120,7 +126,7 @@ inline void _vec_softmax_lastdim(
               output_data,
               input_data,
               dim_size);
-          scalar_t tmp_sum = vec256::reduce_all<scalar_t>(
+          accscalar_t tmp_sum = vec256::reduce_all(
               [](Vec x, Vec y) { return x + y; }, output_data, dim_size);
           tmp_sum = 1 / tmp_sum;
           vec256::map(
@@ -139,7 +145,8 @@ inline void _vec_host_softmax_backward_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using accscalar_t = vec256::vec_compute_t<scalar_t>;
+  using Vec = vec256::Vec256<accscalar_t>;
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
   if (grain_size < 1)
     grain_size = 1;
@@ -151,14 +158,14 @@ inline void _vec_host_softmax_backward_lastdim(
       [&](int64_t begin, int64_t end) {
         for (int64_t i = begin; i < end; i++) {
           scalar_t* grad_input_data = grad_input_data_base + i * dim_size;
-          scalar_t* grad_data = grad_data_base + i * dim_size;
-          scalar_t* output_data = output_data_base + i * dim_size;
-          scalar_t sum;
+          const scalar_t* grad_data = grad_data_base + i * dim_size;
+          const scalar_t* output_data = output_data_base + i * dim_size;
+          accscalar_t sum;
           if (log_softmax) {
-            sum = vec256::reduce_all<scalar_t>(
+            sum = vec256::reduce_all(
                 [](Vec& x, Vec& y) { return x + y; }, grad_data, dim_size);
           } else {
-            sum = vec256::map2_reduce_all<scalar_t>(
+            sum = vec256::map2_reduce_all(
                 [](Vec x, Vec y) { return x * y; },
                 [](Vec x, Vec y) { return x + y; },
                 grad_data,
@@ -184,6 +191,170 @@ inline void _vec_host_softmax_backward_lastdim(
       });
 }
 
+// Loads and stores for the kernels over a non-last dimension, which touch at
+// most one Vec256<vec_compute_t<scalar_t>> worth of elements at a time. The
+// BFloat16 overloads only use the lower half of the Vec256<BFloat16>.
+template <typename scalar_t>
+inline vec256::Vec256<scalar_t> _load_compute(
+    const scalar_t* data,
+    int64_t count) {
+  using Vec = vec256::Vec256<scalar_t>;
+  return count == Vec::size() ? Vec::loadu(data) : Vec::loadu(data, count);
+}
+
+inline vec256::Vec256<float> _load_compute(const BFloat16* data, int64_t count) {
+  using bVec = vec256::Vec256<BFloat16>;
+  return std::get<0>(vec256::convert_bfloat16_float(bVec::loadu(data, count)));
+}
+
+template <typename scalar_t>
+inline void _store_compute(
+    scalar_t* data,
+    const vec256::Vec256<scalar_t>& vec,
+    int64_t count) {
+  vec.store(data, count);
+}
+
+inline void _store_compute(
+    BFloat16* data,
+    const vec256::Vec256<float>& vec,
+    int64_t count) {
+  vec256::convert_float_bfloat16(vec, vec256::Vec256<float>(0))
+      .store(data, count);
+}
+
+// Softmax over a dimension that is not the last one. The elements of a
+// softmax slice are dim_stride = inner_size apart, but neighbouring slices are
+// contiguous, so each task computes Vec::size() slices at once with the inner
+// dimension as the vector lane. Work is split over outer_size x inner blocks.
+template <typename scalar_t, bool LogSoftMax>
+inline void _vec_softmax(
+    scalar_t* input_data_base,
+    scalar_t* output_data_base,
+    int64_t outer_size,
+    int64_t inner_size,
+    int64_t dim_size) {
+  using accscalar_t = vec256::vec_compute_t<scalar_t>;
+  using Vec = vec256::Vec256<accscalar_t>;
+  int64_t dim_stride = inner_size;
+  int64_t outer_stride = dim_size * dim_stride;
+  int64_t inner_blocks = divup(inner_size, (int64_t)Vec::size());
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size * Vec::size());
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size * inner_blocks,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          int64_t outer_idx = i / inner_blocks;
+          int64_t inner_idx = (i % inner_blocks) * Vec::size();
+          int64_t count =
+              std::min<int64_t>(Vec::size(), inner_size - inner_idx);
+          const scalar_t* input_data =
+              input_data_base + outer_idx * outer_stride + inner_idx;
+          scalar_t* output_data =
+              output_data_base + outer_idx * outer_stride + inner_idx;
+
+          Vec max_input = _load_compute(input_data, count);
+          for (int64_t d = 1; d < dim_size; d++) {
+            max_input = vec256::maximum(
+                max_input, _load_compute(input_data + d * dim_stride, count));
+          }
+
+          Vec tmp_sum(0);
+          for (int64_t d = 0; d < dim_size; d++) {
+            Vec z = (_load_compute(input_data + d * dim_stride, count) -
+                     max_input)
+                        .exp();
+            if (!LogSoftMax) {
+              _store_compute(output_data + d * dim_stride, z, count);
+            }
+            tmp_sum = tmp_sum + z;
+          }
+
+          if (LogSoftMax) {
+            tmp_sum = tmp_sum.log();
+          } else {
+            tmp_sum = Vec(1) / tmp_sum;
+          }
+
+          for (int64_t d = 0; d < dim_size; d++) {
+            Vec out;
+            if (LogSoftMax) {
+              // Same order of operations as _vec_log_softmax_lastdim
+              out = _load_compute(input_data + d * dim_stride, count) -
+                  max_input - tmp_sum;
+            } else {
+              out = _load_compute(output_data + d * dim_stride, count) *
+                  tmp_sum;
+            }
+            _store_compute(output_data + d * dim_stride, out, count);
+          }
+        }
+      });
+}
+
+template <typename scalar_t, bool LogSoftMax>
+inline void _vec_softmax_backward(
+    scalar_t* grad_input_data_base,
+    scalar_t* grad_data_base,
+    scalar_t* output_data_base,
+    int64_t outer_size,
+    int64_t inner_size,
+    int64_t dim_size) {
+  using accscalar_t = vec256::vec_compute_t<scalar_t>;
+  using Vec = vec256::Vec256<accscalar_t>;
+  int64_t dim_stride = inner_size;
+  int64_t outer_stride = dim_size * dim_stride;
+  int64_t inner_blocks = divup(inner_size, (int64_t)Vec::size());
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size * Vec::size());
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size * inner_blocks,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          int64_t outer_idx = i / inner_blocks;
+          int64_t inner_idx = (i % inner_blocks) * Vec::size();
+          int64_t count =
+              std::min<int64_t>(Vec::size(), inner_size - inner_idx);
+          int64_t offset = outer_idx * outer_stride + inner_idx;
+          scalar_t* grad_input_data = grad_input_data_base + offset;
+          const scalar_t* grad_data = grad_data_base + offset;
+          const scalar_t* output_data = output_data_base + offset;
+
+          Vec sum(0);
+          for (int64_t d = 0; d < dim_size; d++) {
+            Vec grad = _load_compute(grad_data + d * dim_stride, count);
+            if (LogSoftMax) {
+              sum = sum + grad;
+            } else {
+              sum = sum +
+                  grad * _load_compute(output_data + d * dim_stride, count);
+            }
+          }
+
+          for (int64_t d = 0; d < dim_size; d++) {
+            Vec grad = _load_compute(grad_data + d * dim_stride, count);
+            Vec output = _load_compute(output_data + d * dim_stride, count);
+            Vec grad_input;
+            if (LogSoftMax) {
+              grad_input = grad - output.exp() * sum;
+            } else {
+              grad_input = (grad - sum) * output;
+            }
+            _store_compute(grad_input_data + d * dim_stride, grad_input, count);
+          }
+        }
+      });
+}
+
 template <typename scalar_t, bool LogSoftMax>
 struct vec_host_softmax_lastdim {
   static void apply(Tensor& output, const Tensor& input) {
@@ -223,10 +394,55 @@ struct vec_host_softmax_backward_lastdim {
   }
 };
 
+template <typename scalar_t, bool LogSoftMax>
+struct vec_softmax {
+  static void apply(Tensor& output, const Tensor& input, int64_t dim) {
+    int64_t outer_size = 1;
+    int64_t dim_size = input.size(dim);
+    int64_t inner_size = 1;
+    for (int64_t i = 0; i < dim; ++i)
+      outer_size *= input.size(i);
+    for (int64_t i = dim + 1; i < input.dim(); ++i)
+      inner_size *= input.size(i);
+    scalar_t* input_data_base = input.data_ptr<scalar_t>();
+    scalar_t* output_data_base = output.data_ptr<scalar_t>();
+    _vec_softmax<scalar_t, LogSoftMax>(
+        input_data_base, output_data_base, outer_size, inner_size, dim_size);
+  }
+};
+
+template <typename scalar_t, bool LogSoftMax>
+struct vec_softmax_backward {
+  static void apply(
+      Tensor& grad_input,
+      const Tensor& grad,
+      const Tensor& output,
+      int64_t dim) {
+    int64_t outer_size = 1;
+    int64_t dim_size = grad.size(dim);
+    int64_t inner_size = 1;
+    for (int64_t i = 0; i < dim; ++i)
+      outer_size *= grad.size(i);
+    for (int64_t i = dim + 1; i < grad.dim(); ++i)
+      inner_size *= grad.size(i);
+    scalar_t* grad_input_data_base = grad_input.data_ptr<scalar_t>();
+    scalar_t* grad_data_base = grad.data_ptr<scalar_t>();
+    scalar_t* output_data_base = output.data_ptr<scalar_t>();
+    _vec_softmax_backward<scalar_t, LogSoftMax>(
+        grad_input_data_base,
+        grad_data_base,
+        output_data_base,
+        outer_size,
+        inner_size,
+        dim_size);
+  }
+};
+
 static void softmax_lastdim_kernel_impl(Tensor& result, const Tensor& self) {
-  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "softmax_lastdim_kernel_impl", [&] {
-    vec_host_softmax_lastdim<scalar_t, false>::apply(result, self);
-  });
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, self.scalar_type(),
+      "softmax_lastdim_kernel_impl",
+      [&] { vec_host_softmax_lastdim<scalar_t, false>::apply(result, self); });
 }
 
 static void log_softmax_lastdim_kernel_impl(
@@ -242,8 +458,9 @@ static void softmax_backward_lastdim_kernel_impl(
     Tensor& grad_input,
     const Tensor& grad,
     const Tensor& output) {
-  AT_DISPATCH_FLOATING_TYPES(
-      grad.scalar_type(), "softmax_backward_lastdim_kernel_impl", [&] {
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, grad.scalar_type(),
+      "softmax_backward_lastdim_kernel_impl", [&] {
         vec_host_softmax_backward_lastdim<scalar_t, false>::apply(
             grad_input, grad, output);
       });
@@ -261,6 +478,50 @@ static void log_softmax_backward_lastdim_kernel_impl(
       });
 }
 
+static void softmax_kernel_impl(
+    Tensor& result,
+    const Tensor& self,
+    int64_t dim) {
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, self.scalar_type(), "softmax_kernel_impl",
+      [&] { vec_softmax<scalar_t, false>::apply(result, self, dim); });
+}
+
+static void log_softmax_kernel_impl(
+    Tensor& result,
+    const Tensor& self,
+    int64_t dim) {
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, self.scalar_type(), "log_softmax_kernel_impl",
+      [&] { vec_softmax<scalar_t, true>::apply(result, self, dim); });
+}
+
+static void softmax_backward_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad,
+    const Tensor& output,
+    int64_t dim) {
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, grad.scalar_type(),
+      "softmax_backward_kernel_impl", [&] {
+        vec_softmax_backward<scalar_t, false>::apply(
+            grad_input, grad, output, dim);
+      });
+}
+
+static void log_softmax_backward_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad,
+    const Tensor& output,
+    int64_t dim) {
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, grad.scalar_type(),
+      "log_softmax_backward_kernel_impl", [&] {
+        vec_softmax_backward<scalar_t, true>::apply(
+            grad_input, grad, output, dim);
+      });
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(softmax_lastdim_kernel, &softmax_lastdim_kernel_impl);
@@ -272,4 +533,11 @@ REGISTER_DISPATCH(
     log_softmax_backward_lastdim_kernel,
     &log_softmax_backward_lastdim_kernel_impl);
 
+REGISTER_DISPATCH(softmax_kernel, &softmax_kernel_impl);
+REGISTER_DISPATCH(log_softmax_kernel, &log_softmax_kernel_impl);
+REGISTER_DISPATCH(softmax_backward_kernel, &softmax_backward_kernel_impl);
+REGISTER_DISPATCH(
+    log_softmax_backward_kernel,
+    &log_softmax_backward_kernel_impl);
+
 }} // namespace at::native
@@ -4,11 +4,101 @@
 #include <ATen/NumericUtils.h>
 #include <ATen/native/Sorting.h>
 #include <ATen/native/SortingUtils.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cpu/RadixSort.h>
+
+#include <numeric>
 
 namespace at { namespace native {
 
 namespace {
 
+// Slices at least this long are sorted with parallel radix passes when there
+// are too few of them to keep every thread busy otherwise.
+constexpr int64_t kParallelSortMinSize = 1 << 16;
+// Below this size topk and kthvalue sort the whole slice instead of selecting.
+constexpr int64_t kRadixSelectMinSize = 1024;
+
+// Calls loop(data, strides, n) for the slices along `dim` of `values` and
+// `indices` (and of `self`, if defined), where data holds the pointers to the
+// first element of each slice in that order. Slices are processed in parallel
+// if `parallel_slices`.
+template <typename loop_t>
+void _dim_apply(
+    const Tensor& values,
+    const Tensor& indices,
+    const Tensor& self,
+    int64_t dim,
+    bool parallel_slices,
+    const loop_t& loop) {
+  const auto& shape_tensor = self.defined() ? self : values;
+  auto iter = TensorIterator();
+  iter.dont_compute_common_dtype();
+  iter.dont_resize_outputs();
+  iter.declare_static_shape(shape_tensor.sizes(), dim);
+  iter.add_output(values);
+  iter.add_output(indices);
+  if (self.defined()) {
+    iter.add_input(self);
+  }
+  iter.build();
+
+  int64_t dim_size = std::max<int64_t>(1, shape_tensor.size(dim));
+  int64_t grain_size = parallel_slices
+      ? std::max<int64_t>(1, internal::GRAIN_SIZE / dim_size)
+      : iter.numel() + 1;
+  iter.for_each(loop, grain_size);
+}
+
+inline bool should_parallelize_slices(const Tensor& self, int64_t dim) {
+  int64_t dim_size = self.size(dim);
+  if (dim_size < kParallelSortMinSize) {
+    return true;
+  }
+  return self.numel() / dim_size >= at::get_num_threads();
+}
+
+static void sort_kernel(
+    Tensor& values,
+    Tensor& indices,
+    int64_t dim,
+    bool descending) {
+  const int64_t dim_size = values.size(dim);
+  const bool parallel_slices = should_parallelize_slices(values, dim);
+  const int64_t values_stride = values.stride(dim);
+  const int64_t indices_stride = indices.stride(dim);
+  AT_DISPATCH_ALL_TYPES_AND3(kBool, kHalf, kBFloat16, values.scalar_type(), "sort_cpu", [&] {
+    using key_t = typename radix_traits<scalar_t>::key_t;
+    _dim_apply(values, indices, Tensor(), dim, parallel_slices,
+      [&](char** data, const int64_t* strides, int64_t num_slices) {
+        // only allocated once per chunk of slices
+        std::vector<key_t> keys(dim_size), keys_buffer(dim_size);
+        std::vector<int64_t> idx(dim_size), idx_buffer(dim_size);
+        for (int64_t slice = 0; slice < num_slices; slice++) {
+          auto values_data = reinterpret_cast<scalar_t*>(data[0] + slice * strides[0]);
+          auto indices_data = reinterpret_cast<int64_t*>(data[1] + slice * strides[1]);
+          at::parallel_for(0, dim_size, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+            extract_radix_keys(
+                keys.data() + begin, values_data + begin * values_stride, values_stride,
+                end - begin, descending);
+            std::iota(idx.begin() + begin, idx.begin() + end, begin);
+          });
+          bool in_buffer = sort_keys_with_indices(
+              keys.data(), idx.data(), keys_buffer.data(), idx_buffer.data(),
+              dim_size, !parallel_slices);
+          const key_t* sorted_keys = in_buffer ? keys_buffer.data() : keys.data();
+          const int64_t* sorted_idx = in_buffer ? idx_buffer.data() : idx.data();
+          at::parallel_for(0, dim_size, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+            for (int64_t i = begin; i < end; i++) {
+              values_data[i * values_stride] = radix_value<scalar_t>(sorted_keys[i], descending);
+              indices_data[i * indices_stride] = sorted_idx[i];
+            }
+          });
+        }
+      });
+  });
+}
+
 static void topk_kernel(
     Tensor& values,
     Tensor& indices,
@@ -17,74 +107,165 @@ static void topk_kernel(
     int64_t dim,
     bool largest,
     bool sorted) {
+  if (k == 0) {
+    return;
+  }
+  const int64_t dim_size = self.size(dim);
+  const bool parallel_slices = should_parallelize_slices(self, dim);
+  const int64_t self_stride = self.stride(dim);
+  const int64_t values_stride = values.stride(dim);
+  const int64_t indices_stride = indices.stride(dim);
   AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
-    dim_apply(
-        {self, values, indices},
-        dim,
-        [&](int64_t i, TensorList tl) {
-          auto tmp_values = tl[0].accessor<scalar_t, 1>();
-          auto mode_values = tl[1].accessor<scalar_t, 1>();
-          auto mode_indices = tl[2].accessor<int64_t, 1>();
-
-          auto n = tmp_values.size(0);
-          auto use_partial_sort = k * 64 <= n;
-
-          using elem_t = std::pair<scalar_t, int64_t>;
-          std::vector<elem_t> queue(n);
-          for (int64_t j = 0; j < n; j++) {
-            queue[j].first = tmp_values[j];
-            queue[j].second = j;
+    using key_t = typename radix_traits<scalar_t>::key_t;
+    // Ordering by descending keys when `largest` makes the wanted elements
+    // the k smallest keys, with NaN on top as in numpy.
+    _dim_apply(values, indices, self, dim, parallel_slices,
+      [&](char** data, const int64_t* strides, int64_t num_slices) {
+        const int64_t buffer_size = dim_size < kRadixSelectMinSize ? dim_size : (sorted ? k : 0);
+        std::vector<key_t> keys(buffer_size), keys_buffer(buffer_size);
+        std::vector<int64_t> idx(buffer_size), idx_buffer(buffer_size);
+        for (int64_t slice = 0; slice < num_slices; slice++) {
+          auto values_data = reinterpret_cast<scalar_t*>(data[0] + slice * strides[0]);
+          auto indices_data = reinterpret_cast<int64_t*>(data[1] + slice * strides[1]);
+          auto self_data = reinterpret_cast<const scalar_t*>(data[2] + slice * strides[2]);
+
+          if (dim_size < kRadixSelectMinSize) {
+            extract_radix_keys(keys.data(), self_data, self_stride, dim_size, largest);
+            std::iota(idx.begin(), idx.end(), 0);
+            bool in_buffer = sort_keys_with_indices(
+                keys.data(), idx.data(), keys_buffer.data(), idx_buffer.data(),
+                dim_size, /*parallel=*/false);
+            const int64_t* sorted_idx = in_buffer ? idx_buffer.data() : idx.data();
+            for (int64_t i = 0; i < k; i++) {
+              values_data[i * values_stride] = self_data[sorted_idx[i] * self_stride];
+              indices_data[i * indices_stride] = sorted_idx[i];
+            }
+            continue;
           }
 
-          // we want NaN to be sorted as top for numpy compatibility
-          if (use_partial_sort) {
-            if (largest) {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-            } else {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
+          int64_t num_less;
+          const key_t kth = radix_select(
+              self_data, self_stride, dim_size, k - 1, largest, !parallel_slices, &num_less);
+          const int64_t num_equal = k - num_less;
+
+          // Write the elements below the k-th key, and the first num_equal
+          // elements equal to it, in index order.
+          const int64_t num_chunks = radix_num_chunks(dim_size, !parallel_slices);
+          std::vector<int64_t> less_offsets(num_chunks), equal_offsets(num_chunks);
+          radix_for_each_chunk(dim_size, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+            int64_t less = 0, equal = 0;
+            for (int64_t i = begin; i < end; i++) {
+              key_t key = radix_key(self_data[i * self_stride], largest);
+              less += key < kth;
+              equal += key == kth;
             }
-          } else {
-            if (largest) {
-              std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k - 1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                  });
-              }
-            } else {
-              std::nth_element(queue.begin(), queue.begin() + k -1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k -1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                  });
+            less_offsets[c] = less;
+            equal_offsets[c] = equal;
+          });
+          int64_t less_total = 0, equal_total = 0;
+          for (int64_t c = 0; c < num_chunks; c++) {
+            int64_t less = less_offsets[c], equal = equal_offsets[c];
+            less_offsets[c] = less_total;
+            equal_offsets[c] = equal_total;
+            less_total += less;
+            equal_total += equal;
+          }
+          radix_for_each_chunk(dim_size, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+            int64_t less_pos = less_offsets[c];
+            int64_t equal_pos = equal_offsets[c];
+            for (int64_t i = begin; i < end; i++) {
+              scalar_t value = self_data[i * self_stride];
+              key_t key = radix_key(value, largest);
+              int64_t pos;
+              if (key < kth) {
+                pos = less_pos++;
+              } else if (key == kth && equal_pos < num_equal) {
+                pos = num_less + equal_pos++;
+              } else {
+                continue;
               }
+              values_data[pos * values_stride] = value;
+              indices_data[pos * indices_stride] = i;
+            }
+          });
+
+          if (sorted) {
+            for (int64_t i = 0; i < k; i++) {
+              keys[i] = radix_key(values_data[i * values_stride], largest);
+              idx[i] = indices_data[i * indices_stride];
+            }
+            bool in_buffer = sort_keys_with_indices(
+                keys.data(), idx.data(), keys_buffer.data(), idx_buffer.data(),
+                k, !parallel_slices);
+            const int64_t* sorted_idx = in_buffer ? idx_buffer.data() : idx.data();
+            for (int64_t i = 0; i < k; i++) {
+              values_data[i * values_stride] = self_data[sorted_idx[i] * self_stride];
+              indices_data[i * indices_stride] = sorted_idx[i];
             }
           }
+        }
+      });
+  });
+}
+
+static void kthvalue_kernel(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t k,
+    int64_t dim) {
+  const int64_t dim_size = self.size(dim);
+  const bool parallel_slices = should_parallelize_slices(self, dim);
+  const int64_t self_stride = self.stride(dim);
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "kthvalue_cpu", [&] {
+    using key_t = typename radix_traits<scalar_t>::key_t;
+    _dim_apply(values, indices, self, dim, parallel_slices,
+      [&](char** data, const int64_t* strides, int64_t num_slices) {
+        const int64_t buffer_size = dim_size < kRadixSelectMinSize ? dim_size : 0;
+        std::vector<key_t> keys(buffer_size), keys_buffer(buffer_size);
+        std::vector<int64_t> idx(buffer_size), idx_buffer(buffer_size);
+        for (int64_t slice = 0; slice < num_slices; slice++) {
+          auto mode_value = reinterpret_cast<scalar_t*>(data[0] + slice * strides[0]);
+          auto mode_index = reinterpret_cast<int64_t*>(data[1] + slice * strides[1]);
+          auto self_data = reinterpret_cast<const scalar_t*>(data[2] + slice * strides[2]);
 
-          for (int64_t j = 0; j < k; j++) {
-            mode_values[j] = queue[j].first;
-            mode_indices[j] = queue[j].second;
+          int64_t index;
+          if (dim_size < kRadixSelectMinSize) {
+            extract_radix_keys(keys.data(), self_data, self_stride, dim_size, /*descending=*/false);
+            std::iota(idx.begin(), idx.end(), 0);
+            bool in_buffer = sort_keys_with_indices(
+                keys.data(), idx.data(), keys_buffer.data(), idx_buffer.data(),
+                dim_size, /*parallel=*/false);
+            index = (in_buffer ? idx_buffer : idx)[k - 1];
+          } else {
+            int64_t num_less;
+            const key_t kth = radix_select(
+                self_data, self_stride, dim_size, k - 1, /*descending=*/false,
+                !parallel_slices, &num_less);
+            // first element with the k-th key
+            const int64_t num_chunks = radix_num_chunks(dim_size, !parallel_slices);
+            std::vector<int64_t> first(num_chunks, dim_size);
+            radix_for_each_chunk(dim_size, num_chunks, [&](int64_t c, int64_t begin, int64_t end) {
+              for (int64_t i = begin; i < end; i++) {
+                if (radix_key(self_data[i * self_stride], false) == kth) {
+                  first[c] = i;
+                  break;
+                }
+              }
+            });
+            index = *std::min_element(first.begin(), first.end());
           }
-        });
+          *mode_value = self_data[index * self_stride];
+          *mode_index = index;
+        }
+      });
   });
 }
 
 } // anonymous namespace
 
+REGISTER_DISPATCH(sort_stub, &sort_kernel);
 REGISTER_DISPATCH(topk_stub, &topk_kernel);
+REGISTER_DISPATCH(kthvalue_stub, &kthvalue_kernel);
 
 }} //at::native
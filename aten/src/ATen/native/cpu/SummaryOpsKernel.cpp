@@ -0,0 +1,136 @@
+#include <ATen/native/SummaryOps.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at {
+namespace native {
+
+namespace {
+
+using namespace vec256;
+
+// Calls count(begin, end, hist) to add the elements [begin, end) of the input
+// to hist, a zeroed histogram of nbins bins of type hist_t, and writes the sum
+// of the histograms of all threads to out. Inputs that are small, or that
+// have fewer elements than the private histograms of all threads would have
+// bins, are counted into a single histogram instead.
+template <typename hist_t, typename out_t, typename F>
+void parallel_histogram(out_t* out, int64_t numel, int64_t nbins, const F& count) {
+  const int64_t num_threads = at::get_num_threads();
+  if (numel < internal::GRAIN_SIZE || num_threads == 1 ||
+      nbins * num_threads > numel || at::in_parallel_region()) {
+    std::vector<hist_t> hist(nbins, hist_t(0));
+    count(0, numel, hist.data());
+    std::transform(hist.begin(), hist.end(), out,
+                   [](hist_t h) { return static_cast<out_t>(h); });
+    return;
+  }
+  std::vector<hist_t> thread_hists(num_threads * nbins, hist_t(0));
+  at::parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    count(begin, end, thread_hists.data() + at::get_thread_num() * nbins);
+  });
+  const int64_t grain_size = std::max<int64_t>(internal::GRAIN_SIZE / num_threads, 1);
+  at::parallel_for(0, nbins, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      hist_t total = 0;
+      for (int64_t t = 0; t < num_threads; t++) {
+        total += thread_hists[t * nbins + b];
+      }
+      out[b] = static_cast<out_t>(total);
+    }
+  });
+}
+
+// The bins are counted as int64_t, so that large inputs don't lose counts to
+// the precision of a floating point histogram. The position of every element
+// in the range is computed with Vec256, with the arithmetic of the scalar
+// tail, so an element lands in the same bin wherever it is in the input.
+template <typename scalar_t>
+void histc_kernel_impl(Tensor& hist, const Tensor& self, scalar_t min, scalar_t max) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t nbins = hist.numel();
+  const scalar_t* self_data = self.data_ptr<scalar_t>();
+  const scalar_t range = max - min;
+  const scalar_t scale = static_cast<scalar_t>(nbins);
+  const Vec min_vec(min);
+  const Vec range_vec(range);
+  const Vec scale_vec(scale);
+  parallel_histogram<int64_t>(
+      hist.data_ptr<scalar_t>(), self.numel(), nbins,
+      [&](int64_t begin, int64_t end, int64_t* h) {
+        auto add = [&](scalar_t x, scalar_t pos) {
+          if (x >= min && x <= max) {
+            const int64_t bin = static_cast<int64_t>(pos);
+            h[std::min(bin, nbins - 1)] += 1;
+          }
+        };
+        scalar_t pos[Vec::size()];
+        int64_t i = begin;
+        for (; i + Vec::size() <= end; i += Vec::size()) {
+          ((Vec::loadu(self_data + i) - min_vec) / range_vec * scale_vec).store(pos);
+          for (int64_t j = 0; j < Vec::size(); j++) {
+            add(self_data[i + j], pos[j]);
+          }
+        }
+        for (; i < end; i++) {
+          add(self_data[i], (self_data[i] - min) / range * scale);
+        }
+      });
+}
+
+void histc_kernel(Tensor& hist, const Tensor& self, Scalar min, Scalar max) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "histc_cpu", [&] {
+    histc_kernel_impl<scalar_t>(hist, self, min.to<scalar_t>(), max.to<scalar_t>());
+  });
+}
+
+// Weighted counts are accumulated in the accumulate type of the weights, so
+// the private histograms of float weights are summed in double.
+template <typename input_t>
+void bincount_kernel_impl(Tensor& output, const Tensor& self, const Tensor& weights) {
+  const int64_t numel = self.numel();
+  const int64_t nbins = output.numel();
+  const input_t* self_data = self.data_ptr<input_t>();
+  if (!weights.defined()) {
+    parallel_histogram<int64_t>(
+        output.data_ptr<int64_t>(), numel, nbins,
+        [&](int64_t begin, int64_t end, int64_t* h) {
+          for (int64_t i = begin; i < end; i++) {
+            h[self_data[i]] += 1;
+          }
+        });
+    return;
+  }
+  AT_DISPATCH_FLOATING_TYPES(weights.scalar_type(), "bincount_cpu", [&] {
+    using acc_t = acc_type<scalar_t, /*is_cuda=*/false>;
+    const scalar_t* weights_data = weights.data_ptr<scalar_t>();
+    parallel_histogram<acc_t>(
+        output.data_ptr<scalar_t>(), numel, nbins,
+        [&](int64_t begin, int64_t end, acc_t* h) {
+          for (int64_t i = begin; i < end; i++) {
+            h[self_data[i]] += weights_data[i];
+          }
+        });
+  });
+}
+
+void bincount_kernel(Tensor& output, const Tensor& self, const Tensor& weights) {
+  AT_DISPATCH_INTEGRAL_TYPES(self.scalar_type(), "bincount_cpu", [&] {
+    bincount_kernel_impl<scalar_t>(output, self, weights);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(histc_stub, &histc_kernel);
+REGISTER_DISPATCH(bincount_stub, &bincount_kernel);
+
+} // namespace native
+} // namespace at
@@ -3,6 +3,12 @@
 #include <ATen/Dispatch.h>
 #include <ATen/native/UpSample.h>
 #include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace at {
 namespace native {
@@ -324,6 +330,222 @@ void cpu_upsample_nearest_backward(
   }
 }
 
+// Source indices and weights of an interpolation along one dimension: output
+// index o is the sum, over k < taps, of weight[o * taps + k] times the input
+// at index[o * taps + k]. The tables are computed once per call and shared by
+// every channel and every row of the input.
+template <typename scalar_t>
+struct InterpolationTable {
+  int64_t taps;
+  std::vector<int64_t> index;
+  std::vector<scalar_t> weight;
+};
+
+// The table of a dimension that the input doesn't have, e.g. the depth of a
+// 4d input.
+template <typename scalar_t>
+InterpolationTable<scalar_t> identity_table() {
+  return {1, {0}, {scalar_t(1)}};
+}
+
+template <typename scalar_t>
+InterpolationTable<scalar_t> linear_table(
+    int64_t input_size,
+    int64_t output_size,
+    bool align_corners,
+    c10::optional<double> scales) {
+  InterpolationTable<scalar_t> table{2, std::vector<int64_t>(2 * output_size),
+                                     std::vector<scalar_t>(2 * output_size)};
+  const scalar_t scale = area_pixel_compute_scale<scalar_t>(
+      input_size, output_size, align_corners, scales);
+  for (int64_t o = 0; o < output_size; o++) {
+    const scalar_t real = area_pixel_compute_source_index<scalar_t>(
+        scale, o, align_corners, /*cubic=*/false);
+    const int64_t i = real;
+    const int64_t ip = (i < input_size - 1) ? 1 : 0;
+    const scalar_t lambda = real - i;
+    table.index[2 * o] = i;
+    table.index[2 * o + 1] = i + ip;
+    table.weight[2 * o] = scalar_t(1) - lambda;
+    table.weight[2 * o + 1] = lambda;
+  }
+  return table;
+}
+
+template <typename scalar_t>
+InterpolationTable<scalar_t> cubic_table(
+    int64_t input_size,
+    int64_t output_size,
+    bool align_corners,
+    c10::optional<double> scales) {
+  InterpolationTable<scalar_t> table{4, std::vector<int64_t>(4 * output_size),
+                                     std::vector<scalar_t>(4 * output_size)};
+  const scalar_t scale = area_pixel_compute_scale<scalar_t>(
+      input_size, output_size, align_corners, scales);
+  for (int64_t o = 0; o < output_size; o++) {
+    const scalar_t real = area_pixel_compute_source_index<scalar_t>(
+        scale, o, align_corners, /*cubic=*/true);
+    const int64_t i = std::floor(real);
+    get_cubic_upsample_coefficients<scalar_t>(&table.weight[4 * o], real - i);
+    for (int64_t k = 0; k < 4; k++) {
+      table.index[4 * o + k] =
+          std::max<int64_t>(std::min<int64_t>(i - 1 + k, input_size - 1), 0);
+    }
+  }
+  return table;
+}
+
+// Interpolates an [N, C, D, H, W] input, where D and H are 1 for 3d and 4d
+// inputs, with the tables of its three spatial dimensions.
+//
+// In contiguous format every output row is computed from one row of the
+// input interpolated along D and H, which is a vectorized weighted sum of
+// whole input rows; the interpolation along W then reads that row through
+// the table of W. In channels last format every output pixel is a weighted
+// sum of input pixels, which is vectorized over the channels.
+template <typename scalar_t>
+void cpu_upsample_interpolate(
+    Tensor& output_,
+    const Tensor& input_,
+    const InterpolationTable<scalar_t>& table_d,
+    const InterpolationTable<scalar_t>& table_h,
+    const InterpolationTable<scalar_t>& table_w) {
+  TORCH_CHECK(input_.dtype() == output_.dtype(), "expected dtype ", input_.dtype(),
+              " for `output` but got dtype ", output_.dtype());
+  using Vec = vec256::Vec256<scalar_t>;
+
+  auto input_sizes = input_.sizes().vec();
+  auto output_sizes = output_.sizes().vec();
+  auto ndim = input_sizes.size();
+
+  if (input_sizes == output_sizes) {
+    output_.copy_(input_);
+    return;
+  }
+
+  int64_t num_batches = input_sizes[0];
+  int64_t channels = input_sizes[1];
+  int64_t input_depth = (ndim == 5) ? input_sizes[2] : 1;
+  int64_t output_depth = (ndim == 5) ? output_sizes[2] : 1;
+  int64_t input_height = (ndim >= 4) ? input_sizes[ndim - 2] : 1;
+  int64_t output_height = (ndim >= 4) ? output_sizes[ndim - 2] : 1;
+  int64_t input_width = input_sizes[ndim - 1];
+  int64_t output_width = output_sizes[ndim - 1];
+
+  const int64_t taps_d = table_d.taps;
+  const int64_t taps_h = table_h.taps;
+  const int64_t taps_w = table_w.taps;
+
+  auto memory_format = at::MemoryFormat::Contiguous;
+  if (ndim == 4 && input_.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    memory_format = at::MemoryFormat::ChannelsLast;
+  } else if (ndim == 5 && input_.is_contiguous(at::MemoryFormat::ChannelsLast3d)) {
+    memory_format = at::MemoryFormat::ChannelsLast3d;
+  }
+  auto input = input_.contiguous(memory_format);
+  auto output = output_.contiguous(memory_format);
+  auto input_data = input.data_ptr<scalar_t>();
+  auto output_data = output.data_ptr<scalar_t>();
+
+  auto loop_contiguous = [&](int64_t begin, int64_t end) {
+    int64_t nc = 0;
+    int64_t od = 0;
+    int64_t oh = 0;
+    data_index_init(begin, nc, num_batches * channels, od, output_depth, oh, output_height);
+    const bool interpolate_rows = taps_d * taps_h > 1;
+    std::vector<scalar_t> buffer(interpolate_rows ? input_width : 0);
+
+    for (int64_t i = begin; i < end; i++) {
+      const scalar_t* in = input_data + nc * input_depth * input_height * input_width;
+      const scalar_t* row = in +
+          (table_d.index[od * taps_d] * input_height + table_h.index[oh * taps_h]) * input_width;
+      if (interpolate_rows) {
+        bool first = true;
+        for (int64_t kd = 0; kd < taps_d; kd++) {
+          for (int64_t kh = 0; kh < taps_h; kh++) {
+            const scalar_t w = table_d.weight[od * taps_d + kd] * table_h.weight[oh * taps_h + kh];
+            const scalar_t* src = in +
+                (table_d.index[od * taps_d + kd] * input_height +
+                 table_h.index[oh * taps_h + kh]) * input_width;
+            if (first) {
+              vec256::map([w](Vec x) { return x * Vec(w); }, buffer.data(), src, input_width);
+              first = false;
+            } else {
+              vec256::map2(
+                  [w](Vec acc, Vec x) { return acc + x * Vec(w); },
+                  buffer.data(), buffer.data(), src, input_width);
+            }
+          }
+        }
+        row = buffer.data();
+      }
+
+      scalar_t* out = output_data + i * output_width;
+      for (int64_t ow = 0; ow < output_width; ow++) {
+        const int64_t* index = &table_w.index[ow * taps_w];
+        const scalar_t* weight = &table_w.weight[ow * taps_w];
+        scalar_t sum = weight[0] * row[index[0]];
+        for (int64_t kw = 1; kw < taps_w; kw++) {
+          sum += weight[kw] * row[index[kw]];
+        }
+        out[ow] = sum;
+      }
+      data_index_step(nc, num_batches * channels, od, output_depth, oh, output_height);
+    }
+  };
+
+  auto loop_channels_last = [&](int64_t begin, int64_t end) {
+    int64_t n = 0;
+    int64_t od = 0;
+    int64_t oh = 0;
+    int64_t ow = 0;
+    data_index_init(begin, n, num_batches, od, output_depth, oh, output_height, ow, output_width);
+
+    for (int64_t i = begin; i < end; i++) {
+      const scalar_t* in = input_data + n * input_depth * input_height * input_width * channels;
+      scalar_t* out = output_data + i * channels;
+      bool first = true;
+      for (int64_t kd = 0; kd < taps_d; kd++) {
+        for (int64_t kh = 0; kh < taps_h; kh++) {
+          const scalar_t w_dh = table_d.weight[od * taps_d + kd] * table_h.weight[oh * taps_h + kh];
+          const int64_t offset_dh =
+              table_d.index[od * taps_d + kd] * input_height + table_h.index[oh * taps_h + kh];
+          for (int64_t kw = 0; kw < taps_w; kw++) {
+            const scalar_t w = w_dh * table_w.weight[ow * taps_w + kw];
+            const scalar_t* src = in +
+                (offset_dh * input_width + table_w.index[ow * taps_w + kw]) * channels;
+            if (first) {
+              vec256::map([w](Vec x) { return x * Vec(w); }, out, src, channels);
+              first = false;
+            } else {
+              vec256::map2(
+                  [w](Vec acc, Vec x) { return acc + x * Vec(w); },
+                  out, out, src, channels);
+            }
+          }
+        }
+      }
+      data_index_step(n, num_batches, od, output_depth, oh, output_height, ow, output_width);
+    }
+  };
+
+  if (memory_format == at::MemoryFormat::Contiguous) {
+    at::parallel_for(
+        0, num_batches * channels * output_depth * output_height,
+        std::max<int64_t>(at::internal::GRAIN_SIZE / (output_width * taps_w), 1),
+        loop_contiguous);
+  } else {
+    at::parallel_for(
+        0, num_batches * output_depth * output_height * output_width,
+        std::max<int64_t>(at::internal::GRAIN_SIZE / (channels * taps_d * taps_h * taps_w), 1),
+        loop_channels_last);
+  }
+
+  if (!output_.is_contiguous(memory_format)) {
+    output_.copy_(output);
+  }
+}
+
 using scale_t = std::vector<c10::optional<double>>;
 void upsample_nearest1d_kernel_impl(
     Tensor& output,
@@ -367,6 +589,62 @@ void upsample_nearest3d_kernel_impl(
   }
 }
 
+void upsample_linear1d_kernel_impl(
+    Tensor& output,
+    const Tensor& input,
+    bool align_corners,
+    c10::optional<double> scales_w) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "upsample_linear1d", [&] {
+    cpu_upsample_interpolate<scalar_t>(
+        output, input, identity_table<scalar_t>(), identity_table<scalar_t>(),
+        linear_table<scalar_t>(input.size(2), output.size(2), align_corners, scales_w));
+  });
+}
+
+void upsample_bilinear2d_kernel_impl(
+    Tensor& output,
+    const Tensor& input,
+    bool align_corners,
+    c10::optional<double> scales_h,
+    c10::optional<double> scales_w) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "upsample_bilinear2d", [&] {
+    cpu_upsample_interpolate<scalar_t>(
+        output, input, identity_table<scalar_t>(),
+        linear_table<scalar_t>(input.size(2), output.size(2), align_corners, scales_h),
+        linear_table<scalar_t>(input.size(3), output.size(3), align_corners, scales_w));
+  });
+}
+
+void upsample_trilinear3d_kernel_impl(
+    Tensor& output,
+    const Tensor& input,
+    bool align_corners,
+    c10::optional<double> scales_d,
+    c10::optional<double> scales_h,
+    c10::optional<double> scales_w) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "upsample_trilinear3d", [&] {
+    cpu_upsample_interpolate<scalar_t>(
+        output, input,
+        linear_table<scalar_t>(input.size(2), output.size(2), align_corners, scales_d),
+        linear_table<scalar_t>(input.size(3), output.size(3), align_corners, scales_h),
+        linear_table<scalar_t>(input.size(4), output.size(4), align_corners, scales_w));
+  });
+}
+
+void upsample_bicubic2d_kernel_impl(
+    Tensor& output,
+    const Tensor& input,
+    bool align_corners,
+    c10::optional<double> scales_h,
+    c10::optional<double> scales_w) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "upsample_bicubic2d", [&] {
+    cpu_upsample_interpolate<scalar_t>(
+        output, input, identity_table<scalar_t>(),
+        cubic_table<scalar_t>(input.size(2), output.size(2), align_corners, scales_h),
+        cubic_table<scalar_t>(input.size(3), output.size(3), align_corners, scales_w));
+  });
+}
+
 void upsample_nearest1d_backward_kernel_impl(
     Tensor& grad_input,
     const Tensor& grad_output,
@@ -406,6 +684,10 @@ REGISTER_DISPATCH(upsample_nearest3d_kernel, &upsample_nearest3d_kernel_impl);
 REGISTER_DISPATCH(upsample_nearest1d_backward_kernel, &upsample_nearest1d_backward_kernel_impl);
 REGISTER_DISPATCH(upsample_nearest2d_backward_kernel, &upsample_nearest2d_backward_kernel_impl);
 REGISTER_DISPATCH(upsample_nearest3d_backward_kernel, &upsample_nearest3d_backward_kernel_impl);
+REGISTER_DISPATCH(upsample_linear1d_kernel, &upsample_linear1d_kernel_impl);
+REGISTER_DISPATCH(upsample_bilinear2d_kernel, &upsample_bilinear2d_kernel_impl);
+REGISTER_DISPATCH(upsample_trilinear3d_kernel, &upsample_trilinear3d_kernel_impl);
+REGISTER_DISPATCH(upsample_bicubic2d_kernel, &upsample_bicubic2d_kernel_impl);
 
 } // namespace native
 } // namespace at
@@ -1,8 +1,13 @@
 #include <ATen/native/batch_norm.h>
 
+#include <algorithm>
+#include <vector>
+
 #include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
 #include <ATen/CPUApplyUtils.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 
@@ -107,8 +112,196 @@ void batch_norm_cpu_inference_contiguous_kernel(Tensor& output, const Tensor& in
   });
 }
 
+// The channels last kernels below view their inputs as [M, C] matrices with
+// contiguous rows, split the rows across threads and vectorize over channels.
+// Each per-channel value is written once, as a generic lambda over the type of
+// its operands, and run on Vec256 for the bulk of a row and on scalars for
+// the rest.
+template <typename scalar_t>
+inline scalar_t load(const scalar_t* ptr, scalar_t /* tag */) {
+  return *ptr;
+}
+
+template <typename scalar_t>
+inline Vec256<scalar_t> load(const scalar_t* ptr, Vec256<scalar_t> /* tag */) {
+  return Vec256<scalar_t>::loadu(ptr);
+}
+
+template <typename scalar_t>
+inline void store(scalar_t* ptr, scalar_t value) {
+  *ptr = value;
+}
+
+template <typename scalar_t>
+inline void store(scalar_t* ptr, Vec256<scalar_t> value) {
+  value.store(ptr);
+}
+
+// Calls f(m, c, tag) for every vector, then every scalar, of the channels
+// [c_begin, c_end) of row m, where tag is a Vec256<scalar_t> or a scalar_t.
+template <typename scalar_t, typename F>
+inline void for_each_channel(int64_t m, int64_t c_begin, int64_t c_end, const F& f) {
+  using Vec = Vec256<scalar_t>;
+  int64_t c = c_begin;
+  for (; c + Vec::size() <= c_end; c += Vec::size()) {
+    f(m, c, Vec());
+  }
+  for (; c < c_end; c++) {
+    f(m, c, scalar_t());
+  }
+}
+
+// Rows summed in scalar_t before they are added to the accumulators of a thread.
+constexpr int64_t kChannelsLastSumBlock = 256;
+
+// Sums f(m, c, tag) over the M rows of every channel c into sum. Few rows are
+// split across threads by channels; otherwise the rows are split, with an
+// accumulator of C channels for every thread.
+template <typename scalar_t, typename F>
+void channels_last_sum(int64_t M, int64_t C, scalar_t* sum, const F& f) {
+  using accscalar_t = at::acc_type<scalar_t, false>;
+  if (M <= kChannelsLastSumBlock) {
+    const int64_t grain_size = std::max<int64_t>(internal::GRAIN_SIZE / M, 1);
+    at::parallel_for(0, C, grain_size, [&](int64_t begin, int64_t end) {
+      std::vector<scalar_t> block_sum(end - begin, scalar_t(0));
+      scalar_t* block_sum_data = block_sum.data() - begin;
+      for (int64_t m = 0; m < M; m++) {
+        for_each_channel<scalar_t>(m, begin, end, [&](int64_t row, int64_t c, auto tag) {
+          store(block_sum_data + c, load(block_sum_data + c, tag) + f(row, c, tag));
+        });
+      }
+      std::copy(block_sum.begin(), block_sum.end(), sum + begin);
+    });
+    return;
+  }
+  const int64_t num_threads = at::get_num_threads();
+  std::vector<accscalar_t> thread_sums(num_threads * C, 0);
+  const int64_t grain_size = std::max<int64_t>(internal::GRAIN_SIZE / C, 1);
+  at::parallel_for(0, M, grain_size, [&](int64_t begin, int64_t end) {
+    accscalar_t* thread_sum = thread_sums.data() + at::get_thread_num() * C;
+    std::vector<scalar_t> block_sum(C);
+    for (int64_t block_begin = begin; block_begin < end; block_begin += kChannelsLastSumBlock) {
+      const int64_t block_end = std::min(block_begin + kChannelsLastSumBlock, end);
+      std::fill(block_sum.begin(), block_sum.end(), scalar_t(0));
+      for (int64_t m = block_begin; m < block_end; m++) {
+        for_each_channel<scalar_t>(m, 0, C, [&](int64_t row, int64_t c, auto tag) {
+          store(&block_sum[c], load(&block_sum[c], tag) + f(row, c, tag));
+        });
+      }
+      for (int64_t c = 0; c < C; c++) {
+        thread_sum[c] += block_sum[c];
+      }
+    }
+  });
+  for (int64_t c = 0; c < C; c++) {
+    accscalar_t total = 0;
+    for (int64_t t = 0; t < num_threads; t++) {
+      total += thread_sums[t * C + c];
+    }
+    sum[c] = total;
+  }
+}
+
+// Calls f(m, c, tag) for every channel of every row, split across threads as
+// ranges of the M * C elements.
+template <typename scalar_t, typename F>
+void channels_last_for_each(int64_t M, int64_t C, const F& f) {
+  at::parallel_for(0, M * C, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    int64_t i = begin;
+    while (i < end) {
+      const int64_t m = i / C;
+      const int64_t c_begin = i % C;
+      const int64_t c_end = std::min(C, c_begin + end - i);
+      for_each_channel<scalar_t>(m, c_begin, c_end, f);
+      i += c_end - c_begin;
+    }
+  });
+}
+
+void batch_norm_cpu_collect_stats_channels_last_kernel(
+    Tensor& mean, Tensor& var_sum, const Tensor& input) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "batch_norm_cpu_collect_stats_channels_last", [&] {
+    const int64_t C = input.size(1);
+    const int64_t M = input.numel() / C;
+    const scalar_t* input_data = input.data_ptr<scalar_t>();
+    scalar_t* mean_data = mean.data_ptr<scalar_t>();
+    scalar_t* var_sum_data = var_sum.data_ptr<scalar_t>();
+    channels_last_sum<scalar_t>(M, C, mean_data, [&](int64_t m, int64_t c, auto tag) {
+      return load(input_data + m * C + c, tag);
+    });
+    for (int64_t c = 0; c < C; c++) {
+      mean_data[c] /= M;
+    }
+    channels_last_sum<scalar_t>(M, C, var_sum_data, [&](int64_t m, int64_t c, auto tag) {
+      using T = decltype(tag);
+      const T x = load(input_data + m * C + c, tag) - load(mean_data + c, tag);
+      return x * x;
+    });
+  });
+}
+
+void batch_norm_cpu_transform_channels_last_kernel(
+    Tensor& output, const Tensor& input, const Tensor& alpha, const Tensor& beta) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "batch_norm_cpu_transform_channels_last", [&] {
+    const int64_t C = input.size(1);
+    const int64_t M = input.numel() / C;
+    const scalar_t* input_data = input.data_ptr<scalar_t>();
+    const scalar_t* alpha_data = alpha.data_ptr<scalar_t>();
+    const scalar_t* beta_data = beta.data_ptr<scalar_t>();
+    scalar_t* output_data = output.data_ptr<scalar_t>();
+    channels_last_for_each<scalar_t>(M, C, [&](int64_t m, int64_t c, auto tag) {
+      store(output_data + m * C + c,
+            load(input_data + m * C + c, tag) * load(alpha_data + c, tag) + load(beta_data + c, tag));
+    });
+  });
+}
+
+void batch_norm_cpu_backward_reduce_channels_last_kernel(
+    Tensor& sum_dy, Tensor& dot_p, const Tensor& grad_out, const Tensor& input,
+    const Tensor& mean) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "batch_norm_cpu_backward_reduce_channels_last", [&] {
+    const int64_t C = input.size(1);
+    const int64_t M = input.numel() / C;
+    const scalar_t* grad_out_data = grad_out.data_ptr<scalar_t>();
+    const scalar_t* input_data = input.data_ptr<scalar_t>();
+    const scalar_t* mean_data = mean.data_ptr<scalar_t>();
+    channels_last_sum<scalar_t>(M, C, sum_dy.data_ptr<scalar_t>(), [&](int64_t m, int64_t c, auto tag) {
+      return load(grad_out_data + m * C + c, tag);
+    });
+    channels_last_sum<scalar_t>(M, C, dot_p.data_ptr<scalar_t>(), [&](int64_t m, int64_t c, auto tag) {
+      return (load(input_data + m * C + c, tag) - load(mean_data + c, tag)) *
+          load(grad_out_data + m * C + c, tag);
+    });
+  });
+}
+
+void batch_norm_cpu_backward_elemt_channels_last_kernel(
+    Tensor& grad_input, const Tensor& grad_out, const Tensor& input,
+    const Tensor& a, const Tensor& b, const Tensor& c) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "batch_norm_cpu_backward_elemt_channels_last", [&] {
+    const int64_t C = input.size(1);
+    const int64_t M = input.numel() / C;
+    const scalar_t* grad_out_data = grad_out.data_ptr<scalar_t>();
+    const scalar_t* input_data = input.data_ptr<scalar_t>();
+    const scalar_t* a_data = a.data_ptr<scalar_t>();
+    const scalar_t* b_data = b.data_ptr<scalar_t>();
+    const scalar_t* c_data = c.data_ptr<scalar_t>();
+    scalar_t* grad_input_data = grad_input.data_ptr<scalar_t>();
+    channels_last_for_each<scalar_t>(M, C, [&](int64_t m, int64_t ch, auto tag) {
+      store(grad_input_data + m * C + ch,
+            load(grad_out_data + m * C + ch, tag) * load(a_data + ch, tag) +
+            load(input_data + m * C + ch, tag) * load(b_data + ch, tag) +
+            load(c_data + ch, tag));
+    });
+  });
+}
+
 }// anonymous namespace
 
 REGISTER_DISPATCH(batch_norm_cpu_inference_contiguous_stub, &batch_norm_cpu_inference_contiguous_kernel);
+REGISTER_DISPATCH(batch_norm_cpu_collect_stats_channels_last_stub, &batch_norm_cpu_collect_stats_channels_last_kernel);
+REGISTER_DISPATCH(batch_norm_cpu_transform_channels_last_stub, &batch_norm_cpu_transform_channels_last_kernel);
+REGISTER_DISPATCH(batch_norm_cpu_backward_reduce_channels_last_stub, &batch_norm_cpu_backward_reduce_channels_last_kernel);
+REGISTER_DISPATCH(batch_norm_cpu_backward_elemt_channels_last_stub, &batch_norm_cpu_backward_elemt_channels_last_kernel);
 
 }} // namespace at::native
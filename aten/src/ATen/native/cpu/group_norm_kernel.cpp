@@ -0,0 +1,268 @@
+#include <ATen/native/group_norm.h>
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// Mean and M2, the sum of the squared deviations from the mean, of x[0, n),
+// in one pass. Every lane of a Vec256 runs Welford's algorithm over its own
+// elements, and the lanes and the tail are then combined pairwise.
+template <typename T>
+std::pair<T, T> WelfordMeanM2(const T* x, int64_t n) {
+  using Vec = vec256::Vec256<T>;
+  const int64_t vec_n = n / Vec::size();
+  Vec mean_vec(0);
+  Vec m2_vec(0);
+  for (int64_t i = 0; i < vec_n; ++i) {
+    const Vec x_vec = Vec::loadu(x + i * Vec::size());
+    const Vec delta = x_vec - mean_vec;
+    mean_vec = mean_vec + delta * Vec(T(1) / static_cast<T>(i + 1));
+    m2_vec = m2_vec + delta * (x_vec - mean_vec);
+  }
+  T mean = 0;
+  T m2 = 0;
+  int64_t count = 0;
+  if (vec_n > 0) {
+    T lane_mean[Vec::size()];
+    T lane_m2[Vec::size()];
+    mean_vec.store(lane_mean);
+    m2_vec.store(lane_m2);
+    for (int64_t j = 0; j < Vec::size(); ++j) {
+      const int64_t new_count = count + vec_n;
+      const T delta = lane_mean[j] - mean;
+      const T ratio = static_cast<T>(vec_n) / static_cast<T>(new_count);
+      mean += delta * ratio;
+      m2 += lane_m2[j] + delta * delta * static_cast<T>(count) * ratio;
+      count = new_count;
+    }
+  }
+  for (int64_t i = vec_n * Vec::size(); i < n; ++i) {
+    ++count;
+    const T delta = x[i] - mean;
+    mean += delta / static_cast<T>(count);
+    m2 += delta * (x[i] - mean);
+  }
+  return std::make_pair(mean, m2);
+}
+
+template <typename T>
+void GroupNormKernelImplInternal(
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    T eps,
+    Tensor* Y,
+    Tensor* mean,
+    Tensor* rstd) {
+  using Vec = vec256::Vec256<T>;
+  DCHECK_EQ(X.numel(), N * C * HxW);
+  DCHECK(!gamma.defined() || gamma.numel() == C);
+  DCHECK(!beta.defined() || beta.numel() == C);
+  const int64_t G = group;
+  const int64_t D = C / G;
+  const T* X_data = X.data_ptr<T>();
+  const T* gamma_data = gamma.defined() ? gamma.data_ptr<T>() : nullptr;
+  const T* beta_data = beta.defined() ? beta.data_ptr<T>() : nullptr;
+  T* Y_data = Y->data_ptr<T>();
+  T* mean_data = mean->data_ptr<T>();
+  T* rstd_data = rstd->data_ptr<T>();
+  const T s = T(1) / static_cast<T>(D * HxW);
+  const int64_t grain_size =
+      std::max<int64_t>(internal::GRAIN_SIZE / std::max<int64_t>(D * HxW, 1), 1);
+  // Every (n, g) is one contiguous block of D * HxW elements.
+  at::parallel_for(0, N * G, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; ++i) {
+      const T* X_ptr = X_data + i * D * HxW;
+      T* Y_ptr = Y_data + i * D * HxW;
+      T mean_val;
+      T m2;
+      std::tie(mean_val, m2) = WelfordMeanM2(X_ptr, D * HxW);
+      const T rstd_val = T(1) / std::sqrt(std::max(m2 * s, T(0)) + eps);
+      const int64_t g = i % G;
+      for (int64_t j = 0; j < D; ++j) {
+        const int64_t c = g * D + j;
+        const T scale = rstd_val * (gamma_data == nullptr ? T(1) : gamma_data[c]);
+        const T bias = (beta_data == nullptr ? T(0) : beta_data[c]) - scale * mean_val;
+        vec256::map(
+            [scale, bias](Vec x) { return x * Vec(scale) + Vec(bias); },
+            Y_ptr + j * HxW,
+            X_ptr + j * HxW,
+            HxW);
+      }
+      mean_data[i] = mean_val;
+      rstd_data[i] = rstd_val;
+    }
+  });
+}
+
+void GroupNormKernelImpl(
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps,
+    Tensor* Y,
+    Tensor* mean,
+    Tensor* rstd) {
+  AT_DISPATCH_FLOATING_TYPES(X.scalar_type(), "GroupNormKernelImpl", [&]() {
+    GroupNormKernelImplInternal<scalar_t>(
+        X, gamma, beta, N, C, HxW, group, static_cast<scalar_t>(eps), Y, mean, rstd);
+  });
+}
+
+template <typename T>
+void GroupNormBackwardKernelImplInternal(
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    Tensor* dX,
+    Tensor* dgamma,
+    Tensor* dbeta) {
+  using Vec = vec256::Vec256<T>;
+  DCHECK_EQ(dY.numel(), N * C * HxW);
+  DCHECK_EQ(X.numel(), N * C * HxW);
+  DCHECK_EQ(mean.numel(), N * group);
+  DCHECK_EQ(rstd.numel(), N * group);
+  DCHECK(!gamma.defined() || gamma.numel() == C);
+  const int64_t G = group;
+  const int64_t D = C / G;
+  const T* dY_data = dY.data_ptr<T>();
+  const T* X_data = X.data_ptr<T>();
+  const T* mean_data = mean.data_ptr<T>();
+  const T* rstd_data = rstd.data_ptr<T>();
+  const T* gamma_data = gamma.defined() ? gamma.data_ptr<T>() : nullptr;
+  T* dX_data = dX->defined() ? dX->data_ptr<T>() : nullptr;
+  T* dgamma_data = dgamma->defined() ? dgamma->data_ptr<T>() : nullptr;
+  T* dbeta_data = dbeta->defined() ? dbeta->data_ptr<T>() : nullptr;
+
+  // ds(n, c) = sum(dY * X) and db(n, c) = sum(dY) over the HxW elements of
+  // every channel of every sample, from which all three gradients follow.
+  std::vector<T> ds(N * C);
+  std::vector<T> db(N * C);
+  const int64_t grain_size =
+      std::max<int64_t>(internal::GRAIN_SIZE / std::max<int64_t>(HxW, 1), 1);
+  at::parallel_for(0, N * C, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; ++i) {
+      const T* dY_ptr = dY_data + i * HxW;
+      const T* X_ptr = X_data + i * HxW;
+      ds[i] = vec256::map2_reduce_all<T>(
+          [](Vec x, Vec y) { return x * y; },
+          [](Vec x, Vec y) { return x + y; },
+          dY_ptr,
+          X_ptr,
+          HxW);
+      db[i] = vec256::reduce_all<T>(
+          [](Vec& x, Vec& y) { return x + y; },
+          dY_ptr,
+          HxW);
+    }
+  });
+
+  if (dX_data != nullptr) {
+    const T s = T(1) / static_cast<T>(D * HxW);
+    at::parallel_for(0, N * G, 1, [&](int64_t start, int64_t end) {
+      for (int64_t i = start; i < end; ++i) {
+        const int64_t g = i % G;
+        const T mean_val = mean_data[i];
+        const T rstd_val = rstd_data[i];
+        T ds_val = 0;
+        T db_val = 0;
+        for (int64_t j = 0; j < D; ++j) {
+          const T gamma_v = gamma_data == nullptr ? T(1) : gamma_data[g * D + j];
+          ds_val += ds[i * D + j] * gamma_v;
+          db_val += db[i * D + j] * gamma_v;
+        }
+        const T b = (db_val * mean_val - ds_val) * rstd_val * rstd_val * rstd_val * s;
+        const T c = -b * mean_val - db_val * rstd_val * s;
+        for (int64_t j = 0; j < D; ++j) {
+          const T gamma_v = gamma_data == nullptr ? T(1) : gamma_data[g * D + j];
+          const T a = rstd_val * gamma_v;
+          const int64_t offset = (i * D + j) * HxW;
+          vec256::map2(
+              [a, b, c](Vec dy, Vec x) { return Vec(a) * dy + Vec(b) * x + Vec(c); },
+              dX_data + offset,
+              dY_data + offset,
+              X_data + offset,
+              HxW);
+        }
+      }
+    });
+  }
+
+  // dgamma(c) = sum over n of (ds(n, c) - db(n, c) * mean(n, g)) * rstd(n, g),
+  // and dbeta(c) = sum over n of db(n, c).
+  if (dgamma_data != nullptr || dbeta_data != nullptr) {
+    at::parallel_for(0, C, 1, [&](int64_t start, int64_t end) {
+      for (int64_t c = start; c < end; ++c) {
+        const int64_t g = c / D;
+        T dgamma_val = 0;
+        T dbeta_val = 0;
+        for (int64_t n = 0; n < N; ++n) {
+          const int64_t i = n * C + c;
+          dgamma_val += (ds[i] - db[i] * mean_data[n * G + g]) * rstd_data[n * G + g];
+          dbeta_val += db[i];
+        }
+        if (dgamma_data != nullptr) {
+          dgamma_data[c] = dgamma_val;
+        }
+        if (dbeta_data != nullptr) {
+          dbeta_data[c] = dbeta_val;
+        }
+      }
+    });
+  }
+}
+
+void GroupNormBackwardKernelImpl(
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    Tensor* dX,
+    Tensor* dgamma,
+    Tensor* dbeta) {
+  AT_DISPATCH_FLOATING_TYPES(
+      X.scalar_type(), "GroupNormBackwardKernelImpl", [&]() {
+        GroupNormBackwardKernelImplInternal<scalar_t>(
+            dY, X, mean, rstd, gamma, N, C, HxW, group, dX, dgamma, dbeta);
+      });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(GroupNormKernel, &GroupNormKernelImpl);
+REGISTER_DISPATCH(GroupNormBackwardKernel, &GroupNormBackwardKernelImpl);
+
+} // namespace native
+} // namespace at
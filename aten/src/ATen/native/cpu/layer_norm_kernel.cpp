@@ -1,6 +1,8 @@
 #include <ATen/native/layer_norm.h>
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 #include <ATen/ATen.h>
 #include <ATen/CPUApplyUtils.h>
@@ -13,6 +15,8 @@ namespace native {
 
 namespace {
 
+// The statistics and the normalization are computed in T_ACC, which is float
+// for BFloat16, see vec256::vec_compute_t.
 template <typename T>
 void LayerNormKernelImplInternal(
     const Tensor& X,
@@ -20,45 +24,57 @@ void LayerNormKernelImplInternal(
     const Tensor& beta,
     int64_t M,
     int64_t N,
-    T eps,
+    vec256::vec_compute_t<T> eps,
     Tensor* Y,
     Tensor* mean,
     Tensor* rstd) {
-  using Vec = vec256::Vec256<T>;
+  using T_ACC = vec256::vec_compute_t<T>;
+  using Vec = vec256::Vec256<T_ACC>;
   DCHECK_EQ(X.numel(), M * N);
   DCHECK(!gamma.defined() || gamma.numel() == N);
   DCHECK(!beta.defined() || beta.numel() == N);
-  T* X_data = X.data_ptr<T>();
+  const T* X_data = X.data_ptr<T>();
   const T* gamma_data = gamma.defined() ? gamma.data_ptr<T>() : nullptr;
   const T* beta_data = beta.defined() ? beta.data_ptr<T>() : nullptr;
   T* Y_data = Y->data_ptr<T>();
   T* mean_data = mean->data_ptr<T>();
   T* rstd_data = rstd->data_ptr<T>();
-  const T c = T(1) / static_cast<T>(N);
+  const T_ACC c = T_ACC(1) / static_cast<T_ACC>(N);
   const bool gamma_null = gamma_data == nullptr;
   const bool beta_null = beta_data == nullptr;
   at::parallel_for(0, M, 1, [&](int64_t start, int64_t end) {
     for (int64_t i = start; i < end; ++i) {
-      T* X_ptr = X_data + i * N;
+      const T* X_ptr = X_data + i * N;
       T* Y_ptr = Y_data + i * N;
-      T mean_val = vec256::reduce_all<T>(
+      T_ACC mean_val = vec256::reduce_all(
           [](Vec& x, Vec& y) { return x + y; },
           X_ptr,
           N);
-      T rstd_val = vec256::map_reduce_all<T>(
+      T_ACC rstd_val = vec256::map_reduce_all(
           [](Vec x) { return x * x; },
           [](Vec x, Vec y) { return x + y; },
           X_ptr,
           N);
       mean_val *= c;
-      rstd_val = std::max(rstd_val * c - mean_val * mean_val, T(0));
-      rstd_val = T(1) / std::sqrt(rstd_val + eps);
-      const T scale = rstd_val;
-      const T bias = -rstd_val * mean_val;
-      for (int64_t j = 0; j < N; ++j) {
-        const T gamma_v = gamma_null ? T(1) : gamma_data[j];
-        const T beta_v = beta_null ? T(0) : beta_data[j];
-        Y_ptr[j] = (X_ptr[j] * scale + bias) * gamma_v + beta_v;
+      rstd_val = std::max(rstd_val * c - mean_val * mean_val, T_ACC(0));
+      rstd_val = T_ACC(1) / std::sqrt(rstd_val + eps);
+      const T_ACC scale = rstd_val;
+      const T_ACC bias = -rstd_val * mean_val;
+      if (gamma_null && beta_null) {
+        vec256::map(
+            [scale, bias](Vec x) { return x * Vec(scale) + Vec(bias); },
+            Y_ptr,
+            X_ptr,
+            N);
+      } else {
+        for (int64_t j = 0; j < N; ++j) {
+          const T_ACC gamma_v =
+              gamma_null ? T_ACC(1) : static_cast<T_ACC>(gamma_data[j]);
+          const T_ACC beta_v =
+              beta_null ? T_ACC(0) : static_cast<T_ACC>(beta_data[j]);
+          Y_ptr[j] = (static_cast<T_ACC>(X_ptr[j]) * scale + bias) * gamma_v +
+              beta_v;
+        }
       }
       mean_data[i] = mean_val;
       rstd_data[i] = rstd_val;
@@ -76,10 +92,12 @@ void LayerNormKernelImpl(
     Tensor* Y,
     Tensor* mean,
     Tensor* rstd) {
-  AT_DISPATCH_FLOATING_TYPES(X.scalar_type(), "LayerNormKernelImpl", [&]() {
-    LayerNormKernelImplInternal<scalar_t>(
-        X, gamma, beta, M, N, static_cast<scalar_t>(eps), Y, mean, rstd);
-  });
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, X.scalar_type(), "LayerNormKernelImpl", [&]() {
+        using T_ACC = vec256::vec_compute_t<scalar_t>;
+        LayerNormKernelImplInternal<scalar_t>(
+            X, gamma, beta, M, N, static_cast<T_ACC>(eps), Y, mean, rstd);
+      });
 }
 
 template <typename T>
@@ -94,6 +112,7 @@ void LayerNormBackwardKernelImplInternal(
     Tensor* dX,
     Tensor* dgamma,
     Tensor* dbeta) {
+  using T_ACC = vec256::vec_compute_t<T>;
   DCHECK_EQ(dY.numel(), M * N);
   DCHECK_EQ(X.numel(), M * N);
   DCHECK_EQ(mean.numel(), M);
@@ -107,48 +126,59 @@ void LayerNormBackwardKernelImplInternal(
       gamma.defined() ? gamma.template data_ptr<T>() : nullptr;
   T* dX_data = dX->defined() ? dX->template data_ptr<T>() : nullptr;
   T* dgamma_data = dgamma->defined() ? dgamma->template data_ptr<T>() : nullptr;
-  if (dgamma_data != nullptr) {
-    std::memset(dgamma_data, 0, N * sizeof(T));
-  }
   T* dbeta_data = dbeta->defined() ? dbeta->template data_ptr<T>() : nullptr;
-  if (dbeta_data != nullptr) {
-    std::memset(dbeta_data, 0, N * sizeof(T));
-  }
-  const T scale = T(1) / static_cast<T>(N);
+  // dgamma and dbeta are sums over all M rows, accumulate them in T_ACC and
+  // round to T once at the end.
+  std::vector<T_ACC> dgamma_acc(dgamma_data != nullptr ? N : 0, T_ACC(0));
+  std::vector<T_ACC> dbeta_acc(dbeta_data != nullptr ? N : 0, T_ACC(0));
+  const T_ACC scale = T_ACC(1) / static_cast<T_ACC>(N);
   const bool gamma_null = gamma_data == nullptr;
   for (int64_t i = 0; i < M; ++i) {
     const T* dY_ptr = dY_data + i * N;
     const T* X_ptr = X_data + i * N;
+    const T_ACC mean_val = static_cast<T_ACC>(mean_data[i]);
+    const T_ACC rstd_val = static_cast<T_ACC>(rstd_data[i]);
     if (dX_data != nullptr) {
       T* dX_ptr = dX_data + i * N;
-      T ds = 0;
-      T db = 0;
+      T_ACC ds = 0;
+      T_ACC db = 0;
       for (int64_t j = 0; j < N; ++j) {
-        const T gamma_v = gamma_null ? T(1) : gamma_data[j];
-        ds += dY_ptr[j] * X_ptr[j] * gamma_v;
-        db += dY_ptr[j] * gamma_v;
+        const T_ACC gamma_v =
+            gamma_null ? T_ACC(1) : static_cast<T_ACC>(gamma_data[j]);
+        const T_ACC dY_v = static_cast<T_ACC>(dY_ptr[j]);
+        ds += dY_v * static_cast<T_ACC>(X_ptr[j]) * gamma_v;
+        db += dY_v * gamma_v;
       }
-      const T a = rstd_data[i];
-      const T b = (db * mean_data[i] - ds) * a * a * a * scale;
-      const T c = -b * mean_data[i] - db * a * scale;
+      const T_ACC a = rstd_val;
+      const T_ACC b = (db * mean_val - ds) * a * a * a * scale;
+      const T_ACC c = -b * mean_val - db * a * scale;
       for (int64_t j = 0; j < N; ++j) {
-        const T gamma_v = gamma_null ? T(1) : gamma_data[j];
-        dX_ptr[j] = a * dY_ptr[j] * gamma_v + b * X_ptr[j] + c;
+        const T_ACC gamma_v =
+            gamma_null ? T_ACC(1) : static_cast<T_ACC>(gamma_data[j]);
+        dX_ptr[j] = a * static_cast<T_ACC>(dY_ptr[j]) * gamma_v +
+            b * static_cast<T_ACC>(X_ptr[j]) + c;
       }
     }
     if (dgamma_data != nullptr) {
-      const T a = rstd_data[i];
-      const T b = -a * mean_data[i];
+      const T_ACC a = rstd_val;
+      const T_ACC b = -a * mean_val;
       for (int64_t j = 0; j < N; ++j) {
-        dgamma_data[j] += dY_ptr[j] * (a * X_ptr[j] + b);
+        dgamma_acc[j] += static_cast<T_ACC>(dY_ptr[j]) *
+            (a * static_cast<T_ACC>(X_ptr[j]) + b);
       }
     }
     if (dbeta_data != nullptr) {
       for (int64_t j = 0; j < N; ++j) {
-        dbeta_data[j] += dY_ptr[j];
+        dbeta_acc[j] += static_cast<T_ACC>(dY_ptr[j]);
       }
     }
   }
+  if (dgamma_data != nullptr) {
+    std::copy(dgamma_acc.begin(), dgamma_acc.end(), dgamma_data);
+  }
+  if (dbeta_data != nullptr) {
+    std::copy(dbeta_acc.begin(), dbeta_acc.end(), dbeta_data);
+  }
 }
 
 void LayerNormBackwardKernelImpl(
@@ -162,8 +192,9 @@ void LayerNormBackwardKernelImpl(
     Tensor* dX,
     Tensor* dgamma,
     Tensor* dbeta) {
-  AT_DISPATCH_FLOATING_TYPES(
-      X.scalar_type(), "LayerNormBackwardKernelImpl", [&]() {
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, X.scalar_type(),
+      "LayerNormBackwardKernelImpl", [&]() {
         LayerNormBackwardKernelImplInternal<scalar_t>(
             dY, X, mean, rstd, gamma, M, N, dX, dgamma, dbeta);
       });
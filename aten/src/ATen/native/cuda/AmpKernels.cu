@@ -6,6 +6,11 @@
 #include <ATen/Dispatch.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cuda/Loops.cuh>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <map>
+#include <vector>
 
 namespace {
 // Thin wrapper around https://docs.nvidia.com/cuda/cuda-math-api/group__CUDA__MATH__SINGLE.html#group__CUDA__MATH__SINGLE_1g57a3c8313f570282a1a7bcc78743b08e,
@@ -33,6 +38,45 @@ static __host__ __device__ __forceinline__ int isfinite_ensure_cuda_math(float v
 namespace at {
 namespace native {
 
+namespace {
+
+void check_found_inf_and_inv_scale(const Tensor& found_inf, const Tensor& inv_scale) {
+  TORCH_CHECK(inv_scale.is_cuda(), "inv_scale must be a CUDA tensor.");
+  TORCH_CHECK(found_inf.is_cuda(), "found_inf must be a CUDA tensor.");
+  TORCH_CHECK(inv_scale.numel() == 1, "inv_scale must be a 1-element tensor.");
+  TORCH_CHECK(found_inf.numel() == 1, "found_inf must be a 1-element tensor.");
+  TORCH_CHECK(inv_scale.scalar_type() == at::ScalarType::Float, "inv_scale must be a float tensor.");
+  TORCH_CHECK(found_inf.scalar_type() == at::ScalarType::Float, "found_inf must be a float tensor.");
+}
+
+using multi_tensor_apply_detail::ChunkInfo;
+using multi_tensor_apply_detail::TensorListMetadata;
+
+// Unscales one chunk of a gradient in place. A block writes found_inf at most
+// once, after its whole chunk is checked.
+template <typename scalar_t>
+struct UnscaleFunctor {
+  __device__ __forceinline__ void operator()(
+      int64_t chunk_size, TensorListMetadata<1>& tl, float* found_inf,
+      const float* inv_scale) {
+    ChunkInfo<1> chunk(chunk_size, tl);
+    auto* grad = chunk.template ptr<scalar_t>(tl, 0);
+    const float inv_scale_val = *inv_scale;
+    bool non_finite = false;
+    for (int64_t i = threadIdx.x; i < chunk.n; i += blockDim.x) {
+      const float fval = static_cast<float>(grad[i]);
+      // See isfinite_ensure_cuda_math above.
+      non_finite |= !isfinite_ensure_cuda_math(fval);
+      grad[i] = static_cast<scalar_t>(inv_scale_val == 1.f ? fval : fval * inv_scale_val);
+    }
+    if (__syncthreads_or(non_finite) && threadIdx.x == 0) {
+      *found_inf = 1.f;
+    }
+  }
+};
+
+} // anonymous namespace
+
 // Multiplies scaled_grad in-place by inv_scale.  If an element of scaled_grad was inf or NaN sets found_inf to 1.0.
 //
 // Args:
@@ -49,12 +93,7 @@ void _amp_non_finite_check_and_unscale_cuda_(Tensor& scaled_grad,
                                              const Tensor& inv_scale)
 {
   TORCH_CHECK(scaled_grad.is_cuda(), "scaled_grad must be a CUDA tensor.");
-  TORCH_CHECK(inv_scale.is_cuda(), "inv_scale must be a CUDA tensor.");
-  TORCH_CHECK(found_inf.is_cuda(), "found_inf must be a CUDA tensor.");
-  TORCH_CHECK(inv_scale.numel() == 1, "inv_scale must be a 1-element tensor.");
-  TORCH_CHECK(found_inf.numel() == 1, "found_inf must be a 1-element tensor.");
-  TORCH_CHECK(inv_scale.scalar_type() == at::ScalarType::Float, "inv_scale must be a float tensor.");
-  TORCH_CHECK(found_inf.scalar_type() == at::ScalarType::Float, "found_inf must be a float tensor.");
+  check_found_inf_and_inv_scale(found_inf, inv_scale);
   TORCH_CHECK(scaled_grad.layout() == at::kStrided, "scaled_grad must be a strided (not sparse) Tensor.");
 
   // Act on scaled_grad in place.
@@ -80,6 +119,51 @@ void _amp_non_finite_check_and_unscale_cuda_(Tensor& scaled_grad,
 }
 
 
+// _amp_non_finite_check_and_unscale_cuda_ for a list of gradients, with one
+// multi-tensor apply pass (see MultiTensorApply.cuh) per dtype instead of a
+// kernel per gradient.
+//
+// Args:
+// scaled_grads:  The (scaled) gradients, all on the device of found_inf.  Gradients that are not contiguous
+//                go through _amp_non_finite_check_and_unscale_cuda_ one by one.
+// found_inf, inv_scale:  As for _amp_non_finite_check_and_unscale_cuda_.
+void _amp_foreach_non_finite_check_and_unscale_cuda_(TensorList scaled_grads,
+                                                     Tensor& found_inf,
+                                                     const Tensor& inv_scale)
+{
+  check_found_inf_and_inv_scale(found_inf, inv_scale);
+  if (scaled_grads.empty()) {
+    return;
+  }
+  c10::cuda::CUDAGuard device_guard(found_inf.device());
+
+  std::map<ScalarType, std::vector<Tensor>> grads_by_dtype;
+  for (const auto& grad : scaled_grads) {
+    TORCH_CHECK(grad.is_cuda() && grad.device() == found_inf.device(),
+                "scaled_grads must be CUDA tensors on the device of found_inf, ", found_inf.device(),
+                ", but got a tensor on ", grad.device());
+    if (grad.layout() == at::kStrided && grad.is_contiguous()) {
+      grads_by_dtype[grad.scalar_type()].push_back(grad);
+    } else {
+      Tensor g = grad;
+      _amp_non_finite_check_and_unscale_cuda_(g, found_inf, inv_scale);
+    }
+  }
+
+  for (auto& entry : grads_by_dtype) {
+    std::vector<std::vector<Tensor>> tensor_lists{std::move(entry.second)};
+    AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+      entry.first,
+      "_amp_foreach_non_finite_check_and_unscale_cuda",
+      [&] {
+        multi_tensor_apply<1>(tensor_lists, UnscaleFunctor<scalar_t>(),
+                              found_inf.data_ptr<float>(),
+                              static_cast<const float*>(inv_scale.data_ptr<float>()));
+      });
+  }
+}
+
+
 // amp_update_scale_cuda_kernel is launched with a single thread to compute the new scale.
 // The scale factor is maintained and updated on the GPU to avoid synchronization.
 __global__ void amp_update_scale_cuda_kernel(int* growth_tracker,
@@ -358,6 +358,15 @@ static_assert(CUFFT_MAX_PLAN_NUM >= 0 && CUFFT_MAX_PLAN_NUM <= std::numeric_limi
 static_assert(CUFFT_DEFAULT_CACHE_SIZE >= 0 && CUFFT_DEFAULT_CACHE_SIZE <= CUFFT_MAX_PLAN_NUM,
               "CUFFT_DEFAULT_CACHE_SIZE not in [0, CUFFT_MAX_PLAN_NUM] range");
 
+// Hit/miss/eviction counters of a plan cache. A miss means a plan was built
+// and inserted; an eviction means a plan was destroyed to make room, either on
+// a miss or by shrinking max_size.
+struct CuFFTPlanCacheStats {
+  int64_t hits = 0;
+  int64_t misses = 0;
+  int64_t evictions = 0;
+};
+
 // This cache assumes that the mapping from key to value never changes.
 // This is **NOT** thread-safe. Please use a mutex when using it **AND** the
 // value returned from try_emplace_value.
@@ -382,12 +391,16 @@ public:
   CuFFTParamsLRUCache(CuFFTParamsLRUCache&& other) noexcept :
     _usage_list(std::move(other._usage_list)),
     _cache_map(std::move(other._cache_map)),
-    _max_size(other._max_size) {}
+    _max_size(other._max_size),
+    _stats(other._stats),
+    _batched_plans(other._batched_plans) {}
 
   CuFFTParamsLRUCache& operator=(CuFFTParamsLRUCache&& other) noexcept {
     _usage_list = std::move(other._usage_list);
     _cache_map = std::move(other._cache_map);
     _max_size = other._max_size;
+    _stats = other._stats;
+    _batched_plans = other._batched_plans;
     return *this;
   }
 
@@ -403,17 +416,20 @@ public:
     map_kkv_iter_t map_it = _cache_map.find(key);
     // Hit, put to list front
     if (map_it != _cache_map.end()) {
+      _stats.hits++;
       _usage_list.splice(_usage_list.begin(), _usage_list, map_it->second);
       return map_it->second->second;
     }
 
     // Miss
+    _stats.misses++;
     // remove if needed
     if (_usage_list.size() >= _max_size) {
       auto last = _usage_list.end();
       last--;
       _cache_map.erase(last->first);
       _usage_list.pop_back();
+      _stats.evictions++;
     }
 
     // construct new plan at list front, then insert into _cache_map
@@ -442,6 +458,7 @@ public:
         _cache_map.erase(delete_it->first);
       }
       _usage_list.erase(delete_it, _usage_list.end());
+      _stats.evictions += cur_size - _max_size;
     }
   }
 
@@ -449,6 +466,17 @@ public:
 
   size_t max_size() const noexcept { return _max_size; }
 
+  const CuFFTPlanCacheStats& stats() const { return _stats; }
+
+  void reset_stats() { _stats = CuFFTPlanCacheStats(); }
+
+  // If true, batched transforms are split into chunks whose batch sizes are
+  // powers of two, so plans are shared between transforms of different batch
+  // sizes. See NOTE [ cuFFT Batched Plans ] in native/cuda/SpectralOps.cu.
+  bool batched_plans() const noexcept { return _batched_plans; }
+
+  void set_batched_plans(bool enabled) { _batched_plans = enabled; }
+
   std::mutex mutex;
 
 private:
@@ -467,6 +495,8 @@ private:
   std::list<kv_t> _usage_list;
   map_t _cache_map;
   size_t _max_size;
+  CuFFTPlanCacheStats _stats;
+  bool _batched_plans = false;
 };
 
 // Since ATen is separated into CPU build and CUDA build, we need a way to call
@@ -474,10 +504,16 @@ private:
 // (at cuda/detail/CUDAHooks.cpp), and call the hooked functions from the actual
 // native function counterparts (at native/SpectralOps.cpp), i.e.,
 // _cufft_get_plan_cache_max_size, _cufft_set_plan_cache_max_size
-// _cufft_get_plan_cache_size, and _cufft_clear_plan_cache.
+// _cufft_get_plan_cache_size, _cufft_clear_plan_cache,
+// _cufft_get_plan_cache_stats, _cufft_reset_plan_cache_stats,
+// _cufft_get_plan_cache_batched_plans and _cufft_set_plan_cache_batched_plans.
 int64_t cufft_get_plan_cache_max_size_impl(int64_t device_index);
 void cufft_set_plan_cache_max_size_impl(int64_t device_index, int64_t max_size);
 int64_t cufft_get_plan_cache_size_impl(int64_t device_index);
 void cufft_clear_plan_cache_impl(int64_t device_index);
+CuFFTPlanCacheStats cufft_get_plan_cache_stats_impl(int64_t device_index);
+void cufft_reset_plan_cache_stats_impl(int64_t device_index);
+bool cufft_get_plan_cache_batched_plans_impl(int64_t device_index);
+void cufft_set_plan_cache_batched_plans_impl(int64_t device_index, bool enabled);
 
 }}} // namespace at::native::detail
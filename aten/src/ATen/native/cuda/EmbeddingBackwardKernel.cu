@@ -179,35 +179,33 @@ __global__ void sum_and_scatter(
   }
 }
 
-} // anon namespace
-
-Tensor embedding_backward_cuda_kernel(
-        const Tensor &grad,
-        const Tensor &orig_indices,
-        const Tensor &sorted_indices,
-        const Tensor &count,
-        int64_t num_weights,
-        int padding_idx,
-        bool scale_grad_by_freq,
-        bool mode_mean,
-        const Tensor &offset2bag,
-        const Tensor &bag_size,
-        const Tensor &per_sample_weights) {
+// The segments of `sorted_indices`, which are the runs of equal indices, each
+// split into partial-segments of at most `NROWS_PER_THREAD` rows.
+struct EmbeddingSegments {
+  // Unit: index in `sorted_indices` and `orig_indices`
+  Tensor segment_offsets;
+  int64_t num_of_segments;
+  // Unit: index in `partial_segment_offset`
+  Tensor partials_per_segment_offset;
+  // Unit: index in `sorted_indices` and `orig_indices`
+  Tensor partial_segment_offset;
+  int64_t num_of_partial_segments;
+};
 
+EmbeddingSegments compute_segments(
+    const Tensor &orig_indices,
+    const Tensor &sorted_indices) {
   auto stream = at::cuda::getCurrentCUDAStream();
   auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
   auto policy = thrust::cuda::par(allocator).on(stream);
   const ptrdiff_t numel = sorted_indices.numel();
-
-  auto grad_weight = at::zeros({num_weights, grad.size(-1)}, grad.options());
-  const int64_t stride = grad_weight.stride(0);
+  EmbeddingSegments segments;
 
   // Compute the number of segments and their start position so that we do not have to
   // spawn a warp per index. In this context, a segment is a number of rows that should
   // be summarized.
   // Unit: index in `sorted_indices` and `orig_indices`
-  auto segment_offsets = at::empty({numel}, orig_indices.options());
-  int64_t num_of_segments;
+  segments.segment_offsets = at::empty({numel}, orig_indices.options());
   {
     auto sorted_indices_dev = thrust::device_ptr<int64_t>(sorted_indices.data_ptr<int64_t>());
     auto dummy = at::empty_like(sorted_indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
@@ -218,9 +216,10 @@ Tensor embedding_backward_cuda_kernel(
             sorted_indices_dev + numel,
             thrust::make_counting_iterator(0),
             dummy_dev,
-            thrust::device_ptr<int64_t>(segment_offsets.data_ptr<int64_t>()));
-    num_of_segments = thrust::get<0>(ends) - dummy_dev;
+            thrust::device_ptr<int64_t>(segments.segment_offsets.data_ptr<int64_t>()));
+    segments.num_of_segments = thrust::get<0>(ends) - dummy_dev;
   }
+  const int64_t num_of_segments = segments.num_of_segments;
 
   // We split the segments up into sizes of `NROWS_PER_THREAD`
   // Compute the number partial-segments per segment (some partial-segments 
@@ -229,7 +228,7 @@ Tensor embedding_backward_cuda_kernel(
   {
     krn_partials_per_segment<<<ceil_div(num_of_segments, 32), 32, 0, stream>>> (
             partials_per_segment.data_ptr<int64_t>(),
-            segment_offsets.data_ptr<int64_t>(),
+            segments.segment_offsets.data_ptr<int64_t>(),
             num_of_segments,
             numel);
   }
@@ -238,83 +237,197 @@ Tensor embedding_backward_cuda_kernel(
   // of each partial-segment in `sorted_indices`, we need to compute the
   // start position of each _segment_ in `partial_segment_offset`.
   // Unit: index in `partial_segment_offset`
-  auto partials_per_segment_offset = at::empty({num_of_segments}, orig_indices.options());
+  segments.partials_per_segment_offset = at::empty({num_of_segments}, orig_indices.options());
   thrust::exclusive_scan(
           policy,
           thrust::device_ptr<int64_t>(partials_per_segment.data_ptr<int64_t>()),
           thrust::device_ptr<int64_t>(partials_per_segment.data_ptr<int64_t>()+num_of_segments),
-          thrust::device_ptr<int64_t>(partials_per_segment_offset.data_ptr<int64_t>()));
+          thrust::device_ptr<int64_t>(segments.partials_per_segment_offset.data_ptr<int64_t>()));
 
   // The total number of partial-segments is the sum of `partials_per_segment_offset`
-  const int num_of_partial_segments = partials_per_segment[num_of_segments-1].item<int64_t>() +
-          partials_per_segment_offset[num_of_segments-1].item<int64_t>();
+  segments.num_of_partial_segments = partials_per_segment[num_of_segments-1].item<int64_t>() +
+          segments.partials_per_segment_offset[num_of_segments-1].item<int64_t>();
 
   // Now we can compute the start position of each partial-segment
   // Unit: index in `sorted_indices` and `orig_indices`
-  auto partial_segment_offset = at::empty({num_of_partial_segments}, orig_indices.options());
+  segments.partial_segment_offset = at::empty({segments.num_of_partial_segments}, orig_indices.options());
   {
     krn_partial_segment_offset<<<ceil_div(num_of_segments, 32), 32, 0, stream>>> (
-            partial_segment_offset.data_ptr<int64_t>(),
+            segments.partial_segment_offset.data_ptr<int64_t>(),
             partials_per_segment.data_ptr<int64_t>(),
-            partials_per_segment_offset.data_ptr<int64_t>(),
-            segment_offsets.data_ptr<int64_t>(),
+            segments.partials_per_segment_offset.data_ptr<int64_t>(),
+            segments.segment_offsets.data_ptr<int64_t>(),
             num_of_segments);
   }
+  return segments;
+}
+
+// Computes the sum of each partial-segment and handles bags. The sums are in
+// `acc_type`, for numerical stability.
+template <typename scalar_t>
+Tensor compute_grad_weight_per_segment(
+    const EmbeddingSegments &segments,
+    const Tensor &grad,
+    const Tensor &orig_indices,
+    const Tensor &count,
+    int64_t stride,
+    bool mode_mean,
+    const Tensor &offset2bag,
+    const Tensor &bag_size,
+    const Tensor &per_sample_weights) {
+  using partial_weight_t = acc_type<scalar_t, true>;
+  auto stream = at::cuda::getCurrentCUDAStream();
+  const ptrdiff_t numel = orig_indices.numel();
+  const int stride_warped = ceil_div(stride, C10_WARP_SIZE)*C10_WARP_SIZE;
+  const int block = std::min(stride_warped, MAX_BLOCK_SIZE);
+  const int grid = ceil_div(segments.num_of_partial_segments*stride_warped, block);
+
+  TensorOptions op;
+  if(grad.dtype() == at::kHalf || grad.dtype() == at::kBFloat16) {
+      op = grad.options().dtype(at::kFloat);
+  } else {
+      op = grad.options();
+  }
+  auto grad_weight_per_segment = at::empty({segments.num_of_partial_segments, stride}, op);
+  if (offset2bag.defined()) {
+        compute_grad_weight_bags<scalar_t><<<grid, block, 0, stream>>>(
+          orig_indices.data_ptr<int64_t>(),
+          grad.data_ptr<scalar_t>(),
+          offset2bag.data_ptr<int64_t>(),
+          count.defined() ? count.data_ptr<int64_t>() : nullptr, numel, stride,
+          mode_mean, bag_size.data_ptr<int64_t>(),
+          per_sample_weights.defined() ? per_sample_weights.data_ptr<scalar_t>() : NULL,
+          per_sample_weights.defined() ? per_sample_weights.stride(0) : 0,
+          segments.partial_segment_offset.data_ptr<int64_t>(),
+          segments.num_of_partial_segments, grad_weight_per_segment.data_ptr<partial_weight_t>(),
+          stride_warped);
+  } else {
+        compute_grad_weight<scalar_t><<<grid, block, 0, stream>>>(
+          orig_indices.data_ptr<int64_t>(),
+          grad.data_ptr<scalar_t>(),
+          count.defined() ? count.data_ptr<int64_t>() : nullptr,
+          numel, stride,
+          segments.partial_segment_offset.data_ptr<int64_t>(),
+          segments.num_of_partial_segments,
+          grad_weight_per_segment.data_ptr<partial_weight_t>(),
+          stride_warped);
+  }
+  AT_CUDA_CHECK(cudaGetLastError());
+  return grad_weight_per_segment;
+}
+
+// Each block sums the partial-sums of one segment and applies the update of
+// `optimizer` to the weight row of the segment, so the gradient of the row is
+// never written to memory. Row-wise Adagrad reduces the squares of the
+// gradient of the row across the block, so the row's gradient is summed twice.
+// This kernel assumes that all input tensors are contiguous.
+template <typename scalar_t, EmbeddingFusedOptimizer optimizer>
+__global__ void sum_and_update(
+    const int64_t *input, scalar_t *weight, acc_type<scalar_t, true> *state,
+    int64_t stride,
+    const int64_t* segment_offsets, int64_t num_of_segments,
+    const acc_type<scalar_t, true> *grad_weight_per_segment,
+    const int64_t *segment_sizes_offsets, int64_t num_of_partial_segments,
+    const int64_t padding_idx,
+    acc_type<scalar_t, true> lr,
+    acc_type<scalar_t, true> eps) {
+  using accscalar_t = acc_type<scalar_t, true>;
+  const int64_t id = blockIdx.x;
+  const int64_t target_row = input[segment_offsets[id]];
+  if (target_row == padding_idx) {
+    return;
+  }
+  const int64_t idx_begin = segment_sizes_offsets[id];
+  const int64_t idx_end = (id == num_of_segments-1)?num_of_partial_segments:segment_sizes_offsets[id+1];
+  auto gradient = [&](int64_t feature) {
+    accscalar_t sum = 0;
+    for (int64_t idx = idx_begin; idx < idx_end; ++idx) {
+      sum += grad_weight_per_segment[idx*stride + feature];
+    }
+    return sum;
+  };
+  scalar_t* weight_row = weight + target_row * stride;
+
+  if (optimizer == EmbeddingFusedOptimizer::RowWiseAdagrad) {
+    extern __shared__ char smem_raw[];
+    accscalar_t* smem = reinterpret_cast<accscalar_t*>(smem_raw);
+    __shared__ accscalar_t multiplier;
+    accscalar_t sum_of_squares = 0;
+    for (int64_t feature = threadIdx.x; feature < stride; feature += blockDim.x) {
+      const accscalar_t g = gradient(feature);
+      sum_of_squares += g * g;
+    }
+    sum_of_squares = reduceBlock<accscalar_t, ReduceAdd<accscalar_t>>(
+        smem, blockDim.x, sum_of_squares, ReduceAdd<accscalar_t>(), accscalar_t(0));
+    if (threadIdx.x == 0) {
+      const accscalar_t row_state = state[target_row] + sum_of_squares / stride;
+      state[target_row] = row_state;
+      multiplier = lr / (::sqrt(row_state) + eps);
+    }
+    __syncthreads();
+    for (int64_t feature = threadIdx.x; feature < stride; feature += blockDim.x) {
+      weight_row[feature] = static_cast<scalar_t>(
+          static_cast<accscalar_t>(weight_row[feature]) - multiplier * gradient(feature));
+    }
+  } else {
+    for (int64_t feature = threadIdx.x; feature < stride; feature += blockDim.x) {
+      const accscalar_t g = gradient(feature);
+      accscalar_t step = lr * g;
+      if (optimizer == EmbeddingFusedOptimizer::Adagrad) {
+        const accscalar_t feature_state = state[target_row * stride + feature] + g * g;
+        state[target_row * stride + feature] = feature_state;
+        step /= ::sqrt(feature_state) + eps;
+      }
+      weight_row[feature] = static_cast<scalar_t>(
+          static_cast<accscalar_t>(weight_row[feature]) - step);
+    }
+  }
+}
+
+} // anon namespace
+
+Tensor embedding_backward_cuda_kernel(
+        const Tensor &grad,
+        const Tensor &orig_indices,
+        const Tensor &sorted_indices,
+        const Tensor &count,
+        int64_t num_weights,
+        int padding_idx,
+        bool scale_grad_by_freq,
+        bool mode_mean,
+        const Tensor &offset2bag,
+        const Tensor &bag_size,
+        const Tensor &per_sample_weights) {
+
+  auto stream = at::cuda::getCurrentCUDAStream();
+
+  auto grad_weight = at::zeros({num_weights, grad.size(-1)}, grad.options());
+  const int64_t stride = grad_weight.stride(0);
+
+  auto segments = compute_segments(orig_indices, sorted_indices);
 
   const int stride_warped = ceil_div(stride, C10_WARP_SIZE)*C10_WARP_SIZE;
   const int block = std::min(stride_warped, MAX_BLOCK_SIZE);
-  const int grid = ceil_div(num_of_partial_segments*stride_warped, block);
 
   AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
     grad.scalar_type(), "embedding_bag_backward_cuda_compute_grad_weight", [&] {
       AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "embedding_bag_backward_cuda_compute_grad_weight", [&] {
-        // For numerical stability, the dtype of `grad_weight_per_segment`
-        // should match `acc_type`
         using partial_weight_t = acc_type<scalar_t, true>;
-        TensorOptions op;
-        if(grad.dtype() == at::kHalf || grad.dtype() == at::kBFloat16) {
-            op = grad.options().dtype(at::kFloat);
-        } else {
-            op = grad.options();
-        }
-        auto grad_weight_per_segment = at::empty({num_of_partial_segments, stride}, op);
-        // Compute the sum of each partial-segment and handle bags
-        if (offset2bag.defined()) {
-              compute_grad_weight_bags<scalar_t><<<grid, block, 0, stream>>>(
-                orig_indices.data_ptr<int64_t>(),
-                grad.data_ptr<scalar_t>(),
-                offset2bag.data_ptr<int64_t>(),
-                count.defined() ? count.data_ptr<int64_t>() : nullptr, numel, stride,
-                mode_mean, bag_size.data_ptr<int64_t>(),
-                per_sample_weights.defined() ? per_sample_weights.data_ptr<scalar_t>() : NULL,
-                per_sample_weights.defined() ? per_sample_weights.stride(0) : 0,
-                partial_segment_offset.data_ptr<int64_t>(),
-                num_of_partial_segments, grad_weight_per_segment.data_ptr<partial_weight_t>(),
-                stride_warped);
-        } else {
-              compute_grad_weight<scalar_t><<<grid, block, 0, stream>>>(
-                orig_indices.data_ptr<int64_t>(),
-                grad.data_ptr<scalar_t>(),
-                count.defined() ? count.data_ptr<int64_t>() : nullptr,
-                numel, stride,
-                partial_segment_offset.data_ptr<int64_t>(),
-                num_of_partial_segments,
-                grad_weight_per_segment.data_ptr<partial_weight_t>(),
-                stride_warped);
-        }
-        AT_CUDA_CHECK(cudaGetLastError());
+        auto grad_weight_per_segment = compute_grad_weight_per_segment<scalar_t>(
+            segments, grad, orig_indices, count, stride, mode_mean,
+            offset2bag, bag_size, per_sample_weights);
 
         // Finally, we sum all the partial-sums and scatter them
         // into `grad_weight`.
-        const int grid2 = ceil_div(num_of_segments*stride_warped, block);
+        const int grid2 = ceil_div(segments.num_of_segments*stride_warped, block);
             sum_and_scatter<scalar_t><<<grid2, block, 0, stream>>>(
               sorted_indices.data_ptr<int64_t>(),
               grad_weight.data_ptr<scalar_t>(),
               stride,
-              segment_offsets.data_ptr<int64_t>(),
-              num_of_segments, grad_weight_per_segment.data_ptr<partial_weight_t>(),
-              partials_per_segment_offset.data_ptr<int64_t>(),
-              num_of_partial_segments,
+              segments.segment_offsets.data_ptr<int64_t>(),
+              segments.num_of_segments, grad_weight_per_segment.data_ptr<partial_weight_t>(),
+              segments.partials_per_segment_offset.data_ptr<int64_t>(),
+              segments.num_of_partial_segments,
               padding_idx,
               stride_warped);
         AT_CUDA_CHECK(cudaGetLastError());
@@ -323,4 +436,72 @@ Tensor embedding_backward_cuda_kernel(
   return grad_weight;
 }
 
+void embedding_backward_fused_update_cuda_kernel(
+        Tensor &weight,
+        Tensor &optimizer_state,
+        EmbeddingFusedOptimizer optimizer,
+        double lr,
+        double eps,
+        const Tensor &grad,
+        const Tensor &orig_indices,
+        const Tensor &sorted_indices,
+        const Tensor &count,
+        int padding_idx,
+        bool mode_mean,
+        const Tensor &offset2bag,
+        const Tensor &bag_size,
+        const Tensor &per_sample_weights) {
+
+  auto stream = at::cuda::getCurrentCUDAStream();
+  const int64_t stride = weight.stride(0);
+
+  auto segments = compute_segments(orig_indices, sorted_indices);
+
+  const int stride_warped = ceil_div(stride, C10_WARP_SIZE)*C10_WARP_SIZE;
+  const int block = std::min(stride_warped, MAX_BLOCK_SIZE);
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
+    grad.scalar_type(), "embedding_bag_backward_cuda_fused_update", [&] {
+      AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "embedding_bag_backward_cuda_fused_update", [&] {
+        using partial_weight_t = acc_type<scalar_t, true>;
+        auto grad_weight_per_segment = compute_grad_weight_per_segment<scalar_t>(
+            segments, grad, orig_indices, count, stride, mode_mean,
+            offset2bag, bag_size, per_sample_weights);
+        partial_weight_t* state_data = optimizer == EmbeddingFusedOptimizer::SGD
+            ? nullptr : optimizer_state.data_ptr<partial_weight_t>();
+
+#define SUM_AND_UPDATE(OPTIMIZER)                                             \
+        sum_and_update<scalar_t, OPTIMIZER>                                   \
+          <<<segments.num_of_segments, block,                                 \
+             block * sizeof(partial_weight_t), stream>>>(                     \
+            sorted_indices.data_ptr<int64_t>(),                               \
+            weight.data_ptr<scalar_t>(),                                      \
+            state_data,                                                       \
+            stride,                                                           \
+            segments.segment_offsets.data_ptr<int64_t>(),                     \
+            segments.num_of_segments,                                         \
+            grad_weight_per_segment.data_ptr<partial_weight_t>(),             \
+            segments.partials_per_segment_offset.data_ptr<int64_t>(),         \
+            segments.num_of_partial_segments,                                 \
+            padding_idx,                                                      \
+            static_cast<partial_weight_t>(lr),                                \
+            static_cast<partial_weight_t>(eps))
+
+        switch (optimizer) {
+          case EmbeddingFusedOptimizer::SGD:
+            SUM_AND_UPDATE(EmbeddingFusedOptimizer::SGD);
+            break;
+          case EmbeddingFusedOptimizer::Adagrad:
+            SUM_AND_UPDATE(EmbeddingFusedOptimizer::Adagrad);
+            break;
+          case EmbeddingFusedOptimizer::RowWiseAdagrad:
+            SUM_AND_UPDATE(EmbeddingFusedOptimizer::RowWiseAdagrad);
+            break;
+        }
+#undef SUM_AND_UPDATE
+        AT_CUDA_CHECK(cudaGetLastError());
+    });
+  });
+}
+
 }}
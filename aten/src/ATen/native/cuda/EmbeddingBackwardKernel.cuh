@@ -4,6 +4,7 @@
 #include <ATen/NativeFunctions.h>
 
 #include <ATen/AccumulateType.h>
+#include <ATen/native/EmbeddingFusedUpdate.h>
 
 #include <THC/THCDeviceUtils.cuh>
 #include <THC/THCTensorMathReduce.cuh>
@@ -33,4 +34,22 @@ Tensor embedding_backward_cuda_kernel(
     const Tensor &bag_size = Tensor(),
     const Tensor &per_sample_weights = Tensor());
 
+// Like embedding_backward_cuda_kernel, but applies `optimizer` to the rows of
+// `weight` (see EmbeddingFusedUpdate.h) instead of returning the gradient.
+void embedding_backward_fused_update_cuda_kernel(
+    Tensor &weight,
+    Tensor &optimizer_state,
+    EmbeddingFusedOptimizer optimizer,
+    double lr,
+    double eps,
+    const Tensor &grad,
+    const Tensor &orig_indices,
+    const Tensor &sorted_indices,
+    const Tensor &count,
+    int padding_idx = -1,
+    bool mode_mean = false,
+    const Tensor &offset2bag = Tensor(),
+    const Tensor &bag_size = Tensor(),
+    const Tensor &per_sample_weights = Tensor());
+
 }}
\ No newline at end of file
@@ -111,28 +111,13 @@ __global__ void EmbeddingBag_updateOutputKernel(
 
 
 
-Tensor embedding_bag_backward_cuda_sum_avg(
-                                   const Tensor &grad,
-                                   const Tensor &indices,
-                                   const Tensor &offset2bag,
-                                   const Tensor &bag_size,
-                                   int64_t num_weights,
-                                   bool scale_grad_by_freq, int64_t mode,
-                                   const Tensor& per_sample_weights) {
-
-  auto grad_weight = at::zeros({num_weights, grad.size(1)}, grad.options());
-
+// Sorts the indices, with their positions in `indices` as the values, and
+// counts the occurrences of every index if `scale_grad_by_freq`.
+std::tuple<Tensor, Tensor, Tensor> sort_indices_and_count(
+    const Tensor &indices, bool scale_grad_by_freq) {
   cudaStream_t stream = at::cuda::getCurrentCUDAStream();
-
   ptrdiff_t numel = indices.numel();
 
-  if (numel == 0) {
-    // all empty bags
-    return at::zeros({num_weights, grad.size(1)}, grad.options());
-  }
-
-  int64_t stride = grad_weight.stride(0);
-
   auto sorted_indices = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   auto orig_indices = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   using device_ptr = thrust::device_ptr<int64_t>;
@@ -183,6 +168,28 @@ Tensor embedding_bag_backward_cuda_sum_avg(
         thrust::make_reverse_iterator(count_data + numel),
         thrust::equal_to<int64_t>(), thrust::maximum<int64_t>());
   }
+  return std::make_tuple(sorted_indices, orig_indices, count);
+}
+
+Tensor embedding_bag_backward_cuda_sum_avg(
+                                   const Tensor &grad,
+                                   const Tensor &indices,
+                                   const Tensor &offset2bag,
+                                   const Tensor &bag_size,
+                                   int64_t num_weights,
+                                   bool scale_grad_by_freq, int64_t mode,
+                                   const Tensor& per_sample_weights) {
+
+  ptrdiff_t numel = indices.numel();
+
+  if (numel == 0) {
+    // all empty bags
+    return at::zeros({num_weights, grad.size(1)}, grad.options());
+  }
+
+  Tensor sorted_indices, orig_indices, count;
+  std::tie(sorted_indices, orig_indices, count) =
+      sort_indices_and_count(indices, scale_grad_by_freq);
   return embedding_backward_cuda_kernel(grad, orig_indices, sorted_indices,
       count, num_weights, /* padding_idx= */ -1, scale_grad_by_freq,
       mode == MODE_MEAN, offset2bag, bag_size, per_sample_weights);
@@ -356,6 +363,47 @@ Tensor _embedding_bag_dense_backward_cuda(const Tensor &grad_, const Tensor &ind
   }
 }
 
+void _embedding_bag_fused_update_cuda_(
+    Tensor& weight,
+    Tensor& optimizer_state,
+    const Tensor& grad_,
+    const Tensor& indices,
+    const Tensor& offsets,
+    const Tensor& offset2bag,
+    const Tensor& bag_size,
+    bool scale_grad_by_freq,
+    int64_t mode,
+    const Tensor& per_sample_weights,
+    std::string optimizer_name,
+    double lr,
+    double eps) {
+  const auto optimizer = embedding_fused_optimizer_from_string(optimizer_name);
+  check_embedding_fused_update_args(weight, optimizer_state, optimizer, mode);
+  TORCH_CHECK(mode == MODE_SUM || !per_sample_weights.defined(),
+      "_embedding_bag_fused_update_: per_sample_weights are only supported for mode='sum'");
+
+  Tensor grad = grad_.contiguous();
+  auto weight_arg = TensorArg(weight, "weight", 1);
+  auto grad_arg = TensorArg(grad, "grad", 3);
+  auto indices_arg = TensorArg(indices, "indices", 4);
+  checkSameGPU("_embedding_bag_fused_update_", weight_arg, grad_arg);
+  checkSameGPU("_embedding_bag_fused_update_", weight_arg, indices_arg);
+  checkScalarType("_embedding_bag_fused_update_", indices_arg, kLong);
+  checkSameType("_embedding_bag_fused_update_", weight_arg, grad_arg);
+
+  if (indices.numel() == 0) {
+    return;
+  }
+
+  Tensor sorted_indices, orig_indices, count;
+  std::tie(sorted_indices, orig_indices, count) =
+      sort_indices_and_count(indices, scale_grad_by_freq);
+  embedding_backward_fused_update_cuda_kernel(weight, optimizer_state,
+      optimizer, lr, eps, grad, orig_indices, sorted_indices, count,
+      /* padding_idx= */ -1, mode == MODE_MEAN, offset2bag, bag_size,
+      per_sample_weights);
+}
+
 template <typename scalar_t>
 __inline__ __device__
 static scalar_t warpReduceSum(scalar_t val) {
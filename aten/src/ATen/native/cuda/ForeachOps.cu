@@ -0,0 +1,271 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/ForeachUtils.h>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <vector>
+
+// The _foreach ops with one multi-tensor apply pass (see MultiTensorApply.cuh)
+// instead of one kernel per tensor. Inputs the kernels don't handle, see
+// can_use_fast_route, run op by op with the kernels of ForeachOps.cpp.
+//
+// The functors get depth - 1 input lists and the output list last; in-place
+// variants pass the list they write to as the first input and the output.
+
+namespace at { namespace native {
+
+namespace {
+
+using multi_tensor_apply_detail::ChunkInfo;
+using multi_tensor_apply_detail::TensorListMetadata;
+
+struct AddOp {
+  template <typename T>
+  __device__ __forceinline__ T operator()(T a, T b) const { return a + b; }
+};
+
+struct SubOp {
+  template <typename T>
+  __device__ __forceinline__ T operator()(T a, T b) const { return a - b; }
+};
+
+struct MulOp {
+  template <typename T>
+  __device__ __forceinline__ T operator()(T a, T b) const { return a * b; }
+};
+
+struct DivOp {
+  template <typename T>
+  __device__ __forceinline__ T operator()(T a, T b) const { return a / b; }
+};
+
+struct SqrtOp {
+  template <typename T>
+  __device__ __forceinline__ T operator()(T a) const { return ::sqrt(a); }
+};
+
+// out = op(x, scalar)
+template <typename scalar_t, int depth>
+struct BinaryOpScalarFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  template <typename Op>
+  __device__ __forceinline__ void operator()(
+      int64_t chunk_size, TensorListMetadata<depth>& tl, Op op, opmath_t scalar) {
+    ChunkInfo<depth> chunk(chunk_size, tl);
+    const auto* x = chunk.template ptr<scalar_t>(tl, 0);
+    auto* out = chunk.template ptr<scalar_t>(tl, depth - 1);
+    for (int64_t i = threadIdx.x; i < chunk.n; i += blockDim.x) {
+      out[i] = static_cast<scalar_t>(op(static_cast<opmath_t>(x[i]), scalar));
+    }
+  }
+};
+
+// out = op(x, alpha * y)
+template <typename scalar_t, int depth>
+struct BinaryOpListFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  template <typename Op>
+  __device__ __forceinline__ void operator()(
+      int64_t chunk_size, TensorListMetadata<depth>& tl, Op op, opmath_t alpha) {
+    ChunkInfo<depth> chunk(chunk_size, tl);
+    const auto* x = chunk.template ptr<scalar_t>(tl, 0);
+    const auto* y = chunk.template ptr<scalar_t>(tl, 1);
+    auto* out = chunk.template ptr<scalar_t>(tl, depth - 1);
+    for (int64_t i = threadIdx.x; i < chunk.n; i += blockDim.x) {
+      out[i] = static_cast<scalar_t>(
+          op(static_cast<opmath_t>(x[i]), alpha * static_cast<opmath_t>(y[i])));
+    }
+  }
+};
+
+// out = x + value * op(t1, t2)
+template <typename scalar_t, int depth>
+struct PointwiseOpFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  template <typename Op>
+  __device__ __forceinline__ void operator()(
+      int64_t chunk_size, TensorListMetadata<depth>& tl, Op op, opmath_t value) {
+    ChunkInfo<depth> chunk(chunk_size, tl);
+    const auto* x = chunk.template ptr<scalar_t>(tl, 0);
+    const auto* t1 = chunk.template ptr<scalar_t>(tl, 1);
+    const auto* t2 = chunk.template ptr<scalar_t>(tl, 2);
+    auto* out = chunk.template ptr<scalar_t>(tl, depth - 1);
+    for (int64_t i = threadIdx.x; i < chunk.n; i += blockDim.x) {
+      out[i] = static_cast<scalar_t>(
+          static_cast<opmath_t>(x[i]) +
+          value * op(static_cast<opmath_t>(t1[i]), static_cast<opmath_t>(t2[i])));
+    }
+  }
+};
+
+// out = op(x)
+template <typename scalar_t, int depth>
+struct UnaryOpFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  template <typename Op>
+  __device__ __forceinline__ void operator()(
+      int64_t chunk_size, TensorListMetadata<depth>& tl, Op op) {
+    ChunkInfo<depth> chunk(chunk_size, tl);
+    const auto* x = chunk.template ptr<scalar_t>(tl, 0);
+    auto* out = chunk.template ptr<scalar_t>(tl, depth - 1);
+    for (int64_t i = threadIdx.x; i < chunk.n; i += blockDim.x) {
+      out[i] = static_cast<scalar_t>(op(static_cast<opmath_t>(x[i])));
+    }
+  }
+};
+
+template <template <typename, int> class Functor, int depth, typename Op>
+void foreach_apply(std::vector<std::vector<Tensor>>& tensor_lists, Op op, Scalar scalar) {
+  c10::cuda::CUDAGuard device_guard(tensor_lists[0][0].device());
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(tensor_lists[0][0].scalar_type(), "foreach_apply_cuda", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    multi_tensor_apply<depth>(tensor_lists, Functor<scalar_t, depth>(), op, scalar.to<opmath_t>());
+  });
+}
+
+template <template <typename, int> class Functor, int depth, typename Op>
+void foreach_apply(std::vector<std::vector<Tensor>>& tensor_lists, Op op) {
+  c10::cuda::CUDAGuard device_guard(tensor_lists[0][0].device());
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(tensor_lists[0][0].scalar_type(), "foreach_apply_cuda", [&] {
+    multi_tensor_apply<depth>(tensor_lists, Functor<scalar_t, depth>(), op);
+  });
+}
+
+std::vector<Tensor> empty_like_list(TensorList tensors) {
+  std::vector<Tensor> result;
+  result.reserve(tensors.size());
+  for (const auto& tensor : tensors) {
+    result.push_back(at::empty_like(tensor));
+  }
+  return result;
+}
+
+} // namespace
+
+#define FOREACH_BINARY_OP_SCALAR(NAME, OP)                                                   \
+std::vector<Tensor> foreach_tensor_##NAME##_scalar_kernel_cuda(TensorList tensors, Scalar scalar) { \
+  check_foreach_api_restrictions(tensors);                                                 \
+  if (!can_use_fast_route({tensors}, {scalar})) {                                          \
+    return at::native::foreach_tensor_##NAME##_scalar_kernel_slow(tensors, scalar);        \
+  }                                                                                        \
+  std::vector<std::vector<Tensor>> tensor_lists{tensors.vec(), empty_like_list(tensors)};  \
+  foreach_apply<BinaryOpScalarFunctor, 2>(tensor_lists, OP(), scalar);                     \
+  return tensor_lists[1];                                                                  \
+}                                                                                          \
+                                                                                           \
+void foreach_tensor_##NAME##_scalar_kernel_cuda_(TensorList tensors, Scalar scalar) {      \
+  check_foreach_api_restrictions(tensors);                                                 \
+  if (!can_use_fast_route({tensors}, {scalar})) {                                          \
+    return at::native::foreach_tensor_##NAME##_scalar_kernel_slow_(tensors, scalar);       \
+  }                                                                                        \
+  std::vector<std::vector<Tensor>> tensor_lists{tensors.vec()};                            \
+  foreach_apply<BinaryOpScalarFunctor, 1>(tensor_lists, OP(), scalar);                     \
+}
+
+#define FOREACH_BINARY_OP_LIST_ALPHA(NAME, OP)                                               \
+std::vector<Tensor> foreach_tensor_##NAME##_list_kernel_cuda(                              \
+    TensorList tensors1, TensorList tensors2, Scalar alpha) {                              \
+  check_foreach_api_restrictions(tensors1, tensors2);                                      \
+  if (!can_use_fast_route({tensors1, tensors2}, {alpha})) {                                \
+    return at::native::foreach_tensor_##NAME##_list_kernel_slow(tensors1, tensors2, alpha); \
+  }                                                                                        \
+  std::vector<std::vector<Tensor>> tensor_lists{                                           \
+      tensors1.vec(), tensors2.vec(), empty_like_list(tensors1)};                          \
+  foreach_apply<BinaryOpListFunctor, 3>(tensor_lists, OP(), alpha);                        \
+  return tensor_lists[2];                                                                  \
+}                                                                                          \
+                                                                                           \
+void foreach_tensor_##NAME##_list_kernel_cuda_(TensorList self, TensorList other, Scalar alpha) { \
+  check_foreach_api_restrictions(self, other);                                             \
+  if (!can_use_fast_route({self, other}, {alpha})) {                                       \
+    return at::native::foreach_tensor_##NAME##_list_kernel_slow_(self, other, alpha);      \
+  }                                                                                        \
+  std::vector<std::vector<Tensor>> tensor_lists{self.vec(), other.vec()};                  \
+  foreach_apply<BinaryOpListFunctor, 2>(tensor_lists, OP(), alpha);                        \
+}
+
+#define FOREACH_BINARY_OP_LIST(NAME, OP)                                                     \
+std::vector<Tensor> foreach_tensor_##NAME##_list_kernel_cuda(                              \
+    TensorList tensors1, TensorList tensors2) {                                            \
+  check_foreach_api_restrictions(tensors1, tensors2);                                      \
+  if (!can_use_fast_route({tensors1, tensors2})) {                                         \
+    return at::native::foreach_tensor_##NAME##_list_kernel_slow(tensors1, tensors2);       \
+  }                                                                                        \
+  std::vector<std::vector<Tensor>> tensor_lists{                                           \
+      tensors1.vec(), tensors2.vec(), empty_like_list(tensors1)};                          \
+  foreach_apply<BinaryOpListFunctor, 3>(tensor_lists, OP(), /*alpha=*/1);                  \
+  return tensor_lists[2];                                                                  \
+}                                                                                          \
+                                                                                           \
+void foreach_tensor_##NAME##_list_kernel_cuda_(TensorList self, TensorList other) {        \
+  check_foreach_api_restrictions(self, other);                                             \
+  if (!can_use_fast_route({self, other})) {                                                \
+    return at::native::foreach_tensor_##NAME##_list_kernel_slow_(self, other);             \
+  }                                                                                        \
+  std::vector<std::vector<Tensor>> tensor_lists{self.vec(), other.vec()};                  \
+  foreach_apply<BinaryOpListFunctor, 2>(tensor_lists, OP(), /*alpha=*/1);                  \
+}
+
+#define FOREACH_POINTWISE_OP(NAME, OP)                                                       \
+std::vector<Tensor> foreach_tensor_##NAME##_kernel_cuda(                                   \
+    TensorList input, TensorList tensors1, TensorList tensors2, Scalar value) {            \
+  check_foreach_api_restrictions(input, tensors1, tensors2);                               \
+  if (!can_use_fast_route({input, tensors1, tensors2}, {value})) {                         \
+    return at::native::foreach_tensor_##NAME##_kernel_slow(input, tensors1, tensors2, value); \
+  }                                                                                        \
+  std::vector<std::vector<Tensor>> tensor_lists{                                           \
+      input.vec(), tensors1.vec(), tensors2.vec(), empty_like_list(input)};                \
+  foreach_apply<PointwiseOpFunctor, 4>(tensor_lists, OP(), value);                         \
+  return tensor_lists[3];                                                                  \
+}                                                                                          \
+                                                                                           \
+void foreach_tensor_##NAME##_kernel_cuda_(                                                 \
+    TensorList self, TensorList tensors1, TensorList tensors2, Scalar value) {             \
+  check_foreach_api_restrictions(self, tensors1, tensors2);                                \
+  if (!can_use_fast_route({self, tensors1, tensors2}, {value})) {                          \
+    return at::native::foreach_tensor_##NAME##_kernel_slow_(self, tensors1, tensors2, value); \
+  }                                                                                        \
+  std::vector<std::vector<Tensor>> tensor_lists{self.vec(), tensors1.vec(), tensors2.vec()}; \
+  foreach_apply<PointwiseOpFunctor, 3>(tensor_lists, OP(), value);                         \
+}
+
+#define FOREACH_UNARY_OP(NAME, OP)                                                           \
+std::vector<Tensor> foreach_tensor_##NAME##_kernel_cuda(TensorList tensors) {              \
+  check_foreach_api_restrictions(tensors);                                                 \
+  if (!can_use_fast_route({tensors})) {                                                    \
+    return at::native::foreach_tensor_##NAME##_kernel_slow(tensors);                       \
+  }                                                                                        \
+  std::vector<std::vector<Tensor>> tensor_lists{tensors.vec(), empty_like_list(tensors)};  \
+  foreach_apply<UnaryOpFunctor, 2>(tensor_lists, OP());                                    \
+  return tensor_lists[1];                                                                  \
+}                                                                                          \
+                                                                                           \
+void foreach_tensor_##NAME##_kernel_cuda_(TensorList tensors) {                            \
+  check_foreach_api_restrictions(tensors);                                                 \
+  if (!can_use_fast_route({tensors})) {                                                    \
+    return at::native::foreach_tensor_##NAME##_kernel_slow_(tensors);                      \
+  }                                                                                        \
+  std::vector<std::vector<Tensor>> tensor_lists{tensors.vec()};                            \
+  foreach_apply<UnaryOpFunctor, 1>(tensor_lists, OP());                                    \
+}
+
+FOREACH_BINARY_OP_SCALAR(add, AddOp);
+FOREACH_BINARY_OP_SCALAR(sub, SubOp);
+FOREACH_BINARY_OP_SCALAR(mul, MulOp);
+FOREACH_BINARY_OP_SCALAR(div, DivOp);
+FOREACH_BINARY_OP_LIST_ALPHA(add, AddOp);
+FOREACH_BINARY_OP_LIST_ALPHA(sub, SubOp);
+FOREACH_BINARY_OP_LIST(mul, MulOp);
+FOREACH_BINARY_OP_LIST(div, DivOp);
+FOREACH_POINTWISE_OP(addcmul, MulOp);
+FOREACH_POINTWISE_OP(addcdiv, DivOp);
+FOREACH_UNARY_OP(sqrt, SqrtOp);
+
+}} // namespace at::native
@@ -0,0 +1,500 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
+#include <THC/THCAtomics.cuh>
+#include <THC/THCDeviceUtils.cuh>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <cmath>
+
+// Fused optimizer steps. Each op updates all parameters of a parameter group,
+// and their optimizer state, with one multi-tensor apply pass (see
+// MultiTensorApply.cuh) instead of several element-wise kernels per
+// parameter. The math matches the corresponding torch.optim and
+// torch::optim implementations, computed in acc_type precision.
+//
+// Adam and SGD take an optional found_inf, see native_functions.yaml; every
+// block reads it on the device and returns before touching its chunk when it
+// is set, so a step after a gradient scaler found infs needs no host sync.
+
+namespace at { namespace native {
+
+namespace {
+
+using multi_tensor_apply_detail::ChunkInfo;
+using multi_tensor_apply_detail::TensorListMetadata;
+
+template <typename T>
+struct AdamHyperparams {
+  T lr;
+  T beta1;
+  T beta2;
+  T eps;
+  T weight_decay;
+  T bias_correction1;
+  T sqrt_bias_correction2;
+  bool decoupled_weight_decay;
+};
+
+// tensor lists: params, grads, exp_avgs, exp_avg_sqs[, max_exp_avg_sqs]
+template <typename scalar_t, int depth>
+struct AdamFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+  static constexpr bool amsgrad = depth == 5;
+
+  __device__ __forceinline__ void operator()(
+      int64_t chunk_size, TensorListMetadata<depth>& tl,
+      AdamHyperparams<opmath_t> hp, const float* found_inf) {
+    if (found_inf != nullptr && *found_inf != 0) {
+      return;
+    }
+    ChunkInfo<depth> chunk(chunk_size, tl);
+    auto* param = chunk.template ptr<scalar_t>(tl, 0);
+    const auto* grad = chunk.template ptr<scalar_t>(tl, 1);
+    auto* exp_avg = chunk.template ptr<scalar_t>(tl, 2);
+    auto* exp_avg_sq = chunk.template ptr<scalar_t>(tl, 3);
+    auto* max_exp_avg_sq = amsgrad ? chunk.template ptr<scalar_t>(tl, depth - 1) : nullptr;
+
+    for (int64_t i = threadIdx.x; i < chunk.n; i += blockDim.x) {
+      opmath_t p = static_cast<opmath_t>(param[i]);
+      opmath_t g = static_cast<opmath_t>(grad[i]);
+      if (hp.weight_decay != 0) {
+        if (hp.decoupled_weight_decay) {
+          p *= 1 - hp.lr * hp.weight_decay;
+        } else {
+          g += hp.weight_decay * p;
+        }
+      }
+      opmath_t m = hp.beta1 * static_cast<opmath_t>(exp_avg[i]) + (1 - hp.beta1) * g;
+      opmath_t v = hp.beta2 * static_cast<opmath_t>(exp_avg_sq[i]) + (1 - hp.beta2) * g * g;
+      exp_avg[i] = static_cast<scalar_t>(m);
+      exp_avg_sq[i] = static_cast<scalar_t>(v);
+      if (amsgrad) {
+        v = ::max(static_cast<opmath_t>(max_exp_avg_sq[i]), v);
+        max_exp_avg_sq[i] = static_cast<scalar_t>(v);
+      }
+      const opmath_t denom = ::sqrt(v) / hp.sqrt_bias_correction2 + hp.eps;
+      param[i] = static_cast<scalar_t>(p - (hp.lr / hp.bias_correction1) * m / denom);
+    }
+  }
+};
+
+template <typename T>
+struct SGDHyperparams {
+  T lr;
+  T momentum;
+  T dampening;
+  T weight_decay;
+  bool nesterov;
+  bool first_run;
+};
+
+// tensor lists: params, grads[, momentum_buffers]
+template <typename scalar_t, int depth>
+struct SGDFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+  static constexpr bool use_momentum = depth == 3;
+
+  __device__ __forceinline__ void operator()(
+      int64_t chunk_size, TensorListMetadata<depth>& tl,
+      SGDHyperparams<opmath_t> hp, const float* found_inf) {
+    if (found_inf != nullptr && *found_inf != 0) {
+      return;
+    }
+    ChunkInfo<depth> chunk(chunk_size, tl);
+    auto* param = chunk.template ptr<scalar_t>(tl, 0);
+    const auto* grad = chunk.template ptr<scalar_t>(tl, 1);
+    auto* momentum_buffer = use_momentum ? chunk.template ptr<scalar_t>(tl, depth - 1) : nullptr;
+
+    for (int64_t i = threadIdx.x; i < chunk.n; i += blockDim.x) {
+      const opmath_t p = static_cast<opmath_t>(param[i]);
+      opmath_t d_p = static_cast<opmath_t>(grad[i]) + hp.weight_decay * p;
+      if (use_momentum) {
+        opmath_t buf = hp.first_run
+            ? d_p
+            : hp.momentum * static_cast<opmath_t>(momentum_buffer[i]) + (1 - hp.dampening) * d_p;
+        momentum_buffer[i] = static_cast<scalar_t>(buf);
+        d_p = hp.nesterov ? d_p + hp.momentum * buf : buf;
+      }
+      param[i] = static_cast<scalar_t>(p - hp.lr * d_p);
+    }
+  }
+};
+
+template <typename T>
+struct AdagradHyperparams {
+  T clr;
+  T weight_decay;
+  T eps;
+};
+
+// tensor lists: params, grads, state_sums
+template <typename scalar_t>
+struct AdagradFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  __device__ __forceinline__ void operator()(
+      int64_t chunk_size, TensorListMetadata<3>& tl,
+      AdagradHyperparams<opmath_t> hp) {
+    ChunkInfo<3> chunk(chunk_size, tl);
+    auto* param = chunk.template ptr<scalar_t>(tl, 0);
+    const auto* grad = chunk.template ptr<scalar_t>(tl, 1);
+    auto* state_sum = chunk.template ptr<scalar_t>(tl, 2);
+
+    for (int64_t i = threadIdx.x; i < chunk.n; i += blockDim.x) {
+      const opmath_t p = static_cast<opmath_t>(param[i]);
+      const opmath_t g = static_cast<opmath_t>(grad[i]) + hp.weight_decay * p;
+      const opmath_t sum = static_cast<opmath_t>(state_sum[i]) + g * g;
+      state_sum[i] = static_cast<scalar_t>(sum);
+      param[i] = static_cast<scalar_t>(p - hp.clr * g / (::sqrt(sum) + hp.eps));
+    }
+  }
+};
+
+template <typename T>
+struct RMSpropHyperparams {
+  T lr;
+  T alpha;
+  T eps;
+  T weight_decay;
+  T momentum;
+};
+
+// tensor lists: params, grads, square_avgs[, momentum_buffers][, grad_avgs]
+template <typename scalar_t, int depth, bool use_momentum, bool centered>
+struct RMSpropFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  __device__ __forceinline__ void operator()(
+      int64_t chunk_size, TensorListMetadata<depth>& tl,
+      RMSpropHyperparams<opmath_t> hp) {
+    ChunkInfo<depth> chunk(chunk_size, tl);
+    auto* param = chunk.template ptr<scalar_t>(tl, 0);
+    const auto* grad = chunk.template ptr<scalar_t>(tl, 1);
+    auto* square_avg = chunk.template ptr<scalar_t>(tl, 2);
+    auto* momentum_buffer = use_momentum ? chunk.template ptr<scalar_t>(tl, 3) : nullptr;
+    auto* grad_avg = centered ? chunk.template ptr<scalar_t>(tl, depth - 1) : nullptr;
+
+    for (int64_t i = threadIdx.x; i < chunk.n; i += blockDim.x) {
+      const opmath_t p = static_cast<opmath_t>(param[i]);
+      const opmath_t g = static_cast<opmath_t>(grad[i]) + hp.weight_decay * p;
+      const opmath_t sq = hp.alpha * static_cast<opmath_t>(square_avg[i]) + (1 - hp.alpha) * g * g;
+      square_avg[i] = static_cast<scalar_t>(sq);
+      opmath_t avg;
+      if (centered) {
+        const opmath_t ga = hp.alpha * static_cast<opmath_t>(grad_avg[i]) + (1 - hp.alpha) * g;
+        grad_avg[i] = static_cast<scalar_t>(ga);
+        avg = ::sqrt(sq - ga * ga) + hp.eps;
+      } else {
+        avg = ::sqrt(sq) + hp.eps;
+      }
+      if (use_momentum) {
+        const opmath_t buf = hp.momentum * static_cast<opmath_t>(momentum_buffer[i]) + g / avg;
+        momentum_buffer[i] = static_cast<scalar_t>(buf);
+        param[i] = static_cast<scalar_t>(p - hp.lr * buf);
+      } else {
+        param[i] = static_cast<scalar_t>(p - hp.lr * g / avg);
+      }
+    }
+  }
+};
+
+// LAMB (https://arxiv.org/abs/1904.00962) needs the norms of each parameter
+// and of its Adam update before it can scale the update, so it runs in three
+// passes: compute the updates, accumulate their squared norms per tensor,
+// apply them.
+
+// tensor lists: params, grads, exp_avgs, exp_avg_sqs, updates
+template <typename scalar_t>
+struct LambUpdateFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  __device__ __forceinline__ void operator()(
+      int64_t chunk_size, TensorListMetadata<5>& tl,
+      AdamHyperparams<opmath_t> hp) {
+    ChunkInfo<5> chunk(chunk_size, tl);
+    const auto* param = chunk.template ptr<scalar_t>(tl, 0);
+    const auto* grad = chunk.template ptr<scalar_t>(tl, 1);
+    auto* exp_avg = chunk.template ptr<scalar_t>(tl, 2);
+    auto* exp_avg_sq = chunk.template ptr<scalar_t>(tl, 3);
+    auto* update = chunk.template ptr<scalar_t>(tl, 4);
+
+    for (int64_t i = threadIdx.x; i < chunk.n; i += blockDim.x) {
+      const opmath_t g = static_cast<opmath_t>(grad[i]);
+      const opmath_t m = hp.beta1 * static_cast<opmath_t>(exp_avg[i]) + (1 - hp.beta1) * g;
+      const opmath_t v = hp.beta2 * static_cast<opmath_t>(exp_avg_sq[i]) + (1 - hp.beta2) * g * g;
+      exp_avg[i] = static_cast<scalar_t>(m);
+      exp_avg_sq[i] = static_cast<scalar_t>(v);
+      const opmath_t denom = ::sqrt(v) / hp.sqrt_bias_correction2 + hp.eps;
+      update[i] = static_cast<scalar_t>(
+          (m / hp.bias_correction1) / denom + hp.weight_decay * static_cast<opmath_t>(param[i]));
+    }
+  }
+};
+
+template <typename T>
+__device__ __forceinline__ T block_reduce_sum(T val, T* shared) {
+  const int lid = threadIdx.x % C10_WARP_SIZE;
+  const int wid = threadIdx.x / C10_WARP_SIZE;
+  for (int offset = C10_WARP_SIZE / 2; offset > 0; offset >>= 1) {
+    val += WARP_SHFL_DOWN(val, offset);
+  }
+  if (lid == 0) {
+    shared[wid] = val;
+  }
+  __syncthreads();
+  val = (threadIdx.x < blockDim.x / C10_WARP_SIZE) ? shared[lid] : T(0);
+  if (wid == 0) {
+    for (int offset = C10_WARP_SIZE / 2; offset > 0; offset >>= 1) {
+      val += WARP_SHFL_DOWN(val, offset);
+    }
+  }
+  return val;
+}
+
+// tensor lists: params, updates. Adds the squared norms of this chunk of the
+// parameter and of the update to param_norms and update_norms.
+template <typename scalar_t>
+struct LambNormFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  __device__ __forceinline__ void operator()(
+      int64_t chunk_size, TensorListMetadata<2>& tl,
+      opmath_t* param_norms, opmath_t* update_norms) {
+    __shared__ opmath_t param_shared[C10_WARP_SIZE];
+    __shared__ opmath_t update_shared[C10_WARP_SIZE];
+    ChunkInfo<2> chunk(chunk_size, tl);
+    const auto* param = chunk.template ptr<scalar_t>(tl, 0);
+    const auto* update = chunk.template ptr<scalar_t>(tl, 1);
+
+    opmath_t param_sum = 0;
+    opmath_t update_sum = 0;
+    for (int64_t i = threadIdx.x; i < chunk.n; i += blockDim.x) {
+      const opmath_t p = static_cast<opmath_t>(param[i]);
+      const opmath_t u = static_cast<opmath_t>(update[i]);
+      param_sum += p * p;
+      update_sum += u * u;
+    }
+    param_sum = block_reduce_sum(param_sum, param_shared);
+    update_sum = block_reduce_sum(update_sum, update_shared);
+    if (threadIdx.x == 0) {
+      const int t = tl.tensor_index[chunk.tensor_loc];
+      gpuAtomicAdd(&param_norms[t], param_sum);
+      gpuAtomicAdd(&update_norms[t], update_sum);
+    }
+  }
+};
+
+// tensor lists: params, updates
+template <typename scalar_t>
+struct LambApplyFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  __device__ __forceinline__ void operator()(
+      int64_t chunk_size, TensorListMetadata<2>& tl, opmath_t lr,
+      const opmath_t* param_norms, const opmath_t* update_norms) {
+    ChunkInfo<2> chunk(chunk_size, tl);
+    auto* param = chunk.template ptr<scalar_t>(tl, 0);
+    const auto* update = chunk.template ptr<scalar_t>(tl, 1);
+
+    const int t = tl.tensor_index[chunk.tensor_loc];
+    const opmath_t param_norm = ::sqrt(param_norms[t]);
+    const opmath_t update_norm = ::sqrt(update_norms[t]);
+    const opmath_t trust_ratio =
+        (param_norm > 0 && update_norm > 0) ? param_norm / update_norm : opmath_t(1);
+    for (int64_t i = threadIdx.x; i < chunk.n; i += blockDim.x) {
+      param[i] = static_cast<scalar_t>(
+          static_cast<opmath_t>(param[i]) - lr * trust_ratio * static_cast<opmath_t>(update[i]));
+    }
+  }
+};
+
+template <typename T>
+AdamHyperparams<T> make_adam_hyperparams(
+    double lr, double beta1, double beta2, double eps, double weight_decay,
+    int64_t step, bool bias_correction, bool decoupled_weight_decay) {
+  TORCH_CHECK(step > 0, "expected step > 0, but got ", step);
+  AdamHyperparams<T> hp;
+  hp.lr = lr;
+  hp.beta1 = beta1;
+  hp.beta2 = beta2;
+  hp.eps = eps;
+  hp.weight_decay = weight_decay;
+  hp.bias_correction1 = bias_correction ? 1 - std::pow(beta1, step) : 1;
+  hp.sqrt_bias_correction2 = bias_correction ? std::sqrt(1 - std::pow(beta2, step)) : 1;
+  hp.decoupled_weight_decay = decoupled_weight_decay;
+  return hp;
+}
+
+// The device pointer of an optional found_inf, or nullptr.
+const float* found_inf_ptr(const Tensor& found_inf, const Tensor& param) {
+  if (!found_inf.defined()) {
+    return nullptr;
+  }
+  TORCH_CHECK(found_inf.is_cuda() && found_inf.device() == param.device(),
+              "found_inf must be a CUDA tensor on ", param.device());
+  TORCH_CHECK(found_inf.numel() == 1 && found_inf.scalar_type() == kFloat,
+              "found_inf must be a 1-element float tensor.");
+  return found_inf.data_ptr<float>();
+}
+
+} // anonymous namespace
+
+void _fused_adam_cuda_(
+    TensorList self, TensorList grads, TensorList exp_avgs, TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs, double lr, double beta1, double beta2, double eps,
+    double weight_decay, int64_t step, bool amsgrad, bool decoupled_weight_decay,
+    const Tensor& found_inf) {
+  std::vector<std::vector<Tensor>> tensor_lists{
+      self.vec(), grads.vec(), exp_avgs.vec(), exp_avg_sqs.vec()};
+  if (amsgrad) {
+    tensor_lists.push_back(max_exp_avg_sqs.vec());
+  } else {
+    TORCH_CHECK(max_exp_avg_sqs.empty(),
+                "_fused_adam_: max_exp_avg_sqs must be empty if amsgrad is False");
+  }
+  check_multi_tensor_apply_inputs("_fused_adam_", tensor_lists);
+  c10::cuda::CUDAGuard device_guard(self[0].device());
+  const float* skip = found_inf_ptr(found_inf, self[0]);
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "_fused_adam_cuda_", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    auto hp = make_adam_hyperparams<opmath_t>(
+        lr, beta1, beta2, eps, weight_decay, step, /*bias_correction=*/true,
+        decoupled_weight_decay);
+    if (amsgrad) {
+      multi_tensor_apply<5>(tensor_lists, AdamFunctor<scalar_t, 5>(), hp, skip);
+    } else {
+      multi_tensor_apply<4>(tensor_lists, AdamFunctor<scalar_t, 4>(), hp, skip);
+    }
+  });
+}
+
+void _fused_sgd_cuda_(
+    TensorList self, TensorList grads, TensorList momentum_buffers, double lr,
+    double momentum, double dampening, double weight_decay, bool nesterov,
+    bool first_run, const Tensor& found_inf) {
+  TORCH_CHECK(!nesterov || (momentum > 0 && dampening == 0),
+              "_fused_sgd_: Nesterov momentum requires a momentum and zero dampening");
+  std::vector<std::vector<Tensor>> tensor_lists{self.vec(), grads.vec()};
+  if (momentum != 0) {
+    tensor_lists.push_back(momentum_buffers.vec());
+  } else {
+    TORCH_CHECK(momentum_buffers.empty(),
+                "_fused_sgd_: momentum_buffers must be empty if momentum is 0");
+  }
+  check_multi_tensor_apply_inputs("_fused_sgd_", tensor_lists);
+  c10::cuda::CUDAGuard device_guard(self[0].device());
+  const float* skip = found_inf_ptr(found_inf, self[0]);
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "_fused_sgd_cuda_", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    SGDHyperparams<opmath_t> hp;
+    hp.lr = lr;
+    hp.momentum = momentum;
+    hp.dampening = dampening;
+    hp.weight_decay = weight_decay;
+    hp.nesterov = nesterov;
+    hp.first_run = first_run;
+    if (momentum != 0) {
+      multi_tensor_apply<3>(tensor_lists, SGDFunctor<scalar_t, 3>(), hp, skip);
+    } else {
+      multi_tensor_apply<2>(tensor_lists, SGDFunctor<scalar_t, 2>(), hp, skip);
+    }
+  });
+}
+
+void _fused_adagrad_cuda_(
+    TensorList self, TensorList grads, TensorList state_sums, double lr,
+    double lr_decay, double weight_decay, double eps, int64_t step) {
+  TORCH_CHECK(step > 0, "expected step > 0, but got ", step);
+  std::vector<std::vector<Tensor>> tensor_lists{self.vec(), grads.vec(), state_sums.vec()};
+  check_multi_tensor_apply_inputs("_fused_adagrad_", tensor_lists);
+  c10::cuda::CUDAGuard device_guard(self[0].device());
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "_fused_adagrad_cuda_", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    AdagradHyperparams<opmath_t> hp;
+    hp.clr = lr / (1 + static_cast<double>(step - 1) * lr_decay);
+    hp.weight_decay = weight_decay;
+    hp.eps = eps;
+    multi_tensor_apply<3>(tensor_lists, AdagradFunctor<scalar_t>(), hp);
+  });
+}
+
+void _fused_rmsprop_cuda_(
+    TensorList self, TensorList grads, TensorList square_avgs,
+    TensorList momentum_buffers, TensorList grad_avgs, double lr, double alpha,
+    double eps, double weight_decay, double momentum, bool centered) {
+  std::vector<std::vector<Tensor>> tensor_lists{self.vec(), grads.vec(), square_avgs.vec()};
+  if (momentum > 0) {
+    tensor_lists.push_back(momentum_buffers.vec());
+  } else {
+    TORCH_CHECK(momentum_buffers.empty(),
+                "_fused_rmsprop_: momentum_buffers must be empty unless momentum is positive");
+  }
+  if (centered) {
+    tensor_lists.push_back(grad_avgs.vec());
+  } else {
+    TORCH_CHECK(grad_avgs.empty(),
+                "_fused_rmsprop_: grad_avgs must be empty if centered is False");
+  }
+  check_multi_tensor_apply_inputs("_fused_rmsprop_", tensor_lists);
+  c10::cuda::CUDAGuard device_guard(self[0].device());
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "_fused_rmsprop_cuda_", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    RMSpropHyperparams<opmath_t> hp;
+    hp.lr = lr;
+    hp.alpha = alpha;
+    hp.eps = eps;
+    hp.weight_decay = weight_decay;
+    hp.momentum = momentum;
+    if (momentum > 0 && centered) {
+      multi_tensor_apply<5>(tensor_lists, RMSpropFunctor<scalar_t, 5, true, true>(), hp);
+    } else if (momentum > 0) {
+      multi_tensor_apply<4>(tensor_lists, RMSpropFunctor<scalar_t, 4, true, false>(), hp);
+    } else if (centered) {
+      multi_tensor_apply<4>(tensor_lists, RMSpropFunctor<scalar_t, 4, false, true>(), hp);
+    } else {
+      multi_tensor_apply<3>(tensor_lists, RMSpropFunctor<scalar_t, 3, false, false>(), hp);
+    }
+  });
+}
+
+void _fused_lamb_cuda_(
+    TensorList self, TensorList grads, TensorList exp_avgs, TensorList exp_avg_sqs,
+    double lr, double beta1, double beta2, double eps, double weight_decay,
+    int64_t step, bool bias_correction) {
+  std::vector<Tensor> updates;
+  updates.reserve(self.size());
+  for (const auto& p : self) {
+    updates.push_back(at::empty_like(p, LEGACY_CONTIGUOUS_MEMORY_FORMAT));
+  }
+  std::vector<std::vector<Tensor>> tensor_lists{
+      self.vec(), grads.vec(), exp_avgs.vec(), exp_avg_sqs.vec(), updates};
+  check_multi_tensor_apply_inputs("_fused_lamb_", tensor_lists);
+  c10::cuda::CUDAGuard device_guard(self[0].device());
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "_fused_lamb_cuda_", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    auto hp = make_adam_hyperparams<opmath_t>(
+        lr, beta1, beta2, eps, weight_decay, step, bias_correction,
+        /*decoupled_weight_decay=*/false);
+    multi_tensor_apply<5>(tensor_lists, LambUpdateFunctor<scalar_t>(), hp);
+
+    const auto norm_options = self[0].options().dtype(
+        std::is_same<opmath_t, double>::value ? kDouble : kFloat);
+    auto norms = at::zeros({2, static_cast<int64_t>(self.size())}, norm_options);
+    auto* param_norms = norms[0].data_ptr<opmath_t>();
+    auto* update_norms = norms[1].data_ptr<opmath_t>();
+    std::vector<std::vector<Tensor>> apply_lists{self.vec(), updates};
+    multi_tensor_apply<2>(apply_lists, LambNormFunctor<scalar_t>(), param_norms, update_norms);
+    multi_tensor_apply<2>(apply_lists, LambApplyFunctor<scalar_t>(), static_cast<opmath_t>(lr),
+                          static_cast<const opmath_t*>(param_norms),
+                          static_cast<const opmath_t*>(update_norms));
+  });
+}
+
+}} // namespace at::native
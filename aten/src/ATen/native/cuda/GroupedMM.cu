@@ -0,0 +1,239 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/LinearAlgebraUtils.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <cstring>
+#include <limits>
+
+// Grouped matrix multiply: computes self[i] @ mat2[i] for a list of matrix
+// pairs whose shapes may all differ.
+//
+// cublas<t>gemmBatched and gemmStridedBatched require every problem in the
+// batch to share m, n and k, so a list such as the per-expert or per-sequence
+// projections of a grouped linear layer would otherwise need one cuBLAS call
+// per pair. Instead, every output is cut into BM x BN tiles and all tiles of
+// all problems are computed by a single kernel launch; each block looks up the
+// problem its tile belongs to from a small descriptor table.
+//
+// Problems big enough to keep the device busy on their own are still sent to
+// cuBLAS through at::mm.
+
+namespace at { namespace native {
+
+namespace {
+
+constexpr int BM = 64;
+constexpr int BN = 64;
+constexpr int BK = 16;
+constexpr int THREADS_X = 16;
+constexpr int THREADS_Y = 16;
+constexpr int TM = BM / THREADS_Y;
+constexpr int TN = BN / THREADS_X;
+
+// Products with at least this many multiply-adds go to cuBLAS.
+constexpr int64_t kMaxGroupedProblemSize = 256 * 256 * 256;
+
+template <typename scalar_t>
+struct GroupedMMProblem {
+  const scalar_t* a;
+  const scalar_t* b;
+  scalar_t* c;
+  int64_t m, n, k;
+  int64_t a_stride0, a_stride1;
+  int64_t b_stride0, b_stride1;
+  // Index of the first tile of this problem and number of tiles along n.
+  int64_t tile_start;
+  int64_t tiles_n;
+};
+
+template <typename scalar_t, typename acc_t>
+__global__ void grouped_mm_kernel(
+    const GroupedMMProblem<scalar_t>* __restrict__ problems,
+    int64_t num_problems) {
+  __shared__ acc_t As[BK][BM];
+  __shared__ acc_t Bs[BK][BN];
+
+  const int64_t tile = blockIdx.x;
+
+  // Find the last problem whose first tile is not after this one.
+  int64_t lo = 0;
+  int64_t hi = num_problems - 1;
+  while (lo < hi) {
+    int64_t mid = (lo + hi + 1) / 2;
+    if (problems[mid].tile_start <= tile) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  const GroupedMMProblem<scalar_t> p = problems[lo];
+
+  const int64_t local = tile - p.tile_start;
+  const int64_t row0 = (local / p.tiles_n) * BM;
+  const int64_t col0 = (local % p.tiles_n) * BN;
+
+  const int tx = threadIdx.x;
+  const int ty = threadIdx.y;
+  const int tid = ty * THREADS_X + tx;
+
+  acc_t acc[TM][TN];
+  #pragma unroll
+  for (int i = 0; i < TM; ++i) {
+    #pragma unroll
+    for (int j = 0; j < TN; ++j) {
+      acc[i][j] = acc_t(0);
+    }
+  }
+
+  for (int64_t k0 = 0; k0 < p.k; k0 += BK) {
+    for (int i = tid; i < BM * BK; i += THREADS_X * THREADS_Y) {
+      const int r = i / BK;
+      const int kk = i % BK;
+      const int64_t gr = row0 + r;
+      const int64_t gk = k0 + kk;
+      As[kk][r] = (gr < p.m && gk < p.k)
+          ? static_cast<acc_t>(p.a[gr * p.a_stride0 + gk * p.a_stride1])
+          : acc_t(0);
+    }
+    for (int i = tid; i < BK * BN; i += THREADS_X * THREADS_Y) {
+      const int kk = i / BN;
+      const int c = i % BN;
+      const int64_t gk = k0 + kk;
+      const int64_t gc = col0 + c;
+      Bs[kk][c] = (gk < p.k && gc < p.n)
+          ? static_cast<acc_t>(p.b[gk * p.b_stride0 + gc * p.b_stride1])
+          : acc_t(0);
+    }
+    __syncthreads();
+
+    #pragma unroll
+    for (int kk = 0; kk < BK; ++kk) {
+      acc_t a_reg[TM];
+      acc_t b_reg[TN];
+      #pragma unroll
+      for (int i = 0; i < TM; ++i) {
+        a_reg[i] = As[kk][ty + i * THREADS_Y];
+      }
+      #pragma unroll
+      for (int j = 0; j < TN; ++j) {
+        b_reg[j] = Bs[kk][tx + j * THREADS_X];
+      }
+      #pragma unroll
+      for (int i = 0; i < TM; ++i) {
+        #pragma unroll
+        for (int j = 0; j < TN; ++j) {
+          acc[i][j] += a_reg[i] * b_reg[j];
+        }
+      }
+    }
+    __syncthreads();
+  }
+
+  #pragma unroll
+  for (int i = 0; i < TM; ++i) {
+    const int64_t r = row0 + ty + i * THREADS_Y;
+    if (r >= p.m) {
+      continue;
+    }
+    #pragma unroll
+    for (int j = 0; j < TN; ++j) {
+      const int64_t c = col0 + tx + j * THREADS_X;
+      if (c < p.n) {
+        p.c[r * p.n + c] = static_cast<scalar_t>(acc[i][j]);
+      }
+    }
+  }
+}
+
+template <typename scalar_t>
+void grouped_mm_launch(
+    TensorList self, TensorList mat2, std::vector<Tensor>& result,
+    const std::vector<size_t>& grouped) {
+  using acc_t = acc_type<scalar_t, /*is_cuda=*/true>;
+  using Problem = GroupedMMProblem<scalar_t>;
+
+  // Build the descriptor table in pinned memory so it can be copied
+  // asynchronously; the caching host allocator keeps the buffer alive until
+  // the copy has completed.
+  const int64_t table_bytes = grouped.size() * sizeof(Problem);
+  Tensor host_table = at::empty(
+      {table_bytes}, at::device(kCPU).dtype(kByte).pinned_memory(true));
+  auto* problems = reinterpret_cast<Problem*>(host_table.data_ptr());
+
+  int64_t total_tiles = 0;
+  for (size_t j = 0; j < grouped.size(); ++j) {
+    const size_t i = grouped[j];
+    const Tensor& a = self[i];
+    const Tensor& b = mat2[i];
+    Problem p;
+    p.a = a.data_ptr<scalar_t>();
+    p.b = b.data_ptr<scalar_t>();
+    p.c = result[i].data_ptr<scalar_t>();
+    p.m = a.size(0);
+    p.n = b.size(1);
+    p.k = a.size(1);
+    p.a_stride0 = a.stride(0);
+    p.a_stride1 = a.stride(1);
+    p.b_stride0 = b.stride(0);
+    p.b_stride1 = b.stride(1);
+    p.tile_start = total_tiles;
+    p.tiles_n = (p.n + BN - 1) / BN;
+    total_tiles += ((p.m + BM - 1) / BM) * p.tiles_n;
+    std::memcpy(&problems[j], &p, sizeof(Problem));
+  }
+  TORCH_CHECK(total_tiles <= std::numeric_limits<int32_t>::max(),
+              "_grouped_mm: too many output tiles (", total_tiles, ")");
+
+  Tensor device_table = host_table.to(self[0].device(), /*non_blocking=*/true);
+
+  const dim3 block(THREADS_X, THREADS_Y);
+  const dim3 grid(static_cast<uint32_t>(total_tiles));
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  grouped_mm_kernel<scalar_t, acc_t><<<grid, block, 0, stream>>>(
+      reinterpret_cast<const Problem*>(device_table.data_ptr()),
+      static_cast<int64_t>(grouped.size()));
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+} // anonymous namespace
+
+std::vector<Tensor> _grouped_mm_cuda(TensorList self, TensorList mat2) {
+  groupedMMCheckInputs(self, mat2);
+  std::vector<Tensor> result;
+  result.reserve(self.size());
+  if (self.empty()) {
+    return result;
+  }
+  c10::cuda::CUDAGuard device_guard(self[0].device());
+
+  // Pairs that go through the grouped kernel; the rest are empty or large
+  // enough for at::mm.
+  std::vector<size_t> grouped;
+  for (size_t i = 0; i < self.size(); ++i) {
+    const int64_t m = self[i].size(0);
+    const int64_t k = self[i].size(1);
+    const int64_t n = mat2[i].size(1);
+    if (m * n * k >= kMaxGroupedProblemSize) {
+      result.push_back(at::mm(self[i], mat2[i]));
+      continue;
+    }
+    result.push_back(at::empty({m, n}, self[i].options()));
+    if (m > 0 && n > 0) {
+      grouped.push_back(i);
+    }
+  }
+  if (grouped.empty()) {
+    return result;
+  }
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
+                                  self[0].scalar_type(), "_grouped_mm_cuda", [&] {
+    grouped_mm_launch<scalar_t>(self, mat2, result, grouped);
+  });
+  return result;
+}
+
+}} // namespace at::native
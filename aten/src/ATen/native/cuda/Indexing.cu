@@ -215,7 +215,13 @@ void index_put_accum_kernel(Tensor & self, TensorList indices, const Tensor & va
       // Sort; a stable sort is not required
       // NB - not passing comparator causes thrust to use radix sort, and it hurts perf A LOT, at least for medium (few K) sized indices
       auto sorted_data = device_ptr(sorted_indices.data_ptr<int64_t>());
-      thrust::sort_by_key(policy, sorted_data, sorted_data + num_indices, orig_data, ThrustLTOp<int64_t>());
+      if (globalContext().deterministic()) {
+        // Values with the same index are summed in the order of the sort, so
+        // keep them in their original order.
+        thrust::stable_sort_by_key(policy, sorted_data, sorted_data + num_indices, orig_data, ThrustLTOp<int64_t>());
+      } else {
+        thrust::sort_by_key(policy, sorted_data, sorted_data + num_indices, orig_data, ThrustLTOp<int64_t>());
+      }
       }
       TORCH_INTERNAL_ASSERT(linearIndex.numel()*sliceSize*nElemBefore == value.numel(), "number of flattened indices did not match number of elements in the value tensor", linearIndex.numel()*sliceSize*nElemBefore, value.numel());
       const int UNROLL = 4;
@@ -423,6 +429,44 @@ bool indexShouldBeMajor(cuda::detail::TensorInfo<scalar_t, unsigned int> &info,
   return false;
 }
 
+// index_add_ with atomic adds sums the values of duplicate indices in an
+// arbitrary order, and the atomics contend on the duplicates; half precision
+// atomics are also emulated with compare-and-swap before sm_70. The sort-based
+// reduction of index_put_ with accumulate=True instead adds the values of each
+// index in one thread, in a fixed order. It is used in deterministic mode, and
+// when there are enough indices that on average every index repeats
+// kIndexAddSortMinDuplication times.
+constexpr int64_t kIndexAddSortMinDuplication = 4;
+
+static bool index_add_use_sort(const Tensor & self, const Tensor & index, int64_t selfAddDimSize) {
+  if (self.scalar_type() == ScalarType::Bool) {
+    // not supported by index_add_
+    return false;
+  }
+  if (globalContext().deterministic()) {
+    return true;
+  }
+  return index.numel() > 16 &&
+         index.numel() >= kIndexAddSortMinDuplication * selfAddDimSize;
+}
+
+// Adds source to self as self.index_put_(indices, source, accumulate=True),
+// with the index at dim and full slices before it.
+static void index_add_sorted_cuda_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & source) {
+  std::vector<Tensor> indices(dim);
+  indices.emplace_back(index.reshape(-1));
+  auto value_sizes = self.sizes().vec();
+  value_sizes[dim] = index.numel();
+  // source may have a different shape with the same slice size, which is
+  // deprecated; its elements are read in the order of self's slices.
+  auto value = source.reshape(value_sizes);
+  Tensor self_c = self.contiguous();
+  index_put_accum_kernel(self_c, indices, value, /*unsafe=*/false);
+  if (!self_c.is_same(self)) {
+    self.copy_(self_c);
+  }
+}
+
 Tensor& index_add_cuda_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & source) {
   dim = maybe_wrap_dim(dim, self.dim());
 
@@ -459,6 +503,10 @@ Tensor& index_add_cuda_(Tensor & self, int64_t dim, const Tensor & index, const
   if (sliceSize == 0) {
     return self;
   }
+  if (index_add_use_sort(self, index, selfAddDimSize)) {
+    index_add_sorted_cuda_(self_, dim, index, source_);
+    return self;
+  }
   const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
   bool indContig = index.is_contiguous();
 
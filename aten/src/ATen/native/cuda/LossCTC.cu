@@ -13,6 +13,7 @@
 #include <c10/macros/Macros.h>
 
 #include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
 #include <ATen/Dispatch.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
 
@@ -186,6 +187,124 @@ ctc_loss_log_alpha_gpu_kernel(scalar_t* __restrict__ log_alpha_data,
   }
 }
 
+// The loss (eq (8)) from the row of log_alpha at t = input_length-1.
+template <typename accscalar_t>
+__device__ static inline accscalar_t ctc_loss_neg_log_likelihood(
+    const accscalar_t* la_row,
+    int64_t la_target_stride,
+    int64_t target_length) {
+  constexpr accscalar_t neginf = -INFINITY;
+  accscalar_t l1 = la_row[la_target_stride * (target_length*2)];
+  accscalar_t l2 = target_length > 0 ? la_row[la_target_stride * (target_length*2-1)] : neginf;
+  accscalar_t m = ((l1 > l2) ? l1 : l2);
+  m = ((m == neginf) ? 0 : m);
+  return -(std::log(std::exp(l1-m)+std::exp(l2-m))+m);
+}
+
+// The number of threads of a block of the shared memory kernels below, or 0 if the
+// augmented target (of length 2*max_target_length+1) does not fit in one block.
+// Those kernels run one block per batch item, with one thread per position s
+// of the augmented target, and keep the last row (in t) of log_alpha or
+// log_beta in shared memory for the whole loop over the input. So a single
+// launch covers all time steps and no time step re-reads the previous row from
+// global memory.
+template <typename accscalar_t>
+int ctc_loss_smem_threads(int64_t max_target_length) {
+  constexpr int max_threads = std::is_same<accscalar_t, float>::value ? 1024 : 896;
+  const int64_t target_prime_length = 2*max_target_length+1;
+  if (target_prime_length > max_threads) {
+    return 0;
+  }
+  // the backward kernel also writes rows of the gradient, of num_labels elements
+  return std::max<int>(
+      128, (target_prime_length + C10_WARP_SIZE - 1) / C10_WARP_SIZE * C10_WARP_SIZE);
+}
+
+// The alpha calculation of ctc_loss_log_alpha_gpu_kernel with the rows t-1 and t
+// of log_alpha for batch item blockIdx.x in shared memory, computed in accscalar_t
+// (so float for half inputs). The rows are still written out to log_alpha, as the
+// backward needs them.
+template<typename scalar_t, typename accscalar_t, typename target_t>
+__global__ void
+#if defined (__HIP_PLATFORM_HCC__)
+C10_LAUNCH_BOUNDS_2((std::is_same<accscalar_t, float>::value ? 1024 : 896), 1)
+#endif
+ctc_loss_log_alpha_smem_gpu_kernel(accscalar_t* __restrict__ log_alpha_data,
+                                   const scalar_t*log_probs_data, const int64_t* __restrict__ input_lengths, int64_t max_input_length,
+                                   const target_t* __restrict__ targets_data, const int64_t* __restrict__ target_lengths, int64_t max_target_length,
+                                   scalar_t* __restrict__ neg_log_likelihood_data,
+                                   int64_t lp_input_stride, int64_t lp_batch_stride, int64_t lp_char_stride,
+                                   int64_t la_batch_stride, int64_t la_input_stride, int64_t la_target_stride,
+                                   const int64_t* __restrict__ tg_batch_offsets, int64_t tg_target_stride,
+                                   int64_t BLANK) {
+  constexpr accscalar_t neginf = -INFINITY;
+  extern __shared__ unsigned char smem[];
+  accscalar_t* la_prev = reinterpret_cast<accscalar_t*>(smem);
+  accscalar_t* la_cur = la_prev + blockDim.x;
+
+  int64_t b = blockIdx.x;
+  int64_t s = threadIdx.x;
+  int64_t input_length = input_lengths[b];
+  int64_t target_length = target_lengths[b];
+  int64_t lp_batch_offset = b*lp_batch_stride;
+  int64_t la_batch_offset = b*la_batch_stride;
+  int64_t tg_batch_offset = tg_batch_offsets[b];
+  bool valid_s = s < 2*target_length+1;
+  bool write_s = s < 2*max_target_length+1;
+
+  int64_t current_char = BLANK; // l_s in eq (6)
+  bool have_three = false;      // flag which of the two cases in eq (6) we have
+  if (valid_s && target_length > 0) {
+    current_char = get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s, BLANK);
+    have_three = (s > 1) &&
+        (get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s - 2, BLANK) != current_char);
+  }
+
+  // first row (t=0), the three equations for alpha_1 above eq (6)
+  accscalar_t la = neginf;
+  if (s == 0 || (s == 1 && target_length > 0)) {
+    la = log_probs_data[lp_batch_offset + lp_char_stride * current_char];
+  }
+  la_prev[s] = la;
+  if (write_s) {
+    log_alpha_data[la_batch_offset + la_target_stride * s] = la;
+  }
+
+  for (int64_t t=1; t < input_length; t++) {
+    __syncthreads();
+    la = neginf;
+    if (valid_s) {
+      // equation (6) and (7), with lamax for the logsumexp trick
+      accscalar_t la1 = la_prev[s];
+      accscalar_t la2 = s > 0 ? la_prev[s-1] : neginf;
+      accscalar_t la3 = have_three ? la_prev[s-2] : neginf;
+      accscalar_t lamax = ::max(la1, ::max(la2, la3));
+      if (lamax == neginf) // when all are neginf. (then the whole thing is neginf, but we can pretend)
+        lamax = 0;
+      la = std::log(std::exp(la1-lamax)+std::exp(la2-lamax)+std::exp(la3-lamax))+lamax
+        + static_cast<accscalar_t>(log_probs_data[lp_batch_offset + t * lp_input_stride + lp_char_stride * current_char]);
+    }
+    la_cur[s] = la;
+    if (write_s) {
+      log_alpha_data[la_batch_offset + la_input_stride * t + la_target_stride * s] = la;
+    }
+    accscalar_t* tmp = la_prev;
+    la_prev = la_cur;
+    la_cur = tmp;
+  }
+  if (write_s) {
+    for (int64_t t = std::max<int64_t>(input_length, 1); t < max_input_length; t++) {
+      log_alpha_data[la_batch_offset + la_input_stride * t + la_target_stride * s] = neginf;
+    }
+  }
+  __syncthreads();
+
+  // compute the loss (eq (8)) from the last row, which is in la_prev
+  if (threadIdx.x == 0) {
+    neg_log_likelihood_data[b] = ctc_loss_neg_log_likelihood<accscalar_t>(la_prev, 1, target_length);
+  }
+}
+
 // The forward computation. Lot's of admin and a call to the alpha kernel.
 // Note: we do not check that the labels are in the valid range. As we use
 // them for indexing in the kernels, you'll see memory errors when you
@@ -258,11 +377,36 @@ std::tuple<Tensor, Tensor> ctc_loss_gpu_template(const Tensor& log_probs, const
   auto input_lengths_t = at::tensor(input_lengths, targets.options().dtype(kLong));
   tg_batch_offsets = tg_batch_offsets.cuda();
 
-  Tensor log_alpha = at::empty({batch_size, log_probs.size(0), 2*max_target_length+1}, log_probs.options());
+  // log_alpha is always in the accumulate type, so it is float for half inputs.
+  using accscalar_t = acc_type<scalar_t, true>;
+  const ScalarType acc_scalar_type = std::is_same<accscalar_t, double>::value ? kDouble : kFloat;
+  Tensor log_alpha = at::empty({batch_size, log_probs.size(0), 2*max_target_length+1}, log_probs.options().dtype(acc_scalar_type));
   Tensor neg_log_likelihood = at::empty({batch_size}, log_probs.options());
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+
+  int smem_threads = ctc_loss_smem_threads<accscalar_t>(max_target_length);
+  if (smem_threads > 0) {
+    ctc_loss_log_alpha_smem_gpu_kernel<scalar_t, accscalar_t, target_t>
+      <<<batch_size, smem_threads, 2 * smem_threads * sizeof(accscalar_t), stream>>>(
+        log_alpha.data_ptr<accscalar_t>(),
+        log_probs.data_ptr<scalar_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
+        targets.data_ptr<target_t>(), target_lengths_t.data_ptr<int64_t>(), max_target_length,
+        neg_log_likelihood.data_ptr<scalar_t>(),
+        log_probs.stride(0), log_probs.stride(1), log_probs.stride(2),
+        log_alpha.stride(0), log_alpha.stride(1), log_alpha.stride(2),
+        tg_batch_offsets.data_ptr<int64_t>(), tg_target_stride,
+        BLANK);
+    AT_CUDA_CHECK(cudaGetLastError()); // catch launch errors
+    return std::make_tuple(neg_log_likelihood, log_alpha);
+  }
+
+  // For long targets, we tile the target over several blocks. These kernels
+  // compute in accscalar_t, so half inputs are converted to float first.
+  Tensor log_probs_acc = log_probs.to(acc_scalar_type);
+  Tensor neg_log_likelihood_acc = neg_log_likelihood.to(acc_scalar_type);
 
   // Very likely, we could be more clever here, e.g. learning (or genralizing and reusing) from SoftMax.cu...
-  constexpr int max_threads = std::is_same<scalar_t, float>::value ? 1024 : 896; // we need 72 or so 32 bit registers for double
+  constexpr int max_threads = std::is_same<accscalar_t, float>::value ? 1024 : 896; // we need 72 or so 32 bit registers for double
   int threads_target = max_threads;
   while (threads_target / 2 >= 2*max_target_length+1) {
     threads_target /= 2;
@@ -270,19 +414,18 @@ std::tuple<Tensor, Tensor> ctc_loss_gpu_template(const Tensor& log_probs, const
   int threads_batch = std::min(max_threads / threads_target, (int) batch_size);
   dim3 block(threads_target, threads_batch);
   dim3 grid((2*max_target_length+1 + threads_target-1)/threads_target, (batch_size+threads_batch-1)/threads_batch);
-  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
 
-  ctc_loss_log_alpha_gpu_kernel<scalar_t, target_t><<<grid, block, 0, stream>>>(
-                      log_alpha.data_ptr<scalar_t>(),
-                      log_probs.data_ptr<scalar_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
+  ctc_loss_log_alpha_gpu_kernel<accscalar_t, target_t><<<grid, block, 0, stream>>>(
+                      log_alpha.data_ptr<accscalar_t>(),
+                      log_probs_acc.data_ptr<accscalar_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
                       targets.data_ptr<target_t>(), target_lengths_t.data_ptr<int64_t>(), max_target_length,
-                      neg_log_likelihood.data_ptr<scalar_t>(),
-                      log_probs.stride(0), log_probs.stride(1), log_probs.stride(2),
+                      neg_log_likelihood_acc.data_ptr<accscalar_t>(),
+                      log_probs_acc.stride(0), log_probs_acc.stride(1), log_probs_acc.stride(2),
                       log_alpha.stride(0), log_alpha.stride(1), log_alpha.stride(2),
                       tg_batch_offsets.data_ptr<int64_t>(), tg_target_stride,
                       batch_size, BLANK);
   AT_CUDA_CHECK(cudaGetLastError()); // catch launch errors
-  return std::make_tuple(neg_log_likelihood, log_alpha);
+  return std::make_tuple(neg_log_likelihood_acc.to(log_probs.scalar_type()), log_alpha);
 }
 
 // The second (backward) half of the forward backward algorithm, (10) and (11). This is parallel to the
@@ -567,12 +710,132 @@ ctc_loss_zero_padded_gradients(
   }
 
 
+// Recomputes the loss from log_alpha, for the kernels for long targets with half
+// inputs, whose loss is rounded to half by the forward.
+template<typename accscalar_t>
+__global__ void ctc_loss_neg_log_likelihood_gpu_kernel(accscalar_t* __restrict__ neg_log_likelihood_data,
+                                                       const accscalar_t* __restrict__ log_alpha_data,
+                                                       const int64_t* __restrict__ input_lengths,
+                                                       const int64_t* __restrict__ target_lengths,
+                                                       int64_t la_batch_stride, int64_t la_input_stride, int64_t la_target_stride,
+                                                       int64_t batch_size) {
+  int64_t b = threadIdx.x + blockIdx.x * blockDim.x;
+  if (b >= batch_size)
+    return;
+  neg_log_likelihood_data[b] = ctc_loss_neg_log_likelihood<accscalar_t>(
+      log_alpha_data + b * la_batch_stride + la_input_stride * std::max<int64_t>(input_lengths[b] - 1, 0),
+      la_target_stride, target_lengths[b]);
+}
+
+// The beta calculation of ctc_loss_backward_log_beta_gpu_kernel fused with the
+// gradient, eq (16), for the shared memory layout of
+// ctc_loss_log_alpha_smem_gpu_kernel: once row t of log_beta of batch item
+// blockIdx.x is in shared memory, the block writes the minuend of row t of the
+// gradient, exp(log_probs) * grad_out, and subtracts the term of every position s
+// with an atomicAdd to the label of s, in linear space as in
+// ctc_loss_backward_collect_nonblank_gpu_kernel. So log_beta never goes to
+// global memory. This also zeroes the rows at t >= input_length.
+// The loss is recomputed from log_alpha, as for half inputs the one returned by
+// the forward is rounded to half.
+template<typename scalar_t, typename accscalar_t, typename target_t>
+__global__ void
+#if defined (__HIP_PLATFORM_HCC__)
+C10_LAUNCH_BOUNDS_2((std::is_same<accscalar_t, float>::value ? 1024 : 896), 1)
+#endif
+ctc_loss_backward_fused_smem_gpu_kernel(accscalar_t* __restrict__ gradient_data,
+                                        const scalar_t* __restrict__ grad_out_data, int64_t grad_out_batch_stride,
+                                        const accscalar_t* __restrict__ log_alpha_data,
+                                        const scalar_t*log_probs_data, const int64_t* __restrict__ input_lengths, int64_t max_input_length,
+                                        const target_t* __restrict__ targets_data, const int64_t* __restrict__ target_lengths,
+                                        int64_t gr_input_stride, int64_t gr_batch_stride, int64_t gr_char_stride,
+                                        int64_t lp_input_stride, int64_t lp_batch_stride, int64_t lp_char_stride,
+                                        int64_t la_batch_stride, int64_t la_input_stride, int64_t la_target_stride,
+                                        const int64_t* __restrict__ tg_batch_offsets, int64_t tg_target_stride,
+                                        int64_t num_labels, int64_t BLANK, bool zero_infinity) {
+  constexpr accscalar_t neginf = -INFINITY;
+  extern __shared__ unsigned char smem[];
+  accscalar_t* lb_next = reinterpret_cast<accscalar_t*>(smem);
+  accscalar_t* lb_cur = lb_next + blockDim.x;
+
+  int64_t b = blockIdx.x;
+  int64_t s = threadIdx.x;
+  int64_t input_length = input_lengths[b];
+  int64_t target_length = target_lengths[b];
+  int64_t gr_batch_offset = b*gr_batch_stride;
+  int64_t lp_batch_offset = b*lp_batch_stride;
+  int64_t la_batch_offset = b*la_batch_stride;
+  int64_t tg_batch_offset = tg_batch_offsets[b];
+  // the loss of the forward, but without its rounding to scalar_t
+  accscalar_t nll = ctc_loss_neg_log_likelihood<accscalar_t>(
+      log_alpha_data + la_batch_offset + la_input_stride * std::max<int64_t>(input_length - 1, 0),
+      la_target_stride, target_length);
+  accscalar_t gr = grad_out_data[b * grad_out_batch_stride];
+
+  // the padding, and everything if the loss is zeroed
+  bool zero = zero_infinity && nll == INFINITY;
+  for (int64_t t = zero ? 0 : input_length; t < max_input_length; t++) {
+    for (int64_t c = threadIdx.x; c < num_labels; c += blockDim.x) {
+      gradient_data[gr_batch_offset + t * gr_input_stride + gr_char_stride * c] = 0;
+    }
+  }
+  if (zero) {
+    return;
+  }
+
+  bool valid_s = s < 2*target_length+1;
+  int64_t current_target_prime = BLANK;
+  bool have_three = false;
+  if (valid_s && target_length > 0) {
+    current_target_prime = get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s, BLANK);
+    have_three = (s < 2 * target_length - 1) &&
+        (get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s + 2, BLANK) != current_target_prime);
+  }
+
+  for (int64_t t = input_length - 1; t >= 0; t--) {
+    const scalar_t* lp_row = log_probs_data + lp_batch_offset + t * lp_input_stride;
+    accscalar_t lb = neginf;
+    if (t == input_length - 1) {
+      // the beta initialization before eq (10)
+      if (s == 2*target_length || s == 2*target_length - 1) {
+        lb = lp_row[lp_char_stride * current_target_prime];
+      }
+    } else if (valid_s) {
+      accscalar_t lb1 = lb_next[s];
+      accscalar_t lb2 = s < 2*target_length ? lb_next[s+1] : neginf;
+      accscalar_t lb3 = have_three ? lb_next[s+2] : neginf;
+      accscalar_t lbmax = ::max(lb1, ::max(lb2, lb3));
+      if (lbmax == neginf)
+        lbmax = 0;
+      lb = std::log(std::exp(lb1-lbmax)+std::exp(lb2-lbmax)+std::exp(lb3-lbmax))+lbmax
+        + static_cast<accscalar_t>(lp_row[lp_char_stride * current_target_prime]);
+    }
+    lb_cur[s] = lb;
+
+    accscalar_t* gr_row = gradient_data + gr_batch_offset + t * gr_input_stride;
+    for (int64_t c = threadIdx.x; c < num_labels; c += blockDim.x) {
+      gr_row[gr_char_stride * c] = std::exp(static_cast<accscalar_t>(lp_row[lp_char_stride * c])) * gr;
+    }
+    // makes the minuends visible to the atomics, and lb_next free for t-1
+    __syncthreads();
+
+    if (valid_s) {
+      accscalar_t lp = lp_row[lp_char_stride * current_target_prime];
+      accscalar_t la = log_alpha_data[la_batch_offset + la_input_stride * t + la_target_stride * s];
+      gpuAtomicAdd(&gr_row[gr_char_stride * current_target_prime], -std::exp(la + lb + nll - lp) * gr);
+    }
+    accscalar_t* tmp = lb_next;
+    lb_next = lb_cur;
+    lb_cur = tmp;
+  }
+}
+
 // The backward. It essentially computes eq 16 by using the above kernels.
 // We don't do a lot of checking as we envision this to be called only when backpropagating through a (well-checked) forward.
 template<typename scalar_t, ScalarType target_scalar_type>
 Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths,
                                       const Tensor& neg_log_likelihood, const Tensor& log_alpha, int64_t BLANK, bool zero_infinity) {
-  constexpr scalar_t neginf = -INFINITY;
+  using accscalar_t = acc_type<scalar_t, true>;
+  constexpr accscalar_t neginf = -INFINITY;
   using target_t = typename std::conditional<target_scalar_type == kInt, int, int64_t>::type;
   int64_t batch_size = log_probs.size(1);
   int64_t num_labels = log_probs.size(2);
@@ -607,29 +870,64 @@ Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_
   auto input_lengths_t = at::tensor(input_lengths, targets.options().dtype(kLong));
   tg_batch_offsets = tg_batch_offsets.cuda();
 
+  const ScalarType acc_scalar_type = std::is_same<accscalar_t, double>::value ? kDouble : kFloat;
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+
+  int smem_threads = ctc_loss_smem_threads<accscalar_t>(max_target_length);
+  if (smem_threads > 0) {
+    // (input_length, batch_size, num_labels) like log_probs
+    Tensor grad = at::empty(log_probs.sizes(), log_probs.options().dtype(acc_scalar_type));
+    ctc_loss_backward_fused_smem_gpu_kernel<scalar_t, accscalar_t, target_t>
+      <<<batch_size, smem_threads, 2 * smem_threads * sizeof(accscalar_t), stream>>>(
+        grad.data_ptr<accscalar_t>(),
+        grad_out.data_ptr<scalar_t>(), grad_out.stride(0),
+        log_alpha.data_ptr<accscalar_t>(),
+        log_probs.data_ptr<scalar_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
+        targets.data_ptr<target_t>(), target_lengths_t.data_ptr<int64_t>(),
+        grad.stride(0), grad.stride(1), grad.stride(2),
+        log_probs.stride(0), log_probs.stride(1), log_probs.stride(2),
+        log_alpha.stride(0), log_alpha.stride(1), log_alpha.stride(2),
+        tg_batch_offsets.data_ptr<int64_t>(), tg_target_stride,
+        num_labels, BLANK, zero_infinity);
+    AT_CUDA_CHECK(cudaGetLastError()); // catch launch errors
+    return grad.to(log_probs.scalar_type());
+  }
+
+  // As in the forward, the kernels for long targets compute in accscalar_t.
+  Tensor log_probs_acc = log_probs.to(acc_scalar_type);
+  Tensor grad_out_acc = grad_out.to(acc_scalar_type);
+  Tensor neg_log_likelihood_acc = neg_log_likelihood.to(acc_scalar_type);
+  if (!std::is_same<scalar_t, accscalar_t>::value) {
+    constexpr int threads = 128;
+    ctc_loss_neg_log_likelihood_gpu_kernel<accscalar_t>
+      <<<(batch_size + threads - 1) / threads, threads, 0, stream>>>(
+        neg_log_likelihood_acc.data_ptr<accscalar_t>(), log_alpha.data_ptr<accscalar_t>(),
+        input_lengths_t.data_ptr<int64_t>(), target_lengths_t.data_ptr<int64_t>(),
+        log_alpha.stride(0), log_alpha.stride(1), log_alpha.stride(2), batch_size);
+    AT_CUDA_CHECK(cudaGetLastError()); // catch launch errors
+  }
+
   Tensor log_beta = at::empty_like(log_alpha, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   log_beta.fill_(neginf);
 
-  Tensor grad = at::full_like(log_probs, neginf, LEGACY_CONTIGUOUS_MEMORY_FORMAT); // initialization for log(sum (alpha beta))
+  Tensor grad = at::full_like(log_probs_acc, neginf, LEGACY_CONTIGUOUS_MEMORY_FORMAT); // initialization for log(sum (alpha beta))
 
   // As above, there may be better configurations to use.
-  constexpr int max_threads = std::is_same<scalar_t, float>::value ? 1024 : 896; // we need 72 or so 32 bit registers for double
+  constexpr int max_threads = std::is_same<accscalar_t, float>::value ? 1024 : 896; // we need 72 or so 32 bit registers for double
   int threads_target = max_threads;
   while (threads_target / 2 >= 2*max_target_length+1) {
     threads_target /= 2;
   }
   int threads_batch = std::min(max_threads / threads_target, (int) batch_size);
 
-  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
-
   {
     dim3 block(threads_target, threads_batch);
     dim3 grid((2*max_target_length+1 + threads_target-1)/threads_target, (batch_size+threads_batch-1)/threads_batch);
-    ctc_loss_backward_log_beta_gpu_kernel<scalar_t, target_t><<<grid, block, 0, stream>>>
-      (log_beta.data_ptr<scalar_t>(),
-       log_probs.data_ptr<scalar_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
+    ctc_loss_backward_log_beta_gpu_kernel<accscalar_t, target_t><<<grid, block, 0, stream>>>
+      (log_beta.data_ptr<accscalar_t>(),
+       log_probs_acc.data_ptr<accscalar_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
        targets.data_ptr<target_t>(), target_lengths_t.data_ptr<int64_t>(), max_target_length,
-       log_probs.stride(0), log_probs.stride(1), log_probs.stride(2),
+       log_probs_acc.stride(0), log_probs_acc.stride(1), log_probs_acc.stride(2),
        log_beta.stride(0), log_beta.stride(1), log_beta.stride(2),
        tg_batch_offsets.data_ptr<int64_t>(), tg_target_stride,
        batch_size, BLANK);
@@ -643,7 +941,7 @@ Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_
   bool is_large = (2*log_probs.size(0)+(24*batch_size)/10+(2*num_labels)/10) > 450;
   if (is_large) { // large alphabet, large batch
     // this computes the probs, minuend in (16)
-    at::exp_out(grad, log_probs);
+    at::exp_out(grad, log_probs_acc);
     // now we compute the subtrahend for the blanks. It is a straightforward reduction because we know that
     // blanks are in every other position.
     // maybe we should kernelize this, too.
@@ -654,12 +952,12 @@ Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_
                                                        {log_beta.stride(0), log_beta.stride(1), log_beta.stride(2)*2}),
                                  2, true)
                    .permute({1, 0, 2})
-                   .add_(neg_log_likelihood.view({1, batch_size, 1}))
-                   .sub_(log_probs.narrow(2, BLANK, 1))
+                   .add_(neg_log_likelihood_acc.view({1, batch_size, 1}))
+                   .sub_(log_probs_acc.narrow(2, BLANK, 1))
                    .exp_()
                    );
     // scale by output gradient (blanks and first summand of non-blanks)
-    grad *= grad_out.view({1, batch_size, 1});
+    grad *= grad_out_acc.view({1, batch_size, 1});
     if (zero_infinity) {
       grad = at::where(neg_log_likelihood.view({1, batch_size, 1}) == Scalar(INFINITY), at::zeros({}, grad.options()), grad);
     }
@@ -677,15 +975,15 @@ Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_
             (max_target_length + threads_target - 1) / threads_target, 1),
         (batch_size + threads_batch - 1) / threads_batch,
         1);
-    ctc_loss_backward_collect_nonblank_gpu_kernel<scalar_t, target_t><<<grid, block, 0, stream>>>
-      (grad.data_ptr<scalar_t>(),
-       grad_out.data_ptr<scalar_t>(), grad_out.stride(0),
-       log_alpha.data_ptr<scalar_t>(), log_beta.data_ptr<scalar_t>(),
-       log_probs.data_ptr<scalar_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
+    ctc_loss_backward_collect_nonblank_gpu_kernel<accscalar_t, target_t><<<grid, block, 0, stream>>>
+      (grad.data_ptr<accscalar_t>(),
+       grad_out_acc.data_ptr<accscalar_t>(), grad_out_acc.stride(0),
+       log_alpha.data_ptr<accscalar_t>(), log_beta.data_ptr<accscalar_t>(),
+       log_probs_acc.data_ptr<accscalar_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
        targets.data_ptr<target_t>(), target_lengths_t.data_ptr<int64_t>(), max_target_length,
-       neg_log_likelihood.data_ptr<scalar_t>(),
+       neg_log_likelihood_acc.data_ptr<accscalar_t>(),
        grad.stride(0), grad.stride(1), grad.stride(2),
-       log_probs.stride(0), log_probs.stride(1), log_probs.stride(2),
+       log_probs_acc.stride(0), log_probs_acc.stride(1), log_probs_acc.stride(2),
        log_alpha.stride(0), log_alpha.stride(1), log_alpha.stride(2),
        log_beta.stride(0), log_beta.stride(1), log_beta.stride(2),
        tg_batch_offsets.data_ptr<int64_t>(), tg_target_stride,
@@ -700,15 +998,15 @@ Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_
     threads_batch = std::min(max_threads / threads_input, (int) batch_size);
     dim3 block(threads_input, threads_batch);
     dim3 grid((log_probs.size(0) + threads_input-1)/threads_input, (batch_size+threads_batch-1)/threads_batch);
-    ctc_loss_backward_collect_gpu_kernel<scalar_t, target_t><<<grid, block, 0, stream>>>
-      (grad.data_ptr<scalar_t>(),
-       grad_out.data_ptr<scalar_t>(), grad_out.stride(0),
-       log_alpha.data_ptr<scalar_t>(), log_beta.data_ptr<scalar_t>(),
-       log_probs.data_ptr<scalar_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
+    ctc_loss_backward_collect_gpu_kernel<accscalar_t, target_t><<<grid, block, 0, stream>>>
+      (grad.data_ptr<accscalar_t>(),
+       grad_out_acc.data_ptr<accscalar_t>(), grad_out_acc.stride(0),
+       log_alpha.data_ptr<accscalar_t>(), log_beta.data_ptr<accscalar_t>(),
+       log_probs_acc.data_ptr<accscalar_t>(), input_lengths_t.data_ptr<int64_t>(), log_probs.size(0),
        targets.data_ptr<target_t>(), target_lengths_t.data_ptr<int64_t>(), max_target_length,
-       neg_log_likelihood.data_ptr<scalar_t>(),
+       neg_log_likelihood_acc.data_ptr<accscalar_t>(),
        grad.stride(0), grad.stride(1), grad.stride(2),
-       log_probs.stride(0), log_probs.stride(1), log_probs.stride(2),
+       log_probs_acc.stride(0), log_probs_acc.stride(1), log_probs_acc.stride(2),
        log_alpha.stride(0), log_alpha.stride(1), log_alpha.stride(2),
        log_beta.stride(0), log_beta.stride(1), log_beta.stride(2),
        tg_batch_offsets.data_ptr<int64_t>(), tg_target_stride,
@@ -727,8 +1025,8 @@ Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_
     dim3 grid(
       (log_probs.size(0) + threads_input-1)/threads_input,
       (batch_size+threads_batch-1)/threads_batch);
-    ctc_loss_zero_padded_gradients<scalar_t><<<grid, block, 0, stream>>>(
-      grad.data_ptr<scalar_t>(),
+    ctc_loss_zero_padded_gradients<accscalar_t><<<grid, block, 0, stream>>>(
+      grad.data_ptr<accscalar_t>(),
       input_lengths_t.data_ptr<int64_t>(),
       grad.stride(0),
       grad.stride(1),
@@ -740,14 +1038,14 @@ Tensor ctc_loss_backward_gpu_template(const Tensor& grad_out, const Tensor& log_
     AT_CUDA_CHECK(cudaGetLastError());
   }
 
-  return grad;
+  return grad.to(log_probs.scalar_type());
 }
 
 } // namespace
 
 std::tuple<Tensor, Tensor> ctc_loss_gpu(const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths, int64_t BLANK, bool zero_infinity) {
   (void)zero_infinity; // only used for backward
-  return AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_cuda", [&] {
+  return AT_DISPATCH_FLOATING_TYPES_AND_HALF(log_probs.scalar_type(), "ctc_loss_cuda", [&] {
       if (targets.scalar_type() == kLong) {
         return ctc_loss_gpu_template<scalar_t, kLong>(log_probs, targets, input_lengths, target_lengths, BLANK);
       } else {
@@ -758,7 +1056,7 @@ std::tuple<Tensor, Tensor> ctc_loss_gpu(const Tensor& log_probs, const Tensor& t
 
 Tensor ctc_loss_backward_gpu(const Tensor& grad, const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths,
                              const Tensor& neg_log_likelihood, const Tensor& log_alpha, int64_t BLANK, bool zero_infinity) {
-  return AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_backward_cuda", [&] {
+  return AT_DISPATCH_FLOATING_TYPES_AND_HALF(log_probs.scalar_type(), "ctc_loss_backward_cuda", [&] {
       if (targets.scalar_type() == kLong) {
         return ctc_loss_backward_gpu_template<scalar_t, kLong>(grad, log_probs, targets, input_lengths, target_lengths, neg_log_likelihood, log_alpha, BLANK, zero_infinity);
       } else {
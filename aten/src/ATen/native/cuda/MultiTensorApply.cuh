@@ -0,0 +1,173 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+#include <c10/macros/Macros.h>
+
+#include <vector>
+
+// Multi-tensor apply: runs a device functor over the elements of several lists
+// of tensors with as few kernel launches as possible.
+//
+// Element-wise work over many small tensors, like an optimizer step over all
+// parameters of a model, is dominated by launch overhead when done with one
+// kernel per tensor. Instead, every tensor is cut into chunks of kChunkSize
+// elements and each block of a launch processes one chunk of one tensor. The
+// addresses and sizes of the tensors, and which block handles which chunk, are
+// passed to the kernel by value in a TensorListMetadata struct, so a launch
+// needs no host to device copy. A new launch is only needed once the struct
+// is full.
+//
+// tensor_lists[d][t] is the d-th operand of the t-th tensor, e.g., for Adam,
+// tensor_lists[0] holds the parameters, tensor_lists[1] their gradients, etc.
+// The operands of a tensor are indexed by the same flat offsets, so they must
+// all have the same number of elements and be contiguous; the entry points
+// check that with check_multi_tensor_apply_inputs.
+
+namespace at { namespace native {
+
+namespace multi_tensor_apply_detail {
+
+constexpr int64_t kChunkSize = 65536;
+constexpr int kBlockSize = 512;
+
+// Kernel parameters are limited to 4 KB, which bounds the number of tensors
+// and blocks a single launch can describe for each depth.
+constexpr int depth_to_max_tensors[5] = {110, 64, 48, 36, 30};
+constexpr int depth_to_max_blocks[5] = {320, 320, 320, 320, 320};
+
+template <int n> struct TensorListMetadata {
+  void* addresses[n][depth_to_max_tensors[n - 1]];
+  int64_t numel_for_tensor[depth_to_max_tensors[n - 1]];
+  // Position of the tensor in tensor_lists, for functors writing per-tensor
+  // results.
+  int tensor_index[depth_to_max_tensors[n - 1]];
+  unsigned char block_to_tensor[depth_to_max_blocks[n - 1]];
+  int block_to_chunk[depth_to_max_blocks[n - 1]];
+};
+
+// Position of the chunk this block works on: the tensor slot in the metadata,
+// the offset of the chunk and the number of elements in it.
+template <int depth>
+struct ChunkInfo {
+  int tensor_loc;
+  int64_t offset;
+  int64_t n;
+
+  __device__ ChunkInfo(int64_t chunk_size, const TensorListMetadata<depth>& tl) {
+    tensor_loc = tl.block_to_tensor[blockIdx.x];
+    offset = tl.block_to_chunk[blockIdx.x] * chunk_size;
+    const int64_t remaining = tl.numel_for_tensor[tensor_loc] - offset;
+    n = remaining < chunk_size ? remaining : chunk_size;
+  }
+
+  template <typename scalar_t>
+  __device__ scalar_t* ptr(const TensorListMetadata<depth>& tl, int d) const {
+    return static_cast<scalar_t*>(tl.addresses[d][tensor_loc]) + offset;
+  }
+};
+
+template <typename T, typename U, typename... ArgTypes>
+C10_LAUNCH_BOUNDS_1(kBlockSize)
+__global__ void multi_tensor_apply_kernel(T tensor_list_meta, U callable, ArgTypes... args) {
+  callable(kChunkSize, tensor_list_meta, args...);
+}
+
+} // namespace multi_tensor_apply_detail
+
+// Checks that tensor_lists holds depth lists of contiguous CUDA tensors of the
+// same dtype, and that the operands of each tensor have the same size.
+static inline void check_multi_tensor_apply_inputs(
+    const char* name, const std::vector<std::vector<Tensor>>& tensor_lists) {
+  TORCH_CHECK(!tensor_lists.empty() && !tensor_lists[0].empty(),
+              name, ": expected a non-empty list of tensors");
+  const auto& first = tensor_lists[0][0];
+  for (size_t d = 0; d < tensor_lists.size(); d++) {
+    TORCH_CHECK(tensor_lists[d].size() == tensor_lists[0].size(),
+                name, ": expected all tensor lists to have ", tensor_lists[0].size(),
+                " tensors, but list ", d, " has ", tensor_lists[d].size());
+    for (size_t t = 0; t < tensor_lists[d].size(); t++) {
+      const auto& tensor = tensor_lists[d][t];
+      TORCH_CHECK(tensor.is_cuda() && tensor.device() == first.device(),
+                  name, ": expected all tensors on ", first.device(),
+                  ", but got a tensor on ", tensor.device());
+      TORCH_CHECK(tensor.scalar_type() == first.scalar_type(),
+                  name, ": expected all tensors of type ", first.scalar_type(),
+                  ", but got a tensor of type ", tensor.scalar_type());
+      TORCH_CHECK(tensor.layout() == at::kStrided && tensor.is_contiguous(),
+                  name, ": expected dense contiguous tensors");
+      TORCH_CHECK(tensor.numel() == tensor_lists[0][t].numel(),
+                  name, ": expected tensor ", t, " of every list to have ",
+                  tensor_lists[0][t].numel(), " elements, but the one in list ", d,
+                  " has ", tensor.numel());
+    }
+  }
+}
+
+template <int depth, typename T, typename... ArgTypes>
+void multi_tensor_apply(
+    const std::vector<std::vector<Tensor>>& tensor_lists,
+    T callable,
+    ArgTypes... args) {
+  using namespace multi_tensor_apply_detail;
+  TORCH_INTERNAL_ASSERT(tensor_lists.size() == depth);
+  constexpr int max_tensors = depth_to_max_tensors[depth - 1];
+  constexpr int max_blocks = depth_to_max_blocks[depth - 1];
+
+  const auto n_tensors = tensor_lists[0].size();
+  const auto stream = at::cuda::getCurrentCUDAStream();
+  TensorListMetadata<depth> tensor_list_meta;
+  int loc_block_info = 0;
+  int loc_tensor_info = 0;
+
+  auto launch = [&]() {
+    multi_tensor_apply_kernel<<<loc_block_info, kBlockSize, 0, stream>>>(
+        tensor_list_meta, callable, args...);
+    AT_CUDA_CHECK(cudaGetLastError());
+    loc_block_info = 0;
+  };
+
+  for (size_t t = 0; t < n_tensors; t++) {
+    const int64_t numel = tensor_lists[0][t].numel();
+    if (numel == 0) {
+      continue;
+    }
+    tensor_list_meta.numel_for_tensor[loc_tensor_info] = numel;
+    tensor_list_meta.tensor_index[loc_tensor_info] = static_cast<int>(t);
+    for (int d = 0; d < depth; d++) {
+      tensor_list_meta.addresses[d][loc_tensor_info] = tensor_lists[d][t].data_ptr();
+    }
+    loc_tensor_info++;
+
+    const int64_t chunks = (numel + kChunkSize - 1) / kChunkSize;
+    for (int64_t chunk = 0; chunk < chunks; chunk++) {
+      tensor_list_meta.block_to_tensor[loc_block_info] = loc_tensor_info - 1;
+      tensor_list_meta.block_to_chunk[loc_block_info] = static_cast<int>(chunk);
+      loc_block_info++;
+
+      const bool tensors_full = loc_tensor_info == max_tensors && chunk == chunks - 1;
+      const bool blocks_full = loc_block_info == max_blocks;
+      if (tensors_full || blocks_full) {
+        launch();
+        if (chunk == chunks - 1) {
+          loc_tensor_info = 0;
+        } else {
+          // The rest of this tensor's chunks go to the next launch, where
+          // the tensor takes the first slot.
+          tensor_list_meta.numel_for_tensor[0] = tensor_list_meta.numel_for_tensor[loc_tensor_info - 1];
+          tensor_list_meta.tensor_index[0] = tensor_list_meta.tensor_index[loc_tensor_info - 1];
+          for (int d = 0; d < depth; d++) {
+            tensor_list_meta.addresses[d][0] = tensor_list_meta.addresses[d][loc_tensor_info - 1];
+          }
+          loc_tensor_info = 1;
+        }
+      }
+    }
+  }
+  if (loc_block_info > 0) {
+    launch();
+  }
+}
+
+}} // namespace at::native
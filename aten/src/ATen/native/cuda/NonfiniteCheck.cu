@@ -0,0 +1,91 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <map>
+#include <vector>
+
+// Checks a list of tensors for nan and infinity values with one multi-tensor
+// apply pass (see MultiTensorApply.cuh) per dtype, and keeps the result on
+// the device so that the caller never synchronizes. Used by the nonfinite
+// guard of the autograd engine on the outputs of every node.
+
+namespace {
+// See isfinite_ensure_cuda_math in AmpKernels.cu for why this is outside of
+// at::native.
+template <typename T>
+static __device__ __forceinline__ bool isfinite_value(T val) {
+  return isfinite(val);
+}
+}
+
+namespace at { namespace native {
+
+namespace {
+
+using multi_tensor_apply_detail::TensorListMetadata;
+
+template <typename scalar_t>
+struct RecordNonfiniteFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  __device__ __forceinline__ void operator()(
+      int64_t chunk_size, TensorListMetadata<1>& tl,
+      unsigned long long* found, unsigned long long value) {
+    const int tensor_loc = tl.block_to_tensor[blockIdx.x];
+    const int64_t offset = tl.block_to_chunk[blockIdx.x] * chunk_size;
+    const int64_t remaining = tl.numel_for_tensor[tensor_loc] - offset;
+    const int64_t n = remaining < chunk_size ? remaining : chunk_size;
+    const auto* data = static_cast<const scalar_t*>(tl.addresses[0][tensor_loc]) + offset;
+
+    int nonfinite = 0;
+    for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+      nonfinite |= !isfinite_value(static_cast<opmath_t>(data[i]));
+    }
+    if (__syncthreads_or(nonfinite) && threadIdx.x == 0) {
+      atomicMax(found, value);
+    }
+  }
+};
+
+} // anonymous namespace
+
+void _record_nonfinite_cuda_(Tensor& found, TensorList tensors, int64_t value) {
+  TORCH_CHECK(value >= 0, "_record_nonfinite_: value must be non-negative, but got ", value);
+  TORCH_CHECK(found.is_cuda() && found.scalar_type() == kLong && found.numel() == 1,
+              "_record_nonfinite_: found must be a one-element int64 CUDA tensor");
+  c10::cuda::CUDAGuard device_guard(found.device());
+
+  std::map<ScalarType, std::vector<Tensor>> by_dtype;
+  for (const auto& tensor : tensors) {
+    TORCH_CHECK(tensor.device() == found.device(),
+                "_record_nonfinite_: expected all tensors on ", found.device(),
+                ", but got a tensor on ", tensor.device());
+    if (tensor.numel() == 0 || isIntegralType(tensor.scalar_type(), /*includeBool=*/true)) {
+      continue;
+    }
+    if (tensor.is_complex() || tensor.layout() != kStrided) {
+      const auto nonfinite = at::isfinite(tensor).all().logical_not().to(kLong);
+      found.copy_(at::max(found, nonfinite * value));
+      continue;
+    }
+    by_dtype[tensor.scalar_type()].push_back(tensor.contiguous());
+  }
+
+  // found and value are non-negative, so comparing them as unsigned is the
+  // same as comparing them as signed; CUDA has no signed 64 bit atomicMax
+  // on every platform.
+  auto* found_ptr = reinterpret_cast<unsigned long long*>(found.data_ptr<int64_t>());
+  for (const auto& kv : by_dtype) {
+    std::vector<std::vector<Tensor>> tensor_lists{kv.second};
+    AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, kv.first, "_record_nonfinite_cuda_", [&] {
+      multi_tensor_apply<1>(
+          tensor_lists, RecordNonfiniteFunctor<scalar_t>(), found_ptr,
+          static_cast<unsigned long long>(value));
+    });
+  }
+}
+
+}} // namespace at::native
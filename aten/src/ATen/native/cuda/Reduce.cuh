@@ -859,10 +859,22 @@ inline void gpu_reduce_kernel(TensorIterator& iter, const ops_t& ops, ident_t id
   // load for better performance. Note that if vt0 < ReduceConfig::vec_size, then this
   // means the register pressure could be high, in such case, we should avoid vectorization.
   // We only vectorize 1D reduction
-  if (fastest_moving_stride == sizeof(scalar_t) && dim0 > 128 && vt0 >= ReduceConfig::vec_size) {
+  if (fastest_moving_stride == sizeof(scalar_t) && vt0 >= ReduceConfig::vec_size) {
     // TODO: vectorization on output is not supported yet
     if (reduction_on_fastest_striding_dimension && iter.num_reduce_dims() == 1) {
-      config.vectorize = true;
+      constexpr int vec_size = ReduceConfig::vec_size;
+      if (dim0 > 128) {
+        config.vectorize = true;
+      } else if (dim0 >= vec_size * vec_size && dim0 % vec_size == 0) {
+        // Short rows, e.g., sum(dim=-1) of a [1M, 64] tensor: size block.x by
+        // the number of vectors in a row rather than the number of elements,
+        // so each row is reduced by a sub-warp group of lanes doing one
+        // vector load each, and a warp covers several rows. block.x stays at
+        // least vec_size wide, which vectorized_thread_reduce_impl needs to
+        // handle the unaligned head and the tail.
+        config.vectorize = true;
+        dim0 /= vec_size;
+      }
     }
   }
 
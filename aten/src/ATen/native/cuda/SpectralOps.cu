@@ -172,27 +172,27 @@ static void _fft_fill_with_conjugate_symmetry_(Tensor& input,
 // tensors being contiguous, and that the strides at the innermost signal
 // dimension being unit (1) w.r.t. the corresponding data type.
 
-static inline Tensor _run_cufft(
-    const CuFFTConfig &config, Tensor& input, int64_t signal_ndim,
+// Executes a cuFFT plan on input, writing into output. The plan's workspace is
+// taken from workspace, which is grown (from the caching allocator) if it is
+// too small, so transforms run as several plans can share one scratch buffer.
+static inline void _exec_cufft(
+    const CuFFTConfig &config, Tensor input, const Tensor& output,
     bool complex_input, bool complex_output, bool inverse,
-    IntArrayRef checked_signal_sizes, bool normalized, bool onesided,
-    IntArrayRef output_sizes, bool input_was_cloned
+    bool input_was_cloned, Tensor& workspace
 ) {
   if (config.should_clone_input() && !input_was_cloned) {
     input = input.clone(at::MemoryFormat::Contiguous);
   }
 
   auto& plan = config.plan();
-  auto& ctx = at::globalContext();
-
-  // set output
-  auto output = at::empty(output_sizes, input.options());
 
   // set to current stream
   CUFFT_CHECK(cufftSetStream(plan, at::cuda::getCurrentCUDAStream()));
 
-  auto ws = at::empty({ config.workspace_size() }, at::device(at::kCUDA).dtype(at::kByte));
-  CUFFT_CHECK(cufftSetWorkArea(plan, ws.data_ptr()));
+  if (!workspace.defined() || workspace.numel() < config.workspace_size()) {
+    workspace = at::empty({ config.workspace_size() }, at::device(at::kCUDA).dtype(at::kByte));
+  }
+  CUFFT_CHECK(cufftSetWorkArea(plan, workspace.data_ptr()));
 
   // run
 #ifdef __HIP_PLATFORM_HCC__
@@ -234,7 +234,13 @@ static inline Tensor _run_cufft(
   CUFFT_CHECK(cufftXtExec(plan, input.data_ptr(), output.data_ptr(),
     inverse ? CUFFT_INVERSE : CUFFT_FORWARD));
 #endif
+}
 
+// Rescales output and fills in the conjugate symmetric half if needed.
+static inline Tensor _cufft_postprocess(
+    Tensor& output, int64_t signal_ndim, bool complex_input, bool complex_output,
+    bool inverse, IntArrayRef checked_signal_sizes, bool normalized, bool onesided
+) {
   // rescale if needed by normalized flag or inverse transform
   auto size_last_signal_dim = checked_signal_sizes[signal_ndim - 1];
   if (normalized || inverse) {
@@ -261,6 +267,20 @@ static inline Tensor _run_cufft(
   return output;
 }
 
+static inline Tensor _run_cufft(
+    const CuFFTConfig &config, Tensor& input, int64_t signal_ndim,
+    bool complex_input, bool complex_output, bool inverse,
+    IntArrayRef checked_signal_sizes, bool normalized, bool onesided,
+    IntArrayRef output_sizes, bool input_was_cloned
+) {
+  auto output = at::empty(output_sizes, input.options());
+  Tensor workspace;
+  _exec_cufft(config, input, output, complex_input, complex_output, inverse,
+              input_was_cloned, workspace);
+  return _cufft_postprocess(output, signal_ndim, complex_input, complex_output,
+                            inverse, checked_signal_sizes, normalized, onesided);
+}
+
 // The cuFFT plan cache
 // unique_ptr for nullability and to avoid reference invalidation on vector resize
 static std::vector<std::unique_ptr<CuFFTParamsLRUCache>> plan_caches;
@@ -318,8 +338,71 @@ void cufft_clear_plan_cache_impl(int64_t device_index) {
   return cufft_get_plan_cache(device_index).clear();
 }
 
+CuFFTPlanCacheStats cufft_get_plan_cache_stats_impl(int64_t device_index) {
+  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
+    "cufft_get_plan_cache_stats: expected 0 <= device_index < ",
+    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
+    device_index);
+  auto& plan_cache = cufft_get_plan_cache(device_index);
+  std::lock_guard<std::mutex> guard(plan_cache.mutex);
+  return plan_cache.stats();
+}
+
+void cufft_reset_plan_cache_stats_impl(int64_t device_index) {
+  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
+    "cufft_reset_plan_cache_stats: expected 0 <= device_index < ",
+    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
+    device_index);
+  auto& plan_cache = cufft_get_plan_cache(device_index);
+  std::lock_guard<std::mutex> guard(plan_cache.mutex);
+  plan_cache.reset_stats();
+}
+
+bool cufft_get_plan_cache_batched_plans_impl(int64_t device_index) {
+  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
+    "cufft_get_plan_cache_batched_plans: expected 0 <= device_index < ",
+    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
+    device_index);
+  return cufft_get_plan_cache(device_index).batched_plans();
+}
+
+void cufft_set_plan_cache_batched_plans_impl(int64_t device_index, bool enabled) {
+  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
+    "cufft_set_plan_cache_batched_plans: expected 0 <= device_index < ",
+    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
+    device_index);
+  auto& plan_cache = cufft_get_plan_cache(device_index);
+  std::lock_guard<std::mutex> guard(plan_cache.mutex);
+  plan_cache.set_batched_plans(enabled);
+}
+
 } // namespace at::native::detail
 
+// NOTE [ cuFFT Batched Plans ]
+//
+// A cuFFT plan is made for a fixed batch size, so by default transforms that
+// only differ in batch size each build and cache their own plan. With
+// batched plans enabled on the plan cache, a transform of batch size b is
+// instead run as one chunk per set bit of b, largest first, e.g., 13 = 8 + 4 + 1.
+// Each chunk is a view of the input (and output) along the batch dimension, so
+// it is described by the same embedded strides and only needs a plan for its
+// power-of-two batch size. All batch sizes up to 2^n are then covered by n + 1
+// plans per signal shape, at the cost of at most that many plan executions per
+// transform. All chunks of a transform share one workspace.
+//
+// Chunks have to start at pointers cuFFT can use, i.e., aligned to the complex
+// type, so this is only done when the batch strides of the input and output
+// are multiples of two elements; otherwise, we fall back to a single plan.
+
+static inline bool _cufft_can_use_batched_plans(const Tensor& input,
+                                                IntArrayRef output_sizes) {
+  if (input.size(0) <= 1 || (input.size(0) & (input.size(0) - 1)) == 0) {
+    return false;  // a single chunk anyway
+  }
+  return input.stride(0) % 2 == 0 &&
+         at::prod_intlist(output_sizes.slice(1)) % 2 == 0;
+}
+
 // cuFFT
 // Currently not utilizing multi GPUs so this can be potentially sped up.
 Tensor _fft_cufft(const Tensor& self, int64_t signal_ndim,
@@ -371,6 +454,41 @@ Tensor _fft_cufft(const Tensor& self, int64_t signal_ndim,
     setCuFFTParams(&params, input, signal_ndim, complex_input,
       complex_output, checked_signal_sizes, onesided);
     std::lock_guard<std::mutex> guard(plan_cache.mutex);
+    if (plan_cache.max_size() > 0 && plan_cache.batched_plans() &&
+        _cufft_can_use_batched_plans(input, output_sizes)) {
+      // See NOTE [ cuFFT Batched Plans ].
+      auto output = at::empty(output_sizes, input.options());
+      Tensor workspace;
+      const int64_t batch = input.size(0);
+      int64_t largest_chunk = 1;
+      while (largest_chunk * 2 <= batch) {
+        largest_chunk *= 2;
+      }
+      int64_t offset = 0;
+      for (int64_t chunk = largest_chunk; chunk > 0; chunk >>= 1) {
+        if (!(batch & chunk)) {
+          continue;
+        }
+        auto input_chunk = input.narrow(0, offset, chunk);
+        CuFFTParams chunk_params;
+        setCuFFTParams(&chunk_params, input_chunk, signal_ndim, complex_input,
+          complex_output, checked_signal_sizes, onesided);
+        std::vector<int64_t> chunk_output_sizes(output_sizes.begin(), output_sizes.end());
+        chunk_output_sizes[0] = chunk;
+        // The config is only referenced until the next try_emplace_value,
+        // which may evict it.
+        const CuFFTConfig &config = plan_cache.try_emplace_value(std::move(chunk_params),
+                                               input_chunk, signal_ndim, complex_input,
+                                               complex_output, checked_signal_sizes,
+                                               onesided, chunk_output_sizes);
+        _exec_cufft(config, input_chunk, output.narrow(0, offset, chunk),
+                    complex_input, complex_output, inverse, input_was_cloned,
+                    workspace);
+        offset += chunk;
+      }
+      return _cufft_postprocess(output, signal_ndim, complex_input, complex_output,
+                                inverse, checked_signal_sizes, normalized, onesided);
+    }
     if (plan_cache.max_size() > 0) {  // check again after acquiring the lock
       const CuFFTConfig &config = plan_cache.try_emplace_value(std::move(params),
                                              input, signal_ndim, complex_input,
@@ -2,14 +2,18 @@
 
 #include <ATen/ATen.h>
 #include <ATen/AccumulateType.h>
+#include <ATen/CUDAGeneratorImpl.h>
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <ATen/cuda/CUDAGraphsUtils.cuh>
 #include <ATen/cuda/detail/IndexUtils.cuh>
 #include <THC/THCDeviceUtils.cuh>
 
 #include <c10/cuda/CUDAMathCompat.h>
 
+#include <curand_kernel.h>
+
 namespace at {
 namespace native {
 
@@ -279,6 +283,149 @@ __global__ void GammaBetaBackwardCUDAKernel(
   }
 }
 
+// Computes S = R + dropout(X) and Y = layer_norm(S) for row i in one pass
+// over the inputs. Each thread draws 4 random numbers at a time from its own
+// Philox subsequence, like fused_dropout_kernel. A null mask means p == 1 and
+// no random numbers are needed.
+template <typename T>
+__global__ void DropoutAddLayerNormForwardCUDAKernel(
+    int64_t N,
+    acc_type<T, true> p,
+    acc_type<T, true> eps,
+    const T* X,
+    const T* R,
+    const T* gamma,
+    const T* beta,
+    PhiloxCudaState philox_args,
+    T* S,
+    uint8_t* mask,
+    T* mean,
+    T* rstd,
+    T* Y) {
+  using T_ACC = acc_type<T, true>;
+  __shared__ T_ACC m_shared[C10_WARP_SIZE];
+  __shared__ T_ACC v_shared[C10_WARP_SIZE];
+  __shared__ T_ACC moments[2];
+  const int64_t i = blockIdx.x;
+  const T_ACC pinv = T_ACC(1) / p;
+  curandStatePhilox4_32_10_t state;
+  if (mask != nullptr) {
+    auto seeds = at::cuda::philox::unpack(philox_args);
+    curand_init(
+        std::get<0>(seeds),
+        i * blockDim.x + threadIdx.x,
+        std::get<1>(seeds),
+        &state);
+  }
+  float4 rand;
+  int rand_index = 0;
+  T_ACC sum1 = 0;
+  T_ACC sum2 = 0;
+  for (int64_t j = threadIdx.x; j < N; j += blockDim.x) {
+    const int64_t index = i * N + j;
+    T_ACC x = static_cast<T_ACC>(X[index]);
+    if (mask != nullptr) {
+      if (rand_index == 0) {
+        rand = curand_uniform4(&state);
+      }
+      const bool keep = (&rand.x)[rand_index] < p;
+      rand_index = (rand_index + 1) % 4;
+      mask[index] = keep;
+      x = keep ? x * pinv : T_ACC(0);
+    }
+    // Normalize the rounded sum so the result matches the unfused ops.
+    const T s = static_cast<T>(static_cast<T_ACC>(R[index]) + x);
+    S[index] = s;
+    sum1 += static_cast<T_ACC>(s);
+    sum2 += static_cast<T_ACC>(s) * static_cast<T_ACC>(s);
+  }
+  sum1 = BlockReduceSum<T_ACC>(sum1, m_shared);
+  sum2 = BlockReduceSum<T_ACC>(sum2, v_shared);
+  if (threadIdx.x == 0) {
+    const T_ACC scale = T_ACC(1) / static_cast<T_ACC>(N);
+    sum1 *= scale;
+    sum2 = c10::cuda::compat::max(sum2 * scale - sum1 * sum1, T_ACC(0));
+    const T mean_v = static_cast<T>(sum1);
+    const T rstd_v = static_cast<T>(c10::cuda::compat::rsqrt(sum2 + eps));
+    mean[i] = mean_v;
+    rstd[i] = rstd_v;
+    moments[0] = static_cast<T_ACC>(mean_v);
+    moments[1] = static_cast<T_ACC>(rstd_v);
+  }
+  __syncthreads();
+  const T_ACC mean_v = moments[0];
+  const T_ACC rstd_v = moments[1];
+  // Every thread reads back only the elements of S it wrote above.
+  for (int64_t j = threadIdx.x; j < N; j += blockDim.x) {
+    const int64_t index = i * N + j;
+    const T_ACC gamma_v =
+        gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma[j]);
+    const T_ACC beta_v =
+        beta == nullptr ? T_ACC(0) : static_cast<T_ACC>(beta[j]);
+    Y[index] = (static_cast<T_ACC>(S[index]) - mean_v) * rstd_v * gamma_v + beta_v;
+  }
+}
+
+// Computes dS, the gradient of layer_norm(S) for row i, as in
+// LayerNormBackwardCUDAKenrel, and writes it as the residual gradient dR and,
+// scaled by the dropout mask, as the input gradient dX. Either output may be
+// null.
+template <typename T>
+__global__ void DropoutAddLayerNormBackwardCUDAKernel(
+    int64_t N,
+    acc_type<T, true> p,
+    const T* dY,
+    const T* S,
+    const uint8_t* mask,
+    const T* mean,
+    const T* rstd,
+    const T* gamma,
+    T* dX,
+    T* dR) {
+  using T_ACC = acc_type<T, true>;
+  __shared__ T_ACC ds_shared[C10_WARP_SIZE];
+  __shared__ T_ACC db_shared[C10_WARP_SIZE];
+  __shared__ T_ACC coefficients[2];
+  const int64_t i = blockIdx.x;
+  T_ACC sum1 = 0;
+  T_ACC sum2 = 0;
+  for (int64_t j = threadIdx.x; j < N; j += blockDim.x) {
+    const int64_t index = i * N + j;
+    const T_ACC gamma_v =
+        gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma[j]);
+    sum1 +=
+        static_cast<T_ACC>(dY[index]) * static_cast<T_ACC>(S[index]) * gamma_v;
+    sum2 += static_cast<T_ACC>(dY[index]) * gamma_v;
+  }
+  sum1 = BlockReduceSum<T_ACC>(sum1, ds_shared);
+  sum2 = BlockReduceSum<T_ACC>(sum2, db_shared);
+  const T_ACC mean_v = static_cast<T_ACC>(mean[i]);
+  const T_ACC rstd_v = static_cast<T_ACC>(rstd[i]);
+  if (threadIdx.x == 0) {
+    const T_ACC s = T_ACC(1) / static_cast<T_ACC>(N);
+    const T_ACC a = (sum2 * mean_v - sum1) * rstd_v * rstd_v * rstd_v * s;
+    coefficients[0] = a;
+    coefficients[1] = -(a * mean_v + sum2 * rstd_v * s);
+  }
+  __syncthreads();
+  const T_ACC b = coefficients[0];
+  const T_ACC c = coefficients[1];
+  const T_ACC pinv = T_ACC(1) / p;
+  for (int64_t j = threadIdx.x; j < N; j += blockDim.x) {
+    const int64_t index = i * N + j;
+    const T_ACC gamma_v =
+        gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma[j]);
+    const T_ACC ds = rstd_v * static_cast<T_ACC>(dY[index]) * gamma_v +
+        b * static_cast<T_ACC>(S[index]) + c;
+    if (dR != nullptr) {
+      dR[index] = ds;
+    }
+    if (dX != nullptr) {
+      dX[index] = mask == nullptr ? ds : static_cast<T_ACC>(mask[index]) * ds * pinv;
+    }
+  }
+}
+
 template <typename T>
 void LayerNormKernelImplInternal(
     const Tensor& X,
@@ -490,6 +637,119 @@ std::tuple<Tensor, Tensor, Tensor> layer_norm_backward_cuda(
 }
 
 
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor>
+fused_dropout_add_layer_norm_cuda(
+    const Tensor& X,
+    const Tensor& R,
+    const Tensor& gamma /* optional */,
+    const Tensor& beta /* optional */,
+    int64_t M,
+    int64_t N,
+    double p,
+    double eps,
+    c10::optional<Generator> gen_) {
+  TORCH_CHECK(p > 0 && p <= 1, "_fused_dropout_add_layer_norm: expected p in (0, 1], but got ", p);
+  TORCH_CHECK(X.sizes().equals(R.sizes()) && X.numel() == M * N,
+              "_fused_dropout_add_layer_norm: expected input and residual of ",
+              M * N, " elements, but got sizes ", X.sizes(), " and ", R.sizes());
+  TORCH_CHECK(X.is_contiguous() && R.is_contiguous(),
+              "_fused_dropout_add_layer_norm: expected contiguous input and residual");
+  Tensor Y = at::native::empty_like(R, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor S = at::native::empty_like(R, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  // No mask is needed if nothing is dropped; the backward then uses the
+  // gradient of the residual as the gradient of the input.
+  Tensor mask = at::empty({p < 1 ? M * N : 0}, R.options().dtype(kByte));
+  Tensor mean = at::empty({M}, R.options());
+  Tensor rstd = at::empty({M}, R.options());
+  if (M == 0) {
+    return std::make_tuple(std::move(Y), std::move(S), std::move(mask), std::move(mean), std::move(rstd));
+  }
+
+  PhiloxCudaState rng_engine_inputs;
+  if (p < 1) {
+    auto gen = get_generator_or_default<CUDAGeneratorImpl>(gen_, cuda::detail::getDefaultCUDAGenerator());
+    // Number of random numbers generated per thread, to offset the philox counter
+    const int64_t counter_offset = ((N - 1) / (kCUDANumThreads * 4) + 1) * 4;
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    rng_engine_inputs = gen->philox_cuda_state(counter_offset);
+  }
+
+  cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+      R.scalar_type(), "fused_dropout_add_layer_norm_cuda", [&]() {
+        using T_ACC = acc_type<scalar_t, true>;
+        DropoutAddLayerNormForwardCUDAKernel<scalar_t>
+            <<<M, kCUDANumThreads, 0, cuda_stream>>>(
+                N,
+                static_cast<T_ACC>(p),
+                static_cast<T_ACC>(static_cast<scalar_t>(eps)),
+                X.data_ptr<scalar_t>(),
+                R.data_ptr<scalar_t>(),
+                gamma.defined() ? gamma.data_ptr<scalar_t>() : nullptr,
+                beta.defined() ? beta.data_ptr<scalar_t>() : nullptr,
+                rng_engine_inputs,
+                S.data_ptr<scalar_t>(),
+                p < 1 ? mask.data_ptr<uint8_t>() : nullptr,
+                mean.data_ptr<scalar_t>(),
+                rstd.data_ptr<scalar_t>(),
+                Y.data_ptr<scalar_t>());
+      });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return std::make_tuple(std::move(Y), std::move(S), std::move(mask), std::move(mean), std::move(rstd));
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor>
+fused_dropout_add_layer_norm_backward_cuda(
+    const Tensor& dY,
+    const Tensor& S,
+    const Tensor& mask,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t M,
+    int64_t N,
+    double p,
+    std::array<bool, 4> grad_input_mask) {
+  Tensor dX;
+  Tensor dR;
+  Tensor dgamma;
+  Tensor dbeta;
+  if (grad_input_mask[0]) {
+    dX = at::native::empty_like(S, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  }
+  if (grad_input_mask[1]) {
+    dR = at::native::empty_like(S, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  }
+  if (M > 0 && (dX.defined() || dR.defined())) {
+    cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
+    AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+        S.scalar_type(), "fused_dropout_add_layer_norm_backward_cuda", [&]() {
+          using T_ACC = acc_type<scalar_t, true>;
+          DropoutAddLayerNormBackwardCUDAKernel<scalar_t>
+              <<<M, kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
+                  N,
+                  static_cast<T_ACC>(p),
+                  dY.data_ptr<scalar_t>(),
+                  S.data_ptr<scalar_t>(),
+                  mask.numel() > 0 ? mask.data_ptr<uint8_t>() : nullptr,
+                  mean.data_ptr<scalar_t>(),
+                  rstd.data_ptr<scalar_t>(),
+                  gamma.defined() ? gamma.data_ptr<scalar_t>() : nullptr,
+                  dX.defined() ? dX.data_ptr<scalar_t>() : nullptr,
+                  dR.defined() ? dR.data_ptr<scalar_t>() : nullptr);
+        });
+    AT_CUDA_CHECK(cudaGetLastError());
+  }
+  if (grad_input_mask[2] || grad_input_mask[3]) {
+    // The weight and bias gradients only depend on the normalized sum, so
+    // they come from the layer norm backward kernels.
+    std::tie(std::ignore, dgamma, dbeta) = layer_norm_backward_cuda(
+        dY, S, mean, rstd, gamma, M, N, {false, grad_input_mask[2], grad_input_mask[3]});
+  }
+  return std::make_tuple(std::move(dX), std::move(dR), std::move(dgamma), std::move(dbeta));
+}
+
 REGISTER_DISPATCH(LayerNormKernel, &LayerNormKernelImpl);
 REGISTER_DISPATCH(LayerNormBackwardKernel, &LayerNormBackwardKernelImpl);
 
@@ -7,6 +7,7 @@
 #include <ATen/cuda/CUDAConfig.h>
 #include <ATen/cuda/Exceptions.h>
 #include <ATen/native/ConvUtils.h>
+#include <ATen/native/cudnn/ConvAlgorithmCache.h>
 
 #if !AT_CUDNN_ENABLED()
 
@@ -70,6 +71,14 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
   AT_ERROR("cudnn_convolution_transpose_backward: ATen not compiled with cuDNN support");
 }
 
+void save_cudnn_convolution_algorithms(const std::string& path) {
+  AT_ERROR("save_cudnn_convolution_algorithms: ATen not compiled with cuDNN support");
+}
+
+int64_t load_cudnn_convolution_algorithms(const std::string& path) {
+  AT_ERROR("load_cudnn_convolution_algorithms: ATen not compiled with cuDNN support");
+}
+
 }}
 
 #else  // AT_CUDNN_ENABLED
@@ -80,10 +89,14 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
 #include <ATen/cudnn/Descriptors.h>
 #include <ATen/cudnn/Types.h>
 #include <ATen/cudnn/Utils.h>
+#include <ATen/cuda/CUDAContext.h>
 #include <ATen/native/utils/ParamsHash.h>
 
 #include <ATen/TensorUtils.h>
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <functional>
 #include <iterator>
 #include <sstream>
@@ -292,12 +305,135 @@ struct BenchmarkCache {
     std::lock_guard<std::mutex> guard(mutex);
     map[params] = results;
   }
+
+  // Both ConvolutionParams (zeroed by setConvolutionParams before being
+  // filled in) and the cuDNN perf structs are PODs, so entries are written
+  // as raw bytes.
+  void save(std::ostream& out) {
+    std::lock_guard<std::mutex> guard(mutex);
+    uint64_t count = map.size();
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& entry : map) {
+      out.write(reinterpret_cast<const char*>(&entry.first), sizeof(ConvolutionParams));
+      out.write(reinterpret_cast<const char*>(&entry.second), sizeof(T));
+    }
+  }
+
+  // Returns the number of entries read, or -1 if the stream ended early.
+  int64_t load(std::istream& in) {
+    uint64_t count = 0;
+    if (!in.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+      return -1;
+    }
+    std::lock_guard<std::mutex> guard(mutex);
+    for (uint64_t i = 0; i < count; i++) {
+      ConvolutionParams params;
+      T results;
+      if (!in.read(reinterpret_cast<char*>(&params), sizeof(params)) ||
+          !in.read(reinterpret_cast<char*>(&results), sizeof(results))) {
+        return -1;
+      }
+      map.emplace(params, results);
+    }
+    return count;
+  }
 };
 
 BenchmarkCache<cudnnConvolutionFwdAlgoPerf_t> fwd_algos;
 BenchmarkCache<cudnnConvolutionBwdDataAlgoPerf_t> bwd_data_algos;
 BenchmarkCache<cudnnConvolutionBwdFilterAlgoPerf_t> bwd_filter_algos;
 
+// ---------------------------------------------------------------------
+//
+// Benchmark cache files
+//
+// ---------------------------------------------------------------------
+
+namespace {
+
+constexpr char kAlgorithmCacheMagic[8] = {'C', 'U', 'D', 'N', 'N', 'A', 'L', 'G'};
+constexpr uint32_t kAlgorithmCacheFormatVersion = 1;
+
+// Everything an entry's validity depends on besides its ConvolutionParams.
+struct AlgorithmCacheHeader {
+  char magic[8];
+  uint32_t format_version;
+  uint32_t params_size;
+  uint32_t fwd_perf_size;
+  uint32_t bwd_data_perf_size;
+  uint32_t bwd_filter_perf_size;
+  int32_t compute_major;
+  int32_t compute_minor;
+  uint64_t cudnn_version;
+  char device_name[256];
+};
+
+AlgorithmCacheHeader current_algorithm_cache_header() {
+  AlgorithmCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kAlgorithmCacheMagic, sizeof(header.magic));
+  header.format_version = kAlgorithmCacheFormatVersion;
+  header.params_size = sizeof(ConvolutionParams);
+  header.fwd_perf_size = sizeof(cudnnConvolutionFwdAlgoPerf_t);
+  header.bwd_data_perf_size = sizeof(cudnnConvolutionBwdDataAlgoPerf_t);
+  header.bwd_filter_perf_size = sizeof(cudnnConvolutionBwdFilterAlgoPerf_t);
+  const cudaDeviceProp* prop = at::cuda::getCurrentDeviceProperties();
+  header.compute_major = prop->major;
+  header.compute_minor = prop->minor;
+  header.cudnn_version = cudnnGetVersion();
+  strncpy(header.device_name, prop->name, sizeof(header.device_name) - 1);
+  return header;
+}
+
+} // namespace
+
+void save_cudnn_convolution_algorithms(const std::string& path) {
+  const AlgorithmCacheHeader header = current_algorithm_cache_header();
+  // Write to a temporary file and rename it, so that processes loading the
+  // cache concurrently never see a partially written file.
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    TORCH_CHECK(out, "save_cudnn_convolution_algorithms: could not open ", tmp_path, " for writing");
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    fwd_algos.save(out);
+    bwd_data_algos.save(out);
+    bwd_filter_algos.save(out);
+    TORCH_CHECK(out.flush(), "save_cudnn_convolution_algorithms: failed writing ", tmp_path);
+  }
+  TORCH_CHECK(std::rename(tmp_path.c_str(), path.c_str()) == 0,
+      "save_cudnn_convolution_algorithms: could not rename ", tmp_path, " to ", path);
+}
+
+int64_t load_cudnn_convolution_algorithms(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return 0;
+  }
+  const AlgorithmCacheHeader expected = current_algorithm_cache_header();
+  AlgorithmCacheHeader header;
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      memcmp(header.magic, kAlgorithmCacheMagic, sizeof(header.magic)) != 0) {
+    TORCH_WARN("load_cudnn_convolution_algorithms: ", path, " is not a cuDNN algorithm cache; ignoring it");
+    return 0;
+  }
+  if (memcmp(&header, &expected, sizeof(header)) != 0) {
+    TORCH_WARN("load_cudnn_convolution_algorithms: ", path, " was written for ",
+        header.device_name, " with cuDNN ", header.cudnn_version, ", but this process uses ",
+        expected.device_name, " with cuDNN ", expected.cudnn_version, "; ignoring it");
+    return 0;
+  }
+  int64_t loaded = 0;
+  for (int64_t count : {fwd_algos.load(in), bwd_data_algos.load(in), bwd_filter_algos.load(in)}) {
+    if (count < 0) {
+      TORCH_WARN("load_cudnn_convolution_algorithms: ", path, " is truncated");
+      break;
+    }
+    loaded += count;
+  }
+  return loaded;
+}
+
 // TODO: Stop manually allocating CUDA memory; allocate an ATen byte
 // tensor instead.
 struct Workspace {
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <c10/macros/Export.h>
+
+#include <cstdint>
+#include <string>
+
+namespace at { namespace native {
+
+// The algorithms picked for each convolution shape under
+// torch.backends.cudnn.benchmark are kept in process memory only. These write
+// them to a file and read them back, so that a restarted process can skip
+// benchmarking shapes another process already measured.
+//
+// The file records the GPU model and the cuDNN version that produced it;
+// loading a file written for a different GPU or cuDNN version loads nothing.
+// Loaded entries never replace algorithms already benchmarked by this process.
+
+TORCH_CUDA_API void save_cudnn_convolution_algorithms(const std::string& path);
+
+// Returns the number of entries loaded, or 0 if `path` does not exist or does
+// not match this GPU and cuDNN version.
+TORCH_CUDA_API int64_t load_cudnn_convolution_algorithms(const std::string& path);
+
+}}  // namespace at::native
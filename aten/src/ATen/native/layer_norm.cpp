@@ -79,6 +79,37 @@ Tensor layer_norm(
   return std::get<0>(at::native_layer_norm(X, gamma, beta, M, N, eps));
 }
 
+Tensor _dropout_add_layer_norm(
+    const Tensor& input,
+    const Tensor& residual,
+    IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    double p,
+    bool train,
+    double eps) {
+  TORCH_CHECK(p >= 0 && p <= 1, "dropout probability has to be between 0 and 1, but got ", p);
+  const auto dtype = residual.scalar_type();
+  const bool use_fused_kernel = input.is_cuda() && residual.is_cuda() &&
+      input.sizes().equals(residual.sizes()) && input.scalar_type() == dtype &&
+      dtype != kBFloat16 && (!weight.defined() || weight.scalar_type() == dtype) &&
+      (!bias.defined() || bias.scalar_type() == dtype) && p < 1 && residual.numel() > 0;
+  if (!use_fused_kernel) {
+    return at::layer_norm(
+        residual + at::dropout(input, p, train), normalized_shape, weight, bias, eps);
+  }
+
+  auto inputs = _prepare_layer_norm_inputs(residual, normalized_shape, weight, bias);
+  auto R = std::get<0>(inputs);
+  auto gamma = std::get<1>(inputs);
+  auto beta = std::get<2>(inputs);
+  auto M = std::get<3>(inputs);
+  auto N = std::get<4>(inputs);
+
+  return std::get<0>(at::_fused_dropout_add_layer_norm(
+      input.contiguous(), R, gamma, beta, M, N, train ? 1 - p : 1, eps));
+}
+
 DEFINE_DISPATCH(LayerNormKernel);
 DEFINE_DISPATCH(LayerNormBackwardKernel);
 
@@ -15,6 +15,26 @@ Tensor _fft_mkl(const Tensor& input, int64_t signal_ndim,
   AT_ERROR("fft: ATen not compiled with MKL support");
 }
 
+int64_t _mkl_fft_get_plan_cache_size() {
+  return 0;
+}
+
+int64_t _mkl_fft_get_plan_cache_max_size() {
+  return 0;
+}
+
+void _mkl_fft_set_plan_cache_max_size(int64_t max_size) {
+  AT_ERROR("fft: ATen not compiled with MKL support");
+}
+
+void _mkl_fft_clear_plan_cache() {}
+
+std::tuple<int64_t, int64_t, int64_t> _mkl_fft_get_plan_cache_stats() {
+  return std::make_tuple(0, 0, 0);
+}
+
+void _mkl_fft_reset_plan_cache_stats() {}
+
 }}
 
 #else // AT_MKL_ENABLED
@@ -26,10 +46,17 @@ Tensor _fft_mkl(const Tensor& input, int64_t signal_ndim,
 #include <ATen/Parallel.h>
 #include <ATen/Utils.h>
 
+#include <ATen/native/utils/ParamsHash.h>
+
 #include <algorithm>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <numeric>
 #include <cmath>
+#include <unordered_map>
 
 #include <mkl_dfti.h>
 #include <ATen/mkl/Exceptions.h>
@@ -144,6 +171,201 @@ static inline void _fft_fill_with_conjugate_symmetry_(Tensor& input,
   });
 }
 
+// Everything a committed DFTI descriptor depends on. Strides and distances
+// are in elements of the complex or real type of each side. The number of
+// intra-op threads is part of the key because MKL plans a descriptor for the
+// number of threads it may use when the descriptor is committed.
+struct DftiParams {
+  DFTI_CONFIG_VALUE precision;
+  DFTI_CONFIG_VALUE signal_type;
+  // at most 3, see _fft in native/SpectralOps.cpp
+  int64_t signal_ndim;
+  int64_t signal_sizes[3];
+  int64_t batch;
+  int64_t idist;
+  int64_t odist;
+  int64_t istrides[3];
+  int64_t ostrides[3];
+  bool complex_input;
+  bool complex_output;
+  bool inverse;
+  bool normalized;
+  int num_threads;
+};
+
+static std::shared_ptr<DftiDescriptor> make_dfti_descriptor(const DftiParams& params) {
+  const int64_t signal_ndim = params.signal_ndim;
+  std::vector<MKL_LONG> mkl_signal_sizes(params.signal_sizes, params.signal_sizes + signal_ndim);
+  auto descriptor = std::make_shared<DftiDescriptor>();
+  descriptor->init(params.precision, params.signal_type, signal_ndim, mkl_signal_sizes.data());
+  // out of place FFT
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_PLACEMENT, DFTI_NOT_INPLACE));
+  // batch mode
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_NUMBER_OF_TRANSFORMS, params.batch));
+  // batch dim stride, i.e., dist between each data
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_INPUT_DISTANCE, params.idist));
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_OUTPUT_DISTANCE, params.odist));
+  // signal strides
+  // first val is offset, set to zero (ignored)
+  std::vector<MKL_LONG> mkl_istrides(1 + signal_ndim, 0), mkl_ostrides(1 + signal_ndim, 0);
+  for (int64_t i = 0; i < signal_ndim; i++) {
+    mkl_istrides[i + 1] = params.istrides[i];
+    mkl_ostrides[i + 1] = params.ostrides[i];
+  }
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_INPUT_STRIDES, mkl_istrides.data()));
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_OUTPUT_STRIDES, mkl_ostrides.data()));
+  // if conjugate domain of real is involved, set standard CCE storage type
+  // this will become default in MKL in future
+  if (!params.complex_input || !params.complex_output) {
+    MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX));
+  }
+  // rescale if needed by normalized flag or inverse transform
+  if (params.normalized || params.inverse) {
+    auto signal_numel = at::prod_intlist(IntArrayRef(params.signal_sizes, signal_ndim));
+    double double_scale;
+    if (params.normalized) {
+      double_scale = 1.0 / std::sqrt(static_cast<double>(signal_numel));
+    } else {
+      double_scale = 1.0 / static_cast<double>(signal_numel);
+    }
+    MKL_DFTI_CHECK(DftiSetValue(descriptor->get(),
+      params.inverse ? DFTI_BACKWARD_SCALE : DFTI_FORWARD_SCALE,
+      params.precision == DFTI_DOUBLE ? double_scale : static_cast<float>(double_scale)));
+  }
+  // finalize
+  MKL_DFTI_CHECK(DftiCommitDescriptor(descriptor->get()));
+  return descriptor;
+}
+
+constexpr size_t kDftiMaxCacheSize = 4096;
+constexpr size_t kDftiDefaultCacheSize = 256;
+
+// An LRU cache of committed DFTI descriptors, the CPU counterpart of
+// CuFFTParamsLRUCache in native/cuda/CuFFTPlanCache.h. MKL allows a committed
+// descriptor to be used by several threads at once, so the cache hands out
+// shared pointers, the transforms run without holding the lock, and a
+// descriptor evicted while in use is freed by its last user. Only the
+// bookkeeping of the cache itself is guarded by the mutex.
+class DftiDescriptorCache {
+ public:
+  using kv_t = std::pair<DftiParams, std::shared_ptr<DftiDescriptor>>;
+
+  std::shared_ptr<DftiDescriptor> find(const DftiParams& params) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = map_.find(params);
+    if (it == map_.end()) {
+      misses_++;
+      return nullptr;
+    }
+    hits_++;
+    usage_list_.splice(usage_list_.begin(), usage_list_, it->second);
+    return it->second->second;
+  }
+
+  // Returns the descriptor cached for params, which is `descriptor` unless
+  // another thread inserted the same params first.
+  std::shared_ptr<DftiDescriptor> insert(
+      const DftiParams& params,
+      std::shared_ptr<DftiDescriptor> descriptor) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (max_size_ == 0) {
+      return descriptor;
+    }
+    auto it = map_.find(params);
+    if (it != map_.end()) {
+      return it->second->second;
+    }
+    if (usage_list_.size() >= max_size_) {
+      map_.erase(usage_list_.back().first);
+      usage_list_.pop_back();
+      evictions_++;
+    }
+    usage_list_.emplace_front(params, std::move(descriptor));
+    map_.emplace(usage_list_.front().first, usage_list_.begin());
+    return usage_list_.front().second;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    map_.clear();
+    usage_list_.clear();
+  }
+
+  void resize(int64_t new_size) {
+    TORCH_CHECK(new_size >= 0,
+             "MKL FFT plan cache size must be non-negative, but got ", new_size);
+    TORCH_CHECK(static_cast<size_t>(new_size) <= kDftiMaxCacheSize,
+             "MKL FFT plan cache size can not be larger than ", kDftiMaxCacheSize,
+             ", but got ", new_size);
+    std::lock_guard<std::mutex> guard(mutex_);
+    max_size_ = static_cast<size_t>(new_size);
+    while (usage_list_.size() > max_size_) {
+      map_.erase(usage_list_.back().first);
+      usage_list_.pop_back();
+      evictions_++;
+    }
+  }
+
+  int64_t size() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return usage_list_.size();
+  }
+
+  int64_t max_size() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return max_size_;
+  }
+
+  std::tuple<int64_t, int64_t, int64_t> stats() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return std::make_tuple(hits_, misses_, evictions_);
+  }
+
+  void reset_stats() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    hits_ = misses_ = evictions_ = 0;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::list<kv_t> usage_list_;
+  std::unordered_map<DftiParams, std::list<kv_t>::iterator,
+                     ParamsHash<DftiParams>, ParamsEqual<DftiParams>> map_;
+  size_t max_size_ = kDftiDefaultCacheSize;
+  int64_t hits_ = 0;
+  int64_t misses_ = 0;
+  int64_t evictions_ = 0;
+};
+
+static DftiDescriptorCache& dfti_descriptor_cache() {
+  static DftiDescriptorCache cache;
+  return cache;
+}
+
+int64_t _mkl_fft_get_plan_cache_size() {
+  return dfti_descriptor_cache().size();
+}
+
+int64_t _mkl_fft_get_plan_cache_max_size() {
+  return dfti_descriptor_cache().max_size();
+}
+
+void _mkl_fft_set_plan_cache_max_size(int64_t max_size) {
+  dfti_descriptor_cache().resize(max_size);
+}
+
+void _mkl_fft_clear_plan_cache() {
+  dfti_descriptor_cache().clear();
+}
+
+std::tuple<int64_t, int64_t, int64_t> _mkl_fft_get_plan_cache_stats() {
+  return dfti_descriptor_cache().stats();
+}
+
+void _mkl_fft_reset_plan_cache_stats() {
+  dfti_descriptor_cache().reset_stats();
+}
+
 // MKL DFTI
 Tensor _fft_mkl(const Tensor& self, int64_t signal_ndim,
                 bool complex_input, bool complex_output,
@@ -213,56 +435,40 @@ Tensor _fft_mkl(const Tensor& self, int64_t signal_ndim,
   } else {
     signal_type = complex_output ? DFTI_COMPLEX : DFTI_REAL;
   }
-  // create descriptor with signal size
-  std::vector<MKL_LONG> mkl_signal_sizes(checked_signal_sizes.begin(), checked_signal_sizes.end());
-  DftiDescriptor descriptor;
-  descriptor.init(prec, signal_type, signal_ndim, mkl_signal_sizes.data());
-  // out of place FFT
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_PLACEMENT, DFTI_NOT_INPLACE));
-  // batch mode
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_NUMBER_OF_TRANSFORMS, batch));
-
+  DftiParams params;
+  // zero the padding too, as the cache hashes and compares raw bytes
+  std::memset(&params, 0, sizeof(params));
+  params.precision = prec;
+  params.signal_type = signal_type;
+  params.signal_ndim = signal_ndim;
+  params.batch = batch;
   auto istrides = input.strides();
   auto ostrides = output.strides();
-  // batch dim stride, i.e., dist between each data
-  MKL_LONG idist = complex_input ? istrides[0] >> 1 : istrides[0];
-  MKL_LONG odist = complex_output ? ostrides[0] >> 1 : ostrides[0];
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_INPUT_DISTANCE, idist));
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_OUTPUT_DISTANCE, odist));
-  // signal strides
-  // first val is offset, set to zero (ignored)
-  std::vector<MKL_LONG> mkl_istrides(1 + signal_ndim, 0), mkl_ostrides(1 + signal_ndim, 0);
-  for (int64_t i = 1; i <= signal_ndim; i++) {
-    mkl_istrides[i] = complex_input ? istrides[i] >> 1 : istrides[i];
-    mkl_ostrides[i] = complex_output ? ostrides[i] >> 1 : ostrides[i];
+  params.idist = complex_input ? istrides[0] >> 1 : istrides[0];
+  params.odist = complex_output ? ostrides[0] >> 1 : ostrides[0];
+  for (int64_t i = 0; i < signal_ndim; i++) {
+    params.signal_sizes[i] = checked_signal_sizes[i];
+    params.istrides[i] = complex_input ? istrides[i + 1] >> 1 : istrides[i + 1];
+    params.ostrides[i] = complex_output ? ostrides[i + 1] >> 1 : ostrides[i + 1];
   }
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_INPUT_STRIDES, mkl_istrides.data()));
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_OUTPUT_STRIDES, mkl_ostrides.data()));
-  // if conjugate domain of real is involved, set standard CCE storage type
-  // this will become default in MKL in future
-  if (!complex_input || !complex_output) {
-    MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX));
-  }
-  // rescale if needed by normalized flag or inverse transform
-  if (normalized || inverse) {
-    auto signal_numel = at::prod_intlist(checked_signal_sizes);
-    double double_scale;
-    if (normalized) {
-      double_scale = 1.0 / std::sqrt(static_cast<double>(signal_numel));
-    } else {
-      double_scale = 1.0 / static_cast<double>(signal_numel);
-    }
-    MKL_DFTI_CHECK(DftiSetValue(descriptor.get(),
-      inverse ? DFTI_BACKWARD_SCALE : DFTI_FORWARD_SCALE,
-      prec == DFTI_DOUBLE ? double_scale : static_cast<float>(double_scale)));
+  params.complex_input = complex_input;
+  params.complex_output = complex_output;
+  params.inverse = inverse;
+  params.normalized = normalized;
+  params.num_threads = at::get_num_threads();
+
+  auto& cache = dfti_descriptor_cache();
+  auto descriptor = cache.find(params);
+  if (!descriptor) {
+    // Committing can take longer than the transform, so it happens outside
+    // the lock of the cache.
+    descriptor = cache.insert(params, make_dfti_descriptor(params));
   }
-  // finalize
-  MKL_DFTI_CHECK(DftiCommitDescriptor(descriptor.get()));
   // run
   if (!inverse) {
-    MKL_DFTI_CHECK(DftiComputeForward(descriptor.get(), input.data_ptr(), output.data_ptr()));
+    MKL_DFTI_CHECK(DftiComputeForward(descriptor->get(), input.data_ptr(), output.data_ptr()));
   } else {
-    MKL_DFTI_CHECK(DftiComputeBackward(descriptor.get(), input.data_ptr(), output.data_ptr()));
+    MKL_DFTI_CHECK(DftiComputeBackward(descriptor->get(), input.data_ptr(), output.data_ptr()));
   }
   // now if needed, fill out the other half using Hermitian symmetry dim
   if (!complex_input && complex_output && !onesided) {
@@ -37,6 +37,10 @@ std::tuple<at::Tensor,at::Tensor,at::Tensor> mkldnn_convolution_backward(
 #include <ATen/native/mkldnn/MKLDNNCommon.h>
 #include <ATen/native/mkldnn/Utils.h>
 #include <ATen/native/ConvUtils.h>
+#include <ATen/native/utils/ParamUtils.h>
+
+#include <mutex>
+#include <unordered_map>
 
 namespace {
 // Helper function for getting an ideep tensor out of an aten Tensor.
@@ -51,6 +55,93 @@ inline ideep::tensor get_mkldnn_tensor(const at::Tensor& tensor) {
     return at::native::itensor_view_from_dense(tensor);
   }
 }
+
+// Dense weights are otherwise reordered into mkldnn's blocked conv format on
+// every call (see the note on mkldnn_reorder_conv2d_weight). The reordered
+// copy is kept until the weight is modified, which bumps its version counter.
+// Entries hold a weak reference to the weight's TensorImpl so that its address
+// cannot be reused by another tensor while the entry is alive.
+class ReorderedWeightCache {
+ public:
+  ideep::tensor get(
+      const at::Tensor& weight,
+      at::IntArrayRef padding,
+      at::IntArrayRef stride,
+      at::IntArrayRef dilation,
+      int64_t groups) {
+    std::vector<int64_t> params;
+    params.insert(params.end(), padding.begin(), padding.end());
+    params.insert(params.end(), stride.begin(), stride.end());
+    params.insert(params.end(), dilation.begin(), dilation.end());
+    params.push_back(groups);
+    const auto version = weight.unsafeGetTensorImpl()->version_counter().current_version();
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = entries_.find(weight.unsafeGetTensorImpl());
+    if (it != entries_.end() && !it->second.impl.expired() &&
+        it->second.version == version &&
+        it->second.data == weight.data_ptr() &&
+        it->second.params == params) {
+      return it->second.reordered;
+    }
+
+    const at::Tensor dense = weight.contiguous(weight.suggest_memory_format());
+    const ideep::tensor w = at::native::itensor_view_from_dense(dense);
+    auto desc = ideep::convolution_forward::expected_weights_desc(
+        w.get_dims(),
+        w.get_data_type(),
+        {stride.begin(), stride.end()},
+        {padding.begin(), padding.end()},
+        {padding.begin(), padding.end()},
+        {dilation.begin(), dilation.end()},
+        groups,
+        ideep::algorithm::convolution_direct);
+    ideep::tensor reordered;
+    reordered.init(desc);
+    reordered.feed_from(w);
+
+    if (entries_.size() >= kMaxEntries) {
+      evict_expired();
+    }
+    if (entries_.size() >= kMaxEntries) {
+      entries_.clear();
+    }
+    entries_.erase(weight.unsafeGetTensorImpl());
+    entries_.emplace(weight.unsafeGetTensorImpl(), Entry{
+        c10::weak_intrusive_ptr<c10::TensorImpl, c10::UndefinedTensorImpl>(weight.getIntrusivePtr()),
+        version, weight.data_ptr(), std::move(params), reordered});
+    return reordered;
+  }
+
+ private:
+  struct Entry {
+    c10::weak_intrusive_ptr<c10::TensorImpl, c10::UndefinedTensorImpl> impl;
+    uint32_t version;
+    void* data;
+    std::vector<int64_t> params;
+    ideep::tensor reordered;
+  };
+
+  static constexpr size_t kMaxEntries = 256;
+
+  void evict_expired() {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (it->second.impl.expired()) {
+        it = entries_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<c10::TensorImpl*, Entry> entries_;
+};
+
+ReorderedWeightCache& reordered_weight_cache() {
+  static ReorderedWeightCache cache;
+  return cache;
+}
 }
 
 namespace at { namespace native {
@@ -107,7 +198,14 @@ at::Tensor mkldnn_convolution(
     IntArrayRef dilation,
     int64_t groups) {
   const ideep::tensor mkldnn_input = get_mkldnn_tensor(input);
-  const ideep::tensor mkldnn_weight = get_mkldnn_tensor(weight);
+  const ideep::tensor mkldnn_weight = weight.is_mkldnn()
+      ? get_mkldnn_tensor(weight)
+      : reordered_weight_cache().get(
+            weight,
+            expand_param_if_needed(padding, "padding", 2),
+            expand_param_if_needed(stride, "stride", 2),
+            expand_param_if_needed(dilation, "dilation", 2),
+            groups);
   c10::optional<ideep::tensor> mkldnn_bias{c10::nullopt};
   if (bias.defined()) {
     mkldnn_bias = get_mkldnn_tensor(bias);
@@ -124,6 +222,16 @@ at::Tensor mkldnn_convolution(
 
   if (input.is_mkldnn()) {
     return new_with_itensor_mkldnn(std::move(mkldnn_output), input.options());
+  } else if (input.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+    // Reorder straight into a channels last output instead of going through
+    // a contiguous one.
+    auto dims = mkldnn_output.get_dims();
+    Tensor output = at::empty(
+        std::vector<int64_t>(dims.begin(), dims.end()),
+        input.options().memory_format(at::MemoryFormat::ChannelsLast));
+    ideep::tensor output_view = itensor_view_from_dense(output);
+    output_view.feed_from(mkldnn_output);
+    return output;
   } else {
     return mkldnn_to_dense(
         new_with_itensor_mkldnn(std::move(mkldnn_output), input.options()));
@@ -194,10 +302,13 @@ std::tuple<at::Tensor, at::Tensor> mkldnn_convolution_backward_weights(
 }
 
 std::tuple<at::Tensor,at::Tensor,at::Tensor> mkldnn_convolution_backward(
-    const at::Tensor& input, const at::Tensor& grad_output_t, const at::Tensor& weight,
+    const at::Tensor& input_t, const at::Tensor& grad_output_t, const at::Tensor& weight_t,
     IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation, int64_t groups, std::array<bool,3> output_mask)
 {
   Tensor grad_output = grad_output_t.contiguous();
+  // the forward pass may have read a channels last input and weight as is
+  Tensor input = input_t.is_mkldnn() ? input_t : input_t.contiguous(input_t.suggest_memory_format());
+  Tensor weight = weight_t.is_mkldnn() ? weight_t : weight_t.contiguous(weight_t.suggest_memory_format());
 
   Tensor grad_input, grad_weight, grad_bias;
   if (output_mask[0]) {
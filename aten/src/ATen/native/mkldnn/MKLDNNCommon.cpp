@@ -69,6 +69,15 @@ ideep::tensor itensor_view_from_dense(const Tensor& tensor) {
   AT_ASSERTM(tensor.scalar_type() == ScalarType::Float,
              "itensor_view_from_dense expects float tensor input");
   TORCH_INTERNAL_ASSERT(at::impl::variable_excluded_from_dispatch());
+  if (tensor.dim() == 4 && !tensor.is_contiguous() &&
+      tensor.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    return {{{tensor.sizes().cbegin(), tensor.sizes().cend()},
+             ideep::tensor::data_type::f32,
+             ideep::format_tag::nhwc},
+            tensor.template data_ptr<float>()};
+  }
+  AT_ASSERTM(tensor.is_contiguous(),
+             "itensor_view_from_dense expects contiguous or channels last tensor input");
   return {{{tensor.sizes().cbegin(), tensor.sizes().cend()},
            ideep::tensor::data_type::f32},
           tensor.template data_ptr<float>()};
@@ -15,7 +15,8 @@ Tensor new_with_itensor_mkldnn(ideep::tensor&& it, const TensorOptions& options)
 ideep::tensor& itensor_from_mkldnn(const Tensor& mkldnn_tensor);
 
 // Construct an `ideep::tensor` "view" from dense tensor, note the
-// ideep::tensor will share the underlying buffer
+// ideep::tensor will share the underlying buffer. Channels last 4-d tensors
+// are viewed in nhwc format, so they need not be made contiguous first.
 ideep::tensor itensor_view_from_dense(const Tensor& tensor);
 }}
 
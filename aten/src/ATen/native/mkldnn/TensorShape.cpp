@@ -28,6 +28,10 @@ Tensor& mkldnn_transpose_(Tensor& self, int64_t dim0, int64_t dim1) {
   AT_ERROR("mkldnn_transpose_: ATen not compiled with MKLDNN support");
 }
 
+Tensor mkldnn_cat(TensorList tensors, int64_t dim) {
+  AT_ERROR("mkldnn_cat: ATen not compiled with MKLDNN support");
+}
+
 } // namespace native
 } // namespace at
 
@@ -38,9 +42,18 @@ Tensor& mkldnn_transpose_(Tensor& self, int64_t dim0, int64_t dim1) {
 namespace at {
 namespace native {
 
+// A tensor in a plain format is laid out like a contiguous dense tensor, so it
+// can be viewed with any sizes of the same number of elements. Blocked formats
+// need a reorder, which only reshape does.
 Tensor mkldnn_view(const Tensor& self, IntArrayRef size) {
-  AT_ERROR(
-      "Currently Mkldnn tensor does not support view. Change to use reshape instead");
+  const ideep::tensor& x = itensor_from_mkldnn(self);
+  TORCH_CHECK(
+      x.is_public_format(),
+      "Mkldnn tensor in a blocked format does not support view. Change to use reshape instead");
+  auto inferred_size = at::infer_size(size, self.numel());
+  ideep::tensor y{x};
+  y.reshape(inferred_size);
+  return new_with_itensor_mkldnn(std::move(y), self.options());
 }
 
 Tensor mkldnn_reshape(const Tensor& self, IntArrayRef size) {
@@ -79,6 +92,23 @@ Tensor& mkldnn_transpose_(Tensor& self, int64_t dim0, int64_t dim1) {
   AT_ERROR("mkldnn_transpose_: in-place mkldnn operations are not supported yet");
 }
 
+Tensor mkldnn_cat(TensorList tensors, int64_t dim) {
+  TORCH_CHECK(!tensors.empty(), "mkldnn_cat: expected a non-empty list of Tensors");
+  std::vector<ideep::tensor> inputs;
+  inputs.reserve(tensors.size());
+  for (const auto& t : tensors) {
+    TORCH_CHECK(
+        t.is_mkldnn() && t.scalar_type() == tensors[0].scalar_type(),
+        "mkldnn_cat: expected all tensors to be mkldnn tensors of type ",
+        tensors[0].scalar_type());
+    inputs.emplace_back(itensor_from_mkldnn(t));
+  }
+  dim = maybe_wrap_dim(dim, tensors[0].dim());
+  ideep::tensor y;
+  ideep::concat::compute(inputs, dim, /*add_axis=*/false, y);
+  return new_with_itensor_mkldnn(std::move(y), tensors[0].options());
+}
+
 } // namespace native
 } // namespace at
 
@@ -15,6 +15,22 @@ Tensor& mkldnn_sigmoid_(Tensor& self) {
   AT_ERROR("mkldnn_sigmoid_: ATen not compiled with MKLDNN support");
 }
 
+Tensor mkldnn_tanh(const Tensor& self) {
+  AT_ERROR("mkldnn_tanh: ATen not compiled with MKLDNN support");
+}
+
+Tensor& mkldnn_tanh_(Tensor& self) {
+  AT_ERROR("mkldnn_tanh_: ATen not compiled with MKLDNN support");
+}
+
+Tensor mkldnn_clamp(const Tensor& self, optional<Scalar> min, optional<Scalar> max) {
+  AT_ERROR("mkldnn_clamp: ATen not compiled with MKLDNN support");
+}
+
+Tensor& mkldnn_clamp_(Tensor& self, optional<Scalar> min, optional<Scalar> max) {
+  AT_ERROR("mkldnn_clamp_: ATen not compiled with MKLDNN support");
+}
+
 } // namespace native
 } // namespace at
 
@@ -22,6 +38,9 @@ Tensor& mkldnn_sigmoid_(Tensor& self) {
 
 #include <ATen/native/mkldnn/MKLDNNCommon.h>
 
+#include <limits>
+#include <utility>
+
 namespace at {
 namespace native {
 
@@ -40,6 +59,52 @@ Tensor& mkldnn_sigmoid_(Tensor& self) {
   return self;
 }
 
+Tensor mkldnn_tanh(const Tensor& self) {
+  ideep::tensor& x = itensor_from_mkldnn(self);
+  ideep::tensor y;
+  ideep::eltwise_forward::compute(
+      x, y, ideep::algorithm::eltwise_tanh, ideep::prop_kind::forward);
+  return new_with_itensor_mkldnn(std::move(y), self.options());
+}
+
+Tensor& mkldnn_tanh_(Tensor& self) {
+  ideep::tensor& x = itensor_from_mkldnn(self);
+  ideep::eltwise_forward::compute(
+      x, x, ideep::algorithm::eltwise_tanh, ideep::prop_kind::forward);
+  return self;
+}
+
+namespace {
+
+// eltwise_clip clamps to [alpha, beta]; a missing bound is infinite.
+std::pair<float, float> clip_bounds(optional<Scalar> min, optional<Scalar> max) {
+  TORCH_CHECK(min || max, "At least one of 'min' or 'max' must not be None");
+  return {
+      min ? min->to<float>() : -std::numeric_limits<float>::infinity(),
+      max ? max->to<float>() : std::numeric_limits<float>::infinity()};
+}
+
+} // namespace
+
+Tensor mkldnn_clamp(const Tensor& self, optional<Scalar> min, optional<Scalar> max) {
+  const auto bounds = clip_bounds(min, max);
+  ideep::tensor& x = itensor_from_mkldnn(self);
+  ideep::tensor y;
+  ideep::eltwise_forward::compute(
+      x, y, ideep::algorithm::eltwise_clip, ideep::prop_kind::forward,
+      /*alpha*/ bounds.first, /*beta*/ bounds.second);
+  return new_with_itensor_mkldnn(std::move(y), self.options());
+}
+
+Tensor& mkldnn_clamp_(Tensor& self, optional<Scalar> min, optional<Scalar> max) {
+  const auto bounds = clip_bounds(min, max);
+  ideep::tensor& x = itensor_from_mkldnn(self);
+  ideep::eltwise_forward::compute(
+      x, x, ideep::algorithm::eltwise_clip, ideep::prop_kind::forward,
+      /*alpha*/ bounds.first, /*beta*/ bounds.second);
+  return self;
+}
+
 } // namespace native
 } // namespace at
 
@@ -11,6 +11,8 @@
 #include <c10/core/QScheme.h>
 #include <c10/core/TensorOptions.h>
 
+#include <cstring>
+
 #include <torch/custom_class.h>
 
 #include <ATen/native/quantized/cpu/packed_params.h>
@@ -204,12 +206,275 @@ Tensor ConvertToChannelsLast3dTensor(const Tensor& src) {
   return dst;
 }
 
+namespace {
+
+// Packed weights hold about as much memory as the weights and biases they
+// were made from.
+constexpr int64_t kDefaultPrepackCacheMaxBytes = 256 * 1024 * 1024;
+
+int64_t DoubleBits(double value) {
+  int64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+void AppendTensorToKey(PrepackedWeightCache::Key& key, const Tensor& tensor) {
+  key.push_back(reinterpret_cast<intptr_t>(tensor.data_ptr()));
+  key.push_back(tensor.unsafeGetTensorImpl()->version_counter().current_version());
+  key.push_back(static_cast<int64_t>(tensor.scalar_type()));
+  key.push_back(tensor.dim());
+  key.insert(key.end(), tensor.sizes().begin(), tensor.sizes().end());
+  key.insert(key.end(), tensor.strides().begin(), tensor.strides().end());
+}
+
+c10::weak_intrusive_ptr<c10::StorageImpl> WeakStorage(const Tensor& tensor) {
+  return c10::weak_intrusive_ptr<c10::StorageImpl>(
+      c10::intrusive_ptr<c10::StorageImpl>::unsafe_reclaim_from_nonowning(
+          tensor.storage().unsafeGetStorageImpl()));
+}
+
+bool IsStorageOf(
+    const c10::weak_intrusive_ptr<c10::StorageImpl>& storage,
+    const Tensor& tensor) {
+  return storage.lock().get() == tensor.storage().unsafeGetStorageImpl();
+}
+
+bool HasBias(const c10::optional<Tensor>& bias) {
+  return bias.has_value() && bias->defined();
+}
+
+} // namespace
+
+PrepackedWeightCache::PrepackedWeightCache()
+    : max_bytes_(kDefaultPrepackCacheMaxBytes) {}
+
+PrepackedWeightCache& PrepackedWeightCache::get() {
+  static PrepackedWeightCache cache;
+  return cache;
+}
+
+c10::intrusive_ptr<torch::jit::CustomClassHolder> PrepackedWeightCache::find(
+    const Key& key,
+    const Tensor& weight,
+    const c10::optional<Tensor>& bias) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    stats_.misses++;
+    return c10::intrusive_ptr<torch::jit::CustomClassHolder>();
+  }
+  const Entry& entry = it->second;
+  if (!IsStorageOf(entry.weight_storage, weight) ||
+      (entry.bias_storage.has_value() &&
+       !IsStorageOf(*entry.bias_storage, *bias))) {
+    erase(it);
+    stats_.misses++;
+    return c10::intrusive_ptr<torch::jit::CustomClassHolder>();
+  }
+  lru_list_.splice(lru_list_.begin(), lru_list_, entry.lru_position);
+  stats_.hits++;
+  return entry.packed;
+}
+
+void PrepackedWeightCache::insert(
+    Key key,
+    const Tensor& weight,
+    const c10::optional<Tensor>& bias,
+    c10::intrusive_ptr<torch::jit::CustomClassHolder> packed) {
+  int64_t nbytes = weight.numel() * weight.element_size();
+  if (HasBias(bias)) {
+    nbytes += bias->numel() * bias->element_size();
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (nbytes > max_bytes_ || entries_.count(key) > 0) {
+    return;
+  }
+  // Drop the entries of weights that have been freed first.
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    auto next = std::next(it);
+    if (it->second.weight_storage.expired() ||
+        (it->second.bias_storage.has_value() &&
+         it->second.bias_storage->expired())) {
+      erase(it);
+    }
+    it = next;
+  }
+  evict_to(max_bytes_ - nbytes);
+
+  c10::optional<c10::weak_intrusive_ptr<c10::StorageImpl>> bias_storage;
+  if (HasBias(bias)) {
+    bias_storage = WeakStorage(*bias);
+  }
+  lru_list_.push_front(key);
+  Entry entry{
+      std::move(packed),
+      WeakStorage(weight),
+      std::move(bias_storage),
+      nbytes,
+      lru_list_.begin()};
+  entries_.emplace(std::move(key), std::move(entry));
+  bytes_ += nbytes;
+}
+
+void PrepackedWeightCache::erase(
+    std::unordered_map<Key, Entry, KeyHash>::iterator it) {
+  bytes_ -= it->second.nbytes;
+  lru_list_.erase(it->second.lru_position);
+  entries_.erase(it);
+}
+
+void PrepackedWeightCache::evict_to(int64_t max_bytes) {
+  while (bytes_ > max_bytes && !lru_list_.empty()) {
+    erase(entries_.find(lru_list_.back()));
+    stats_.evictions++;
+  }
+}
+
+int64_t PrepackedWeightCache::size() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return entries_.size();
+}
+
+int64_t PrepackedWeightCache::bytes() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return bytes_;
+}
+
+int64_t PrepackedWeightCache::max_bytes() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return max_bytes_;
+}
+
+void PrepackedWeightCache::set_max_bytes(int64_t max_bytes) {
+  TORCH_CHECK(
+      max_bytes >= 0,
+      "quantized prepack cache max_bytes must be non-negative, but got ",
+      max_bytes);
+  std::lock_guard<std::mutex> guard(mutex_);
+  max_bytes_ = max_bytes;
+  evict_to(max_bytes_);
+}
+
+void PrepackedWeightCache::clear() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  entries_.clear();
+  lru_list_.clear();
+  bytes_ = 0;
+}
+
+PrepackedWeightCache::Stats PrepackedWeightCache::stats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return stats_;
+}
+
+void PrepackedWeightCache::reset_stats() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  stats_ = Stats();
+}
+
+PrepackedWeightCache::Key MakePrepackCacheKey(
+    PrepackKind kind,
+    const Tensor& weight,
+    const c10::optional<Tensor>& bias) {
+  PrepackedWeightCache::Key key{static_cast<int64_t>(kind)};
+  AppendTensorToKey(key, weight);
+  const auto qtype = weight.qscheme();
+  key.push_back(static_cast<int64_t>(qtype));
+  if (qtype == c10::kPerTensorAffine) {
+    key.push_back(DoubleBits(weight.q_scale()));
+    key.push_back(weight.q_zero_point());
+  } else if (qtype == c10::kPerChannelAffine) {
+    // The parameters are few compared to the weight, so the key keeps their
+    // values rather than relying on the pointers of the quantizer's tensors.
+    key.push_back(weight.q_per_channel_axis());
+    const auto scales = weight.q_per_channel_scales().to(kDouble).contiguous();
+    const auto zero_points =
+        weight.q_per_channel_zero_points().to(kLong).contiguous();
+    const double* scales_data = scales.data_ptr<double>();
+    for (int64_t i = 0; i < scales.numel(); ++i) {
+      key.push_back(DoubleBits(scales_data[i]));
+    }
+    key.insert(
+        key.end(),
+        zero_points.data_ptr<int64_t>(),
+        zero_points.data_ptr<int64_t>() + zero_points.numel());
+  }
+  key.push_back(HasBias(bias));
+  if (HasBias(bias)) {
+    AppendTensorToKey(key, *bias);
+  }
+  return key;
+}
+
 } // namespace fbgemm_utils
 } // namespace native
 } // namespace at
 
 #endif // USE_FBGEMM
 
+namespace at {
+namespace native {
+
+// The cache only exists with FBGEMM; without it, it is always empty and its
+// maximum size is 0.
+int64_t _quantized_get_prepack_cache_size() {
+#ifdef USE_FBGEMM
+  return fbgemm_utils::PrepackedWeightCache::get().size();
+#else
+  return 0;
+#endif
+}
+
+int64_t _quantized_get_prepack_cache_bytes() {
+#ifdef USE_FBGEMM
+  return fbgemm_utils::PrepackedWeightCache::get().bytes();
+#else
+  return 0;
+#endif
+}
+
+int64_t _quantized_get_prepack_cache_max_bytes() {
+#ifdef USE_FBGEMM
+  return fbgemm_utils::PrepackedWeightCache::get().max_bytes();
+#else
+  return 0;
+#endif
+}
+
+void _quantized_set_prepack_cache_max_bytes(int64_t max_bytes) {
+#ifdef USE_FBGEMM
+  fbgemm_utils::PrepackedWeightCache::get().set_max_bytes(max_bytes);
+#else
+  TORCH_CHECK(
+      max_bytes == 0,
+      "quantized prepack cache: PyTorch was built without FBGEMM");
+#endif
+}
+
+void _quantized_clear_prepack_cache() {
+#ifdef USE_FBGEMM
+  fbgemm_utils::PrepackedWeightCache::get().clear();
+#endif
+}
+
+std::tuple<int64_t, int64_t, int64_t> _quantized_get_prepack_cache_stats() {
+#ifdef USE_FBGEMM
+  const auto stats = fbgemm_utils::PrepackedWeightCache::get().stats();
+  return std::make_tuple(stats.hits, stats.misses, stats.evictions);
+#else
+  return std::make_tuple(0, 0, 0);
+#endif
+}
+
+void _quantized_reset_prepack_cache_stats() {
+#ifdef USE_FBGEMM
+  fbgemm_utils::PrepackedWeightCache::get().reset_stats();
+#endif
+}
+
+} // namespace native
+} // namespace at
+
 template <int kSpatialDim = 2>
 CAFFE2_API torch::jit::class_<ConvPackedParamsBase<kSpatialDim>> register_conv_params() {
   using SerializationType = std::tuple<
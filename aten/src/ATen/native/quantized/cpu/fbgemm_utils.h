@@ -9,6 +9,12 @@
 #include <ATen/native/quantized/cpu/conv_packed_params.h>
 #include <ATen/native/quantized/cpu/packed_params.h>
 #include <c10/core/QScheme.h>
+#include <c10/util/intrusive_ptr.h>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 
 // The struct for the packed weight matrix (PackBMatrix) and the corresponding
@@ -53,6 +59,9 @@ struct CAFFE2_API PackedLinearWeight : public LinearPackedParamsBase {
   at::Tensor apply_dynamic(at::Tensor input) override;
   at::Tensor apply_dynamic_relu(at::Tensor input) override;
 
+  at::Tensor apply_dynamic_per_row(at::Tensor input) override;
+  at::Tensor apply_dynamic_per_row_relu(at::Tensor input) override;
+
   std::tuple<at::Tensor, c10::optional<at::Tensor>> unpack() override;
 
   c10::optional<at::Tensor> bias() override {
@@ -72,6 +81,9 @@ struct CAFFE2_API PackedLinearWeight : public LinearPackedParamsBase {
 
   template <bool ReluFused>
   at::Tensor apply_dynamic_impl(at::Tensor input);
+
+  template <bool ReluFused>
+  at::Tensor apply_dynamic_per_row_impl(at::Tensor input);
 };
 
 struct CAFFE2_API PackedLinearWeightFp16 : public LinearPackedParamsBase {
@@ -272,6 +284,119 @@ Tensor MakeEmptyPerChannelAffineQuantizedChannelsLast3dTensor(
 
 Tensor ConvertToChannelsLast3dTensor(const Tensor& src);
 
+// Process-wide cache of prepacked weights, so that packing the same quantized
+// weight again, e.g., when the same state dict is loaded into a new copy of a
+// model, reuses the packed weight instead of repacking it.
+//
+// Entries are keyed by the data pointers and versions of the weight and bias,
+// and by everything else the packed weight depends on: sizes, strides,
+// quantization parameters and, for convolutions, the convolution arguments;
+// see MakePrepackCacheKey. An entry only holds weak references to the storages
+// of the weight and bias, and a lookup checks that they are still the storages
+// that were packed, as a freed data pointer may be reused by a new tensor.
+// Entries whose storages are gone are dropped, and the least recently used
+// entries are evicted to keep the packed weights under max_bytes.
+class CAFFE2_API PrepackedWeightCache {
+ public:
+  using Key = std::vector<int64_t>;
+
+  struct Stats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t evictions = 0;
+  };
+
+  static PrepackedWeightCache& get();
+
+  // Returns the cached packed weight for key, or calls prepack() and caches
+  // its result. T is the class the result of prepack() is returned as; the
+  // key must identify it, see PrepackKind.
+  template <typename T, typename Prepack>
+  c10::intrusive_ptr<T> lookupOrPrepack(
+      Key key,
+      const Tensor& weight,
+      const c10::optional<Tensor>& bias,
+      Prepack prepack) {
+    if (max_bytes() == 0) {
+      return prepack();
+    }
+    auto cached = find(key, weight, bias);
+    if (cached) {
+      return c10::intrusive_ptr<T>::unsafe_reclaim_from_nonowning(
+          static_cast<T*>(cached.get()));
+    }
+    c10::intrusive_ptr<T> packed = prepack();
+    insert(std::move(key), weight, bias, packed);
+    return packed;
+  }
+
+  // Number of cached packed weights
+  int64_t size() const;
+  // Approximate memory used by the cached packed weights, in bytes
+  int64_t bytes() const;
+  int64_t max_bytes() const;
+  // A maximum of 0 disables the cache.
+  void set_max_bytes(int64_t max_bytes);
+  void clear();
+  Stats stats() const;
+  void reset_stats();
+
+ private:
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      size_t seed = key.size();
+      for (auto v : key) {
+        seed ^= std::hash<int64_t>()(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      }
+      return seed;
+    }
+  };
+
+  struct Entry {
+    c10::intrusive_ptr<torch::jit::CustomClassHolder> packed;
+    c10::weak_intrusive_ptr<c10::StorageImpl> weight_storage;
+    c10::optional<c10::weak_intrusive_ptr<c10::StorageImpl>> bias_storage;
+    int64_t nbytes;
+    std::list<Key>::iterator lru_position;
+  };
+
+  PrepackedWeightCache();
+
+  c10::intrusive_ptr<torch::jit::CustomClassHolder> find(
+      const Key& key,
+      const Tensor& weight,
+      const c10::optional<Tensor>& bias);
+  void insert(
+      Key key,
+      const Tensor& weight,
+      const c10::optional<Tensor>& bias,
+      c10::intrusive_ptr<torch::jit::CustomClassHolder> packed);
+  // The functions below expect mutex_ to be held.
+  void erase(std::unordered_map<Key, Entry, KeyHash>::iterator it);
+  void evict_to(int64_t max_bytes);
+
+  mutable std::mutex mutex_;
+  std::unordered_map<Key, Entry, KeyHash> entries_;
+  // Keys of entries_, most recently used first
+  std::list<Key> lru_list_;
+  int64_t bytes_ = 0;
+  int64_t max_bytes_;
+  Stats stats_;
+};
+
+enum class PrepackKind : int64_t {
+  Linear,
+  Conv2d,
+  Conv3d,
+};
+
+// The key of a packed weight that depends on weight and bias only. Callers
+// append any other arguments of the prepack function.
+CAFFE2_API PrepackedWeightCache::Key MakePrepackCacheKey(
+    PrepackKind kind,
+    const Tensor& weight,
+    const c10::optional<Tensor>& bias);
+
 } // namespace fbgemm_utils
 } // namespace native
 } // namespace at
@@ -3,9 +3,12 @@
 #include <ATen/Parallel.h>
 #include <ATen/native/SortingUtils.h>
 #include <ATen/native/TensorIterator.h>
+#include <ATen/native/SharedReduceOps.h>
 #include <ATen/native/UpSample.h>
 #include <ATen/native/cpu/Loops.h>
+#include <ATen/native/cpu/Reduce.h>
 #include <ATen/native/quantized/affine_quantizer.h>
+#include <ATen/native/quantized/fake_quant_affine.h>
 #include <ATen/native/quantized/cpu/quantized_ops.h>
 
 #include <cmath>
@@ -1905,6 +1908,68 @@ void fake_quant_grad_per_channel_cpu(
       });
 }
 
+void fake_quantize_tensor_cachemask_kernel(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    const Tensor& sc,
+    const Tensor& z_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  const float scale = sc.item<float>();
+  const int64_t zero_point = z_point.item<int64_t>();
+  const float inv_scale = 1.0f / scale;
+  const float* input_data = input.data_ptr<float>();
+  float* output_data = output.data_ptr<float>();
+  bool* mask_data = mask.data_ptr<bool>();
+  at::parallel_for(
+      0, input.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const int64_t xq = static_cast<int64_t>(
+              zero_point + std::nearbyint(input_data[i] * inv_scale));
+          output_data[i] =
+              (std::min(std::max(xq, quant_min), quant_max) - zero_point) *
+              scale;
+          mask_data[i] = xq >= quant_min && xq <= quant_max;
+        }
+      });
+}
+
+void fake_quant_min_max_cpu(TensorIterator& iter) {
+  binary_kernel_reduce(
+      iter,
+      MinMaxOps<float, std::tuple<float, float>>{},
+      std::pair<float, float>(
+          std::numeric_limits<float>::infinity(),
+          -std::numeric_limits<float>::infinity()));
+}
+
+void fake_quant_update_qparams_cpu(
+    Tensor& running_min,
+    Tensor& running_max,
+    Tensor& sc,
+    Tensor& z_point,
+    const Tensor& x_min,
+    const Tensor& x_max,
+    float averaging_const,
+    int64_t quant_min,
+    int64_t quant_max,
+    bool init,
+    bool symmetric_quant) {
+  update_moving_average_qparams(
+      x_min.item<float>(),
+      x_max.item<float>(),
+      running_min.data_ptr<float>(),
+      running_max.data_ptr<float>(),
+      sc.data_ptr<float>(),
+      z_point.data_ptr<int64_t>(),
+      averaging_const,
+      quant_min,
+      quant_max,
+      init,
+      symmetric_quant);
+}
+
 // Assumes X is composed of M groups of N elements. Normalizes each of the
 // groups and optionally applies affine scaling. Useful for LayerNorm,
 // GroupNorm, InstanceNorm.
@@ -2343,6 +2408,9 @@ REGISTER_DISPATCH(qbatch_norm_stub, &q_batch_norm_kernel<false>);
 REGISTER_DISPATCH(qbatch_norm_relu_stub, &q_batch_norm_kernel<true>);
 REGISTER_DISPATCH(fake_quant_tensor_stub, &fake_quantize_tensor_kernel);
 REGISTER_DISPATCH(fake_quant_grad_tensor_stub, &fake_quantize_grad_tensor_kernel);
+REGISTER_DISPATCH(fake_quant_tensor_cachemask_stub, &fake_quantize_tensor_cachemask_kernel);
+REGISTER_DISPATCH(fake_quant_min_max_stub, &fake_quant_min_max_cpu);
+REGISTER_DISPATCH(fake_quant_update_qparams_stub, &fake_quant_update_qparams_cpu);
 REGISTER_DISPATCH(fake_quant_per_channel_stub, &fake_quant_per_channel_cpu);
 REGISTER_DISPATCH(fake_quant_grad_per_channel_stub, &fake_quant_grad_per_channel_cpu);
 REGISTER_DISPATCH(
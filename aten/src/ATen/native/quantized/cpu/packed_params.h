@@ -15,6 +15,20 @@ struct LinearPackedParamsBase : public torch::jit::CustomClassHolder {
   virtual at::Tensor apply_dynamic(at::Tensor input) = 0;
   virtual at::Tensor apply_dynamic_relu(at::Tensor input) = 0;
 
+  // Dynamic linear that quantizes every row of the input (every token of a
+  // sequence) with its own scale and zero point instead of one for the whole
+  // input, so that rows with outliers don't cost the others their precision.
+  virtual at::Tensor apply_dynamic_per_row(at::Tensor input) {
+    throw std::runtime_error(
+        "apply_dynamic_per_row is not implemented for this packed "
+        "parameter type");
+  }
+  virtual at::Tensor apply_dynamic_per_row_relu(at::Tensor input) {
+    throw std::runtime_error(
+        "apply_dynamic_per_row_relu is not implemented for this packed "
+        "parameter type");
+  }
+
   virtual std::tuple<at::Tensor, c10::optional<at::Tensor>> unpack() = 0;
 
   virtual c10::optional<at::Tensor> bias() = 0;
@@ -524,45 +524,18 @@ at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_impl(
 
   double act_input_scale = act_nhwc.q_scale();
 
-  // Re-quantizing the bias based on input scale and weight scale.
+  TORCH_INTERNAL_ASSERT(pack_w != nullptr, "Packed Weights are NULL");
+  // Re-quantizing the bias based on input scale and weight scale. The weights
+  // were packed by prepack, so only the biases in them are updated.
   if (!input_scale.has_value() || input_scale.value() != act_input_scale) {
-    // Get the original weight and adjust it to uint8 from int8
-    auto weight_contig =
-        orig_weight.contiguous(c10::MemoryFormat::ChannelsLast);
-    auto bias_fp32 = bias;
-    int8_t* w_data =
-        reinterpret_cast<int8_t*>(weight_contig.template data_ptr<c10::qint8>());
-    at::Tensor qnnp_weight = at::_empty_affine_quantized(
-        weight_contig.sizes(),
-        at::device(c10::kCPU)
-            .dtype(c10::kQUInt8)
-            .memory_format(c10::MemoryFormat::ChannelsLast),
-        kernel_scale,
-        kernel_zp,
-        c10::nullopt);
-    auto* qnnp_w_data = qnnp_weight.template data_ptr<c10::quint8>();
-    auto wt_numel = weight_contig.numel();
-    for (int i = 0; i < wt_numel; ++i) {
-      qnnp_w_data[i] = static_cast<c10::quint8>(w_data[i] + 128);
-    }
     // Original bias was float, so we requantize it here.
     auto qbias = at::quantize_per_tensor(
-        bias_fp32, kernel_scale * act_input_scale, 0, c10::kQInt32);
-    // Update the input scale to not pack again.
-    input_scale = act_input_scale;
-    w.reset();
-    w = std::make_unique<qnnpack::PrePackConvWeights>(
-        conv_p,
-        reinterpret_cast<uint8_t*>(qnnp_w_data),
+        bias, kernel_scale * act_input_scale, 0, c10::kQInt32);
+    pack_w->updateBias(
         reinterpret_cast<int32_t*>(qbias.template data_ptr<c10::qint32>()));
-    pack_w = w.get();
-    if (at::globalContext().releaseWeightsWhenPrepacking()) {
-        // On mobile, we release the original weight by resetting the intrusive_ptr.
-        // Calling unpack after this will throw an assertion.
-        orig_weight.reset();
-    }
+    // Update the input scale to not requantize again.
+    input_scale = act_input_scale;
   }
-  TORCH_INTERNAL_ASSERT(pack_w != nullptr, "Packed Weights are NULL");
   const auto output_shape = MakeConvOutputShape<kSpatialDim>(
       N, M, {H, W}, kernel, stride_, padding_, dilation_);
   if (act_nhwc.numel() > 0) {
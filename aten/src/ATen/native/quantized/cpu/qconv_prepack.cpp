@@ -11,22 +11,15 @@
 #include <torch/library.h>
 
 #ifdef USE_FBGEMM
+namespace {
 template <int kSpatialDim>
-c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> PackedConvWeight<
-    kSpatialDim>::
-    prepack(
-        at::Tensor weight,
-        c10::optional<at::Tensor> bias,
-        torch::List<int64_t> stride,
-        torch::List<int64_t> padding,
-        torch::List<int64_t> dilation,
-        int64_t groups) {
-  TORCH_CHECK(
-      weight.ndimension() == kSpatialDim + 2,
-      "Weights are expected to have ",
-      kSpatialDim + 2,
-      " dimensions");
-
+c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> PackConvWeight(
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias,
+    const torch::List<int64_t>& stride,
+    const torch::List<int64_t>& padding,
+    const torch::List<int64_t>& dilation,
+    int64_t groups) {
   TORCH_CHECK(
       stride.size() == kSpatialDim,
       "stride should contain ",
@@ -154,6 +147,43 @@ c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> PackedConvWeight<
 
   return ret_ptr;
 }
+} // namespace
+
+template <int kSpatialDim>
+c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> PackedConvWeight<
+    kSpatialDim>::
+    prepack(
+        at::Tensor weight,
+        c10::optional<at::Tensor> bias,
+        torch::List<int64_t> stride,
+        torch::List<int64_t> padding,
+        torch::List<int64_t> dilation,
+        int64_t groups) {
+  TORCH_CHECK(
+      weight.ndimension() == kSpatialDim + 2,
+      "Weights are expected to have ",
+      kSpatialDim + 2,
+      " dimensions");
+
+  auto key = at::native::fbgemm_utils::MakePrepackCacheKey(
+      kSpatialDim == 2 ? at::native::fbgemm_utils::PrepackKind::Conv2d
+                       : at::native::fbgemm_utils::PrepackKind::Conv3d,
+      weight,
+      bias);
+  for (const auto& arg : {stride, padding, dilation}) {
+    key.push_back(arg.size());
+    for (int64_t v : arg) {
+      key.push_back(v);
+    }
+  }
+  key.push_back(groups);
+  return at::native::fbgemm_utils::PrepackedWeightCache::get()
+      .lookupOrPrepack<ConvPackedParamsBase<kSpatialDim>>(
+          std::move(key), weight, bias, [&]() {
+            return PackConvWeight<kSpatialDim>(
+                weight, bias, stride, padding, dilation, groups);
+          });
+}
 
 #endif // USE_FBGEMM
 
@@ -221,6 +251,10 @@ c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> PackedConvWeightsQnnp<
   uint32_t dilation_h = dilation[0];
   uint32_t dilation_w = dilation[1];
 
+  // Adjust weight zero point, similar to weight data.
+  const auto kernel_zp = weight.q_zero_point() + 128;
+  const auto kernel_scale = weight.q_scale();
+
   qnnpack::conv_param_t conv_p(
       {kernel_w, kernel_h},
       {stride_w, stride_h},
@@ -230,22 +264,45 @@ c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> PackedConvWeightsQnnp<
       groups,
       in_ch,
       out_ch,
-      weight.q_zero_point(),
-      weight.q_scale(),
+      kernel_zp,
+      kernel_scale,
       std::numeric_limits<uint8_t>::min(),
       std::numeric_limits<uint8_t>::max(),
       /*transpose=*/false);
 
   auto weight_contig = weight.contiguous(c10::MemoryFormat::ChannelsLast);
 
-  // We set the pre-packed conv weights to nullptr below as we call pre-pack
-  // during the first invocation of operator run. Refer to qconv.cpp for more
-  // details. TODO Update to actually call pre-pack here once bias is removed
-  // from pre-packing step.
+  // Adjust the weight to uint8 from int8 and pack it now, so that the first
+  // run doesn't have to. The bias is quantized with the input scale, which is
+  // only known at run time, so it is packed as zeros and patched in by
+  // qconv.cpp.
+  int8_t* w_data =
+      reinterpret_cast<int8_t*>(weight_contig.template data_ptr<c10::qint8>());
+  at::Tensor qnnp_weight = at::_empty_affine_quantized(
+      weight_contig.sizes(),
+      at::device(c10::kCPU)
+          .dtype(c10::kQUInt8)
+          .memory_format(c10::MemoryFormat::ChannelsLast),
+      kernel_scale,
+      kernel_zp,
+      c10::nullopt);
+  auto* qnnp_w_data = qnnp_weight.template data_ptr<c10::quint8>();
+  auto wt_numel = weight_contig.numel();
+  for (int i = 0; i < wt_numel; ++i) {
+    qnnp_w_data[i] = static_cast<c10::quint8>(w_data[i] + 128);
+  }
+  auto pack_w = std::make_unique<qnnpack::PrePackConvWeights>(
+      conv_p, reinterpret_cast<uint8_t*>(qnnp_w_data), nullptr);
+  if (at::globalContext().releaseWeightsWhenPrepacking()) {
+    // On mobile, we release the original weight by resetting the intrusive_ptr.
+    // Calling unpack after this will throw an assertion.
+    weight_contig.reset();
+  }
+
   c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> ret_ptr =
       c10::make_intrusive<PackedConvWeightsQnnp<kSpatialDim>>(
           PackedConvWeightsQnnp<kSpatialDim>{
-              nullptr, /* PrePackConvWeights */
+              std::move(pack_w), /* PrePackConvWeights */
               weight_contig, /* int8_t weight */
               bias_fp32.contiguous(), /* fp32 bias */
               stride,
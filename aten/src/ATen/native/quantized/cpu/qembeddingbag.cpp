@@ -0,0 +1,369 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/quantized/cpu/qembeddingbag.h>
+#include <torch/library.h>
+
+#ifdef USE_FBGEMM
+#include <fbgemm/Fbgemm.h>
+#elif !defined(C10_MOBILE)
+#include <caffe2/perfkernels/fused_8bit_rowwise_embedding_lookup_idx.h>
+#include <caffe2/perfkernels/fused_nbit_rowwise_embedding_lookup_idx.h>
+#endif
+
+#include <cstring>
+
+namespace at {
+namespace native {
+
+namespace {
+
+constexpr int64_t MODE_SUM = 0;
+constexpr int64_t MODE_MEAN = 1;
+
+// Bags are split between threads in chunks that dequantize about GRAIN_SIZE
+// values each.
+int64_t bag_grain_size(int64_t num_indices, int64_t num_bags, int64_t embedding_dim) {
+  const int64_t indices_per_bag = std::max<int64_t>(1, num_indices / std::max<int64_t>(1, num_bags));
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / (indices_per_bag * embedding_dim));
+}
+
+// Portable reduction over bags [begin, end) for tables with 8 / bit_rate
+// values per byte, used when no optimized kernel is available.
+template <typename scale_bias_t>
+void rowwise_embedding_bag_reference(
+    int64_t bit_rate,
+    const uint8_t* weight_data,
+    int64_t num_rows,
+    int64_t packed_cols,
+    int64_t embedding_dim,
+    const int64_t* indices_data,
+    const int64_t* offsets_data,
+    const float* per_sample_weights_data,
+    bool normalize_by_lengths,
+    int64_t begin,
+    int64_t end,
+    float* output_data) {
+  const int64_t elements_per_byte = nbit_elements_per_byte(bit_rate);
+  const int64_t value_bytes = embedding_dim / elements_per_byte;
+  const int64_t mask = (1 << bit_rate) - 1;
+  for (int64_t bag = begin; bag < end; bag++) {
+    float* out = output_data + bag * embedding_dim;
+    std::fill_n(out, embedding_dim, 0.f);
+    for (int64_t i = offsets_data[bag]; i < offsets_data[bag + 1]; i++) {
+      const int64_t index = indices_data[i];
+      TORCH_CHECK(
+          index >= 0 && index < num_rows,
+          "embedding_bag: index ", index, " is out of bounds for a table with ",
+          num_rows, " rows");
+      const uint8_t* row = weight_data + index * packed_cols;
+      scale_bias_t scale_bias[2];
+      std::memcpy(scale_bias, row + value_bytes, sizeof(scale_bias));
+      const float weight = per_sample_weights_data ? per_sample_weights_data[i] : 1.f;
+      const float scale = weight * static_cast<float>(scale_bias[0]);
+      const float bias = weight * static_cast<float>(scale_bias[1]);
+      for (int64_t d = 0; d < embedding_dim; d++) {
+        const int64_t quantized =
+            (row[d / elements_per_byte] >> ((d % elements_per_byte) * bit_rate)) & mask;
+        out[d] += scale * quantized + bias;
+      }
+    }
+    const int64_t length = offsets_data[bag + 1] - offsets_data[bag];
+    if (normalize_by_lengths && length > 0) {
+      const float scale = 1.f / length;
+      for (int64_t d = 0; d < embedding_dim; d++) {
+        out[d] *= scale;
+      }
+    }
+  }
+}
+
+// Validates the arguments shared by the byte and N-bit ops and returns the
+// start of every bag followed by the end of the last one. 2-d indices are
+// bags of equal length, as in torch.nn.functional.embedding_bag.
+Tensor rowwise_embedding_bag_offsets(
+    const Tensor& weight,
+    Tensor& indices,
+    const c10::optional<Tensor>& offsets,
+    bool sparse,
+    int64_t mode,
+    const c10::optional<Tensor>& per_sample_weights,
+    bool include_last_offset) {
+  TORCH_CHECK(
+      weight.dim() == 2 && weight.scalar_type() == kByte,
+      "embedding_bag: expected a 2-d uint8 packed table");
+  TORCH_CHECK(
+      indices.scalar_type() == kLong,
+      "embedding_bag: expected int64 indices, got ", indices.scalar_type());
+  TORCH_CHECK(
+      mode == MODE_SUM || mode == MODE_MEAN,
+      "embedding_bag: row-wise quantized tables only support mode 'sum' and 'mean'");
+  TORCH_CHECK(!sparse, "embedding_bag: row-wise quantized tables do not support sparse gradients");
+
+  Tensor bag_offsets;
+  if (indices.dim() == 2) {
+    TORCH_CHECK(
+        !offsets.has_value() || !offsets->defined(),
+        "embedding_bag: offsets have to be None if indices are 2-d");
+    const int64_t num_bags = indices.size(0);
+    bag_offsets = at::arange(0, (num_bags + 1) * indices.size(1), indices.size(1), indices.options());
+    indices = indices.reshape({-1});
+  } else {
+    TORCH_CHECK(
+        indices.dim() == 1,
+        "embedding_bag: expected 1-d or 2-d indices, got ", indices.dim(), "-d");
+    TORCH_CHECK(
+        offsets.has_value() && offsets->defined() && offsets->dim() == 1,
+        "embedding_bag: 1-d indices need 1-d offsets");
+    TORCH_CHECK(
+        offsets->scalar_type() == kLong,
+        "embedding_bag: expected int64 offsets, got ", offsets->scalar_type());
+    auto offsets_contig = offsets->contiguous();
+    if (include_last_offset) {
+      TORCH_CHECK(
+          offsets_contig.numel() >= 1,
+          "include_last_offset: number of offset should be at least 1");
+      bag_offsets = offsets_contig;
+    } else {
+      bag_offsets = at::empty({offsets_contig.numel() + 1}, offsets_contig.options());
+      bag_offsets.narrow(0, 0, offsets_contig.numel()).copy_(offsets_contig);
+      bag_offsets.data_ptr<int64_t>()[offsets_contig.numel()] = indices.numel();
+    }
+  }
+  indices = indices.contiguous();
+
+  const int64_t* offsets_data = bag_offsets.data_ptr<int64_t>();
+  const int64_t num_bags = bag_offsets.numel() - 1;
+  TORCH_CHECK(
+      num_bags == 0 || offsets_data[0] == 0,
+      "offsets[0] has to be 0, i.e., the first sequence in the mini-batch has "
+      "to start from position 0. However, got ", offsets_data[0]);
+  for (int64_t bag = 0; bag < num_bags; bag++) {
+    TORCH_CHECK(
+        offsets_data[bag] <= offsets_data[bag + 1],
+        "embedding_bag: offsets have to be non-decreasing");
+  }
+  TORCH_CHECK(
+      offsets_data[num_bags] <= indices.numel(),
+      "offsets[-1] can not be greater than input's length ", indices.numel(),
+      " but got offsets[-1] of ", offsets_data[num_bags]);
+
+  if (per_sample_weights.has_value() && per_sample_weights->defined()) {
+    TORCH_CHECK(
+        mode == MODE_SUM,
+        "embedding_bag: per_sample_weights only supported with mode='sum'");
+    TORCH_CHECK(
+        per_sample_weights->scalar_type() == kFloat,
+        "embedding_bag: expected float per_sample_weights, got ",
+        per_sample_weights->scalar_type());
+    TORCH_CHECK(
+        per_sample_weights->numel() == indices.numel(),
+        "embedding_bag: expected one per_sample_weight per index");
+  }
+  return bag_offsets;
+}
+
+Tensor qembeddingbag_byte(
+    const Tensor& weight,
+    const Tensor& indices_,
+    const c10::optional<Tensor>& offsets,
+    bool /*scale_grad_by_freq*/,
+    int64_t mode,
+    bool sparse,
+    const c10::optional<Tensor>& per_sample_weights_,
+    bool include_last_offset) {
+  Tensor indices = indices_;
+  auto bag_offsets = rowwise_embedding_bag_offsets(
+      weight, indices, offsets, sparse, mode, per_sample_weights_, include_last_offset);
+  TORCH_CHECK(
+      weight.size(1) > kByteRowScaleBiasBytes,
+      "embedding_bag_byte: packed rows must be longer than their scale and bias");
+  auto weight_contig = weight.contiguous();
+  const int64_t num_rows = weight_contig.size(0);
+  const int64_t packed_cols = weight_contig.size(1);
+  const int64_t embedding_dim = packed_cols - kByteRowScaleBiasBytes;
+  const int64_t num_bags = bag_offsets.numel() - 1;
+  Tensor per_sample_weights;
+  if (per_sample_weights_.has_value() && per_sample_weights_->defined()) {
+    per_sample_weights = per_sample_weights_->contiguous();
+  }
+
+  auto output = at::empty({num_bags, embedding_dim}, weight.options().dtype(kFloat));
+  const uint8_t* weight_data = weight_contig.data_ptr<uint8_t>();
+  const int64_t* indices_data = indices.data_ptr<int64_t>();
+  const int64_t* offsets_data = bag_offsets.data_ptr<int64_t>();
+  const float* per_sample_weights_data =
+      per_sample_weights.defined() ? per_sample_weights.data_ptr<float>() : nullptr;
+  float* output_data = output.data_ptr<float>();
+  const bool normalize_by_lengths = mode == MODE_MEAN;
+
+#ifdef USE_FBGEMM
+  auto kernel_i8_i64 = fbgemm::GenerateEmbeddingSpMDM<uint8_t, int64_t, int64_t>(
+      /*block_size=*/embedding_dim,
+      /*has_weight=*/per_sample_weights.defined(),
+      /*normalize_by_lengths=*/normalize_by_lengths,
+      /*prefetch=*/16,
+      /*is_weight_positional=*/false,
+      /*use_offsets=*/true);
+#endif
+  at::parallel_for(
+      0, num_bags, bag_grain_size(offsets_data[num_bags], num_bags, embedding_dim),
+      [&](int64_t begin, int64_t end) {
+        const int64_t start = offsets_data[begin];
+#ifdef USE_FBGEMM
+        bool success = kernel_i8_i64(
+            /*output_size=*/end - begin,
+            /*index_size=*/offsets_data[end] - start,
+            /*data_size=*/num_rows,
+            /*input=*/weight_data,
+            /*indices=*/indices_data + start,
+            /*offsets_or_lengths=*/offsets_data + begin,
+            /*weights=*/per_sample_weights_data ? per_sample_weights_data + start : nullptr,
+            /*out=*/output_data + begin * embedding_dim);
+        TORCH_CHECK(
+            success,
+            "embedding_bag_byte: an index is out of bounds for a table with ",
+            num_rows, " rows");
+#elif !defined(C10_MOBILE)
+        caffe2::Fused8BitRowwiseEmbeddingLookupIdx<int64_t, uint8_t, float, false>(
+            /*block_size=*/embedding_dim,
+            /*output_size=*/end - begin,
+            /*index_size=*/offsets_data[end] - start,
+            /*data_size=*/num_rows,
+            /*input=*/weight_data,
+            /*indices=*/indices_data + start,
+            /*offsets=*/offsets_data + begin,
+            /*weights=*/per_sample_weights_data ? per_sample_weights_data + start : nullptr,
+            /*normalize_by_lengths=*/normalize_by_lengths,
+            /*out=*/output_data + begin * embedding_dim);
+#else
+        rowwise_embedding_bag_reference<float>(
+            /*bit_rate=*/8, weight_data, num_rows, packed_cols, embedding_dim,
+            indices_data, offsets_data, per_sample_weights_data,
+            normalize_by_lengths, begin, end, output_data);
+#endif
+      });
+  return output;
+}
+
+Tensor qembeddingbag_nbit(
+    int64_t bit_rate,
+    const Tensor& weight,
+    const Tensor& indices_,
+    const c10::optional<Tensor>& offsets,
+    int64_t mode,
+    bool sparse,
+    const c10::optional<Tensor>& per_sample_weights_,
+    bool include_last_offset) {
+  Tensor indices = indices_;
+  auto bag_offsets = rowwise_embedding_bag_offsets(
+      weight, indices, offsets, sparse, mode, per_sample_weights_, include_last_offset);
+  TORCH_CHECK(
+      weight.size(1) > kNBitRowScaleBiasBytes,
+      "embedding_bag_nbit: packed rows must be longer than their scale and bias");
+  auto weight_contig = weight.contiguous();
+  const int64_t num_rows = weight_contig.size(0);
+  const int64_t packed_cols = weight_contig.size(1);
+  const int64_t embedding_dim =
+      (packed_cols - kNBitRowScaleBiasBytes) * nbit_elements_per_byte(bit_rate);
+  const int64_t num_bags = bag_offsets.numel() - 1;
+  Tensor per_sample_weights;
+  if (per_sample_weights_.has_value() && per_sample_weights_->defined()) {
+    per_sample_weights = per_sample_weights_->contiguous();
+  }
+
+  auto output = at::empty({num_bags, embedding_dim}, weight.options().dtype(kFloat));
+  const uint8_t* weight_data = weight_contig.data_ptr<uint8_t>();
+  const int64_t* indices_data = indices.data_ptr<int64_t>();
+  const int64_t* offsets_data = bag_offsets.data_ptr<int64_t>();
+  const float* per_sample_weights_data =
+      per_sample_weights.defined() ? per_sample_weights.data_ptr<float>() : nullptr;
+  float* output_data = output.data_ptr<float>();
+  const bool normalize_by_lengths = mode == MODE_MEAN;
+
+#ifdef USE_FBGEMM
+  auto kernel_nbit_i64 = fbgemm::GenerateEmbeddingSpMDMNBit<int64_t, int64_t>(
+      /*bit_rate=*/bit_rate,
+      /*block_size=*/embedding_dim,
+      /*has_weight=*/per_sample_weights.defined(),
+      /*normalize_by_lengths=*/normalize_by_lengths,
+      /*prefetch=*/16,
+      /*is_weight_positional=*/false,
+      /*use_offsets=*/true);
+#endif
+  at::parallel_for(
+      0, num_bags, bag_grain_size(offsets_data[num_bags], num_bags, embedding_dim),
+      [&](int64_t begin, int64_t end) {
+#ifdef USE_FBGEMM
+        const int64_t start = offsets_data[begin];
+        bool success = kernel_nbit_i64(
+            /*output_size=*/end - begin,
+            /*index_size=*/offsets_data[end] - start,
+            /*data_size=*/num_rows,
+            /*input=*/weight_data,
+            /*indices=*/indices_data + start,
+            /*offsets_or_lengths=*/offsets_data + begin,
+            /*weights=*/per_sample_weights_data ? per_sample_weights_data + start : nullptr,
+            /*out=*/output_data + begin * embedding_dim);
+        TORCH_CHECK(
+            success,
+            "embedding_bag_nbit: an index is out of bounds for a table with ",
+            num_rows, " rows");
+#elif !defined(C10_MOBILE)
+        const int64_t start = offsets_data[begin];
+        caffe2::FusedNBitRowwiseEmbeddingLookupIdx<int64_t, float>(
+            /*bit_rate=*/bit_rate,
+            /*block_size=*/embedding_dim,
+            /*output_size=*/end - begin,
+            /*index_size=*/offsets_data[end] - start,
+            /*data_size=*/num_rows,
+            /*input=*/weight_data,
+            /*indices=*/indices_data + start,
+            /*offsets=*/offsets_data + begin,
+            /*weights=*/per_sample_weights_data ? per_sample_weights_data + start : nullptr,
+            /*normalize_by_lengths=*/normalize_by_lengths,
+            /*out=*/output_data + begin * embedding_dim);
+#else
+        rowwise_embedding_bag_reference<at::Half>(
+            bit_rate, weight_data, num_rows, packed_cols, embedding_dim,
+            indices_data, offsets_data, per_sample_weights_data,
+            normalize_by_lengths, begin, end, output_data);
+#endif
+      });
+  return output;
+}
+
+Tensor qembeddingbag_4bit(
+    const Tensor& weight,
+    const Tensor& indices,
+    const c10::optional<Tensor>& offsets,
+    bool /*scale_grad_by_freq*/,
+    int64_t mode,
+    bool sparse,
+    const c10::optional<Tensor>& per_sample_weights,
+    bool include_last_offset) {
+  return qembeddingbag_nbit(
+      4, weight, indices, offsets, mode, sparse, per_sample_weights, include_last_offset);
+}
+
+Tensor qembeddingbag_2bit(
+    const Tensor& weight,
+    const Tensor& indices,
+    const c10::optional<Tensor>& offsets,
+    bool /*scale_grad_by_freq*/,
+    int64_t mode,
+    bool sparse,
+    const c10::optional<Tensor>& per_sample_weights,
+    bool include_last_offset) {
+  return qembeddingbag_nbit(
+      2, weight, indices, offsets, mode, sparse, per_sample_weights, include_last_offset);
+}
+
+TORCH_LIBRARY_IMPL(quantized, CPU, m) {
+  m.impl("embedding_bag_byte_rowwise_offsets", qembeddingbag_byte);
+  m.impl("embedding_bag_4bit_rowwise_offsets", qembeddingbag_4bit);
+  m.impl("embedding_bag_2bit_rowwise_offsets", qembeddingbag_2bit);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+// Row-wise quantized embedding tables are plain uint8 2-D tensors with one
+// quantized row of the float table per row, followed by that row's scale and
+// bias, so that weight[i][j] ~= scale_i * q_ij + bias_i.
+//
+// - 8-bit ("byte"): embedding_dim uint8 values then a float scale and a float
+//   bias, the fused 8-bit row-wise layout of Caffe2's Fused8BitRowwise ops.
+// - N-bit (N = 4 or 2): embedding_dim / (8 / N) bytes holding 8 / N values
+//   each, lowest bits first, then an fp16 scale and an fp16 bias, the layout
+//   of fbgemm's FusedNBitRowwise kernels.
+
+namespace at {
+namespace native {
+
+constexpr int64_t kByteRowScaleBiasBytes = 2 * sizeof(float);
+constexpr int64_t kNBitRowScaleBiasBytes = 2 * sizeof(at::Half);
+
+inline int64_t nbit_elements_per_byte(int64_t bit_rate) {
+  return 8 / bit_rate;
+}
+
+Tensor qembeddingbag_byte_prepack(const Tensor& weight);
+Tensor qembeddingbag_byte_unpack(const Tensor& packed_weight);
+Tensor qembeddingbag_nbit_prepack(const Tensor& weight, int64_t bit_rate);
+Tensor qembeddingbag_nbit_unpack(const Tensor& packed_weight, int64_t bit_rate);
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,225 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/quantized/cpu/qembeddingbag.h>
+#include <torch/library.h>
+
+#ifndef C10_MOBILE
+#include <caffe2/perfkernels/fused_8bit_rowwise_conversion.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace at {
+namespace native {
+
+namespace {
+
+void check_float_table(const Tensor& weight, const char* op) {
+  TORCH_CHECK(
+      weight.dim() == 2,
+      op, ": expected a 2-d embedding table, got a ", weight.dim(), "-d tensor");
+  TORCH_CHECK(
+      weight.scalar_type() == kFloat,
+      op, ": expected a float embedding table, got ", weight.scalar_type());
+  TORCH_CHECK(weight.size(1) > 0, op, ": expected a non-empty embedding dim");
+}
+
+void check_packed_table(const Tensor& packed_weight, int64_t scale_bias_bytes, const char* op) {
+  TORCH_CHECK(
+      packed_weight.dim() == 2 && packed_weight.scalar_type() == kByte,
+      op, ": expected a 2-d uint8 packed table");
+  TORCH_CHECK(
+      packed_weight.size(1) > scale_bias_bytes,
+      op, ": packed rows must be longer than their ", scale_bias_bytes,
+      " bytes of scale and bias");
+}
+
+int64_t prepack_grain_size(int64_t embedding_dim) {
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / embedding_dim);
+}
+
+void check_bit_rate(int64_t bit_rate) {
+  TORCH_CHECK(
+      bit_rate == 2 || bit_rate == 4,
+      "embedding_bag N-bit tables support bit_rate 2 and 4, got ", bit_rate);
+}
+
+} // namespace
+
+Tensor qembeddingbag_byte_prepack(const Tensor& weight) {
+  check_float_table(weight, "embedding_bag_byte_prepack");
+  auto weight_contig = weight.contiguous();
+  const int64_t rows = weight_contig.size(0);
+  const int64_t cols = weight_contig.size(1);
+  const int64_t packed_cols = cols + kByteRowScaleBiasBytes;
+  auto output = at::empty({rows, packed_cols}, weight_contig.options().dtype(kByte));
+  const float* weight_data = weight_contig.data_ptr<float>();
+  uint8_t* output_data = output.data_ptr<uint8_t>();
+
+  at::parallel_for(0, rows, prepack_grain_size(cols), [&](int64_t begin, int64_t end) {
+#ifndef C10_MOBILE
+    caffe2::FloatToFused8BitRowwiseQuantized(
+        weight_data + begin * cols, end - begin, cols, output_data + begin * packed_cols);
+#else
+    // Same rounding as caffe2::FloatToFused8BitRowwiseQuantized, which mobile
+    // builds do not include.
+    constexpr float kEpsilon = 1e-8f;
+    for (int64_t row = begin; row < end; row++) {
+      const float* input_row = weight_data + row * cols;
+      uint8_t* output_row = output_data + row * packed_cols;
+      const float minimum = *std::min_element(input_row, input_row + cols);
+      const float maximum = *std::max_element(input_row, input_row + cols);
+      const float range = maximum - minimum;
+      const float scale_bias[2] = {range / 255.0f, minimum};
+      std::memcpy(output_row + cols, scale_bias, sizeof(scale_bias));
+      const float inverse_scale = 255.0f / (range + kEpsilon);
+      for (int64_t col = 0; col < cols; col++) {
+        output_row[col] = std::lrintf((input_row[col] - minimum) * inverse_scale);
+      }
+    }
+#endif
+  });
+  return output;
+}
+
+Tensor qembeddingbag_byte_unpack(const Tensor& packed_weight) {
+  check_packed_table(packed_weight, kByteRowScaleBiasBytes, "embedding_bag_byte_unpack");
+  auto packed_contig = packed_weight.contiguous();
+  const int64_t rows = packed_contig.size(0);
+  const int64_t packed_cols = packed_contig.size(1);
+  const int64_t cols = packed_cols - kByteRowScaleBiasBytes;
+  auto output = at::empty({rows, cols}, packed_contig.options().dtype(kFloat));
+  const uint8_t* packed_data = packed_contig.data_ptr<uint8_t>();
+  float* output_data = output.data_ptr<float>();
+
+  at::parallel_for(0, rows, prepack_grain_size(cols), [&](int64_t begin, int64_t end) {
+#ifndef C10_MOBILE
+    caffe2::Fused8BitRowwiseQuantizedToFloat(
+        packed_data + begin * packed_cols, end - begin, packed_cols, output_data + begin * cols);
+#else
+    for (int64_t row = begin; row < end; row++) {
+      const uint8_t* input_row = packed_data + row * packed_cols;
+      float scale_bias[2];
+      std::memcpy(scale_bias, input_row + cols, sizeof(scale_bias));
+      for (int64_t col = 0; col < cols; col++) {
+        output_data[row * cols + col] = input_row[col] * scale_bias[0] + scale_bias[1];
+      }
+    }
+#endif
+  });
+  return output;
+}
+
+// Matches fbgemm::FloatToFusedNBitRowwiseQuantizedSBHalf: the bias and scale
+// are rounded to fp16 before quantizing so that dequantizing with the stored
+// values is consistent.
+Tensor qembeddingbag_nbit_prepack(const Tensor& weight, int64_t bit_rate) {
+  check_bit_rate(bit_rate);
+  check_float_table(weight, "embedding_bag_nbit_prepack");
+  const int64_t elements_per_byte = nbit_elements_per_byte(bit_rate);
+  auto weight_contig = weight.contiguous();
+  const int64_t rows = weight_contig.size(0);
+  const int64_t cols = weight_contig.size(1);
+  TORCH_CHECK(
+      cols % elements_per_byte == 0,
+      "embedding_bag_nbit_prepack: the embedding dim must be a multiple of ",
+      elements_per_byte, " for bit_rate ", bit_rate, ", got ", cols);
+  const int64_t value_bytes = cols / elements_per_byte;
+  const int64_t packed_cols = value_bytes + kNBitRowScaleBiasBytes;
+  const int64_t max_quantized = (1 << bit_rate) - 1;
+  auto output = at::empty({rows, packed_cols}, weight_contig.options().dtype(kByte));
+  const float* weight_data = weight_contig.data_ptr<float>();
+  uint8_t* output_data = output.data_ptr<uint8_t>();
+
+  at::parallel_for(0, rows, prepack_grain_size(cols), [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      const float* input_row = weight_data + row * cols;
+      uint8_t* output_row = output_data + row * packed_cols;
+      const at::Half minimum = *std::min_element(input_row, input_row + cols);
+      const float maximum = *std::max_element(input_row, input_row + cols);
+      const float range = maximum - static_cast<float>(minimum);
+      at::Half scale = range == 0 ? 1.0f : range / max_quantized;
+      if (static_cast<float>(scale) == 0) {
+        // range is too small for fp16, every value quantizes to 0
+        scale = 1.0f;
+      }
+      const float inverse_scale = 1.0f / static_cast<float>(scale);
+      const at::Half scale_bias[2] = {scale, minimum};
+      std::memcpy(output_row + value_bytes, scale_bias, sizeof(scale_bias));
+
+      std::memset(output_row, 0, value_bytes);
+      for (int64_t col = 0; col < cols; col++) {
+        const float value = (input_row[col] - static_cast<float>(minimum)) * inverse_scale;
+        const int64_t quantized = std::max<int64_t>(
+            0, std::min<int64_t>(std::lrintf(value), max_quantized));
+        output_row[col / elements_per_byte] |=
+            quantized << ((col % elements_per_byte) * bit_rate);
+      }
+    }
+  });
+  return output;
+}
+
+Tensor qembeddingbag_nbit_unpack(const Tensor& packed_weight, int64_t bit_rate) {
+  check_bit_rate(bit_rate);
+  check_packed_table(packed_weight, kNBitRowScaleBiasBytes, "embedding_bag_nbit_unpack");
+  const int64_t elements_per_byte = nbit_elements_per_byte(bit_rate);
+  auto packed_contig = packed_weight.contiguous();
+  const int64_t rows = packed_contig.size(0);
+  const int64_t packed_cols = packed_contig.size(1);
+  const int64_t value_bytes = packed_cols - kNBitRowScaleBiasBytes;
+  const int64_t cols = value_bytes * elements_per_byte;
+  const int64_t mask = (1 << bit_rate) - 1;
+  auto output = at::empty({rows, cols}, packed_contig.options().dtype(kFloat));
+  const uint8_t* packed_data = packed_contig.data_ptr<uint8_t>();
+  float* output_data = output.data_ptr<float>();
+
+  at::parallel_for(0, rows, prepack_grain_size(cols), [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      const uint8_t* input_row = packed_data + row * packed_cols;
+      at::Half scale_bias[2];
+      std::memcpy(scale_bias, input_row + value_bytes, sizeof(scale_bias));
+      const float scale = scale_bias[0];
+      const float bias = scale_bias[1];
+      for (int64_t col = 0; col < cols; col++) {
+        const int64_t quantized =
+            (input_row[col / elements_per_byte] >> ((col % elements_per_byte) * bit_rate)) & mask;
+        output_data[row * cols + col] = scale * quantized + bias;
+      }
+    }
+  });
+  return output;
+}
+
+namespace {
+
+Tensor qembeddingbag_4bit_prepack(const Tensor& weight) {
+  return qembeddingbag_nbit_prepack(weight, 4);
+}
+
+Tensor qembeddingbag_4bit_unpack(const Tensor& packed_weight) {
+  return qembeddingbag_nbit_unpack(packed_weight, 4);
+}
+
+Tensor qembeddingbag_2bit_prepack(const Tensor& weight) {
+  return qembeddingbag_nbit_prepack(weight, 2);
+}
+
+Tensor qembeddingbag_2bit_unpack(const Tensor& packed_weight) {
+  return qembeddingbag_nbit_unpack(packed_weight, 2);
+}
+
+TORCH_LIBRARY_IMPL(quantized, CPU, m) {
+  m.impl("embedding_bag_byte_prepack", qembeddingbag_byte_prepack);
+  m.impl("embedding_bag_byte_unpack", qembeddingbag_byte_unpack);
+  m.impl("embedding_bag_4bit_prepack", qembeddingbag_4bit_prepack);
+  m.impl("embedding_bag_4bit_unpack", qembeddingbag_4bit_unpack);
+  m.impl("embedding_bag_2bit_prepack", qembeddingbag_2bit_prepack);
+  m.impl("embedding_bag_2bit_unpack", qembeddingbag_2bit_unpack);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
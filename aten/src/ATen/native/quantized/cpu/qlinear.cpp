@@ -240,44 +240,18 @@ at::Tensor PackedLinearWeightsQnnp::apply_impl(
   auto kernel_zp = w_zp + 128;
   auto kernel_scale = w_scale;
   size_t rows_w = bias_.size(0);
-  size_t cols_w = input_contig.size(input_contig.dim() - 1);
+  size_t cols_w = packB->getInputChannels();
   auto input_scale = input_contig.q_scale();
 
   if (!this->input_scale.has_value() ||
       this->input_scale.value() != input_scale) {
-    // Get the original weight and adjust it to uint8 from int8
-    auto weight_contig = orig_weight;
-    auto bias_fp32 = bias_;
-    int8_t* w_data = (int8_t*)weight_contig.data_ptr<c10::qint8>();
-    at::Tensor qnnp_weight = at::_empty_affine_quantized(
-        weight_contig.sizes(),
-        at::device(c10::kCPU).dtype(c10::kQUInt8),
-        kernel_scale,
-        kernel_zp);
-    auto* qnnp_w_data = qnnp_weight.data_ptr<c10::quint8>();
-    auto wt_numel = weight_contig.numel();
-    for (int i = 0; i < wt_numel; ++i) {
-      qnnp_w_data[i] = static_cast<c10::quint8>(w_data[i] + 128);
-    }
-    // Original bias was float, so we requantize it here.
+    // Original bias was float, so we requantize it here, and only update the
+    // biases in the weights packed by prepack.
     auto qbias = at::quantize_per_tensor(
-        bias_fp32, kernel_scale * input_scale, 0, c10::kQInt32);
-    // Update the input scale to not pack again.
+        bias_, kernel_scale * input_scale, 0, c10::kQInt32);
+    packB->updateBias((int32_t*)qbias.data_ptr<c10::qint32>());
+    // Update the input scale to not requantize again.
     this->input_scale = input_scale;
-    w.reset();
-    w = std::make_unique<qnnpack::PackBMatrix>(
-        cols_w /* input_channels */,
-        rows_w /* output_channels */,
-        kernel_zp,
-        kernel_scale,
-        (uint8_t*)qnnp_w_data,
-        (int32_t*)qbias.data_ptr<c10::qint32>());
-    packB = w.get();
-    if (at::globalContext().releaseWeightsWhenPrepacking()) {
-      // On mobile, we release the original weight by resetting the intrusive_ptr.
-      // Calling unpack after this will throw an assertion.
-      orig_weight.reset();
-    }
   }
 
   size_t rows_input = 1;
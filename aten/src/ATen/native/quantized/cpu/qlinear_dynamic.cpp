@@ -213,6 +213,159 @@ at::Tensor PackedLinearWeight::apply_dynamic_relu(at::Tensor input) {
   return apply_dynamic_impl</*ReluFused=*/true>(std::move(input));
 }
 
+template <bool ReluFused>
+at::Tensor PackedLinearWeight::apply_dynamic_per_row_impl(at::Tensor input) {
+  // fp32 * int8 -> fp32, with every row of the input quantized with its own
+  // scale and zero point.
+  TORCH_CHECK(
+      fbgemm::fbgemmSupportedCPU(), "Your CPU does not support FBGEMM.");
+
+  auto input_contig = input.contiguous();
+  const auto* input_ptr = input_contig.data_ptr<float>();
+
+  TORCH_CHECK(
+      input.dim() >= 2,
+      "The dimension of input tensor should be larger than or equal to 2");
+  // C(output) = A(input) x B(weight), where C, A, B are M x N, M x K, K x N
+  // matrices, respectively.
+  int64_t M = size_to_dim_(input.dim() - 1, input.sizes());
+
+  auto packB = w.get();
+
+  int64_t N = static_cast<int64_t>(packB->numCols());
+  int64_t K = input.size(input.dim() - 1);
+  TORCH_CHECK(
+      K == static_cast<int64_t>(packB->numRows()),
+      "The number of rows in the packB should be equal to K: " +
+          std::to_string(K));
+
+  const float* bias_ptr = nullptr;
+  at::Tensor bias_contig;
+  if (bias_.has_value()) {
+    TORCH_CHECK(bias_->dim() == 1, "bias should be a vector (1D Tensor)");
+    TORCH_CHECK(
+        bias_->size(0) == N,
+        "bias should have N elements: " + std::to_string(N));
+    bias_contig = bias_->contiguous();
+    bias_ptr = bias_contig.data_ptr<float>();
+  }
+
+  // Input rows are quantized as 8-bit unsigned values
+  static constexpr int precision = 8;
+
+  // Choose the quantization parameters of each row, quantize it and sum it
+  // up for the row offsets while the row is in cache, so the float input is
+  // only streamed from memory once. fbgemmPacked then packs the quantized
+  // rows into its tiles as it goes.
+  auto q_input = at::empty({M, K}, input.options().dtype(at::kByte));
+  auto* q_input_ptr = q_input.data_ptr<uint8_t>();
+  std::vector<float> row_scales(M);
+  std::vector<int32_t> row_zero_points(M);
+  std::vector<int32_t> row_offsets(M);
+  at::parallel_for(
+      0,
+      M,
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, K)),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t m = begin; m < end; ++m) {
+          const float* row = input_ptr + m * K;
+          uint8_t* q_row = q_input_ptr + m * K;
+          float x_min, x_max;
+          fbgemm::FindMinMax(row, &x_min, &x_max, K);
+          auto q_params = quant_utils::ChooseQuantizationParams(
+              /*min=*/x_min,
+              /*max=*/x_max,
+              /*qmin=*/0,
+              /*qmax=*/(1 << precision) - 1,
+              /*preserve_sparsity=*/false);
+          fbgemm::Quantize<uint8_t, false /*LEGACY*/>(
+              row,
+              q_row,
+              K,
+              fbgemm::TensorQuantizationParams{
+                  static_cast<float>(q_params.scale),
+                  q_params.zero_point,
+                  precision});
+          int32_t row_sum = 0;
+          for (int64_t k = 0; k < K; ++k) {
+            row_sum += q_row[k];
+          }
+          row_scales[m] = q_params.scale;
+          row_zero_points[m] = q_params.zero_point;
+          row_offsets[m] = row_sum;
+        }
+      });
+
+  std::vector<int64_t> out_sizes = input.sizes().vec();
+  out_sizes.back() = N;
+  auto output = at::empty(out_sizes, input.options().dtype(at::kFloat));
+  // fbgemm's output pipelines dequantize with a single activation scale, so
+  // the int32 accumulators are kept and dequantized per row below.
+  auto acc = at::empty({M, N}, input.options().dtype(at::kInt));
+  auto* acc_ptr = acc.data_ptr<int32_t>();
+
+  int num_tasks = at::get_num_threads();
+  at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
+    fbgemm::PackAMatrix<uint8_t> packA(
+        /*trans=*/fbgemm::matrix_op_t::NoTranspose,
+        /*nRow=*/M,
+        /*nCol=*/K,
+        /*smat=*/q_input_ptr,
+        /*ld=*/K,
+        /*pmat=*/nullptr); // Currently, packA manages ownership of `pmat`.
+    fbgemm::DoNothing<int32_t, int32_t> doNothingObj{};
+    fbgemm::memCopy<> memCopyObj(doNothingObj);
+    for (int task_id = begin; task_id < end; ++task_id) {
+      fbgemm::fbgemmPacked(
+          /*packA=*/packA,
+          /*packB=*/*packB,
+          /*C=*/acc_ptr,
+          /*C_buffer=*/acc_ptr,
+          /*ldc=*/N,
+          /*outProcess=*/memCopyObj,
+          /*thread_id=*/task_id,
+          /*num_threads=*/num_tasks);
+    }
+  });
+
+  // Y = A_scale[m] * B_scale[n] *
+  //     (acc - B_zero_point[n] * row_offsets[m] - A_zero_point[m] * col_offsets[n])
+  //     + bias[n]
+  // where col_offsets already include the B_zero_point[n] * K term.
+  const bool per_channel = q_scheme == c10::kPerChannelAffine;
+  auto* output_ptr = output.data_ptr<float>();
+  at::parallel_for(
+      0,
+      M,
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, N)),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t m = begin; m < end; ++m) {
+          const int32_t* acc_row = acc_ptr + m * N;
+          float* out_row = output_ptr + m * N;
+          for (int64_t n = 0; n < N; ++n) {
+            const int64_t w_idx = per_channel ? n : 0;
+            float y = row_scales[m] * w_scale[w_idx] *
+                (acc_row[n] - w_zp[w_idx] * row_offsets[m] -
+                 row_zero_points[m] * col_offsets[n]);
+            if (bias_ptr) {
+              y += bias_ptr[n];
+            }
+            out_row[n] = ReluFused ? std::max(y, 0.f) : y;
+          }
+        }
+      });
+
+  return output;
+}
+
+at::Tensor PackedLinearWeight::apply_dynamic_per_row(at::Tensor input) {
+  return apply_dynamic_per_row_impl</*ReluFused=*/false>(std::move(input));
+}
+
+at::Tensor PackedLinearWeight::apply_dynamic_per_row_relu(at::Tensor input) {
+  return apply_dynamic_per_row_impl</*ReluFused=*/true>(std::move(input));
+}
+
 #endif // USE_FBGEMM
 
 #ifdef USE_PYTORCH_QNNPACK
@@ -231,7 +384,6 @@ at::Tensor PackedLinearWeightsQnnp::apply_dynamic_impl(at::Tensor input) {
   auto kernel_zp = w_zp + 128;
   auto kernel_scale = w_scale;
   size_t rows_w = bias_.size(0);
-  size_t cols_w = input_contig.size(input_contig.dim() - 1);
 
   at::Tensor bias_vec = bias_;
 
@@ -250,38 +402,11 @@ at::Tensor PackedLinearWeightsQnnp::apply_dynamic_impl(at::Tensor input) {
       /*max=*/x_max,
       /*qmin=*/0,
       /*qmax=*/255);
-  if (!input_scale.has_value()) {
-    // Get the original weight and adjust it to uint8 from int8
-    auto weight_contig = orig_weight;
-    int8_t* w_data = (int8_t*)weight_contig.data_ptr<c10::qint8>();
-    Tensor qnnp_weight = at::_empty_affine_quantized(
-        weight_contig.sizes(),
-        at::device(c10::kCPU).dtype(c10::kQUInt8),
-        kernel_scale,
-        kernel_zp);
-    auto* qnnp_w_data = qnnp_weight.data_ptr<c10::quint8>();
-    auto wt_numel = weight_contig.numel();
-    for (int i = 0; i < wt_numel; ++i) {
-      qnnp_w_data[i] = static_cast<c10::quint8>(w_data[i] + 128);
-    }
-
-    // Update the input scale to not pack again.
-    // Pass in nullptr for bias, as we pass FP32 bias to run function.
-    input_scale = q_params.scale;
-    w.reset();
-    w = std::make_unique<qnnpack::PackBMatrix>(
-        cols_w /* input_channels */,
-        rows_w /* output_channels */,
-        kernel_zp,
-        kernel_scale,
-        (uint8_t*)qnnp_w_data,
-        nullptr);
-    packB = w.get();
-    if (at::globalContext().releaseWeightsWhenPrepacking()) {
-      // On mobile, we release the original weight by resetting the intrusive_ptr.
-      // Calling unpack after this will throw an assertion.
-      orig_weight.reset();
-    }
+  // The weights were packed by prepack with zero biases, as we pass FP32 bias
+  // to run function. Clear any quantized biases a static run patched in.
+  if (input_scale.has_value()) {
+    packB->updateBias(nullptr);
+    input_scale = c10::nullopt;
   }
 
   // Quantize input
@@ -302,6 +427,12 @@ at::Tensor PackedLinearWeightsQnnp::apply_dynamic_impl(at::Tensor input) {
   for (size_t i = 0; i < input_contig.dim() - 1; ++i) {
     rows_input *= input_contig.size(i);
   }
+  TORCH_CHECK(
+      cols_input == packB->getInputChannels(),
+      "quantized::linear_dynamic(): input size does not match weight dimension 1 size: got ",
+      cols_input,
+      " but expected ",
+      packB->getInputChannels());
   pytorch_qnnp_status runStatus = qnnpack::qnnpackLinearDynamic(
       rows_input /* batch_size */,
       cols_input /* input_channels */,
@@ -404,6 +535,20 @@ class QLinearDynamicInt8 final {
   }
 };
 
+template <bool ReluFused>
+class QLinearDynamicInt8PerRow final {
+ public:
+  static at::Tensor run(
+      at::Tensor input,
+      const c10::intrusive_ptr<LinearPackedParamsBase>& packed_weight) {
+    if (ReluFused) {
+      return packed_weight->apply_dynamic_per_row_relu(std::move(input));
+    } else {
+      return packed_weight->apply_dynamic_per_row(std::move(input));
+    }
+  }
+};
+
 template <bool ReluFused>
 class QLinearDynamicFp16 final {
  public:
@@ -436,6 +581,8 @@ class QLinearDynamicFp16 final {
 TORCH_LIBRARY_IMPL(quantized, CPU, m) {
   m.impl("linear_dynamic", QLinearDynamicInt8<false>::run);
   m.impl("linear_relu_dynamic", QLinearDynamicInt8<true>::run);
+  m.impl("linear_dynamic_per_row", QLinearDynamicInt8PerRow<false>::run);
+  m.impl("linear_relu_dynamic_per_row", QLinearDynamicInt8PerRow<true>::run);
   m.impl("linear_dynamic_fp16", QLinearDynamicFp16<false>::run);
 }
 
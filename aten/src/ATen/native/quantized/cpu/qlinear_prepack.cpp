@@ -37,16 +37,10 @@ void calc_col_offsets_transpose(
     }
   }
 }
-} // namespace
-
-c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeight::prepack(
-    at::Tensor weight,
-    c10::optional<at::Tensor> bias) {
-  TORCH_CHECK(
-      weight.dim() == 2,
-      "The weight tensor for quantized::linear_prepack (fbgemm) should"
-      " be 2-dimensional.");
 
+c10::intrusive_ptr<LinearPackedParamsBase> PackLinearWeight(
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias) {
   auto N = weight.size(0);
   auto K = weight.size(1);
 
@@ -110,6 +104,23 @@ c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeight::prepack(
       qtype);
   return ret_ptr;
 }
+} // namespace
+
+c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeight::prepack(
+    at::Tensor weight,
+    c10::optional<at::Tensor> bias) {
+  TORCH_CHECK(
+      weight.dim() == 2,
+      "The weight tensor for quantized::linear_prepack (fbgemm) should"
+      " be 2-dimensional.");
+  auto key = at::native::fbgemm_utils::MakePrepackCacheKey(
+      at::native::fbgemm_utils::PrepackKind::Linear, weight, bias);
+  return at::native::fbgemm_utils::PrepackedWeightCache::get()
+      .lookupOrPrepack<LinearPackedParamsBase>(
+          std::move(key), weight, bias, [&]() {
+            return PackLinearWeight(weight, bias);
+          });
+}
 #endif // USE_FBGEMM
 
 #ifdef USE_PYTORCH_QNNPACK
@@ -144,15 +155,43 @@ c10::intrusive_ptr<LinearPackedParamsBase> PackedLinearWeightsQnnp::prepack(
 
   at::Tensor weight_contig = weight.contiguous();
   auto weight_zp = weight.q_zero_point();
+  // Adjust weight zero point, similar to weight data.
+  auto kernel_zp = weight_zp + 128;
+  auto kernel_scale = weight.q_scale();
 
   at::native::initQNNPACK();
 
-  // We set the pre-packed linear weights to nullptr below as we call pre-pack
-  // during the first invocation of operator run. Refer to qlinear.cpp for more
-  // details. TODO Update to actually call pre-pack here once bias is removed
-  // from pre-packing step.
+  // Adjust the weight to uint8 from int8 and pack it now, so that the first
+  // run doesn't have to. The bias is quantized with the input scale, which is
+  // only known at run time, so it is packed as zeros and patched in by
+  // qlinear.cpp. The zero biases are also what the dynamic linear expects, as
+  // it adds its FP32 bias itself.
+  int8_t* w_data = (int8_t*)weight_contig.data_ptr<c10::qint8>();
+  at::Tensor qnnp_weight = at::_empty_affine_quantized(
+      weight_contig.sizes(),
+      at::device(c10::kCPU).dtype(c10::kQUInt8),
+      kernel_scale,
+      kernel_zp);
+  auto* qnnp_w_data = qnnp_weight.data_ptr<c10::quint8>();
+  auto wt_numel = weight_contig.numel();
+  for (int i = 0; i < wt_numel; ++i) {
+    qnnp_w_data[i] = static_cast<c10::quint8>(w_data[i] + 128);
+  }
+  auto packB = std::make_unique<qnnpack::PackBMatrix>(
+      weight_contig.size(1) /* input_channels */,
+      rows_w /* output_channels */,
+      kernel_zp,
+      kernel_scale,
+      (uint8_t*)qnnp_w_data,
+      nullptr);
+  if (at::globalContext().releaseWeightsWhenPrepacking()) {
+    // On mobile, we release the original weight by resetting the intrusive_ptr.
+    // Calling unpack after this will throw an assertion.
+    weight_contig.reset();
+  }
+
   auto wt_ptr = c10::make_intrusive<PackedLinearWeightsQnnp>(
-      nullptr,
+      std::move(packB),
       weight_contig, /* int8_t weight */
       bias_fp32.contiguous(), /* fp32 bias */
       c10::nullopt, /* input_scale */
@@ -0,0 +1,270 @@
+#include <ATen/ATen.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/quantized/affine_quantizer.h>
+#include <torch/library.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace at {
+namespace native {
+
+namespace {
+
+/* Quantized (batched) matrix multiply of two activations.
+ *
+ * Products of activations, like the query-key and attention-value products of
+ * self-attention, have no weight that could be packed ahead of time, so the
+ * product is computed directly on the int8 values with int32 accumulation:
+ * with za and zb the zero points of A and B,
+ *
+ *   sum_k (a_ik - za) (b_kj - zb) = sum_k a_ik b_kj - zb rowsum(A)_i
+ *                                   - za colsum(B)_j + K za zb,
+ *
+ * so the inner loop only multiplies raw values and the zero points are folded
+ * in once per output. The accumulator is then requantized to the output scale
+ * and zero point. A is a quint8 per-tensor affine tensor; B may be quint8 or
+ * qint8 and per-tensor or per-channel affine along its last dimension, i.e.,
+ * with a scale and zero point per output column.
+ */
+
+struct QParamsB {
+  // Per output column; constant for per-tensor quantized B.
+  std::vector<double> scales;
+  std::vector<int32_t> zero_points;
+};
+
+QParamsB get_column_qparams(const Tensor& qb, int64_t N) {
+  QParamsB qparams;
+  if (qb.qscheme() == kPerTensorAffine) {
+    qparams.scales.assign(N, qb.q_scale());
+    qparams.zero_points.assign(N, qb.q_zero_point());
+    return qparams;
+  }
+  TORCH_CHECK(
+      qb.q_per_channel_axis() == qb.dim() - 1,
+      "quantized::matmul: per-channel quantized mat2 must be quantized along "
+      "its last dimension, but got axis ", qb.q_per_channel_axis());
+  const auto scales = qb.q_per_channel_scales().to(kDouble).contiguous();
+  const auto zero_points = qb.q_per_channel_zero_points().to(kLong).contiguous();
+  const double* scale_data = scales.data_ptr<double>();
+  const int64_t* zp_data = zero_points.data_ptr<int64_t>();
+  qparams.scales.assign(scale_data, scale_data + N);
+  qparams.zero_points.assign(zp_data, zp_data + N);
+  return qparams;
+}
+
+void check_matmul_inputs(const char* name, const Tensor& qa, const Tensor& qb) {
+  TORCH_CHECK(
+      qa.scalar_type() == kQUInt8 && qa.qscheme() == kPerTensorAffine,
+      name, ": expected self to be a per-tensor affine quint8 tensor");
+  TORCH_CHECK(
+      qb.scalar_type() == kQUInt8 || qb.scalar_type() == kQInt8,
+      name, ": expected mat2 to be a quint8 or qint8 tensor, but got ",
+      qb.scalar_type());
+  TORCH_CHECK(
+      qb.qscheme() == kPerTensorAffine ||
+          qb.qscheme() == kPerChannelAffine,
+      name, ": expected mat2 to be per-tensor or per-channel affine quantized");
+}
+
+// Computes out[b] = A[b] B[b] for contiguous int_repr tensors a of shape
+// [batch, M, K] and b of shape [batch, K, N] into the quint8 data of out.
+template <typename b_underlying_t>
+void qmatmul_kernel(
+    const Tensor& a,
+    const Tensor& b,
+    int32_t a_zero_point,
+    double a_scale,
+    const QParamsB& b_qparams,
+    double out_scale,
+    int64_t out_zero_point,
+    uint8_t* out_data) {
+  const int64_t batch = a.size(0);
+  const int64_t M = a.size(1);
+  const int64_t K = a.size(2);
+  const int64_t N = b.size(2);
+  const uint8_t* a_data = a.data_ptr<uint8_t>();
+  const b_underlying_t* b_data =
+      static_cast<const b_underlying_t*>(b.data_ptr());
+
+  std::vector<float> multipliers(N);
+  std::vector<int64_t> col_offsets(N);
+  for (int64_t j = 0; j < N; ++j) {
+    multipliers[j] =
+        static_cast<float>(a_scale * b_qparams.scales[j] / out_scale);
+    col_offsets[j] = K * static_cast<int64_t>(a_zero_point) *
+        b_qparams.zero_points[j];
+  }
+
+  // Column sums of every B, shifted by the constant part of the correction.
+  std::vector<int64_t> col_corrections(batch * N);
+  at::parallel_for(0, batch, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t bi = begin; bi < end; ++bi) {
+      int64_t* corr = col_corrections.data() + bi * N;
+      std::fill(corr, corr + N, 0);
+      for (int64_t k = 0; k < K; ++k) {
+        const b_underlying_t* b_row = b_data + (bi * K + k) * N;
+        for (int64_t j = 0; j < N; ++j) {
+          corr[j] += b_row[j];
+        }
+      }
+      for (int64_t j = 0; j < N; ++j) {
+        corr[j] = col_offsets[j] - a_zero_point * corr[j];
+      }
+    }
+  });
+
+  constexpr int32_t qmin = std::numeric_limits<uint8_t>::min();
+  constexpr int32_t qmax = std::numeric_limits<uint8_t>::max();
+  const int64_t grain_size = std::max<int64_t>(
+      1, internal::GRAIN_SIZE / std::max<int64_t>(1, K * N));
+  at::parallel_for(0, batch * M, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<int32_t> acc(N);
+    for (int64_t row = begin; row < end; ++row) {
+      const int64_t bi = row / M;
+      const uint8_t* a_row = a_data + row * K;
+      const b_underlying_t* b_mat = b_data + bi * K * N;
+      std::fill(acc.begin(), acc.end(), 0);
+      int64_t row_sum = 0;
+      for (int64_t k = 0; k < K; ++k) {
+        const int32_t a_val = a_row[k];
+        row_sum += a_val;
+        const b_underlying_t* b_row = b_mat + k * N;
+        for (int64_t j = 0; j < N; ++j) {
+          acc[j] += a_val * static_cast<int32_t>(b_row[j]);
+        }
+      }
+
+      const int64_t* corr = col_corrections.data() + bi * N;
+      uint8_t* out_row = out_data + row * N;
+      for (int64_t j = 0; j < N; ++j) {
+        const int64_t total = acc[j] + corr[j] -
+            row_sum * static_cast<int64_t>(b_qparams.zero_points[j]);
+        const int64_t q = out_zero_point +
+            static_cast<int64_t>(std::nearbyint(total * multipliers[j]));
+        out_row[j] = static_cast<uint8_t>(
+            std::min<int64_t>(std::max<int64_t>(q, qmin), qmax));
+      }
+    }
+  });
+}
+
+// Multiplies the [batch, M, K] and [batch, K, N] int_repr tensors a and b
+// and returns the result quantized with the given parameters in the given
+// output shape.
+Tensor qmatmul_impl(
+    const Tensor& qa,
+    const Tensor& qb,
+    const Tensor& a,
+    const Tensor& b,
+    IntArrayRef out_shape,
+    double scale,
+    int64_t zero_point) {
+  const int64_t N = b.size(2);
+  const auto b_qparams = get_column_qparams(qb, N);
+  auto qc = at::_empty_affine_quantized(
+      out_shape, qa.options().dtype(kQUInt8), scale, zero_point);
+  if (qc.numel() == 0) {
+    return qc;
+  }
+  auto* out_data = reinterpret_cast<uint8_t*>(qc.data_ptr<c10::quint8>());
+  if (qb.scalar_type() == kQUInt8) {
+    qmatmul_kernel<uint8_t>(
+        a, b, qa.q_zero_point(), qa.q_scale(), b_qparams, scale, zero_point,
+        out_data);
+  } else {
+    qmatmul_kernel<int8_t>(
+        a, b, qa.q_zero_point(), qa.q_scale(), b_qparams, scale, zero_point,
+        out_data);
+  }
+  return qc;
+}
+
+class QBmm final {
+ public:
+  static Tensor run(Tensor qa, Tensor qb, double scale, int64_t zero_point) {
+    check_matmul_inputs("quantized::bmm", qa, qb);
+    TORCH_CHECK(
+        qa.dim() == 3 && qb.dim() == 3,
+        "quantized::bmm: expected 3D tensors, but got ", qa.dim(), "D and ",
+        qb.dim(), "D tensors");
+    TORCH_CHECK(
+        qa.size(0) == qb.size(0) && qa.size(2) == qb.size(1),
+        "quantized::bmm: shapes ", qa.sizes(), " and ", qb.sizes(),
+        " cannot be multiplied");
+    return qmatmul_impl(
+        qa, qb, qa.int_repr().contiguous(), qb.int_repr().contiguous(),
+        {qa.size(0), qa.size(1), qb.size(2)}, scale, zero_point);
+  }
+};
+
+// Follows the broadcasting rules of at::matmul.
+class QMatmul final {
+ public:
+  static Tensor run(Tensor qa, Tensor qb, double scale, int64_t zero_point) {
+    check_matmul_inputs("quantized::matmul", qa, qb);
+    const int64_t dim_a = qa.dim();
+    const int64_t dim_b = qb.dim();
+    TORCH_CHECK(
+        dim_a >= 1 && dim_b >= 1,
+        "quantized::matmul: both arguments need to be at least 1D, but got ",
+        dim_a, "D and ", dim_b, "D tensors");
+    TORCH_CHECK(
+        dim_b >= 2 || qb.qscheme() == kPerTensorAffine,
+        "quantized::matmul: a per-channel quantized mat2 must be at least 2D");
+
+    // Promote vectors to matrices and remember which dimensions to drop.
+    Tensor a = qa.int_repr();
+    Tensor b = qb.int_repr();
+    if (dim_a == 1) {
+      a = a.unsqueeze(0);
+    }
+    if (dim_b == 1) {
+      b = b.unsqueeze(1);
+    }
+    const int64_t M = a.size(-2);
+    const int64_t K = a.size(-1);
+    const int64_t N = b.size(-1);
+    TORCH_CHECK(
+        b.size(-2) == K,
+        "quantized::matmul: shapes ", qa.sizes(), " and ", qb.sizes(),
+        " cannot be multiplied");
+
+    const IntArrayRef batch_a = a.sizes().slice(0, a.dim() - 2);
+    const IntArrayRef batch_b = b.sizes().slice(0, b.dim() - 2);
+    std::vector<int64_t> batch_shape = infer_size(batch_a, batch_b);
+    const int64_t batch = std::accumulate(
+        batch_shape.begin(), batch_shape.end(), int64_t(1),
+        std::multiplies<int64_t>());
+
+    std::vector<int64_t> a_shape(batch_shape);
+    a_shape.insert(a_shape.end(), {M, K});
+    std::vector<int64_t> b_shape(batch_shape);
+    b_shape.insert(b_shape.end(), {K, N});
+    a = a.expand(a_shape).reshape({batch, M, K}).contiguous();
+    b = b.expand(b_shape).reshape({batch, K, N}).contiguous();
+
+    std::vector<int64_t> out_shape(batch_shape);
+    if (dim_a > 1) {
+      out_shape.push_back(M);
+    }
+    if (dim_b > 1) {
+      out_shape.push_back(N);
+    }
+    return qmatmul_impl(qa, qb, a, b, out_shape, scale, zero_point);
+  }
+};
+
+TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
+  m.impl("matmul", QMatmul::run);
+  m.impl("bmm",    QBmm::run);
+}
+
+}  // namespace
+}}  // namespace at::native
@@ -4,6 +4,7 @@
 namespace qnnpack {
 class PrePackConvWeights final {
  public:
+  // bias may be null to pack zero biases, to be set with updateBias.
   PrePackConvWeights(const conv_param_t& conv_param, const uint8_t* kernel, const int32_t* bias);
 
   void* getPackedWeights() const
@@ -16,6 +17,11 @@ class PrePackConvWeights final {
     return output_channels_;
   }
 
+  // Replaces the biases in the packed weights with bias, or zeros if it is
+  // null, without repacking the kernel, e.g. when the input scale the biases
+  // are quantized with changes.
+  void updateBias(const int32_t* bias);
+
   ~PrePackConvWeights()
   {
     if (packed_weights_ != nullptr) {
@@ -30,6 +36,14 @@ class PrePackConvWeights final {
  private:
   void* packed_weights_ = nullptr;
   int64_t output_channels_;
+  // Where the biases are in packed_weights_: bias_groups_ groups,
+  // bias_group_stride_ bytes apart, of bias_group_channels_ channels in blocks
+  // of bias_nr_, bias_block_size_ bytes apart.
+  size_t bias_groups_;
+  size_t bias_group_channels_;
+  size_t bias_group_stride_;
+  uint32_t bias_nr_;
+  size_t bias_block_size_;
 };
 
 class PackBMatrix final {
@@ -57,6 +71,10 @@ class PackBMatrix final {
     return output_channels_;
   }
 
+  // Replaces the biases in the packed weights with bias, or zeros if it is
+  // null, without repacking the kernel.
+  void updateBias(const int32_t* bias);
+
   ~PackBMatrix()
   {
     if (packed_weights_ != nullptr) {
@@ -72,6 +90,8 @@ class PackBMatrix final {
   void* packed_weights_ = nullptr;
   size_t input_channels_;
   size_t output_channels_;
+  uint32_t nr_;
+  size_t k_stride_;
 };
 
 enum pytorch_qnnp_status qnnpackLinear(
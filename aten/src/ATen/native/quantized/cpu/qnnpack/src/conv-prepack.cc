@@ -16,10 +16,23 @@ PrePackConvWeights::PrePackConvWeights(
   const uint32_t groups = conv_p.groups;
 
   const size_t kernel_size = kernel_height * kernel_width;
+  bias_groups_ = groups;
+  bias_group_channels_ = conv_p.group_output_channels;
   switch (ukernel_type) {
     case pytorch_qnnp_ukernel_type_dwconv: {
       const uint32_t cr = pytorch_qnnp_params.q8dw9.cr;
       const uint32_t c_stride = (groups + (cr - 1)) & -cr;
+      // Depthwise weights hold one group of all the channels. A 5x5 kernel
+      // is packed in three passes, and only the first one holds biases, with
+      // 10 of the 25 weights.
+      bias_groups_ = 1;
+      bias_group_channels_ = groups;
+      bias_group_stride_ = 0;
+      bias_nr_ = cr;
+      bias_block_size_ =
+          (sizeof(uint8_t) * (kernel_size == 25 ? 10 : kernel_size) +
+           sizeof(int32_t)) *
+          cr;
       const size_t packed_weights_size =
           (sizeof(uint8_t) * kernel_size + sizeof(int32_t)) * c_stride;
       packed_weights_ = malloc(packed_weights_size);
@@ -100,6 +113,9 @@ PrePackConvWeights::PrePackConvWeights(
       const size_t packed_group_weights_size =
           (sizeof(uint8_t) * kernel_size * k_stride + sizeof(int32_t)) *
           n_stride;
+      bias_group_stride_ = packed_group_weights_size;
+      bias_nr_ = nr;
+      bias_block_size_ = (sizeof(uint8_t) * k_stride + sizeof(int32_t)) * nr;
       packed_weights_ = malloc(packed_group_weights_size * groups);
       if (packed_weights_ == nullptr) {
         pytorch_qnnp_log_error(
@@ -120,7 +136,7 @@ PrePackConvWeights::PrePackConvWeights(
             kernel +
                 group * conv_p.group_output_channels *
                     conv_p.group_input_channels,
-            bias + group * conv_p.group_output_channels,
+            bias ? bias + group * conv_p.group_output_channels : nullptr,
             (void*)((uintptr_t)packed_weights_ + group * packed_group_weights_size));
       }
       break;
@@ -135,6 +151,10 @@ PrePackConvWeights::PrePackConvWeights(
       const size_t packed_group_weights_size =
           (sizeof(uint8_t) * kernel_size * k_stride + sizeof(int32_t)) *
           n_stride;
+      bias_group_stride_ = packed_group_weights_size;
+      bias_nr_ = nr;
+      bias_block_size_ =
+          (sizeof(uint8_t) * kernel_size * k_stride + sizeof(int32_t)) * nr;
       packed_weights_ = malloc(packed_group_weights_size * groups);
       if (packed_weights_ == nullptr) {
         pytorch_qnnp_log_error(
@@ -159,7 +179,7 @@ PrePackConvWeights::PrePackConvWeights(
                 kernel +
                     group * conv_p.group_output_channels *
                         conv_p.group_input_channels,
-                bias + group * conv_p.group_output_channels,
+                bias ? bias + group * conv_p.group_output_channels : nullptr,
                 (void*)((uintptr_t)packed_weights_ + group * packed_group_weights_size));
           }
           break;
@@ -174,7 +194,7 @@ PrePackConvWeights::PrePackConvWeights(
                 kernel +
                     group * conv_p.group_output_channels * kernel_size *
                         conv_p.group_input_channels,
-                bias + group * conv_p.group_output_channels,
+                bias ? bias + group * conv_p.group_output_channels : nullptr,
                 (void*)((uintptr_t)packed_weights_ + group * packed_group_weights_size));
           }
           break;
@@ -186,5 +206,16 @@ PrePackConvWeights::PrePackConvWeights(
     default:
       PYTORCH_QNNP_UNREACHABLE;
   }
-} // namespace qnnpack
+}
+
+void PrePackConvWeights::updateBias(const int32_t* bias) {
+  for (size_t group = 0; group < bias_groups_; group++) {
+    pytorch_pack_update_bias(
+        bias_group_channels_,
+        bias_nr_,
+        bias_block_size_,
+        bias ? bias + group * bias_group_channels_ : nullptr,
+        (void*)((uintptr_t)packed_weights_ + group * bias_group_stride_));
+  }
+}
 } // namespace qnnpack
@@ -28,6 +28,8 @@ PackBMatrix::PackBMatrix(
 
   input_channels_ = input_channels;
   output_channels_ = output_channels;
+  nr_ = nr;
+  k_stride_ = k_stride;
   packed_weights_ =
       malloc(n_stride * (k_stride * sizeof(uint8_t) + sizeof(int32_t)));
   if (packed_weights_ == NULL) {
@@ -51,4 +53,13 @@ PackBMatrix::PackBMatrix(
       bias,
       packed_weights_);
 }
+
+void PackBMatrix::updateBias(const int32_t* bias) {
+  pytorch_pack_update_bias(
+      output_channels_,
+      nr_,
+      nr_ * (k_stride_ * sizeof(uint8_t) + sizeof(int32_t)),
+      bias,
+      packed_weights_);
+}
 } // namespace qnnpack
@@ -99,6 +99,29 @@ static inline void pytorch_pack_q8gemm_wrq(
   }
 }
 
+/*
+ * Overwrites the biases of nc output channels in weights packed in blocks of
+ * nr channels, block_size bytes apart, each starting with its nr biases (the
+ * *_wrq and *_brq layouts), leaving the kernel as it is. b may be NULL for zero
+ * biases.
+ */
+static inline void pytorch_pack_update_bias(
+    const size_t nc,
+    const uint32_t nr,
+    const size_t block_size,
+    const int32_t* const b,
+    void* const packed_w) {
+  for (size_t nr_block_start = 0; nr_block_start < nc; nr_block_start += nr) {
+    const size_t nr_block_size = min(nc - nr_block_start, nr);
+    int32_t* const packed_b = (int32_t*)((uintptr_t)packed_w +
+        (nr_block_start / nr) * block_size);
+    for (size_t nr_block_offset = 0; nr_block_offset < nr_block_size;
+         nr_block_offset++) {
+      packed_b[nr_block_offset] = b ? b[nr_block_start + nr_block_offset] : 0;
+    }
+  }
+}
+
 static inline void pytorch_pack_q8conv_wdq(
     size_t n,
     size_t ks,
@@ -18,11 +18,13 @@ struct QnnpackOperatorDeleter {
 // For PyTorch Mobile, once the model is scripted and serialized we don't need
 // to call unpack, so we can save some memory by checking for this case and free
 // the original weights after packing.
-// Input scale is set to null in pre-pack step. QNNPACK needs bias quantized
-// with input scale which is available at runtime in pytorch. During runtime if
-// input scale value changes then we requantize bias with the updated scale. For
-// inference we expect the graph to be static so the input scale should not
-// change across consecutive inference calls.
+// The weights are packed in the pre-pack step, with zero biases, and
+// input_scale set to null. QNNPACK needs bias quantized with input scale which
+// is available at runtime in pytorch, so the first run, and any run where the
+// input scale value changes, requantizes bias with that scale and patches it
+// into the packed weights, without repacking them; input_scale is the scale of
+// the packed biases. For inference we expect the graph to be static so the
+// input scale should not change across consecutive inference calls.
 struct PackedLinearWeightsQnnp : public LinearPackedParamsBase {
   PackedLinearWeightsQnnp(
       std::unique_ptr<qnnpack::PackBMatrix> w,
@@ -1,9 +1,13 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/NumericLimits.cuh>
 #include <ATen/native/quantized/fake_quant_affine.h>
+#include <ATen/native/SharedReduceOps.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cuda/Loops.cuh>
+#include <ATen/native/cuda/Reduce.cuh>
 #include <cmath>
 
 /* Fake quantize a tensor
@@ -69,8 +73,124 @@ void fake_quantize_grad_tensor_kernel_cuda(
     });
 }
 
+// One pass writing both the output and the mask, gpu_kernel has a single
+// output. The scale and zero point are loaded on the device.
+__global__ void fake_quantize_tensor_cachemask_kernel(
+    const float* input,
+    float* output,
+    bool* mask,
+    const float* sc,
+    const int64_t* z_point,
+    int64_t quant_min,
+    int64_t quant_max,
+    int64_t numel) {
+  const float scale = *sc;
+  const int64_t zero_point = *z_point;
+  const float inv_scale = 1.0f / scale;
+  for (int64_t i = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x;
+       i < numel;
+       i += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    const int64_t Xq = std::nearbyint(input[i] * inv_scale + zero_point);
+    output[i] = (fminf(quant_max, fmaxf(quant_min, Xq)) - zero_point) * scale;
+    mask[i] = Xq >= quant_min && Xq <= quant_max;
+  }
+}
+
+void fake_quantize_tensor_cachemask_kernel_cuda(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    const Tensor& sc,
+    const Tensor& z_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  // scalar type of this function is guaranteed to be float
+  const int64_t numel = input.numel();
+  const int64_t threads = 512;
+  const int64_t blocks = std::min<int64_t>(
+      (numel + threads - 1) / threads,
+      at::cuda::getCurrentDeviceProperties()->maxGridSize[0]);
+  fake_quantize_tensor_cachemask_kernel<<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(
+      input.data_ptr<float>(),
+      output.data_ptr<float>(),
+      mask.data_ptr<bool>(),
+      sc.data_ptr<float>(),
+      z_point.data_ptr<int64_t>(),
+      quant_min,
+      quant_max,
+      numel);
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+void fake_quant_min_max_cuda(TensorIterator& iter) {
+  gpu_reduce_kernel<float, float>(
+      iter,
+      MinMaxOps<float, thrust::tuple<float, float>>{},
+      thrust::pair<float, float>(
+          at::numeric_limits<float>::upper_bound(),
+          at::numeric_limits<float>::lower_bound()));
+}
+
+__global__ void fake_quant_update_qparams_kernel(
+    const float* x_min,
+    const float* x_max,
+    float* running_min,
+    float* running_max,
+    float* sc,
+    int64_t* z_point,
+    float averaging_const,
+    int64_t quant_min,
+    int64_t quant_max,
+    bool init,
+    bool symmetric_quant) {
+  update_moving_average_qparams(
+      *x_min,
+      *x_max,
+      running_min,
+      running_max,
+      sc,
+      z_point,
+      averaging_const,
+      quant_min,
+      quant_max,
+      init,
+      symmetric_quant);
+}
+
+// A single thread: this is a handful of scalar operations, launched on the
+// stream instead of round-tripping the min and max through the host.
+void fake_quant_update_qparams_cuda(
+    Tensor& running_min,
+    Tensor& running_max,
+    Tensor& sc,
+    Tensor& z_point,
+    const Tensor& x_min,
+    const Tensor& x_max,
+    float averaging_const,
+    int64_t quant_min,
+    int64_t quant_max,
+    bool init,
+    bool symmetric_quant) {
+  fake_quant_update_qparams_kernel<<<1, 1, 0, at::cuda::getCurrentCUDAStream()>>>(
+      x_min.data_ptr<float>(),
+      x_max.data_ptr<float>(),
+      running_min.data_ptr<float>(),
+      running_max.data_ptr<float>(),
+      sc.data_ptr<float>(),
+      z_point.data_ptr<int64_t>(),
+      averaging_const,
+      quant_min,
+      quant_max,
+      init,
+      symmetric_quant);
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
 REGISTER_DISPATCH(fake_quant_tensor_stub, &fake_quantize_tensor_kernel_cuda);
 REGISTER_DISPATCH(fake_quant_grad_tensor_stub, &fake_quantize_grad_tensor_kernel_cuda);
+REGISTER_DISPATCH(fake_quant_tensor_cachemask_stub, &fake_quantize_tensor_cachemask_kernel_cuda);
+REGISTER_DISPATCH(fake_quant_min_max_stub, &fake_quant_min_max_cuda);
+REGISTER_DISPATCH(fake_quant_update_qparams_stub, &fake_quant_update_qparams_cuda);
 
 // Fake quantize per channel
 
@@ -3,6 +3,8 @@
 #include <ATen/ATen.h>
 #include <ATen/native/DispatchStub.h>
 
+#include <cmath>
+
 namespace at {
 
 struct TensorIterator;
@@ -29,6 +31,79 @@ using fake_quant_grad_tensor_fn = void (*)(
 DECLARE_DISPATCH(fake_quant_tensor_fn, fake_quant_tensor_stub);
 DECLARE_DISPATCH(fake_quant_grad_tensor_fn, fake_quant_grad_tensor_stub);
 
+// Like fake_quant_tensor_fn, with the scale and zero point read from
+// 1-element tensors on the device of the input, so that CUDA callers don't
+// have to synchronize. Also sets mask to whether each element was inside
+// [quant_min, quant_max], which is all the backward pass needs.
+// input, output and mask are dense with the same strides.
+using fake_quant_tensor_cachemask_fn = void (*)(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    const Tensor& sc,
+    const Tensor& z_point,
+    int64_t quant_min,
+    int64_t quant_max);
+
+// Reduces the input of iter into its two outputs, the min and the max.
+using fake_quant_min_max_fn = void (*)(TensorIterator& iter);
+
+// The moving average observer step, on the device of its arguments: folds
+// x_min and x_max into running_min and running_max (or sets them, if init),
+// and computes the new scale and zero_point from them.
+using fake_quant_update_qparams_fn = void (*)(
+    Tensor& running_min,
+    Tensor& running_max,
+    Tensor& sc,
+    Tensor& z_point,
+    const Tensor& x_min,
+    const Tensor& x_max,
+    float averaging_const,
+    int64_t quant_min,
+    int64_t quant_max,
+    bool init,
+    bool symmetric_quant);
+
+DECLARE_DISPATCH(fake_quant_tensor_cachemask_fn, fake_quant_tensor_cachemask_stub);
+DECLARE_DISPATCH(fake_quant_min_max_fn, fake_quant_min_max_stub);
+DECLARE_DISPATCH(fake_quant_update_qparams_fn, fake_quant_update_qparams_stub);
+
+// Shared by the CPU and CUDA fake_quant_update_qparams kernels, mirrors
+// MovingAverageMinMaxObserver.forward and MinMaxObserver._calculate_qparams.
+C10_HOST_DEVICE inline void update_moving_average_qparams(
+    float x_min,
+    float x_max,
+    float* running_min,
+    float* running_max,
+    float* sc,
+    int64_t* z_point,
+    float averaging_const,
+    int64_t quant_min,
+    int64_t quant_max,
+    bool init,
+    bool symmetric_quant) {
+  float min_val = init ? x_min : *running_min + averaging_const * (x_min - *running_min);
+  float max_val = init ? x_max : *running_max + averaging_const * (x_max - *running_max);
+  *running_min = min_val;
+  *running_max = max_val;
+
+  // torch.finfo(torch.float32).eps
+  const float eps = 1.1920928955078125e-07f;
+  min_val = min_val < 0.0f ? min_val : 0.0f;
+  max_val = max_val > 0.0f ? max_val : 0.0f;
+  if (symmetric_quant) {
+    max_val = -min_val > max_val ? -min_val : max_val;
+    const float scale = max_val / (static_cast<float>(quant_max - quant_min) / 2);
+    *sc = scale > eps ? scale : eps;
+    *z_point = quant_min < 0 ? 0 : 128;
+  } else {
+    const float scale = (max_val - min_val) / static_cast<float>(quant_max - quant_min);
+    *sc = scale > eps ? scale : eps;
+    const int64_t zero_point = quant_min - static_cast<int64_t>(std::nearbyint(min_val / *sc));
+    *z_point = zero_point < quant_min ? quant_min : (zero_point > quant_max ? quant_max : zero_point);
+  }
+}
+
 using fake_quant_per_channel_fn = void (*)(
     TensorIterator &iter,
     int64_t quant_min,
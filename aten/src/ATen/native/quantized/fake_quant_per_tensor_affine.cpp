@@ -5,6 +5,9 @@
 #include <ATen/native/cpu/Loops.h>
 #include <ATen/native/quantized/fake_quant_affine.h>
 
+#include <tuple>
+#include <vector>
+
 // FakeQuantize Op for PerTensorAffine quantization scheme.
 namespace at {
 namespace native {
@@ -12,6 +15,9 @@ namespace native {
 // Use REGISTER_DISPATCH to run CPU and CUDA backend.
 DEFINE_DISPATCH(fake_quant_tensor_stub);
 DEFINE_DISPATCH(fake_quant_grad_tensor_stub);
+DEFINE_DISPATCH(fake_quant_tensor_cachemask_stub);
+DEFINE_DISPATCH(fake_quant_min_max_stub);
+DEFINE_DISPATCH(fake_quant_update_qparams_stub);
 
 /* Fake-quantizes the 'inputs' tensor.
 Args:
@@ -94,5 +100,148 @@ Tensor fake_quantize_per_tensor_affine_backward(
   return dX;
 }
 
+/* Fake-quantizes the 'inputs' tensor, saving a mask for the backward pass.
+Args:
+  self: Forward input tensor.
+  scale: 1-element float tensor, scale of per tensor affine quantization
+  zero_point: 1-element int64 tensor, zero_point of per tensor affine
+              quantization
+  quant_min: minimum quantized value
+  quant_max: maximum quantized value
+Returns:
+  Fake quantized tensor (float dtype), and a bool mask of the elements that
+  were inside [quant_min, quant_max]: the gradient is grad * mask.
+
+Notes:
+  - scale and zero_point are read on the device, so nothing is synchronized.
+  - The backward pass only needs the mask, so it doesn't keep the input
+    alive or quantize it again.
+*/
+std::tuple<Tensor, Tensor> _fake_quantize_per_tensor_affine_cachemask(
+    const Tensor& self,
+    const Tensor& scale,
+    const Tensor& zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  TORCH_CHECK(self.scalar_type() == ScalarType::Float);
+  TORCH_CHECK(
+      quant_min <= quant_max,
+      "`quant_min` should be less than or \
+        equal to `quant_max`.");
+  TORCH_CHECK(
+      scale.numel() == 1 && scale.scalar_type() == ScalarType::Float,
+      "`scale` must be a 1-element float tensor.");
+  TORCH_CHECK(
+      zero_point.numel() == 1 && zero_point.scalar_type() == ScalarType::Long,
+      "`zero_point` must be a 1-element int64 tensor.");
+  TORCH_CHECK(
+      scale.device() == self.device() && zero_point.device() == self.device(),
+      "`scale` and `zero_point` must be on the device of the input.");
+
+  auto X = self.contiguous(self.suggest_memory_format());
+  auto Y = at::empty_like(X, X.options(), MemoryFormat::Preserve);
+  auto mask = at::empty_like(X, X.options().dtype(kBool), MemoryFormat::Preserve);
+  if (X.numel() > 0) {
+    fake_quant_tensor_cachemask_stub(
+        X.device().type(), Y, mask, X, scale, zero_point, quant_min, quant_max);
+  }
+  return std::make_tuple(Y, mask);
+}
+
+/* Moving average min/max observer and per tensor fake-quantization, fused.
+Args:
+  self: Forward input tensor.
+  running_min, running_max: float tensors with the moving average min and
+                            max, updated in place. When empty they are
+                            resized and set to the min and max of self.
+  scale, zero_point: 1-element tensors with the quantization parameters,
+                     updated in place when observer_on.
+  averaging_const: weight of the current min and max in the moving averages
+  quant_min: minimum quantized value
+  quant_max: maximum quantized value
+  observer_on: whether to update the statistics and quantization parameters
+  symmetric_quant: compute per_tensor_symmetric quantization parameters
+  reduce_range: compute quantization parameters for half of the range
+Returns:
+  Fake quantized tensor (float dtype).
+
+Notes:
+  - Equivalent to a MovingAverageMinMaxObserver followed by
+    fake_quantize_per_tensor_affine with its quantization parameters, but
+    the min and max come from a single reduction and everything stays on
+    the device of the input.
+*/
+Tensor _fused_moving_avg_obs_fake_quant(
+    const Tensor& self,
+    Tensor& running_min,
+    Tensor& running_max,
+    Tensor& scale,
+    Tensor& zero_point,
+    double averaging_const,
+    int64_t quant_min,
+    int64_t quant_max,
+    bool observer_on,
+    bool symmetric_quant,
+    bool reduce_range) {
+  if (observer_on) {
+    TORCH_CHECK(self.scalar_type() == ScalarType::Float);
+    TORCH_CHECK(self.numel() > 0, "Can't observe an empty tensor.");
+    TORCH_CHECK(
+        quant_min <= quant_max,
+        "`quant_min` should be less than or \
+          equal to `quant_max`.");
+    TORCH_CHECK(
+        running_min.scalar_type() == ScalarType::Float &&
+            running_max.scalar_type() == ScalarType::Float,
+        "`running_min` and `running_max` must be float tensors.");
+    TORCH_CHECK(
+        running_min.device() == self.device() &&
+            running_max.device() == self.device() &&
+            scale.device() == self.device() &&
+            zero_point.device() == self.device(),
+        "The observer state must be on the device of the input.");
+    TORCH_CHECK(
+        scale.numel() == 1 && scale.scalar_type() == ScalarType::Float &&
+            zero_point.numel() == 1 && zero_point.scalar_type() == ScalarType::Long,
+        "`scale` and `zero_point` must be 1-element float and int64 tensors.");
+    const bool init = running_min.numel() == 0 || running_max.numel() == 0;
+    if (init) {
+      running_min.resize_({});
+      running_max.resize_({});
+    }
+    TORCH_CHECK(
+        running_min.numel() == 1 && running_max.numel() == 1,
+        "`running_min` and `running_max` must have one element.");
+
+    // Both reduced in one pass, into 1-element tensors of the input's rank.
+    std::vector<int64_t> reduced_size(self.dim(), 1);
+    auto x_min = at::empty(reduced_size, self.options());
+    auto x_max = at::empty(reduced_size, self.options());
+    auto iter = TensorIterator::reduce_op(x_min, x_max, self);
+    fake_quant_min_max_stub(self.device().type(), iter);
+
+    // As in MinMaxObserver, reduce_range computes the quantization
+    // parameters for [0, 127] instead of [0, 255], or [-64, 63] instead of
+    // [-128, 127].
+    const int64_t qparams_min = reduce_range ? quant_min / 2 : quant_min;
+    const int64_t qparams_max = reduce_range ? quant_max / 2 : quant_max;
+    fake_quant_update_qparams_stub(
+        self.device().type(),
+        running_min,
+        running_max,
+        scale,
+        zero_point,
+        x_min,
+        x_max,
+        averaging_const,
+        qparams_min,
+        qparams_max,
+        init,
+        symmetric_quant);
+  }
+  return std::get<0>(at::_fake_quantize_per_tensor_affine_cachemask(
+      self, scale, zero_point, quant_min, quant_max));
+}
+
 } // namespace native
 } // namespace at
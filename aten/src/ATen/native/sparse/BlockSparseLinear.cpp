@@ -0,0 +1,138 @@
+// Linear layers on block-sparse weights, for pruned models whose weights are
+// zero in whole blocks. See cpu/BlockSparseLinearKernel.h for the format.
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/cpu/BlockSparseLinearKernel.h>
+
+#include <tuple>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+void check_block_sparse_linear_args(
+    const Tensor& input,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& bias) {
+  TORCH_CHECK(input.dim() >= 1, "block_sparse_linear: input must have at least one dimension");
+  TORCH_CHECK(crow_indices.dim() == 1 && crow_indices.size(0) >= 1 &&
+              crow_indices.scalar_type() == kLong,
+              "block_sparse_linear: crow_indices must be a non-empty int64 vector");
+  TORCH_CHECK(col_indices.dim() == 1 && col_indices.scalar_type() == kLong,
+              "block_sparse_linear: col_indices must be an int64 vector");
+  TORCH_CHECK(values.dim() == 3 && values.size(0) == col_indices.size(0),
+              "block_sparse_linear: values must be [nnz_blocks, block_cols, block_rows], got ",
+              values.sizes(), " for ", col_indices.size(0), " blocks");
+  TORCH_CHECK(values.scalar_type() == input.scalar_type(),
+              "block_sparse_linear: expected values of type ", input.scalar_type(),
+              ", got ", values.scalar_type());
+  TORCH_CHECK(values.size(1) > 0 && input.size(-1) % values.size(1) == 0,
+              "block_sparse_linear: in_features (", input.size(-1),
+              ") must be a multiple of the block columns (", values.size(1), ")");
+  int64_t out_features = (crow_indices.size(0) - 1) * values.size(2);
+  TORCH_CHECK(!bias.defined() || (bias.dim() == 1 && bias.size(0) == out_features),
+              "block_sparse_linear: expected a bias of size ", out_features);
+}
+
+std::vector<int64_t> block_sparse_linear_output_size(const Tensor& input, int64_t out_features) {
+  auto sizes = input.sizes().vec();
+  sizes.back() = out_features;
+  return sizes;
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor, Tensor> _block_sparse_linear_pack(const Tensor& weight, IntArrayRef blocksize) {
+  TORCH_CHECK(weight.dim() == 2, "_block_sparse_linear_pack: expected a 2-d weight, got ", weight.dim(), " dims");
+  TORCH_CHECK(blocksize.size() == 2 && blocksize[0] > 0 && blocksize[1] > 0,
+              "_block_sparse_linear_pack: expected two positive block sizes, got ", blocksize);
+  const int64_t out_features = weight.size(0);
+  const int64_t in_features = weight.size(1);
+  const int64_t block_rows = blocksize[0];
+  const int64_t block_cols = blocksize[1];
+  TORCH_CHECK(out_features % block_rows == 0 && in_features % block_cols == 0,
+              "_block_sparse_linear_pack: weight of size ", weight.sizes(),
+              " can't be split into blocks of size ", blocksize);
+  const int64_t num_block_rows = out_features / block_rows;
+  const int64_t num_block_cols = in_features / block_cols;
+
+  // [block row, block col, block_cols, block_rows]: blocks transposed
+  auto blocks = weight.reshape({num_block_rows, block_rows, num_block_cols, block_cols})
+                    .permute({0, 2, 3, 1});
+  auto nonzero_blocks = blocks.ne(0).reshape({num_block_rows, num_block_cols, -1}).any(-1);
+  // nonzero() lists the blocks by block row, then block column
+  auto block_indices = nonzero_blocks.nonzero();
+  auto crow_indices = at::zeros({num_block_rows + 1}, weight.options().dtype(kLong));
+  crow_indices.narrow(0, 1, num_block_rows).copy_(nonzero_blocks.sum(1).cumsum(0));
+  auto col_indices = block_indices.select(1, 1).contiguous();
+  auto values = blocks.reshape({num_block_rows * num_block_cols, block_cols, block_rows})
+                    .index_select(0, block_indices.select(1, 0) * num_block_cols + col_indices);
+  return std::make_tuple(crow_indices, col_indices, values);
+}
+
+// Any device: gathers the input blocks each weight block multiplies, computes
+// all block products with a single bmm and sums them per block row. On CUDA
+// the bmm runs on tensor cores for half inputs and suitable block sizes.
+Tensor block_sparse_linear_generic(
+    const Tensor& input,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& bias) {
+  check_block_sparse_linear_args(input, crow_indices, col_indices, values, bias);
+  const int64_t num_block_rows = crow_indices.size(0) - 1;
+  const int64_t block_cols = values.size(1);
+  const int64_t block_rows = values.size(2);
+  const int64_t out_features = num_block_rows * block_rows;
+  auto input_2d = input.reshape({-1, input.size(-1)});
+  const int64_t batch = input_2d.size(0);
+
+  // [nnz_blocks, batch, block_cols]
+  auto input_blocks = input_2d.reshape({batch, -1, block_cols})
+                          .index_select(1, col_indices)
+                          .transpose(0, 1);
+  // [nnz_blocks, batch, block_rows]
+  auto output_blocks = at::bmm(input_blocks, values);
+  auto row_indices = at::repeat_interleave(
+      crow_indices.narrow(0, 1, num_block_rows) - crow_indices.narrow(0, 0, num_block_rows));
+  auto output = at::zeros({num_block_rows, batch, block_rows}, input.options())
+                    .index_add_(0, row_indices, output_blocks)
+                    .permute({1, 0, 2})
+                    .reshape({batch, out_features});
+  if (bias.defined()) {
+    output.add_(bias);
+  }
+  return output.view(block_sparse_linear_output_size(input, out_features));
+}
+
+Tensor block_sparse_linear_cpu(
+    const Tensor& input,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& bias) {
+  if (input.scalar_type() != kFloat && input.scalar_type() != kDouble) {
+    return block_sparse_linear_generic(input, crow_indices, col_indices, values, bias);
+  }
+  check_block_sparse_linear_args(input, crow_indices, col_indices, values, bias);
+  const int64_t out_features = (crow_indices.size(0) - 1) * values.size(2);
+  auto input_2d = input.reshape({-1, input.size(-1)}).contiguous();
+  auto output = at::empty({input_2d.size(0), out_features}, input.options());
+  block_sparse_linear_stub(
+      kCPU,
+      output,
+      input_2d,
+      crow_indices.contiguous(),
+      col_indices.contiguous(),
+      values.contiguous(),
+      bias.defined() ? bias.contiguous() : bias);
+  return output.view(block_sparse_linear_output_size(input, out_features));
+}
+
+DEFINE_DISPATCH(block_sparse_linear_stub);
+
+}} // namespace at::native
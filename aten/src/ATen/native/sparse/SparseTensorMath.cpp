@@ -558,6 +558,130 @@ SparseTensor& add_out_sparse_cpu(SparseTensor& r, const SparseTensor& t, const S
   }
 }
 
+// --------------------------------------------------------------------
+// _sparse_add_and_coalesce(SparseTensor, SparseTensor)
+//
+// Equivalent to (self + other).coalesce(), but never materializes the
+// uncoalesced sum. Each input is sorted by its flattened indices only if it
+// is not already coalesced, the two sorted runs are merged, and every output
+// row is reduced exactly once. This is what gradient accumulation uses when
+// sparse gradients are merged eagerly, where one side is usually the already
+// coalesced running sum.
+// --------------------------------------------------------------------
+
+namespace {
+
+// Returns the flattened indices of `t` in ascending order together with the
+// position in `t` of each of them; `order` is left undefined when `t` is
+// coalesced and its indices are already in order.
+std::tuple<LongTensor, LongTensor> sorted_flat_indices(const SparseTensor& t) {
+  LongTensor keys = flatten_indices(t._indices(), t.sizes()).contiguous();
+  if (t.is_coalesced()) {
+    return std::make_tuple(keys, LongTensor());
+  }
+  return keys.sort(0);
+}
+
+} // namespace
+
+SparseTensor _sparse_add_and_coalesce_cpu(const SparseTensor& self, const SparseTensor& other) {
+  TORCH_CHECK(self.is_sparse() && other.is_sparse(), "_sparse_add_and_coalesce: expected sparse tensors");
+  TORCH_CHECK(!self.is_cuda() && !other.is_cuda(), "_sparse_add_and_coalesce: expected CPU tensors");
+  TORCH_CHECK(self.sizes().equals(other.sizes()), "_sparse_add_and_coalesce: expected sizes of 'self' and 'other' to match, but ", self.sizes(), " != ", other.sizes());
+  TORCH_CHECK(is_same_density(self, other), "_sparse_add_and_coalesce: expected 'self' and 'other' to have same density, but 'self' has ", self.sparse_dim(), " sparse dimensions while 'other' has ", other.sparse_dim(), " sparse dimensions");
+
+  auto commonDtype = promoteTypes(self.scalar_type(), other.scalar_type());
+  const int64_t sparse_dim = self.sparse_dim();
+  const int64_t self_nnz = self._nnz(), other_nnz = other._nnz();
+
+  LongTensor self_keys, self_order, other_keys, other_order;
+  std::tie(self_keys, self_order) = sorted_flat_indices(self);
+  std::tie(other_keys, other_order) = sorted_flat_indices(other);
+  const int64_t* self_keys_ptr = self_keys.data_ptr<int64_t>();
+  const int64_t* other_keys_ptr = other_keys.data_ptr<int64_t>();
+  const int64_t* self_order_ptr = self_order.defined() ? self_order.data_ptr<int64_t>() : nullptr;
+  const int64_t* other_order_ptr = other_order.defined() ? other_order.data_ptr<int64_t>() : nullptr;
+
+  // Merge the two sorted runs. Source rows are numbered with `self` first, so
+  // row `i < self_nnz` is self's row i and row `i >= self_nnz` is other's row
+  // `i - self_nnz`; rows feeding output j are sources[segments[j], segments[j + 1]).
+  std::vector<int64_t> sources;
+  std::vector<int64_t> segments;
+  sources.reserve(self_nnz + other_nnz);
+  segments.reserve(self_nnz + other_nnz + 1);
+  int64_t self_i = 0, other_i = 0;
+  int64_t prev_key = 0;
+  while (self_i < self_nnz || other_i < other_nnz) {
+    int64_t key, source;
+    if (other_i >= other_nnz || (self_i < self_nnz && self_keys_ptr[self_i] <= other_keys_ptr[other_i])) {
+      key = self_keys_ptr[self_i];
+      source = self_order_ptr ? self_order_ptr[self_i] : self_i;
+      self_i++;
+    } else {
+      key = other_keys_ptr[other_i];
+      source = self_nnz + (other_order_ptr ? other_order_ptr[other_i] : other_i);
+      other_i++;
+    }
+    if (segments.empty() || key != prev_key) {
+      segments.push_back(sources.size());
+      prev_key = key;
+    }
+    sources.push_back(source);
+  }
+  const int64_t r_nnz = segments.size();
+  segments.push_back(sources.size());
+
+  Tensor self_values = self._values().to(commonDtype).contiguous();
+  Tensor other_values = other._values().to(commonDtype).contiguous();
+  LongTensor self_indices = self._indices().contiguous();
+  LongTensor other_indices = other._indices().contiguous();
+
+  LongTensor r_indices = at::empty({sparse_dim, r_nnz}, self_indices.options());
+  Tensor r_values = new_values_with_size_of(self_values, r_nnz);
+  const int64_t blockSize = r_nnz > 0 ? r_values.numel() / r_nnz : 0;
+
+  const int64_t* self_indices_ptr = self_indices.data_ptr<int64_t>();
+  const int64_t* other_indices_ptr = other_indices.data_ptr<int64_t>();
+  int64_t* r_indices_ptr = r_indices.data_ptr<int64_t>();
+
+  AT_DISPATCH_ALL_TYPES(
+      commonDtype, "_sparse_add_and_coalesce_cpu", [&] {
+        const scalar_t* self_values_ptr = self_values.data_ptr<scalar_t>();
+        const scalar_t* other_values_ptr = other_values.data_ptr<scalar_t>();
+        scalar_t* r_values_ptr = r_values.data_ptr<scalar_t>();
+        const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, blockSize));
+        at::parallel_for(0, r_nnz, grain_size, [&](int64_t start, int64_t end) {
+          for (int64_t j = start; j < end; j++) {
+            scalar_t* r_row = r_values_ptr + j * blockSize;
+            for (int64_t s = segments[j]; s < segments[j + 1]; s++) {
+              const int64_t source = sources[s];
+              const bool from_self = source < self_nnz;
+              const int64_t row = from_self ? source : source - self_nnz;
+              const scalar_t* values_row = (from_self ? self_values_ptr : other_values_ptr) + row * blockSize;
+              if (s == segments[j]) {
+                const int64_t* indices_ptr = from_self ? self_indices_ptr : other_indices_ptr;
+                const int64_t nnz = from_self ? self_nnz : other_nnz;
+                for (int64_t d = 0; d < sparse_dim; d++) {
+                  r_indices_ptr[d * r_nnz + j] = indices_ptr[d * nnz + row];
+                }
+                std::copy(values_row, values_row + blockSize, r_row);
+              } else {
+                THBlas_axpy<scalar_t>(blockSize, 1, const_cast<scalar_t*>(values_row), 1, r_row, 1);
+              }
+            }
+          }
+        });
+      });
+
+  SparseTensor r = at::_sparse_coo_tensor_with_dims_and_tensors(
+      sparse_dim, self.dense_dim(), self.sizes(), r_indices, r_values, self.options().dtype(commonDtype));
+  return r._coalesced_(true);
+}
+
+SparseTensor _sparse_add_and_coalesce_sparse(const SparseTensor& self, const SparseTensor& other) {
+  return at::add(self, other).coalesce();
+}
+
 // --------------------------------------------------------------------
 // add(Tensor, SparseTensor, Scalar)
 //    formerly known as spcadd
@@ -764,10 +888,10 @@ SparseTensor& mul_out_sparse_cpu(SparseTensor& r, const Tensor& t_, const Tensor
 // D = beta * D1 + alpha * mm(S, D2)
 // --------------------------------------------------------------------
 
+// `indices` must be sorted by row (duplicates allowed), which lets the
+// product be computed row by row from the CSR row pointers.
 template <typename scalar_t>
 void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j, int64_t dim_k, Tensor& r, Scalar beta, const Tensor& t, Scalar alpha, const Tensor& indices, const Tensor& values, const Tensor& dense) {
-  int64_t i;
-
   // r_ = alpha * sparse * dense
   scalar_t cast_alpha = alpha.to<scalar_t>();
   scalar_t cast_beta = beta.to<scalar_t>();
@@ -781,33 +905,44 @@ void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j,
     at::mul_out(r, t, scalar_to_tensor(beta));
   }
 
-  auto indices_accessor = indices.accessor<int64_t, 2>();
-
-  auto values_accessor = values.accessor<scalar_t, 1>();
+  LongTensor rows = indices.select(0, 0).contiguous();
+  LongTensor cols = indices.select(0, 1).contiguous();
+  Tensor values_contig = values.contiguous();
+  const int64_t* rows_ptr = rows.data_ptr<int64_t>();
+  const int64_t* cols_ptr = cols.data_ptr<int64_t>();
+  scalar_t* values_ptr = values_contig.data_ptr<scalar_t>();
   scalar_t* dense_ptr = dense.data_ptr<scalar_t>();
   scalar_t* r_ptr = r.data_ptr<scalar_t>();
 
+  for (int64_t i = 0; i < nnz; i++) {
+    int64_t row = rows_ptr[i];
+    int64_t col = cols_ptr[i];
+    if (col < 0 || col >= dim_j) {
+      AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
+    } else if (row < 0 || row >= dim_i) {
+      AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
+    }
+  }
+  LongTensor csr = _to_csr(rows_ptr, dim_i, nnz);
+  const int64_t* csr_ptr = csr.data_ptr<int64_t>();
+
   int64_t dense_stride0 = dense.stride(0);
   int64_t dense_stride1 = dense.stride(1);
   int64_t r_stride0 = r.stride(0);
   int64_t r_stride1 = r.stride(1);
-  for (i = 0; i < nnz; i++) {
-    scalar_t val = values_accessor[i];
-    int64_t row = indices_accessor[0][i];
-    int64_t col = indices_accessor[1][i];
-    if (col >= 0 && col < dim_j && row >= 0 && row < dim_i) {
-      THBlas_axpy<scalar_t>(dim_k,
-            cast_alpha * val,
-            dense_ptr + col * dense_stride0, dense_stride1,
-            r_ptr + row * r_stride0, r_stride1);
-    } else {
-      if (col < 0 || col >= dim_j) {
-        AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
-      } else {
-        AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
+
+  // Each output row is written by exactly one thread.
+  const int64_t work_per_row = std::max<int64_t>(1, (nnz / std::max<int64_t>(1, dim_i)) * dim_k);
+  at::parallel_for(0, dim_i, std::max<int64_t>(1, internal::GRAIN_SIZE / work_per_row), [&](int64_t start, int64_t end) {
+    for (int64_t row = start; row < end; row++) {
+      for (int64_t i = csr_ptr[row]; i < csr_ptr[row + 1]; i++) {
+        THBlas_axpy<scalar_t>(dim_k,
+              cast_alpha * values_ptr[i],
+              dense_ptr + cols_ptr[i] * dense_stride0, dense_stride1,
+              r_ptr + row * r_stride0, r_stride1);
       }
     }
-  }
+  });
 };
 
 Tensor& s_addmm_out_sparse_dense_cpu(
@@ -851,6 +986,12 @@ Tensor& s_addmm_out_sparse_dense_cpu(
 
   LongTensor indices = sparse_._indices();
   Tensor values      = sparse_._values();
+  if (!sparse_.is_coalesced()) {
+    // Only the row order matters; duplicate entries simply accumulate.
+    LongTensor perm = std::get<1>(indices.select(0, 0).sort());
+    indices = indices.index_select(1, perm);
+    values = values.index_select(0, perm);
+  }
 
   AT_DISPATCH_ALL_TYPES(
       values.scalar_type(), "addmm_sparse_dense", [&] {
@@ -0,0 +1,135 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/xnnpack/Factory.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+namespace internal {
+namespace activation {
+namespace {
+
+// Elementwise operators take their input as a batch of rows of channels. The
+// input and output are laid out contiguously in the memory format of the
+// input, so that is one row of all the elements, and the output keeps the
+// layout of the input.
+
+bool usable(const Tensor& input) {
+  return xnnpack::internal::available() &&
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      !input.requires_grad() &&
+      (input.numel() > 0) &&
+      true;
+}
+
+template <typename Setup>
+Tensor run(
+    const Tensor& input,
+    const xnn_operator_t xnn_op,
+    const char* const setup_name,
+    const Setup setup) {
+  const Operator op(xnn_op);
+  const c10::MemoryFormat memory_format = input.suggest_memory_format();
+
+  const Tensor input_padded_contig = allocate_padded_contiguous_if_needed(
+      input,
+      memory_format);
+
+  Tensor output_padded_contig = empty_with_tail_padding(
+      input_padded_contig.sizes(),
+      input_padded_contig.options().dtype(),
+      memory_format,
+      input_padded_contig.names());
+
+  const xnn_status setup_status = setup(
+      op.get(),                                   // operator
+      1u,                                         // batch_size
+      input_padded_contig.data_ptr<float>(),      // input
+      output_padded_contig.data_ptr<float>(),     // output
+      caffe2::xnnpack_threadpool());              // threadpool
+
+  TORCH_CHECK(xnn_status_success == setup_status, setup_name, " failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      op.get(),                       // operator
+      caffe2::xnnpack_threadpool());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_padded_contig;
+}
+
+} // namespace
+} // namespace activation
+} // namespace internal
+
+bool use_hardswish(const Tensor& input) {
+  return internal::activation::usable(input);
+}
+
+Tensor hardswish(const Tensor& input) {
+  xnn_operator_t hardswish_op{};
+
+  const xnn_status create_status = xnn_create_hardswish_nc_f32(
+      input.numel(),    // channels
+      input.numel(),    // input_stride
+      input.numel(),    // output_stride
+      0u,               // flags
+      &hardswish_op);   // operator
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_hardswish_nc_f32 failed!");
+
+  return internal::activation::run(
+      input,
+      hardswish_op,
+      "xnn_setup_hardswish_nc_f32",
+      xnn_setup_hardswish_nc_f32);
+}
+
+bool use_clamp(
+    const Tensor& input,
+    const c10::optional<Scalar> min,
+    const c10::optional<Scalar> max) {
+  return internal::activation::usable(input) &&
+      (min || max) &&
+      (!min || !max || (min->to<float>() <= max->to<float>())) &&
+      true;
+}
+
+Tensor clamp(
+    const Tensor& input,
+    const c10::optional<Scalar> min,
+    const c10::optional<Scalar> max) {
+  xnn_operator_t clamp_op{};
+
+  const xnn_status create_status = xnn_create_clamp_nc_f32(
+      input.numel(),      // channels
+      input.numel(),      // input_stride
+      input.numel(),      // output_stride
+      min ? min->to<float>() : -std::numeric_limits<float>::infinity(), // output_min
+      max ? max->to<float>() : +std::numeric_limits<float>::infinity(), // output_max
+      0u,                 // flags
+      &clamp_op);         // operator
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_clamp_nc_f32 failed!");
+
+  return internal::activation::run(
+      input,
+      clamp_op,
+      "xnn_setup_clamp_nc_f32",
+      xnn_setup_clamp_nc_f32);
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
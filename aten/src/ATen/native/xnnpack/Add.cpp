@@ -0,0 +1,145 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/ExpandUtils.h>
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/xnnpack/Factory.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+namespace internal {
+namespace add {
+namespace {
+
+// The sizes of a 4D tensor in the order its elements are laid out in memory
+// in MEMORY_FORMAT, which is how XNNPACK sees them.
+std::array<size_t, 4> memory_order_sizes(
+    const IntArrayRef sizes,
+    const c10::MemoryFormat memory_format) {
+  if (c10::MemoryFormat::ChannelsLast == memory_format) {
+    return {
+      static_cast<size_t>(sizes[Layout::Activation4D::batch]),
+      static_cast<size_t>(sizes[Layout::Activation4D::height]),
+      static_cast<size_t>(sizes[Layout::Activation4D::width]),
+      static_cast<size_t>(sizes[Layout::Activation4D::channels]),
+    };
+  }
+  return {
+    static_cast<size_t>(sizes[0]),
+    static_cast<size_t>(sizes[1]),
+    static_cast<size_t>(sizes[2]),
+    static_cast<size_t>(sizes[3]),
+  };
+}
+
+bool broadcastable(const IntArrayRef self, const IntArrayRef other) {
+  for (size_t i = 0u; i < self.size(); ++i) {
+    if ((self[i] != other[i]) && (self[i] != 1) && (other[i] != 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+} // namespace add
+} // namespace internal
+
+// Supports NHWC and NCHW FP32 addition of 4D tensors, with broadcasting and
+// without a scaling factor.
+
+bool use_add(const Tensor& self, const Tensor& other, const Scalar alpha) {
+  using namespace internal;
+
+  const auto usable = [](const Tensor& input) {
+    return (4 == input.dim()) &&
+        (c10::DeviceType::CPU == input.device().type()) &&
+        (kFloat == input.scalar_type()) &&
+        !input.requires_grad() &&
+        true;
+  };
+
+  return xnnpack::internal::available() &&
+      usable(self) &&
+      usable(other) &&
+      // Alpha
+      (alpha.isIntegral(true) ? (1 == alpha.to<int64_t>())
+                              : (1.0 == alpha.to<double>())) &&
+      // Output
+      internal::add::broadcastable(self.sizes(), other.sizes()) &&
+      (self.numel() > 0) &&
+      (other.numel() > 0) &&
+      true;
+}
+
+Tensor add(const Tensor& self, const Tensor& other) {
+  using namespace internal;
+
+  // Keep the layout of the larger operand, which is what XNNPACK computes in.
+  const c10::MemoryFormat memory_format = (self.numel() >= other.numel())
+      ? self.suggest_memory_format()
+      : other.suggest_memory_format();
+
+  const Tensor self_padded_contig = allocate_padded_contiguous_if_needed(
+      self,
+      memory_format);
+  const Tensor other_padded_contig = allocate_padded_contiguous_if_needed(
+      other,
+      memory_format);
+
+  Tensor output_padded_contig = empty_with_tail_padding(
+      infer_size(self.sizes(), other.sizes()),
+      self_padded_contig.options().dtype(),
+      memory_format,
+      self_padded_contig.names());
+
+  xnn_operator_t add_op{};
+
+  const xnn_status create_status = xnn_create_add_nd_f32(
+      -std::numeric_limits<float>::infinity(),  // output_min
+      +std::numeric_limits<float>::infinity(),  // output_max
+      0u,                                       // flags
+      &add_op);                                 // operator
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_add_nd_f32 failed!");
+
+  const Operator op(add_op);
+
+  const std::array<size_t, 4> self_sizes =
+      internal::add::memory_order_sizes(self.sizes(), memory_format);
+  const std::array<size_t, 4> other_sizes =
+      internal::add::memory_order_sizes(other.sizes(), memory_format);
+
+  const xnn_status setup_status = xnn_setup_add_nd_f32(
+      op.get(),                                   // operator
+      self_sizes.size(),                          // num_input1_dims
+      self_sizes.data(),                          // input1_shape
+      other_sizes.size(),                         // num_input2_dims
+      other_sizes.data(),                         // input2_shape
+      self_padded_contig.data_ptr<float>(),       // input1
+      other_padded_contig.data_ptr<float>(),      // input2
+      output_padded_contig.data_ptr<float>(),     // output
+      caffe2::xnnpack_threadpool());              // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_add_nd_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      op.get(),                       // operator
+      caffe2::xnnpack_threadpool());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_padded_contig;
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
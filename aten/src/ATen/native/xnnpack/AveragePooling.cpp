@@ -0,0 +1,269 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/native/Pool.h>
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/xnnpack/Factory.h>
+#include <ATen/native/xnnpack/Pooling.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+
+// Supports NHWC and NCHW FP32 average pooling with any
+//  - kernel size
+//  - stride
+// and no padding, so that count_include_pad doesn't matter.
+
+bool use_avg_pool2d(
+    const Tensor& input,
+    const IntArrayRef kernel_,
+    const IntArrayRef padding_,
+    IntArrayRef stride_,
+    const bool ceil_mode,
+    const bool count_include_pad,
+    const c10::optional<int64_t> divisor_override) {
+  using namespace internal;
+
+  if (kernel_.empty() || padding_.empty()) {
+    return false;
+  }
+
+  // Stride can be legitimately empty, in which case it is to be defaulted to kernel size.
+  if (stride_.empty()) {
+    stride_ = kernel_;
+  }
+
+  const internal::pooling::Parameters parameters{
+    kernel_,
+    padding_,
+    stride_,
+    /* dilation = */ {1},
+  };
+
+  // Here are the list of conditions required for this code path to be taken:
+  // * Input must be 4D CPU float tensor with no gradients.
+  // * Kernel must be a 2D IntArrayRef containing two positive numbers, not
+  //   1x1, which XNNPACK prohibits.
+  // * Padding must be zero.
+  // * Stride must be a 2D IntArrayRef containing two positive numbers.
+  // * Ceil mode and divisor override are not supported.
+  // * The output must have a valid shape.
+
+  return xnnpack::internal::available() &&
+      // Input
+      (4 == input.dim()) &&
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      !input.requires_grad() &&
+      // Kernel
+      (parameters.kernel[Layout::Parameter::height] > 0) &&
+      (parameters.kernel[Layout::Parameter::width] > 0) &&
+      ((parameters.kernel[Layout::Parameter::height] *
+        parameters.kernel[Layout::Parameter::width]) > 1) &&
+      // Padding
+      (0 == parameters.padding[Layout::Parameter::height]) &&
+      (0 == parameters.padding[Layout::Parameter::width]) &&
+      // Stride
+      (parameters.stride[Layout::Parameter::height] > 0) &&
+      (parameters.stride[Layout::Parameter::width] > 0) &&
+      // Ceil Mode / Divisor
+      !ceil_mode &&
+      !divisor_override &&
+      // Output
+      (pooling_output_shape<int64_t>(
+        input.size(Layout::Activation4D::height),
+        parameters.kernel[Layout::Parameter::height],
+        /* padding = */ 0,
+        parameters.stride[Layout::Parameter::height],
+        /* dilation = */ 1,
+        ceil_mode) > 0) &&
+      (pooling_output_shape<int64_t>(
+        input.size(Layout::Activation4D::width),
+        parameters.kernel[Layout::Parameter::width],
+        /* padding = */ 0,
+        parameters.stride[Layout::Parameter::width],
+        /* dilation = */ 1,
+        ceil_mode) > 0) &&
+      true;
+}
+
+Tensor avg_pool2d(
+    const Tensor& input,
+    const IntArrayRef kernel_,
+    const IntArrayRef padding_,
+    IntArrayRef stride_) {
+  using namespace internal;
+
+  // A call to avg_pool2d must have been gated by a call to use_avg_pool2d.
+
+  if (stride_.empty()) {
+    stride_ = kernel_;
+  }
+
+  const internal::pooling::Parameters parameters{
+    kernel_,
+    padding_,
+    stride_,
+    /* dilation = */ {1},
+  };
+
+  const Tensor input_padded_contig_nhwc = allocate_padded_contiguous_if_needed(
+      input,
+      MemoryFormat::ChannelsLast);
+
+  Tensor output_padded_contig_nhwc = empty_with_tail_padding(
+      {
+        input_padded_contig_nhwc.size(Layout::Activation4D::batch),
+        input_padded_contig_nhwc.size(Layout::Activation4D::channels),
+        pooling_output_shape<int64_t>(
+            input_padded_contig_nhwc.size(Layout::Activation4D::height),
+            parameters.kernel[Layout::Parameter::height],
+            /* padding = */ 0,
+            parameters.stride[Layout::Parameter::height],
+            /* dilation = */ 1,
+            false),
+        pooling_output_shape<int64_t>(
+            input_padded_contig_nhwc.size(Layout::Activation4D::width),
+            parameters.kernel[Layout::Parameter::width],
+            /* padding = */ 0,
+            parameters.stride[Layout::Parameter::width],
+            /* dilation = */ 1,
+            false),
+      },
+      input_padded_contig_nhwc.options().dtype(),
+      MemoryFormat::ChannelsLast,
+      input_padded_contig_nhwc.names());
+
+  xnn_operator_t avg_pool_op{};
+
+  const xnn_status create_status = xnn_create_average_pooling2d_nhwc_f32(
+      0u,                                                             // input_padding_top
+      0u,                                                             // input_padding_right
+      0u,                                                             // input_padding_bottom
+      0u,                                                             // input_padding_left
+      parameters.kernel[Layout::Parameter::height],                   // pooling_height
+      parameters.kernel[Layout::Parameter::width],                    // pooling_width
+      parameters.stride[Layout::Parameter::height],                   // stride_height
+      parameters.stride[Layout::Parameter::width],                    // stride_width
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // channels
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // input_pixel_stride - NHWC Contiguous
+      output_padded_contig_nhwc.size(Layout::Activation4D::channels), // output_pixel_stride - NHWC Contiguous
+      -std::numeric_limits<float>::infinity(),                        // output_min
+      +std::numeric_limits<float>::infinity(),                        // output_max
+      0u,                                                             // flags
+      &avg_pool_op);                                                  // operator
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_average_pooling2d_nhwc_f32 failed!");
+
+  const Operator op(avg_pool_op);
+
+  const xnn_status setup_status = xnn_setup_average_pooling2d_nhwc_f32(
+      op.get(),                                                     // operator
+      input_padded_contig_nhwc.size(Layout::Activation4D::batch),   // batch_size
+      input_padded_contig_nhwc.size(Layout::Activation4D::height),  // input_height
+      input_padded_contig_nhwc.size(Layout::Activation4D::width),   // input_width
+      input_padded_contig_nhwc.data_ptr<float>(),                   // input
+      output_padded_contig_nhwc.data_ptr<float>(),                  // output
+      caffe2::xnnpack_threadpool());                                // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_average_pooling2d_nhwc_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      op.get(),                       // operator
+      caffe2::xnnpack_threadpool());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_padded_contig_nhwc.contiguous(input.suggest_memory_format());
+}
+
+// Global average pooling, i.e. adaptive average pooling to 1x1, of NHWC and
+// NCHW FP32 activations.
+
+bool use_global_average_pool(const Tensor& input) {
+  using namespace internal;
+
+  return xnnpack::internal::available() &&
+      // Input
+      (4 == input.dim()) &&
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      !input.requires_grad() &&
+      (input.size(Layout::Activation4D::batch) > 0) &&
+      (input.size(Layout::Activation4D::channels) > 0) &&
+      (input.size(Layout::Activation4D::height) > 0) &&
+      (input.size(Layout::Activation4D::width) > 0) &&
+      true;
+}
+
+Tensor global_average_pool(const Tensor& input) {
+  using namespace internal;
+
+  const Tensor input_padded_contig_nhwc = allocate_padded_contiguous_if_needed(
+      input,
+      MemoryFormat::ChannelsLast);
+
+  Tensor output_padded_contig_nhwc = empty_with_tail_padding(
+      {
+        input_padded_contig_nhwc.size(Layout::Activation4D::batch),
+        input_padded_contig_nhwc.size(Layout::Activation4D::channels),
+        1,
+        1,
+      },
+      input_padded_contig_nhwc.options().dtype(),
+      MemoryFormat::ChannelsLast,
+      input_padded_contig_nhwc.names());
+
+  xnn_operator_t global_average_pooling_op{};
+
+  const xnn_status create_status = xnn_create_global_average_pooling_nwc_f32(
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // channels
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // input_stride
+      input_padded_contig_nhwc.size(Layout::Activation4D::channels),  // output_stride
+      -std::numeric_limits<float>::infinity(),                        // output_min
+      +std::numeric_limits<float>::infinity(),                        // output_max
+      0u,                                                             // flags
+      &global_average_pooling_op);                                    // operator
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_global_average_pooling_nwc_f32 failed!");
+
+  const Operator op(global_average_pooling_op);
+
+  // The height and width of each image are flattened into one width.
+  const xnn_status setup_status = xnn_setup_global_average_pooling_nwc_f32(
+      op.get(),                                                     // operator
+      input_padded_contig_nhwc.size(Layout::Activation4D::batch),   // batch_size
+      input_padded_contig_nhwc.size(Layout::Activation4D::height) *
+          input_padded_contig_nhwc.size(Layout::Activation4D::width), // width
+      input_padded_contig_nhwc.data_ptr<float>(),                   // input
+      output_padded_contig_nhwc.data_ptr<float>(),                  // output
+      caffe2::xnnpack_threadpool());                                // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_global_average_pooling_nwc_f32 failed!");
+
+  const xnn_status run_status = xnn_run_operator(
+      op.get(),                       // operator
+      caffe2::xnnpack_threadpool());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+
+  return output_padded_contig_nhwc.contiguous(input.suggest_memory_format());
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
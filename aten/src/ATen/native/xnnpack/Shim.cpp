@@ -88,6 +88,63 @@ Tensor max_pool2d(
   TORCH_CHECK(false, internal::kError);
 }
 
+bool use_avg_pool2d(
+    const Tensor&,
+    const IntArrayRef,
+    const IntArrayRef,
+    const IntArrayRef,
+    const bool,
+    const bool,
+    const c10::optional<int64_t>) {
+  return false;
+}
+
+Tensor avg_pool2d(
+    const Tensor&,
+    const IntArrayRef,
+    const IntArrayRef,
+    const IntArrayRef) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_global_average_pool(const Tensor&) {
+  return false;
+}
+
+Tensor global_average_pool(const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_hardswish(const Tensor&) {
+  return false;
+}
+
+Tensor hardswish(const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_clamp(
+    const Tensor&,
+    const c10::optional<Scalar>,
+    const c10::optional<Scalar>) {
+  return false;
+}
+
+Tensor clamp(
+    const Tensor&,
+    const c10::optional<Scalar>,
+    const c10::optional<Scalar>) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_add(const Tensor&, const Tensor&, const Scalar) {
+  return false;
+}
+
+Tensor add(const Tensor&, const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
 } // namespace xnnpack
 
 } // namespace native
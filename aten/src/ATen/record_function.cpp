@@ -14,8 +14,15 @@ CallbackHandle next_unique_callback_handle() {
 }
 
 // Thread local vector of callbacks, holds pairs (callbacks, unique_id);
-// must be sorted in increasing handles order
-thread_local RecordFunctionCallbacks sorted_tls_callbacks_;
+// must be sorted in increasing handles order. Never modified in place, so
+// that ThreadLocalState shares it with the threads it is propagated to;
+// null instead of empty
+thread_local std::shared_ptr<const RecordFunctionCallbacks> sorted_tls_callbacks_;
+
+const RecordFunctionCallbacks& emptyCallbacks() {
+  static const RecordFunctionCallbacks empty;
+  return empty;
+}
 
 class CallbackManager {
  public:
@@ -23,7 +30,11 @@ class CallbackManager {
     // note: monotonically increasing callbacks_unique_id keeps
     // sorted_tls_callbacks_ sorted
     auto handle = next_unique_callback_handle();
-    sorted_tls_callbacks_.emplace_back(std::move(cb), handle);
+    auto callbacks = sorted_tls_callbacks_
+        ? std::make_shared<RecordFunctionCallbacks>(*sorted_tls_callbacks_)
+        : std::make_shared<RecordFunctionCallbacks>();
+    callbacks->emplace_back(std::move(cb), handle);
+    sorted_tls_callbacks_ = std::move(callbacks);
     return handle;
   }
 
@@ -34,8 +45,8 @@ class CallbackManager {
   }
 
   void removeCallback(CallbackHandle handle) {
-    auto find_and_remove = [handle](RecordFunctionCallbacks& cbs) {
-      auto it = std::find_if(
+    auto find = [handle](const RecordFunctionCallbacks& cbs) {
+      return std::find_if(
         cbs.begin(), cbs.end(),
         [handle](
             const std::pair<
@@ -43,6 +54,9 @@ class CallbackManager {
                 CallbackHandle>& el) {
           return el.second == handle;
         });
+    };
+    auto find_and_remove = [&find](RecordFunctionCallbacks& cbs) {
+      auto it = find(cbs);
       if (it != cbs.end()) {
         // keeps it sorted
         cbs.erase(it);
@@ -50,7 +64,22 @@ class CallbackManager {
       }
       return false;
     };
-    auto found = find_and_remove(sorted_tls_callbacks_);
+    bool found = false;
+    if (sorted_tls_callbacks_) {
+      auto it = find(*sorted_tls_callbacks_);
+      if (it != sorted_tls_callbacks_->end()) {
+        found = true;
+        if (sorted_tls_callbacks_->size() == 1) {
+          sorted_tls_callbacks_.reset();
+        } else {
+          auto callbacks =
+              std::make_shared<RecordFunctionCallbacks>(*sorted_tls_callbacks_);
+          callbacks->erase(
+              callbacks->begin() + (it - sorted_tls_callbacks_->begin()));
+          sorted_tls_callbacks_ = std::move(callbacks);
+        }
+      }
+    }
     if (!found) {
       found = find_and_remove(sorted_global_callbacks_);
     }
@@ -64,7 +93,7 @@ class CallbackManager {
   }
 
   void clearThreadLocalCallbacks() {
-    sorted_tls_callbacks_.clear();
+    sorted_tls_callbacks_.reset();
   }
 
   inline bool hasGlobalCallbacks() const {
@@ -72,7 +101,7 @@ class CallbackManager {
   }
 
   inline bool hasThreadLocalCallbacks() const {
-    return !sorted_tls_callbacks_.empty();
+    return sorted_tls_callbacks_ && !sorted_tls_callbacks_->empty();
   }
 
   // init is called by RecordFunction in constructor to
@@ -83,7 +112,7 @@ class CallbackManager {
     bool found_active_cb = false;
     bool found_needs_inputs = false;
     auto init_handles = [scope, &found_active_cb, &found_needs_inputs](
-        CallbackHandles& handles, RecordFunctionCallbacks& cbs) {
+        CallbackHandles& handles, const RecordFunctionCallbacks& cbs) {
       handles.clear();
       for (const auto& cb : cbs) {
         if (cb.first.shouldRun(scope)) {
@@ -96,39 +125,46 @@ class CallbackManager {
       }
     };
 
-    init_handles(rec_fn.sorted_active_tls_handles_, sorted_tls_callbacks_);
+    init_handles(rec_fn.sorted_active_tls_handles_, tlsCallbacks());
     init_handles(rec_fn.sorted_active_global_handles_, sorted_global_callbacks_);
     rec_fn.active_ = found_active_cb;
     rec_fn.needs_inputs_ = found_needs_inputs;
   }
 
   void runStartCallbacks(RecordFunction& rf) {
+    // keeps the TLS callbacks alive if a callback removes some
+    auto tls_callbacks = sorted_tls_callbacks_;
     mergeRunCallbacks(
         sorted_global_callbacks_,
         rf.sorted_active_global_handles_,
         /* is_start */ true,
         rf);
     mergeRunCallbacks(
-        sorted_tls_callbacks_,
+        tls_callbacks ? *tls_callbacks : emptyCallbacks(),
         rf.sorted_active_tls_handles_,
         /* is_start */ true,
         rf);
   }
 
   void runEndCallbacks(RecordFunction& rf) {
+    auto tls_callbacks = sorted_tls_callbacks_;
     mergeRunCallbacks(
         sorted_global_callbacks_,
         rf.sorted_active_global_handles_,
         /* is_start */ false,
         rf);
     mergeRunCallbacks(
-        sorted_tls_callbacks_,
+        tls_callbacks ? *tls_callbacks : emptyCallbacks(),
         rf.sorted_active_tls_handles_,
         /* is_start */ false,
         rf);
   }
 
  private:
+  static const RecordFunctionCallbacks& tlsCallbacks() {
+    return sorted_tls_callbacks_ ? *sorted_tls_callbacks_ : emptyCallbacks();
+  }
+
   bool tryRunCallback(
       const std::function<void(const RecordFunction&)>& fn,
       RecordFunction& rf) {
@@ -207,20 +243,15 @@ double RecordFunctionCallback::sample_zero_one() {
   return dist(*gen);
 }
 
-RecordFunctionCallbacks _getTLSCallbacks() {
+const std::shared_ptr<const RecordFunctionCallbacks>& _getTLSCallbacks() {
   return sorted_tls_callbacks_;
 }
 
-void _setTLSCallbacks(const RecordFunctionCallbacks& callbacks) {
-  // keep the original handles
+void _setTLSCallbacks(
+    const std::shared_ptr<const RecordFunctionCallbacks>& callbacks) {
+  // keeps the original handles; callbacks come from _getTLSCallbacks, so
+  // they are already sorted
   sorted_tls_callbacks_ = callbacks;
-  std::sort(
-      sorted_tls_callbacks_.begin(),
-      sorted_tls_callbacks_.end(),
-      [](const std::pair<RecordFunctionCallback, CallbackHandle>& l,
-          const std::pair<RecordFunctionCallback, CallbackHandle>& r) {
-        return l.second < r.second;
-  });
 }
 
 bool hasCallbacks() {
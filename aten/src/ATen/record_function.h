@@ -439,8 +439,12 @@ class TORCH_API DisableRecordFunctionGuard : public RecordFunctionGuard {
   virtual ~DisableRecordFunctionGuard() {}
 };
 
-// Internal, used in ThreadLocalState to propagate TLS callbacks across threads
-TORCH_API RecordFunctionCallbacks _getTLSCallbacks();
-TORCH_API void _setTLSCallbacks(const RecordFunctionCallbacks& callbacks);
+// Internal, used in ThreadLocalState to propagate TLS callbacks across threads;
+// the TLS callbacks are immutable once set (adding or removing a callback
+// replaces them), so that they are shared instead of copied, and null
+// when there are none
+TORCH_API const std::shared_ptr<const RecordFunctionCallbacks>& _getTLSCallbacks();
+TORCH_API void _setTLSCallbacks(
+    const std::shared_ptr<const RecordFunctionCallbacks>& callbacks);
 
 } // namespace at
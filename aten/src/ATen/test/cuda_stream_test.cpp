@@ -196,6 +196,33 @@ TEST(TestStream, StreamPoolTest) {
   ASSERT_TRUE(hasDuplicates);
 }
 
+// Dedicated streams are never returned by the pool or to another caller
+TEST(TestStream, DedicatedStreamTest) {
+  if (!at::cuda::is_available()) return;
+  int least_priority, greatest_priority;
+  std::tie(least_priority, greatest_priority) =
+      at::cuda::CUDAStream::priority_range();
+
+  at::cuda::CUDAStream dedicated = at::cuda::getDedicatedStream();
+  at::cuda::CUDAStream high = at::cuda::getDedicatedStream(greatest_priority - 1);
+  ASSERT_NE_CUDA(dedicated, high);
+  ASSERT_EQ_CUDA(dedicated.priority(), 0);
+  ASSERT_EQ_CUDA(high.priority(), greatest_priority);
+  for (int i = 0; i < 200; ++i) {
+    cudaStream_t pool_stream = at::cuda::getStreamFromPool(i % 2 == 0);
+    ASSERT_NE_CUDA(pool_stream, dedicated.stream());
+    ASSERT_NE_CUDA(pool_stream, high.stream());
+  }
+
+  // A released stream is reused for the next request of the same priority
+  at::cuda::releaseDedicatedStream(dedicated);
+  ASSERT_EQ_CUDA(at::cuda::getDedicatedStream(), dedicated);
+  at::cuda::releaseDedicatedStream(dedicated);
+  at::cuda::releaseDedicatedStream(high);
+  ASSERT_ANY_THROW(at::cuda::releaseDedicatedStream(high));
+  ASSERT_ANY_THROW(at::cuda::releaseDedicatedStream(at::cuda::getStreamFromPool()));
+}
+
 // Multi-GPU
 TEST(TestStream, MultiGPUTest) {
   if (!at::cuda::is_available()) return;
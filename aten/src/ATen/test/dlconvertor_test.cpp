@@ -30,3 +30,67 @@ TEST(TestDlconvertor, TestDlconvertorNoStrides) {
 
   ASSERT_TRUE(a.equal(b));
 }
+
+TEST(TestDlconvertor, TestDlconvertorByteOffset) {
+  manual_seed(123);
+
+  Tensor a = rand({3, 4});
+  DLManagedTensor* dlMTensor = toDLPack(a[1]);
+  dlMTensor->dl_tensor.data = a.data_ptr();
+  dlMTensor->dl_tensor.byte_offset = 4 * sizeof(float);
+
+  Tensor b = fromDLPack(dlMTensor);
+
+  ASSERT_TRUE(a[1].equal(b));
+}
+
+namespace {
+struct ArrowTestData {
+  std::vector<float> values{1, 2, 3, 4, 5};
+  const void* buffers[2];
+  bool released = false;
+};
+
+void releaseArrowTestArray(ArrowArray* array) {
+  static_cast<ArrowTestData*>(array->private_data)->released = true;
+  array->release = nullptr;
+}
+} // namespace
+
+TEST(TestDlconvertor, TestArrowArray) {
+  ArrowTestData data;
+  data.buffers[0] = nullptr;
+  data.buffers[1] = data.values.data();
+  ArrowArray array{/*length=*/3, /*null_count=*/0, /*offset=*/2,
+                   /*n_buffers=*/2, /*n_children=*/0, data.buffers,
+                   /*children=*/nullptr, /*dictionary=*/nullptr,
+                   &releaseArrowTestArray, &data};
+  ArrowSchema schema{"f", "", nullptr, 0, 0, nullptr, nullptr, nullptr, nullptr};
+
+  {
+    Tensor t = fromArrowArray(&array, &schema);
+    ASSERT_EQ(array.release, nullptr);
+    ASSERT_EQ(t.data_ptr<float>(), data.values.data() + 2);
+    ASSERT_TRUE(t.equal(at::tensor({3.f, 4.f, 5.f})));
+    ASSERT_FALSE(data.released);
+  }
+  ASSERT_TRUE(data.released);
+}
+
+TEST(TestDlconvertor, TestArrowArrayUnsupported) {
+  ArrowTestData data;
+  data.buffers[0] = data.values.data();
+  data.buffers[1] = data.values.data();
+  ArrowArray array{/*length=*/5, /*null_count=*/1, /*offset=*/0,
+                   /*n_buffers=*/2, /*n_children=*/0, data.buffers,
+                   /*children=*/nullptr, /*dictionary=*/nullptr,
+                   &releaseArrowTestArray, &data};
+  ArrowSchema schema{"f", "", nullptr, 0, 0, nullptr, nullptr, nullptr, nullptr};
+  ASSERT_ANY_THROW(fromArrowArray(&array, &schema));
+  // The caller keeps the array when the conversion fails.
+  ASSERT_NE(array.release, nullptr);
+
+  array.null_count = 0;
+  ArrowSchema bool_schema{"b", "", nullptr, 0, 0, nullptr, nullptr, nullptr, nullptr};
+  ASSERT_ANY_THROW(fromArrowArray(&array, &bool_schema));
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <ATen/ATen.h>
+#include <ATen/native/FusedElementwise.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cpu/Loops.h>
+
+using namespace at;
+using at::native::FusedElementwiseProgram;
+using at::native::fused_elementwise;
+
+TEST(FusedElementwiseTest, Silu) {
+  for (auto dtype : {kFloat, kDouble}) {
+    // odd size to cover the vector tail and more than one chunk
+    auto x = at::randn({3, 301}, dtype);
+    FusedElementwiseProgram program(1);
+    auto in = program.input(0);
+    program.add_output(program.mul(in, program.sigmoid(in)));
+    auto outputs = fused_elementwise(program, {x});
+    ASSERT_EQ(outputs.size(), 1);
+    ASSERT_TRUE(outputs[0].allclose(x * at::sigmoid(x)));
+  }
+}
+
+TEST(FusedElementwiseTest, BroadcastAndStrided) {
+  auto a = at::randn({64, 33});
+  auto b = at::randn({33});
+  auto c = at::randn({33, 64}).t();
+  FusedElementwiseProgram program(3);
+  program.add_output(program.fmadd(program.input(0), program.input(1), program.input(2)));
+  auto outputs = fused_elementwise(program, {a, b, c});
+  ASSERT_EQ(outputs[0].sizes(), IntArrayRef({64, 33}));
+  ASSERT_TRUE(outputs[0].allclose(a * b + c));
+}
+
+TEST(FusedElementwiseTest, MultipleOutputs) {
+  auto x = at::randn({1000});
+  FusedElementwiseProgram program(1);
+  auto in = program.input(0);
+  auto scaled = program.mul(program.clamp(in, -0.5, 0.5), program.constant(3));
+  program.add_output(scaled);
+  program.add_output(program.relu(program.sub(in, scaled)));
+  auto outputs = fused_elementwise(program, {x});
+  ASSERT_EQ(outputs.size(), 2);
+  auto expected = x.clamp(-0.5, 0.5) * 3;
+  ASSERT_TRUE(outputs[0].allclose(expected));
+  ASSERT_TRUE(outputs[1].allclose(at::relu(x - expected)));
+}
+
+TEST(FusedElementwiseTest, TypePromotion) {
+  auto a = at::randn({10}, kDouble);
+  auto b = at::randn({10}, kFloat);
+  FusedElementwiseProgram program(2);
+  program.add_output(program.maximum(program.input(0), program.input(1)));
+  auto outputs = fused_elementwise(program, {a, b});
+  ASSERT_EQ(outputs[0].scalar_type(), kDouble);
+  ASSERT_TRUE(outputs[0].equal(at::max(a, b.to(kDouble))));
+}
+
+TEST(FusedElementwiseTest, InvalidPrograms) {
+  FusedElementwiseProgram program(1);
+  ASSERT_ANY_THROW(program.input(1));
+  ASSERT_ANY_THROW(program.exp(5));
+  // no outputs
+  ASSERT_ANY_THROW(fused_elementwise(program, {at::randn({4})}));
+  program.add_output(program.exp(program.input(0)));
+  // wrong number of inputs
+  ASSERT_ANY_THROW(fused_elementwise(program, {at::randn({4}), at::randn({4})}));
+  // integral inputs
+  ASSERT_ANY_THROW(fused_elementwise(program, {at::ones({4}, kLong)}));
+}
+
+TEST(FusedElementwiseTest, ComposeLambdas) {
+  auto x = at::randn({257});
+  Tensor out = at::empty_like(x);
+  auto iter = TensorIterator::unary_op(out, x);
+  const float lo = -0.5, hi = 0.5, scale = 3;
+  const vec256::Vec256<float> lo_vec(lo), hi_vec(hi), scale_vec(scale);
+  native::cpu_kernel_vec(iter,
+      native::compose(
+          [=](float a) { return std::min(std::max(a, lo), hi); },
+          [=](float a) { return a * scale; }),
+      native::compose(
+          [=](vec256::Vec256<float> a) { return vec256::clamp(a, lo_vec, hi_vec); },
+          [=](vec256::Vec256<float> a) { return a * scale_vec; }));
+  ASSERT_TRUE(out.allclose(x.clamp(lo, hi) * scale));
+}
@@ -144,6 +144,71 @@ TEST(IValueTest, FutureExceptions) {
   ASSERT_EQ(std::string(f3->error()->what()), std::string("My Error"));
 }
 
+TEST(IValueTest, FutureThenWithExecutor) {
+  auto f = c10::make_intrusive<ivalue::Future>(IntType::get());
+  std::vector<std::function<void(void)>> queued;
+  auto executor = [&queued](std::function<void(void)> fn) {
+    queued.push_back(std::move(fn));
+  };
+  auto child = f->then(
+      [f]() { return IValue(f->value().toInt() + 1); },
+      IntType::get(),
+      executor);
+  f->markCompleted(IValue(1));
+  // The continuation waits for the executor to run it.
+  ASSERT_FALSE(child->completed());
+  ASSERT_EQ(queued.size(), 1);
+  queued[0]();
+  ASSERT_TRUE(child->completed());
+  ASSERT_EQ(child->value().toInt(), 2);
+
+  // Errors thrown by the continuation are set on the child future.
+  auto failing = f->then(
+      []() -> IValue { throw std::runtime_error("My Error"); },
+      IntType::get(),
+      executor);
+  ASSERT_EQ(queued.size(), 2);
+  queued[1]();
+  ASSERT_TRUE(failing->hasError());
+  ASSERT_EQ(std::string(failing->error()->what()), "My Error");
+}
+
+TEST(IValueTest, FutureCollectAll) {
+  auto f1 = c10::make_intrusive<ivalue::Future>(IntType::get());
+  auto f2 = c10::make_intrusive<ivalue::Future>(IntType::get());
+  auto all = collectAll({f1, f2});
+  f2->markCompleted(IValue(2));
+  ASSERT_FALSE(all->completed());
+  f1->markCompleted(IValue(1));
+  ASSERT_TRUE(all->completed());
+  auto srcs = all->value().toList();
+  ASSERT_EQ(srcs.size(), 2);
+  ASSERT_EQ(srcs.get(0).toFuture()->value().toInt(), 1);
+  ASSERT_EQ(srcs.get(1).toFuture()->value().toInt(), 2);
+
+  ASSERT_TRUE(collectAll({})->completed());
+
+  auto f3 = c10::make_intrusive<ivalue::Future>(IntType::get());
+  auto f4 = c10::make_intrusive<ivalue::Future>(IntType::get());
+  auto failing = collectAll({f3, f4});
+  f3->setError("My Error");
+  ASSERT_TRUE(failing->hasError());
+  f4->markCompleted(IValue(4));
+  ASSERT_EQ(std::string(failing->error()->what()), "My Error");
+}
+
+TEST(IValueTest, FutureCollectAny) {
+  auto f1 = c10::make_intrusive<ivalue::Future>(IntType::get());
+  auto f2 = c10::make_intrusive<ivalue::Future>(IntType::get());
+  auto any = collectAny({f1, f2});
+  ASSERT_FALSE(any->completed());
+  f2->markCompleted(IValue(2));
+  ASSERT_TRUE(any->completed());
+  f1->markCompleted(IValue(1));
+  ASSERT_EQ(any->value().toInt(), 2);
+  ASSERT_TRUE(any->type()->isSubtypeOf(IntType::get()));
+}
+
 TEST(IValueTest, ValueEquality) {
   EXPECT_EQ(IValue("asdf"), IValue("asdf"));
   EXPECT_NE(IValue("asdf"), IValue("ASDF"));
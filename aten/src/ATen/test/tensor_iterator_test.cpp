@@ -226,3 +226,46 @@ TEST(TensorIteratorTest, FailNonPromotingBinaryOp) {
   iter.add_input(at::ones({1,1}, at::dtype(at::kInt)));
   ASSERT_ANY_THROW(iter.build());
 }
+
+// Builds with the plan cache must give the same iterator as fresh builds.
+TEST(TensorIteratorTest, PlanCache) {
+  bool enabled = at::get_tensor_iterator_plan_cache_enabled();
+  at::set_tensor_iterator_plan_cache_enabled(true);
+  at::clear_tensor_iterator_plan_cache();
+
+  auto check = [](const Tensor& a, const Tensor& b) {
+    Tensor out;
+    auto iter = TensorIterator::binary_op(out, a, b);
+    at::set_tensor_iterator_plan_cache_enabled(false);
+    Tensor expected_out;
+    auto expected = TensorIterator::binary_op(expected_out, a, b);
+    at::set_tensor_iterator_plan_cache_enabled(true);
+    ASSERT_EQ(iter.shape(), expected.shape());
+    ASSERT_EQ(iter.output().strides(), expected.output().strides());
+    for (int i = 0; i < iter.ntensors(); i++) {
+      ASSERT_EQ(iter.strides(i), expected.strides(i));
+      ASSERT_EQ(iter.dtype(i), expected.dtype(i));
+    }
+  };
+  for (int repeat = 0; repeat < 3; repeat++) {
+    check(at::randn({4, 5}), at::randn({4, 5}));
+    check(at::randn({5, 4}).t(), at::randn({4, 5}));
+    check(at::randn({4, 5}), at::randn({5}));
+    check(at::randn({2, 3, 4, 5}).contiguous(at::MemoryFormat::ChannelsLast),
+          at::randn({2, 3, 4, 5}).contiguous(at::MemoryFormat::ChannelsLast));
+    check(at::randn({4, 5}, kDouble), at::randn({4, 5}));  // cast by copy, not cached
+    check(at::randn({4, 5}), at::scalar_tensor(2, kDouble));
+  }
+
+  // an out= tensor of the wrong shape is resized on every call
+  Tensor out = at::empty({0});
+  auto a = at::randn({3});
+  for (int repeat = 0; repeat < 2; repeat++) {
+    out.resize_({0});
+    auto iter = TensorIterator::binary_op(out, a, a);
+    ASSERT_EQ(out.sizes(), a.sizes());
+  }
+
+  at::clear_tensor_iterator_plan_cache();
+  at::set_tensor_iterator_plan_cache_enabled(enabled);
+}
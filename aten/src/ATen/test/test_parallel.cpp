@@ -69,3 +69,37 @@ TEST(TestParallel, IntraOpLaunchFuture) {
 
   ASSERT_TRUE(v1 == 1 && v2 == 2);
 }
+
+TEST(TestParallel, GrainSizeEstimator) {
+  internal::GrainSizeEstimator estimator;
+  // too small to be timed
+  estimator.record(internal::GrainSizeEstimator::kMinSampleSize - 1, 1);
+  ASSERT_EQ(estimator.grain_size(), 0);
+
+  // 10ns per element
+  for (int i = 0; i < internal::GrainSizeEstimator::kNumSamples; ++i) {
+    ASSERT_EQ(estimator.grain_size(), 0);
+    estimator.record(10000, 100000);
+  }
+  ASSERT_EQ(
+      estimator.grain_size(),
+      internal::GrainSizeEstimator::kTargetChunkNs / 10);
+
+  // further samples are ignored
+  estimator.record(10000, 1);
+  ASSERT_EQ(
+      estimator.grain_size(),
+      internal::GrainSizeEstimator::kTargetChunkNs / 10);
+}
+
+TEST(TestParallel, AdaptiveGrainSize) {
+  bool enabled = get_adaptive_grain_size();
+  set_adaptive_grain_size(true);
+  Tensor a = rand({100, 1000});
+  Tensor expected = a.exp();
+  // results must not depend on how the work was chunked
+  for (int i = 0; i < internal::GrainSizeEstimator::kNumSamples + 2; ++i) {
+    ASSERT_TRUE(a.exp().equal(expected));
+  }
+  set_adaptive_grain_size(enabled);
+}
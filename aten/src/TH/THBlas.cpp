@@ -1,5 +1,8 @@
 #include <TH/THBlas.h>
 
+#include <algorithm>
+#include <vector>
+
 #include <TH/generic/THBlas.cpp>
 #include <TH/THGenerateAllTypes.h>
 
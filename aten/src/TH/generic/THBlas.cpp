@@ -304,6 +304,52 @@ void THBlas_(gemm)(
   }
 #endif
 
+#if defined(TH_REAL_IS_BFLOAT16)
+  // Accumulating into c directly rounds to BFloat16 after every product,
+  // which loses most of the precision of long dot products. Accumulate in
+  // float instead and round each element of c once.
+  {
+    const float alpha_f = alpha;
+    const float beta_f = beta;
+    if (transa_) {
+      // Rows of op(a) are contiguous, every element of c is a dot product.
+      for (int64_t j = 0; j < n; j++) {
+        for (int64_t i = 0; i < m; i++) {
+          const scalar_t *a_ = a + i * lda;
+          float sum = 0;
+          for (int64_t l = 0; l < k; l++) {
+            const float b_v = transb_ ? b[l * ldb + j] : b[j * ldb + l];
+            sum += static_cast<float>(a_[l]) * b_v;
+          }
+          if (beta_f == 0)
+            c[j * ldc + i] = alpha_f * sum;
+          else
+            c[j * ldc + i] = beta_f * static_cast<float>(c[j * ldc + i]) + alpha_f * sum;
+        }
+      }
+    } else {
+      // Columns of a are contiguous, accumulate one column of c at a time.
+      std::vector<float> c_acc(m);
+      for (int64_t j = 0; j < n; j++) {
+        std::fill(c_acc.begin(), c_acc.end(), 0.f);
+        for (int64_t l = 0; l < k; l++) {
+          const float val = transb_ ? b[j + l * ldb] : b[l + j * ldb];
+          const scalar_t *a_ = a + l * lda;
+          for (int64_t i = 0; i < m; i++)
+            c_acc[i] += static_cast<float>(a_[i]) * val;
+        }
+        for (int64_t i = 0; i < m; i++) {
+          if (beta_f == 0)
+            c[j * ldc + i] = alpha_f * c_acc[i];
+          else
+            c[j * ldc + i] = beta_f * static_cast<float>(c[j * ldc + i]) + alpha_f * c_acc[i];
+        }
+      }
+    }
+    return;
+  }
+#endif
+
   {
     if(!transa_ && !transb_)
     {
@@ -4,227 +4,478 @@
 
 
 #include <cuda_runtime_api.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <deque>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <stdint.h>
 #include <unordered_map>
 #include <unordered_set>
-#include <set>
 #include <utility>
+#include <vector>
 
 namespace {
 
-struct BlockSize
-{
-  size_t  size; // allocation size
-  void*   ptr;  // host memory pointer
+using c10::cuda::CUDACachingAllocator::Stat;
 
-  BlockSize(size_t size, void* ptr=NULL) : size(size), ptr(ptr) {}
-};
+// Sizes are rounded up to a power of two so that freed blocks can serve
+// requests of similar size; the free list of each size class has its own lock.
+constexpr size_t kMinBlockSize = 512;
+constexpr int kNumSizeClasses = 64;
+
+// blocks are looked up by pointer in one of kNumShards maps, each with its own
+// lock, so that threads freeing unrelated blocks don't contend
+constexpr size_t kNumShards = 16;
 
-struct Block : public BlockSize
+struct Block
 {
-  bool  allocated;    // true if the block is currently allocated
-  int   event_count;  // number of outstanding cuda events
+  Block(size_t size, void* ptr) : size(size), ptr(ptr) {}
+
+  const size_t size;  // allocation size, a power of two
+  void* const  ptr;   // host memory pointer
+
+  // lock around the fields below
+  std::mutex mutex;
+  bool  allocated = true;  // true if the block is currently allocated
+  int   event_count = 0;   // number of outstanding cuda events
   std::unordered_set<at::cuda::CUDAStream> streams;
 
-  Block(size_t size, void* ptr, bool allocated) :
-      BlockSize(size, ptr), allocated(allocated), event_count(0), streams() {}
+  // when the block was last made available, for LRU release
+  uint64_t free_tick = 0;
+};
+
+struct FreeList
+{
+  std::mutex mutex;
+  // available blocks (event_count=0), least recently freed first
+  std::deque<Block*> blocks;
 };
 
-static bool BlockComparator(const BlockSize& a, const BlockSize& b)
+struct BlockShard
 {
-  // sort by size, break ties with pointer
-  if (a.size != b.size) {
-    return a.size < b.size;
+  std::mutex mutex;
+  std::unordered_map<void*, std::unique_ptr<Block>> blocks;
+};
+
+void update_stat(Stat& stat, int64_t amount) {
+  stat.current += amount;
+  stat.peak = std::max(stat.current, stat.peak);
+  if (amount > 0) {
+    stat.allocated += amount;
+  }
+  if (amount < 0) {
+    stat.freed += -amount;
+  }
+}
+
+size_t round_size(size_t size) {
+  if (size <= kMinBlockSize) {
+    return kMinBlockSize;
+  }
+  size_t rounded = kMinBlockSize;
+  while (rounded < size) {
+    rounded <<= 1;
+  }
+  return rounded;
+}
+
+int size_class(size_t rounded_size) {
+  int cls = 0;
+  while ((size_t(1) << cls) < rounded_size) {
+    cls++;
   }
-  return (uintptr_t)a.ptr < (uintptr_t)b.ptr;
+  return cls;
 }
 
 struct HostAllocator
 {
-  typedef bool (*Comparison)(const BlockSize&, const BlockSize&);
+  // free lists by size class
+  std::array<FreeList, kNumSizeClasses> free_lists;
 
-  // lock around all operations
-  std::mutex mutex;
+  // all blocks by pointer
+  std::array<BlockShard, kNumShards> shards;
+
+  // bytes in free lists, and the most that may be kept there
+  std::atomic<size_t> cached_bytes{0};
+  std::atomic<size_t> cache_limit{std::numeric_limits<size_t>::max()};
+
+  std::atomic<uint64_t> free_tick{0};
 
-  // blocks by pointer
-  std::unordered_map<void*, Block> blocks;
+  // outstanding cuda events, per stream. Events recorded on one stream
+  // complete in order, so each queue is processed up to its first pending
+  // event without waiting for the other streams.
+  std::mutex events_mutex;
+  std::unordered_map<at::cuda::CUDAStream, std::deque<std::pair<cudaEvent_t, Block*>>> cuda_events;
 
-  // pointers that are ready to be allocated (event_count=0)
-  std::set<BlockSize, Comparison> available;
+  std::mutex stats_mutex;
+  THCCachingHostAllocatorStats stats;
 
-  // outstanding cuda events
-  std::deque<std::pair<cudaEvent_t, void*>> cuda_events;
+  BlockShard& shard_for(void* ptr) {
+    return shards[(reinterpret_cast<uintptr_t>(ptr) / kMinBlockSize) % kNumShards];
+  }
 
-  HostAllocator() : available(BlockComparator) {}
+  Block* find_block(void* ptr) {
+    BlockShard& shard = shard_for(ptr);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.blocks.find(ptr);
+    return it == shard.blocks.end() ? nullptr : it->second.get();
+  }
 
   cudaError_t malloc(void** ptr, size_t size)
   {
-    std::lock_guard<std::mutex> lock(mutex);
+    if (size == 0) {
+      *ptr = nullptr;
+      return cudaSuccess;
+    }
 
-    // process outstanding cuda events which may have occurred
-    cudaError_t err = processEvents();
+    // process outstanding cuda events which may have occurred; skipped if
+    // another thread is already at it
+    cudaError_t err = processEvents(/*blocking=*/false);
     if (err != cudaSuccess) {
       return err;
     }
 
-    // search for the smallest block which can hold this allocation
-    BlockSize search_key(size);
-    auto it = available.lower_bound(search_key);
-    if (it != available.end()) {
-      Block& block = blocks.at(it->ptr);
-      THAssert(!block.allocated && block.event_count == 0);
-      block.allocated = true;
-      *ptr = block.ptr;
-      available.erase(it);
+    const size_t rounded = round_size(size);
+    Block* block = pop_available(rounded);
+    if (block) {
+      {
+        std::lock_guard<std::mutex> block_lock(block->mutex);
+        THAssert(!block->allocated && block->event_count == 0);
+        block->allocated = true;
+      }
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      update_stat(stats.allocation, 1);
+      update_stat(stats.allocated_bytes, block->size);
+      *ptr = block->ptr;
       return cudaSuccess;
     }
 
-    // Pinned memory pointers allocated by any device can be directly used by any
-    // other device, regardless of the current device at the time of allocation,
-    // since we assume unified addressing.
-    // So we grab any existing primary context, if available.
-    // See pytorch/pytorch#21081.
-    at::OptionalDeviceGuard device_guard;
-    auto primary_ctx_device_index = at::detail::getCUDAHooks().getDevceIndexWithPrimaryContext();
-    if (primary_ctx_device_index.has_value()) {
-      device_guard.reset_device(at::Device(at::DeviceType::CUDA, *primary_ctx_device_index));
-    }
-
-    // note that cudaHostAlloc may not touch pointer if size is 0
-    *ptr = 0;
-
-    // allocate a new block if no cached allocation is found
-    err = cudaHostAlloc(ptr, size, cudaHostAllocDefault);
-    if (err != cudaSuccess) {
-      return err;
+    // allocate a new block if no cached allocation is found; no lock is held
+    // across cudaHostAlloc, which can take milliseconds
+    err = allocBlock(ptr, rounded, /*allocated=*/true);
+    if (err == cudaErrorMemoryAllocation && cached_bytes > 0) {
+      // release the cache and retry
+      cudaGetLastError();  // clear CUDA error
+      releaseCachedBlocks(0);
+      err = allocBlock(ptr, rounded, /*allocated=*/true);
     }
-
-    blocks.insert({*ptr, Block(size, *ptr, true)});
-    return cudaSuccess;
+    return err;
   }
 
   cudaError_t free(void* ptr)
   {
-    std::lock_guard<std::mutex> lock(mutex);
-
     if (!ptr) {
       return cudaSuccess;
     }
 
     // process outstanding cuda events which may have occurred
-    cudaError_t err = processEvents();
+    cudaError_t err = processEvents(/*blocking=*/false);
     if (err != cudaSuccess) {
       return err;
     }
 
-    auto it = blocks.find(ptr);
-    THAssert(it != blocks.end());
+    Block* block = find_block(ptr);
+    THAssert(block);
 
-    Block& block = it->second;
-    THAssert(block.allocated);
+    bool available;
+    std::vector<std::pair<at::cuda::CUDAStream, cudaEvent_t>> events;
+    {
+      std::lock_guard<std::mutex> block_lock(block->mutex);
+      THAssert(block->allocated);
 
-    // free (on valid memory) shouldn't fail, so mark unallocated before
-    // we process the streams.
-    block.allocated = false;
+      // free (on valid memory) shouldn't fail, so mark unallocated before
+      // we process the streams.
+      block->allocated = false;
 
-    // insert CUDA events for each stream on which this block was used. This
-    err = insertEvents(block);
-    if (err != cudaSuccess) {
-      return err;
+      // record CUDA events for each stream on which this block was used.
+      err = recordEvents(*block, events);
+      available = block->event_count == 0;
     }
-
-    if (block.event_count == 0) {
+    if (!events.empty()) {
+      // queued after releasing the block, as processEvents locks the queues
+      // before the blocks
+      std::lock_guard<std::mutex> lock(events_mutex);
+      for (auto& e : events) {
+        cuda_events[e.first].emplace_back(e.second, block);
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      update_stat(stats.allocation, -1);
+      update_stat(stats.allocated_bytes, -static_cast<int64_t>(block->size));
+    }
+    if (available) {
       // the block can be re-used if there are no outstanding cuda events
-      available.insert(block);
+      pushAvailable(block);
     }
+    if (err != cudaSuccess) {
+      return err;
+    }
+    enforceCacheLimit();
     return cudaSuccess;
   }
 
   cudaError_t recordEvent(void* ptr, at::cuda::CUDAStream stream)
   {
-    std::lock_guard<std::mutex> lock(mutex);
-
-    auto it = blocks.find(ptr);
-    if (it == blocks.end()) {
+    Block* block = find_block(ptr);
+    if (!block) {
       // ignore events for untracked pointers
       return cudaSuccess;
     }
 
-    Block& block = it->second;
-    THAssert(block.allocated);
+    std::lock_guard<std::mutex> block_lock(block->mutex);
+    THAssert(block->allocated);
 
-    block.streams.insert(stream);
+    block->streams.insert(stream);
     return cudaSuccess;
   }
 
-  cudaError_t processEvents()
+  cudaError_t processEvents(bool blocking)
   {
     // Process outstanding cudaEvents. Events that are completed are removed
-    // from the queue, and the 'event_count' for the corresponding allocation
-    // is decremented. Stops at the first event which has not been completed.
-    // Since events on different devices or streams may occur out of order,
-    // the processing of some events may be delayed.
-    while (!cuda_events.empty()) {
-      auto& e = cuda_events.front();
-      cudaEvent_t event = e.first;
-
-      cudaError_t err = cudaEventQuery(event);
-      if (err == cudaErrorNotReady) {
-        break;
-      } else if (err != cudaSuccess) {
-        return err;
+    // from their stream's queue, and the 'event_count' for the corresponding
+    // allocation is decremented. Each queue stops at its first event which
+    // has not been completed; with blocking, waits for all of them instead.
+    std::unique_lock<std::mutex> lock(events_mutex, std::defer_lock);
+    if (blocking) {
+      lock.lock();
+    } else if (!lock.try_lock()) {
+      return cudaSuccess;
+    }
+
+    std::vector<Block*> ready;
+    cudaError_t err = cudaSuccess;
+    for (auto it = cuda_events.begin(); it != cuda_events.end() && err == cudaSuccess;) {
+      auto& events = it->second;
+      while (!events.empty()) {
+        auto& e = events.front();
+        cudaEvent_t event = e.first;
+
+        err = blocking ? cudaEventSynchronize(event) : cudaEventQuery(event);
+        if (err == cudaErrorNotReady) {
+          cudaGetLastError();  // clear CUDA error
+          err = cudaSuccess;
+          break;
+        } else if (err != cudaSuccess) {
+          break;
+        }
+        err = cudaEventDestroy(event);
+        if (err != cudaSuccess) {
+          break;
+        }
+
+        Block* block = e.second;
+        {
+          std::lock_guard<std::mutex> block_lock(block->mutex);
+          block->event_count--;
+          if (block->event_count == 0 && !block->allocated) {
+            ready.push_back(block);
+          }
+        }
+        events.pop_front();
+      }
+      if (events.empty()) {
+        it = cuda_events.erase(it);
+      } else {
+        ++it;
       }
-      err = cudaEventDestroy(event);
+    }
+    lock.unlock();
+
+    for (Block* block : ready) {
+      pushAvailable(block);
+    }
+    return err;
+  }
+
+  void emptyCache()
+  {
+    // wait for the streams still using freed blocks, then release all of
+    // the cached blocks
+    THCudaCheckWarn(processEvents(/*blocking=*/true));
+    releaseCachedBlocks(0);
+  }
+
+  cudaError_t reserve(size_t size, size_t count)
+  {
+    const size_t rounded = round_size(size);
+    for (size_t i = 0; i < count; ++i) {
+      void* ptr;
+      cudaError_t err = allocBlock(&ptr, rounded, /*allocated=*/false);
       if (err != cudaSuccess) {
         return err;
       }
+    }
+    enforceCacheLimit();
+    return cudaSuccess;
+  }
+
+  void setCacheLimit(size_t limit)
+  {
+    cache_limit = limit;
+    enforceCacheLimit();
+  }
+
+  THCCachingHostAllocatorStats getStats()
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    return stats;
+  }
+
+  void resetAccumulatedStats()
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    for (Stat* stat : {&stats.allocation, &stats.segment,
+                       &stats.allocated_bytes, &stats.reserved_bytes}) {
+      stat->allocated = 0;
+      stat->freed = 0;
+    }
+    stats.num_evictions = 0;
+  }
+
+  void resetPeakStats()
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    for (Stat* stat : {&stats.allocation, &stats.segment,
+                       &stats.allocated_bytes, &stats.reserved_bytes}) {
+      stat->peak = stat->current;
+    }
+  }
+
+ private:
+
+  cudaError_t allocBlock(void** ptr, size_t size, bool allocated)
+  {
+    // Pinned memory pointers allocated by any device can be directly used by any
+    // other device, regardless of the current device at the time of allocation,
+    // since we assume unified addressing.
+    // So we grab any existing primary context, if available.
+    // See pytorch/pytorch#21081.
+    at::OptionalDeviceGuard device_guard;
+    auto primary_ctx_device_index = at::detail::getCUDAHooks().getDevceIndexWithPrimaryContext();
+    if (primary_ctx_device_index.has_value()) {
+      device_guard.reset_device(at::Device(at::DeviceType::CUDA, *primary_ctx_device_index));
+    }
+
+    // note that cudaHostAlloc may not touch pointer if size is 0
+    *ptr = 0;
+
+    cudaError_t err = cudaHostAlloc(ptr, size, cudaHostAllocDefault);
+    if (err != cudaSuccess) {
+      return err;
+    }
 
-      Block& block = blocks.at(e.second);
-      block.event_count--;
-      if (block.event_count == 0 && !block.allocated) {
-        available.insert(block);
+    auto owned = std::make_unique<Block>(size, *ptr);
+    Block* block = owned.get();
+    block->allocated = allocated;
+    {
+      BlockShard& shard = shard_for(*ptr);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.blocks.emplace(*ptr, std::move(owned));
+    }
+    {
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      update_stat(stats.segment, 1);
+      update_stat(stats.reserved_bytes, size);
+      if (allocated) {
+        update_stat(stats.allocation, 1);
+        update_stat(stats.allocated_bytes, size);
       }
-      cuda_events.pop_front();
+    }
+    if (!allocated) {
+      pushAvailable(block);
     }
     return cudaSuccess;
   }
 
-  void emptyCache()
+  Block* pop_available(size_t rounded_size)
   {
-    std::lock_guard<std::mutex> lock(mutex);
-
-    // remove events for freed blocks
-    for (auto it = cuda_events.begin(); it != cuda_events.end(); ++it) {
-      cudaEvent_t event = it->first;
-      Block& block = blocks.at(it->second);
-      if (!block.allocated) {
-        THCudaCheckWarn(cudaEventDestroy(event));
-        block.event_count--;
-      }
+    FreeList& free_list = free_lists[size_class(rounded_size)];
+    std::lock_guard<std::mutex> lock(free_list.mutex);
+    if (free_list.blocks.empty()) {
+      return nullptr;
     }
+    // reuse the most recently freed block, which is likely still in cache
+    Block* block = free_list.blocks.back();
+    free_list.blocks.pop_back();
+    cached_bytes -= block->size;
+    return block;
+  }
 
-    // all cuda_events have been processed
-    cuda_events.clear();
+  void pushAvailable(Block* block)
+  {
+    FreeList& free_list = free_lists[size_class(block->size)];
+    std::lock_guard<std::mutex> lock(free_list.mutex);
+    block->free_tick = free_tick++;
+    free_list.blocks.push_back(block);
+    cached_bytes += block->size;
+  }
 
-    // clear list of available blocks
-    available.clear();
+  void enforceCacheLimit()
+  {
+    const size_t limit = cache_limit;
+    if (cached_bytes > limit) {
+      releaseCachedBlocks(limit);
+    }
+  }
 
-    // free and erase non-allocated blocks
-    for (auto it = blocks.begin(); it != blocks.end();) {
-      Block& block = it->second;
-      if (!block.allocated) {
-        THCudaCheckWarn(cudaFreeHost(block.ptr));
-        it = blocks.erase(it);
-      } else {
-        ++it;
+  // Releases the least recently freed cached blocks until at most
+  // target_bytes remain cached.
+  void releaseCachedBlocks(size_t target_bytes)
+  {
+    while (cached_bytes > target_bytes) {
+      // find the size class whose oldest block was freed first
+      int oldest = -1;
+      uint64_t oldest_tick = std::numeric_limits<uint64_t>::max();
+      for (int cls = 0; cls < kNumSizeClasses; ++cls) {
+        FreeList& free_list = free_lists[cls];
+        std::lock_guard<std::mutex> lock(free_list.mutex);
+        if (!free_list.blocks.empty() && free_list.blocks.front()->free_tick < oldest_tick) {
+          oldest = cls;
+          oldest_tick = free_list.blocks.front()->free_tick;
+        }
+      }
+      if (oldest < 0) {
+        return;
+      }
+
+      Block* block;
+      {
+        FreeList& free_list = free_lists[oldest];
+        std::lock_guard<std::mutex> lock(free_list.mutex);
+        if (free_list.blocks.empty()) {
+          // taken by another thread in the meantime
+          continue;
+        }
+        block = free_list.blocks.front();
+        free_list.blocks.pop_front();
+        cached_bytes -= block->size;
+      }
+
+      const size_t size = block->size;
+      THCudaCheckWarn(cudaFreeHost(block->ptr));
+      {
+        BlockShard& shard = shard_for(block->ptr);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.blocks.erase(block->ptr);
+      }
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      update_stat(stats.segment, -1);
+      update_stat(stats.reserved_bytes, -static_cast<int64_t>(size));
+      if (target_bytes > 0) {
+        stats.num_evictions += 1;
       }
     }
   }
 
-  cudaError_t insertEvents(Block& block)
+  // Records an event on each stream which used the block, counted in its
+  // event_count, and returns them in events. Requires block.mutex.
+  cudaError_t recordEvents(
+      Block& block,
+      std::vector<std::pair<at::cuda::CUDAStream, cudaEvent_t>>& events)
   {
     cudaError_t err;
 
@@ -245,7 +496,7 @@ struct HostAllocator
       if (err != cudaSuccess) break;
 
       block.event_count++;
-      cuda_events.emplace_back(event, block.ptr);
+      events.emplace_back(*it, event);
     }
 
     cudaSetDevice(prev_device);
@@ -267,6 +518,31 @@ void THCCachingHostAllocator_emptyCache()
   allocator.emptyCache();
 }
 
+cudaError_t THCCachingHostAllocator_reserve(size_t size, size_t count)
+{
+  return allocator.reserve(size, count);
+}
+
+void THCCachingHostAllocator_setCacheLimit(size_t bytes)
+{
+  allocator.setCacheLimit(bytes);
+}
+
+THCCachingHostAllocatorStats THCCachingHostAllocator_getStats()
+{
+  return allocator.getStats();
+}
+
+void THCCachingHostAllocator_resetAccumulatedStats()
+{
+  allocator.resetAccumulatedStats();
+}
+
+void THCCachingHostAllocator_resetPeakStats()
+{
+  allocator.resetPeakStats();
+}
+
 static void THCCachingHostDeleter(void* ptr) {
   allocator.free(ptr);
 }
@@ -4,6 +4,7 @@
 #include <THC/THCGeneral.h>
 
 
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/cuda/CUDAStream.h>
 
 //
@@ -19,7 +20,14 @@
 // copy_from_cpu_async_ and copy_to_cpu_async_.
 //
 // Note that this allocator does not split larger allocations into smaller
-// blocks, unlike the caching device allocator.
+// blocks, unlike the caching device allocator. Allocation sizes are rounded up
+// to a power of two, and freed blocks are kept on a free list per size class,
+// each with its own lock. Blocks wait to be reused on per-stream event queues,
+// so a busy stream doesn't hold back blocks freed by the others.
+//
+// The cache is unbounded by default. THCCachingHostAllocator_setCacheLimit
+// caps the bytes of cached free blocks; the least recently freed ones beyond
+// the cap are released with cudaFreeHost.
 //
 THC_API c10::Allocator* getTHCCachingHostAllocator(void);
 
@@ -30,4 +38,31 @@ THC_API cudaError_t THCCachingHostAllocator_recordEvent(void *ptr, at::cuda::CUD
 // Releases cached pinned memory allocations via cudaHostFree
 THC_API void THCCachingHostAllocator_emptyCache(void);
 
+// Pins `count` blocks able to hold `size` bytes each and adds them to the
+// cache, e.g. at startup, so that later allocations don't stall on
+// cudaHostAlloc.
+THC_API cudaError_t THCCachingHostAllocator_reserve(size_t size, size_t count);
+
+// Caps the number of bytes kept in cached free blocks.
+THC_API void THCCachingHostAllocator_setCacheLimit(size_t bytes);
+
+// Statistics of the caching host allocator; see getDeviceStats for the
+// meaning of the Stat fields.
+struct THCCachingHostAllocatorStats {
+  // COUNT: allocations requested by client code
+  c10::cuda::CUDACachingAllocator::Stat allocation;
+  // COUNT: number of blocks pinned with cudaHostAlloc()
+  c10::cuda::CUDACachingAllocator::Stat segment;
+  // SUM: bytes of allocated blocks
+  c10::cuda::CUDACachingAllocator::Stat allocated_bytes;
+  // SUM: bytes pinned by this allocator (both free and used)
+  c10::cuda::CUDACachingAllocator::Stat reserved_bytes;
+  // COUNT: cached blocks released to stay under the cache limit
+  int64_t num_evictions = 0;
+};
+
+THC_API THCCachingHostAllocatorStats THCCachingHostAllocator_getStats(void);
+THC_API void THCCachingHostAllocator_resetAccumulatedStats(void);
+THC_API void THCCachingHostAllocator_resetPeakStats(void);
+
 #endif
@@ -7,6 +7,7 @@
 #include <THC/THCSortUtils.cuh>
 #include <THC/THCTensorCopy.h>
 #include <THC/THCTensorTypeUtils.cuh>
+#include <ATen/cuda/CUDAContext.h>
 
 #include <THC/THCThrustAllocator.cuh>
 #include <thrust/device_ptr.h>
@@ -14,6 +15,13 @@
 #if CUDA_VERSION >= 7000 || defined(__HIP_PLATFORM_HCC__)
 #include <thrust/system/cuda/execution_policy.h>
 #endif
+#if !defined(__HIP_PLATFORM_HCC__)
+#include <cuda_fp16.h>
+#include <cub/device/device_radix_sort.cuh>
+#include <cub/device/device_segmented_radix_sort.cuh>
+#include <cub/iterator/counting_input_iterator.cuh>
+#include <cub/iterator/transform_input_iterator.cuh>
+#endif
 
 template <typename T, bool handleNaN = false>
 struct ThrustGTOp {
@@ -97,6 +105,35 @@ struct GlobalIndexToPerSliceIndex {
   const int64_t sliceSize;
 };
 
+#if !defined(__HIP_PLATFORM_HCC__)
+// The type that CUB radix sorts for keys of type T; at::Half has the layout
+// of __half.
+template <typename T>
+struct CubSortKey {
+  using type = T;
+};
+
+template <>
+struct CubSortKey<at::Half> {
+  using type = __half;
+};
+
+// For segmented sorts in CUB; the offset of the start of a slice of
+// contiguous slices
+struct SliceOffsetOp {
+  SliceOffsetOp(int size) : sliceSize(size) {}
+
+  __host__ __device__ __forceinline__ int operator()(int slice) const {
+    return slice * sliceSize;
+  }
+
+  const int sliceSize;
+};
+
+using SliceOffsetIterator =
+  cub::TransformInputIterator<int, SliceOffsetOp, cub::CountingInputIterator<int>>;
+#endif
+
 void THCudaLongTensor_fillSliceWithIndex(THCState* state,
                                          THCudaLongTensor* t,
                                          int dim);
@@ -272,6 +272,120 @@ void THCTensor_(sortViaThrust)(THCState* state,
   THCudaLongTensor_freeCopyTo(state, trContigIndices, indices);
 }
 
+#if !defined(__HIP_PLATFORM_HCC__) && !defined(THC_REAL_IS_BFLOAT16)
+// Slices larger than this are sorted with one segmented sort only if there
+// are enough of them to keep the device busy, since CUB sorts each segment
+// with a single block.
+#define THC_SEGMENTED_SORT_MAX_SLICE_SIZE 65536
+
+// Whether THCTensor_(sortViaRadixSort) handles a sort of numSlices slices of
+// sliceSize elements.
+static bool THCTensor_(canSortViaRadixSort)(THCState* state,
+                                            int64_t numSlices,
+                                            int64_t sliceSize) {
+  // CUB takes the number of items and the offsets as int
+  if (numSlices * sliceSize >= INT_MAX) {
+    return false;
+  }
+  return numSlices == 1 ||
+         sliceSize <= THC_SEGMENTED_SORT_MAX_SLICE_SIZE ||
+         numSlices >= at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+}
+
+// Sorts the slices with CUB's radix sort: the slices are made contiguous and
+// innermost, and all of them are sorted at once by a segmented radix sort,
+// with the per-slice indices as the values. A single slice is sorted by the
+// device-wide radix sort instead.
+//
+// Radix sort orders floating point keys by their bits, so NaNs with the sign
+// bit cleared are sorted after +inf like in the comparison sorts, but NaNs
+// with the sign bit set are sorted before -inf.
+void THCTensor_(sortViaRadixSort)(THCState* state,
+                                  THCTensor* sorted,
+                                  THCudaLongTensor* indices,
+                                  THCTensor* input,
+                                  int dim, bool dir) {
+  using key_t = typename CubSortKey<scalar_t>::type;
+
+  int nDims = THCTensor_(nDimensionLegacyAll)(state, input);
+  ptrdiff_t totalElements = THCTensor_(nElement)(state, input);
+  int64_t sliceSize = THCTensor_(sizeLegacyNoScalars)(state, input, dim);
+  int64_t numSlices = totalElements / sliceSize;
+
+  // Transpose dim to innermost, and make the keys contiguous
+  THCTensor* trInput = THCTensor_(newWithTensor)(state, input);
+  if (dim != nDims - 1) {
+    THCTensor_(transpose)(state, trInput, NULL, dim, nDims - 1);
+  }
+  THCTensor* keysIn = THCTensor_(newContiguous)(state, trInput);
+  THCTensor_(free)(state, trInput);
+
+  THCTensor* keysOut = THCTensor_(new)(state);
+  THCudaLongTensor* valuesIn = THCudaLongTensor_new(state);
+  THCudaLongTensor* valuesOut = THCudaLongTensor_new(state);
+  THCTensor_(resize)(state, keysOut, keysIn->sizes(), {});
+  THCudaLongTensor_resize(state, valuesIn, keysIn->sizes(), {});
+  THCudaLongTensor_resize(state, valuesOut, keysIn->sizes(), {});
+  THCudaLongTensor_fillSliceWithIndex(state, valuesIn, nDims - 1);
+
+  const key_t* keysInData = reinterpret_cast<const key_t*>(THCTensor_(data)(state, keysIn));
+  key_t* keysOutData = reinterpret_cast<key_t*>(THCTensor_(data)(state, keysOut));
+  const int64_t* valuesInData = THCudaLongTensor_data(state, valuesIn);
+  int64_t* valuesOutData = THCudaLongTensor_data(state, valuesOut);
+  const int numItems = static_cast<int>(totalElements);
+  const int numSegments = static_cast<int>(numSlices);
+  SliceOffsetIterator offsets(cub::CountingInputIterator<int>(0), SliceOffsetOp(sliceSize));
+  cudaStream_t stream = c10::cuda::getCurrentCUDAStream();
+
+  // The first call only computes the size of the temporary storage
+  void* tempStorage = nullptr;
+  size_t tempStorageBytes = 0;
+  for (int pass = 0; pass < 2; ++pass) {
+    if (numSlices == 1) {
+      if (dir) {
+        THCudaCheck(cub::DeviceRadixSort::SortPairsDescending(
+          tempStorage, tempStorageBytes, keysInData, keysOutData,
+          valuesInData, valuesOutData, numItems,
+          0, sizeof(key_t) * 8, stream));
+      } else {
+        THCudaCheck(cub::DeviceRadixSort::SortPairs(
+          tempStorage, tempStorageBytes, keysInData, keysOutData,
+          valuesInData, valuesOutData, numItems,
+          0, sizeof(key_t) * 8, stream));
+      }
+    } else {
+      if (dir) {
+        THCudaCheck(cub::DeviceSegmentedRadixSort::SortPairsDescending(
+          tempStorage, tempStorageBytes, keysInData, keysOutData,
+          valuesInData, valuesOutData, numItems, numSegments,
+          offsets, offsets + 1, 0, sizeof(key_t) * 8, stream));
+      } else {
+        THCudaCheck(cub::DeviceSegmentedRadixSort::SortPairs(
+          tempStorage, tempStorageBytes, keysInData, keysOutData,
+          valuesInData, valuesOutData, numItems, numSegments,
+          offsets, offsets + 1, 0, sizeof(key_t) * 8, stream));
+      }
+    }
+    if (pass == 0) {
+      tempStorage = THCudaMalloc(state, std::max<size_t>(tempStorageBytes, 1));
+    }
+  }
+  THCudaFree(state, tempStorage);
+
+  THCTensor_(free)(state, keysIn);
+  THCudaLongTensor_free(state, valuesIn);
+
+  // Reverse the transposition as needed
+  if (dim != nDims - 1) {
+    THCTensor_(transpose)(state, keysOut, NULL, dim, nDims - 1);
+    THCudaLongTensor_transpose(state, valuesOut, NULL, dim, nDims - 1);
+  }
+  // Then copy back to the expected output
+  THCTensor_(freeCopyTo)(state, keysOut, sorted);
+  THCudaLongTensor_freeCopyTo(state, valuesOut, indices);
+}
+#endif
+
 void THCTensor_(sort)(THCState* state,
                       THCTensor *sorted,
                       THCudaLongTensor *indices,
@@ -320,6 +434,14 @@ void THCTensor_(sort)(THCState* state,
     // layout
     THCTensor_(sortKeyValueInplace)(state, sorted, indices, dim, order);
   } else {
+#if !defined(__HIP_PLATFORM_HCC__) && !defined(THC_REAL_IS_BFLOAT16)
+    ptrdiff_t numSlices = THCTensor_(nElement)(state, input) / sliceSize;
+    if (THCTensor_(canSortViaRadixSort)(state, numSlices, sliceSize)) {
+      THCTensor_(sortViaRadixSort)(state, sorted, indices, input, dim, (bool) order);
+      THCudaCheck(cudaGetLastError());
+      return;
+    }
+#endif
     // Otherwise, fall back upon Thrust, which handles all other cases
     // (potentially slowly, with extra copies/memory allocations)
     THCTensor_(sortViaThrust)(state, sorted, indices, input, dim, (bool) order);
@@ -0,0 +1,59 @@
+"""Time loading TorchScript archives whose pickle is a large dict of tensors.
+
+Loading such state dicts is dominated by the unpickler rather than by reading
+the tensor data, so the tensors here are small and the reported time is per
+dict entry.
+"""
+import argparse
+import io
+import statistics
+import timeit
+
+import torch
+
+from typing import Dict
+
+
+class StateDictModule(torch.nn.Module):
+    def __init__(self, state):
+        super(StateDictModule, self).__init__()
+        self.state: Dict[str, torch.Tensor] = state
+
+    def forward(self):
+        return self.state
+
+
+def make_archive(num_entries, tensor_size):
+    state = {}
+    for i in range(num_entries):
+        name = 'layers.{}.block.{}.weight'.format(i // 16, i % 16)
+        state[name] = torch.rand(tensor_size)
+    buffer = io.BytesIO()
+    torch.jit.save(torch.jit.script(StateDictModule(state)), buffer)
+    return buffer.getvalue()
+
+
+def run_benchmark(num_entries, tensor_size, repeat):
+    data = make_archive(num_entries, tensor_size)
+
+    def load():
+        torch.jit.load(io.BytesIO(data))
+
+    load()
+    runtimes = timeit.repeat(load, repeat=repeat, number=1)
+    avg_time = statistics.mean(runtimes) * 1000.0
+    stddev_time = statistics.stdev(runtimes) * 1000.0 if repeat > 1 else 0.0
+    print("{} entries of {} floats: avg. time: {:.3f} ms, stddev: {:.3f} ms, "
+          "{:.3f} us per entry".format(
+              num_entries, tensor_size, avg_time, stddev_time,
+              avg_time * 1000.0 / num_entries))
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--entries', type=int, nargs='+', default=[1000, 10000, 100000])
+    parser.add_argument('--tensor-size', type=int, default=4)
+    parser.add_argument('--repeat', type=int, default=5)
+    args = parser.parse_args()
+    for num_entries in args.entries:
+        run_benchmark(num_entries, args.tensor_size, args.repeat)
@@ -14,10 +14,21 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <random>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "ATen/ATen.h"
+#include "ATen/Parallel.h"
+#include "ATen/record_function.h"
 #include "caffe2/core/timer.h"
 #include "caffe2/utils/string_utils.h"
 #include "torch/csrc/autograd/grad_mode.h"
@@ -62,6 +73,37 @@ C10_DEFINE_bool(
   "Whether to print performance stats for AI-PEP.");
 
 C10_DEFINE_int(pytext_len, 0, "Length of input sequence.");
+C10_DEFINE_int(
+    load_threads,
+    0,
+    "If positive, run in load generation mode: this many client threads "
+    "share the module and run --iter requests in total, and the benchmark "
+    "reports throughput and latency percentiles.");
+C10_DEFINE_double(
+    target_qps,
+    0,
+    "In load generation mode, the rate at which requests arrive, independently "
+    "of how fast they are served (open loop). The latency of a request counts "
+    "from its arrival. If 0, every client thread sends its next request as soon "
+    "as the previous one finishes (closed loop).");
+C10_DEFINE_bool(
+    poisson_arrival,
+    true,
+    "With --target_qps, whether the requests arrive as a Poisson process, or at "
+    "a constant interval.");
+C10_DEFINE_int(
+    intra_op_threads,
+    0,
+    "If positive, the number of intra-op threads (at::set_num_threads).");
+C10_DEFINE_int(
+    inter_op_threads,
+    0,
+    "If positive, the number of inter-op threads (at::set_num_interop_threads).");
+C10_DEFINE_bool(
+    op_breakdown,
+    false,
+    "Whether to report the time spent in every operator of the main runs, "
+    "collected with RecordFunction.");
 
 std::vector<std::string>
 split(char separator, const std::string& string, bool ignore_empty = true) {
@@ -149,6 +191,174 @@ std::vector<c10::IValue> create_inputs() {
   return inputs;
 }
 
+// Per-operator counts and inclusive times of the main runs, collected by a
+// global RecordFunction callback. Every thread that runs operators keeps its
+// own stats, so the callback never takes a lock.
+struct OpStats {
+  struct Entry {
+    int64_t count = 0;
+    double micros = 0;
+  };
+  std::unordered_map<std::string, Entry> ops;
+  std::vector<high_resolution_clock::time_point> starts;
+};
+
+std::mutex op_stats_mutex;
+std::vector<std::shared_ptr<OpStats>> all_op_stats;
+std::atomic<bool> op_stats_enabled{false};
+
+OpStats& thread_op_stats() {
+  thread_local std::shared_ptr<OpStats> stats = [] {
+    auto stats = std::make_shared<OpStats>();
+    std::lock_guard<std::mutex> guard(op_stats_mutex);
+    all_op_stats.push_back(stats);
+    return stats;
+  }();
+  return *stats;
+}
+
+void add_op_breakdown_callback() {
+  at::addGlobalCallback(
+      at::RecordFunctionCallback(
+          [](const at::RecordFunction&) {
+            thread_op_stats().starts.push_back(high_resolution_clock::now());
+          },
+          [](const at::RecordFunction& fn) {
+            auto& stats = thread_op_stats();
+            if (stats.starts.empty()) {
+              return;
+            }
+            auto duration = high_resolution_clock::now() - stats.starts.back();
+            stats.starts.pop_back();
+            if (op_stats_enabled.load(std::memory_order_relaxed)) {
+              auto& entry = stats.ops[fn.name().str()];
+              entry.count++;
+              entry.micros += duration_cast<nanoseconds>(duration).count() / 1000.0;
+            }
+          })
+          .scopes({at::RecordScope::FUNCTION}));
+}
+
+void report_op_breakdown(int64_t num_requests) {
+  std::unordered_map<std::string, OpStats::Entry> total;
+  double total_micros = 0;
+  {
+    std::lock_guard<std::mutex> guard(op_stats_mutex);
+    for (const auto& stats : all_op_stats) {
+      for (const auto& op : stats->ops) {
+        auto& entry = total[op.first];
+        entry.count += op.second.count;
+        entry.micros += op.second.micros;
+      }
+    }
+  }
+  std::vector<std::pair<std::string, OpStats::Entry>> ops(total.begin(), total.end());
+  std::sort(ops.begin(), ops.end(), [](const auto& a, const auto& b) {
+    return a.second.micros > b.second.micros;
+  });
+  for (const auto& op : ops) {
+    total_micros += op.second.micros;
+  }
+  // Times are inclusive, so an op that calls other ops counts their time too.
+  std::cout << "Operator breakdown (inclusive times, per request):" << std::endl;
+  std::cout << std::setw(40) << std::left << "op" << std::right
+            << std::setw(10) << "calls" << std::setw(14) << "us"
+            << std::setw(10) << "%" << std::endl;
+  for (const auto& op : ops) {
+    std::cout << std::setw(40) << std::left << op.first << std::right
+              << std::setw(10) << std::fixed << std::setprecision(1)
+              << static_cast<double>(op.second.count) / num_requests
+              << std::setw(14) << op.second.micros / num_requests
+              << std::setw(10) << 100.0 * op.second.micros / total_micros
+              << std::endl;
+  }
+  std::cout.unsetf(std::ios_base::floatfield);
+}
+
+// The latencies are in microseconds, sorted.
+double percentile(const std::vector<double>& latencies, double p) {
+  if (latencies.empty()) {
+    return 0;
+  }
+  auto rank = static_cast<size_t>(std::ceil(p / 100.0 * latencies.size()));
+  return latencies[std::min(latencies.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+// Runs FLAGS_iter requests from FLAGS_load_threads client threads. In open
+// loop the request i arrives at arrivals[i], and a client that is free picks
+// the next request and waits for its arrival if it has not arrived yet; the
+// latency counts from the arrival, so it includes the time the request waits
+// for a free client.
+void run_load(torch::jit::Module& module, const std::vector<c10::IValue>& inputs) {
+  const int64_t num_requests = FLAGS_iter;
+  const bool open_loop = FLAGS_target_qps > 0;
+  std::vector<high_resolution_clock::duration> arrivals(num_requests);
+  if (open_loop) {
+    std::mt19937_64 generator(0);
+    std::exponential_distribution<double> interval(FLAGS_target_qps);
+    double seconds = 0;
+    for (int64_t i = 0; i < num_requests; ++i) {
+      arrivals[i] = duration_cast<high_resolution_clock::duration>(
+          duration<double>(seconds));
+      seconds += FLAGS_poisson_arrival ? interval(generator)
+                                       : 1.0 / FLAGS_target_qps;
+    }
+  }
+
+  std::vector<double> latencies(num_requests);
+  std::atomic<int64_t> next_request{0};
+  const auto parent_grad_mode = torch::autograd::GradMode::is_enabled();
+  auto start = high_resolution_clock::now();
+  auto client = [&]() {
+    torch::autograd::AutoGradMode guard(parent_grad_mode);
+    torch::jit::GraphOptimizerEnabledGuard no_optimizer_guard(false);
+    if (FLAGS_op_breakdown) {
+      at::enableRecordFunction();
+    }
+    for (int64_t i = next_request++; i < num_requests; i = next_request++) {
+      auto request_start = high_resolution_clock::now();
+      if (open_loop) {
+        auto arrival = start + arrivals[i];
+        std::this_thread::sleep_until(arrival);
+        request_start = arrival;
+      }
+      module.forward(inputs);
+      latencies[i] = duration_cast<nanoseconds>(
+                         high_resolution_clock::now() - request_start)
+                         .count() /
+          1000.0;
+    }
+  };
+  std::vector<std::thread> clients;
+  for (int i = 0; i < FLAGS_load_threads; ++i) {
+    clients.emplace_back(client);
+  }
+  for (auto& thread : clients) {
+    thread.join();
+  }
+  double seconds = duration_cast<duration<double>>(
+      high_resolution_clock::now() - start).count();
+
+  if (FLAGS_report_pep) {
+    for (auto t : latencies) {
+      std::cout << "PyTorchObserver {\"type\": \"NET\", \"unit\": \"us\", \"metric\": \"latency\", \"value\": \"" << t << "\"}" << std::endl;
+    }
+  }
+  std::sort(latencies.begin(), latencies.end());
+  std::cout << "Load run finished. " << FLAGS_load_threads << " client threads, "
+            << (open_loop ? "open loop at target QPS " + c10::to_string(FLAGS_target_qps)
+                          : std::string("closed loop"))
+            << "." << std::endl;
+  std::cout << "Throughput: " << num_requests / seconds << " requests per second."
+            << std::endl;
+  std::cout << "Latency (us): p50 " << percentile(latencies, 50)
+            << ", p90 " << percentile(latencies, 90)
+            << ", p99 " << percentile(latencies, 99)
+            << ", p99.9 " << percentile(latencies, 99.9)
+            << ", max " << (latencies.empty() ? 0 : latencies.back())
+            << std::endl;
+}
+
 int main(int argc, char** argv) {
   c10::SetUsageMessage(
     "Run speed benchmark for pytorch model.\n"
@@ -157,12 +367,32 @@ int main(int argc, char** argv) {
     " --model=<model_file>"
     " --use_bundled_input=0"
     " --warmup=5"
-    " --iter=20");
+    " --iter=20\n"
+    "Load generation example:\n"
+    "./speed_benchmark_torch"
+    " --model=<model_file>"
+    " --use_bundled_input=0"
+    " --load_threads=8"
+    " --target_qps=200"
+    " --iter=10000");
   if (!c10::ParseCommandLineFlags(&argc, &argv)) {
     std::cerr << "Failed to parse command line flags!" << std::endl;
     return 1;
   }
 
+  // Both have to be set before any parallel work starts.
+  if (FLAGS_inter_op_threads > 0) {
+    at::set_num_interop_threads(FLAGS_inter_op_threads);
+  }
+  if (FLAGS_intra_op_threads > 0) {
+    at::set_num_threads(FLAGS_intra_op_threads);
+  }
+  if (FLAGS_op_breakdown) {
+    // global callbacks must be added before other threads run operators
+    add_op_breakdown_callback();
+    at::enableRecordFunction();
+  }
+
   std::vector<c10::IValue> inputs = create_inputs();
 
   torch::autograd::AutoGradMode guard(false);
@@ -209,6 +439,15 @@ int main(int argc, char** argv) {
       "Number of main runs should be non negative, provided ",
       FLAGS_iter,
       ".");
+  op_stats_enabled = true;
+  if (FLAGS_load_threads > 0) {
+    run_load(module, inputs);
+    if (FLAGS_op_breakdown) {
+      op_stats_enabled = false;
+      report_op_breakdown(FLAGS_iter);
+    }
+    return 0;
+  }
   caffe2::Timer timer;
   std::vector<float> times;
   auto micros = timer.MicroSeconds();
@@ -229,6 +468,10 @@ int main(int argc, char** argv) {
             << micros / FLAGS_iter
             << ". Iters per second: " << 1000.0 * 1000 * FLAGS_iter / micros
             << std::endl;
+  if (FLAGS_op_breakdown) {
+    op_stats_enabled = false;
+    report_op_breakdown(FLAGS_iter);
+  }
 
   return 0;
 }
@@ -32,4 +32,20 @@ at::Allocator* GetAllocator(const at::DeviceType& t) {
   return alloc;
 }
 
+bool memoryProfilingEnabled() {
+  const auto& state = ThreadLocalDebugInfo::get(DebugInfoKind::PROFILER_STATE);
+  auto* reporter_ptr = dynamic_cast<MemoryReportingInfoBase*>(state.get());
+  return reporter_ptr && reporter_ptr->memoryProfilingEnabled();
+}
+
+void reportMemoryUsageToProfiler(void* ptr, int64_t alloc_size, Device device) {
+  const auto& state = ThreadLocalDebugInfo::get(DebugInfoKind::PROFILER_STATE);
+  auto* reporter_ptr = dynamic_cast<MemoryReportingInfoBase*>(state.get());
+  if (reporter_ptr && reporter_ptr->memoryProfilingEnabled()) {
+    reporter_ptr->reportMemoryUsage(ptr, alloc_size, device);
+  }
+}
+
+MemoryReportingInfoBase::MemoryReportingInfoBase() {}
+
 } // namespace c10
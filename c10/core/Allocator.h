@@ -4,8 +4,9 @@
 #include <memory>
 
 #include <c10/core/Device.h>
-#include <c10/util/UniqueVoidPtr.h>
 #include <c10/util/Exception.h>
+#include <c10/util/ThreadLocalDebugInfo.h>
+#include <c10/util/UniqueVoidPtr.h>
 
 namespace c10 {
 
@@ -207,6 +208,23 @@ struct C10_API InefficientStdFunctionContext {
 C10_API void SetAllocator(DeviceType t, Allocator* alloc, uint8_t priority = 0);
 C10_API Allocator* GetAllocator(const DeviceType& t);
 
+// An interface for reporting the memory allocated and freed on a thread, e.g.,
+// by the profiler. It is looked up in the PROFILER_STATE slot of the
+// ThreadLocalDebugInfo, so it follows the work of the thread across async
+// tasks and into backward.
+struct C10_API MemoryReportingInfoBase : public c10::DebugInfoBase {
+  MemoryReportingInfoBase();
+  virtual ~MemoryReportingInfoBase() {}
+
+  // Negative alloc_size corresponds to freeing of the memory
+  virtual void reportMemoryUsage(void* ptr, int64_t alloc_size, Device device) = 0;
+
+  virtual bool memoryProfilingEnabled() const = 0;
+};
+
+C10_API bool memoryProfilingEnabled();
+C10_API void reportMemoryUsageToProfiler(void* ptr, int64_t alloc_size, Device device);
+
 template <DeviceType t>
 struct AllocatorRegisterer {
   explicit AllocatorRegisterer(Allocator* alloc) {
@@ -1,6 +1,8 @@
 #include <c10/core/CPUAllocator.h>
 #include <c10/core/DeviceType.h>
 
+#include <algorithm>
+
 // TODO: rename flags to C10
 C10_DEFINE_bool(
     caffe2_report_cpu_memory_usage,
@@ -17,8 +19,50 @@ C10_DEFINE_bool(
     false,
     "If set, fill memory with deterministic junk when allocating on CPU");
 
+C10_DEFINE_bool(
+    caffe2_track_cpu_memory_usage,
+    false,
+    "If set, collect memory usage statistics of the default CPU allocator "
+    "without logging every allocation");
+
 namespace c10 {
 
+namespace {
+
+void update_stat(CPUAllocatorStat& stat, int64_t amount) {
+  stat.current += amount;
+  stat.peak = std::max(stat.current, stat.peak);
+  if (amount > 0) {
+    stat.allocated += amount;
+  } else {
+    stat.freed += -amount;
+  }
+}
+
+void reset_accumulated_stat(CPUAllocatorStat& stat) {
+  stat.allocated = 0;
+  stat.freed = 0;
+}
+
+void reset_peak_stat(CPUAllocatorStat& stat) {
+  stat.peak = stat.current;
+}
+
+size_t size_bucket(size_t nbytes) {
+  size_t bucket = 0;
+  while (nbytes >>= 1) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+bool should_track_cpu_memory_usage() {
+  return FLAGS_caffe2_report_cpu_memory_usage ||
+      FLAGS_caffe2_track_cpu_memory_usage;
+}
+
+} // namespace
+
 void memset_junk(void* data, size_t num) {
   // This garbage pattern is NaN when interpreted as floating point values,
   // or as very large integer values.
@@ -98,14 +142,56 @@ void free_cpu(void* data) {
 // deallocation status
 class C10_API MemoryAllocationReporter {
  public:
-  MemoryAllocationReporter() : allocated_(0) {}
+  MemoryAllocationReporter() {}
   void New(void* ptr, size_t nbytes);
   void Delete(void* ptr);
 
+  CPUAllocatorStats GetStats();
+  void ResetAccumulatedStats();
+  void ResetPeakStats();
+  std::vector<CPUAllocationInfo> Snapshot();
+
+ private:
+  void UpdateStats(size_t nbytes, int64_t sign);
+
+  std::mutex mutex_;
+  std::unordered_map<void*, size_t> size_table_;
+  CPUAllocatorStats stats_;
+};
+
+// Reports the allocations of the default CPU allocator to the profiler, see
+// MemoryReportingInfoBase; keeps their sizes to report the frees.
+class ProfiledCPUMemoryReporter {
+ public:
+  void New(void* ptr, size_t nbytes) {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      size_table_[ptr] = nbytes;
+    }
+    reportMemoryUsageToProfiler(
+        ptr, static_cast<int64_t>(nbytes), Device(DeviceType::CPU));
+  }
+
+  void Delete(void* ptr) {
+    size_t nbytes = 0;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto it = size_table_.find(ptr);
+      if (it == size_table_.end()) {
+        return;
+      }
+      nbytes = it->second;
+      size_table_.erase(it);
+    }
+    // The memory may be freed outside of the profiling session that
+    // allocated it, in which case this is a no-op.
+    reportMemoryUsageToProfiler(
+        ptr, -static_cast<int64_t>(nbytes), Device(DeviceType::CPU));
+  }
+
  private:
   std::mutex mutex_;
   std::unordered_map<void*, size_t> size_table_;
-  size_t allocated_;
 };
 
 struct C10_API DefaultCPUAllocator final : at::Allocator {
@@ -113,8 +199,17 @@ struct C10_API DefaultCPUAllocator final : at::Allocator {
   ~DefaultCPUAllocator() override {}
   at::DataPtr allocate(size_t nbytes) const override {
     void* data = alloc_cpu(nbytes);
-    if (FLAGS_caffe2_report_cpu_memory_usage && nbytes > 0) {
+    const bool track = should_track_cpu_memory_usage() && nbytes > 0;
+    const bool profile = nbytes > 0 && memoryProfilingEnabled();
+    if (track) {
       getMemoryAllocationReporter().New(data, nbytes);
+    }
+    if (profile) {
+      getProfiledCPUMemoryReporter().New(data, nbytes);
+      return {data, data, track ? &ReportProfileAndDelete : &ProfileAndDelete,
+              at::Device(at::DeviceType::CPU)};
+    }
+    if (track) {
       return {data, data, &ReportAndDelete, at::Device(at::DeviceType::CPU)};
     }
     return {data, data, &free_cpu, at::Device(at::DeviceType::CPU)};
@@ -128,19 +223,39 @@ struct C10_API DefaultCPUAllocator final : at::Allocator {
     free_cpu(ptr);
   }
 
+  static void ProfileAndDelete(void* ptr) {
+    if (!ptr) {
+      return;
+    }
+    getProfiledCPUMemoryReporter().Delete(ptr);
+    free_cpu(ptr);
+  }
+
+  static void ReportProfileAndDelete(void* ptr) {
+    if (!ptr) {
+      return;
+    }
+    getProfiledCPUMemoryReporter().Delete(ptr);
+    ReportAndDelete(ptr);
+  }
+
   at::DeleterFnPtr raw_deleter() const override {
-    if (FLAGS_caffe2_report_cpu_memory_usage) {
+    if (should_track_cpu_memory_usage()) {
       return &ReportAndDelete;
     }
     return &free_cpu;
   }
 
- protected:
   static MemoryAllocationReporter& getMemoryAllocationReporter() {
     static MemoryAllocationReporter reporter_;
     return reporter_;
   }
 
+  static ProfiledCPUMemoryReporter& getProfiledCPUMemoryReporter() {
+    static ProfiledCPUMemoryReporter reporter_;
+    return reporter_;
+  }
+
 };
 
 // QNNPACK AND XNNPACK may out-of-bound access the input and / or output
@@ -205,10 +320,26 @@ class DefaultMobileCPUAllocator final : public at::Allocator {
 
 void NoDelete(void*) {}
 
+namespace {
+thread_local at::Allocator* cpu_allocator_override = nullptr;
+} // namespace
+
 at::Allocator* GetCPUAllocator() {
+  if (C10_UNLIKELY(cpu_allocator_override)) {
+    return cpu_allocator_override;
+  }
   return GetAllocator(DeviceType::CPU);
 }
 
+WithCPUAllocatorGuard::WithCPUAllocatorGuard(at::Allocator* allocator)
+    : prev_allocator_(cpu_allocator_override) {
+  cpu_allocator_override = allocator;
+}
+
+WithCPUAllocatorGuard::~WithCPUAllocatorGuard() {
+  cpu_allocator_override = prev_allocator_;
+}
+
 void SetCPUAllocator(at::Allocator* alloc, uint8_t priority) {
   SetAllocator(DeviceType::CPU, alloc, priority);
 }
@@ -248,22 +379,107 @@ REGISTER_ALLOCATOR(DeviceType::CPU, &g_cpu_alloc);
 
 #endif /* C10_Mobile */
 
+// The statistics are only collected by DefaultCPUAllocator; the mobile
+// allocator never reports to it.
+static MemoryAllocationReporter& getCPUMemoryAllocationReporter() {
+#ifdef C10_MOBILE
+  static MemoryAllocationReporter reporter_;
+  return reporter_;
+#else
+  return DefaultCPUAllocator::getMemoryAllocationReporter();
+#endif
+}
+
+CPUAllocatorStats GetDefaultCPUAllocatorStats() {
+  return getCPUMemoryAllocationReporter().GetStats();
+}
+
+void ResetDefaultCPUAllocatorAccumulatedStats() {
+  getCPUMemoryAllocationReporter().ResetAccumulatedStats();
+}
+
+void ResetDefaultCPUAllocatorPeakStats() {
+  getCPUMemoryAllocationReporter().ResetPeakStats();
+}
+
+std::vector<CPUAllocationInfo> SnapshotDefaultCPUAllocator() {
+  return getCPUMemoryAllocationReporter().Snapshot();
+}
+
+void MemoryAllocationReporter::UpdateStats(size_t nbytes, int64_t sign) {
+  const size_t bucket = size_bucket(nbytes);
+  update_stat(stats_.allocation, sign);
+  update_stat(stats_.allocated_bytes, sign * static_cast<int64_t>(nbytes));
+  update_stat(stats_.bucket_allocation[bucket], sign);
+  update_stat(
+      stats_.bucket_allocated_bytes[bucket],
+      sign * static_cast<int64_t>(nbytes));
+}
+
 void MemoryAllocationReporter::New(void* ptr, size_t nbytes) {
   std::lock_guard<std::mutex> guard(mutex_);
   size_table_[ptr] = nbytes;
-  allocated_ += nbytes;
-  LOG(INFO) << "C10 alloc " << nbytes << " bytes, total alloc " << allocated_
-            << " bytes.";
+  UpdateStats(nbytes, 1);
+  if (FLAGS_caffe2_report_cpu_memory_usage) {
+    LOG(INFO) << "C10 alloc " << nbytes << " bytes, total alloc "
+              << stats_.allocated_bytes.current << " bytes.";
+  }
 }
 
 void MemoryAllocationReporter::Delete(void* ptr) {
   std::lock_guard<std::mutex> guard(mutex_);
   auto it = size_table_.find(ptr);
   CHECK(it != size_table_.end());
-  allocated_ -= it->second;
-  LOG(INFO) << "C10 deleted " << it->second << " bytes, total alloc "
-            << allocated_ << " bytes.";
+  UpdateStats(it->second, -1);
+  if (FLAGS_caffe2_report_cpu_memory_usage) {
+    LOG(INFO) << "C10 deleted " << it->second << " bytes, total alloc "
+              << stats_.allocated_bytes.current << " bytes.";
+  }
   size_table_.erase(it);
 }
 
+CPUAllocatorStats MemoryAllocationReporter::GetStats() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return stats_;
+}
+
+void MemoryAllocationReporter::ResetAccumulatedStats() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  reset_accumulated_stat(stats_.allocation);
+  reset_accumulated_stat(stats_.allocated_bytes);
+  for (size_t i = 0; i < kNumCPUAllocatorSizeBuckets; ++i) {
+    reset_accumulated_stat(stats_.bucket_allocation[i]);
+    reset_accumulated_stat(stats_.bucket_allocated_bytes[i]);
+  }
+}
+
+void MemoryAllocationReporter::ResetPeakStats() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  reset_peak_stat(stats_.allocation);
+  reset_peak_stat(stats_.allocated_bytes);
+  for (size_t i = 0; i < kNumCPUAllocatorSizeBuckets; ++i) {
+    reset_peak_stat(stats_.bucket_allocation[i]);
+    reset_peak_stat(stats_.bucket_allocated_bytes[i]);
+  }
+}
+
+std::vector<CPUAllocationInfo> MemoryAllocationReporter::Snapshot() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  std::vector<CPUAllocationInfo> result;
+  result.reserve(size_table_.size());
+  for (const auto& entry : size_table_) {
+    CPUAllocationInfo info;
+    info.address = reinterpret_cast<int64_t>(entry.first);
+    info.size = static_cast<int64_t>(entry.second);
+    result.push_back(info);
+  }
+  std::sort(
+      result.begin(),
+      result.end(),
+      [](const CPUAllocationInfo& a, const CPUAllocationInfo& b) {
+        return a.address < b.address;
+      });
+  return result;
+}
+
 } // namespace c10
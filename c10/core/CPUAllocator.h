@@ -1,7 +1,9 @@
 #pragma once
 
+#include <array>
 #include <cstring>
 #include <unordered_map>
+#include <vector>
 
 #include <c10/core/Allocator.h>
 #include <c10/util/Logging.h>
@@ -11,6 +13,7 @@
 C10_DECLARE_bool(caffe2_report_cpu_memory_usage);
 C10_DECLARE_bool(caffe2_cpu_allocator_do_zero_fill);
 C10_DECLARE_bool(caffe2_cpu_allocator_do_junk_fill);
+C10_DECLARE_bool(caffe2_track_cpu_memory_usage);
 
 namespace c10 {
 
@@ -37,7 +40,8 @@ C10_API void memset_junk(void* data, size_t num);
 C10_API void* alloc_cpu(size_t nbytes);
 C10_API void free_cpu(void* data);
 
-// Get the CPU Allocator.
+// Get the CPU Allocator. Returns the innermost allocator installed on the
+// calling thread by a WithCPUAllocatorGuard, if any.
 C10_API at::Allocator* GetCPUAllocator();
 // Sets the CPU allocator to the given allocator: the caller gives away the
 // ownership of the pointer.
@@ -46,7 +50,65 @@ C10_API void SetCPUAllocator(at::Allocator* alloc, uint8_t priority = 0);
 // Get the Default CPU Allocator
 C10_API at::Allocator* GetDefaultCPUAllocator();
 
+// RAII guard that makes GetCPUAllocator() return `allocator` on the calling
+// thread while it is in scope. The guard does not take ownership of the
+// allocator, which must outlive every allocation made through it. Code that
+// looks up the CPU allocator through GetAllocator(DeviceType::CPU) is not
+// affected.
+class C10_API WithCPUAllocatorGuard {
+ public:
+  explicit WithCPUAllocatorGuard(at::Allocator* allocator);
+  ~WithCPUAllocatorGuard();
+
+  WithCPUAllocatorGuard(const WithCPUAllocatorGuard&) = delete;
+  WithCPUAllocatorGuard& operator=(const WithCPUAllocatorGuard&) = delete;
+
+ private:
+  at::Allocator* prev_allocator_;
+};
+
 // Get the Default Mobile CPU Allocator
 C10_API at::Allocator* GetDefaultMobileCPUAllocator();
 
+// Memory usage statistics of the default CPU allocator. They are only
+// collected while FLAGS_caffe2_track_cpu_memory_usage or
+// FLAGS_caffe2_report_cpu_memory_usage is set; allocations made while both
+// flags are off are invisible to them.
+
+struct CPUAllocatorStat {
+  int64_t current = 0;
+  int64_t peak = 0;
+  int64_t allocated = 0;
+  int64_t freed = 0;
+};
+
+// Allocations are grouped by size into power-of-two buckets: bucket i counts
+// allocations of [2^i, 2^(i+1)) bytes.
+constexpr size_t kNumCPUAllocatorSizeBuckets = 64;
+
+typedef std::array<CPUAllocatorStat, kNumCPUAllocatorSizeBuckets>
+    CPUAllocatorBucketStats;
+
+struct CPUAllocatorStats {
+  // COUNT: allocations requested by client code
+  CPUAllocatorStat allocation;
+  // SUM: bytes requested by client code
+  CPUAllocatorStat allocated_bytes;
+
+  // Same as above, broken down by allocation size
+  CPUAllocatorBucketStats bucket_allocation;
+  CPUAllocatorBucketStats bucket_allocated_bytes;
+};
+
+// A live allocation made by the default CPU allocator.
+struct CPUAllocationInfo {
+  int64_t address = 0;
+  int64_t size = 0;
+};
+
+C10_API CPUAllocatorStats GetDefaultCPUAllocatorStats();
+C10_API void ResetDefaultCPUAllocatorAccumulatedStats();
+C10_API void ResetDefaultCPUAllocatorPeakStats();
+C10_API std::vector<CPUAllocationInfo> SnapshotDefaultCPUAllocator();
+
 } // namespace c10
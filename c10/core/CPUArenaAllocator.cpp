@@ -0,0 +1,66 @@
+#include <c10/core/CPUArenaAllocator.h>
+
+#include <algorithm>
+#include <atomic>
+
+namespace c10 {
+
+// A chunk is reference counted: the arena holds one reference while the
+// chunk is current, and every allocation carved out of it holds another.
+struct CPUArenaAllocator::Chunk {
+  explicit Chunk(size_t size) : data(alloc_cpu(size)), size(size) {}
+
+  ~Chunk() {
+    free_cpu(data);
+  }
+
+  void* data;
+  size_t size;
+  std::atomic<size_t> refcount{1};
+};
+
+constexpr size_t CPUArenaAllocator::kDefaultChunkSize;
+
+CPUArenaAllocator::CPUArenaAllocator(size_t chunk_size)
+    : chunk_size_(chunk_size) {
+  TORCH_CHECK(chunk_size > 0, "CPUArenaAllocator: chunk size must be positive");
+}
+
+CPUArenaAllocator::~CPUArenaAllocator() {
+  if (chunk_) {
+    release_chunk(chunk_);
+  }
+}
+
+void CPUArenaAllocator::release_chunk(void* ptr) {
+  auto* chunk = static_cast<Chunk*>(ptr);
+  if (chunk->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete chunk;
+  }
+}
+
+at::DataPtr CPUArenaAllocator::allocate(size_t nbytes) const {
+  if (nbytes == 0) {
+    return {nullptr, nullptr, &NoDelete, at::Device(DeviceType::CPU)};
+  }
+  const size_t aligned = (nbytes + gAlignment - 1) / gAlignment * gAlignment;
+  if (!chunk_ || offset_ + aligned > chunk_->size) {
+    auto* chunk = new Chunk(std::max(chunk_size_, aligned));
+    if (chunk_) {
+      release_chunk(chunk_);
+    }
+    chunk_ = chunk;
+    offset_ = 0;
+    ++num_chunks_;
+  }
+  void* data = static_cast<char*>(chunk_->data) + offset_;
+  offset_ += aligned;
+  bytes_allocated_ += aligned;
+  chunk_->refcount.fetch_add(1, std::memory_order_relaxed);
+  return {data, chunk_, &release_chunk, at::Device(DeviceType::CPU)};
+}
+
+CPUArenaGuard::CPUArenaGuard(size_t chunk_size)
+    : allocator_(chunk_size), guard_(&allocator_) {}
+
+} // namespace c10
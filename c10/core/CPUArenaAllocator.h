@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <c10/core/Allocator.h>
+#include <c10/core/CPUAllocator.h>
+
+namespace c10 {
+
+// A bump allocator for CPU memory with a lifetime limited to a scope, e.g.
+// one inference request.
+//
+// Memory is obtained from the system in large chunks, and every allocation
+// simply advances a pointer within the current chunk. Individual frees do not
+// return memory: each chunk is released in one piece once the arena is
+// destroyed (or has moved on to a new chunk) and every allocation carved out
+// of it has been freed. Tensors that outlive the arena therefore stay valid;
+// they only keep their chunk alive.
+//
+// Allocation is not thread-safe: an arena must only be used by one thread at
+// a time. Freeing memory is thread-safe and may happen on any thread.
+class C10_API CPUArenaAllocator final : public at::Allocator {
+ public:
+  static constexpr size_t kDefaultChunkSize = 16 * 1024 * 1024;
+
+  explicit CPUArenaAllocator(size_t chunk_size = kDefaultChunkSize);
+  ~CPUArenaAllocator() override;
+
+  CPUArenaAllocator(const CPUArenaAllocator&) = delete;
+  CPUArenaAllocator& operator=(const CPUArenaAllocator&) = delete;
+
+  at::DataPtr allocate(size_t nbytes) const override;
+
+  // Number of bytes handed out so far, including alignment padding.
+  size_t bytes_allocated() const {
+    return bytes_allocated_;
+  }
+
+  // Number of chunks obtained from the system so far.
+  size_t num_chunks() const {
+    return num_chunks_;
+  }
+
+ private:
+  struct Chunk;
+
+  static void release_chunk(void* chunk);
+
+  const size_t chunk_size_;
+  // allocate() is const in the Allocator interface.
+  mutable Chunk* chunk_ = nullptr;
+  mutable size_t offset_ = 0;
+  mutable size_t bytes_allocated_ = 0;
+  mutable size_t num_chunks_ = 0;
+};
+
+// RAII guard that serves all CPU allocations made through GetCPUAllocator()
+// on the calling thread from a CPUArenaAllocator while in scope:
+//
+//   {
+//     c10::CPUArenaGuard arena;
+//     auto output = module.forward(inputs);
+//   } // arena memory not referenced by `output` is released here
+class C10_API CPUArenaGuard {
+ public:
+  explicit CPUArenaGuard(
+      size_t chunk_size = CPUArenaAllocator::kDefaultChunkSize);
+
+  CPUArenaAllocator& allocator() {
+    return allocator_;
+  }
+
+ private:
+  CPUArenaAllocator allocator_;
+  WithCPUAllocatorGuard guard_;
+};
+
+} // namespace c10
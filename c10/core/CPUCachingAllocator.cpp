@@ -0,0 +1,414 @@
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/util/Exception.h>
+#include <c10/util/llvmMathExtras.h>
+#include <c10/util/numa.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+C10_DEFINE_int64(
+    caffe2_cpu_caching_allocator_max_block_size,
+    256 * 1024 * 1024,
+    "Requests larger than this many bytes bypass the CPU caching allocator");
+
+C10_DEFINE_int64(
+    caffe2_cpu_caching_allocator_thread_cache_size,
+    16 * 1024 * 1024,
+    "Maximum number of bytes kept in each thread's free list by the CPU "
+    "caching allocator. Set to 0 to disable per-thread caching.");
+
+C10_DEFINE_int64(
+    caffe2_cpu_caching_allocator_trim_threshold,
+    1024 * 1024 * 1024,
+    "Maximum number of bytes kept in the global pool of the CPU caching "
+    "allocator; freed blocks beyond this are returned to the system");
+
+namespace c10 {
+namespace CPUCachingAllocator {
+
+namespace {
+
+// Every block starts with a header recording its size class, so that the
+// deleter can find its way back to the right free list without a lookup
+// table. The header occupies a full alignment unit to keep the user pointer
+// aligned to gAlignment.
+struct BlockHeader {
+  size_t size;        // block size in bytes, excluding the header
+  int64_t bin;        // size class, or kUncachedBin
+  int64_t numa_node;  // node the block was placed on, or -1
+};
+
+constexpr size_t kHeaderSize = gAlignment;
+static_assert(sizeof(BlockHeader) <= kHeaderSize, "header does not fit");
+
+constexpr int kMinBlockLog2 = 6;                   // 64 bytes
+constexpr size_t kMinBlockSize = size_t(1) << kMinBlockLog2;
+constexpr int kMaxBlockLog2 = 40;                  // 1 TiB
+constexpr int kStepsPerPowerOfTwo = 4;
+constexpr size_t kNumBins =
+    1 + kStepsPerPowerOfTwo * (kMaxBlockLog2 - kMinBlockLog2);
+constexpr int64_t kUncachedBin = -1;
+
+using FreeList = std::array<std::vector<void*>, kNumBins>;
+
+// Maps a request size to its size class and the rounded block size.
+// Sizes in (2^L, 2^(L+1)] are rounded up to a multiple of 2^(L-2).
+int64_t size_class(size_t nbytes, size_t* block_size) {
+  if (nbytes <= kMinBlockSize) {
+    *block_size = kMinBlockSize;
+    return 0;
+  }
+  const int log2 = 63 - static_cast<int>(llvm::countLeadingZeros(
+                            static_cast<uint64_t>(nbytes - 1)));
+  if (log2 >= kMaxBlockLog2 ||
+      static_cast<int64_t>(nbytes) >
+          FLAGS_caffe2_cpu_caching_allocator_max_block_size) {
+    *block_size = nbytes;
+    return kUncachedBin;
+  }
+  const size_t step = (size_t(1) << log2) / kStepsPerPowerOfTwo;
+  const size_t steps = (nbytes + step - 1) / step;
+  *block_size = steps * step;
+  return 1 + kStepsPerPowerOfTwo * (log2 - kMinBlockLog2) +
+      static_cast<int64_t>(steps - kStepsPerPowerOfTwo - 1);
+}
+
+struct AtomicStat {
+  std::atomic<int64_t> current{0};
+  std::atomic<int64_t> peak{0};
+  std::atomic<int64_t> allocated{0};
+  std::atomic<int64_t> freed{0};
+
+  void update(int64_t amount) {
+    const int64_t now =
+        current.fetch_add(amount, std::memory_order_relaxed) + amount;
+    int64_t prev_peak = peak.load(std::memory_order_relaxed);
+    while (now > prev_peak &&
+           !peak.compare_exchange_weak(
+               prev_peak, now, std::memory_order_relaxed)) {
+    }
+    if (amount > 0) {
+      allocated.fetch_add(amount, std::memory_order_relaxed);
+    } else {
+      freed.fetch_add(-amount, std::memory_order_relaxed);
+    }
+  }
+
+  Stat get() const {
+    Stat stat;
+    stat.current = current.load(std::memory_order_relaxed);
+    stat.peak = peak.load(std::memory_order_relaxed);
+    stat.allocated = allocated.load(std::memory_order_relaxed);
+    stat.freed = freed.load(std::memory_order_relaxed);
+    return stat;
+  }
+
+  void reset_accumulated() {
+    allocated.store(0, std::memory_order_relaxed);
+    freed.store(0, std::memory_order_relaxed);
+  }
+
+  void reset_peak() {
+    peak.store(current.load(std::memory_order_relaxed),
+               std::memory_order_relaxed);
+  }
+};
+
+struct AtomicStats {
+  AtomicStat allocation;
+  AtomicStat segment;
+  AtomicStat allocated_bytes;
+  AtomicStat reserved_bytes;
+  AtomicStat cached_bytes;
+  std::atomic<int64_t> num_cache_hits{0};
+  std::atomic<int64_t> num_cache_misses{0};
+  std::atomic<int64_t> num_trims{0};
+};
+
+AtomicStats& stats() {
+  // Leaked on purpose: thread caches may flush into the global state during
+  // thread exit, after static destructors have run.
+  static AtomicStats* stats = new AtomicStats();
+  return *stats;
+}
+
+BlockHeader* header_of(void* ptr) {
+  return reinterpret_cast<BlockHeader*>(static_cast<char*>(ptr) - kHeaderSize);
+}
+
+void* system_alloc(size_t block_size, int64_t bin, int numa_node) {
+  // alloc_cpu places the memory on the calling thread's NUMA node.
+  void* raw = alloc_cpu(kHeaderSize + block_size);
+  auto* header = static_cast<BlockHeader*>(raw);
+  header->size = block_size;
+  header->bin = bin;
+  header->numa_node = numa_node;
+  auto& s = stats();
+  s.segment.update(1);
+  s.reserved_bytes.update(block_size);
+  return static_cast<char*>(raw) + kHeaderSize;
+}
+
+void system_free(void* ptr) {
+  BlockHeader* header = header_of(ptr);
+  auto& s = stats();
+  s.segment.update(-1);
+  s.reserved_bytes.update(-static_cast<int64_t>(header->size));
+  free_cpu(header);
+}
+
+struct GlobalPool {
+  std::mutex mutex;
+  FreeList blocks;
+  size_t cached_bytes = 0;
+
+  void* pop(int64_t bin) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& list = blocks[bin];
+    if (list.empty()) {
+      return nullptr;
+    }
+    void* ptr = list.back();
+    list.pop_back();
+    cached_bytes -= header_of(ptr)->size;
+    return ptr;
+  }
+
+  // Takes ownership of a free block; releases it to the system if keeping it
+  // would exceed the trim threshold.
+  void push(void* ptr) {
+    BlockHeader* header = header_of(ptr);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (static_cast<int64_t>(cached_bytes + header->size) <=
+          FLAGS_caffe2_cpu_caching_allocator_trim_threshold) {
+        blocks[header->bin].push_back(ptr);
+        cached_bytes += header->size;
+        return;
+      }
+    }
+    stats().cached_bytes.update(-static_cast<int64_t>(header->size));
+    stats().num_trims.fetch_add(1, std::memory_order_relaxed);
+    system_free(ptr);
+  }
+
+  void release_all() {
+    std::vector<void*> to_free;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (auto& list : blocks) {
+        to_free.insert(to_free.end(), list.begin(), list.end());
+        list.clear();
+      }
+      cached_bytes = 0;
+    }
+    for (void* ptr : to_free) {
+      stats().cached_bytes.update(-static_cast<int64_t>(header_of(ptr)->size));
+      system_free(ptr);
+    }
+  }
+};
+
+// In NUMA mode there is one global pool per node, so that a block is only
+// reused by threads running on the node that holds its memory.
+GlobalPool& global_pool(int numa_node) {
+  static const size_t num_pools = std::max(GetNumNUMANodes(), 1);
+  // Leaked on purpose, see stats().
+  static GlobalPool* pools = new GlobalPool[num_pools];
+  return pools[numa_node > 0 ? numa_node % num_pools : 0];
+}
+
+struct ThreadCache {
+  FreeList blocks;
+  size_t cached_bytes = 0;
+
+  ~ThreadCache();
+
+  void* pop(int64_t bin) {
+    auto& list = blocks[bin];
+    if (list.empty()) {
+      return nullptr;
+    }
+    void* ptr = list.back();
+    list.pop_back();
+    cached_bytes -= header_of(ptr)->size;
+    return ptr;
+  }
+
+  bool try_push(void* ptr, int numa_node) {
+    const size_t size = header_of(ptr)->size;
+    if (static_cast<int64_t>(cached_bytes + size) >
+            FLAGS_caffe2_cpu_caching_allocator_thread_cache_size ||
+        header_of(ptr)->numa_node != numa_node) {
+      return false;
+    }
+    blocks[header_of(ptr)->bin].push_back(ptr);
+    cached_bytes += size;
+    return true;
+  }
+
+  void flush() {
+    for (auto& list : blocks) {
+      for (void* ptr : list) {
+        global_pool(header_of(ptr)->numa_node).push(ptr);
+      }
+      list.clear();
+    }
+    cached_bytes = 0;
+  }
+};
+
+// Tensors may still be freed by other thread_local destructors after the
+// thread cache is gone; those frees go directly to the global pool.
+thread_local bool thread_cache_destroyed = false;
+
+ThreadCache::~ThreadCache() {
+  flush();
+  thread_cache_destroyed = true;
+}
+
+ThreadCache* thread_cache() {
+  if (C10_UNLIKELY(thread_cache_destroyed)) {
+    return nullptr;
+  }
+  static thread_local ThreadCache cache;
+  return &cache;
+}
+
+void fill_reused_block(void* ptr, size_t nbytes) {
+  if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+    memset(ptr, 0, nbytes);
+  } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+    memset_junk(ptr, nbytes);
+  }
+}
+
+void* allocate_block(size_t nbytes) {
+  size_t block_size = 0;
+  const int64_t bin = size_class(nbytes, &block_size);
+  const int numa_node = GetCurrentNUMANode();
+  auto& s = stats();
+  void* ptr = nullptr;
+  if (bin != kUncachedBin) {
+    ThreadCache* cache = thread_cache();
+    if (cache) {
+      ptr = cache->pop(bin);
+    }
+    if (!ptr) {
+      ptr = global_pool(numa_node).pop(bin);
+    }
+  }
+  if (ptr) {
+    s.num_cache_hits.fetch_add(1, std::memory_order_relaxed);
+    s.cached_bytes.update(-static_cast<int64_t>(block_size));
+    fill_reused_block(ptr, nbytes);
+  } else {
+    s.num_cache_misses.fetch_add(1, std::memory_order_relaxed);
+    ptr = system_alloc(block_size, bin, numa_node);
+  }
+  s.allocation.update(1);
+  s.allocated_bytes.update(block_size);
+  return ptr;
+}
+
+void free_block(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  BlockHeader* header = header_of(ptr);
+  auto& s = stats();
+  s.allocation.update(-1);
+  s.allocated_bytes.update(-static_cast<int64_t>(header->size));
+  if (header->bin == kUncachedBin) {
+    system_free(ptr);
+    return;
+  }
+  s.cached_bytes.update(header->size);
+  ThreadCache* cache = thread_cache();
+  if (cache && cache->try_push(ptr, GetCurrentNUMANode())) {
+    return;
+  }
+  global_pool(header->numa_node).push(ptr);
+}
+
+struct CPUCachingAllocator final : public at::Allocator {
+  at::DataPtr allocate(size_t nbytes) const override {
+    if (nbytes == 0) {
+      return {nullptr, nullptr, &free_block, at::Device(DeviceType::CPU)};
+    }
+    void* data = allocate_block(nbytes);
+    return {data, data, &free_block, at::Device(DeviceType::CPU)};
+  }
+
+  at::DeleterFnPtr raw_deleter() const override {
+    return &free_block;
+  }
+};
+
+CPUCachingAllocator g_cpu_caching_allocator;
+
+} // namespace
+
+at::Allocator* get() {
+  return &g_cpu_caching_allocator;
+}
+
+void emptyCache() {
+  ThreadCache* cache = thread_cache();
+  if (cache) {
+    cache->flush();
+  }
+  for (int node = 0; node < std::max(GetNumNUMANodes(), 1); ++node) {
+    global_pool(node).release_all();
+  }
+}
+
+AllocatorStats getStats() {
+  const auto& s = stats();
+  AllocatorStats result;
+  result.allocation = s.allocation.get();
+  result.segment = s.segment.get();
+  result.allocated_bytes = s.allocated_bytes.get();
+  result.reserved_bytes = s.reserved_bytes.get();
+  result.cached_bytes = s.cached_bytes.get();
+  result.num_cache_hits = s.num_cache_hits.load(std::memory_order_relaxed);
+  result.num_cache_misses = s.num_cache_misses.load(std::memory_order_relaxed);
+  result.num_trims = s.num_trims.load(std::memory_order_relaxed);
+  return result;
+}
+
+void resetAccumulatedStats() {
+  auto& s = stats();
+  for (AtomicStat* stat :
+       {&s.allocation,
+        &s.segment,
+        &s.allocated_bytes,
+        &s.reserved_bytes,
+        &s.cached_bytes}) {
+    stat->reset_accumulated();
+  }
+  s.num_cache_hits = 0;
+  s.num_cache_misses = 0;
+  s.num_trims = 0;
+}
+
+void resetPeakStats() {
+  auto& s = stats();
+  for (AtomicStat* stat :
+       {&s.allocation,
+        &s.segment,
+        &s.allocated_bytes,
+        &s.reserved_bytes,
+        &s.cached_bytes}) {
+    stat->reset_peak();
+  }
+}
+
+} // namespace CPUCachingAllocator
+} // namespace c10
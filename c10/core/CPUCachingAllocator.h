@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <c10/core/Allocator.h>
+#include <c10/core/CPUAllocator.h>
+#include <c10/util/Flags.h>
+
+C10_DECLARE_int64(caffe2_cpu_caching_allocator_max_block_size);
+C10_DECLARE_int64(caffe2_cpu_caching_allocator_thread_cache_size);
+C10_DECLARE_int64(caffe2_cpu_caching_allocator_trim_threshold);
+
+namespace c10 {
+
+// A caching allocator for CPU memory.
+//
+// The default CPU allocator hands every request straight to posix_memalign
+// and every free straight back to the system. For workloads that allocate
+// the same handful of intermediate sizes over and over (e.g. inference
+// servers), this allocator keeps freed blocks around and reuses them:
+//
+// - Requests are rounded up to a size class. There are four evenly spaced
+//   classes between consecutive powers of two, so at most 25% of a block is
+//   wasted on rounding.
+// - Freed blocks first go to a free list owned by the freeing thread, which
+//   is accessed without any locking. Once a thread has cached
+//   FLAGS_caffe2_cpu_caching_allocator_thread_cache_size bytes, further
+//   blocks are handed to a global pool shared by all threads.
+// - The global pool never holds more than
+//   FLAGS_caffe2_cpu_caching_allocator_trim_threshold bytes; blocks that
+//   would push it over the threshold are returned to the system.
+// - Requests larger than FLAGS_caffe2_cpu_caching_allocator_max_block_size
+//   bypass the cache altogether.
+// - When NUMA is enabled (see c10::IsNUMAEnabled), blocks are placed on the
+//   allocating thread's node and are only reused by threads on that node.
+//
+// The allocator is opt-in. To use it for all CPU tensors, install it with a
+// priority higher than the default allocator's:
+//
+//   c10::SetCPUAllocator(c10::CPUCachingAllocator::get(), /*priority=*/1);
+
+namespace CPUCachingAllocator {
+
+using Stat = CPUAllocatorStat;
+
+// Struct containing memory allocator summary statistics.
+struct AllocatorStats {
+  // COUNT: allocations requested by client code
+  Stat allocation;
+  // COUNT: number of blocks obtained from the system allocator
+  Stat segment;
+
+  // SUM: bytes handed out to client code (after size class rounding)
+  Stat allocated_bytes;
+  // SUM: bytes obtained from the system allocator (both free and used)
+  Stat reserved_bytes;
+  // SUM: bytes sitting in free lists, ready for reuse
+  Stat cached_bytes;
+
+  // COUNT: allocations served from a free list
+  int64_t num_cache_hits = 0;
+  // COUNT: allocations that had to go to the system allocator
+  int64_t num_cache_misses = 0;
+  // COUNT: cached blocks released to the system due to the trim threshold
+  int64_t num_trims = 0;
+};
+
+C10_API at::Allocator* get();
+
+// Returns the blocks held by the global pool and by the calling thread's
+// free list to the system. Free lists of other threads are left untouched;
+// they are flushed to the global pool when their thread exits.
+C10_API void emptyCache();
+
+C10_API AllocatorStats getStats();
+C10_API void resetAccumulatedStats();
+C10_API void resetPeakStats();
+
+} // namespace CPUCachingAllocator
+} // namespace c10
@@ -139,6 +139,9 @@ enum class DispatchKey : uint8_t {
   // Autocasting precedes VariableTypeId, to ensure casts are autograd-exposed
   // and inputs are saved for backward in the post-autocast type.
   Autocast,
+  // Autocasting of CPU tensors to bfloat16; Autocast only touches CUDA
+  // tensors, so the two can be enabled independently.
+  AutocastCPU,
 
   // Here are some reserved pre-autograd keys for user-defined backends, see
   // Note [Private use DispatchKey]
@@ -151,6 +154,10 @@ enum class DispatchKey : uint8_t {
   // autograd; for example, error checking, tracing, profiling or vmap.  They
   // go here.
 
+  // Lazy tensors record the ops run on them into a JIT graph instead of
+  // running them, see torch/csrc/jit/runtime/lazy_tensor.h.
+  Lazy,
+
   // TESTING: This is intended to be a generic testing tensor type id.
   // Don't use it for anything real; its only acceptable use is within a single
   // process test.  Use it by creating a TensorImpl with this DispatchKey, and
@@ -0,0 +1,27 @@
+#include <c10/core/InferenceMode.h>
+
+namespace c10 {
+
+namespace {
+thread_local bool inference_mode_enabled = false;
+} // namespace
+
+InferenceMode::InferenceMode()
+    : prev_enabled_(inference_mode_enabled),
+      autograd_guard_(DispatchKey::Autograd) {
+  inference_mode_enabled = true;
+}
+
+InferenceMode::~InferenceMode() {
+  inference_mode_enabled = prev_enabled_;
+}
+
+bool InferenceMode::is_enabled() {
+  return inference_mode_enabled;
+}
+
+void InferenceMode::set_enabled(bool enabled) {
+  inference_mode_enabled = enabled;
+}
+
+} // namespace c10
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <c10/core/impl/LocalDispatchKeySet.h>
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+
+// A RAII, thread local guard for pure inference. While it is enabled:
+//
+//  - dispatch skips the Autograd key, so operators go straight to their
+//    kernels without recording anything for backward, and
+//  - tensors created on this thread don't allocate a version counter, so
+//    in-place operations on them don't bump one either.
+//
+// Tensors created in inference mode ("inference tensors") can't be saved
+// for backward later, since the autograd graph could not tell whether they
+// were modified since; the check lives in SavedVariable.
+//
+// Gradient mode is not part of this guard, since GradMode lives in ATen;
+// torch::InferenceMode in the C++ frontend disables both.
+struct C10_API InferenceMode {
+  InferenceMode();
+  ~InferenceMode();
+
+  InferenceMode(const InferenceMode&) = delete;
+  InferenceMode& operator=(const InferenceMode&) = delete;
+
+  static bool is_enabled();
+  static void set_enabled(bool enabled);
+
+ private:
+  bool prev_enabled_;
+  impl::ExcludeDispatchKeyGuard autograd_guard_;
+};
+
+} // namespace c10
@@ -24,6 +24,7 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
         resizable_(resizable),
         received_cuda_(false),
         allocator_(allocator) {
+    enable_biased_refcount_();
     if (resizable) {
       AT_ASSERTM(
           allocator_, "For resizable storage, allocator must be provided");
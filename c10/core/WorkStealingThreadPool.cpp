@@ -0,0 +1,172 @@
+#include <c10/core/WorkStealingThreadPool.h>
+
+#include <c10/util/Logging.h>
+
+#include <algorithm>
+
+namespace c10 {
+
+namespace {
+
+// number of rounds an idle worker looks for work before going to sleep
+constexpr int kSpinRounds = 64;
+
+// pool and queue of the calling thread, if it is a pool worker
+thread_local const WorkStealingThreadPool* current_pool = nullptr;
+thread_local size_t current_queue = 0;
+
+} // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(
+    int pool_size,
+    int numa_node_id,
+    std::function<void()> init_thread)
+    : threads_(pool_size < 0 ? defaultNumThreads() : pool_size),
+      available_(threads_.size()) {
+  // A pool without threads still needs a queue, runPendingTask() drains it.
+  const size_t num_queues = std::max<size_t>(threads_.size(), 1);
+  for (size_t i = 0; i < num_queues; ++i) {
+    queues_.emplace_back(std::make_unique<WorkQueue>());
+  }
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    threads_[i] = std::thread([this, i, numa_node_id, init_thread]() {
+      NUMABind(numa_node_id);
+      if (init_thread) {
+        init_thread();
+      }
+      this->main_loop(i);
+    });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    running_ = false;
+  }
+  sleep_cv_.notify_all();
+
+  for (auto& t : threads_) {
+    try {
+      t.join();
+    } catch (const std::exception&) {
+    }
+  }
+}
+
+size_t WorkStealingThreadPool::size() const {
+  return threads_.size();
+}
+
+size_t WorkStealingThreadPool::numAvailable() const {
+  return available_;
+}
+
+bool WorkStealingThreadPool::inThreadPool() const {
+  return current_pool == this;
+}
+
+void WorkStealingThreadPool::run(std::function<void()> func) {
+  if (threads_.size() == 0) {
+    throw std::runtime_error("No threads to run a task");
+  }
+  const size_t index = current_pool == this
+      ? current_queue
+      : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+  {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    queues_[index]->tasks.emplace_back(std::move(func));
+  }
+  pending_.fetch_add(1);
+
+  // A worker registers as a sleeper under sleep_mutex_ before it checks
+  // pending_ for the last time, so either it sees the new task or we see it.
+  if (sleepers_.load() > 0) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    sleep_cv_.notify_one();
+  }
+}
+
+bool WorkStealingThreadPool::pop(size_t index, Task& task) {
+  WorkQueue& queue = *queues_[index];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+  task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  pending_.fetch_sub(1);
+  return true;
+}
+
+bool WorkStealingThreadPool::steal(size_t index, Task& task) {
+  const size_t num_queues = queues_.size();
+  for (size_t offset = 1; offset <= num_queues; ++offset) {
+    WorkQueue& queue = *queues_[(index + offset) % num_queues];
+    // Do not wait for a contended queue, try the next one.
+    std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+    if (!lock.owns_lock() || queue.tasks.empty()) {
+      continue;
+    }
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    pending_.fetch_sub(1);
+    return true;
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::run_task(Task& task) {
+  try {
+    task();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Exception in thread pool task: " << e.what();
+  } catch (...) {
+    LOG(ERROR) << "Exception in thread pool task: unknown";
+  }
+  // Destroy the task right away, it may hold on to resources.
+  task = nullptr;
+}
+
+bool WorkStealingThreadPool::runPendingTask() {
+  if (pending_.load() == 0) {
+    return false;
+  }
+  Task task;
+  const size_t start = next_queue_.load(std::memory_order_relaxed);
+  if (!steal(start, task)) {
+    return false;
+  }
+  run_task(task);
+  return true;
+}
+
+void WorkStealingThreadPool::main_loop(size_t index) {
+  current_pool = this;
+  current_queue = index;
+
+  Task task;
+  int idle_rounds = 0;
+  while (running_) {
+    if (pop(index, task) || steal(index, task)) {
+      idle_rounds = 0;
+      --available_;
+      run_task(task);
+      ++available_;
+      continue;
+    }
+
+    if (++idle_rounds < kSpinRounds || pending_.load() > 0) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    ++sleepers_;
+    sleep_cv_.wait(lock, [this]() { return pending_.load() > 0 || !running_; });
+    --sleepers_;
+    idle_rounds = 0;
+  }
+}
+
+} // namespace c10
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <c10/core/thread_pool.h>
+
+namespace c10 {
+
+// A thread pool in which every worker owns a task deque.
+//
+// c10::ThreadPool keeps all tasks in one queue behind one mutex, which every
+// worker and every submitter contends on; with many cores and fine-grained
+// tasks that mutex dominates. Here tasks submitted from outside the pool are
+// spread round-robin over the worker deques, and tasks submitted by a worker
+// go to its own deque. A worker takes tasks from the back of its own deque
+// (most recently pushed, likely still in cache) and, once that is empty,
+// steals from the front of the other workers' deques. Each deque has its own
+// lock, so a lock is only ever contended by its owner and a thief; idle
+// workers spin briefly before going to sleep, and submitters only touch the
+// shared condition variable when some worker is actually asleep.
+//
+// Workers are bound to `numa_node_id` if it is not -1.
+//
+// Threads that wait for pool work to finish can call runPendingTask() to
+// execute queued tasks themselves instead of blocking.
+class C10_API WorkStealingThreadPool : public TaskThreadPoolBase {
+ public:
+  explicit WorkStealingThreadPool(
+      int pool_size,
+      int numa_node_id = -1,
+      std::function<void()> init_thread = nullptr);
+
+  ~WorkStealingThreadPool() override;
+
+  void run(std::function<void()> func) override;
+
+  size_t size() const override;
+
+  size_t numAvailable() const override;
+
+  bool inThreadPool() const override;
+
+  // Runs one queued task on the calling thread. Returns false if there was
+  // none.
+  bool runPendingTask();
+
+ private:
+  using Task = std::function<void()>;
+
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  // Entry point for pool threads.
+  void main_loop(size_t index);
+
+  // Takes the newest task of queue `index`.
+  bool pop(size_t index, Task& task);
+
+  // Takes the oldest task of any queue, starting after queue `index`.
+  bool steal(size_t index, Task& task);
+
+  void run_task(Task& task);
+
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<size_t> pending_{0};
+  std::atomic<size_t> available_;
+  std::atomic<size_t> next_queue_{0};
+  std::atomic<bool> running_{true};
+
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  std::atomic<size_t> sleepers_{0};
+};
+
+} // namespace c10
@@ -0,0 +1,79 @@
+#include <c10/core/impl/COW.h>
+
+#include <atomic>
+#include <cstring>
+
+namespace c10 {
+namespace impl {
+namespace cow {
+
+namespace {
+
+struct COWContext {
+  // The number of copy-on-write DataPtrs with this context.
+  std::atomic<int64_t> refcount{1};
+  DataPtr data;
+};
+
+COWContext* cow_context(const StorageImpl& storage) {
+  return storage.data_ptr().cast_context<COWContext>(&cow_deleter);
+}
+
+} // namespace
+
+void cow_deleter(void* ctx) {
+  auto cow = static_cast<COWContext*>(ctx);
+  if (--cow->refcount == 0) {
+    delete cow;
+  }
+}
+
+c10::intrusive_ptr<StorageImpl> lazy_clone_storage(StorageImpl& storage) {
+  TORCH_CHECK(
+      storage.device_type() == DeviceType::CPU,
+      "Only CPU storages can be cloned lazily, but got a ",
+      storage.device_type(),
+      " storage");
+  void* data = storage.data();
+  const Device device = storage.device();
+  COWContext* ctx = nullptr;
+  if (is_cow(storage)) {
+    ctx = cow_context(storage);
+    ++ctx->refcount;
+  } else {
+    ctx = new COWContext();
+    ctx->data = storage.set_data_ptr(DataPtr(data, ctx, &cow_deleter, device));
+    ctx->refcount = 2;
+  }
+  return c10::make_intrusive<StorageImpl>(
+      StorageImpl::use_byte_size_t(),
+      storage.dtype(),
+      storage.nbytes(),
+      DataPtr(data, ctx, &cow_deleter, device),
+      storage.allocator(),
+      storage.resizable());
+}
+
+void materialize_cow_storage_slow(StorageImpl& storage) {
+  COWContext* ctx = cow_context(storage);
+  TORCH_INTERNAL_ASSERT(ctx != nullptr);
+  if (ctx->refcount == 1) {
+    // No other storage shares the data anymore. The old DataPtr, returned by
+    // set_data_ptr, frees the context.
+    storage.set_data_ptr(std::move(ctx->data));
+    return;
+  }
+  Allocator* allocator = storage.allocator();
+  if (allocator == nullptr) {
+    allocator = GetAllocator(storage.device_type());
+  }
+  DataPtr copy = allocator->allocate(storage.nbytes());
+  if (storage.nbytes() > 0) {
+    std::memcpy(copy.get(), storage.data(), storage.nbytes());
+  }
+  storage.set_data_ptr(std::move(copy));
+}
+
+} // namespace cow
+} // namespace impl
+} // namespace c10
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <c10/core/StorageImpl.h>
+
+namespace c10 {
+namespace impl {
+namespace cow {
+
+// Copy-on-write storages.
+//
+// lazy_clone_storage returns a storage that shares the data of the given
+// storage until either of them is written to. Both then hold a DataPtr whose
+// context is a refcounted COWContext owning the original DataPtr; the
+// deleter of that DataPtr is what marks a storage as copy-on-write.
+//
+// Writers call materialize_cow_storage first, which gives the storage a
+// private copy of the data, or takes the original DataPtr back if no other
+// storage shares it anymore. ATen ops that write to their arguments do so
+// in VariableType; writes through raw data pointers are not detected.
+//
+// Only CPU storages can be cloned lazily. Lazily cloning a storage, and
+// materializing it, are not thread-safe against concurrent uses of that
+// storage, the same as resizing it.
+
+// The deleter of the DataPtrs of copy-on-write storages.
+C10_API void cow_deleter(void* ctx);
+
+inline bool is_cow(const StorageImpl& storage) {
+  return storage.data_ptr().get_deleter() == &cow_deleter;
+}
+
+C10_API c10::intrusive_ptr<StorageImpl> lazy_clone_storage(
+    StorageImpl& storage);
+
+C10_API void materialize_cow_storage_slow(StorageImpl& storage);
+
+inline void materialize_cow_storage(StorageImpl& storage) {
+  if (C10_UNLIKELY(is_cow(storage))) {
+    materialize_cow_storage_slow(storage);
+  }
+}
+
+} // namespace cow
+} // namespace impl
+} // namespace c10
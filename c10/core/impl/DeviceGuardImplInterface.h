@@ -109,6 +109,15 @@ struct C10_API DeviceGuardImplInterface {
     TORCH_CHECK(false, "Backend doesn't support acquiring a default stream.")
   }
 
+  /**
+   * Get a stream from the global pool for a given device, e.g. to run work
+   * concurrently with the current stream.
+   */
+  virtual Stream getStreamFromPool(Device, bool /*isHighPriority*/ = false)
+      const {
+    TORCH_CHECK(false, "Backend doesn't support acquiring a stream from pool.")
+  }
+
   /**
    * Set a stream to be the thread local current stream for its device.
    * Return the previous stream for that device. You are NOT required
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <c10/macros/Macros.h>
+#include <c10/util/ArrayRef.h>
+#include <c10/util/Exception.h>
+
+namespace c10 {
+namespace impl {
+
+// The sizes and strides of a tensor in a single buffer. Up to
+// kMaxInlineDims dimensions, the buffer is stored inline, so that a
+// TensorImpl of most tensors needs no allocation for its metadata, and
+// reading a size and the matching stride touches a single cache line; more
+// dimensions are stored in one heap buffer, sizes first. Compared with two
+// SmallVectors, it also drops the begin, end and capacity pointers of each.
+//
+// Resizing leaves the new sizes and strides uninitialized; callers set them
+// right after.
+class SizesAndStrides {
+ public:
+  static constexpr size_t kMaxInlineDims = 5;
+
+  // A single dimension of size 0 and stride 1, like a default TensorImpl.
+  SizesAndStrides() : size_(1) {
+    inlineStorage_[0] = 0;
+    inlineStorage_[kMaxInlineDims] = 1;
+  }
+
+  ~SizesAndStrides() {
+    if (C10_UNLIKELY(!isInline())) {
+      free(outOfLineStorage_);
+    }
+  }
+
+  SizesAndStrides(const SizesAndStrides& rhs) : size_(rhs.size_) {
+    if (C10_LIKELY(rhs.isInline())) {
+      copyInline(rhs);
+    } else {
+      allocateOutOfLine(size_);
+      copyOutOfLine(rhs);
+    }
+  }
+
+  SizesAndStrides& operator=(const SizesAndStrides& rhs) {
+    if (this == &rhs) {
+      return *this;
+    }
+    if (C10_LIKELY(rhs.isInline())) {
+      if (C10_UNLIKELY(!isInline())) {
+        free(outOfLineStorage_);
+      }
+      copyInline(rhs);
+    } else {
+      if (isInline()) {
+        allocateOutOfLine(rhs.size_);
+      } else {
+        resizeOutOfLine(rhs.size_);
+      }
+      copyOutOfLine(rhs);
+    }
+    size_ = rhs.size_;
+    return *this;
+  }
+
+  SizesAndStrides(SizesAndStrides&& rhs) noexcept : size_(rhs.size_) {
+    if (C10_LIKELY(isInline())) {
+      copyInline(rhs);
+    } else {
+      outOfLineStorage_ = rhs.outOfLineStorage_;
+      rhs.outOfLineStorage_ = nullptr;
+    }
+    rhs.size_ = 0;
+  }
+
+  SizesAndStrides& operator=(SizesAndStrides&& rhs) noexcept {
+    if (this == &rhs) {
+      return *this;
+    }
+    if (C10_UNLIKELY(!isInline())) {
+      free(outOfLineStorage_);
+    }
+    if (C10_LIKELY(rhs.isInline())) {
+      copyInline(rhs);
+    } else {
+      outOfLineStorage_ = rhs.outOfLineStorage_;
+      rhs.outOfLineStorage_ = nullptr;
+    }
+    size_ = rhs.size_;
+    rhs.size_ = 0;
+    return *this;
+  }
+
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  const int64_t* sizes_data() const noexcept {
+    return isInline() ? &inlineStorage_[0] : &outOfLineStorage_[0];
+  }
+
+  int64_t* sizes_data() noexcept {
+    return isInline() ? &inlineStorage_[0] : &outOfLineStorage_[0];
+  }
+
+  const int64_t* strides_data() const noexcept {
+    return isInline() ? &inlineStorage_[kMaxInlineDims] : &outOfLineStorage_[size_];
+  }
+
+  int64_t* strides_data() noexcept {
+    return isInline() ? &inlineStorage_[kMaxInlineDims] : &outOfLineStorage_[size_];
+  }
+
+  IntArrayRef sizes_arrayref() const noexcept {
+    return IntArrayRef{sizes_data(), size_};
+  }
+
+  IntArrayRef strides_arrayref() const noexcept {
+    return IntArrayRef{strides_data(), size_};
+  }
+
+  int64_t size_at(size_t idx) const {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(idx < size_);
+    return sizes_data()[idx];
+  }
+
+  int64_t& size_at(size_t idx) {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(idx < size_);
+    return sizes_data()[idx];
+  }
+
+  int64_t stride_at(size_t idx) const {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(idx < size_);
+    return strides_data()[idx];
+  }
+
+  int64_t& stride_at(size_t idx) {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(idx < size_);
+    return strides_data()[idx];
+  }
+
+  // Resizes to newSize dimensions and copies the given sizes; the strides
+  // are left uninitialized.
+  void set_sizes(IntArrayRef newSizes) {
+    resize(newSizes.size());
+    std::copy(newSizes.begin(), newSizes.end(), sizes_data());
+  }
+
+  // Keeps the sizes and strides of the first min(size(), newSize)
+  // dimensions.
+  void resize(size_t newSize) {
+    const size_t oldSize = size_;
+    if (newSize == oldSize) {
+      return;
+    }
+    if (C10_LIKELY(newSize <= kMaxInlineDims && isInline())) {
+      size_ = newSize;
+    } else {
+      resizeSlowPath(newSize, oldSize);
+    }
+  }
+
+ private:
+  bool isInline() const noexcept {
+    return size_ <= kMaxInlineDims;
+  }
+
+  void copyInline(const SizesAndStrides& rhs) {
+    std::memcpy(inlineStorage_, rhs.inlineStorage_, sizeof(inlineStorage_));
+  }
+
+  void copyOutOfLine(const SizesAndStrides& rhs) {
+    std::memcpy(outOfLineStorage_, rhs.outOfLineStorage_, storageBytes(rhs.size_));
+  }
+
+  static size_t storageBytes(size_t size) noexcept {
+    return size * 2 * sizeof(int64_t);
+  }
+
+  void allocateOutOfLine(size_t size) {
+    outOfLineStorage_ = static_cast<int64_t*>(malloc(storageBytes(size)));
+    TORCH_CHECK(outOfLineStorage_, "Could not allocate memory for Tensor SizesAndStrides!");
+  }
+
+  void resizeOutOfLine(size_t newSize) {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(!isInline());
+    outOfLineStorage_ = static_cast<int64_t*>(realloc(outOfLineStorage_, storageBytes(newSize)));
+    TORCH_CHECK(outOfLineStorage_, "Could not allocate memory for Tensor SizesAndStrides!");
+  }
+
+  void resizeSlowPath(size_t newSize, size_t oldSize) {
+    const size_t keep = std::min(oldSize, newSize);
+    if (newSize <= kMaxInlineDims) {
+      // Out of line to inline
+      int64_t* oldStorage = outOfLineStorage_;
+      std::memcpy(&inlineStorage_[0], &oldStorage[0], keep * sizeof(int64_t));
+      std::memcpy(&inlineStorage_[kMaxInlineDims], &oldStorage[oldSize], keep * sizeof(int64_t));
+      free(oldStorage);
+    } else if (isInline()) {
+      // Inline to out of line
+      int64_t tmp[kMaxInlineDims * 2];
+      std::memcpy(tmp, inlineStorage_, sizeof(inlineStorage_));
+      allocateOutOfLine(newSize);
+      std::memcpy(&outOfLineStorage_[0], &tmp[0], keep * sizeof(int64_t));
+      std::memcpy(&outOfLineStorage_[newSize], &tmp[kMaxInlineDims], keep * sizeof(int64_t));
+    } else {
+      // Out of line to out of line; the strides move with the sizes.
+      if (newSize > oldSize) {
+        resizeOutOfLine(newSize);
+        std::memmove(&outOfLineStorage_[newSize], &outOfLineStorage_[oldSize], keep * sizeof(int64_t));
+      } else {
+        std::memmove(&outOfLineStorage_[newSize], &outOfLineStorage_[oldSize], keep * sizeof(int64_t));
+        resizeOutOfLine(newSize);
+      }
+    }
+    size_ = newSize;
+  }
+
+  size_t size_;
+  union {
+    int64_t* outOfLineStorage_;
+    int64_t inlineStorage_[kMaxInlineDims * 2]{};
+  };
+};
+
+} // namespace impl
+} // namespace c10
@@ -1,19 +1,26 @@
 #include <c10/cuda/CUDACachingAllocator.h>
 
 #include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDADriverAPI.h>
 #include <c10/cuda/CUDAException.h>
 #include <c10/cuda/CUDAFunctions.h>
+#include <c10/util/Backtrace.h>
 #include <c10/util/UniqueVoidPtr.h>
+#include <c10/util/string_utils.h>
 
 #include <cuda_runtime_api.h>
 #include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <chrono>
+#include <cstdlib>
 #include <deque>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <sstream>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -51,6 +58,19 @@ namespace CUDACachingAllocator {
 // ensure that the block is not reused before each recorded stream completes
 // work.
 //
+// Expandable segments (PYTORCH_CUDA_ALLOC_CONF=expandable_segments:True):
+// - Instead of one cudaMalloc per segment, the large pool of each stream
+//   reserves a virtual address range the size of the device memory and maps
+//   physical pages into it on demand using the CUDA VMM driver API.
+// - A new large allocation that finds no free block grows the segment at its
+//   end, merging with the free block at the end of the segment if there is
+//   one. Blocks can therefore coalesce across what would have been separate
+//   cudaMalloc segments, which keeps fragmentation down for workloads whose
+//   allocation sizes vary from step to step.
+// - Freeing cached memory unmaps the pages of the free block at the end of
+//   each segment.
+// - Memory in expandable segments cannot be shared through CUDA IPC.
+//
 
 
 namespace {
@@ -66,6 +86,128 @@ constexpr size_t kRoundLarge = 2097152;     // round up large allocs to 2 MiB
 
 typedef std::bitset<static_cast<size_t>(StatType::NUM_TYPES)> StatTypes;
 
+// Settings parsed from the PYTORCH_CUDA_ALLOC_CONF environment variable, a
+// comma-separated list of key:value pairs, e.g. "expandable_segments:True".
+//
+// - max_split_size_mb: blocks of at least this size are never split, and are
+//   only reused for allocations of similar size. Keeps huge cached blocks from
+//   being carved up by small allocations they can then never serve again.
+// - garbage_collection_threshold: fraction of device memory above which cached
+//   blocks that have not been reused for the longest are released before
+//   asking cudaMalloc for more, instead of waiting for cudaMalloc to fail.
+// - roundup_power2_divisions: splits every power-of-two interval into this
+//   many equal steps and rounds allocation sizes up to the next step, so that
+//   sizes that vary slightly between iterations map to the same block size.
+class CachingAllocatorConfig {
+ public:
+  static bool expandable_segments() {
+    return instance().expandable_segments_;
+  }
+
+  static size_t max_split_size() {
+    return instance().max_split_size_;
+  }
+
+  static double garbage_collection_threshold() {
+    return instance().garbage_collection_threshold_;
+  }
+
+  static size_t roundup_power2_divisions() {
+    return instance().roundup_power2_divisions_;
+  }
+
+ private:
+  CachingAllocatorConfig() {
+    const char* env = std::getenv("PYTORCH_CUDA_ALLOC_CONF");
+    if (env) {
+      parse(env);
+    }
+  }
+
+  static const CachingAllocatorConfig& instance() {
+    static CachingAllocatorConfig config;
+    return config;
+  }
+
+  static bool parse_bool(const std::string& key, const std::string& value) {
+    if (value == "True" || value == "true" || value == "1") {
+      return true;
+    }
+    TORCH_CHECK(
+        value == "False" || value == "false" || value == "0",
+        "PYTORCH_CUDA_ALLOC_CONF: expected a boolean for ", key,
+        ", got ", value);
+    return false;
+  }
+
+  static size_t parse_size(const std::string& key, const std::string& value) {
+    size_t pos = 0;
+    unsigned long long result = 0;
+    try {
+      result = std::stoull(value, &pos);
+    } catch (const std::exception&) {
+      pos = 0;
+    }
+    TORCH_CHECK(
+        pos > 0 && pos == value.size(),
+        "PYTORCH_CUDA_ALLOC_CONF: expected an integer for ", key,
+        ", got ", value);
+    return static_cast<size_t>(result);
+  }
+
+  void parse(const std::string& env) {
+    std::stringstream ss(env);
+    std::string option;
+    while (std::getline(ss, option, ',')) {
+      if (option.empty()) {
+        continue;
+      }
+      const auto colon = option.find(':');
+      TORCH_CHECK(
+          colon != std::string::npos,
+          "PYTORCH_CUDA_ALLOC_CONF: expected key:value, got ", option);
+      const std::string key = option.substr(0, colon);
+      const std::string value = option.substr(colon + 1);
+      if (key == "expandable_segments") {
+        expandable_segments_ = parse_bool(key, value);
+      } else if (key == "max_split_size_mb") {
+        const size_t mb = parse_size(key, value);
+        TORCH_CHECK(
+            mb > kLargeBuffer / (1024 * 1024),
+            "PYTORCH_CUDA_ALLOC_CONF: max_split_size_mb must be larger than ",
+            kLargeBuffer / (1024 * 1024), ", got ", value);
+        max_split_size_ = mb * 1024 * 1024;
+      } else if (key == "garbage_collection_threshold") {
+        double threshold = 0;
+        try {
+          threshold = std::stod(value);
+        } catch (const std::exception&) {
+          threshold = -1;
+        }
+        TORCH_CHECK(
+            threshold > 0 && threshold < 1,
+            "PYTORCH_CUDA_ALLOC_CONF: garbage_collection_threshold must be in (0.0, 1.0), got ",
+            value);
+        garbage_collection_threshold_ = threshold;
+      } else if (key == "roundup_power2_divisions") {
+        const size_t divisions = parse_size(key, value);
+        TORCH_CHECK(
+            divisions > 0 && (divisions & (divisions - 1)) == 0,
+            "PYTORCH_CUDA_ALLOC_CONF: roundup_power2_divisions must be a power of 2, got ",
+            value);
+        roundup_power2_divisions_ = divisions;
+      } else {
+        TORCH_CHECK(false, "PYTORCH_CUDA_ALLOC_CONF: unrecognized option ", key);
+      }
+    }
+  }
+
+  bool expandable_segments_ = false;
+  size_t max_split_size_ = std::numeric_limits<size_t>::max();
+  double garbage_collection_threshold_ = 0;
+  size_t roundup_power2_divisions_ = 0;
+};
+
 void update_stat(Stat& stat, int64_t amount) {
   stat.current += amount;
 
@@ -98,8 +240,18 @@ void update_stat_array(StatArray& stat_array, int64_t amount, const StatTypes& s
 }
 
 struct Block;
+struct ExpandableSegment;
+struct PrivatePool;
 typedef bool (*Comparison)(const Block*, const Block*);
-typedef std::set<Block*, Comparison> BlockPool;
+
+struct BlockPool {
+  BlockPool(Comparison comparator, bool small, PrivatePool* private_pool = nullptr) :
+    blocks(comparator), is_small(small), owner_PrivatePool(private_pool) {}
+
+  std::set<Block*, Comparison> blocks;
+  const bool is_small;
+  PrivatePool* owner_PrivatePool; // nullptr for the default pools
+};
 
 struct Block {
   int           device;      // gpu
@@ -112,15 +264,20 @@ struct Block {
   Block*        prev;        // prev block if split from a larger allocation
   Block*        next;        // next block if split from a larger allocation
   int           event_count; // number of outstanding CUDA events
+  ExpandableSegment* expandable_segment; // owning expandable segment, if any
+  int           gc_count;    // pool searches since the block was last cached or reused
+  std::shared_ptr<const History> history; // allocation context, if recorded
 
   Block(int device, cudaStream_t stream, size_t size, BlockPool* pool, void* ptr) :
     device(device), stream(stream), stream_uses(), size(size), pool(pool),
-    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    expandable_segment(nullptr), gc_count(0) { }
 
   // constructor for search key
   Block(int device, cudaStream_t stream, size_t size) :
     device(device), stream(stream), stream_uses(), size(size), pool(nullptr),
-    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    expandable_segment(nullptr), gc_count(0) { }
 
   bool is_split() const {
     return (prev != nullptr) || (next != nullptr);
@@ -138,6 +295,165 @@ static bool BlockComparator(const Block* a, const Block* b)
   return (uintptr_t)a->ptr < (uintptr_t)b->ptr;
 }
 
+// A virtual address range reserved for the large blocks of one stream, into
+// which physical memory is mapped page by page as the segment grows. The
+// blocks of the segment form a single prev/next list covering
+// [ptr(), ptr() + size()); `tail` is the last block of that list.
+struct ExpandableSegment {
+  ExpandableSegment(int device, cudaStream_t stream, size_t page_size, size_t max_size)
+      : device(device), stream(stream), page_size(page_size) {
+#ifdef C10_CUDA_DRIVER_API_SUPPORTED
+    max_pages = (max_size + page_size - 1) / page_size;
+    C10_CUDA_DRIVER_CHECK(cuda::DriverAPI::get()->cuMemAddressReserve_(
+        &base, max_pages * page_size, 0ULL, 0, 0ULL));
+#else
+    TORCH_INTERNAL_ASSERT(false, "expandable segments are not supported in this build");
+#endif
+  }
+
+  // True if the driver supports virtual memory management on `device`.
+  static bool is_supported(int device) {
+#ifdef C10_CUDA_DRIVER_API_SUPPORTED
+    auto* driver = cuda::DriverAPI::get();
+    if (!driver) {
+      return false;
+    }
+    int supported = 0;
+    C10_CUDA_DRIVER_CHECK(driver->cuDeviceGetAttribute_(
+        &supported, CU_DEVICE_ATTRIBUTE_VIRTUAL_ADDRESS_MANAGEMENT_SUPPORTED, device));
+    return supported != 0;
+#else
+    return false;
+#endif
+  }
+
+  // Smallest unit in which memory can be mapped on `device`, rounded up to
+  // kRoundLarge.
+  static size_t page_size_for(int device) {
+    size_t granularity = 0;
+#ifdef C10_CUDA_DRIVER_API_SUPPORTED
+    CUmemAllocationProp prop = {};
+    prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+    prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    prop.location.id = device;
+    C10_CUDA_DRIVER_CHECK(cuda::DriverAPI::get()->cuMemGetAllocationGranularity_(
+        &granularity, &prop, CU_MEM_ALLOC_GRANULARITY_MINIMUM));
+#endif
+    granularity = std::max(granularity, kRoundLarge);
+    return kRoundLarge * ((granularity + kRoundLarge - 1) / kRoundLarge);
+  }
+
+  char* ptr() const {
+    return reinterpret_cast<char*>(base);
+  }
+
+  // number of bytes currently backed by physical memory
+  size_t size() const {
+    return handles.size() * page_size;
+  }
+
+  // Maps `nbytes` (a multiple of page_size) of new memory at the end of the
+  // segment. Returns false, leaving the segment unchanged, if the device is
+  // out of memory or the reserved range is exhausted.
+  bool map(size_t nbytes) {
+#ifdef C10_CUDA_DRIVER_API_SUPPORTED
+    auto* driver = cuda::DriverAPI::get();
+    const size_t begin = handles.size();
+    const size_t end = begin + nbytes / page_size;
+    if (end > max_pages) {
+      return false;
+    }
+
+    CUmemAllocationProp prop = {};
+    prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+    prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    prop.location.id = device;
+    for (size_t i = begin; i < end; ++i) {
+      CUmemGenericAllocationHandle handle;
+      CUresult status = driver->cuMemCreate_(&handle, page_size, &prop, 0);
+      if (status == CUDA_ERROR_OUT_OF_MEMORY) {
+        for (size_t j = begin; j < i; ++j) {
+          C10_CUDA_DRIVER_CHECK(driver->cuMemRelease_(handles.back()));
+          handles.pop_back();
+        }
+        return false;
+      }
+      C10_CUDA_DRIVER_CHECK(status);
+      handles.push_back(handle);
+    }
+    for (size_t i = begin; i < end; ++i) {
+      C10_CUDA_DRIVER_CHECK(driver->cuMemMap_(
+          base + i * page_size, page_size, 0, handles[i], 0ULL));
+    }
+
+    CUmemAccessDesc desc;
+    desc.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    desc.location.id = device;
+    desc.flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
+    C10_CUDA_DRIVER_CHECK(driver->cuMemSetAccess_(
+        base + begin * page_size, (end - begin) * page_size, &desc, 1));
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  // Unmaps all pages at or after byte offset `new_size` (a multiple of
+  // page_size). The caller must ensure that the memory is no longer in use.
+  void unmap(size_t new_size) {
+#ifdef C10_CUDA_DRIVER_API_SUPPORTED
+    auto* driver = cuda::DriverAPI::get();
+    const size_t begin = new_size / page_size;
+    for (size_t i = begin; i < handles.size(); ++i) {
+      C10_CUDA_DRIVER_CHECK(driver->cuMemUnmap_(base + i * page_size, page_size));
+      C10_CUDA_DRIVER_CHECK(driver->cuMemRelease_(handles[i]));
+    }
+    handles.resize(begin);
+#endif
+  }
+
+  int device;
+  cudaStream_t stream;
+  size_t page_size;
+  Block* tail = nullptr;
+
+ private:
+#ifdef C10_CUDA_DRIVER_API_SUPPORTED
+  CUdeviceptr base = 0;
+  size_t max_pages = 0;
+  std::vector<CUmemGenericAllocationHandle> handles;
+#else
+  uintptr_t base = 0;
+  std::vector<int> handles;
+#endif
+};
+
+// A named memory pool selected with MemoryPoolGuard. It caches its own blocks,
+// separately from the default pools of the device, and may cap the amount of
+// memory it reserves from the device.
+struct PrivatePool {
+  PrivatePool(std::string name, size_t limit) :
+    name(std::move(name)),
+    limit(limit),
+    large_blocks(BlockComparator, /*small=*/false, this),
+    small_blocks(BlockComparator, /*small=*/true, this) {}
+
+  std::string name;
+  size_t limit;               // maximum number of reserved bytes
+  size_t reserved_bytes = 0;  // bytes currently obtained from cudaMalloc
+  // number of live CUDA graphs captured into this pool; while positive its
+  // cached blocks are never returned to the driver
+  int graph_use_count = 0;
+  // created by notifyCaptureBegin; removed once its graphs are destroyed and
+  // it holds no memory
+  bool owned_by_graphs = false;
+  BlockPool large_blocks;
+  BlockPool small_blocks;
+};
+
+// memory pool selected on this thread by MemoryPoolGuard; empty for the default pools
+thread_local std::string current_memory_pool;
+
 static std::string format_size(uint64_t size) {
   std::ostringstream os;
   os.precision(2);
@@ -166,9 +482,9 @@ struct AllocParams {
     block(nullptr),
     err(cudaSuccess) {}
 
-  int device() { return search_key.device; }
-  cudaStream_t stream() { return search_key.stream; }
-  size_t size() { return search_key.size; }
+  int device() const { return search_key.device; }
+  cudaStream_t stream() const { return search_key.stream; }
+  size_t size() const { return search_key.size; }
 
   Block search_key;
   BlockPool* pool;
@@ -176,8 +492,14 @@ struct AllocParams {
   Block* block;
   StatTypes stat_types;
   cudaError_t err;
+  std::shared_ptr<const std::string> context; // backtrace, if history is recorded
 };
 
+int64_t get_time_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
 } // namespace
 
 class DeviceCachingAllocator {
@@ -202,26 +524,60 @@ class DeviceCachingAllocator {
   // outstanding cuda events
   std::deque<std::pair<cudaEvent_t, Block*>> cuda_events;
 
+  // named memory pools, see MemoryPoolGuard
+  std::unordered_map<std::string, std::unique_ptr<PrivatePool>> private_pools;
+
+  // memory pools serving the CUDA graph captures currently underway
+  std::unordered_map<CaptureId_t, PrivatePool*> captures_underway;
+
+  // blocks freed during a capture which were used by other streams; their
+  // events are recorded once no capture is underway, see free()
+  std::vector<Block*> needs_events_deferred_until_no_capture;
+
+  // per-stream expandable segments backing large_blocks, if enabled
+  std::unordered_map<cudaStream_t, ExpandableSegment*> expandable_segments;
+
+  // 0: not checked yet, 1: supported, -1: unsupported
+  int expandable_segments_supported = 0;
+
+  // total device memory, queried on first use by garbage collection
+  size_t device_total_memory = 0;
+
+  // allocation history, see recordHistory(); trace is a ring buffer whose
+  // oldest entry is at trace_next once it holds max_trace_entries entries
+  std::atomic<bool> record_history{false};
+  size_t max_trace_entries = 0;
+  std::vector<TraceEntry> trace;
+  size_t trace_next = 0;
+
  public:
 
   DeviceCachingAllocator() :
-      large_blocks(BlockComparator),
-      small_blocks(BlockComparator) {}
+      large_blocks(BlockComparator, /*small=*/false),
+      small_blocks(BlockComparator, /*small=*/true) {}
 
   // All public methods (except the above) acquire the allocator mutex.
   // Thus, do not call a public method from another public method.
 
   Block* malloc(int device, size_t size, cudaStream_t stream)
   {
+    // collect the backtrace before taking the lock, it is expensive
+    std::shared_ptr<const std::string> context;
+    if (record_history) {
+      context = std::make_shared<const std::string>(get_backtrace(/*frames_to_skip=*/1));
+    }
+
     std::unique_lock<std::recursive_mutex> lock(mutex);
 
     // process outstanding cudaEvents
     process_events();
 
+    const size_t orig_size = size;
     size = round_size(size);
-    auto& pool = get_pool(size);
+    auto& pool = get_pool(size, stream);
     const size_t alloc_size = get_allocation_size(size);
     AllocParams params(device, size, stream, &pool, alloc_size, stats);
+    params.context = context;
     params.stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
     params.stat_types[static_cast<size_t>(get_stat_type_for_pool(pool))] = true;
 
@@ -229,11 +585,24 @@ class DeviceCachingAllocator {
       // Search pool
       get_free_block(params)
       // Trigger callbacks and retry search
-      || (trigger_free_memory_callbacks(params) && get_free_block(params))
-      // Attempt allocate
-      || alloc_block(params, false)
-      // Free all non-split cached blocks and retry alloc.
-      || (free_cached_blocks() && alloc_block(params, true));
+      || (trigger_free_memory_callbacks(params) && get_free_block(params));
+
+    if (!block_found) {
+      // cudaFree is not permitted while a stream is being captured, so
+      // cached blocks are only released outside of captures.
+      const bool can_release = captures_underway.empty();
+      // Release idle cached blocks if above the garbage collection threshold
+      if (can_release && CachingAllocatorConfig::garbage_collection_threshold() > 0) {
+        garbage_collect_cached_blocks();
+      }
+      block_found =
+        // Attempt allocate
+        alloc_block(params, false)
+        // Free enough unsplittable cached blocks to satisfy the request and retry alloc.
+        || (can_release && release_available_cached_blocks(params) && alloc_block(params, false))
+        // Free all non-split cached blocks and retry alloc.
+        || (can_release && free_cached_blocks() && alloc_block(params, true));
+    }
 
     TORCH_INTERNAL_ASSERT((!block_found && params.err != cudaSuccess) || params.block);
     if (!block_found) {
@@ -261,6 +630,13 @@ class DeviceCachingAllocator {
         // Note that at this point free_cached_blocks has already returned all
         // possible "cached" memory to the driver. The only remaining "cached"
         // memory is split from a larger block that is partially in-use.
+        const PrivatePool* private_pool = pool.owner_PrivatePool;
+        TORCH_CHECK_WITH(CUDAOutOfMemoryError,
+          !private_pool || private_pool->reserved_bytes + alloc_size <= private_pool->limit,
+          "CUDA out of memory. Tried to allocate ", format_size(alloc_size),
+          " (GPU ", device, "; memory pool '", private_pool->name, "' has ",
+          format_size(private_pool->reserved_bytes), " reserved of its ",
+          format_size(private_pool->limit), " limit)");
         TORCH_CHECK_WITH(CUDAOutOfMemoryError, false,
           "CUDA out of memory. Tried to allocate ", format_size(alloc_size),
           " (GPU ", device, "; ",
@@ -284,6 +660,7 @@ class DeviceCachingAllocator {
       remaining = block;
 
       block = new Block(device, stream, size, &pool, block->ptr);
+      block->expandable_segment = remaining->expandable_segment;
       block->prev = remaining->prev;
       if (block->prev) {
         block->prev->next = block;
@@ -293,7 +670,7 @@ class DeviceCachingAllocator {
       remaining->prev = block;
       remaining->ptr = static_cast<char*>(remaining->ptr) + size;
       remaining->size -= size;
-      pool.insert(remaining);
+      pool.blocks.insert(remaining);
 
       if (already_split) {
         // An already-split inactive block is being shrunk by size bytes.
@@ -318,6 +695,20 @@ class DeviceCachingAllocator {
     update_stat_array(stats.active, 1, params.stat_types);
     update_stat_array(stats.active_bytes, block->size, params.stat_types);
 
+    c10::reportMemoryUsageToProfiler(
+        block, static_cast<int64_t>(block->size),
+        c10::Device(c10::DeviceType::CUDA, device));
+
+    if (record_history) {
+      auto history = std::make_shared<History>();
+      history->context = context;
+      history->real_size = orig_size;
+      history->stream = reinterpret_cast<int64_t>(stream);
+      history->time_us = get_time_us();
+      block->history = std::move(history);
+      record_trace(TraceEntry::ALLOC, device, block->ptr, block->size, stream, context);
+    }
+
     return block;
   }
 
@@ -327,14 +718,30 @@ class DeviceCachingAllocator {
 
     block->allocated = false;
 
+    if (block->history) {
+      record_trace(TraceEntry::FREE, block->device, block->ptr, block->size,
+                   block->stream, block->history->context);
+      block->history.reset();
+    }
+
     StatTypes stat_types;
     stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
     stat_types[static_cast<size_t>(get_stat_type_for_pool(*(block->pool)))] = true;
     update_stat_array(stats.allocation, -1, {stat_types});
     update_stat_array(stats.allocated_bytes, -block->size, {stat_types});
 
+    c10::reportMemoryUsageToProfiler(
+        block, -static_cast<int64_t>(block->size),
+        c10::Device(c10::DeviceType::CUDA, block->device));
+
     if (!block->stream_uses.empty()) {
-      insert_events(block);
+      if (!captures_underway.empty()) {
+        // The other streams may be part of the capture, where recording
+        // and querying events is not permitted.
+        needs_events_deferred_until_no_capture.push_back(block);
+      } else {
+        insert_events(block);
+      }
     } else {
       free_block(block);
     }
@@ -342,6 +749,10 @@ class DeviceCachingAllocator {
 
   void* getBaseAllocation(Block* block, size_t* outSize) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_CHECK(!block->expandable_segment,
+        "Tensors allocated with expandable_segments:True cannot be shared "
+        "between processes. Consider using expandable_segments:False in "
+        "processes that share CUDA tensors.");
     while (block->prev) {
       block = block->prev;
     }
@@ -370,9 +781,96 @@ class DeviceCachingAllocator {
   /** returns cached blocks to the system allocator **/
   void emptyCache() {
     std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_CHECK(captures_underway.empty(),
+        "emptyCache() cannot be called while a CUDA graph is being captured");
     free_cached_blocks();
   }
 
+  /** Starts or stops recording allocation history **/
+  void recordHistory(bool enabled, size_t max_entries)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (enabled) {
+      // start a fresh history; when disabled, the last one stays available
+      max_trace_entries = max_entries;
+      trace.clear();
+      trace.reserve(std::min<size_t>(max_entries, 1024));
+      trace_next = 0;
+    }
+    record_history = enabled;
+  }
+
+  /** Returns the recorded allocator events, oldest first **/
+  std::vector<TraceEntry> getHistory() const
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::vector<TraceEntry> result;
+    result.reserve(trace.size());
+    result.insert(result.end(), trace.begin() + trace_next, trace.end());
+    result.insert(result.end(), trace.begin(), trace.begin() + trace_next);
+    return result;
+  }
+
+  /** Creates a named memory pool that reserves at most limit bytes **/
+  void createMemoryPool(const std::string& name, size_t limit)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_CHECK(!name.empty(), "CUDA memory pool name must not be empty");
+    TORCH_CHECK(private_pools.find(name) == private_pools.end(),
+        "CUDA memory pool '", name, "' already exists on this device");
+    private_pools.emplace(name, std::make_unique<PrivatePool>(name, limit));
+  }
+
+  /** Returns the number of bytes reserved by the named memory pool **/
+  size_t memoryPoolReservedBytes(const std::string& name)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = private_pools.find(name);
+    TORCH_CHECK(it != private_pools.end(),
+        "CUDA memory pool '", name, "' was not created on this device");
+    return it->second->reserved_bytes;
+  }
+
+  /** Routes allocations on streams captured as capture_id to the named pool **/
+  void notifyCaptureBegin(CaptureId_t capture_id, const std::string& name)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_CHECK(!name.empty(), "CUDA memory pool name must not be empty");
+    auto it = private_pools.find(name);
+    if (it == private_pools.end()) {
+      it = private_pools.emplace(
+          name, std::make_unique<PrivatePool>(name, std::numeric_limits<size_t>::max())).first;
+      it->second->owned_by_graphs = true;
+    }
+    it->second->graph_use_count++;
+    captures_underway[capture_id] = it->second.get();
+  }
+
+  /** Stops routing allocations of capture_id; the pool stays reserved **/
+  void notifyCaptureEnd(CaptureId_t capture_id)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    captures_underway.erase(capture_id);
+  }
+
+  /** Called when a graph captured into the named pool is destroyed **/
+  void notifyCaptureDestroy(const std::string& name)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = private_pools.find(name);
+    TORCH_INTERNAL_ASSERT(it != private_pools.end() && it->second->graph_use_count > 0);
+    PrivatePool& private_pool = *it->second;
+    if (--private_pool.graph_use_count > 0 || !captures_underway.empty()) {
+      // the pool is released by a later emptyCache()
+      return;
+    }
+    free_blocks(private_pool.large_blocks);
+    free_blocks(private_pool.small_blocks);
+    if (private_pool.owned_by_graphs && private_pool.reserved_bytes == 0) {
+      private_pools.erase(it);
+    }
+  }
+
   /** Retrieves info (total size + largest block) of the memory cache **/
   void cacheInfo(size_t* total, size_t* largest)
   {
@@ -442,7 +940,10 @@ class DeviceCachingAllocator {
       SegmentInfo& segment_info = result.back();
       segment_info.device = head_block->device;
       segment_info.address = reinterpret_cast<int64_t>(head_block->ptr);
-      segment_info.is_large = (head_block->pool == &large_blocks);
+      segment_info.is_large = !head_block->pool->is_small;
+      if (head_block->pool->owner_PrivatePool) {
+        segment_info.pool = head_block->pool->owner_PrivatePool->name;
+      }
 
       const Block* block = head_block;
       while (block != nullptr) {
@@ -452,6 +953,7 @@ class DeviceCachingAllocator {
         block_info.size = block->size;
         block_info.allocated = block->allocated;
         block_info.active = block->allocated || (block->event_count > 0);
+        block_info.history = block->history;
 
         segment_info.total_size += block_info.size;
         if (block_info.allocated) {
@@ -473,8 +975,11 @@ class DeviceCachingAllocator {
   }
 
   static size_t round_size(size_t size) {
+    const size_t divisions = CachingAllocatorConfig::roundup_power2_divisions();
     if (size < kMinBlockSize) {
       return kMinBlockSize;
+    } else if (divisions > 0 && size > kMinBlockSize * divisions) {
+      return roundup_power2_next_division(size, divisions);
     } else {
       return kMinBlockSize * ((size + kMinBlockSize - 1) / kMinBlockSize);
     }
@@ -484,10 +989,39 @@ class DeviceCachingAllocator {
 
   // All private methods do not acquire the allocator mutex.
 
+  void record_trace(TraceEntry::Action action, int device, void* addr, size_t size,
+                    cudaStream_t stream, std::shared_ptr<const std::string> context)
+  {
+    if (!record_history || max_trace_entries == 0) {
+      return;
+    }
+    TraceEntry entry;
+    entry.action = action;
+    entry.device = device;
+    entry.addr = reinterpret_cast<int64_t>(addr);
+    entry.size = size;
+    entry.stream = reinterpret_cast<int64_t>(stream);
+    entry.time_us = get_time_us();
+    entry.context = std::move(context);
+    if (trace.size() < max_trace_entries) {
+      trace.push_back(std::move(entry));
+    } else {
+      trace[trace_next] = std::move(entry);
+      trace_next = (trace_next + 1) % max_trace_entries;
+    }
+  }
+
   std::vector<const Block*> get_all_blocks() const {
     std::vector<const Block*> blocks;
-    blocks.insert(blocks.end(), small_blocks.begin(), small_blocks.end());
-    blocks.insert(blocks.end(), large_blocks.begin(), large_blocks.end());
+    blocks.insert(blocks.end(), small_blocks.blocks.begin(), small_blocks.blocks.end());
+    blocks.insert(blocks.end(), large_blocks.blocks.begin(), large_blocks.blocks.end());
+    for (const auto& entry : private_pools) {
+      const PrivatePool& private_pool = *entry.second;
+      blocks.insert(blocks.end(), private_pool.small_blocks.blocks.begin(),
+                    private_pool.small_blocks.blocks.end());
+      blocks.insert(blocks.end(), private_pool.large_blocks.blocks.begin(),
+                    private_pool.large_blocks.blocks.end());
+    }
     blocks.insert(blocks.end(), active_blocks.begin(), active_blocks.end());
     return blocks;
   }
@@ -513,7 +1047,8 @@ class DeviceCachingAllocator {
     }
 
     active_blocks.erase(block);
-    pool.insert(block);
+    block->gc_count = 0;
+    pool.blocks.insert(block);
 
     if (block->is_split()) {
       net_change_inactive_split_blocks += 1;
@@ -551,15 +1086,41 @@ class DeviceCachingAllocator {
       }
     }
 
+    ExpandableSegment* segment = src->expandable_segment;
+    if (segment && segment->tail == src) {
+      segment->tail = dst;
+    }
+
     const size_t subsumed_size = src->size;
     dst->size += subsumed_size;
-    pool.erase(src);
+    pool.blocks.erase(src);
     delete src;
 
     return subsumed_size;
   }
 
-  BlockPool& get_pool(size_t size) {
+  BlockPool& get_pool(size_t size, cudaStream_t stream) {
+#if defined(CUDART_VERSION) && CUDART_VERSION >= 11000
+    if (C10_UNLIKELY(!captures_underway.empty())) {
+      cudaStreamCaptureStatus status;
+      CaptureId_t id;
+      C10_CUDA_CHECK(cudaStreamGetCaptureInfo(stream, &status, &id));
+      if (status != cudaStreamCaptureStatusNone) {
+        auto it = captures_underway.find(id);
+        TORCH_CHECK(it != captures_underway.end(),
+            "allocation on a stream captured outside of torch.cuda graph capture");
+        PrivatePool& private_pool = *it->second;
+        return size <= kSmallSize ? private_pool.small_blocks : private_pool.large_blocks;
+      }
+    }
+#endif
+    if (!current_memory_pool.empty()) {
+      auto it = private_pools.find(current_memory_pool);
+      TORCH_CHECK(it != private_pools.end(),
+          "CUDA memory pool '", current_memory_pool, "' was not created on this device");
+      PrivatePool& private_pool = *it->second;
+      return size <= kSmallSize ? private_pool.small_blocks : private_pool.large_blocks;
+    }
     if (size <= kSmallSize) {
       return small_blocks;
     } else {
@@ -568,26 +1129,35 @@ class DeviceCachingAllocator {
   }
 
   StatType get_stat_type_for_pool(const BlockPool& pool) {
-    if (&pool == &small_blocks) {
-      return StatType::SMALL_POOL;
-    } else if (&pool == &large_blocks) {
-      return StatType::LARGE_POOL;
-    } else {
-      AT_ERROR("get_stat_type_for_pool: invalid pool");
-    }
+    return pool.is_small ? StatType::SMALL_POOL : StatType::LARGE_POOL;
   }
 
   bool should_split(const Block* block, size_t size) {
     size_t remaining = block->size - size;
-    if (block->pool == &small_blocks) {
+    if (block->pool->is_small) {
       return remaining >= kMinBlockSize;
-    } else if (block->pool == &large_blocks) {
-      return remaining > kSmallSize;
     } else {
-      AT_ERROR("should_split: invalid pool");
+      return (size < CachingAllocatorConfig::max_split_size()) && (remaining > kSmallSize);
     }
   }
 
+  // Rounds size up to the next of `divisions` equal steps between the
+  // enclosing powers of two, e.g. 1200 with 4 divisions rounds to 1280.
+  static size_t roundup_power2_next_division(size_t size, size_t divisions) {
+    size_t power2_floor = 1;
+    while (power2_floor <= size / 2) {
+      power2_floor <<= 1;
+    }
+    if (power2_floor == size) {
+      return size;
+    }
+    const size_t step = power2_floor / divisions;
+    if (step == 0) {
+      return power2_floor << 1;
+    }
+    return ((size + step - 1) / step) * step;
+  }
+
   static size_t get_allocation_size(size_t size) {
     if (size <= kSmallSize) {
       return kSmallBuffer;
@@ -600,11 +1170,26 @@ class DeviceCachingAllocator {
 
   bool get_free_block(AllocParams& p) {
     BlockPool& pool = *p.pool;
-    auto it = pool.lower_bound(&p.search_key);
-    if (it == pool.end() || (*it)->stream != p.stream())
+    if (CachingAllocatorConfig::garbage_collection_threshold() > 0) {
+      // age every cached block; the ones reused least are collected first
+      for (Block* block : pool.blocks) {
+        ++block->gc_count;
+      }
+    }
+    auto it = pool.blocks.lower_bound(&p.search_key);
+    if (it == pool.blocks.end() || (*it)->stream != p.stream())
+      return false;
+    const size_t max_split_size = CachingAllocatorConfig::max_split_size();
+    // Do not return an oversized block for a small request
+    if ((p.size() < max_split_size) && ((*it)->size >= max_split_size))
+      return false;
+    // Do not return an oversized block for a large request, if it would waste
+    // more than a large buffer
+    if ((p.size() >= max_split_size) && ((*it)->size >= p.size() + kLargeBuffer))
       return false;
     p.block = *it;
-    pool.erase(it);
+    p.block->gc_count = 0;
+    pool.blocks.erase(it);
     return true;
   }
 
@@ -625,6 +1210,16 @@ class DeviceCachingAllocator {
       stats.num_alloc_retries += 1;
     }
 
+    if (p.pool == &large_blocks && use_expandable_segments(p.device())) {
+      return expand_segment(p);
+    }
+
+    PrivatePool* private_pool = p.pool->owner_PrivatePool;
+    if (private_pool && private_pool->reserved_bytes + size > private_pool->limit) {
+      p.err = cudaErrorMemoryAllocation;
+      return false;
+    }
+
     p.err = cudaMalloc(&ptr, size);
     if (p.err != cudaSuccess) {
       if (!isRetry || p.err == cudaErrorMemoryAllocation)
@@ -632,6 +1227,10 @@ class DeviceCachingAllocator {
       return false;
     }
 
+    if (private_pool) {
+      private_pool->reserved_bytes += size;
+    }
+    record_trace(TraceEntry::SEGMENT_ALLOC, p.device(), ptr, size, p.stream(), p.context);
     p.block = new Block(p.device(), p.stream(), size, p.pool, (char*)ptr);
     update_stat_array(stats.segment, 1, p.stat_types);
     update_stat_array(stats.reserved_bytes, size, p.stat_types);
@@ -639,6 +1238,140 @@ class DeviceCachingAllocator {
     return (p.block != nullptr);
   }
 
+  bool use_expandable_segments(int device) {
+    if (!CachingAllocatorConfig::expandable_segments()) {
+      return false;
+    }
+    if (expandable_segments_supported == 0) {
+      expandable_segments_supported = ExpandableSegment::is_supported(device) ? 1 : -1;
+      if (expandable_segments_supported < 0) {
+        TORCH_WARN("expandable_segments:True is not supported by the CUDA "
+                   "driver on device ", device, "; falling back to cudaMalloc.");
+      }
+    }
+    return expandable_segments_supported > 0;
+  }
+
+  ExpandableSegment* get_expandable_segment(int device, cudaStream_t stream) {
+    auto it = expandable_segments.find(stream);
+    if (it != expandable_segments.end()) {
+      return it->second;
+    }
+    size_t device_free;
+    size_t device_total;
+    C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
+    auto* segment = new ExpandableSegment(
+        device, stream, ExpandableSegment::page_size_for(device), device_total);
+    expandable_segments.emplace(stream, segment);
+    return segment;
+  }
+
+  /** grows the expandable segment of p.stream() so that its last block can hold p.size() bytes */
+  bool expand_segment(AllocParams& p) {
+    ExpandableSegment* segment = get_expandable_segment(p.device(), p.stream());
+    Block* tail = segment->tail;
+    const bool tail_free = tail && !tail->allocated && tail->event_count == 0;
+    const size_t available = tail_free ? tail->size : 0;
+    if (available >= p.size()) {
+      // the tail was freed by free_cached_blocks() after the pool was searched
+      large_blocks.blocks.erase(tail);
+      p.block = tail;
+      return true;
+    }
+
+    const size_t page_size = segment->page_size;
+    const size_t grow = page_size * ((p.size() - available + page_size - 1) / page_size);
+    if (!segment->map(grow)) {
+      p.err = cudaErrorMemoryAllocation;
+      return false;
+    }
+
+    if (segment->size() == grow) {
+      update_stat_array(stats.segment, 1, p.stat_types);
+    }
+    record_trace(TraceEntry::SEGMENT_ALLOC, p.device(), segment->ptr() + segment->size() - grow,
+                 grow, p.stream(), p.context);
+    update_stat_array(stats.reserved_bytes, grow, p.stat_types);
+
+    if (tail_free) {
+      // extend the free block at the end of the segment
+      large_blocks.blocks.erase(tail);
+      tail->size += grow;
+      if (tail->is_split()) {
+        update_stat_array(stats.inactive_split_bytes, grow, p.stat_types);
+      }
+      p.block = tail;
+    } else {
+      Block* block = new Block(p.device(), p.stream(), grow, p.pool,
+                               segment->ptr() + segment->size() - grow);
+      block->expandable_segment = segment;
+      block->prev = tail;
+      if (tail) {
+        tail->next = block;
+        update_stat_array(stats.inactive_split, 1, p.stat_types);
+        update_stat_array(stats.inactive_split_bytes, grow, p.stat_types);
+      }
+      segment->tail = block;
+      p.block = block;
+    }
+    return true;
+  }
+
+  /** unmaps the pages covered by the free block at the end of each expandable segment */
+  void release_expandable_segments()
+  {
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(StatType::LARGE_POOL)] = true;
+
+    for (auto& entry : expandable_segments) {
+      ExpandableSegment* segment = entry.second;
+      Block* tail = segment->tail;
+      if (!tail || tail->allocated || tail->event_count > 0) {
+        continue;
+      }
+      const size_t page_size = segment->page_size;
+      const size_t offset = static_cast<char*>(tail->ptr) - segment->ptr();
+      const size_t keep = page_size * ((offset + page_size - 1) / page_size);
+      const size_t released = segment->size() - keep;
+      if (released == 0) {
+        continue;
+      }
+
+      // Unlike cudaFree, unmapping does not wait for pending work on the
+      // freed memory.
+      CUDAGuard guard(segment->device);
+      C10_CUDA_CHECK(cudaDeviceSynchronize());
+      segment->unmap(keep);
+      record_trace(TraceEntry::SEGMENT_FREE, segment->device, segment->ptr() + keep,
+                   released, segment->stream, nullptr);
+
+      const bool was_split = tail->is_split();
+      large_blocks.blocks.erase(tail);
+      tail->size -= released;
+      if (was_split) {
+        update_stat_array(stats.inactive_split_bytes, -released, stat_types);
+      }
+      if (tail->size == 0) {
+        if (tail->prev) {
+          tail->prev->next = nullptr;
+        }
+        if (was_split) {
+          update_stat_array(stats.inactive_split, -1, stat_types);
+        }
+        segment->tail = tail->prev;
+        delete tail;
+      } else {
+        large_blocks.blocks.insert(tail);
+      }
+
+      update_stat_array(stats.reserved_bytes, -released, stat_types);
+      if (segment->size() == 0) {
+        update_stat_array(stats.segment, -1, stat_types);
+      }
+    }
+  }
+
   bool free_cached_blocks()
   {
     // First ensure that all blocks that can't currently be allocated due to
@@ -648,30 +1381,161 @@ class DeviceCachingAllocator {
     // Free all non-split cached blocks
     free_blocks(large_blocks);
     free_blocks(small_blocks);
+    for (auto it = private_pools.begin(); it != private_pools.end();) {
+      PrivatePool& private_pool = *it->second;
+      if (private_pool.graph_use_count > 0) {
+        // replays of live graphs still use these blocks
+        ++it;
+        continue;
+      }
+      free_blocks(private_pool.large_blocks);
+      free_blocks(private_pool.small_blocks);
+      if (private_pool.owned_by_graphs && private_pool.reserved_bytes == 0) {
+        it = private_pools.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    release_expandable_segments();
     return true;
   }
 
-  void free_blocks(BlockPool& blocks)
+  void free_blocks(BlockPool& pool)
   {
     // Frees all non-split blocks
+    auto& blocks = pool.blocks;
     auto it = blocks.begin();
     while (it != blocks.end()) {
       Block* block = *it;
-      if (!block->prev && !block->next) {
-        C10_CUDA_CHECK(cudaFree((void*)block->ptr));
+      ++it;
+      if (is_releasable(block)) {
+        release_block(block);
+      }
+    }
+  }
 
-        StatTypes stat_types;
-        stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
-        stat_types[static_cast<size_t>(get_stat_type_for_pool(*(block->pool)))] = true;
-        update_stat_array(stats.segment, -1, stat_types);
-        update_stat_array(stats.reserved_bytes, -block->size, stat_types);
+  static bool is_releasable(const Block* block) {
+    return !block->prev && !block->next && !block->expandable_segment;
+  }
 
-        auto cur = it;
-        ++it;
-        blocks.erase(cur);
-        delete block;
-      } else {
-        ++it;
+  /** returns a cached, non-split block to the driver */
+  void release_block(Block* block)
+  {
+    TORCH_INTERNAL_ASSERT(is_releasable(block));
+    C10_CUDA_CHECK(cudaFree((void*)block->ptr));
+    record_trace(TraceEntry::SEGMENT_FREE, block->device, block->ptr, block->size,
+                 block->stream, nullptr);
+
+    BlockPool& pool = *block->pool;
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(get_stat_type_for_pool(pool))] = true;
+    update_stat_array(stats.segment, -1, stat_types);
+    update_stat_array(stats.reserved_bytes, -block->size, stat_types);
+    if (pool.owner_PrivatePool) {
+      pool.owner_PrivatePool->reserved_bytes -= block->size;
+    }
+
+    pool.blocks.erase(block);
+    delete block;
+  }
+
+  /** frees cached blocks of at least max_split_size, which cannot be split to serve p */
+  bool release_available_cached_blocks(const AllocParams& p)
+  {
+    const size_t max_split_size = CachingAllocatorConfig::max_split_size();
+    if (max_split_size == std::numeric_limits<size_t>::max()) {
+      return false;
+    }
+    BlockPool& pool = *p.pool;
+    if (pool.owner_PrivatePool && pool.owner_PrivatePool->graph_use_count > 0) {
+      return false;
+    }
+    Block key = p.search_key;
+    key.size = std::max(key.size, max_split_size);
+    auto it = pool.blocks.lower_bound(&key);
+    if (it != pool.blocks.end() && (*it)->stream == p.stream() && is_releasable(*it)) {
+      // the smallest oversized block that is large enough
+      release_block(*it);
+      return true;
+    }
+
+    // No single block is large enough; free oversized blocks, starting with
+    // the largest, until their combined size is.
+    size_t total_released = 0;
+    while (total_released < key.size && it != pool.blocks.begin()) {
+      --it;
+      Block* block = *it;
+      if (block->stream != p.stream() || block->size < max_split_size) {
+        break;
+      }
+      if (is_releasable(block)) {
+        total_released += block->size;
+        // release_block invalidates `it`; restart from the next larger block
+        auto next = std::next(it);
+        release_block(block);
+        it = next;
+      }
+    }
+    return total_released >= key.size;
+  }
+
+  /** frees the cached blocks that have gone unused for longest until reserved
+   *  memory drops below the garbage collection threshold */
+  void garbage_collect_cached_blocks()
+  {
+    if (device_total_memory == 0) {
+      size_t device_free;
+      C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total_memory));
+    }
+    const auto gc_threshold = static_cast<size_t>(
+        CachingAllocatorConfig::garbage_collection_threshold() * device_total_memory);
+    const size_t reserved =
+        stats.reserved_bytes[static_cast<size_t>(StatType::AGGREGATE)].current;
+    if (reserved <= gc_threshold) {
+      return;
+    }
+    const size_t target_size = reserved - gc_threshold;
+
+    std::vector<BlockPool*> pools = {&large_blocks};
+    for (auto& entry : private_pools) {
+      if (entry.second->graph_use_count == 0) {
+        pools.push_back(&entry.second->large_blocks);
+      }
+    }
+
+    size_t gc_reclaimed = 0;
+    bool block_freed = true;
+    while (gc_reclaimed < target_size && block_freed) {
+      // Free blocks at least as old as the average, so that blocks which are
+      // reused regularly stay cached.
+      double total_age = 0.0;
+      int freeable_block_count = 0;
+      for (BlockPool* pool : pools) {
+        for (const Block* block : pool->blocks) {
+          if (is_releasable(block)) {
+            total_age += block->gc_count;
+            ++freeable_block_count;
+          }
+        }
+      }
+      if (freeable_block_count == 0) {
+        break;
+      }
+      const double age_threshold = total_age / freeable_block_count;
+
+      block_freed = false;
+      for (BlockPool* pool : pools) {
+        auto it = pool->blocks.begin();
+        while (it != pool->blocks.end() && gc_reclaimed < target_size) {
+          Block* block = *it;
+          ++it;
+          if (is_releasable(block) && block->gc_count >= age_threshold) {
+            block_freed = true;
+            gc_reclaimed += block->size;
+            release_block(block);
+          }
+        }
       }
     }
   }
@@ -727,6 +1591,13 @@ class DeviceCachingAllocator {
 
   void process_events()
   {
+    if (captures_underway.empty() && !needs_events_deferred_until_no_capture.empty()) {
+      for (Block* block : needs_events_deferred_until_no_capture) {
+        insert_events(block);
+      }
+      needs_events_deferred_until_no_capture.clear();
+    }
+
     // Process outstanding cudaEvents. Events that are completed are removed
     // from the queue, and the 'event_count' for the corresponding allocation
     // is decremented. Stops at the first event which has not been completed.
@@ -757,9 +1628,9 @@ class DeviceCachingAllocator {
   }
 
   // Accumulates sizes of all memory blocks for given device in given pool
-  void cache_info_aux(BlockPool& blocks, size_t* total, size_t* largest)
+  void cache_info_aux(BlockPool& pool, size_t* total, size_t* largest)
   {
-    for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+    for (auto it = pool.blocks.begin(); it != pool.blocks.end(); ++it) {
       size_t blocksize = (*it)->size;
       *total += blocksize;
       if (blocksize > *largest) {
@@ -961,6 +1832,59 @@ std::vector<SegmentInfo> snapshot() {
   return caching_allocator.snapshot();
 }
 
+void recordHistory(bool enabled, size_t max_entries) {
+  for (auto& allocator : caching_allocator.device_allocator) {
+    allocator->recordHistory(enabled, max_entries);
+  }
+}
+
+std::vector<TraceEntry> getHistory(int device) {
+  assertValidDevice(device);
+  return caching_allocator.device_allocator[device]->getHistory();
+}
+
+void createMemoryPool(int device, const std::string& name, size_t limit) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->createMemoryPool(name, limit);
+}
+
+size_t getMemoryPoolReservedBytes(int device, const std::string& name) {
+  assertValidDevice(device);
+  return caching_allocator.device_allocator[device]->memoryPoolReservedBytes(name);
+}
+
+const std::string& getCurrentMemoryPool() {
+  return current_memory_pool;
+}
+
+void setCurrentMemoryPool(const std::string& name) {
+  current_memory_pool = name;
+}
+
+void notifyCaptureBegin(int device, CaptureId_t capture_id, const std::string& pool) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureBegin(capture_id, pool);
+}
+
+void notifyCaptureEnd(int device, CaptureId_t capture_id) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureEnd(capture_id);
+}
+
+void notifyCaptureDestroy(int device, const std::string& pool) {
+  assertValidDevice(device);
+  caching_allocator.device_allocator[device]->notifyCaptureDestroy(pool);
+}
+
+MemoryPoolGuard::MemoryPoolGuard(const std::string& name)
+    : prev_(current_memory_pool) {
+  current_memory_pool = name;
+}
+
+MemoryPoolGuard::~MemoryPoolGuard() {
+  current_memory_pool = prev_;
+}
+
 //
 // In CUDA IPC, sender sends a tensor to receiver, getIpcDevPtr
 // is called by the receiving process to map the CUDA memory from the sending
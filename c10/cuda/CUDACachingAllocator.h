@@ -7,7 +7,10 @@
 #include <c10/util/Registry.h>
 
 #include <array>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <string>
 
 namespace c10 {
 
@@ -87,11 +90,22 @@ struct DeviceStats {
   int64_t num_ooms = 0;
 };
 
+// Context of an allocation, recorded while history recording is enabled
+// (see recordHistory).
+struct History {
+  std::shared_ptr<const std::string> context; // backtrace of the allocation
+  int64_t real_size = 0; // size requested by the caller
+  int64_t stream = 0;    // stream the block was allocated on
+  int64_t time_us = 0;   // time of the allocation, microseconds since epoch
+};
+
 // Struct containing info of an allocation block (i.e. a fractional part of a cudaMalloc)..
 struct BlockInfo {
   int64_t size = 0;
   bool allocated = false;
   bool active = false;
+  // set for allocated blocks if history recording was enabled when they were allocated
+  std::shared_ptr<const History> history;
 };
 
 // Struct containing info of a memory segment (i.e. one contiguous cudaMalloc).
@@ -102,9 +116,28 @@ struct SegmentInfo {
   int64_t allocated_size = 0;
   int64_t active_size = 0;
   bool is_large = false;
+  // name of the memory pool owning the segment; empty for the default pools
+  std::string pool;
   std::vector<BlockInfo> blocks;
 };
 
+// One allocator event in the bounded history of a device.
+struct TraceEntry {
+  enum Action {
+    ALLOC,         // block handed out to the caller
+    FREE,          // block returned by the caller
+    SEGMENT_ALLOC, // memory obtained from the driver
+    SEGMENT_FREE   // memory returned to the driver
+  };
+  Action action = ALLOC;
+  int64_t device = 0;
+  int64_t addr = 0;
+  int64_t size = 0;
+  int64_t stream = 0;
+  int64_t time_us = 0;
+  std::shared_ptr<const std::string> context; // backtrace, if recorded
+};
+
 C10_CUDA_API void* raw_alloc(size_t nbytes);
 C10_CUDA_API void* raw_alloc_with_stream(size_t nbytes, cudaStream_t stream);
 C10_CUDA_API void raw_delete(void* ptr);
@@ -120,6 +153,65 @@ C10_CUDA_API void resetAccumulatedStats(int device);
 C10_CUDA_API void resetPeakStats(int device);
 C10_CUDA_API std::vector<SegmentInfo> snapshot();
 
+// Enables or disables recording of allocation history on all devices. While
+// enabled, every allocation records a backtrace (c10::get_backtrace), its
+// stream and a timestamp, which snapshot() reports for allocated blocks. The
+// most recent `max_entries` allocator events per device are kept in a ring
+// buffer, returned oldest first by getHistory(). Recording backtraces is slow;
+// enable it only while diagnosing memory usage.
+C10_CUDA_API void recordHistory(bool enabled, size_t max_entries = 10000);
+C10_CUDA_API std::vector<TraceEntry> getHistory(int device);
+
+// Named memory pools. A memory pool caches its own blocks, separately from
+// the default pools of the device, and reserves at most `limit` bytes from the
+// device; allocations beyond the limit raise CUDAOutOfMemoryError. Pools are
+// created per device, and allocations are served from the pool selected on
+// the calling thread (see MemoryPoolGuard). Cached blocks of all pools are
+// released by emptyCache().
+C10_CUDA_API void createMemoryPool(
+    int device,
+    const std::string& name,
+    size_t limit = std::numeric_limits<size_t>::max());
+C10_CUDA_API size_t getMemoryPoolReservedBytes(int device, const std::string& name);
+
+// Name of the memory pool used by allocations on this thread; empty
+// selects the default pools.
+C10_CUDA_API const std::string& getCurrentMemoryPool();
+C10_CUDA_API void setCurrentMemoryPool(const std::string& name);
+
+// RAII guard that selects a memory pool for allocations made on this thread
+// while in scope:
+//
+//   CUDACachingAllocator::createMemoryPool(0, "model_a", 4ULL << 30);
+//   {
+//     CUDACachingAllocator::MemoryPoolGuard guard("model_a");
+//     auto output = model_a.forward(inputs);
+//   }
+class C10_CUDA_API MemoryPoolGuard {
+ public:
+  explicit MemoryPoolGuard(const std::string& name);
+  ~MemoryPoolGuard();
+
+  MemoryPoolGuard(const MemoryPoolGuard&) = delete;
+  MemoryPoolGuard& operator=(const MemoryPoolGuard&) = delete;
+
+ private:
+  std::string prev_;
+};
+
+// CUDA graph support, see at::cuda::CUDAGraph. Between notifyCaptureBegin
+// and notifyCaptureEnd, allocations made on a stream being captured as
+// `capture_id` are served from the named memory pool (created if needed)
+// instead of the pool selected on the calling thread. A replayed graph reuses
+// the addresses it captured, so the blocks of a pool used by a capture stay
+// reserved -- emptyCache() and garbage collection skip them -- until every
+// graph captured into the pool has called notifyCaptureDestroy.
+using CaptureId_t = unsigned long long;
+
+C10_CUDA_API void notifyCaptureBegin(int device, CaptureId_t capture_id, const std::string& pool);
+C10_CUDA_API void notifyCaptureEnd(int device, CaptureId_t capture_id);
+C10_CUDA_API void notifyCaptureDestroy(int device, const std::string& pool);
+
 C10_CUDA_API std::mutex* getFreeMutex();
 
 C10_CUDA_API std::shared_ptr<void> getIpcDevPtr(std::string handle);
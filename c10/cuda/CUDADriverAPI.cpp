@@ -0,0 +1,43 @@
+#include <c10/cuda/CUDADriverAPI.h>
+
+#ifdef C10_CUDA_DRIVER_API_SUPPORTED
+
+#include <dlfcn.h>
+
+namespace c10 {
+namespace cuda {
+
+namespace {
+
+DriverAPI* load_driver_api() {
+  void* handle = dlopen("libcuda.so.1", RTLD_LAZY | RTLD_NOLOAD);
+  if (!handle) {
+    handle = dlopen("libcuda.so.1", RTLD_LAZY);
+  }
+  if (!handle) {
+    return nullptr;
+  }
+  auto* api = new DriverAPI();
+#define C10_CUDA_DRIVER_API_LOOKUP(name)                          \
+  api->name##_ = reinterpret_cast<decltype(&name)>(dlsym(handle, #name)); \
+  if (!api->name##_) {                                            \
+    delete api;                                                   \
+    return nullptr;                                               \
+  }
+  C10_CUDA_DRIVER_API(C10_CUDA_DRIVER_API_LOOKUP)
+#undef C10_CUDA_DRIVER_API_LOOKUP
+  return api;
+}
+
+} // namespace
+
+DriverAPI* DriverAPI::get() {
+  // Leaked on purpose; libcuda stays loaded for the lifetime of the process.
+  static DriverAPI* api = load_driver_api();
+  return api;
+}
+
+} // namespace cuda
+} // namespace c10
+
+#endif // C10_CUDA_DRIVER_API_SUPPORTED
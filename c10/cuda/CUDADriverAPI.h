@@ -0,0 +1,57 @@
+#pragma once
+
+#include <c10/cuda/CUDAMacros.h>
+#include <c10/util/Exception.h>
+
+#include <cuda.h>
+
+// The virtual memory management (VMM) functions of the CUDA driver API
+// (cuMemCreate, cuMemMap, ...) are only available from the driver library,
+// which c10_cuda does not link against. They are looked up at runtime from
+// libcuda instead, so that builds and processes without a driver keep
+// working.
+#if defined(CUDA_VERSION) && CUDA_VERSION >= 10020 && !defined(_WIN32)
+#define C10_CUDA_DRIVER_API_SUPPORTED
+#endif
+
+#ifdef C10_CUDA_DRIVER_API_SUPPORTED
+
+#define C10_CUDA_DRIVER_CHECK(EXPR)                                     \
+  do {                                                                  \
+    CUresult __err = EXPR;                                              \
+    if (__err != CUDA_SUCCESS) {                                        \
+      const char* err_str;                                              \
+      CUresult get_error_str_err C10_UNUSED =                           \
+          c10::cuda::DriverAPI::get()->cuGetErrorString_(__err, &err_str); \
+      TORCH_CHECK(false, "CUDA driver error: ", err_str);               \
+    }                                                                   \
+  } while (0)
+
+#define C10_CUDA_DRIVER_API(_)         \
+  _(cuDeviceGetAttribute)              \
+  _(cuGetErrorString)                  \
+  _(cuMemAddressFree)                  \
+  _(cuMemAddressReserve)               \
+  _(cuMemCreate)                       \
+  _(cuMemGetAllocationGranularity)     \
+  _(cuMemMap)                          \
+  _(cuMemRelease)                      \
+  _(cuMemSetAccess)                    \
+  _(cuMemUnmap)
+
+namespace c10 {
+namespace cuda {
+
+struct C10_CUDA_API DriverAPI {
+#define C10_CUDA_DRIVER_API_MEMBER(name) decltype(&name) name##_;
+  C10_CUDA_DRIVER_API(C10_CUDA_DRIVER_API_MEMBER)
+#undef C10_CUDA_DRIVER_API_MEMBER
+
+  // Returns nullptr if libcuda could not be loaded.
+  static DriverAPI* get();
+};
+
+} // namespace cuda
+} // namespace c10
+
+#endif // C10_CUDA_DRIVER_API_SUPPORTED
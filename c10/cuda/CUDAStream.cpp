@@ -3,10 +3,14 @@
 #include <c10/cuda/CUDAGuard.h>
 #include <c10/util/Exception.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstdint>
+#include <cstdlib>
 #include <mutex>
+#include <string>
+#include <tuple>
 #include <vector>
 
 #include <iostream>
@@ -35,13 +39,22 @@ struct LeakyStreamInternals {
   DeviceIndex device_index = -1;
   int32_t stream_id = -1;
   cudaStream_t stream = nullptr;
+  // Only tracked for dedicated streams, which can have any priority
+  int priority = 0;
 };
 
 // Global stream state and constants
 static DeviceIndex num_gpus = -1;
-static constexpr int kStreamsPerPoolBits = 5;
-static constexpr int kStreamsPerPool = 1 << kStreamsPerPoolBits;
+static constexpr int kStreamIdIndexBits = 8;
+// The pools are allocated with room for kMaxStreamsPerPool streams, but
+// only the first streams_per_pool of them are created and handed out.
+// streams_per_pool defaults to kDefaultStreamsPerPool and can be set with
+// the PYTORCH_CUDA_STREAMS_PER_POOL environment variable.
+static constexpr int kMaxStreamsPerPool = 1 << kStreamIdIndexBits;
+static constexpr int kDefaultStreamsPerPool = 32;
+static constexpr int kMaxDedicatedStreams = 1 << kStreamIdIndexBits;
 static constexpr unsigned int kDefaultFlags = cudaStreamNonBlocking;
+static uint32_t streams_per_pool = kDefaultStreamsPerPool;
 
 // Note: stream priority is not supported by HIP
 // Note: lower numbers are higher priorities, zero is default priority
@@ -68,22 +81,34 @@ static LeakyStreamInternals default_streams[C10_COMPILE_TIME_MAX_GPUS];
 static std::once_flag device_flags[C10_COMPILE_TIME_MAX_GPUS];
 static std::atomic<uint32_t> low_priority_counters[C10_COMPILE_TIME_MAX_GPUS];
 static std::atomic<uint32_t> high_priority_counters[C10_COMPILE_TIME_MAX_GPUS];
-static std::array<LeakyStreamInternals, kStreamsPerPool>
+static std::array<LeakyStreamInternals, kMaxStreamsPerPool>
     low_priority_streams[C10_COMPILE_TIME_MAX_GPUS];
-static std::array<LeakyStreamInternals, kStreamsPerPool>
+static std::array<LeakyStreamInternals, kMaxStreamsPerPool>
     high_priority_streams[C10_COMPILE_TIME_MAX_GPUS];
 
+// Dedicated streams
+// These are created on request, one cuStream per getDedicatedStream call
+// that can't reuse a released stream of the same priority, and are never
+// destroyed. dedicated_stream_counts[i] of them exist on device i, and the
+// indices of the released ones are kept in dedicated_free_lists[i].
+static std::mutex dedicated_streams_mutex;
+static std::array<LeakyStreamInternals, kMaxDedicatedStreams>
+    dedicated_streams[C10_COMPILE_TIME_MAX_GPUS];
+static size_t dedicated_stream_counts[C10_COMPILE_TIME_MAX_GPUS];
+static std::vector<size_t> dedicated_free_lists[C10_COMPILE_TIME_MAX_GPUS];
+
 // Note [StreamId assignment]
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~
 // How do we assign stream IDs?
 //
-// -- 25 bits -- -- 2 bits --  -- 5 bits -----
+// -- 22 bits -- -- 2 bits --  -- 8 bits -----
 // zeros         StreamIdType  stream id index
 //
 // Where StreamIdType:
 //  00 = default stream
 //  01 = low priority stream
 //  10 = high priority stream
+//  11 = dedicated stream
 //
 // This is not really for efficiency; it's just easier to write the code
 // to extract the index if we do this with bitmasks :)
@@ -104,6 +129,7 @@ enum class StreamIdType : uint8_t {
   DEFAULT = 0x0,
   LOW = 0x1,
   HIGH = 0x2,
+  DEDICATED = 0x3,
 };
 
 std::ostream& operator<<(std::ostream& stream, StreamIdType s) {
@@ -117,6 +143,9 @@ std::ostream& operator<<(std::ostream& stream, StreamIdType s) {
     case StreamIdType::HIGH:
       stream << "HIGH";
       break;
+    case StreamIdType::DEDICATED:
+      stream << "DEDICATED";
+      break;
     default:
       stream << static_cast<uint8_t>(s);
       break;
@@ -129,15 +158,15 @@ std::ostream& operator<<(std::ostream& stream, StreamIdType s) {
 // see Note [Hazard when concatenating signed integers]
 
 static inline StreamIdType streamIdType(StreamId s) {
-  return static_cast<StreamIdType>(s >> kStreamsPerPoolBits);
+  return static_cast<StreamIdType>(s >> kStreamIdIndexBits);
 }
 
 static inline size_t streamIdIndex(StreamId s) {
-  return static_cast<size_t>(s & ((1 << kStreamsPerPoolBits) - 1));
+  return static_cast<size_t>(s & ((1 << kStreamIdIndexBits) - 1));
 }
 
 StreamId makeStreamId(StreamIdType st, size_t si) {
-  return (static_cast<StreamId>(st) << kStreamsPerPoolBits) |
+  return (static_cast<StreamId>(st) << kStreamIdIndexBits) |
       static_cast<StreamId>(si);
 }
 
@@ -178,6 +207,13 @@ static StreamId CUDAStream_getStreamId(const LeakyStreamInternals* ptr) {
         StreamIdType::HIGH, ptr - high_priority_streams[device_index].data());
   }
 
+  // Check if it's a dedicated stream
+  if (pointer_within<LeakyStreamInternals>(
+          ptr, dedicated_streams[device_index])) {
+    return makeStreamId(
+        StreamIdType::DEDICATED, ptr - dedicated_streams[device_index].data());
+  }
+
   AT_ASSERTM(
       0,
       "Could not compute stream ID for ",
@@ -198,6 +234,24 @@ static thread_local LeakyStreamInternals** current_streams = nullptr;
 // Warning: this function must only be called once!
 static void initGlobalStreamState() {
   num_gpus = device_count();
+  if (const char* env = std::getenv("PYTORCH_CUDA_STREAMS_PER_POOL")) {
+    int value = 0;
+    try {
+      size_t pos = 0;
+      value = std::stoi(env, &pos);
+      if (env[pos] != '\0') {
+        value = 0;
+      }
+    } catch (const std::exception&) {
+    }
+    TORCH_CHECK(
+        value >= 1 && value <= kMaxStreamsPerPool,
+        "PYTORCH_CUDA_STREAMS_PER_POOL: expected an integer between 1 and ",
+        kMaxStreamsPerPool,
+        ", got ",
+        env);
+    streams_per_pool = static_cast<uint32_t>(value);
+  }
   // Check if the number of GPUs matches the expected compile-time max number
   // of GPUs.
   AT_ASSERTM(
@@ -222,7 +276,7 @@ static void initDeviceStreamState(DeviceIndex device_index) {
   // with it.
   CUDAGuard device_guard{device_index};
 
-  for (auto i = decltype(kStreamsPerPool){0}; i < kStreamsPerPool; ++i) {
+  for (uint32_t i = 0; i < streams_per_pool; ++i) {
     auto& lowpri_stream = low_priority_streams[device_index][i];
     auto& hipri_stream = high_priority_streams[device_index][i];
 
@@ -269,7 +323,7 @@ static inline void check_gpu(DeviceIndex device_index) {
 // Note: Streams are returned round-robin (see note in CUDAStream.h)
 static uint32_t get_idx(std::atomic<uint32_t>& counter) {
   auto raw_idx = counter++;
-  return raw_idx % kStreamsPerPool;
+  return raw_idx % streams_per_pool;
 }
 
 // See Note [StreamId assignment]
@@ -293,6 +347,8 @@ LeakyStreamInternals* CUDAStream_internals(CUDAStream s) {
       return &low_priority_streams[device_index][si];
     case StreamIdType::HIGH:
       return &high_priority_streams[device_index][si];
+    case StreamIdType::DEDICATED:
+      return &dedicated_streams[device_index][si];
     default:
       AT_ASSERTM(
           0,
@@ -345,6 +401,81 @@ CUDAStream getStreamFromPool(
   return CUDAStream_fromInternals(&low_priority_streams[device_index][idx]);
 }
 
+CUDAStream getDedicatedStream(int priority, DeviceIndex device_index) {
+  initCUDAStreamsOnce();
+  if (device_index == -1)
+    device_index = current_device();
+  check_gpu(device_index);
+
+#ifndef __HIP_PLATFORM_HCC__
+  // Lower numbers are higher priorities, see CUDAStream::priority_range
+  int least_priority, greatest_priority;
+  {
+    CUDAGuard device_guard{device_index};
+    std::tie(least_priority, greatest_priority) =
+        CUDAStream::priority_range();
+  }
+  priority = std::min(std::max(priority, greatest_priority), least_priority);
+#else
+  priority = 0;
+#endif // __HIP_PLATFORM_HCC__
+
+  std::lock_guard<std::mutex> lock(dedicated_streams_mutex);
+  auto& streams = dedicated_streams[device_index];
+  auto& free_list = dedicated_free_lists[device_index];
+  auto it = std::find_if(free_list.begin(), free_list.end(), [&](size_t i) {
+    return streams[i].priority == priority;
+  });
+  if (it != free_list.end()) {
+    const size_t idx = *it;
+    free_list.erase(it);
+    return CUDAStream_fromInternals(&streams[idx]);
+  }
+
+  auto& count = dedicated_stream_counts[device_index];
+  TORCH_CHECK(
+      count < kMaxDedicatedStreams,
+      "Can't create more than ",
+      kMaxDedicatedStreams,
+      " dedicated CUDA streams on device ",
+      device_index,
+      "; release the ones that are no longer used with "
+      "releaseDedicatedStream");
+  auto& internals = streams[count];
+  {
+    CUDAGuard device_guard{device_index};
+#ifndef __HIP_PLATFORM_HCC__
+    C10_CUDA_CHECK(cudaStreamCreateWithPriority(
+        &internals.stream, kDefaultFlags, priority));
+#else
+    C10_CUDA_CHECK(cudaStreamCreateWithFlags(&internals.stream, kDefaultFlags));
+#endif // __HIP_PLATFORM_HCC__
+  }
+  internals.device_index = device_index;
+  internals.priority = priority;
+  ++count;
+  return CUDAStream_fromInternals(&internals);
+}
+
+void releaseDedicatedStream(CUDAStream stream) {
+  TORCH_CHECK(
+      streamIdType(stream.id()) == StreamIdType::DEDICATED,
+      "releaseDedicatedStream: ",
+      stream,
+      " was not returned by getDedicatedStream");
+  const size_t idx = streamIdIndex(stream.id());
+  std::lock_guard<std::mutex> lock(dedicated_streams_mutex);
+  auto& free_list = dedicated_free_lists[stream.device_index()];
+  TORCH_CHECK(
+      idx < dedicated_stream_counts[stream.device_index()] &&
+          std::find(free_list.begin(), free_list.end(), idx) ==
+              free_list.end(),
+      "releaseDedicatedStream: ",
+      stream,
+      " is not in use");
+  free_list.push_back(idx);
+}
+
 CUDAStream getDefaultCUDAStream(DeviceIndex device_index) {
   initCUDAStreamsOnce();
   if (device_index == -1) {
@@ -28,7 +28,10 @@
 * in the third pool (below). There are 32 of these streams per device, and
 * when a stream is requested one of these streams is returned round-robin.
 * That is, the first stream requested is at index 0, the second at index 1...
-* to index 31, then index 0 again.
+* to index 31, then index 0 again.  The number of streams in this pool and
+* the third one can be set between 1 and 256 with the
+* PYTORCH_CUDA_STREAMS_PER_POOL environment variable, which is read when
+* streams are first used.
 *
 * This means that if 33 low priority streams are requested, the first and
 * last streams requested are actually the same stream (under the covers)
@@ -38,11 +41,13 @@
 * the second pool except the streams are created with a higher priority.
 *
 * These pools suggest that stream users should prefer many short-lived streams,
-* as the cost of acquiring and releasing streams is effectively zero. If
-* many longer-lived streams are required in performance critical scenarios
-* then the functionality here may need to be extended to allow, for example,
-* "reserving" a subset of the pool so that other streams do not accidentally
-* overlap the performance critical streams.
+* as the cost of acquiring and releasing streams is effectively zero. Long-lived
+* streams in performance critical code (e.g. for data prefetching or one
+* inference session of several on a device) should instead come from
+* getDedicatedStream, which returns a stream that no other caller gets until
+* it is given back with releaseDedicatedStream, so that unrelated work is not
+* serialized with it. Dedicated streams may have any priority the device
+* supports, see CUDAStream::priority_range.
 *
 * Note: although the notion of "current stream for device" is thread local
 * (every OS thread has a separate current stream, as one might expect),
@@ -184,6 +189,25 @@ private:
 CAFFE2_API CUDAStream
 getStreamFromPool(const bool isHighPriority = false, DeviceIndex device = -1);
 
+/**
+ * Get a stream that is not shared with any other caller, for the passed
+ * device or the current device, until it is released with
+ * releaseDedicatedStream.  The priority is clamped to the priority range of
+ * the device; lower numbers are higher priorities and 0 is the default.
+ *
+ * Streams are created on demand and reused once released, but never
+ * destroyed, so this is meant for long-lived streams; at most 256 of them
+ * can be in use on a device.
+ */
+CAFFE2_API CUDAStream
+getDedicatedStream(int priority = 0, DeviceIndex device = -1);
+
+/**
+ * Give a stream returned by getDedicatedStream back for reuse.  Work queued
+ * on it does not need to have completed.
+ */
+CAFFE2_API void releaseDedicatedStream(CUDAStream stream);
+
 /**
  * Get the default CUDA stream, for the passed CUDA device, or for the
  * current device if no device index is passed.  The default stream is
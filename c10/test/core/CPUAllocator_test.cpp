@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+
+using namespace c10;
+
+TEST(CPUAllocatorTest, TracksStatsWhenEnabled) {
+  const bool saved = FLAGS_caffe2_track_cpu_memory_usage;
+  FLAGS_caffe2_track_cpu_memory_usage = true;
+  ResetDefaultCPUAllocatorPeakStats();
+  ResetDefaultCPUAllocatorAccumulatedStats();
+
+  at::Allocator* allocator = GetDefaultCPUAllocator();
+  auto base = GetDefaultCPUAllocatorStats();
+  {
+    at::DataPtr small = allocator->allocate(100);
+    at::DataPtr large = allocator->allocate(5000);
+
+    auto stats = GetDefaultCPUAllocatorStats();
+    ASSERT_EQ(stats.allocation.current, base.allocation.current + 2);
+    ASSERT_EQ(
+        stats.allocated_bytes.current, base.allocated_bytes.current + 5100);
+    // 100 bytes falls into [64, 128), 5000 bytes into [4096, 8192).
+    ASSERT_EQ(
+        stats.bucket_allocation[6].current,
+        base.bucket_allocation[6].current + 1);
+    ASSERT_EQ(
+        stats.bucket_allocated_bytes[12].current,
+        base.bucket_allocated_bytes[12].current + 5000);
+
+    bool found_small = false;
+    for (const auto& info : SnapshotDefaultCPUAllocator()) {
+      if (info.address == reinterpret_cast<int64_t>(small.get())) {
+        ASSERT_EQ(info.size, 100);
+        found_small = true;
+      }
+    }
+    ASSERT_TRUE(found_small);
+  }
+  auto stats = GetDefaultCPUAllocatorStats();
+  ASSERT_EQ(stats.allocation.current, base.allocation.current);
+  ASSERT_EQ(stats.allocation.allocated, base.allocation.allocated + 2);
+  ASSERT_EQ(stats.allocation.freed, base.allocation.freed + 2);
+  ASSERT_EQ(stats.allocated_bytes.peak, base.allocated_bytes.current + 5100);
+
+  ResetDefaultCPUAllocatorAccumulatedStats();
+  ASSERT_EQ(GetDefaultCPUAllocatorStats().allocation.allocated, 0);
+
+  FLAGS_caffe2_track_cpu_memory_usage = saved;
+}
+
+TEST(CPUAllocatorTest, FreeAfterTrackingDisabled) {
+  const bool saved = FLAGS_caffe2_track_cpu_memory_usage;
+  FLAGS_caffe2_track_cpu_memory_usage = true;
+  auto base = GetDefaultCPUAllocatorStats();
+  at::DataPtr ptr = GetDefaultCPUAllocator()->allocate(64);
+  FLAGS_caffe2_track_cpu_memory_usage = false;
+  // The deleter was chosen at allocation time, so the free is still counted.
+  ptr.clear();
+  ASSERT_EQ(
+      GetDefaultCPUAllocatorStats().allocation.current,
+      base.allocation.current);
+  FLAGS_caffe2_track_cpu_memory_usage = saved;
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUArenaAllocator.h>
+
+#include <cstdint>
+#include <thread>
+
+using namespace c10;
+
+TEST(CPUArenaAllocatorTest, BumpsWithinChunk) {
+  CPUArenaAllocator arena(4096);
+  at::DataPtr a = arena.allocate(100);
+  at::DataPtr b = arena.allocate(100);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(a.get()) % gAlignment, 0);
+  ASSERT_EQ(static_cast<char*>(b.get()) - static_cast<char*>(a.get()), 128);
+  ASSERT_EQ(arena.bytes_allocated(), 256);
+  ASSERT_EQ(arena.num_chunks(), 1);
+}
+
+TEST(CPUArenaAllocatorTest, StartsNewChunkWhenFull) {
+  CPUArenaAllocator arena(1024);
+  at::DataPtr a = arena.allocate(1000);
+  at::DataPtr b = arena.allocate(1000);
+  ASSERT_EQ(arena.num_chunks(), 2);
+  // Requests larger than the chunk size get a chunk of their own.
+  at::DataPtr c = arena.allocate(5000);
+  ASSERT_EQ(arena.num_chunks(), 3);
+  memset(c.get(), 0, 5000);
+}
+
+TEST(CPUArenaAllocatorTest, AllocationsOutliveArena) {
+  at::DataPtr escaped;
+  {
+    CPUArenaAllocator arena;
+    escaped = arena.allocate(64);
+    memset(escaped.get(), 1, 64);
+  }
+  std::thread t([&]() { escaped.clear(); });
+  t.join();
+}
+
+TEST(CPUArenaAllocatorTest, GuardOverridesCPUAllocator) {
+  at::Allocator* original = GetCPUAllocator();
+  {
+    CPUArenaGuard outer;
+    ASSERT_EQ(GetCPUAllocator(), &outer.allocator());
+    {
+      CPUArenaGuard inner;
+      ASSERT_EQ(GetCPUAllocator(), &inner.allocator());
+    }
+    ASSERT_EQ(GetCPUAllocator(), &outer.allocator());
+    at::DataPtr ptr = GetCPUAllocator()->allocate(10);
+    ASSERT_EQ(outer.allocator().bytes_allocated(), gAlignment);
+
+    std::thread t([&]() { ASSERT_EQ(GetCPUAllocator(), original); });
+    t.join();
+  }
+  ASSERT_EQ(GetCPUAllocator(), original);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <cstdint>
+#include <thread>
+
+using namespace c10;
+
+TEST(CPUCachingAllocatorTest, ReusesFreedBlocks) {
+  CPUCachingAllocator::emptyCache();
+  at::Allocator* allocator = CPUCachingAllocator::get();
+
+  void* first = nullptr;
+  {
+    at::DataPtr ptr = allocator->allocate(1000);
+    first = ptr.get();
+    ASSERT_NE(first, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(first) % gAlignment, 0);
+  }
+  auto before = CPUCachingAllocator::getStats();
+  {
+    // 1000 and 1020 bytes fall into the same size class.
+    at::DataPtr ptr = allocator->allocate(1020);
+    ASSERT_EQ(ptr.get(), first);
+  }
+  auto after = CPUCachingAllocator::getStats();
+  ASSERT_EQ(after.num_cache_hits, before.num_cache_hits + 1);
+  ASSERT_EQ(after.num_cache_misses, before.num_cache_misses);
+  ASSERT_EQ(after.segment.current, before.segment.current);
+
+  CPUCachingAllocator::emptyCache();
+  auto emptied = CPUCachingAllocator::getStats();
+  ASSERT_EQ(emptied.cached_bytes.current, 0);
+  ASSERT_EQ(emptied.reserved_bytes.current, emptied.allocated_bytes.current);
+}
+
+TEST(CPUCachingAllocatorTest, TracksStats) {
+  CPUCachingAllocator::emptyCache();
+  CPUCachingAllocator::resetPeakStats();
+  at::Allocator* allocator = CPUCachingAllocator::get();
+  auto base = CPUCachingAllocator::getStats();
+  {
+    at::DataPtr a = allocator->allocate(4096);
+    at::DataPtr b = allocator->allocate(8192);
+    auto stats = CPUCachingAllocator::getStats();
+    ASSERT_EQ(stats.allocation.current, base.allocation.current + 2);
+    ASSERT_EQ(
+        stats.allocated_bytes.current, base.allocated_bytes.current + 12288);
+    ASSERT_GE(stats.reserved_bytes.current, stats.allocated_bytes.current);
+  }
+  auto stats = CPUCachingAllocator::getStats();
+  ASSERT_EQ(stats.allocation.current, base.allocation.current);
+  ASSERT_EQ(stats.allocated_bytes.peak, base.allocated_bytes.current + 12288);
+  ASSERT_EQ(stats.cached_bytes.current, 12288);
+
+  CPUCachingAllocator::resetPeakStats();
+  ASSERT_EQ(
+      CPUCachingAllocator::getStats().allocated_bytes.peak,
+      base.allocated_bytes.current);
+  CPUCachingAllocator::emptyCache();
+}
+
+TEST(CPUCachingAllocatorTest, LargeRequestsBypassCache) {
+  CPUCachingAllocator::emptyCache();
+  at::Allocator* allocator = CPUCachingAllocator::get();
+  const size_t nbytes = FLAGS_caffe2_cpu_caching_allocator_max_block_size + 1;
+  { at::DataPtr ptr = allocator->allocate(nbytes); }
+  ASSERT_EQ(CPUCachingAllocator::getStats().cached_bytes.current, 0);
+}
+
+TEST(CPUCachingAllocatorTest, RawAllocateAndFreeOnOtherThread) {
+  CPUCachingAllocator::emptyCache();
+  at::Allocator* allocator = CPUCachingAllocator::get();
+  void* raw = allocator->raw_allocate(256);
+  ASSERT_NE(raw, nullptr);
+  std::thread t([&]() { allocator->raw_deallocate(raw); });
+  t.join();
+  // The freeing thread has exited, so its cached block was flushed to the
+  // global pool and is visible to this thread.
+  at::DataPtr ptr = allocator->allocate(256);
+  ASSERT_EQ(ptr.get(), raw);
+  ptr.clear();
+  CPUCachingAllocator::emptyCache();
+}
+
+TEST(CPUCachingAllocatorTest, TrimThreshold) {
+  CPUCachingAllocator::emptyCache();
+  const auto saved_thread_cache =
+      FLAGS_caffe2_cpu_caching_allocator_thread_cache_size;
+  const auto saved_threshold = FLAGS_caffe2_cpu_caching_allocator_trim_threshold;
+  FLAGS_caffe2_cpu_caching_allocator_thread_cache_size = 0;
+  FLAGS_caffe2_cpu_caching_allocator_trim_threshold = 4096;
+
+  at::Allocator* allocator = CPUCachingAllocator::get();
+  auto before = CPUCachingAllocator::getStats();
+  {
+    at::DataPtr a = allocator->allocate(4096);
+    at::DataPtr b = allocator->allocate(4096);
+  }
+  auto after = CPUCachingAllocator::getStats();
+  ASSERT_EQ(after.num_trims, before.num_trims + 1);
+  ASSERT_EQ(after.cached_bytes.current, 4096);
+
+  FLAGS_caffe2_cpu_caching_allocator_thread_cache_size = saved_thread_cache;
+  FLAGS_caffe2_cpu_caching_allocator_trim_threshold = saved_threshold;
+  CPUCachingAllocator::emptyCache();
+}
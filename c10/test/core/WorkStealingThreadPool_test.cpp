@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/WorkStealingThreadPool.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace c10;
+
+TEST(WorkStealingThreadPoolTest, RunsAllTasks) {
+  WorkStealingThreadPool pool(4);
+  ASSERT_EQ(pool.size(), 4);
+  std::atomic<int> count{0};
+  constexpr int kNumTasks = 10000;
+  for (int i = 0; i < kNumTasks; ++i) {
+    pool.run([&count]() { ++count; });
+  }
+  while (count < kNumTasks) {
+    pool.runPendingTask();
+  }
+  ASSERT_EQ(count, kNumTasks);
+}
+
+TEST(WorkStealingThreadPoolTest, NestedTasksAreStolen) {
+  WorkStealingThreadPool pool(4);
+  std::atomic<int> count{0};
+  std::atomic<bool> in_pool{true};
+  // All children are pushed to one worker's queue; the others must steal them.
+  pool.run([&]() {
+    for (int i = 0; i < 100; ++i) {
+      pool.run([&]() {
+        in_pool = in_pool && pool.inThreadPool();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        ++count;
+      });
+    }
+  });
+  while (count < 100) {
+    std::this_thread::yield();
+  }
+  ASSERT_TRUE(in_pool);
+  ASSERT_FALSE(pool.inThreadPool());
+}
+
+TEST(WorkStealingThreadPoolTest, WakesUpSleepingWorkers) {
+  WorkStealingThreadPool pool(2);
+  for (int round = 0; round < 3; ++round) {
+    // give the workers time to go to sleep
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::atomic<bool> done{false};
+    pool.run([&done]() { done = true; });
+    while (!done) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+TEST(WorkStealingThreadPoolTest, SurvivesThrowingTasks) {
+  WorkStealingThreadPool pool(2);
+  std::atomic<bool> done{false};
+  pool.run([]() { throw std::runtime_error("task failure"); });
+  pool.run([&done]() { done = true; });
+  while (!done) {
+    std::this_thread::yield();
+  }
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/impl/COW.h>
+
+#include <cstring>
+
+using namespace c10;
+using namespace c10::impl;
+
+static intrusive_ptr<StorageImpl> makeStorage(size_t size_bytes) {
+  auto storage = make_intrusive<StorageImpl>(
+      StorageImpl::use_byte_size_t(),
+      caffe2::TypeMeta::Make<uint8_t>(),
+      size_bytes,
+      GetCPUAllocator(),
+      /*resizable=*/false);
+  std::memset(storage->data(), 7, size_bytes);
+  return storage;
+}
+
+TEST(COWTest, LazyCloneSharesData) {
+  auto storage = makeStorage(16);
+  EXPECT_FALSE(cow::is_cow(*storage));
+  auto clone = cow::lazy_clone_storage(*storage);
+  EXPECT_TRUE(cow::is_cow(*storage));
+  EXPECT_TRUE(cow::is_cow(*clone));
+  EXPECT_EQ(storage->data(), clone->data());
+  EXPECT_EQ(storage->nbytes(), clone->nbytes());
+}
+
+TEST(COWTest, MaterializeCopiesSharedData) {
+  auto storage = makeStorage(16);
+  auto clone = cow::lazy_clone_storage(*storage);
+  void* shared = storage->data();
+
+  cow::materialize_cow_storage(*clone);
+  EXPECT_FALSE(cow::is_cow(*clone));
+  EXPECT_NE(clone->data(), shared);
+  EXPECT_EQ(static_cast<uint8_t*>(clone->data())[15], 7);
+
+  // The last storage sharing the data takes it back without copying.
+  EXPECT_TRUE(cow::is_cow(*storage));
+  cow::materialize_cow_storage(*storage);
+  EXPECT_FALSE(cow::is_cow(*storage));
+  EXPECT_EQ(storage->data(), shared);
+}
+
+TEST(COWTest, CloneOfClone) {
+  auto storage = makeStorage(8);
+  auto clone = cow::lazy_clone_storage(*storage);
+  auto clone2 = cow::lazy_clone_storage(*clone);
+  EXPECT_EQ(clone2->data(), storage->data());
+
+  cow::materialize_cow_storage(*storage);
+  EXPECT_NE(storage->data(), clone->data());
+  EXPECT_EQ(clone->data(), clone2->data());
+
+  // Destroying a sharing storage releases its reference.
+  void* shared = clone->data();
+  clone.reset();
+  cow::materialize_cow_storage(*clone2);
+  EXPECT_EQ(clone2->data(), shared);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/impl/SizesAndStrides.h>
+
+#include <vector>
+
+using namespace c10;
+using namespace c10::impl;
+
+static void setContiguousStrides(SizesAndStrides& ss) {
+  int64_t stride = 1;
+  for (size_t i = ss.size(); i > 0; --i) {
+    ss.stride_at(i - 1) = stride;
+    stride *= ss.size_at(i - 1);
+  }
+}
+
+static void checkData(
+    const SizesAndStrides& ss,
+    const std::vector<int64_t>& sizes,
+    const std::vector<int64_t>& strides) {
+  ASSERT_EQ(ss.size(), sizes.size());
+  EXPECT_EQ(ss.sizes_arrayref(), IntArrayRef(sizes));
+  EXPECT_EQ(ss.strides_arrayref(), IntArrayRef(strides));
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    EXPECT_EQ(ss.size_at(i), sizes[i]);
+    EXPECT_EQ(ss.stride_at(i), strides[i]);
+  }
+}
+
+TEST(SizesAndStridesTest, DefaultConstructor) {
+  SizesAndStrides ss;
+  checkData(ss, {0}, {1});
+}
+
+TEST(SizesAndStridesTest, SetSizes) {
+  SizesAndStrides ss;
+  ss.set_sizes({2, 3, 4});
+  setContiguousStrides(ss);
+  checkData(ss, {2, 3, 4}, {12, 4, 1});
+}
+
+TEST(SizesAndStridesTest, ResizeKeepsCommonPrefix) {
+  SizesAndStrides ss;
+  ss.set_sizes({2, 3, 4, 5});
+  setContiguousStrides(ss);
+
+  // Inline to out of line and back.
+  ss.resize(7);
+  for (size_t i = 4; i < 7; ++i) {
+    ss.size_at(i) = 1;
+    ss.stride_at(i) = 1;
+  }
+  checkData(ss, {2, 3, 4, 5, 1, 1, 1}, {60, 20, 5, 1, 1, 1, 1});
+  ss.resize(9);
+  ss.resize(6);
+  checkData(ss, {2, 3, 4, 5, 1, 1}, {60, 20, 5, 1, 1, 1});
+  ss.resize(2);
+  checkData(ss, {2, 3}, {60, 20});
+  ss.resize(0);
+  checkData(ss, {}, {});
+}
+
+TEST(SizesAndStridesTest, CopyAndMove) {
+  for (const std::vector<int64_t>& sizes :
+       {std::vector<int64_t>{2, 3}, std::vector<int64_t>{1, 2, 3, 4, 5, 6}}) {
+    SizesAndStrides ss;
+    ss.set_sizes(sizes);
+    setContiguousStrides(ss);
+    const std::vector<int64_t> strides = ss.strides_arrayref().vec();
+
+    SizesAndStrides copy(ss);
+    checkData(copy, sizes, strides);
+    checkData(ss, sizes, strides);
+
+    SizesAndStrides assigned;
+    assigned.set_sizes({1, 2, 3, 4, 5, 6, 7});
+    assigned = ss;
+    checkData(assigned, sizes, strides);
+
+    SizesAndStrides moved(std::move(copy));
+    checkData(moved, sizes, strides);
+
+    SizesAndStrides moveAssigned;
+    moveAssigned = std::move(moved);
+    checkData(moveAssigned, sizes, strides);
+  }
+}
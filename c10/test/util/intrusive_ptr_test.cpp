@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 #include <map>
 #include <set>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -63,6 +64,13 @@ class ChildDestructableMock final : public DestructableMock {
   ChildDestructableMock(bool* resourcesReleased, bool* wasDestructed)
       : DestructableMock(resourcesReleased, wasDestructed) {}
 };
+class BiasedDestructableMock final : public DestructableMock {
+ public:
+  BiasedDestructableMock(bool* resourcesReleased, bool* wasDestructed)
+      : DestructableMock(resourcesReleased, wasDestructed) {
+    enable_biased_refcount_();
+  }
+};
 class NullType1 final {
   static SomeClass singleton_;
 public:
@@ -3382,3 +3390,84 @@ TEST(WeakIntrusivePtrTest, givenStackObject_whenReclaimed_thenCrashes) {
   EXPECT_ANY_THROW(ptr = weak_intrusive_ptr<SomeClass>::reclaim(&obj));
 #endif
 }
+
+TEST(BiasedRefcountTest, givenOwnedPtr_whenCopied_thenCountsReferences) {
+  bool resourcesReleased = false;
+  bool wasDestructed = false;
+  {
+    c10::impl::BiasedRefcountGuard guard;
+    auto obj = make_intrusive<BiasedDestructableMock>(&resourcesReleased, &wasDestructed);
+    {
+      auto copy = obj;
+      EXPECT_EQ(2, obj.use_count());
+    }
+    EXPECT_EQ(1, obj.use_count());
+    EXPECT_FALSE(resourcesReleased);
+    obj.reset();
+    EXPECT_TRUE(resourcesReleased);
+    EXPECT_TRUE(wasDestructed);
+  }
+}
+
+TEST(BiasedRefcountTest, givenOwnedPtr_whenLastReferenceDroppedOnOtherThread_thenDestructsWhenGuardEnds) {
+  bool resourcesReleased = false;
+  bool wasDestructed = false;
+  {
+    c10::impl::BiasedRefcountGuard guard;
+    auto obj = make_intrusive<BiasedDestructableMock>(&resourcesReleased, &wasDestructed);
+    std::thread([obj = std::move(obj)]() mutable { obj.reset(); }).join();
+    // The biased count is still 1 until the owner merges it.
+    EXPECT_FALSE(resourcesReleased);
+  }
+  EXPECT_TRUE(resourcesReleased);
+  EXPECT_TRUE(wasDestructed);
+}
+
+TEST(BiasedRefcountTest, givenOwnedPtr_whenSharedWithOtherThread_thenStaysAlive) {
+  bool resourcesReleased = false;
+  bool wasDestructed = false;
+  {
+    c10::impl::BiasedRefcountGuard guard;
+    auto obj = make_intrusive<BiasedDestructableMock>(&resourcesReleased, &wasDestructed);
+    auto copy = obj;
+    std::thread([&]() {
+      auto other = copy;
+      copy.reset();
+      other.reset();
+    }).join();
+    EXPECT_FALSE(resourcesReleased);
+    EXPECT_EQ(1, obj.use_count());
+  }
+  EXPECT_TRUE(resourcesReleased);
+  EXPECT_TRUE(wasDestructed);
+}
+
+TEST(BiasedRefcountTest, givenPtrOfEndedGuard_whenDroppedOnOtherThread_thenDestructs) {
+  bool resourcesReleased = false;
+  bool wasDestructed = false;
+  intrusive_ptr<BiasedDestructableMock> obj;
+  {
+    c10::impl::BiasedRefcountGuard guard;
+    obj = make_intrusive<BiasedDestructableMock>(&resourcesReleased, &wasDestructed);
+  }
+  std::thread([obj = std::move(obj)]() mutable { obj.reset(); }).join();
+  EXPECT_TRUE(resourcesReleased);
+  EXPECT_TRUE(wasDestructed);
+}
+
+TEST(BiasedRefcountTest, givenOwnedPtr_whenLockedFromOtherThread_thenReturnsValidPtr) {
+  bool resourcesReleased = false;
+  bool wasDestructed = false;
+  c10::impl::BiasedRefcountGuard guard;
+  auto obj = make_intrusive<BiasedDestructableMock>(&resourcesReleased, &wasDestructed);
+  weak_intrusive_ptr<BiasedDestructableMock> weak(obj);
+  std::thread([&]() {
+    auto locked = weak.lock();
+    EXPECT_TRUE(locked.defined());
+    EXPECT_EQ(2, locked.use_count());
+  }).join();
+  obj.reset();
+  EXPECT_TRUE(resourcesReleased);
+  EXPECT_FALSE(wasDestructed);
+  EXPECT_FALSE(weak.lock().defined());
+}
@@ -20,7 +20,7 @@ std::shared_ptr<DebugInfoBase> ThreadLocalDebugInfo::get(
 }
 
 /* static */
-std::shared_ptr<ThreadLocalDebugInfo> ThreadLocalDebugInfo::current() {
+const std::shared_ptr<ThreadLocalDebugInfo>& ThreadLocalDebugInfo::current() {
   return debug_info;
 }
 
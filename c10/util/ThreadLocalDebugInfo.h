@@ -41,8 +41,9 @@ class C10_API ThreadLocalDebugInfo {
  public:
   static std::shared_ptr<DebugInfoBase> get(DebugInfoKind kind);
 
-  // Get current ThreadLocalDebugInfo
-  static std::shared_ptr<ThreadLocalDebugInfo> current();
+  // Get current ThreadLocalDebugInfo; the reference is valid until the
+  // current debug info of the thread changes
+  static const std::shared_ptr<ThreadLocalDebugInfo>& current();
 
   // Internal, use DebugInfoGuard/ThreadLocalStateGuard
   static void _forceCurrentDebugInfo(
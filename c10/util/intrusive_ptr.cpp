@@ -1 +1,207 @@
 #include <c10/util/intrusive_ptr.h>
+
+#include <mutex>
+#include <vector>
+
+namespace c10 {
+
+constexpr int64_t intrusive_ptr_target::kMerged;
+constexpr int64_t intrusive_ptr_target::kQueued;
+constexpr int64_t intrusive_ptr_target::kRefcountOne;
+
+namespace impl {
+
+// The biased refcounts of the objects a thread created while holding a
+// BiasedRefcountGuard. Owners are never freed: objects point to them for as
+// long as they live. When its thread exits, an owner is handed to the next
+// thread that takes a guard, which inherits its objects.
+struct BiasedRefcountOwner {
+  std::mutex mutex;
+  // Objects other threads asked us to merge, each holding a weak reference.
+  std::vector<const intrusive_ptr_target*> queue;
+  std::atomic<bool> has_queued{false};
+  // True when no thread holds a guard for this owner, in which case the
+  // threads queueing objects merge them themselves. Only written with the
+  // mutex held.
+  std::atomic<bool> exited{true};
+
+  // Folds the biased count of self into its shared count; returns true if
+  // self is dead. Must only be called by the thread owning self, or with the
+  // mutex of an owner that exited.
+  static bool merge(const intrusive_ptr_target* self) noexcept {
+    int64_t biased = self->biased_refcount_.load(std::memory_order_relaxed);
+    self->biased_refcount_.store(0, std::memory_order_relaxed);
+    self->owner_.store(nullptr, std::memory_order_relaxed);
+    int64_t delta = biased * intrusive_ptr_target::kRefcountOne +
+        intrusive_ptr_target::kMerged;
+    return intrusive_ptr_target::is_dead_(
+        self->refcount_.fetch_add(delta, std::memory_order_acq_rel) + delta);
+  }
+
+  static void drop_weak(const intrusive_ptr_target* self) noexcept {
+    if (--self->weakcount_ == 0) {
+      delete self;
+    }
+  }
+
+  // Same as intrusive_ptr::reset_() once the last strong reference is gone.
+  static void release(const intrusive_ptr_target* self) noexcept {
+    const_cast<intrusive_ptr_target*>(self)->release_resources();
+    drop_weak(self);
+  }
+
+  bool is_owner_of(const intrusive_ptr_target* self) const noexcept {
+    return self->owner_.load(std::memory_order_relaxed) == this;
+  }
+
+  // Merges the queued objects; called by the owning thread.
+  void process_queue() noexcept {
+    while (has_queued.load(std::memory_order_acquire)) {
+      std::vector<const intrusive_ptr_target*> objects;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        objects.swap(queue);
+        has_queued.store(false, std::memory_order_relaxed);
+      }
+      for (auto object : objects) {
+        // The owner may have merged the object since it was queued.
+        if (is_owner_of(object) && merge(object)) {
+          release(object);
+        }
+        drop_weak(object);
+      }
+    }
+  }
+
+  // Takes over the weak reference the caller holds on self.
+  void enqueue(const intrusive_ptr_target* self) noexcept {
+    bool dead = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!exited.load(std::memory_order_relaxed)) {
+        queue.push_back(self);
+        has_queued.store(true, std::memory_order_release);
+        return;
+      }
+      dead = is_owner_of(self) && merge(self);
+    }
+    if (dead) {
+      release(self);
+    }
+    drop_weak(self);
+  }
+
+  void enter() {
+    std::lock_guard<std::mutex> lock(mutex);
+    exited.store(false, std::memory_order_relaxed);
+  }
+
+  void exit() {
+    while (true) {
+      process_queue();
+      std::lock_guard<std::mutex> lock(mutex);
+      // Releasing the queued objects may have queued others.
+      if (queue.empty()) {
+        exited.store(true, std::memory_order_relaxed);
+        return;
+      }
+    }
+  }
+};
+
+namespace {
+
+// Owners whose thread exited, waiting for a new thread to adopt them.
+std::mutex& free_owners_mutex() {
+  static auto* mutex = new std::mutex();
+  return *mutex;
+}
+
+std::vector<BiasedRefcountOwner*>& free_owners() {
+  static auto* owners = new std::vector<BiasedRefcountOwner*>();
+  return *owners;
+}
+
+// Kept separate from ThreadOwner, which has a destructor, so that reading it
+// on every refcount change is a plain thread local load.
+thread_local BiasedRefcountOwner* current_owner = nullptr;
+
+struct ThreadOwner {
+  BiasedRefcountOwner* owner = nullptr;
+  int guard_depth = 0;
+
+  BiasedRefcountOwner* get() {
+    if (!owner) {
+      std::lock_guard<std::mutex> lock(free_owners_mutex());
+      if (free_owners().empty()) {
+        owner = new BiasedRefcountOwner();
+      } else {
+        owner = free_owners().back();
+        free_owners().pop_back();
+      }
+    }
+    return owner;
+  }
+
+  ~ThreadOwner() {
+    if (owner) {
+      std::lock_guard<std::mutex> lock(free_owners_mutex());
+      free_owners().push_back(owner);
+    }
+  }
+};
+
+thread_local ThreadOwner thread_owner;
+
+} // namespace
+
+BiasedRefcountOwner* current_biased_refcount_owner() noexcept {
+  return current_owner;
+}
+
+BiasedRefcountGuard::BiasedRefcountGuard() {
+  if (thread_owner.guard_depth++ == 0) {
+    auto owner = thread_owner.get();
+    owner->enter();
+    current_owner = owner;
+  }
+}
+
+BiasedRefcountGuard::~BiasedRefcountGuard() {
+  if (--thread_owner.guard_depth == 0) {
+    current_owner = nullptr;
+    thread_owner.owner->exit();
+  }
+}
+
+} // namespace impl
+
+bool intrusive_ptr_target::drop_biased_refcount_(
+    impl::BiasedRefcountOwner* owner) const noexcept {
+  bool dead = impl::BiasedRefcountOwner::merge(this);
+  owner->process_queue();
+  return dead;
+}
+
+void intrusive_ptr_target::decref_from_other_thread_(
+    impl::BiasedRefcountOwner* owner) const noexcept {
+  // Keeps the object around in case it has to be queued on its owner.
+  ++weakcount_;
+  int64_t word =
+      refcount_.fetch_sub(kRefcountOne, std::memory_order_acq_rel) -
+      kRefcountOne;
+  // Queue the object if it might be dead, or if its owner exited, so that it
+  // goes back to plain atomic refcounting instead of taking this path again.
+  if (!(word & kMerged) && !(word & kQueued) &&
+      (word < 0 || owner->exited.load(std::memory_order_relaxed)) &&
+      !(refcount_.fetch_or(kQueued, std::memory_order_acq_rel) & kQueued)) {
+    owner->enqueue(this);
+    return;
+  }
+  if (is_dead_(word)) {
+    impl::BiasedRefcountOwner::release(this);
+  }
+  impl::BiasedRefcountOwner::drop_weak(this);
+}
+
+} // namespace c10
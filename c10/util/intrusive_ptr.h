@@ -3,10 +3,17 @@
 #include <c10/util/C++17.h>
 #include <c10/util/Exception.h>
 #include <atomic>
+#include <cstdint>
 #include <stdexcept>
 
 namespace c10 {
 class intrusive_ptr_target;
+namespace impl {
+  struct BiasedRefcountOwner;
+  // The owner of objects created on this thread, while a BiasedRefcountGuard
+  // is active on it; nullptr otherwise.
+  C10_API BiasedRefcountOwner* current_biased_refcount_owner() noexcept;
+}
 namespace raw {
   namespace weak_intrusive_ptr {
     inline void incref(intrusive_ptr_target* self);
@@ -63,8 +70,115 @@ class C10_API intrusive_ptr_target {
   //    atomically increment the use count, if it is greater than 0.
   //    If it is not, you must report that the storage is dead.
   //
-  mutable std::atomic<size_t> refcount_;
-  mutable std::atomic<size_t> weakcount_;
+  // Note [Biased reference counting]
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Most tensors never leave the thread that created them, so paying for an
+  // atomic read-modify-write on every copy is wasted. Objects that opt in via
+  // enable_biased_refcount_() are owned by the thread that created them (if it
+  // holds a BiasedRefcountGuard), and their strong refcount is split in two:
+  //
+  //  - biased_refcount_ is only ever touched by the owner thread, with plain
+  //    loads and stores,
+  //  - refcount_ counts the references taken or dropped by any other thread.
+  //    It may go negative when another thread drops a reference the owner
+  //    took.
+  //
+  // Their sum is the refcount. refcount_ packs the shared count with two
+  // flags: kMerged once the biased count has been folded into it (from then
+  // on the object is counted like any other, with atomics only), and kQueued
+  // once another thread asked the owner to merge.
+  //
+  //  - When the biased count drops to zero, the owner merges it; the object
+  //    dies if the shared count is zero too.
+  //  - When another thread makes the shared count negative, the object may be
+  //    dead without the owner knowing, so it is queued on the owner, which
+  //    merges it the next time it merges anything, or when its guard ends.
+  //  - Once the owner's guard ended, the next thread dropping a reference to
+  //    one of its objects merges it.
+  //
+  // Objects that don't opt in start merged and behave exactly as before.
+  mutable std::atomic<int64_t> refcount_;
+  mutable std::atomic<uint32_t> weakcount_;
+  mutable std::atomic<uint32_t> biased_refcount_;
+  mutable std::atomic<impl::BiasedRefcountOwner*> owner_;
+
+  static constexpr int64_t kMerged = 1;
+  static constexpr int64_t kQueued = 2;
+  static constexpr int64_t kRefcountOne = 4;
+
+  static int64_t shared_refcount_(int64_t word) noexcept {
+    return (word - (word & (kRefcountOne - 1))) / kRefcountOne;
+  }
+
+  static bool is_dead_(int64_t word) noexcept {
+    return (word & ~kQueued) == kMerged;
+  }
+
+  size_t use_count_() const noexcept {
+    int64_t word = refcount_.load(std::memory_order_acquire);
+    int64_t count = shared_refcount_(word);
+    if (!(word & kMerged)) {
+      count += biased_refcount_.load(std::memory_order_relaxed);
+    }
+    return count > 0 ? static_cast<size_t>(count) : 0;
+  }
+
+  bool is_owned_by_current_thread_() const noexcept {
+    auto owner = owner_.load(std::memory_order_relaxed);
+    return owner != nullptr && owner == impl::current_biased_refcount_owner();
+  }
+
+  void incref_() const {
+    if (is_owned_by_current_thread_()) {
+      biased_refcount_.store(
+          biased_refcount_.load(std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
+    } else {
+      int64_t old = refcount_.fetch_add(kRefcountOne, std::memory_order_relaxed);
+      (void)old;
+      TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+          !is_dead_(old),
+          "intrusive_ptr: Cannot increase refcount after it reached zero.");
+    }
+  }
+
+  // Takes the first strong reference of a new object.
+  void init_refcount_() const noexcept {
+    if (is_owned_by_current_thread_()) {
+      biased_refcount_.store(1, std::memory_order_relaxed);
+    } else {
+      refcount_.fetch_add(kRefcountOne, std::memory_order_relaxed);
+    }
+  }
+
+  // Drops a strong reference. Returns true if it was the last one, in which
+  // case the caller releases the resources and the weak reference strong
+  // references hold.
+  bool decref_() const noexcept {
+    auto owner = owner_.load(std::memory_order_relaxed);
+    if (owner == nullptr) {
+      return is_dead_(
+          refcount_.fetch_sub(kRefcountOne, std::memory_order_acq_rel) -
+          kRefcountOne);
+    }
+    if (owner == impl::current_biased_refcount_owner()) {
+      uint32_t biased = biased_refcount_.load(std::memory_order_relaxed) - 1;
+      biased_refcount_.store(biased, std::memory_order_relaxed);
+      return biased == 0 && drop_biased_refcount_(owner);
+    }
+    decref_from_other_thread_(owner);
+    return false;
+  }
+
+  // Called by the owner when the biased count reached zero: merges it, and
+  // the objects other threads queued. Returns true if the object is dead.
+  bool drop_biased_refcount_(impl::BiasedRefcountOwner* owner) const noexcept;
+  // Drops a strong reference of a biased object from a non-owner thread,
+  // queueing the object on its owner if needed, and destroying it if it was
+  // the last reference.
+  void decref_from_other_thread_(impl::BiasedRefcountOwner* owner) const noexcept;
+
+  friend struct impl::BiasedRefcountOwner;
 
   template <typename T, typename NullType>
   friend class intrusive_ptr;
@@ -94,7 +208,7 @@ class C10_API intrusive_ptr_target {
 #  pragma GCC diagnostic ignored "-Wexceptions"
 #endif
     TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
-        refcount_.load() == 0,
+        use_count_() == 0,
         "Tried to destruct an intrusive_ptr_target that still has intrusive_ptr to it");
     TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
         weakcount_.load() == 0,
@@ -106,7 +220,21 @@ class C10_API intrusive_ptr_target {
 #endif
   }
 
-  constexpr intrusive_ptr_target() noexcept : refcount_(0), weakcount_(0) {}
+  constexpr intrusive_ptr_target() noexcept
+      : refcount_(kMerged),
+        weakcount_(0),
+        biased_refcount_(0),
+        owner_(nullptr) {}
+
+  // Opts this object into biased reference counting, see
+  // Note [Biased reference counting]. Must be called from the constructor,
+  // before any intrusive_ptr to the object exists.
+  void enable_biased_refcount_() noexcept {
+    if (auto owner = impl::current_biased_refcount_owner()) {
+      owner_.store(owner, std::memory_order_relaxed);
+      refcount_.store(0, std::memory_order_relaxed);
+    }
+  }
 
   // intrusive_ptr_target supports copy and move: but refcount and weakcount don't
   // participate (since they are intrinsic properties of the memory location)
@@ -133,6 +261,22 @@ class C10_API intrusive_ptr_target {
   virtual void release_resources() {}
 };
 
+namespace impl {
+// While alive, makes the current thread the owner of the objects it creates
+// that opt into biased reference counting (TensorImpl and StorageImpl), see
+// Note [Biased reference counting]. Objects other threads dropped the last
+// reference to are only freed the next time this thread merges a biased
+// refcount, or when the guard ends, so don't keep a guard alive on a thread
+// that stops working, e.g. while it waits on another thread. Guards nest.
+class C10_API BiasedRefcountGuard {
+ public:
+  BiasedRefcountGuard();
+  ~BiasedRefcountGuard();
+  BiasedRefcountGuard(const BiasedRefcountGuard&) = delete;
+  BiasedRefcountGuard& operator=(const BiasedRefcountGuard&) = delete;
+};
+} // namespace impl
+
 namespace detail {
 template <class TTarget>
 struct intrusive_target_default_null_type final {
@@ -184,15 +328,12 @@ class intrusive_ptr final {
 
   void retain_() {
     if (target_ != NullType::singleton()) {
-      size_t new_refcount = ++target_->refcount_;
-      TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
-          new_refcount != 1,
-          "intrusive_ptr: Cannot increase refcount after it reached zero.");
+      target_->incref_();
     }
   }
 
   void reset_() noexcept {
-    if (target_ != NullType::singleton() && --target_->refcount_ == 0) {
+    if (target_ != NullType::singleton() && target_->decref_()) {
       // justification for const_cast: release_resources is basically a destructor
       // and a destructor always mutates the object, even for const objects.
       const_cast<std::remove_const_t<TTarget>*>(target_)->release_resources();
@@ -313,7 +454,7 @@ class intrusive_ptr final {
     if (target_ == NullType::singleton()) {
       return 0;
     }
-    return target_->refcount_.load();
+    return target_->use_count_();
   }
 
   size_t weak_use_count() const noexcept {
@@ -356,7 +497,7 @@ class intrusive_ptr final {
     // We can't use retain_(), because we also have to increase weakcount
     // and because we allow raising these values from 0, which retain_()
     // has an assertion against.
-    ++result.target_->refcount_;
+    result.target_->init_refcount_();
     ++result.target_->weakcount_;
 
     return result;
@@ -370,7 +511,7 @@ class intrusive_ptr final {
   static intrusive_ptr unsafe_reclaim_from_nonowning(TTarget* raw_ptr) {
     // See Note [Stack allocated intrusive_ptr_target safety]
     TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
-        raw_ptr == NullType::singleton() || raw_ptr->refcount_.load() > 0,
+        raw_ptr == NullType::singleton() || raw_ptr->use_count_() > 0,
         "intrusive_ptr: Can only reclaim pointers that are owned by someone");
     auto ptr = reclaim(raw_ptr); // doesn't increase refcount
     ptr.retain_();
@@ -568,7 +709,7 @@ class weak_intrusive_ptr final {
     if (target_ == NullType::singleton()) {
       return 0;
     }
-    return target_->refcount_.load(); // refcount, not weakcount!
+    return target_->use_count_(); // refcount, not weakcount!
   }
 
   size_t weak_use_count() const noexcept {
@@ -583,14 +724,17 @@ class weak_intrusive_ptr final {
   }
 
   intrusive_ptr<TTarget, NullType> lock() const noexcept {
+    // Any thread may take a reference through the shared count, see
+    // Note [Biased reference counting].
     auto refcount = target_->refcount_.load();
     do {
-      if (refcount == 0) {
+      if (intrusive_ptr_target::is_dead_(refcount)) {
         // Object already destructed, no strong references left anymore.
         // Return nullptr.
         return intrusive_ptr<TTarget, NullType>(NullType::singleton());
       }
-    } while (!target_->refcount_.compare_exchange_weak(refcount, refcount + 1));
+    } while (!target_->refcount_.compare_exchange_weak(
+        refcount, refcount + intrusive_ptr_target::kRefcountOne));
     return intrusive_ptr<TTarget, NullType>(target_);
   }
 
@@ -623,7 +767,7 @@ class weak_intrusive_ptr final {
     TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
         owning_weak_ptr == NullType::singleton() ||
         owning_weak_ptr->weakcount_.load() > 1 ||
-            (owning_weak_ptr->refcount_.load() == 0 &&
+            (owning_weak_ptr->use_count_() == 0 &&
              owning_weak_ptr->weakcount_.load() > 0),
         "weak_intrusive_ptr: Can only weak_intrusive_ptr::reclaim() owning pointers that were created using weak_intrusive_ptr::release().");
     return weak_intrusive_ptr(owning_weak_ptr);
@@ -692,7 +836,7 @@ namespace intrusive_ptr {
   // NullType::singleton to this function
   inline void incref(intrusive_ptr_target* self) {
     if (self) {
-      ++self->refcount_;
+      self->incref_();
     }
   }
 
@@ -103,6 +103,16 @@ int GetCurrentNUMANode() {
   return n;
 }
 
+int GetNUMANodeForWorker(size_t index, size_t count) {
+  if (!IsNUMAEnabled()) {
+    return -1;
+  }
+  AT_ASSERT(index < count);
+
+  size_t num_nodes = numa_num_configured_nodes();
+  return static_cast<int>(index * num_nodes / count);
+}
+
 #else // C10_ENABLE_NUMA
 
 bool IsNUMAEnabled() {
@@ -127,6 +137,10 @@ int GetCurrentNUMANode() {
   return -1;
 }
 
+int GetNUMANodeForWorker(size_t index, size_t count) {
+  return -1;
+}
+
 #endif // C10_NUMA_ENABLED
 
 } // namespace c10
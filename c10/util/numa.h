@@ -37,4 +37,11 @@ C10_API void NUMAMove(void* ptr, size_t size, int numa_node_id);
  */
 C10_API int GetCurrentNUMANode();
 
+/**
+ * Get the NUMA node the `index`-th of `count` workers should run on when the
+ * workers are split into contiguous, equally sized groups, one per node.
+ * Returns -1 if NUMA is disabled.
+ */
+C10_API int GetNUMANodeForWorker(size_t index, size_t count);
+
 } // namespace c10
@@ -3,6 +3,8 @@
 #include <mutex>
 #include <sstream>
 
+#include <google/protobuf/io/coded_stream.h>
+
 #include "caffe2/core/blob.h"
 #include "caffe2/utils/proto_utils.h"
 
@@ -26,6 +28,12 @@ C10_DEFINE_bool(
     false,
     "Serialize BOOL, UINT8, INT8, UINT16, INT16, INT64, FLOAT16 tensors using byte_data field instead of int32");
 
+C10_DEFINE_bool(
+    caffe2_serialize_raw_data,
+    false,
+    "Serialize tensors of numeric types as their bytes, in the raw_data field "
+    "with the RAW storage type, instead of in typed fields");
+
 #ifdef _MSC_VER
 // It's MSVC, so we just have to guess ... and allow an override
 #ifdef FOLLY_ENDIAN_BE
@@ -117,6 +125,85 @@ std::string SerializeBlob(const Blob& blob, const string& name) {
   return SerializeBlob(blob.GetRaw(), blob.meta(), name);
 }
 
+static bool EnableRawData(const TensorProto::DataType& dataType) {
+  // raw_data is little-endian.
+  if (!FLAGS_caffe2_serialize_raw_data || !kIsLittleEndian) {
+    return false;
+  }
+  switch (dataType) {
+    case TensorProto_DataType_FLOAT:
+    case TensorProto_DataType_INT32:
+    case TensorProto_DataType_BOOL:
+    case TensorProto_DataType_UINT8:
+    case TensorProto_DataType_INT8:
+    case TensorProto_DataType_UINT16:
+    case TensorProto_DataType_INT16:
+    case TensorProto_DataType_INT64:
+    case TensorProto_DataType_FLOAT16:
+    case TensorProto_DataType_DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Appends the bytes of the elements [chunkBegin, chunkBegin + chunkSize) of
+// input to out.
+static void CopyRawData(
+    const Tensor& input,
+    size_t chunkBegin,
+    size_t chunkSize,
+    BaseContext* context,
+    std::string* out) {
+  const size_t numBytes = chunkSize * input.itemsize();
+  if (numBytes == 0) {
+    return;
+  }
+  const size_t offset = out->size();
+  out->resize(offset + numBytes);
+  context->CopyBytesToCPU(
+      numBytes,
+      static_cast<const char*>(input.raw_data()) + chunkBegin * input.itemsize(),
+      &(*out)[offset]);
+  context->FinishDeviceComputation();
+}
+
+static void AppendVarint(uint64_t value, std::string* out) {
+  using google::protobuf::io::CodedOutputStream;
+  // A varint has 7 bits of the value per byte.
+  uint8_t buffer[10];
+  const uint8_t* end = CodedOutputStream::WriteVarint64ToArray(value, buffer);
+  out->append(reinterpret_cast<const char*>(buffer), end - buffer);
+}
+
+// Appends the elements [chunkBegin, chunkBegin + chunkSize) of input to
+// serialized, a serialized BlobProto, as the raw_data of its tensor. Parsers
+// merge all occurrences of an embedded message field, so this reads as if
+// raw_data was set in the proto, and the data is copied once, from the tensor
+// into the output, rather than into the proto and then into the output.
+static void AppendRawData(
+    const Tensor& input,
+    size_t chunkBegin,
+    size_t chunkSize,
+    std::string* serialized) {
+  using google::protobuf::io::CodedOutputStream;
+  // Tags of length-delimited fields.
+  const uint32_t tensorTag = (BlobProto::kTensorFieldNumber << 3) | 2;
+  const uint32_t rawDataTag = (TensorProto::kRawDataFieldNumber << 3) | 2;
+  const size_t numBytes = chunkSize * input.itemsize();
+  const size_t tensorSize = CodedOutputStream::VarintSize32(rawDataTag) +
+      CodedOutputStream::VarintSize64(numBytes) + numBytes;
+  serialized->reserve(
+      serialized->size() + CodedOutputStream::VarintSize32(tensorTag) +
+      CodedOutputStream::VarintSize64(tensorSize) + tensorSize);
+  AppendVarint(tensorTag, serialized);
+  AppendVarint(tensorSize, serialized);
+  AppendVarint(rawDataTag, serialized);
+  AppendVarint(numBytes, serialized);
+  auto context = CreateContext(input.GetDevice());
+  CopyRawData(input, chunkBegin, chunkSize, context.get(), serialized);
+}
+
 void TensorSerializer::Serialize(
     const void* pointer,
     TypeMeta typeMeta,
@@ -146,11 +233,24 @@ void TensorSerializer::SerializeWithChunkSize(
     blob_proto.set_type(kTensorBlobType);
     TensorProto& proto = *blob_proto.mutable_tensor();
     proto.set_name(name);
-    this->Serialize(
-        tensor, name, blob_proto.mutable_tensor(), chunkStart, chunk_size);
+    this->SerializeChunk(
+        tensor,
+        name,
+        blob_proto.mutable_tensor(),
+        chunkStart,
+        chunk_size,
+        /* withRawData */ false);
+    std::string serialized = SerializeBlobProtoAsString_EnforceCheck(blob_proto);
+    if (proto.storage_type() == TensorProto_StorageType_RAW) {
+      AppendRawData(
+          tensor,
+          proto.segment().begin(),
+          proto.segment().end() - proto.segment().begin(),
+          &serialized);
+    }
     acceptor(
         c10::str(name, kChunkIdSeparator, chunkStart / chunk_size),
-        SerializeBlobProtoAsString_EnforceCheck(blob_proto));
+        serialized);
   };
 
 #ifndef __ANDROID__
@@ -164,8 +264,12 @@ void TensorSerializer::SerializeWithChunkSize(
   };
   std::vector<std::future<void>> futures;
   if (tensor.numel() > chunk_size) {
-    futures.reserve(FLAGS_caffe2_max_tensor_serializer_threads);
-    for (int i = 0; i < FLAGS_caffe2_max_tensor_serializer_threads; ++i) {
+    // No more threads than chunks.
+    const int numThreads = std::min<int64_t>(
+        FLAGS_caffe2_max_tensor_serializer_threads,
+        (tensor.numel() + chunk_size - 1) / chunk_size);
+    futures.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
       futures.emplace_back(std::async(std::launch::async, task));
     }
   }
@@ -250,6 +354,17 @@ void TensorSerializer::Serialize(
     TensorProto* proto_ptr,
     size_t chunkBegin,
     int32_t chunkSize) {
+  SerializeChunk(
+      input, name, proto_ptr, chunkBegin, chunkSize, /* withRawData */ true);
+}
+
+void TensorSerializer::SerializeChunk(
+    const Tensor& input,
+    const string& name,
+    TensorProto* proto_ptr,
+    size_t chunkBegin,
+    int32_t chunkSize,
+    bool withRawData) {
   CAFFE_ENFORCE(
       chunkBegin <= input.numel(),
       "Chunk begin is out of tensor: ",
@@ -287,6 +402,14 @@ void TensorSerializer::Serialize(
   // TODO: use CUDAGuard here instead of context and employ explicit sync
   // copy
   auto uniq_ptr = CreateContext(input.GetDevice());
+  if (EnableRawData(data_type)) {
+    proto.set_storage_type(TensorProto_StorageType_RAW);
+    if (withRawData) {
+      CopyRawData(
+          input, chunkBegin, chunkSize, uniq_ptr.get(), proto.mutable_raw_data());
+    }
+    return;
+  }
   // A lot of copypaste is error prone. Should we create a macro for this?
   switch (data_type) {
     case TensorProto_DataType_FLOAT:
@@ -573,6 +696,28 @@ void TensorDeserializer::DeserializeToTensor(
       tensor->numel());
   auto chunkSize = chunkEnd - chunkBegin;
 
+  if (tensor_proto.storage_type() == TensorProto_StorageType_RAW) {
+    CAFFE_ENFORCE(
+        kIsLittleEndian || tensor->itemsize() == 1,
+        "Serialization with raw data not supported on big endian platform.");
+    CAFFE_ENFORCE(
+        tensor->dtype().copy() == nullptr,
+        "Raw data is only supported for numeric types, got ",
+        tensor->dtype().name());
+    const size_t numBytes = chunkSize * tensor->itemsize();
+    CAFFE_ENFORCE_EQ(
+        numBytes, tensor_proto.raw_data().size(), "Incorrect proto field size.");
+    if (numBytes > 0) {
+      context->CopyBytesFromCPU(
+          numBytes,
+          tensor_proto.raw_data().data(),
+          static_cast<char*>(tensor->raw_mutable_data(tensor->dtype())) +
+              chunkBegin * tensor->itemsize());
+    }
+    context->FinishDeviceComputation();
+    return;
+  }
+
   switch (tensor_proto.data_type()) {
     case TensorProto_DataType_FLOAT:
       detail::CopyFromProtoAsIs(
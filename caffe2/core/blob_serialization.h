@@ -16,6 +16,7 @@
 C10_DECLARE_int(caffe2_tensor_chunk_size);
 C10_DECLARE_int(caffe2_max_tensor_serializer_threads);
 C10_DECLARE_bool(caffe2_serialize_fp16_as_bytes);
+C10_DECLARE_bool(caffe2_serialize_raw_data);
 
 namespace caffe2 {
 
@@ -111,6 +112,16 @@ class CAFFE2_API TensorSerializer : public BlobSerializerBase {
       int32_t chunkSize);
 
  private:
+  // Serializes a chunk of the tensor into proto. Chunks with the RAW storage
+  // type get their raw_data only withRawData, so that SerializeWithChunkSize
+  // can write the bytes straight into the serialized BlobProto.
+  void SerializeChunk(
+      const Tensor& tensor,
+      const string& name,
+      TensorProto* proto,
+      size_t chunkBegin,
+      int32_t chunkSize,
+      bool withRawData);
   // A utility function to store the device context detauls.
   void StoreDeviceDetail(const Tensor& input, TensorProto* proto);
   unique_ptr<BaseContext> context_;
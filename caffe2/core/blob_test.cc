@@ -1,4 +1,5 @@
 #include <iostream>
+#include <map>
 #include <memory>
 #include <mutex>
 
@@ -23,6 +24,7 @@ C10_DEFINE_int64(caffe2_test_big_tensor_size, 100000000, "");
 C10_DECLARE_int(caffe2_tensor_chunk_size);
 C10_DECLARE_bool(caffe2_serialize_fp16_as_bytes);
 C10_DECLARE_bool(caffe2_serialize_using_bytes_as_holder);
+C10_DECLARE_bool(caffe2_serialize_raw_data);
 
 namespace caffe2 {
 using namespace ::caffe2::db;
@@ -1262,5 +1264,70 @@ TEST(TensorSerialization, TestCorrectness) {
       caffe2::TensorProto_DataType_FLOAT16, "TensorProto_DataType_FLOAT16");
 }
 
+template <typename T>
+void TestRawDataSerialization() {
+  FLAGS_caffe2_serialize_raw_data = true;
+  constexpr int kSize = 2500;
+  constexpr int kChunkSize = 1000;
+  Blob blob;
+  TensorCPU* tensor = BlobGetMutableTensor(&blob, CPU);
+  tensor->Resize(5, kSize / 5);
+  for (int i = 0; i < kSize; ++i) {
+    tensor->mutable_data<T>()[i] = static_cast<T>(i % 100);
+  }
+
+  // The chunks hold the bytes of their part of the tensor.
+  std::mutex mutex;
+  std::map<std::string, std::string> chunks;
+  auto acceptor = [&](const std::string& key, const std::string& value) {
+    std::lock_guard<std::mutex> guard(mutex);
+    chunks[key] = value;
+  };
+  SerializeBlob(blob, "test", acceptor, kChunkSize);
+  EXPECT_EQ(chunks.size(), 3u);
+  Blob new_blob;
+  TensorCPU* new_tensor = BlobGetMutableTensor(
+      &new_blob, {5, kSize / 5}, at::dtype<T>().device(CPU));
+  for (const auto& chunk : chunks) {
+    BlobProto proto;
+    CHECK(proto.ParseFromString(chunk.second));
+    const TensorProto& tensor_proto = proto.tensor();
+    EXPECT_EQ(tensor_proto.name(), "test");
+    EXPECT_EQ(tensor_proto.storage_type(), TensorProto_StorageType_RAW);
+    EXPECT_EQ(tensor_proto.dims_size(), 2);
+    const auto begin = tensor_proto.segment().begin();
+    const auto end = tensor_proto.segment().end();
+    EXPECT_EQ(tensor_proto.raw_data().size(), (end - begin) * sizeof(T));
+    EXPECT_EQ(
+        0,
+        memcmp(
+            tensor_proto.raw_data().data(),
+            tensor->data<T>() + begin,
+            tensor_proto.raw_data().size()));
+    TensorDeserializer().DeserializeToTensor(tensor_proto, new_tensor);
+  }
+  for (int i = 0; i < kSize; ++i) {
+    EXPECT_EQ(new_tensor->data<T>()[i], tensor->data<T>()[i]);
+  }
+
+  // Unchunked protos go through the same proto fields.
+  Blob unchunked_blob;
+  DeserializeBlob(SerializeBlob(blob, "test"), &unchunked_blob);
+  const auto& unchunked_tensor = unchunked_blob.Get<TensorCPU>();
+  EXPECT_EQ(unchunked_tensor.sizes(), tensor->sizes());
+  for (int i = 0; i < kSize; ++i) {
+    EXPECT_EQ(unchunked_tensor.data<T>()[i], tensor->data<T>()[i]);
+  }
+  FLAGS_caffe2_serialize_raw_data = false;
+}
+
+TEST(TensorSerialization, RawData) {
+  TestRawDataSerialization<float>();
+  TestRawDataSerialization<double>();
+  TestRawDataSerialization<int>();
+  TestRawDataSerialization<int64_t>();
+  TestRawDataSerialization<uint8_t>();
+}
+
 } // namespace
 } // namespace caffe2
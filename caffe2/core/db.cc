@@ -77,6 +77,11 @@ class MiniDBCursor : public Cursor {
     return string(value_.data(), value_len_);
   }
 
+  c10::string_view value_view() override {
+    CAFFE_ENFORCE(valid_, "Cursor is at invalid location!");
+    return c10::string_view(value_.data(), value_len_);
+  }
+
   bool Valid() override { return valid_; }
 
  private:
@@ -171,6 +176,133 @@ class MiniDB : public DB {
 REGISTER_CAFFE2_DB(MiniDB, MiniDB);
 REGISTER_CAFFE2_DB(minidb, MiniDB);
 
+PrefetchingCursor::PrefetchingCursor(
+    std::unique_ptr<Cursor> cursor,
+    size_t capacity)
+    : cursor_(std::move(cursor)), ring_(capacity) {
+  CAFFE_ENFORCE(cursor_, "Passed null cursor");
+  CAFFE_ENFORCE_GT(capacity, 0);
+  Start();
+}
+
+PrefetchingCursor::~PrefetchingCursor() {
+  Stop();
+}
+
+void PrefetchingCursor::Start() {
+  consumed_ = 0;
+  read_ = 0;
+  done_ = false;
+  stop_ = false;
+  error_ = nullptr;
+  thread_ = std::thread([this] { ReadAhead(); });
+}
+
+void PrefetchingCursor::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_consumed_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void PrefetchingCursor::ReadAhead() {
+  try {
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_consumed_.wait(
+            lock, [this] { return stop_ || read_ - consumed_ < ring_.size(); });
+        if (stop_) {
+          return;
+        }
+      }
+      if (!cursor_->Valid()) {
+        break;
+      }
+      // The slot is free until read_ is incremented, and only this thread
+      // changes read_, so the entry is filled without holding the mutex.
+      auto& entry = ring_[read_ % ring_.size()];
+      entry.key = cursor_->key();
+      const auto value = cursor_->value_view();
+      entry.value.assign(value.data(), value.size());
+      cursor_->Next();
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++read_;
+      }
+      cv_read_.notify_one();
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_ = std::current_exception();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ = true;
+  }
+  cv_read_.notify_one();
+}
+
+bool PrefetchingCursor::WaitForCurrent(std::unique_lock<std::mutex>& lock) {
+  cv_read_.wait(lock, [this] { return consumed_ < read_ || done_; });
+  if (consumed_ < read_) {
+    return true;
+  }
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  return false;
+}
+
+void PrefetchingCursor::Seek(const string& key) {
+  Stop();
+  cursor_->Seek(key);
+  Start();
+}
+
+void PrefetchingCursor::SeekToFirst() {
+  Stop();
+  cursor_->SeekToFirst();
+  Start();
+}
+
+void PrefetchingCursor::Next() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    CAFFE_ENFORCE(WaitForCurrent(lock), "Cursor is at invalid location!");
+    ++consumed_;
+  }
+  cv_consumed_.notify_one();
+}
+
+string PrefetchingCursor::key() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  CAFFE_ENFORCE(WaitForCurrent(lock), "Cursor is at invalid location!");
+  return ring_[consumed_ % ring_.size()].key;
+}
+
+string PrefetchingCursor::value() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  CAFFE_ENFORCE(WaitForCurrent(lock), "Cursor is at invalid location!");
+  return ring_[consumed_ % ring_.size()].value;
+}
+
+c10::string_view PrefetchingCursor::value_view() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  CAFFE_ENFORCE(WaitForCurrent(lock), "Cursor is at invalid location!");
+  // The background thread doesn't reuse the slot before the cursor moves.
+  return ring_[consumed_ % ring_.size()].value;
+}
+
+bool PrefetchingCursor::Valid() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return WaitForCurrent(lock);
+}
+
 void DBReaderSerializer::Serialize(
     const void* pointer,
     TypeMeta typeMeta,
@@ -1,9 +1,13 @@
 #ifndef CAFFE2_CORE_DB_H_
 #define CAFFE2_CORE_DB_H_
 
+#include <condition_variable>
+#include <exception>
 #include <mutex>
+#include <thread>
 
 #include "c10/util/Registry.h"
+#include "c10/util/string_view.h"
 #include "caffe2/core/blob_serialization.h"
 #include "caffe2/proto/caffe2_pb.h"
 
@@ -46,6 +50,16 @@ class CAFFE2_API Cursor {
    * Returns the current value.
    */
   virtual string value() = 0;
+  /**
+   * Returns a view of the current value, which stays valid until the cursor
+   * moves. Dbs that keep their values in memory, like the mmap'd LMDB, return
+   * them without a copy; by default, the value is copied into a buffer of the
+   * cursor.
+   */
+  virtual c10::string_view value_view() {
+    value_buffer_ = value();
+    return value_buffer_;
+  }
   /**
    * Returns whether the current location is valid - for example, if we have
    * reached the end of the database, return false.
@@ -53,6 +67,63 @@ class CAFFE2_API Cursor {
   virtual bool Valid() = 0;
 
   C10_DISABLE_COPY_AND_ASSIGN(Cursor);
+
+ private:
+  string value_buffer_;
+};
+
+/**
+ * A cursor that reads the entries of another cursor ahead, in a background
+ * thread, into a ring of `capacity` entries. Moving the cursor then only takes
+ * the next entry of the ring, so readers no longer wait for the db, and the
+ * values are copied out of the db off their thread.
+ *
+ * Seek() and SeekToFirst() stop the background thread, move the wrapped
+ * cursor and start reading ahead again. Errors of the wrapped cursor are
+ * rethrown when the reader gets to the entry that failed.
+ */
+class CAFFE2_API PrefetchingCursor : public Cursor {
+ public:
+  PrefetchingCursor(std::unique_ptr<Cursor> cursor, size_t capacity);
+  ~PrefetchingCursor() override;
+
+  void Seek(const string& key) override;
+  bool SupportsSeek() override {
+    return cursor_->SupportsSeek();
+  }
+  void SeekToFirst() override;
+  void Next() override;
+  string key() override;
+  string value() override;
+  c10::string_view value_view() override;
+  bool Valid() override;
+
+ private:
+  struct Entry {
+    string key;
+    string value;
+  };
+
+  void Start();
+  void Stop();
+  void ReadAhead();
+  // Waits until the current entry is read, or the wrapped cursor is done, and
+  // returns whether there is a current entry.
+  bool WaitForCurrent(std::unique_lock<std::mutex>& lock);
+
+  std::unique_ptr<Cursor> cursor_;
+  std::vector<Entry> ring_;
+  std::mutex mutex_;
+  std::condition_variable cv_read_;
+  std::condition_variable cv_consumed_;
+  // The number of entries consumed, and read, since the last seek. The
+  // current entry is ring_[consumed_ % ring_.size()].
+  size_t consumed_{0};
+  size_t read_{0};
+  bool done_{false};
+  bool stop_{false};
+  std::exception_ptr error_;
+  std::thread thread_;
 };
 
 /**
@@ -151,8 +222,9 @@ class CAFFE2_API DBReader {
       const string& db_type,
       const string& source,
       const int32_t num_shards = 1,
-      const int32_t shard_id = 0) {
-    Open(db_type, source, num_shards, shard_id);
+      const int32_t shard_id = 0,
+      const size_t prefetch_size = 0) {
+    Open(db_type, source, num_shards, shard_id, prefetch_size);
   }
 
   explicit DBReader(const DBReaderProto& proto) {
@@ -175,11 +247,16 @@ class CAFFE2_API DBReader {
     cursor_ = db_->NewCursor();
   }
 
+  /**
+   * Opens the db. With a prefetch_size, a background thread reads up to that
+   * many entries ahead, see PrefetchingCursor.
+   */
   void Open(
       const string& db_type,
       const string& source,
       const int32_t num_shards = 1,
-      const int32_t shard_id = 0) {
+      const int32_t shard_id = 0,
+      const size_t prefetch_size = 0) {
     // Note(jiayq): resetting is needed when we re-open e.g. leveldb where no
     // concurrent access is allowed.
     cursor_.reset();
@@ -194,18 +271,19 @@ class CAFFE2_API DBReader {
         " (while trying to open ",
         source_,
         ")");
-    InitializeCursor(num_shards, shard_id);
+    InitializeCursor(num_shards, shard_id, prefetch_size);
   }
 
   void Open(
       unique_ptr<DB>&& db,
       const int32_t num_shards = 1,
-      const int32_t shard_id = 0) {
+      const int32_t shard_id = 0,
+      const size_t prefetch_size = 0) {
     cursor_.reset();
     db_.reset();
     db_ = std::move(db);
     CAFFE_ENFORCE(db_.get(), "Passed null db");
-    InitializeCursor(num_shards, shard_id);
+    InitializeCursor(num_shards, shard_id, prefetch_size);
   }
 
  public:
@@ -229,7 +307,9 @@ class CAFFE2_API DBReader {
     CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
     std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
     *key = cursor_->key();
-    *value = cursor_->value();
+    // Reuses the space of the caller's string.
+    const auto value_view = cursor_->value_view();
+    value->assign(value_view.data(), value_view.size());
 
     // In sharded mode, each read skips num_shards_ records
     for (uint32_t s = 0; s < num_shards_; s++) {
@@ -264,13 +344,20 @@ class CAFFE2_API DBReader {
   }
 
  private:
-  void InitializeCursor(const int32_t num_shards, const int32_t shard_id) {
+  void InitializeCursor(
+      const int32_t num_shards,
+      const int32_t shard_id,
+      const size_t prefetch_size) {
     CAFFE_ENFORCE(num_shards >= 1);
     CAFFE_ENFORCE(shard_id >= 0);
     CAFFE_ENFORCE(shard_id < num_shards);
     num_shards_ = num_shards;
     shard_id_ = shard_id;
     cursor_ = db_->NewCursor();
+    if (prefetch_size > 0) {
+      cursor_ = std::unique_ptr<Cursor>(
+          new PrefetchingCursor(std::move(cursor_), prefetch_size));
+    }
     SeekToFirst();
   }
 
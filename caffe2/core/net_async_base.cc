@@ -21,6 +21,12 @@ C10_DEFINE_bool(
     false,
     "If set, profile operators of the net regardless of net being prof_dag.");
 
+C10_DEFINE_bool(
+    caffe2_net_async_priority_scheduling,
+    false,
+    "If set, run ready tasks with the longest remaining path through the net "
+    "first instead of in FIFO order");
+
 C10_DEFINE_int(
     caffe2_net_async_max_gpus,
     16,
@@ -86,6 +92,7 @@ AsyncNetBase::AsyncNetBase(
     chains_.push_back(kv.second);
   }
   chain_nodes_ = dag_utils::prepareChainGraphNodes(operator_nodes_, chains_);
+  updateTaskPriorities();
 
   events_.reserve(chains_.size());
   for (const auto& chain : chains_) {
@@ -318,6 +325,55 @@ int AsyncNetBase::numOps(int task_id) const {
   return chains_[task_id].size();
 }
 
+float AsyncNetBase::taskPriority(int task_id) const {
+  return task_priorities_[task_id];
+}
+
+// The priority of a task is the cost of the longest path from its start to
+// the end of the net, i.e. the least time the rest of the net needs once the
+// task starts; running the tasks of the critical path first keeps long chains
+// from waiting behind many short independent tasks. The cost of an op is its
+// mean time over the runs profiled so far (see ProfDAGCounters), or 1 while
+// no profile is available.
+void AsyncNetBase::updateTaskPriorities() {
+  std::vector<float> op_costs;
+  if (options_.report_stats_) {
+    op_costs = counters_.GetMeanOpTimes();
+  }
+
+  // Visit the tasks in reverse topological order, so that the priorities of
+  // all children of a task are known when it is visited
+  const int num_tasks = tasksNum();
+  task_priorities_.assign(num_tasks, 0.0f);
+  std::vector<int> pending_children(num_tasks);
+  std::vector<int> ready_tasks;
+  for (int task_id = 0; task_id < num_tasks; ++task_id) {
+    pending_children[task_id] = children(task_id).size();
+    if (pending_children[task_id] == 0) {
+      ready_tasks.push_back(task_id);
+    }
+  }
+  while (!ready_tasks.empty()) {
+    const int task_id = ready_tasks.back();
+    ready_tasks.pop_back();
+    float cost = 0.0f;
+    for (auto op_id : chains_[task_id]) {
+      cost += op_costs.empty() ? 1.0f : op_costs[op_id];
+    }
+    float longest_child_path = 0.0f;
+    for (auto child_id : children(task_id)) {
+      longest_child_path =
+          std::max(longest_child_path, task_priorities_[child_id]);
+    }
+    task_priorities_[task_id] = cost + longest_child_path;
+    for (auto parent_id : parents(task_id)) {
+      if (--pending_children[parent_id] == 0) {
+        ready_tasks.push_back(parent_id);
+      }
+    }
+  }
+}
+
 int AsyncNetBase::firstTaskOpId(int task_id) const {
   return chains_[task_id].front();
 }
@@ -588,6 +644,7 @@ ExecutionOptions::ExecutionOptions(
   }
 
   use_dfs_scheduling_ = false;
+  use_priority_scheduling_ = FLAGS_caffe2_net_async_priority_scheduling;
 
   for (int arg_idx = 0; arg_idx < net_def->arg_size(); ++arg_idx) {
     auto& arg = net_def->arg(arg_idx);
@@ -595,6 +652,10 @@ ExecutionOptions::ExecutionOptions(
       CAFFE_ENFORCE(arg.has_i(), "enable_profiling should be an int");
       report_stats_ = arg.i() == 1;
     }
+    if (arg.has_name() && arg.name() == "priority_scheduling") {
+      CAFFE_ENFORCE(arg.has_i(), "priority_scheduling should be an int");
+      use_priority_scheduling_ = arg.i() == 1;
+    }
     if (arg.has_name() && arg.name() == "deferrable_mode") {
       CAFFE_ENFORCE(arg.has_i(), "deferrable_mode should be an int");
       use_dfs_scheduling_ = arg.i() == 1; // corr. to DFS scheduling
@@ -24,6 +24,7 @@ C10_DECLARE_bool(caffe2_net_async_use_single_pool);
 C10_DECLARE_bool(caffe2_net_async_use_per_net_pools);
 C10_DECLARE_bool(caffe2_net_async_run_root_tasks_inline);
 C10_DECLARE_bool(caffe2_net_async_profile_operators);
+C10_DECLARE_bool(caffe2_net_async_priority_scheduling);
 
 namespace caffe2 {
 
@@ -55,6 +56,9 @@ struct ExecutionOptions {
   bool use_dfs_scheduling_ = false;
   // run net's root tasks in RunAsync thread instead of in thread pool
   bool run_root_tasks_inline_ = false;
+  // run ready tasks in the order of their critical path priority instead of
+  // the order in which they became ready
+  bool use_priority_scheduling_ = false;
 };
 
 struct CAFFE2_API AsyncNetCancelled : public std::exception {
@@ -82,6 +86,10 @@ class CAFFE2_API AsyncNetBase : public NetBase {
     return execution_chains_;
   }
 
+  const std::vector<float>& TEST_task_priorities() const {
+    return task_priorities_;
+  }
+
   ProfDAGProtos GetOperatorStats() const;
   ProfDAGProtos GetPerOperatorCost() const;
   ProfDAGReport GetProfReport() const;
@@ -102,6 +110,8 @@ class CAFFE2_API AsyncNetBase : public NetBase {
   int getParentCount(int child_id);
   bool testAndSetScheduled(int task_id);
   int numOps(int task_id) const;
+  float taskPriority(int task_id) const;
+  void updateTaskPriorities();
 
   int firstTaskOpId(int task_id) const;
   int lastTaskOpId(int task_id) const;
@@ -134,6 +144,8 @@ class CAFFE2_API AsyncNetBase : public NetBase {
   std::vector<std::vector<int>> chains_;
   std::vector<dag_utils::OpGraphNode> chain_nodes_; // chains' parents/children
   dag_utils::ExecutionChains execution_chains_; // for testing
+  // Critical path priority of every task, see updateTaskPriorities
+  std::vector<float> task_priorities_;
 
   // Pools and streams
   std::mutex pools_mutex_;
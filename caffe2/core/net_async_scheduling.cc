@@ -2,6 +2,8 @@
 
 #include "caffe2/core/net_async_tracing.h"
 
+#include <algorithm>
+
 namespace caffe2 {
 
 AsyncSchedulingNet::AsyncSchedulingNet(
@@ -174,8 +176,55 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
     schedule_func();
   } else {
     const auto& device_option = event(task_id).GetDeviceOption();
-    pool(device_option)->run(schedule_func);
+    runInPool(pool(device_option), task_id, std::move(schedule_func));
+  }
+}
+
+void AsyncSchedulingNet::runInPool(
+    TaskThreadPoolBase* task_pool,
+    int task_id,
+    std::function<void()> task) {
+  if (!options_.use_priority_scheduling_) {
+    task_pool->run(std::move(task));
+    return;
+  }
+  ReadyQueue* ready_queue = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(ready_queues_mutex_);
+    auto& queue = ready_queues_[task_pool];
+    if (!queue) {
+      queue = std::make_unique<ReadyQueue>();
+    }
+    ready_queue = queue.get();
   }
+  ready_queue->push(taskPriority(task_id), std::move(task));
+  task_pool->run([ready_queue]() { ready_queue->pop()(); });
+}
+
+bool AsyncSchedulingNet::ReadyQueue::lowerPriority(
+    const Entry& lhs,
+    const Entry& rhs) {
+  if (lhs.priority != rhs.priority) {
+    return lhs.priority < rhs.priority;
+  }
+  return lhs.seq > rhs.seq;
+}
+
+void AsyncSchedulingNet::ReadyQueue::push(
+    float priority,
+    std::function<void()> task) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  heap_.push_back(Entry{priority, next_seq_++, std::move(task)});
+  std::push_heap(heap_.begin(), heap_.end(), &ReadyQueue::lowerPriority);
+}
+
+std::function<void()> AsyncSchedulingNet::ReadyQueue::pop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CAFFE_ENFORCE(!heap_.empty(), "No ready task to run");
+  std::pop_heap(heap_.begin(), heap_.end(), &ReadyQueue::lowerPriority);
+  auto task = std::move(heap_.back().task);
+  heap_.pop_back();
+  return task;
 }
 
 void AsyncSchedulingNet::parentCallback(int parent_id) {
@@ -217,6 +266,10 @@ void AsyncSchedulingNet::finishRun() {
   finalizeEvents();
   if (options_.report_stats_) {
     counters_.ReportRunEnd();
+    if (options_.use_priority_scheduling_) {
+      // weigh the next runs' priorities by the op times profiled so far
+      updateTaskPriorities();
+    }
   }
   // notify observers and waiters
   StopAllObservers();
@@ -28,6 +28,37 @@ class CAFFE2_API AsyncSchedulingNet : public AsyncNetBase {
 
   void CancelAndFinishAsyncTasks();
 
+  // Tasks that are ready to run in one pool, for priority scheduling. Every
+  // task pushed to the queue is matched by one job submitted to the pool,
+  // which runs the ready task of the highest priority at the time it starts,
+  // so the pool itself can stay FIFO.
+  class ReadyQueue {
+   public:
+    void push(float priority, std::function<void()> task);
+    std::function<void()> pop();
+
+   private:
+    struct Entry {
+      float priority;
+      uint64_t seq;
+      std::function<void()> task;
+    };
+    static bool lowerPriority(const Entry& lhs, const Entry& rhs);
+
+    std::mutex mutex_;
+    // max-heap by priority, in FIFO order for equal priorities
+    std::vector<Entry> heap_;
+    uint64_t next_seq_ = 0;
+  };
+  void runInPool(
+      TaskThreadPoolBase* task_pool,
+      int task_id,
+      std::function<void()> task);
+
+  std::mutex ready_queues_mutex_;
+  std::unordered_map<TaskThreadPoolBase*, std::unique_ptr<ReadyQueue>>
+      ready_queues_;
+
   std::mutex running_mutex_;
   std::condition_variable running_cv_;
   std::atomic<bool> running_;
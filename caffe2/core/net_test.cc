@@ -617,6 +617,57 @@ TEST(NetTest, OperatorWithExecutorHelper) {
   ASSERT_TRUE(net->Run());
 }
 
+TEST(NetTest, PriorityScheduling) {
+  const auto spec = R"DOC(
+        name: "example"
+        type: "async_scheduling"
+        external_input: "in"
+        arg {
+          name: "priority_scheduling"
+          i: 1
+        }
+        op {
+          input: "in"
+          output: "hidden1"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "hidden1"
+          output: "hidden2"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "hidden2"
+          output: "out1"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "in"
+          output: "out2"
+          type: "NetTestDummy"
+        }
+)DOC";
+
+  Workspace ws;
+  ws.CreateBlob("in");
+  NetDef net_def;
+  CAFFE_ENFORCE(TextFormat::ParseFromString(spec, &net_def));
+  net_def.set_num_workers(kTestPoolSize);
+  std::unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  auto* async_net = dynamic_cast_if_rtti<AsyncNetBase*>(net.get());
+  CHECK_NOTNULL(async_net);
+
+  // Without profiles every op costs 1, so the task starting the chain of
+  // three ops has the longest path to the end of the net, and the task of
+  // the independent op the shortest.
+  const auto& priorities = async_net->TEST_task_priorities();
+  ASSERT_FALSE(priorities.empty());
+  EXPECT_EQ(*std::max_element(priorities.begin(), priorities.end()), 3.0f);
+  EXPECT_EQ(*std::min_element(priorities.begin(), priorities.end()), 1.0f);
+
+  testExecution(net, net_def.op().size());
+}
+
 TEST(NetTest, DISABLED_OperatorWithDisabledEvent) {
   const auto spec = R"DOC(
         name: "example"
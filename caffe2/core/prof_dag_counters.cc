@@ -124,6 +124,18 @@ ProfDAGReport ProfDAGCounters::GetReport() const {
   return report_;
 }
 
+std::vector<float> ProfDAGCounters::GetMeanOpTimes() const {
+  std::vector<float> mean_op_times;
+  if (!report_.hasStats()) {
+    return mean_op_times;
+  }
+  mean_op_times.reserve(report_.time_per_op_total_.size());
+  for (const auto& stats : report_.time_per_op_total_) {
+    mean_op_times.push_back(stats.sum() / stats.cnt());
+  }
+  return mean_op_times;
+}
+
 bool ProfDAGReport::hasStats() const {
   return runtime_stats_.cnt() > 0;
 }
@@ -105,6 +105,10 @@ class ProfDAGCounters {
   void AddPerOpAsyncEndTime(size_t op_id);
   ProfDAGReport GetReport() const;
 
+  // The mean execution time of every operator over the runs profiled so
+  // far, or an empty vector if no run was profiled yet
+  std::vector<float> GetMeanOpTimes() const;
+
  private:
   Timer timer_;
 
@@ -155,6 +155,26 @@ TEST(DBReaderTest, Reader) {
   EXPECT_EQ(keys_set.size(), kMaxItems);
 }
 
+TEST(PrefetchingCursorTest, LevelDB) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+  std::unique_ptr<DB> db(CreateDB("leveldb", name, READ));
+  // A ring smaller than the db, so that reading ahead wraps around it.
+  PrefetchingCursor cursor(db->NewCursor(), 3);
+  TestCursor(&cursor);
+  cursor.SeekToFirst();
+  for (int i = 0; i < kMaxItems; ++i) {
+    std::stringstream ss;
+    ss << std::setw(2) << std::setfill('0') << i;
+    ASSERT_TRUE(cursor.Valid());
+    EXPECT_EQ(cursor.key(), ss.str());
+    const auto value = cursor.value_view();
+    EXPECT_EQ(string(value.data(), value.size()), ss.str());
+    cursor.Next();
+  }
+  EXPECT_FALSE(cursor.Valid());
+}
+
 TEST(DBReaderShardedTest, Reader) {
   std::string name = std::tmpnam(nullptr);
   CreateAndFill("leveldb", name);
@@ -198,6 +218,17 @@ TEST(DBReaderShardedTest, Reader) {
   reader2->Read(&key, &value);
   EXPECT_EQ(key, "05");
   EXPECT_EQ(value, "05");
+
+  // Prefetching readers return the same entries, and wrap around the same
+  // way.
+  CreateAndFill("leveldb", name + "3");
+  std::unique_ptr<DBReader> reader3(new DBReader(
+      "leveldb", name + "3", 3, 1, /*prefetch_size=*/2));
+  for (const string expected : {"01", "04", "07", "01", "04"}) {
+    reader3->Read(&key, &value);
+    EXPECT_EQ(key, expected);
+    EXPECT_EQ(value, expected);
+  }
 }
 
 } // namespace db
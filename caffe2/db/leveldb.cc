@@ -25,6 +25,10 @@ class LevelDBCursor : public Cursor {
   void Next() override { iter_->Next(); }
   string key() override { return iter_->key().ToString(); }
   string value() override { return iter_->value().ToString(); }
+  c10::string_view value_view() override {
+    const leveldb::Slice value = iter_->value();
+    return c10::string_view(value.data(), value.size());
+  }
   bool Valid() override { return iter_->Valid(); }
 
  private:
@@ -68,6 +68,13 @@ class LMDBCursor : public Cursor {
         mdb_value_.mv_size);
   }
 
+  // The value lives in the memory map of the db, which the read-only
+  // transaction of the cursor keeps valid.
+  c10::string_view value_view() override {
+    return c10::string_view(
+        static_cast<const char*>(mdb_value_.mv_data), mdb_value_.mv_size);
+  }
+
   bool Valid() override { return valid_; }
 
  private:
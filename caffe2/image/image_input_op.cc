@@ -128,7 +128,9 @@ The dimension of the output image will always be cropxcrop
     .Arg("use_caffe_datum", "1 if the input is in Caffe format. Defaults to 0")
     .Arg(
         "use_gpu_transform",
-        "1 if GPU acceleration should be used."
+        "1 if GPU acceleration should be used: images are decoded and"
+        " cropped on CPU, and color jitter, color lighting and normalization"
+        " are applied on GPU."
         " Defaults to 0. Can only be 1 in a CUDAContext")
     .Arg(
         "decode_threads",
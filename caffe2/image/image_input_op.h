@@ -89,6 +89,7 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   void DecodeAndTransposeOnly(
       const std::string& value,
       uint8_t* image_data,
+      ColorParams* color_params,
       int item_id,
       const int channels,
       std::size_t thread_index);
@@ -104,6 +105,9 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   Tensor prefetched_image_on_device_;
   Tensor prefetched_label_on_device_;
   vector<Tensor> prefetched_additional_outputs_on_device_;
+  // The color augmentation of every image, for the GPU transform to apply.
+  Tensor prefetched_color_params_;
+  Tensor prefetched_color_params_on_device_;
   // Default parameters for images
   PerImageArg default_arg_;
   int batch_size_;
@@ -135,6 +139,8 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   bool is_test_;
   bool use_caffe_datum_;
   bool gpu_transform_;
+  // Whether the GPU transform applies color jitter or color lighting.
+  bool gpu_color_augmentation_;
   bool mean_std_copied_ = false;
 
   // thread pool for parse + decode
@@ -410,6 +416,15 @@ ImageInputOp<Context>::ImageInputOp(
     prefetched_additional_outputs_on_device_.emplace_back();
     prefetched_additional_outputs_.emplace_back();
   }
+
+  gpu_color_augmentation_ = gpu_transform_ && color_ && !is_test_ &&
+      (color_jitter_ || color_lighting_);
+  if (gpu_color_augmentation_) {
+    ReinitializeTensor(
+        &prefetched_color_params_,
+        {int64_t(batch_size_), int64_t(kColorParamsSize)},
+        at::dtype<float>().device(CPU));
+  }
 }
 
 // Inception-stype scale jittering
@@ -923,6 +938,47 @@ void ColorLighting(
   }
 }
 
+// Draws the color jitter and color lighting of one image, the way
+// ColorJitter and ColorLighting do, for the GPU transform to apply them.
+inline void RandomColorParams(
+    const bool color_jitter,
+    const float saturation,
+    const float brightness,
+    const float contrast,
+    const bool color_lighting,
+    const float color_lighting_std,
+    const std::vector<std::vector<float>>& color_lighting_eigvecs,
+    const std::vector<float>& color_lighting_eigvals,
+    std::mt19937* randgen,
+    ColorParams* params) {
+  *params = ColorParams{{0, 1, 2}, 1.0f, 1.0f, 1.0f, {0, 0, 0}};
+  if (color_jitter) {
+    auto jitter = [randgen](const float alpha_rand) {
+      return 1.0f +
+          std::uniform_real_distribution<float>(-alpha_rand, alpha_rand)(
+                 *randgen);
+    };
+    std::shuffle(params->order, params->order + 3, *randgen);
+    params->saturation = jitter(saturation);
+    params->brightness = jitter(brightness);
+    params->contrast = jitter(contrast);
+  }
+  if (color_lighting) {
+    std::normal_distribution<float> d(0, color_lighting_std);
+    float alphas[3];
+    for (int i = 0; i < 3; ++i) {
+      alphas[i] = d(*randgen);
+    }
+    // The eigenvectors are in RGB order, and the image in BGR.
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        params->lighting[2 - i] += color_lighting_eigvecs[i][j] *
+            color_lighting_eigvals[j] * alphas[j];
+      }
+    }
+  }
+}
+
 // assume HWC order and color channels BGR
 // mean subtraction and scaling.
 template <class Context>
@@ -1120,6 +1176,7 @@ template <class Context>
 void ImageInputOp<Context>::DecodeAndTransposeOnly(
     const std::string& value,
     uint8_t* image_data,
+    ColorParams* color_params,
     int item_id,
     const int channels,
     std::size_t thread_index) {
@@ -1144,6 +1201,20 @@ void ImageInputOp<Context>::DecodeAndTransposeOnly(
       randgen,
       &mirror_this_image,
       is_test_);
+
+  if (color_params) {
+    RandomColorParams(
+        color_jitter_,
+        img_saturation_,
+        img_brightness_,
+        img_contrast_,
+        color_lighting_,
+        color_lighting_std_,
+        color_lighting_eigvecs_,
+        color_lighting_eigvals_,
+        randgen,
+        color_params);
+  }
 }
 
 template <class Context>
@@ -1217,16 +1288,22 @@ bool ImageInputOp<Context>::Prefetch() {
     }
 
     // launch into thread pool for processing
-    // TODO: support color jitter and color lighting in gpu_transform
     if (gpu_transform_) {
       // output of decode will still be int8
       uint8_t* image_data = prefetched_image_.mutable_data<uint8_t>() +
           crop_ * crop_ * channels * item_id;
+      // color jitter and color lighting are drawn here, and applied on GPU
+      ColorParams* color_params = gpu_color_augmentation_
+          ? reinterpret_cast<ColorParams*>(
+                prefetched_color_params_.mutable_data<float>()) +
+              item_id
+          : nullptr;
       thread_pool_->runTaskWithID(std::bind(
           &ImageInputOp<Context>::DecodeAndTransposeOnly,
           this,
-          std::string(value),
+          std::move(value),
           image_data,
+          color_params,
           item_id,
           channels,
           std::placeholders::_1));
@@ -1236,7 +1313,7 @@ bool ImageInputOp<Context>::Prefetch() {
       thread_pool_->runTaskWithID(std::bind(
           &ImageInputOp<Context>::DecodeAndTransform,
           this,
-          std::string(value),
+          std::move(value),
           image_data,
           item_id,
           channels,
@@ -1263,6 +1340,12 @@ bool ImageInputOp<Context>::Prefetch() {
         &prefetched_image_on_device_, device, prefetched_image_);
     ReinitializeAndCopyFrom(
         &prefetched_label_on_device_, device, prefetched_label_);
+    if (gpu_color_augmentation_) {
+      ReinitializeAndCopyFrom(
+          &prefetched_color_params_on_device_,
+          device,
+          prefetched_color_params_);
+    }
 
     for (int i = 0; i < prefetched_additional_outputs_on_device_.size(); ++i) {
       ReinitializeAndCopyFrom(
@@ -1295,7 +1378,6 @@ bool ImageInputOp<Context>::CopyPrefetched() {
           i, options, prefetched_additional_outputs_[i - 2], /* async */ true);
     }
   } else {
-    // TODO: support color jitter and color lighting in gpu_transform
     if (gpu_transform_) {
       if (!mean_std_copied_) {
         ReinitializeTensor(
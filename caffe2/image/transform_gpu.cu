@@ -1,3 +1,5 @@
+#include <cub/block/block_reduce.cuh>
+
 #include "caffe2/core/context_gpu.h"
 #include "caffe2/image/transform_gpu.h"
 #include "caffe2/utils/conversions.h"
@@ -46,6 +48,90 @@ __global__ void transform_kernel(
   }
 }
 
+constexpr int kBlockDim = 16;
+
+// input in (int8, NHWC, BGR), output in (fp32, NCHW); matches the
+// ColorJitter, ColorLighting and ColorNormalization of image_input_op.h
+template <typename In, typename Out>
+__global__ void transform_color_kernel(
+    const int N,
+    const int H,
+    const int W,
+    const float* mean,
+    const float* std,
+    const ColorParams* color_params,
+    const In* in,
+    Out* out) {
+  using BlockReduce = cub::
+      BlockReduce<float, kBlockDim, cub::BLOCK_REDUCE_WARP_REDUCTIONS, kBlockDim>;
+  __shared__ typename BlockReduce::TempStorage temp_storage;
+  __shared__ float contrast_mean;
+
+  const int n = blockIdx.x;
+  const int HW = H * W;
+  const ColorParams params = color_params[n];
+
+  // pointers to data for this image
+  const In* input_ptr = &in[n * 3 * HW];
+  Out* output_ptr = &out[n * 3 * HW];
+
+  // Saturation keeps the gray level of every pixel, and brightness scales it,
+  // so the gray mean the contrast jitter blends with follows from the one of
+  // the input.
+  if (params.contrast != 1.0f) {
+    float gray_sum = 0;
+    for (int h = threadIdx.y; h < H; h += blockDim.y) {
+      for (int w = threadIdx.x; w < W; w += blockDim.x) {
+        const In* pixel = &input_ptr[3 * (h * W + w)];
+        gray_sum += convert::To<In, float>(pixel[0]) * 0.114f +
+            convert::To<In, float>(pixel[1]) * 0.587f +
+            convert::To<In, float>(pixel[2]) * 0.299f;
+      }
+    }
+    gray_sum = BlockReduce(temp_storage).Sum(gray_sum);
+    if (threadIdx.x == 0 && threadIdx.y == 0) {
+      float scale = 1.0f;
+      for (int i = 0; i < 3 && params.order[i] != 2; ++i) {
+        if (params.order[i] == 1) {
+          scale = params.brightness;
+        }
+      }
+      contrast_mean = gray_sum / HW * scale;
+    }
+    __syncthreads();
+  }
+
+  for (int h = threadIdx.y; h < H; h += blockDim.y) {
+    for (int w = threadIdx.x; w < W; w += blockDim.x) {
+      const In* pixel = &input_ptr[3 * (h * W + w)];
+      float bgr[3];
+      for (int c = 0; c < 3; ++c) {
+        bgr[c] = convert::To<In, float>(pixel[c]);
+      }
+      for (int i = 0; i < 3; ++i) {
+        float alpha, gray;
+        if (params.order[i] == 0) {
+          alpha = params.saturation;
+          gray = bgr[0] * 0.114f + bgr[1] * 0.587f + bgr[2] * 0.299f;
+        } else if (params.order[i] == 1) {
+          alpha = params.brightness;
+          gray = 0;
+        } else {
+          alpha = params.contrast;
+          gray = alpha != 1.0f ? contrast_mean : 0;
+        }
+        for (int c = 0; c < 3; ++c) {
+          bgr[c] = bgr[c] * alpha + gray * (1.0f - alpha);
+        }
+      }
+      for (int c = 0; c < 3; ++c) {
+        output_ptr[c * HW + h * W + w] = convert::To<float, Out>(
+            (bgr[c] + params.lighting[c] - mean[c]) * std[c]);
+      }
+    }
+  }
+}
+
 }
 
 template <typename T_IN, typename T_OUT, class Context>
@@ -81,4 +167,48 @@ template bool TransformOnGPU<uint8_t, at::Half, CUDAContext>(
     Tensor& std,
     CUDAContext* context);
 
+template <typename T_IN, typename T_OUT, class Context>
+bool TransformWithColorOnGPU(
+    Tensor& X,
+    Tensor* Y,
+    Tensor& color_params,
+    Tensor& mean,
+    Tensor& std,
+    Context* context) {
+  const int N = X.dim32(0), C = X.dim32(3), H = X.dim32(1), W = X.dim32(2);
+  CAFFE_ENFORCE_EQ(C, 3, "Color augmentation needs BGR images");
+  CAFFE_ENFORCE_EQ(color_params.numel(), N * kColorParamsSize);
+  auto* input_data = X.template data<T_IN>();
+  auto* output_data = Y->template mutable_data<T_OUT>();
+
+  transform_color_kernel<T_IN, T_OUT>
+      <<<N, dim3(kBlockDim, kBlockDim), 0, context->cuda_stream()>>>(
+          N,
+          H,
+          W,
+          mean.template data<float>(),
+          std.template data<float>(),
+          reinterpret_cast<const ColorParams*>(
+              color_params.template data<float>()),
+          input_data,
+          output_data);
+  return true;
+}
+
+template bool TransformWithColorOnGPU<uint8_t, float, CUDAContext>(
+    Tensor& X,
+    Tensor* Y,
+    Tensor& color_params,
+    Tensor& mean,
+    Tensor& std,
+    CUDAContext* context);
+
+template bool TransformWithColorOnGPU<uint8_t, at::Half, CUDAContext>(
+    Tensor& X,
+    Tensor* Y,
+    Tensor& color_params,
+    Tensor& mean,
+    Tensor& std,
+    CUDAContext* context);
+
 }  // namespace caffe2
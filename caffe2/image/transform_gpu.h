@@ -30,6 +30,20 @@
 
 namespace caffe2 {
 
+// The color augmentation of one BGR image, drawn on the CPU and applied by
+// TransformWithColorOnGPU: the saturation, brightness and contrast jitters are
+// applied in `order` (0, 1 and 2 stand for them respectively) with the given
+// factors, and `lighting` is then added to the B, G and R channels.
+struct ColorParams {
+  float order[3];
+  float saturation;
+  float brightness;
+  float contrast;
+  float lighting[3];
+};
+
+constexpr int kColorParamsSize = sizeof(ColorParams) / sizeof(float);
+
 template <typename T_IN, typename T_OUT, class Context>
 bool TransformOnGPU(
     Tensor& X,
@@ -38,6 +52,17 @@ bool TransformOnGPU(
     Tensor& std,
     Context* context);
 
+// Like TransformOnGPU, but also applies the color augmentation of every image
+// of X, given as the floats of a [N, kColorParamsSize] tensor of ColorParams.
+template <typename T_IN, typename T_OUT, class Context>
+bool TransformWithColorOnGPU(
+    Tensor& X,
+    Tensor* Y,
+    Tensor& color_params,
+    Tensor& mean,
+    Tensor& std,
+    Context* context);
+
 }  // namespace caffe2
 
 #endif
@@ -0,0 +1,206 @@
+#include "latency_observer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace caffe2 {
+
+namespace {
+
+uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int highestBit(uint64_t value) {
+  int bit = 0;
+  while (value >>= 1) {
+    ++bit;
+  }
+  return bit;
+}
+
+} // namespace
+
+constexpr int LatencyHistogram::kSubBucketBits;
+constexpr uint64_t LatencyHistogram::kSubBuckets;
+constexpr int LatencyHistogram::kMaxBits;
+constexpr size_t LatencyHistogram::kNumBuckets;
+
+LatencySnapshot::LatencySnapshot() : counts(LatencyHistogram::kNumBuckets) {}
+
+void LatencySnapshot::merge(const LatencySnapshot& other) {
+  for (size_t i = 0; i < counts.size(); ++i) {
+    counts[i] += other.counts[i];
+  }
+  count += other.count;
+  sum += other.sum;
+  max = std::max(max, other.max);
+}
+
+double LatencySnapshot::mean() const {
+  return count ? static_cast<double>(sum) / count : 0.0;
+}
+
+uint64_t LatencySnapshot::percentile(double p) const {
+  uint64_t total = 0;
+  for (auto c : counts) {
+    total += c;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(p / 100.0 * total)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      // The bucket bound can exceed the largest value actually recorded
+      return std::min(LatencyHistogram::bucketUpperBound(i), max);
+    }
+  }
+  return max;
+}
+
+LatencyHistogram::LatencyHistogram() : count_(0), sum_(0), max_(0) {
+  for (auto& c : counts_) {
+    c.store(0, std::memory_order_relaxed);
+  }
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) {
+  value = std::min(value, (uint64_t(1) << kMaxBits) - 1);
+  if (value < kSubBuckets) {
+    return value;
+  }
+  int bit = highestBit(value);
+  uint64_t subBucket = (value >> (bit - kSubBucketBits)) - kSubBuckets;
+  return (bit - kSubBucketBits + 1) * kSubBuckets + subBucket;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  int shift = index / kSubBuckets - 1;
+  uint64_t mantissa = index % kSubBuckets + kSubBuckets;
+  return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+  counts_[bucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(nanoseconds, std::memory_order_relaxed);
+  uint64_t max = max_.load(std::memory_order_relaxed);
+  while (nanoseconds > max &&
+         !max_.compare_exchange_weak(
+             max, nanoseconds, std::memory_order_relaxed)) {
+  }
+}
+
+LatencySnapshot LatencyHistogram::snapshot(bool reset) {
+  LatencySnapshot s;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    s.counts[i] = reset ? counts_[i].exchange(0, std::memory_order_relaxed)
+                        : counts_[i].load(std::memory_order_relaxed);
+  }
+  if (reset) {
+    s.count = count_.exchange(0, std::memory_order_relaxed);
+    s.sum = sum_.exchange(0, std::memory_order_relaxed);
+    s.max = max_.exchange(0, std::memory_order_relaxed);
+  } else {
+    s.count = count_.load(std::memory_order_relaxed);
+    s.sum = sum_.load(std::memory_order_relaxed);
+    s.max = max_.load(std::memory_order_relaxed);
+  }
+  return s;
+}
+
+LatencyOperatorObserver::LatencyOperatorObserver(
+    OperatorBase* subject,
+    LatencyObserver* netObserver)
+    : LatencyOperatorObserver(
+          subject,
+          netObserver,
+          std::make_shared<LatencyHistogram>()) {}
+
+LatencyOperatorObserver::LatencyOperatorObserver(
+    OperatorBase* subject,
+    LatencyObserver* netObserver,
+    std::shared_ptr<LatencyHistogram> histogram)
+    : ObserverBase<OperatorBase>(subject),
+      netObserver_(netObserver),
+      histogram_(std::move(histogram)) {
+  CAFFE_ENFORCE(netObserver_, "Observers can't operate outside of the net");
+}
+
+std::unique_ptr<ObserverBase<OperatorBase>> LatencyOperatorObserver::rnnCopy(
+    OperatorBase* subject,
+    int rnn_order) const {
+  return std::unique_ptr<ObserverBase<OperatorBase>>(
+      new LatencyOperatorObserver(subject, netObserver_, histogram_));
+}
+
+void LatencyOperatorObserver::Start() {
+  sampled_ = netObserver_->sampling();
+  if (sampled_) {
+    startNs_ = nowNs();
+  }
+}
+
+void LatencyOperatorObserver::Stop() {
+  if (sampled_) {
+    histogram_->record(nowNs() - startNs_);
+  }
+}
+
+LatencyObserver::LatencyObserver(NetBase* subject, int sampleRate)
+    : OperatorAttachingNetObserver<LatencyOperatorObserver, LatencyObserver>(
+          subject,
+          this),
+      sampleRate_(sampleRate),
+      runs_(0),
+      sampled_(false) {
+  CAFFE_ENFORCE_GE(sampleRate_, 1, "Sample rate must be positive");
+}
+
+void LatencyObserver::Start() {
+  bool sampled = sampleRate_ == 1 ||
+      runs_.fetch_add(1, std::memory_order_relaxed) % sampleRate_ == 0;
+  sampled_.store(sampled, std::memory_order_relaxed);
+  if (sampled) {
+    startNs_ = nowNs();
+  }
+}
+
+void LatencyObserver::Stop() {
+  if (sampling()) {
+    histogram_.record(nowNs() - startNs_);
+  }
+}
+
+LatencySnapshot LatencyObserver::netSnapshot(bool reset) {
+  return histogram_.snapshot(reset);
+}
+
+std::map<std::string, LatencySnapshot> LatencyObserver::operatorTypeSnapshots(
+    bool reset) {
+  std::map<std::string, LatencySnapshot> snapshots;
+  for (const auto* observer : operator_observers_) {
+    snapshots[observer->subject()->type()].merge(
+        observer->histogram().snapshot(reset));
+  }
+  return snapshots;
+}
+
+void LatencyObserver::reset() {
+  histogram_.snapshot(/* reset */ true);
+  for (const auto* observer : operator_observers_) {
+    observer->histogram().snapshot(/* reset */ true);
+  }
+}
+
+} // namespace caffe2
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/observers/operator_attaching_net_observer.h"
+
+namespace caffe2 {
+
+// Point-in-time copy of a LatencyHistogram. Snapshots of different
+// histograms can be merged, e.g. to aggregate all operators of one type.
+struct CAFFE2_API LatencySnapshot {
+  LatencySnapshot();
+
+  void merge(const LatencySnapshot& other);
+
+  double mean() const;
+
+  // Upper bound of the bucket containing the p-th percentile, p in [0, 100].
+  // Returns 0 if nothing was recorded.
+  uint64_t percentile(double p) const;
+
+  std::vector<uint64_t> counts;
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  uint64_t max = 0;
+};
+
+// Log-linear histogram of latencies in nanoseconds, in the spirit of HDR
+// histograms: a value is bucketed by its highest set bit and the following
+// kSubBucketBits bits, so the relative error of any percentile is below
+// 1/16. Recording is a handful of relaxed atomic operations; any number of
+// threads can record concurrently without locking.
+class CAFFE2_API LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr uint64_t kSubBuckets = 1 << kSubBucketBits;
+  // Values are clamped to 2^kMaxBits - 1 ns (about 4.9 hours).
+  static constexpr int kMaxBits = 44;
+  static constexpr size_t kNumBuckets =
+      (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+
+  LatencyHistogram();
+
+  void record(uint64_t nanoseconds);
+
+  // Copies the current counts, and clears them if reset is set. Values
+  // recorded concurrently with a reset are either in the snapshot or in the
+  // histogram afterwards.
+  LatencySnapshot snapshot(bool reset = false);
+
+  static size_t bucketIndex(uint64_t value);
+  static uint64_t bucketUpperBound(size_t index);
+
+ private:
+  std::array<std::atomic<uint64_t>, kNumBuckets> counts_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> max_;
+};
+
+class LatencyObserver;
+
+class CAFFE2_API LatencyOperatorObserver final
+    : public ObserverBase<OperatorBase> {
+ public:
+  explicit LatencyOperatorObserver(OperatorBase* subject) = delete;
+  LatencyOperatorObserver(OperatorBase* subject, LatencyObserver* netObserver);
+  std::unique_ptr<ObserverBase<OperatorBase>> rnnCopy(
+      OperatorBase* subject,
+      int rnn_order) const override;
+
+  LatencyHistogram& histogram() const {
+    return *histogram_;
+  }
+
+ private:
+  LatencyOperatorObserver(
+      OperatorBase* subject,
+      LatencyObserver* netObserver,
+      std::shared_ptr<LatencyHistogram> histogram);
+
+  void Start() override;
+  void Stop() override;
+
+  LatencyObserver* netObserver_;
+  // Shared with the copies made for recurrent network steps
+  std::shared_ptr<LatencyHistogram> histogram_;
+  bool sampled_ = false;
+  uint64_t startNs_ = 0;
+};
+
+// Aggregates latency histograms for a net and each of its operators, for
+// continuous reporting of tail latencies from production hosts. Only one in
+// sampleRate runs of the net is timed, together with all of its operators.
+//
+//   auto net_ob = std::make_unique<LatencyObserver>(net.get(), 100);
+//   auto* ob = net_ob.get();
+//   net->AttachObserver(std::move(net_ob));
+//   ...
+//   auto ops = ob->operatorTypeSnapshots(/* reset */ true);
+//   LOG(INFO) << "FC p99: " << ops["FC"].percentile(99) << " ns";
+class CAFFE2_API LatencyObserver final
+    : public OperatorAttachingNetObserver<
+          LatencyOperatorObserver,
+          LatencyObserver> {
+ public:
+  explicit LatencyObserver(NetBase* subject, int sampleRate = 1);
+
+  bool sampling() const {
+    return sampled_.load(std::memory_order_relaxed);
+  }
+
+  LatencySnapshot netSnapshot(bool reset = false);
+
+  // Snapshots of all operators of the net, merged by operator type
+  std::map<std::string, LatencySnapshot> operatorTypeSnapshots(
+      bool reset = false);
+
+  void reset();
+
+ private:
+  void Start() override;
+  void Stop() override;
+
+  const int sampleRate_;
+  std::atomic<uint64_t> runs_;
+  std::atomic<bool> sampled_;
+  uint64_t startNs_ = 0;
+  LatencyHistogram histogram_;
+};
+
+} // namespace caffe2
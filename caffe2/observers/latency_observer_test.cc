@@ -0,0 +1,129 @@
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+#include "latency_observer.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+namespace caffe2 {
+
+namespace {
+
+class LatencySleepOp final : public OperatorBase {
+ public:
+  using OperatorBase::OperatorBase;
+  bool Run(int /* unused */) override {
+    StartAllObservers();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    StopAllObservers();
+    return true;
+  }
+};
+
+REGISTER_CPU_OPERATOR(LatencySleepOp, LatencySleepOp);
+
+OPERATOR_SCHEMA(LatencySleepOp)
+    .NumInputs(0, INT_MAX)
+    .NumOutputs(0, INT_MAX)
+    .AllowInplace({{0, 0}, {1, 1}});
+
+unique_ptr<NetBase> CreateNetTestHelper(Workspace* ws) {
+  NetDef net_def;
+  {
+    auto& op = *(net_def.add_op());
+    op.set_type("LatencySleepOp");
+    op.add_input("in");
+    op.add_output("hidden");
+  }
+  {
+    auto& op = *(net_def.add_op());
+    op.set_type("LatencySleepOp");
+    op.add_input("hidden");
+    op.add_output("out");
+  }
+  net_def.add_external_input("in");
+  net_def.add_external_output("out");
+
+  return CreateNet(net_def, ws);
+}
+} // namespace
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram histogram;
+  for (uint64_t i = 1; i <= 10000; ++i) {
+    histogram.record(i * 1000);
+  }
+  auto s = histogram.snapshot();
+  EXPECT_EQ(s.count, 10000u);
+  EXPECT_EQ(s.max, 10000000u);
+  EXPECT_NEAR(s.mean(), 5000500, 1);
+  for (double p : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+    double exact = p * 100 * 1000;
+    EXPECT_GE(s.percentile(p), exact);
+    EXPECT_LE(s.percentile(p), exact * (1 + 1.0 / 16));
+  }
+  EXPECT_EQ(s.percentile(100), 10000000u);
+
+  histogram.snapshot(/* reset */ true);
+  EXPECT_EQ(histogram.snapshot().count, 0u);
+  EXPECT_EQ(histogram.snapshot().percentile(99), 0u);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  for (uint64_t v = 0; v < 64; ++v) {
+    auto index = LatencyHistogram::bucketIndex(v);
+    EXPECT_LT(index, LatencyHistogram::kNumBuckets);
+    if (v < LatencyHistogram::kSubBuckets * 2) {
+      EXPECT_EQ(LatencyHistogram::bucketUpperBound(index), v);
+    }
+  }
+  EXPECT_EQ(
+      LatencyHistogram::bucketIndex(~uint64_t(0)),
+      LatencyHistogram::kNumBuckets - 1);
+}
+
+TEST(LatencyObserverTest, AggregatesNetAndOperators) {
+  Workspace ws;
+  ws.CreateBlob("in");
+  unique_ptr<NetBase> net(CreateNetTestHelper(&ws));
+  auto net_ob = std::make_unique<LatencyObserver>(net.get());
+  auto* ob = net_ob.get();
+  net->AttachObserver(std::move(net_ob));
+  for (int i = 0; i < 5; ++i) {
+    net->Run();
+  }
+
+  auto net_snapshot = ob->netSnapshot();
+  EXPECT_EQ(net_snapshot.count, 5u);
+  EXPECT_GE(net_snapshot.percentile(50), 4000000u);
+
+  auto op_snapshots = ob->operatorTypeSnapshots(/* reset */ true);
+  ASSERT_EQ(op_snapshots.size(), 1u);
+  const auto& sleep_ops = op_snapshots["LatencySleepOp"];
+  EXPECT_EQ(sleep_ops.count, 10u);
+  EXPECT_GE(sleep_ops.percentile(99), 2000000u);
+  EXPECT_LE(sleep_ops.percentile(99), net_snapshot.max);
+
+  EXPECT_EQ(ob->operatorTypeSnapshots()["LatencySleepOp"].count, 0u);
+  ob->reset();
+  EXPECT_EQ(ob->netSnapshot().count, 0u);
+}
+
+TEST(LatencyObserverTest, Sampling) {
+  Workspace ws;
+  ws.CreateBlob("in");
+  unique_ptr<NetBase> net(CreateNetTestHelper(&ws));
+  auto net_ob =
+      std::make_unique<LatencyObserver>(net.get(), /* sampleRate */ 3);
+  auto* ob = net_ob.get();
+  net->AttachObserver(std::move(net_ob));
+  for (int i = 0; i < 7; ++i) {
+    net->Run();
+  }
+  EXPECT_EQ(ob->netSnapshot().count, 3u);
+  EXPECT_EQ(ob->operatorTypeSnapshots()["LatencySleepOp"].count, 6u);
+}
+} // namespace caffe2
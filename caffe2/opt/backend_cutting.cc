@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <fstream>
 #include <queue>
+#include <sstream>
 
 namespace caffe2 {
 namespace opt {
@@ -284,6 +285,35 @@ void ReplaceSubgraph(
   }
 }
 
+// Estimates the latency of the subgraph on the host and on the backend, once
+// its boundary references are known.
+BackendSubgraphCost EstimateSubgraphCost(
+    const TransformSubgraph& subgraph,
+    const BackendCostModel& cost_model) {
+  BackendSubgraphCost cost{
+      subgraph.group_id, 0, 0, cost_model.launch_cost, 0, false};
+  for (auto node : subgraph.nodes) {
+    if (!nn::is<NeuralNetOperator>(node)) {
+      continue;
+    }
+    const auto* nn_op = nn::get<NeuralNetOperator>(node);
+    const auto& op_def =
+        dyn_cast<Caffe2Annotation>(nn_op->getAnnotation())->getOperatorDef();
+    ++cost.num_ops;
+    cost.host_cost += cost_model.host_cost(op_def);
+    cost.backend_cost += cost_model.backend_cost(op_def);
+  }
+  for (const auto& kv : subgraph.external_input_refs) {
+    cost.transfer_cost += cost_model.transfer_cost(kv.first);
+  }
+  for (const auto& kv : subgraph.external_output_refs) {
+    cost.transfer_cost += cost_model.transfer_cost(kv.first);
+  }
+  cost.lowered = cost.num_ops >= cost_model.min_ops &&
+      cost.backend_cost + cost.transfer_cost < cost.host_cost;
+  return cost;
+}
+
 void PruneUnrefereredNodes(NNModule* nn) {
   auto& g = nn->dataFlow;
   std::vector<NodeRef> to_delete;
@@ -310,7 +340,33 @@ void PruneUnrefereredNodes(NNModule* nn) {
   }
 }
 
+caffe2::NetDef OptimizeForBackendImpl(
+    caffe2::NetDef& net,
+    std::function<bool(const caffe2::OperatorDef&)> supports,
+    std::function<caffe2::NetDef(const caffe2::NetDef&)> transform_func,
+    const BackendCostModel* cost_model,
+    std::vector<BackendSubgraphCost>* report,
+    bool debug);
+
 } // namespace
+
+std::string BackendCostReportToString(
+    const std::vector<BackendSubgraphCost>& report) {
+  std::stringstream ss;
+  double total = 0;
+  for (const auto& cost : report) {
+    const double backend_total = cost.backend_cost + cost.transfer_cost;
+    ss << "Group " << cost.group_id << ": " << cost.num_ops
+       << " ops, host cost " << cost.host_cost << ", backend cost "
+       << cost.backend_cost << " + transfer cost " << cost.transfer_cost
+       << " = " << backend_total << ", "
+       << (cost.lowered ? "lowered" : "kept on host") << "\n";
+    total += cost.lowered ? backend_total : cost.host_cost;
+  }
+  ss << "Total cost of the supported subgraphs: " << total << "\n";
+  return ss.str();
+}
+
 void DumpGraph(NNGraph* g, const std::string& fname) {
   auto nnprinter = [](typename NNGraph::NodeRef node) {
     std::map<std::string, std::string> labelMap;
@@ -360,6 +416,29 @@ caffe2::NetDef OptimizeForBackend(
     std::function<bool(const caffe2::OperatorDef&)> supports,
     std::function<caffe2::NetDef(const caffe2::NetDef&)> transform_func,
     bool debug) {
+  return OptimizeForBackendImpl(
+      net, supports, transform_func, nullptr, nullptr, debug);
+}
+
+caffe2::NetDef OptimizeForBackend(
+    caffe2::NetDef& net,
+    std::function<bool(const caffe2::OperatorDef&)> supports,
+    std::function<caffe2::NetDef(const caffe2::NetDef&)> transform_func,
+    const BackendCostModel& cost_model,
+    std::vector<BackendSubgraphCost>* report,
+    bool debug) {
+  return OptimizeForBackendImpl(
+      net, supports, transform_func, &cost_model, report, debug);
+}
+
+namespace {
+caffe2::NetDef OptimizeForBackendImpl(
+    caffe2::NetDef& net,
+    std::function<bool(const caffe2::OperatorDef&)> supports,
+    std::function<caffe2::NetDef(const caffe2::NetDef&)> transform_func,
+    const BackendCostModel* cost_model,
+    std::vector<BackendSubgraphCost>* report,
+    bool debug) {
   auto nn = convertToNNModule(net);
   auto& dfg = nn.dataFlow;
 
@@ -416,10 +495,24 @@ caffe2::NetDef OptimizeForBackend(
   // Transform needed subgraphs one by one
   std::vector<caffe2::NetDef> opt_subnets;
   opt_subnets.reserve(subs.size());
+  if (report) {
+    report->clear();
+  }
   for (auto& g : subs) {
     // Generate boundary input/output edges
     DetectBoundaryReferences(&g, context.infos, external_outputs);
 
+    // Supported subgraphs that are not worth lowering stay as they are
+    if (cost_model) {
+      const auto cost = EstimateSubgraphCost(g, *cost_model);
+      if (report) {
+        report->push_back(cost);
+      }
+      if (!cost.lowered) {
+        continue;
+      }
+    }
+
     caffe2::NetDef subnet = ConvertToC2Net(g, context.infos);
     // Transform the subgraph protobuf def, note that we can have less external
     // inputs/outputs but not more
@@ -440,6 +533,7 @@ caffe2::NetDef OptimizeForBackend(
   new_net.set_name(net.name() + "_opt");
   return new_net;
 }
+} // namespace
 
 } // namespace opt
 } // namespace caffe2
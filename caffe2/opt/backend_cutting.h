@@ -5,14 +5,56 @@
 #include "nomnigraph/Representations/NeuralNet.h"
 
 #include <functional>
+#include <string>
+#include <vector>
 
 namespace caffe2 {
 namespace opt {
+
+// Estimated latencies, in any consistent unit, that decide which of the
+// supported subgraphs are worth lowering to the backend. A subgraph is lowered
+// if it has at least min_ops ops and running it on the backend, with the
+// transfers of its boundary tensors, is estimated to be faster than running
+// it on the host.
+struct CAFFE2_API BackendCostModel {
+  // The latency of an op on the host, and on the backend.
+  std::function<double(const caffe2::OperatorDef&)> host_cost;
+  std::function<double(const caffe2::OperatorDef&)> backend_cost;
+  // The latency of moving a tensor between the host and the backend.
+  std::function<double(const std::string&)> transfer_cost;
+  // The fixed latency of running a lowered subgraph.
+  double launch_cost{0};
+  size_t min_ops{1};
+};
+
+// The estimates for one supported subgraph.
+struct CAFFE2_API BackendSubgraphCost {
+  int group_id;
+  size_t num_ops;
+  double host_cost;
+  // Includes the launch cost.
+  double backend_cost;
+  double transfer_cost;
+  bool lowered;
+};
+
+CAFFE2_API std::string BackendCostReportToString(
+    const std::vector<BackendSubgraphCost>& report);
+
 CAFFE2_API void DumpGraph(nom::repr::NNGraph* g, const std::string& fname);
 CAFFE2_API caffe2::NetDef OptimizeForBackend(
     caffe2::NetDef& net,
     std::function<bool(const caffe2::OperatorDef&)> supports,
     std::function<caffe2::NetDef(const caffe2::NetDef&)> transform_func,
     bool debug = false);
+// Like above, but only lowers the subgraphs that cost_model deems worth it,
+// and fills report, if given, with the estimates of every supported subgraph.
+CAFFE2_API caffe2::NetDef OptimizeForBackend(
+    caffe2::NetDef& net,
+    std::function<bool(const caffe2::OperatorDef&)> supports,
+    std::function<caffe2::NetDef(const caffe2::NetDef&)> transform_func,
+    const BackendCostModel& cost_model,
+    std::vector<BackendSubgraphCost>* report = nullptr,
+    bool debug = false);
 }
 } // namespace caffe2
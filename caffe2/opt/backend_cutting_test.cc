@@ -151,3 +151,62 @@ TEST(BackendCuttingTest, skipPath) {
   auto net_opt = caffe2::opt::OptimizeForBackend(net, Supports, Transform);
   EXPECT_EQ(4, net_opt.op_size());
 }
+
+// X -> CopyIn -> MyConv -> MyConv -> CopyOut -> Y, where the convs are only
+// lowered if they are worth their transfers
+TEST(BackendCuttingTest, costModel) {
+  caffe2::NetDef net;
+  net.add_external_input("X");
+  net.add_external_input("W0");
+  net.add_external_input("W1");
+  net.add_external_input("b0");
+  net.add_external_input("b1");
+  net.add_external_output("Y");
+  auto* op = net.add_op();
+  op->set_type("CopyIn");
+  op->add_input("X");
+  op->add_output("N0");
+  for (int i = 0; i < 2; ++i) {
+    AddConv(&net, i);
+  }
+  op = net.add_op();
+  op->set_type("CopyOut");
+  op->add_input("N2");
+  op->add_output("Y");
+
+  double transfer_cost = 0;
+  caffe2::opt::BackendCostModel cost_model;
+  cost_model.host_cost = [](const caffe2::OperatorDef&) { return 1.0; };
+  cost_model.backend_cost = [](const caffe2::OperatorDef&) { return 0.1; };
+  // Weights are loaded once, and N0 and N2 cross the boundary
+  cost_model.transfer_cost = [&transfer_cost](const std::string& name) {
+    return StartsWith(name, "W") || StartsWith(name, "b") ? 0.0
+                                                          : transfer_cost;
+  };
+
+  std::vector<caffe2::opt::BackendSubgraphCost> report;
+  transfer_cost = 0.5;
+  auto net_opt = caffe2::opt::OptimizeForBackend(
+      net, Supports, Transform, cost_model, &report);
+  EXPECT_EQ(3, net_opt.op_size());
+  ASSERT_EQ(1u, report.size());
+  EXPECT_EQ(2u, report[0].num_ops);
+  EXPECT_DOUBLE_EQ(2.0, report[0].host_cost);
+  EXPECT_DOUBLE_EQ(0.2, report[0].backend_cost);
+  EXPECT_DOUBLE_EQ(1.0, report[0].transfer_cost);
+  EXPECT_TRUE(report[0].lowered);
+
+  transfer_cost = 1.0;
+  net_opt = caffe2::opt::OptimizeForBackend(
+      net, Supports, Transform, cost_model, &report);
+  EXPECT_EQ(4, net_opt.op_size());
+  ASSERT_EQ(1u, report.size());
+  EXPECT_FALSE(report[0].lowered);
+
+  transfer_cost = 0.5;
+  cost_model.min_ops = 3;
+  net_opt = caffe2::opt::OptimizeForBackend(
+      net, Supports, Transform, cost_model, &report);
+  EXPECT_EQ(4, net_opt.op_size());
+  EXPECT_FALSE(report[0].lowered);
+}
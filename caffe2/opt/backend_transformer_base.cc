@@ -1,9 +1,75 @@
 #include "caffe2/opt/backend_transformer_base.h"
+#include "caffe2/core/operator_schema.h"
 #include "caffe2/onnx/onnx_exporter.h"
 #include "caffe2/utils/proto_utils.h"
 
+#include <algorithm>
+#include <fstream>
+
 namespace caffe2 {
 
+namespace {
+// The bytes of a tensor according to its bound shape, or 0 if it has none.
+uint64_t tensorBytes(const ShapeInfoMap& shape_hints, const std::string& name) {
+  const auto it = shape_hints.find(name);
+  if (it == shape_hints.end() || it->second.shape.unknown_shape()) {
+    return 0;
+  }
+  const auto& shape = it->second.shape;
+  uint64_t bytes = 1;
+  if (!it->second.is_quantized && shape.data_type() != TensorProto::UNDEFINED &&
+      shape.data_type() != TensorProto::STRING) {
+    bytes = DataTypeToTypeMeta(shape.data_type()).itemsize();
+  }
+  for (const auto d : shape.dims()) {
+    bytes *= std::max<int64_t>(d, 0);
+  }
+  return bytes;
+}
+
+// The cost of the op from the cost inference of its schema. Ops without one
+// are assumed to read their inputs and write their outputs once.
+OpSchema::Cost inferOpCost(
+    const OperatorDef& op,
+    const ShapeInfoMap& shape_hints) {
+  const auto* schema = OpSchemaRegistry::Schema(op.type());
+  if (schema && schema->HasCostInferenceFunction()) {
+    std::vector<TensorShape> input_shapes;
+    for (const auto& input : op.input()) {
+      const auto it = shape_hints.find(input);
+      if (it != shape_hints.end()) {
+        input_shapes.push_back(it->second.shape);
+      } else {
+        input_shapes.emplace_back();
+        input_shapes.back().set_unknown_shape(true);
+      }
+    }
+    try {
+      return schema->InferCost(op, input_shapes);
+    } catch (const std::exception& e) {
+      VLOG(2) << "Cannot infer the cost of " << op.type() << ": " << e.what();
+    }
+  }
+  OpSchema::Cost cost;
+  for (const auto& input : op.input()) {
+    cost.bytes_read += tensorBytes(shape_hints, input);
+  }
+  for (const auto& output : op.output()) {
+    cost.bytes_written += tensorBytes(shape_hints, output);
+  }
+  return cost;
+}
+
+double rooflineLatency(
+    const OpSchema::Cost& cost,
+    double flops_per_us,
+    double bytes_per_us) {
+  return std::max(
+      cost.flops / flops_per_us,
+      (cost.bytes_read + cost.bytes_written) / bytes_per_us);
+}
+} // namespace
+
 // Populate 'net_pos' argument for any ops that don't already have it. 'net_pos'
 // we populate here starts after the max 'net_pos' value we encountered.
 void BackendTransformerBase::annotateOpIndex(NetDef* net) {
@@ -118,6 +184,63 @@ ShapeInfoMap BackendTransformerBase::ssaRewriteAndMapNames(
   return shape_hints_mapped;
 }
 
+NetDef BackendTransformerBase::optimizeForBackend(
+    NetDef* pred_net,
+    std::function<bool(const OperatorDef&)> supports,
+    std::function<NetDef(const NetDef&)> transform_func,
+    const BackendTransformOptions& opts,
+    const ShapeInfoMap& shape_hints,
+    const std::unordered_set<std::string>& weights) const {
+  if (!opts.use_cost_model) {
+    return opt::OptimizeForBackend(
+        *pred_net, supports, transform_func, opts.debug);
+  }
+  std::vector<opt::BackendSubgraphCost> report;
+  auto net_opt = opt::OptimizeForBackend(
+      *pred_net,
+      supports,
+      transform_func,
+      buildCostModel(opts, shape_hints, weights),
+      &report,
+      opts.debug);
+  const auto report_str = opt::BackendCostReportToString(report);
+  LOG(INFO) << "Backend cost report of " << pred_net->name() << ":\n"
+            << report_str;
+  if (opts.debug) {
+    std::ofstream out("debug_cost_report.txt");
+    out << report_str;
+  }
+  return net_opt;
+}
+
+opt::BackendCostModel BackendTransformerBase::buildCostModel(
+    const BackendTransformOptions& opts,
+    const ShapeInfoMap& shape_hints,
+    const std::unordered_set<std::string>& weights) const {
+  opt::BackendCostModel cost_model;
+  cost_model.host_cost = [&opts, &shape_hints](const OperatorDef& op) {
+    return rooflineLatency(
+        inferOpCost(op, shape_hints),
+        opts.host_flops_per_us,
+        opts.host_bytes_per_us);
+  };
+  cost_model.backend_cost = [&opts, &shape_hints](const OperatorDef& op) {
+    return rooflineLatency(
+        inferOpCost(op, shape_hints),
+        opts.backend_flops_per_us,
+        opts.backend_bytes_per_us);
+  };
+  cost_model.transfer_cost = [&opts, &shape_hints, &weights](
+                                 const std::string& name) {
+    return weights.count(name)
+        ? 0.0
+        : tensorBytes(shape_hints, name) / opts.transfer_bytes_per_us;
+  };
+  cost_model.launch_cost = opts.backend_launch_us;
+  cost_model.min_ops = opts.min_ops;
+  return cost_model;
+}
+
 ShapeInfoMap BackendTransformerBase::inferShapes(
     Workspace* ws,
     NetDef* pred_net,
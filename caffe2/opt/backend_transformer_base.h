@@ -2,11 +2,14 @@
 
 #include "caffe2/core/common.h"
 #include "caffe2/core/workspace.h"
+#include "caffe2/opt/backend_cutting.h"
 #include "caffe2/opt/bound_shape_inferencer.h"
 #include "caffe2/proto/caffe2_pb.h"
 
+#include <functional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace caffe2 {
@@ -25,6 +28,20 @@ struct BackendTransformOptions {
   // small, it doesn't make sense to lower it to backend.
   size_t min_ops{1};
 
+  // Whether to lower only the subgraphs that are estimated to run faster on
+  // the backend, see opt::BackendCostModel. Op costs come from the cost
+  // inference of the op schemas, with the bound shapes, and are turned into
+  // latencies (in microseconds) with a roofline of the throughputs below.
+  bool use_cost_model{false};
+  double host_flops_per_us{1e5};
+  double host_bytes_per_us{2e4};
+  double backend_flops_per_us{1e7};
+  double backend_bytes_per_us{3e5};
+  // Bandwidth between the host and the backend
+  double transfer_bytes_per_us{1e4};
+  // Fixed latency of running a backend op
+  double backend_launch_us{10};
+
   // Bound shape spec
   BoundShapeSpec bound_shape_spec;
 };
@@ -83,6 +100,25 @@ class BackendTransformerBase {
       NetDef* pred_net,
       const ShapeInfoMap& input_shape_hints);
 
+  // Cuts the subgraphs that supports accepts out of pred_net, and replaces
+  // them by the result of transform_func, with opt::OptimizeForBackend. With
+  // opts.use_cost_model, only the subgraphs worth lowering are transformed,
+  // and the estimates are logged.
+  NetDef optimizeForBackend(
+      NetDef* pred_net,
+      std::function<bool(const OperatorDef&)> supports,
+      std::function<NetDef(const NetDef&)> transform_func,
+      const BackendTransformOptions& opts,
+      const ShapeInfoMap& shape_hints,
+      const std::unordered_set<std::string>& weights) const;
+
+  // Build the cost model of opts from the shapes. Weights are loaded into the
+  // backend once, so they cost no transfer.
+  opt::BackendCostModel buildCostModel(
+      const BackendTransformOptions& opts,
+      const ShapeInfoMap& shape_hints,
+      const std::unordered_set<std::string>& weights) const;
+
   // Do bound shape inference and collect shape infos
   ShapeInfoMap inferShapes(
       Workspace* ws,
@@ -28,6 +28,12 @@ C10_DEFINE_int32(
     1,
     "Minimum number of ops for a subgraph to be lowered to backend");
 
+C10_DEFINE_bool(
+    onnxifi_use_cost_model,
+    false,
+    "Only lower the subgraphs that are estimated to run faster on the backend, "
+    "with their transfers, than on the host");
+
 C10_DEFINE_string(
     onnxifi_shape_hints,
     "",
@@ -129,6 +135,7 @@ void onnxifi(
   opts.debug = FLAGS_onnxifi_debug_mode;
   opts.adjust_batch = FLAGS_onnxifi_adjust_batch;
   opts.min_ops = FLAGS_onnxifi_min_ops;
+  opts.use_cost_model = FLAGS_onnxifi_use_cost_model;
   opts.load_model_by_blob = load_model_by_blob;
   opts.merge_fp32_inputs_into_fp16 = FLAGS_merge_fp32_inputs_into_fp16;
   opts.loop_test = FLAGS_onnxifi_loop_test_mode;
@@ -1371,8 +1371,8 @@ NetDef OnnxifiTransformer::TransformViaC2(
         return SubnetToOnnxifiOpViaC2(net, weights, shape_hints);
       };
 
-  return opt::OptimizeForBackend(
-      *pred_net, c2_supports, c2_converter, opts_.debug);
+  return optimizeForBackend(
+      pred_net, c2_supports, c2_converter, opts_, shape_hints, weights);
 }
 
 NetDef OnnxifiTransformer::TransformViaOnnx(
@@ -1399,8 +1399,8 @@ NetDef OnnxifiTransformer::TransformViaOnnx(
     return SubnetToOnnxifiOpViaOnnx(net, weights, ws, &exporter2, shape_hints);
   };
 
-  return opt::OptimizeForBackend(
-      *pred_net, onnx_supports, onnx_converter, opts_.debug);
+  return optimizeForBackend(
+      pred_net, onnx_supports, onnx_converter, opts_, *shape_hints, weights);
 }
 
 void OnnxifiTransformer::extractPartitionInfo(const NetDef& net) {
@@ -0,0 +1,32 @@
+#include "caffe2/perfkernels/embedding_lookup_prefetch.h"
+
+#include <algorithm>
+
+#include <c10/util/Flags.h>
+
+C10_DEFINE_int(
+    caffe2_embedding_lookup_prefetch_distance,
+    0,
+    "The number of indices ahead whose rows the embedding lookup kernels "
+    "prefetch. 0 picks it from the size of the rows.");
+
+namespace caffe2 {
+
+namespace {
+constexpr int64_t kPrefetchBytes = 4096;
+constexpr int64_t kMinPrefetchDistance = 16;
+constexpr int64_t kMaxPrefetchDistance = 64;
+} // namespace
+
+int64_t EmbeddingLookupPrefetchDistance(int64_t row_bytes) {
+  if (FLAGS_caffe2_embedding_lookup_prefetch_distance > 0) {
+    return FLAGS_caffe2_embedding_lookup_prefetch_distance;
+  }
+  const int64_t distance =
+      (kPrefetchBytes + std::max<int64_t>(row_bytes, 1) - 1) /
+      std::max<int64_t>(row_bytes, 1);
+  return std::min(
+      std::max(distance, kMinPrefetchDistance), kMaxPrefetchDistance);
+}
+
+} // namespace caffe2
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace caffe2 {
+
+/**
+ * The number of indices ahead of the current one whose rows the embedding
+ * lookup kernels prefetch, for rows of `row_bytes` bytes.
+ *
+ * The flag caffe2_embedding_lookup_prefetch_distance sets the distance for
+ * all row sizes. When it is 0, the distance covers about a page of rows, so
+ * that rows of short embeddings are prefetched early enough to hide the
+ * memory latency, and the prefetches of long ones don't evict the rows in
+ * flight; it is clamped to [16, 64].
+ */
+int64_t EmbeddingLookupPrefetchDistance(int64_t row_bytes);
+
+} // namespace caffe2
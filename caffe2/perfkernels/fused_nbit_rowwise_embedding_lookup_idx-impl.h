@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <immintrin.h>
+
+#include <c10/util/Half.h>
+#include "caffe2/perfkernels/embedding_lookup_prefetch.h"
+
+// The N-bit row-wise embedding lookup shared by the AVX2 and the AVX-512
+// kernels. `Vec` wraps the vector type of one instruction set:
+//
+//   Vec::kWidth                      floats per register
+//   Vec::Reg                         the register type
+//   Vec::set1 / loadu / storeu / add / mul / fmadd
+//   Vec::Unpacker<BIT_RATE>          turns the kWidth * BIT_RATE / 8 bytes at
+//                                    a pointer into kWidth floats
+//
+// Every output row is accumulated in place, one register of kWidth values at
+// a time, and the values past the last full register are done one by one.
+
+namespace caffe2 {
+namespace perfkernels {
+namespace {
+
+template <typename Vec, int BIT_RATE, typename IndexType>
+bool FusedNBitRowwiseEmbeddingLookupIdxImpl(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const IndexType* indices,
+    const int64_t* offsets,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  constexpr int kElemPerByte = 8 / BIT_RATE;
+  constexpr int kCacheLineSize = 64;
+  const int64_t value_bytes = block_size / kElemPerByte;
+  // block_size is the number of elements and fused_block_size is the size of
+  // an entire row, including scale and bias.
+  const int64_t fused_block_size = value_bytes + 2 * sizeof(at::Half);
+  const int64_t prefdist_T0 = EmbeddingLookupPrefetchDistance(fused_block_size);
+  const int64_t vec_end = block_size - block_size % Vec::kWidth;
+  const typename Vec::template Unpacker<BIT_RATE> unpack;
+
+  int64_t dataInd = 0;
+  for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+    float* op = &out[rangeIndex * block_size];
+    std::memset(op, 0, sizeof(float) * block_size);
+    if (dataInd != offsets[rangeIndex] - offsets[0]) {
+      return false;
+    }
+    const int64_t end_offset = offsets[rangeIndex + 1] - offsets[0];
+    const int64_t length = offsets[rangeIndex + 1] - offsets[rangeIndex];
+    if (end_offset > index_size) {
+      return false;
+    }
+    for (; dataInd < end_offset; ++dataInd) {
+      const IndexType idx = indices[dataInd];
+      if (idx < 0 || idx >= data_size) {
+        return false;
+      }
+      if (dataInd + prefdist_T0 < index_size) {
+        const IndexType idx_pref_T0 = indices[dataInd + prefdist_T0];
+        if (idx_pref_T0 >= 0 && idx_pref_T0 < data_size) {
+          const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+          for (int64_t b = 0; b < fused_block_size; b += kCacheLineSize) {
+            _mm_prefetch(
+                reinterpret_cast<const char*>(ip_next_T0 + b), _MM_HINT_T0);
+          }
+        }
+      }
+
+      const uint8_t* ip = &input[idx * fused_block_size];
+      at::Half scale_bias[2];
+      std::memcpy(scale_bias, ip + value_bytes, sizeof(scale_bias));
+      const float wgt = weights ? weights[dataInd] : 1.f;
+      const float scale = wgt * static_cast<float>(scale_bias[0]);
+      const float bias = wgt * static_cast<float>(scale_bias[1]);
+      const typename Vec::Reg vscale = Vec::set1(scale);
+      const typename Vec::Reg vbias = Vec::set1(bias);
+
+      int64_t j = 0;
+      for (; j < vec_end; j += Vec::kWidth) {
+        Vec::storeu(
+            op + j,
+            Vec::fmadd(
+                vscale,
+                unpack(ip + j / kElemPerByte),
+                Vec::add(Vec::loadu(op + j), vbias)));
+      }
+      for (; j < block_size; ++j) {
+        const int quantized =
+            (ip[j / kElemPerByte] >> ((j % kElemPerByte) * BIT_RATE)) &
+            ((1 << BIT_RATE) - 1);
+        op[j] = std::fma(scale, static_cast<float>(quantized), op[j] + bias);
+      }
+    }
+
+    if (normalize_by_lengths && length) {
+      const float len_inv = 1.0f / length;
+      const typename Vec::Reg vlen_inv = Vec::set1(len_inv);
+      int64_t j = 0;
+      for (; j < vec_end; j += Vec::kWidth) {
+        Vec::storeu(op + j, Vec::mul(Vec::loadu(op + j), vlen_inv));
+      }
+      for (; j < block_size; ++j) {
+        op[j] = len_inv * op[j];
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+
+template <typename Vec, typename IndexType>
+bool FusedNBitRowwiseEmbeddingLookupIdxDispatch(
+    const int bit_rate,
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const IndexType* indices,
+    const int64_t* offsets,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  switch (bit_rate) {
+    case 4:
+      return FusedNBitRowwiseEmbeddingLookupIdxImpl<Vec, 4>(
+          block_size,
+          output_size,
+          index_size,
+          data_size,
+          input,
+          indices,
+          offsets,
+          weights,
+          normalize_by_lengths,
+          out);
+    case 2:
+      return FusedNBitRowwiseEmbeddingLookupIdxImpl<Vec, 2>(
+          block_size,
+          output_size,
+          index_size,
+          data_size,
+          input,
+          indices,
+          offsets,
+          weights,
+          normalize_by_lengths,
+          out);
+    default:
+      return false;
+  }
+}
+
+} // namespace
+} // namespace perfkernels
+} // namespace caffe2
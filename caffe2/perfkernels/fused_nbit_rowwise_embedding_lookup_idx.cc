@@ -0,0 +1,242 @@
+#include "caffe2/perfkernels/fused_nbit_rowwise_embedding_lookup_idx.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <c10/util/Half.h>
+#include "caffe2/core/logging.h"
+#include "caffe2/perfkernels/common.h"
+
+namespace caffe2 {
+
+/**
+ * Base implementation does runtime dispatch for each segment of reduction
+ * @return false if there is an out-of-bound error
+ */
+template <typename IndexType, typename OutType>
+static bool FusedNBitRowwiseEmbeddingLookupGenericSlowIdx(
+    const int bit_rate,
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const IndexType* indices,
+    const int64_t* offsets,
+    const float* weights, // optional, can be null for sum reducer
+    bool normalize_by_lengths,
+    OutType* out) {
+  const int num_elem_per_byte = 8 / bit_rate;
+  // block_size is the number of elements and fused_block_size is the size of
+  // an entire row, including scale and bias.
+  const int64_t value_bytes = block_size / num_elem_per_byte;
+  const int64_t fused_block_size = value_bytes + 2 * sizeof(at::Half);
+  int64_t current = 0;
+  for (int m = 0; m < output_size; ++m) {
+    memset(out, 0, sizeof(OutType) * block_size);
+    if (current != offsets[m] - offsets[0]) {
+      return false;
+    }
+    int64_t start_offset = offsets[m];
+    int64_t end_offset = offsets[m + 1];
+    int64_t length = end_offset - start_offset;
+    if (current + length > index_size) {
+      return false;
+    }
+    for (int64_t i = start_offset; i < end_offset; ++i) {
+      int64_t idx = indices[current];
+      if (idx < 0 || idx >= data_size) {
+        return false;
+      }
+#ifdef __GNUC__
+      if (current + 1 < index_size) {
+        __builtin_prefetch(
+            input + fused_block_size * indices[current + 1], 0, 1);
+      }
+#endif // __GNUC__
+
+      const uint8_t* row = input + fused_block_size * idx;
+      at::Half scale_bias[2];
+      memcpy(scale_bias, row + value_bytes, sizeof(scale_bias));
+
+      float weight = 1.0f;
+      if (weights) {
+        weight = weights[current];
+      }
+      const float scale = weight * scale_bias[0];
+      const float bias = weight * scale_bias[1];
+
+      for (int j = 0; j < block_size; ++j) {
+        uint8_t quantized = row[j / num_elem_per_byte];
+        quantized >>= (j % num_elem_per_byte) * bit_rate;
+        quantized &= (1 << bit_rate) - 1;
+        out[j] = std::fma(scale, quantized, out[j] + bias);
+      }
+
+      ++current;
+    }
+    if (normalize_by_lengths && length) {
+      float scale = 1.f / length;
+      for (int j = 0; j < block_size; ++j) {
+        out[j] *= scale;
+      }
+    }
+    out += block_size;
+  }
+  return current == index_size;
+}
+
+// Proxy back to generic implementation
+#define FUSED_NBIT_ROWWISE_EMBEDDING_IDX_SPECIALIZATION(IndexType, OutType)      \
+  bool FusedNBitRowwiseEmbeddingLookupIdx_##IndexType##_##OutType##__base(       \
+      const int bit_rate,                                                        \
+      const int64_t block_size,                                                  \
+      const int64_t output_size,                                                 \
+      const int64_t index_size,                                                  \
+      const int64_t data_size,                                                   \
+      const uint8_t* input,                                                      \
+      const IndexType* indices,                                                  \
+      const int64_t* offsets,                                                    \
+      const float* weights,                                                      \
+      bool normalize_by_lengths,                                                 \
+      OutType* out) {                                                            \
+    return FusedNBitRowwiseEmbeddingLookupGenericSlowIdx<IndexType, OutType>(    \
+        bit_rate,                                                                \
+        block_size,                                                              \
+        output_size,                                                             \
+        index_size,                                                              \
+        data_size,                                                               \
+        input,                                                                   \
+        indices,                                                                 \
+        offsets,                                                                 \
+        weights,                                                                 \
+        normalize_by_lengths,                                                    \
+        out);                                                                    \
+  }                                                                              \
+  decltype(FusedNBitRowwiseEmbeddingLookupIdx_##IndexType##_##OutType##__base)   \
+      FusedNBitRowwiseEmbeddingLookupIdx_##IndexType##_##OutType##__avx2_fma;    \
+  decltype(FusedNBitRowwiseEmbeddingLookupIdx_##IndexType##_##OutType##__base)   \
+      FusedNBitRowwiseEmbeddingLookupIdx_##IndexType##_##OutType##__avx512;      \
+  bool FusedNBitRowwiseEmbeddingLookupIdx_##IndexType##_##OutType(               \
+      const int bit_rate,                                                        \
+      const int64_t block_size,                                                  \
+      const int64_t output_size,                                                 \
+      const int64_t index_size,                                                  \
+      const int64_t data_size,                                                   \
+      const uint8_t* input,                                                      \
+      const IndexType* indices,                                                  \
+      const int64_t* offsets,                                                    \
+      const float* weights,                                                      \
+      bool normalize_by_lengths,                                                 \
+      OutType* out) {                                                            \
+    const int32_t one = 1;                                                       \
+    CAFFE_ENFORCE_EQ(                                                            \
+        reinterpret_cast<const uint8_t*>(&one)[0],                               \
+        1,                                                                       \
+        "FusedNBitRowwiseEmbeddingLookup is not supported on this platform");    \
+    AVX512_DO(                                                                   \
+        FusedNBitRowwiseEmbeddingLookupIdx_##IndexType##_##OutType,              \
+        bit_rate,                                                                \
+        block_size,                                                              \
+        output_size,                                                             \
+        index_size,                                                              \
+        data_size,                                                               \
+        input,                                                                   \
+        indices,                                                                 \
+        offsets,                                                                 \
+        weights,                                                                 \
+        normalize_by_lengths,                                                    \
+        out);                                                                    \
+    AVX2_FMA_DO(                                                                 \
+        FusedNBitRowwiseEmbeddingLookupIdx_##IndexType##_##OutType,              \
+        bit_rate,                                                                \
+        block_size,                                                              \
+        output_size,                                                             \
+        index_size,                                                              \
+        data_size,                                                               \
+        input,                                                                   \
+        indices,                                                                 \
+        offsets,                                                                 \
+        weights,                                                                 \
+        normalize_by_lengths,                                                    \
+        out);                                                                    \
+    BASE_DO(                                                                     \
+        FusedNBitRowwiseEmbeddingLookupIdx_##IndexType##_##OutType,              \
+        bit_rate,                                                                \
+        block_size,                                                              \
+        output_size,                                                             \
+        index_size,                                                              \
+        data_size,                                                               \
+        input,                                                                   \
+        indices,                                                                 \
+        offsets,                                                                 \
+        weights,                                                                 \
+        normalize_by_lengths,                                                    \
+        out);                                                                    \
+  }                                                                              \
+  template <>                                                                    \
+  void FusedNBitRowwiseEmbeddingLookupIdx<IndexType, OutType>(                   \
+      const int bit_rate,                                                        \
+      const int64_t block_size,                                                  \
+      const int64_t output_size,                                                 \
+      const int64_t index_size,                                                  \
+      const int64_t data_size,                                                   \
+      const uint8_t* input,                                                      \
+      const IndexType* indices,                                                  \
+      const int64_t* offsets,                                                    \
+      const float* weights,                                                      \
+      bool normalize_by_lengths,                                                 \
+      OutType* out) {                                                            \
+    CAFFE_ENFORCE(                                                               \
+        bit_rate == 2 || bit_rate == 4,                                          \
+        "FusedNBitRowwiseEmbeddingLookup only supports bit rates 2 and 4, got ", \
+        bit_rate);                                                               \
+    CAFFE_ENFORCE_EQ(                                                            \
+        block_size % (8 / bit_rate),                                             \
+        0,                                                                       \
+        "block size must be divisible by ",                                      \
+        8 / bit_rate);                                                           \
+    bool success = FusedNBitRowwiseEmbeddingLookupIdx_##IndexType##_##OutType(   \
+        bit_rate,                                                                \
+        block_size,                                                              \
+        output_size,                                                             \
+        index_size,                                                              \
+        data_size,                                                               \
+        input,                                                                   \
+        indices,                                                                 \
+        offsets,                                                                 \
+        weights,                                                                 \
+        normalize_by_lengths,                                                    \
+        out);                                                                    \
+    if (success) {                                                               \
+      return;                                                                    \
+    }                                                                            \
+    int64_t current = 0;                                                         \
+    for (int m = 0; m < output_size; ++m) {                                      \
+      for (int64_t i = offsets[m]; i < offsets[m + 1]; ++i) {                    \
+        CAFFE_ENFORCE_LT(current, index_size);                                   \
+        IndexType idx = indices[current];                                        \
+        CAFFE_ENFORCE(                                                           \
+            0 <= idx && idx < data_size,                                         \
+            "Index ",                                                            \
+            current,                                                             \
+            " is out of bounds: ",                                               \
+            idx,                                                                 \
+            ", range 0 to ",                                                     \
+            data_size);                                                          \
+        ++current;                                                               \
+      }                                                                          \
+    }                                                                            \
+    CAFFE_ENFORCE_EQ(                                                            \
+        current,                                                                 \
+        index_size,                                                              \
+        "Your input seems to be incorrect: the sum of lengths values should be " \
+        "the size of the indices tensor, but it appears not.");                  \
+  }
+
+FUSED_NBIT_ROWWISE_EMBEDDING_IDX_SPECIALIZATION(int32_t, float);
+FUSED_NBIT_ROWWISE_EMBEDDING_IDX_SPECIALIZATION(int64_t, float);
+
+#undef FUSED_NBIT_ROWWISE_EMBEDDING_IDX_SPECIALIZATION
+
+} // namespace caffe2
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+namespace caffe2 {
+
+/**
+ * Embedding lookup with reduction over N-bit (N = 2 or 4) fused row-wise
+ * quantized input.
+ *
+ * `input` of size data_size * (block_size / (8 / bit_rate) + 4B)
+ * `indices` of size index_size
+ * `offsets` of size output_size + 1
+ * `weights` nullptr or array of size index_size
+ * `out` of size output_size * block_size
+ *
+ * Every row of the input holds block_size / (8 / bit_rate) bytes with
+ * 8 / bit_rate quantized values each, lowest bits first, followed by an fp16
+ * scale and an fp16 bias. block_size has to be a multiple of 8 / bit_rate.
+ *
+ * Behavior is roughly equivalent to pseudocode:
+ *
+ * pos = 0
+ * for (i = 0..output_size-1)
+ *   for (k = 0..block_size-1)
+ *     out[i*block_size + k] = 0
+ *   length = offsets[i+1] - offsets[i]
+ *   for (j = offsets[i]..offsets[i+1]-1)
+ *     row = input[indices[pos]]
+ *     w = weights ? weights[pos] : 1.0
+ *     for (k = 0..block_size-1)
+ *       out[i*block_size + k] += w * (row.scale * row.q[k] + row.bias)
+ *     pos += 1
+ *   if (normalize_weights && length > 0)
+ *     for (k = 0..block_size-1)
+ *       out[i*block_size + k] /= length
+ *
+ */
+template <typename IndexType, typename OutType>
+void FusedNBitRowwiseEmbeddingLookupIdx(
+    const int bit_rate,
+    const std::int64_t block_size,
+    const std::int64_t output_size,
+    const std::int64_t index_size,
+    const std::int64_t data_size,
+    const std::uint8_t* input,
+    const IndexType* indices,
+    const std::int64_t* offsets,
+    const float* weights, // optional, can be null for non-weighted sum
+    bool normalize_by_lengths,
+    OutType* out);
+
+} // namespace caffe2
@@ -0,0 +1,102 @@
+#include "caffe2/perfkernels/fused_nbit_rowwise_embedding_lookup_idx-impl.h"
+
+namespace caffe2 {
+
+namespace {
+
+struct Avx512Vec {
+  static constexpr int kWidth = 16;
+  using Reg = __m512;
+
+  static Reg set1(float x) {
+    return _mm512_set1_ps(x);
+  }
+  static Reg loadu(const float* p) {
+    return _mm512_loadu_ps(p);
+  }
+  static void storeu(float* p, Reg x) {
+    _mm512_storeu_ps(p, x);
+  }
+  static Reg add(Reg a, Reg b) {
+    return _mm512_add_ps(a, b);
+  }
+  static Reg mul(Reg a, Reg b) {
+    return _mm512_mul_ps(a, b);
+  }
+  static Reg fmadd(Reg a, Reg b, Reg c) {
+    return _mm512_fmadd_ps(a, b, c);
+  }
+
+  // Spreads the 8 / BIT_RATE values of each packed byte over as many 32-bit
+  // lanes with one byte shuffle, then shifts every lane's value down to its
+  // lowest bits.
+  template <int BIT_RATE>
+  struct Unpacker {
+    static constexpr int kElemPerByte = 8 / BIT_RATE;
+    static constexpr int kBytes = kWidth / kElemPerByte;
+
+    Unpacker() {
+      alignas(16) int8_t spread[16];
+      alignas(64) int32_t shift[kWidth];
+      for (int i = 0; i < 16; ++i) {
+        spread[i] = i < kWidth ? i / kElemPerByte : -1;
+      }
+      for (int i = 0; i < kWidth; ++i) {
+        shift[i] = (i % kElemPerByte) * BIT_RATE;
+      }
+      spread_ = _mm_load_si128(reinterpret_cast<const __m128i*>(spread));
+      shift_ = _mm512_load_si512(shift);
+      mask_ = _mm512_set1_epi32((1 << BIT_RATE) - 1);
+    }
+
+    Reg operator()(const uint8_t* p) const {
+      uint64_t bytes = 0;
+      std::memcpy(&bytes, p, kBytes);
+      const __m128i packed = _mm_shuffle_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&bytes)), spread_);
+      const __m512i values =
+          _mm512_srlv_epi32(_mm512_cvtepu8_epi32(packed), shift_);
+      return _mm512_cvtepi32_ps(_mm512_and_si512(values, mask_));
+    }
+
+    __m128i spread_;
+    __m512i shift_;
+    __m512i mask_;
+  };
+};
+
+} // namespace
+
+#define FUSED_NBIT_ROWWISE_EMBEDDING_IDX_AVX512(IndexType)                     \
+  bool FusedNBitRowwiseEmbeddingLookupIdx_##IndexType##_float__avx512(         \
+      const int bit_rate,                                                      \
+      const int64_t block_size,                                                \
+      const int64_t output_size,                                               \
+      const int64_t index_size,                                                \
+      const int64_t data_size,                                                 \
+      const uint8_t* input,                                                    \
+      const IndexType* indices,                                                \
+      const int64_t* offsets,                                                  \
+      const float* weights,                                                    \
+      bool normalize_by_lengths,                                               \
+      float* out) {                                                            \
+    return perfkernels::FusedNBitRowwiseEmbeddingLookupIdxDispatch<Avx512Vec>( \
+        bit_rate,                                                              \
+        block_size,                                                            \
+        output_size,                                                           \
+        index_size,                                                            \
+        data_size,                                                             \
+        input,                                                                 \
+        indices,                                                               \
+        offsets,                                                               \
+        weights,                                                               \
+        normalize_by_lengths,                                                  \
+        out);                                                                  \
+  }
+
+FUSED_NBIT_ROWWISE_EMBEDDING_IDX_AVX512(int32_t);
+FUSED_NBIT_ROWWISE_EMBEDDING_IDX_AVX512(int64_t);
+
+#undef FUSED_NBIT_ROWWISE_EMBEDDING_IDX_AVX512
+
+} // namespace caffe2
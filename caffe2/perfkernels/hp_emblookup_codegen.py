@@ -7,30 +7,73 @@ import sys
 sizeof = {"float": 4, "at::Half": 2, "uint8_t": 1}
 
 
+class Isa(object):
+    """The vector type and intrinsics the kernels of one instruction set use.
+
+    width is the number of floats per vector, mm the prefix of its
+    intrinsics, and half_load / uint8_load the loads of width halfs and width
+    uint8s, which get converted to floats.
+    """
+
+    def __init__(self, name, suffix, vec, width, mm, half_load, uint8_load):
+        self.name = name
+        self.suffix = suffix
+        self.vec = vec
+        self.width = width
+        self.mm = mm
+        self.half_load = half_load
+        self.uint8_load = uint8_load
+
+
+ISAS = {
+    "avx2": Isa(
+        "AVX2",
+        "__avx2_fma",
+        "__m256",
+        8,
+        "_mm256",
+        "_mm_loadu_si128(reinterpret_cast<const __m128i*>",
+        "_mm_loadl_epi64(reinterpret_cast<const __m128i*>",
+    ),
+    "avx512": Isa(
+        "AVX512",
+        "__avx512",
+        "__m512",
+        16,
+        "_mm512",
+        "_mm256_loadu_si256(reinterpret_cast<const __m256i*>",
+        "_mm_loadu_si128(reinterpret_cast<const __m128i*>",
+    ),
+}
+
+
 def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
+    mm = isa.mm
+
     def compute(regid, InType, use_weights, isa, prefetch):
         code = []
 
         if InType == "float":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(vwgt, _mm256_loadu_ps(ip + (%d)), vop%d);"  # noqa
-                % (regid, regid, regid)
+                "        vop%d = %s_fmadd_ps(vwgt, %s_loadu_ps(ip + (%d)), vop%d);"  # noqa
+                % (regid, mm, mm, regid, regid)
             )
         elif InType == "at::Half":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        vop%d = %s_fmadd_ps(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtph_ps(\n"
-                "                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (%d)))),\n"  # noqa
-                "            vop%d);" % (regid, regid, regid)
+                "            %s_cvtph_ps(\n"
+                "                %s(ip + (%d)))),\n"  # noqa
+                "            vop%d);" % (regid, mm, mm, isa.half_load, regid, regid)
             )
         elif InType == "uint8_t":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        vop%d = %s_fmadd_ps(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(\n"
-                "                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ip + (%d))))),\n"  # noqa
-                "            _mm256_add_ps(vop%d, vbio));" % (regid, regid, regid)
+                "            %s_cvtepi32_ps(%s_cvtepu8_epi32(\n"
+                "                %s(ip + (%d))))),\n"  # noqa
+                "            %s_add_ps(vop%d, vbio));"
+                % (regid, mm, mm, mm, isa.uint8_load, regid, mm, regid)
             )
         else:
             assert False
@@ -66,8 +109,10 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
 
     code.append("      " + OutType + "* op = &out[rangeIndex * block_size];")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("      __m256 vop" + str(j) + " = _mm256_setzero_ps();")
+        j = isa.width * i
+        code.append(
+            "      " + isa.vec + " vop" + str(j) + " = " + mm + "_setzero_ps();"
+        )
 
     # inner loop
     if use_offsets:
@@ -120,7 +165,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        " + isa.vec + " vbio = " + mm + "_set1_ps(bio);")
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -128,7 +173,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        " + isa.vec + " vwgt = " + mm + "_set1_ps(wgt);")
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -150,7 +195,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     )
 
     for i in range(0, uf):
-        j = 8 * i
+        j = isa.width * i
         cachelinesize = 64
         byteoffset = sizeof[InType] * j
         prefetch = (byteoffset % cachelinesize) == 0
@@ -162,20 +207,34 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     else:
         code.append("      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("        _mm256_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");")
+        j = isa.width * i
+        code.append(
+            "        " + mm + "_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");"
+        )
     code.append("      } else {")
     # inv of length
     if use_offsets:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / length);")
+        code.append(
+            "        " + isa.vec + " vlen_inv = " + mm + "_set1_ps(1.0f / length);"
+        )
     else:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);")
+        code.append(
+            "        "
+            + isa.vec
+            + " vlen_inv = "
+            + mm
+            + "_set1_ps(1.0f / lengths[rangeIndex]);"
+        )
     for i in range(0, uf):
-        j = 8 * i
+        j = isa.width * i
         code.append(
-            "        _mm256_storeu_ps(&op["
+            "        "
+            + mm
+            + "_storeu_ps(&op["
             + str(j)
-            + "], _mm256_mul_ps("
+            + "], "
+            + mm
+            + "_mul_ps("
             + "vop"
             + str(j)
             + ", vlen_inv));"
@@ -187,34 +246,42 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
 
 
 def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
+    mm = isa.mm
+    width = str(isa.width)
+
     def compute(InType, use_weights, isa):
         code = []
         if InType == "float":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
-                "                  vwgt, _mm256_loadu_ps(&ip[j]), _mm256_loadu_ps(&op[j])));"  # noqa
+                "              %s_fmadd_ps(\n"
+                "                  vwgt, %s_loadu_ps(&ip[j]), %s_loadu_ps(&op[j])));"  # noqa
+                % (mm, mm, mm, mm)
             )
         elif InType == "at::Half":
+            half_load, half_ptr = isa.half_load.split("(")
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
+                "              %s_fmadd_ps(\n"
                 "                  vwgt,\n"
-                "                  _mm256_cvtph_ps(_mm_loadu_si128(\n"
-                "                      reinterpret_cast<const __m128i*>(&ip[j]))),\n"
-                "                  _mm256_loadu_ps(&op[j])));"
+                "                  %s_cvtph_ps(%s(\n"
+                "                      %s(&ip[j]))),\n"
+                "                  %s_loadu_ps(&op[j])));"
+                % (mm, mm, mm, half_load, half_ptr, mm)
             )
         elif InType == "uint8_t":
+            uint8_load, uint8_ptr = isa.uint8_load.split("(")
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
+                "              %s_fmadd_ps(\n"
                 "                  vwgt,\n"
-                "                  _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(\n"  # noqa
-                "                      reinterpret_cast<const __m128i*>(&ip[j])))),\n"
-                "                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));"
+                "                  %s_cvtepi32_ps(%s_cvtepu8_epi32(%s(\n"  # noqa
+                "                      %s(&ip[j])))),\n"
+                "                  %s_add_ps(%s_loadu_ps(&op[j]), vbio)));"
+                % (mm, mm, mm, mm, uint8_load, uint8_ptr, mm, mm)
             )
         else:
             assert False
@@ -249,8 +316,8 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # initialize to 0
     code.append("      int64_t j = 0;")
-    code.append("      for (; j + 8 <= block_size; j += 8) {")
-    code.append("        _mm256_storeu_ps(op + j, _mm256_setzero_ps());")
+    code.append("      for (; j + " + width + " <= block_size; j += " + width + ") {")
+    code.append("        " + mm + "_storeu_ps(op + j, " + mm + "_setzero_ps());")
     code.append("      }")
     code.append("      for (; j < block_size; j++) {")
     code.append("        op[j] = 0.0f;")
@@ -307,7 +374,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        " + isa.vec + " vbio = " + mm + "_set1_ps(bio);")
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -315,7 +382,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        " + isa.vec + " vwgt = " + mm + "_set1_ps(wgt);")
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -337,7 +404,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # compute and store main loop
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append("        for (; j + " + width + " <= block_size; j += " + width + ") {")
     code.extend(compute(InType, use_weights, isa))
     code.append("        }")
     # leftover
@@ -366,12 +433,13 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     else:
         code.append("      if (normalize_by_lengths && lengths[rangeIndex]) {")
         code.append("        float len_inv = 1.0f / lengths[rangeIndex];")
-    code.append("        __m256 vlen_inv = _mm256_set1_ps(len_inv);")
+    code.append("        " + isa.vec + " vlen_inv = " + mm + "_set1_ps(len_inv);")
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append("        for (; j + " + width + " <= block_size; j += " + width + ") {")
     code.append(
-        "          _mm256_storeu_ps(\n"
-        "              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));"
+        "          %s_storeu_ps(\n"
+        "              &op[j], %s_mul_ps(%s_loadu_ps(&op[j]), vlen_inv));"
+        % (mm, mm, mm)
     )
     code.append("        }")
     code.append("        for (; j < block_size; j++) {")
@@ -389,19 +457,30 @@ parser = argparse.ArgumentParser()
 parser.add_argument("-f", "--filename", help="file name")
 parser.add_argument("--fused", action="store_true")
 parser.add_argument("--use-offsets", action="store_true")
+parser.add_argument("--isa", choices=sorted(ISAS.keys()), default="avx2")
 opts = parser.parse_args()
+isa = ISAS[opts.isa]
 if opts.filename:
     filename = opts.filename
 elif opts.fused:
     if opts.use_offsets:
-        filename = "embedding_lookup_fused_8bit_rowwise_idx_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_fused_8bit_rowwise_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_{}.cc".format(opts.isa)
 else:
     if opts.use_offsets:
-        filename = "embedding_lookup_idx_avx2.cc"
+        filename = "embedding_lookup_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_avx2.cc"
+        filename = "embedding_lookup_{}.cc".format(opts.isa)
+
+# The block sizes that get fully unrolled kernels, each with a register per
+# vector of the row. Rows of 8 floats only fill half of an AVX-512 register,
+# so they use the AVX2 kernel, which compiles into the AVX-512 file as well.
+if opts.isa == "avx512":
+    unrolled = [(128, 8, isa), (64, 4, isa), (32, 2, isa), (16, 1, isa)]
+else:
+    unrolled = [(128, 16, isa), (64, 8, isa), (32, 4, isa), (16, 2, isa)]
+unrolled.append((8, 1, ISAS["avx2"]))
 
 options = [
     ["int32_t", "int", "float", "float", "float", "float"],
@@ -423,6 +502,7 @@ code.append("//// --------------------------\n")
 
 code.append("#include <c10/util/Half.h>")
 code.append("#include <immintrin.h>")
+code.append('#include "caffe2/perfkernels/embedding_lookup_prefetch.h"')
 
 code.append("namespace caffe2 {\n")
 for o in options:
@@ -438,7 +518,7 @@ for o in options:
         fn_base = "{}EmbeddingLookup_{}_{}_{}".format(
             prefix, IndexTypeName, InTypeName, OutTypeName
         )
-    suffix = "__avx2_fma"
+    suffix = isa.suffix
     fn = "static bool " + fn_base + suffix
     code.append(fn + "(")
 
@@ -460,13 +540,18 @@ for o in options:
     args.append("    " + OutType + "* out) {")
     code += args
 
-    code.append("  const " + IndexType + " prefdist_T0 = 16;")
     # block_size is the number of elements and fused_block_size is the size of
     # an entire row, including scale and bias.
     offset = (8 // sizeof[InType]) if opts.fused else 0
     code.append(
         "  const {} fused_block_size = block_size + {};".format(IndexType, offset)
     )
+    code.append(
+        "  const {} prefdist_T0 = static_cast<{}>(\n"
+        "      EmbeddingLookupPrefetchDistance(sizeof({}) * fused_block_size));".format(
+            IndexType, IndexType, InType
+        )
+    )
     if opts.use_offsets:
         code.append("  int64_t dataInd = 0;")
     else:
@@ -474,17 +559,16 @@ for o in options:
 
     # code.append("printf(\"calling " + fn + "\\n\");");
 
-    code.append("  if (block_size == 128) {")
-    code += unroll(16, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 64) {")
-    code += unroll(8, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 32) {")
-    code += unroll(4, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 16) {")
-    code += unroll(2, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    for i, (block_size, uf, block_isa) in enumerate(unrolled):
+        code.append(
+            "  {}if (block_size == {}) {{".format("} else " if i else "", block_size)
+        )
+        code += unroll(
+            uf, IndexType, InType, OutType, True, block_isa, opts.fused, opts.use_offsets
+        )
     code.append("  } else {")
     code.append("    // generic code")
-    code += generic(IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    code += generic(IndexType, InType, OutType, True, isa, opts.fused, opts.use_offsets)
     code.append("  }")
     code.append("  return dataInd == index_size;")
 
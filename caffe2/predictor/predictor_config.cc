@@ -1,10 +1,13 @@
 #include "predictor_config.h"
 
 #include <atomic>
+#include <unordered_set>
 
 #include "caffe2/core/init.h"
+#include "caffe2/core/memonger.h"
 #include "caffe2/utils/proto_utils.h"
 #ifdef CAFFE2_OPTIMIZER
+#include "caffe2/opt/bound_shape_inferencer.h"
 #include "caffe2/opt/optimizer.h"
 #endif
 
@@ -35,10 +38,89 @@ const ::google::protobuf::RepeatedPtrField<::std::string>& getBlobs(
   CAFFE_THROW("Blob not found: ", name);
 }
 
+// Infers upper bounds of the shapes of the predict net's blobs, or returns
+// no shapes if they can't be inferred.
+std::unordered_map<std::string, std::vector<int>> inferBlobShapes(
+    const PredictorConfig& config,
+    const PredictorMemoryOptions& options) {
+  std::unordered_map<std::string, std::vector<int>> blob_shapes;
+#ifdef CAFFE2_OPTIMIZER
+  try {
+    BoundShapeInferencer inferencer(
+        BoundShapeSpec(options.max_batch_size, options.max_seq_size));
+    inferencer.InferBoundShapeAndType(
+        *config.predict_net, ShapeInfoMap(), config.ws.get());
+    for (const auto& kv : inferencer.shape_info()) {
+      auto& dims = blob_shapes[kv.first];
+      for (const auto d : kv.second.shape.dims()) {
+        dims.push_back(static_cast<int>(d));
+      }
+    }
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Bound shape inference failed: " << e.what();
+    blob_shapes.clear();
+  }
+#endif
+  return blob_shapes;
+}
+
 } // namespace
 
-PredictorConfig
-makePredictorConfig(const MetaNetDef& def, Workspace* parent, bool run_init) {
+void optimizePredictorMemory(
+    PredictorConfig* config,
+    const PredictorMemoryOptions& options) {
+  if (!options.share_activations) {
+    return;
+  }
+  const auto& net = *config->predict_net;
+  std::unordered_set<std::string> static_blobs{net.external_input().begin(),
+                                               net.external_input().end()};
+  static_blobs.insert(net.external_output().begin(), net.external_output().end());
+  static_blobs.insert(config->input_names.begin(), config->input_names.end());
+  static_blobs.insert(config->output_names.begin(), config->output_names.end());
+  for (const auto& name : config->ws->Blobs()) {
+    static_blobs.insert(name);
+  }
+
+  // Every other blob the ops produce is an activation
+  std::unordered_set<std::string> activations;
+  std::vector<int> op_indices;
+  for (int i = 0; i < net.op_size(); ++i) {
+    for (const auto& output : net.op(i).output()) {
+      if (!static_blobs.count(output)) {
+        activations.insert(output);
+      }
+    }
+    op_indices.push_back(i);
+  }
+  if (activations.empty()) {
+    return;
+  }
+
+  const std::vector<std::string> heads{net.external_input().begin(),
+                                       net.external_input().end()};
+  try {
+    auto optimized = std::make_shared<NetDef>(
+        memonger::compute_blob_recycling_for_dag(
+            net,
+            heads,
+            op_indices,
+            activations,
+            /*namescope=*/"",
+            /*dont_share_blob_names=*/{},
+            inferBlobShapes(*config, options)));
+    config->predict_net = std::move(optimized);
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Memory optimization of the predict net failed: "
+                 << e.what();
+  }
+}
+
+PredictorConfig makePredictorConfig(
+    const MetaNetDef& def,
+    Workspace* parent,
+    bool run_init,
+    const PredictorMemoryOptions& memory_options) {
   const auto& init_net =
       getNet(def, PredictorConsts::default_instance().global_init_net_type());
   const auto& run_net =
@@ -55,6 +137,7 @@ makePredictorConfig(const MetaNetDef& def, Workspace* parent, bool run_init) {
   for (const auto& output : outputs) {
     config.output_names.emplace_back(output);
   }
+  optimizePredictorMemory(&config, memory_options);
   return config;
 }
 
@@ -63,7 +146,8 @@ PredictorConfig makePredictorConfig(
     const NetDef& run_net,
     Workspace* parent,
     bool run_init,
-    int optimization) {
+    int optimization,
+    const PredictorMemoryOptions& memory_options) {
   PredictorConfig config;
   config.ws = std::make_shared<Workspace>(parent);
   auto& ws = *config.ws;
@@ -91,6 +175,7 @@ PredictorConfig makePredictorConfig(
     }
 #endif
   }
+  optimizePredictorMemory(&config, memory_options);
   return config;
 }
 
@@ -41,18 +41,43 @@ struct CAFFE2_API PredictorConfig {
   std::shared_ptr<Workspace> ws;
 };
 
+/**
+ * Memory optimization of the predict net, applied when the predictor config
+ * is made.
+ */
+struct CAFFE2_API PredictorMemoryOptions {
+  // Remaps the activations of the predict net onto a shared set of blobs,
+  // so that activations whose lifetimes don't overlap reuse one buffer.
+  // Parameters, external inputs and outputs and the config's input and
+  // output names keep their own blobs.
+  bool share_activations = false;
+  // Bounds for the shape inference of the activations (see
+  // BoundShapeInferencer), used to share buffers between activations of
+  // similar sizes. Shapes are only inferred in builds with CAFFE2_OPTIMIZER.
+  int64_t max_batch_size = 1;
+  int64_t max_seq_size = 1;
+};
+
 CAFFE2_API Workspace makeWorkspace(std::shared_ptr<PredictorParameters> parameters);
 
+// Applies `options` to the predict net of `config`, whose workspace holds the
+// parameters. Does nothing unless options.share_activations is set.
+CAFFE2_API void optimizePredictorMemory(
+    PredictorConfig* config,
+    const PredictorMemoryOptions& options);
+
 CAFFE2_API PredictorConfig makePredictorConfig(
     const MetaNetDef& net,
     Workspace* parent = nullptr,
-    bool run_init = true);
+    bool run_init = true,
+    const PredictorMemoryOptions& memory_options = PredictorMemoryOptions());
 
 CAFFE2_API PredictorConfig makePredictorConfig(
     const NetDef& init_net,
     const NetDef& run_net,
     Workspace* parent = nullptr,
     bool run_init = true,
-    int optimization = 1);
+    int optimization = 1,
+    const PredictorMemoryOptions& memory_options = PredictorMemoryOptions());
 
 } // namespace caffe2
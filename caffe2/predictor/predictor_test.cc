@@ -2,10 +2,14 @@
 #include "caffe2/core/operator.h"
 #include "caffe2/core/tensor.h"
 #include "caffe2/predictor/predictor.h"
+#include "caffe2/predictor/shared_weights_predictor.h"
 #include "caffe2/utils/math.h"
 
 #include <gtest/gtest.h>
 
+#include <set>
+#include <thread>
+
 namespace caffe2 {
 
 namespace {
@@ -205,4 +209,123 @@ TEST_F(PredictorTest, SimpleBatchSizedMapInput) {
   EXPECT_NEAR(output.front().data<float>()[4], 0.1209, 1E-4);
 }
 
+const char* deepPredictSpec = R"DOC(
+        name: "predict"
+        type: "simple"
+        external_input: "data"
+        external_input: "W"
+        external_input: "b"
+        external_output: "y"
+        op {
+          input: "data"
+          input: "W"
+          input: "b"
+          output: "h1"
+          type: "FC"
+        }
+        op {
+          input: "h1"
+          output: "h2"
+          type: "Relu"
+        }
+        op {
+          input: "h2"
+          output: "h3"
+          type: "Relu"
+        }
+        op {
+          input: "h3"
+          output: "y"
+          type: "Relu"
+        }
+)DOC";
+
+TEST(PredictorMemoryTest, SharesActivations) {
+  PredictorMemoryOptions options;
+  options.share_activations = true;
+  Predictor p(makePredictorConfig(
+      parseNetDef(initSpec),
+      parseNetDef(deepPredictSpec),
+      /*parent=*/nullptr,
+      /*run_init=*/true,
+      /*optimization=*/0,
+      options));
+
+  // h3 is written after h1 is last read, so they share a blob
+  std::set<std::string> blobs;
+  for (const auto& op : p.def().op()) {
+    blobs.insert(op.output().begin(), op.output().end());
+  }
+  EXPECT_LT(blobs.size(), 4);
+  EXPECT_TRUE(blobs.count("y"));
+
+  CPUContext ctx;
+  auto inputData = randomTensor({1, 4}, &ctx);
+  auto* tensor = BlobGetMutableTensor(inputData.get(), CPU);
+  math::Set<float, CPUContext>(
+      4, 1.0f, tensor->template mutable_data<float>(), &ctx);
+  Predictor::TensorList input;
+  input.emplace_back(tensor->Alias());
+  Predictor::TensorList output;
+  ASSERT_TRUE(p(input, &output));
+  ASSERT_EQ(output.size(), 1);
+  EXPECT_FLOAT_EQ(output.front().data<float>()[4], 10.0f);
+}
+
+TEST(SharedWeightsPredictorTest, SharesParametersAcrossThreads) {
+  SharedWeightsPredictor predictor(
+      parseNetDef(initSpec), parseNetDef(predictSpec));
+  ASSERT_TRUE(predictor.parameters()->HasBlob("W"));
+  ASSERT_TRUE(predictor.parameters()->HasBlob("b"));
+
+  constexpr int kNumThreads = 4;
+  std::vector<std::thread> threads;
+  std::vector<float> results(kNumThreads);
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      CPUContext ctx;
+      Predictor::TensorList output;
+      for (int run = 0; run < 3; ++run) {
+        auto inputData = randomTensor({1, 4}, &ctx);
+        math::Set<float, CPUContext>(
+            4,
+            1.0f,
+            BlobGetMutableTensor(inputData.get(), CPU)
+                ->template mutable_data<float>(),
+            &ctx);
+        Predictor::TensorList input;
+        input.emplace_back(BlobGetMutableTensor(inputData.get(), CPU)->Alias());
+        ASSERT_TRUE(predictor(input, &output));
+      }
+      ASSERT_EQ(output.size(), 1);
+      EXPECT_EQ(output.front().size(0), 1);
+      EXPECT_EQ(output.front().size(1), 10);
+      results[i] = output.front().data<float>()[4];
+
+      // Parameters are only held by the shared workspace
+      auto* ws = predictor.threadPredictor().ws();
+      EXPECT_NE(ws, predictor.parameters());
+      EXPECT_EQ(
+          ws->GetBlob("W"),
+          const_cast<Workspace*>(predictor.parameters())->GetBlob("W"));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < kNumThreads; ++i) {
+    // 4 inputs of 1 times weights of 2, plus a bias of 2
+    EXPECT_FLOAT_EQ(results[i], 10.0f);
+  }
+}
+
+TEST(SharedWeightsPredictorTest, RejectsWritesToParameters) {
+  auto predictNet = parseNetDef(predictSpec);
+  predictNet.mutable_op(0)->set_output(0, "W");
+  ASSERT_THROW(
+      SharedWeightsPredictor(parseNetDef(initSpec), predictNet),
+      EnforceNotMet);
+}
+
 } // namespace caffe2
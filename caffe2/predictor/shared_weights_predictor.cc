@@ -0,0 +1,102 @@
+#include "caffe2/predictor/shared_weights_predictor.h"
+
+#include <algorithm>
+
+namespace caffe2 {
+
+SharedWeightsPredictor::SharedWeightsPredictor(
+    const NetDef& init_net,
+    const NetDef& run_net,
+    int optimization,
+    const PredictorMemoryOptions& memory_options)
+    : SharedWeightsPredictor(makePredictorConfig(
+          init_net,
+          run_net,
+          /*parent=*/nullptr,
+          /*run_init=*/true,
+          optimization,
+          memory_options)) {}
+
+SharedWeightsPredictor::SharedWeightsPredictor(PredictorConfig config)
+    : config_(std::move(config)) {
+  for (const auto& name : config_.ws->Blobs()) {
+    if (std::find(
+            config_.input_names.begin(), config_.input_names.end(), name) ==
+        config_.input_names.end()) {
+      parameters_.insert(name);
+    }
+  }
+  for (const auto& op : config_.predict_net->op()) {
+    for (const auto& output : op.output()) {
+      CAFFE_ENFORCE(
+          !parameters_.count(output),
+          "Operator ",
+          op.type(),
+          " of the predict net writes to parameter ",
+          output,
+          ", which is shared by all threads");
+    }
+  }
+}
+
+Predictor& SharedWeightsPredictor::threadPredictor() {
+  auto* predictor = thread_predictor_.get();
+  if (!predictor) {
+    PredictorConfig thread_config;
+    thread_config.parameters = config_.parameters;
+    thread_config.predict_net = config_.predict_net;
+    thread_config.input_names = config_.input_names;
+    thread_config.output_names = config_.output_names;
+    thread_config.parameter_names = config_.parameter_names;
+    thread_config.ws = std::make_shared<Workspace>(config_.ws.get());
+    // The operators bind to their blobs when the net is created, so inputs
+    // must be shadowed before
+    for (const auto& name : config_.input_names) {
+      BlobGetMutableTensor(thread_config.ws->CreateLocalBlob(name), CPU);
+    }
+    thread_predictor_.reset(
+        std::make_unique<Predictor>(std::move(thread_config)));
+    predictor = thread_predictor_.get();
+  }
+  return *predictor;
+}
+
+void SharedWeightsPredictor::enforceIsInput(const std::string& name) const {
+  CAFFE_ENFORCE(
+      !parameters_.count(name),
+      "Input ",
+      name,
+      " is a parameter shared by all threads, list it in the input names of "
+      "the config to give every thread its own blob");
+}
+
+bool SharedWeightsPredictor::operator()(
+    const TensorList& inputs,
+    TensorList* outputs) {
+  for (size_t i = 0; i < inputs.size() &&
+       i < static_cast<size_t>(config_.predict_net->external_input_size());
+       ++i) {
+    enforceIsInput(config_.predict_net->external_input(i));
+  }
+  return threadPredictor()(inputs, outputs);
+}
+
+bool SharedWeightsPredictor::operator()(
+    const TensorMap& inputs,
+    TensorList* outputs) {
+  for (const auto& input : inputs) {
+    enforceIsInput(input.first);
+  }
+  return threadPredictor()(inputs, outputs);
+}
+
+bool SharedWeightsPredictor::operator()(
+    const TensorMap& inputs,
+    TensorMap* outputs) {
+  for (const auto& input : inputs) {
+    enforceIsInput(input.first);
+  }
+  return threadPredictor()(inputs, outputs);
+}
+
+} // namespace caffe2
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+
+#include "caffe2/predictor/ThreadLocalPtr.h"
+#include "caffe2/predictor/predictor.h"
+
+namespace caffe2 {
+
+/**
+ * A predictor that serves one model from many threads while keeping a single
+ * copy of its parameters.
+ *
+ * The init net runs once, into a parameter workspace that is shared by every
+ * thread and never written to afterwards: the constructor enforces that no
+ * operator of the predict net outputs a parameter blob. Each thread that
+ * calls the predictor gets its own Predictor, whose workspace is a child of
+ * the parameter workspace and only holds the inputs and activations of that
+ * thread. Inputs must not be parameters, unless they are listed in the
+ * config's input_names, in which case every thread gets its own blob for
+ * them. Activations are planned once when the config is made (see
+ * PredictorMemoryOptions), so that blobs whose lifetimes don't overlap share
+ * memory, and stay allocated between runs: the first run of a thread sizes
+ * them, and later runs of the same shapes reuse them without allocating. Serving memory is therefore one copy of the model
+ * plus one set of activations per thread.
+ */
+class CAFFE2_API SharedWeightsPredictor {
+ public:
+  using TensorList = Predictor::TensorList;
+  using TensorMap = Predictor::TensorMap;
+
+  // Shares activations by default, see PredictorMemoryOptions
+  SharedWeightsPredictor(
+      const NetDef& init_net,
+      const NetDef& run_net,
+      int optimization = 1,
+      const PredictorMemoryOptions& memory_options = sharedActivations());
+
+  explicit SharedWeightsPredictor(PredictorConfig config);
+
+  // Same as the corresponding Predictor::operator() run by the calling
+  // thread's predictor. The outputs are part of that thread's workspace and
+  // are only valid until its next run.
+  bool operator()(const TensorList& inputs, TensorList* outputs);
+  bool operator()(const TensorMap& inputs, TensorList* outputs);
+  bool operator()(const TensorMap& inputs, TensorMap* outputs);
+
+  const NetDef& def() const {
+    return *config_.predict_net;
+  }
+
+  // The workspace holding the parameters shared by all threads
+  const Workspace* parameters() const {
+    return config_.ws.get();
+  }
+
+  // The predictor of the calling thread, created on first use
+  Predictor& threadPredictor();
+
+ private:
+  static PredictorMemoryOptions sharedActivations() {
+    PredictorMemoryOptions options;
+    options.share_activations = true;
+    return options;
+  }
+
+  void enforceIsInput(const std::string& name) const;
+
+  PredictorConfig config_;
+  // Blobs of the parameter workspace, except for the model's inputs, which
+  // every thread's workspace shadows with its own blob
+  std::set<std::string> parameters_;
+  ThreadLocalPtr<Predictor> thread_predictor_;
+};
+
+} // namespace caffe2
@@ -1,209 +1,251 @@
 #include "rebatching_queue.h"
-#include "caffe2/utils/smart_tensor_printer.h"
 
 namespace caffe2 {
 
-namespace {
-
-// This concat function will always create a new first dimension to concat
-void concat(
+// Copies the rows into the outputs, whose first dimension becomes the number
+// of rows.
+void RebatchingQueue::concat(
     CPUContext& context,
-    const std::vector<std::vector<TensorCPU>>& inputs,
+    const std::vector<Row>& rows,
     const std::vector<TensorCPU*>& outputs) {
-  CAFFE_ENFORCE(!inputs.empty());
-
-  const auto& inputZero = inputs[0];
-  const auto numTensors = inputZero.size();
-  const auto numRows = inputs.size();
+  CAFFE_ENFORCE(!rows.empty());
 
-  // Precompute the output sizes to avoid resizing
-  std::vector<std::vector<int64_t>> outputDims(numTensors);
-
-  for (size_t i = 0; i < numTensors; ++i) {
-    SmartTensorPrinter::PrintTensor(inputZero.at(i));
-    outputDims[i] = inputZero.at(i).sizes().vec();
-    outputDims[i].insert(outputDims[i].begin(), numRows);
-  }
+  const auto& batchZero = *rows[0].batch;
+  const auto numTensors = batchZero.size();
+  const auto numRows = rows.size();
 
   // Resize to the final output size
-  std::vector<void*> destinations(numTensors);
+  std::vector<char*> destinations(numTensors);
   for (size_t i = 0; i < numTensors; ++i) {
-    outputs[i]->Resize(outputDims[i]);
-    destinations[i] = outputs[i]->raw_mutable_data(inputZero[i].meta());
+    auto outputDims = batchZero[i].sizes().vec();
+    outputDims[0] = numRows;
+    outputs[i]->Resize(outputDims);
+    destinations[i] =
+        static_cast<char*>(outputs[i]->raw_mutable_data(batchZero[i].meta()));
   }
 
-  for (size_t i = 0; i < numRows; ++i) {
-    CAFFE_ENFORCE_EQ(inputs[i].size(), numTensors);
+  for (size_t begin = 0; begin < numRows;) {
+    // Rows [begin, end) are consecutive rows of one batch, so they are copied
+    // together.
+    const auto& batch = *rows[begin].batch;
+    size_t end = begin + 1;
+    while (end < numRows && rows[end].batch == rows[begin].batch &&
+           rows[end].index == rows[end - 1].index + 1) {
+      ++end;
+    }
+    CAFFE_ENFORCE_EQ(batch.size(), numTensors);
 
-    for (int j = 0; j < numTensors; ++j) {
-      const auto& input = inputs[i][j];
+    for (size_t j = 0; j < numTensors; ++j) {
+      const auto& input = batch[j];
 
-      CAFFE_ENFORCE(inputZero[j].meta() == input.dtype());
-      CAFFE_ENFORCE_EQ(inputZero[j].itemsize(), input.itemsize());
-      CAFFE_ENFORCE_EQ(inputZero[j].ndim(), input.dim());
-      for (int k = 0; k < input.dim(); ++k) {
-        CAFFE_ENFORCE_EQ(input.sizes()[k], inputZero[j].size(k));
+      CAFFE_ENFORCE(batchZero[j].meta() == input.dtype());
+      CAFFE_ENFORCE_EQ(batchZero[j].itemsize(), input.itemsize());
+      CAFFE_ENFORCE_EQ(batchZero[j].dim(), input.dim());
+      for (int k = 1; k < input.dim(); ++k) {
+        CAFFE_ENFORCE_EQ(input.sizes()[k], batchZero[j].size(k));
       }
 
+      const auto innerSize = input.size_from_dim(1);
+      const auto numItems = innerSize * (end - begin);
       // Skip empty tensors
-      if (input.numel() == 0) {
+      if (numItems == 0) {
         continue;
       }
 
       context.CopyItemsToCPU(
           input.dtype(),
-          input.numel(),
-          input.raw_data() /* src */,
+          numItems,
+          static_cast<const char*>(input.raw_data()) +
+              rows[begin].index * innerSize * input.itemsize() /* src */,
           destinations[j] /* dst */
       );
 
-      destinations[j] =
-          (char*)destinations[j] + input.numel() * input.itemsize();
+      destinations[j] += numItems * input.itemsize();
     }
+    begin = end;
   }
 }
 
-std::vector<std::vector<TensorCPU>> split(
-    CPUContext& context,
-    const std::vector<const TensorCPU*>& inputs) {
-  CAFFE_ENFORCE(!inputs.empty());
-
-  const auto outputSize = inputs[0]->sizes().at(0);
-  std::vector<std::vector<TensorCPU>> outputs(outputSize);
+RebatchingQueue::RebatchingQueue(size_t capacity, size_t numBlobs)
+    : capacity_(capacity),
+      numBlobs_(numBlobs),
+      slots_(new Slot[capacity]) {
+  CAFFE_ENFORCE_GT(capacity, 0);
+  for (size_t i = 0; i < capacity; ++i) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
 
-  for (const auto* inputPtr : inputs) {
-    CAFFE_ENFORCE(inputPtr);
+RebatchingQueue::~RebatchingQueue() {
+  close();
+}
 
-    const auto& input = *inputPtr;
-    const auto innerSize = input.size_from_dim(1);
-    const auto itemSize = input.dtype().itemsize();
+bool RebatchingQueue::canRead() const {
+  return tail_.load() < head_.load();
+}
 
-    auto outputDims = input.sizes().vec();
-    CAFFE_ENFORCE(!outputDims.empty());
-    outputDims.erase(outputDims.begin());
-    CAFFE_ENFORCE_EQ(input.sizes().at(0), outputSize);
+bool RebatchingQueue::canWrite() const {
+  return tail_.load() + capacity() > head_.load();
+}
 
-    for (int i = 0; i < outputSize; ++i) {
-      outputs[i].push_back(Tensor(outputDims, CPU));
-      context.CopyItemsToCPU(
-          input.dtype(),
-          innerSize,
-          (char*)input.raw_data() + i * innerSize * itemSize /* src */,
-          outputs[i].back().raw_mutable_data(input.dtype()) /* dst */);
+bool RebatchingQueue::tryEnqueue(Row& row) {
+  uint64_t pos = head_.load(std::memory_order_relaxed);
+  for (;;) {
+    auto& slot = slots_[pos % capacity()];
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<int64_t>(sequence - pos);
+    if (diff == 0) {
+      if (head_.compare_exchange_weak(pos, pos + 1)) {
+        slot.row = std::move(row);
+        slot.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      // The slot still holds the element of the previous round, so the queue
+      // is full.
+      return false;
+    } else {
+      pos = head_.load(std::memory_order_relaxed);
     }
   }
-
-  return outputs;
 }
-} // anonymous namespace
 
-RebatchingQueue::RebatchingQueue(size_t capacity, size_t numBlobs)
-    : capacity_(capacity), numBlobs_(numBlobs), queue_(capacity) {}
+bool RebatchingQueue::tryDequeue(Row* row) {
+  uint64_t pos = tail_.load(std::memory_order_relaxed);
+  for (;;) {
+    auto& slot = slots_[pos % capacity()];
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<int64_t>(sequence - (pos + 1));
+    if (diff == 0) {
+      if (tail_.compare_exchange_weak(pos, pos + 1)) {
+        *row = std::move(slot.row);
+        slot.row = Row();
+        slot.sequence.store(pos + capacity(), std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      // The element at pos hasn't been written yet.
+      return false;
+    } else {
+      pos = tail_.load(std::memory_order_relaxed);
+    }
+  }
+}
 
-RebatchingQueue::~RebatchingQueue() {
-  close();
+template <typename Predicate>
+void RebatchingQueue::wait(
+    std::condition_variable& cv,
+    std::atomic<int>& waiters,
+    Predicate predicate) {
+  // The increment is ordered before the predicate reads head_ and tail_, and
+  // the other side updates them before it reads waiters, so either the
+  // predicate sees the update or the other side sees the waiter and notifies.
+  waiters.fetch_add(1);
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv.wait(lock, predicate);
+  }
+  waiters.fetch_sub(1);
 }
 
-bool RebatchingQueue::canRead() const {
-  return tail_ < head_;
+void RebatchingQueue::notify(
+    std::condition_variable& cv,
+    const std::atomic<int>& waiters) {
+  if (waiters.load() > 0) {
+    // Taking the mutex makes the notification wait for a waiter that has
+    // checked its predicate to go to sleep.
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    cv.notify_all();
+  }
 }
 
 bool RebatchingQueue::dequeue(
     CPUContext& context,
     size_t numElements,
     const std::vector<TensorCPU*>& outputs) {
-  std::vector<std::vector<TensorCPU>> results;
-  results.reserve(numElements);
-
-  for (;;) {
-    if (results.size() == numElements) {
-      break;
+  std::vector<Row> rows;
+  rows.reserve(numElements);
+
+  while (rows.size() < numElements) {
+    Row row;
+    if (tryDequeue(&row)) {
+      rows.push_back(std::move(row));
+      notify(cvOverflow_, waitingProducers_);
+      continue;
     }
 
-    {
-      std::unique_lock<std::mutex> lock(mutex_);
-
-      cvEmpty_.wait(lock, [this] { return canRead() || isClosed_; });
-
-      // We only want to stop reading if the queue is empty and closed
-      if (!canRead() && isClosed_) {
-        break;
-      }
-
-      do {
-        results.push_back(std::move(queue_[tail_++ % capacity()]));
-      } while (canRead() && results.size() < numElements);
+    // We only want to stop reading if the queue is empty and closed
+    if (isClosed_ && !canRead()) {
+      break;
     }
 
-    if (numElements == 1) {
-      cvOverflow_.notify_one();
-    } else {
-      cvOverflow_.notify_all();
-    }
+    wait(cvEmpty_, waitingConsumers_, [this] {
+      return canRead() || isClosed_;
+    });
   }
 
-  if (results.empty()) {
+  if (rows.empty()) {
     return false;
   }
 
-  concat(context, results, outputs);
+  concat(context, rows, outputs);
 
   return true;
 }
 
-bool RebatchingQueue::canWrite() const {
-  return tail_ + capacity() > head_;
-}
-
 bool RebatchingQueue::enqueueOne(
     CPUContext& /*context*/,
     const std::vector<const TensorCPU*>& inputs) {
-  std::vector<std::vector<TensorCPU>> splittedInputs;
-  splittedInputs.emplace_back();
-  auto& tensorVector = splittedInputs.back();
-  tensorVector.reserve(inputs.size());
+  auto batch = std::make_shared<Batch>();
+  batch->reserve(inputs.size());
   for (const auto* tensorPtr : inputs) {
-    tensorVector.push_back(tensorPtr->Clone());
+    batch->push_back(tensorPtr->Clone());
+    // A batch of one row.
+    auto dims = batch->back().sizes().vec();
+    dims.insert(dims.begin(), 1);
+    batch->back().Reshape(dims);
   }
 
-  return enqueue(std::move(splittedInputs));
+  return enqueue(std::move(batch));
 }
 
 bool RebatchingQueue::enqueueMany(
-    CPUContext& context,
+    CPUContext& /*context*/,
     const std::vector<const TensorCPU*>& inputs) {
   CAFFE_ENFORCE_EQ(numBlobs_, inputs.size());
+  CAFFE_ENFORCE(!inputs.empty());
 
-  std::vector<std::vector<TensorCPU>> splittedInputs;
-  splittedInputs = split(context, inputs);
-  return enqueue(std::move(splittedInputs));
-}
-
-bool RebatchingQueue::enqueue(
-    std::vector<std::vector<TensorCPU>> splittedInputs) {
-  int idx = 0;
-  for (;;) {
-    if (idx >= splittedInputs.size()) {
-      break;
-    }
-
-    {
-      std::unique_lock<std::mutex> lock(mutex_);
+  const auto numRows = inputs[0]->sizes().at(0);
+  auto batch = std::make_shared<Batch>();
+  batch->reserve(inputs.size());
+  for (const auto* inputPtr : inputs) {
+    CAFFE_ENFORCE(inputPtr);
+    CAFFE_ENFORCE(inputPtr->dim() > 0);
+    CAFFE_ENFORCE_EQ(inputPtr->size(0), numRows);
+    batch->push_back(inputPtr->Clone());
+  }
 
-      cvOverflow_.wait(lock, [this] { return canWrite() || isClosed_; });
+  return enqueue(std::move(batch));
+}
 
+bool RebatchingQueue::enqueue(std::shared_ptr<const Batch> batch) {
+  const int64_t numRows = batch->empty() ? 0 : batch->front().size(0);
+  for (int64_t i = 0; i < numRows; ++i) {
+    Row row{batch, i};
+    for (;;) {
       if (isClosed_) {
         // If we are here it means that we didn't apply the entire batch and if
         // we get closed in the middle of enquing we treat it as a non-success.
         return false;
       }
-
-      do {
-        queue_[head_++ % capacity()] = std::move(splittedInputs[idx++]);
-      } while (canWrite() && idx < splittedInputs.size());
+      if (tryEnqueue(row)) {
+        break;
+      }
+      wait(cvOverflow_, waitingProducers_, [this] {
+        return canWrite() || isClosed_;
+      });
     }
-
-    cvEmpty_.notify_all();
+    notify(cvEmpty_, waitingConsumers_);
   }
 
   return true;
@@ -218,7 +260,6 @@ size_t RebatchingQueue::numBlobs() const {
 }
 
 bool RebatchingQueue::isClosed() const {
-  std::lock_guard<std::mutex> g(mutex_);
   return isClosed_;
 }
 
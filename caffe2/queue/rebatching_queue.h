@@ -13,10 +13,15 @@
 
 namespace caffe2 {
 
-// TODO: This is a very naive implementation with a single mutex. We can do the
-// atomic index + circular queue optimizations or pull something more
-// heavy-weight later
-
+// A bounded queue of rows, where a row is the element at one index of the
+// first dimension of every blob of an enqueued batch.
+//
+// Enqueuing copies the batch once, and the queue holds references to its
+// rows; dequeuing copies the rows straight into the outputs, with one copy
+// per run of consecutive rows of a batch. The queue itself is a ring of slots
+// with per-slot sequence numbers, so producers and consumers only contend on
+// one atomic index each. They fall back to waiting on a condition variable
+// when the queue is full or empty.
 class RebatchingQueue {
  public:
   RebatchingQueue(size_t capacity, size_t numBlobs);
@@ -45,24 +50,59 @@ class RebatchingQueue {
   void close();
 
  private:
-  bool enqueue(std::vector<std::vector<TensorCPU>> splittedInputs);
+  // The tensors of an enqueued batch, with its rows along the first dimension.
+  using Batch = std::vector<TensorCPU>;
+
+  struct Row {
+    std::shared_ptr<const Batch> batch;
+    int64_t index{0};
+  };
+
+  struct Slot {
+    // pos when the slot is free for the element at pos, and pos + 1 when it
+    // holds it.
+    std::atomic<uint64_t> sequence;
+    Row row;
+  };
+
+  bool enqueue(std::shared_ptr<const Batch> batch);
+
+  static void concat(
+      CPUContext& context,
+      const std::vector<Row>& rows,
+      const std::vector<TensorCPU*>& outputs);
+
+  bool tryEnqueue(Row& row);
+  bool tryDequeue(Row* row);
 
   bool canWrite() const;
   bool canRead() const;
 
+  // Waits on `cv` until `predicate` holds, counting the thread in `waiters` so
+  // that the other side only takes the mutex to notify when someone waits.
+  template <typename Predicate>
+  void wait(
+      std::condition_variable& cv,
+      std::atomic<int>& waiters,
+      Predicate predicate);
+  void notify(std::condition_variable& cv, const std::atomic<int>& waiters);
+
   const size_t capacity_;
   const size_t numBlobs_;
 
   mutable std::mutex mutex_;
 
-  bool isClosed_{false};
+  std::atomic<bool> isClosed_{false};
 
-  uint64_t head_{0};
-  uint64_t tail_{0};
+  std::unique_ptr<Slot[]> slots_;
+
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::atomic<uint64_t> tail_{0};
+
+  std::atomic<int> waitingProducers_{0};
+  std::atomic<int> waitingConsumers_{0};
 
   std::condition_variable cvEmpty_;
   std::condition_variable cvOverflow_;
-
-  std::vector<std::vector<TensorCPU>> queue_;
 };
 } // caffe2
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstring>
 #include <cerrno>
@@ -5,6 +7,11 @@
 #include <ostream>
 #include <fstream>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include <c10/core/Allocator.h>
 #include <c10/core/Backend.h>
 
@@ -148,11 +155,14 @@ constexpr int MZ_ZIP_LOCAL_DIR_HEADER_SIZE = 30;
 constexpr int MZ_ZIP_LDH_FILENAME_LEN_OFS = 26;
 constexpr int MZ_ZIP_LDH_EXTRA_LEN_OFS = 28;
 
+// Returns the size of the extra field that aligns the data of a record at
+// CURSOR, and sets DATA_POS to the offset of the data.
 static size_t getPadding(
     size_t cursor,
     size_t filename_size,
     size_t size,
-    std::string& padding_buf) {
+    std::string& padding_buf,
+    size_t* data_pos = nullptr) {
   size_t start = cursor + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_size +
       sizeof(mz_uint16) * 2;
   if (size >= MZ_UINT32_MAX || cursor >= MZ_UINT32_MAX) {
@@ -167,6 +177,9 @@ static size_t getPadding(
   size_t mod = start % kFieldAlignment;
   size_t next_offset = (mod == 0) ? start : (start + kFieldAlignment - mod);
   size_t padding_size = next_offset - start;
+  if (data_pos) {
+    *data_pos = next_offset;
+  }
   size_t padding_size_plus_fbxx = padding_size + 4;
   if (padding_buf.size() < padding_size_plus_fbxx) {
     padding_buf.append(padding_size_plus_fbxx - padding_buf.size(), 'Z');
@@ -217,6 +230,17 @@ std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), key, &stat);
   valid("retrieving file meta-data for ", name.c_str());
+  // Records written by PyTorchStreamWriter are stored uncompressed and
+  // aligned, so readers that have them in memory don't need to copy them.
+  if (stat.m_method == 0 && stat.m_comp_size == stat.m_uncomp_size) {
+    size_t offset = getRecordOffset(name);
+    if (offset % kFieldAlignment == 0) {
+      at::DataPtr mapped = in_->map(offset, stat.m_uncomp_size);
+      if (mapped) {
+        return std::make_tuple(std::move(mapped), stat.m_uncomp_size);
+      }
+    }
+  }
   void * ptr = malloc(stat.m_uncomp_size);
   mz_zip_reader_extract_to_mem(ar_.get(), key, ptr, stat.m_uncomp_size, 0);
   valid("reading file ", name.c_str());
@@ -225,6 +249,35 @@ std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string
   return std::make_tuple(std::move(retval), stat.m_uncomp_size);
 }
 
+std::vector<std::tuple<at::DataPtr, size_t>> PyTorchStreamReader::getRecords(
+    const std::vector<std::string>& names) {
+  std::vector<std::tuple<at::DataPtr, size_t>> records(names.size());
+  std::vector<ReadAdapterInterface::ReadRequest> requests;
+  for (size_t i = 0; i < names.size(); ++i) {
+    mz_zip_archive_file_stat stat;
+    mz_zip_reader_file_stat(ar_.get(), getRecordID(names[i]), &stat);
+    valid("retrieving file meta-data for ", names[i].c_str());
+    if (stat.m_method != 0 || stat.m_comp_size != stat.m_uncomp_size) {
+      records[i] = getRecord(names[i]);
+      continue;
+    }
+    size_t size = stat.m_uncomp_size;
+    size_t offset = getRecordOffset(names[i]);
+    at::DataPtr data;
+    if (offset % kFieldAlignment == 0) {
+      data = in_->map(offset, size);
+    }
+    if (!data) {
+      void* ptr = malloc(size);
+      data = at::DataPtr(ptr, ptr, free, at::kCPU);
+      requests.push_back({offset, ptr, size});
+    }
+    records[i] = std::make_tuple(std::move(data), size);
+  }
+  in_->readMany(requests, "reading records");
+  return records;
+}
+
 static int64_t read_le_16(uint8_t* buf) {
   return buf[0] + (buf[1] << 8);
 }
@@ -257,6 +310,9 @@ size_t ostream_write_func(
     const void* pBuf,
     size_t n) {
   auto self = static_cast<PyTorchStreamWriter*>(pOpaque);
+  if (self->fd_ >= 0) {
+    return self->writeAt(file_ofs, pBuf, n);
+  }
   if (self->current_pos_ != file_ofs) {
     CAFFE_THROW("unexpected pos ", self->current_pos_, " vs ", file_ofs);
   }
@@ -268,8 +324,84 @@ size_t ostream_write_func(
   return ret;
 }
 
-PyTorchStreamWriter::PyTorchStreamWriter(std::string file_name)
-    : archive_name_(basename(file_name)) {
+#ifndef _WIN32
+static bool pwriteAll(int fd, const char* buf, size_t n, uint64_t pos) {
+  while (n > 0) {
+    ssize_t ret = ::pwrite(fd, buf, n, pos);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    buf += ret;
+    n -= ret;
+    pos += ret;
+  }
+  return true;
+}
+#endif
+
+// The CRC-32 of the concatenation of two buffers, from their CRCs and the size
+// of the second one, as in zlib's crc32_combine(): appending LEN2 zero bytes
+// to the first buffer is a linear map on its CRC, applied by squaring the
+// matrix of the one-bit shift for each bit of LEN2.
+static uint32_t gf2MatrixTimes(const uint32_t* mat, uint32_t vec) {
+  uint32_t sum = 0;
+  for (; vec; vec >>= 1, ++mat) {
+    if (vec & 1) {
+      sum ^= *mat;
+    }
+  }
+  return sum;
+}
+
+static void gf2MatrixSquare(uint32_t* square, const uint32_t* mat) {
+  for (int n = 0; n < 32; ++n) {
+    square[n] = gf2MatrixTimes(mat, mat[n]);
+  }
+}
+
+static uint32_t crc32Combine(uint32_t crc1, uint32_t crc2, uint64_t len2) {
+  if (len2 == 0) {
+    return crc1;
+  }
+  uint32_t even[32];
+  uint32_t odd[32];
+  // The operator for one zero bit.
+  odd[0] = 0xedb88320UL;
+  uint32_t row = 1;
+  for (int n = 1; n < 32; ++n) {
+    odd[n] = row;
+    row <<= 1;
+  }
+  // Two and then four zero bits.
+  gf2MatrixSquare(even, odd);
+  gf2MatrixSquare(odd, even);
+  // Each iteration squares the operator again, starting with one zero byte.
+  do {
+    gf2MatrixSquare(even, odd);
+    if (len2 & 1) {
+      crc1 = gf2MatrixTimes(even, crc1);
+    }
+    len2 >>= 1;
+    if (len2 == 0) {
+      break;
+    }
+    gf2MatrixSquare(odd, even);
+    if (len2 & 1) {
+      crc1 = gf2MatrixTimes(odd, crc1);
+    }
+    len2 >>= 1;
+  } while (len2 != 0);
+  return crc1 ^ crc2;
+}
+
+PyTorchStreamWriter::PyTorchStreamWriter(
+    std::string file_name,
+    size_t num_write_threads)
+    : archive_name_(basename(file_name)),
+      num_write_threads_(num_write_threads) {
   setup(file_name);
 }
 
@@ -287,7 +419,18 @@ void PyTorchStreamWriter::setup(const string& file_name) {
   if (archive_name_.size() == 0) {
     CAFFE_THROW("invalid file name: ", file_name);
   }
-  if (!writer_func_) {
+#ifndef _WIN32
+  if (!writer_func_ && num_write_threads_ > 1) {
+    fd_ = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd_ < 0) {
+      CAFFE_THROW(
+          "open file failed, file path: ", file_name, ": ", strerror(errno));
+    }
+    write_pool_ = std::make_unique<c10::ThreadPool>(
+        static_cast<int>(num_write_threads_));
+  }
+#endif
+  if (!writer_func_ && fd_ < 0) {
     file_stream_.open(
         file_name,
         std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
@@ -317,9 +460,19 @@ void PyTorchStreamWriter::writeRecord(
   AT_ASSERT(!finalized_);
   AT_ASSERT(!archive_name_plus_slash_.empty());
   std::string full_name = archive_name_plus_slash_ + name;
-  size_t padding_size =
-      getPadding(ar_->m_archive_size, full_name.size(), size, padding_);
+  size_t data_pos = 0;
+  size_t padding_size = getPadding(
+      ar_->m_archive_size, full_name.size(), size, padding_, &data_pos);
   uint32_t flags = compress ? MZ_BEST_COMPRESSION : 0;
+  uint32_t crc32 = 0;
+  if (write_pool_ && !compress && size >= 2 * kMinParallelWriteChunkSize) {
+    // Write the data first, at the offset miniz will put it at, and have miniz
+    // only write the headers around it.
+    crc32 = writeChunks(data, size, data_pos);
+    flags |= MZ_ZIP_FLAG_PRECOMPUTED_CRC32;
+    written_data_ = data;
+    written_pos_ = data_pos;
+  }
   mz_zip_writer_add_mem_ex_v2(
       ar_.get(),
       full_name.c_str(),
@@ -329,15 +482,67 @@ void PyTorchStreamWriter::writeRecord(
       0,
       flags,
       0,
-      0,
+      crc32,
       nullptr,
       padding_.c_str(),
       padding_size,
       nullptr,
       0);
+  written_data_ = nullptr;
   valid("writing file ", name.c_str());
 }
 
+uint32_t PyTorchStreamWriter::writeChunks(
+    const void* data,
+    size_t size,
+    uint64_t pos) {
+  size_t chunk_size = std::max(
+      kMinParallelWriteChunkSize,
+      (size + num_write_threads_ - 1) / num_write_threads_);
+  size_t num_chunks = (size + chunk_size - 1) / chunk_size;
+  std::vector<uint32_t> crcs(num_chunks);
+  std::atomic<bool> failed{false};
+  for (size_t i = 0; i < num_chunks; ++i) {
+    write_pool_->run([&, i]() {
+      const char* chunk = static_cast<const char*>(data) + i * chunk_size;
+      size_t n = std::min(chunk_size, size - i * chunk_size);
+      crcs[i] = (uint32_t)mz_crc32(
+          MZ_CRC32_INIT, reinterpret_cast<const mz_uint8*>(chunk), n);
+#ifndef _WIN32
+      if (!pwriteAll(fd_, chunk, n, pos + i * chunk_size)) {
+        failed = true;
+      }
+#endif
+    });
+  }
+  write_pool_->waitWorkComplete();
+  if (failed) {
+    err_seen_ = true;
+  }
+  uint32_t crc = crcs[0];
+  for (size_t i = 1; i < num_chunks; ++i) {
+    crc = crc32Combine(
+        crc, crcs[i], std::min(chunk_size, size - i * chunk_size));
+  }
+  return crc;
+}
+
+size_t PyTorchStreamWriter::writeAt(uint64_t pos, const void* buf, size_t n) {
+  if (buf == written_data_) {
+    if (pos != written_pos_) {
+      CAFFE_THROW("unexpected pos ", written_pos_, " vs ", pos);
+    }
+    return n;
+  }
+#ifndef _WIN32
+  if (!pwriteAll(fd_, static_cast<const char*>(buf), n, pos)) {
+    err_seen_ = true;
+    return 0;
+  }
+#endif
+  return n;
+}
+
 void PyTorchStreamWriter::writeEndOfFile() {
   AT_ASSERT(!finalized_);
   finalized_ = true;
@@ -347,6 +552,19 @@ void PyTorchStreamWriter::writeEndOfFile() {
   if (file_stream_.is_open()) {
     file_stream_.close();
   }
+#ifndef _WIN32
+  if (fd_ >= 0) {
+    int ret = ::close(fd_);
+    fd_ = -1;
+    if (ret != 0) {
+      CAFFE_THROW(
+          "PytorchStreamWriter failed closing archive ",
+          archive_name_,
+          ": ",
+          strerror(errno));
+    }
+  }
+#endif
 }
 
 void PyTorchStreamWriter::valid(const char* what, const char* info) {
@@ -9,6 +9,7 @@
 
 #include <c10/core/Allocator.h>
 #include <c10/core/Backend.h>
+#include <c10/core/thread_pool.h>
 
 #include "caffe2/serialize/istream_adapter.h"
 #include "caffe2/serialize/read_adapter_interface.h"
@@ -101,6 +102,9 @@ constexpr uint64_t kProducedFileFormatVersion = 0x3L;
 
 // Writer-specific constants
 constexpr uint64_t kFieldAlignment = 64;
+// Uncompressed records are written by several threads in chunks of at least
+// this size when the writer has more than one write thread.
+constexpr size_t kMinParallelWriteChunkSize = 4 << 20;
 
 class CAFFE2_API PyTorchStreamReader final {
  public:
@@ -110,6 +114,12 @@ class CAFFE2_API PyTorchStreamReader final {
 
   // return dataptr, size
   std::tuple<at::DataPtr, size_t> getRecord(const std::string& name);
+  // Like getRecord() for each name, except that the records stored
+  // uncompressed that the reader can't map are read with one readMany() call,
+  // so that readers such as ParallelFileAdapter read them concurrently. Like
+  // mapped records, they aren't checked against their CRC-32.
+  std::vector<std::tuple<at::DataPtr, size_t>> getRecords(
+      const std::vector<std::string>& names);
   size_t getRecordOffset(const std::string& name);
   bool hasRecord(const std::string& name);
   std::vector<std::string> getAllRecords();
@@ -136,7 +146,13 @@ class CAFFE2_API PyTorchStreamReader final {
 
 class CAFFE2_API PyTorchStreamWriter final {
  public:
-  explicit PyTorchStreamWriter(std::string archive_name);
+  // With NUM_WRITE_THREADS > 1, large uncompressed records are split into
+  // chunks that are checksummed and written to their offsets in the file by
+  // that many threads, straight from the buffer passed to writeRecord(), which
+  // returns once the whole record is written. This is ignored on Windows.
+  explicit PyTorchStreamWriter(
+      std::string archive_name,
+      size_t num_write_threads = 1);
   explicit PyTorchStreamWriter(
       const std::function<size_t(const void*, size_t)>& writer_func);
 
@@ -160,6 +176,8 @@ class CAFFE2_API PyTorchStreamWriter final {
  private:
   void setup(const std::string& file_name);
   void valid(const char* what, const char* info = "");
+  uint32_t writeChunks(const void* data, size_t size, uint64_t pos);
+  size_t writeAt(uint64_t pos, const void* buf, size_t n);
   size_t current_pos_ = 0;
   std::unique_ptr<mz_zip_archive> ar_;
   std::string archive_name_;
@@ -167,6 +185,13 @@ class CAFFE2_API PyTorchStreamWriter final {
   std::string padding_;
   std::ofstream file_stream_;
   std::function<size_t(const void*, size_t)> writer_func_;
+  // Set instead of file_stream_ when writing with several threads.
+  int fd_ = -1;
+  size_t num_write_threads_ = 1;
+  std::unique_ptr<c10::ThreadPool> write_pool_;
+  // The data of the current record, if writeChunks() already wrote it.
+  const void* written_data_ = nullptr;
+  uint64_t written_pos_ = 0;
   bool finalized_ = false;
   bool err_seen_ = false;
   friend size_t ostream_write_func(
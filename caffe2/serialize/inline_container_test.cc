@@ -1,10 +1,14 @@
 #include <cstdio>
 #include <string>
 #include <array>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "caffe2/serialize/inline_container.h"
+#include "caffe2/serialize/mmap_file_adapter.h"
+#include "caffe2/serialize/parallel_file_adapter.h"
+#include "miniz.h"
 
 namespace caffe2 {
 namespace serialize {
@@ -63,6 +67,145 @@ TEST(PyTorchStreamWriterAndReader, SaveAndLoad) {
   ASSERT_EQ(memcmp(the_file.c_str() + off2, data2.data(), data2.size()), 0);
 }
 
+TEST(PyTorchStreamWriterAndReader, LoadFromMmap) {
+  std::ostringstream oss;
+  PyTorchStreamWriter writer([&](const void* b, size_t n) -> size_t {
+    oss.write(static_cast<const char*>(b), n);
+    return oss ? n : 0;
+  });
+  std::array<char, 200> data;
+  for (int i = 0; i < data.size(); ++i) {
+    data[i] = i;
+  }
+  writer.writeRecord("key", data.data(), data.size());
+  writer.writeEndOfFile();
+
+  std::string the_file = oss.str();
+  const char* file_name = "output_mmap.zip";
+  std::ofstream out(file_name);
+  out.write(the_file.c_str(), the_file.size());
+  out.close();
+
+  at::DataPtr data_ptr;
+  int64_t size;
+  const void* first_ptr;
+  {
+    PyTorchStreamReader reader(std::make_unique<MmapFileAdapter>(file_name));
+    std::tie(data_ptr, size) = reader.getRecord("key");
+    ASSERT_EQ(size, data.size());
+    ASSERT_EQ(memcmp(data_ptr.get(), data.data(), data.size()), 0);
+    // Both reads of the record point into the same mapping.
+    first_ptr = data_ptr.get();
+    ASSERT_EQ(std::get<0>(reader.getRecord("key")).get(), first_ptr);
+  }
+  // The record outlives the reader, and writes to it don't reach the file.
+  static_cast<char*>(data_ptr.get())[0] = 42;
+  data_ptr.clear();
+  PyTorchStreamReader reader(std::make_unique<MmapFileAdapter>(file_name));
+  std::tie(data_ptr, size) = reader.getRecord("key");
+  ASSERT_EQ(static_cast<char*>(data_ptr.get())[0], 0);
+  std::remove(file_name);
+}
+
+TEST(PyTorchStreamWriterAndReader, ParallelWrites) {
+  const char* file_name = "output_parallel.zip";
+  // Large enough to be split into chunks, and not a multiple of their size.
+  std::vector<char> data1(3 * kMinParallelWriteChunkSize + 17);
+  for (size_t i = 0; i < data1.size(); ++i) {
+    data1[i] = static_cast<char>(i * 31 + i / 4096);
+  }
+  std::array<char, 100> data2;
+  for (int i = 0; i < data2.size(); ++i) {
+    data2[i] = i;
+  }
+  {
+    PyTorchStreamWriter writer(file_name, 4);
+    writer.writeRecord("key1", data1.data(), data1.size());
+    writer.writeRecord("key2", data2.data(), data2.size());
+    writer.writeEndOfFile();
+  }
+
+  PyTorchStreamReader reader(file_name);
+  at::DataPtr data_ptr;
+  int64_t size;
+  std::tie(data_ptr, size) = reader.getRecord("key1");
+  ASSERT_EQ(size, data1.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+  ASSERT_EQ(reader.getRecordOffset("key1") % kFieldAlignment, 0);
+  std::tie(data_ptr, size) = reader.getRecord("key2");
+  ASSERT_EQ(size, data2.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), data2.data(), data2.size()), 0);
+
+  // The reader doesn't check CRCs, so check the combined one here.
+  std::ifstream in(file_name, std::ios::binary);
+  std::string the_file(
+      (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  mz_zip_archive ar;
+  memset(&ar, 0, sizeof(ar));
+  ASSERT_TRUE(mz_zip_reader_init_mem(&ar, the_file.data(), the_file.size(), 0));
+  int index = mz_zip_reader_locate_file(&ar, "output_parallel/key1", nullptr, 0);
+  ASSERT_GE(index, 0);
+  mz_zip_archive_file_stat stat;
+  ASSERT_TRUE(mz_zip_reader_file_stat(&ar, index, &stat));
+  ASSERT_EQ(
+      stat.m_crc32,
+      mz_crc32(
+          MZ_CRC32_INIT,
+          reinterpret_cast<const mz_uint8*>(data1.data()),
+          data1.size()));
+  mz_zip_reader_end(&ar);
+  std::remove(file_name);
+}
+
+TEST(PyTorchStreamWriterAndReader, ParallelReads) {
+  const char* file_name = "output_parallel_reads.zip";
+  // Large enough to be read in chunks, and not a multiple of their size.
+  std::vector<char> data1(3 * kParallelReadChunkSize + 17);
+  for (size_t i = 0; i < data1.size(); ++i) {
+    data1[i] = static_cast<char>(i * 31 + i / 4096);
+  }
+  std::vector<std::vector<char>> small(20);
+  for (size_t i = 0; i < small.size(); ++i) {
+    small[i].assign(100 + i, static_cast<char>(i));
+  }
+  std::vector<std::string> names{"key1"};
+  {
+    PyTorchStreamWriter writer(file_name);
+    writer.writeRecord("key1", data1.data(), data1.size());
+    for (size_t i = 0; i < small.size(); ++i) {
+      names.push_back("small" + c10::to_string(i));
+      writer.writeRecord(names.back(), small[i].data(), small[i].size());
+    }
+    writer.writeEndOfFile();
+  }
+
+  for (bool direct_io : {false, true}) {
+    PyTorchStreamReader reader(
+        std::make_unique<ParallelFileAdapter>(file_name, 4, direct_io));
+    auto records = reader.getRecords(names);
+    ASSERT_EQ(records.size(), names.size());
+    ASSERT_EQ(std::get<1>(records[0]), data1.size());
+    ASSERT_EQ(
+        memcmp(std::get<0>(records[0]).get(), data1.data(), data1.size()), 0);
+    for (size_t i = 0; i < small.size(); ++i) {
+      ASSERT_EQ(std::get<1>(records[i + 1]), small[i].size());
+      ASSERT_EQ(
+          memcmp(
+              std::get<0>(records[i + 1]).get(),
+              small[i].data(),
+              small[i].size()),
+          0);
+    }
+    // getRecord() goes through the chunked reads too
+    at::DataPtr data_ptr;
+    int64_t size;
+    std::tie(data_ptr, size) = reader.getRecord("key1");
+    ASSERT_EQ(size, data1.size());
+    ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+  }
+  std::remove(file_name);
+}
+
 } // namespace
 } // namespace serialize
 } // namespace caffe2
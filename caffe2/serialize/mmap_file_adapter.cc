@@ -0,0 +1,113 @@
+#include "caffe2/serialize/mmap_file_adapter.h"
+
+#include <c10/util/Exception.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace caffe2 {
+namespace serialize {
+
+struct MmapFileAdapter::Mapping {
+  char* data = nullptr;
+  size_t size = 0;
+
+  explicit Mapping(const std::string& file_name) {
+#ifndef _WIN32
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+      AT_ERROR("open file failed, file path: ", file_name);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      AT_ERROR("stat failed, file path: ", file_name);
+    }
+    size = st.st_size;
+    if (size > 0) {
+      // A private writable mapping, so that writes to tensors in it copy the
+      // pages they touch instead of faulting or changing the file.
+      void* ptr =
+          mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      if (ptr == MAP_FAILED) {
+        close(fd);
+        AT_ERROR("mmap failed, file path: ", file_name, ": ", strerror(errno));
+      }
+      data = static_cast<char*>(ptr);
+    }
+    close(fd);
+#else
+    std::ifstream file(file_name, std::ifstream::in | std::ifstream::binary);
+    if (!file) {
+      AT_ERROR("open file failed, file path: ", file_name);
+    }
+    file.seekg(0, file.end);
+    size = file.tellg();
+    file.seekg(0, file.beg);
+    data = static_cast<char*>(malloc(size));
+    file.read(data, size);
+    if (!file) {
+      free(data);
+      AT_ERROR("reading file failed, file path: ", file_name);
+    }
+#endif
+  }
+
+  ~Mapping() {
+#ifndef _WIN32
+    if (data) {
+      munmap(data, size);
+    }
+#else
+    free(data);
+#endif
+  }
+};
+
+namespace {
+
+void deleteMappingRef(void* ctx) {
+  delete static_cast<std::shared_ptr<void>*>(ctx);
+}
+
+} // namespace
+
+MmapFileAdapter::MmapFileAdapter(const std::string& file_name)
+    : mapping_(std::make_shared<Mapping>(file_name)) {}
+
+size_t MmapFileAdapter::size() const {
+  return mapping_->size;
+}
+
+size_t MmapFileAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  TORCH_CHECK(
+      pos <= mapping_->size && n <= mapping_->size - pos,
+      "reading beyond the end of the file while ",
+      what);
+  memcpy(buf, mapping_->data + pos, n);
+  return n;
+}
+
+at::DataPtr MmapFileAdapter::map(uint64_t pos, size_t n) const {
+  TORCH_CHECK(
+      pos <= mapping_->size && n <= mapping_->size - pos,
+      "mapping beyond the end of the file");
+  auto ref = new std::shared_ptr<void>(mapping_);
+  return at::DataPtr(
+      mapping_->data + pos, ref, &deleteMappingRef, at::Device(at::kCPU));
+}
+
+MmapFileAdapter::~MmapFileAdapter() {}
+
+} // namespace serialize
+} // namespace caffe2
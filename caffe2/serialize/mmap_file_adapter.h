@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/read_adapter_interface.h"
+
+namespace caffe2 {
+namespace serialize {
+
+// Reads a file through a private memory mapping of all of it. Records that
+// are stored uncompressed can then be handed out by map() without copying:
+// their pages are read from the page cache when first touched, shared with
+// other processes mapping the same file, and copied only if written to. The
+// mapping lives as long as the adapter or any DataPtr returned by map().
+//
+// On platforms without mmap the file is read into one buffer instead, which
+// still avoids a second copy of each record.
+class CAFFE2_API MmapFileAdapter final : public ReadAdapterInterface {
+ public:
+  C10_DISABLE_COPY_AND_ASSIGN(MmapFileAdapter);
+  explicit MmapFileAdapter(const std::string& file_name);
+  size_t size() const override;
+  size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
+      const override;
+  at::DataPtr map(uint64_t pos, size_t n) const override;
+  ~MmapFileAdapter();
+
+ private:
+  struct Mapping;
+  std::shared_ptr<Mapping> mapping_;
+};
+
+} // namespace serialize
+} // namespace caffe2
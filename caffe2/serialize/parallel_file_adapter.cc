@@ -0,0 +1,223 @@
+#include "caffe2/serialize/parallel_file_adapter.h"
+
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace caffe2 {
+namespace serialize {
+
+#ifndef _WIN32
+namespace {
+
+// Reads up to n bytes, stopping early only at the end of the file; returns
+// the number of bytes read, or -1 with errno set.
+ssize_t preadFully(int fd, char* buf, size_t n, uint64_t pos) {
+  size_t done = 0;
+  while (done < n) {
+    ssize_t ret = ::pread(fd, buf + done, n - done, pos + done);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    if (ret == 0) {
+      break;
+    }
+    done += ret;
+  }
+  return done;
+}
+
+bool isAligned(uint64_t v) {
+  return v % kDirectReadAlignment == 0;
+}
+
+} // namespace
+
+ParallelFileAdapter::ParallelFileAdapter(
+    const std::string& file_name,
+    size_t num_threads,
+    bool direct_io) {
+  fd_ = ::open(file_name.c_str(), O_RDONLY);
+  if (fd_ < 0) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  struct stat st;
+  if (fstat(fd_, &st) != 0) {
+    ::close(fd_);
+    AT_ERROR("stat failed, file path: ", file_name);
+  }
+  size_ = st.st_size;
+#ifdef O_DIRECT
+  if (direct_io) {
+    // Filesystems such as tmpfs refuse O_DIRECT; use the page cache there.
+    direct_fd_ = ::open(file_name.c_str(), O_RDONLY | O_DIRECT);
+  }
+#endif
+  if (num_threads == 0) {
+    num_threads = c10::TaskThreadPoolBase::defaultNumThreads();
+  }
+  // The thread calling readMany() reads chunks too.
+  if (num_threads > 1) {
+    pool_ = std::make_unique<c10::ThreadPool>(
+        static_cast<int>(num_threads - 1));
+  }
+}
+
+int ParallelFileAdapter::readChunk(uint64_t pos, char* buf, size_t n) const {
+  if (direct_fd_ >= 0) {
+    if (isAligned(reinterpret_cast<uintptr_t>(buf)) && isAligned(pos) &&
+        isAligned(n) && preadFully(direct_fd_, buf, n, pos) == (ssize_t)n) {
+      return 0;
+    }
+    uint64_t begin = pos / kDirectReadAlignment * kDirectReadAlignment;
+    uint64_t end = (pos + n + kDirectReadAlignment - 1) /
+        kDirectReadAlignment * kDirectReadAlignment;
+    void* aligned = nullptr;
+    if (posix_memalign(&aligned, kDirectReadAlignment, end - begin) == 0) {
+      // Direct reads of the last block of the file return what is left.
+      ssize_t ret = preadFully(
+          direct_fd_, static_cast<char*>(aligned), end - begin, begin);
+      bool ok = ret >= 0 && static_cast<uint64_t>(ret) >= pos + n - begin;
+      if (ok) {
+        memcpy(buf, static_cast<char*>(aligned) + (pos - begin), n);
+      }
+      free(aligned);
+      if (ok) {
+        return 0;
+      }
+    }
+  }
+  ssize_t ret = preadFully(fd_, buf, n, pos);
+  if (ret < 0) {
+    return errno;
+  }
+  return static_cast<size_t>(ret) == n ? 0 : -1;
+}
+
+void ParallelFileAdapter::readMany(
+    const std::vector<ReadRequest>& requests,
+    const char* what) const {
+  struct Chunk {
+    uint64_t pos;
+    char* buf;
+    size_t n;
+  };
+  std::vector<Chunk> chunks;
+  for (const auto& request : requests) {
+    TORCH_CHECK(
+        request.pos <= size_ && request.n <= size_ - request.pos,
+        "reading beyond the end of the file while ",
+        what);
+    for (size_t offset = 0; offset < request.n;
+         offset += kParallelReadChunkSize) {
+      chunks.push_back(
+          {request.pos + offset,
+           static_cast<char*>(request.buf) + offset,
+           std::min(kParallelReadChunkSize, request.n - offset)});
+    }
+  }
+
+  // Every thread takes the next chunk until none is left.
+  std::atomic<size_t> next_chunk{0};
+  std::atomic<int> error{0};
+  auto readChunks = [&]() {
+    for (size_t i = next_chunk++; i < chunks.size(); i = next_chunk++) {
+      int ret = readChunk(chunks[i].pos, chunks[i].buf, chunks[i].n);
+      if (ret != 0) {
+        int expected = 0;
+        error.compare_exchange_strong(expected, ret);
+      }
+    }
+  };
+
+  // The calling thread reads chunks too.
+  size_t num_tasks = 0;
+  if (pool_ && chunks.size() > 1) {
+    num_tasks = std::min(pool_->size(), chunks.size() - 1);
+  }
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t remaining = num_tasks;
+  for (size_t i = 0; i < num_tasks; ++i) {
+    pool_->run([&]() {
+      readChunks();
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--remaining == 0) {
+        done.notify_one();
+      }
+    });
+  }
+  readChunks();
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&]() { return remaining == 0; });
+  }
+
+  TORCH_CHECK(
+      error != -1,
+      "reading file failed while ",
+      what,
+      ": unexpected end of file");
+  TORCH_CHECK(
+      error == 0, "reading file failed while ", what, ": ", strerror(error));
+}
+
+ParallelFileAdapter::~ParallelFileAdapter() {
+  // joins the threads before the files are closed
+  pool_.reset();
+  if (direct_fd_ >= 0) {
+    ::close(direct_fd_);
+  }
+  ::close(fd_);
+}
+
+#else
+
+ParallelFileAdapter::ParallelFileAdapter(
+    const std::string& file_name,
+    size_t /*num_threads*/,
+    bool /*direct_io*/)
+    : file_adapter_(std::make_unique<FileAdapter>(file_name)) {
+  size_ = file_adapter_->size();
+}
+
+void ParallelFileAdapter::readMany(
+    const std::vector<ReadRequest>& requests,
+    const char* what) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  file_adapter_->readMany(requests, what);
+}
+
+ParallelFileAdapter::~ParallelFileAdapter() {}
+
+#endif
+
+size_t ParallelFileAdapter::size() const {
+  return size_;
+}
+
+size_t ParallelFileAdapter::read(
+    uint64_t pos,
+    void* buf,
+    size_t n,
+    const char* what) const {
+  readMany({{pos, buf, n}}, what);
+  return n;
+}
+
+} // namespace serialize
+} // namespace caffe2
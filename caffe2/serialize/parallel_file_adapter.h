@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <c10/core/thread_pool.h>
+
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/file_adapter.h"
+#include "caffe2/serialize/read_adapter_interface.h"
+
+namespace caffe2 {
+namespace serialize {
+
+// Reads are split into chunks of this size, which are read concurrently.
+constexpr size_t kParallelReadChunkSize = 4 << 20;
+// The alignment of the offsets, sizes and buffers of direct reads.
+constexpr size_t kDirectReadAlignment = 4096;
+
+// Reads a file with positional reads (pread) issued by a pool of threads, so
+// that large records, or many records read with readMany(), are read with as
+// many requests in flight as the pool has threads, which storage such as NVMe
+// drives and network filesystems need to reach their bandwidth. read() and
+// readMany() may be called by several threads at once.
+//
+// With direct_io, the file is read with O_DIRECT where the platform and the
+// filesystem support it, bypassing the page cache, through aligned buffers
+// the data is copied out of; reads fall back to the page cache otherwise.
+//
+// On Windows, reads go through a FileAdapter one at a time.
+class CAFFE2_API ParallelFileAdapter final : public ReadAdapterInterface {
+ public:
+  C10_DISABLE_COPY_AND_ASSIGN(ParallelFileAdapter);
+  // num_threads = 0 uses c10::TaskThreadPoolBase::defaultNumThreads().
+  explicit ParallelFileAdapter(
+      const std::string& file_name,
+      size_t num_threads = 0,
+      bool direct_io = false);
+  size_t size() const override;
+  size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
+      const override;
+  void readMany(const std::vector<ReadRequest>& requests, const char* what = "")
+      const override;
+  ~ParallelFileAdapter();
+
+ private:
+  // Returns 0, the errno of the failed read, or -1 at the end of the file.
+  int readChunk(uint64_t pos, char* buf, size_t n) const;
+
+  size_t size_ = 0;
+#ifndef _WIN32
+  int fd_ = -1;
+  int direct_fd_ = -1;
+  std::unique_ptr<c10::ThreadPool> pool_;
+#else
+  std::unique_ptr<FileAdapter> file_adapter_;
+  mutable std::mutex mutex_;
+#endif
+};
+
+} // namespace serialize
+} // namespace caffe2
@@ -1,8 +1,25 @@
 #include "caffe2/serialize/read_adapter_interface.h"
 
+#include <c10/util/Exception.h>
+
 namespace caffe2 {
 namespace serialize {
 
+at::DataPtr ReadAdapterInterface::map(uint64_t /*pos*/, size_t /*n*/) const {
+  return at::DataPtr();
+}
+
+void ReadAdapterInterface::readMany(
+    const std::vector<ReadRequest>& requests,
+    const char* what) const {
+  for (const auto& request : requests) {
+    TORCH_CHECK(
+        read(request.pos, request.buf, request.n, what) == request.n,
+        "reading beyond the end of the file while ",
+        what);
+  }
+}
+
 ReadAdapterInterface::~ReadAdapterInterface() {}
 
 } // namespace serialize
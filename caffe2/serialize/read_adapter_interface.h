@@ -2,7 +2,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
+#include "c10/core/Allocator.h"
 #include "c10/macros/Macros.h"
 
 namespace caffe2 {
@@ -16,6 +18,22 @@ class CAFFE2_API ReadAdapterInterface {
   virtual size_t size() const = 0;
   virtual size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
       const = 0;
+  // Returns a pointer to the n bytes at pos that stays valid as long as the
+  // DataPtr lives, for readers that hold the whole input in memory, or an
+  // empty DataPtr if the bytes have to be read.
+  virtual at::DataPtr map(uint64_t pos, size_t n) const;
+
+  struct ReadRequest {
+    uint64_t pos;
+    void* buf;
+    size_t n;
+  };
+  // Reads all the n bytes of each request, throwing if any of them can't be
+  // read. Readers that can read at several positions at once issue the
+  // requests concurrently; the default reads them one after another.
+  virtual void readMany(
+      const std::vector<ReadRequest>& requests,
+      const char* what = "") const;
   virtual ~ReadAdapterInterface();
 };
 
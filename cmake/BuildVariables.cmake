@@ -17,6 +17,10 @@ set(Caffe2_GPU_SRCS)
 set(Caffe2_CPU_TEST_SRCS)
 set(Caffe2_GPU_TEST_SRCS)
 
+# Caffe2_CPU_BENCHMARK_SRCS is the list of the sources of the CPU benchmark
+# binaries, one binary per source file.
+set(Caffe2_CPU_BENCHMARK_SRCS)
+
 # Caffe2_{CPU,GPU}_INCLUDE is the list that will have all the include
 # directories for CPU and GPU respectively.
 set(Caffe2_CPU_INCLUDE)
@@ -21,6 +21,21 @@ SET(AVX2_CODE "
     a = _mm256_abs_epi16(a);
     __m256i x;
     _mm256_extract_epi64(x, 0); // we rely on this in our AVX2 code
+    __m128i h = _mm256_cvtps_ph(_mm256_set1_ps(0), 0); // F16C, for Vec256<Half>
+    return 0;
+  }
+")
+
+SET(AVX512_CODE "
+  #include <immintrin.h>
+
+  int main()
+  {
+    __m512i a = _mm512_set1_epi8(0);
+    __m512i b = a;
+    __mmask64 equality_mask = _mm512_cmp_epi8_mask(a, b, _MM_CMPINT_EQ); // AVX512BW
+    __m512d c = _mm512_cvtepi64_pd(a); // AVX512DQ
+    __m256i d = _mm256_abs_epi64(_mm512_castsi512_si256(a)); // AVX512VL
     return 0;
   }
 ")
@@ -55,7 +70,8 @@ MACRO(CHECK_SSE lang type flags)
 ENDMACRO()
 
 CHECK_SSE(C "AVX" " ;-mavx;/arch:AVX")
-CHECK_SSE(C "AVX2" " ;-mavx2 -mfma;/arch:AVX2")
+CHECK_SSE(C "AVX2" " ;-mavx2 -mfma -mf16c;/arch:AVX2")
 
 CHECK_SSE(CXX "AVX" " ;-mavx;/arch:AVX")
-CHECK_SSE(CXX "AVX2" " ;-mavx2 -mfma;/arch:AVX2")
+CHECK_SSE(CXX "AVX2" " ;-mavx2 -mfma -mf16c;/arch:AVX2")
+CHECK_SSE(CXX "AVX512" " ;-mavx512f -mavx512bw -mavx512dq -mavx512vl -mfma;/arch:AVX512")
@@ -249,6 +249,26 @@ else()
       ${LIBNVTOOLSEXT})
 endif()
 
+# cupti
+if(USE_CUPTI)
+  find_path(CUPTI_INCLUDE_DIR cupti.h
+      PATHS ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI/include
+      NO_DEFAULT_PATH)
+  if(CUDA_cupti_LIBRARY AND CUPTI_INCLUDE_DIR)
+    add_library(torch::cupti INTERFACE IMPORTED)
+    set_property(
+        TARGET torch::cupti PROPERTY INTERFACE_LINK_LIBRARIES
+        ${CUDA_cupti_LIBRARY})
+    set_property(
+        TARGET torch::cupti PROPERTY INTERFACE_INCLUDE_DIRECTORIES
+        ${CUPTI_INCLUDE_DIR})
+  else()
+    message(WARNING
+      "CUPTI not found in ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI. "
+      "The CUPTI mode of the autograd profiler will not be available.")
+  endif()
+endif()
+
 # cudnn
 # static linking is handled by USE_STATIC_CUDNN environment variable
 if(CAFFE2_USE_CUDNN)
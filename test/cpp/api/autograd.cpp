@@ -4,6 +4,11 @@
 
 #include <test/cpp/api/support.h>
 
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
+
 using namespace torch::autograd;
 
 #define ASSERT_VARIABLE_EQ(a,b) ASSERT_TRUE(torch::allclose((a),(b)))
@@ -152,6 +157,29 @@ TEST(AutogradAPITests, RetainGrad) {
   ASSERT_VARIABLE_EQ(input * 18, input.grad());
 }
 
+TEST(AutogradAPITests, NodeCache) {
+  ASSERT_TRUE(node_cache_enabled());
+  auto input = torch::rand({1, 3}, torch::requires_grad());
+  std::set<const Node*> freed;
+  {
+    auto out = input * 3;
+    ASSERT_EQ(out.grad_fn()->next_edges().size(), 1);
+    freed.insert(out.grad_fn().get());
+    // The AccumulateGrad node of input goes away with the graph too.
+    freed.insert(out.grad_fn()->next_edges()[0].function.get());
+  }
+  // The blocks of the nodes freed on this thread are reused for the next ones.
+  auto out = input * 3;
+  ASSERT_EQ(freed.count(out.grad_fn().get()), 1);
+  out.sum().backward();
+  ASSERT_VARIABLE_EQ(input.grad(), torch::full({1, 3}, 3.));
+
+  set_node_cache_enabled(false);
+  auto uncached = input * 2;
+  ASSERT_TRUE(uncached.grad_fn());
+  set_node_cache_enabled(true);
+}
+
 TEST(CustomAutogradTest, CustomFunction) {
   struct MyFunction : public Function<MyFunction> {
     static Variable forward(AutogradContext *ctx, Variable var1, int mul, Variable var2) {
@@ -587,6 +615,124 @@ TEST(CustomAutogradTest, ReentrantPriority) {
   ASSERT_EQ(order.back(), 0);
 }
 
+TEST(CustomAutogradTest, ParallelCPUBackward) {
+  static std::atomic<int> arrived;
+  static std::atomic<bool> overlapped;
+  arrived = 0;
+  overlapped = false;
+
+  // The backward of each branch waits for the other one, which only
+  // completes if the branches run on different threads.
+  struct Rendezvous : public Function<Rendezvous> {
+    static Variable forward(AutogradContext*, Variable x) {
+      return x.clone();
+    }
+
+    static variable_list backward(AutogradContext*, variable_list grad) {
+      ++arrived;
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+      while (arrived.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+      }
+      if (arrived.load() >= 2) {
+        overlapped = true;
+      }
+      return {grad[0] * 2};
+    }
+  };
+
+  auto& engine = Engine::get_default_engine();
+  engine.set_num_cpu_workers(2);
+  auto x = torch::randn({3}, torch::requires_grad());
+  auto y = torch::randn({3}, torch::requires_grad());
+  auto out = (Rendezvous::apply(x * 3) + Rendezvous::apply(y * 4)).sum();
+  out.backward();
+  engine.set_num_cpu_workers(0);
+
+  ASSERT_TRUE(overlapped.load());
+  ASSERT_VARIABLE_EQ(x.grad(), torch::full({3}, 6.));
+  ASSERT_VARIABLE_EQ(y.grad(), torch::full({3}, 8.));
+}
+
+TEST(CustomAutogradTest, ParallelCPUBackwardReentrant) {
+  struct DeepReenter : public Function<DeepReenter> {
+    static Variable forward(AutogradContext *ctx, Variable x) {
+      {
+        at::AutoGradMode enable_grad(true);
+        ctx->saved_data["x"] = make_variable(x.tensor_data(), true) -1;
+      }
+      return ctx->saved_data["x"].toTensor().detach();
+    }
+
+    static variable_list backward(AutogradContext*ctx, variable_list grad_output) {
+      if (!ctx->saved_data["x"].toTensor().is_nonzero()) {
+        return grad_output;
+      }
+      {
+        at::AutoGradMode enable_grad(true);
+        apply(ctx->saved_data["x"].toTensor())[0].sum().backward();
+        return grad_output;
+      }
+    }
+  };
+
+  auto& engine = Engine::get_default_engine();
+  engine.set_num_cpu_workers(3);
+  std::vector<Variable> leaves;
+  Variable out;
+  for (int i = 0; i < 4; ++i) {
+    leaves.push_back(torch::tensor({100}, torch::dtype(torch::kFloat).requires_grad(true)));
+    auto branch = DeepReenter::apply(leaves.back() * (i + 1)).sum();
+    out = out.defined() ? out + branch : branch;
+  }
+  out.backward();
+  engine.set_num_cpu_workers(0);
+
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_VARIABLE_EQ(leaves[i].grad(), torch::full({1}, i + 1.));
+  }
+}
+
+TEST(CustomAutogradTest, SavedVariableHooks) {
+  static int num_packed;
+  static int num_unpacked;
+  num_packed = 0;
+  num_unpacked = 0;
+
+  // Keeps a copy of the saved tensor, which is released by the graph.
+  struct CopyHooks : public SavedVariableHooks {
+    void call_pack_hook(const at::Tensor& tensor) override {
+      ++num_packed;
+      copy_ = tensor.clone();
+    }
+    at::Tensor call_unpack_hook() override {
+      ++num_unpacked;
+      return copy_;
+    }
+    at::Tensor copy_;
+  };
+  struct CopyHooksFactory : public SavedVariableHooksFactory {
+    std::unique_ptr<SavedVariableHooks> make_hooks() override {
+      return std::unique_ptr<SavedVariableHooks>(new CopyHooks());
+    }
+  };
+
+  auto x = torch::randn({4}, torch::requires_grad());
+  auto y = torch::randn({4}, torch::requires_grad());
+  SavedTensorDefaultHooks::push_hooks(std::make_shared<CopyHooksFactory>());
+  auto out = (x * y).sum();
+  SavedTensorDefaultHooks::pop_hooks();
+  auto out2 = (x * y).sum();
+
+  ASSERT_EQ(num_packed, 2);
+  out.backward();
+  ASSERT_EQ(num_unpacked, 2);
+  ASSERT_VARIABLE_EQ(x.grad(), y);
+  ASSERT_VARIABLE_EQ(y.grad(), x);
+  out2.backward();
+  ASSERT_EQ(num_unpacked, 2);
+}
+
 TEST(CustomAutogradTest, Hooks) {
   Variable x = torch::ones({5,5}, torch::requires_grad());
   Variable y = torch::ones({5,5})*4;
@@ -666,6 +812,56 @@ TEST(CustomAutogradTest, HookNone) {
   ASSERT_TRUE(was_called);
 }
 
+TEST(InferenceModeTest, RunsModulesWithoutAutograd) {
+  torch::nn::Linear model(3, 4);
+  auto x = torch::randn({2, 3});
+  auto expected = model(x).detach();
+  {
+    torch::InferenceMode guard;
+    ASSERT_TRUE(torch::InferenceMode::is_enabled());
+    ASSERT_FALSE(torch::GradMode::is_enabled());
+    auto y = model(x);
+    ASSERT_FALSE(y.requires_grad());
+    ASSERT_FALSE(y.grad_fn());
+    ASSERT_VARIABLE_EQ(y, expected);
+  }
+  ASSERT_FALSE(torch::InferenceMode::is_enabled());
+  ASSERT_TRUE(torch::GradMode::is_enabled());
+}
+
+TEST(InferenceModeTest, InferenceTensorsHaveNoVersionCounter) {
+  torch::Tensor a;
+  {
+    torch::InferenceMode guard;
+    a = torch::ones({2, 2});
+    ASSERT_FALSE(a.unsafeGetTensorImpl()->version_counter().enabled());
+    a.add_(1);
+    ASSERT_EQ(a._version(), 0);
+  }
+  a.mul_(2);
+  ASSERT_EQ(a._version(), 0);
+  ASSERT_VARIABLE_EQ(a, torch::full({2, 2}, 4.));
+
+  auto b = torch::ones({2, 2});
+  ASSERT_TRUE(b.unsafeGetTensorImpl()->version_counter().enabled());
+  b.add_(1);
+  ASSERT_EQ(b._version(), 1);
+}
+
+TEST(InferenceModeTest, InferenceTensorsCannotBeSavedForBackward) {
+  torch::Tensor a;
+  {
+    torch::InferenceMode guard;
+    a = torch::ones({2, 2});
+  }
+  auto w = torch::ones({2, 2}, torch::requires_grad());
+  ASSERT_THROWS_WITH(
+      w * a, "Inference tensors cannot be saved for backward");
+  auto out = w * a.clone();
+  out.sum().backward();
+  ASSERT_VARIABLE_EQ(w.grad(), torch::ones({2, 2}));
+}
+
 // TODO add these tests if needed
 // test_once_differentiable
 // test_sparse_backward
@@ -2,6 +2,8 @@
 
 #include <torch/torch.h>
 
+#include <torch/data/detail/queue.h>
+
 #include <test/cpp/api/support.h>
 
 #include <c10/util/ArrayRef.h>
@@ -9,6 +11,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <future>
 #include <iostream>
 #include <iterator>
@@ -450,6 +453,81 @@ TEST(DataTest, TensorDatasetConstructsFromInitializerListOfTensors) {
       torch::tensor({0, 0, 1, 0, 0}, torch::kFloat32).allclose(dataset.get(2)));
 }
 
+TEST(DataTest, RecordFileReadsRecordsWrittenByRecordFileWriter) {
+  auto tempfile = c10::make_tempfile();
+  {
+    datasets::RecordFileWriter writer(tempfile.name);
+    writer.write(torch::arange(5, torch::kFloat32));
+    writer.write("abc", 3);
+    writer.write(torch::empty({0}));
+    writer.close();
+  }
+
+  datasets::RecordFile records(tempfile.name);
+  ASSERT_EQ(records.size().value(), 3);
+  auto floats = records.get(0).data;
+  ASSERT_EQ(floats.dtype(), torch::kByte);
+  ASSERT_EQ(floats.numel(), 5 * sizeof(float));
+  ASSERT_TRUE(torch::from_blob(floats.data_ptr(), {5}, torch::kFloat32)
+                  .equal(torch::arange(5, torch::kFloat32)));
+  auto chars = records.get(1).data;
+  ASSERT_EQ(
+      std::string(static_cast<const char*>(chars.data_ptr()), chars.numel()),
+      "abc");
+  ASSERT_EQ(records.get(2).data.numel(), 0);
+  ASSERT_THROWS_WITH(records.get(3), "out of range");
+}
+
+TEST(DataTest, RecordFileRejectsOtherFiles) {
+  auto tempfile = c10::make_tempfile();
+  {
+    std::ofstream stream(tempfile.name, std::ios::binary);
+    stream << "this is not a record file, but it is long enough for a header";
+  }
+  ASSERT_THROWS_WITH(
+      datasets::RecordFile(tempfile.name), "is not a record file");
+}
+
+// Writes a record file with one single-byte record per value.
+void write_byte_records(const std::string& path, uint8_t begin, uint8_t end) {
+  datasets::RecordFileWriter writer(path);
+  for (uint8_t value = begin; value < end; ++value) {
+    writer.write(&value, 1);
+  }
+  writer.close();
+}
+
+TEST(DataTest, RecordFileWorksWithShardsAndDistributedSampler) {
+  auto first_shard = c10::make_tempfile();
+  auto second_shard = c10::make_tempfile();
+  write_byte_records(first_shard.name, 0, 6);
+  write_byte_records(second_shard.name, 6, 10);
+  datasets::RecordFile records(
+      std::vector<std::string>{first_shard.name, second_shard.name});
+  ASSERT_EQ(records.size().value(), 10);
+  ASSERT_EQ(records.num_shards(), 2);
+  ASSERT_EQ(records.shard_begin(1), 6);
+  ASSERT_EQ(records.shard_size(1), 4);
+
+  std::vector<int64_t> values;
+  for (size_t rank = 0; rank < 2; ++rank) {
+    auto data_loader = torch::data::make_data_loader(
+        records,
+        samplers::DistributedRandomSampler(
+            records.size().value(), /*num_replicas=*/2, rank),
+        DataLoaderOptions(3).workers(2));
+    for (auto& batch : *data_loader) {
+      for (auto& example : batch) {
+        values.push_back(example.data.item<uint8_t>());
+      }
+    }
+  }
+  std::sort(values.begin(), values.end());
+  std::vector<int64_t> expected(10);
+  std::iota(expected.begin(), expected.end(), 0);
+  ASSERT_EQ(values, expected);
+}
+
 TEST(DataTest, StackTransformWorksForExample) {
   struct D : public datasets::Dataset<D> {
     Example<> get(size_t index) override {
@@ -485,6 +563,32 @@ TEST(DataTest, StackTransformWorksForTensorExample) {
   ASSERT_TRUE(second.data.allclose(torch::eye(4).slice(/*dim=*/0, 2, 4)));
 }
 
+TEST(DataTest, StackTransformReusesBatchesWrittenByTheDataset) {
+  auto tensor = torch::arange(8, torch::kLong).view({4, 2});
+  auto d = datasets::TensorDataset(tensor).map(
+      transforms::Stack<TensorExample>());
+
+  void* data_ptr = nullptr;
+  {
+    TensorExample batch = d.get_batch({3, 1});
+    ASSERT_TRUE(batch.data.equal(torch::tensor({{6, 7}, {2, 3}}, torch::kLong)));
+    data_ptr = batch.data.data_ptr();
+  }
+
+  // The first batch is no longer in use, so its tensor is written again.
+  TensorExample batch = d.get_batch({0, 2});
+  ASSERT_TRUE(batch.data.equal(torch::tensor({{0, 1}, {4, 5}}, torch::kLong)));
+  ASSERT_EQ(batch.data.data_ptr(), data_ptr);
+
+  // A view keeps the batch in use.
+  auto row = batch.data[0];
+  batch = TensorExample();
+  TensorExample second = d.get_batch({1, 1});
+  ASSERT_TRUE(second.data.equal(torch::tensor({{2, 3}, {2, 3}}, torch::kLong)));
+  ASSERT_NE(second.data.data_ptr(), data_ptr);
+  ASSERT_TRUE(row.equal(torch::tensor({0, 1}, torch::kLong)));
+}
+
 // Template classes cannot be nested in functions.
 template <typename Target>
 struct T : transforms::TensorTransform<Target> {
@@ -688,6 +792,115 @@ TEST(DataTest, QueueClearEmptiesTheQueue) {
   ASSERT_THROWS_WITH(queue.pop(1 * kMillisecond), "Timeout");
 }
 
+TEST(DataTest, LockFreeQueueRoundsCapacityUpToPowerOfTwo) {
+  ASSERT_EQ(torch::data::detail::LockFreeQueue<int>(0).capacity(), 1);
+  ASSERT_EQ(torch::data::detail::LockFreeQueue<int>(4).capacity(), 4);
+  ASSERT_EQ(torch::data::detail::LockFreeQueue<int>(5).capacity(), 8);
+}
+
+TEST(DataTest, LockFreeQueuePushAndPopFromSameThread) {
+  torch::data::detail::LockFreeQueue<int> queue(4);
+  queue.push(1);
+  queue.push(2);
+  ASSERT_EQ(queue.pop(), 1);
+  ASSERT_EQ(queue.pop(), 2);
+  // Wrap around the ring a few times.
+  for (int i = 0; i < 10; ++i) {
+    queue.push(i);
+    queue.push(i + 1);
+    ASSERT_EQ(queue.pop(), i);
+    ASSERT_EQ(queue.pop(), i + 1);
+  }
+}
+
+TEST(DataTest, LockFreeQueueTryPushFailsWhenFull) {
+  torch::data::detail::LockFreeQueue<int> queue(2);
+  int value = 1;
+  ASSERT_TRUE(queue.try_push(value));
+  value = 2;
+  ASSERT_TRUE(queue.try_push(value));
+  value = 3;
+  ASSERT_FALSE(queue.try_push(value));
+  torch::optional<int> popped;
+  ASSERT_TRUE(queue.try_pop(popped));
+  ASSERT_EQ(popped.value(), 1);
+  ASSERT_TRUE(queue.try_push(value));
+}
+
+TEST(DataTest, LockFreeQueuePopWithTimeoutThrowsUponTimeout) {
+  torch::data::detail::LockFreeQueue<int> queue(4);
+  ASSERT_THROWS_WITH(
+      queue.pop(10 * kMillisecond),
+      "Timeout in DataLoader queue while waiting for next batch "
+      "(timeout was 10 ms)");
+}
+
+TEST(DataTest, LockFreeQueuePushAndPopFromDifferentThreads) {
+  using torch::data::detail::LockFreeQueue;
+
+  // First test: attempt to pop batch (and block), then push.
+  {
+    LockFreeQueue<int> queue(4);
+    std::thread thread([&queue] {
+      std::this_thread::sleep_for(20 * kMillisecond);
+      queue.push(123);
+    });
+    ASSERT_EQ(queue.pop(), 123);
+    thread.join();
+  }
+
+  // Second test: push into a full queue (and block), then pop.
+  {
+    LockFreeQueue<int> queue(1);
+    queue.push(1);
+    std::thread thread([&queue] { queue.push(2); });
+    std::this_thread::sleep_for(20 * kMillisecond);
+    ASSERT_EQ(queue.pop(), 1);
+    ASSERT_EQ(queue.pop(), 2);
+    thread.join();
+  }
+
+  // Third test: many producers and consumers.
+  {
+    const int kThreads = 4;
+    const int kElementsPerThread = 1000;
+    LockFreeQueue<int> queue(8);
+    std::vector<std::thread> producers;
+    std::vector<std::future<int64_t>> consumers;
+    for (int t = 0; t < kThreads; ++t) {
+      producers.emplace_back([&queue] {
+        for (int i = 1; i <= kElementsPerThread; ++i) {
+          queue.push(i);
+        }
+      });
+      consumers.push_back(std::async(std::launch::async, [&queue] {
+        int64_t sum = 0;
+        for (int i = 0; i < kElementsPerThread; ++i) {
+          sum += queue.pop();
+        }
+        return sum;
+      }));
+    }
+    int64_t sum = 0;
+    for (auto& consumer : consumers) {
+      sum += consumer.get();
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    ASSERT_EQ(sum, kThreads * kElementsPerThread * (kElementsPerThread + 1) / 2);
+  }
+}
+
+TEST(DataTest, LockFreeQueueClearEmptiesTheQueue) {
+  torch::data::detail::LockFreeQueue<int> queue(4);
+  queue.push(1);
+  queue.push(2);
+  queue.push(3);
+  ASSERT_EQ(queue.clear(), 3);
+  ASSERT_THROWS_WITH(queue.pop(1 * kMillisecond), "Timeout");
+}
+
 TEST(DataTest, DataShuttleCanPushAndPopJob) {
   torch::data::detail::DataShuttle<int, int> shuttle;
   shuttle.push_job(1);
@@ -1030,6 +1243,9 @@ TEST(DataLoaderTest, DataLoaderOptionsDefaultAsExpected) {
   ASSERT_EQ(full_options.max_jobs, 0);
   ASSERT_FALSE(full_options.timeout.has_value());
   ASSERT_TRUE(full_options.enforce_ordering);
+  ASSERT_FALSE(full_options.pin_memory);
+  ASSERT_FALSE(full_options.device.has_value());
+  ASSERT_EQ(full_options.device_prefetch, 2);
 }
 
 TEST(DataLoaderTest, DataLoaderOptionsCoalesceOptionalValues) {
@@ -1429,6 +1645,50 @@ TEST(DataLoaderTest, Reset) {
   ASSERT_EQ(++iterator, end);
 }
 
+TEST(DataLoaderTest, CopiesBatchesToDevice) {
+  datasets::TensorDataset dataset(torch::arange(20).view({20, 1}));
+  for (size_t workers : {0, 2}) {
+    auto data_loader = torch::data::make_data_loader(
+        dataset.map(transforms::Stack<TensorExample>()),
+        DataLoaderOptions(4)
+            .workers(workers)
+            .device(torch::kCPU)
+            .device_prefetch(3));
+    for (size_t epoch = 0; epoch < 2; ++epoch) {
+      int64_t expected = 0;
+      for (auto& batch : *data_loader) {
+        ASSERT_EQ(batch.data.size(0), 4);
+        for (int64_t i = 0; i < 4; ++i) {
+          ASSERT_EQ(batch.data[i].item<int64_t>(), expected++);
+        }
+      }
+      ASSERT_EQ(expected, 20);
+    }
+  }
+}
+
+TEST(DataLoaderTest, PinsMemoryAndCopiesBatchesToDevice_CUDA) {
+  std::vector<TensorExample> examples = {torch::ones(3), torch::ones(3)};
+  auto stacked = transforms::Stack<TensorExample>(/*pin_memory=*/true)
+                     .apply_batch(examples);
+  ASSERT_TRUE(stacked.data.is_pinned());
+  ASSERT_TRUE(stacked.data.equal(torch::ones({2, 3})));
+
+  datasets::TensorDataset dataset(torch::arange(20).view({20, 1}));
+  auto data_loader = torch::data::make_data_loader(
+      dataset.map(transforms::Stack<TensorExample>()),
+      DataLoaderOptions(4).workers(2).pin_memory(true).device(torch::kCUDA));
+  int64_t expected = 0;
+  for (auto& batch : *data_loader) {
+    ASSERT_TRUE(batch.data.is_cuda());
+    auto data = batch.data.cpu();
+    for (int64_t i = 0; i < 4; ++i) {
+      ASSERT_EQ(data[i].item<int64_t>(), expected++);
+    }
+  }
+  ASSERT_EQ(expected, 20);
+}
+
 TEST(DataLoaderTest, TestExceptionsArePropagatedFromWorkers) {
   struct D : datasets::Dataset<DummyDataset, int> {
     int get(size_t index) override {
@@ -1690,6 +1950,40 @@ TEST(DataLoaderTest, ChunkDataSetGetBatch) {
   }
 }
 
+TEST(DataLoaderTest, ChunkDatasetReadsRecordFile) {
+  auto tempfile = c10::make_tempfile();
+  write_byte_records(tempfile.name, 0, 20);
+  datasets::RecordFileChunkReader chunk_reader(
+      datasets::RecordFile(tempfile.name), /*records_per_chunk=*/6);
+  ASSERT_EQ(chunk_reader.chunk_count(), 4);
+  ASSERT_EQ(chunk_reader.read_chunk(3).size(), 2);
+
+  samplers::DistributedRandomSampler chunk_sampler(
+      chunk_reader.chunk_count(), /*num_replicas=*/1, /*rank=*/0);
+  samplers::SequentialSampler example_sampler(0);
+  auto dataset = datasets::make_shared_dataset<datasets::ChunkDataset<
+      datasets::RecordFileChunkReader,
+      samplers::DistributedRandomSampler,
+      samplers::SequentialSampler>>(
+      chunk_reader,
+      chunk_sampler,
+      example_sampler,
+      datasets::ChunkDatasetOptions(/*preloader_count=*/2, /*batch_size=*/4));
+  auto data_loader =
+      torch::data::make_data_loader(dataset, DataLoaderOptions(4).workers(0));
+
+  std::vector<int64_t> values;
+  for (auto& batch : *data_loader) {
+    for (auto& example : batch) {
+      values.push_back(example.data.item<uint8_t>());
+    }
+  }
+  std::sort(values.begin(), values.end());
+  std::vector<int64_t> expected(20);
+  std::iota(expected.begin(), expected.end(), 0);
+  ASSERT_EQ(values, expected);
+}
+
 TEST(DataLoaderTest, ChunkDataSetWithBatchSizeMismatch) {
   const size_t prefetch_count = 1;
   const size_t batch_size = 5;
@@ -1896,6 +2190,94 @@ TEST(DataLoaderTest, ChunkDatasetDoesNotHang) {
   auto iterator = data_loader->begin();
 }
 
+TEST(DataLoaderTest, ChunkDatasetAddsPreloadersForSlowReaders) {
+  struct SlowChunkDataReader : public DummyChunkDataReader {
+    BatchType read_chunk(size_t chunk_index) override {
+      std::this_thread::sleep_for(20 * kMillisecond);
+      return DummyChunkDataReader::read_chunk(chunk_index % chunk_count_);
+    }
+    size_t chunk_count() override {
+      return 3 * chunk_count_;
+    }
+  };
+
+  const size_t batch_size = 5;
+  SlowChunkDataReader data_reader;
+  samplers::SequentialSampler sampler(0);
+  auto dataset = datasets::make_shared_dataset<datasets::ChunkDataset<
+      SlowChunkDataReader,
+      samplers::SequentialSampler,
+      samplers::SequentialSampler>>(
+      data_reader,
+      sampler,
+      sampler,
+      datasets::ChunkDatasetOptions(/*preloader_count=*/1, batch_size)
+          .max_preloader_count(4)
+          .preloader_scaling_wait(std::chrono::milliseconds(1)));
+  dataset->reset();
+  ASSERT_EQ(dataset->preloader_thread_count(), 1);
+
+  std::vector<size_t> counts(35, 0);
+  while (auto batch = dataset->get_batch()) {
+    for (auto value : *batch) {
+      ++counts[value];
+    }
+  }
+  ASSERT_GT(dataset->preloader_thread_count(), 1);
+  ASSERT_LE(dataset->preloader_thread_count(), 4);
+  for (auto count : counts) {
+    ASSERT_EQ(count, 3);
+  }
+}
+
+TEST(DataLoaderTest, ChunkDatasetWithShuffleBufferReturnsEveryExampleOnce) {
+  const size_t batch_size = 7;
+  DummyChunkDataReader data_reader;
+  samplers::SequentialSampler sampler(0);
+  auto dataset = datasets::make_shared_dataset<datasets::ChunkDataset<
+      DummyChunkDataReader,
+      samplers::SequentialSampler,
+      samplers::SequentialSampler>>(
+      data_reader,
+      sampler,
+      sampler,
+      datasets::ChunkDatasetOptions(/*preloader_count=*/2, batch_size)
+          .shuffle_buffer_size(16));
+  auto data_loader = torch::data::make_data_loader(
+      dataset, DataLoaderOptions(batch_size));
+
+  for (int epoch = 0; epoch < 2; ++epoch) {
+    std::vector<int> values;
+    for (auto& batch : *data_loader) {
+      ASSERT_LE(batch.size(), batch_size);
+      values.insert(values.end(), batch.begin(), batch.end());
+    }
+    ASSERT_EQ(values.size(), 35);
+    // The shuffle buffer mixes examples, even with sequential samplers.
+    ASSERT_FALSE(std::is_sorted(values.begin(), values.end()));
+    std::sort(values.begin(), values.end());
+    for (size_t i = 0; i < values.size(); ++i) {
+      ASSERT_EQ(values[i], i);
+    }
+  }
+}
+
+TEST(DataTest, ChunkDatasetRejectsMaxPreloaderCountBelowPreloaderCount) {
+  DummyChunkDataReader data_reader;
+  samplers::SequentialSampler sampler(0);
+  using ChunkDataset = datasets::ChunkDataset<
+      DummyChunkDataReader,
+      samplers::SequentialSampler,
+      samplers::SequentialSampler>;
+  ASSERT_THROWS_WITH(
+      ChunkDataset(
+          data_reader,
+          sampler,
+          sampler,
+          datasets::ChunkDatasetOptions(2, 5).max_preloader_count(1)),
+      "max_preloader_count needs to be 0 or at least preloader_count");
+}
+
 // Test ChunkDataset save function.
 // Note [save/load ChunkDataset as ChunkSampler]:
 // The chunk sampler inside ChunkDataset is used in a separate thread pool other
@@ -81,7 +81,8 @@ void assign_parameter(
 template <typename OptimizerClass, typename Options>
 void check_exact_values(
     Options options,
-    std::vector<std::vector<torch::Tensor>> expected_parameters) {
+    std::vector<std::vector<torch::Tensor>> expected_parameters,
+    torch::Device device = torch::kCPU) {
   const size_t kIterations = 1001;
   const size_t kSampleEvery = 100;
 
@@ -93,7 +94,7 @@ void check_exact_values(
       Linear(3, 1),
       Functional(torch::sigmoid));
 
-  model->to(torch::kFloat64);
+  model->to(device, torch::kFloat64);
 
   // Use exact input values because matching random values is hard.
   auto parameters = model->named_parameters();
@@ -109,7 +110,7 @@ void check_exact_values(
 
   auto optimizer = OptimizerClass(parameters.values(), options);
   torch::Tensor input =
-      torch::tensor({0.1, 0.2, 0.3, 0.4, 0.5, 0.6}, torch::kFloat64).reshape({3, 2});
+      torch::tensor({0.1, 0.2, 0.3, 0.4, 0.5, 0.6}, torch::kFloat64).reshape({3, 2}).to(device);
 
   for (size_t i = 0; i < kIterations; ++i) {
     optimizer.zero_grad();
@@ -126,7 +127,7 @@ void check_exact_values(
       for (size_t p = 0; p < parameters.size(); ++p) {
         ASSERT_TRUE(parameters[p]->defined());
         // Always compare using double dtype, regardless of the original dtype of the tensors
-        auto computed = parameters[p]->flatten().to(torch::kFloat64);
+        auto computed = parameters[p]->flatten().to(torch::kCPU, torch::kFloat64);
         auto expected = expected_parameters.at(i / kSampleEvery).at(p).to(torch::kFloat64);
         if (!computed.allclose(expected, /*rtol=*/1e-3, /*atol=*/5e-4)) {
           std::cout << "Iteration " << i << ": " << computed
@@ -348,6 +349,50 @@ TEST(OptimTest, ProducesPyTorchValues_SGDWithWeightDecayAndNesterovMomentum) {
       expected_parameters::SGD_with_weight_decay_and_nesterov_momentum());
 }
 
+// On CUDA, Adam and SGD update all parameters with the fused kernels
+TEST(OptimTest, ProducesPyTorchValues_Adam_CUDA) {
+  check_exact_values<Adam>(
+      AdamOptions(1.0), expected_parameters::Adam(), torch::kCUDA);
+}
+
+TEST(OptimTest, ProducesPyTorchValues_AdamWithWeightDecayAndAMSGrad_CUDA) {
+  check_exact_values<Adam>(
+      AdamOptions(1.0).weight_decay(1e-6).amsgrad(true),
+      expected_parameters::Adam_with_weight_decay_and_amsgrad(),
+      torch::kCUDA);
+}
+
+TEST(OptimTest, ProducesPyTorchValues_SGDWithWeightDecayAndMomentum_CUDA) {
+  check_exact_values<SGD>(
+      SGDOptions(0.1).weight_decay(1e-2).momentum(0.9),
+      expected_parameters::SGD_with_weight_decay_and_momentum(),
+      torch::kCUDA);
+}
+
+TEST(OptimTest, ProducesPyTorchValues_SGDWithWeightDecayAndNesterovMomentum_CUDA) {
+  check_exact_values<SGD>(
+      SGDOptions(0.1).weight_decay(1e-6).momentum(0.9).nesterov(true),
+      expected_parameters::SGD_with_weight_decay_and_nesterov_momentum(),
+      torch::kCUDA);
+}
+
+TEST(OptimTest, ProducesPyTorchValues_AdagradWithWeightDecayAndLRDecay_CUDA) {
+  check_exact_values<Adagrad>(
+      AdagradOptions(1.0).weight_decay(1e-6).lr_decay(1e-3),
+      expected_parameters::Adagrad_with_weight_decay_and_lr_decay(),
+      torch::kCUDA);
+}
+
+TEST(
+    OptimTest,
+    ProducesPyTorchValues_RMSpropWithWeightDecayAndCenteredAndMomentum_CUDA) {
+  check_exact_values<RMSprop>(
+      RMSpropOptions(0.1).weight_decay(1e-6).centered(true).momentum(0.9),
+      expected_parameters::
+          RMSprop_with_weight_decay_and_centered_and_momentum(),
+      torch::kCUDA);
+}
+
 TEST(OptimTest, ProducesPyTorchValues_LBFGS) {
   check_exact_values<LBFGS>(
       LBFGSOptions(1.0),
@@ -409,6 +454,50 @@ TEST(OptimTest, ExternalVectorOfParameters) {
   ASSERT_TRUE(parameters[2].allclose(original_parameters[2] - 1.0));
 }
 
+TEST(OptimTest, FlattenedParameters) {
+  torch::manual_seed(0);
+  Sequential model(Linear(3, 4), Functional(torch::tanh), Linear(4, 2));
+  Sequential flat_model(Linear(3, 4), Functional(torch::tanh), Linear(4, 2));
+  {
+    torch::NoGradGuard no_grad;
+    auto params = model->parameters();
+    auto flat_model_params = flat_model->parameters();
+    for (size_t i = 0; i < params.size(); ++i) {
+      flat_model_params[i].copy_(params[i]);
+    }
+  }
+
+  auto flat = flatten_parameters(flat_model->parameters());
+  ASSERT_EQ(flat.dim(), 1);
+  ASSERT_EQ(flat.numel(), 3 * 4 + 4 + 4 * 2 + 2);
+  ASSERT_TRUE(flat.grad().defined());
+
+  Adam optimizer(model->parameters(), AdamOptions(0.1).weight_decay(1e-2));
+  Adam flat_optimizer({flat}, AdamOptions(0.1).weight_decay(1e-2));
+  const auto input = torch::randn({5, 3});
+  for (int i = 0; i < 10; ++i) {
+    optimizer.zero_grad();
+    model->forward(input).sum().backward();
+    optimizer.step();
+
+    flat_optimizer.zero_grad();
+    flat_model->forward(input).sum().backward();
+    flat_optimizer.step();
+  }
+
+  auto params = model->parameters();
+  auto flat_model_params = flat_model->parameters();
+  int64_t offset = 0;
+  for (size_t i = 0; i < params.size(); ++i) {
+    ASSERT_TRUE(flat_model_params[i].allclose(params[i]));
+    // The parameters of the module still alias the flat tensor.
+    ASSERT_TRUE(flat.narrow(0, offset, params[i].numel())
+                    .view(params[i].sizes())
+                    .equal(flat_model_params[i]));
+    offset += params[i].numel();
+  }
+}
+
 TEST(OptimTest, AddParameter_LBFGS) {
   torch::manual_seed(0);
 
@@ -1147,6 +1147,42 @@ void testMemoryDAG() {
       AT_ASSERT(!dag->mayContainAlias(e, elem));
     }
   }
+  {
+    // Memoized contained memory locations agree with a fresh walk, whatever
+    // order they are queried in.
+    // c(b) and b(a), d -> c, e(d)
+    auto t = std::make_unique<MemoryDAGBuilder>();
+    auto a = t->makeFreshValue(aValue);
+    auto b = t->makeFreshValue(bValue);
+    auto c = t->makeFreshValue(cValue);
+    auto d = t->makeFreshValue(dValue);
+    auto e = t->makeFreshValue(eValue);
+    auto g = t->makeFreshValue(gValue);
+    t->addToContainedElements(a, b);
+    t->addToContainedElements(b, c);
+    t->makePointerTo(d, c);
+    t->addToContainedElements(d, e);
+
+    auto dag = std::make_unique<MemoryDAG>(std::move(t));
+    AT_ASSERT(dag->mayContainAlias(b, a));
+    AT_ASSERT(dag->mayContainAlias(e, a));
+    AT_ASSERT(dag->mayContainAlias(d, b));
+    AT_ASSERT(!dag->mayContainAlias(e, g));
+    for (auto elem : {e, d, c, b, a}) {
+      MemoryLocations walked;
+      walked.set(elem->index);
+      for (auto loc : dag->getMemoryLocations(elem)) {
+        dag->collectAllContainedMemoryLocations(dag->fromIndex(loc), walked);
+      }
+      for (auto contained : elem->containedElements) {
+        dag->collectAllContainedMemoryLocations(
+            dag->fromIndex(contained), walked);
+      }
+      AT_ASSERT(walked == dag->getAllContainedMemoryLocations(elem));
+    }
+    AT_ASSERT(dag->getAllContainedMemoryLocations(e).test(a->index));
+    AT_ASSERT(!dag->getAllContainedMemoryLocations(a).test(e->index));
+  }
 }
 
 void testAliasRegistration() {
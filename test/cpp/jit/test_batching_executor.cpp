@@ -0,0 +1,84 @@
+#include <test/cpp/jit/test_base.h>
+#include <test/cpp/jit/test_utils.h>
+
+#include <torch/csrc/jit/runtime/batching_executor.h>
+#include <torch/torch.h>
+
+#include <thread>
+
+namespace torch {
+namespace jit {
+
+void testBatchingExecutor() {
+  {
+    Module m("m");
+    m.register_parameter("weight", at::randn({3, 4}), false);
+    m.register_parameter("bias", at::randn({3}), false);
+    m.define(R"(
+      def forward(self, x):
+          y = torch.linear(x, self.weight, self.bias)
+          return torch.softmax(torch.relu(y), 1), y + x.sum(1, keepdim=True)
+    )");
+    BatchingOptions options;
+    options.max_batch_size = 4;
+    options.timeout = std::chrono::milliseconds(5);
+    BatchingExecutor executor(m, options);
+    ASSERT_TRUE(executor.batchable());
+
+    std::vector<at::Tensor> inputs;
+    std::vector<c10::intrusive_ptr<c10::ivalue::Future>> futures;
+    for (int i = 0; i < 10; ++i) {
+      inputs.push_back(at::randn({1 + i % 2, 4}));
+      futures.push_back(executor.enqueue({inputs.back()}));
+    }
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      futures[i]->wait();
+      auto expected = m.forward({inputs[i]}).toTuple()->elements();
+      auto actual = futures[i]->value().toTuple()->elements();
+      ASSERT_EQ(actual.size(), 2);
+      ASSERT_TRUE(almostEqual(actual[0].toTensor(), expected[0].toTensor()));
+      ASSERT_TRUE(almostEqual(actual[1].toTensor(), expected[1].toTensor()));
+    }
+
+    // Concurrent blocking calls.
+    std::vector<std::thread> threads;
+    std::vector<char> ok(8, 0);
+    for (size_t t = 0; t < ok.size(); ++t) {
+      threads.emplace_back([&, t] {
+        auto x = at::randn({1, 4});
+        auto expected = m.forward({x}).toTuple()->elements();
+        auto actual = executor.run({x}).toTuple()->elements();
+        ok[t] = almostEqual(actual[0].toTensor(), expected[0].toTensor());
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (char b : ok) {
+      ASSERT_TRUE(b);
+    }
+
+    // Errors only affect their own request.
+    auto bad = executor.enqueue({at::randn({1, 5})});
+    auto good = executor.enqueue({at::randn({1, 4})});
+    bad->wait();
+    good->wait();
+    ASSERT_TRUE(bad->hasError());
+    ASSERT_FALSE(good->hasError());
+  }
+  {
+    // Reducing over the batch dimension mixes samples.
+    Module m("m");
+    m.define(R"(
+      def forward(self, x):
+          return x - x.mean(0, keepdim=True)
+    )");
+    BatchingExecutor executor(m);
+    ASSERT_FALSE(executor.batchable());
+    auto x = at::randn({1, 4});
+    ASSERT_TRUE(almostEqual(executor.run({x}).toTensor(), at::zeros({1, 4})));
+  }
+}
+
+} // namespace jit
+} // namespace torch
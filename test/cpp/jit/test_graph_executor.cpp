@@ -1,5 +1,6 @@
 #include "test/cpp/jit/test_base.h"
 #include "test/cpp/jit/test_utils.h"
+#include "torch/csrc/jit/ir/irparser.h"
 #include "torch/csrc/jit/runtime/graph_executor.h"
 
 namespace torch {
@@ -28,5 +29,37 @@ void testGraphExecutor() {
   ASSERT_TRUE(almostEqual(stack[1].toTensor(), r1));
 }
 
+void testGraphExecutorBackgroundCompilation() {
+  auto graph = std::make_shared<Graph>();
+  parseIR(
+      R"IR(
+graph(%a : Tensor, %b : Tensor):
+  %c : int = prim::Constant[value=1]()
+  %d : Tensor = aten::mul(%a, %b)
+  %e : Tensor = aten::add(%d, %a, %c)
+  return (%e))IR",
+      graph.get());
+
+  auto old_mode = getBackgroundCompilationMode().exchange(true);
+  auto a = at::randn({2, 3});
+  auto b = at::randn({2, 3});
+  auto expected = a * b + a;
+
+  GraphExecutor executor(graph, "");
+  // The first runs don't wait for the optimized plan.
+  for (int i = 0; i < 3; ++i) {
+    auto stack = createStack({a, b});
+    executor.run(stack);
+    ASSERT_TRUE(almostEqual(stack[0].toTensor(), expected));
+  }
+  executor.waitForBackgroundCompilation();
+  ASSERT_EQ(executor.getDebugState().execution_plans.size(), 1);
+
+  auto stack = createStack({a, b});
+  executor.run(stack);
+  ASSERT_TRUE(almostEqual(stack[0].toTensor(), expected));
+  getBackgroundCompilationMode() = old_mode;
+}
+
 } // namespace jit
 } // namespace torch
@@ -1,4 +1,5 @@
 #include <c10/core/TensorOptions.h>
+#include <caffe2/serialize/inline_container.h>
 #include <test/cpp/jit/test_base.h>
 #include <torch/csrc/autograd/generated/variable_factories.h>
 #include <torch/csrc/jit/api/module.h>
@@ -101,6 +102,61 @@ void testLiteInterpreterConv() {
       outputref[0][0][0][0].item<int>() == output[0][0][0][0].item<int>());
 }
 
+void testLiteInterpreterUnboxedOps() {
+  // Ops with unboxed kernels give the same results as the JIT.
+  Module m("m");
+  m.register_parameter("weight", torch::rand({3, 4}), false);
+  m.register_parameter("bias", torch::rand({3}), false);
+  m.define(R"(
+    def forward(self, x, y):
+      z = torch.linear(x, self.weight, self.bias)
+      z = torch.addmm(self.bias, x, self.weight.t(), beta=2, alpha=0.5)
+      w = torch.relu(z - y) * torch.sigmoid(y) + torch.tanh(z)
+      return torch.matmul(w, torch.linear(x, self.weight).t())
+  )");
+  std::vector<IValue> inputs = {torch::rand({2, 4}), torch::rand({2, 3})};
+  auto ref = m.forward(inputs).toTensor();
+
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+  for (int i = 0; i < 3; ++i) {
+    auto res = bc.run_method("forward", inputs).toTensor();
+    AT_ASSERT(res.allclose(ref));
+  }
+}
+
+void testLiteInterpreterFlatBytecode() {
+  // Methods are loaded from bytecode.bin, with constants of every kind.
+  Module m("m");
+  m.register_parameter("foo", torch::ones({2}), false);
+  m.define(R"(
+    def forward(self, x: Tensor, mode: str, flag: bool):
+      scale = 2.5
+      offset = 3
+      if mode == "affine" and flag:
+        return self.foo * x * scale + offset
+      return x
+  )");
+  std::vector<IValue> inputs = {torch::rand({2}), "affine", true};
+  auto ref = m.forward(inputs).toTensor();
+
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  {
+    caffe2::serialize::PyTorchStreamReader reader(&ss);
+    AT_ASSERT(reader.hasRecord("bytecode.bin"));
+    AT_ASSERT(reader.hasRecord("bytecode.pkl"));
+  }
+  ss.seekg(0);
+  mobile::Module bc = _load_for_mobile(ss);
+  auto res = bc.run_method("forward", inputs).toTensor();
+  AT_ASSERT(res.equal(ref));
+  std::vector<IValue> identity_inputs = {inputs[0], "identity", true};
+  res = bc.run_method("forward", identity_inputs).toTensor();
+  AT_ASSERT(res.equal(inputs[0].toTensor()));
+}
+
 void testLiteInterpreterInline() {
   Module m("m");
   m.define(R"JIT(
@@ -54,6 +54,7 @@
 
 #include <c10/util/Exception.h>
 #include <c10/util/ThreadLocalDebugInfo.h>
+#include <c10/util/tempfile.h>
 
 #include <algorithm>
 #include <cstddef>
@@ -67,6 +68,11 @@
 #include <utility>
 #include <vector>
 
+#ifndef _WIN32
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
 using namespace torch::autograd::profiler;
 
 namespace torch {
@@ -1455,6 +1461,82 @@ void testProfiler() {
   checkShape(*tanh_n, eltwise);
 }
 
+void testProfilerFusibleOnly() {
+  auto graph = std::make_shared<Graph>();
+  parseIR(
+      R"IR(
+graph(%x : Tensor, %w : Tensor):
+  %y : Tensor = aten::mm(%x, %w)
+  %z : Tensor = aten::sigmoid(%y)
+  return (%z))IR",
+      &*graph);
+
+  FLAGS_torch_jit_profile_fusible_only = true;
+  auto pr = ProfilingRecord::instrumentGraph(graph);
+  FLAGS_torch_jit_profile_fusible_only = false;
+  auto nodes = pr->profiled_graph_->block()->nodes();
+  auto mm = std::find_if(
+      nodes.begin(), nodes.end(), [](Node* n) { return n->kind() == aten::mm; });
+  ASSERT_NE(mm, nodes.end());
+  for (auto i : mm->inputs()) {
+    ASSERT_NE(i->node()->kind(), prim::profile);
+  }
+  auto sigmoid_n = std::find_if(nodes.begin(), nodes.end(), [](Node* n) {
+    return n->kind() == aten::sigmoid;
+  });
+  ASSERT_NE(sigmoid_n, nodes.end());
+  ASSERT_EQ(sigmoid_n->input()->node()->kind(), prim::profile);
+}
+
+void testProfilerSavedTypes() {
+#ifndef _WIN32
+  auto dir = c10::detail::make_filename("torch-profiles-");
+  ASSERT_NE(mkdtemp(dir.data()), nullptr);
+  FLAGS_torch_jit_profile_dir = dir.data();
+
+  auto g = build_lstm();
+  auto pr = ProfilingRecord::instrumentGraph(g);
+  ASSERT_FALSE(pr->ready());
+  auto stack = createStack(
+      {at::randn({4, 256}, at::kCPU),
+       at::randn({4, 512}, at::kCPU),
+       at::randn({4, 512}, at::kCPU),
+       t_def(at::randn({2048, 256}, at::kCPU)),
+       t_def(at::randn({2048, 512}, at::kCPU))});
+  Code cd(pr->profiled_graph_, "");
+  InterpreterState is{cd};
+  is.run(stack);
+  ASSERT_TRUE(pr->ready());
+
+  // a second executor of the graph starts from the saved types
+  auto seeded = ProfilingRecord::instrumentGraph(g);
+  ASSERT_TRUE(seeded->ready());
+  auto profiled = pr->profiled_graph_->block()->nodes();
+  auto loaded = seeded->profiled_graph_->block()->nodes();
+  auto it = loaded.begin();
+  for (auto n : profiled) {
+    ASSERT_NE(it, loaded.end());
+    ASSERT_EQ(n->kind(), it->kind());
+    if (n->kind() == prim::profile && n->outputs().size() == 1) {
+      ASSERT_TRUE(*n->output()->type() == *it->output()->type());
+      ASSERT_TRUE(n->output()->type()->expect<TensorType>()->isComplete());
+    }
+    ++it;
+  }
+
+  FLAGS_torch_jit_profile_dir = "";
+  DIR* d = opendir(dir.data());
+  while (auto entry = readdir(d)) {
+    std::string name = entry->d_name;
+    if (name != "." && name != "..") {
+      std::remove((std::string(dir.data()) + "/" + name).c_str());
+    }
+  }
+  closedir(d);
+  rmdir(dir.data());
+#endif
+}
+
 void testCallStack() {
   const auto text = R"(
 def ham(x):
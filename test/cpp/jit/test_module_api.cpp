@@ -210,5 +210,39 @@ void testModuleParameter() {
   ASSERT_TRUE(m.hasattr("none_param2"));
 }
 
+void testModuleRunAsync() {
+  Module m("m");
+  m.register_parameter("foo", torch::ones({}), false);
+  m.define(R"(
+    def forward(self, fut: Future[Tensor], b: int = 4):
+      return torch.wait(fut) + self.foo + b
+  )");
+
+  size_t launched = 0;
+  auto taskLauncher = [&launched](std::function<void()> f) {
+    ++launched;
+    f();
+  };
+
+  // A completed input future runs to the end without suspending.
+  auto input = c10::make_intrusive<c10::ivalue::Future>(TensorType::get());
+  input->markCompleted(torch::ones({}));
+  auto result = m.get_method("forward").run_async({input}, {}, taskLauncher);
+  ASSERT_TRUE(result->completed());
+  ASSERT_EQ(result->value().toTensor().item<float>(), 6);
+  ASSERT_EQ(launched, 0);
+
+  // An incomplete one suspends the interpreter, and completing it resumes
+  // the continuation through the task launcher.
+  input = c10::make_intrusive<c10::ivalue::Future>(TensorType::get());
+  result =
+      m.get_method("forward").run_async({input}, {{"b", 1}}, taskLauncher);
+  ASSERT_FALSE(result->completed());
+  input->markCompleted(torch::ones({}));
+  ASSERT_TRUE(result->completed());
+  ASSERT_EQ(result->value().toTensor().item<float>(), 3);
+  ASSERT_EQ(launched, 1);
+}
+
 } // namespace jit
 } // namespace torch
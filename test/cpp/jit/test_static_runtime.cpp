@@ -0,0 +1,85 @@
+#include <test/cpp/jit/test_base.h>
+#include <test/cpp/jit/test_utils.h>
+
+#include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/runtime/static/impl.h>
+#include <torch/torch.h>
+
+namespace torch {
+namespace jit {
+
+void testStaticRuntime() {
+  {
+    // A graph with unboxed kernels and a boxed op in between.
+    const auto graph_string = R"IR(
+      graph(%x : Tensor, %w : Tensor, %b : Tensor):
+        %1 : int = prim::Constant[value=1]()
+        %y : Tensor = aten::addmm(%b, %x, %w, %1, %1)
+        %z : Tensor = aten::relu(%y)
+        %t : Tensor = aten::t(%z)
+        %u : Tensor = aten::tanh(%t)
+        %v : Tensor = aten::add(%u, %u, %1)
+        return (%v))IR";
+    auto graph = std::make_shared<Graph>();
+    parseIR(graph_string, graph.get());
+    StaticRuntime runtime(graph);
+    ASSERT_TRUE(runtime.nodes().at(0).hasStaticKernel());
+    ASSERT_FALSE(runtime.nodes().at(2).hasStaticKernel());
+
+    at::Tensor prev;
+    for (int i = 0; i < 3; ++i) {
+      auto x = at::randn({4, 5});
+      auto w = at::randn({5, 6});
+      auto b = at::randn({6});
+      auto expected = at::add(
+          at::tanh(at::relu(at::addmm(b, x, w)).t()),
+          at::tanh(at::relu(at::addmm(b, x, w)).t()));
+      auto outputs = runtime.run(std::vector<at::Tensor>{x, w, b});
+      ASSERT_EQ(outputs.size(), 1);
+      ASSERT_TRUE(almostEqual(outputs[0], expected));
+      // The output of a run belongs to the caller.
+      if (prev.defined()) {
+        ASSERT_NE(prev.data_ptr(), outputs[0].data_ptr());
+      }
+      prev = outputs[0];
+    }
+  }
+  {
+    // A frozen module.
+    Module m("m");
+    m.register_parameter("weight", at::randn({3, 4}), false);
+    m.register_parameter("bias", at::randn({3}), false);
+    m.define(R"(
+      def forward(self, x):
+          y = torch.addmm(self.bias, x, self.weight.t())
+          return torch.sigmoid(y) * y
+    )");
+    m.eval();
+    StaticRuntime runtime(m);
+    for (int i = 0; i < 2; ++i) {
+      auto x = at::randn({2, 4});
+      auto expected = m.forward({x}).toTensor();
+      auto outputs = runtime.run(std::vector<IValue>{x});
+      ASSERT_EQ(outputs.size(), 1);
+      ASSERT_TRUE(almostEqual(outputs[0].toTensor(), expected));
+    }
+  }
+  {
+    // Control flow isn't supported.
+    const auto graph_string = R"IR(
+      graph(%c : bool, %x : Tensor):
+        %y : Tensor = prim::If(%c)
+          block0():
+            -> (%x)
+          block1():
+            %z : Tensor = aten::relu(%x)
+            -> (%z)
+        return (%y))IR";
+    auto graph = std::make_shared<Graph>();
+    parseIR(graph_string, graph.get());
+    ASSERT_ANY_THROW(StaticRuntime{graph});
+  }
+}
+
+} // namespace jit
+} // namespace torch
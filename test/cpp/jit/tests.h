@@ -47,6 +47,8 @@ namespace jit {
   _(ClassParser)                       \
   _(UnifyTypes)                        \
   _(Profiler)                          \
+  _(ProfilerFusibleOnly)               \
+  _(ProfilerSavedTypes)                \
   _(InsertAndEliminateRedundantGuards) \
   _(InsertBailOuts)                    \
   _(PeepholeOptimize)                  \
@@ -57,6 +59,7 @@ namespace jit {
   _(ModuleClone)                       \
   _(ModuleConstant)                    \
   _(ModuleParameter)                   \
+  _(ModuleRunAsync)                    \
   _(ModuleCopy)                        \
   _(ModuleDeepcopy)                    \
   _(ModuleDeepcopyString)              \
@@ -76,6 +79,8 @@ namespace jit {
   _(Inliner)                           \
   _(LiteInterpreterAdd)                \
   _(LiteInterpreterConv)               \
+  _(LiteInterpreterUnboxedOps)         \
+  _(LiteInterpreterFlatBytecode)       \
   _(LiteInterpreterInline)             \
   _(LiteInterpreterTuple)              \
   _(LiteInterpreterUpsampleNearest2d)  \
@@ -90,7 +95,10 @@ namespace jit {
   _(LiteInterpreterSetState)           \
   _(TorchbindIValueAPI)                \
   _(LiteInterpreterDict)               \
-  _(FusionAliasing)
+  _(FusionAliasing)                    \
+  _(StaticRuntime)                     \
+  _(BatchingExecutor)                  \
+  _(GraphExecutorBackgroundCompilation)
 
 #if defined(USE_CUDA)
 #define TH_FORALL_TESTS_CUDA(_)  \
@@ -137,3 +137,43 @@ TEST(TensorpipeSerialize, NoDeleterTensors) {
           t2.storage().data(),
           sendingTpMessage.tensors[1].length) == 0);
 }
+
+TEST(TensorpipeSerialize, CudaTensorsDeviceMap) {
+  if (!torch::cuda::is_available()) {
+    return;
+  }
+  at::Tensor t1 = torch::ones({16}, at::ScalarType::Float);
+  at::Tensor t2 = torch::ones({16}, at::kCUDA);
+  std::vector<at::Tensor> tensors{t1, t2};
+  torch::distributed::rpc::Message sendingRpcMessage(
+      {}, std::move(tensors), torch::distributed::rpc::MessageType::UNKNOWN);
+
+  // CUDA tensors can't be sent without a device map.
+  EXPECT_THROW(
+      torch::distributed::rpc::tensorpipeSerialize(sendingRpcMessage),
+      c10::Error);
+
+  torch::distributed::rpc::TensorPipeEntry tpEntry =
+      torch::distributed::rpc::tensorpipeSerialize(
+          sendingRpcMessage, {{0, 0}});
+  tensorpipe::Message& sendingTpMessage = tpEntry.message;
+  // The CUDA tensor is sent from host memory.
+  EXPECT_TRUE(tpEntry.reservedTensors[1].device().is_cpu());
+
+  torch::distributed::rpc::TensorPipeDevices devices =
+      torch::distributed::rpc::tensorpipeReadDevices(sendingTpMessage);
+  EXPECT_EQ(devices.source, std::vector<c10::DeviceIndex>({-1, 0}));
+  EXPECT_EQ(devices.target, std::vector<c10::DeviceIndex>({-1, 0}));
+
+  torch::distributed::rpc::Message recvingRpcMessage(
+      {},
+      {t1.clone(), tpEntry.reservedTensors[1].clone()},
+      torch::distributed::rpc::MessageType::UNKNOWN);
+  torch::distributed::rpc::DeviceMap reverseDeviceMap =
+      torch::distributed::rpc::tensorpipeMoveToDevices(
+          recvingRpcMessage, devices);
+  EXPECT_TRUE(recvingRpcMessage.tensors()[0].device().is_cpu());
+  EXPECT_EQ(recvingRpcMessage.tensors()[1].device(), t2.device());
+  EXPECT_TRUE(torch::equal(t2, recvingRpcMessage.tensors()[1]));
+  EXPECT_EQ(reverseDeviceMap.at(0), 0);
+}
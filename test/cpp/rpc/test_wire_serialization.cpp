@@ -49,6 +49,43 @@ TEST(WireSerialize, RecopySparseTensors) {
   EXPECT_LT(ser.size(), (tiny.element_size() * k1K) + k1K);
 }
 
+TEST(WireSerialize, ExternalTensorData) {
+  at::Tensor t1 = torch::randn({5, 5});
+  at::Tensor t2 = torch::rand({10, 10});
+  std::vector<at::Tensor> tensorData;
+  auto ser = torch::distributed::rpc::wireSerialize(
+      {'h', 'i'}, {t1, t2, torch::empty({0})}, &tensorData);
+  // The tensor data isn't copied into the serialized payload.
+  EXPECT_LT(ser.size(), t1.nbytes());
+  ASSERT_EQ(tensorData.size(), 3);
+  EXPECT_EQ(tensorData[0].data_ptr(), t1.data_ptr());
+  EXPECT_EQ(tensorData[1].data_ptr(), t2.data_ptr());
+  auto sizes =
+      torch::distributed::rpc::wireTensorDataSizes(ser.data(), ser.size());
+  ASSERT_EQ(sizes.size(), 3);
+  EXPECT_EQ(sizes[0], t1.nbytes());
+  EXPECT_EQ(sizes[1], t2.nbytes());
+  EXPECT_EQ(sizes[2], 0);
+
+  // Receive the tensor data into separate buffers, then deserialize from them.
+  std::vector<at::Tensor> received;
+  std::vector<void*> receivedPtrs;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    received.push_back(tensorData[i].clone());
+    receivedPtrs.push_back(received.back().data_ptr());
+  }
+  auto deser = torch::distributed::rpc::wireDeserialize(
+      ser.data(), ser.size(), &received);
+  EXPECT_EQ(deser.first.size(), 2);
+  ASSERT_EQ(deser.second.size(), 3);
+  EXPECT_TRUE(torch::equal(t1, deser.second[0]));
+  EXPECT_TRUE(torch::equal(t2, deser.second[1]));
+  EXPECT_EQ(deser.second[2].numel(), 0);
+  // The deserialized tensors use the received memory.
+  EXPECT_EQ(deser.second[0].data_ptr(), receivedPtrs[0]);
+  EXPECT_EQ(deser.second[1].data_ptr(), receivedPtrs[1]);
+}
+
 TEST(WireSerialize, CloneSparseTensors) {
   constexpr size_t k1K = 1024;
   at::Tensor big = torch::randn({k1K, k1K});
@@ -1109,6 +1109,47 @@ void testLLVMBroadcastAdd() {
   }
 }
 
+void testLLVMParallelBroadcastAdd() {
+  // Parallelize the outer loop, which captures the kernel arguments, or the
+  // inner loop, which also captures the index of the outer one.
+  for (int level = 0; level < 2; level++) {
+    KernelScope kernel_scope;
+    const int M = 32;
+    const int N = 1024;
+    Buffer a(BufHandle("a", {M, N}, kFloat));
+    Buffer b(BufHandle("b", {N}, kFloat));
+    Tensor* c = Compute(
+        "c", {{M, "i"}, {N, "j"}}, [&](const VarHandle& i, const VarHandle& j) {
+          ExprHandle mask(1);
+          return Load::make(a, {i, j}, mask) + Load::make(b, {j}, mask);
+        });
+
+    Buffer c_buf(BufHandle(c->func_var()));
+    LoopNest l({c});
+    std::vector<For*> loops = l.getLoopStmtsFor(c);
+    l.parallelize(loops[level]);
+    ASSERT_TRUE(loops[level]->loop_options().is_parallel());
+    l.prepareForCodegen();
+    Stmt* s = l.root_stmt();
+
+    LLVMCodeGen cg(s, {a, b, c_buf});
+
+    std::vector<float> av(M * N);
+    std::iota(av.begin(), av.end(), 0);
+    std::vector<float> bv(N);
+    std::iota(bv.begin(), bv.end(), 0);
+    std::vector<float> cv(M * N, 0);
+    std::vector<void*> args({av.data(), bv.data(), cv.data()});
+    ASSERT_EQ(cg.value<int>(args), 0);
+
+    for (int i = 0; i < M; i++) {
+      for (int j = 0; j < N; j++) {
+        ASSERT_EQ(cv[i * N + j], av[i * N + j] + bv[j]);
+      }
+    }
+  }
+}
+
 void testLLVMBitwiseOps() {
   KernelScope kernel_scope;
   auto a = IntImm::make(59);
@@ -291,6 +291,7 @@ namespace jit {
   _(LLVMSimpleMath01)                      \
   _(LLVMComputeMul)                        \
   _(LLVMBroadcastAdd)                      \
+  _(LLVMParallelBroadcastAdd)              \
   _(LLVMBitwiseOps)                        \
   _(LLVMDynamicShapeAdd)                   \
   _(LLVMBindDynamicShapeAdd)               \
@@ -214,6 +214,26 @@ class StoreTestBase(object):
     def test_set_get(self):
         self._test_set_get(self._create_store())
 
+    def test_multi_set_get(self):
+        fs = self._create_store()
+        fs.multi_set(["key0", "key1", "key2"], ["value0", "value1", "value2"])
+        fs.set("key3", "value3")
+        self.assertEqual(
+            [b"value3", b"value0", b"value2"],
+            fs.multi_get(["key3", "key0", "key2"]))
+        self.assertEqual([], fs.multi_get([]))
+        with self.assertRaisesRegex(ValueError, "as many values as keys"):
+            fs.multi_set(["key4", "key5"], ["value4"])
+
+    def test_compare_set(self):
+        fs = self._create_store()
+        # A key that isn't set compares equal to an empty value.
+        self.assertEqual(b"", fs.compare_set("key", "value", "other"))
+        self.assertEqual(b"value", fs.compare_set("key", "", "value"))
+        self.assertEqual(b"value", fs.compare_set("key", "other", "new"))
+        self.assertEqual(b"new", fs.compare_set("key", "value", "new"))
+        self.assertEqual(b"new", fs.get("key"))
+
 
 class FileStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -1554,6 +1574,64 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
                 self.assertEqual(torch.full([10, 10], self.world_size), tensor)
             del pg
 
+    def _create_hierarchical_pg(self, local_world_size):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        node, local_rank = divmod(self.rank, local_world_size)
+        num_nodes = self.world_size // local_world_size
+        intra_node_group = c10d.ProcessGroupGloo(
+            c10d.PrefixStore("intra/%d" % node, store),
+            local_rank,
+            local_world_size,
+            self.opts())
+        inter_node_group = c10d.ProcessGroupGloo(
+            c10d.PrefixStore("inter/%d" % local_rank, store),
+            node,
+            num_nodes,
+            self.opts())
+        return c10d._hierarchical_process_groups(
+            intra_node_group, inter_node_group)
+
+    def test_hierarchical_allreduce(self):
+        pg = self._create_hierarchical_pg(local_world_size=2)
+        self.assertEqual(self.rank, pg.rank())
+        self.assertEqual(self.world_size, pg.size())
+
+        # The sizes don't divide evenly into shards.
+        for size in [[1], [7, 3], [100, 100]]:
+            tensor = torch.full(size, float(self.rank + 1))
+            pg.allreduce(tensor).wait()
+            expected = sum(range(1, self.world_size + 1))
+            self.assertEqual(torch.full(size, float(expected)), tensor)
+
+        tensor = torch.tensor([float(self.rank + 1)])
+        pg.allreduce(tensor, c10d.ReduceOp.MAX).wait()
+        self.assertEqual(torch.tensor([float(self.world_size)]), tensor)
+
+    def test_hierarchical_broadcast(self):
+        pg = self._create_hierarchical_pg(local_world_size=2)
+        for root in range(self.world_size):
+            tensor = torch.full([10, 10], float(self.rank))
+            pg.broadcast(tensor, root=root).wait()
+            self.assertEqual(torch.full([10, 10], float(root)), tensor)
+
+    def test_hierarchical_allgather(self):
+        pg = self._create_hierarchical_pg(local_world_size=2)
+        outputs = [torch.zeros(2, 3) for _ in range(self.world_size)]
+        pg.allgather(outputs, torch.full([2, 3], float(self.rank))).wait()
+        for rank, output in enumerate(outputs):
+            self.assertEqual(torch.full([2, 3], float(rank)), output)
+
+    def test_hierarchical_barrier(self):
+        pg = self._create_hierarchical_pg(local_world_size=2)
+        pg.barrier().wait()
+
+    def test_hierarchical_invalid_layout(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+        # Both groups span all processes, which doesn't form a two-level layout.
+        with self.assertRaisesRegex(RuntimeError, "to span"):
+            c10d._hierarchical_process_groups(pg, pg)
+
 
 @requires_nccl()
 class ProcessGroupNCCLTest(TestCase):
@@ -1639,6 +1717,25 @@ class ProcessGroupNCCLTest(TestCase):
                 torch.tensor([float(self.num_gpus * (self.num_gpus + 1) / 2)]),
                 tensors[i])
 
+    def test_allreduce_coalesced_ops(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+
+        tensors = [torch.full((i % 3 + 1, 2), float(i)).cuda(0) for i in range(100)]
+        expected = [t.clone() for t in tensors]
+        for op in [c10d.ReduceOp.SUM, c10d.ReduceOp.MAX]:
+            opts = c10d.AllreduceCoalescedOptions()
+            opts.reduceOp = op
+            pg.allreduce_coalesced(tensors, opts).wait()
+            # With a single process, the reduction keeps the values.
+            self.assertEqual(expected, tensors)
+
+        with self.assertRaisesRegex(ValueError, "tensors must all have the same type"):
+            pg.allreduce_coalesced([tensors[0], tensors[1].double()])
+
+        with self.assertRaisesRegex(ValueError, "tensors must all be on the same device"):
+            pg.allreduce_coalesced([tensors[0], tensors[1].cuda(1)])
+
         # Product
         tensors = []
         for i in range(self.num_gpus):
@@ -2364,6 +2461,43 @@ class DistributedDataParallelTest(MultiProcessTestCase):
         )
         run_and_verify_grad(gpu_model)
 
+    @requires_gloo()
+    def test_cache_unused_parameters(self):
+        """
+        With `cache_unused_parameters=True`, the unused parameters are found
+        once per set of submodules called by forward, and reused afterwards.
+        """
+        class TwoBranchModule(nn.Module):
+            def __init__(self):
+                super(TwoBranchModule, self).__init__()
+                self.a = nn.Linear(2, 2, bias=False)
+                self.b = nn.Linear(2, 2, bias=False)
+
+            def forward(self, x, use_a):
+                return self.a(x) if use_a else self.b(x)
+
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+        model = DistributedDataParallel(
+            TwoBranchModule(),
+            process_group=process_group,
+            find_unused_parameters=True,
+            cache_unused_parameters=True,
+        )
+
+        for use_a in [True, False, True, False]:
+            model.zero_grad()
+            model(torch.ones(1, 2), use_a).sum().backward()
+            used, unused = (model.module.a, model.module.b) if use_a else (
+                model.module.b, model.module.a)
+            self.assertEqual(used.weight.grad, torch.ones(2, 2))
+            # Globally unused parameters keep their (zeroed or no) grad.
+            self.assertTrue(
+                unused.weight.grad is None or not unused.weight.grad.any())
+
+        # Both branches were traversed once.
+        self.assertEqual(len(model._unused_parameters_graph_keys), 2)
+
     @requires_nccl()
     @skip_if_not_multigpu
     def test_multiple_outputs_multiple_backward(self):
@@ -2896,6 +3030,86 @@ class ReducerTest(TestCase):
             output.backward()
             optimizer.step()
 
+    def _run_comm_hook(self, hook):
+        # Returns the gradients of the model reduced with and without HOOK.
+        torch.manual_seed(0)
+        random.seed(0)
+        batch_size = 10
+        input = torch.rand([batch_size, 2])
+        target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+        grads = []
+        model = ReducerModule()
+        for comm_hook in [None, hook]:
+            model.zero_grad()
+            reducer = self._create_reducer_for_models([model])
+            if comm_hook is not None:
+                reducer.register_comm_hook(comm_hook)
+            output = nn.CrossEntropyLoss()(model(input), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            grads.append([p.grad.clone() for p in model.parameters()])
+        return grads
+
+    def test_fp16_compress_hook(self):
+        expected, actual = self._run_comm_hook(c10d.FP16CompressHook(self.process_group))
+        for e, a in zip(expected, actual):
+            self.assertEqual(e, a, atol=1e-3, rtol=1e-3)
+
+    def test_power_sgd_hook(self):
+        # A full rank approximation of a process' own gradients is exact.
+        hook = c10d.PowerSGDHook(self.process_group, matrix_approximation_rank=16)
+        expected, actual = self._run_comm_hook(hook)
+        for e, a in zip(expected, actual):
+            self.assertEqual(e, a, atol=1e-4, rtol=1e-4)
+
+    def test_top_k_sparsify_hook(self):
+        expected, actual = self._run_comm_hook(
+            c10d.TopKSparsifyHook(self.process_group, ratio=1.0))
+        for e, a in zip(expected, actual):
+            self.assertEqual(e, a)
+
+        # With error feedback, what isn't sent in one iteration is sent in the
+        # next, so the gradients sum up to the same.
+        hook = c10d.TopKSparsifyHook(self.process_group, ratio=0.5)
+        expected, first = self._run_comm_hook(hook)
+        _, second = self._run_comm_hook(hook)
+        for e, f, s in zip(expected, first, second):
+            self.assertEqual(e * 2, f + s)
+
+    def test_rebuild_buckets(self):
+        batch_size = 10
+        model = ReducerModule()
+        parameters = list(model.parameters())
+        # One bucket per parameter, in the order they are defined, which is the
+        # reverse of the order their gradients become ready in.
+        reducer = dist.Reducer(
+            [parameters],
+            [[i] for i in range(len(parameters))],
+            self.process_group,
+            bucket_size_limits=[1])
+        # Nothing to rebuild from before the first backward pass.
+        self.assertFalse(reducer._rebuild_buckets())
+
+        loss = nn.CrossEntropyLoss()
+        for i in range(3):
+            model.zero_grad()
+            input = torch.rand([batch_size, 2])
+            target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+            output = loss(model(input), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            expected = torch.autograd.grad(loss(model(input), target), parameters)
+            for p, g in zip(parameters, expected):
+                self.assertEqual(g, p.grad)
+            # The buckets are rebuilt once, after the first iteration.
+            self.assertEqual(i == 0, reducer._rebuild_buckets())
+
+    def test_register_comm_hook_twice(self):
+        reducer = self._create_reducer_for_models([ReducerModule()])
+        reducer.register_comm_hook(c10d.FP16CompressHook(self.process_group))
+        with self.assertRaisesRegex(RuntimeError, "only be called once"):
+            reducer.register_comm_hook(c10d.FP16CompressHook(self.process_group))
+
 
 class ComputeBucketAssignmentTest(TestCase):
     def test_single_limit_single_dtype(self):
@@ -3183,6 +3397,66 @@ class CommTest(MultiProcessTestCase):
         self._test_broadcast_coalesced(process_group, device)
 
 
+class ZeroRedundancyOptimizerTest(MultiProcessTestCase):
+    def setUp(self):
+        super(ZeroRedundancyOptimizerTest, self).setUp()
+        self._fork_processes()
+
+    def tearDown(self):
+        super(ZeroRedundancyOptimizerTest, self).tearDown()
+        try:
+            os.remove(self.file_name)
+        except OSError:
+            pass
+
+    @property
+    def world_size(self):
+        return 3
+
+    def _inputs(self, rank, iteration):
+        torch.manual_seed(rank * 100 + iteration)
+        return torch.randn(4, 5)
+
+    @requires_gloo()
+    def test_step_matches_local_optimizer(self):
+        from torch.distributed.optim import ZeroRedundancyOptimizer
+
+        store = c10d.FileStore(self.file_name, self.world_size)
+        c10d.init_process_group(
+            "gloo", store=store, rank=self.rank, world_size=self.world_size)
+
+        torch.manual_seed(0)
+        model = nn.Sequential(nn.Linear(5, 7), nn.ReLU(), nn.Linear(7, 3))
+        reference = copy.deepcopy(model)
+        # The parameters of the other processes are overwritten by the ones
+        # of process 0.
+        if self.rank != 0:
+            for p in model.parameters():
+                p.data.fill_(self.rank)
+
+        optimizer = ZeroRedundancyOptimizer(
+            model.parameters(), torch.optim.Adam, lr=0.1)
+        reference_optimizer = torch.optim.Adam(reference.parameters(), lr=0.1)
+        self.assertLess(
+            sum(len(group["params"]) for group in optimizer.param_groups),
+            len(list(model.parameters())))
+
+        for iteration in range(3):
+            optimizer.zero_grad()
+            model(self._inputs(self.rank, iteration)).sum().backward()
+            optimizer.step()
+
+            # The reference sees the average of the gradients of all processes.
+            reference_optimizer.zero_grad()
+            for rank in range(self.world_size):
+                loss = reference(self._inputs(rank, iteration)).sum()
+                (loss / self.world_size).backward()
+            reference_optimizer.step()
+
+            for p, expected in zip(model.parameters(), reference.parameters()):
+                self.assertEqual(expected, p)
+
+
 if __name__ == '__main__':
     assert not torch.cuda._initialized, "test_distributed must not have initialized CUDA context on main process"
 
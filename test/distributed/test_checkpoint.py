@@ -0,0 +1,85 @@
+import os
+import shutil
+import tempfile
+
+import torch
+from torch.distributed.checkpoint import Shard, load_manifest, load_sharded, load_tensors, save_sharded
+from torch.testing._internal.common_utils import TestCase, load_tests, run_tests
+
+
+# load_tests from common_utils is used to automatically filter tests for
+# sharding on sandcastle. This line silences flake warnings
+load_tests = load_tests
+
+
+class ShardedCheckpointTest(TestCase):
+    def setUp(self):
+        super(ShardedCheckpointTest, self).setUp()
+        self.path = tempfile.mkdtemp()
+
+    def tearDown(self):
+        super(ShardedCheckpointTest, self).tearDown()
+        shutil.rmtree(self.path)
+
+    def _save(self, weight, bias, world_size, bounds):
+        # Saves WEIGHT sharded by rows at BOUNDS, as if by WORLD_SIZE ranks.
+        for rank in range(world_size):
+            begin, end = bounds[rank], bounds[rank + 1]
+            state_dict = {
+                'weight': Shard(weight[begin:end], [begin, 0], list(weight.size())),
+                'bias': bias,
+                'step': 7,
+            }
+            save_sharded(state_dict, self.path, rank=rank, world_size=world_size)
+
+    def test_save_and_load(self):
+        weight = torch.randn(8, 4)
+        bias = torch.arange(4, dtype=torch.int64)
+        self._save(weight, bias, 2, [0, 5, 8])
+        self.assertEqual(sorted(os.listdir(self.path)),
+                         ['manifest_0.json', 'manifest_1.json', 'shard_0.pt', 'shard_1.pt'])
+
+        manifest = load_manifest(self.path)
+        self.assertEqual(manifest['weight']['dtype'], 'torch.float32')
+        self.assertEqual(manifest['weight']['size'], [8, 4])
+        self.assertEqual(sorted(s['file'] for s in manifest['weight']['shards']),
+                         ['shard_0.pt', 'shard_1.pt'])
+        # Unsharded values are only saved by rank 0.
+        self.assertEqual([s['file'] for s in manifest['bias']['shards']], ['shard_0.pt'])
+
+        loaded = load_tensors(self.path)
+        self.assertEqual(loaded['weight'], weight)
+        self.assertEqual(loaded['bias'], bias)
+        self.assertEqual(loaded['step'], 7)
+
+    def test_reshard(self):
+        weight = torch.randn(8, 4)
+        bias = torch.randn(4)
+        self._save(weight, bias, 2, [0, 5, 8])
+
+        # Load as three ranks sharding by columns.
+        for begin, end in [(0, 1), (1, 3), (3, 4)]:
+            shard = Shard(torch.empty(8, end - begin), [0, begin], [8, 4])
+            state_dict = {'weight': shard}
+            load_sharded(self.path, state_dict)
+            self.assertEqual(shard.tensor, weight[:, begin:end])
+
+    def test_selective_load(self):
+        weight = torch.randn(8, 4)
+        bias = torch.randn(4)
+        self._save(weight, bias, 2, [0, 5, 8])
+        loaded = load_tensors(self.path, ['bias'])
+        self.assertEqual(list(loaded.keys()), ['bias'])
+        self.assertEqual(loaded['bias'], bias)
+        with self.assertRaises(KeyError):
+            load_tensors(self.path, ['missing'])
+
+    def test_missing_shard(self):
+        weight = torch.randn(8, 4)
+        save_sharded({'weight': Shard(weight[:5], [0, 0], [8, 4])}, self.path, rank=0, world_size=2)
+        with self.assertRaisesRegex(RuntimeError, "missing the manifest of rank 1"):
+            load_tensors(self.path)
+
+
+if __name__ == '__main__':
+    run_tests()
@@ -5,6 +5,7 @@ from torch.testing._internal.jit_utils import JitTestCase
 from torch.testing import FileCheck
 
 import io
+import unittest
 
 if __name__ == '__main__':
     raise RuntimeError("This test file is not meant to be run directly, use:\n\n"
@@ -809,3 +810,58 @@ class TestFreezing(JitTestCase):
         out3 = smod(inp)
         self.assertNotEqual(out1, out2)
         self.assertEqual(out2, out3)
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_freeze_conv_linear_to_mkldnn(self):
+        class Net(nn.Module):
+            def __init__(self):
+                super(Net, self).__init__()
+                self.conv1 = nn.Conv2d(3, 8, 3, padding=1)
+                self.conv2 = nn.Conv2d(8, 8, 3, stride=2)
+                self.fc = nn.Linear(8, 4)
+
+            def forward(self, x):
+                x = torch.relu(self.conv1(x))
+                x = torch.relu(self.conv2(x))
+                x = torch.adaptive_avg_pool2d(x, (1, 1))
+                return self.fc(x.flatten(1))
+
+        mod = Net().eval()
+        fmod = torch._C._freeze_module(torch.jit.script(mod)._c)
+        graph = fmod._get_method('forward').graph
+        torch._C._jit_pass_convert_frozen_ops_to_mkldnn(graph)
+        # activations stay in the mkldnn layout from the first conv to the
+        # pooling, before the flatten
+        FileCheck().check_count("aten::to_mkldnn", 2, exactly=True) \
+                   .check("aten::mkldnn_linear").run(graph)
+        FileCheck().check("aten::mkldnn_convolution").check("aten::relu") \
+                   .check("aten::mkldnn_convolution").check("aten::adaptive_avg_pool2d") \
+                   .check("aten::to_dense").check("aten::flatten").run(graph)
+        FileCheck().check_not("aten::conv2d").check_not("aten::linear").run(graph)
+        inp = torch.randn(2, 3, 16, 16)
+        self.assertEqual(fmod.forward(inp), mod(inp))
+
+    def test_freeze_linear_to_block_sparse(self):
+        class Net(nn.Module):
+            def __init__(self):
+                super(Net, self).__init__()
+                self.sparse = nn.Linear(32, 16)
+                self.dense = nn.Linear(16, 8)
+                with torch.no_grad():
+                    # keep 4 of the 64 8x1 blocks
+                    mask = torch.zeros(2, 32)
+                    mask[0, :3] = 1
+                    mask[1, 7] = 1
+                    self.sparse.weight.mul_(mask.repeat_interleave(8, 0))
+
+            def forward(self, x):
+                return self.dense(torch.relu(self.sparse(x)))
+
+        mod = Net().eval()
+        fmod = torch._C._freeze_module(torch.jit.script(mod)._c)
+        graph = fmod._get_method('forward').graph
+        torch._C._jit_pass_convert_frozen_linear_to_block_sparse(graph, [8, 1], 0.7)
+        FileCheck().check("aten::_block_sparse_linear").check("aten::relu") \
+                   .check("aten::linear").run(graph)
+        inp = torch.randn(5, 32)
+        self.assertEqual(fmod.forward(inp), mod(inp))
@@ -1472,6 +1472,29 @@ class TestQuantizeScriptPTSQOps(JitTestCase):
                        .check_not("aten::mul_") \
                        .run(m.graph)
 
+    def test_quantized_matmul(self):
+        class Matmul(torch.nn.Module):
+            def __init__(self):
+                super(Matmul, self).__init__()
+
+            def forward(self, x, y):
+                return torch.matmul(x, y)
+
+        class Bmm(torch.nn.Module):
+            def __init__(self):
+                super(Bmm, self).__init__()
+
+            def forward(self, x, y):
+                return torch.bmm(x, y)
+
+        data = [(torch.rand((2, 4, 8), dtype=torch.float), torch.rand((2, 8, 3), dtype=torch.float),
+                 torch.randint(0, 1, (1,), dtype=torch.long)) for _ in range(2)]
+        for M, quantized_op, op in [(Matmul(), "quantized::matmul", "aten::matmul"),
+                                    (Bmm(), "quantized::bmm", "aten::bmm")]:
+            m = self._test_op_impl(M, data, quantized_op)
+            FileCheck().check_not(op) \
+                       .run(m.graph)
+
     def test_quantized_mul_scalar(self):
         class MulScalar(torch.nn.Module):
             def __init__(self):
@@ -1551,10 +1574,39 @@ class TestQuantizeScriptPTSQOps(JitTestCase):
                        .run(m.graph)
 
     def test_hardswish(self):
+        class InplaceHardswish(torch.nn.Module):
+            def __init__(self):
+                super(InplaceHardswish, self).__init__()
+                self.conv = torch.nn.Conv2d(3, 3, 3).float()
+
+            def forward(self, x):
+                return torch._C._nn.hardswish_(self.conv(x))
+
         data = [(torch.rand((1, 3, 10, 10), dtype=torch.float), torch.randint(0, 1, (1,), dtype=torch.long)) for _ in range(2)]
-        m = self._test_op_impl(torch.nn.Hardswish(), data, "quantized::hardswish")
-        FileCheck().check_not("aten::hardswish") \
-                   .run(m.graph)
+        for M in [torch.nn.Hardswish(), InplaceHardswish()]:
+            m = self._test_op_impl(M, data, "quantized::hardswish")
+            FileCheck().check_not("aten::hardswish") \
+                       .check_not("aten::hardswish_") \
+                       .run(m.graph)
+
+    def test_fold_requantize(self):
+        """ A dequantize that is quantized again with the qparams of its
+        input is removed by quant fusion
+        """
+        input_str = """
+graph(%a_quant):
+    %a_dequant = aten::dequantize(%a_quant)
+    %r_scale : float = aten::q_scale(%a_quant)
+    %r_zero_point : int = aten::q_zero_point(%a_quant)
+    %r_dtype : int = prim::dtype(%a_quant)
+    %r_quant = aten::quantize_per_tensor(%a_dequant, %r_scale, %r_zero_point, %r_dtype)
+    %r = aten::dequantize(%r_quant)
+    return (%r)"""
+        graph = parse_ir(input_str)
+        torch._C._jit_pass_quant_fusion(graph)
+        FileCheck().check_count("aten::dequantize", 1, exactly=True) \
+                   .check_not("aten::quantize_per_tensor") \
+                   .run(graph)
 
     def test_layer_norm(self):
         data = [(torch.rand((1, 3, 10, 10), dtype=torch.float), torch.randint(0, 1, (1,), dtype=torch.long)) for _ in range(2)]
@@ -796,6 +796,53 @@ class TestQuantizedOps(TestCase):
         np.testing.assert_equal(qC, qC_hat.int_repr(),
                                 "Quantized multiplication failed.")
 
+    """Tests the correctness of the quantized matmul and bmm ops."""
+    def test_qmatmul(self):
+        scale_C = 0.25
+        zero_point_C = 11
+
+        def _reference(qA, qB):
+            C = torch.matmul(qA.dequantize(), qB.dequantize())
+            return torch.quantize_per_tensor(C, scale_C, zero_point_C, torch.quint8)
+
+        shapes = [((4, 6), (6, 5)),
+                  ((2, 3, 4, 6), (6, 5)),
+                  ((3, 4, 6), (2, 1, 6, 5)),
+                  ((6,), (3, 6, 5)),
+                  ((3, 4, 6), (6,)),
+                  ((0, 4, 6), (6, 5))]
+        for shape_A, shape_B in shapes:
+            A = torch.randn(*shape_A)
+            B = torch.randn(*shape_B)
+            qA = torch.quantize_per_tensor(A, 0.05, 131, torch.quint8)
+            for dtype, zero_point_B in ((torch.quint8, 120), (torch.qint8, -3)):
+                qB = torch.quantize_per_tensor(B, 0.04, zero_point_B, dtype)
+                qC = torch.ops.quantized.matmul(qA, qB, scale_C, zero_point_C)
+                qC_ref = _reference(qA, qB)
+                self.assertEqual(qC.shape, qC_ref.shape)
+                self.assertEqual(qC.q_scale(), scale_C)
+                self.assertEqual(qC.q_zero_point(), zero_point_C)
+                # float and integer rounding may differ by one
+                self.assertEqual(qC.int_repr().int(), qC_ref.int_repr().int(), atol=1, rtol=0)
+
+        # per-channel mat2 along the output columns
+        A = torch.randn(2, 4, 6)
+        B = torch.randn(2, 6, 5)
+        qA = torch.quantize_per_tensor(A, 0.05, 128, torch.quint8)
+        scales = torch.rand(5, dtype=torch.double) * 0.05 + 0.01
+        zero_points = torch.randint(-10, 10, (5,), dtype=torch.long)
+        qB = torch.quantize_per_channel(B, scales, zero_points, 2, torch.qint8)
+        for op in (torch.ops.quantized.matmul, torch.ops.quantized.bmm):
+            qC = op(qA, qB, scale_C, zero_point_C)
+            self.assertEqual(qC.int_repr().int(), _reference(qA, qB).int_repr().int(), atol=1, rtol=0)
+
+        qB = torch.quantize_per_channel(B, torch.ones(6, dtype=torch.double), torch.zeros(6, dtype=torch.long),
+                                        1, torch.qint8)
+        with self.assertRaisesRegex(RuntimeError, "last dimension"):
+            torch.ops.quantized.matmul(qA, qB, scale_C, zero_point_C)
+        with self.assertRaisesRegex(RuntimeError, "3D tensors"):
+            torch.ops.quantized.bmm(qA[0], qA[0], scale_C, zero_point_C)
+
     """Tests channel shuffle operation on quantized tensors."""
     @given(X=hu.tensor(shapes=hu.array_shapes(min_dims=4, max_dims=4,
                                               min_side=2, max_side=32, max_numel=10**5),
@@ -2063,6 +2110,46 @@ class TestDynamicQuantizedLinear(TestCase):
         self.assertEqual(Y_fp32, Y_fp32_ref,
                          message="torch.ops.quantized.linear_dynamic (fbgemm) results are off")
 
+    @skipIfNoFBGEMM
+    @given(use_bias=st.booleans(),
+           use_relu=st.booleans(),
+           use_channelwise=st.booleans())
+    def test_qlinear_per_row(self, use_bias, use_relu, use_channelwise):
+        with override_quantized_engine('fbgemm'):
+            batch_size, input_channels, output_channels = 6, 32, 8
+            # rows of very different magnitudes, like activations of outlier tokens
+            row_magnitudes = torch.tensor([0.01, 0.1, 1., 10., 100., 1000.]).view(-1, 1)
+            X = torch.randn(batch_size, input_channels) * row_magnitudes
+            W = torch.randn(output_channels, input_channels)
+            # weights within [-63, 63] so that fbgemm's int16 accumulation can't saturate
+            if use_channelwise:
+                W_q = torch.quantize_per_channel(
+                    W, scales=W.abs().max(1)[0].double() / 63,
+                    zero_points=torch.zeros(output_channels, dtype=torch.long),
+                    axis=0, dtype=torch.qint8)
+            else:
+                W_q = torch.quantize_per_tensor(
+                    W, scale=W.abs().max().item() / 63, zero_point=0, dtype=torch.qint8)
+            b = torch.randn(output_channels) if use_bias else None
+
+            W_prepack = torch.ops.quantized.linear_prepack(W_q, b)
+            if use_relu:
+                qlinear_dynamic = torch.ops.quantized.linear_relu_dynamic_per_row
+            else:
+                qlinear_dynamic = torch.ops.quantized.linear_dynamic_per_row
+            Y = qlinear_dynamic(X, W_prepack)
+            Y_ref = F.linear(X, W_q.dequantize(), b)
+            if use_relu:
+                Y_ref = F.relu(Y_ref)
+
+            # every row is only off by about its own quantization step
+            X_range = X.max(1)[0].clamp(min=0) - X.min(1)[0].clamp(max=0)
+            bound = X_range / 255 * W_q.dequantize().abs().sum(1).max() + 1e-4
+            self.assertTrue(((Y - Y_ref).abs() <= bound.view(-1, 1)).all())
+
+            Y_3d = qlinear_dynamic(X.view(2, 3, input_channels), W_prepack)
+            self.assertEqual(Y_3d, Y.view(2, 3, output_channels))
+
     @skipIfNoFBGEMM
     @given(
         batch_size=st.integers(1, 4),
@@ -2306,6 +2393,63 @@ class TestQuantizedLinear(unittest.TestCase):
             np.testing.assert_equal(
                 W_q.q_zero_point(), W_q_origin.q_zero_point())
 
+    @skipIfNoFBGEMM
+    def test_qlinear_prepack_cache(self):
+        cache = torch.backends.quantized.prepack_cache
+        original_max_bytes = cache.max_bytes
+        qlinear_prepack = torch.ops.quantized.linear_prepack
+        qlinear = torch.ops.quantized.linear
+        with override_quantized_engine('fbgemm'):
+            try:
+                cache.clear()
+                cache.reset_stats()
+                W_q = torch.quantize_per_tensor(torch.randn(8, 16), 0.1, 0, torch.qint8)
+                bias = torch.randn(8)
+                X_q = torch.quantize_per_tensor(torch.rand(4, 16), 0.05, 0, torch.quint8)
+
+                W_prepack = qlinear_prepack(W_q, bias)
+                Y_q = qlinear(X_q, W_prepack, 0.2, 0)
+                W_prepack = qlinear_prepack(W_q, bias)
+                self.assertEqual(cache.stats(), {'hits': 1, 'misses': 1, 'evictions': 0})
+                self.assertEqual(cache.size, 1)
+                self.assertTrue(torch.equal(qlinear(X_q, W_prepack, 0.2, 0).int_repr(), Y_q.int_repr()))
+
+                # changing the bias in place or packing another view of the
+                # weight must not reuse the packed weight
+                bias.add_(1)
+                W_prepack = qlinear_prepack(W_q, bias)
+                self.assertFalse(torch.equal(qlinear(X_q, W_prepack, 0.2, 0).int_repr(), Y_q.int_repr()))
+                qlinear_prepack(W_q[:4], bias[:4])
+                self.assertEqual(cache.stats(), {'hits': 1, 'misses': 3, 'evictions': 0})
+                self.assertEqual(cache.size, 3)
+
+                # per channel quantization parameters are part of the key
+                W = torch.randn(8, 16)
+                zero_points = torch.zeros(8, dtype=torch.long)
+                W_q_per_channel = [torch.quantize_per_channel(W, torch.rand(8) + 0.1, zero_points, 0, torch.qint8)
+                                   for _ in range(2)]
+                for W_q_channel in W_q_per_channel:
+                    qlinear_prepack(W_q_channel)
+                self.assertEqual(cache.stats()['hits'], 1)
+
+                # the cache evicts the least recently used weights to stay
+                # under max_bytes, and is disabled by a max_bytes of 0
+                W_conv_q = torch.quantize_per_tensor(torch.randn(4, 2, 3, 3), 0.1, 0, torch.qint8)
+                cache.max_bytes = cache.bytes
+                torch.ops.quantized.conv2d_prepack(W_conv_q, None, [1, 1], [0, 0], [1, 1], 1)
+                self.assertGreater(cache.stats()['evictions'], 0)
+                self.assertLessEqual(cache.bytes, cache.max_bytes)
+                torch.ops.quantized.conv2d_prepack(W_conv_q, None, [1, 1], [0, 0], [1, 1], 1)
+                torch.ops.quantized.conv2d_prepack(W_conv_q, None, [2, 2], [0, 0], [1, 1], 1)
+                self.assertEqual(cache.stats()['hits'], 2)
+                cache.max_bytes = 0
+                self.assertEqual(cache.size, 0)
+                qlinear_prepack(W_q, bias)
+                self.assertEqual(cache.size, 0)
+            finally:
+                cache.max_bytes = original_max_bytes
+                cache.clear()
+
 class TestQuantizedConv(unittest.TestCase):
     def _test_qconv_unpack_impl(
         self, qconv_prepack_fn, qconv_unpack_fn, inputs, strides, pads,
@@ -2835,6 +2979,79 @@ class TestPadding(TestCase):
         self.assertEqual(qy_ref, qy_hat)
 
 
+class TestQuantizedEmbeddingBag(TestCase):
+    def _test_rowwise_embedding_bag(self, prepack, unpack, embedding_bag, bit_rate,
+                                    num_embeddings, embedding_dim, num_offsets,
+                                    include_last_offset):
+        weight = torch.randn(num_embeddings, embedding_dim)
+        packed_weight = prepack(weight)
+        dequantized_weight = unpack(packed_weight)
+        # each value is within half a quantization step of the original
+        levels = (1 << bit_rate) - 1
+        value_range = weight.max(1, keepdim=True)[0] - weight.min(1, keepdim=True)[0]
+        self.assertTrue(((dequantized_weight - weight).abs() <= value_range / levels + 1e-3).all())
+
+        lengths = torch.randint(0, 20, (num_offsets,))
+        lengths[0] = 0
+        indices = torch.randint(num_embeddings, (int(lengths.sum()),))
+        offsets = torch.cat([lengths.new_zeros(1), lengths.cumsum(0)[:-1]])
+        if include_last_offset:
+            offsets = torch.cat([offsets, offsets.new_tensor([indices.numel()])])
+        per_sample_weights = torch.rand(indices.numel())
+
+        for mode, weights in ((0, None), (0, per_sample_weights), (1, None)):
+            expected = torch.embedding_bag(dequantized_weight, indices, offsets, False, mode,
+                                           False, weights, include_last_offset)[0]
+            result = embedding_bag(packed_weight, indices, offsets, mode=mode,
+                                   per_sample_weights=weights,
+                                   include_last_offset=include_last_offset)
+            self.assertEqual(result, expected, atol=1e-4, rtol=1e-4)
+
+        # 2-d indices are bags of equal length
+        indices_2d = torch.randint(num_embeddings, (7, 3))
+        expected = torch.embedding_bag(dequantized_weight, indices_2d.view(-1),
+                                       torch.arange(0, 21, 3), False, 0)[0]
+        self.assertEqual(embedding_bag(packed_weight, indices_2d), expected, atol=1e-4, rtol=1e-4)
+
+        with self.assertRaisesRegex(RuntimeError, "only support mode 'sum' and 'mean'"):
+            embedding_bag(packed_weight, indices, offsets, mode=2)
+        with self.assertRaisesRegex(RuntimeError, "out of bounds"):
+            embedding_bag(packed_weight, torch.tensor([0, num_embeddings]), torch.tensor([0]))
+
+    @given(num_embeddings=st.integers(10, 100),
+           embedding_dim=st.integers(1, 20).map(lambda x: x * 8),
+           num_offsets=st.integers(1, 20),
+           include_last_offset=st.booleans())
+    def test_embedding_bag_byte(self, num_embeddings, embedding_dim, num_offsets,
+                                include_last_offset):
+        self._test_rowwise_embedding_bag(
+            torch.ops.quantized.embedding_bag_byte_prepack,
+            torch.ops.quantized.embedding_bag_byte_unpack,
+            torch.ops.quantized.embedding_bag_byte_rowwise_offsets,
+            8, num_embeddings, embedding_dim, num_offsets, include_last_offset)
+
+    @given(num_embeddings=st.integers(10, 100),
+           embedding_dim=st.integers(1, 20).map(lambda x: x * 8),
+           num_offsets=st.integers(1, 20),
+           include_last_offset=st.booleans(),
+           bit_rate=st.sampled_from([2, 4]))
+    def test_embedding_bag_nbit(self, num_embeddings, embedding_dim, num_offsets,
+                                include_last_offset, bit_rate):
+        ops = torch.ops.quantized
+        prepack = ops.embedding_bag_4bit_prepack if bit_rate == 4 else ops.embedding_bag_2bit_prepack
+        unpack = ops.embedding_bag_4bit_unpack if bit_rate == 4 else ops.embedding_bag_2bit_unpack
+        embedding_bag = ops.embedding_bag_4bit_rowwise_offsets if bit_rate == 4 \
+            else ops.embedding_bag_2bit_rowwise_offsets
+        self._test_rowwise_embedding_bag(
+            prepack, unpack, embedding_bag, bit_rate,
+            num_embeddings, embedding_dim, num_offsets, include_last_offset)
+
+        packed_weight = prepack(torch.randn(num_embeddings, embedding_dim))
+        self.assertEqual(packed_weight.size(1), embedding_dim * bit_rate // 8 + 4)
+        with self.assertRaisesRegex(RuntimeError, "must be a multiple of"):
+            prepack(torch.randn(3, 8 // bit_rate + 1))
+
+
 @unittest.skipUnless('qnnpack' in supported_qengines,
                      "This Pytorch Build has not been built with or does not support QNNPACK")
 class TestQNNPackOps(TestCase):
@@ -3156,6 +3373,41 @@ class TestQNNPackOps(TestCase):
             qY = torch.mean(qX, dim)
             np.testing.assert_array_almost_equal(Y.int_repr().numpy(), qY.int_repr().numpy(), decimal=0)
 
+    """Tests that weights packed once are reused across input scales."""
+    def test_prepacked_bias_update(self):
+        with override_quantized_engine('qnnpack'):
+            def check(qY, Y_ref):
+                Y_ref = torch.quantize_per_tensor(Y_ref, qY.q_scale(), qY.q_zero_point(), torch.quint8)
+                np.testing.assert_allclose(qY.int_repr().numpy().astype(np.int32),
+                                           Y_ref.int_repr().numpy().astype(np.int32), atol=1)
+
+            W = torch.randn(8, 16)
+            bias = torch.randn(8)
+            qW = torch.quantize_per_tensor(W, 0.02, 0, torch.qint8)
+            packed = torch.ops.quantized.linear_prepack(qW, bias)
+            X = torch.rand(4, 16)
+            # The biases are requantized for every new input scale, and reset
+            # for the dynamic linear, without repacking the weights.
+            for scale in [0.01, 0.005, 0.01]:
+                qX = torch.quantize_per_tensor(X, scale, 0, torch.quint8)
+                qY = torch.ops.quantized.linear(packed, qX, 0.1, 0)
+                check(qY, F.linear(qX.dequantize(), qW.dequantize(), bias))
+            Y = torch.ops.quantized.linear_dynamic(packed, X)
+            np.testing.assert_allclose(Y.numpy(), F.linear(X, qW.dequantize(), bias).numpy(),
+                                       atol=0.1, rtol=0)
+
+            # Regular, grouped and depthwise 3x3 and 5x5 convolutions.
+            for groups, in_ch, kernel in [(1, 4, 3), (2, 4, 1), (8, 8, 3), (8, 8, 5)]:
+                W = torch.randn(8, in_ch // groups, kernel, kernel)
+                bias = torch.randn(8)
+                qW = torch.quantize_per_tensor(W, 0.02, 0, torch.qint8)
+                packed = torch.ops.quantized.conv2d_prepack(qW, bias, [1, 1], [1, 1], [1, 1], groups)
+                X = torch.rand(1, in_ch, 7, 7)
+                for scale in [0.01, 0.005]:
+                    qX = torch.quantize_per_tensor(X, scale, 0, torch.quint8)
+                    qY = torch.ops.quantized.conv2d(qX, packed, 0.1, 0)
+                    check(qY, F.conv2d(qX.dequantize(), qW.dequantize(), bias, padding=1, groups=groups))
+
     """Tests the correctness of the quantized::hardtanh op."""
     @given(X=hu.tensor(shapes=hu.array_shapes(1, 8, 1, 8, max_numel=10**5),
                        elements=hu.floats(-1e6, 1e6, allow_nan=False, allow_infinity=False),
@@ -568,6 +568,52 @@ class TestFakeQuantizePerTensor(TestCase):
         self.assertNotEqual(fq_module.scale, scale)
         self.assertNotEqual(fq_module.zero_point, zero_point)
 
+    @given(device=st.sampled_from(['cpu', 'cuda'] if torch.cuda.is_available() else ['cpu']),
+           qscheme=st.sampled_from((torch.per_tensor_affine, torch.per_tensor_symmetric)),
+           reduce_range=st.booleans())
+    def test_fused_obs_fake_quant(self, device, qscheme, reduce_range):
+        r"""Tests _fused_moving_avg_obs_fake_quant against a MovingAverageMinMaxObserver
+        followed by fake_quantize_per_tensor_affine.
+        """
+        torch.manual_seed(NP_RANDOM_SEED)
+        quant_min, quant_max = 0, 255
+        observer = MovingAverageMinMaxObserver(averaging_constant=0.1, dtype=torch.quint8,
+                                               qscheme=qscheme, reduce_range=reduce_range).to(device)
+        running_min = torch.tensor([], device=device)
+        running_max = torch.tensor([], device=device)
+        scale = torch.tensor([1.0], device=device)
+        zero_point = torch.tensor([0], device=device)
+        for i in range(4):
+            X = (torch.randn(3, 5, 7, device=device) * (i + 1) + i).requires_grad_()
+            observer(X)
+            ref_scale, ref_zero_point = observer.calculate_qparams()
+            Y = torch._fused_moving_avg_obs_fake_quant(
+                X, running_min, running_max, scale, zero_point, 0.1, quant_min, quant_max,
+                True, qscheme == torch.per_tensor_symmetric, reduce_range)
+            self.assertEqual(running_min, observer.min_val)
+            self.assertEqual(running_max, observer.max_val)
+            self.assertEqual(scale.item(), ref_scale.item())
+            self.assertEqual(zero_point.item(), ref_zero_point.item())
+
+            Y_ref = _fake_quantize_per_tensor_affine_reference(
+                X.detach().cpu(), scale.item(), zero_point.item(), quant_min, quant_max)
+            np.testing.assert_allclose(Y.detach().cpu(), Y_ref, rtol=tolerance, atol=tolerance)
+            dout = torch.rand_like(X)
+            Y.backward(dout)
+            dX = _fake_quantize_per_tensor_affine_grad_reference(
+                dout.cpu(), X.detach().cpu(), scale.item(), zero_point.item(), quant_min, quant_max)
+            np.testing.assert_allclose(X.grad.cpu(), dX, rtol=tolerance, atol=tolerance)
+
+        # With the observer off, only fake-quantizes with the current parameters
+        X = torch.randn(3, 5, 7, device=device) * 10
+        Y = torch._fused_moving_avg_obs_fake_quant(
+            X, running_min, running_max, scale, zero_point, 0.1, quant_min, quant_max, False)
+        self.assertEqual(running_min, observer.min_val)
+        self.assertEqual(running_max, observer.max_val)
+        Y_ref = _fake_quantize_per_tensor_affine_reference(
+            X.cpu(), scale.item(), zero_point.item(), quant_min, quant_max)
+        np.testing.assert_allclose(Y.cpu(), Y_ref, rtol=tolerance, atol=tolerance)
+
 
 
 class TestFakeQuantizePerChannel(TestCase):
@@ -28,6 +28,7 @@ TESTS = [
     'test_cpp_extensions_jit',
     'distributed/test_c10d',
     'distributed/test_c10d_spawn',
+    'distributed/test_checkpoint',
     'test_cuda',
     'test_jit_cuda_fuser',
     'test_cuda_primary_ctx',
@@ -562,6 +562,43 @@ class TestAutograd(TestCase):
         self.assertEqual(counter[0], 1, 'bw_hook not called')
         self.assertEqual(x.grad, torch.ones(5, 5) * 2, atol=1e-5)
 
+    def test_post_accumulate_grad_hook(self):
+        w = torch.ones(3, requires_grad=True)
+        b = torch.ones(3, requires_grad=True)
+        seen = []
+
+        def sgd_step(p):
+            seen.append(p.grad.clone())
+            with torch.no_grad():
+                p.add_(p.grad, alpha=-0.5)
+            p.grad = None
+
+        handles = [w.register_post_accumulate_grad_hook(sgd_step),
+                   b.register_post_accumulate_grad_hook(sgd_step)]
+        (2 * w + b).sum().backward()
+        self.assertEqual(len(seen), 2)
+        self.assertIsNone(w.grad)
+        self.assertIsNone(b.grad)
+        self.assertEqual(w, torch.zeros(3))
+        self.assertEqual(b, torch.full((3,), 0.5))
+
+        # The hook sees the grad accumulated over all the uses of the leaf.
+        for h in handles:
+            h.remove()
+        grads = []
+        w.register_post_accumulate_grad_hook(lambda p: grads.append(p.grad.clone()))
+        (w * 3 + w * 4).sum().backward()
+        self.assertEqual(grads, [torch.full((3,), 7.)])
+
+        with self.assertRaisesRegex(RuntimeError, "should return None"):
+            x = torch.ones(2, requires_grad=True)
+            x.register_post_accumulate_grad_hook(lambda p: p)
+            x.sum().backward()
+        with self.assertRaisesRegex(RuntimeError, "leaf tensors"):
+            (w * 2).register_post_accumulate_grad_hook(lambda p: None)
+        with self.assertRaisesRegex(RuntimeError, "doesn't require gradient"):
+            torch.ones(2).register_post_accumulate_grad_hook(lambda p: None)
+
     def test_hook_none(self):
         # WARNING: this is a test for autograd internals.
         # You should never have to use such things in your code.
@@ -2660,6 +2697,92 @@ class TestAutograd(TestCase):
                 last_end = info.cpu_interval.end
             self.assertEqual(info.name, expected_name)
 
+    def test_sampling_profiler(self):
+        from torch.autograd.profiler import enable_sampling, disable_sampling, sampled_op_stats
+        x = torch.randn(10, 10)
+        sampled_op_stats(reset=True)
+        enable_sampling(sample_period=1)
+        try:
+            self.assertTrue(torch.autograd._sampling_profiler_enabled())
+            with self.assertRaisesRegex(RuntimeError, "already enabled"):
+                enable_sampling()
+            for _ in range(10):
+                with record_function("sampled_range"):
+                    x * 2
+        finally:
+            disable_sampling()
+        self.assertFalse(torch.autograd._sampling_profiler_enabled())
+        with record_function("sampled_range"):
+            x * 2
+
+        stats = {s.name: s for s in sampled_op_stats(reset=True)}
+        self.assertEqual(stats["sampled_range"].count, 10)
+        self.assertEqual(sum(stats["sampled_range"].histogram), 10)
+        self.assertGreaterEqual(stats["sampled_range"].total_ns, stats["sampled_range"].max_ns)
+        self.assertTrue(any(name.endswith("mul") for name in stats))
+        self.assertEqual(sampled_op_stats(), [])
+
+        # Sampling one in N invocations records about 1 / N of them.
+        enable_sampling(sample_period=10)
+        try:
+            for _ in range(1000):
+                with record_function("sampled_range"):
+                    x * 2
+        finally:
+            disable_sampling()
+        count = sum(s.count for s in sampled_op_stats(reset=True) if s.name == "sampled_range")
+        self.assertGreater(count, 50)
+        self.assertLess(count, 200)
+
+        with self.assertRaisesRegex(RuntimeError, "must be positive"):
+            enable_sampling(sample_period=0)
+
+    def test_op_latency_metrics(self):
+        from torch.autograd.profiler import (enable_op_latency_metrics, disable_op_latency_metrics,
+                                             op_latency_metrics)
+
+        def count(name):
+            return sum(m.count for m in op_latency_metrics() if m.name == name)
+
+        x = torch.randn(10, 10)
+        before = count("latency_range")
+        enable_op_latency_metrics()
+        try:
+            self.assertTrue(torch.autograd._op_latency_metrics_enabled())
+            with self.assertRaisesRegex(RuntimeError, "already enabled"):
+                enable_op_latency_metrics()
+            for _ in range(10):
+                with record_function("latency_range"):
+                    x * 2
+
+            def worker():
+                torch.autograd._enable_record_function(True)
+                for _ in range(5):
+                    with record_function("latency_range"):
+                        x * 2
+
+            t = threading.Thread(target=worker)
+            t.start()
+            t.join()
+        finally:
+            disable_op_latency_metrics()
+        self.assertFalse(torch.autograd._op_latency_metrics_enabled())
+        with record_function("latency_range"):
+            x * 2
+
+        self.assertEqual(count("latency_range") - before, 15)
+        metrics = {m.name: m for m in op_latency_metrics()}
+        metric = metrics["latency_range"]
+        self.assertEqual(sum(metric.buckets), metric.count)
+        self.assertGreater(metric.total_ns, 0)
+        self.assertTrue(any(name.endswith("mul") for name in metrics))
+
+        bounds = [metric.bucket_lower_bound(i) for i in range(len(metric.buckets))]
+        self.assertEqual(bounds[:6], [0, 128, 160, 192, 224, 256])
+        self.assertEqual(bounds, sorted(bounds))
+        self.assertIn(metric.quantile(0.5), bounds)
+        self.assertLessEqual(metric.quantile(0.5), metric.quantile(0.99))
+
     def test_profiler_unboxed_only(self):
         x = torch.rand(3, 4)
 
@@ -2784,6 +2907,30 @@ class TestAutograd(TestCase):
         self.assertEqual(avg.cpu_time, 7.5)
         self.assertEqual(avg.cuda_time_total, 0)
 
+    def test_profiler_memory(self):
+        with profile(profile_memory=True) as p:
+            x = torch.randn(128, 128)
+            y = x.mul(2)
+        nbytes = 128 * 128 * 4
+        randn = [evt for evt in p.function_events if evt.name == 'randn']
+        self.assertEqual(len(randn), 1)
+        self.assertEqual(randn[0].cpu_memory_usage, nbytes)
+        mul = [evt for evt in p.function_events if evt.name == 'mul']
+        self.assertEqual(max(evt.cpu_memory_usage for evt in mul), nbytes)
+        # Allocations are attributed to the innermost function only, and
+        # the temporaries of mul are freed before it returns.
+        self.assertEqual(sum(evt.self_cpu_memory_usage for evt in p.function_events), 2 * nbytes)
+        self.assertIn("Self CPU Mem", p.key_averages().table())
+
+        with profile() as p:
+            x = torch.randn(128, 128)
+        self.assertTrue(all(evt.cpu_memory_usage == 0 for evt in p.function_events))
+        self.assertNotIn("Self CPU Mem", p.table())
+
+    def test_profiler_cupti_args(self):
+        with self.assertRaisesRegex(ValueError, "can't be used together"):
+            profile(use_cuda=True, use_cupti=True)
+
     def test_profiler_shapes(self):
         print("")
         layer1 = torch.nn.Linear(20, 30)
@@ -3177,6 +3324,38 @@ class TestAutograd(TestCase):
                     out.backward()
             self.assertIn('MyFunc.apply', str(w[0].message))
 
+    def test_detect_nonfinite(self):
+        class MyFunc(Function):
+            @staticmethod
+            def forward(ctx, inp):
+                return inp.clone()
+
+            @staticmethod
+            def backward(ctx, gO):
+                return gO / 0
+
+        self.assertIsNone(torch.autograd.first_nonfinite_node())
+        inp = torch.rand(10, requires_grad=True)
+        with torch.autograd.detect_nonfinite():
+            (inp * 2).sum().backward()
+        self.assertIsNone(torch.autograd.first_nonfinite_node())
+
+        with torch.autograd.detect_nonfinite():
+            MyFunc.apply(inp).sum().backward()
+        first = torch.autograd.first_nonfinite_node()
+        self.assertIsNotNone(first)
+        self.assertIsNone(torch.autograd.first_nonfinite_node())
+
+        # The mul node runs after MyFuncBackward and also returns infinities,
+        # but the node created right after it is the one reported.
+        with torch.autograd.detect_nonfinite():
+            MyFunc.apply(inp * 2).sum().backward()
+        self.assertEqual(torch.autograd.first_nonfinite_node(), first + 3)
+
+        self.assertFalse(torch.autograd._is_nonfinite_guard_enabled())
+        MyFunc.apply(inp).sum().backward()
+        self.assertIsNone(torch.autograd.first_nonfinite_node())
+
     @skipIfNoLapack
     def test_eig_no_eigenvectors(self):
         A = torch.tensor([[1., 2.], [2., 4.]], dtype=torch.float32, requires_grad=True)
@@ -3448,6 +3627,72 @@ for shape in [(1,), ()]:
         v2 = torch.tensor(200.0, requires_grad=True)
         DeepReentrant.apply(v2).sum().backward()
 
+    def test_parallel_cpu_workers(self):
+        barrier = threading.Barrier(2, timeout=10)
+
+        class Rendezvous(Function):
+            @staticmethod
+            def forward(ctx, x):
+                return x.clone()
+
+            @staticmethod
+            def backward(ctx, grad):
+                # Only passes if the other branch runs on another thread.
+                barrier.wait()
+                return grad * 2
+
+        class DeepReentrant(Function):
+            @staticmethod
+            def forward(ctx, x):
+                with torch.enable_grad():
+                    ctx.x = Variable(x.detach(), requires_grad=True)
+                    ctx.x = ctx.x - 1
+                return ctx.x.detach()
+
+            @staticmethod
+            def backward(ctx, x):
+                if ctx.x < 0:
+                    return x
+                with torch.enable_grad():
+                    DeepReentrant.apply(ctx.x).sum().backward()
+                return x
+
+        self.assertEqual(torch.autograd.get_num_cpu_workers(), 0)
+        torch.autograd.set_num_cpu_workers(2)
+        try:
+            self.assertEqual(torch.autograd.get_num_cpu_workers(), 2)
+            x = torch.randn(3, requires_grad=True)
+            y = torch.randn(3, requires_grad=True)
+            (Rendezvous.apply(x * 3) + Rendezvous.apply(y * 4)).sum().backward()
+            self.assertEqual(x.grad, torch.full((3,), 6.))
+            self.assertEqual(y.grad, torch.full((3,), 8.))
+
+            # reentrant backward from the workers, and the same results as
+            # the serial engine
+            a = torch.randn(5, 5, requires_grad=True)
+            b = torch.tensor(100.0, requires_grad=True)
+            branches = [(a * i).tanh().sum() for i in range(8)]
+            out = sum(branches) + DeepReentrant.apply(b).sum()
+            grads = torch.autograd.grad(out, (a, b), retain_graph=True)
+            torch.autograd.set_num_cpu_workers(0)
+            expected = torch.autograd.grad(out, (a, b))
+            self.assertEqual(grads, expected)
+
+            torch.autograd.set_num_cpu_workers(2)
+            with self.assertRaisesRegex(RuntimeError, "Simulate error"):
+                class Fail(Function):
+                    @staticmethod
+                    def forward(ctx, x):
+                        return x.clone()
+
+                    @staticmethod
+                    def backward(ctx, grad):
+                        raise RuntimeError("Simulate error")
+
+                (Fail.apply(x) + x * 2).sum().backward()
+        finally:
+            torch.autograd.set_num_cpu_workers(0)
+
     def test_reentrant_priority(self):
         order = []
 
@@ -3519,6 +3764,87 @@ for shape in [(1,), ()]:
         mean_combined = torch.stack(feat_combined).mean()
         mean_combined.backward()
 
+    def test_saved_tensors_hooks(self):
+        packed = []
+        unpacked = []
+
+        def pack(x):
+            packed.append(x)
+            return len(packed) - 1
+
+        def unpack(idx):
+            unpacked.append(idx)
+            return packed[idx] * 1
+
+        a = torch.randn(5, requires_grad=True)
+        b = torch.randn(5, requires_grad=True)
+        with torch.autograd.graph.saved_tensors_hooks(pack, unpack):
+            y = a * b
+            z = a.exp()
+        self.assertEqual(len(packed), 3)
+        self.assertEqual(packed[0], a)
+        self.assertEqual(packed[1], b)
+
+        y.sum().backward()
+        self.assertEqual(sorted(unpacked), [0, 1])
+        self.assertEqual(a.grad, b)
+        self.assertEqual(b.grad, a)
+        z.sum().backward()
+        self.assertEqual(a.grad, b + a.exp())
+
+        # hooks are only active inside the context manager
+        y = a * b
+        self.assertEqual(len(packed), 3)
+
+        # the version counter checks still apply
+        with torch.autograd.graph.saved_tensors_hooks(pack, unpack):
+            c = a * 1
+            y = c * b
+        c.add_(1)
+        with self.assertRaisesRegex(RuntimeError, "modified by an inplace operation"):
+            y.sum().backward()
+
+        with torch.autograd.graph.saved_tensors_hooks(lambda x: x, lambda x: "not a tensor"):
+            y = a * b
+        with self.assertRaisesRegex(RuntimeError, "expected to be a Tensor"):
+            y.sum().backward()
+
+    def test_saved_tensors_hooks_custom_function(self):
+        class MyFn(Function):
+            @staticmethod
+            def forward(ctx, x):
+                ctx.save_for_backward(x)
+                return x * 2
+
+            @staticmethod
+            def backward(ctx, grad):
+                x, = ctx.saved_tensors
+                return grad * x
+
+        packed = []
+        a = torch.randn(3, requires_grad=True)
+        with torch.autograd.graph.saved_tensors_hooks(lambda x: packed.append(x) or x.clone(), lambda x: x):
+            MyFn.apply(a).sum().backward()
+        self.assertEqual(len(packed), 1)
+        self.assertEqual(a.grad, a)
+
+    def test_save_on_cpu(self):
+        a = torch.randn(5, requires_grad=True)
+        with torch.autograd.graph.save_on_cpu():
+            y = (a * a).exp()
+        y.sum().backward()
+        self.assertEqual(a.grad, 2 * a * (a * a).exp())
+
+    def test_offload_to_cpu_keeps_cpu_tensors(self):
+        a = torch.randn(5, requires_grad=True)
+        with torch.autograd.graph.offload_to_cpu(min_bytes=0):
+            y = (a * a).exp()
+        y.sum().backward()
+        self.assertEqual(a.grad, 2 * a * (a * a).exp())
+
+        with self.assertRaisesRegex(ValueError, "prefetch must be non-negative"):
+            torch.autograd.graph.offload_to_cpu(prefetch=-1)
+
     def _test_reentrant_with_callbacks(self, install_callbacks_in_depths):
         counter = {}
         counter["inner"] = 0
@@ -5801,6 +6127,28 @@ class TestAutogradDeviceType(TestCase):
         gradcheck(lambda x: x.pin_memory(), [x])
         gradgradcheck(lambda x: x.pin_memory(), [x])
 
+    @onlyCUDA
+    def test_profiler_cupti(self, device):
+        x = torch.randn(1024, device=device)
+        try:
+            with profile(use_cupti=True) as p:
+                y = x.cpu()
+                z = (x * 2).sum()
+        except RuntimeError as e:
+            if "compiled without CUDA or CUPTI" in str(e):
+                self.skipTest("PyTorch was built without CUPTI")
+            raise
+        kernels = [k for evt in p.function_events for k in evt.kernels]
+        self.assertTrue(any(k.name == "Memcpy DtoH" for k in kernels))
+        mul = [evt for evt in p.function_events if evt.name == "mul" and evt.kernels]
+        self.assertTrue(len(mul) > 0)
+        for k in mul[0].kernels:
+            self.assertGreaterEqual(k.interval.start, mul[0].cpu_interval.start)
+        with tempfile.NamedTemporaryFile(mode="w+") as f:
+            p.export_chrome_trace(f.name)
+            trace = json.load(f)
+        self.assertTrue(any(e["pid"] == "CUDA functions" for e in trace))
+
     @skipCUDAIfRocm
     @onlyCUDA
     def test_profiler_emit_nvtx(self, device):
@@ -5813,6 +6161,32 @@ class TestAutogradDeviceType(TestCase):
             with emit_nvtx():
                 a.add(1.0)
 
+    @onlyCUDA
+    def test_offload_to_cpu(self, device):
+        a = torch.randn(64, 64, device=device, requires_grad=True)
+        small = torch.randn(2, device=device, requires_grad=True)
+        hooks = torch.autograd.graph.offload_to_cpu(min_bytes=64 * 64 * 4, prefetch=1)
+        with hooks:
+            x = a
+            for _ in range(4):
+                x = (x * x).tanh()
+            y = x.sum() + (small * small).sum()
+        # Only the large activations were moved to host memory.
+        self.assertEqual(len(hooks._saved), 12)
+        y.backward(retain_graph=True)
+
+        a_ = a.detach().clone().requires_grad_()
+        x = a_
+        for _ in range(4):
+            x = (x * x).tanh()
+        x.sum().backward()
+        self.assertEqual(a.grad, a_.grad)
+        self.assertEqual(small.grad, 2 * small)
+
+        # The host copies are kept for another backward pass.
+        y.backward()
+        self.assertEqual(a.grad, 2 * a_.grad)
+
     @onlyCUDA
     def test_rnn_backward_to_input_but_not_parameters(self, device):
         # this checks whether it is possible to not require
@@ -1,9 +1,10 @@
 import collections
 import io
+import math
 import tempfile
 import unittest
 import sys
-from itertools import repeat, chain
+from itertools import repeat, chain, product
 import os
 import gc
 from contextlib import contextmanager
@@ -53,6 +54,9 @@ if TEST_CUDA:
     TEST_LARGE_TENSOR = torch.cuda.get_device_properties(0).total_memory >= 12e9
     TEST_MEDIUM_TENSOR = torch.cuda.get_device_properties(0).total_memory >= 6e9
 
+TEST_CUDA_GRAPH = TEST_CUDA and not TEST_WITH_ROCM and \
+    torch.version.cuda is not None and int(torch.version.cuda.split(".")[0]) >= 11
+
 types = [
     torch.FloatTensor,
     torch.DoubleTensor,
@@ -301,6 +305,129 @@ class TestCuda(TestCase):
                 torch.cuda.caching_allocator_delete(mem)
                 self.assertEqual(torch.cuda.memory_allocated(), prev)
 
+    def test_memory_history(self):
+        torch.cuda.record_memory_history(True, max_entries=4)
+        try:
+            x = torch.empty(1024, device="cuda")
+            blocks = [b for s in torch.cuda.memory_snapshot() for b in s["blocks"]
+                      if b["state"] == "active_allocated" and "history" in b]
+            self.assertTrue(any(b["history"]["real_size"] == 1024 * 4 for b in blocks))
+            del x
+            for _ in range(4):
+                torch.empty(1024, device="cuda")
+        finally:
+            torch.cuda.record_memory_history(False)
+
+        history = torch.cuda.memory_history()
+        # only the most recent events are kept
+        self.assertEqual(len(history), 4)
+        self.assertEqual([e["action"] for e in history], ["alloc", "free", "alloc", "free"])
+        self.assertTrue(all(history[i]["time_us"] <= history[i + 1]["time_us"] for i in range(3)))
+
+    def test_memory_pool(self):
+        # allocations under 10 MiB reserve 20 MiB segments
+        limit = 32 * 1024 * 1024
+        torch.cuda.create_memory_pool("test_memory_pool", limit=limit)
+        with self.assertRaisesRegex(RuntimeError, "already exists"):
+            torch.cuda.create_memory_pool("test_memory_pool")
+
+        with torch.cuda.memory_pool("test_memory_pool"):
+            x = torch.empty(4 * 1024 * 1024, dtype=torch.uint8, device="cuda")
+            self.assertGreater(torch.cuda.memory_pool_reserved("test_memory_pool"), 0)
+            with self.assertRaisesRegex(RuntimeError, "memory pool 'test_memory_pool'"):
+                torch.empty(limit, dtype=torch.uint8, device="cuda")
+        self.assertLessEqual(torch.cuda.memory_pool_reserved("test_memory_pool"), limit)
+        self.assertTrue(any(s["pool"] == "test_memory_pool" for s in torch.cuda.memory_snapshot()))
+
+        del x
+        torch.cuda.empty_cache()
+        self.assertEqual(torch.cuda.memory_pool_reserved("test_memory_pool"), 0)
+
+        with torch.cuda.memory_pool("no_such_pool"):
+            with self.assertRaisesRegex(RuntimeError, "was not created"):
+                torch.empty(1, device="cuda")
+
+    @unittest.skipIf(not TEST_CUDA_GRAPH, "CUDA >= 11.0 required for graphs")
+    def test_graph_capture_simple(self):
+        s = torch.cuda.Stream()
+
+        with torch.cuda.stream(s):
+            a = torch.full((1000,), 1.0, device="cuda")
+            g = torch.cuda.CUDAGraph()
+            torch.cuda.empty_cache()
+            g.capture_begin()
+            b = a
+            for _ in range(10):
+                b = b + 1
+            g.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
+        # capture records the work without running it
+        a.fill_(2)
+        g.replay()
+        self.assertEqual(b.sum().item(), 12 * 1000)
+
+        # the captured allocations stay reserved while the graph lives
+        torch.cuda.empty_cache()
+        a.fill_(3)
+        g.replay()
+        self.assertEqual(b.sum().item(), 13 * 1000)
+
+        with self.assertRaisesRegex(RuntimeError, "non-default stream"):
+            torch.cuda.CUDAGraph().capture_begin()
+
+    @unittest.skipIf(not TEST_CUDA_GRAPH, "CUDA >= 11.0 required for graphs")
+    def test_graph_rng_dropout(self):
+        size = 10000
+        s = torch.cuda.Stream()
+        a = torch.ones(size, device="cuda")
+
+        torch.cuda.manual_seed(5)
+        eager_masks = [torch.nn.functional.dropout(a, 0.5) != 0 for _ in range(3)]
+
+        torch.cuda.manual_seed(5)
+        with torch.cuda.stream(s):
+            g = torch.cuda.CUDAGraph()
+            g.capture_begin()
+            b = torch.nn.functional.dropout(a, 0.5)
+            g.capture_end()
+            # operations that do not support capture fail instead of
+            # replaying the same random numbers
+            g2 = torch.cuda.CUDAGraph()
+            g2.capture_begin()
+            with self.assertRaisesRegex(RuntimeError, "does not support CUDA graph capture"):
+                torch.rand(size, device="cuda")
+            g2.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
+        # each replay draws the numbers the eager calls would have
+        for mask in eager_masks:
+            g.replay()
+            self.assertEqual(b != 0, mask)
+
+    def test_allocator_settings(self):
+        import subprocess
+        script = """\
+import torch
+x = torch.empty(64 * 1024 * 1024 + 1, dtype=torch.uint8, device="cuda")
+blocks = torch.cuda.memory_snapshot()[0]["blocks"]
+# 64 MiB + 1 byte rounds up to the next of 4 steps between 64 and 128 MiB
+assert blocks[0]["size"] == 80 * 1024 * 1024, blocks
+del x
+# the oversized cached block is not split to serve a small request
+y = torch.empty(1024 * 1024 * 4, dtype=torch.uint8, device="cuda")
+assert all(len(s["blocks"]) == 1 for s in torch.cuda.memory_snapshot())
+"""
+        env = dict(os.environ)
+        env["PYTORCH_CUDA_ALLOC_CONF"] = (
+            "max_split_size_mb:40,garbage_collection_threshold:0.8,roundup_power2_divisions:4")
+        subprocess.check_call([sys.executable, "-c", script], env=env)
+
+        env["PYTORCH_CUDA_ALLOC_CONF"] = "max_split_size_mb:1"
+        with self.assertRaises(subprocess.CalledProcessError):
+            subprocess.check_call([sys.executable, "-c", "import torch; torch.empty(1, device='cuda')"],
+                                  env=env, stderr=subprocess.DEVNULL)
+
     def test_cuda_get_device_name(self):
         # Testing the behaviour with None as an argument
         current_device = torch.cuda.current_device()
@@ -1512,6 +1639,30 @@ class TestCuda(TestCase):
         self.assertNotEqual(t.data_ptr(), ptr, 'allocation re-used too soon')
         self.assertEqual(list(gpu_tensor), [1])
 
+    def test_pinned_memory_cache_limit(self):
+        torch.cuda.empty_pinned_cache()
+        before = torch.cuda.pinned_memory_stats()
+        size = 1024 * 1024
+        torch.cuda.reserve_pinned_memory(size, count=2)
+        after = torch.cuda.pinned_memory_stats()
+        self.assertEqual(after["segment.current"] - before["segment.current"], 2)
+        self.assertEqual(after["reserved_bytes.current"] - before["reserved_bytes.current"], 2 * size)
+
+        # reserved blocks serve allocations without pinning more memory
+        t = torch.empty(size // 4 - 1).pin_memory()
+        self.assertEqual(torch.cuda.pinned_memory_stats()["segment.current"], after["segment.current"])
+        del t
+
+        try:
+            # the least recently freed block is released
+            torch.cuda.set_pinned_memory_cache_limit(size)
+            limited = torch.cuda.pinned_memory_stats()
+            self.assertEqual(limited["num_evictions"] - after["num_evictions"], 1)
+            self.assertEqual(limited["segment.current"] - before["segment.current"], 1)
+        finally:
+            torch.cuda.set_pinned_memory_cache_limit(None)
+        torch.cuda.empty_pinned_cache()
+
     @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
     def test_caching_pinned_memory_multi_gpu(self):
         # checks that the events preventing pinned memory from being re-used
@@ -1664,6 +1815,226 @@ class TestCuda(TestCase):
                             self.assertEqual(torch.backends.cuda.cufft_plan_cache.max_size, 10)  # default is cuda:0
                         self.assertEqual(torch.backends.cuda.cufft_plan_cache.max_size, 11)  # default is cuda:1
 
+    @skipIfRocm
+    def test_cufft_plan_cache_stats_and_batched_plans(self):
+        plan_cache = torch.backends.cuda.cufft_plan_cache
+        original_max_size = plan_cache.max_size
+        try:
+            plan_cache.clear()
+            plan_cache.max_size = 10
+            plan_cache.reset_stats()
+            x = torch.randn(4, 32, 2, device='cuda')
+            torch.fft(x, 1)
+            torch.fft(x, 1)
+            self.assertEqual(plan_cache.stats(), {'hits': 1, 'misses': 1, 'evictions': 0})
+            plan_cache.max_size = 0
+            self.assertEqual(plan_cache.stats()['evictions'], 1)
+            plan_cache.max_size = 10
+
+            # with batched plans, batch sizes 13 = 8 + 4 + 1 and 5 = 4 + 1
+            # share their plans
+            self.assertFalse(plan_cache.batched_plans)
+            plan_cache.batched_plans = True
+            plan_cache.reset_stats()
+            x13 = torch.randn(13, 32, 2, device='cuda')
+            x5 = torch.randn(5, 32, 2, device='cuda')
+            res13 = torch.fft(x13, 1)
+            res5 = torch.ifft(x5, 1, normalized=True)
+            self.assertEqual(plan_cache.stats(), {'hits': 2, 'misses': 3, 'evictions': 0})
+            self.assertEqual(plan_cache.size, 3)
+
+            # rfft with onesided=False exercises the conjugate symmetry fill
+            # on the chunked output
+            r13 = torch.randn(13, 16, device='cuda')
+            res_r13 = torch.rfft(r13, 1, onesided=False)
+            plan_cache.batched_plans = False
+            self.assertEqual(res13, torch.fft(x13, 1))
+            self.assertEqual(res5, torch.ifft(x5, 1, normalized=True))
+            self.assertEqual(res_r13, torch.rfft(r13, 1, onesided=False))
+        finally:
+            plan_cache.batched_plans = False
+            plan_cache.max_size = original_max_size
+
+    def _fused_optimizer_inputs(self, dtype):
+        # enough tensors to need several launches, an empty one, and one
+        # that spans several chunks
+        sizes = [(3, 5), (0,), (70000,)] + [(i % 7 + 1, 13) for i in range(120)]
+        return [torch.randn(size, device='cuda', dtype=dtype) for size in sizes]
+
+    def test_fused_adam(self):
+        for amsgrad, decoupled, weight_decay in product([False, True], [False, True], [0, 0.1]):
+            params = self._fused_optimizer_inputs(torch.float)
+            grads = [torch.randn_like(p) for p in params]
+            exp_avgs = [torch.rand_like(p) for p in params]
+            exp_avg_sqs = [torch.rand_like(p) for p in params]
+            max_exp_avg_sqs = [torch.rand_like(p) for p in params] if amsgrad else []
+            lr, beta1, beta2, eps, step = 0.01, 0.9, 0.999, 1e-8, 3
+
+            ref_params = [p.clone() for p in params]
+            ref_exp_avgs = [m.clone() for m in exp_avgs]
+            ref_exp_avg_sqs = [v.clone() for v in exp_avg_sqs]
+            ref_max_exp_avg_sqs = [v.clone() for v in max_exp_avg_sqs]
+            for i, (p, g, m, v) in enumerate(zip(ref_params, grads, ref_exp_avgs, ref_exp_avg_sqs)):
+                if decoupled:
+                    p.mul_(1 - lr * weight_decay)
+                else:
+                    g = g + weight_decay * p
+                m.mul_(beta1).add_(g, alpha=1 - beta1)
+                v.mul_(beta2).addcmul_(g, g, value=1 - beta2)
+                if amsgrad:
+                    torch.max(ref_max_exp_avg_sqs[i], v, out=ref_max_exp_avg_sqs[i])
+                    v = ref_max_exp_avg_sqs[i]
+                denom = v.sqrt() / math.sqrt(1 - beta2 ** step) + eps
+                p.addcdiv_(m, denom, value=-lr / (1 - beta1 ** step))
+
+            torch._fused_adam_(params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs,
+                               lr, beta1, beta2, eps, weight_decay, step, amsgrad, decoupled)
+            self.assertEqual(params, ref_params)
+            self.assertEqual(exp_avgs, ref_exp_avgs)
+            self.assertEqual(exp_avg_sqs, ref_exp_avg_sqs)
+            self.assertEqual(max_exp_avg_sqs, ref_max_exp_avg_sqs)
+
+        # a set found_inf skips the step, a zero one doesn't
+        found_inf = torch.ones(1, device='cuda')
+        ref_params = [p.clone() for p in params]
+        torch._fused_adam_(params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs,
+                           lr, beta1, beta2, eps, weight_decay, step, amsgrad, decoupled,
+                           found_inf)
+        self.assertEqual(params, ref_params)
+        found_inf.zero_()
+        torch._fused_adam_(params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs,
+                           lr, beta1, beta2, eps, weight_decay, step, amsgrad, decoupled,
+                           found_inf)
+        self.assertNotEqual(params, ref_params)
+
+    def test_fused_sgd(self):
+        lr, momentum, weight_decay = 0.1, 0.9, 0.01
+        for nesterov, first_run in product([False, True], [False, True]):
+            dampening = 0 if nesterov else 0.1
+            params = self._fused_optimizer_inputs(torch.float)
+            grads = [torch.randn_like(p) for p in params]
+            bufs = [torch.randn_like(p) for p in params]
+
+            ref_params = [p.clone() for p in params]
+            ref_bufs = [b.clone() for b in bufs]
+            for p, g, b in zip(ref_params, grads, ref_bufs):
+                d_p = g + weight_decay * p
+                if first_run:
+                    b.copy_(d_p)
+                else:
+                    b.mul_(momentum).add_(d_p, alpha=1 - dampening)
+                d_p = d_p + momentum * b if nesterov else b
+                p.add_(d_p, alpha=-lr)
+
+            torch._fused_sgd_(params, grads, bufs, lr, momentum, dampening,
+                              weight_decay, nesterov, first_run)
+            self.assertEqual(params, ref_params)
+            self.assertEqual(bufs, ref_bufs)
+
+        # without momentum, no buffers are needed
+        params = self._fused_optimizer_inputs(torch.half)
+        grads = [torch.randn_like(p) for p in params]
+        ref_params = [(p.float() - lr * (g.float() + weight_decay * p.float())).half()
+                      for p, g in zip(params, grads)]
+        torch._fused_sgd_(params, grads, [], lr, 0, 0, weight_decay, False, False)
+        self.assertEqual(params, ref_params)
+
+        # a set found_inf skips the step
+        found_inf = torch.ones(1, device='cuda')
+        ref_params = [p.clone() for p in params]
+        torch._fused_sgd_(params, grads, [], lr, 0, 0, weight_decay, False, False, found_inf)
+        self.assertEqual(params, ref_params)
+        params = self._fused_optimizer_inputs(torch.float)
+        grads = [torch.randn_like(p) for p in params]
+        bufs = [torch.randn_like(p) for p in params]
+        ref_params = [p.clone() for p in params]
+        ref_bufs = [b.clone() for b in bufs]
+        torch._fused_sgd_(params, grads, bufs, lr, momentum, 0, weight_decay, False, False, found_inf)
+        self.assertEqual(params, ref_params)
+        self.assertEqual(bufs, ref_bufs)
+
+    def test_fused_adagrad(self):
+        lr, lr_decay, weight_decay, eps, step = 0.1, 0.01, 0.01, 1e-10, 3
+        params = self._fused_optimizer_inputs(torch.float)
+        grads = [torch.randn_like(p) for p in params]
+        state_sums = [torch.rand_like(p) for p in params]
+
+        ref_params = [p.clone() for p in params]
+        ref_state_sums = [s.clone() for s in state_sums]
+        clr = lr / (1 + (step - 1) * lr_decay)
+        for p, g, s in zip(ref_params, grads, ref_state_sums):
+            g = g + weight_decay * p
+            s.addcmul_(g, g)
+            p.addcdiv_(g, s.sqrt() + eps, value=-clr)
+
+        torch._fused_adagrad_(params, grads, state_sums, lr, lr_decay, weight_decay, eps, step)
+        self.assertEqual(params, ref_params)
+        self.assertEqual(state_sums, ref_state_sums)
+
+    def test_fused_rmsprop(self):
+        lr, alpha, eps, weight_decay = 0.01, 0.99, 1e-8, 0.01
+        for momentum, centered in product([0, 0.9], [False, True]):
+            params = self._fused_optimizer_inputs(torch.float)
+            grads = [torch.randn_like(p) for p in params]
+            square_avgs = [torch.rand_like(p) + 2 for p in params]
+            bufs = [torch.randn_like(p) for p in params] if momentum > 0 else []
+            grad_avgs = [torch.rand_like(p) for p in params] if centered else []
+
+            ref_params = [p.clone() for p in params]
+            ref_square_avgs = [s.clone() for s in square_avgs]
+            ref_bufs = [b.clone() for b in bufs]
+            ref_grad_avgs = [a.clone() for a in grad_avgs]
+            for i, (p, g, sq) in enumerate(zip(ref_params, grads, ref_square_avgs)):
+                g = g + weight_decay * p
+                sq.mul_(alpha).addcmul_(g, g, value=1 - alpha)
+                if centered:
+                    ga = ref_grad_avgs[i]
+                    ga.mul_(alpha).add_(g, alpha=1 - alpha)
+                    avg = sq.addcmul(ga, ga, value=-1).sqrt() + eps
+                else:
+                    avg = sq.sqrt() + eps
+                if momentum > 0:
+                    ref_bufs[i].mul_(momentum).addcdiv_(g, avg)
+                    p.add_(ref_bufs[i], alpha=-lr)
+                else:
+                    p.addcdiv_(g, avg, value=-lr)
+
+            torch._fused_rmsprop_(params, grads, square_avgs, bufs, grad_avgs,
+                                  lr, alpha, eps, weight_decay, momentum, centered)
+            self.assertEqual(params, ref_params)
+            self.assertEqual(square_avgs, ref_square_avgs)
+            self.assertEqual(bufs, ref_bufs)
+            self.assertEqual(grad_avgs, ref_grad_avgs)
+
+    def test_fused_lamb(self):
+        lr, beta1, beta2, eps, weight_decay, step = 0.01, 0.9, 0.999, 1e-6, 0.01, 2
+        params = self._fused_optimizer_inputs(torch.float)
+        grads = [torch.randn_like(p) for p in params]
+        exp_avgs = [torch.rand_like(p) for p in params]
+        exp_avg_sqs = [torch.rand_like(p) for p in params]
+
+        ref_params = [p.clone() for p in params]
+        ref_exp_avgs = [m.clone() for m in exp_avgs]
+        ref_exp_avg_sqs = [v.clone() for v in exp_avg_sqs]
+        for p, g, m, v in zip(ref_params, grads, ref_exp_avgs, ref_exp_avg_sqs):
+            m.mul_(beta1).add_(g, alpha=1 - beta1)
+            v.mul_(beta2).addcmul_(g, g, value=1 - beta2)
+            denom = v.sqrt() / math.sqrt(1 - beta2 ** step) + eps
+            update = (m / (1 - beta1 ** step)) / denom + weight_decay * p
+            p_norm, u_norm = p.norm(), update.norm()
+            trust_ratio = p_norm / u_norm if p_norm > 0 and u_norm > 0 else 1
+            p.sub_(lr * trust_ratio * update)
+
+        torch._fused_lamb_(params, grads, exp_avgs, exp_avg_sqs,
+                           lr, beta1, beta2, eps, weight_decay, step)
+        self.assertEqual(params, ref_params)
+        self.assertEqual(exp_avgs, ref_exp_avgs)
+        self.assertEqual(exp_avg_sqs, ref_exp_avg_sqs)
+
+        with self.assertRaisesRegex(RuntimeError, "contiguous"):
+            torch._fused_lamb_([params[0].t()], [grads[0].t()], [exp_avgs[0].t()],
+                               [exp_avg_sqs[0].t()], lr, beta1, beta2, eps, weight_decay, step)
+
     def test_multinomial_ext(self):
         # Test two corner cases from older PyTorch (Issue #4858)
         freqs = torch.cuda.FloatTensor([
@@ -2059,6 +2430,26 @@ t2.start()
         self.assertEqual(growth_tracker, 0)
         self.assertEqual(scale, 2.0)
 
+    def test_grad_scaling_foreach_unscale(self):
+        inv_scale = torch.tensor([0.25], device="cuda")
+        found_inf = torch.tensor([0.0], device="cuda")
+        # mixed dtypes, a non-contiguous gradient and enough chunks for several launches
+        grads = self._fused_optimizer_inputs(torch.float) + self._fused_optimizer_inputs(torch.half)
+        grads.append(torch.randn(5, 6, device="cuda").t())
+        ref_grads = [g.float() * 0.25 for g in grads]
+        torch._amp_foreach_non_finite_check_and_unscale_(grads, found_inf, inv_scale)
+        self.assertEqual(found_inf, 0.0)
+        for g, ref in zip(grads, ref_grads):
+            self.assertEqual(g.float(), ref, atol=1e-3, rtol=0)
+
+        for i in (0, len(grads) // 2, len(grads) - 1):
+            for bad in (float('inf'), float('nan')):
+                found_inf.zero_()
+                grads[i][-1, -1] = bad
+                torch._amp_foreach_non_finite_check_and_unscale_(grads, found_inf, inv_scale)
+                self.assertEqual(found_inf, 1.0)
+                grads[i].zero_()
+
     @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
     def test_grad_scaling_device_as_key(self):
         # Ensure that different instances of "device" objects that point to the same device
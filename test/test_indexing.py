@@ -84,6 +84,18 @@ class TestIndexing(TestCase):
             self.assertEqual(y, torch.ones(size=(10, 10), device=device))
             self.assertEquals(len(w), 2)
 
+    def test_index_put_accumulate_duplicate_indices(self, device):
+        # Large enough for the parallel accumulate kernels on CPU.
+        for dt in [torch.float, torch.double, torch.long]:
+            a = torch.zeros(100, dtype=dt, device=device)
+            indices = torch.arange(100000, device=device) % 37
+            values = torch.arange(100000, dtype=dt, device=device) % 5
+            a.index_put_((indices, ), values, accumulate=True)
+            expected = torch.zeros(100, dtype=torch.double)
+            for i, v in zip(indices.tolist(), values.tolist()):
+                expected[i] += v
+            self.assertEqual(a.cpu().double(), expected)
+
     def test_index_put_accumulate_large_tensor(self, device):
         # This test is for tensors with number of elements >= INT_MAX (2^31 - 1).
         N = (1 << 31) + 5
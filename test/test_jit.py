@@ -12412,6 +12412,165 @@ a")
         FileCheck().check_not("aten::dropout").run(str(m.graph))
         torch.testing.assert_allclose(ref_res, res, rtol=1e-2, atol=1e-3)
 
+    def test_fuse_dropout_add_layer_norm(self):
+        input_strs = ["""
+graph(%input, %residual, %p, %train, %shape, %weight, %bias, %eps, %cudnn_enable):
+    # CHECK-NOT: aten::dropout
+    # CHECK-NOT: aten::add
+    # CHECK-NOT: aten::layer_norm
+    # CHECK: aten::_dropout_add_layer_norm
+    %alpha : int = prim::Constant[value=1]()
+    %dropout = aten::dropout(%input, %p, %train)
+    %sum = aten::add(%residual, %dropout, %alpha)
+    %res = aten::layer_norm(%sum, %shape, %weight, %bias, %eps, %cudnn_enable)
+    return (%res)""", """
+graph(%input, %residual, %p, %train, %shape, %weight, %bias, %eps, %cudnn_enable):
+    # CHECK: aten::_dropout_add_layer_norm
+    %alpha : int = prim::Constant[value=1]()
+    %dropout = aten::dropout(%input, %p, %train)
+    %sum = aten::add(%dropout, %residual, %alpha)
+    %res = aten::layer_norm(%sum, %shape, %weight, %bias, %eps, %cudnn_enable)
+    return (%res)""", """
+graph(%input, %residual, %p, %train, %shape, %weight, %bias, %eps, %cudnn_enable):
+    # CHECK-NOT: aten::_dropout_add_layer_norm
+    %alpha : int = prim::Constant[value=2]()
+    %dropout = aten::dropout(%input, %p, %train)
+    %sum = aten::add(%residual, %dropout, %alpha)
+    %res = aten::layer_norm(%sum, %shape, %weight, %bias, %eps, %cudnn_enable)
+    return (%res)""", """
+graph(%input, %residual, %p, %train, %shape, %weight, %bias, %eps, %cudnn_enable):
+    # CHECK-NOT: aten::_dropout_add_layer_norm
+    %alpha : int = prim::Constant[value=1]()
+    %dropout = aten::dropout(%input, %p, %train)
+    %sum = aten::add(%residual, %dropout, %alpha)
+    %res = aten::layer_norm(%sum, %shape, %weight, %bias, %eps, %cudnn_enable)
+    return (%res, %sum)"""]
+        for input_str in input_strs:
+            graph = parse_ir(input_str)
+            torch._C._jit_pass_fuse_dropout_add_layer_norm(graph)
+            FileCheck().run(input_str, graph)
+
+        def fn(x, y, weight, bias):
+            return F.layer_norm(x + F.dropout(y, 0.1, False), (8,), weight, bias)
+
+        scripted = torch.jit.script(fn)
+        torch._C._jit_pass_inline(scripted.graph)
+        torch._C._jit_pass_constant_propagation(scripted.graph)
+        torch._C._jit_pass_fuse_dropout_add_layer_norm(scripted.graph)
+        FileCheck().check("aten::_dropout_add_layer_norm").run(scripted.graph)
+        args = (torch.randn(3, 8), torch.randn(3, 8), torch.randn(8), torch.randn(8))
+        self.assertEqual(scripted(*args), fn(*args))
+
+    def test_reuse_dead_outputs(self):
+        def fn(x, y):
+            a = x + y
+            b = a * y
+            c = b - x
+            d = c.sigmoid()
+            return d.t()
+
+        x = torch.randn(3, 4)
+        y = torch.randn(3, 4)
+        graph = torch.jit.script(fn).graph
+        torch._C._jit_pass_complete_shape_analysis(graph, (x, y), False)
+        torch._C._jit_pass_reuse_dead_outputs(graph)
+        nodes = {n.kind(): n for n in graph.nodes()}
+        # a is dead after b, b after c; nothing is free for a or b
+        self.assertEqual(len(list(nodes["aten::add"].inputs())), 3)
+        self.assertEqual(len(list(nodes["aten::mul"].inputs())), 2)
+        self.assertEqual(len(list(nodes["aten::sub"].inputs())), 4)
+        self.assertEqual(len(list(nodes["aten::sigmoid"].inputs())), 2)
+        f = torch._C._create_function_from_graph("reuse_dead_outputs", graph)
+        self.assertEqual(f(x, y), fn(x, y))
+
+        # without complete types, nothing is rewritten
+        graph = torch.jit.script(fn).graph
+        torch._C._jit_pass_reuse_dead_outputs(graph)
+        nodes = {n.kind(): n for n in graph.nodes()}
+        self.assertEqual(len(list(nodes["aten::sub"].inputs())), 3)
+
+    def test_lazy_tensors(self):
+        def fn(a, b, c):
+            return ((a + b) * c).relu()
+
+        a, b, c = (torch.randn(3, 4) for _ in range(3))
+        expected = fn(a, b, c)
+        la, lb, lc = (torch._C._jit_to_lazy(t) for t in (a, b, c))
+        out = fn(la, lb, lc)
+        self.assertTrue(torch._C._jit_is_lazy(out))
+        self.assertEqual(out.size(), expected.size())
+        self.assertEqual(torch._C._jit_lazy_materialize(out), expected)
+
+        # the same graph again hits the executor cache
+        cache_size = torch._C._jit_lazy_graph_cache_size()
+        out = fn(la, lb, lc)
+        self.assertEqual(torch._C._jit_lazy_materialize(out), expected)
+        self.assertEqual(torch._C._jit_lazy_graph_cache_size(), cache_size)
+
+        # in-place ops run eagerly on the materialized tensors
+        out = la + lb
+        out.mul_(lc)
+        self.assertEqual(torch._C._jit_lazy_materialize(out), (a + b) * c)
+        self.assertEqual(out.sum().item(), ((a + b) * c).sum().item())
+
+        with self.assertRaisesRegex(RuntimeError, "autograd"):
+            torch._C._jit_to_lazy(torch.randn(2, requires_grad=True))
+
+    def test_plan_memory(self):
+        def fn(x, y):
+            a = x + y
+            b = a * y
+            c = b - x
+            d = c.sigmoid()
+            return d.t()
+
+        x = torch.randn(3, 4)
+        y = torch.randn(3, 4)
+        graph = torch.jit.script(fn).graph
+        torch._C._jit_pass_complete_shape_analysis(graph, (x, y), False)
+        torch._C._jit_pass_plan_memory(graph)
+        slabs = [n for n in graph.nodes() if n.kind() == "memory_plan::Slab"]
+        views = [n for n in graph.nodes() if n.kind() == "memory_plan::SlabView"]
+        self.assertEqual(len(slabs), 1)
+        # a, b, c and d are intermediates; the output is a view of d, so d
+        # can't be planned
+        self.assertEqual(len(views), 3)
+        # a and c, which aren't alive at the same time, share memory
+        offsets = [v.i("offset") for v in views]
+        self.assertEqual(len(set(offsets)), 2)
+        self.assertEqual(slabs[0].i("size"), 2 * 64)
+        f = torch._C._create_function_from_graph("plan_memory", graph)
+        for _ in range(3):
+            self.assertEqual(f(x, y), fn(x, y))
+
+    def test_parallelize_branches(self):
+        def fn(x, y, w1, w2):
+            a = torch.mm(x, w1).relu().sigmoid().tanh()
+            b = torch.mm(y, w2).relu().sigmoid().tanh()
+            c = x.sum()
+            return torch.cat([a, b]) + c
+
+        args = (torch.randn(3, 4), torch.randn(3, 4), torch.randn(4, 5), torch.randn(4, 5))
+        graph = torch.jit.script(fn).graph
+        torch._C._jit_pass_parallelize_branches(graph)
+        # one tower is forked, the other and the small sum stay inline
+        FileCheck().check("aten::mm").check("prim::fork").check("aten::wait") \
+            .check("aten::cat").run(graph)
+        forks = [n for n in graph.nodes() if n.kind() == "prim::fork"]
+        self.assertEqual(len(forks), 1)
+        f = torch._C._create_function_from_graph("parallelize_branches", graph)
+        self.assertEqual(f(*args), fn(*args))
+
+        def mutating(x, y):
+            a = x.relu().sigmoid().tanh().exp()
+            y.add_(1)
+            b = y.relu().sigmoid().tanh().exp()
+            return a + b
+
+        graph = torch.jit.script(mutating).graph
+        torch._C._jit_pass_parallelize_branches(graph)
+        FileCheck().check_not("prim::fork").run(graph)
+
     def test_mm_batching(self):
 
         with enable_profiling_mode_for_profiling_tests():
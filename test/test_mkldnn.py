@@ -127,6 +127,28 @@ class TestMkldnn(TestCase):
                 self._test_serialization(mkldnn_conv2d, (x.to_mkldnn(),))
                 self._test_tracing(mkldnn_conv2d, (x.to_mkldnn(),))
 
+    def test_conv2d_channels_last(self):
+        x = torch.randn(4, 8, 32, 32, dtype=torch.float32)
+        conv2d = torch.nn.Conv2d(8, 16, kernel_size=3, padding=1).float()
+        with torch.backends.mkldnn.flags(enabled=False):
+            y_ref = conv2d(x)
+
+        conv2d_cl = copy.deepcopy(conv2d).to(memory_format=torch.channels_last)
+        x_cl = x.contiguous(memory_format=torch.channels_last)
+        y = conv2d_cl(x_cl)
+        self.assertTrue(y.is_contiguous(memory_format=torch.channels_last))
+        self.assertEqual(y, y_ref)
+
+        # the cached reordered weight must not outlive an in-place update
+        for _ in range(2):
+            with torch.no_grad():
+                conv2d.weight.mul_(2)
+                conv2d_cl.weight.mul_(2)
+            with torch.backends.mkldnn.flags(enabled=False):
+                y_ref = conv2d(x)
+            self.assertEqual(conv2d_cl(x_cl), y_ref)
+            self.assertEqual(conv2d_cl(x), y_ref)
+
     def test_conv2d_legacy_jit_model(self):
         """
         MKLDNN integration used to serialize models with 5d weight for grouped
@@ -305,10 +327,22 @@ class TestMkldnn(TestCase):
         self.assertEqual(out, mkldnn_out.to_dense())
 
     def test_view(self):
-        x = torch.randn(3, 4, 5, dtype=torch.float32).to_mkldnn()
+        x = torch.randn(3, 4, 5, dtype=torch.float32)
+        size = (x.size(0), -1)
+        # a plain format tensor is viewed without a copy
+        y = x.to_mkldnn()
+        z = y.view(size)
+        self.assertEqual(x.view(size), z.to_dense())
+        z.add_(z)
+        self.assertEqual(y.to_dense(), x * 2)
+
+        # a blocked format tensor can't be viewed
+        C = 7
+        m = mkldnn_utils.to_mkldnn(torch.nn.Conv2d(C, C, 3))
+        y_block = m(torch.randn(1, C, 8, 8).to_mkldnn())
         self.assertRaisesRegex(RuntimeError,
                                "Change to use reshape",
-                               lambda: x.view(x.size(0), -1))
+                               lambda: y_block.view(C, -1))
 
     def test_reshape(self):
         x = torch.randn(3, 4, 5, dtype=torch.float32) * 10
@@ -400,6 +434,84 @@ class TestMkldnn(TestCase):
         torch.sigmoid_(mkldnn_x)
         self.assertEqual(x, mkldnn_x.to_dense())
 
+    def test_tanh(self):
+        x = torch.randn(4, 5, dtype=torch.float32) * 10
+        mkldnn_x = x.to_mkldnn()
+        self.assertEqual(
+            torch.tanh(x),
+            torch.tanh(mkldnn_x).to_dense(),
+        )
+        # inplace
+        torch.tanh_(x)
+        torch.tanh_(mkldnn_x)
+        self.assertEqual(x, mkldnn_x.to_dense())
+
+    def test_clamp(self):
+        x = torch.randn(4, 5, dtype=torch.float32) * 10
+        mkldnn_x = x.to_mkldnn()
+        for min, max in [(-1.5, 2.5), (None, 3.), (-2., None)]:
+            self.assertEqual(
+                torch.clamp(x, min, max),
+                torch.clamp(mkldnn_x, min, max).to_dense(),
+            )
+        self.assertEqual(
+            torch.nn.functional.relu6(x),
+            torch.nn.functional.relu6(mkldnn_x).to_dense(),
+        )
+        self.assertEqual(
+            torch.nn.functional.hardtanh(x, -3., 4.),
+            torch.nn.functional.hardtanh(mkldnn_x, -3., 4.).to_dense(),
+        )
+        # inplace
+        x.clamp_(-1., 1.)
+        mkldnn_x.clamp_(-1., 1.)
+        self.assertEqual(x, mkldnn_x.to_dense())
+
+    def test_cat(self):
+        C = 7
+        conv = mkldnn_utils.to_mkldnn(torch.nn.Conv2d(3, C, 3))
+        xs = [torch.randn(2, 3, 8, 8) for _ in range(3)]
+        for dim in range(4):
+            self.assertEqual(
+                torch.cat(xs, dim),
+                torch.cat([x.to_mkldnn() for x in xs], dim).to_dense(),
+            )
+        # plain format and blocked format inputs
+        y_block = conv(xs[0].to_mkldnn())
+        y_plain = torch.randn(2, 5, 6, 6)
+        self.assertEqual(
+            torch.cat([y_block.to_dense(), y_plain], 1),
+            torch.cat([y_block, y_plain.to_mkldnn()], 1).to_dense(),
+        )
+
+    def test_to_mkldnn_propagate_layout(self):
+        class Model(torch.nn.Module):
+            def __init__(self):
+                super(Model, self).__init__()
+                self.features = torch.nn.Sequential(
+                    torch.nn.Conv2d(3, 8, 3, padding=1),
+                    torch.nn.BatchNorm2d(8),
+                    torch.nn.ReLU6(),
+                    torch.nn.Conv2d(8, 8, 3),
+                    torch.nn.Tanh(),
+                    # no mkldnn support, runs on dense inputs
+                    torch.nn.LocalResponseNorm(2),
+                    torch.nn.AdaptiveAvgPool2d((2, 2)),
+                    torch.nn.Flatten(),
+                )
+                self.fc = torch.nn.Linear(32, 10)
+
+            def forward(self, x):
+                y = self.features(x)
+                return torch.cat([self.fc(y), torch.sigmoid(y)], 1)
+
+        model = Model().eval()
+        x = torch.randn(2, 3, 10, 10, dtype=torch.float32)
+        mkldnn_model = mkldnn_utils.to_mkldnn(copy.deepcopy(model), propagate_layout=True)
+        y = mkldnn_model(x)
+        self.assertFalse(y.is_mkldnn)
+        self.assertEqual(model(x), y)
+
     def _test_serialization(self, module, inputs):
         with TemporaryFileName() as fname:
             torch.jit.save(module, fname)
@@ -164,6 +164,11 @@ def fs_sharing():
         mp.set_sharing_strategy(prev_strategy)
 
 
+def shm_files():
+    prefix = 'torch_' + str(os.getpid())
+    return [filename for filename in os.listdir('/dev/shm') if filename.startswith(prefix)]
+
+
 class leak_checker(object):
 
     def __init__(self, test_case):
@@ -834,6 +839,30 @@ if __name__ == "__main__":
         t = torch.randn(5, 5).cuda()
         self.assertTrue(t.is_shared())
 
+    @unittest.skipIf(IS_WINDOWS, "shared memory arenas are not supported on Windows")
+    def test_small_tensors_share_arena(self):
+        def do_test():
+            tensors = [torch.ones(4) * i for i in range(100)]
+            large = torch.zeros(1 << 19)  # 2 MB, too large for an arena
+            q = mp.Queue()
+            q.put(tensors + [large])
+            received = q.get(timeout=1)
+            self.assertEqual(received[:-1], tensors, 0)
+            if HAS_SHM_FILES:
+                # One arena segment and the segment of the large tensor.
+                self.assertEqual(len(shm_files()), 2 if mp.get_sharing_strategy() == 'file_system' else 1)
+            for t in tensors:
+                self.assertTrue(t.is_shared())
+            # Received storages are views of the arena blocks.
+            tensors[0].fill_(-1)
+            self.assertEqual(received[0], tensors[0], 0)
+            self.assertEqual(received[-1].data_ptr(), large.data_ptr())
+
+        with leak_checker(self):
+            do_test()
+        with fs_sharing(), leak_checker(self):
+            do_test()
+
 
 if __name__ == '__main__':
     run_tests()
@@ -43,7 +43,8 @@ from torch.testing._internal.common_nn import NNTestCase, NewModuleTest, NewCrit
     ctcloss_reference, new_module_tests
 from torch.testing._internal.common_device_type import instantiate_device_type_tests, dtypes, \
     dtypesIfCUDA, skipCUDAIfNoCudnn, skipCUDAIfCudnnVersionLessThan, onlyCUDA, \
-    skipCUDAIfRocm, skipCUDAIf, skipCUDAIfNotRocm, largeCUDATensorTest, onlyOnCPUAndCUDA
+    skipCUDAIfRocm, skipCUDAIf, skipCUDAIfNotRocm, largeCUDATensorTest, onlyOnCPUAndCUDA, \
+    onlyCPU
 
 from torch.nn import MultiheadAttention
 
@@ -3873,6 +3874,24 @@ class TestNN(NNTestCase):
             bias=True).cuda()
         result = m(x)
 
+    @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+    @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
+    def test_cudnn_benchmark_cache_file(self):
+        x = torch.randn(2, 3, 17, 19, device="cuda")
+        conv = torch.nn.Conv2d(3, 5, 3).cuda()
+        with cudnn.flags(enabled=True, benchmark=True):
+            expected = conv(x)
+        with TemporaryFileName() as fname:
+            cudnn.save_benchmark_cache(fname)
+            self.assertGreater(cudnn.load_benchmark_cache(fname), 0)
+            with cudnn.flags(enabled=True, benchmark=True):
+                self.assertEqual(conv(x), expected)
+        with TemporaryFileName() as fname:
+            with open(fname, 'wb') as f:
+                f.write(b'not a cache')
+            with warnings.catch_warnings(record=True):
+                self.assertEqual(cudnn.load_benchmark_cache(fname), 0)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
     def test_Conv2d_inconsistent_types_on_GPU_with_cudnn(self):
@@ -4187,6 +4206,57 @@ class TestNN(NNTestCase):
                                         m2.weight.grad.data], 0),
                              atol=dtype2prec_DONTUSE[dtype])
 
+    # CPU-only test for the direct depthwise and grouped conv2d kernels, which
+    # are checked against the convolutions of the groups one at a time.
+    def test_Conv2d_depthwise_grouped_direct_cpu(self):
+        def conv_per_group(i, weight, bias, groups, **kwargs):
+            outputs = [F.conv2d(i_g, w_g, b_g, **kwargs) for i_g, w_g, b_g in
+                       zip(i.chunk(groups, 1), weight.chunk(groups, 0), bias.chunk(groups, 0))]
+            return torch.cat(outputs, 1)
+
+        torch.manual_seed(123)
+        configs = [
+            # (in_channels, out_channels, groups, kernel_size, stride, padding, dilation)
+            (4, 4, 4, 3, 1, 1, 1),
+            (4, 8, 4, 3, 2, 1, 1),
+            (6, 6, 6, (5, 3), (1, 2), (2, 0), (2, 1)),
+            (3, 6, 3, 1, 1, 0, 1),
+            (8, 12, 4, 3, 1, 2, 2),
+            (6, 4, 2, (3, 2), 2, 1, 1),
+        ]
+        for dtype in [torch.float, torch.double]:
+            for in_channels, out_channels, groups, kernel_size, stride, padding, dilation in configs:
+                kwargs = dict(stride=stride, padding=padding, dilation=dilation)
+                m = nn.Conv2d(in_channels, out_channels, kernel_size, groups=groups, **kwargs).to(dtype)
+                i = torch.randn(2, in_channels, 11, 13, dtype=dtype, requires_grad=True)
+                output = m(i)
+                with torch.no_grad():
+                    output_no_grad = m(i)
+                    expected = conv_per_group(i, m.weight, m.bias, groups, **kwargs)
+                self.assertEqual(output, expected)
+                self.assertEqual(output_no_grad, expected)
+
+                grad_output = torch.randn_like(output)
+                output.backward(grad_output)
+                i1 = i.detach().clone().requires_grad_()
+                weight1 = m.weight.detach().clone().requires_grad_()
+                bias1 = m.bias.detach().clone().requires_grad_()
+                conv_per_group(i1, weight1, bias1, groups, **kwargs).backward(grad_output)
+                self.assertEqual(i.grad, i1.grad)
+                self.assertEqual(m.weight.grad, weight1.grad)
+                self.assertEqual(m.bias.grad, bias1.grad)
+
+        # depthwise backward, including double backward
+        i = torch.randn(1, 3, 7, 6, dtype=torch.double, requires_grad=True)
+        weight = torch.randn(6, 1, 3, 2, dtype=torch.double, requires_grad=True)
+        bias = torch.randn(6, dtype=torch.double, requires_grad=True)
+        for stride, padding, dilation in [(1, 1, 1), (2, 0, 1), (1, 2, 2)]:
+            def fn(i, weight, bias):
+                return F.conv2d(i, weight, bias, stride=stride, padding=padding,
+                                dilation=dilation, groups=3)
+            self.assertTrue(gradcheck(fn, (i, weight, bias)))
+            self.assertTrue(gradgradcheck(fn, (i, weight, bias)))
+
     def test_MaxUnpool2d_output_size(self):
         m = nn.MaxPool2d(3, stride=2, return_indices=True)
         mu = nn.MaxUnpool2d(3, stride=2)
@@ -4387,6 +4457,28 @@ class TestNN(NNTestCase):
         self.assertAlmostEqual(g1, g2, delta=1e-4)
         self.assertTrue((g1 == g1).all().item())  # check that we don't have NaN
 
+    @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+    def test_CTCLoss_half(self):
+        # short targets use the shared memory kernels, the long one does not
+        # fit in a block and is computed in float
+        for target_lengths in ([30, 0, 25, 12], [600, 20, 30, 10]):
+            input_lengths = [700, 650, 700, 40]
+            targets = torch.randint(1, 15, (sum(target_lengths),), dtype=torch.long, device='cuda')
+            log_probs = torch.randn(700, 4, 15, device='cuda').log_softmax(2).half().requires_grad_()
+            res = torch.nn.functional.ctc_loss(log_probs, targets, input_lengths, target_lengths,
+                                               reduction='none', zero_infinity=True)
+            self.assertEqual(res.dtype, torch.half)
+            grad_out = torch.rand_like(res)
+            grad, = torch.autograd.grad(res, log_probs, grad_out)
+            self.assertEqual(grad.dtype, torch.half)
+
+            log_probs_cpu = log_probs.detach().float().cpu().requires_grad_()
+            res_cpu = torch.nn.functional.ctc_loss(log_probs_cpu, targets.cpu(), input_lengths, target_lengths,
+                                                   reduction='none', zero_infinity=True)
+            grad_cpu, = torch.autograd.grad(res_cpu, log_probs_cpu, grad_out.float().cpu())
+            self.assertEqual(res.float().cpu(), res_cpu, prec=1e-2 * res_cpu.abs().max().item())
+            self.assertEqual(grad.float().cpu(), grad_cpu, prec=1e-2)
+
     def test_RNN_cell_no_broadcasting(self):
         def test(cell_module, input, hx, input_size, hidden_size):
             cell = cell_module(input_size, hidden_size)
@@ -4627,6 +4719,27 @@ class TestNN(NNTestCase):
 
             (hx + cx).sum().backward()
 
+    def test_RNN_cpu_fused_layers(self):
+        # Without autograd, full LSTM and GRU layers on CPU run fused kernels,
+        # which must match the cells that run with autograd.
+        for mode, dtype, bias, bidirectional, batch_first in product(
+                ('LSTM', 'GRU'), (torch.float, torch.double), (True, False), (True, False), (True, False)):
+            rnn = getattr(nn, mode)(10, 13, num_layers=2, bias=bias, bidirectional=bidirectional,
+                                    batch_first=batch_first).to(dtype)
+            input = torch.randn(3, 5, 10, dtype=dtype)
+            num_directions = 2 if bidirectional else 1
+            hx = torch.randn(2 * num_directions, 3 if batch_first else 5, 13, dtype=dtype)
+            hidden = (hx, torch.randn_like(hx)) if mode == 'LSTM' else hx
+            expected_output, expected_hidden = rnn(input, hidden)
+            with torch.no_grad():
+                output, hidden = rnn(input, hidden)
+            self.assertEqual(output, expected_output)
+            if mode == 'LSTM':
+                self.assertEqual(hidden[0], expected_hidden[0])
+                self.assertEqual(hidden[1], expected_hidden[1])
+            else:
+                self.assertEqual(hidden, expected_hidden)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_pack_sequence_batch_sizes_throw(self):
         with self.assertRaisesRegex(ValueError, r"batch_sizes should always be on CPU"):
@@ -6200,6 +6313,52 @@ class TestNN(NNTestCase):
         self.assertEqual(bn.bias.grad, ref_bn.bias.grad)
         self.assertEqual(input.grad, ref_input.grad)
 
+    def test_batchnorm_nhwc_cpu(self):
+        for shape in [(4, 8, 2, 2), (2, 19, 31, 3), (300, 5, 1, 1)]:
+            input = torch.randn(shape, dtype=torch.double, requires_grad=True)
+            input = input.contiguous(memory_format=torch.channels_last)
+            input.retain_grad()
+            grad = torch.randn(shape, dtype=torch.double).contiguous(memory_format=torch.channels_last)
+            bn = nn.BatchNorm2d(shape[1]).double()
+            bn.weight.data.uniform_()
+            bn.bias.data.uniform_()
+
+            ref_input = input.detach().clone().contiguous().requires_grad_(True)
+            ref_bn = nn.BatchNorm2d(shape[1]).double()
+            ref_bn.load_state_dict(bn.state_dict())
+
+            for train in [True, False]:
+                bn.train(train)
+                ref_bn.train(train)
+                out = bn(input)
+                out.backward(grad)
+                ref_out = ref_bn(ref_input)
+                ref_out.backward(grad.contiguous())
+
+                self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+                self.assertEqual(out, ref_out)
+                self.assertEqual(bn.running_mean, ref_bn.running_mean)
+                self.assertEqual(bn.running_var, ref_bn.running_var)
+                self.assertEqual(bn.weight.grad, ref_bn.weight.grad)
+                self.assertEqual(bn.bias.grad, ref_bn.bias.grad)
+                self.assertEqual(input.grad, ref_input.grad)
+
+    def test_batchnorm_2d_input_cpu(self):
+        # [N, C] inputs take the channels last kernels, [N, C, L] ones do not
+        input = torch.randn(1000, 37, dtype=torch.double, requires_grad=True)
+        ref_input = input.detach().clone().unsqueeze(-1).requires_grad_(True)
+        bn = nn.BatchNorm1d(37).double()
+        ref_bn = nn.BatchNorm1d(37).double()
+        out = bn(input)
+        ref_out = ref_bn(ref_input)
+        self.assertEqual(out, ref_out.squeeze(-1))
+        self.assertEqual(bn.running_var, ref_bn.running_var)
+        grad = torch.randn_like(out)
+        out.backward(grad)
+        ref_out.backward(grad.unsqueeze(-1))
+        self.assertEqual(input.grad, ref_input.grad.squeeze(-1))
+        self.assertEqual(bn.weight.grad, ref_bn.weight.grad)
+
     @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
     def test_batchnorm_cudnn_half(self):
         # THNN
@@ -7618,6 +7777,24 @@ class TestNN(NNTestCase):
             out_t_5 = m(in_t_9[:, :, :5, :5, :5])
         self.assertEqual(out_t_9[:, :, :15, :15, :15], out_t_5)
 
+    def test_upsampling_channels_last_cpu(self):
+        cases = [('bilinear', (2, 3, 5, 7), torch.channels_last),
+                 ('bicubic', (2, 3, 5, 7), torch.channels_last),
+                 ('bilinear', (1, 20, 4, 4), torch.channels_last),
+                 ('trilinear', (2, 17, 3, 4, 5), torch.channels_last_3d)]
+        for mode, shape, memory_format in cases:
+            for align_corners in [True, False]:
+                for scale_factor in [0.5, 1.7, 2]:
+                    input = torch.randn(shape)
+                    kwargs = dict(scale_factor=scale_factor, mode=mode, align_corners=align_corners)
+                    out = F.interpolate(input.contiguous(memory_format=memory_format), **kwargs)
+                    self.assertTrue(out.is_contiguous(memory_format=memory_format))
+                    self.assertEqual(out, F.interpolate(input, **kwargs))
+
+            input = torch.randn(shape[:2] + (3,) * (len(shape) - 2), dtype=torch.double)
+            input = input.contiguous(memory_format=memory_format).requires_grad_()
+            gradcheck(lambda x: F.interpolate(x, scale_factor=2, mode=mode, align_corners=False), [input])
+
     def test_interpolate(self):
         def _test_interpolate_helper(in_t, scale_factor, layer):
             out_size = int(math.floor(in_t.shape[-1] * scale_factor))
@@ -8096,6 +8273,64 @@ class TestNN(NNTestCase):
         self.assertEqual(input.grad.dtype, dtype)
         self.assertEqual(input.grad, inputf.grad.to(dtype), atol=0.1)
 
+    def test_softmax_cpu(self, dtype=torch.bfloat16):
+        # 1000 elements per row so that a sum accumulated in bfloat16 would
+        # be visibly off
+        inputf = torch.rand(32, 1000, device="cpu", dtype=torch.float, requires_grad=True)
+        input = inputf.to(dtype).detach().requires_grad_(True)
+        outf = F.softmax(inputf, dim=-1)
+        out = F.softmax(input, dim=-1)
+        self.assertEqual(out.dtype, dtype)
+        self.assertEqualIgnoreType(out, outf, atol=1e-3, rtol=0.02)
+
+        grad = torch.rand_like(outf)
+        out.backward(grad.to(dtype))
+        outf.backward(grad)
+        self.assertEqual(input.grad.dtype, dtype)
+        self.assertEqualIgnoreType(input.grad, inputf.grad, atol=1e-3, rtol=0.05)
+
+    def test_softmax_non_last_dim_cpu(self):
+        # Inner sizes that are, are not and are less than a multiple of the
+        # vector width, checked against the last-dim kernels
+        shapes_dims = [((4, 10, 16), 1), ((3, 7, 13), 1), ((2, 5, 3), 1),
+                       ((6, 17), 0), ((2, 3, 9, 11), 1), ((2, 3, 1), 1)]
+        for fn in [F.softmax, F.log_softmax]:
+            for dtype in [torch.float, torch.double, torch.bfloat16]:
+                for shape, dim in shapes_dims:
+                    input = (torch.randn(shape) * 4).to(dtype).requires_grad_(True)
+                    ref_input = input.to(torch.double).detach().transpose(dim, -1).contiguous()
+                    ref_input.requires_grad_(True)
+                    out = fn(input, dim=dim)
+                    ref = fn(ref_input, dim=-1)
+                    self.assertEqual(out.dtype, dtype)
+                    atol, rtol = (0.05, 0.02) if dtype == torch.bfloat16 else (1e-5, 1e-5)
+                    self.assertEqualIgnoreType(out, ref.transpose(dim, -1), atol=atol, rtol=rtol)
+
+                    grad = torch.randn(shape, dtype=torch.double)
+                    out.backward(grad.to(dtype))
+                    ref.backward(grad.transpose(dim, -1))
+                    self.assertEqual(input.grad.dtype, dtype)
+                    self.assertEqualIgnoreType(input.grad, ref_input.grad.transpose(dim, -1),
+                                               atol=atol * 4, rtol=rtol)
+
+    def test_layer_norm_cpu(self, dtype=torch.bfloat16):
+        inputf = torch.randn(16, 1000, device="cpu", dtype=torch.float, requires_grad=True)
+        input = inputf.to(dtype).detach().requires_grad_(True)
+        weightf = torch.randn(1000, requires_grad=True)
+        weight = weightf.to(dtype).detach().requires_grad_(True)
+        biasf = torch.randn(1000, requires_grad=True)
+        bias = biasf.to(dtype).detach().requires_grad_(True)
+        outf = F.layer_norm(inputf, (1000,), weightf, biasf)
+        out = F.layer_norm(input, (1000,), weight, bias)
+        self.assertEqual(out.dtype, dtype)
+        self.assertEqualIgnoreType(out, outf, atol=0.05, rtol=0.02)
+
+        out.sum().backward()
+        outf.sum().backward()
+        self.assertEqual(input.grad.dtype, dtype)
+        self.assertEqualIgnoreType(input.grad, inputf.grad, atol=0.05, rtol=0.05)
+        self.assertEqualIgnoreType(bias.grad, biasf.grad, atol=0.05, rtol=0.02)
+
     def test_adaptive_log_softmax(self):
         # args validation
         with self.assertRaises(ValueError):
@@ -9354,12 +9589,83 @@ class TestNNDeviceType(NNTestCase):
         if self.device_type == 'cuda':
             self._test_LayerNorm_cuda_half(device)
 
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    def test_dropout_add_layer_norm(self, device, dtype):
+        def reference(input, residual, mask, keep, weight, bias):
+            return F.layer_norm(residual + input * mask / keep, (64,), weight, bias)
+
+        tol = dict(atol=1e-2, rtol=1e-2) if dtype == torch.half else {}
+        input = torch.randn(4, 5, 64, device=device, dtype=dtype, requires_grad=True)
+        residual = torch.randn(4, 5, 64, device=device, dtype=dtype, requires_grad=True)
+        weight = torch.randn(64, device=device, dtype=dtype, requires_grad=True)
+        bias = torch.randn(64, device=device, dtype=dtype, requires_grad=True)
+        leaves = (input, residual, weight, bias)
+
+        # without dropout, the op is an add followed by layer_norm
+        for p, train in [(0.3, False), (0., True)]:
+            out = torch._dropout_add_layer_norm(input, residual, (64,), weight, bias, p, train)
+            expected = reference(input, residual, torch.ones_like(input), 1, weight, bias)
+            self.assertEqual(out, expected, **tol)
+            grad = torch.randn_like(out)
+            self.assertEqual(torch.autograd.grad(out, leaves, grad),
+                             torch.autograd.grad(expected, leaves, grad), **tol)
+
+        out = torch._dropout_add_layer_norm(input, residual, (64,), weight, bias, 1., True)
+        self.assertEqual(out, F.layer_norm(residual, (64,), weight, bias))
+
+        if self.device_type != 'cuda':
+            return
+        keep = 0.7
+        out, sum, mask, mean, rstd = torch._fused_dropout_add_layer_norm(
+            input, residual, weight, bias, 20, 64, keep, 1e-5)
+        self.assertEqual(mask.numel(), input.numel())
+        self.assertEqual(mask.double().mean().item(), keep, atol=0.1, rtol=0)
+        mask = mask.view_as(input).to(dtype)
+        self.assertEqual(sum, residual + input * mask / keep, **tol)
+        expected = reference(input, residual, mask, keep, weight, bias)
+        self.assertEqual(out, expected, **tol)
+        grad = torch.randn_like(out)
+        self.assertEqual(torch.autograd.grad(out, leaves, grad),
+                         torch.autograd.grad(expected, leaves, grad), **tol)
+
+        # mismatched shapes take the unfused path, which broadcasts
+        out = torch._dropout_add_layer_norm(input[0], residual, (64,), weight, bias, 0.3, False)
+        self.assertEqual(out, F.layer_norm(residual + input[0], (64,), weight, bias), **tol)
+
     def test_GroupNorm_general(self, device):
         self._test_GroupNorm_general(device)
 
         if self.device_type == 'cuda':
             self._test_GroupNorm_cuda_half()
 
+    @onlyCPU
+    def test_GroupNorm_cpu_kernel(self, device):
+        def group_norm_reference(x, g, weight, bias, eps):
+            b, c = x.shape[:2]
+            out = F.batch_norm(x.reshape(1, b * g, -1), None, None, training=True, eps=eps).reshape(x.shape)
+            affine_shape = [1, c] + [1] * (x.dim() - 2)
+            return out * weight.view(affine_shape) + bias.view(affine_shape)
+
+        for shape, g in [((3, 6, 5, 7), 3), ((2, 32, 40), 8), ((4, 4, 1, 1), 4), ((2, 9, 3, 1, 2), 1)]:
+            x = torch.randn(shape, dtype=torch.double).mul_(3).add_(100).requires_grad_()
+            weight = torch.randn(shape[1], dtype=torch.double, requires_grad=True)
+            bias = torch.randn(shape[1], dtype=torch.double, requires_grad=True)
+            out = F.group_norm(x, g, weight, bias, 1e-5)
+            ref = group_norm_reference(x, g, weight, bias, 1e-5)
+            self.assertEqual(out, ref)
+            grad = torch.randn_like(out)
+            grads = torch.autograd.grad(out, (x, weight, bias), grad)
+            ref_grads = torch.autograd.grad(ref, (x, weight, bias), grad)
+            for actual, expected in zip(grads, ref_grads):
+                self.assertEqual(actual, expected)
+
+        x = torch.randn(2, 6, 3, dtype=torch.double, requires_grad=True)
+        weight = torch.randn(6, dtype=torch.double, requires_grad=True)
+        bias = torch.randn(6, dtype=torch.double, requires_grad=True)
+        self.assertTrue(gradcheck(lambda x, w, b: F.group_norm(x, 3, w, b), (x, weight, bias)))
+        self.assertTrue(gradgradcheck(lambda x, w, b: F.group_norm(x, 3, w, b), (x, weight, bias)))
+
     def test_GroupNorm_raises_error_if_one_value_per_group(self, device):
         x = torch.rand(10)[None, :, None]
         with self.assertRaises(ValueError):
@@ -9621,6 +9927,34 @@ class TestNNDeviceType(NNTestCase):
         helper(10, 512, 31, 31, 3, stride=2)
         helper(1, 129, 8, 8, 3, stride=2)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_max_pool2d_nhwc_cpu(self, device, dtype):
+        def helper(n, c, h, w, kernel_size, stride=None, padding=0, dilation=1):
+            if stride is None:
+                stride = kernel_size
+            input = torch.randn(n, c, h, w, dtype=dtype, device=device)
+            input = input.contiguous(memory_format=torch.channels_last).requires_grad_()
+            pool = torch.nn.MaxPool2d(kernel_size, stride, padding, dilation)
+            ref_input = input.detach().clone().contiguous().requires_grad_(True)
+
+            out = pool(input)
+            ref_out = pool(ref_input)
+            grad = torch.randn_like(ref_out)
+            out.backward(grad)
+            ref_out.backward(grad)
+
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertTrue(input.grad.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(out, ref_out, atol=0, rtol=0)
+            self.assertEqual(input.grad, ref_input.grad)
+
+        helper(4, 8, 8, 8, 7)
+        helper(4, 8, 7, 7, 3, stride=1)
+        helper(4, 8, 9, 9, 3, stride=2, padding=1)
+        helper(2, 16, 12, 12, 3, stride=1, dilation=2)
+        helper(1, 129, 8, 8, 3, stride=2)
+
     def test_embedding_dense_grad(self, device):
         embd = nn.Embedding(20, 20).to(device)
         weight = embd.weight
@@ -9724,6 +10058,29 @@ class TestNNDeviceType(NNTestCase):
                 embedding.zero_grad()
                 self.assertEqual(after, pre)
 
+    @dtypes(torch.float, torch.double)
+    def test_block_sparse_linear(self, device, dtype):
+        # 8 rows per block takes the vectorized CPU path, 4 or 3 the scalar one
+        for blocksize in [(8, 1), (4, 4), (16, 16), (3, 2)]:
+            out_features, in_features = blocksize[0] * 4, blocksize[1] * 6
+            weight = torch.randn(out_features, in_features, device=device, dtype=dtype)
+            mask = torch.rand(4, 6, device=device) < 0.3
+            mask[1] = False  # a block row without any block
+            mask = mask.repeat_interleave(blocksize[0], 0).repeat_interleave(blocksize[1], 1)
+            weight = weight * mask.to(dtype)
+            bias = torch.randn(out_features, device=device, dtype=dtype)
+            crow_indices, col_indices, values = torch._block_sparse_linear_pack(weight, blocksize)
+            self.assertEqual(crow_indices[-1].item(), values.size(0))
+            self.assertEqual(values.shape[1:], (blocksize[1], blocksize[0]))
+            for input_size in [(1, in_features), (5, in_features), (2, 3, in_features)]:
+                input = torch.randn(input_size, device=device, dtype=dtype)
+                for b in [None, bias]:
+                    out = torch._block_sparse_linear(input, crow_indices, col_indices, values, b)
+                    self.assertEqual(out, F.linear(input, weight, b))
+
+        with self.assertRaisesRegex(RuntimeError, "can't be split into blocks"):
+            torch._block_sparse_linear_pack(torch.randn(6, 4, device=device), (4, 4))
+
     @dtypesIfCUDA(torch.half, torch.float)
     @dtypes(torch.float)
     def test_softmax_backward(self, device, dtype):
@@ -10552,6 +10909,103 @@ class TestNNDeviceType(NNTestCase):
         self._test_EmbeddingBag(device, 'sum', True, dtype, test_backward=test_backward)
         self._test_EmbeddingBag(device, 'mean', True, dtype, test_backward=test_backward)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_embedding_bag_many_bags(self, device, dtype):
+        # enough bags to be reduced in parallel, an embedding dim that is not
+        # a multiple of the vector width, empty bags and repeated indices
+        num_bags, D = 600, 37
+        weight = torch.randn(50, D, device=device, dtype=dtype)
+        lengths = torch.randint(0, 40, (num_bags,))
+        lengths[::17] = 0
+        indices = torch.randint(50, (int(lengths.sum()),), device=device)
+        offsets = torch.cat([lengths.new_zeros(1), lengths.cumsum(0)[:-1]]).to(device)
+        per_sample_weights = torch.randn(indices.numel(), device=device, dtype=dtype)
+
+        for include_last_offset in (False, True):
+            bag_offsets = offsets
+            if include_last_offset:
+                bag_offsets = torch.cat([offsets, offsets.new_tensor([indices.numel()])])
+            sums = []
+            weighted_sums = []
+            maxes = []
+            max_indices = []
+            for start, length in zip(offsets.tolist(), lengths.tolist()):
+                rows = weight[indices[start:start + length]]
+                sums.append(rows.sum(0))
+                weighted_sums.append((rows * per_sample_weights[start:start + length, None]).sum(0))
+                if length == 0:
+                    maxes.append(weight.new_zeros(D))
+                    max_indices.append(indices.new_zeros(D))
+                else:
+                    value, position = rows.max(0)
+                    maxes.append(value)
+                    max_indices.append(indices[start + position])
+            sums = torch.stack(sums)
+            means = sums / lengths.clamp(min=1).to(device, dtype).unsqueeze(1)
+
+            def embedding_bag(mode, per_sample_weights=None):
+                return torch.embedding_bag(weight, indices, bag_offsets, False, mode, False,
+                                           per_sample_weights, include_last_offset)
+
+            self.assertEqual(embedding_bag(0)[0], sums)
+            self.assertEqual(embedding_bag(0, per_sample_weights)[0], torch.stack(weighted_sums))
+            self.assertEqual(embedding_bag(1)[0], means)
+            output, _, _, output_indices = embedding_bag(2)
+            self.assertEqual(output, torch.stack(maxes))
+            self.assertEqual(output_indices[:num_bags], torch.stack(max_indices))
+
+        # non-contiguous rows take the generic path
+        output = torch.embedding_bag(weight.t().contiguous().t(), indices, offsets, False, 2)[0]
+        self.assertEqual(output, torch.stack(maxes))
+
+    @dtypes(torch.float, torch.double)
+    def test_embedding_bag_fused_optimizer(self, device, dtype):
+        num_embeddings, D = 20, 7
+        indices = torch.randint(num_embeddings, (30,), device=device)
+        offsets = torch.tensor([0, 4, 4, 13, 21], device=device)
+        per_sample_weights = torch.randn(30, device=device, dtype=dtype)
+        lr, eps = 0.1, 1e-6
+        for optimizer, mode, scale_grad_by_freq, weighted in itertools.product(
+                ('sgd', 'adagrad', 'rowwise_adagrad'), ('sum', 'mean'), (False, True), (False, True)):
+            if weighted and mode != 'sum':
+                continue
+            fused = nn.EmbeddingBag(num_embeddings, D, mode=mode, scale_grad_by_freq=scale_grad_by_freq,
+                                    fused_optimizer=optimizer, fused_lr=lr, fused_eps=eps)
+            fused = fused.to(device, dtype)
+            reference = nn.EmbeddingBag(num_embeddings, D, mode=mode, scale_grad_by_freq=scale_grad_by_freq,
+                                        _weight=fused.weight.detach().clone()).to(device, dtype)
+            state = torch.zeros_like(fused.optimizer_state)
+            psw = per_sample_weights if weighted else None
+            for _ in range(2):
+                fused_out = fused(indices, offsets, psw)
+                out = reference(indices, offsets, psw)
+                self.assertEqual(fused_out, out)
+                grad_out = torch.randn_like(out)
+                fused_out.backward(grad_out)
+                out.backward(grad_out)
+                self.assertIsNone(fused.weight.grad)
+
+                with torch.no_grad():
+                    g = reference.weight.grad
+                    reference.weight.grad = None
+                    used = torch.zeros(num_embeddings, dtype=torch.bool, device=device)
+                    used[indices] = True
+                    if optimizer == 'sgd':
+                        reference.weight.sub_(lr * g)
+                    elif optimizer == 'adagrad':
+                        state.add_(g * g)
+                        reference.weight.sub_(lr * g / (state.sqrt() + eps) * used.unsqueeze(1))
+                    else:
+                        state.add_((g * g).mean(1))
+                        reference.weight.sub_(lr * g / (state.sqrt() + eps).unsqueeze(1) * used.unsqueeze(1))
+                self.assertEqual(fused.weight, reference.weight)
+                self.assertEqual(fused.optimizer_state, state)
+
+        with self.assertRaises(ValueError):
+            nn.EmbeddingBag(num_embeddings, D, mode='max', fused_optimizer='sgd')
+        with self.assertRaises(ValueError):
+            nn.EmbeddingBag(num_embeddings, D, fused_optimizer='adam')
 
     @onlyCUDA
     @skipCUDAIfNotRocm
@@ -660,6 +660,21 @@ class TestSerialization(TestCase, SerializationMixin):
 
         test(io.BytesIO())
 
+    @unittest.skipIf(IS_WINDOWS, "NamedTemporaryFile on windows")
+    def test_serialization_zipfile_parallel_writes(self):
+        # Big enough for its storage to be written in several chunks.
+        data = {'big': torch.randn(5 * 1024 * 1024), 'small': torch.arange(10)}
+        if torch.cuda.is_available():
+            data['cuda'] = torch.randn(1024, 1024, device='cuda')
+            data['cuda_small'] = torch.arange(10, device='cuda')
+        with tempfile.NamedTemporaryFile() as f:
+            torch.save(data, f.name, _num_write_threads=4)
+            self.assertTrue(zipfile.is_zipfile(f.name))
+            with zipfile.ZipFile(f.name) as z:
+                self.assertIsNone(z.testzip())
+            result = torch.load(f.name)
+        self.assertEqual(result, data)
+
     def run(self, *args, **kwargs):
         with serialization_method(use_zip=True):
             return super(TestSerialization, self).run(*args, **kwargs)
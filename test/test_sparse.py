@@ -769,6 +769,41 @@ class TestSparse(TestCase):
         x.sub_(2 * x)
         self.assertLessEqual(x._nnz(), 10)
 
+    def test_sparse_add_and_coalesce(self):
+        def test_shape(sparse_dims, nnz_x, nnz_y, sizes):
+            x, _, _ = self._gen_sparse(sparse_dims, nnz_x, sizes)
+            y, _, _ = self._gen_sparse(sparse_dims, nnz_y, sizes)
+            for a, b in [(x, y), (x.coalesce(), y), (x, y.coalesce()), (x.coalesce(), y.coalesce())]:
+                r = torch._sparse_add_and_coalesce(a, b)
+                expected = (a + b).coalesce()
+                self.assertTrue(r.is_coalesced())
+                self.assertEqual(r._indices(), expected._indices())
+                self.assertEqual(r._values(), expected._values())
+
+        test_shape(1, 20, 10, [30])
+        test_shape(2, 20, 30, [5, 6])
+        test_shape(2, 20, 30, [5, 6, 3])
+        test_shape(2, 0, 30, [5, 6, 3])
+        test_shape(3, 20, 0, [5, 6, 3])
+
+    def test_merge_sparse_grads(self):
+        prev = torch._C._is_merge_sparse_grads_enabled()
+        try:
+            torch._C._set_merge_sparse_grads_enabled(True)
+            weight = torch.randn(10, 3, device=self.device, requires_grad=True)
+            for _ in range(3):
+                indices = torch.tensor([1, 4, 1, 7], device=self.device)
+                torch.nn.functional.embedding(indices, weight, sparse=True).sum().backward()
+            self.assertTrue(weight.grad.is_coalesced())
+            self.assertEqual(weight.grad._nnz(), 3)
+            expected = torch.zeros(10, 3, device=self.device)
+            expected[1] = 6
+            expected[4] = 3
+            expected[7] = 3
+            self.assertEqual(weight.grad.to_dense(), expected)
+        finally:
+            torch._C._set_merge_sparse_grads_enabled(prev)
+
     def test_cat(self):
         # shapes: list of tuples (sparse_dims, nnz, sizes)
         def test_shapes(shapes, dim, fail_message=None):
@@ -918,6 +953,8 @@ class TestSparse(TestCase):
         test_shape(10, 100, 100, 20)
         test_shape(100, 1000, 200, 20)
         test_shape(64, 10000, 300, 20)
+        # enough rows to be split across threads
+        test_shape(2000, 100, 50, 4000)
         test_shape(0, 100, 100, 0)
         test_shape(10, 0, 100, 0)
         test_shape(10, 100, 0, 0)
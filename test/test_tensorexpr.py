@@ -1258,6 +1258,62 @@ class TestTensorExprFuser(BaseTestClass):
         scripted(a, b)
         assert cx.elapsed_value() == 1
 
+    def test_reductions(self):
+        def test_sum(x, y):
+            return (torch.sum(x * y, dim=1) + 1, torch.sum(x, dim=[0, 2], keepdim=True))
+
+        def test_mean(x, y):
+            return torch.mean(x + y) * 2
+
+        def test_softmax(x, y):
+            return F.softmax(x * y, dim=-1) + 1, F.log_softmax(x - y, dim=1)
+
+        x = torch.rand(4, 8, 16)
+        y = torch.rand(4, 8, 16)
+        for test in (test_sum, test_mean, test_softmax):
+            llvm_executed = LLVMCodeGenExecuted()
+            simple_ir_eval_executed = SimpleIREvalExecuted()
+            scripted = torch.jit.script(test)
+            with num_profiled_runs(1):
+                scripted(x, y)
+                results = scripted(x, y)
+            ref = test(x, y)
+            for result, expected in zip(results if isinstance(results, tuple) else (results,),
+                                        ref if isinstance(ref, tuple) else (ref,)):
+                np.testing.assert_allclose(expected.numpy(), result.numpy(), rtol=1e-5)
+            assert (
+                llvm_executed.elapsed_value() >= 1
+                or simple_ir_eval_executed.elapsed_value() >= 1
+            )
+
+    def test_dynamic_shapes(self):
+        def test(x, y, z):
+            return (x * y + z).sigmoid() - torch.mean(x, dim=1, keepdim=True)
+
+        old_dynamic_shapes = torch._C._jit_texpr_dynamic_shapes_enabled()
+        torch._C._jit_set_texpr_dynamic_shapes_enabled(True)
+        try:
+            scripted = torch.jit.script(test)
+            with num_profiled_runs(1):
+                scripted(torch.rand(4, 8), torch.rand(4, 8), torch.rand(8))
+                # A single kernel handles every length without bailing out.
+                llvm_executed = LLVMCodeGenExecuted()
+                simple_ir_eval_executed = SimpleIREvalExecuted()
+                for n in (4, 7, 13, 1):
+                    x, y, z = torch.rand(n, 8), torch.rand(n, 8), torch.rand(8)
+                    np.testing.assert_allclose(
+                        test(x, y, z).numpy(), scripted(x, y, z).numpy(), rtol=1e-5)
+                assert (
+                    llvm_executed.elapsed_value() >= 1
+                    or simple_ir_eval_executed.elapsed_value() >= 1
+                )
+                # Mismatched dynamic dimensions fall back to the interpreter.
+                x, y = torch.rand(3, 8), torch.rand(1, 8)
+                np.testing.assert_allclose(
+                    test(x, y, z).numpy(), scripted(x, y, z).numpy(), rtol=1e-5)
+        finally:
+            torch._C._jit_set_texpr_dynamic_shapes_enabled(old_dynamic_shapes)
+
     @unittest.skipIf(not torch.cuda.is_available(), "requires CUDA")
     def test_multi_rand(self):
         def test(x):
@@ -2,12 +2,14 @@ import sys
 import io
 import inspect
 import math
+import itertools
 import random
 import re
 import copy
 import torch
 import torch.cuda
 import torch.backends.cuda
+import torch.backends.mkl
 import tempfile
 import unittest
 import warnings
@@ -18,12 +20,13 @@ from torch.utils.dlpack import from_dlpack, to_dlpack
 from torch._six import inf, nan, string_classes, istuple
 from itertools import product, combinations, combinations_with_replacement, permutations
 from functools import reduce
+from contextlib import contextmanager
 from random import randrange
 from torch import multiprocessing as mp
 from torch.testing._internal.common_methods_invocations import tri_tests_args, run_additional_tri_tests, \
     _compare_trilu_indices
 from torch.testing._internal.common_utils import TestCase, iter_indices, TEST_NUMPY, TEST_SCIPY, TEST_MKL, \
-    TEST_LIBROSA, TEST_WITH_ROCM, run_tests, skipIfNoLapack, suppress_warnings, \
+    TEST_LIBROSA, TEST_PYARROW, TEST_WITH_ROCM, run_tests, skipIfNoLapack, suppress_warnings, \
     IS_WINDOWS, NO_MULTIPROCESSING_SPAWN, do_test_dtypes, do_test_empty_full, \
     IS_SANDCASTLE, load_tests, slowTest, skipCUDANonDefaultStreamIf, skipCUDAMemoryLeakCheckIf, \
     BytesIOContext, skipIfRocm, torch_to_numpy_dtype_dict
@@ -759,6 +762,22 @@ class _TestTorchMixin(object):
         self.assertEqual(y[:, 0], range(100))
         self.assertEqual(y[:, 40], range(4000, 4100))
 
+    def test_copy_permute(self):
+        # permuted copies of every element size, with sizes that aren't
+        # multiples of the tiles
+        for dtype in [torch.uint8, torch.bfloat16, torch.float, torch.double]:
+            x = torch.arange(3 * 70 * 9 * 67).reshape(3, 70, 9, 67).to(dtype)
+            for dims in [(0, 2, 3, 1), (0, 3, 1, 2), (3, 2, 1, 0), (1, 0, 3, 2)]:
+                y = x.permute(dims).contiguous()
+                index = tuple(torch.randint(0, s, (100,)) for s in y.shape)
+                x_index = [None] * 4
+                for d, i in zip(dims, index):
+                    x_index[d] = i
+                self.assertEqual(y[index], x[tuple(x_index)])
+            y = torch.empty(3, 67, 70, 9, dtype=dtype).permute(0, 2, 3, 1)
+            y.copy_(x)
+            self.assertEqual(y, x)
+
     def test_device(self):
         cpu = torch.device('cpu')
         self.assertEqual('cpu', str(cpu))
@@ -1723,6 +1742,50 @@ class _TestTorchMixin(object):
         # Make sure True isn't mistakenly taken as the 2nd dimension (interpreted as 1)
         self.assertRaises(TypeError, lambda: q.topk(4, True))
 
+    @unittest.skipIf(not TEST_NUMPY, 'Numpy not found')
+    def test_sort_topk_kthvalue_large(self):
+        # long slices take the radix select and parallel radix sort paths
+        for dtype in (torch.float, torch.double, torch.int32, torch.int64):
+            if dtype.is_floating_point:
+                x = torch.randn(200000, dtype=dtype)
+                x[::1000] = float('nan')
+                x[1::1000] = float('inf')
+            else:
+                x = torch.randint(-1000, 1000, (200000,), dtype=dtype)
+            # contiguous and strided slices
+            for t in (x, x.view(-1, 2)[:, 0]):
+                expected = torch.from_numpy(np.sort(t.numpy()))
+                values, indices = t.sort()
+                self.assertEqual(values, expected, atol=0, rtol=0, allow_inf=True)
+                self.assertEqual(t[indices], values, atol=0, rtol=0, allow_inf=True)
+                values, indices = t.sort(descending=True)
+                self.assertEqual(values, expected.flip(0), atol=0, rtol=0, allow_inf=True)
+                self.assertEqual(t[indices], values, atol=0, rtol=0, allow_inf=True)
+
+                for k in (1, 17, 5000):
+                    values, indices = t.topk(k)
+                    self.assertEqual(values, expected.flip(0)[:k], atol=0, rtol=0, allow_inf=True)
+                    self.assertEqual(t[indices], values, atol=0, rtol=0, allow_inf=True)
+                    values, indices = t.topk(k, largest=False, sorted=False)
+                    self.assertEqual(values.sort()[0], expected[:k], atol=0, rtol=0, allow_inf=True)
+                    self.assertEqual(t[indices], values, atol=0, rtol=0, allow_inf=True)
+
+                    value, index = t.kthvalue(k)
+                    self.assertEqual(value, expected[k - 1], atol=0, rtol=0, allow_inf=True)
+                    self.assertEqual(t[index], value, atol=0, rtol=0, allow_inf=True)
+
+        # sort keeps the relative order of equal elements
+        x = torch.randint(0, 3, (100000,)).half()
+        values, indices = x.sort()
+        for v in range(3):
+            equal_indices = indices[values == v]
+            self.assertTrue((equal_indices[1:] > equal_indices[:-1]).all())
+        x = torch.rand(100000) > 0.5
+        values, indices = x.sort(descending=True)
+        self.assertEqual(values, x[indices])
+        self.assertEqual(values.sum(), x.sum())
+        self.assertFalse(values[:int(x.sum())].logical_not().any())
+
     def test_median(self):
         for size in (155, 156):
             x = torch.rand(size, size)
@@ -2048,6 +2111,54 @@ class _TestTorchMixin(object):
     def test_fft_ifft_rfft_irfft(self):
         self._test_fft_ifft_rfft_irfft(self)
 
+    @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
+    def test_mkl_fft_plan_cache(self):
+        plan_cache = torch.backends.mkl.fft_plan_cache
+
+        @contextmanager
+        def plan_cache_max_size(n):
+            original = plan_cache.max_size
+            plan_cache.max_size = n
+            yield
+            plan_cache.max_size = original
+
+        with plan_cache_max_size(max(1, plan_cache.size - 10)):
+            self._test_fft_ifft_rfft_irfft(self)
+
+        with plan_cache_max_size(0):
+            self._test_fft_ifft_rfft_irfft(self)
+            self.assertEqual(plan_cache.size, 0)
+
+        plan_cache.clear()
+        self.assertEqual(plan_cache.size, 0)
+
+        # check that still works after clearing cache
+        with plan_cache_max_size(10):
+            self._test_fft_ifft_rfft_irfft(self)
+            self.assertLessEqual(plan_cache.size, 10)
+
+            plan_cache.clear()
+            plan_cache.reset_stats()
+            x = torch.randn(4, 16, dtype=torch.double)
+            expected = x.rfft(1)
+            for _ in range(3):
+                self.assertEqual(x.rfft(1), expected)
+            # the descriptor depends on the strides of the input
+            self.assertEqual(x.t().contiguous().t().rfft(1), expected)
+            self.assertEqual(plan_cache.stats(), {'hits': 2, 'misses': 2, 'evictions': 0})
+            self.assertEqual(plan_cache.size, 2)
+
+            for n in range(2, 14):
+                torch.randn(n, dtype=torch.double).rfft(1)
+            self.assertEqual(plan_cache.size, 10)
+            self.assertEqual(plan_cache.stats()['evictions'], 4)
+
+        with self.assertRaisesRegex(RuntimeError, r"must be non-negative"):
+            plan_cache.max_size = -1
+
+        with self.assertRaisesRegex(AttributeError, r"can't set attribute"):
+            plan_cache.size = -1
+
     @unittest.skip("Not implemented yet")
     def test_conv2(self):
         x = torch.rand(math.floor(torch.uniform(50, 100)), math.floor(torch.uniform(50, 100)))
@@ -2201,6 +2312,53 @@ class _TestTorchMixin(object):
         after = torch.rand(1000)
         self.assertEqual(before, after, 0)
 
+    def test_RNGState_parallel(self):
+        # large tensors are generated from Philox substreams, in parallel
+        # but independently of the number of threads
+        num_threads = torch.get_num_threads()
+        try:
+            results = []
+            for threads in [1, 4]:
+                torch.set_num_threads(threads)
+                torch.manual_seed(123)
+                results.append((torch.rand(300001), torch.randn(300001), torch.randn(300001, dtype=torch.double),
+                                torch.empty(300001).exponential_(), torch.randint(0, 100, (300001,)),
+                                torch.rand(5)))
+            for a, b in zip(*results):
+                self.assertEqual(a, b, atol=0, rtol=0)
+        finally:
+            torch.set_num_threads(num_threads)
+
+        state = torch.get_rng_state()
+        before = torch.randn(300001)
+        torch.set_rng_state(state)
+        self.assertEqual(before, torch.randn(300001), atol=0, rtol=0)
+
+    def test_reductions_parallel(self):
+        # reductions split their input independently of the number of threads
+        num_threads = torch.get_num_threads()
+        x = torch.rand(1000003)
+        y = torch.rand(3001, 337, dtype=torch.double)
+        try:
+            results = []
+            for threads in [1, 3, 4]:
+                torch.set_num_threads(threads)
+                results.append((x.sum(), y.sum(), y.sum(0), y.sum(1), y.t().sum(1),
+                                x.std(), x.var_mean(), y.std(0), x.norm()))
+            for result in results[1:]:
+                for a, b in zip(result, results[0]):
+                    self.assertEqual(a, b, atol=0, rtol=0)
+        finally:
+            torch.set_num_threads(num_threads)
+
+        # cascade summation keeps float sums accurate
+        ones = torch.ones(2 ** 25)
+        self.assertEqual(ones.sum().item(), 2 ** 25, atol=0, rtol=0)
+        self.assertEqual(x.sum().double(), x.double().sum(), atol=0, rtol=1e-6)
+        self.assertNotEqual(before, torch.randn(300001))
+        self.assertLess((before.mean()).abs(), 0.01)
+        self.assertLess((before.std() - 1).abs(), 0.01)
+
     def test_RNGStateAliasing(self):
         # Fork the random number stream at this point
         gen = torch.Generator()
@@ -3585,6 +3743,21 @@ class _TestTorchMixin(object):
         self.assertRaises(TypeError,
                           lambda: torch.isclose(x, x, torch.tensor(1.5), torch.tensor(1., requires_grad=True)).all())
 
+    def test_parsing_overloads_repeated(self):
+        # the matched overload is cached by argument kinds, so calls with
+        # different kinds must keep resolving to the right overload
+        x = torch.randn(3, 3)
+        for _ in range(3):
+            self.assertEqual(torch.clamp(x, min=-0.5), x.clamp_min(-0.5))
+            self.assertEqual(torch.where(x > 0, x, torch.zeros(())), x.relu())
+            self.assertEqual(torch.max(x, 1)[0], x.max(dim=1)[0])
+            self.assertEqual(torch.max(x, x), x)
+            self.assertEqual(torch.max(x), x.max())
+            self.assertEqual(torch.cumsum(x, torch.tensor(0)), torch.cumsum(x, 0))
+            self.assertRaises(TypeError, lambda: torch.cumsum(x, torch.tensor(0.)))
+            self.assertEqual(torch.add(x, 2), x + 2)
+            self.assertEqual(torch.add(x, torch.tensor(2.)), x + 2)
+
     def test_parsing_intlist(self):
         #  parse with integer variables
         self.assertEqual(torch.Size([3, 4]), torch.ones((torch.tensor(3), torch.tensor(4))).shape)
@@ -4490,6 +4663,27 @@ tensor([[[1., 1., 1.,  ..., 1., 1., 1.],
             torch.Tensor(bad_mock_seq)
         self.assertEqual(torch.Tensor([1.0, 2.0, 3.0]), torch.Tensor(good_mock_seq))
 
+    def test_tensor_from_buffer_sequence(self):
+        import array
+        # objects exposing the buffer protocol infer dtypes like the
+        # equivalent list of python scalars
+        for data in (array.array('d', [1.5, 2., 3.]), array.array('f', [1.5, 2., 3.]),
+                     array.array('b', [-1, 2, 3]), array.array('q', [1, 2, 2 ** 40]),
+                     bytearray(b'\x01\x02\xff'), memoryview(array.array('i', [4, 5, 6]))):
+            expected = torch.tensor(list(data))
+            actual = torch.tensor(data)
+            self.assertIs(expected.dtype, actual.dtype)
+            self.assertEqual(expected, actual)
+            for dtype in (torch.float64, torch.float32, torch.int32, torch.uint8, torch.bool):
+                self.assertEqual(torch.tensor(list(data), dtype=dtype), torch.tensor(data, dtype=dtype))
+        self.assertEqual(torch.tensor([]), torch.tensor(array.array('d')))
+
+        # the result does not alias the buffer
+        data = array.array('d', [1., 2.])
+        t = torch.tensor(data)
+        data[0] = 5.
+        self.assertEqual(t, torch.tensor([1., 2.], dtype=torch.get_default_dtype()))
+
     def test_comparison_ops(self):
         x = torch.randn(5, 5)
         y = torch.randn(5, 5)
@@ -4733,6 +4927,23 @@ tensor([[[1., 1., 1.,  ..., 1., 1., 1.],
     def test_parallel_info(self):
         torch.__config__.parallel_info()
 
+    def test_cpu_memory_stats(self):
+        was_enabled = torch.cpu.is_memory_stats_enabled()
+        torch.cpu.set_memory_stats_enabled(True)
+        try:
+            torch.cpu.reset_peak_memory_stats()
+            before = torch.cpu.memory_allocated()
+            x = torch.empty(1024, dtype=torch.uint8)
+            self.assertEqual(torch.cpu.memory_allocated(), before + 1024)
+            stats = torch.cpu.memory_stats()
+            self.assertGreaterEqual(stats["bucket_allocated_bytes.1024.current"], 1024)
+            self.assertIn({"address": x.data_ptr(), "size": 1024}, torch.cpu.memory_snapshot())
+            del x
+            self.assertEqual(torch.cpu.memory_allocated(), before)
+            self.assertGreaterEqual(torch.cpu.max_memory_allocated(), before + 1024)
+        finally:
+            torch.cpu.set_memory_stats_enabled(was_enabled)
+
     @slowTest
     def test_slow_test(self):
         # Just a smoketest to make sure our slowTest decorator works.
@@ -5211,6 +5422,53 @@ tensor([[[1., 1., 1.,  ..., 1., 1., 1.],
             model.weight.data = weight
             out = model(input)
 
+    def test_autocast_cpu(self):
+        a = torch.randn(8, 8)
+        b = torch.randn(8, 8)
+        self.assertFalse(torch.is_autocast_cpu_enabled())
+        with torch.cpu.amp.autocast():
+            self.assertTrue(torch.is_autocast_cpu_enabled())
+            self.assertFalse(torch.is_autocast_enabled())
+            # lower precision ops run in bfloat16
+            out = torch.mm(a, b)
+            self.assertEqual(out.dtype, torch.bfloat16)
+            with torch.cpu.amp.autocast(enabled=False):
+                self.assertEqual(out, torch.mm(a.bfloat16(), b.bfloat16()), atol=0, rtol=0)
+            # fp32 ops run in float32 on bfloat16 inputs
+            self.assertEqual(torch.exp(out).dtype, torch.float32)
+            self.assertEqual(torch.sum(out).dtype, torch.float32)
+            # promote ops run in the widest type of their inputs
+            self.assertEqual(torch.cat([out, a]).dtype, torch.float32)
+            self.assertEqual(torch.cat([out, out]).dtype, torch.bfloat16)
+            # other types are left alone
+            self.assertEqual(torch.mm(a.double(), b.double()).dtype, torch.double)
+            self.assertEqual(torch.sum(torch.ones(3, dtype=torch.int32)).dtype, torch.int64)
+        self.assertFalse(torch.is_autocast_cpu_enabled())
+
+    def test_autocast_cpu_cast_cache(self):
+        weight = torch.randn(8, 8, requires_grad=True)
+        x = torch.randn(8, 8)
+
+        def expected():
+            return torch.mm(x.bfloat16(), weight.detach().bfloat16())
+
+        # a cast made with grad mode off must not be reused with it on
+        with torch.no_grad(), torch.cpu.amp.autocast():
+            self.assertEqual(torch.mm(x, weight), expected(), atol=0, rtol=0)
+        for _ in range(2):
+            with torch.cpu.amp.autocast():
+                out = torch.mm(x, weight)
+            self.assertTrue(out.requires_grad)
+            self.assertEqual(out, expected(), atol=0, rtol=0)
+        out.float().sum().backward()
+        self.assertEqual(weight.grad, x.t().mm(torch.ones(8, 8)), atol=0.1, rtol=0.05)
+
+        # an in-place update of the weight invalidates its cached cast
+        with torch.no_grad():
+            weight.add_(1)
+        with torch.cpu.amp.autocast():
+            self.assertEqual(torch.mm(x, weight), expected(), atol=0, rtol=0)
+
 
 # Functions to test negative dimension wrapping
 METHOD = 1
@@ -6680,7 +6938,6 @@ class TestTorchDeviceType(TestCase):
         res2 = torch.cat((x, y), out=z)
         self.assertEqual(res1, res2)
 
-    @onlyCUDA
     def test_cat_preserve_channels_last(self, device):
         x = torch.randn((4, 3, 8, 8), device=device)
         y = torch.randn(x.shape, device=device)
@@ -6689,6 +6946,16 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(res1, res2)
         self.assertTrue(res2.is_contiguous(memory_format=torch.channels_last))
 
+    def test_cat_many_inputs(self, device):
+        for dtype in [torch.uint8, torch.half, torch.float, torch.double]:
+            inputs = [torch.randn(5, i % 7, 3, device=device).to(dtype) for i in range(1000)]
+            res = torch.cat(inputs, dim=1)
+            self.assertEqual(res.shape, (5, sum(i % 7 for i in range(1000)), 3))
+            offset = 0
+            for t in inputs:
+                self.assertEqual(res[:, offset:offset + t.size(1)], t)
+                offset += t.size(1)
+
     @onlyCUDA
     @deviceCountAtLeast(2)
     def test_cat_different_devices(self, devices):
@@ -6896,6 +7163,40 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(torch.matmul(matrices, matrices_inverse),
                          torch.eye(3, dtype=torch.float64).to(device).expand_as(matrices))
 
+    @skipCUDAIfNoMagma
+    @skipCPUIfNoLapack
+    @dtypes(torch.float, torch.double)
+    def test_linalg_small_matrices_batched(self, device, dtype):
+        from torch.testing._internal.common_utils import random_fullrank_matrix_distinct_singular_value
+
+        # Orders up to 8 take the unrolled kernels on CPU, and 9 takes LAPACK
+        for n in range(1, 10):
+            A = random_fullrank_matrix_distinct_singular_value(n, 37).to(device=device, dtype=dtype)
+            b = torch.randn(37, n, 2, dtype=dtype, device=device)
+            eye = torch.eye(n, dtype=dtype, device=device).expand_as(A)
+            self.assertEqual(torch.matmul(torch.inverse(A), A), eye, atol=1e-3, rtol=0)
+            x, _ = torch.solve(b, A)
+            self.assertEqual(torch.matmul(A, x), b, atol=1e-3, rtol=0)
+            LU_data, LU_pivots = torch.lu(A)
+            self.assertEqual(torch.matmul(A, torch.lu_solve(b, LU_data, LU_pivots)), b, atol=1e-3, rtol=0)
+
+            S = torch.matmul(A, A.transpose(-2, -1)) + eye
+            for upper in [True, False]:
+                L = torch.cholesky(S, upper=upper)
+                if upper:
+                    self.assertEqual(torch.matmul(L.transpose(-2, -1), L), S, atol=1e-3, rtol=0)
+                else:
+                    self.assertEqual(torch.matmul(L, L.transpose(-2, -1)), S, atol=1e-3, rtol=0)
+                x = torch.cholesky_solve(b, L, upper=upper)
+                self.assertEqual(torch.matmul(S, x), b, atol=1e-3, rtol=0)
+
+            # The first failing matrix of the batch is reported
+            singular = A.clone()
+            singular[5].zero_()
+            singular[7].zero_()
+            with self.assertRaisesRegex(RuntimeError, "For batch 5"):
+                torch.inverse(singular)
+
     @skipCUDAIfNoMagma
     @skipCPUIfNoLapack
     @dtypes(torch.double)
@@ -9037,6 +9338,20 @@ class TestTorchDeviceType(TestCase):
             for j in range(7):
                 self.assertEqual(xs[j].item(), size[1] - i)
 
+    @onlyCUDA
+    @dtypes(torch.half, torch.float, torch.double)
+    def test_reduction_vectorized_short_rows(self, device, dtype):
+        # Row-wise reductions over inner dims of at most 128 elements are
+        # vectorized with sub-warp groups of lanes per row
+        for inner in (16, 20, 64, 128):
+            x = torch.randint(-4, 4, (1000, inner + 1), dtype=dtype, device=device)
+            # unaligned rows and an unaligned start
+            for t in (x[:, :inner], x[:, 1:], x[:, :inner].contiguous()):
+                expected = t.double().cpu()
+                self.assertEqual(t.sum(dim=-1), expected.sum(dim=-1).to(dtype))
+                self.assertEqual(t.max(dim=-1).values, expected.max(dim=-1).values.to(dtype))
+                self.assertEqual(t.gather(-1, t.argmax(dim=-1, keepdim=True)).squeeze(-1),
+                                 expected.max(dim=-1).values.to(dtype))
 
     @slowTest
     def test_argminmax_large_axis(self, device):
@@ -10579,6 +10894,25 @@ class TestTorchDeviceType(TestCase):
             expected = self._brute_cdist(x, y, p=2)
             self.assertTrue(torch.allclose(expected, actual))
 
+    def test_cdist_topk(self, device):
+        # Spans several tiles along both dimensions of the distance matrix
+        for x_size, y_size, k in [((1100, 4), (5000, 4), 5), ((2, 3, 4), (2, 6000, 4), 4100), ((7, 4), (9, 4), 9)]:
+            x = torch.randn(x_size, device=device, dtype=torch.double)
+            y = torch.randn(y_size, device=device, dtype=torch.double)
+            for p in [1, 2]:
+                dist = torch.cdist(x, y, p=p)
+                values, indices = torch.cdist_topk(x, y, k, p=p)
+                self.assertEqual(values, dist.topk(k, largest=False).values)
+                self.assertEqual(dist.gather(-1, indices), values)
+
+        x = torch.randn(3, 4, device=device)
+        y = torch.randn(5, 4, device=device)
+        values, indices = torch.cdist_topk(x, y, 0)
+        self.assertEqual(values.shape, (3, 0))
+        self.assertEqual(indices.dtype, torch.long)
+        with self.assertRaisesRegex(RuntimeError, "must be in the range"):
+            torch.cdist_topk(x, y, 6)
+
     def test_cdist_non_contiguous(self, device):
         for cm in ['use_mm_for_euclid_dist', 'donot_use_mm_for_euclid_dist']:
             x = torch.randn(5, 7, device=device).transpose(-1, -2)
@@ -10969,6 +11303,70 @@ class TestTorchDeviceType(TestCase):
                                                        [0, 0, 0],
                                                        [0, 0, 0]]), expected_out)
 
+    @onlyCPU
+    def test_cumulative_ops_large_dim(self, device):
+        # Long scanned dimensions are split into blocks that are scanned in parallel
+        def reference(values, op):
+            result, indices = [], []
+            for i, v in enumerate(values):
+                if not result or op(v, result[-1]):
+                    result.append(v)
+                    indices.append(i)
+                else:
+                    result.append(result[-1])
+                    indices.append(indices[-1])
+            return result, indices
+
+        for shape, dim in [((200003,), 0), ((3, 70001), 1), ((70001, 3), 0), ((5, 20000), 0)]:
+            x = torch.randint(-1000, 1000, shape, device=device)
+            slices = x.transpose(dim, -1).reshape(-1, shape[dim]).tolist()
+            expected_sum = [list(itertools.accumulate(row)) for row in slices]
+            actual_sum = x.cumsum(dim).transpose(dim, -1).reshape(-1, shape[dim]).tolist()
+            self.assertEqual(actual_sum, expected_sum)
+
+            for op, cmp in [(torch.cummax, lambda a, b: a >= b), (torch.cummin, lambda a, b: a <= b)]:
+                values, indices = op(x, dim)
+                values = values.transpose(dim, -1).reshape(-1, shape[dim]).tolist()
+                indices = indices.transpose(dim, -1).reshape(-1, shape[dim]).tolist()
+                for row, v, i in zip(slices, values, indices):
+                    self.assertEqual((v, i), reference(row, cmp))
+
+            y = x.double().div_(1e5).add_(1)
+            self.assertEqual(y.cumprod(dim).log(), y.log().cumsum(dim), atol=1e-6, rtol=1e-6)
+            self.assertEqual(y.logcumsumexp(dim), y.exp().cumsum(dim).log(), atol=1e-6, rtol=1e-6)
+
+        x = torch.rand(200003, device=device)
+        self.assertEqual(x.cumsum(0)[-1], x.double().sum(), atol=1e-2, rtol=1e-6)
+        self.assertEqual(x.cumsum(0).double(), x.double().cumsum(0), atol=1e-2, rtol=1e-6)
+
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_logcumsumexp(self, device, dtype):
+        x = torch.randn(5, 4, 7, device=device, dtype=dtype)
+        for dim in range(x.dim()):
+            self.assertEqual(torch.logcumsumexp(x, dim), x.exp().cumsum(dim).log())
+            out = torch.empty(0, device=device, dtype=dtype)
+            torch.logcumsumexp(x, dim, out=out)
+            self.assertEqual(out, x.logcumsumexp(dim))
+            # stable for inputs whose exponentials overflow
+            self.assertEqual(torch.logcumsumexp(x + 1000, dim), torch.logcumsumexp(x, dim) + 1000)
+
+        x = torch.tensor([-inf, -inf, 0, inf, 1, nan, 2], device=device, dtype=dtype)
+        expected = torch.tensor([-inf, -inf, 0, inf, inf, nan, nan], device=device, dtype=dtype)
+        self.assertEqual(torch.logcumsumexp(x, 0), expected, allow_inf=True)
+
+        # Check the scalar and empty cases
+        self.assertEqual(torch.logcumsumexp(torch.tensor(3., device=device, dtype=dtype), 0), 3.)
+        self.assertEqual(torch.logcumsumexp(torch.empty(2, 0, device=device, dtype=dtype), 1).shape, (2, 0))
+
+        with self.assertRaisesRegex(RuntimeError, "expected a floating point input"):
+            torch.logcumsumexp(torch.arange(3, device=device), 0)
+
+        if dtype == torch.double:
+            x = torch.randn(3, 4, device=device, dtype=dtype, requires_grad=True)
+            torch.autograd.gradcheck(lambda x: x.logcumsumexp(1), (x,))
+            torch.autograd.gradgradcheck(lambda x: x.logcumsumexp(0), (x,))
+
     def test_std_mean(self, device):
         x = torch.rand(100, 50, 20, device=device)
         for dim in range(x.dim()):
@@ -11142,6 +11540,32 @@ class TestTorchDeviceType(TestCase):
             expanded = torch.randn(1, 5, 1, 2, device=device).expand(3, 5, 7, 2)
             test_against_np(expanded)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_histc_bincount_large(self, device, dtype):
+        # large enough for the inputs to be counted with per-thread histograms
+        n = 200003
+        x = torch.randn(n, device=device, dtype=dtype)
+        x[::1000] = 5
+        bins, lo, hi = 37, -2., 2.
+        bin_idx = ((x - lo) / (hi - lo) * bins).long().clamp(max=bins - 1)
+        in_range = (x >= lo) & (x <= hi)
+        expected = torch.bincount(bin_idx[in_range], minlength=bins).to(dtype)
+        self.assertEqual(torch.histc(x, bins=bins, min=lo, max=hi), expected, atol=0, rtol=0)
+        self.assertEqual(torch.histc(x, bins=bins).sum().item(), n)
+
+        idx = torch.randint(0, 101, (n,), device=device)
+        counts = torch.zeros(101, dtype=torch.long, device=device)
+        counts.index_add_(0, idx, torch.ones(n, dtype=torch.long, device=device))
+        self.assertEqual(torch.bincount(idx), counts, atol=0, rtol=0)
+
+        w = torch.rand(n, device=device, dtype=dtype)
+        expected = torch.zeros(101, dtype=torch.double, device=device)
+        expected.index_add_(0, idx, w.double())
+        actual = torch.bincount(idx, w)
+        self.assertEqual(actual.dtype, dtype)
+        self.assertEqual(actual, expected.to(dtype))
+
     def test_bool_tensor_comparison_ops(self, device):
         a = torch.tensor([True, False, True, False, True, False], dtype=torch.bool, device=device)
         b = torch.tensor([True, False, True, True, True, True], dtype=torch.bool, device=device)
@@ -11239,6 +11663,72 @@ class TestTorchDeviceType(TestCase):
         y = x.as_strided([2, 1, 5], [1, 0, 2])
         self.assertEqual(y, y.clone())
 
+    @dtypes(torch.float, torch.double, torch.long)
+    @dtypesIfCUDA(torch.float, torch.double, torch.half, torch.long)
+    def test_foreach_ops(self, device, dtype):
+        def make_tensors():
+            # many small tensors, an empty one, and one past a kernel chunk
+            shapes = [(3, 4)] * 20 + [(0,), (70000,)]
+            return [torch.randint(1, 10, shape, device=device).to(dtype) for shape in shapes]
+
+        xs, ys, zs = make_tensors(), make_tensors(), make_tensors()
+        for op in ('add', 'sub', 'mul'):
+            self.assertEqual(getattr(torch, '_foreach_' + op)(xs, 2),
+                             [getattr(x, op)(2) for x in xs])
+            self.assertEqual(getattr(torch, '_foreach_' + op)(xs, ys),
+                             [getattr(x, op)(y) for x, y in zip(xs, ys)])
+        self.assertEqual(torch._foreach_add(xs, ys, alpha=3), [x.add(y, alpha=3) for x, y in zip(xs, ys)])
+        if dtype.is_floating_point:
+            self.assertEqual(torch._foreach_div(xs, ys), [x / y for x, y in zip(xs, ys)])
+            self.assertEqual(torch._foreach_sqrt(xs), [x.sqrt() for x in xs])
+            self.assertEqual(torch._foreach_addcdiv(xs, ys, zs, value=0.5),
+                             [x.addcdiv(y, z, value=0.5) for x, y, z in zip(xs, ys, zs)])
+        self.assertEqual(torch._foreach_addcmul(xs, ys, zs, value=2),
+                         [x.addcmul(y, z, value=2) for x, y, z in zip(xs, ys, zs)])
+
+        # in-place, including non-contiguous tensors that run op by op
+        expected = [x.mul(y).add(1) for x, y in zip(xs, ys)]
+        self_ = [x.clone() for x in xs]
+        self_[0] = xs[0].t().clone().t()
+        versions = [t._version for t in self_]
+        torch._foreach_mul_(self_, ys)
+        torch._foreach_add_(self_, 1)
+        self.assertEqual(self_, expected)
+        self.assertEqual([t._version for t in self_], [v + 2 for v in versions])
+
+        with self.assertRaisesRegex(RuntimeError, "same number of tensors"):
+            torch._foreach_add(xs, ys[:-1])
+        with self.assertRaises(RuntimeError):
+            torch._foreach_add([], 1)
+
+    def test_lazy_clone(self, device):
+        x = torch.randn(4, 3, device=device)
+        expected = x.clone()
+        y = torch._lazy_clone(x)
+        self.assertEqual(x, y)
+        if self.device_type == 'cpu':
+            self.assertEqual(x.data_ptr(), y.data_ptr())
+
+        # writes to either tensor leave the other as it was
+        y.add_(1)
+        self.assertEqual(x, expected)
+        self.assertEqual(y, expected + 1)
+        self.assertNotEqual(x.data_ptr(), y.data_ptr())
+
+        z = torch._lazy_clone(x)
+        torch.mul(x, 2, out=x)
+        self.assertEqual(z, expected)
+        self.assertEqual(x, expected * 2)
+
+        # writes through views, and autograd
+        w = torch._lazy_clone(z)
+        w[0].zero_()
+        self.assertEqual(z, expected)
+        self.assertEqual(w[0], torch.zeros(3, device=device))
+        a = torch.randn(3, device=device, requires_grad=True)
+        torch._lazy_clone(a).sum().backward()
+        self.assertEqual(a.grad, torch.ones(3, device=device))
+
     def test_cat_all_dtypes_and_devices(self, device):
         for dt in torch.testing.get_all_dtypes():
             x = torch.tensor([[1, 2], [3, 4]], dtype=dt, device=device)
@@ -11753,6 +12243,33 @@ class TestTorchDeviceType(TestCase):
                                             [False, True, False, True, False],
                                             [True, False, True, False, True]], device=device))
 
+    def test_scatter_gather_expanded_index(self, device):
+        # an index expanded over the last dimension selects contiguous rows
+        src = torch.randn(1000, 16, device=device)
+        index = torch.randint(0, 10, (1000, 1), device=device).expand(-1, 16)
+        expected = torch.zeros(10, 16, dtype=torch.double, device=device)
+        for i, j in enumerate(index[:, 0].tolist()):
+            expected[j] += src[i].double()
+        res = torch.zeros(10, 16, device=device).scatter_add_(0, index, src)
+        self.assertEqual(res.double(), expected, prec=1e-4)
+        self.assertEqual(res.gather(0, index), res[index[:, 0]])
+
+    @onlyCPU
+    def test_scatter_reduce(self, device):
+        src = torch.tensor([[1., 2.], [3., -4.], [5., 6.], [float('nan'), 0.]], device=device)
+        index = torch.tensor([[0, 0], [2, 2], [0, 2], [3, 0]], device=device)
+        self.assertEqual(torch._scatter_reduce(src, 0, index, "sum"),
+                         torch.tensor([[6., 2.], [0., 0.], [3., 2.], [float('nan'), 0.]]))
+        self.assertEqual(torch._scatter_reduce(src, 0, index, "mean", output_size=5),
+                         torch.tensor([[3., 1.], [0., 0.], [3., 1.], [float('nan'), 0.], [0., 0.]]))
+        self.assertEqual(torch._scatter_reduce(src, 0, index, "max"),
+                         torch.tensor([[5., 2.], [0., 0.], [3., 6.], [float('nan'), 0.]]))
+        self.assertEqual(torch._scatter_reduce(src, 0, index, "min"),
+                         torch.tensor([[1., 0.], [0., 0.], [3., -4.], [float('nan'), 0.]]))
+        self.assertEqual(torch._scatter_reduce(index, 1, index, "max"),
+                         torch.tensor([[0, 0, 0, 0], [0, 0, 2, 0], [0, 0, 2, 0], [0, 0, 0, 3]]))
+        self.assertRaises(RuntimeError, lambda: torch._scatter_reduce(src, 0, index, "prod"))
+
     def test_masked_scatter_bool_tensor(self, device):
         src = torch.tensor([True, True, True], device=device)
         dst = torch.tensor([False, False, False], device=device)
@@ -13504,6 +14021,33 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(top1, top2)
         self.assertEqual(idx1, idx2)
 
+    @onlyCUDA
+    @dtypes(torch.half, torch.float, torch.double, torch.uint8, torch.int32, torch.int64)
+    def test_sort_topk_many_long_rows(self, device, dtype):
+        # slices longer than the in-place bitonic sort handles take the
+        # segmented radix sort, or the device-wide one for a single slice
+        for rows, cols in [(300, 5000), (1, 100000), (3, 70000)]:
+            if dtype.is_floating_point:
+                x = torch.randn(rows, cols, device=device, dtype=dtype)
+                x[:, ::1000] = float('nan')
+                x[:, 1::1000] = float('inf')
+            else:
+                x = torch.randint(0, 100, (rows, cols), device=device, dtype=dtype)
+            x_cpu = x.cpu().double() if dtype == torch.half else x.cpu()
+            for t, t_cpu, dim in [(x, x_cpu, 1), (x.t(), x_cpu.t(), 0)]:
+                for descending in [False, True]:
+                    values, indices = t.sort(dim, descending=descending)
+                    expected = t_cpu.sort(dim, descending=descending)[0]
+                    self.assertEqual(values.cpu().to(expected.dtype), expected, atol=0, rtol=0, allow_inf=True)
+                    self.assertEqual(t.gather(dim, indices), values, atol=0, rtol=0, allow_inf=True)
+                    self.assertEqual(t.argsort(dim, descending=descending), indices)
+
+                k = min(3000, cols)
+                values, indices = t.topk(k, dim)
+                expected = t_cpu.sort(dim, descending=True)[0].narrow(dim, 0, k)
+                self.assertEqual(values.cpu().to(expected.dtype), expected, atol=0, rtol=0, allow_inf=True)
+                self.assertEqual(t.gather(dim, indices), values, atol=0, rtol=0, allow_inf=True)
+
     @dtypes(torch.int8, torch.uint8, torch.int16, torch.int32, torch.int64)
     def test_topk_integral(self, device, dtype):
         a = torch.randint(torch.iinfo(dtype).min, torch.iinfo(dtype).max, size=(10,),
@@ -13885,6 +14429,17 @@ class TestTorchDeviceType(TestCase):
                                     count += 1
                             self.assertEqual(j, count)
 
+    def test_unique_large_input(self, device):
+        # large enough to be split across threads on CPU
+        x = torch.randint(0, 5000, (200000,), device=device)
+        for sort in [True, False]:
+            output, inverse, counts = torch.unique(x, sorted=sort, return_inverse=True, return_counts=True)
+            if sort:
+                self.assertEqual(output, torch.arange(5000, device=device))
+            self.assertEqual(output[inverse], x)
+            self.assertEqual(counts, torch.bincount(x, minlength=5000)[output])
+            self.assertEqual(counts.sum(), x.numel())
+
     @dtypes(*set(torch.testing.get_all_dtypes()) - {torch.bfloat16, torch.complex64, torch.complex128})
     def test_unique_consecutive(self, device, dtype):
         if dtype is torch.half and self.device_type == 'cpu':
@@ -13963,6 +14518,28 @@ class TestTorchDeviceType(TestCase):
         z = from_dlpack(to_dlpack(x))
         self.assertEqual(z, x)
 
+    @onlyCPU
+    @unittest.skipIf(not TEST_PYARROW, "PyArrow not found")
+    def test_from_arrow(self, device):
+        import pyarrow
+        from torch.utils.arrow import from_arrow
+        from torch.utils.data._utils.collate import default_convert
+
+        values = pyarrow.array([1.5, 2.5, 3.5, 4.5], type=pyarrow.float32())
+        x = from_arrow(values)
+        self.assertEqual(x, torch.tensor([1.5, 2.5, 3.5, 4.5]))
+        self.assertEqual(x.data_ptr(), values.buffers()[1].address)
+        self.assertEqual(from_arrow(values[1:3]), torch.tensor([2.5, 3.5]))
+
+        batch = pyarrow.RecordBatch.from_arrays(
+            [values, pyarrow.array([1, 2, 3, 4], type=pyarrow.int64())], ['a', 'b'])
+        converted = default_convert(batch)
+        self.assertEqual(converted['a'], x)
+        self.assertEqual(converted['b'], torch.tensor([1, 2, 3, 4]))
+
+        with self.assertRaisesRegex(RuntimeError, "nulls"):
+            from_arrow(pyarrow.array([1.0, None], type=pyarrow.float64()))
+
     @onlyCUDA
     @unittest.skipIf(PYTORCH_CUDA_MEMCHECK, "is_pinned uses failure to detect pointer property")
     def test_pin_memory_from_constructor(self, device):
@@ -14391,6 +14968,11 @@ class TestTorchDeviceType(TestCase):
         l = torch.randn(5, 10, dtype=dtype, device=device)
         r = torch.randn(5, 20, dtype=dtype, device=device)
         w = torch.randn(30, 10, 20, dtype=dtype, device=device)
+        M = torch.randn(3, 20, dtype=dtype, device=device)
+        N = torch.randn(20, 4, dtype=dtype, device=device)
+        O = torch.randn(4, 30, dtype=dtype, device=device)
+        P = torch.randn(30, 6, dtype=dtype, device=device)
+        Q = torch.randn(5, 4, dtype=dtype, device=device)
         test_list = [
             # -- Vector
             ("i->", x),                 # sum
@@ -14424,6 +15006,10 @@ class TestTorchDeviceType(TestCase):
             ("...ii->...i", I),       # batch diagonal
             # -- Other
             ("bn,anm,bm->ba", l, w, r),  # as torch.bilinear
+            ("ij,jk,kl,lm->im", M, N, O, P),     # matrix chain, not contracted left to right
+            ("ij,jk,kl,lm->im", M, N, O.t().contiguous().t(), P.t().contiguous().t()),  # transposed operands
+            ("ab,cd,bc,de->ae", B, O, Q, P),  # pairs not adjacent in the equation
+            ("aij,ajk,ak->ai", C, D, D[:, 0]),     # batched, with a dimension shared by three operands
             ("... ii->...i  ", I),       # batch diagonal with spaces
         ]
         for test in test_list:
@@ -15693,6 +16279,49 @@ scipy_lobpcg  | {:10.2e}  | {:10.2e}  | {:6} | N/A
 
             _test_mm(n, m, p, dtype, genf)
 
+    @onlyOnCPUAndCUDA
+    @dtypes(torch.float32, torch.float64)
+    @dtypesIfCUDA(torch.float32, torch.float64, torch.half)
+    def test_grouped_mm(self, device, dtype):
+        # (m, k, n) per pair: varying m as in grouped linear layers, empty
+        # products, k == 0, and one pair large enough to bypass the grouped
+        # kernel on CUDA
+        shapes = [(5, 7, 3), (1, 7, 3), (130, 20, 70), (0, 4, 6), (3, 0, 2),
+                  (17, 33, 65), (300, 300, 300)]
+        lhs = [torch.randn(m, k, device=device, dtype=dtype) for m, k, n in shapes]
+        rhs = [torch.randn(k, n, device=device, dtype=dtype) for m, k, n in shapes]
+        # non-contiguous inputs
+        lhs[1] = lhs[1].t().contiguous().t()
+        rhs[2] = torch.randn(70, 20, device=device, dtype=dtype).t()
+
+        res = torch._grouped_mm(lhs, rhs)
+        self.assertEqual(len(res), len(shapes))
+        for a, b, r in zip(lhs, rhs, res):
+            expected = torch.mm(a.double(), b.double())
+            tol = 1e-2 if dtype == torch.half else 1e-5
+            self.assertEqual(r, expected.to(dtype), atol=tol, rtol=tol)
+
+        self.assertEqual(torch._grouped_mm([], []), [])
+        with self.assertRaisesRegex(RuntimeError, "as many matrices"):
+            torch._grouped_mm(lhs, rhs[:-1])
+        with self.assertRaisesRegex(RuntimeError, "size mismatch"):
+            torch._grouped_mm([lhs[0]], [rhs[1].t()])
+        with self.assertRaisesRegex(RuntimeError, "2-d"):
+            torch._grouped_mm([lhs[0][0]], [rhs[0]])
+
+        if dtype == torch.half:
+            return
+        lhs = [t.detach().requires_grad_() for t in lhs[:3]]
+        rhs = [t.detach().requires_grad_() for t in rhs[:3]]
+        # leave the gradient of the second product undefined
+        res = torch._grouped_mm(lhs, rhs)
+        (res[0].sum() + res[2].sum() * 2).backward()
+        lhs_ref = [t.detach().requires_grad_() for t in lhs]
+        rhs_ref = [t.detach().requires_grad_() for t in rhs]
+        (torch.mm(lhs_ref[0], rhs_ref[0]).sum() + torch.mm(lhs_ref[2], rhs_ref[2]).sum() * 2).backward()
+        for t, ref in zip(lhs + rhs, lhs_ref + rhs_ref):
+            self.assertEqual(t.grad, ref.grad)
+
     @onlyCPU
     @dtypes(torch.float)
     def test_bmm(self, device, dtype):
@@ -16609,6 +17238,34 @@ scipy_lobpcg  | {:10.2e}  | {:10.2e}  | {:6} | N/A
         test_output_dtype(torch.int32, False)
         test_output_dtype(torch.int64, True)
 
+    @dtypes(torch.int8, torch.int16, torch.int64, torch.float, torch.double)
+    def test_bucketization_many_values(self, device, dtype):
+        def reference(boundaries, values, right):
+            # the number of boundaries before every value
+            if right:
+                before = ~(values.unsqueeze(-1) < boundaries.unsqueeze(-2))
+            else:
+                before = ~(boundaries.unsqueeze(-2) >= values.unsqueeze(-1))
+            return before.sum(-1)
+
+        for num_boundaries in (1, 7, 16, 33, 64, 65, 300):
+            boundaries = torch.randint(-100, 100, (num_boundaries,), device=device).to(dtype).sort()[0]
+            values = torch.randint(-110, 110, (1003,), device=device).to(dtype)
+            if dtype.is_floating_point:
+                values[::50] = float('nan')
+            for right in (False, True):
+                expected = reference(boundaries, values, right)
+                self.assertEqual(torch.bucketize(values, boundaries, right=right), expected)
+                self.assertEqual(torch.bucketize(values, boundaries, right=right, out_int32=True),
+                                 expected.int())
+
+            # every row of values is searched in its own row of boundaries
+            boundaries = torch.randint(-100, 100, (5, 3, num_boundaries), device=device).to(dtype).sort()[0]
+            values = torch.randint(-110, 110, (5, 3, 13), device=device).to(dtype)
+            for right in (False, True):
+                expected = reference(boundaries, values, right)
+                self.assertEqual(torch.searchsorted(boundaries, values, right=right), expected)
+
     def test_pickle_gradscaler(self, device):
         # This test is not in test_cuda.py because it should pass in 3 cases:
         #  1. cuda is not available.
@@ -16808,6 +17465,52 @@ class TestDevicePrecision(TestCase):
 
         self.assertEqual(out_cpu, out_gpu, atol=1e-2)
 
+    @onlyCPU
+    def test_half_vectorized_ops(self, device):
+        # Sizes cover full vectors of every width and a partial tail.
+        for n in (7, 16, 33, 100):
+            x = torch.randn(n, device=device)
+            y = torch.randn(n, device=device)
+            xh, yh = x.half(), y.half()
+            self.assertEqual(xh.float(), x, atol=1e-3, rtol=1e-3)
+            self.assertEqual(torch.empty_like(x).copy_(xh), xh.float(), atol=0, rtol=0)
+            self.assertEqual(xh[::2].float(), x[::2].half().float(), atol=0, rtol=0)
+            self.assertEqual(torch.add(xh, yh, alpha=2).float(),
+                             xh.float() + 2 * yh.float(), atol=1e-2, rtol=1e-2)
+            self.assertEqual((xh * yh).float(), xh.float() * yh.float(), atol=1e-2, rtol=1e-2)
+            self.assertEqual(xh.abs().sum().float(), xh.float().abs().sum(), atol=1e-1, rtol=1e-2)
+            for op in (torch.exp, torch.sigmoid, torch.tanh, torch.floor):
+                self.assertEqual(op(xh).float(), op(xh.float()), atol=1e-2, rtol=1e-2)
+
+    @onlyCUDA
+    @dtypes(torch.half, torch.float, torch.double)
+    def test_index_add_duplicate_indices(self, device, dtype):
+        # Many duplicates take the sort-based path of index_add_, and
+        # deterministic mode takes it for any indices.
+        for num_indices, deterministic in [(2000, False), (100, True), (2000, True)]:
+            for dim in range(3):
+                sizes = [4, 5, 6]
+                num_dests = sizes[dim]
+                source_sizes = list(sizes)
+                source_sizes[dim] = num_indices
+                source = torch.randn(source_sizes, dtype=dtype, device=device)
+                index = torch.randint(num_dests, (num_indices,), device=device)
+                dest = torch.randn(sizes, dtype=dtype, device=device)
+                prev = torch.is_deterministic()
+                torch.set_deterministic(deterministic)
+                try:
+                    actual = dest.clone().index_add_(dim, index, source)
+                    if deterministic:
+                        self.assertEqual(dest.clone().index_add_(dim, index, source), actual, atol=0, rtol=0)
+                    # non-contiguous destination
+                    actual_t = dest.clone().transpose(0, 2).index_add_(2 - dim, index, source.transpose(0, 2))
+                finally:
+                    torch.set_deterministic(prev)
+                expected = dest.double().cpu().index_add_(dim, index.cpu(), source.double().cpu())
+                atol = 1e-1 if dtype == torch.half else 1e-5
+                self.assertEqual(actual.double().cpu(), expected, atol=atol, rtol=0)
+                self.assertEqual(actual_t.transpose(0, 2).double().cpu(), expected, atol=atol, rtol=0)
+
     @skipCUDAIfRocm
     @dtypes(torch.double)
     def test_sum_noncontig(self, device, dtype):
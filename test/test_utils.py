@@ -201,6 +201,55 @@ class TestCheckpoint(TestCase):
         with self.assertRaises(TypeError):
             checkpoint_sequential(model, 1)
 
+    def test_checkpoint_non_reentrant(self):
+        model = nn.Sequential(
+            nn.Linear(20, 30),
+            nn.ReLU(),
+            nn.Dropout(),
+            nn.Linear(30, 10),
+            nn.Tanh(),
+        )
+        x = torch.randn(8, 20)
+
+        torch.manual_seed(0)
+        model(x).sum().backward()
+        expected = [p.grad.clone() for p in model.parameters()]
+        model.zero_grad()
+
+        # Inputs that do not require grad and torch.autograd.grad work, and
+        # the recomputation sees the same dropout mask.
+        torch.manual_seed(0)
+        out = checkpoint(model, x, use_reentrant=False)
+        grads = torch.autograd.grad(out.sum(), list(model.parameters()))
+        self.assertEqual(grads, expected)
+
+        # Each saved tensor is recomputed on first use only.
+        calls = [0]
+
+        def run(inp):
+            calls[0] += 1
+            return model[3](model[1](model[0](inp))).exp()
+
+        torch.manual_seed(0)
+        out = checkpoint(run, x, use_reentrant=False)
+        self.assertEqual(calls[0], 1)
+        out.sum().backward(retain_graph=True)
+        self.assertEqual(calls[0], 2)
+        out.sum().backward()
+        self.assertEqual(calls[0], 3)
+
+    def test_checkpoint_non_reentrant_nondeterministic(self):
+        x = torch.randn(5, requires_grad=True)
+        calls = [0]
+
+        def run(inp):
+            calls[0] += 1
+            return inp.exp() if calls[0] == 1 else inp.clone()
+
+        out = checkpoint(run, x, use_reentrant=False)
+        with self.assertRaisesRegex(RuntimeError, "not deterministic"):
+            out.sum().backward()
+
     def test_checkpoint_rng_cpu(self):
         for _ in range(5):
             inp = torch.randn(20000, device='cpu').requires_grad_()
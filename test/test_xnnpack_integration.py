@@ -658,6 +658,40 @@ class TestXNNPACKRewritePass(TestCase):
             prepack_removal=True,
             fuse_clamping_ops=True)
 
+    def test_channels_last_conversions(self):
+        class M(torch.nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.conv1 = torch.nn.Conv2d(3, 8, 3)
+                self.conv2 = torch.nn.Conv2d(8, 8, 3, padding=1, groups=8)
+                self.conv3 = torch.nn.Conv2d(8, 16, 1)
+                self.linear = torch.nn.Linear(16, 4)
+
+            def forward(self, x):
+                y = F.hardswish(self.conv1(x))
+                y = F.max_pool2d(F.relu(self.conv2(y)) + y, 2)
+                y = F.adaptive_avg_pool2d(torch.clamp(self.conv3(y), 0, 6), 1)
+                return self.linear(torch.flatten(y, 1))
+
+        scripted_model = torch.jit.script(M())
+        scripted_model.eval()
+        input_data = torch.rand((2, 3, 16, 16))
+        ref_result = scripted_model(input_data)
+
+        optimized_model = torch.jit._recursive.wrap_cpp_module(
+            torch._C._jit_pass_optimize_for_mobile(scripted_model._c))
+        graph = optimized_model.graph
+        # The input of the first convolution is converted to channels last, and
+        # the activations back only where they leave the convolutions, at flatten.
+        FileCheck().check("aten::contiguous").check("prepacked::conv2d_clamp_run") \
+            .check("aten::hardswish").check("prepacked::conv2d_clamp_run") \
+            .check("aten::max_pool2d").check("prepacked::conv2d_clamp_run") \
+            .check("aten::adaptive_avg_pool2d").check("aten::contiguous") \
+            .check("aten::flatten").run(graph)
+        FileCheck().check_count("aten::contiguous", 2, exactly=True).run(graph)
+        xnnpack_result = optimized_model(input_data)
+        torch.testing.assert_allclose(ref_result, xnnpack_result, rtol=1e-2, atol=1e-3)
+
     def test_decomposed_linear(self):
         data_shape = [2, 32]
         weight_output_dim = 24
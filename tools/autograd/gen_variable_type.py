@@ -1051,6 +1051,24 @@ def emit_body(declaration):
             return []
         return ['increment_version({});'.format(arg['name']) for arg in differentiable_outputs]
 
+    def emit_increment_version_of_tensor_lists():
+        # In-place ops on tensor lists return nothing, so emit_increment_version
+        # has no outputs to bump the version of.
+        if not inplace or differentiable_outputs:
+            return []
+        return ['increment_version({});'.format(arg['name']) for arg in arguments
+                if arg['type'] == 'TensorList' and arg['name'] == 'self']
+
+    def emit_materialize_cow():
+        # Arguments that share their storage copy-on-write need a private copy
+        # of it before they are written to, whether they are differentiable or not.
+        if not modifies_arguments:
+            return []
+        written = [arg for arg in arguments
+                   if arg['type'] in ('Tensor &', 'TensorList') and
+                   (arg.get('output', False) or (inplace and arg['name'] == 'self'))]
+        return ['materialize_cow({});'.format(arg['name']) for arg in written]
+
     env = {}
     combined = nested_dict(env, declaration)
 
@@ -1060,12 +1078,14 @@ def emit_body(declaration):
     if requires_derivative:
         body.extend(emit_check_inplace())
         body.extend(setup_derivative(differentiable_inputs))
+    body.extend(emit_materialize_cow())
     body.append(declare_returned_variables())
 
     pre_record_trace, post_record_trace = format_trace(declaration)
 
     body.append(pre_record_trace)
     body.append(emit_call(env))
+    body.extend(emit_increment_version_of_tensor_lists())
     if requires_derivative:
         # set_flags has to appear after version_counter, because rebase_history
         # requires that the counter is incremented before it is called
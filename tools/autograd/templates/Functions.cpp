@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <numeric>
 #include <functional>
+#include <limits>
 
 // ${generated_comment}
 
@@ -477,6 +478,25 @@ Tensor logsumexp_backward(Tensor grad, const Tensor & self, Tensor result, IntAr
   return grad * (self - result).exp();
 }
 
+Tensor logcumsumexp_backward(const Tensor& grad, const Tensor& self, const Tensor& result, int64_t dim) {
+  if (self.dim() == 0) {
+    return grad;
+  }
+  // grad_self[i] = sum_{j >= i} grad[j] * exp(self[i] - result[j]), computed
+  // in log space for the positive and the negative parts of grad, where the
+  // sum over j >= i is a logcumsumexp of the reversed dimension.
+  auto reverse_logcumsumexp = [dim](const Tensor& x) {
+    return at::flip(at::logcumsumexp(at::flip(x, {dim}), dim), {dim});
+  };
+  auto neg_inf = at::scalar_tensor(-std::numeric_limits<double>::infinity(), grad.options());
+  auto log_abs_grad = grad.abs().log();
+  auto log_grad_positive = at::where(grad > 0, log_abs_grad, neg_inf);
+  auto log_grad_negative = at::where(grad < 0, log_abs_grad, neg_inf);
+  auto output_positive = (reverse_logcumsumexp(log_grad_positive - result) + self).exp();
+  auto output_negative = (reverse_logcumsumexp(log_grad_negative - result) + self).exp();
+  return output_positive - output_negative;
+}
+
 Tensor unbind_backward(const variable_list& grads, int64_t dim) {
   IntArrayRef sizes;
   at::TensorOptions o;
@@ -534,6 +554,44 @@ std::vector<Tensor> cat_tensors_backward(const Tensor & grad, const std::vector<
   return grad_inputs;
 }
 
+// Computes grads[i] @ other[i].t() (or other[i].t() @ grads[i] if !grad_first)
+// for each defined grad with a single _grouped_mm call; results for undefined
+// grads are left undefined.
+static std::vector<Tensor> grouped_mm_backward(const variable_list& grads, const std::vector<Tensor>& other, bool grad_first) {
+  std::vector<Tensor> lhs, rhs;
+  std::vector<size_t> index;
+  for (size_t i = 0; i < grads.size(); ++i) {
+    if (!grads[i].defined()) {
+      continue;
+    }
+    if (grad_first) {
+      lhs.push_back(grads[i]);
+      rhs.push_back(other[i].t());
+    } else {
+      lhs.push_back(other[i].t());
+      rhs.push_back(grads[i]);
+    }
+    index.push_back(i);
+  }
+  std::vector<Tensor> grad_inputs(grads.size());
+  if (index.empty()) {
+    return grad_inputs;
+  }
+  auto products = at::_grouped_mm(lhs, rhs);
+  for (size_t j = 0; j < index.size(); ++j) {
+    grad_inputs[index[j]] = products[j];
+  }
+  return grad_inputs;
+}
+
+std::vector<Tensor> grouped_mm_backward_self(const variable_list& grads, const std::vector<Tensor>& mat2) {
+  return grouped_mm_backward(grads, mat2, /*grad_first=*/true);
+}
+
+std::vector<Tensor> grouped_mm_backward_mat2(const variable_list& grads, const std::vector<Tensor>& self) {
+  return grouped_mm_backward(grads, self, /*grad_first=*/false);
+}
+
 Tensor clamp_backward(const Tensor & grad, const Tensor &self, const optional<Scalar> & min, const optional<Scalar> & max) {
   // clamp: gradients not defined on min and max, so we return the subgradient 1 for these cases.
   if (max && min) {
@@ -2516,6 +2574,83 @@ infinitely_differentiable_native_layer_norm_backward(
   return std::make_tuple(dX, dgamma, dbeta);
 }
 
+std::tuple<Tensor, Tensor, Tensor>
+infinitely_differentiable_native_group_norm_backward(
+    const Tensor& dY,
+    const Tensor& dmean,
+    const Tensor& drstd,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps,
+    std::array<bool, 3> grad_input_mask) {
+  const int64_t G = group;
+  const int64_t D = C / G;
+  const double s = 1.0 / static_cast<double>(D * HxW);
+  Tensor X_tensor = X.reshape({N, G, D, HxW});
+  Tensor mean_tensor = mean.reshape({N, G, 1, 1});
+  Tensor rstd_tensor = rstd.reshape({N, G, 1, 1});
+  Tensor dY_tensor;
+  Tensor gamma_tensor;
+  if (dY.defined()) {
+    dY_tensor = dY.reshape({N, G, D, HxW});
+  }
+  if (gamma.defined()) {
+    gamma_tensor = gamma.reshape({1, G, D, 1});
+  }
+
+  Tensor dX;
+  if (grad_input_mask[0]) {
+    Tensor var;
+    Tensor dvar;
+    if (drstd.defined()) {
+      var = ((rstd_tensor * rstd_tensor).reciprocal_() - eps).clamp_min(0).reshape({N * G, 1});
+      dvar = (-0.5 * rstd_tensor * rstd_tensor * rstd_tensor * drstd.view({N, G, 1, 1})).reshape({N * G, 1});
+    }
+    if (dY.defined()) {
+      const Tensor dY_gamma = gamma.defined() ? dY_tensor * gamma_tensor : dY_tensor;
+      const Tensor ds = (dY_gamma * X_tensor).sum({2, 3}, true);
+      const Tensor db = dY_gamma.sum({2, 3}, true);
+      const Tensor b = (db * mean_tensor - ds) * rstd_tensor * rstd_tensor * rstd_tensor * s;
+      const Tensor c = -b * mean_tensor - db * rstd_tensor * s;
+      dX = rstd_tensor * dY_gamma + b * X_tensor + c;
+    }
+    if (dmean.defined() && drstd.defined()) {
+      Tensor dX_stats = var_std_mean_backward(
+          {dvar, dmean.reshape({N * G, 1})},
+          X_tensor.reshape({N * G, D * HxW}),
+          var,
+          mean_tensor.reshape({N * G, 1}),
+          {1},
+          false,
+          true,
+          false).reshape({N, G, D, HxW});
+      dX = dX.defined() ? dX + dX_stats : dX_stats;
+    }
+    if (dX.defined()) {
+      dX = dX.reshape_as(X);
+    }
+  }
+
+  Tensor dgamma;
+  Tensor dbeta;
+  if (grad_input_mask[1] && dY.defined()) {
+    dgamma = (dY_tensor * (X_tensor - mean_tensor) * rstd_tensor)
+                 .sum({0, 3})
+                 .reshape({C});
+  }
+  if (grad_input_mask[2] && dY.defined()) {
+    dbeta = dY_tensor.sum({0, 3}).reshape({C});
+  }
+
+  return std::make_tuple(dX, dgamma, dbeta);
+}
+
 std::tuple<Tensor, Tensor, Tensor> _trilinear_backward(const Tensor& grad_out, const Tensor& i1, const Tensor& i2, const Tensor& i3,
                                                        IntArrayRef expand1, IntArrayRef expand2, IntArrayRef expand3,
                                                        IntArrayRef sumdim, int64_t unroll_dim, std::array<bool, 3> grad_mask) {
@@ -34,7 +34,7 @@ __all__ = [
     'ShortStorage', 'CharStorage', 'ByteStorage', 'BoolStorage',
     'DoubleTensor', 'FloatTensor', 'LongTensor', 'IntTensor',
     'ShortTensor', 'CharTensor', 'ByteTensor', 'BoolTensor', 'Tensor',
-    'lobpcg',
+    'lobpcg', 'set_deterministic', 'is_deterministic',
 ]
 
 ################################################################################
@@ -266,6 +266,29 @@ def set_default_dtype(d):
     """
     _C._set_default_dtype(d)
 
+def set_deterministic(d):
+    r"""Sets whether operators that have both a nondeterministic and a
+    deterministic implementation use the deterministic one. The
+    deterministic implementations may be slower.
+
+    Currently this affects :meth:`~Tensor.index_add_` on CUDA, which then sums
+    the values with duplicate indices in a fixed order instead of with atomic
+    adds, and :meth:`~Tensor.index_put_` with ``accumulate=True`` on CUDA.
+
+    This does not change the convolution algorithms of cuDNN; use
+    ``torch.backends.cudnn.deterministic`` for those.
+
+    Args:
+        d (:class:`bool`): If True, use deterministic implementations.
+    """
+    _C._set_deterministic(d)
+
+def is_deterministic():
+    r"""Returns True if deterministic implementations are selected. Refer to
+    :func:`torch.set_deterministic` documentation for more details.
+    """
+    return _C._get_deterministic()
+
 # If you edit these imports, please update torch/__init__.py.in as well
 from .random import set_rng_state, get_rng_state, manual_seed, initial_seed, seed
 from .serialization import save, load
@@ -405,6 +428,7 @@ del ComplexFloatStorageBase
 ################################################################################
 
 import torch.cuda
+import torch.cpu
 import torch.autograd
 from torch.autograd import no_grad, enable_grad, set_grad_enabled
 import torch.nn
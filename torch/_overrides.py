@@ -62,6 +62,8 @@ def get_ignored_functions():
         torch.parse_type_comment,
         torch.set_anomaly_enabled,
         torch.set_flush_denormal,
+        torch.set_deterministic,
+        torch.is_deterministic,
         torch.set_num_interop_threads,
         torch.set_num_threads,
         torch.wait,
@@ -135,7 +137,10 @@ def get_ignored_functions():
         torch.nn.functional.tanh,
         torch.set_autocast_enabled,
         torch.is_autocast_enabled,
+        torch.set_autocast_cpu_enabled,
+        torch.is_autocast_cpu_enabled,
         torch.clear_autocast_cache,
+        torch.prune_autocast_cache,
         torch.autocast_increment_nesting,
         torch.autocast_decrement_nesting,
         torch.nn.functional.hardswish,
@@ -211,6 +216,7 @@ def get_testing_overrides():
         torch.cartesian_prod: lambda *tensors: -1,
         torch.cat: lambda tensors, dim=0, out=None: -1,
         torch.cdist: lambda x1, c2, p=2, compute_mode=None: -1,
+        torch.cdist_topk: lambda x1, x2, k, p=2, compute_mode=None: -1,
         torch.ceil: lambda input, out=None: -1,
         torch.celu: lambda input, alhpa=1., inplace=False: -1,
         torch.chain_matmul: lambda *matrices: -1,
@@ -354,6 +360,7 @@ def get_testing_overrides():
         torch.logical_not: lambda input, out=None: -1,
         torch.logical_or: lambda input, other, out=None: -1,
         torch.logical_xor: lambda input, other, out=None: -1,
+        torch.logcumsumexp: lambda input, dim, out=None: -1,
         torch.logsumexp: lambda input, names, keepdim, out=None: -1,
         torch.lstm: lambda data, batch_sizes, hx, params, has_biases, num_layers, dropout, train, bidirectional: -1,
         torch.lstm_cell: lambda input, hx, w_ih, w_hh, b_ih=None, b_hh=None: -1,
@@ -395,6 +402,7 @@ def get_testing_overrides():
         torch.mvlgamma: lambda input, p: -1,
         torch.narrow: lambda input, dim, start, length: -1,
         torch.native_batch_norm: lambda input, weight, bias, running_mean, running_var, training, momentum, eps: -1,
+        torch.native_group_norm: lambda input, weight, bias, N, C, HxW, group, eps: -1,
         torch.native_layer_norm: lambda input, weight, bias, M, N, eps: -1,
         torch.native_norm: lambda input, p=2: -1,
         torch.ne: lambda input, other, out=None: -1,
@@ -13,9 +13,10 @@ from .variable import Variable
 from .function import Function, NestedIOFunction
 from .gradcheck import gradcheck, gradgradcheck
 from .grad_mode import no_grad, enable_grad, set_grad_enabled
-from .anomaly_mode import detect_anomaly, set_detect_anomaly
+from .anomaly_mode import detect_anomaly, set_detect_anomaly, detect_nonfinite, first_nonfinite_node
 from . import profiler
 from . import functional
+from . import graph
 
 __all__ = ['Variable', 'Function', 'backward', 'grad_mode']
 
@@ -206,6 +207,29 @@ def _is_checkpoint_valid():
     return Variable._execution_engine.is_checkpoint_valid()
 
 
+def set_num_cpu_workers(num_workers: int) -> None:
+    r"""Sets the number of threads that help the calling thread run the CPU
+    part of :func:`backward` and :func:`grad`.
+
+    By default, all CPU work of a backward pass runs on the thread that called
+    it. With ``num_workers > 0``, nodes of the graph whose inputs are ready
+    are also run by a pool of ``num_workers`` threads, so independent
+    branches of the graph, like the towers of a multi-tower model, are
+    differentiated in parallel. Gradients are accumulated as usual, but the
+    order in which the contributions to a gradient are summed may vary from
+    run to run.
+
+    Arguments:
+        num_workers (int): number of additional threads, 0 to disable.
+    """
+    Variable._execution_engine.set_num_cpu_workers(num_workers)
+
+
+def get_num_cpu_workers() -> int:
+    r"""Returns the number of threads set by :func:`set_num_cpu_workers`."""
+    return Variable._execution_engine.num_cpu_workers()
+
+
 def variable(*args, **kwargs):
     warnings.warn("torch.autograd.variable(...) is deprecated, use torch.tensor(...) instead")
     return torch.tensor(*args, **kwargs)
@@ -1,7 +1,7 @@
 import torch
 import warnings
 
-from typing import Any
+from typing import Any, Optional
 
 class detect_anomaly(object):
     r"""Context-manager that enable anomaly detection for the autograd engine.
@@ -106,3 +106,50 @@ class set_detect_anomaly(object):
     def __exit__(self, *args: Any) -> bool:
         torch.set_anomaly_enabled(self.prev)
         return False
+
+
+class detect_nonfinite(object):
+    r"""Context-manager that enables the nonfinite guard of the autograd engine.
+
+    While it is enabled, the outputs of every backward function are checked
+    for nan and infinity values. Unlike :class:`detect_anomaly`, this is cheap
+    enough to leave on during training: each check is a single fused kernel
+    that never synchronizes with the device, and only records the sequence
+    number of the offending function in a flag on the device. Read the flag
+    once per step with :func:`first_nonfinite_node`.
+
+    Backward runs functions in decreasing order of sequence number, i.e., in
+    reverse order of creation, so the function reported is the one where
+    nonfinite values first appeared, the ones after it usually getting them
+    as inputs.
+
+    Example::
+
+        >>> with torch.autograd.detect_nonfinite():
+        ...     loss = model(input).sum()
+        ...     loss.backward()
+        >>> seq_nr = torch.autograd.first_nonfinite_node()
+        >>> if seq_nr is not None:
+        ...     print("Backward returned nonfinite values from node", seq_nr)
+    """
+
+    def __init__(self, mode: bool = True) -> None:
+        self.prev = torch.autograd._is_nonfinite_guard_enabled()
+        self.mode = mode
+
+    def __enter__(self) -> None:
+        torch.autograd._set_nonfinite_guard_enabled(self.mode)
+
+    def __exit__(self, *args: Any) -> bool:
+        torch.autograd._set_nonfinite_guard_enabled(self.prev)
+        return False
+
+
+def first_nonfinite_node() -> Optional[int]:
+    r"""Returns the sequence number of the first backward function that
+    returned nan or infinity values while :class:`detect_nonfinite` was
+    enabled since the previous call, or ``None`` if there was none, and clears
+    the record. Synchronizes with the devices.
+    """
+    seq_nr = torch.autograd._first_nonfinite_node()
+    return None if seq_nr < 0 else seq_nr
@@ -0,0 +1,211 @@
+import torch
+import weakref
+from typing import Any, Callable
+
+
+class saved_tensors_hooks(object):
+    r"""Context-manager that sets a pair of pack / unpack hooks for saved tensors.
+
+    Use this context-manager to define how intermediary results of an operation
+    should be packed before saving, and unpacked on retrieval.
+
+    In that context, the ``pack_hook`` function will be called every time an
+    operation saves a tensor for backward (this includes intermediary results
+    saved using :func:`~torch.autograd.function._ContextMethodMixin.save_for_backward`
+    but also those recorded by a PyTorch-defined operation). The output of
+    ``pack_hook`` is then stored in the computation graph instead of the
+    original tensor.
+
+    The ``unpack_hook`` is called when the saved tensor needs to be accessed,
+    namely when executing :func:`torch.Tensor.backward()` or
+    :func:`torch.autograd.grad()`. It takes as argument the *packed* object
+    returned by ``pack_hook`` and should return a tensor which has the same
+    content as the original tensor (passed as input to the corresponding
+    ``pack_hook``).
+
+    The hooks should have the following signatures::
+
+        pack_hook(tensor: Tensor) -> Any
+
+        unpack_hook(Any) -> Tensor
+
+    where the return value of ``pack_hook`` is a valid input to ``unpack_hook``.
+
+    The hooks apply to the current thread only, and are not called for the
+    tensors saved by operations run inside ``pack_hook`` itself.
+
+    Example::
+
+        >>> def pack_hook(x):
+        ...     print("Packing", x)
+        ...     return x
+        >>>
+        >>> def unpack_hook(x):
+        ...     print("Unpacking", x)
+        ...     return x
+        >>>
+        >>> a = torch.ones(5, requires_grad=True)
+        >>> b = torch.ones(5, requires_grad=True) * 2
+        >>> with torch.autograd.graph.saved_tensors_hooks(pack_hook, unpack_hook):
+        ...     y = a * b
+        Packing tensor([1., 1., 1., 1., 1.])
+        Packing tensor([2., 2., 2., 2., 2.])
+        >>> y.sum().backward()
+        Unpacking tensor([1., 1., 1., 1., 1.])
+        Unpacking tensor([2., 2., 2., 2., 2.])
+
+    .. warning ::
+        Performing an inplace operation on the input to either hook may lead
+        to undefined behavior.
+    """
+    def __init__(self, pack_hook: Callable[[torch.Tensor], Any], unpack_hook: Callable[[Any], torch.Tensor]):
+        self.pack_hook = pack_hook
+        self.unpack_hook = unpack_hook
+
+    def __enter__(self):
+        torch.autograd._push_saved_tensors_default_hooks(self.pack_hook, self.unpack_hook)
+
+    def __exit__(self, *args: Any):
+        torch.autograd._pop_saved_tensors_default_hooks()
+
+
+class save_on_cpu(saved_tensors_hooks):
+    r"""Context-manager under which tensors saved by the forward pass will be
+    stored on cpu, then retrieved for backward.
+
+    When performing operations within this context manager, intermediary
+    results saved in the graph during the forward pass will be moved to CPU,
+    then copied back to the original device when needed for the backward pass.
+    If the graph was already on CPU, no tensor copy is performed.
+
+    Use this context-manager to trade compute for GPU memory usage (e.g.
+    when your model doesn't fit in GPU memory during training).
+
+    Arguments:
+        pin_memory (bool): If ``True`` tensors will be saved to CPU pinned memory
+            during packing and copied to GPU asynchronously during unpacking.
+            Defaults to ``False``.
+    """
+    def __init__(self, pin_memory: bool = False):
+        def pack_to_cpu(tensor):
+            if not tensor.is_cuda or tensor.layout != torch.strided:
+                return (tensor.device, tensor.cpu())
+            packed = torch.empty(tensor.size(), dtype=tensor.dtype, layout=tensor.layout,
+                                 pin_memory=pin_memory)
+            packed.copy_(tensor)
+            return (tensor.device, packed)
+
+        def unpack_from_cpu(packed):
+            device, tensor = packed
+            return tensor.to(device, non_blocking=pin_memory)
+
+        super(save_on_cpu, self).__init__(pack_to_cpu, unpack_from_cpu)
+
+
+class _OffloadedTensor(object):
+    # A saved tensor moved to host memory by offload_to_cpu, together with
+    # the device copy prefetched for backward, if any.
+    __slots__ = ['position', 'host', 'device', 'stream', 'prefetched', 'ready', '__weakref__']
+
+    def __init__(self, position, host, device, stream):
+        self.position = position
+        self.host = host
+        self.device = device
+        self.stream = stream
+        self.prefetched = None
+        self.ready = None
+
+
+class offload_to_cpu(saved_tensors_hooks):
+    r"""Context-manager under which large tensors saved by the forward pass are
+    moved to pinned host memory asynchronously, and prefetched back to their
+    device during backward ahead of the nodes that use them.
+
+    Every saved CUDA tensor of at least :attr:`min_bytes` bytes is copied to
+    pinned memory on a side stream, so the copy overlaps with the rest of the
+    forward pass, and its device memory becomes free once the copy is done.
+    Backward runs nodes in decreasing order of creation (sequence number),
+    which is also the reverse of the order in which their tensors were saved;
+    whenever a node unpacks an offloaded tensor, the next :attr:`prefetch`
+    tensors in that order are copied back on the side stream, so they are
+    usually on the device by the time their nodes run. Smaller tensors and
+    tensors not on a CUDA device are saved as usual.
+
+    Use a new instance for every forward pass.
+
+    Arguments:
+        min_bytes (int): size from which saved tensors are offloaded.
+            Defaults to 1 MiB.
+        prefetch (int): number of offloaded tensors to copy back ahead of their
+            use. Defaults to 2.
+
+    Example::
+
+        >>> with torch.autograd.graph.offload_to_cpu(min_bytes=1 << 20, prefetch=2):
+        ...     loss = model(input).sum()
+        >>> loss.backward()
+    """
+    def __init__(self, min_bytes: int = 1 << 20, prefetch: int = 2):
+        if prefetch < 0:
+            raise ValueError("prefetch must be non-negative, but got {}".format(prefetch))
+        self.min_bytes = min_bytes
+        self.prefetch = prefetch
+        # Weak references to the offloaded tensors in the order they were
+        # saved, so the graph alone keeps them alive.
+        self._saved = []
+        self._streams = {}
+
+        def pack(tensor):
+            if (not tensor.is_cuda or tensor.layout != torch.strided or
+                    tensor.numel() * tensor.element_size() < self.min_bytes):
+                return tensor
+            stream = self._side_stream(tensor.device)
+            host = torch.empty(tensor.size(), dtype=tensor.dtype, pin_memory=True)
+            stream.wait_stream(torch.cuda.current_stream(tensor.device))
+            with torch.cuda.stream(stream):
+                host.copy_(tensor, non_blocking=True)
+            # The caching allocator must not reuse the memory of tensor before
+            # the copy is done.
+            tensor.record_stream(stream)
+            entry = _OffloadedTensor(len(self._saved), host, tensor.device, stream)
+            self._saved.append(weakref.ref(entry))
+            return entry
+
+        def unpack(packed):
+            if not isinstance(packed, _OffloadedTensor):
+                return packed
+            if packed.prefetched is None:
+                self._prefetch(packed)
+            current_stream = torch.cuda.current_stream(packed.device)
+            current_stream.wait_event(packed.ready)
+            tensor = packed.prefetched
+            tensor.record_stream(current_stream)
+            # Keep the host copy only, in case of another backward.
+            packed.prefetched = None
+            packed.ready = None
+
+            position = packed.position - 1
+            remaining = self.prefetch
+            while remaining > 0 and position >= 0:
+                entry = self._saved[position]()
+                if entry is not None:
+                    if entry.prefetched is None:
+                        self._prefetch(entry)
+                    remaining -= 1
+                position -= 1
+            return tensor
+
+        super(offload_to_cpu, self).__init__(pack, unpack)
+
+    def _side_stream(self, device):
+        stream = self._streams.get(device)
+        if stream is None:
+            stream = torch.cuda.Stream(device)
+            self._streams[device] = stream
+        return stream
+
+    def _prefetch(self, entry):
+        with torch.cuda.stream(entry.stream):
+            entry.prefetched = entry.host.to(entry.device, non_blocking=True)
+            entry.ready = torch.cuda.Event()
+            entry.ready.record(entry.stream)
@@ -24,9 +24,11 @@ class EventList(list):
     """A list of Events (for pretty printing)"""
     def __init__(self, *args, **kwargs):
         use_cuda = kwargs.pop('use_cuda', True)
+        profile_memory = kwargs.pop('profile_memory', False)
         super(EventList, self).__init__(*args, **kwargs)
         self._cpu_children_populated = False
         self._use_cuda = use_cuda
+        self._profile_memory = profile_memory
 
     def __str__(self):
         return self.table()
@@ -100,13 +102,16 @@ class EventList(list):
             sort_by (str, optional): Attribute used to sort entries. By default
                 they are printed in the same order as they were registered.
                 Valid keys include: ``cpu_time``, ``cuda_time``, ``cpu_time_total``,
-                ``cuda_time_total``, ``count``.
+                ``cuda_time_total``, ``count``, and with memory profiling
+                ``cpu_memory_usage``, ``self_cpu_memory_usage``,
+                ``cuda_memory_usage``, ``self_cuda_memory_usage``.
 
         Returns:
             A string containing the table.
         """
         return build_table(
-            self, sort_by=sort_by, row_limit=row_limit, header=header, use_cuda=self._use_cuda)
+            self, sort_by=sort_by, row_limit=row_limit, header=header, use_cuda=self._use_cuda,
+            profile_memory=self._profile_memory)
 
     def export_chrome_trace(self, path):
         """Exports an EventList as a Chrome tracing tools file.
@@ -189,7 +194,7 @@ class EventList(list):
         for evt in self:
             stats[get_key(evt, group_by_input_shapes)].add(
                 evt, group_by_input_shapes)
-        return EventList(stats.values(), use_cuda=self._use_cuda)
+        return EventList(stats.values(), use_cuda=self._use_cuda, profile_memory=self._profile_memory)
 
     def total_average(self):
         """Averages all events.
@@ -220,6 +225,19 @@ class profile(object):
             Adds approximately 4us of overhead to each tensor operation.
             Default: ``False``
 
+        profile_memory (bool, optional): Records the memory allocated and
+            freed by the CPU and CUDA allocators, and attributes it to the
+            innermost function running on the allocating thread, which shows
+            up in the "Self CPU Mem" and "Self CUDA Mem" columns. Memory freed
+            in a function counts negatively. Default: ``False``
+
+        use_cupti (bool, optional): Records the kernels, memcpys and memsets
+            executed on the GPUs with CUPTI, and attributes them to the
+            innermost function that launched them. Unlike ``use_cuda``, it
+            shows the actual kernel timeline, including idle gaps, without
+            synchronizing streams. Requires PyTorch to be built with CUPTI.
+            Default: ``False``
+
         record_shapes (bool, optional): If shapes recording is set, information
             about input dimensions will be collected. This allows one to see which
             dimensions have been used under the hood and further group by them
@@ -260,9 +278,14 @@ class profile(object):
         -----------------------------------  ---------------  ---------------  ---------------
 
     """
-    def __init__(self, enabled=True, use_cuda=False, record_shapes=False):
+    def __init__(self, enabled=True, use_cuda=False, record_shapes=False, use_cupti=False,
+                 profile_memory=False):
         self.enabled = enabled
-        self.use_cuda = use_cuda
+        self.profile_memory = profile_memory
+        if use_cuda and use_cupti:
+            raise ValueError("use_cuda and use_cupti can't be used together")
+        self.use_cuda = use_cuda or use_cupti
+        self.use_cupti = use_cupti
         self.function_events = None
         if not self.enabled:
             return
@@ -275,17 +298,23 @@ class profile(object):
         if self.entered:
             raise RuntimeError("autograd profiler traces are not reentrant")
         self.entered = True
-        profiler_kind = torch.autograd.ProfilerState.CUDA if self.use_cuda \
-            else torch.autograd.ProfilerState.CPU
-        config = torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes)
+        if self.use_cupti:
+            profiler_kind = torch.autograd.ProfilerState.CUPTI
+        elif self.use_cuda:
+            profiler_kind = torch.autograd.ProfilerState.CUDA
+        else:
+            profiler_kind = torch.autograd.ProfilerState.CPU
+        config = torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes, self.profile_memory)
         torch.autograd._enable_profiler(config)
         return self
 
     def __exit__(self, exc_type, exc_val, exc_tb):
         if not self.enabled:
             return
-        records = torch.autograd._disable_profiler()
-        self.function_events = EventList(parse_cpu_trace(records), use_cuda=self.use_cuda)
+        records, activities = torch.autograd._disable_profiler_with_activities()
+        self.function_events = EventList(
+            parse_cpu_trace(records, activities), use_cuda=self.use_cuda,
+            profile_memory=self.profile_memory)
         return False
 
     def __repr__(self):
@@ -526,6 +555,68 @@ def load_nvprof(path):
     return EventList(parse_nvprof_trace(path))
 
 
+def enable_sampling(sample_period=1000):
+    """Starts the sampling profiler, which times one in ``sample_period``
+    operator invocations on average, on every thread, and aggregates the
+    samples into per-operator statistics, see :func:`sampled_op_stats`.
+
+    Unlike :class:`profile`, it is cheap enough to stay enabled continuously,
+    e.g. in a serving process. Enable and disable it while no other thread runs
+    PyTorch code, and call ``torch.autograd._enable_record_function(True)`` on
+    the other threads to profile; this function does it for the calling thread.
+
+    Arguments:
+        sample_period (int): average number of invocations per sample.
+    """
+    torch.autograd._enable_sampling_profiler(sample_period)
+
+
+def disable_sampling():
+    """Stops the sampling profiler. The statistics collected so far are kept."""
+    torch.autograd._disable_sampling_profiler()
+
+
+def sampled_op_stats(reset=False):
+    """Returns the statistics collected by the sampling profiler as a list of
+    objects with the attributes ``name``, ``count`` (number of samples),
+    ``total_ns``, ``max_ns`` and ``histogram``, a list of sample counts where
+    the first bucket counts samples shorter than 1us and bucket ``i`` those
+    lasting between ``2 ** (i - 1)`` and ``2 ** i`` us.
+
+    Arguments:
+        reset (bool): if ``True``, also clears the statistics.
+    """
+    return torch.autograd._sampling_profiler_stats(reset)
+
+
+def enable_op_latency_metrics():
+    """Starts timing every operator invocation on every thread, to export
+    per-operator call counts and latency histograms, see
+    :func:`op_latency_metrics`.
+
+    Each thread records into its own counters without locking, so the
+    overhead stays low enough for continuous use. The same restrictions as for
+    :func:`enable_sampling` apply.
+    """
+    torch.autograd._enable_op_latency_metrics()
+
+
+def disable_op_latency_metrics():
+    """Stops timing operator invocations. The metrics are kept."""
+    torch.autograd._disable_op_latency_metrics()
+
+
+def op_latency_metrics():
+    """Returns the metrics of every operator timed since the process started,
+    as a list of objects with the attributes ``name``, ``count``, ``total_ns``
+    and ``buckets``, the invocation counts of a log-linear histogram whose
+    bucket ``i`` starts at ``bucket_lower_bound(i)`` ns, and a method
+    ``quantile(q)`` to estimate latency quantiles from it. The metrics only
+    grow; compare two calls to get the invocations in between.
+    """
+    return torch.autograd._scrape_op_latency_metrics()
+
+
 ################################################################################
 # FunctionEvent
 
@@ -540,6 +631,21 @@ def format_time(time_us):
     return '{:.3f}us'.format(time_us)
 
 
+def format_memory(nbytes):
+    """Returns a formatted memory size string"""
+    KB = 1024.
+    MB = 1024. * KB
+    GB = 1024. * MB
+    if abs(nbytes) >= GB:
+        return '{:.2f} Gb'.format(nbytes / GB)
+    elif abs(nbytes) >= MB:
+        return '{:.2f} Mb'.format(nbytes / MB)
+    elif abs(nbytes) >= KB:
+        return '{:.2f} Kb'.format(nbytes / KB)
+    else:
+        return str(nbytes) + ' b'
+
+
 def format_time_share(time_us, total_time_us):
     """Defines how to format time in FunctionEvent"""
     if total_time_us == 0:
@@ -596,6 +702,12 @@ class FunctionEvent(FormattedTimesMixin):
         self.count = 1
         self.cpu_children = []
         self.input_shapes = input_shapes
+        # Bytes allocated minus bytes freed during the function, including
+        # (cpu/cuda_memory_usage) or excluding (self_*) its children
+        self.cpu_memory_usage = 0
+        self.cuda_memory_usage = 0
+        self.self_cpu_memory_usage = 0
+        self.self_cuda_memory_usage = 0
 
     def append_kernel(self, name, device, start, end):
         self.kernels.append(Kernel(name, device, Interval(start, end)))
@@ -653,6 +765,10 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.cuda_time_total = 0
         self.self_cpu_time_total = 0
         self.input_shapes = None
+        self.cpu_memory_usage = 0
+        self.cuda_memory_usage = 0
+        self.self_cpu_memory_usage = 0
+        self.self_cuda_memory_usage = 0
 
     def add(self, other, group_by_input_shapes=False):
         if self.key is None:
@@ -669,6 +785,10 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.cpu_time_total += other.cpu_time_total
         self.cuda_time_total += other.cuda_time_total
         self.self_cpu_time_total += other.self_cpu_time_total
+        self.cpu_memory_usage += other.cpu_memory_usage
+        self.cuda_memory_usage += other.cuda_memory_usage
+        self.self_cpu_memory_usage += other.self_cpu_memory_usage
+        self.self_cuda_memory_usage += other.self_cuda_memory_usage
         self.count += other.count
         return self
 
@@ -700,7 +820,7 @@ class StringTable(defaultdict):
 ################################################################################
 # CPU checkpoints
 
-def parse_cpu_trace(thread_records):
+def parse_cpu_trace(thread_records, cuda_activities=()):
     next_id = 0
     start_record = None
     cuda_records = {}
@@ -727,9 +847,27 @@ def parse_cpu_trace(thread_records):
             cuda_records[record.device()] = record
     assert start_record is not None
 
+    # CUPTI activities, by the correlation id of the range that launched them
+    launched = defaultdict(list)
+    for activity in cuda_activities:
+        launched[activity.correlation_id].append(activity)
+
+    # [cpu, cuda, self cpu, self cuda] bytes allocated, by function id
+    memory_usage = defaultdict(lambda: [0, 0, 0, 0])
+
     for record in itertools.chain(*thread_records):
         if record.kind() == 'mark':
             continue
+        elif record.kind() == 'memory_alloc':
+            # Allocations are recorded on the thread's list, while the
+            # functions enclosing them are open on the stack.
+            for depth, (function_id, _) in enumerate(reversed(record_stack)):
+                usage = memory_usage[function_id]
+                usage[0] += record.cpu_memory_usage()
+                usage[1] += record.cuda_memory_usage()
+                if depth == 0:
+                    usage[2] += record.cpu_memory_usage()
+                    usage[3] += record.cuda_memory_usage()
         elif record.kind() == 'push':
             record_stack.append((next_id, record))
             next_id += 1
@@ -749,6 +887,15 @@ def parse_cpu_trace(thread_records):
                                  start.device(),
                                  cuda_start,
                                  cuda_end)
+            if start.correlation_id() != 0:
+                for activity in launched[start.correlation_id()]:
+                    fe.append_kernel(activity.name,
+                                     activity.device,
+                                     (activity.start_ns - start_record.cpu_ns()) / 1000.0,
+                                     (activity.end_ns - start_record.cpu_ns()) / 1000.0)
+            if function_id in memory_usage:
+                (fe.cpu_memory_usage, fe.cuda_memory_usage,
+                 fe.self_cpu_memory_usage, fe.self_cuda_memory_usage) = memory_usage.pop(function_id)
             functions.append(fe)
 
     # Sort functions by start time then by end time ascending.
@@ -842,7 +989,7 @@ def parse_nvprof_trace(path):
 # Pretty printer
 
 
-def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True):
+def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True, profile_memory=False):
     """Prints a summary of events (which can be a list of FunctionEvent or FunctionEventAvg)."""
     if len(events) == 0:
         return ""
@@ -872,6 +1019,16 @@ def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True)
             'CUDA total',
             'CUDA time avg',
         ])
+    if profile_memory:
+        headers.extend([
+            'CPU Mem',
+            'Self CPU Mem',
+        ])
+        if use_cuda:
+            headers.extend([
+                'CUDA Mem',
+                'Self CUDA Mem',
+            ])
     headers.append(
         'Number of Calls'
     )
@@ -936,6 +1093,16 @@ def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True)
                 evt.cuda_time_total_str,
                 evt.cuda_time_str,  # Cuda time avg
             ])
+        if profile_memory:
+            row_values.extend([
+                format_memory(evt.cpu_memory_usage),  # CPU Mem
+                format_memory(evt.self_cpu_memory_usage),  # Self CPU Mem
+            ])
+            if use_cuda:
+                row_values.extend([
+                    format_memory(evt.cuda_memory_usage),  # CUDA Mem
+                    format_memory(evt.self_cuda_memory_usage),  # Self CUDA Mem
+                ])
         row_values.append(
             evt.count,  # Number of calls
         )
@@ -29,8 +29,9 @@ class cuFFTPlanCacheAttrContextProp(object):
 class cuFFTPlanCache(object):
     r"""
     Represents a specific plan cache for a specific `device_index`. The
-    attributes `size` and `max_size`, and method `clear`, can fetch and/ or
-    change properties of the C++ cuFFT plan cache.
+    attributes `size`, `max_size` and `batched_plans`, and methods `clear`,
+    `stats` and `reset_stats`, can fetch and/ or change properties of the C++
+    cuFFT plan cache.
     """
     def __init__(self, device_index):
         self.device_index = device_index
@@ -43,9 +44,21 @@ class cuFFTPlanCache(object):
     max_size = cuFFTPlanCacheAttrContextProp(torch._cufft_get_plan_cache_max_size,
                                              torch._cufft_set_plan_cache_max_size)
 
+    batched_plans = cuFFTPlanCacheAttrContextProp(torch._cufft_get_plan_cache_batched_plans,
+                                                  torch._cufft_set_plan_cache_batched_plans)
+
     def clear(self):
         return torch._cufft_clear_plan_cache(self.device_index)
 
+    def stats(self):
+        r"""Returns a dictionary with the number of ``hits``, ``misses`` and
+        ``evictions`` of this cache."""
+        hits, misses, evictions = torch._cufft_get_plan_cache_stats(self.device_index)
+        return {'hits': hits, 'misses': misses, 'evictions': evictions}
+
+    def reset_stats(self):
+        return torch._cufft_reset_plan_cache_stats(self.device_index)
+
 
 class cuFFTPlanCacheManager(object):
     r"""
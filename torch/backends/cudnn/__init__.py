@@ -112,6 +112,31 @@ def flags(enabled=False, benchmark=False, deterministic=False, verbose=False):
             set_flags(orig_flags[0], orig_flags[1], orig_flags[2], orig_flags[3])
 
 
+def save_benchmark_cache(path):
+    r"""Writes the convolution algorithms chosen so far with
+    ``torch.backends.cudnn.benchmark = True`` to the file at ``path``.
+
+    The file can be loaded with :func:`load_benchmark_cache` by later
+    processes running on the same GPU model and cuDNN version, which then
+    skip benchmarking the convolution shapes it contains.
+    """
+    if not _init() or not _cudnn.is_cuda:
+        raise RuntimeError("save_benchmark_cache requires cuDNN")
+    _cudnn._save_convolution_algorithms(path)
+
+
+def load_benchmark_cache(path):
+    r"""Loads the convolution algorithms written by :func:`save_benchmark_cache`.
+
+    Returns the number of cached algorithms loaded. Nothing is loaded if
+    ``path`` does not exist or was written for a different GPU model or
+    cuDNN version.
+    """
+    if not _init() or not _cudnn.is_cuda:
+        raise RuntimeError("load_benchmark_cache requires cuDNN")
+    return _cudnn._load_convolution_algorithms(path)
+
+
 # The magic here is to allow us to intercept code like this:
 #
 #   torch.backends.<cudnn|mkldnn>.enabled = True
@@ -4,3 +4,41 @@ import torch
 def is_available():
     r"""Returns whether PyTorch is built with MKL support."""
     return torch._C.has_mkl
+
+
+class MKLFFTPlanCache(object):
+    r"""
+    Represents the cache of committed MKL FFT descriptors used by CPU FFTs.
+    The attributes `size` and `max_size`, and methods `clear`, `stats` and
+    `reset_stats`, can fetch and/ or change properties of the C++ cache, like
+    their counterparts of ``torch.backends.cuda.cufft_plan_cache``.
+    """
+
+    @property
+    def size(self):
+        r"""The number of descriptors currently in the cache."""
+        return torch._mkl_fft_get_plan_cache_size()
+
+    @property
+    def max_size(self):
+        r"""The capacity of the cache. Setting it to 0 disables caching."""
+        return torch._mkl_fft_get_plan_cache_max_size()
+
+    @max_size.setter
+    def max_size(self, value):
+        torch._mkl_fft_set_plan_cache_max_size(value)
+
+    def clear(self):
+        return torch._mkl_fft_clear_plan_cache()
+
+    def stats(self):
+        r"""Returns a dictionary with the number of ``hits``, ``misses`` and
+        ``evictions`` of this cache."""
+        hits, misses, evictions = torch._mkl_fft_get_plan_cache_stats()
+        return {'hits': hits, 'misses': misses, 'evictions': evictions}
+
+    def reset_stats(self):
+        return torch._mkl_fft_reset_plan_cache_stats()
+
+
+fft_plan_cache = MKLFFTPlanCache()
@@ -38,6 +38,53 @@ class _SupportedQEnginesProp(object):
     def __set__(self, obj, val):
         raise RuntimeError("Assignment not supported")
 
+class _PrepackCacheAttr(object):
+    def __init__(self, getter, setter):
+        self.getter = getter
+        self.setter = setter
+
+    def __get__(self, obj, objtype):
+        return self.getter()
+
+    def __set__(self, obj, val):
+        if isinstance(self.setter, str):
+            raise RuntimeError(self.setter)
+        self.setter(val)
+
+class PrepackCache(object):
+    r"""
+    Represents the process-wide cache of FBGEMM prepacked weights, which lets
+    packing the same quantized weight again reuse the packed weight. The
+    attributes `size`, `bytes` and `max_bytes`, and methods `clear`, `stats`
+    and `reset_stats`, can fetch and/ or change properties of the C++ cache.
+    Setting `max_bytes` to 0 disables the cache.
+    """
+    size = _PrepackCacheAttr(
+        torch._quantized_get_prepack_cache_size,
+        '.size is a read-only property showing the number of packed weights '
+        'currently in the cache. To change the cache capacity, set '
+        'prepack_cache.max_bytes.')
+
+    bytes = _PrepackCacheAttr(
+        torch._quantized_get_prepack_cache_bytes,
+        '.bytes is a read-only property showing the approximate memory used by '
+        'the cache. To change the cache capacity, set prepack_cache.max_bytes.')
+
+    max_bytes = _PrepackCacheAttr(torch._quantized_get_prepack_cache_max_bytes,
+                                  torch._quantized_set_prepack_cache_max_bytes)
+
+    def clear(self):
+        return torch._quantized_clear_prepack_cache()
+
+    def stats(self):
+        r"""Returns a dictionary with the number of ``hits``, ``misses`` and
+        ``evictions`` of this cache."""
+        hits, misses, evictions = torch._quantized_get_prepack_cache_stats()
+        return {'hits': hits, 'misses': misses, 'evictions': evictions}
+
+    def reset_stats(self):
+        return torch._quantized_reset_prepack_cache_stats()
+
 class QuantizedEngine(types.ModuleType):
     def __init__(self, m, name):
         super(QuantizedEngine, self).__init__(name)
@@ -48,6 +95,7 @@ class QuantizedEngine(types.ModuleType):
 
     engine = _QEngineProp()
     supported_engines = _SupportedQEnginesProp()
+    prepack_cache = PrepackCache()
 
 # This is the sys.modules replacement trick, see
 # https://stackoverflow.com/questions/2447353/getattr-on-a-module/7668273#7668273
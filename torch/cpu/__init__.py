@@ -0,0 +1,7 @@
+r"""
+This package provides utilities for inspecting memory used by CPU tensors,
+and CPU autocasting (:mod:`torch.cpu.amp`).
+"""
+
+from .memory import *  # noqa: F401
+from . import amp  # noqa: F401
@@ -0,0 +1,60 @@
+import torch
+import functools
+
+
+class autocast(object):
+    r"""
+    Instances of :class:`autocast` serve as context managers or decorators that
+    allow regions of your script to run CPU ops in mixed precision.
+
+    In these regions, some CPU ops run in ``bfloat16`` (convolutions, ``addmm``, ``mm`` and ``linear``)
+    and ops that need the range of ``float32`` (losses, norms, reductions and the like) run in
+    ``float32``, following the same op lists as :class:`torch.cuda.amp.autocast` does for ``float16``.
+    Only ``float32`` and ``bfloat16`` CPU tensors are cast; CUDA tensors are left to
+    :class:`torch.cuda.amp.autocast`, and the two can be enabled independently.
+
+    Example::
+
+        model = Net()
+        optimizer = optim.SGD(model.parameters(), ...)
+
+        for input, target in data:
+            optimizer.zero_grad()
+
+            with torch.cpu.amp.autocast():
+                output = model(input)
+                loss = loss_fn(output, target)
+
+            loss.backward()
+            optimizer.step()
+
+    ``bfloat16`` has the exponent range of ``float32``, so gradients don't need scaling
+    (no :class:`torch.cuda.amp.GradScaler` is needed).
+
+    The autocast state is thread-local.  If you want it enabled in a new thread, the context manager or decorator
+    must be invoked in that thread.
+
+    Arguments:
+        enabled(bool, optional, default=True):  Whether autocasting should be enabled in the region.
+    """
+    def __init__(self, enabled=True):
+        self._enabled = enabled
+
+    def __enter__(self):
+        self.prev = torch.is_autocast_cpu_enabled()
+        torch.set_autocast_cpu_enabled(self._enabled)
+        torch.autocast_increment_nesting()
+
+    def __exit__(self, *args):
+        # See torch.cuda.amp.autocast.
+        if torch.autocast_decrement_nesting() == 0:
+            torch.prune_autocast_cache()
+        torch.set_autocast_cpu_enabled(self.prev)
+        return False
+
+    def __call__(self, func):
+        @functools.wraps(func)
+        def decorate_autocast(*args, **kwargs):
+            with self:
+                return func(*args, **kwargs)
+        return decorate_autocast
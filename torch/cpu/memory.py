@@ -0,0 +1,121 @@
+import collections
+
+import torch
+
+
+def set_memory_stats_enabled(enabled):
+    r"""Enables or disables collection of statistics by the default CPU
+    memory allocator.
+
+    Collection is disabled by default because it adds a lock and a hash table
+    update to every allocation. Only allocations made while collection is
+    enabled are counted; they are still counted when freed after collection
+    has been disabled.
+
+    Arguments:
+        enabled (bool): whether to collect statistics.
+    """
+    torch._C._cpu_setMemoryStatsEnabled(enabled)
+
+
+def is_memory_stats_enabled():
+    r"""Returns whether the default CPU memory allocator collects statistics.
+
+    See :func:`~torch.cpu.set_memory_stats_enabled`.
+    """
+    return torch._C._cpu_memoryStatsEnabled()
+
+
+def memory_stats():
+    r"""Returns a dictionary of CPU memory allocator statistics.
+
+    The return value of this function is a dictionary of statistics, each of
+    which is a non-negative integer. Statistics are only collected while
+    enabled by :func:`~torch.cpu.set_memory_stats_enabled`.
+
+    Core statistics:
+
+    - ``"allocation.{current,peak,allocated,freed}"``:
+      number of allocation requests received by the memory allocator.
+    - ``"allocated_bytes.{current,peak,allocated,freed}"``:
+      amount of allocated memory.
+
+    The same statistics, broken down by allocation size, are available as
+    ``"bucket_allocation.{size}.*"`` and ``"bucket_allocated_bytes.{size}.*"``,
+    where ``{size}`` is a power of two and the bucket holds allocations of
+    at least ``size`` and less than ``2 * size`` bytes. Buckets that never
+    held an allocation are omitted.
+
+    Metric type:
+
+    - ``current``: current value of this metric.
+    - ``peak``: maximum value of this metric.
+    - ``allocated``: historical total increase in this metric.
+    - ``freed``: historical total decrease in this metric.
+    """
+    result = []
+
+    def _recurse_add_to_result(prefix, obj):
+        if isinstance(obj, dict):
+            if len(prefix) > 0:
+                prefix += "."
+            for k, v in obj.items():
+                _recurse_add_to_result(prefix + k, v)
+        else:
+            result.append((prefix, obj))
+
+    stats = memory_stats_as_nested_dict()
+    _recurse_add_to_result("", stats)
+    result.sort()
+
+    return collections.OrderedDict(result)
+
+
+def memory_stats_as_nested_dict():
+    r"""Returns the result of :func:`~torch.cpu.memory_stats` as a nested dictionary."""
+    return torch._C._cpu_memoryStats()
+
+
+def reset_accumulated_memory_stats():
+    r"""Resets the "accumulated" (historical) stats tracked by the CPU memory allocator.
+
+    See :func:`~torch.cpu.memory_stats` for details. Accumulated stats correspond to
+    the `"allocated"` and `"freed"` keys in each individual stat dict.
+    """
+    return torch._C._cpu_resetAccumulatedMemoryStats()
+
+
+def reset_peak_memory_stats():
+    r"""Resets the "peak" stats tracked by the CPU memory allocator.
+
+    See :func:`~torch.cpu.memory_stats` for details. Peak stats correspond to the
+    `"peak"` key in each individual stat dict.
+    """
+    return torch._C._cpu_resetPeakMemoryStats()
+
+
+def memory_snapshot():
+    r"""Returns a snapshot of the live allocations tracked by the CPU memory
+    allocator, as a list of dictionaries with ``"address"`` and ``"size"``
+    keys, sorted by address.
+
+    Only allocations made while statistics were enabled are included, see
+    :func:`~torch.cpu.set_memory_stats_enabled`.
+    """
+    return torch._C._cpu_memorySnapshot()
+
+
+def memory_allocated():
+    r"""Returns the current CPU memory occupied by tensors in bytes.
+
+    This is a shortcut for ``memory_stats()["allocated_bytes.current"]``.
+    """
+    return memory_stats().get("allocated_bytes.current", 0)
+
+
+def max_memory_allocated():
+    r"""Returns the maximum CPU memory occupied by tensors in bytes since
+    the beginning of the program or the last call to
+    :func:`~torch.cpu.reset_peak_memory_stats`.
+    """
+    return memory_stats().get("allocated_bytes.peak", 0)
@@ -1,9 +1,12 @@
 #ifdef USE_CUDA
 #include <torch/csrc/CudaIPCTypes.h>
 #include <TH/THAllocator.h>
+#include <atomic>
+#include <iterator>
 #include <map>
 #include <mutex>
 #include <random>
+#include <unordered_map>
 
 #ifdef _MSC_VER
 #include <windows.h>
@@ -25,9 +28,65 @@ void warnProducerTerminatedBeforeSharedTensorsReleased() {
   }
 }
 
+// Reference counters are written by the producer, and decremented by any
+// number of consumers at once.
+std::atomic<int64_t>* asAtomicCounter(int64_t* counter) {
+  static_assert(
+      sizeof(std::atomic<int64_t>) == sizeof(int64_t),
+      "Reference counters must be usable as atomics");
+  return reinterpret_cast<std::atomic<int64_t>*>(counter);
+}
+
+struct CudaIPCEvent {
+  cudaEvent_t event;
+  cudaIpcEventHandle_t ipc_handle;
+};
+
+// Interprocess events of a device, that were created for storages sent
+// earlier, and can be recorded again once their storages were released by all
+// consumers. Creating interprocess events (and getting their IPC handles) is
+// expensive, so they are reused rather than destroyed.
+struct CudaIPCEventPool final {
+  // Returns a free event of `device`, or false if all
+  // CUDA_IPC_MAXIMUM_EVENTS_TO_USE events are in use.
+  bool acquire(c10::DeviceIndex device, CudaIPCEvent* event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_events_.size() <= static_cast<size_t>(device)) {
+      free_events_.resize(device + 1);
+    }
+    auto& free_events = free_events_[device];
+    if (!free_events.empty()) {
+      *event = free_events.back();
+      free_events.pop_back();
+      return true;
+    }
+    if (events_created_ >= CUDA_IPC_MAXIMUM_EVENTS_TO_USE) {
+      return false;
+    }
+    C10_CUDA_CHECK(cudaEventCreateWithFlags(
+        &event->event,
+        cudaEventDisableTiming | cudaEventInterprocess |
+            cudaEventBlockingSync));
+    C10_CUDA_CHECK(cudaIpcGetEventHandle(&event->ipc_handle, event->event));
+    events_created_++;
+    return true;
+  }
+
+  void release(c10::DeviceIndex device, const CudaIPCEvent& event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_events_[device].push_back(event);
+  }
+
+ private:
+  std::mutex mutex_;
+  // The events of every device that are not in use, by device index.
+  std::vector<std::vector<CudaIPCEvent>> free_events_;
+  int64_t events_created_ = 0;
+};
+
 struct CudaIPCGlobalEntities {
   std::mutex ref_counters_mutex_;
-  std::atomic<int64_t> sync_events_used_;
+  CudaIPCEventPool event_pool_;
   std::map<std::string, std::shared_ptr<CudaIPCRefCountersFile>>
       ref_counters_files_;
   std::shared_ptr<CudaIPCRefCountersFile> next_available_ref_counters_file_;
@@ -60,18 +119,16 @@ CudaIPCSentDataLimbo::~CudaIPCSentDataLimbo() {
 }
 
 bool CudaIPCSentDataLimbo::collect() {
-  bool freed_memory = false;
   std::lock_guard<std::mutex> lock(limbo_mutex_);
-  std::vector<std::unique_ptr<CudaIPCSentData>> kept_blocks;
+  // Compacts the blocks that are still referred by consumers in place.
+  auto kept_end = shared_blocks_.begin();
   for (auto& sd : shared_blocks_) {
     if (sd->counter_value() > 0) {
-      kept_blocks.push_back(std::move(sd));
-    } else {
-      freed_memory = true;
-      sd.reset();
+      *kept_end++ = std::move(sd);
     }
   }
-  shared_blocks_ = std::move(kept_blocks);
+  const bool freed_memory = kept_end != shared_blocks_.end();
+  shared_blocks_.erase(kept_end, shared_blocks_.end());
   return freed_memory;
 }
 
@@ -96,20 +153,54 @@ void CudaIPCSentDataDelete(void* ptr) {
   if (sent_data->counter_value() > 0) {
     cuda_ipc_global_entities.CudaIPCSentDataLimbo_.add(std::move(sent_data));
   }
-  cuda_ipc_global_entities.CudaIPCSentDataLimbo_.collect();
+  if (cuda_ipc_global_entities.CudaIPCSentDataLimbo_.size() > 0) {
+    cuda_ipc_global_entities.CudaIPCSentDataLimbo_.collect();
+  }
 }
 
-void ReturnRefCounter(const std::string& handle, uint64_t offset /* unused */) {
+void ReturnRefCounter(const std::string& handle, uint64_t offset) {
   std::lock_guard<std::mutex> lock(
       cuda_ipc_global_entities.ref_counters_mutex_);
-  cuda_ipc_global_entities.ref_counters_files_[handle]->return_offset(offset);
-  if (cuda_ipc_global_entities.ref_counters_files_[handle]->offsets_in_use() ==
-          0 &&
-      !cuda_ipc_global_entities.ref_counters_files_[handle]->have_offsets()) {
+  auto& file = cuda_ipc_global_entities.ref_counters_files_[handle];
+  file->return_offset(offset);
+  // The returned offsets of the current file are reused, other files were
+  // exhausted and are dropped once all of their counters are released.
+  if (file->offsets_in_use() == 0 &&
+      file != cuda_ipc_global_entities.next_available_ref_counters_file_) {
     cuda_ipc_global_entities.ref_counters_files_.erase(handle);
   }
 }
 
+// The reference counters files of producers, that this process
+// received storages from.
+std::mutex mapped_ref_counters_files_mutex;
+std::unordered_map<std::string, std::weak_ptr<int64_t>>
+    mapped_ref_counters_files;
+
+// The events that producers shared with this process, by IPC handle.
+std::mutex opened_events_mutex;
+std::unordered_map<std::string, cudaEvent_t> opened_events;
+
+void releaseRefCounter(int64_t* counter) {
+  asAtomicCounter(counter)->fetch_sub(1, std::memory_order_release);
+}
+
+struct CudaIPCRefCounterRelease {
+  std::shared_ptr<int64_t> counters;
+  int64_t offset;
+};
+
+#ifndef __HIP_PLATFORM_HCC__
+void CUDART_CB releaseRefCounterCallback(
+    cudaStream_t /* unused */,
+    cudaError_t /* unused */,
+    void* data) {
+  std::unique_ptr<CudaIPCRefCounterRelease> release(
+      static_cast<CudaIPCRefCounterRelease*>(data));
+  releaseRefCounter(release->counters.get() + release->offset);
+}
+#endif
+
 } // namespace
 
 CudaIPCSentData::CudaIPCSentData(
@@ -134,16 +225,14 @@ CudaIPCSentData::CudaIPCSentData(
   //  [i.record() for i in a]
   //  ```
   //
-  if (cuda_ipc_global_entities.sync_events_used_.load() < CUDA_IPC_MAXIMUM_EVENTS_TO_USE) {
+  CudaIPCEvent event;
+  if (cuda_ipc_global_entities.event_pool_.acquire(device.index(), &event)) {
     // TODO: More efficient would be to create event inside of main thread (at
     // the moment of the queue.put). The reason this is more efficient is
     // because the main thread may have queued extra work on the stream, which
     // this event will consequently wait for (uselessly).
-    cuda_ipc_global_entities.sync_events_used_ ++;
-    C10_CUDA_CHECK(cudaEventCreateWithFlags(
-        &event_,
-        cudaEventDisableTiming | cudaEventInterprocess |
-            cudaEventBlockingSync));
+    event_ = event.event;
+    ipc_event_handle_ = event.ipc_handle;
     C10_CUDA_CHECK(cudaEventRecord(
         event_, c10::cuda::getCurrentCUDAStream(device.index())));
     event_sync_required_ = true;
@@ -166,9 +255,10 @@ CudaIPCSentData::~CudaIPCSentData() {
 #ifndef __HIP_PLATFORM_HCC__
   try {
     if (event_sync_required_) {
-      at::cuda::CUDAGuard device_guard(device_.index());
-      cudaEventDestroy(event_);
-      cuda_ipc_global_entities.sync_events_used_ --;
+      // All consumers released the storage, so they are done waiting for
+      // the event, and it can be recorded again for another storage.
+      cuda_ipc_global_entities.event_pool_.release(
+          device_.index(), CudaIPCEvent{event_, ipc_event_handle_});
     }
   } catch (...) { /* No throw */
   }
@@ -176,35 +266,117 @@ CudaIPCSentData::~CudaIPCSentData() {
 }
 
 int64_t CudaIPCSentData::counter_value() {
-  return *counter_ptr_;
+  return asAtomicCounter(counter_ptr_)->load(std::memory_order_acquire);
+}
+
+std::shared_ptr<int64_t> CudaIPCMapRefCounters(const std::string& handle) {
+  std::lock_guard<std::mutex> lock(mapped_ref_counters_files_mutex);
+  auto& cached = mapped_ref_counters_files[handle];
+  if (auto counters = cached.lock()) {
+    return counters;
+  }
+  int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
+  auto mapping = std::make_shared<at::DataPtr>(
+      THRefcountedMapAllocator::makeDataPtr(
+          handle.c_str(),
+          flags,
+          sizeof(int64_t) * CUDA_IPC_REF_COUNTER_FILE_SIZE,
+          nullptr));
+  // Aliases the mapping, which is unmapped with the last counter.
+  std::shared_ptr<int64_t> counters(
+      mapping, static_cast<int64_t*>(mapping->get()));
+  cached = counters;
+  // Drop the entries of files that were unmapped since.
+  if (mapped_ref_counters_files.size() > 64) {
+    for (auto it = mapped_ref_counters_files.begin();
+         it != mapped_ref_counters_files.end();) {
+      it = it->second.expired() ? mapped_ref_counters_files.erase(it)
+                                : std::next(it);
+    }
+  }
+  return counters;
+}
+
+void CudaIPCReleaseRefCounterAsync(
+    std::shared_ptr<int64_t> counters,
+    int64_t offset,
+    int64_t device) {
+#ifndef __HIP_PLATFORM_HCC__
+  // The counter is released by a host callback once the stream reaches it,
+  // instead of synchronizing the stream here (otherwise another process may
+  // reuse memory and corrupt data).
+  auto release = new CudaIPCRefCounterRelease{counters, offset};
+  if (cudaStreamAddCallback(
+          c10::cuda::getCurrentCUDAStream(device),
+          releaseRefCounterCallback,
+          release,
+          0) == cudaSuccess) {
+    return;
+  }
+  cudaGetLastError(); // Clear the error; e.g. CUDA is shutting down.
+  delete release;
+#endif
+  cudaStreamSynchronize(c10::cuda::getCurrentCUDAStream(device));
+  releaseRefCounter(counters.get() + offset);
+}
+
+void CudaIPCReleaseRefCounter(const std::string& handle, int64_t offset) {
+  // We don't want to break existing code, so resource deletion is best
+  // effort basis. Exception expected if producer process terminated
+  // before consumer released data.
+  try {
+    releaseRefCounter(CudaIPCMapRefCounters(handle).get() + offset);
+  } catch (c10::Error& err) {
+    // Already warned inside of producer process
+  }
+}
+
+cudaEvent_t CudaIPCOpenEventHandle(const std::string& handle) {
+  std::lock_guard<std::mutex> lock(opened_events_mutex);
+  auto it = opened_events.find(handle);
+  if (it != opened_events.end()) {
+    return it->second;
+  }
+  if (opened_events.size() >= 4 * CUDA_IPC_MAXIMUM_EVENTS_TO_USE) {
+    // Most of these are events of producers that are gone by now.
+    for (auto& opened_event : opened_events) {
+      cudaEventDestroy(opened_event.second);
+    }
+    opened_events.clear();
+  }
+  cudaEvent_t event;
+  C10_CUDA_CHECK(cudaIpcOpenEventHandle(
+      &event, *reinterpret_cast<const cudaIpcEventHandle_t*>(handle.data())));
+  opened_events.emplace(handle, event);
+  return event;
 }
 
 at::DataPtr GetNewRefCountedSentData(void* data, at::Device device) {
-  {
-    std::lock_guard<std::mutex> lock(
-        cuda_ipc_global_entities.ref_counters_mutex_);
-    if (!cuda_ipc_global_entities.next_available_ref_counters_file_) {
-      static std::random_device rd;
-      std::string ref_counter_handle = "/torch_";
+  // Offsets are returned to the current file concurrently, see
+  // ReturnRefCounter().
+  std::lock_guard<std::mutex> lock(
+      cuda_ipc_global_entities.ref_counters_mutex_);
+  if (!cuda_ipc_global_entities.next_available_ref_counters_file_) {
+    static std::random_device rd;
+    std::string ref_counter_handle = "/torch_";
 #ifdef _MSC_VER
-      ref_counter_handle += std::to_string(GetCurrentProcessId());
+    ref_counter_handle += std::to_string(GetCurrentProcessId());
 #else
-      ref_counter_handle += std::to_string(getpid());
+    ref_counter_handle += std::to_string(getpid());
 #endif
-      ref_counter_handle += "_";
-      ref_counter_handle += std::to_string(rd());
+    ref_counter_handle += "_";
+    ref_counter_handle += std::to_string(rd());
 
-      int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE;
-      at::DataPtr sptr = THRefcountedMapAllocator::makeDataPtr(
-          ref_counter_handle.c_str(),
-          flags,
-          sizeof(int64_t) * CUDA_IPC_REF_COUNTER_FILE_SIZE,
-          nullptr);
-      auto rc = std::make_shared<CudaIPCRefCountersFile>(
-          ref_counter_handle, CUDA_IPC_REF_COUNTER_FILE_SIZE, std::move(sptr));
-      cuda_ipc_global_entities.ref_counters_files_[ref_counter_handle] = rc;
-      cuda_ipc_global_entities.next_available_ref_counters_file_ = rc;
-    }
+    int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE;
+    at::DataPtr sptr = THRefcountedMapAllocator::makeDataPtr(
+        ref_counter_handle.c_str(),
+        flags,
+        sizeof(int64_t) * CUDA_IPC_REF_COUNTER_FILE_SIZE,
+        nullptr);
+    auto rc = std::make_shared<CudaIPCRefCountersFile>(
+        ref_counter_handle, CUDA_IPC_REF_COUNTER_FILE_SIZE, std::move(sptr));
+    cuda_ipc_global_entities.ref_counters_files_[ref_counter_handle] = rc;
+    cuda_ipc_global_entities.next_available_ref_counters_file_ = rc;
   }
   cuda_ipc_global_entities.next_available_ref_counters_file_->set_counter(1);
   auto sent_data = new CudaIPCSentData(
@@ -8,6 +8,9 @@
 #include <c10/util/Logging.h>
 #include <cuda_runtime_api.h>
 #include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace torch {
 
@@ -19,12 +22,34 @@ struct CudaIPCReceivedData final {
   std::shared_ptr<void> shared_ptr_;
 };
 
+// Maps the reference counters file of a producer in a consumer. Consumers
+// share one mapping of a file among all the storages they received with
+// counters in it, so that releasing a counter doesn't map the file again.
+std::shared_ptr<int64_t> CudaIPCMapRefCounters(const std::string& handle);
+
+// Decrements the reference counter at `offset` of `counters` (a mapping
+// returned by CudaIPCMapRefCounters) once the work queued on the current
+// stream of `device` so far has finished. Doesn't block.
+void CudaIPCReleaseRefCounterAsync(
+    std::shared_ptr<int64_t> counters,
+    int64_t offset,
+    int64_t device);
+
+// Decrements the reference counter at `offset` of the reference counters file
+// `handle` right away. Best effort: does nothing if the producer is gone.
+void CudaIPCReleaseRefCounter(const std::string& handle, int64_t offset);
+
+// Opens an event shared by a producer. Producers reuse their events, so the
+// consumer keeps the events it opened, and only opens every handle once.
+cudaEvent_t CudaIPCOpenEventHandle(const std::string& handle);
+
 struct CudaIPCSentData final {
   std::string handle_;
   int64_t offset_;
   int64_t* counter_ptr_; // Reference counter shared memory block
   at::DataPtr original_ptr_; // Original mem allocation
-  cudaEvent_t event_; // Sync cuEventDestroy
+  cudaEvent_t event_; // Taken from the event pool of the device
+  cudaIpcEventHandle_t ipc_event_handle_; // The IPC handle of event_
   bool event_sync_required_;
   at::Device device_;
 
@@ -87,7 +112,7 @@ struct CudaIPCRefCountersFile final {
         refcounted_shared_mem_(std::move(data_ptr)) {}
 
   int64_t* counter_ptr() {
-    return static_cast<int64_t*>(refcounted_shared_mem_.get()) + next_offset_;
+    return static_cast<int64_t*>(refcounted_shared_mem_.get()) + get_offset();
   }
 
   void set_counter(uint64_t value) {
@@ -95,24 +120,31 @@ struct CudaIPCRefCountersFile final {
   }
 
   bool have_offsets() {
-    return next_offset_ < size_;
+    return next_offset_ < size_ || !returned_offsets_.empty();
   }
 
   bool offsets_in_use() {
     return used_slots_;
   }
 
+  // Offsets whose counters were released are reused before new ones, so
+  // that the file is only exhausted by that many storages in flight.
   int64_t get_offset() {
-    return next_offset_;
+    return returned_offsets_.empty() ? next_offset_ : returned_offsets_.back();
   }
 
   void rotate_offset() {
-    next_offset_++;
+    if (returned_offsets_.empty()) {
+      next_offset_++;
+    } else {
+      returned_offsets_.pop_back();
+    }
     used_slots_++;
   }
 
-  void return_offset(uint64_t offset /* unused */) {
+  void return_offset(uint64_t offset) {
     used_slots_--;
+    returned_offsets_.push_back(offset);
   }
 
   std::string handle() {
@@ -123,6 +155,7 @@ struct CudaIPCRefCountersFile final {
   uint64_t next_offset_;
   uint64_t size_;
   uint64_t used_slots_;
+  std::vector<uint64_t> returned_offsets_;
   std::string handle_;
   at::DataPtr refcounted_shared_mem_;
 };
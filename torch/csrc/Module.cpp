@@ -9,6 +9,7 @@
 #include <cstdlib>
 #include <libshm.h>
 #include <TH/TH.h>
+#include <c10/core/CPUAllocator.h>
 #include <c10/util/Logging.h>
 #include <ATen/ATen.h>
 #include <ATen/ExpandUtils.h>
@@ -404,6 +405,37 @@ PyObject *THPModule_fromDLPack(PyObject *_unused, PyObject *data)
   END_HANDLE_TH_ERRORS
 }
 
+// Takes the addresses of an ArrowArray and an ArrowSchema exported to us,
+// e.g., by pyarrow's Array._export_to_c
+PyObject *THPModule_fromArrow(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject *array_address = nullptr;
+  PyObject *schema_address = nullptr;
+  if (!PyArg_ParseTuple(args, "OO", &array_address, &schema_address)) {
+    return nullptr;
+  }
+  auto array = reinterpret_cast<ArrowArray*>(
+      static_cast<intptr_t>(THPUtils_unpackLong(array_address)));
+  auto schema = reinterpret_cast<ArrowSchema*>(
+      static_cast<intptr_t>(THPUtils_unpackLong(schema_address)));
+  // We own the exported structs; release whatever the tensor doesn't take
+  struct ReleaseGuard {
+    ArrowArray* array;
+    ArrowSchema* schema;
+    ~ReleaseGuard() {
+      if (array->release) {
+        array->release(array);
+      }
+      if (schema->release) {
+        schema->release(schema);
+      }
+    }
+  } guard{array, schema};
+  return THPVariable_Wrap(at::fromArrowArray(array, schema));
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject *THPModule_setUserEnabledCuDNN(PyObject *_unused, PyObject *arg)
 {
   THPUtils_assert(PyBool_Check(arg), "set_enabled_cudnn expects a bool, "
@@ -446,6 +478,20 @@ PyObject *THPModule_deterministicCuDNN(PyObject *_unused, PyObject *noargs)
   else Py_RETURN_FALSE;
 }
 
+PyObject *THPModule_setDeterministic(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_deterministic expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setDeterministic(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_deterministic(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().deterministic()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
 PyObject *THPModule_setBenchmarkCuDNN(PyObject *_unused, PyObject *arg)
 {
   THPUtils_assert(PyBool_Check(arg), "set_benchmark_cudnn expects a bool, "
@@ -466,6 +512,88 @@ PyObject *THPModule_benchmarkCuDNN(PyObject *_unused, PyObject *noargs)
   else Py_RETURN_FALSE;
 }
 
+PyObject *THPModule_setCPUMemoryStatsEnabled(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_memory_stats_enabled expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  FLAGS_caffe2_track_cpu_memory_usage = (arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_cpuMemoryStatsEnabled(PyObject *_unused, PyObject *noargs)
+{
+  if (FLAGS_caffe2_track_cpu_memory_usage) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_cpuMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  const auto statToDict = [](const c10::CPUAllocatorStat& stat) {
+    py::dict dict;
+
+    dict["current"] = stat.current;
+    dict["peak"] = stat.peak;
+    dict["allocated"] = stat.allocated;
+    dict["freed"] = stat.freed;
+    return dict;
+  };
+
+  // Buckets are keyed by their lower bound in bytes, as a string; empty
+  // buckets are omitted.
+  const auto bucketStatsToDict = [=](
+      const c10::CPUAllocatorBucketStats& bucket_stats) {
+    py::dict dict;
+    for (size_t i = 0; i < bucket_stats.size(); ++i) {
+      if (bucket_stats[i].allocated > 0 || bucket_stats[i].current > 0) {
+        dict[py::str(std::to_string(static_cast<uint64_t>(1) << i))] = statToDict(bucket_stats[i]);
+      }
+    }
+    return dict;
+  };
+
+  const c10::CPUAllocatorStats stats = c10::GetDefaultCPUAllocatorStats();
+
+  py::dict result;
+  result["allocation"] = statToDict(stats.allocation);
+  result["allocated_bytes"] = statToDict(stats.allocated_bytes);
+  result["bucket_allocation"] = bucketStatsToDict(stats.bucket_allocation);
+  result["bucket_allocated_bytes"] = bucketStatsToDict(stats.bucket_allocated_bytes);
+
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject *THPModule_cpuResetAccumulatedMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  c10::ResetDefaultCPUAllocatorAccumulatedStats();
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_cpuResetPeakMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  c10::ResetDefaultCPUAllocatorPeakStats();
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_cpuMemorySnapshot(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  py::list result;
+  for (const auto& info : c10::SnapshotDefaultCPUAllocator()) {
+    py::dict dict;
+    dict["address"] = info.address;
+    dict["size"] = info.size;
+    result.append(dict);
+  }
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject *THPModule_setFlushDenormal(PyObject *_unused, PyObject *arg) {
   THPUtils_assert(PyBool_Check(arg), "flush_denormal expects a bool, "
           "but got %s", THPUtils_typename(arg));
@@ -558,8 +686,17 @@ static PyMethodDef TorchMethods[] = {
   {"_set_cudnn_benchmark", (PyCFunction)THPModule_setBenchmarkCuDNN, METH_O,  nullptr},
   {"_get_cudnn_deterministic", (PyCFunction)THPModule_deterministicCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_deterministic", (PyCFunction)THPModule_setDeterministicCuDNN, METH_O,  nullptr},
+  {"_get_deterministic", (PyCFunction)THPModule_deterministic, METH_NOARGS,     nullptr},
+  {"_set_deterministic", (PyCFunction)THPModule_setDeterministic, METH_O,  nullptr},
   {"_to_dlpack",      (PyCFunction)THPModule_toDLPack,          METH_O,       nullptr},
   {"_from_dlpack",    (PyCFunction)THPModule_fromDLPack,        METH_O,       nullptr},
+  {"_from_arrow",     (PyCFunction)THPModule_fromArrow,         METH_VARARGS, nullptr},
+  {"_cpu_setMemoryStatsEnabled", (PyCFunction)THPModule_setCPUMemoryStatsEnabled, METH_O, nullptr},
+  {"_cpu_memoryStatsEnabled", (PyCFunction)THPModule_cpuMemoryStatsEnabled, METH_NOARGS, nullptr},
+  {"_cpu_memoryStats", (PyCFunction)THPModule_cpuMemoryStats, METH_NOARGS, nullptr},
+  {"_cpu_resetAccumulatedMemoryStats", (PyCFunction)THPModule_cpuResetAccumulatedMemoryStats, METH_NOARGS, nullptr},
+  {"_cpu_resetPeakMemoryStats", (PyCFunction)THPModule_cpuResetPeakMemoryStats, METH_NOARGS, nullptr},
+  {"_cpu_memorySnapshot", (PyCFunction)THPModule_cpuMemorySnapshot, METH_NOARGS, nullptr},
   {"set_flush_denormal", (PyCFunction)THPModule_setFlushDenormal, METH_O,     nullptr},
   {"get_default_dtype", (PyCFunction)THPModule_getDefaultDtype, METH_NOARGS,  nullptr},
   {"_get_default_device", (PyCFunction)THPModule_getDefaultDevice, METH_NOARGS,   nullptr},
@@ -3,6 +3,7 @@
 #include <torch/data/dataloader_options.h>
 #include <torch/data/detail/data_shuttle.h>
 #include <torch/data/detail/sequencers.h>
+#include <torch/data/detail/transfer.h>
 #include <torch/data/iterator.h>
 #include <torch/data/samplers/random.h>
 #include <torch/data/worker_exception.h>
@@ -13,6 +14,7 @@
 
 #include <c10/util/Exception.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <exception>
 #include <memory>
@@ -37,7 +39,14 @@ class DataLoaderBase {
       std::unique_ptr<Dataset> main_thread_dataset = nullptr)
       : options_(std::move(options)),
         main_thread_dataset_(std::move(main_thread_dataset)),
-        sequencer_(new_sequencer()) {}
+        // At most `max_jobs` jobs are in flight, and `join()` pushes one
+        // 'quit' job per worker once all of them finished.
+        shuttle_(std::max(options_.max_jobs, options_.workers)),
+        sequencer_(new_sequencer()) {
+    if (options_.device) {
+      device_prefetcher_.emplace(*options_.device, options_.device_prefetch);
+    }
+  }
 
   virtual ~DataLoaderBase() {
     join();
@@ -136,6 +145,9 @@ class DataLoaderBase {
   /// Resets the internal state of the DataLoader, optionally pre-fetching
   /// new jobs.
   virtual void reset() {
+    if (device_prefetcher_) {
+      device_prefetcher_->clear();
+    }
     shuttle_.drain();
     sequence_number_ = 0;
     sequencer_ = new_sequencer();
@@ -161,8 +173,17 @@ class DataLoaderBase {
 
   /// Returns the next batch of data, or an empty `optional` if the DataLoader
   /// is exhausted. This operation will block until a batch is available if one
-  /// is still expected.
+  /// is still expected. If a `device` was configured, the batch is on it.
   optional<BatchType> next() {
+    if (device_prefetcher_) {
+      return device_prefetcher_->next([this] { return this->next_on_host(); });
+    }
+    return next_on_host();
+  }
+
+  /// Returns the next batch of data as loaded by the dataset, or an empty
+  /// `optional` if the DataLoader is exhausted.
+  optional<BatchType> next_on_host() {
     if (options_.workers > 0) {
       while (optional<Result> result = this->pop_result()) {
         if (result->exception) {
@@ -173,7 +194,12 @@ class DataLoaderBase {
         }
       }
     } else if (auto batch_request = get_batch_request()) {
-      return this->main_thread_dataset_->get_batch(std::move(*batch_request));
+      auto batch =
+          this->main_thread_dataset_->get_batch(std::move(*batch_request));
+      if (options_.pin_memory) {
+        detail::pin_memory(batch);
+      }
+      return std::move(batch);
     }
     return nullopt;
   }
@@ -187,6 +213,9 @@ class DataLoaderBase {
       }
       try {
         auto batch = dataset.get_batch(std::move(*job.batch_request));
+        if (options_.pin_memory) {
+          detail::pin_memory(batch);
+        }
         shuttle_.push_result({std::move(batch), job.sequence_number});
       } catch (...) {
         shuttle_.push_result({std::current_exception(), job.sequence_number});
@@ -241,6 +270,9 @@ class DataLoaderBase {
 
   /// True if the DataLoader has joined its worker threads.
   bool joined_ = false;
+
+  /// Copies batches to the configured `device` ahead of time, if any.
+  optional<detail::DevicePrefetcher<Batch>> device_prefetcher_;
 };
 } // namespace data
 } // namespace torch
@@ -37,6 +37,20 @@ struct DataLoaderOptions {
   /// Whether to omit the last batch if it contains less than `batch_size`
   /// examples.
   TORCH_ARG(bool, drop_last) = false;
+
+  /// Whether to move the tensors of every batch into pinned (page-locked) host
+  /// memory, as soon as the batch is loaded. Copies from pinned memory to a
+  /// CUDA device can run asynchronously. Requires CUDA.
+  TORCH_ARG(bool, pin_memory) = false;
+
+  /// An optional device to copy the tensors of every batch to before the batch
+  /// is returned. The copies are issued on a side stream of the device, ahead
+  /// of time, so they overlap with the work on the current stream.
+  TORCH_ARG(optional<Device>, device);
+
+  /// The number of batches to copy to `device` ahead of the batch that is
+  /// returned.
+  TORCH_ARG(size_t, device_prefetch) = 2;
 };
 
 /// Like `DataLoaderOptions`, but without any unconfigured state.
@@ -52,7 +66,10 @@ struct FullDataLoaderOptions {
         max_jobs(options.max_jobs().value_or(2 * workers)),
         timeout(options.timeout()),
         enforce_ordering(options.enforce_ordering()),
-        drop_last(options.drop_last()) {}
+        drop_last(options.drop_last()),
+        pin_memory(options.pin_memory()),
+        device(options.device()),
+        device_prefetch(options.device_prefetch()) {}
 
   size_t batch_size;
   size_t workers;
@@ -60,6 +77,9 @@ struct FullDataLoaderOptions {
   optional<std::chrono::milliseconds> timeout;
   bool enforce_ordering;
   bool drop_last;
+  bool pin_memory;
+  optional<Device> device;
+  size_t device_prefetch;
 };
 } // namespace data
 } // namespace torch
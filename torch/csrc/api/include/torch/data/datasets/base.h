@@ -91,6 +91,19 @@ class Dataset : public BatchDataset<Self, std::vector<SingleExample>> {
     }
     return batch;
   }
+
+  /// Writes the examples at the given indices directly into `batch`, collated
+  /// the way `transforms::Stack` collates them, and returns true. The tensors
+  /// of `batch` are either undefined, or belong to an earlier batch and may be
+  /// resized and overwritten. This saves allocating and copying the tensors of
+  /// every example when the dataset is mapped with `transforms::Stack`.
+  /// The default implementation returns false, in which case the batch is
+  /// collated from the result of `get_batch()`.
+  virtual bool get_batch_into(
+      ArrayRef<size_t> /* unused */,
+      ExampleType& /* unused */) {
+    return false;
+  }
 };
 
 /// A `StreamDataset` represents a dataset that is a potentially infinite stream.
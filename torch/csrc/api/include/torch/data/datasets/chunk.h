@@ -9,6 +9,11 @@
 
 #include <torch/serialize.h>
 
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <random>
+
 namespace torch {
 namespace data {
 namespace datasets {
@@ -55,10 +60,20 @@ class BatchDataBuffer {
   BatchDataBuffer(
       size_t batch_size,
       ExampleSampler& example_sampler,
-      size_t queue_capacity)
+      size_t queue_capacity,
+      size_t shuffle_buffer_size = 0)
       : batch_size_(batch_size),
         example_sampler_(example_sampler),
-        queue_capacity_(queue_capacity) {}
+        queue_capacity_(queue_capacity),
+        shuffle_buffer_size_(shuffle_buffer_size) {
+    if (shuffle_buffer_size_ > 0) {
+      // Seed from the global generator, so that `torch::manual_seed()` makes
+      // the shuffling reproducible, like it does for the samplers.
+      shuffle_engine_.seed(static_cast<uint64_t>(
+          torch::randint(std::numeric_limits<int64_t>::max(), {1})
+              .item<int64_t>()));
+    }
+  }
 
   /// Return batch data from the queue. Called from the ChunkDataset main
   /// thread.
@@ -109,6 +124,13 @@ class BatchDataBuffer {
     auto remaining_size = data_size;
     example_sampler_.reset(data_size);
 
+    if (shuffle_buffer_size_ > 0) {
+      add_to_shuffle_buffer(std::move(data));
+      lock.unlock();
+      cv_read_.notify_all();
+      return;
+    }
+
     auto fill_batch = [&](size_t example_count, UnwrappedBatchType& batch) {
       auto batch_example_indices = this->example_sampler_.next(example_count);
       AT_ASSERT(
@@ -173,6 +195,21 @@ class BatchDataBuffer {
     cv_read_.notify_all();
   }
 
+  /// Moves the examples left in the shuffle buffer into batches, in random
+  /// order. Called once no more chunks will be added.
+  void flush_shuffle_buffer() {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      if (stop_) {
+        return;
+      }
+      while (!shuffle_buffer_.empty()) {
+        emit_random_example();
+      }
+    }
+    cv_read_.notify_all();
+  }
+
   void stop(){
     {
       // Hold the lock before changing stop_ to prevent a race condition which can
@@ -195,6 +232,43 @@ class BatchDataBuffer {
     // notify all readers too.
     cv_read_.notify_all();
   }
+  /// Adds the examples of a chunk to the shuffle buffer, in the order of the
+  /// example sampler. For every example beyond the capacity of the shuffle
+  /// buffer, a random example of the buffer is moved into a batch, so the
+  /// examples of consecutive chunks are shuffled without merging the chunks.
+  /// Called with `queue_mutex_` held.
+  void add_to_shuffle_buffer(UnwrappedBatchType data) {
+    const auto data_size = data.size();
+    auto indices = example_sampler_.next(data_size);
+    AT_ASSERT(indices && indices.value().size() == data_size);
+    for (size_t i : indices.value()) {
+      TORCH_CHECK(i < data_size, "Index out of range");
+      shuffle_buffer_.push_back(std::move(data[i]));
+      if (shuffle_buffer_.size() > shuffle_buffer_size_) {
+        emit_random_example();
+      }
+    }
+  }
+
+  /// Moves a random example out of the shuffle buffer, and appends it to the
+  /// last batch of the queue, or a new batch if the last one is complete.
+  /// Called with `queue_mutex_` held.
+  void emit_random_example() {
+    std::uniform_int_distribution<size_t> distribution(
+        0, shuffle_buffer_.size() - 1);
+    std::swap(
+        shuffle_buffer_[distribution(shuffle_engine_)], shuffle_buffer_.back());
+    if (batch_queue_.empty() || batch_queue_.back().exception ||
+        batch_queue_.back().batch_data.size() >= batch_size_) {
+      UnwrappedBatchType batch;
+      batch.reserve(batch_size_);
+      batch_queue_.emplace(std::move(batch));
+    }
+    batch_queue_.back().batch_data.push_back(std::move(shuffle_buffer_.back()));
+    shuffle_buffer_.pop_back();
+    ++total_example_count_in_queue_;
+  }
+
   /// The batch size is needed to create batches from the chunk data. Similar to
   /// regular dataloader where the batches are created with prefetches,
   /// BatchDataBuffer perform the batch creation using the provided batch size.
@@ -233,6 +307,15 @@ class BatchDataBuffer {
   // configurable maximun number of elements the queue can hold at one time.
   size_t queue_capacity_;
 
+  // The maximum number of examples held back in the shuffle buffer, or 0 if
+  // there is no shuffle buffer.
+  size_t shuffle_buffer_size_;
+
+  // Examples that are not in a batch yet, see add_to_shuffle_buffer().
+  UnwrappedBatchType shuffle_buffer_;
+
+  std::mt19937_64 shuffle_engine_;
+
   // When set to true, it wakes the writer threads from the wait and exit current
   // function call. This is needed when ChunkDataSet.Reset is called while the
   // previous epoch is not exhausted yet. When ChunkDataset is waiting its
@@ -292,6 +375,27 @@ struct ChunkDatasetOptions {
   // penalty when this value is greater than 1, as we need to do extra merge
   // between multiple chunks before performing example sampling.
   TORCH_ARG(size_t, cross_chunk_shuffle_count) = 1;
+
+  // The maximum number of preloaders. Default to 0 meaning that the number of
+  // preloaders is fixed to `preloader_count`. Otherwise, whenever `get_batch`
+  // waits longer than `preloader_scaling_wait` for a batch, because reading
+  // chunks is slower than consuming them, another preloader is started, until
+  // there are `max_preloader_count` of them. Useful for readers whose
+  // `read_chunk` mostly waits for I/O.
+  TORCH_ARG(size_t, max_preloader_count) = 0;
+
+  // How long `get_batch` may wait for a batch before another preloader is
+  // started, see `max_preloader_count`.
+  TORCH_ARG(std::chrono::milliseconds, preloader_scaling_wait) =
+      std::chrono::milliseconds(10);
+
+  // The number of examples in the shuffle buffer. Default to 0 meaning no
+  // shuffle buffer. When it is equal to n (n > 0), examples of a chunk are not
+  // batched right away, but added to a buffer of n examples, from which random
+  // examples are batched. This shuffles examples across consecutive chunks
+  // without loading or merging several chunks at once, unlike
+  // `cross_chunk_shuffle_count`.
+  TORCH_ARG(size_t, shuffle_buffer_size) = 0;
 };
 
 /// A stateful dataset that support hierarchical sampling and prefetching of
@@ -332,7 +436,12 @@ class ChunkDataset final
         preprocessing_policy_(preprocessing_policy),
         quit_worker_(false),
         running_preloaders_(0),
-        load_checkpoint_(false) {}
+        load_checkpoint_(false) {
+    TORCH_CHECK(
+        options_.max_preloader_count() == 0 ||
+            options_.max_preloader_count() >= options_.preloader_count(),
+        "max_preloader_count needs to be 0 or at least preloader_count.");
+  }
 
   virtual ~ChunkDataset() {
     // stop batch buffer first.
@@ -356,7 +465,11 @@ class ChunkDataset final
       "The requested batch size does not match with the initialized batch size.\n"
       " The requested batch size is ", batch_size,
       ", while the dataset is created with batch size equal to ", options_.batch_size());
-    return batch_buffer_->get_batch();
+    const auto start = std::chrono::steady_clock::now();
+    auto batch = batch_buffer_->get_batch();
+    maybe_add_preloader(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start));
+    return batch;
   }
 
   /// Helper method around get_batch as `batch_size` is not strictly necessary
@@ -373,7 +486,6 @@ class ChunkDataset final
     }
     // free workers from previous reset if there is any.
     free_workers();
-    preload_threads_.clear();
 
     if (!load_checkpoint_){
       chunk_reader_.reset();
@@ -387,18 +499,28 @@ class ChunkDataset final
         detail::BatchDataBuffer<UnwrappedBatchType, ExampleSamplerType>>(
         options_.batch_size(),
         example_sampler_,
-        options_.cache_size());
+        options_.cache_size(),
+        options_.shuffle_buffer_size());
 
     // create new workers for this new epoch.
     quit_worker_ = false;
 
     AT_ASSERT(running_preloaders_ == 0);
     running_preloaders_ = options_.preloader_count();
+    std::lock_guard<std::mutex> lock(preload_threads_guard_);
+    preload_threads_.clear();
     for (size_t i = 0; i < options_.preloader_count(); ++i) {
       preload_threads_.emplace_back([this, i]() { this->preloader(i); });
     }
   }
 
+  /// Returns the number of preloaders started since the last `reset()`, which
+  /// grows beyond `preloader_count` if `max_preloader_count` allows it.
+  size_t preloader_thread_count() const {
+    std::lock_guard<std::mutex> lock(preload_threads_guard_);
+    return preload_threads_.size();
+  }
+
   /// size is not used for chunk dataset.
   optional<size_t> size() const override {
     return torch::nullopt;
@@ -451,16 +573,43 @@ class ChunkDataset final
         batch_buffer_->add_chunk_data(std::current_exception());
       }
     }
-    AT_ASSERT(running_preloaders_.load() > 0);
-    --running_preloaders_;
-    if (running_preloaders_.load() == 0) {
+    const auto running_preloaders = running_preloaders_.fetch_sub(1);
+    AT_ASSERT(running_preloaders > 0);
+    if (running_preloaders == 1) {
       // all preloaders are completed, so we can notify the batch_buffer.
+      batch_buffer_->flush_shuffle_buffer();
       batch_buffer_->stop();
     }
   }
 
+  /// Starts another preloader if `get_batch` waited for `waited`, longer than
+  /// `preloader_scaling_wait`, and `max_preloader_count` allows it.
+  void maybe_add_preloader(std::chrono::milliseconds waited) {
+    if (options_.max_preloader_count() <= options_.preloader_count() ||
+        waited < options_.preloader_scaling_wait()) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(preload_threads_guard_);
+    if (quit_worker_.load() ||
+        preload_threads_.size() >= options_.max_preloader_count()) {
+      return;
+    }
+    // Once the last preloader exited, the chunks are exhausted (or the buffer
+    // is stopped), so there is nothing left for another preloader to do.
+    auto running_preloaders = running_preloaders_.load();
+    do {
+      if (running_preloaders == 0) {
+        return;
+      }
+    } while (!running_preloaders_.compare_exchange_weak(
+        running_preloaders, running_preloaders + 1));
+    const size_t id = preload_threads_.size();
+    preload_threads_.emplace_back([this, id]() { this->preloader(id); });
+  }
+
   /// Block the current thread until the workers finish execution and exit.
   void free_workers() {
+    std::lock_guard<std::mutex> lock(preload_threads_guard_);
     if (!quit_worker_.load()) {
       quit_worker_ = true;
       for (auto& worker_thread : preload_threads_) {
@@ -488,6 +637,9 @@ class ChunkDataset final
   // worker thread pool
   std::vector<std::thread> preload_threads_;
 
+  // mutex to synchronize starting preloaders from get_batch() with reset().
+  mutable std::mutex preload_threads_guard_;
+
   /// The options the Dataset was configured with.
   const ChunkDatasetOptions options_;
 
@@ -15,6 +15,28 @@ namespace datasets {
 namespace detail {
 template <bool C, typename T>
 using optional_if_t = typename std::conditional<C, torch::optional<T>, T>::type;
+
+/// Lets the transform fetch the batch from the dataset itself, if it can, e.g.
+/// so that `transforms::Stack` can have the dataset write into its buffers.
+template <typename Transform, typename Dataset, typename BatchRequest>
+auto apply_batch_transform(
+    Transform& transform,
+    Dataset& dataset,
+    BatchRequest indices,
+    int /* preferred */)
+    -> decltype(transform.collate(dataset, std::move(indices))) {
+  return transform.collate(dataset, std::move(indices));
+}
+
+template <typename Transform, typename Dataset, typename BatchRequest>
+auto apply_batch_transform(
+    Transform& transform,
+    Dataset& dataset,
+    BatchRequest indices,
+    long /* fallback */)
+    -> decltype(transform.apply_batch(dataset.get_batch(std::move(indices)))) {
+  return transform.apply_batch(dataset.get_batch(std::move(indices)));
+}
 } // namespace detail
 
 /// A `MapDataset` is a dataset that applies a transform to a source dataset.
@@ -72,7 +94,8 @@ class MapDataset : public BatchDataset<
       typename D = SourceDataset,
       typename = torch::disable_if_t<D::is_stateful>>
   OutputBatchType get_batch_impl(BatchRequestType indices) {
-    return transform_.apply_batch(dataset_.get_batch(std::move(indices)));
+    return detail::apply_batch_transform(
+        transform_, dataset_, std::move(indices), /*preferred=*/0);
   }
 
   /// The implementation of `get_batch()` for the stateful case. Here, we follow
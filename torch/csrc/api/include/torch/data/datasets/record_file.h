@@ -0,0 +1,156 @@
+#pragma once
+
+#include <torch/data/datasets/base.h>
+#include <torch/data/datasets/chunk.h>
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <c10/util/ArrayRef.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+
+/// Writes a record file, which `RecordFile` reads.
+///
+/// A record file starts with a fixed-size header that holds a magic string, a
+/// version, the number of records and the offset of the index. The records
+/// follow, each one starting at a multiple of 64 bytes, so that its bytes can
+/// be viewed as a tensor of any dtype. The index comes last, and holds the
+/// offset and size of every record. All numbers are 64-bit little-endian.
+class TORCH_API RecordFileWriter {
+ public:
+  /// Creates (or truncates) the record file at `path`.
+  explicit RecordFileWriter(const std::string& path);
+
+  /// Closes the file, if `close()` wasn't called. Errors are ignored, so call
+  /// `close()` to find out whether the file was written completely.
+  ~RecordFileWriter();
+
+  /// Appends a record of `size` bytes.
+  void write(const void* data, size_t size);
+
+  /// Appends a record with the bytes of a CPU tensor.
+  void write(const Tensor& tensor);
+
+  /// Writes the index and the header, and closes the file.
+  void close();
+
+ private:
+  std::string path_;
+  std::ofstream stream_;
+  /// Pairs of (offset, size) of the records written so far.
+  std::vector<std::pair<uint64_t, uint64_t>> index_;
+  uint64_t offset_;
+  bool closed_ = false;
+};
+
+/// A dataset of the records of one or more record files (shards), written by
+/// `RecordFileWriter`.
+///
+/// The files are memory-mapped, and every example is a 1-D `kByte` tensor that
+/// points into the mapping, so reading a record neither parses nor copies it,
+/// and all workers and processes that read the same files share their pages
+/// in the page cache. The index of the records is the index into the
+/// concatenation of the shards.
+///
+/// Copies of a `RecordFile` share the mappings, so it is cheap to copy into
+/// every `DataLoader` worker. It can be sampled with any sampler, e.g. a
+/// `DistributedRandomSampler`, and `RecordFileChunkReader` lets a
+/// `ChunkDataset` read it for the stateful `DataLoader`.
+class TORCH_API RecordFile : public Dataset<RecordFile, TensorExample> {
+ public:
+  /// The expected access pattern, which tells the kernel how much to read
+  /// ahead of the pages that are touched (through `madvise` on POSIX).
+  enum class Access {
+    /// Records are read in random order. No read-ahead beyond the pages of
+    /// the requested records, which `get_batch()` and `prefetch()` request.
+    kRandom,
+    /// Records are mostly read in order of their index. Aggressive read-ahead.
+    kSequential,
+  };
+
+  /// Maps the record file at `path`.
+  explicit RecordFile(const std::string& path, Access access = Access::kRandom);
+
+  /// Maps the record files at `paths`, as consecutive shards of one dataset.
+  explicit RecordFile(
+      const std::vector<std::string>& paths,
+      Access access = Access::kRandom);
+
+  /// Returns the record at the given `index`.
+  TensorExample get(size_t index) override;
+
+  /// Returns the records at the given indices, after asking the kernel to
+  /// read all of them in, so that the reads of a batch overlap.
+  std::vector<TensorExample> get_batch(ArrayRef<size_t> indices) override;
+
+  /// Returns the total number of records.
+  optional<size_t> size() const override;
+
+  /// Returns the number of shards.
+  size_t num_shards() const noexcept;
+
+  /// Returns the index of the first record of the given `shard`.
+  size_t shard_begin(size_t shard) const;
+
+  /// Returns the number of records of the given `shard`.
+  size_t shard_size(size_t shard) const;
+
+  /// Asks the kernel to start reading the records in [`begin`, `end`), which
+  /// must be within one shard.
+  void prefetch(size_t begin, size_t end) const;
+
+ private:
+  struct Shard;
+
+  /// Returns the index of the shard of the record at `index`, and the index of
+  /// the record within the shard.
+  std::pair<size_t, size_t> locate(size_t index) const;
+
+  std::vector<std::shared_ptr<const Shard>> shards_;
+  /// The index of the first record of every shard, and the total number.
+  std::vector<size_t> shard_begins_;
+};
+
+/// A `ChunkDataReader` for a `ChunkDataset` over a `RecordFile`. Every chunk is
+/// a range of consecutive records of one shard, which is prefetched as a whole
+/// before its records are returned.
+class TORCH_API RecordFileChunkReader : public ChunkDataReader<TensorExample> {
+ public:
+  using BatchType = ChunkType;
+
+  /// Splits the shards of `records` into chunks of `records_per_chunk`
+  /// records (fewer at the end of a shard), or into one chunk per shard if
+  /// `records_per_chunk` is zero.
+  explicit RecordFileChunkReader(
+      RecordFile records,
+      size_t records_per_chunk = 0);
+
+  /// Returns the records of the given chunk.
+  ChunkType read_chunk(size_t chunk_index) override;
+
+  /// Returns the number of chunks.
+  size_t chunk_count() override;
+
+  /// Does nothing, since the reader holds no state.
+  void reset() override;
+
+ private:
+  RecordFile records_;
+  /// The [begin, end) index ranges of the chunks.
+  std::vector<std::pair<size_t, size_t>> chunks_;
+};
+} // namespace datasets
+} // namespace data
+} // namespace torch
@@ -25,6 +25,23 @@ struct TensorDataset : public Dataset<TensorDataset, TensorExample> {
     return tensor[index];
   }
 
+  /// Gathers the rows at `indices` directly into `batch`.
+  bool get_batch_into(ArrayRef<size_t> indices, TensorExample& batch) override {
+    auto index = torch::empty(
+        {static_cast<int64_t>(indices.size())},
+        torch::TensorOptions(torch::kLong));
+    auto* index_data = index.data_ptr<int64_t>();
+    for (size_t i = 0; i < indices.size(); ++i) {
+      index_data[i] = static_cast<int64_t>(indices[i]);
+    }
+    if (!batch.data.defined()) {
+      batch.data = torch::empty({0}, tensor.options());
+    }
+    torch::index_select_out(
+        batch.data, tensor, /*dim=*/0, index.to(tensor.device()));
+    return true;
+  }
+
   /// Returns the number of tensors in the dataset.
   optional<size_t> size() const override {
     return tensor.size(0);
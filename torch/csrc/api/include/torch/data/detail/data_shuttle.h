@@ -1,6 +1,6 @@
 #pragma once
 
-#include <torch/data/detail/queue.h>
+#include <torch/data/detail/lock_free_queue.h>
 #include <torch/types.h>
 
 #include <c10/util/Exception.h>
@@ -22,9 +22,16 @@ namespace detail {
 /// dequeues a result is the count of in-flight jobs decremented. When the main
 /// thread attempts to dequeue a job but no jobs are in-flight, that means the
 /// epoch is complete and `pop_result` returns an empty optional.
+///
+/// Jobs and results travel through bounded `LockFreeQueue`s, so the `capacity`
+/// must be at least the maximum number of jobs in flight. `push_job()` and
+/// `push_result()` block while their queue is full.
 template <typename Job, typename Result>
 class DataShuttle {
  public:
+  explicit DataShuttle(size_t capacity = kDefaultCapacity)
+      : new_jobs_(capacity), results_(capacity) {}
+
   /// Pushes a new job. Called by the main thread.
   void push_job(Job job) {
     new_jobs_.push(std::move(job));
@@ -73,15 +80,20 @@ class DataShuttle {
   }
 
  private:
+  static constexpr size_t kDefaultCapacity = 1024;
+
   /// The queue for jobs that are not yet in flight.
-  Queue<Job> new_jobs_;
+  LockFreeQueue<Job> new_jobs_;
   /// The number of in-flight jobs.
   /// NOTE: Not atomic because only manipulated by the main thread.
   size_t in_flight_jobs_ = 0;
   /// The queue for results of finished jobs.
-  Queue<Result> results_;
+  LockFreeQueue<Result> results_;
 };
 
+template <typename Job, typename Result>
+constexpr size_t DataShuttle<Job, Result>::kDefaultCapacity;
+
 } // namespace detail
 } // namespace data
 } // namespace torch
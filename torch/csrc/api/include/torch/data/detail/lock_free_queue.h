@@ -0,0 +1,242 @@
+#pragma once
+
+#include <torch/types.h>
+
+#include <c10/util/Exception.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// A bounded, blocking MPMC queue that doesn't take a lock to `push` or `pop`.
+///
+/// The elements are stored in a ring buffer of `capacity` slots (rounded up to
+/// a power of two). Every slot has a sequence number that tells producers and
+/// consumers whose turn it is, so a `push` or `pop` claims its slot with a
+/// single compare-and-swap on the tail or head of the queue.
+///
+/// When the queue is empty (or full), `pop()` (or `push()`) spins for a short
+/// while, and then parks on a condition variable. The other side only takes
+/// the lock to wake it up if some thread is parked, so threads never contend
+/// on the lock while the queue is neither empty nor full.
+///
+/// Like `Queue`, this is written specifically for use with the `DataLoader`,
+/// which bounds the number of elements in flight.
+template <typename T>
+class LockFreeQueue {
+ public:
+  explicit LockFreeQueue(size_t capacity)
+      : capacity_(round_up_to_power_of_two(capacity)),
+        mask_(capacity_ - 1),
+        slots_(new Slot[capacity_]) {
+    for (size_t i = 0; i < capacity_; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  LockFreeQueue(const LockFreeQueue&) = delete;
+  LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+  ~LockFreeQueue() {
+    clear();
+  }
+
+  /// Pushes a new value to the back of the queue, blocking while the queue is
+  /// full, and wakes up one thread waiting inside `pop()`, if any.
+  void push(T value) {
+    if (!spin_until([&] { return try_push(value); })) {
+      park(not_full_, [&] { return try_push(value); }, nullopt);
+    }
+    wake(not_empty_);
+  }
+
+  /// Pushes a new value to the back of the queue if it isn't full. Returns
+  /// whether the value was pushed; `value` is left untouched if it wasn't.
+  bool try_push(T& value) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      Slot& slot = slots_[tail & mask_];
+      const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(sequence) -
+          static_cast<std::ptrdiff_t>(tail);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(
+                tail, tail + 1, std::memory_order_relaxed)) {
+          new (&slot.storage) T(std::move(value));
+          slot.sequence.store(tail + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // The slot still holds the element pushed one lap earlier.
+        return false;
+      } else {
+        tail = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Blocks until at least one element is ready to be popped from the front of
+  /// the queue. An optional `timeout` in seconds can be used to limit the time
+  /// spent waiting for an element. If the wait times out, an exception is
+  /// raised.
+  T pop(optional<std::chrono::milliseconds> timeout = nullopt) {
+    optional<T> value;
+    if (!spin_until([&] { return try_pop(value); })) {
+      if (!park(not_empty_, [&] { return try_pop(value); }, timeout)) {
+        // clang-format off
+        AT_ERROR(
+            "Timeout in DataLoader queue while waiting for next batch"
+            " (timeout was ", timeout->count(), " ms)");
+        // clang-format on
+      }
+    }
+    wake(not_full_);
+    return std::move(*value);
+  }
+
+  /// Pops the element at the front of the queue into `value` if the queue
+  /// isn't empty. Returns whether an element was popped.
+  bool try_pop(optional<T>& value) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    while (true) {
+      Slot& slot = slots_[head & mask_];
+      const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(sequence) -
+          static_cast<std::ptrdiff_t>(head + 1);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(
+                head, head + 1, std::memory_order_relaxed)) {
+          T* element = reinterpret_cast<T*>(&slot.storage);
+          value = std::move(*element);
+          element->~T();
+          slot.sequence.store(head + capacity_, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // No element was pushed into the slot yet.
+        return false;
+      } else {
+        head = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Empties the queue and returns the number of elements that were popped.
+  /// Threads waiting inside `push()` are woken up, since there is room now.
+  size_t clear() {
+    size_t size = 0;
+    optional<T> value;
+    while (try_pop(value)) {
+      ++size;
+    }
+    if (size > 0) {
+      wake(not_full_);
+    }
+    return size;
+  }
+
+  /// Returns the number of slots of the queue.
+  size_t capacity() const noexcept {
+    return capacity_;
+  }
+
+ private:
+  /// Number of failed attempts before a waiting thread parks.
+  static constexpr int kSpinCount = 1024;
+
+  struct Slot {
+    std::atomic<size_t> sequence;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  };
+
+  /// The threads parked until the queue is no longer empty or full.
+  struct Waiters {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<size_t> count{0};
+  };
+
+  static size_t round_up_to_power_of_two(size_t capacity) {
+    size_t rounded = 1;
+    while (rounded < capacity) {
+      rounded <<= 1;
+    }
+    return rounded;
+  }
+
+  /// Retries `attempt` for a while, yielding the CPU on later attempts.
+  template <typename Attempt>
+  static bool spin_until(Attempt&& attempt) {
+    for (int i = 0; i < kSpinCount; ++i) {
+      if (attempt()) {
+        return true;
+      }
+      if (i >= kSpinCount / 2) {
+        std::this_thread::yield();
+      }
+    }
+    return false;
+  }
+
+  /// Waits on `waiters` until `attempt` succeeds, or `timeout` elapses.
+  /// Returns whether `attempt` succeeded.
+  template <typename Attempt>
+  static bool park(
+      Waiters& waiters,
+      Attempt&& attempt,
+      optional<std::chrono::milliseconds> timeout) {
+    std::unique_lock<std::mutex> lock(waiters.mutex);
+    // The count is incremented before `attempt` runs again, and the waking
+    // side checks it after changing the queue, so either this thread sees the
+    // change, or the waking side sees this thread and notifies it.
+    waiters.count.fetch_add(1, std::memory_order_seq_cst);
+    bool succeeded = true;
+    if (timeout) {
+      succeeded = waiters.cv.wait_for(lock, *timeout, attempt);
+    } else {
+      waiters.cv.wait(lock, attempt);
+    }
+    waiters.count.fetch_sub(1, std::memory_order_relaxed);
+    return succeeded;
+  }
+
+  /// Wakes up one thread parked on `waiters`, if any.
+  static void wake(Waiters& waiters) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.count.load(std::memory_order_relaxed) > 0) {
+      // Taking the lock makes sure that the parked thread is either waiting
+      // on the condition variable, or yet to check the queue again.
+      { std::lock_guard<std::mutex> lock(waiters.mutex); }
+      waiters.cv.notify_one();
+    }
+  }
+
+  const size_t capacity_;
+  const size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+
+  // Producers and consumers claim slots from different cache lines.
+  alignas(64) std::atomic<size_t> tail_{0};
+  alignas(64) std::atomic<size_t> head_{0};
+
+  Waiters not_empty_;
+  Waiters not_full_;
+};
+
+template <typename T>
+constexpr int LockFreeQueue<T>::kSpinCount;
+
+} // namespace detail
+} // namespace data
+} // namespace torch
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <c10/core/Event.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
+#include <c10/util/Optional.h>
+
+#include <cstddef>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// Calls `function` with a reference to every tensor in `batch`. Tensors are
+/// found inside `Tensor`, `Example`, `std::vector` and `optional` batches,
+/// possibly nested. Batches of any other type hold no tensors.
+template <typename F>
+void for_each_tensor(Tensor& tensor, const F& function);
+template <typename Data, typename Target, typename F>
+void for_each_tensor(Example<Data, Target>& example, const F& function);
+template <typename Data, typename F>
+void for_each_tensor(
+    Example<Data, example::NoTarget>& example,
+    const F& function);
+template <typename T, typename F>
+void for_each_tensor(std::vector<T>& batch, const F& function);
+template <typename T, typename F>
+void for_each_tensor(optional<T>& batch, const F& function);
+template <typename T, typename F>
+void for_each_tensor(T& /* unused */, const F& /* unused */) {}
+
+template <typename F>
+void for_each_tensor(Tensor& tensor, const F& function) {
+  function(tensor);
+}
+
+template <typename Data, typename Target, typename F>
+void for_each_tensor(Example<Data, Target>& example, const F& function) {
+  for_each_tensor(example.data, function);
+  for_each_tensor(example.target, function);
+}
+
+template <typename Data, typename F>
+void for_each_tensor(
+    Example<Data, example::NoTarget>& example,
+    const F& function) {
+  for_each_tensor(example.data, function);
+}
+
+template <typename T, typename F>
+void for_each_tensor(std::vector<T>& batch, const F& function) {
+  for (auto& element : batch) {
+    for_each_tensor(element, function);
+  }
+}
+
+template <typename T, typename F>
+void for_each_tensor(optional<T>& batch, const F& function) {
+  if (batch) {
+    for_each_tensor(*batch, function);
+  }
+}
+
+/// Moves every CPU tensor in `batch` into pinned (page-locked) host memory,
+/// unless it is pinned already. Pinned memory comes from the caching host
+/// allocator, so the buffers of earlier batches are reused once the copies
+/// out of them have finished.
+template <typename Batch>
+void pin_memory(Batch& batch) {
+  for_each_tensor(batch, [](Tensor& tensor) {
+    if (tensor.defined() && tensor.device().is_cpu()) {
+      tensor = tensor.pin_memory();
+    }
+  });
+}
+
+/// Copies batches to a device, a few batches ahead of the one that is used.
+///
+/// The copies of a batch are issued with `non_blocking=true` on a side stream
+/// taken from the pool of the device, so they overlap with whatever runs on
+/// the current stream, and with the copies of later batches the data loader
+/// prefetches. This only saves time if the tensors are in pinned memory. When
+/// a batch is handed out by `next()`, the current stream waits for its copies.
+///
+/// The device tensors are allocated on the current stream, and the side stream
+/// waits for the current stream before copying into them, so memory that the
+/// current stream freed is never overwritten while it is still in use.
+template <typename Batch>
+class DevicePrefetcher {
+ public:
+  /// Constructs a `DevicePrefetcher` that copies up to `depth` batches ahead
+  /// of the one returned by `next()`.
+  DevicePrefetcher(Device device, size_t depth)
+      : device_(resolve(device)), depth_(depth) {}
+
+  /// Returns the next batch, with its tensors on the device, or nullopt once
+  /// `next_batch`, which returns the next batch on the host or nullopt, is
+  /// exhausted. Calls `next_batch` until `depth` more batches are in flight.
+  template <typename F>
+  optional<Batch> next(F&& next_batch) {
+    while (transfers_.size() <= depth_) {
+      optional<Batch> batch = next_batch();
+      if (!batch) {
+        break;
+      }
+      transfers_.push_back(start(std::move(*batch)));
+    }
+    if (transfers_.empty()) {
+      return nullopt;
+    }
+    Transfer transfer = std::move(transfers_.front());
+    transfers_.pop_front();
+    if (transfer.copied) {
+      c10::impl::VirtualGuardImpl impl(device_.type());
+      transfer.copied->block(impl.getStream(device_));
+    }
+    return std::move(transfer.batch);
+  }
+
+  /// Discards the batches that were prefetched but not returned yet.
+  void clear() {
+    transfers_.clear();
+  }
+
+ private:
+  struct Transfer {
+    Batch batch;
+    /// Recorded on the side stream once the copies of the batch were issued.
+    optional<c10::Event> copied;
+  };
+
+  static Device resolve(Device device) {
+    if (device.is_cpu() || device.has_index()) {
+      return device;
+    }
+    return c10::impl::VirtualGuardImpl(device.type()).getDevice();
+  }
+
+  Transfer start(Batch batch) {
+    if (device_.is_cpu()) {
+      for_each_tensor(batch, [this](Tensor& tensor) {
+        if (tensor.defined()) {
+          tensor = tensor.to(device_);
+        }
+      });
+      return {std::move(batch), nullopt};
+    }
+
+    // Pairs of (source, destination).
+    std::vector<std::pair<Tensor, Tensor>> copies;
+    for_each_tensor(batch, [this, &copies](Tensor& tensor) {
+      if (tensor.defined() && tensor.device() != device_) {
+        auto destination =
+            torch::empty(tensor.sizes(), tensor.options().device(device_));
+        copies.emplace_back(tensor, destination);
+        tensor = std::move(destination);
+      }
+    });
+    if (copies.empty()) {
+      return {std::move(batch), nullopt};
+    }
+
+    c10::impl::VirtualGuardImpl impl(device_.type());
+    if (!stream_) {
+      stream_ = impl.getStreamFromPool(device_);
+    }
+    c10::Event allocated(device_.type());
+    allocated.record(impl.getStream(device_));
+    allocated.block(*stream_);
+    {
+      c10::StreamGuard guard(*stream_);
+      for (auto& copy : copies) {
+        copy.second.copy_(copy.first, /*non_blocking=*/true);
+      }
+    }
+    c10::Event copied(device_.type());
+    copied.record(*stream_);
+    return {std::move(batch), std::move(copied)};
+  }
+
+  const Device device_;
+  const size_t depth_;
+  /// The side stream, taken from the pool on first use.
+  optional<c10::Stream> stream_;
+  std::deque<Transfer> transfers_;
+};
+
+} // namespace detail
+} // namespace data
+} // namespace torch
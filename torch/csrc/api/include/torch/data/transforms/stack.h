@@ -1,9 +1,13 @@
 #pragma once
 
+#include <torch/data/detail/transfer.h>
 #include <torch/data/example.h>
 #include <torch/data/transforms/collate.h>
 #include <torch/types.h>
 
+#include <c10/util/ArrayRef.h>
+
+#include <cstddef>
 #include <utility>
 #include <vector>
 
@@ -11,13 +15,84 @@ namespace torch {
 namespace data {
 namespace transforms {
 
+namespace detail {
+/// Stacks `tensors` into one new tensor, which is allocated in pinned
+/// (page-locked) host memory if `pin_memory` is true.
+inline Tensor stack(const std::vector<Tensor>& tensors, bool pin_memory) {
+  if (!pin_memory || tensors.empty()) {
+    return torch::stack(tensors);
+  }
+  auto sizes = tensors.front().sizes().vec();
+  sizes.insert(sizes.begin(), static_cast<int64_t>(tensors.size()));
+  auto output =
+      torch::empty(sizes, tensors.front().options().pinned_memory(true));
+  return torch::stack_out(output, tensors);
+}
+
+/// A few batches whose tensors are reused for later batches, once nothing
+/// outside of the pool refers to them anymore.
+template <typename Batch>
+class BatchPool {
+ public:
+  /// Returns a batch of the pool that is no longer in use, or a new batch with
+  /// undefined tensors if all of them are.
+  Batch& acquire() {
+    for (auto& batch : batches_) {
+      if (!in_use(batch)) {
+        return batch;
+      }
+    }
+    if (batches_.size() < kMaxBatches) {
+      batches_.emplace_back();
+      return batches_.back();
+    }
+    // Let go of the oldest batch, which stays alive where it's in use.
+    auto& batch = batches_[next_evicted_];
+    next_evicted_ = (next_evicted_ + 1) % kMaxBatches;
+    batch = Batch();
+    return batch;
+  }
+
+ private:
+  static constexpr size_t kMaxBatches = 8;
+
+  /// Whether some tensor of `batch`, or some view of it, is referenced outside
+  /// of the pool.
+  static bool in_use(Batch& batch) {
+    bool used = false;
+    data::detail::for_each_tensor(batch, [&used](Tensor& tensor) {
+      if (tensor.defined() &&
+          (tensor.use_count() > 1 ||
+           (tensor.has_storage() && tensor.storage().use_count() > 1))) {
+        used = true;
+      }
+    });
+    return used;
+  }
+
+  std::vector<Batch> batches_;
+  size_t next_evicted_ = 0;
+};
+
+template <typename Batch>
+constexpr size_t BatchPool<Batch>::kMaxBatches;
+} // namespace detail
+
 template <typename T = Example<>>
 struct Stack;
 
 /// A `Collation` for `Example<Tensor, Tensor>` types that stacks all data
 /// tensors into one tensor, and all target (label) tensors into one tensor.
+/// If `pin_memory` is true, the tensors are stacked directly into pinned host
+/// memory, e.g. for a `DataLoader` that copies batches to a CUDA device.
+///
+/// When mapped over a dataset that implements `get_batch_into()`, the dataset
+/// writes every batch directly into the tensors of a batch that is no longer
+/// in use, instead of allocating a tensor per example that is then copied.
 template <>
 struct Stack<Example<>> : public Collation<Example<>> {
+  explicit Stack(bool pin_memory = false) : pin_memory_(pin_memory) {}
+
   Example<> apply_batch(std::vector<Example<>> examples) override {
     std::vector<torch::Tensor> data, targets;
     data.reserve(examples.size());
@@ -26,23 +101,68 @@ struct Stack<Example<>> : public Collation<Example<>> {
       data.push_back(std::move(example.data));
       targets.push_back(std::move(example.target));
     }
-    return {torch::stack(data), torch::stack(targets)};
+    return {
+        detail::stack(data, pin_memory_), detail::stack(targets, pin_memory_)};
+  }
+
+  /// Returns the collated batch of `dataset` at `indices`; see the class
+  /// comment. Called by `MapDataset`.
+  template <typename Dataset>
+  auto collate(Dataset& dataset, ArrayRef<size_t> indices)
+      -> decltype(dataset.get_batch_into(indices, std::declval<Example<>&>()),
+                  Example<>()) {
+    // Pinned buffers are left to the caching host allocator, which doesn't
+    // reuse them before the asynchronous copies out of them have finished.
+    if (!pin_memory_) {
+      auto& batch = pool_.acquire();
+      if (dataset.get_batch_into(indices, batch)) {
+        return batch;
+      }
+    }
+    return apply_batch(dataset.get_batch(indices));
   }
+
+ private:
+  bool pin_memory_;
+  detail::BatchPool<Example<>> pool_;
 };
 
 /// A `Collation` for `Example<Tensor, NoTarget>` types that stacks all data
-/// tensors into one tensor.
+/// tensors into one tensor, in pinned host memory if `pin_memory` is true.
+/// Like `Stack<Example<>>`, it lets datasets that implement `get_batch_into()`
+/// write batches directly into pooled tensors.
 template <>
 struct Stack<TensorExample>
     : public Collation<Example<Tensor, example::NoTarget>> {
+  explicit Stack(bool pin_memory = false) : pin_memory_(pin_memory) {}
+
   TensorExample apply_batch(std::vector<TensorExample> examples) override {
     std::vector<torch::Tensor> data;
     data.reserve(examples.size());
     for (auto& example : examples) {
       data.push_back(std::move(example.data));
     }
-    return torch::stack(data);
+    return detail::stack(data, pin_memory_);
   }
+
+  /// Returns the collated batch of `dataset` at `indices`. Called by
+  /// `MapDataset`.
+  template <typename Dataset>
+  auto collate(Dataset& dataset, ArrayRef<size_t> indices) -> decltype(
+      dataset.get_batch_into(indices, std::declval<TensorExample&>()),
+      TensorExample()) {
+    if (!pin_memory_) {
+      auto& batch = pool_.acquire();
+      if (dataset.get_batch_into(indices, batch)) {
+        return batch;
+      }
+    }
+    return apply_batch(dataset.get_batch(indices));
+  }
+
+ private:
+  bool pin_memory_;
+  detail::BatchPool<TensorExample> pool_;
 };
 } // namespace transforms
 } // namespace data
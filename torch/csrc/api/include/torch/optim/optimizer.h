@@ -167,7 +167,27 @@ b) For c10::nullopt value: in param state, c10::nullopt value in C++ impl is equ
    missing key in Python impl. Since we don't serialize missing keys in Python API,
    we skip c10::nullopt values when serializing the param state. */
 
+/// Moves `params`, which must be dense leaf tensors of the same type on the
+/// same device, into one contiguous buffer, and their gradients into another
+/// one. Every parameter becomes a view into the buffer, so the modules that
+/// own them keep working, and their gradients accumulate into the gradient
+/// buffer. The returned tensor is the flat parameter, whose gradient is the
+/// flat gradient buffer. Passing it to an optimizer instead of `params` makes
+/// its state flat as well, so that every step is one fused pass over one
+/// tensor per state. Moving the parameters afterwards, e.g. with
+/// `Module::to()`, or backward passes that create a graph replace the views
+/// and break the link to the flat tensors.
+TORCH_API Tensor flatten_parameters(const std::vector<Tensor>& params);
+
 /// Serializes an `Optimizer` into an `OutputArchive`.
+namespace detail {
+/// Returns true if `tensors` (a parameter, its gradient and its optimizer
+/// state) can be updated by the fused optimizer kernels, i.e., if they are
+/// dense, contiguous tensors of the same floating point type on the same
+/// device, which is either a CUDA device, or the CPU for float and double.
+TORCH_API bool can_use_fused_step(at::ArrayRef<Tensor> tensors);
+} // namespace detail
+
 TORCH_API serialize::OutputArchive& operator<<(
     serialize::OutputArchive& archive,
     const Optimizer& optimizer);
@@ -2,6 +2,7 @@
 
 #include <ATen/Parallel.h>
 #include <ATen/record_function.h>
+#include <c10/core/InferenceMode.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/api/include/torch/types.h>
 #include <cstdint>
@@ -66,6 +67,40 @@ using NoGradGuard = at::NoGradGuard;
 /// @endcode
 using AutoGradMode = at::AutoGradMode;
 
+/// A RAII, thread-local guard for running modules purely for inference.
+///
+/// In addition to disabling gradient calculation like ``NoGradGuard``,
+/// ``InferenceMode`` skips the autograd layer of the dispatcher altogether, and
+/// tensors created under it don't carry a version counter, so operators run
+/// with no autograd bookkeeping at all. In exchange, tensors created in
+/// inference mode cannot be saved for backward: using them in computations
+/// that record autograd history once the guard is gone throws.
+///
+/// This context manager is thread-local; it will not affect computation
+/// in other threads.
+///
+/// Example:
+/// @code
+/// torch::nn::Linear model(3, 4);
+/// {
+///   torch::InferenceMode guard;
+///   auto y = model(torch::ones({2, 3}));
+///   std::cout << y.requires_grad() << std::endl; // prints `false`
+/// }
+/// @endcode
+class InferenceMode {
+ public:
+  InferenceMode() = default;
+
+  static bool is_enabled() {
+    return c10::InferenceMode::is_enabled();
+  }
+
+ private:
+  at::AutoGradMode grad_mode_{false};
+  c10::InferenceMode inference_mode_;
+};
+
 /// Sets the global random seed for all newly created CPU and CUDA tensors.
 using at::manual_seed;
 
@@ -0,0 +1,332 @@
+#include <torch/data/datasets/record_file.h>
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <TH/THAllocator.h>
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace torch {
+namespace data {
+namespace datasets {
+namespace {
+constexpr char kMagic[8] = {'T', 'O', 'R', 'C', 'H', 'R', 'E', 'C'};
+constexpr uint64_t kVersion = 1;
+constexpr uint64_t kRecordAlignment = 64;
+
+struct Header {
+  char magic[8];
+  uint64_t version;
+  uint64_t num_records;
+  uint64_t index_offset;
+};
+static_assert(sizeof(Header) == 32, "The record file header must be packed");
+
+struct IndexEntry {
+  uint64_t offset;
+  uint64_t size;
+};
+static_assert(sizeof(IndexEntry) == 16, "Index entries must be packed");
+
+uint64_t align(uint64_t offset) {
+  return (offset + kRecordAlignment - 1) / kRecordAlignment * kRecordAlignment;
+}
+
+bool check_is_little_endian() {
+  const uint32_t word = 1;
+  return reinterpret_cast<const uint8_t*>(&word)[0] == 1;
+}
+} // namespace
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ RecordFileWriter ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+RecordFileWriter::RecordFileWriter(const std::string& path)
+    : path_(path),
+      stream_(path, std::ios::binary | std::ios::trunc),
+      offset_(sizeof(Header)) {
+  TORCH_CHECK(stream_, "Error opening record file at ", path_);
+  TORCH_CHECK(
+      check_is_little_endian(),
+      "Record files can only be written on little-endian hosts");
+  // The header is written last, once the index offset is known.
+  const Header header{};
+  stream_.write(reinterpret_cast<const char*>(&header), sizeof header);
+}
+
+RecordFileWriter::~RecordFileWriter() {
+  if (!closed_) {
+    try {
+      close();
+    } catch (...) {
+    }
+  }
+}
+
+void RecordFileWriter::write(const void* data, size_t size) {
+  TORCH_CHECK(!closed_, "Attempted to write to a closed record file");
+  const uint64_t offset = align(offset_);
+  static const char kPadding[kRecordAlignment] = {};
+  stream_.write(kPadding, offset - offset_);
+  stream_.write(static_cast<const char*>(data), size);
+  TORCH_CHECK(stream_, "Error writing to record file at ", path_);
+  index_.emplace_back(offset, size);
+  offset_ = offset + size;
+}
+
+void RecordFileWriter::write(const Tensor& tensor) {
+  TORCH_CHECK(
+      tensor.device().is_cpu(),
+      "Only CPU tensors can be written to record files, got a tensor on ",
+      tensor.device());
+  const auto contiguous = tensor.contiguous();
+  write(contiguous.data_ptr(), contiguous.nbytes());
+}
+
+void RecordFileWriter::close() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  const uint64_t index_offset = align(offset_);
+  static const char kPadding[kRecordAlignment] = {};
+  stream_.write(kPadding, index_offset - offset_);
+  for (const auto& entry : index_) {
+    const IndexEntry index_entry{entry.first, entry.second};
+    stream_.write(
+        reinterpret_cast<const char*>(&index_entry), sizeof index_entry);
+  }
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof kMagic);
+  header.version = kVersion;
+  header.num_records = index_.size();
+  header.index_offset = index_offset;
+  stream_.seekp(0);
+  stream_.write(reinterpret_cast<const char*>(&header), sizeof header);
+  stream_.close();
+  TORCH_CHECK(stream_, "Error writing to record file at ", path_);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ RecordFile ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+struct RecordFile::Shard {
+  Shard(const std::string& path, Access access) : path(path) {
+    size_t mapped_size = 0;
+    mapping = THMapAllocator::makeDataPtr(
+        path.c_str(), /*flags=*/0, /*size=*/0, &mapped_size);
+    size = mapped_size;
+    base = static_cast<const uint8_t*>(mapping.get());
+    TORCH_CHECK(
+        base != nullptr && size >= sizeof(Header),
+        "Error mapping record file at ",
+        path);
+
+    Header header;
+    std::memcpy(&header, base, sizeof header);
+    TORCH_CHECK(
+        std::memcmp(header.magic, kMagic, sizeof kMagic) == 0,
+        "The file at ",
+        path,
+        " is not a record file");
+    TORCH_CHECK(
+        header.version == kVersion,
+        "Unsupported version ",
+        header.version,
+        " of the record file at ",
+        path);
+    TORCH_CHECK(
+        header.index_offset <= size &&
+            header.num_records <=
+                (size - header.index_offset) / sizeof(IndexEntry),
+        "The index of the record file at ",
+        path,
+        " is truncated");
+    num_records = header.num_records;
+    index = reinterpret_cast<const IndexEntry*>(base + header.index_offset);
+    for (size_t i = 0; i < num_records; ++i) {
+      TORCH_CHECK(
+          index[i].offset <= header.index_offset &&
+              index[i].size <= header.index_offset - index[i].offset,
+          "Record ",
+          i,
+          " of the record file at ",
+          path,
+          " is out of bounds");
+    }
+    advise(0, size, access == Access::kRandom ? kRandom : kSequential);
+  }
+
+  enum Advice { kRandom, kSequential, kWillNeed };
+
+  /// Forwards `advice` for the bytes in [begin, end) to `madvise`. This is only
+  /// a hint, so failures are ignored, and it does nothing on Windows.
+  void advise(uint64_t begin, uint64_t end, Advice advice) const {
+#ifndef _WIN32
+    static const uint64_t page_size = sysconf(_SC_PAGESIZE);
+    begin = begin / page_size * page_size;
+    if (begin >= end) {
+      return;
+    }
+    int flag = MADV_WILLNEED;
+    if (advice == kRandom) {
+      flag = MADV_RANDOM;
+    } else if (advice == kSequential) {
+      flag = MADV_SEQUENTIAL;
+    }
+    madvise(const_cast<uint8_t*>(base) + begin, end - begin, flag);
+#endif
+  }
+
+  std::string path;
+  at::DataPtr mapping;
+  size_t size;
+  const uint8_t* base;
+  size_t num_records;
+  const IndexEntry* index;
+};
+
+RecordFile::RecordFile(const std::string& path, Access access)
+    : RecordFile(std::vector<std::string>{path}, access) {}
+
+RecordFile::RecordFile(const std::vector<std::string>& paths, Access access) {
+  shards_.reserve(paths.size());
+  shard_begins_.reserve(paths.size() + 1);
+  shard_begins_.push_back(0);
+  for (const auto& path : paths) {
+    shards_.push_back(std::make_shared<const Shard>(path, access));
+    shard_begins_.push_back(shard_begins_.back() + shards_.back()->num_records);
+  }
+}
+
+std::pair<size_t, size_t> RecordFile::locate(size_t index) const {
+  TORCH_CHECK(
+      index < shard_begins_.back(),
+      "Index ",
+      index,
+      " is out of range for a record file with ",
+      shard_begins_.back(),
+      " records");
+  // The first shard that begins after `index`, minus one.
+  const size_t shard = std::upper_bound(
+                           shard_begins_.begin(), shard_begins_.end(), index) -
+      shard_begins_.begin() - 1;
+  return {shard, index - shard_begins_[shard]};
+}
+
+TensorExample RecordFile::get(size_t index) {
+  const auto location = locate(index);
+  // The tensor keeps the mapping of its shard alive.
+  auto shard = shards_[location.first];
+  const auto& entry = shard->index[location.second];
+  return torch::from_blob(
+      const_cast<uint8_t*>(shard->base) + entry.offset,
+      {static_cast<int64_t>(entry.size)},
+      [shard](void* /* unused */) {},
+      torch::kByte);
+}
+
+std::vector<TensorExample> RecordFile::get_batch(ArrayRef<size_t> indices) {
+  for (const auto index : indices) {
+    const auto location = locate(index);
+    const auto& shard = *shards_[location.first];
+    const auto& entry = shard.index[location.second];
+    shard.advise(entry.offset, entry.offset + entry.size, Shard::kWillNeed);
+  }
+  return Dataset<RecordFile, TensorExample>::get_batch(indices);
+}
+
+optional<size_t> RecordFile::size() const {
+  return shard_begins_.back();
+}
+
+size_t RecordFile::num_shards() const noexcept {
+  return shards_.size();
+}
+
+size_t RecordFile::shard_begin(size_t shard) const {
+  TORCH_CHECK(shard < shards_.size(), "Shard ", shard, " is out of range");
+  return shard_begins_[shard];
+}
+
+size_t RecordFile::shard_size(size_t shard) const {
+  TORCH_CHECK(shard < shards_.size(), "Shard ", shard, " is out of range");
+  return shards_[shard]->num_records;
+}
+
+void RecordFile::prefetch(size_t begin, size_t end) const {
+  if (begin >= end) {
+    return;
+  }
+  const auto first = locate(begin);
+  const auto last = locate(end - 1);
+  TORCH_CHECK(
+      first.first == last.first,
+      "Records ",
+      begin,
+      " to ",
+      end,
+      " span more than one shard");
+  const auto& shard = *shards_[first.first];
+  const auto& last_entry = shard.index[last.second];
+  shard.advise(
+      shard.index[first.second].offset,
+      last_entry.offset + last_entry.size,
+      Shard::kWillNeed);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ RecordFileChunkReader ~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+RecordFileChunkReader::RecordFileChunkReader(
+    RecordFile records,
+    size_t records_per_chunk)
+    : records_(std::move(records)) {
+  for (size_t shard = 0; shard < records_.num_shards(); ++shard) {
+    const auto begin = records_.shard_begin(shard);
+    const auto end = begin + records_.shard_size(shard);
+    const auto step = records_per_chunk > 0 ? records_per_chunk : end - begin;
+    for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += step) {
+      chunks_.emplace_back(chunk_begin, std::min(chunk_begin + step, end));
+    }
+  }
+}
+
+RecordFileChunkReader::ChunkType RecordFileChunkReader::read_chunk(
+    size_t chunk_index) {
+  TORCH_CHECK(
+      chunk_index < chunks_.size(),
+      "Chunk ",
+      chunk_index,
+      " is out of range for ",
+      chunks_.size(),
+      " chunks");
+  const auto& chunk = chunks_[chunk_index];
+  records_.prefetch(chunk.first, chunk.second);
+  ChunkType examples;
+  examples.reserve(chunk.second - chunk.first);
+  for (size_t index = chunk.first; index < chunk.second; ++index) {
+    examples.push_back(records_.get(index));
+  }
+  return examples;
+}
+
+size_t RecordFileChunkReader::chunk_count() {
+  return chunks_.size();
+}
+
+void RecordFileChunkReader::reset() {}
+
+} // namespace datasets
+} // namespace data
+} // namespace torch
@@ -7,7 +7,10 @@
 
 #include <ATen/ATen.h>
 
+#include <array>
 #include <functional>
+#include <map>
+#include <tuple>
 
 namespace torch {
 namespace optim {
@@ -63,6 +66,12 @@ Tensor Adagrad::step(LossClosure closure) {
     loss = closure();
   }
   for (auto& group : param_groups_) {
+    auto& options = static_cast<AdagradOptions&>(group.options());
+    // Parameters updated by the fused kernels, which take tensors on a
+    // single device and decay the learning rate for one step count per call.
+    // The lists are params, grads and state sums.
+    std::map<std::tuple<int64_t, c10::DeviceIndex, at::ScalarType>,
+             std::array<std::vector<Tensor>, 3>> fused;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
@@ -70,10 +79,17 @@ Tensor Adagrad::step(LossClosure closure) {
       auto grad = p.grad();
       TORCH_INTERNAL_ASSERT(state_[c10::guts::to_string(p.unsafeGetTensorImpl())] != nullptr, "state found NULL for the Tensor ", p);
       auto& state = static_cast<AdagradParamState&>(*state_[c10::guts::to_string(p.unsafeGetTensorImpl())]);
-      auto& options = static_cast<AdagradOptions&>(group.options());
 
       state.step(state.step() + 1);
 
+      if (detail::can_use_fused_step({p, grad, state.sum()})) {
+        auto& lists = fused[std::make_tuple(state.step(), p.device().index(), p.scalar_type())];
+        lists[0].push_back(p);
+        lists[1].push_back(grad);
+        lists[2].push_back(state.sum());
+        continue;
+      }
+
       if (options.weight_decay() != 0) {
         TORCH_CHECK(!p.grad().is_sparse(), "weight_decay option is not compatible with sparse gradients");
         grad = grad.add(p, options.weight_decay());
@@ -105,6 +121,13 @@ Tensor Adagrad::step(LossClosure closure) {
         p.addcdiv_(grad, std, -clr);
       }
     }
+
+    for (auto& entry : fused) {
+      auto& lists = entry.second;
+      at::_fused_adagrad_(lists[0], lists[1], lists[2], options.lr(),
+                          options.lr_decay(), options.weight_decay(),
+                          options.eps(), /*step=*/std::get<0>(entry.first));
+    }
   }
   return loss;
 }
@@ -7,8 +7,11 @@
 
 #include <ATen/ATen.h>
 
+#include <array>
 #include <cmath>
 #include <functional>
+#include <map>
+#include <tuple>
 
 namespace torch {
 namespace optim {
@@ -69,6 +72,13 @@ Tensor Adam::step(LossClosure closure)  {
     loss = closure();
   }
   for (auto& group : param_groups_) {
+    auto& options = static_cast<AdamOptions&>(group.options());
+    // Parameters updated by the fused kernels, which take tensors on a
+    // single device and apply one bias correction, i.e., one step count,
+    // per call. The lists are params, grads, exp_avgs, exp_avg_sqs and
+    // max_exp_avg_sqs.
+    std::map<std::tuple<int64_t, c10::DeviceIndex, at::ScalarType>,
+             std::array<std::vector<Tensor>, 5>> fused;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
@@ -76,7 +86,6 @@ Tensor Adam::step(LossClosure closure)  {
       auto grad = p.grad();
       TORCH_CHECK(!grad.is_sparse(), "Adam does not support sparse gradients"/*, please consider SparseAdam instead*/);
       auto param_state = state_.find(c10::guts::to_string(p.unsafeGetTensorImpl()));
-      auto& options = static_cast<AdamOptions&>(group.options());
 
       // State initialization
       if(param_state == state_.end()) {
@@ -99,6 +108,19 @@ Tensor Adam::step(LossClosure closure)  {
       auto& max_exp_avg_sq = state.max_exp_avg_sq();
 
       state.step(state.step()+1);
+
+      std::vector<Tensor> tensors{p, grad, exp_avg, exp_avg_sq};
+      if (options.amsgrad()) {
+        tensors.push_back(max_exp_avg_sq);
+      }
+      if (detail::can_use_fused_step(tensors)) {
+        auto& lists = fused[std::make_tuple(state.step(), p.device().index(), p.scalar_type())];
+        for (size_t i = 0; i < tensors.size(); i++) {
+          lists[i].push_back(tensors[i]);
+        }
+        continue;
+      }
+
       auto beta1 = std::get<0>(options.betas());
       auto beta2 = std::get<1>(options.betas());
 
@@ -126,6 +148,15 @@ Tensor Adam::step(LossClosure closure)  {
       auto step_size = options.lr() / bias_correction1;
       p.addcdiv_(exp_avg, denom, -step_size);
     }
+
+    for (auto& entry : fused) {
+      auto& lists = entry.second;
+      at::_fused_adam_(lists[0], lists[1], lists[2], lists[3], lists[4],
+                       options.lr(), std::get<0>(options.betas()),
+                       std::get<1>(options.betas()), options.eps(),
+                       options.weight_decay(), std::get<0>(entry.first),
+                       options.amsgrad(), /*decoupled_weight_decay=*/false);
+    }
   }
   return loss;
 }
@@ -3,6 +3,7 @@
 #include <torch/csrc/autograd/generated/variable_factories.h>
 #include <torch/ordered_dict.h>
 #include <torch/types.h>
+#include <torch/utils.h>
 
 #include <string>
 #include <utility>
@@ -11,6 +12,64 @@
 namespace torch {
 namespace optim {
 
+namespace detail {
+bool can_use_fused_step(at::ArrayRef<Tensor> tensors) {
+  const auto& first = tensors[0];
+  const auto dtype = first.scalar_type();
+  if (first.is_cuda()) {
+    if (!at::isFloatingType(dtype) || dtype == at::kBFloat16) {
+      return false;
+    }
+  } else if (
+      !first.device().is_cpu() ||
+      (dtype != at::kFloat && dtype != at::kDouble)) {
+    return false;
+  }
+  return std::all_of(tensors.begin(), tensors.end(), [&](const Tensor& t) {
+    return t.device() == first.device() &&
+        t.scalar_type() == first.scalar_type() && t.layout() == at::kStrided &&
+        t.is_contiguous() && t.numel() == first.numel();
+  });
+}
+} // namespace detail
+
+Tensor flatten_parameters(const std::vector<Tensor>& params) {
+  TORCH_CHECK(!params.empty(), "flatten_parameters expects at least one parameter");
+  const auto& first = params[0];
+  int64_t numel = 0;
+  for (const auto& p : params) {
+    TORCH_CHECK(
+        p.is_leaf() && p.layout() == at::kStrided,
+        "flatten_parameters expects dense leaf tensors");
+    TORCH_CHECK(
+        p.device() == first.device() && p.scalar_type() == first.scalar_type(),
+        "flatten_parameters expects parameters of one type on one device, but got ",
+        p.scalar_type(), " on ", p.device(), " and ", first.scalar_type(),
+        " on ", first.device());
+    numel += p.numel();
+  }
+
+  NoGradGuard no_grad;
+  const auto options = first.options();
+  auto flat = torch::empty({numel}, options);
+  auto flat_grad = torch::zeros({numel}, options);
+  int64_t offset = 0;
+  for (auto p : params) {
+    auto data = flat.narrow(0, offset, p.numel()).view(p.sizes());
+    auto grad = flat_grad.narrow(0, offset, p.numel()).view(p.sizes());
+    offset += p.numel();
+    data.copy_(p);
+    if (p.grad().defined()) {
+      grad.copy_(p.grad());
+    }
+    p.set_data(data);
+    p.grad() = grad;
+  }
+  flat.set_requires_grad(true);
+  flat.grad() = flat_grad;
+  return flat;
+}
+
 bool OptimizerParamGroup::has_options() const {
   return options_ != nullptr;
 }
@@ -6,7 +6,10 @@
 
 #include <ATen/ATen.h>
 
+#include <array>
 #include <functional>
+#include <map>
+#include <utility>
 
 namespace torch {
 namespace optim {
@@ -71,6 +74,12 @@ Tensor RMSprop::step(LossClosure closure)  {
     loss = closure();
   }
   for (auto& group : param_groups_) {
+    auto& options = static_cast<RMSpropOptions&>(group.options());
+    // Parameters updated by the fused kernels, which take tensors on a
+    // single device per call. The lists are params, grads, square averages,
+    // momentum buffers and gradient averages.
+    std::map<std::pair<c10::DeviceIndex, at::ScalarType>,
+             std::array<std::vector<Tensor>, 5>> fused;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
@@ -78,7 +87,6 @@ Tensor RMSprop::step(LossClosure closure)  {
       auto grad = p.grad();
       TORCH_CHECK(!grad.is_sparse(), "RMSprop does not support sparse gradients");
       auto param_state = state_.find(c10::guts::to_string(p.unsafeGetTensorImpl()));
-      auto& options = static_cast<RMSpropOptions&>(group.options());
 
       // State initialization
       if (param_state == state_.end()) {
@@ -100,6 +108,27 @@ Tensor RMSprop::step(LossClosure closure)  {
 
       state.step(state.step() + 1);
 
+      std::vector<Tensor> tensors{p, grad, square_avg};
+      if (options.momentum() > 0) {
+        tensors.push_back(state.momentum_buffer());
+      }
+      if (options.centered()) {
+        tensors.push_back(state.grad_avg());
+      }
+      if (detail::can_use_fused_step(tensors)) {
+        auto& lists = fused[std::make_pair(p.device().index(), p.scalar_type())];
+        lists[0].push_back(p);
+        lists[1].push_back(grad);
+        lists[2].push_back(square_avg);
+        if (options.momentum() > 0) {
+          lists[3].push_back(state.momentum_buffer());
+        }
+        if (options.centered()) {
+          lists[4].push_back(state.grad_avg());
+        }
+        continue;
+      }
+
       if (options.weight_decay() != 0) {
         grad = grad.add(p, options.weight_decay());
       }
@@ -125,6 +154,14 @@ Tensor RMSprop::step(LossClosure closure)  {
         p.addcdiv_(grad, avg, -options.lr());
       }
     }
+
+    for (auto& entry : fused) {
+      auto& lists = entry.second;
+      at::_fused_rmsprop_(lists[0], lists[1], lists[2], lists[3], lists[4],
+                          options.lr(), options.alpha(), options.eps(),
+                          options.weight_decay(), options.momentum(),
+                          options.centered());
+    }
   }
   return loss;
 }
@@ -9,7 +9,10 @@
 
 #include <ATen/ATen.h>
 
+#include <array>
 #include <functional>
+#include <map>
+#include <tuple>
 
 namespace torch {
 namespace optim {
@@ -66,10 +69,39 @@ Tensor SGD::step(LossClosure closure)  {
     auto dampening = options.dampening();
     auto nesterov = options.nesterov();
 
+    // Parameters updated by the fused kernels, which take tensors on a
+    // single device per call and initialize either all or none of the
+    // momentum buffers it is given. The lists are params, grads and
+    // momentum_buffers.
+    std::map<std::tuple<bool, c10::DeviceIndex, at::ScalarType>,
+             std::array<std::vector<Tensor>, 3>> fused;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
       }
+      if (detail::can_use_fused_step({p, p.grad()})) {
+        const bool first_run = momentum != 0 &&
+            state_.find(c10::guts::to_string(p.unsafeGetTensorImpl())) == state_.end();
+        Tensor buf;
+        if (first_run) {
+          // Filled in with the first update by the kernel
+          buf = torch::empty_like(p, MemoryFormat::Contiguous);
+          auto state = std::make_unique<SGDParamState>();
+          state->momentum_buffer(buf);
+          state_[c10::guts::to_string(p.unsafeGetTensorImpl())] = std::move(state);
+        } else if (momentum != 0) {
+          buf = static_cast<SGDParamState&>(*state_[c10::guts::to_string(p.unsafeGetTensorImpl())]).momentum_buffer();
+        }
+        if (momentum == 0 || detail::can_use_fused_step({p, buf})) {
+          auto& lists = fused[std::make_tuple(first_run, p.device().index(), p.scalar_type())];
+          lists[0].push_back(p);
+          lists[1].push_back(p.grad());
+          if (momentum != 0) {
+            lists[2].push_back(buf);
+          }
+          continue;
+        }
+      }
       auto d_p = p.grad().data();
       if (weight_decay != 0) {
         d_p = d_p.add(p.data(), weight_decay);
@@ -94,6 +126,13 @@ Tensor SGD::step(LossClosure closure)  {
       }
       p.data().add_(d_p, -1 * options.lr());
     }
+
+    for (auto& entry : fused) {
+      auto& lists = entry.second;
+      at::_fused_sgd_(lists[0], lists[1], lists[2], options.lr(), momentum,
+                      dampening, weight_decay, nesterov,
+                      /*first_run=*/std::get<0>(entry.first));
+    }
   }
   return loss;
 }
@@ -17,6 +17,8 @@
 #include <torch/csrc/utils/variadic.h>
 #include <torch/csrc/autograd/functions/utils.h>
 
+#include <c10/core/impl/COW.h>
+
 #include <array>
 #include <cstddef>
 #include <functional>
@@ -39,6 +41,21 @@ using namespace torch::autograd::generated;
 
 namespace torch { namespace autograd {
 
+// Gives a tensor that is about to be written to a private copy of its storage
+// if it shares it copy-on-write; see c10/core/impl/COW.h.
+inline void materialize_cow(const Tensor& tensor) {
+  if (tensor.defined() && tensor.has_storage()) {
+    c10::impl::cow::materialize_cow_storage(
+        *tensor.storage().unsafeGetStorageImpl());
+  }
+}
+
+inline void materialize_cow(TensorList tensors) {
+  for (const auto& tensor : tensors) {
+    materialize_cow(tensor);
+  }
+}
+
 inline void check_inplace(const Tensor& tensor) {
   auto& var = static_cast<const Variable&>(tensor);
   if (var.requires_grad() && GradMode::is_enabled()) {
@@ -88,6 +105,12 @@ inline void increment_version(Tensor & t) {
   impl::bump_version(t);
 }
 
+inline void increment_version(TensorList tensors) {
+  for (const auto& t : tensors) {
+    impl::bump_version(t);
+  }
+}
+
 struct Flatten : IterArgs<Flatten> {
   Flatten(variable_list& out) : out(out) {}
   variable_list& out;
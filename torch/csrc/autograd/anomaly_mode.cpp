@@ -1,8 +1,66 @@
 #include <torch/csrc/autograd/anomaly_mode.h>
 
+#include <ATen/ATen.h>
+#include <c10/core/Device.h>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
 namespace torch { namespace autograd {
 
 bool AnomalyMode::_enabled = false;
+bool NonfiniteGuardMode::_enabled = false;
+
+namespace {
+
+std::mutex nonfinite_flags_mutex;
+// One per device, holding the largest sequence number plus one of the nodes
+// that returned nonfinite values, 0 if none did.
+// Leaked, so that no device memory is freed at exit.
+auto& nonfinite_flags = *new std::unordered_map<c10::Device, at::Tensor>();
+
+at::Tensor nonfinite_flag(c10::Device device) {
+  std::lock_guard<std::mutex> lock(nonfinite_flags_mutex);
+  auto& flag = nonfinite_flags[device];
+  if (!flag.defined()) {
+    flag = at::zeros({1}, at::TensorOptions().dtype(at::kLong).device(device));
+  }
+  return flag;
+}
+
+} // namespace
+
+void NonfiniteGuardMode::record_outputs(
+    uint64_t sequence_nr,
+    const std::vector<at::Tensor>& outputs) {
+  // The outputs of a node are almost always on a single device.
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(outputs.size());
+  for (const auto& output : outputs) {
+    if (!output.defined()) {
+      continue;
+    }
+    if (!tensors.empty() && output.device() != tensors[0].device()) {
+      at::_record_nonfinite_(nonfinite_flag(tensors[0].device()), tensors, sequence_nr + 1);
+      tensors.clear();
+    }
+    tensors.push_back(output);
+  }
+  if (!tensors.empty()) {
+    at::_record_nonfinite_(nonfinite_flag(tensors[0].device()), tensors, sequence_nr + 1);
+  }
+}
+
+int64_t NonfiniteGuardMode::first_nonfinite_node() {
+  std::lock_guard<std::mutex> lock(nonfinite_flags_mutex);
+  int64_t first = -1;
+  for (auto& kv : nonfinite_flags) {
+    first = std::max(first, kv.second.item<int64_t>() - 1);
+    kv.second.zero_();
+  }
+  return first;
+}
 
 AnomalyMetadata::~AnomalyMetadata() = default;
 
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
+#include <ATen/core/Tensor.h>
+
 namespace torch { namespace autograd {
 
 struct TORCH_API AnomalyMode {
@@ -18,6 +22,33 @@ private:
 };
 
 
+// Detection of nan and infinity values in backward cheap enough to leave on
+// in training, unlike AnomalyMode. The engine checks the outputs of every
+// node with one fused kernel per device (see _record_nonfinite_) that keeps,
+// in a flag on the device, the largest sequence number of the nodes that
+// returned nonfinite values, without synchronizing. Backward runs nodes in
+// decreasing sequence number, so that is the node where they first appeared.
+// The flags are read once per step with first_nonfinite_node.
+struct TORCH_API NonfiniteGuardMode {
+  static bool is_enabled() {
+    return _enabled;
+  }
+  static void set_enabled(bool enabled) {
+    _enabled = enabled;
+  }
+
+  static void record_outputs(
+      uint64_t sequence_nr,
+      const std::vector<at::Tensor>& outputs);
+  // Returns the sequence number of the first node that returned nonfinite
+  // values since the previous call, or -1 if none did, and clears the flags.
+  // Synchronizes with the devices.
+  static int64_t first_nonfinite_node();
+
+private:
+  static bool _enabled;
+};
+
 struct TORCH_API AnomalyMetadata {
   virtual ~AnomalyMetadata();
   virtual void store_stack() = 0;
@@ -155,6 +155,26 @@ static thread_local std::shared_ptr<ReadyQueue> local_ready_queue = nullptr;
 // the leaf streams with the default streams is sufficient to implement
 // the historic behavior.
 
+// Note [Parallel CPU backward]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// By default all CPU work of a backward pass is run by the thread that
+// called it, so independent branches of the graph, e.g., the towers of a
+// multi-tower model, are processed one after the other. With
+// set_num_cpu_workers(n) for n > 0, a non-reentrant backward call instead
+// gives its GraphTask a fresh cpu_ready_queue_ and asks n threads of the
+// cpu_worker_pool_ to pop from it next to the calling thread, so every
+// NodeTask whose dependencies are satisfied can run as soon as a thread is
+// free. Gradients are still accumulated into the InputBuffers of not_ready_
+// under the GraphTask's mutex_, so the results are the same as with a single
+// thread, up to the order in which gradients are summed.
+//
+// Workers keep their own local_ready_queue, so a reentrant backward called
+// from a node they run is processed by that worker as described in
+// Note [Reentrant backwards] and never enters the shared queue. Every thread
+// leaves cpu_worker_main once the GraphTask is completed; the thread that
+// observes the completion pushes an empty NodeTask per possible participant
+// to wake up the ones blocked on the queue.
+
 int NodeTask::getReentrantDepth() const {
   std::shared_ptr<GraphTask> graph_task = base_.lock();
   if (graph_task) {
@@ -439,6 +459,94 @@ void Engine::reentrant_thread_init() {
   }
 }
 
+void Engine::cpu_worker_thread_init() {
+  at::init_num_threads();
+  set_device(CPU_DEVICE);
+  // Reentrant backward calls made on this thread use its own ready queue.
+  init_local_ready_queue();
+  auto pool = cpu_worker_pool_;
+  while (true) {
+    std::unique_lock<std::mutex> lk(pool->mutex_);
+    pool->work_.wait(lk, [&pool]{ return !pool->graphtasks_queue_.empty(); });
+    auto task = pool->graphtasks_queue_.front();
+    pool->graphtasks_queue_.pop();
+    lk.unlock();
+    std::shared_ptr<GraphTask> graph_task;
+    if (!(graph_task = task.lock())) {
+      continue;
+    }
+    total_depth = graph_task->reentrant_depth_;
+    cpu_worker_main(graph_task);
+  }
+}
+
+void Engine::cpu_worker_main(const std::shared_ptr<GraphTask>& graph_task) {
+  TORCH_INTERNAL_ASSERT(graph_task->parallel_cpu_);
+  const auto& queue = graph_task->cpu_ready_queue_;
+  while (!graph_task->completed()) {
+    {
+      NodeTask task = queue->pop();
+      std::shared_ptr<GraphTask> local_graph_task;
+      if (!(local_graph_task = task.base_.lock())) {
+        // Woken up because the GraphTask has completed, see below.
+        continue;
+      }
+      // Reentrant backward calls never use the shared queue.
+      TORCH_INTERNAL_ASSERT(local_graph_task == graph_task);
+
+      if (task.fn_ && !graph_task->has_error_.load()) {
+        AutoGradMode grad_mode(graph_task->grad_mode_);
+        try {
+          GraphTaskGuard guard(local_graph_task);
+          evaluate_function(local_graph_task, task.fn_.get(), task.inputs_, queue);
+        } catch (std::exception& e) {
+          thread_on_exception(local_graph_task, task.fn_, e);
+        }
+      }
+    }
+
+    --graph_task->outstanding_tasks_;
+
+    if (graph_task->completed()) {
+      size_t num_threads;
+      {
+        std::lock_guard<std::mutex> lck(cpu_worker_pool_->mutex_);
+        num_threads = cpu_worker_pool_->num_workers_ + 1;
+      }
+      for (size_t i = 0; i < num_threads; ++i) {
+        queue->push(NodeTask({}, nullptr, InputBuffer(0)), /* incrementOutstandingTasks */ false);
+      }
+    }
+  }
+  graph_task->mark_as_completed_and_run_post_processing();
+}
+
+void Engine::add_cpu_worker_tasks(const std::shared_ptr<GraphTask>& graph_task) {
+  const size_t num_workers = num_cpu_workers_.load();
+  std::unique_lock<std::mutex> lck(cpu_worker_pool_->mutex_);
+  const size_t num_new_threads = num_workers > cpu_worker_pool_->num_workers_
+      ? num_workers - cpu_worker_pool_->num_workers_
+      : 0;
+  cpu_worker_pool_->num_workers_ += num_new_threads;
+  for (size_t i = 0; i < num_workers; ++i) {
+    cpu_worker_pool_->graphtasks_queue_.push(graph_task);
+  }
+  lck.unlock();
+  for (size_t i = 0; i < num_new_threads; ++i) {
+    std::thread t(&Engine::cpu_worker_thread_init, this);
+    t.detach();
+  }
+  cpu_worker_pool_->work_.notify_all();
+}
+
+void Engine::set_num_cpu_workers(size_t num_workers) {
+  num_cpu_workers_.store(num_workers);
+}
+
+size_t Engine::num_cpu_workers() const {
+  return num_cpu_workers_.load();
+}
+
 void Engine::thread_on_exception(
     std::shared_ptr<GraphTask> graph_task,
     const std::shared_ptr<Node>& fn,
@@ -751,6 +859,11 @@ void Engine::evaluate_function(
     }
   }
 
+  if (NonfiniteGuardMode::is_enabled()) {
+    AutoGradMode grad_mode(false);
+    NonfiniteGuardMode::record_outputs(fn.sequence_nr(), outputs);
+  }
+
   // Lock mutex for the accesses to GraphTask dependencies_, not_ready_ and cpu_ready_queue_ below
   std::lock_guard<std::mutex> lock(graph_task->mutex_);
   for (int i = 0; i < num_outputs; ++i) {
@@ -856,12 +969,15 @@ auto Engine::execute(const edge_list& roots,
   // then memorize the local_ready_queue in GraphTask
   init_local_ready_queue();
   bool not_reentrant_backward_call = worker_device == NO_DEVICE;
+  // See Note [Parallel CPU backward]
+  bool parallel_cpu = not_reentrant_backward_call && num_cpu_workers_.load() > 0;
 
   auto graph_task = std::make_shared<GraphTask>(
       /* keep_graph */ keep_graph,
       /* create_graph */ create_graph,
       /* depth */ not_reentrant_backward_call ? 0 : total_depth + 1,
-      /* cpu_ready_queue */ local_ready_queue);
+      /* cpu_ready_queue */ parallel_cpu ? std::make_shared<ReadyQueue>() : local_ready_queue);
+  graph_task->parallel_cpu_ = parallel_cpu;
 
   // Now compute the dependencies for all executable functions and queue the root
   auto graph_root = std::make_shared<GraphRoot>(roots, inputs);
@@ -906,7 +1022,13 @@ std::shared_ptr<FutureVariableList> Engine::execute_with_graph_task(
     // The owning thread start to drive the engine execution with the GraphTask
     // that has already been pushed to the current CPU thread's ready_queue
     lock.unlock();
-    thread_main(nullptr, false);
+    if (graph_task->parallel_cpu_) {
+      // See Note [Parallel CPU backward]
+      add_cpu_worker_tasks(graph_task);
+      cpu_worker_main(graph_task);
+    } else {
+      thread_main(nullptr, false);
+    }
     TORCH_INTERNAL_ASSERT(graph_task->future_result_->completed());
     // reset the worker_device after the completion of the graph_task, this is so
     // that the initial state of the engine remains the same across every backward()
@@ -1042,6 +1164,7 @@ auto Engine::start_device_threads() -> void {
   }
 
   thread_pool_shared_ = std::make_shared<ThreadPoolShared>();
+  cpu_worker_pool_ = std::make_shared<ThreadPoolShared>();
 
   non_reentrant_device_thread_count_.store(num_devices);
   for (int i = 0; i < num_devices; ++i) {
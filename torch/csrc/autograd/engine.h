@@ -151,6 +151,12 @@ struct GraphTask: std::enable_shared_from_this<GraphTask> {
   // and but next NodeTask should be run on CPU.
   std::shared_ptr<ReadyQueue> cpu_ready_queue_;
 
+  // Whether the CPU work of this graph task is shared with the engine's CPU
+  // workers. If so, cpu_ready_queue_ is not the owning thread's ready queue
+  // but one created for this graph task, which the owning thread and the
+  // workers pop from. See Note [Parallel CPU backward]
+  bool parallel_cpu_ = false;
+
   // Future representing the completion of the graph task. Notified when all
   // tasks are done.
   std::shared_ptr<FutureVariableList> future_result_;
@@ -300,6 +306,12 @@ struct TORCH_API Engine {
   // Should be called after fork to notify that worker threads are gone
   void release_workers();
 
+  // Sets the number of threads that help the calling thread with the CPU
+  // work of a backward pass. 0, the default, runs all CPU work on the calling
+  // thread. See Note [Parallel CPU backward]
+  void set_num_cpu_workers(size_t num_workers);
+  size_t num_cpu_workers() const;
+
  protected:
   Engine();
   void compute_dependencies(Node* root, GraphTask& task);
@@ -324,6 +336,10 @@ struct TORCH_API Engine {
       bool reentrant_thread);
   void reentrant_thread_init();
   void add_thread_pool_task(const std::weak_ptr<GraphTask>& graph_task);
+  virtual void cpu_worker_thread_init();
+  // Runs the CPU tasks of a parallel_cpu_ graph task until it is completed.
+  void cpu_worker_main(const std::shared_ptr<GraphTask>& graph_task);
+  void add_cpu_worker_tasks(const std::shared_ptr<GraphTask>& graph_task);
 
   // Ensures device_ready_queues_ are initialized only once
   std::once_flag start_device_threads_flag_;
@@ -360,6 +376,13 @@ struct TORCH_API Engine {
  // for the graphtasks_queue_ to be nonempty.
  std::shared_ptr<ThreadPoolShared> thread_pool_shared_;
 
+ // Threads that run the CPU work of graph tasks with parallel_cpu_ set. Here
+ // num_workers_ is the number of threads started so far, and every entry of
+ // graphtasks_queue_ asks one of them to join the graph task.
+ // See Note [Parallel CPU backward]
+ std::shared_ptr<ThreadPoolShared> cpu_worker_pool_;
+ std::atomic<size_t> num_cpu_workers_{0};
+
 private:
   // Number of non-reentrant threads
   std::atomic<uint32_t> non_reentrant_device_thread_count_;
@@ -6,6 +6,8 @@
 #include <ATen/ATen.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <stdexcept>
@@ -72,6 +74,87 @@ static void gatherFunctions(
   * converting recursion to a loop, using a heap buffer in place of the
   * recursive call stack.
   */
+namespace {
+
+// Block sizes of the node cache are multiples of kNodeCacheGranularity up to
+// kNodeCacheMaxSize; larger nodes go straight to the global allocator.
+constexpr size_t kNodeCacheGranularity = 16;
+constexpr size_t kNodeCacheMaxSize = 512;
+constexpr size_t kNodeCacheClasses = kNodeCacheMaxSize / kNodeCacheGranularity;
+constexpr size_t kNodeCacheBlocksPerClass = 128;
+
+std::atomic<bool> node_cache_enabled_{true};
+
+struct NodeCache {
+  std::array<std::array<void*, kNodeCacheBlocksPerClass>, kNodeCacheClasses> blocks;
+  std::array<size_t, kNodeCacheClasses> counts{};
+
+  ~NodeCache();
+};
+
+// Nodes can still be freed by the destructors of other thread locals after
+// the cache of the thread is gone.
+thread_local bool node_cache_destroyed = false;
+
+NodeCache::~NodeCache() {
+  for (size_t cls = 0; cls < kNodeCacheClasses; ++cls) {
+    for (size_t i = 0; i < counts[cls]; ++i) {
+      ::operator delete(blocks[cls][i]);
+    }
+  }
+  node_cache_destroyed = true;
+}
+
+NodeCache* nodeCache() {
+  if (node_cache_destroyed) {
+    return nullptr;
+  }
+  static thread_local NodeCache cache;
+  return &cache;
+}
+
+size_t nodeCacheClass(size_t size) {
+  return (size + kNodeCacheGranularity - 1) / kNodeCacheGranularity - 1;
+}
+
+} // namespace
+
+void* Node::operator new(size_t size) {
+  if (size <= kNodeCacheMaxSize) {
+    if (auto* cache = nodeCache()) {
+      const size_t cls = nodeCacheClass(size);
+      if (cache->counts[cls] > 0) {
+        return cache->blocks[cls][--cache->counts[cls]];
+      }
+    }
+    // Rounded up so that the block can be reused for any node of its class.
+    return ::operator new((nodeCacheClass(size) + 1) * kNodeCacheGranularity);
+  }
+  return ::operator new(size);
+}
+
+void Node::operator delete(void* ptr, size_t size) {
+  if (size <= kNodeCacheMaxSize &&
+      node_cache_enabled_.load(std::memory_order_relaxed)) {
+    if (auto* cache = nodeCache()) {
+      const size_t cls = nodeCacheClass(size);
+      if (cache->counts[cls] < kNodeCacheBlocksPerClass) {
+        cache->blocks[cls][cache->counts[cls]++] = ptr;
+        return;
+      }
+    }
+  }
+  ::operator delete(ptr);
+}
+
+void set_node_cache_enabled(bool enabled) {
+  node_cache_enabled_ = enabled;
+}
+
+bool node_cache_enabled() {
+  return node_cache_enabled_;
+}
+
 void deleteNode(Node* function) {
   // To avoid stack overflow on large computational graphs,
   // we need to track reference decrementing and freeing
@@ -29,13 +29,19 @@ struct FunctionPreHook;
 
 using tensor_list = std::vector<at::Tensor>;
 using variable_list = std::vector<Variable>;
-using edge_list = std::vector<Edge>;
+// Most nodes have one or two inputs, so their edges are stored inline.
+using edge_list = at::SmallVector<Edge, 2>;
 using saved_variable_list = std::vector<SavedVariable>;
 using IndexRange = std::pair<size_t, size_t>;
 
 // Custom deleter to prevent stack overflows.
 TORCH_API void deleteNode(Node* function);
 
+// Enables or disables the cache of the memory of freed nodes, see
+// Node::operator new. Enabled by default.
+TORCH_API void set_node_cache_enabled(bool enabled);
+TORCH_API bool node_cache_enabled();
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 //                               Node
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -109,6 +115,13 @@ struct TORCH_API Node : std::enable_shared_from_this<Node> {
   Node& operator=(Node&& other) = delete;
   virtual ~Node() = default;
 
+  /// Nodes are allocated from a thread local cache of the blocks of the
+  /// nodes freed on that thread, by size, as a forward pass creates many
+  /// short lived nodes of a few sizes. The cache holds a bounded number of
+  /// blocks and can be disabled with `set_node_cache_enabled`.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
   /// Evaluates the function on the given inputs and returns the result of the
   /// function call.
   variable_list operator()(variable_list&& inputs) {
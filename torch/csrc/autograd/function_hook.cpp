@@ -4,5 +4,6 @@ namespace torch { namespace autograd {
 
 FunctionPreHook::~FunctionPreHook() = default;
 FunctionPostHook::~FunctionPostHook() = default;
+PostAccumulateGradHook::~PostAccumulateGradHook() = default;
 
 }} // namespace torch::autograd
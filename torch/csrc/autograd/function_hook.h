@@ -23,4 +23,11 @@ struct TORCH_API FunctionPostHook {
     const variable_list& inputs /* grad_outputs */) = 0;
 };
 
+// Called by AccumulateGrad once the gradient of a leaf has been accumulated
+// into its .grad, e.g., to run an optimizer step for it during backward.
+struct TORCH_API PostAccumulateGradHook {
+  virtual ~PostAccumulateGradHook();
+  virtual void operator()(const Variable& tensor) = 0;
+};
+
 }} // namespace torch::autograd
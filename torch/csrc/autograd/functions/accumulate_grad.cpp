@@ -58,6 +58,12 @@ auto AccumulateGrad::apply(variable_list&& grads) -> variable_list {
       1 + !post_hooks().empty() /* num_expected_refs */,
       [&grad](at::Tensor&& grad_update) { grad = std::move(grad_update); });
 
+  // The grad is final for this backward pass, so e.g. an optimizer step can
+  // be applied to the variable right away and its grad freed.
+  if (auto hook = impl::post_acc_grad_hook(variable)) {
+    (*hook)(variable);
+  }
+
   return variable_list();
 }
 }} // namespace torch::autograd
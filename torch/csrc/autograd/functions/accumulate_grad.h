@@ -1,6 +1,7 @@
 #pragma once
 
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/sparse_grad_mode.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
@@ -97,6 +98,12 @@ struct TORCH_API AccumulateGrad : public Node {
         // TensorImpl type of a tensor requires changing the tensor itself, and
         // thus in this case we have to change the grad tensor.
         update_grad(new_grad + variable_grad);
+      } else if (
+          variable_grad.is_sparse() && new_grad.is_sparse() &&
+          SparseGradMergeMode::is_enabled()) {
+        // Keep the accumulated sparse gradient coalesced so its nnz stays
+        // bounded by the number of distinct indices seen so far.
+        update_grad(at::_sparse_add_and_coalesce(variable_grad, new_grad));
       } else {
         // In this case we can avoid changing the grad tensor. There are three
         // scenarios when we'll hit this case:
@@ -3,9 +3,11 @@
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/utils/pybind.h>
 #include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/autograd/sparse_grad_mode.h>
 #include <ATen/autocast_mode.h>
 #include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/autograd/python_function.h>
+#include <torch/csrc/autograd/python_saved_variable_hooks.h>
 #include <torch/csrc/autograd/function.h>
 
 PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
@@ -34,10 +36,13 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .value("Disabled", ProfilerState::Disabled)
       .value("CPU", ProfilerState::CPU)
       .value("CUDA", ProfilerState::CUDA)
-      .value("NVTX", ProfilerState::NVTX);
+      .value("NVTX", ProfilerState::NVTX)
+      .value("CUPTI", ProfilerState::CUPTI);
 
   py::class_<ProfilerConfig>(m, "ProfilerConfig")
-      .def(py::init<ProfilerState, bool>());
+      .def(py::init<ProfilerState, bool, bool>(),
+           py::arg("state"), py::arg("report_input_shapes"),
+           py::arg("profile_memory") = false);
 
   py::class_<Event>(m, "ProfilerEvent")
       .def("kind", &Event::kind)
@@ -47,12 +52,72 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .def("cpu_elapsed_us", &Event::cpu_elapsed_us)
       .def("cuda_elapsed_us", &Event::cuda_elapsed_us)
       .def("has_cuda", &Event::has_cuda)
-      .def("shapes", &Event::shapes);
+      .def("shapes", &Event::shapes)
+      .def("correlation_id", &Event::correlation_id)
+      .def("cpu_ns", &Event::cpu_ns)
+      .def("cpu_memory_usage", &Event::cpu_memory_usage)
+      .def("cuda_memory_usage", &Event::cuda_memory_usage);
+
+  py::class_<CUDAActivity>(m, "CUDAActivity")
+      .def_readonly("name", &CUDAActivity::name)
+      .def_readonly("device", &CUDAActivity::device)
+      .def_readonly("stream", &CUDAActivity::stream)
+      .def_readonly("start_ns", &CUDAActivity::start_ns)
+      .def_readonly("end_ns", &CUDAActivity::end_ns)
+      .def_readonly("correlation_id", &CUDAActivity::correlation_id);
 
   m.def("_enable_profiler", enableProfiler);
   m.def("_disable_profiler", disableProfiler);
+  m.def("_disable_profiler_with_activities", disableProfilerWithActivities);
   m.def("_profiler_enabled", profilerEnabled);
 
+  py::class_<SampledOpStats>(m, "SampledOpStats")
+      .def_readonly("name", &SampledOpStats::name)
+      .def_readonly("count", &SampledOpStats::count)
+      .def_readonly("total_ns", &SampledOpStats::total_ns)
+      .def_readonly("max_ns", &SampledOpStats::max_ns)
+      .def_readonly("histogram", &SampledOpStats::histogram);
+
+  m.def("_enable_sampling_profiler", enableSamplingProfiler);
+  m.def("_disable_sampling_profiler", disableSamplingProfiler);
+  m.def("_sampling_profiler_enabled", samplingProfilerEnabled);
+  m.def("_sampling_profiler_stats", samplingProfilerStats, py::arg("reset") = false);
+
+  py::class_<OpLatencyHistogram>(m, "OpLatencyHistogram")
+      .def_readonly("name", &OpLatencyHistogram::name)
+      .def_readonly("count", &OpLatencyHistogram::count)
+      .def_readonly("total_ns", &OpLatencyHistogram::total_ns)
+      .def_readonly("buckets", &OpLatencyHistogram::buckets)
+      .def_static("bucket_lower_bound", &OpLatencyHistogram::bucketLowerBound)
+      .def("quantile", &OpLatencyHistogram::quantile);
+
+  m.def("_enable_op_latency_metrics", enableOpLatencyMetrics);
+  m.def("_disable_op_latency_metrics", disableOpLatencyMetrics);
+  m.def("_op_latency_metrics_enabled", opLatencyMetricsEnabled);
+  m.def("_scrape_op_latency_metrics", scrapeOpLatencyMetrics);
+  m.def("_enable_record_function", [](bool enable) {
+    at::enableRecordFunction(enable);
+  });
+
+  m.def("_set_nonfinite_guard_enabled", [](bool enabled) {
+    torch::autograd::NonfiniteGuardMode::set_enabled(enabled);
+  });
+  m.def("_is_nonfinite_guard_enabled", []() {
+    return torch::autograd::NonfiniteGuardMode::is_enabled();
+  });
+  m.def("_first_nonfinite_node", []() {
+    pybind11::gil_scoped_release no_gil;
+    return torch::autograd::NonfiniteGuardMode::first_nonfinite_node();
+  });
+
+  m.def("_push_saved_tensors_default_hooks", [](py::function& pack_hook, py::function& unpack_hook) {
+    torch::autograd::SavedTensorDefaultHooks::push_hooks(
+        std::make_shared<torch::autograd::PySavedVariableHooksFactory>(pack_hook.ptr(), unpack_hook.ptr()));
+  });
+  m.def("_pop_saved_tensors_default_hooks", []() {
+    torch::autograd::SavedTensorDefaultHooks::pop_hooks();
+  });
+
   Py_RETURN_TRUE;
 }
 
@@ -78,6 +143,26 @@ static PyObject * is_autocast_enabled(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * set_autocast_cpu_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!PyBool_Check(arg)) {
+    throw TypeError("enabled must be a bool (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  at::autocast::set_cpu_enabled(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * is_autocast_cpu_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (at::autocast::is_cpu_enabled()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
 static PyObject * clear_autocast_cache(PyObject* _unused, PyObject *arg) {
   HANDLE_TH_ERRORS
   at::autocast::clear_cache();
@@ -85,6 +170,13 @@ static PyObject * clear_autocast_cache(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * prune_autocast_cache(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  at::autocast::prune_cache();
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 static PyObject * autocast_increment_nesting(PyObject* _unused, PyObject *arg) {
   HANDLE_TH_ERRORS
   return THPUtils_packInt64(at::autocast::increment_nesting());
@@ -137,17 +229,42 @@ static PyObject * is_anomaly_mode_enabled(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * set_merge_sparse_grads_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!PyBool_Check(arg)) {
+    throw TypeError("enabled must be a bool (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  SparseGradMergeMode::set_enabled(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * is_merge_sparse_grads_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (SparseGradMergeMode::is_enabled()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
 // autograd methods on torch._C
 static PyMethodDef methods[] = { // NOLINT
   {"set_grad_enabled", (PyCFunction)set_grad_enabled, METH_O, nullptr},
   {"is_grad_enabled", (PyCFunction)is_grad_enabled, METH_NOARGS, nullptr},
   {"set_autocast_enabled", (PyCFunction)set_autocast_enabled, METH_O, nullptr},
   {"is_autocast_enabled", (PyCFunction)is_autocast_enabled, METH_NOARGS, nullptr},
+  {"set_autocast_cpu_enabled", (PyCFunction)set_autocast_cpu_enabled, METH_O, nullptr},
+  {"is_autocast_cpu_enabled", (PyCFunction)is_autocast_cpu_enabled, METH_NOARGS, nullptr},
   {"clear_autocast_cache", (PyCFunction)clear_autocast_cache, METH_NOARGS, nullptr},
+  {"prune_autocast_cache", (PyCFunction)prune_autocast_cache, METH_NOARGS, nullptr},
   {"autocast_increment_nesting", (PyCFunction)autocast_increment_nesting, METH_NOARGS, nullptr},
   {"autocast_decrement_nesting", (PyCFunction)autocast_decrement_nesting, METH_NOARGS, nullptr},
   {"set_anomaly_enabled", (PyCFunction)set_anomaly_mode_enabled, METH_O, nullptr},
   {"is_anomaly_enabled", (PyCFunction)is_anomaly_mode_enabled, METH_NOARGS, nullptr},
+  {"_set_merge_sparse_grads_enabled", (PyCFunction)set_merge_sparse_grads_enabled, METH_O, nullptr},
+  {"_is_merge_sparse_grads_enabled", (PyCFunction)is_merge_sparse_grads_enabled, METH_NOARGS, nullptr},
   {nullptr, nullptr, 0, nullptr}
 };
 
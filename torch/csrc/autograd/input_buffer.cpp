@@ -1,4 +1,5 @@
 #include <torch/csrc/autograd/input_buffer.h>
+#include <torch/csrc/autograd/sparse_grad_mode.h>
 
 #include <c10/core/DeviceGuard.h>
 #include <c10/core/StreamGuard.h>
@@ -18,7 +19,9 @@ namespace torch { namespace autograd {
     auto& old_var = buffer[pos];
     // ATen doesn't route sparse additions correctly...
     // do dense + sparse in-place if possible
-    if (old_var.is_sparse()) {
+    if (old_var.is_sparse() && var.is_sparse() && SparseGradMergeMode::is_enabled()) {
+      buffer[pos] = at::_sparse_add_and_coalesce(old_var, var);
+    } else if (old_var.is_sparse()) {
       //storage use_count is a big hammer, but for anything lighter there's an adversarial example with unexpected inplace modification
       if (!var.is_sparse() && var.is_contiguous() && var.storage().use_count() == 1) {
           buffer[pos] = var.add_(old_var);
@@ -7,15 +7,20 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <torch/library.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <fstream>
 #include <list>
 #include <mutex>
+#include <random>
 #include <sstream>
 #include <string>
 #include <vector>
 
 #include <ATen/record_function.h>
 #include <c10/util/ThreadLocalDebugInfo.h>
+#include <c10/util/llvmMathExtras.h>
 
 #include <iostream>
 
@@ -120,7 +125,7 @@ static CUDAStubs* cuda_stubs = default_stubs_addr;
 //
 
 // Profiler state
-struct ProfilerThreadLocalState : public at::DebugInfoBase {
+struct ProfilerThreadLocalState : public c10::MemoryReportingInfoBase {
   explicit ProfilerThreadLocalState(
       ProfilerState state,
       bool report_input_shapes)
@@ -171,6 +176,16 @@ struct ProfilerThreadLocalState : public at::DebugInfoBase {
     if (config_.state == ProfilerState::NVTX) {
       cuda_stubs->nvtxRangePushA(getNvtxStr(
           name, msg, sequence_nr, shapes).c_str());
+    } else if (config_.state == ProfilerState::CUPTI) {
+      const uint64_t correlation_id = next_correlation_id_++;
+      getEventList().record(
+          EventKind::PushRange,
+          name,
+          at::RecordFunction::currentThreadId(),
+          false,
+          std::move(shapes),
+          correlation_id);
+      cuda_stubs->pushCorrelationId(correlation_id);
     } else {
       getEventList().record(
           EventKind::PushRange,
@@ -193,9 +208,32 @@ struct ProfilerThreadLocalState : public at::DebugInfoBase {
           at::StringView(""),
           thread_id,
           config_.state == ProfilerState::CUDA);
+      if (config_.state == ProfilerState::CUPTI) {
+        cuda_stubs->popCorrelationId();
+      }
     }
   }
 
+  bool memoryProfilingEnabled() const override {
+    return config_.profile_memory && config_.state != ProfilerState::Disabled &&
+        config_.state != ProfilerState::NVTX;
+  }
+
+  // Called by the allocators on the allocating (or freeing) thread, so the
+  // event lands between the push and pop of the op that caused it.
+  void reportMemoryUsage(
+      void* /* unused */,
+      int64_t alloc_size,
+      c10::Device device) override {
+    Event evt(
+        EventKind::MemoryAlloc,
+        at::StringView(""),
+        at::RecordFunction::currentThreadId(),
+        false);
+    evt.updateMemoryStats(alloc_size, device);
+    getEventList().record(std::move(evt));
+  }
+
   void setCallbackHandle(at::CallbackHandle handle) {
     handle_ = handle;
   }
@@ -264,6 +302,8 @@ struct ProfilerThreadLocalState : public at::DebugInfoBase {
       event_lists_map_;
   ProfilerConfig config_ = ProfilerConfig(ProfilerState::Disabled, false);
   at::CallbackHandle handle_ = 0;
+  // 0 means "not launched from a profiled range" in CUDAActivity
+  std::atomic<uint64_t> next_correlation_id_{1};
 };
 
 ProfilerThreadLocalState* getProfilerTLSState() {
@@ -334,10 +374,18 @@ bool profilerEnabled() {
 void enableProfiler(const ProfilerConfig& new_config) {
   TORCH_CHECK(new_config.state != ProfilerState::NVTX || cuda_stubs->enabled(),
     "Can't use NVTX profiler - PyTorch was compiled without CUDA");
+  TORCH_CHECK(new_config.state != ProfilerState::CUPTI || cuda_stubs->cuptiEnabled(),
+    "Can't use CUPTI profiler - PyTorch was compiled without CUDA or CUPTI");
 
   auto state_ptr = getProfilerTLSState();
   TORCH_CHECK(!state_ptr, "Profiler is already enabled on this thread");
 
+  if (new_config.state == ProfilerState::CUPTI) {
+    // CUPTI records the activity of the process, hence first, so that a
+    // second CUPTI profiler fails before changing any state
+    cuda_stubs->enableActivities();
+  }
+
   auto state = std::make_shared<ProfilerThreadLocalState>(new_config);
   c10::ThreadLocalDebugInfo::_push(c10::DebugInfoKind::PROFILER_STATE, state);
 
@@ -365,6 +413,11 @@ void enableProfiler(const ProfilerConfig& new_config) {
 }
 
 thread_event_lists disableProfiler() {
+  return disableProfilerWithActivities().first;
+}
+
+std::pair<thread_event_lists, std::vector<CUDAActivity>>
+disableProfilerWithActivities() {
   // all the DebugInfoBase objects are scope based and supposed to use DebugInfoGuard
   auto state = c10::ThreadLocalDebugInfo::_pop(c10::DebugInfoKind::PROFILER_STATE);
   auto state_ptr = static_cast<ProfilerThreadLocalState*>(state.get());
@@ -375,12 +428,16 @@ thread_event_lists disableProfiler() {
   at::removeCallback(state_ptr->callbackHandle());
 
   if (state_ptr->config().state == ProfilerState::NVTX) {
-    return thread_event_lists();
+    return {};
   }
 
   state_ptr->mark("__stop_profile");
 
-  return state_ptr->consolidate();
+  std::vector<CUDAActivity> activities;
+  if (state_ptr->config().state == ProfilerState::CUPTI) {
+    activities = cuda_stubs->disableActivities();
+  }
+  return std::make_pair(state_ptr->consolidate(), std::move(activities));
 }
 
 void Event::record(bool record_cuda) {
@@ -403,6 +460,385 @@ double Event::cuda_elapsed_us(const Event & e) {
 
 CUDAStubs::~CUDAStubs() = default;
 
+namespace {
+
+// Deepest nesting of sampled ranges tracked per thread; ranges opened deeper
+// than that are dropped.
+constexpr size_t kMaxSampledDepth = 64;
+
+// Samples of one thread. Only the owning thread writes to it, so mutex is
+// uncontended except while samplingProfilerStats runs.
+struct SamplingThreadState {
+  std::mutex mutex;
+  std::unordered_map<std::string, SampledOpStats> stats;
+
+  // Start times of the sampled ranges still open on this thread, innermost
+  // last.
+  std::array<std::pair<const at::RecordFunction*, int64_t>, kMaxSampledDepth> open;
+  size_t depth = 0;
+  // Value of sampling_generation when open was last used, to forget the
+  // ranges left open by a previous run.
+  uint64_t generation = 0;
+
+  // Number of ranges until the next sample, and xorshift state to draw it.
+  uint64_t countdown = 0;
+  uint64_t rng = 0;
+};
+
+std::atomic<uint64_t> sampling_period{0};
+std::atomic<uint64_t> sampling_generation{0};
+at::CallbackHandle sampling_handle = 0;
+
+std::mutex sampling_states_mutex;
+std::vector<std::shared_ptr<SamplingThreadState>> sampling_states;
+
+SamplingThreadState& samplingThreadState() {
+  // The states outlive their threads so that their samples are still reported.
+  static thread_local std::shared_ptr<SamplingThreadState> state = [] {
+    auto new_state = std::make_shared<SamplingThreadState>();
+    // xorshift never leaves a zero state
+    new_state->rng = (static_cast<uint64_t>(std::random_device()()) << 1) | 1;
+    std::lock_guard<std::mutex> guard(sampling_states_mutex);
+    sampling_states.push_back(new_state);
+    return new_state;
+  }();
+  return *state;
+}
+
+// Runs for every RecordFunction, hence a countdown rather than a uniform
+// draw per range: waits are uniform in [1, 2 * period - 1], so one range in
+// period is sampled on average, without locking onto periodic patterns.
+bool shouldSample() {
+  auto& state = samplingThreadState();
+  if (state.countdown > 1) {
+    --state.countdown;
+    return false;
+  }
+  const uint64_t period = sampling_period.load(std::memory_order_relaxed);
+  uint64_t& x = state.rng;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  state.countdown = period <= 1 ? 1 : 1 + x % (2 * period - 1);
+  return true;
+}
+
+void startSample(const at::RecordFunction& fn) {
+  auto& state = samplingThreadState();
+  const auto generation = sampling_generation.load(std::memory_order_relaxed);
+  if (state.generation != generation) {
+    state.depth = 0;
+    state.generation = generation;
+  }
+  if (state.depth < kMaxSampledDepth) {
+    state.open[state.depth++] = std::make_pair(&fn, getTime());
+  }
+}
+
+void endSample(const at::RecordFunction& fn) {
+  const int64_t end_ns = getTime();
+  auto& state = samplingThreadState();
+  // Ranges that end on another thread than they started (async ops) or that
+  // were dropped are not found; ranges above the one ending were missed.
+  size_t idx = state.depth;
+  while (idx > 0 && state.open[idx - 1].first != &fn) {
+    --idx;
+  }
+  if (idx == 0) {
+    return;
+  }
+  const int64_t duration_ns = end_ns - state.open[idx - 1].second;
+  state.depth = idx - 1;
+
+  size_t bucket = 0;
+  for (int64_t us = duration_ns / 1000;
+       us > 0 && bucket < kSampledOpHistogramBuckets - 1;
+       us >>= 1) {
+    ++bucket;
+  }
+
+  std::lock_guard<std::mutex> guard(state.mutex);
+  auto& stats = state.stats[fn.name().str()];
+  if (stats.count == 0) {
+    stats.name = fn.name().str();
+  }
+  ++stats.count;
+  stats.total_ns += duration_ns;
+  stats.max_ns = std::max(stats.max_ns, duration_ns);
+  ++stats.histogram[bucket];
+}
+
+} // namespace
+
+void enableSamplingProfiler(uint64_t sample_period) {
+  TORCH_CHECK(sample_period > 0, "sample_period must be positive");
+  TORCH_CHECK(!sampling_handle, "Sampling profiler is already enabled");
+  sampling_period = sample_period;
+  ++sampling_generation;
+  sampling_handle = at::addGlobalCallback(
+      at::RecordFunctionCallback(&startSample, &endSample)
+          .setShouldRun([](const at::RecordFunctionCallback&) {
+            return shouldSample();
+          }));
+  at::enableRecordFunction();
+}
+
+void disableSamplingProfiler() {
+  TORCH_CHECK(sampling_handle, "Can't disable sampling profiler when it's not running");
+  at::removeCallback(sampling_handle);
+  sampling_handle = 0;
+}
+
+bool samplingProfilerEnabled() {
+  return sampling_handle != 0;
+}
+
+std::vector<SampledOpStats> samplingProfilerStats(bool reset) {
+  std::unordered_map<std::string, SampledOpStats> merged;
+  {
+    std::lock_guard<std::mutex> states_guard(sampling_states_mutex);
+    for (const auto& state : sampling_states) {
+      std::lock_guard<std::mutex> guard(state->mutex);
+      for (const auto& kv : state->stats) {
+        const auto& stats = kv.second;
+        auto& total = merged[kv.first];
+        total.name = stats.name;
+        total.count += stats.count;
+        total.total_ns += stats.total_ns;
+        total.max_ns = std::max(total.max_ns, stats.max_ns);
+        for (size_t i = 0; i < kSampledOpHistogramBuckets; ++i) {
+          total.histogram[i] += stats.histogram[i];
+        }
+      }
+      if (reset) {
+        state->stats.clear();
+      }
+    }
+  }
+  std::vector<SampledOpStats> result;
+  result.reserve(merged.size());
+  for (auto& kv : merged) {
+    result.push_back(std::move(kv.second));
+  }
+  std::sort(
+      result.begin(), result.end(),
+      [](const SampledOpStats& a, const SampledOpStats& b) {
+        return a.name < b.name;
+      });
+  return result;
+}
+
+namespace {
+
+// Ops tracked per thread; the ranges of other ops are not recorded.
+constexpr size_t kOpLatencyTableSize = 1024;
+constexpr size_t kMaxOpLatencyDepth = 64;
+
+struct OpLatencyCounters {
+  explicit OpLatencyCounters(std::string name) : name(std::move(name)) {}
+
+  const std::string name;
+  std::atomic<uint64_t> count{0};
+  std::atomic<int64_t> total_ns{0};
+  std::array<std::atomic<uint64_t>, kOpLatencyBuckets> buckets{};
+};
+
+// Only the owning thread writes to the counters, so it increments them with a
+// relaxed load and store instead of a locked read-modify-write.
+template <typename T>
+inline void bump(std::atomic<T>& counter, T value) {
+  counter.store(
+      counter.load(std::memory_order_relaxed) + value,
+      std::memory_order_relaxed);
+}
+
+struct OpLatencyThreadState {
+  // Open addressing table indexed by the hash of the name. A slot is
+  // published by the release store of its counters, which are never freed or
+  // moved afterwards, so readers only need an acquire load.
+  std::array<std::atomic<OpLatencyCounters*>, kOpLatencyTableSize> table{};
+  // Owned by the thread, for the lookups.
+  std::array<uint64_t, kOpLatencyTableSize> hashes{};
+  std::vector<std::unique_ptr<OpLatencyCounters>> owned;
+
+  std::array<std::pair<const at::RecordFunction*, int64_t>, kMaxOpLatencyDepth> open;
+  size_t depth = 0;
+  uint64_t generation = 0;
+};
+
+std::atomic<uint64_t> op_latency_generation{0};
+at::CallbackHandle op_latency_handle = 0;
+
+std::mutex op_latency_states_mutex;
+std::vector<std::shared_ptr<OpLatencyThreadState>> op_latency_states;
+
+OpLatencyThreadState& opLatencyThreadState() {
+  static thread_local std::shared_ptr<OpLatencyThreadState> state = [] {
+    auto new_state = std::make_shared<OpLatencyThreadState>();
+    std::lock_guard<std::mutex> guard(op_latency_states_mutex);
+    op_latency_states.push_back(new_state);
+    return new_state;
+  }();
+  return *state;
+}
+
+size_t opLatencyBucket(int64_t duration_ns) {
+  if (duration_ns < (int64_t(1) << kOpLatencyMinExponent)) {
+    return 0;
+  }
+  const auto value = static_cast<uint64_t>(duration_ns);
+  const int exponent = 63 - static_cast<int>(llvm::countLeadingZeros(value));
+  if (exponent >= kOpLatencyMaxExponent) {
+    return kOpLatencyBuckets - 1;
+  }
+  const auto sub_bucket = (value >> (exponent - kOpLatencySubBucketBits)) &
+      ((uint64_t(1) << kOpLatencySubBucketBits) - 1);
+  return 1 +
+      (static_cast<size_t>(exponent - kOpLatencyMinExponent)
+       << kOpLatencySubBucketBits) +
+      sub_bucket;
+}
+
+OpLatencyCounters* opLatencyCounters(OpLatencyThreadState& state, const char* name) {
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ull;
+  for (const char* c = name; *c; ++c) {
+    hash = (hash ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+  }
+  for (size_t probe = 0; probe < kOpLatencyTableSize; ++probe) {
+    const size_t idx = (hash + probe) % kOpLatencyTableSize;
+    auto* counters = state.table[idx].load(std::memory_order_relaxed);
+    if (!counters) {
+      state.owned.push_back(std::make_unique<OpLatencyCounters>(name));
+      state.hashes[idx] = hash;
+      counters = state.owned.back().get();
+      state.table[idx].store(counters, std::memory_order_release);
+      return counters;
+    }
+    if (state.hashes[idx] == hash && counters->name == name) {
+      return counters;
+    }
+  }
+  return nullptr;
+}
+
+void startOpLatency(const at::RecordFunction& fn) {
+  auto& state = opLatencyThreadState();
+  const auto generation = op_latency_generation.load(std::memory_order_relaxed);
+  if (state.generation != generation) {
+    state.depth = 0;
+    state.generation = generation;
+  }
+  if (state.depth < kMaxOpLatencyDepth) {
+    state.open[state.depth++] = std::make_pair(&fn, getTime());
+  }
+}
+
+void endOpLatency(const at::RecordFunction& fn) {
+  const int64_t end_ns = getTime();
+  auto& state = opLatencyThreadState();
+  size_t idx = state.depth;
+  while (idx > 0 && state.open[idx - 1].first != &fn) {
+    --idx;
+  }
+  if (idx == 0) {
+    return;
+  }
+  const int64_t duration_ns = end_ns - state.open[idx - 1].second;
+  state.depth = idx - 1;
+
+  auto* counters = opLatencyCounters(state, fn.name().str());
+  if (!counters) {
+    return;
+  }
+  bump<uint64_t>(counters->count, 1);
+  bump<int64_t>(counters->total_ns, duration_ns);
+  bump<uint64_t>(counters->buckets[opLatencyBucket(duration_ns)], 1);
+}
+
+} // namespace
+
+int64_t OpLatencyHistogram::bucketLowerBound(size_t bucket) {
+  TORCH_CHECK(bucket < kOpLatencyBuckets, "bucket ", bucket, " out of range");
+  if (bucket == 0) {
+    return 0;
+  }
+  const int exponent = kOpLatencyMinExponent +
+      static_cast<int>((bucket - 1) >> kOpLatencySubBucketBits);
+  const int64_t sub_bucket =
+      (bucket - 1) & ((size_t(1) << kOpLatencySubBucketBits) - 1);
+  return (int64_t(1) << exponent) +
+      (sub_bucket << (exponent - kOpLatencySubBucketBits));
+}
+
+int64_t OpLatencyHistogram::quantile(double q) const {
+  TORCH_CHECK(q >= 0 && q <= 1, "quantile must be in [0, 1], but got ", q);
+  if (count == 0) {
+    return 0;
+  }
+  const auto rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(q * count)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kOpLatencyBuckets; ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return bucketLowerBound(i);
+    }
+  }
+  return bucketLowerBound(kOpLatencyBuckets - 1);
+}
+
+void enableOpLatencyMetrics() {
+  TORCH_CHECK(!op_latency_handle, "Op latency metrics are already enabled");
+  ++op_latency_generation;
+  op_latency_handle = at::addGlobalCallback(
+      at::RecordFunctionCallback(&startOpLatency, &endOpLatency));
+  at::enableRecordFunction();
+}
+
+void disableOpLatencyMetrics() {
+  TORCH_CHECK(op_latency_handle, "Can't disable op latency metrics when they are not enabled");
+  at::removeCallback(op_latency_handle);
+  op_latency_handle = 0;
+}
+
+bool opLatencyMetricsEnabled() {
+  return op_latency_handle != 0;
+}
+
+std::vector<OpLatencyHistogram> scrapeOpLatencyMetrics() {
+  std::unordered_map<std::string, OpLatencyHistogram> merged;
+  {
+    std::lock_guard<std::mutex> states_guard(op_latency_states_mutex);
+    for (const auto& state : op_latency_states) {
+      for (const auto& slot : state->table) {
+        const auto* counters = slot.load(std::memory_order_acquire);
+        if (!counters) {
+          continue;
+        }
+        auto& total = merged[counters->name];
+        total.name = counters->name;
+        total.count += counters->count.load(std::memory_order_relaxed);
+        total.total_ns += counters->total_ns.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < kOpLatencyBuckets; ++i) {
+          total.buckets[i] += counters->buckets[i].load(std::memory_order_relaxed);
+        }
+      }
+    }
+  }
+  std::vector<OpLatencyHistogram> result;
+  result.reserve(merged.size());
+  for (auto& kv : merged) {
+    result.push_back(std::move(kv.second));
+  }
+  std::sort(
+      result.begin(), result.end(),
+      [](const OpLatencyHistogram& a, const OpLatencyHistogram& b) {
+        return a.name < b.name;
+      });
+  return result;
+}
+
 
 static jit::CodeTemplate event_template(R"(
 {
@@ -415,36 +851,66 @@ static jit::CodeTemplate event_template(R"(
   "args": {}
 })");
 
+static jit::CodeTemplate activity_template(R"(
+{
+  "name": "${name}",
+  "ph": "X",
+  "ts": ${ts},
+  "dur": ${dur},
+  "tid": "stream ${stream}",
+  "pid": "CUDA device ${device}",
+  "args": {}
+})");
+
+// Arrow from the range launching an activity to the activity
+static jit::CodeTemplate flow_template(R"(
+{
+  "name": "launch",
+  "ph": "${ph}",
+  "bp": "e",
+  "ts": ${ts},
+  "tid": ${tid},
+  "pid": ${pid},
+  "id": ${id},
+  "cat": "cpu_to_cuda",
+  "args": {}
+})");
 
-RecordProfile::RecordProfile(std::ostream& out)
-: out_(out) {
+
+RecordProfile::RecordProfile(std::ostream& out, ProfilerState state)
+: out_(out), state_(state) {
   init();
 }
 
-RecordProfile::RecordProfile(const std::string& filename)
-: file_(new std::ofstream(filename)), out_(*file_) {
+RecordProfile::RecordProfile(const std::string& filename, ProfilerState state)
+: file_(new std::ofstream(filename)), out_(*file_), state_(state) {
   init();
 }
 
 void RecordProfile::init() {
-  enableProfiler(ProfilerConfig(ProfilerState::CPU, false /* report shapes */));
+  TORCH_CHECK(
+      state_ == ProfilerState::CPU || state_ == ProfilerState::CUPTI,
+      "RecordProfile supports the CPU and CUPTI profiler states only");
+  enableProfiler(ProfilerConfig(state_, false /* report shapes */));
 }
 
 RecordProfile::~RecordProfile() {
-  thread_event_lists event_lists = disableProfiler();
+  auto result = disableProfilerWithActivities();
   std::vector<Event*> events;
-  for(auto& l : event_lists) {
+  for(auto& l : result.first) {
     for(auto& e : l) {
         events.push_back(&e);
     }
   }
-  processEvents(events);
+  processEvents(events, result.second);
   if (file_){
     file_->close();
   }
 }
 
-void RecordProfile::processEvents(const std::vector<Event*>& events) {
+void RecordProfile::processEvents(
+    const std::vector<Event*>& events,
+    const std::vector<CUDAActivity>& activities) {
   TORCH_CHECK(out_, "could not open file");
   Event* start = nullptr;
   for (Event* e : events) {
@@ -475,6 +941,46 @@ void RecordProfile::processEvents(const std::vector<Event*>& events) {
       out_ << event_template.format(env);
     }
   }
+
+  std::unordered_map<uint64_t, Event*> launches;
+  for (Event* e : events) {
+    if (e->correlation_id() != 0) {
+      launches[e->correlation_id()] = e;
+    }
+  }
+  for (const auto& activity : activities) {
+    if (!first) {
+      out_ << ",\n";
+    }
+    first = false;
+    const double ts = (activity.start_ns - start->cpu_ns()) / 1000.0;
+    jit::TemplateEnv env;
+    env.s("name", activity.name);
+    env.d("ts", ts);
+    env.d("dur", (activity.end_ns - activity.start_ns) / 1000.0);
+    env.d("stream", activity.stream);
+    env.d("device", activity.device);
+    out_ << activity_template.format(env);
+
+    auto it = launches.find(activity.correlation_id);
+    if (it == launches.end()) {
+      continue;
+    }
+    jit::TemplateEnv launch_env;
+    launch_env.s("ph", "s");
+    launch_env.d("ts", start->cpu_elapsed_us(*it->second));
+    launch_env.d("tid", it->second->thread_id());
+    launch_env.s("pid", "\"CPU Functions\"");
+    launch_env.d("id", activity.correlation_id);
+    out_ << ",\n" << flow_template.format(launch_env);
+    jit::TemplateEnv arrival_env;
+    arrival_env.s("ph", "f");
+    arrival_env.d("ts", ts);
+    arrival_env.s("tid", "\"stream " + c10::to_string(activity.stream) + "\"");
+    arrival_env.s("pid", "\"CUDA device " + c10::to_string(activity.device) + "\"");
+    arrival_env.d("id", activity.correlation_id);
+    out_ << ",\n" << flow_template.format(arrival_env);
+  }
   out_ << "]\n";
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <mutex>
 #include <memory>
@@ -28,6 +29,25 @@ struct Node;
 
 namespace profiler {
 
+enum class CUDAActivityKind : uint8_t {
+  Kernel,
+  Memcpy,
+  Memset,
+};
+
+// A kernel, memcpy or memset executed on a device, as recorded by CUPTI.
+// Timestamps are on the clock of getTime(); correlation_id is the one of the
+// innermost profiled range that launched it, or 0 if none did.
+struct TORCH_API CUDAActivity {
+  CUDAActivityKind kind;
+  std::string name;
+  int device;
+  uint32_t stream;
+  int64_t start_ns;
+  int64_t end_ns;
+  uint64_t correlation_id;
+};
+
 struct TORCH_API CUDAStubs {
   virtual void record(int* device, CUDAEventStub* event, int64_t* cpu_ns) {
     fail();
@@ -54,6 +74,26 @@ struct TORCH_API CUDAStubs {
   virtual void synchronize() {
     fail();
   }
+  virtual bool cuptiEnabled() {
+    return false;
+  }
+  // Starts recording CUDA activity of the whole process.
+  virtual void enableActivities() {
+    fail();
+  }
+  // Stops recording and returns the activity recorded since enableActivities.
+  virtual std::vector<CUDAActivity> disableActivities() {
+    fail();
+    return {};
+  }
+  // Attributes the activity launched by this thread to correlation_id, until
+  // the matching popCorrelationId.
+  virtual void pushCorrelationId(uint64_t correlation_id) {
+    fail();
+  }
+  virtual void popCorrelationId() {
+    fail();
+  }
   virtual ~CUDAStubs();
 
 private:
@@ -98,20 +138,29 @@ enum class TORCH_API ProfilerState {
     CPU, // CPU-only profiling
     CUDA, // CPU + CUDA events
     NVTX,  // only emit NVTX markers
+    CUPTI, // CPU + CUDA kernels, memcpys and memsets recorded by CUPTI
 };
 
 struct TORCH_API ProfilerConfig {
-  ProfilerConfig(ProfilerState state, bool report_input_shapes)
-      : state(state), report_input_shapes(report_input_shapes) {}
+  ProfilerConfig(
+      ProfilerState state,
+      bool report_input_shapes,
+      bool profile_memory = false)
+      : state(state),
+        report_input_shapes(report_input_shapes),
+        profile_memory(profile_memory) {}
   ~ProfilerConfig();
   ProfilerState state;
   bool report_input_shapes;
+  // Record the allocations and frees of the CPU and CUDA allocators
+  bool profile_memory;
 };
 
 enum class TORCH_API EventKind : uint16_t {
   Mark,
   PushRange,
-  PopRange
+  PopRange,
+  MemoryAlloc,
 };
 #ifndef _MSC_VER
 #  pragma GCC diagnostic pop
@@ -123,11 +172,13 @@ struct TORCH_API Event final {
       at::StringView name,
       uint16_t thread_id,
       bool record_cuda,
-      std::vector<std::vector<int64_t>>&& shapes = {})
+      std::vector<std::vector<int64_t>>&& shapes = {},
+      uint64_t correlation_id = 0)
       : name_(std::move(name)),
         kind_(kind),
         thread_id_(thread_id),
-        shapes_(shapes) {
+        shapes_(shapes),
+        correlation_id_(correlation_id) {
     record(record_cuda);
   }
 
@@ -137,6 +188,7 @@ struct TORCH_API Event final {
       case EventKind::Mark: return "mark";
       case EventKind::PushRange: return "push";
       case EventKind::PopRange: return "pop";
+      case EventKind::MemoryAlloc: return "memory_alloc";
     }
     throw std::runtime_error("unknown EventKind");
   }
@@ -152,6 +204,27 @@ struct TORCH_API Event final {
   double cpu_elapsed_us(const Event & e) {
     return (e.cpu_ns_ - cpu_ns_)/(1000.0);
   }
+  int64_t cpu_ns() const {
+    return cpu_ns_;
+  }
+  // Links a push event to the CUDAActivity it launched in CUPTI mode.
+  uint64_t correlation_id() const {
+    return correlation_id_;
+  }
+  // Bytes allocated (negative if freed) by a memory_alloc event
+  void updateMemoryStats(int64_t alloc_size, c10::Device device) {
+    if (device.type() == c10::DeviceType::CUDA) {
+      cuda_memory_usage_ = alloc_size;
+    } else if (device.type() == c10::DeviceType::CPU) {
+      cpu_memory_usage_ = alloc_size;
+    }
+  }
+  int64_t cpu_memory_usage() const {
+    return cpu_memory_usage_;
+  }
+  int64_t cuda_memory_usage() const {
+    return cuda_memory_usage_;
+  }
   double cuda_elapsed_us(const Event & e);
   bool has_cuda() const {
     return event != nullptr;
@@ -166,6 +239,9 @@ private:
   EventKind kind_;
   uint16_t thread_id_;
   std::vector<std::vector<int64_t>> shapes_;
+  uint64_t correlation_id_ = 0;
+  int64_t cpu_memory_usage_ = 0;
+  int64_t cuda_memory_usage_ = 0;
   int device_ = -1;
   struct CUevent_st* event = nullptr;
 };
@@ -214,8 +290,88 @@ using thread_event_lists = std::vector<std::vector<Event>>;
 // across thread boundary (e.g. at::launch tasks)
 TORCH_API void enableProfiler(const ProfilerConfig&);
 TORCH_API thread_event_lists disableProfiler();
+// Like disableProfiler, and also returns the CUDA activity recorded in CUPTI
+// mode.
+TORCH_API std::pair<thread_event_lists, std::vector<CUDAActivity>>
+disableProfilerWithActivities();
 TORCH_API bool profilerEnabled();
 
+// Sampling profiler
+//
+// The profiler above records a pair of Events with the input shapes for every
+// range, which is too expensive to leave on. The sampling profiler instead
+// times 1 in sample_period ranges on average (picked with a thread local
+// countdown) and folds each sample right away into per-op statistics kept in
+// preallocated per thread state, so it can stay enabled while serving.
+//
+// It uses a global RecordFunction callback: enable and disable it while no
+// other code runs, e.g. during initialization, and note that RecordFunction
+// must be enabled (at::enableRecordFunction) on the threads to profile;
+// enableSamplingProfiler does it for the calling thread.
+
+// Duration histogram buckets: bucket 0 counts samples shorter than 1us and
+// bucket i > 0 those in [2^(i-1), 2^i) us; the last one is unbounded.
+constexpr size_t kSampledOpHistogramBuckets = 32;
+
+struct TORCH_API SampledOpStats {
+  std::string name;
+  uint64_t count = 0;
+  int64_t total_ns = 0;
+  int64_t max_ns = 0;
+  std::array<uint64_t, kSampledOpHistogramBuckets> histogram{};
+};
+
+TORCH_API void enableSamplingProfiler(uint64_t sample_period);
+TORCH_API void disableSamplingProfiler();
+TORCH_API bool samplingProfilerEnabled();
+// Returns the statistics of the sampled ranges, merged across threads and
+// sorted by name; reset clears them.
+TORCH_API std::vector<SampledOpStats> samplingProfilerStats(bool reset = false);
+
+// Operator latency metrics
+//
+// Times every range, to export per-op call counts and latency histograms,
+// e.g. as service metrics (see torch/csrc/distributed/rpc/metrics). Each
+// thread records into its own fixed-size table of counters that only it
+// writes, with relaxed atomic stores: recording takes no lock, and allocates
+// only the first time a thread sees an op. Scraping sums the tables of all
+// threads while they keep recording. The counters are never reset, so
+// consumers compute rates from the difference of two scrapes.
+//
+// Same RecordFunction caveats as the sampling profiler.
+
+// Log-linear (HDR style) buckets: bucket 0 counts durations shorter than
+// 2^kOpLatencyMinExponent ns, and every power of two above that is split into
+// 2^kOpLatencySubBucketBits equal buckets, which bounds the relative error of
+// a duration to 25%. The last bucket counts durations of at least
+// 2^kOpLatencyMaxExponent ns (about 137s).
+constexpr int kOpLatencyMinExponent = 7;
+constexpr int kOpLatencyMaxExponent = 37;
+constexpr int kOpLatencySubBucketBits = 2;
+constexpr size_t kOpLatencyBuckets = 2 +
+    (static_cast<size_t>(kOpLatencyMaxExponent - kOpLatencyMinExponent)
+     << kOpLatencySubBucketBits);
+
+struct TORCH_API OpLatencyHistogram {
+  std::string name;
+  uint64_t count = 0;
+  int64_t total_ns = 0;
+  std::array<uint64_t, kOpLatencyBuckets> buckets{};
+
+  // Smallest duration counted in the given bucket.
+  static int64_t bucketLowerBound(size_t bucket);
+  // Lower bound of the bucket holding the q-quantile of the durations, or 0
+  // if there are none.
+  int64_t quantile(double q) const;
+};
+
+TORCH_API void enableOpLatencyMetrics();
+TORCH_API void disableOpLatencyMetrics();
+TORCH_API bool opLatencyMetricsEnabled();
+// Returns the metrics of every op recorded since the process started, merged
+// across threads and sorted by name.
+TORCH_API std::vector<OpLatencyHistogram> scrapeOpLatencyMetrics();
+
 
 // Usage:
 //   {
@@ -223,16 +379,25 @@ TORCH_API bool profilerEnabled();
 //     // code you want to profile
 //   }
 // Then open filename.trace in chrome://tracing
+//
+// With ProfilerState::CUPTI, the trace also shows the kernels, memcpys and
+// memsets on a timeline per device and stream, with arrows from the ranges
+// that launched them. Perfetto (ui.perfetto.dev) opens the same file.
 struct TORCH_API RecordProfile {
-  RecordProfile(std::ostream& out);
-  RecordProfile(const std::string& filename);
+  RecordProfile(std::ostream& out, ProfilerState state = ProfilerState::CPU);
+  RecordProfile(
+      const std::string& filename,
+      ProfilerState state = ProfilerState::CPU);
 
   ~RecordProfile();
 private:
   void init();
   std::unique_ptr<std::ofstream> file_;
   std::ostream& out_;
-  void processEvents(const std::vector<Event*>& events);
+  ProfilerState state_;
+  void processEvents(
+      const std::vector<Event*>& events,
+      const std::vector<CUDAActivity>& activities);
 };
 
 
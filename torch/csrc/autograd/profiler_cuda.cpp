@@ -1,8 +1,16 @@
 #include <torch/csrc/autograd/profiler.h>
 #include <c10/cuda/CUDAGuard.h>
+#include <c10/util/Exception.h>
+#include <c10/util/Type.h>
 #include <nvToolsExt.h>
+#ifdef USE_CUPTI
+#include <cupti.h>
+#endif
 
+#include <atomic>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 
 namespace torch { namespace autograd { namespace profiler {
 
@@ -31,6 +39,123 @@ static inline void cudaCheck(cudaError_t result, const char * file, int line) {
 }
 #define TORCH_CUDA_CHECK(result) cudaCheck(result,__FILE__,__LINE__);
 
+#ifdef USE_CUPTI
+
+#define TORCH_CUPTI_CHECK(call)                                  \
+  do {                                                           \
+    CUptiResult status = call;                                   \
+    if (status != CUPTI_SUCCESS) {                               \
+      const char* msg = nullptr;                                 \
+      cuptiGetResultString(status, &msg);                        \
+      TORCH_CHECK(false, #call, " failed: ", msg ? msg : "?");   \
+    }                                                            \
+  } while (0)
+
+// Activity records are handed to us by CUPTI in buffers we allocate, once
+// they are full or flushed, from a CUPTI thread.
+constexpr size_t kActivityBufferSize = 4 * 1024 * 1024;
+
+const CUpti_ActivityKind kActivityKinds[] = {
+  CUPTI_ACTIVITY_KIND_CONCURRENT_KERNEL,
+  CUPTI_ACTIVITY_KIND_MEMCPY,
+  CUPTI_ACTIVITY_KIND_MEMSET,
+  CUPTI_ACTIVITY_KIND_EXTERNAL_CORRELATION,
+};
+
+struct ActivityCollector {
+  std::mutex mutex;
+  std::vector<CUDAActivity> activities;
+  // CUPTI correlation id of a launch -> correlation id of the profiled
+  // range it was made in
+  std::unordered_map<uint32_t, uint64_t> range_ids;
+  // getTime() - cuptiGetTimestamp()
+  int64_t clock_offset_ns = 0;
+};
+
+ActivityCollector& collector() {
+  static ActivityCollector collector_;
+  return collector_;
+}
+
+const char* memcpyName(uint8_t copy_kind) {
+  switch (copy_kind) {
+    case CUPTI_ACTIVITY_MEMCPY_KIND_HTOD: return "Memcpy HtoD";
+    case CUPTI_ACTIVITY_MEMCPY_KIND_DTOH: return "Memcpy DtoH";
+    case CUPTI_ACTIVITY_MEMCPY_KIND_DTOD: return "Memcpy DtoD";
+    case CUPTI_ACTIVITY_MEMCPY_KIND_HTOH: return "Memcpy HtoH";
+    case CUPTI_ACTIVITY_MEMCPY_KIND_PTOP: return "Memcpy PtoP";
+    default: return "Memcpy";
+  }
+}
+
+void CUPTIAPI bufferRequested(
+    uint8_t** buffer,
+    size_t* size,
+    size_t* max_num_records) {
+  *buffer = new uint8_t[kActivityBufferSize];
+  *size = kActivityBufferSize;
+  *max_num_records = 0;
+}
+
+void CUPTIAPI bufferCompleted(
+    CUcontext /* ctx */,
+    uint32_t /* stream_id */,
+    uint8_t* buffer,
+    size_t /* size */,
+    size_t valid_size) {
+  auto& c = collector();
+  {
+    std::lock_guard<std::mutex> guard(c.mutex);
+    CUpti_Activity* record = nullptr;
+    while (cuptiActivityGetNextRecord(buffer, valid_size, &record) ==
+           CUPTI_SUCCESS) {
+      switch (record->kind) {
+        case CUPTI_ACTIVITY_KIND_CONCURRENT_KERNEL: {
+          auto kernel = reinterpret_cast<const CUpti_ActivityKernel4*>(record);
+          c.activities.push_back(CUDAActivity{
+              CUDAActivityKind::Kernel, c10::demangle(kernel->name),
+              static_cast<int>(kernel->deviceId), kernel->streamId,
+              static_cast<int64_t>(kernel->start),
+              static_cast<int64_t>(kernel->end), kernel->correlationId});
+          break;
+        }
+        case CUPTI_ACTIVITY_KIND_MEMCPY: {
+          auto memcpy = reinterpret_cast<const CUpti_ActivityMemcpy*>(record);
+          c.activities.push_back(CUDAActivity{
+              CUDAActivityKind::Memcpy, memcpyName(memcpy->copyKind),
+              static_cast<int>(memcpy->deviceId), memcpy->streamId,
+              static_cast<int64_t>(memcpy->start),
+              static_cast<int64_t>(memcpy->end), memcpy->correlationId});
+          break;
+        }
+        case CUPTI_ACTIVITY_KIND_MEMSET: {
+          auto memset = reinterpret_cast<const CUpti_ActivityMemset*>(record);
+          c.activities.push_back(CUDAActivity{
+              CUDAActivityKind::Memset, "Memset",
+              static_cast<int>(memset->deviceId), memset->streamId,
+              static_cast<int64_t>(memset->start),
+              static_cast<int64_t>(memset->end), memset->correlationId});
+          break;
+        }
+        case CUPTI_ACTIVITY_KIND_EXTERNAL_CORRELATION: {
+          auto correlation =
+              reinterpret_cast<const CUpti_ActivityExternalCorrelation*>(record);
+          if (correlation->externalKind ==
+              CUPTI_EXTERNAL_CORRELATION_KIND_CUSTOM0) {
+            c.range_ids[correlation->correlationId] = correlation->externalId;
+          }
+          break;
+        }
+        default:
+          break;
+      }
+    }
+  }
+  delete[] buffer;
+}
+
+#endif // USE_CUPTI
+
 struct CUDAMethods : public CUDAStubs {
   void record(int* device, CUDAEventStub* event, int64_t* cpu_ns) override {
     TORCH_CUDA_CHECK(cudaGetDevice(device));
@@ -69,7 +194,72 @@ struct CUDAMethods : public CUDAStubs {
   bool enabled() override {
     return true;
   }
+#ifdef USE_CUPTI
+  bool cuptiEnabled() override {
+    return true;
+  }
+  void enableActivities() override {
+    bool expected = false;
+    TORCH_CHECK(
+        activities_enabled_.compare_exchange_strong(expected, true),
+        "CUPTI profiler is already running in this process");
+    static bool registered = [] {
+      TORCH_CUPTI_CHECK(
+          cuptiActivityRegisterCallbacks(bufferRequested, bufferCompleted));
+      return true;
+    }();
+    (void)registered;
+    auto& c = collector();
+    {
+      std::lock_guard<std::mutex> guard(c.mutex);
+      c.activities.clear();
+      c.range_ids.clear();
+      uint64_t cupti_ns = 0;
+      TORCH_CUPTI_CHECK(cuptiGetTimestamp(&cupti_ns));
+      c.clock_offset_ns = getTime() - static_cast<int64_t>(cupti_ns);
+    }
+    for (auto kind : kActivityKinds) {
+      TORCH_CUPTI_CHECK(cuptiActivityEnable(kind));
+    }
+  }
+  std::vector<CUDAActivity> disableActivities() override {
+    // Activity is recorded asynchronously, so wait for work in flight.
+    cudaDeviceSynchronize();
+    for (auto kind : kActivityKinds) {
+      cuptiActivityDisable(kind);
+    }
+    TORCH_CUPTI_CHECK(cuptiActivityFlushAll(0));
+
+    auto& c = collector();
+    std::vector<CUDAActivity> activities;
+    {
+      std::lock_guard<std::mutex> guard(c.mutex);
+      activities.swap(c.activities);
+      for (auto& activity : activities) {
+        auto it = c.range_ids.find(activity.correlation_id);
+        activity.correlation_id = it == c.range_ids.end() ? 0 : it->second;
+        activity.start_ns += c.clock_offset_ns;
+        activity.end_ns += c.clock_offset_ns;
+      }
+      c.range_ids.clear();
+    }
+    activities_enabled_ = false;
+    return activities;
+  }
+  void pushCorrelationId(uint64_t correlation_id) override {
+    cuptiActivityPushExternalCorrelationId(
+        CUPTI_EXTERNAL_CORRELATION_KIND_CUSTOM0, correlation_id);
+  }
+  void popCorrelationId() override {
+    // Fails harmlessly for ranges ending on another thread.
+    uint64_t correlation_id = 0;
+    cuptiActivityPopExternalCorrelationId(
+        CUPTI_EXTERNAL_CORRELATION_KIND_CUSTOM0, &correlation_id);
+  }
 
+ private:
+  std::atomic<bool> activities_enabled_{false};
+#endif // USE_CUPTI
 };
 
 struct RegisterCUDAMethods {
@@ -55,6 +55,13 @@ void PythonEngine::thread_init(int device, const std::shared_ptr<ReadyQueue>& re
   Engine::thread_init(device, ready_queue);
 }
 
+void PythonEngine::cpu_worker_thread_init() {
+  // See thread_init above.
+  pybind11::gil_scoped_acquire gil;
+  pybind11::gil_scoped_release no_gil;
+  Engine::cpu_worker_thread_init();
+}
+
 void PythonEngine::thread_on_exception(
     std::shared_ptr<GraphTask> graph_task,
     const std::shared_ptr<Node>& fn,
@@ -171,7 +178,7 @@ PyObject *THPEngine_run_backward(THPEngine *self, PyObject *args, PyObject *kwar
     }
   }
 
-  std::vector<Edge> output_edges;
+  edge_list output_edges;
   if (inputs != nullptr) {
     int num_inputs = PyTuple_GET_SIZE(inputs);
     output_edges.reserve(num_inputs);
@@ -245,6 +252,26 @@ PyObject* THPEngine_is_checkpoint_valid(PyObject *self, PyObject *noargs) {
   END_HANDLE_TH_ERRORS
 }
 
+PyObject* THPEngine_set_num_cpu_workers(PyObject *self, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "num_workers must be an int, but got %s",
+      THPUtils_typename(arg));
+  auto num_workers = THPUtils_unpackLong(arg);
+  THPUtils_assert(num_workers >= 0, "num_workers must be non-negative, but got %lld",
+      static_cast<long long>(num_workers));
+  auto& engine = python::PythonEngine::get_python_engine();
+  engine.set_num_cpu_workers(static_cast<size_t>(num_workers));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject* THPEngine_num_cpu_workers(PyObject *self, PyObject *noargs) {
+  HANDLE_TH_ERRORS
+  auto& engine = python::PythonEngine::get_python_engine();
+  return THPUtils_packUInt64(engine.num_cpu_workers());
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject *THPEngine_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
 {
   return type->tp_alloc(type, 0);
@@ -254,6 +281,8 @@ static struct PyMethodDef THPEngine_methods[] = {
   {(char*)"run_backward", (PyCFunction)(void(*)(void))THPEngine_run_backward, METH_VARARGS | METH_KEYWORDS, nullptr},
   {(char*)"queue_callback", (PyCFunction)THPEngine_queue_callback, METH_O, nullptr},
   {(char*)"is_checkpoint_valid", (PyCFunction)THPEngine_is_checkpoint_valid, METH_NOARGS, nullptr},
+  {(char*)"set_num_cpu_workers", (PyCFunction)THPEngine_set_num_cpu_workers, METH_O, nullptr},
+  {(char*)"num_cpu_workers", (PyCFunction)THPEngine_num_cpu_workers, METH_NOARGS, nullptr},
   {nullptr}
 };
 
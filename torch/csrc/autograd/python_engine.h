@@ -12,6 +12,7 @@ namespace torch { namespace autograd { namespace python {
 struct PythonEngine : public Engine {
   static Engine& get_python_engine();
   void thread_init(int device, const std::shared_ptr<ReadyQueue>& ready_queue) override;
+  void cpu_worker_thread_init() override;
   void thread_on_exception(
       std::shared_ptr<GraphTask> graph_task,
       const std::shared_ptr<Node>& fn,
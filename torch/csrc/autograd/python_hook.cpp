@@ -87,6 +87,35 @@ auto PyFunctionPostHook::operator()(
   return unwrap_variables(outputs.get());
 }
 
+PyPostAccumulateGradHook::PyPostAccumulateGradHook(PyObject* dict) : dict(dict) {
+  Py_INCREF(dict);
+}
+
+PyPostAccumulateGradHook::~PyPostAccumulateGradHook() {
+  pybind11::gil_scoped_acquire gil;
+  Py_DECREF(dict);
+}
+
+void PyPostAccumulateGradHook::operator()(const Variable& tensor) {
+  pybind11::gil_scoped_acquire gil;
+
+  THPObjectPtr value(THPVariable_Wrap(tensor));
+  if (!value) throw python_error();
+
+  PyObject *key, *hook;
+  Py_ssize_t pos = 0;
+  while (PyDict_Next(dict, &pos, &key, &hook)) {
+    THPObjectPtr res(PyObject_CallFunctionObjArgs(hook, value.get(), nullptr));
+    if (!res) throw python_error();
+    if (res != Py_None) {
+      std::stringstream ss;
+      ss << "post accumulate grad hook '" << hook_name(hook)
+         << "' should return None, but got " << THPUtils_typename(res.get());
+      throw std::runtime_error(ss.str());
+    }
+  }
+}
+
 }} // namespace torch::autograd
 
 
@@ -21,4 +21,11 @@ struct PyFunctionPostHook : public FunctionPostHook {
   PyObject* dict;
 };
 
+struct PyPostAccumulateGradHook : public PostAccumulateGradHook {
+  PyPostAccumulateGradHook(PyObject* dict);
+  ~PyPostAccumulateGradHook() override;
+  void operator()(const Variable& tensor) override;
+  PyObject* dict;
+};
+
 }} // namespace torch::autograd
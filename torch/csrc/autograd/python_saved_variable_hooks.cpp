@@ -0,0 +1,66 @@
+#include <torch/csrc/autograd/python_saved_variable_hooks.h>
+
+#include <pybind11/pybind11.h>
+#include <torch/csrc/THP.h>
+#include <torch/csrc/autograd/python_variable.h>
+#include <torch/csrc/utils/object_ptr.h>
+#include <torch/csrc/Exceptions.h>
+
+namespace torch { namespace autograd {
+
+PySavedVariableHooks::PySavedVariableHooks(PyObject* pack_hook, PyObject* unpack_hook)
+  : pack_hook_(pack_hook), unpack_hook_(unpack_hook) {
+  // Only created by PySavedVariableHooksFactory::make_hooks, with the GIL held.
+  Py_INCREF(pack_hook_);
+  Py_INCREF(unpack_hook_);
+}
+
+PySavedVariableHooks::~PySavedVariableHooks() {
+  // SavedVariables may be destroyed on any thread, e.g., an autograd worker.
+  pybind11::gil_scoped_acquire gil;
+  Py_DECREF(pack_hook_);
+  Py_DECREF(unpack_hook_);
+  Py_XDECREF(data_);
+}
+
+void PySavedVariableHooks::call_pack_hook(const at::Tensor& tensor) {
+  pybind11::gil_scoped_acquire gil;
+  THPObjectPtr obj(THPVariable_Wrap(tensor));
+  if (!obj) throw python_error();
+  THPObjectPtr packed(PyObject_CallFunctionObjArgs(pack_hook_, obj.get(), nullptr));
+  if (!packed) throw python_error();
+  Py_XDECREF(data_);
+  data_ = packed.release();
+}
+
+at::Tensor PySavedVariableHooks::call_unpack_hook() {
+  pybind11::gil_scoped_acquire gil;
+  TORCH_INTERNAL_ASSERT(data_, "call_unpack_hook called before call_pack_hook");
+  THPObjectPtr res(PyObject_CallFunctionObjArgs(unpack_hook_, data_, nullptr));
+  if (!res) throw python_error();
+  if (!THPVariable_Check(res.get())) {
+    throw TypeError(
+        "Output of saved tensor unpack_hook expected to be a Tensor but got result of type %s",
+        THPUtils_typename(res.get()));
+  }
+  return THPVariable_Unpack(res.get());
+}
+
+PySavedVariableHooksFactory::PySavedVariableHooksFactory(PyObject* pack_hook, PyObject* unpack_hook)
+  : pack_hook_(pack_hook), unpack_hook_(unpack_hook) {
+  Py_INCREF(pack_hook_);
+  Py_INCREF(unpack_hook_);
+}
+
+PySavedVariableHooksFactory::~PySavedVariableHooksFactory() {
+  pybind11::gil_scoped_acquire gil;
+  Py_DECREF(pack_hook_);
+  Py_DECREF(unpack_hook_);
+}
+
+std::unique_ptr<SavedVariableHooks> PySavedVariableHooksFactory::make_hooks() {
+  pybind11::gil_scoped_acquire gil;
+  return std::unique_ptr<SavedVariableHooks>(new PySavedVariableHooks(pack_hook_, unpack_hook_));
+}
+
+}} // namespace torch::autograd
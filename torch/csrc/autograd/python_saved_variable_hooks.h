@@ -0,0 +1,33 @@
+#pragma once
+
+#include <torch/csrc/python_headers.h>
+#include <torch/csrc/autograd/saved_variable_hooks.h>
+
+namespace torch { namespace autograd {
+
+// Saved variable hooks calling a pair of Python functions: pack_hook(tensor)
+// may return any Python object, which is passed to unpack_hook when the
+// variable is unpacked.
+struct PySavedVariableHooks : public SavedVariableHooks {
+  PySavedVariableHooks(PyObject* pack_hook, PyObject* unpack_hook);
+  ~PySavedVariableHooks() override;
+  void call_pack_hook(const at::Tensor& tensor) override;
+  at::Tensor call_unpack_hook() override;
+
+ private:
+  PyObject* pack_hook_;
+  PyObject* unpack_hook_;
+  PyObject* data_ = nullptr;
+};
+
+struct PySavedVariableHooksFactory : public SavedVariableHooksFactory {
+  PySavedVariableHooksFactory(PyObject* pack_hook, PyObject* unpack_hook);
+  ~PySavedVariableHooksFactory() override;
+  std::unique_ptr<SavedVariableHooks> make_hooks() override;
+
+ private:
+  PyObject* pack_hook_;
+  PyObject* unpack_hook_;
+};
+
+}} // namespace torch::autograd
@@ -76,6 +76,7 @@ PyObject * THPVariable_Wrap(Variable var)
 static int THPVariable_traverse(THPVariable *self, visitproc visit, void *arg)
 {
   Py_VISIT(self->backward_hooks);
+  Py_VISIT(self->post_accumulate_grad_hooks);
   // We don't want to traverse the grad_fn, even if the Variable owns it and the
   // shared pointer's use count is 1. This is because we would need to treat
   // the grad_fn as part of the Python state and hold the GIL sometimes when
@@ -103,7 +104,9 @@ static int THPVariable_traverse(THPVariable *self, visitproc visit, void *arg)
 static int THPVariable_clear(THPVariable *self)
 {
   Py_CLEAR(self->backward_hooks);
+  Py_CLEAR(self->post_accumulate_grad_hooks);
   if (self->cdata.defined()) {
+    torch::autograd::impl::set_post_acc_grad_hook(self->cdata, nullptr);
     if (auto grad_acc = torch::autograd::impl::try_get_grad_accumulator(self->cdata)) {
       grad_acc->pre_hooks().clear();
     }
@@ -437,6 +440,33 @@ int THPVariable_set_backwards_hooks(THPVariable *self, PyObject *obj, void *unus
   END_HANDLE_TH_ERRORS_RET(-1)
 }
 
+PyObject *THPVariable_get_post_accumulate_grad_hooks(THPVariable *self, void *unused)
+{
+  HANDLE_TH_ERRORS
+  if (self->post_accumulate_grad_hooks) {
+    Py_INCREF(self->post_accumulate_grad_hooks);
+    return self->post_accumulate_grad_hooks;
+  }
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+int THPVariable_set_post_accumulate_grad_hooks(THPVariable *self, PyObject *obj, void *unused)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assertRet(-1, obj, "Deletion of _post_accumulate_grad_hooks not allowed!");
+  if (obj == Py_None) {
+    obj = nullptr;
+  }
+  Py_XINCREF(obj);
+  Py_XDECREF(self->post_accumulate_grad_hooks);
+  self->post_accumulate_grad_hooks = obj;
+  torch::autograd::impl::set_post_acc_grad_hook(
+      self->cdata, obj ? std::make_shared<PyPostAccumulateGradHook>(obj) : nullptr);
+  return 0;
+  END_HANDLE_TH_ERRORS_RET(-1)
+}
+
 PyObject *THPVariable_get_base(THPVariable *self, void *unused)
 {
   HANDLE_TH_ERRORS
@@ -532,6 +562,7 @@ static struct PyGetSetDef THPVariable_properties[] = {
   {"output_nr", (getter)THPVariable_get_output_nr, nullptr, nullptr, nullptr},
   {"requires_grad", (getter)THPVariable_get_requires_grad, (setter)THPVariable_set_requires_grad, nullptr, nullptr},
   {"_backward_hooks", (getter)THPVariable_get_backwards_hooks, (setter)THPVariable_set_backwards_hooks, nullptr, nullptr},
+  {"_post_accumulate_grad_hooks", (getter)THPVariable_get_post_accumulate_grad_hooks, (setter)THPVariable_set_post_accumulate_grad_hooks, nullptr, nullptr},
   {"name", (getter)THPVariable_get_name, nullptr, nullptr, nullptr},
   {"shape", (getter)THPVariable_get_shape, nullptr, nullptr, nullptr},
   {"is_cuda", (getter)THPVariable_is_cuda, nullptr, nullptr, nullptr},
@@ -16,6 +16,10 @@ struct THPVariable {
     // Hooks to be run on backwards pass (corresponds to Python attr
     // '_backwards_hooks', set by 'register_hook')
     PyObject* backward_hooks = nullptr;
+    // Hooks to be run once the grad of this leaf has been accumulated
+    // (corresponds to Python attr '_post_accumulate_grad_hooks', set by
+    // 'register_post_accumulate_grad_hook')
+    PyObject* post_accumulate_grad_hooks = nullptr;
 };
 
 THP_API PyObject *THPVariableClass;
@@ -11,11 +11,16 @@
 #include <list>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 namespace torch { namespace autograd {
 
 SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_inplace_view) {
   if (variable.defined()) {
+    TORCH_CHECK(
+        variable.unsafeGetTensorImpl()->version_counter().enabled(),
+        "Inference tensors cannot be saved for backward. To work around it, "
+        "you can make a clone to get a normal tensor and use it in autograd.");
     was_default_constructed_ = false;
     output_nr_ = variable.output_nr();
     requires_grad_ = variable.requires_grad();
@@ -33,11 +38,20 @@ SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_i
     }
     version_counter_ = impl::version_counter(variable);
     saved_version_ = version_counter_.current_version();
+
+    if (auto* factory = SavedTensorDefaultHooks::get_hooks_factory()) {
+      hooks_ = factory->make_hooks();
+      {
+        DisableSavedTensorDefaultHooks no_hooks;
+        hooks_->call_pack_hook(data_);
+      }
+      data_.reset();
+    }
   }
 }
 
 Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
-  if (!data_.defined()) {
+  if (!data_.defined() && !hooks_) {
     if (!was_default_constructed_) {
       throw std::runtime_error(ERR_BACKWARD_TWICE);
     }
@@ -54,11 +68,16 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
     grad_fn = std::move(saved_for);
   }
 
+  // The hooks may recompute the tensor without changing the version of the
+  // original one.
+  const auto data = hooks_ ? hooks_->call_unpack_hook().tensor_data() : data_;
+  TORCH_CHECK(data.defined(), "the unpack hook of a saved tensor returned an undefined tensor");
+
   if (saved_version_ != version_counter_.current_version()) {
     std::stringstream message;
     message << "one of the variables needed for gradient computation has been "
-        "modified by an inplace operation: [" << data_.toString() << " "
-        << data_.sizes() << "]";
+        "modified by an inplace operation: [" << data.toString() << " "
+        << data.sizes() << "]";
     if (grad_fn) {
         message << ", which is output " << output_nr_
             << " of " << grad_fn->name() << ",";
@@ -83,9 +102,9 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
   // in-place functions on unpacked variables.
   Variable var;
   if (grad_fn) {
-    var = make_variable(data_, Edge(std::move(grad_fn), output_nr_));
+    var = make_variable(data, Edge(std::move(grad_fn), output_nr_));
   } else {
-    var = make_variable(data_, requires_grad_);
+    var = make_variable(data, requires_grad_);
   }
   impl::set_version_counter(var, saved_version_);
 
@@ -100,6 +119,42 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
   return var;
 }
 
+namespace {
+
+struct SavedTensorDefaultHooksState {
+  std::vector<std::shared_ptr<SavedVariableHooksFactory>> stack;
+  bool enabled = true;
+};
+
+thread_local SavedTensorDefaultHooksState default_hooks_state;
+
+} // namespace
+
+void SavedTensorDefaultHooks::push_hooks(std::shared_ptr<SavedVariableHooksFactory> factory) {
+  TORCH_INTERNAL_ASSERT(factory);
+  default_hooks_state.stack.push_back(std::move(factory));
+}
+
+void SavedTensorDefaultHooks::pop_hooks() {
+  TORCH_CHECK(!default_hooks_state.stack.empty(), "no saved tensor default hooks to pop");
+  default_hooks_state.stack.pop_back();
+}
+
+SavedVariableHooksFactory* SavedTensorDefaultHooks::get_hooks_factory() {
+  if (!default_hooks_state.enabled || default_hooks_state.stack.empty()) {
+    return nullptr;
+  }
+  return default_hooks_state.stack.back().get();
+}
+
+bool SavedTensorDefaultHooks::is_enabled() {
+  return default_hooks_state.enabled;
+}
+
+void SavedTensorDefaultHooks::set_enabled(bool enabled) {
+  default_hooks_state.enabled = enabled;
+}
+
 const char* ERR_BACKWARD_TWICE =
     "Trying to backward through the graph a second time, but the buffers have "
     "already been freed. Specify retain_graph=True when calling backward "
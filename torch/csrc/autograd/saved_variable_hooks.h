@@ -0,0 +1,58 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <ATen/ATen.h>
+
+#include <memory>
+
+namespace torch { namespace autograd {
+
+/// Replaces the tensor held by a `SavedVariable` until backward needs it.
+///
+/// When a `SavedVariable` is created with hooks, it passes the tensor to
+/// `call_pack_hook` and keeps no reference to it; `call_unpack_hook` must
+/// return a tensor with the same content when the variable is unpacked. This
+/// lets a saved activation be recomputed (see `torch.utils.checkpoint`) or
+/// moved to another device in between.
+struct TORCH_API SavedVariableHooks {
+  virtual ~SavedVariableHooks() = default;
+  virtual void call_pack_hook(const at::Tensor& tensor) = 0;
+  virtual at::Tensor call_unpack_hook() = 0;
+};
+
+/// Creates the hooks of the variables saved while it is the innermost
+/// default, see `SavedTensorDefaultHooks`.
+struct TORCH_API SavedVariableHooksFactory {
+  virtual ~SavedVariableHooksFactory() = default;
+  virtual std::unique_ptr<SavedVariableHooks> make_hooks() = 0;
+};
+
+/// A thread local stack of hooks factories. Every `SavedVariable` created on
+/// a thread while the stack is non-empty gets its hooks from the factory on
+/// top of the stack. Hooks are not applied to the variables saved while a
+/// pack hook runs.
+struct TORCH_API SavedTensorDefaultHooks {
+  static void push_hooks(std::shared_ptr<SavedVariableHooksFactory> factory);
+  static void pop_hooks();
+  /// Returns the innermost factory, or nullptr if there is none, or if a
+  /// pack hook is running on this thread.
+  static SavedVariableHooksFactory* get_hooks_factory();
+  static bool is_enabled();
+  static void set_enabled(bool enabled);
+};
+
+/// RAII guard that disables the default hooks, e.g., while a pack hook runs.
+struct TORCH_API DisableSavedTensorDefaultHooks {
+  DisableSavedTensorDefaultHooks() : prev_(SavedTensorDefaultHooks::is_enabled()) {
+    SavedTensorDefaultHooks::set_enabled(false);
+  }
+  ~DisableSavedTensorDefaultHooks() {
+    SavedTensorDefaultHooks::set_enabled(prev_);
+  }
+
+ private:
+  bool prev_;
+};
+
+}} // namespace torch::autograd
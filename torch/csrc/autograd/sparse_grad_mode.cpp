@@ -0,0 +1,17 @@
+#include <torch/csrc/autograd/sparse_grad_mode.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace torch { namespace autograd {
+
+namespace {
+bool merge_sparse_grads_from_env() {
+  const char* env = std::getenv("TORCH_MERGE_SPARSE_GRADS");
+  return env != nullptr && std::strcmp(env, "1") == 0;
+}
+} // namespace
+
+bool SparseGradMergeMode::_enabled = merge_sparse_grads_from_env();
+
+}}
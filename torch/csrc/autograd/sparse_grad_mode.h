@@ -0,0 +1,27 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+namespace torch { namespace autograd {
+
+// When enabled, the engine accumulates sparse gradients with
+// at::_sparse_add_and_coalesce, which merges the already sorted indices of
+// both operands, instead of concatenating them and leaving the result
+// uncoalesced until something (typically the optimizer step) calls
+// coalesce(). This keeps repeated accumulation into the same embedding
+// gradient from growing nnz without bound.
+//
+// Disabled by default; set TORCH_MERGE_SPARSE_GRADS=1 to enable it at startup.
+struct TORCH_API SparseGradMergeMode {
+  static bool is_enabled() {
+    return _enabled;
+  }
+  static void set_enabled(bool enabled) {
+    _enabled = enabled;
+  }
+
+private:
+  static bool _enabled;
+};
+
+}}
@@ -233,6 +233,20 @@ namespace impl {
     materialize_autograd_meta(self)->hooks_.clear();
   }
 
+  void set_post_acc_grad_hook(const Variable& self, std::shared_ptr<PostAccumulateGradHook> hook) {
+    if (!hook && !get_autograd_meta(self)) {
+      return;
+    }
+    materialize_autograd_meta(self)->post_acc_grad_hook_ = std::move(hook);
+  }
+
+  PostAccumulateGradHook* post_acc_grad_hook(const Variable& self) {
+    if (auto meta = get_autograd_meta(self)) {
+      return meta->post_acc_grad_hook_.get();
+    }
+    return nullptr;
+  }
+
   void set_name(const Variable& self, const std::string& name) {
     materialize_autograd_meta(self)->name_ = name;
   }
@@ -167,6 +167,11 @@ namespace impl {
   TORCH_API const std::vector<std::shared_ptr<FunctionPreHook>>& hooks(const Variable&);
   TORCH_API void clear_hooks(const Variable&);
 
+  /// Sets the hook that `AccumulateGrad` calls after accumulating into the
+  /// grad of this leaf `Variable`; nullptr removes it.
+  TORCH_API void set_post_acc_grad_hook(const Variable&, std::shared_ptr<PostAccumulateGradHook> hook);
+  TORCH_API PostAccumulateGradHook* post_acc_grad_hook(const Variable&);
+
   TORCH_API void create_cpp_hook(const Variable&);
 }
 
@@ -188,6 +193,7 @@ struct TORCH_API AutogradMeta : public c10::AutogradMetaInterface {
 
   std::vector<std::shared_ptr<FunctionPreHook>> hooks_;
   std::shared_ptr<hooks_list> cpp_hooks_list;
+  std::shared_ptr<PostAccumulateGradHook> post_acc_grad_hook_;
 
   // Only meaningful on leaf variables (must be false otherwise)
   bool requires_grad_;
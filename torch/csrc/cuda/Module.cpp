@@ -6,6 +6,7 @@
 #include <TH/TH.h>
 #include <ATen/ATen.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAGraph.h>
 #include <ATen/CUDAGeneratorImpl.h>
 #include <c10/cuda/CUDAFunctions.h>
 #include <c10/cuda/CUDACachingAllocator.h>
@@ -368,12 +369,22 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
     segmentDict["allocated_size"] = segmentInfo.allocated_size;
     segmentDict["active_size"] = segmentInfo.active_size;
     segmentDict["segment_type"] = (segmentInfo.is_large ? "large" : "small");
+    segmentDict["pool"] = segmentInfo.pool;
 
     py::list blocks;
     for (const auto& blockInfo : segmentInfo.blocks) {
       py::dict blockDict;
       blockDict["size"] = blockInfo.size;
       blockDict["state"] = (blockInfo.allocated ? "active_allocated" : (blockInfo.active ? "active_pending_free" : "inactive"));
+      if (blockInfo.history) {
+        const auto& history = *blockInfo.history;
+        py::dict historyDict;
+        historyDict["context"] = history.context ? *history.context : std::string();
+        historyDict["real_size"] = history.real_size;
+        historyDict["stream"] = history.stream;
+        historyDict["time_us"] = history.time_us;
+        blockDict["history"] = historyDict;
+      }
       blocks.append(blockDict);
     }
     segmentDict["blocks"] = blocks;
@@ -396,6 +407,134 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
 // Cuda module initialization
 ////////////////////////////////////////////////////////////////////////////////
 
+static void bindCudaMemoryPools(PyObject* module) {
+  auto m = py::handle(module).cast<py::module>();
+  m.def("_cuda_createMemoryPool", [](int device, const std::string& name, size_t limit) {
+    c10::cuda::CUDACachingAllocator::createMemoryPool(device, name, limit);
+  });
+  m.def("_cuda_memoryPoolReserved", [](int device, const std::string& name) {
+    return c10::cuda::CUDACachingAllocator::getMemoryPoolReservedBytes(device, name);
+  });
+  m.def("_cuda_getMemoryPool", []() {
+    return c10::cuda::CUDACachingAllocator::getCurrentMemoryPool();
+  });
+  m.def("_cuda_setMemoryPool", [](const std::string& name) {
+    c10::cuda::CUDACachingAllocator::setCurrentMemoryPool(name);
+  });
+}
+
+PyObject * THCPModule_recordMemoryHistory(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject* enabled_o = nullptr;
+  PyObject* max_entries_o = nullptr;
+  if (!PyArg_ParseTuple(args, "OO", &enabled_o, &max_entries_o) ||
+      !PyBool_Check(enabled_o) || !THPUtils_checkLong(max_entries_o)) {
+    THPUtils_invalidArguments(
+        args,
+        nullptr,
+        "_record_memory_history",
+        1,
+        "(bool enabled, int max_entries);");
+    return nullptr;
+  }
+  c10::cuda::CUDACachingAllocator::recordHistory(
+      enabled_o == Py_True, THPUtils_unpackLong(max_entries_o));
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject * THCPModule_memoryHistory(PyObject *_unused, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "invalid argument to memory_history");
+  const int device = (int) THPUtils_unpackLong(arg);
+
+  using c10::cuda::CUDACachingAllocator::TraceEntry;
+  const auto actionName = [](TraceEntry::Action action) {
+    switch (action) {
+      case TraceEntry::ALLOC:
+        return "alloc";
+      case TraceEntry::FREE:
+        return "free";
+      case TraceEntry::SEGMENT_ALLOC:
+        return "segment_alloc";
+      case TraceEntry::SEGMENT_FREE:
+        return "segment_free";
+    }
+    return "unknown";
+  };
+
+  py::list result;
+  for (const auto& entry : c10::cuda::CUDACachingAllocator::getHistory(device)) {
+    py::dict entryDict;
+    entryDict["action"] = actionName(entry.action);
+    entryDict["device"] = entry.device;
+    entryDict["addr"] = entry.addr;
+    entryDict["size"] = entry.size;
+    entryDict["stream"] = entry.stream;
+    entryDict["time_us"] = entry.time_us;
+    entryDict["context"] = entry.context ? *entry.context : std::string();
+    result.append(entryDict);
+  }
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+static void bindCudaHostAllocator(PyObject* module) {
+  auto m = py::handle(module).cast<py::module>();
+  m.def("_cuda_hostMemoryStats", []() {
+    const auto statToDict = [](const c10::cuda::CUDACachingAllocator::Stat& stat) {
+      py::dict dict;
+      dict["current"] = stat.current;
+      dict["peak"] = stat.peak;
+      dict["allocated"] = stat.allocated;
+      dict["freed"] = stat.freed;
+      return dict;
+    };
+    const THCCachingHostAllocatorStats stats = THCCachingHostAllocator_getStats();
+    py::dict result;
+    result["num_evictions"] = stats.num_evictions;
+    result["allocation"] = statToDict(stats.allocation);
+    result["segment"] = statToDict(stats.segment);
+    result["allocated_bytes"] = statToDict(stats.allocated_bytes);
+    result["reserved_bytes"] = statToDict(stats.reserved_bytes);
+    return result;
+  });
+  m.def("_cuda_resetAccumulatedHostMemoryStats", []() {
+    THCCachingHostAllocator_resetAccumulatedStats();
+  });
+  m.def("_cuda_resetPeakHostMemoryStats", []() {
+    THCCachingHostAllocator_resetPeakStats();
+  });
+  m.def("_cuda_setHostCacheLimit", [](size_t bytes) {
+    THCCachingHostAllocator_setCacheLimit(bytes);
+  });
+  m.def("_cuda_reserveHostMemory", [](size_t size, size_t count) {
+    pybind11::gil_scoped_release no_gil;
+    THCudaCheck(THCCachingHostAllocator_reserve(size, count));
+  });
+  m.def("_cuda_emptyHostCache", []() {
+    pybind11::gil_scoped_release no_gil;
+    THCCachingHostAllocator_emptyCache();
+  });
+}
+
+static void bindCudaGraphs(PyObject* module) {
+  auto m = py::handle(module).cast<py::module>();
+  // Capture and replay wait on the device, so they release the GIL.
+  py::class_<at::cuda::CUDAGraph>(m, "_CUDAGraph")
+    .def(py::init<>())
+    .def("capture_begin", &at::cuda::CUDAGraph::capture_begin,
+         py::call_guard<py::gil_scoped_release>())
+    .def("capture_end", &at::cuda::CUDAGraph::capture_end,
+         py::call_guard<py::gil_scoped_release>())
+    .def("replay", &at::cuda::CUDAGraph::replay,
+         py::call_guard<py::gil_scoped_release>())
+    .def("reset", &at::cuda::CUDAGraph::reset,
+         py::call_guard<py::gil_scoped_release>());
+}
+
 static void bindCudaDeviceProperties(PyObject* module) {
   // Add class and method to torch.cuda
   auto m = py::handle(module).cast<py::module>();
@@ -505,6 +644,8 @@ static struct PyMethodDef _THCPModule_methods[] = {
   {"_cuda_resetAccumulatedMemoryStats", (PyCFunction) THCPModule_resetAccumulatedMemoryStats, METH_O, nullptr},
   {"_cuda_resetPeakMemoryStats", (PyCFunction) THCPModule_resetPeakMemoryStats, METH_O,  nullptr},
   {"_cuda_memorySnapshot", (PyCFunction) THCPModule_memorySnapshot, METH_NOARGS, nullptr},
+  {"_cuda_recordMemoryHistory", (PyCFunction) THCPModule_recordMemoryHistory, METH_VARARGS, nullptr},
+  {"_cuda_memoryHistory", (PyCFunction) THCPModule_memoryHistory, METH_O, nullptr},
   {"_cuda_cudaHostAllocator", (PyCFunction)THCPModule_cudaHostAllocator, METH_NOARGS, nullptr},
   {"_cuda_cudaCachingAllocator_raw_alloc", (PyCFunction)THCPModule_cudaCachingAllocator_raw_alloc, METH_VARARGS, nullptr},
   {"_cuda_cudaCachingAllocator_raw_delete", (PyCFunction)THCPModule_cudaCachingAllocator_raw_delete, METH_O, nullptr},
@@ -551,6 +692,9 @@ void initModule(PyObject *module) {
 #if defined(USE_CUDNN) || defined(__HIP_PLATFORM_HCC__)
   shared::initCudnnBindings(module);
 #endif
+  bindCudaMemoryPools(module);
+  bindCudaHostAllocator(module);
+  bindCudaGraphs(module);
 }
 
 }}
@@ -12,6 +12,7 @@ using version_tuple = std::tuple<size_t, size_t, size_t>;
 
 #ifdef USE_CUDNN
 #include <cudnn.h>
+#include <ATen/native/cudnn/ConvAlgorithmCache.h>
 
 namespace {
 
@@ -87,6 +88,10 @@ void initCudnnBindings(PyObject* module) {
   cudnn.def("getRuntimeVersion", getRuntimeVersion);
   cudnn.def("getCompileVersion", getCompileVersion);
   cudnn.def("getVersionInt", getVersionInt);
+#ifdef USE_CUDNN
+  cudnn.def("_save_convolution_algorithms", &at::native::save_cudnn_convolution_algorithms);
+  cudnn.def("_load_convolution_algorithms", &at::native::load_cudnn_convolution_algorithms);
+#endif
 }
 
 } // namespace shared
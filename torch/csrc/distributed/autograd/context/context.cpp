@@ -71,12 +71,18 @@ void DistAutogradContext::accumulateGrad(
   TORCH_INTERNAL_ASSERT(grad.defined());
   TORCH_INTERNAL_ASSERT(variable.requires_grad());
 
-  std::lock_guard<std::mutex> guard(lock_);
-  auto it = accumulatedGrads_.find(variable);
+  const auto stripe =
+      std::hash<c10::TensorImpl*>()(variable.unsafeGetTensorImpl()) %
+      kNumGradLockStripes;
+  std::lock_guard<std::mutex> stripeGuard(gradLockStripes_[stripe]);
   at::Tensor old_grad;
-  if (it != accumulatedGrads_.end()) {
-    // Accumulate multiple grads on the same variable.
-    old_grad = it->value();
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    auto it = accumulatedGrads_.find(variable);
+    if (it != accumulatedGrads_.end()) {
+      // Accumulate multiple grads on the same variable.
+      old_grad = it->value();
+    }
   }
 
   // No higher order gradients supported in distributed autograd.
@@ -96,6 +102,7 @@ void DistAutogradContext::accumulateGrad(
       // refcount bump for the new_grad.
       num_expected_refs + 1,
       [this, &variable](at::Tensor&& grad_update) {
+        std::lock_guard<std::mutex> guard(lock_);
         accumulatedGrads_.insert(variable, std::move(grad_update));
       });
 }
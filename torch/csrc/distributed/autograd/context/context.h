@@ -5,6 +5,7 @@
 #include <torch/csrc/distributed/autograd/functions/recvrpc_backward.h>
 #include <torch/csrc/distributed/autograd/functions/sendrpc_backward.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
+#include <array>
 #include <cstdint>
 
 namespace torch {
@@ -74,7 +75,7 @@ class TORCH_API DistAutogradContext {
   friend class DistAccumulateGradCaptureHook;
 
   // Record that we would like to accumulate the provided gradient on the given
-  // variable.
+  // variable. Gradients of different variables are accumulated concurrently.
   void accumulateGrad(
       const torch::autograd::Variable& variable,
       const torch::Tensor& grad,
@@ -127,6 +128,13 @@ class TORCH_API DistAutogradContext {
 
   // Lock to protect concurrent modification of the context.
   mutable std::mutex lock_;
+
+  // Serialize the accumulation of the gradients of a variable, which can be
+  // expensive, e.g. when it runs hooks, without blocking the accumulation of
+  // other variables. The stripe of a variable is picked by its TensorImpl,
+  // and lock_ is only held to look up and insert into accumulatedGrads_.
+  static constexpr size_t kNumGradLockStripes = 16;
+  std::array<std::mutex, kNumGradLockStripes> gradLockStripes_;
 };
 
 using ContextPtr = std::shared_ptr<DistAutogradContext>;
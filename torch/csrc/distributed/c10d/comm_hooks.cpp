@@ -0,0 +1,213 @@
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include <ATen/CPUGeneratorImpl.h>
+
+namespace c10d {
+namespace {
+
+// The work of a hook: waits for the collectives it started, then runs
+// `finish` to compute the result, e.g. to decompress it. Collectives started
+// by `finish` are issued in the order the Reducer waits for buckets, which is
+// the same on every process.
+class HookWork : public ProcessGroup::Work {
+ public:
+  HookWork(
+      std::vector<std::shared_ptr<ProcessGroup::Work>> works,
+      std::function<std::vector<at::Tensor>()> finish)
+      : works_(std::move(works)), finish_(std::move(finish)) {}
+
+  bool wait() override {
+    {
+      std::lock_guard<std::mutex> lock(wait_mutex_);
+      if (!isCompleted()) {
+        try {
+          for (auto& work : works_) {
+            work->wait();
+          }
+          result_ = finish_();
+          finish();
+        } catch (...) {
+          finish(std::current_exception());
+        }
+      }
+    }
+    return ProcessGroup::Work::wait();
+  }
+
+  std::vector<at::Tensor> result() const override {
+    return result_;
+  }
+
+ private:
+  std::vector<std::shared_ptr<ProcessGroup::Work>> works_;
+  std::function<std::vector<at::Tensor>()> finish_;
+  std::vector<at::Tensor> result_;
+  std::mutex wait_mutex_;
+};
+
+// Orthonormalizes the columns of `matrix` in place with Gram-Schmidt.
+void orthogonalize(at::Tensor& matrix) {
+  constexpr double kEpsilon = 1e-8;
+  const auto num_cols = matrix.size(1);
+  for (int64_t i = 0; i < num_cols; i++) {
+    auto col = matrix.narrow(1, i, 1);
+    col.div_(col.norm().clamp_min(kEpsilon));
+    if (i + 1 < num_cols) {
+      auto rest = matrix.narrow(1, i + 1, num_cols - i - 1);
+      rest.sub_(col * (col * rest).sum(0, /*keepdim=*/true));
+    }
+  }
+}
+
+} // namespace
+
+FP16CompressHook::FP16CompressHook(std::shared_ptr<ProcessGroup> process_group)
+    : process_group_(std::move(process_group)) {}
+
+std::shared_ptr<ProcessGroup::Work> FP16CompressHook::runHook(
+    size_t /* unused */,
+    std::vector<at::Tensor>& tensors) {
+  std::vector<at::Tensor> compressed;
+  compressed.reserve(tensors.size());
+  for (const auto& tensor : tensors) {
+    compressed.push_back(tensor.to(at::kHalf));
+  }
+  auto work = process_group_->allreduce(compressed);
+  return std::make_shared<HookWork>(
+      std::vector<std::shared_ptr<ProcessGroup::Work>>{std::move(work)},
+      [tensors, compressed]() {
+        std::vector<at::Tensor> result;
+        result.reserve(tensors.size());
+        for (size_t i = 0; i < tensors.size(); i++) {
+          result.push_back(tensors[i].copy_(compressed[i]));
+        }
+        return result;
+      });
+}
+
+PowerSGDHook::PowerSGDHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    int64_t matrix_approximation_rank,
+    uint64_t seed)
+    : process_group_(std::move(process_group)),
+      matrix_approximation_rank_(matrix_approximation_rank),
+      seed_(seed) {
+  TORCH_CHECK(
+      matrix_approximation_rank_ > 0,
+      "PowerSGD matrix approximation rank must be positive, got ",
+      matrix_approximation_rank_);
+}
+
+std::shared_ptr<ProcessGroup::Work> PowerSGDHook::runHook(
+    size_t bucket_index,
+    std::vector<at::Tensor>& tensors) {
+  TORCH_CHECK(
+      tensors.size() == 1,
+      "PowerSGDHook supports a single model replica per process");
+  auto tensor = tensors.front();
+  const auto numel = tensor.numel();
+  const auto cols = static_cast<int64_t>(std::ceil(std::sqrt(numel)));
+  const auto rows = (numel + cols - 1) / cols;
+  const auto rank = std::min({matrix_approximation_rank_, rows, cols});
+
+  // The state is reset if the buckets were rebuilt with different sizes.
+  auto& state = states_[bucket_index];
+  if (!state.q.defined() || state.error.numel() != rows * cols ||
+      state.q.size(1) != rank) {
+    // Q must start out the same on every process, because P is the sum of the
+    // M Q of all processes.
+    auto generator = at::detail::createCPUGenerator(seed_ + bucket_index);
+    state.q = at::randn(
+                  {cols, rank},
+                  generator,
+                  tensor.options().device(at::kCPU))
+                  .to(tensor.device());
+    state.error = at::zeros({rows * cols}, tensor.options());
+  }
+
+  // M is the error buffer, which becomes the error again once P Q^T is known.
+  state.error.narrow(0, 0, numel).add_(tensor);
+  auto matrix = state.error.view({rows, cols});
+  std::vector<at::Tensor> p = {at::mm(matrix, state.q)};
+  auto work = process_group_->allreduce(p);
+  return std::make_shared<HookWork>(
+      std::vector<std::shared_ptr<ProcessGroup::Work>>{std::move(work)},
+      [this, bucket_index, tensor, matrix, p, numel]() mutable {
+        auto& state = states_[bucket_index];
+        orthogonalize(p.front());
+        std::vector<at::Tensor> q = {at::mm(matrix.t(), p.front())};
+        process_group_->allreduce(q)->wait();
+        state.q = q.front();
+
+        // P Q^T approximates the sum of the M of all processes, so each
+        // process keeps its share of what the approximation missed.
+        auto approximation = at::mm(p.front(), state.q.t()).view(-1);
+        state.error.sub_(approximation.div(process_group_->getSize()));
+        state.error.narrow(0, numel, state.error.numel() - numel).zero_();
+        tensor.copy_(approximation.narrow(0, 0, numel));
+        return std::vector<at::Tensor>{tensor};
+      });
+}
+
+TopKSparsifyHook::TopKSparsifyHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    double ratio)
+    : process_group_(std::move(process_group)), ratio_(ratio) {
+  TORCH_CHECK(
+      ratio_ > 0 && ratio_ <= 1,
+      "Top-k sparsification ratio must be in (0, 1], got ",
+      ratio_);
+}
+
+std::shared_ptr<ProcessGroup::Work> TopKSparsifyHook::runHook(
+    size_t bucket_index,
+    std::vector<at::Tensor>& tensors) {
+  TORCH_CHECK(
+      tensors.size() == 1,
+      "TopKSparsifyHook supports a single model replica per process");
+  auto tensor = tensors.front();
+  const auto numel = tensor.numel();
+  const auto k = std::max<int64_t>(
+      1, std::min<int64_t>(numel, static_cast<int64_t>(ratio_ * numel)));
+
+  auto& error = errors_[bucket_index];
+  if (!error.defined() || error.sizes() != tensor.sizes()) {
+    error = at::zeros_like(tensor);
+  }
+  error.add_(tensor);
+  auto indices = std::get<1>(
+      error.abs().topk(k, /*dim=*/0, /*largest=*/true, /*sorted=*/false));
+  auto values = error.index_select(0, indices);
+  // Whatever isn't sent now is sent in a later iteration.
+  error.index_fill_(0, indices, 0);
+
+  const auto world_size = process_group_->getSize();
+  std::vector<std::vector<at::Tensor>> gathered_values(1);
+  std::vector<std::vector<at::Tensor>> gathered_indices(1);
+  for (int i = 0; i < world_size; i++) {
+    gathered_values.front().push_back(at::empty_like(values));
+    gathered_indices.front().push_back(at::empty_like(indices));
+  }
+  std::vector<at::Tensor> values_input = {values};
+  std::vector<at::Tensor> indices_input = {indices};
+  auto values_work = process_group_->allgather(gathered_values, values_input);
+  auto indices_work =
+      process_group_->allgather(gathered_indices, indices_input);
+  return std::make_shared<HookWork>(
+      std::vector<std::shared_ptr<ProcessGroup::Work>>{std::move(values_work),
+                                                       std::move(indices_work)},
+      [tensor, gathered_values, gathered_indices]() mutable {
+        tensor.zero_();
+        for (size_t i = 0; i < gathered_values.front().size(); i++) {
+          tensor.index_add_(
+              0, gathered_indices.front()[i], gathered_values.front()[i]);
+        }
+        return std::vector<at::Tensor>{tensor};
+      });
+}
+
+} // namespace c10d
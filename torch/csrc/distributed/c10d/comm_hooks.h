@@ -0,0 +1,95 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <c10d/ProcessGroup.hpp>
+
+namespace c10d {
+
+// A communication hook replaces the allreduce that the Reducer runs on the
+// flattened contents of every dense bucket, e.g. to compress the gradients
+// before they are sent.
+class CommHook {
+ public:
+  virtual ~CommHook() = default;
+
+  // Starts the reduction of `tensors`, the contents of bucket `bucket_index`
+  // (one tensor per model replica, already divided by the world size), and
+  // returns its work handle. Once the work is waited on, its result() must
+  // hold the reduced contents, one tensor per replica with the sizes and
+  // dtype of `tensors`. The hook may modify `tensors` in place.
+  virtual std::shared_ptr<ProcessGroup::Work> runHook(
+      size_t bucket_index,
+      std::vector<at::Tensor>& tensors) = 0;
+};
+
+// Allreduces the bucket contents as FP16, halving the bytes sent.
+class FP16CompressHook : public CommHook {
+ public:
+  explicit FP16CompressHook(std::shared_ptr<ProcessGroup> process_group);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(
+      size_t bucket_index,
+      std::vector<at::Tensor>& tensors) override;
+
+ private:
+  std::shared_ptr<ProcessGroup> process_group_;
+};
+
+// PowerSGD low-rank compression (Vogels et al., 2019). The contents of every
+// bucket, plus the error left from the previous iteration, are viewed as an
+// n x m matrix M and approximated by P Q^T, with P and Q of rank
+// `matrix_approximation_rank`, computed with one step of power iteration
+// warm-started from the previous Q. Only P and Q are allreduced, which sends
+// rank * (n + m) values instead of n * m.
+//
+// Requires a single model replica per process.
+class PowerSGDHook : public CommHook {
+ public:
+  PowerSGDHook(
+      std::shared_ptr<ProcessGroup> process_group,
+      int64_t matrix_approximation_rank,
+      uint64_t seed = 0);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(
+      size_t bucket_index,
+      std::vector<at::Tensor>& tensors) override;
+
+ private:
+  struct BucketState {
+    // The right factor of the last approximation, m x rank.
+    at::Tensor q;
+    // The contents that weren't sent yet, padded to n * m.
+    at::Tensor error;
+  };
+
+  std::shared_ptr<ProcessGroup> process_group_;
+  const int64_t matrix_approximation_rank_;
+  const uint64_t seed_;
+  std::unordered_map<size_t, BucketState> states_;
+};
+
+// Top-k sparsification with error feedback. Only the `ratio` fraction of the
+// values of every bucket with the largest magnitudes, with their indices, is
+// allgathered; the values that weren't sent are added to the bucket in the
+// next iteration.
+//
+// Requires a single model replica per process.
+class TopKSparsifyHook : public CommHook {
+ public:
+  TopKSparsifyHook(std::shared_ptr<ProcessGroup> process_group, double ratio);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(
+      size_t bucket_index,
+      std::vector<at::Tensor>& tensors) override;
+
+ private:
+  std::shared_ptr<ProcessGroup> process_group_;
+  const double ratio_;
+  std::unordered_map<size_t, at::Tensor> errors_;
+};
+
+} // namespace c10d
@@ -17,12 +17,14 @@
 #endif
 
 #include <c10d/PrefixStore.hpp>
+#include <c10d/ProcessGroupHierarchical.hpp>
 #include <c10d/ProcessGroupRoundRobin.hpp>
 #include <c10d/TCPStore.hpp>
 #include <pybind11/chrono.h>
 
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/distributed/c10d/comm.h>
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
 #include <torch/csrc/distributed/c10d/reducer.h>
 #include <torch/csrc/utils/object_ptr.h>
 #include <torch/csrc/utils/pybind.h>
@@ -115,17 +117,49 @@ PyObject* c10d_init(PyObject* _unused) {
 
   auto module = py::handle(c10d_module).cast<py::module>();
 
+  auto commHook = shared_ptr_class_<::c10d::CommHook>(module, "CommHook", R"(
+A communication hook that the :class:`Reducer` runs on every dense bucket
+instead of an allreduce of its contents.)");
+
+  shared_ptr_class_<::c10d::FP16CompressHook>(
+      module, "FP16CompressHook", commHook, R"(
+Allreduces the gradients as FP16, halving the bytes sent.)")
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>>(),
+          py::arg("process_group"));
+
+  shared_ptr_class_<::c10d::PowerSGDHook>(module, "PowerSGDHook", commHook, R"(
+Allreduces a rank ``matrix_approximation_rank`` approximation of every bucket,
+viewed as a matrix, computed with PowerSGD, and keeps the approximation error
+to add to the bucket in the next iteration.)")
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>, int64_t, uint64_t>(),
+          py::arg("process_group"),
+          py::arg("matrix_approximation_rank") = 1,
+          py::arg("seed") = 0);
+
+  shared_ptr_class_<::c10d::TopKSparsifyHook>(
+      module, "TopKSparsifyHook", commHook, R"(
+Allgathers the ``ratio`` fraction of the gradients with the largest magnitudes,
+and keeps the others to add to the bucket in the next iteration.)")
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>, double>(),
+          py::arg("process_group"),
+          py::arg("ratio") = 0.01);
+
   shared_ptr_class_<::c10d::Reducer>(module, "Reducer")
       .def(
           py::init<
               std::vector<std::vector<torch::autograd::Variable>>,
               std::vector<std::vector<size_t>>,
               std::shared_ptr<::c10d::ProcessGroup>,
-              std::vector<std::vector<bool>>>(),
+              std::vector<std::vector<bool>>,
+              std::vector<size_t>>(),
           py::arg("replicas"),
           py::arg("bucket_indices"),
           py::arg("process_group"),
-          py::arg("expect_sparse_gradients") = std::vector<std::vector<bool>>())
+          py::arg("expect_sparse_gradients") = std::vector<std::vector<bool>>(),
+          py::arg("bucket_size_limits") = std::vector<size_t>())
       .def(
           "initialize_buckets",
           &::c10d::Reducer::initialize_buckets,
@@ -133,13 +167,24 @@ PyObject* c10d_init(PyObject* _unused) {
       .def(
           "prepare_for_backward",
           &::c10d::Reducer::prepare_for_backward,
+          py::arg("outputs"),
+          py::arg("graph_key") = -1,
           py::call_guard<py::gil_scoped_release>())
       .def(
           "prepare_for_backward",
           [](::c10d::Reducer& reducer, const torch::autograd::Variable& output)
               -> void { reducer.prepare_for_backward({output}); },
           py::call_guard<py::gil_scoped_release>())
-      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats);
+      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats)
+      .def(
+          "_rebuild_buckets",
+          &::c10d::Reducer::rebuild_buckets,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "register_comm_hook",
+          &::c10d::Reducer::register_comm_hook,
+          py::arg("hook"),
+          py::call_guard<py::gil_scoped_release>());
 
   py::enum_<::c10d::ReduceOp>(module, "ReduceOp", R"(
 An enum-like class for available reduction operations: ``SUM``, ``PRODUCT``,
@@ -253,7 +298,54 @@ They are used in specifying strategies for reduction collectives, e.g.,
                  const std::chrono::milliseconds& timeout) {
                 store.wait(keys, timeout);
               },
-              py::call_guard<py::gil_scoped_release>());
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_set",
+              [](::c10d::Store& store,
+                 const std::vector<std::string>& keys,
+                 const std::vector<std::string>& values) {
+                std::vector<std::vector<uint8_t>> values_;
+                values_.reserve(values.size());
+                for (const auto& value : values) {
+                  values_.emplace_back(value.begin(), value.end());
+                }
+                store.multiSet(keys, values_);
+              },
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_get",
+              [](::c10d::Store& store, const std::vector<std::string>& keys) {
+                auto values = [&]() {
+                  py::gil_scoped_release guard;
+                  return store.multiGet(keys);
+                }();
+                std::vector<py::bytes> result;
+                result.reserve(values.size());
+                for (const auto& value : values) {
+                  result.emplace_back(
+                      reinterpret_cast<const char*>(value.data()),
+                      value.size());
+                }
+                return result;
+              })
+          .def(
+              "compare_set",
+              [](::c10d::Store& store,
+                 const std::string& key,
+                 const std::string& expected_value,
+                 const std::string& desired_value) -> py::bytes {
+                std::vector<uint8_t> expected_value_(
+                    expected_value.begin(), expected_value.end());
+                std::vector<uint8_t> desired_value_(
+                    desired_value.begin(), desired_value.end());
+                auto value = [&]() {
+                  py::gil_scoped_release guard;
+                  return store.compareSet(
+                      key, expected_value_, desired_value_);
+                }();
+                return py::bytes(
+                    reinterpret_cast<const char*>(value.data()), value.size());
+              });
 
   shared_ptr_class_<::c10d::FileStore>(module, "FileStore", store)
       .def(py::init<const std::string&, int>());
@@ -556,6 +648,22 @@ They are used in specifying strategies for reduction collectives, e.g.,
       py::arg("process_groups"),
       py::call_guard<py::gil_scoped_release>());
 
+  module.def(
+      "_hierarchical_process_groups",
+      [](std::shared_ptr<::c10d::ProcessGroup> intraNodeGroup,
+         std::shared_ptr<::c10d::ProcessGroup> interNodeGroup)
+          -> std::shared_ptr<::c10d::ProcessGroup> {
+        const auto localSize = intraNodeGroup->getSize();
+        const auto rank =
+            interNodeGroup->getRank() * localSize + intraNodeGroup->getRank();
+        const auto size = interNodeGroup->getSize() * localSize;
+        return std::make_shared<::c10d::ProcessGroupHierarchical>(
+            rank, size, std::move(intraNodeGroup), std::move(interNodeGroup));
+      },
+      py::arg("intra_node_group"),
+      py::arg("inter_node_group"),
+      py::call_guard<py::gil_scoped_release>());
+
 #ifdef USE_C10D_GLOO
   auto processGroupGloo = shared_ptr_class_<::c10d::ProcessGroupGloo>(
       module, "ProcessGroupGloo", processGroup);
@@ -637,7 +745,32 @@ They are used in specifying strategies for reduction collectives, e.g.,
           py::arg("rank"),
           py::arg("size"),
           py::arg("timeout") = std::chrono::milliseconds(
-              ::c10d::ProcessGroupNCCL::kProcessGroupNCCLOpTimeoutMillis));
+              ::c10d::ProcessGroupNCCL::kProcessGroupNCCLOpTimeoutMillis))
+      .def(
+          "batch_isend_irecv",
+          [](::c10d::ProcessGroupNCCL& pg,
+             const std::vector<std::tuple<std::string, at::Tensor, int>>&
+                 ops) {
+            std::vector<::c10d::ProcessGroupNCCL::P2POp> p2pOps;
+            p2pOps.reserve(ops.size());
+            for (const auto& op : ops) {
+              const auto& type = std::get<0>(op);
+              if (type != "send" && type != "recv") {
+                throw std::invalid_argument(
+                    "batch_isend_irecv: expected \"send\" or \"recv\", got " +
+                    type);
+              }
+              p2pOps.push_back(
+                  {type == "send"
+                       ? ::c10d::ProcessGroupNCCL::P2POp::Type::SEND
+                       : ::c10d::ProcessGroupNCCL::P2POp::Type::RECV,
+                   std::get<1>(op),
+                   std::get<2>(op)});
+            }
+            return pg.batchIsendIrecv(p2pOps);
+          },
+          py::arg("ops"),
+          py::call_guard<py::gil_scoped_release>());
 #endif
 
 #ifdef USE_C10D_MPI
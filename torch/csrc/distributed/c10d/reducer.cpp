@@ -25,7 +25,8 @@ Reducer::Reducer(
     std::vector<std::vector<torch::autograd::Variable>> replicas,
     std::vector<std::vector<size_t>> bucket_indices,
     std::shared_ptr<c10d::ProcessGroup> process_group,
-    std::vector<std::vector<bool>> expect_sparse_gradients)
+    std::vector<std::vector<bool>> expect_sparse_gradients,
+    std::vector<size_t> bucket_size_limits)
     : replicas_(std::move(replicas)),
       process_group_(std::move(process_group)),
       expect_sparse_gradients_(std::move(expect_sparse_gradients)),
@@ -34,6 +35,8 @@ Reducer::Reducer(
       next_bucket_(0),
       has_marked_unused_parameters_(false),
       local_used_maps_reduced_(false),
+      bucket_size_limits_(std::move(bucket_size_limits)),
+      has_rebuilt_bucket_(bucket_size_limits_.empty()),
       backward_stats_base_(0) {
   C10_LOG_API_USAGE_ONCE("torch.distributed.ddp.reducer");
 
@@ -296,6 +299,11 @@ void Reducer::mark_variable_ready(VariableIndex index) {
   backward_stats_[replica_index][variable_index] =
       current_time_in_nanos() - backward_stats_base_;
 
+  // Record the order in which gradients become ready to rebuild the buckets.
+  if (!has_rebuilt_bucket_ && replica_index == 0) {
+    rebuilt_param_indices_.push_back(variable_index);
+  }
+
   // Any time we mark a variable ready (be it in line due to unused parameters,
   // or via an autograd hook), we require a call to the finalize function. If
   // this doesn't happen before the next iteration (or call to
@@ -335,7 +343,10 @@ void Reducer::mark_variable_ready(VariableIndex index) {
         "parameters in the model participate in the backward pass, you can ",
         "disable unused parameter detection by passing the keyword argument ",
         "`find_unused_parameters=False` to ",
-        "`torch.nn.parallel.DistributedDataParallel`.");
+        "`torch.nn.parallel.DistributedDataParallel`. If you passed ",
+        "`cache_unused_parameters=True`, the parameters used also depend on ",
+        "something else than the set of submodules called by `forward`, and ",
+        "the option must be disabled.");
     TORCH_CHECK(!has_marked_unused_parameters_, common_error);
   }
 
@@ -409,10 +420,94 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
       //
       tensors.push_back(replica.contents);
     }
-    bucket.work = process_group_->allreduce(tensors);
+    if (comm_hook_ && !bucket.expect_sparse_gradient) {
+      bucket.work = comm_hook_->runHook(next_bucket_, tensors);
+    } else {
+      bucket.work = process_group_->allreduce(tensors);
+    }
   }
 }
 
+bool Reducer::rebuild_buckets() {
+  std::vector<size_t> order;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (has_rebuilt_bucket_ || rebuilt_param_indices_.empty()) {
+      return false;
+    }
+    TORCH_CHECK(
+        !expect_autograd_hooks_,
+        "`rebuild_buckets` must NOT be called during autograd execution.");
+    order = std::move(rebuilt_param_indices_);
+    rebuilt_param_indices_.clear();
+    has_rebuilt_bucket_ = true;
+  }
+
+  // The order is only usable if every rank saw every variable become ready,
+  // once. Otherwise, e.g. if the backward pass didn't finish, keep the
+  // buckets as they are.
+  const auto variable_count = replicas_[0].size();
+  bool complete = order.size() == variable_count;
+  if (complete) {
+    std::vector<bool> seen(variable_count, false);
+    for (const auto variable_index : order) {
+      complete = complete && !seen[variable_index];
+      seen[variable_index] = true;
+    }
+  }
+  const auto options =
+      at::TensorOptions().dtype(at::kLong).device(replicas_[0][0].device());
+  std::vector<at::Tensor> all_complete = {
+      at::full({1}, complete ? 1 : 0, options)};
+  AllreduceOptions allreduce_options;
+  allreduce_options.reduceOp = ReduceOp::MIN;
+  process_group_->allreduce(all_complete, allreduce_options)->wait();
+  if (all_complete.front().item<int64_t>() == 0) {
+    return false;
+  }
+
+  // Use the order of rank 0, so that all ranks agree on the buckets.
+  std::vector<at::Tensor> synced_order = {
+      at::tensor(std::vector<int64_t>(order.begin(), order.end()), options)};
+  process_group_->broadcast(synced_order)->wait();
+  const auto synced_order_cpu = synced_order.front().cpu();
+  const auto synced_order_data = synced_order_cpu.data_ptr<int64_t>();
+
+  std::vector<at::Tensor> tensors;
+  std::vector<bool> expect_sparse_gradient;
+  tensors.reserve(variable_count);
+  expect_sparse_gradient.reserve(variable_count);
+  for (size_t i = 0; i < variable_count; i++) {
+    const auto variable_index = synced_order_data[i];
+    tensors.push_back(replicas_[0][variable_index]);
+    expect_sparse_gradient.push_back(
+        expect_sparse_gradients_[0][variable_index]);
+  }
+
+  // The assignment is computed on the variables in ready order, which makes
+  // its buckets be in ready order too; map its indices back to variables.
+  auto bucket_indices = compute_bucket_assignment_by_size(
+      tensors, bucket_size_limits_, expect_sparse_gradient);
+  for (auto& bucket : bucket_indices) {
+    for (auto& index : bucket) {
+      index = synced_order_data[index];
+    }
+  }
+  initialize_buckets(std::move(bucket_indices));
+  return true;
+}
+
+void Reducer::register_comm_hook(std::shared_ptr<CommHook> hook) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TORCH_CHECK(hook, "Expected a communication hook");
+  TORCH_CHECK(
+      !comm_hook_, "register_comm_hook can only be called once per Reducer");
+  TORCH_CHECK(
+      !expect_autograd_hooks_,
+      "register_comm_hook can't be called during a backward pass");
+  comm_hook_ = std::move(hook);
+}
+
 void Reducer::initialize_buckets(
     std::vector<std::vector<size_t>> bucket_indices) {
   std::lock_guard<std::mutex> lock(mutex_);
@@ -530,7 +625,8 @@ void Reducer::initialize_buckets(
 // done immediately because the model output may be ignored, and we only
 // want to start performing reductions on `torch.autograd.backward()`.
 void Reducer::prepare_for_backward(
-    const std::vector<torch::autograd::Variable>& outputs) {
+    const std::vector<torch::autograd::Variable>& outputs,
+    int64_t graph_key) {
   std::lock_guard<std::mutex> lock(mutex_);
   std::unordered_set<torch::autograd::Node*> seen;
   std::vector<torch::autograd::Node*> queue;
@@ -582,6 +678,14 @@ void Reducer::prepare_for_backward(
     return;
   }
 
+  if (graph_key != -1) {
+    auto it = unused_parameters_cache_.find(graph_key);
+    if (it != unused_parameters_cache_.end()) {
+      unused_parameters_ = it->second;
+      return;
+    }
+  }
+
   // Seed queue with the grad functions of all outputs.
   for (const auto& output : outputs) {
     const auto& grad_fn = output.grad_fn();
@@ -590,14 +694,20 @@ void Reducer::prepare_for_backward(
     }
   }
 
-  // Traverse the autograd graph starting at the specified output.
-  while (!queue.empty()) {
+  // Traverse the autograd graph starting at the specified output. Once all
+  // accumulator functions have been seen, every parameter is known to be used
+  // and the rest of the graph doesn't need to be visited.
+  size_t num_seen_accumulators = 0;
+  while (!queue.empty() && num_seen_accumulators < func_.size()) {
     auto fn = queue.back();
     queue.pop_back();
     for (const auto& edge : fn->next_edges()) {
       if (auto next_ptr = edge.function.get()) {
         const bool was_inserted = seen.insert(next_ptr).second;
         if (was_inserted) {
+          if (func_.count(next_ptr) > 0) {
+            num_seen_accumulators++;
+          }
           queue.push_back(next_ptr);
         }
       }
@@ -614,13 +724,25 @@ void Reducer::prepare_for_backward(
 
     unused_parameters_.push_back(it.second);
   }
+
+  if (graph_key != -1) {
+    unused_parameters_cache_.emplace(graph_key, unused_parameters_);
+  }
 }
 
 // A bucket with one or more dense tensors needs to be unflattened.
 void Reducer::finalize_bucket_dense(Bucket& bucket) {
+  // With a communication hook, the reduced contents are its result.
+  std::vector<at::Tensor> hook_result;
+  if (comm_hook_) {
+    hook_result = bucket.work->result();
+    TORCH_INTERNAL_ASSERT(bucket.replicas.size() == hook_result.size());
+  }
   for (size_t replica_index = 0; replica_index < bucket.replicas.size();
        replica_index++) {
     auto& replica = bucket.replicas[replica_index];
+    const auto& contents =
+        comm_hook_ ? hook_result[replica_index] : replica.contents;
     for (size_t intra_bucket_index = 0;
          intra_bucket_index < replica.variables.size();
          intra_bucket_index++) {
@@ -663,7 +785,7 @@ void Reducer::finalize_bucket_dense(Bucket& bucket) {
       }
 
       auto bucket_view =
-          replica.contents.narrow(0, offset, length).view(variable.sizes());
+          contents.narrow(0, offset, length).view(variable.sizes());
       auto& grad = variable.grad();
 
       // If a parameter is globally unused, we keep its grad untouched.
@@ -10,6 +10,7 @@
 #include <c10d/ProcessGroup.hpp>
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
 
 namespace c10d {
 
@@ -19,11 +20,15 @@ class Reducer {
   // The bucket assignment for this reducer is specified as a list of
   // buckets, each of which is specified as a list of indices into the
   // variables list for **a single replica** (i.e. `variables[0]`).
+  // If `bucket_size_limits` is given, the buckets can be rebuilt with these
+  // limits once the order in which gradients become ready is known, see
+  // rebuild_buckets.
   explicit Reducer(
       std::vector<std::vector<torch::autograd::Variable>> replicas,
       std::vector<std::vector<size_t>> bucket_indices,
       std::shared_ptr<c10d::ProcessGroup> process_group,
-      std::vector<std::vector<bool>> expect_sparse_gradients);
+      std::vector<std::vector<bool>> expect_sparse_gradients,
+      std::vector<size_t> bucket_size_limits = {});
 
   ~Reducer() noexcept(false);
 
@@ -37,8 +42,13 @@ class Reducer {
   // and the user wishes to reduce gradients in the backwards pass.
   // If they don't, and wish to accumulate gradients before reducing them,
   // a call to this function can simply be omitted.
+  // If `graph_key` is not -1, the parameters found unused the first time a
+  // key is passed are assumed to be unused whenever it is passed again, and
+  // the autograd graph is only traversed once per key. The caller must pass
+  // the same key only for graphs that reach the same parameters.
   void prepare_for_backward(
-      const std::vector<torch::autograd::Variable>& outputs);
+      const std::vector<torch::autograd::Variable>& outputs,
+      int64_t graph_key = -1);
 
   // Returns the relative time in nanoseconds when gradients were ready,
   // with respect to the time `prepare_for_backward` was called. The outer
@@ -47,6 +57,17 @@ class Reducer {
     return backward_stats_;
   }
 
+  // Reassigns the variables to buckets in the order in which their gradients
+  // became ready in the first backward pass, so that each bucket is ready as
+  // early as possible, using the order seen by rank 0 on every rank. This is
+  // a collective: every rank must call it at the same point, before a forward
+  // pass. Returns whether the buckets were rebuilt, which happens at most once.
+  bool rebuild_buckets();
+
+  // Makes dense buckets be reduced by `hook` instead of with an allreduce of
+  // their contents. Can only be called once, and not during a backward pass.
+  void register_comm_hook(std::shared_ptr<CommHook> hook);
+
  protected:
   // Forward declaration.
   struct Bucket;
@@ -74,6 +95,9 @@ class Reducer {
 
   bool has_marked_unused_parameters_;
   std::vector<VariableIndex> unused_parameters_;
+  // The unused parameters found for each graph key, see prepare_for_backward.
+  std::unordered_map<int64_t, std::vector<VariableIndex>>
+      unused_parameters_cache_;
   // Locally used parameter maps indicating if parameters are used locally
   // during the current iteration or no_sync session if no_sync is on. One
   // tensor for each model replica and each tensor is one-dim int32 tensor of
@@ -92,6 +116,16 @@ class Reducer {
   // Work handle for allreduce on local_used_maps_
   std::shared_ptr<c10d::ProcessGroup::Work> local_used_work_;
 
+  // Reduces the dense buckets if set, see register_comm_hook.
+  std::shared_ptr<CommHook> comm_hook_;
+
+  // The bucket size limits to rebuild the buckets with, see rebuild_buckets.
+  std::vector<size_t> bucket_size_limits_;
+  bool has_rebuilt_bucket_;
+  // Indices of the variables of replica 0 in the order they were marked ready,
+  // recorded until the buckets are rebuilt.
+  std::vector<size_t> rebuilt_param_indices_;
+
   void mark_variable_ready_dense(VariableIndex index);
 
   void mark_variable_ready_sparse(VariableIndex index);
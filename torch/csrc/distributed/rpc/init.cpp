@@ -383,6 +383,15 @@ PyObject* rpc_init(PyObject* /* unused */) {
                   :meth:`~torch.distributed.rpc.rpc_async` if necessary.
               init_method (str, optional): The URL to initialize
                   ``ProcessGroupGloo`` (default: ``env://``).
+              num_control_threads (int, optional): The number of threads in
+                  the separate thread-pool that handles internal RRef and
+                  distributed autograd cleanup messages, so that they are not
+                  queued behind user requests (default: 1).
+              max_queued_recvs (int, optional): The maximum number of received
+                  messages waiting for a thread of the thread-pool. Requests
+                  that arrive when the limit is reached fail on the caller
+                  with an error, which it can retry after a backoff. ``0``
+                  means no limit (default: 0).
 
 
           Example::
@@ -404,19 +413,38 @@ PyObject* rpc_init(PyObject* /* unused */) {
               >>> # omitting init_rpc invocation on worker2
       )")
       .def(
-          py::init<int, float, std::string>(),
+          py::init<int, float, std::string, int, int64_t>(),
           py::arg("num_send_recv_threads") = kDefaultNumSendRecvThreads,
           py::arg("rpc_timeout") = kDefaultRpcTimeoutSeconds,
-          py::arg("init_method") = kDefaultInitMethod)
+          py::arg("init_method") = kDefaultInitMethod,
+          py::arg("num_control_threads") = kDefaultNumControlThreads,
+          py::arg("max_queued_recvs") = kUnboundedQueuedRecvs)
       .def_readwrite(
           "num_send_recv_threads",
           &ProcessGroupRpcBackendOptions::numSendRecvThreads,
           R"(
               The number of threads in the thread-pool used by ProcessGroupAgent.
+          )")
+      .def_readwrite(
+          "num_control_threads",
+          &ProcessGroupRpcBackendOptions::numControlThreads,
+          R"(
+              The number of threads in the thread-pool used by ProcessGroupAgent
+              for internal RRef and distributed autograd cleanup messages.
+          )")
+      .def_readwrite(
+          "max_queued_recvs",
+          &ProcessGroupRpcBackendOptions::maxQueuedRecvs,
+          R"(
+              The maximum number of received messages waiting for a thread
+              before ProcessGroupAgent rejects requests, or ``0`` for no limit.
           )");
 
   module.attr("_DEFAULT_NUM_SEND_RECV_THREADS") =
       py::cast(kDefaultNumSendRecvThreads);
+  module.attr("_DEFAULT_NUM_CONTROL_THREADS") =
+      py::cast(kDefaultNumControlThreads);
+  module.attr("_UNBOUNDED_QUEUED_RECVS") = py::cast(kUnboundedQueuedRecvs);
 
   shared_ptr_class_<ProcessGroupAgent>(module, "ProcessGroupAgent", rpcAgent)
       .def(
@@ -424,11 +452,15 @@ PyObject* rpc_init(PyObject* /* unused */) {
               std::string,
               std::shared_ptr<::c10d::ProcessGroup>,
               int,
-              std::chrono::milliseconds>(),
+              std::chrono::milliseconds,
+              int,
+              int64_t>(),
           py::arg("name"),
           py::arg("process_group"),
           py::arg("num_send_recv_threads"),
-          py::arg("rpc_timeout"))
+          py::arg("rpc_timeout"),
+          py::arg("num_control_threads") = kDefaultNumControlThreads,
+          py::arg("max_queued_recvs") = kUnboundedQueuedRecvs)
       .def(
           "get_worker_info",
           (const WorkerInfo& (ProcessGroupAgent::*)(void)const) &
@@ -461,9 +493,30 @@ PyObject* rpc_init(PyObject* /* unused */) {
   py::class_<TensorPipeRpcBackendOptions>(
       module, "TensorPipeRpcBackendOptions", rpcBackendOptions)
       .def(
-          py::init<float, std::string>(),
+          py::init<
+              float,
+              std::string,
+              std::unordered_map<std::string, DeviceMap>>(),
           py::arg("rpc_timeout") = kDefaultRpcTimeoutSeconds,
-          py::arg("init_method") = kDefaultInitMethod);
+          py::arg("init_method") = kDefaultInitMethod,
+          py::arg("device_maps") = std::unordered_map<std::string, DeviceMap>())
+      .def_readonly(
+          "device_maps",
+          &TensorPipeRpcBackendOptions::deviceMaps,
+          R"(For each destination worker name, the map from the CUDA device
+              indices of this worker to those of the destination that CUDA
+              tensors are sent to. Responses send CUDA tensors back to the
+              devices of the request.)")
+      .def(
+          "set_device_map",
+          &TensorPipeRpcBackendOptions::setDeviceMap,
+          py::arg("to"),
+          py::arg("device_map"),
+          R"(
+              Sets the device mapping to the worker ``to``: CUDA tensors on
+              device ``i`` of this worker arrive on device ``device_map[i]``
+              of ``to``. Entries already set for other devices are kept.
+          )");
 
   shared_ptr_class_<TensorPipeAgent>(module, "TensorPipeAgent", rpcAgent)
       .def(
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <torch/csrc/autograd/profiler.h>
+#include <torch/csrc/distributed/rpc/metrics/RpcMetricsHandler.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+// Reports the operator latency metrics (see enableOpLatencyMetrics in
+// torch/csrc/autograd/profiler.h) to a RpcMetricsHandler. Handlers accumulate
+// the values they get, so every call covers the invocations recorded since
+// the previous one: for every op that ran in between, it accumulates the
+// number of invocations in "<prefix>op.<name>.count" and their median and
+// 99th percentile latencies in "<prefix>op.<name>.p50_ns" and ".p99_ns".
+class OpLatencyMetricsReporter {
+ public:
+  void report(RpcMetricsHandler& handler) {
+    for (auto& histogram : torch::autograd::profiler::scrapeOpLatencyMetrics()) {
+      auto& last = last_[histogram.name];
+      torch::autograd::profiler::OpLatencyHistogram delta;
+      delta.count = histogram.count - last.count;
+      if (delta.count == 0) {
+        continue;
+      }
+      for (size_t i = 0; i < delta.buckets.size(); ++i) {
+        delta.buckets[i] = histogram.buckets[i] - last.buckets[i];
+      }
+      const std::string key =
+          std::string(kRpcMetricsKeyPrefix) + "op." + histogram.name;
+      handler.accumulateMetric(key + ".count", delta.count);
+      handler.accumulateMetric(key + ".p50_ns", delta.quantile(0.5));
+      handler.accumulateMetric(key + ".p99_ns", delta.quantile(0.99));
+      last = std::move(histogram);
+    }
+  }
+
+ private:
+  std::unordered_map<std::string, torch::autograd::profiler::OpLatencyHistogram>
+      last_;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -57,6 +57,9 @@ const ProcessGroupAgent::steady_clock_time_point
 const std::string kNumPendingRequests = "agent.num_pending_requests";
 const std::string kThreadPoolSize = "agent.thread_pool_size";
 const std::string kNumIdleThreads = "agent.num_idle_threads";
+const std::string kControlThreadPoolSize = "agent.control_thread_pool_size";
+const std::string kNumQueuedRecvs = "agent.num_queued_recvs";
+const std::string kNumRejectedRequests = "agent.num_rejected_requests";
 const std::string kGilAverageWaitTime = "agent.gil_average_wait_time_us";
 const std::string kClientActiveCalls = "agent.client_active_calls";
 const std::string kServerActiveCalls = "agent.server_active_calls";
@@ -97,7 +100,9 @@ ProcessGroupAgent::ProcessGroupAgent(
     std::string workerName,
     std::shared_ptr<c10d::ProcessGroup> pg,
     int numSendRecvThreads,
-    std::chrono::milliseconds rpcTimeout)
+    std::chrono::milliseconds rpcTimeout,
+    int numControlThreads,
+    int64_t maxQueuedRecvs)
     : RpcAgent(
           WorkerInfo(std::move(workerName), (int64_t)pg->getRank()),
           std::make_unique<RequestCallbackImpl>(),
@@ -108,6 +113,8 @@ ProcessGroupAgent::ProcessGroupAgent(
       nextId_(0),
       sendMutexes_(pg_->getSize()),
       threadPool_(numSendRecvThreads),
+      controlThreadPool_(numControlThreads),
+      maxQueuedRecvs_(maxQueuedRecvs),
       timeoutThreadEnabled_{false} {
   // initialize metric info counters
   metrics_.resize(ProcessGroupAgentMetrics::N_METRICS);
@@ -232,8 +239,9 @@ void ProcessGroupAgent::sync() {
   pg_->barrier()->wait();
   // block until all peers agree that all sent messages have been processed.
   do {
-    // Finish all send/recv tasks in the thread pool
+    // Finish all send/recv tasks in the thread pools
     threadPool_.waitWorkComplete();
+    controlThreadPool_.waitWorkComplete();
     // As there could be nested RPC calls, or response callback could also
     // trigger more messages to be sent, we need to wait for the thread pool
     // again.
@@ -287,6 +295,7 @@ void ProcessGroupAgent::shutdownImpl() {
   // that we can finish any possible work enqueued into the thread pool, before
   // python RPC handler is shutdown (see shutdown in rpc/api.py).
   threadPool_.waitWorkComplete();
+  controlThreadPool_.waitWorkComplete();
 }
 
 std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
@@ -417,8 +426,12 @@ std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
 }
 
 void ProcessGroupAgent::handleSend(const SendWork& work) {
-  auto serializedPayload = std::make_unique<std::string>(std::move(
-      wireSerialize(work.message_.payload(), work.message_.tensors())));
+  // The tensor data is sent from the tensor storages, without copying it into
+  // the serialized payload.
+  std::vector<torch::Tensor> tensorData;
+  auto serializedPayload = std::make_unique<std::string>(
+      wireSerialize(
+          work.message_.payload(), work.message_.tensors(), &tensorData));
 
   std::vector<torch::Tensor> preamble = {torch::tensor(
       {(int64_t)pg_->getRank(),
@@ -441,7 +454,7 @@ void ProcessGroupAgent::handleSend(const SendWork& work) {
       serializedPayloadSize,
       [deleteWhenDone](void*) { delete deleteWhenDone; },
       {torch::kChar})};
-  pendingSends.reserve(2);
+  pendingSends.reserve(2 + tensorData.size());
 
   sendCounts_.increment(dst);
 
@@ -449,6 +462,14 @@ void ProcessGroupAgent::handleSend(const SendWork& work) {
     std::lock_guard<std::mutex> guard(sendMutexes_[dst]);
     pendingSends.emplace_back(pg_->send(preamble, dst, dst /* channelTag */));
     pendingSends.emplace_back(pg_->send(payload, dst, dst /* channelTag */));
+    for (auto& data : tensorData) {
+      // The receiver knows the sizes from the payload, and skips empty ones.
+      if (data.numel() == 0) {
+        continue;
+      }
+      std::vector<torch::Tensor> buffer = {data};
+      pendingSends.emplace_back(pg_->send(buffer, dst, dst /* channelTag */));
+    }
   }
   // Write pendingSends to a global map so that they can be interrupted by
   // ::shutdown().
@@ -506,7 +527,11 @@ void ProcessGroupAgent::enqueueSend(SendWork work) {
 
 bool ProcessGroupAgent::handleRecv(RecvWork& work) {
   torch::Tensor& payload = work.payload_;
-  auto data = wireDeserialize(payload.storage().data(), payload.numel());
+  // Messages sent to ourselves hold the tensor data in the payload.
+  auto data = wireDeserialize(
+      payload.storage().data(),
+      payload.numel(),
+      work.tensorData_.empty() ? nullptr : &work.tensorData_);
   Message message(
       std::move(data.first), std::move(data.second), work.type_, work.id_);
   if (message.isRequest()) {
@@ -599,9 +624,42 @@ bool ProcessGroupAgent::handleRecv(RecvWork& work) {
   return true;
 }
 
+bool ProcessGroupAgent::isControlMessage(MessageType type) {
+  switch (type) {
+    case MessageType::RREF_USER_DELETE:
+    case MessageType::RREF_FORK_REQUEST:
+    case MessageType::RREF_CHILD_ACCEPT:
+    case MessageType::RREF_ACK:
+    case MessageType::RREF_BATCH:
+    case MessageType::CLEANUP_AUTOGRAD_CONTEXT_REQ:
+    case MessageType::CLEANUP_AUTOGRAD_CONTEXT_RESP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool ProcessGroupAgent::shouldRejectRequest(MessageType type) const {
+  if (maxQueuedRecvs_ == kUnboundedQueuedRecvs || isControlMessage(type) ||
+      queuedRecvs_.load() < maxQueuedRecvs_) {
+    return false;
+  }
+  // Responses are never rejected, since they complete the futures that the
+  // queued requests may be waiting for.
+  return Message({}, {}, type).isRequest();
+}
+
 void ProcessGroupAgent::enqueueRecv(RecvWork work) {
-  threadPool_.run(std::bind(
-      [&](RecvWork& work) {
+  const bool isControl = isControlMessage(work.type_);
+  if (!isControl) {
+    ++queuedRecvs_;
+  }
+  auto& threadPool = isControl ? controlThreadPool_ : threadPool_;
+  threadPool.run(std::bind(
+      [this, isControl](RecvWork& work) {
+        if (!isControl) {
+          --queuedRecvs_;
+        }
         try {
           // Only increment recvCounts if handleRecv() tells us to. We may not,
           // i.e. if we process work corresponding to a future that has already
@@ -741,8 +799,52 @@ void ProcessGroupAgent::listenLoopInternal() {
       return;
     }
 
-    enqueueRecv(
-        RecvWork(allWorkerInfo_[srcRank], type, id, std::move(tensors[0])));
+    // The data of the tensor storages follows the payload, and is received
+    // into the memory that the deserialized tensors use.
+    std::vector<torch::Tensor> tensorData;
+    for (auto dataSize :
+         wireTensorDataSizes(tensors[0].storage().data(), size)) {
+      tensorData.push_back(
+          torch::empty({static_cast<int64_t>(dataSize)}, {torch::kChar}));
+      if (dataSize == 0) {
+        continue;
+      }
+      std::vector<torch::Tensor> buffer = {tensorData.back()};
+      work = pg_->recv(buffer, srcRank, pg_->getRank());
+      {
+        // Write class variable so it can be aborted by shutdown()
+        std::lock_guard<std::mutex> guard(recvWorkMutex_);
+        recvWork_ = work;
+      }
+
+      if (!rpcAgentRunning_.load() || !work->wait() /* aborted */) {
+        return;
+      }
+    }
+
+    if (shouldRejectRequest(type)) {
+      // The request counts as processed for termination detection, and the
+      // error response is tallied as a sent message.
+      ++numRejectedRequests_;
+      recvCounts_.increment(srcRank);
+      auto err = c10::str(
+          "RPC request rejected by worker ",
+          RpcAgent::getWorkerInfo().id_,
+          " because ",
+          maxQueuedRecvs_,
+          " received messages are already waiting to be processed. ",
+          "Retry after a backoff.");
+      enqueueSend(SendWork(
+          allWorkerInfo_[srcRank], createExceptionResponse(err, id)));
+      continue;
+    }
+
+    enqueueRecv(RecvWork(
+        allWorkerInfo_[srcRank],
+        type,
+        id,
+        std::move(tensors[0]),
+        std::move(tensorData)));
   }
 }
 
@@ -849,6 +951,9 @@ std::unordered_map<std::string, std::string> ProcessGroupAgent::getMetrics() {
   }
   metrics[kThreadPoolSize] = c10::to_string(threadPool_.size());
   metrics[kNumIdleThreads] = c10::to_string(threadPool_.numAvailable());
+  metrics[kControlThreadPoolSize] = c10::to_string(controlThreadPool_.size());
+  metrics[kNumQueuedRecvs] = c10::to_string(queuedRecvs_.load());
+  metrics[kNumRejectedRequests] = c10::to_string(numRejectedRequests_.load());
   metrics[kClientActiveCalls] = c10::to_string(clientActiveCalls_.load());
   metrics[kServerActiveCalls] = c10::to_string(serverActiveCalls_.load());
   metrics[kServerActiveAsyncCalls] =
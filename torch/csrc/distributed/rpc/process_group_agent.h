@@ -12,22 +12,41 @@ namespace distributed {
 namespace rpc {
 
 constexpr auto kDefaultNumSendRecvThreads = 4;
+constexpr auto kDefaultNumControlThreads = 1;
+// No limit on the number of received messages waiting for a thread.
+constexpr int64_t kUnboundedQueuedRecvs = 0;
 
 struct ProcessGroupRpcBackendOptions : public RpcBackendOptions {
   ProcessGroupRpcBackendOptions(
       int num_send_recv_threads,
       float rpc_timeout,
-      std::string init_method)
+      std::string init_method,
+      int num_control_threads = kDefaultNumControlThreads,
+      int64_t max_queued_recvs = kUnboundedQueuedRecvs)
       : RpcBackendOptions(rpc_timeout, init_method),
-        numSendRecvThreads(num_send_recv_threads) {
+        numSendRecvThreads(num_send_recv_threads),
+        numControlThreads(num_control_threads),
+        maxQueuedRecvs(max_queued_recvs) {
     TORCH_CHECK(
         num_send_recv_threads > 0,
         "Cannot create ProcessGroup RPC backend with ",
         num_send_recv_threads,
         " threads in the thread-pool.");
+    TORCH_CHECK(
+        num_control_threads > 0,
+        "Cannot create ProcessGroup RPC backend with ",
+        num_control_threads,
+        " threads in the control thread-pool.");
+    TORCH_CHECK(
+        max_queued_recvs >= 0,
+        "Cannot create ProcessGroup RPC backend with a negative limit of ",
+        max_queued_recvs,
+        " queued messages.");
   }
 
   int numSendRecvThreads;
+  int numControlThreads;
+  int64_t maxQueuedRecvs;
 };
 
 // SendWork and RecvWork will be put into a task queue, and later picked up by
@@ -42,18 +61,28 @@ struct SendWork {
 
 // SendWork wraps a Message and RecvWork wraps a Tensor. The difference here is
 // to allow us to run serialization/deserialization in the worker threads.
+//
+// Messages from other workers are received as the serialized payload plus
+// one tensor with the data of every tensor storage, which wireSerialize()
+// left out of the payload so that it's sent and received in place.
 struct RecvWork {
   RecvWork(
       const WorkerInfo& from,
       MessageType type,
       int64_t id,
-      torch::Tensor&& payload)
-      : from_(from), type_(type), id_(id), payload_(payload) {}
+      torch::Tensor&& payload,
+      std::vector<torch::Tensor>&& tensorData = {})
+      : from_(from),
+        type_(type),
+        id_(id),
+        payload_(payload),
+        tensorData_(std::move(tensorData)) {}
 
   const WorkerInfo& from_;
   const MessageType type_;
   const int64_t id_;
   torch::Tensor payload_;
+  std::vector<torch::Tensor> tensorData_;
 };
 
 class ProcessGroupAgent : public RpcAgent {
@@ -62,7 +91,9 @@ class ProcessGroupAgent : public RpcAgent {
       std::string workerName,
       std::shared_ptr<c10d::ProcessGroup> pg,
       int numSendRecvThreads,
-      std::chrono::milliseconds rpcTimeout);
+      std::chrono::milliseconds rpcTimeout,
+      int numControlThreads = kDefaultNumControlThreads,
+      int64_t maxQueuedRecvs = kUnboundedQueuedRecvs);
 
   const WorkerInfo& getWorkerInfo(const std::string& workerName) const override;
 
@@ -154,6 +185,13 @@ class ProcessGroupAgent : public RpcAgent {
   void handleSend(const SendWork& work);
   // put RecvWork into a queue and notify the worker thread
   void enqueueRecv(RecvWork work);
+  // Internal RRef and distributed autograd cleanup messages, which are cheap
+  // to handle and unblock other workers, so they skip the queue of user
+  // requests.
+  static bool isControlMessage(MessageType type);
+  // Whether a request of the given type should be rejected because too many
+  // received messages are waiting for a thread.
+  bool shouldRejectRequest(MessageType type) const;
   // handle a RecvWork request. Return true if we should increment recvCounts,
   // false if not (i.e. if the RPC timed out and we are getting a result after
   // the timeout). This ensures that the messages accounted for in
@@ -252,6 +290,16 @@ class ProcessGroupAgent : public RpcAgent {
   //     NB: Ideally, this should be addressed by supporting asynchronous UDF.
   //         This is just a temporary solution for (2).
   ThreadPool threadPool_;
+  // A separate, usually small, threadPool for control messages (see
+  // isControlMessage()), so that they aren't queued behind user requests.
+  ThreadPool controlThreadPool_;
+  // Requests that arrive while maxQueuedRecvs_ messages are waiting for a
+  // thread of threadPool_ are answered with an error instead of queued, which
+  // bounds the queue under heavy fan-in and tells the callers to back off.
+  // Zero means unbounded.
+  const int64_t maxQueuedRecvs_;
+  std::atomic<int64_t> queuedRecvs_{0};
+  std::atomic<int64_t> numRejectedRequests_{0};
   // Atomic to indicate whether the timeout thread is enabled.
   std::atomic<bool> timeoutThreadEnabled_;
   // Mapping of request id to FutureInfo struct.
@@ -430,6 +430,38 @@ void RequestCallbackImpl::processRpc(
       markComplete(RRefAck().toMessage());
       return;
     }
+    case MessageType::RREF_BATCH: {
+      auto& rb = static_cast<RRefBatch&>(rpc);
+      auto& ctx = RRefContext::getInstance();
+      std::vector<c10::intrusive_ptr<RRef>> deletedPyObjRRefs;
+      for (const auto& entry : rb.entries()) {
+        switch (entry.type) {
+          case MessageType::RREF_USER_DELETE: {
+            auto deletedRRef =
+                ctx.delForkOfOwner(entry.rrefId, entry.forkId);
+            if (deletedRRef && deletedRRef->isPyObj()) {
+              deletedPyObjRRefs.emplace_back(std::move(deletedRRef));
+            }
+            break;
+          }
+          case MessageType::RREF_FORK_REQUEST:
+            ctx.addForkOfOwnerIfNotPresent(entry.rrefId, entry.forkId);
+            break;
+          case MessageType::RREF_CHILD_ACCEPT:
+            ctx.delPendingChild(entry.forkId);
+            break;
+          default:
+            TORCH_INTERNAL_ASSERT(
+                false, "Unexpected message type in RRefBatch: ", entry.type);
+        }
+      }
+      if (!deletedPyObjRRefs.empty()) {
+        py::gil_scoped_acquire acquire;
+        deletedPyObjRRefs.clear();
+      }
+      markComplete(RRefAck().toMessage());
+      return;
+    }
     case MessageType::FORWARD_AUTOGRAD_REQ: {
       auto& rpcWithAutograd = static_cast<RpcWithAutograd&>(rpc);
 
@@ -1,5 +1,4 @@
 #include <torch/csrc/distributed/rpc/rref_context.h>
-#include <torch/csrc/distributed/rpc/rref_proto.h>
 
 #include <sstream>
 
@@ -175,11 +174,10 @@ void RRefContext::delUser(
       // Sending an RRefUserDelete causes the receiver to run delForkOfOwner,
       // which is now idempotent. See the comment at RRefContext::delForkOfOwner
       // for more details.
-      auto fm = agent_->sendWithRetries(
-          agent_->getWorkerInfo(owner),
-          RRefUserDelete(rrefId, forkId).toMessage());
-
-      fm->addCallback([](const FutureMessage& fm) { handleException(fm); });
+      sendRRefMessage(
+          owner,
+          {MessageType::RREF_USER_DELETE, rrefId, forkId},
+          [](const FutureMessage& fm) { handleException(fm); });
     }
   }
 
@@ -408,19 +406,19 @@ void RRefContext::notifyOwnerAndParentOfFork(
     // In this case, the owner is the caller, and it does not add the fork id
     // into forks_. Because, there will be no real `UserRRef` associated
     // with this fork ID.
-    auto fm = agent_->sendWithRetries(
-        agent_->getWorkerInfo(parent), RRefChildAccept(forkId).toMessage());
-    fm->addCallback([](const FutureMessage& fm) { handleException(fm); });
+    sendRRefMessage(
+        parent,
+        {MessageType::RREF_CHILD_ACCEPT, forkId, forkId},
+        [](const FutureMessage& fm) { handleException(fm); });
   } else {
-    auto fm = agent_->sendWithRetries(
-        agent_->getWorkerInfo(rref->owner()),
-        RRefForkRequest(rref->rrefId(), forkId).toMessage());
-
     addPendingUser(forkId, rref);
-    fm->addCallback([this, forkId, parent](const FutureMessage& fm) {
-      handleException(fm);
-      this->finishForkRequest(forkId, parent);
-    });
+    sendRRefMessage(
+        rref->owner(),
+        {MessageType::RREF_FORK_REQUEST, rref->rrefId(), forkId},
+        [this, forkId, parent](const FutureMessage& fm) {
+          handleException(fm);
+          this->finishForkRequest(forkId, parent);
+        });
   }
 }
 
@@ -583,10 +581,74 @@ void RRefContext::clearRecordedPendingRRefsOnError() {
 
 void RRefContext::finishForkRequest(const ForkId& forkId, worker_id_t parent) {
   delPendingUser(forkId);
+  sendRRefMessage(
+      parent,
+      {MessageType::RREF_CHILD_ACCEPT, forkId, forkId},
+      [](const FutureMessage& fm) { handleException(fm); });
+}
+
+void RRefContext::sendRRefMessage(
+    worker_id_t dst,
+    RRefBatch::Entry entry,
+    RRefMessageCallback callback) {
+  {
+    std::lock_guard<std::mutex> lock(pendingRRefMessagesMutex_);
+    auto& pending = pendingRRefMessages_[dst];
+    if (pending.inFlight) {
+      pending.entries.emplace_back(std::move(entry));
+      pending.callbacks.emplace_back(std::move(callback));
+      return;
+    }
+    pending.inFlight = true;
+  }
+  sendRRefBatch(dst, {std::move(entry)}, {std::move(callback)});
+}
+
+void RRefContext::sendRRefBatch(
+    worker_id_t dst,
+    std::vector<RRefBatch::Entry> entries,
+    std::vector<RRefMessageCallback> callbacks) {
+  // A single message is sent as is, so that the destination sees the same
+  // messages as without batching when it isn't busy.
+  auto message = entries.size() == 1
+      ? entries.front().toMessage()
+      : RRefBatch(std::move(entries)).toMessage();
   auto fm = agent_->sendWithRetries(
-      agent_->getWorkerInfo(parent), RRefChildAccept(forkId).toMessage());
+      agent_->getWorkerInfo(dst), std::move(message));
 
-  fm->addCallback([](const FutureMessage& fm) { handleException(fm); });
+  fm->addCallback([this, dst, callbacks{std::move(callbacks)}](
+                      const FutureMessage& fm) {
+    std::vector<RRefBatch::Entry> nextEntries;
+    std::vector<RRefMessageCallback> nextCallbacks;
+    {
+      std::lock_guard<std::mutex> lock(pendingRRefMessagesMutex_);
+      auto& pending = pendingRRefMessages_[dst];
+      if (pending.entries.empty()) {
+        pending.inFlight = false;
+      } else {
+        nextEntries.swap(pending.entries);
+        nextCallbacks.swap(pending.callbacks);
+      }
+    }
+    if (!nextEntries.empty()) {
+      sendRRefBatch(dst, std::move(nextEntries), std::move(nextCallbacks));
+    }
+
+    // Run every callback even if some of them throw, e.g. on an error.
+    std::exception_ptr eptr;
+    for (const auto& callback : callbacks) {
+      try {
+        callback(fm);
+      } catch (...) {
+        if (!eptr) {
+          eptr = std::current_exception();
+        }
+      }
+    }
+    if (eptr) {
+      std::rethrow_exception(eptr);
+    }
+  });
 }
 
 void RRefContext::addSelfAsFork(c10::intrusive_ptr<OwnerRRef>& rref) {
@@ -4,6 +4,7 @@
 #include <torch/csrc/distributed/rpc/message.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 #include <torch/csrc/distributed/rpc/rref_impl.h>
+#include <torch/csrc/distributed/rpc/rref_proto.h>
 #include <torch/csrc/distributed/rpc/types.h>
 #include <torch/csrc/utils/future.h>
 
@@ -225,6 +226,29 @@ class TORCH_API RRefContext {
 
   void finishForkRequest(const ForkId& forkId, worker_id_t parent);
 
+  // Note [RRef Message Batching]
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  //
+  // Every fork and delete of a UserRRef sends an RREF_FORK_REQUEST,
+  // RREF_CHILD_ACCEPT or RREF_USER_DELETE message. To avoid a storm of tiny
+  // RPCs when many RRefs are passed around, at most one of these messages per
+  // destination is in flight. The messages sent in the meantime are queued,
+  // and once the message in flight is acked, all of them are sent as one
+  // RREF_BATCH message. A message to an idle destination is sent right away,
+  // on its own, so this adds no latency unless the destination is busy.
+  //
+  // `callback` runs when the message is acked, as if it was sent on its own.
+  using RRefMessageCallback = std::function<void(const FutureMessage&)>;
+  void sendRRefMessage(
+      worker_id_t dst,
+      RRefBatch::Entry entry,
+      RRefMessageCallback callback);
+  // Sends `entries`, and the messages queued for `dst` once they are acked.
+  void sendRRefBatch(
+      worker_id_t dst,
+      std::vector<RRefBatch::Entry> entries,
+      std::vector<RRefMessageCallback> callbacks);
+
   // If there is any leak on any RRef, this method will throw an error.
   void checkRRefLeaks(bool ignoreRRefLeak);
 
@@ -288,6 +312,16 @@ class TORCH_API RRefContext {
   std::mutex destroyedMutex_;
   bool destroyed_;
 
+  // The RRef messages queued while a message to the same destination is in
+  // flight, see Note [RRef Message Batching].
+  struct PendingRRefMessages {
+    bool inFlight = false;
+    std::vector<RRefBatch::Entry> entries;
+    std::vector<RRefMessageCallback> callbacks;
+  };
+  std::unordered_map<worker_id_t, PendingRRefMessages> pendingRRefMessages_;
+  std::mutex pendingRRefMessagesMutex_;
+
   // Thread local states to keep UserRRefs deserialized from user function
   // arguments.
   static thread_local std::vector<std::shared_ptr<PendingUserState>> userTable_;
@@ -189,6 +189,52 @@ std::unique_ptr<RRefForkRequest> RRefForkRequest::fromMessage(
   return std::make_unique<RRefForkRequest>(pair.first, pair.second);
 }
 
+Message RRefBatch::Entry::toMessage() const {
+  switch (type) {
+    case MessageType::RREF_USER_DELETE:
+      return RRefUserDelete(rrefId, forkId).toMessage();
+    case MessageType::RREF_FORK_REQUEST:
+      return RRefForkRequest(rrefId, forkId).toMessage();
+    case MessageType::RREF_CHILD_ACCEPT:
+      return RRefChildAccept(forkId).toMessage();
+    default:
+      TORCH_INTERNAL_ASSERT(
+          false, "Unexpected message type in RRefBatch: ", type);
+  }
+}
+
+const std::vector<RRefBatch::Entry>& RRefBatch::entries() const {
+  return entries_;
+}
+
+Message RRefBatch::toMessageImpl() && {
+  std::vector<at::IValue> ivalues;
+  ivalues.reserve(entries_.size() * 3);
+  for (const auto& entry : entries_) {
+    ivalues.emplace_back(static_cast<int64_t>(entry.type));
+    ivalues.emplace_back(entry.rrefId.toIValue());
+    ivalues.emplace_back(entry.forkId.toIValue());
+  }
+  return fromIValues(std::move(ivalues), MessageType::RREF_BATCH);
+}
+
+std::unique_ptr<RRefBatch> RRefBatch::fromMessage(const Message& message) {
+  auto values = toIValues(message, MessageType::RREF_BATCH);
+  TORCH_INTERNAL_ASSERT(
+      values.size() % 3 == 0,
+      "Expect 3 IValues per RRefBatch entry, but got ",
+      values.size());
+
+  std::vector<Entry> entries;
+  entries.reserve(values.size() / 3);
+  for (size_t i = 0; i < values.size(); i += 3) {
+    entries.push_back({static_cast<MessageType>(values[i].toInt()),
+                       RRefId::fromIValue(values[i + 1]),
+                       ForkId::fromIValue(values[i + 2])});
+  }
+  return std::make_unique<RRefBatch>(std::move(entries));
+}
+
 Message RRefAck::toMessageImpl() && {
   return Message({}, {}, MessageType::RREF_ACK);
 }
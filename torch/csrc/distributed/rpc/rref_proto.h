@@ -155,6 +155,34 @@ class TORCH_API RRefForkRequest final : public ForkMessageBase {
   static std::unique_ptr<RRefForkRequest> fromMessage(const Message& message);
 };
 
+// A worker uses this message to send the RREF_USER_DELETE, RREF_FORK_REQUEST
+// and RREF_CHILD_ACCEPT messages to one destination that it queued while its
+// previous message to that destination was in flight. The destination handles
+// the entries in order, as if they were sent one by one, and acks them all.
+class TORCH_API RRefBatch final : public RpcCommandBase {
+ public:
+  struct Entry {
+    MessageType type;
+    // Unused for RREF_CHILD_ACCEPT.
+    RRefId rrefId;
+    ForkId forkId;
+
+    // The message that sends this entry alone.
+    Message toMessage() const;
+  };
+
+  explicit RRefBatch(std::vector<Entry> entries)
+      : entries_(std::move(entries)) {}
+
+  const std::vector<Entry>& entries() const;
+
+  Message toMessageImpl() && override;
+  static std::unique_ptr<RRefBatch> fromMessage(const Message& message);
+
+ private:
+  std::vector<Entry> entries_;
+};
+
 class TORCH_API RRefAck final : public RpcCommandBase {
  public:
   RRefAck() {}
@@ -33,6 +33,27 @@ const std::string kClientActiveCalls = "agent.client_active_calls";
 const std::string kServerActiveCalls = "agent.server_active_calls";
 const std::string kServerActiveAsyncCalls = "agent.server_active_async_calls";
 
+namespace {
+
+// Checks that deviceMap says where to send the CUDA tensors of message.
+void checkDeviceMap(
+    const Message& message,
+    const DeviceMap& deviceMap,
+    const std::string& destination) {
+  for (const auto& tensor : message.tensors()) {
+    TORCH_CHECK(
+        !tensor.is_cuda() || deviceMap.count(tensor.device().index()) > 0,
+        "TensorPipe RPC backend can't send a tensor on ",
+        tensor.device(),
+        " to ",
+        destination,
+        " without a device map for it. Call set_device_map on ",
+        "TensorPipeRpcBackendOptions, or move the tensor to CPU.");
+  }
+}
+
+} // namespace
+
 //////////////////////////  MetricsTracker  /////////////////////////////////
 
 TensorPipeAgent::TimeSeriesMetricsTracker::TimeSeriesMetricsTracker(
@@ -167,24 +188,28 @@ void TensorPipeAgent::onListenerAccepted(
 
 void TensorPipeAgent::pipeRead(
     const std::shared_ptr<tensorpipe::Pipe>& pipe,
-    std::function<void(const tensorpipe::Error&, Message&&)> fn) {
+    std::function<
+        void(const tensorpipe::Error&, Message&&, TensorPipeDevices&&)> fn) {
   pipe->readDescriptor([fn{std::move(fn)}, pipe](
                            const tensorpipe::Error& error,
                            tensorpipe::Message&& tpMessage) mutable {
     if (error) {
-      fn(error, Message());
+      fn(error, Message(), TensorPipeDevices());
       return;
     }
 
     // Allocate memory and fill in pointers
     Message rpcMessage = tensorpipeAllocateMessage(tpMessage);
+    TensorPipeDevices devices = tensorpipeReadDevices(tpMessage);
 
     pipe->read(
         std::move(tpMessage),
-        [fn{std::move(fn)}, rpcMessage{std::move(rpcMessage)}](
+        [fn{std::move(fn)},
+         rpcMessage{std::move(rpcMessage)},
+         devices{std::move(devices)}](
             const tensorpipe::Error& error,
             tensorpipe::Message&& /* unused */) mutable {
-          fn(error, std::move(rpcMessage));
+          fn(error, std::move(rpcMessage), std::move(devices));
         });
   });
 }
@@ -192,8 +217,9 @@ void TensorPipeAgent::pipeRead(
 void TensorPipeAgent::pipeWrite(
     const std::shared_ptr<tensorpipe::Pipe>& pipe,
     Message&& rpcMessage,
+    const DeviceMap& deviceMap,
     std::function<void(const tensorpipe::Error&)> fn) {
-  TensorPipeEntry tpEntry = tensorpipeSerialize(rpcMessage);
+  TensorPipeEntry tpEntry = tensorpipeSerialize(rpcMessage, deviceMap);
   tensorpipe::Message tpMessage = std::move(tpEntry.message);
   pipe->write(
       std::move(tpMessage),
@@ -209,19 +235,32 @@ void TensorPipeAgent::pipeWrite(
 void TensorPipeAgent::sendCompletedResponseMessage(
     std::shared_ptr<tensorpipe::Pipe>& pipe,
     std::shared_ptr<FutureMessage>& futureResponseMessage,
-    uint64_t messageId) {
+    uint64_t messageId,
+    const DeviceMap& reverseDeviceMap) {
   if (!rpcAgentRunning_.load()) {
     LOG(WARNING) << "RPC agent is being closed. Skip sending rpc response";
     return;
   }
 
-  const c10::optional<utils::FutureError> error =
-      futureResponseMessage->error();
+  c10::optional<std::string> error;
+  if (futureResponseMessage->error()) {
+    error = futureResponseMessage->error()->what();
+  }
   Message&& responseMessage = std::move(*futureResponseMessage).moveValue();
   responseMessage.setId(messageId);
+  if (!error) {
+    try {
+      checkDeviceMap(responseMessage, reverseDeviceMap, "the caller");
+    } catch (const std::exception& e) {
+      error = e.what();
+    }
+  }
   if (!error) {
     pipeWrite(
-        pipe, std::move(responseMessage), [](const tensorpipe::Error& error) {
+        pipe,
+        std::move(responseMessage),
+        reverseDeviceMap,
+        [](const tensorpipe::Error& error) {
           if (error) {
             LOG(WARNING) << "sending response failed: " << error.what();
             return;
@@ -230,7 +269,8 @@ void TensorPipeAgent::sendCompletedResponseMessage(
   } else {
     pipeWrite(
         pipe,
-        createExceptionResponse(error->what(), responseMessage.id()),
+        createExceptionResponse(*error, responseMessage.id()),
+        reverseDeviceMap,
         [](const tensorpipe::Error& error) {
           if (error) {
             LOG(WARNING) << "sending error response failed: " << error.what();
@@ -244,7 +284,9 @@ void TensorPipeAgent::respond(std::shared_ptr<tensorpipe::Pipe>& pipe) {
   pipeRead(
       pipe,
       [this, pipe](
-          const tensorpipe::Error& error, Message&& requestMessage) mutable {
+          const tensorpipe::Error& error,
+          Message&& requestMessage,
+          TensorPipeDevices&& devices) mutable {
         // TODO: Handle server pipe read error
         if (error) {
           LOG(WARNING) << "Server read message: " << error.what();
@@ -261,9 +303,12 @@ void TensorPipeAgent::respond(std::shared_ptr<tensorpipe::Pipe>& pipe) {
         threadPool_.run([this,
                          pipe,
                          messageId,
-                         requestMessage{std::move(requestMessage)}]() mutable {
+                         requestMessage{std::move(requestMessage)},
+                         devices{std::move(devices)}]() mutable {
           std::shared_ptr<FutureMessage> futureResponseMessage;
+          DeviceMap reverseDeviceMap;
           try {
+            reverseDeviceMap = tensorpipeMoveToDevices(requestMessage, devices);
             futureResponseMessage = cb_->operator()(requestMessage);
           } catch (const std::exception& e) {
             futureResponseMessage = std::make_shared<FutureMessage>();
@@ -274,16 +319,20 @@ void TensorPipeAgent::respond(std::shared_ptr<tensorpipe::Pipe>& pipe) {
           if (futureResponseMessage->completed()) {
             --serverActiveCalls_;
             sendCompletedResponseMessage(
-                pipe, futureResponseMessage, messageId);
+                pipe, futureResponseMessage, messageId, reverseDeviceMap);
           } else {
             // Not complete yet
             ++serverActiveAsyncCalls_;
             futureResponseMessage->addCallback(
-                [this, pipe, futureResponseMessage, messageId]() mutable {
+                [this,
+                 pipe,
+                 futureResponseMessage,
+                 messageId,
+                 reverseDeviceMap{std::move(reverseDeviceMap)}]() mutable {
                   --serverActiveCalls_;
                   --serverActiveAsyncCalls_;
                   sendCompletedResponseMessage(
-                      pipe, futureResponseMessage, messageId);
+                      pipe, futureResponseMessage, messageId, reverseDeviceMap);
                 });
           }
         });
@@ -310,6 +359,11 @@ std::shared_ptr<FutureMessage> TensorPipeAgent::send(
 
   const auto& url = findWorkerURL(toWorkerInfo);
 
+  const auto deviceMapIt = opts_.deviceMaps.find(toWorkerInfo.name_);
+  const DeviceMap deviceMap =
+      deviceMapIt != opts_.deviceMaps.end() ? deviceMapIt->second : DeviceMap();
+  checkDeviceMap(requestMessage, deviceMap, toWorkerInfo.name_);
+
   std::unique_lock<std::mutex> lock(mutex_);
 
   // See if we already have a connection to this address or not
@@ -334,19 +388,28 @@ std::shared_ptr<FutureMessage> TensorPipeAgent::send(
   pipeWrite(
       clientPipe.pipe_,
       std::move(requestMessage),
+      deviceMap,
       [this, &clientPipe, futureResponseMessage](
           const tensorpipe::Error& error) {
         if (error) {
           LOG(WARNING) << "client write error: " << error.what();
-          --clientActiveCalls_;
-          futureResponseMessage->setError(error.what());
+          // Run the callbacks of the future on the thread pool rather than
+          // on the tensorpipe event loop, like for a successful response.
+          threadPool_.run([this,
+                           futureResponseMessage,
+                           errorMsg{std::string(error.what())}]() {
+            --clientActiveCalls_;
+            futureResponseMessage->setError(errorMsg);
+          });
           return;
         }
 
         pipeRead(
             clientPipe.pipe_,
             [this, &clientPipe](
-                const tensorpipe::Error& error, Message&& responseMessage) {
+                const tensorpipe::Error& error,
+                Message&& responseMessage,
+                TensorPipeDevices&& devices) {
               if (error) {
                 LOG(WARNING) << "Read response error: " << error.what();
                 std::lock_guard<std::mutex> lock(mutex_);
@@ -354,9 +417,12 @@ std::shared_ptr<FutureMessage> TensorPipeAgent::send(
                 // Flushing all future messages belonging to this pipe due to
                 // error state.
                 for (auto& p : clientPipe.pendingResponseMessage_) {
-                  --clientActiveCalls_;
-                  std::shared_ptr<FutureMessage>& futureMessage = p.second;
-                  futureMessage->setError(error.what());
+                  threadPool_.run([this,
+                                   futureMessage{std::move(p.second)},
+                                   errorMsg{std::string(error.what())}]() {
+                    --clientActiveCalls_;
+                    futureMessage->setError(errorMsg);
+                  });
                 }
                 clientPipe.pendingResponseMessage_.clear();
                 clientPipe.readError_ = true;
@@ -385,8 +451,15 @@ std::shared_ptr<FutureMessage> TensorPipeAgent::send(
               threadPool_.run(
                   [this,
                    futureResponseMessage,
-                   responseMessage{std::move(responseMessage)}]() mutable {
+                   responseMessage{std::move(responseMessage)},
+                   devices{std::move(devices)}]() mutable {
                     --clientActiveCalls_;
+                    try {
+                      tensorpipeMoveToDevices(responseMessage, devices);
+                    } catch (const std::exception& e) {
+                      futureResponseMessage->setError(e.what());
+                      return;
+                    }
                     if (responseMessage.type() == MessageType::EXCEPTION) {
                       futureResponseMessage->setError(std::string(
                           responseMessage.payload().begin(),
@@ -6,6 +6,7 @@
 #include <tensorpipe/core/listener.h>
 #include <tensorpipe/core/pipe.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
+#include <torch/csrc/distributed/rpc/utils.h>
 
 #include <atomic>
 #include <thread>
@@ -15,8 +16,25 @@ namespace distributed {
 namespace rpc {
 
 struct TensorPipeRpcBackendOptions : public RpcBackendOptions {
-  TensorPipeRpcBackendOptions(float rpc_timeout, std::string init_method)
-      : RpcBackendOptions(rpc_timeout, init_method) {}
+  TensorPipeRpcBackendOptions(
+      float rpc_timeout,
+      std::string init_method,
+      std::unordered_map<std::string, DeviceMap> device_maps = {})
+      : RpcBackendOptions(rpc_timeout, init_method),
+        deviceMaps(std::move(device_maps)) {}
+
+  // Adds the entries of deviceMap to the map of the devices of this worker
+  // to those of workerName.
+  void setDeviceMap(const std::string& workerName, const DeviceMap& deviceMap) {
+    auto& workerDeviceMap = deviceMaps[workerName];
+    for (const auto& entry : deviceMap) {
+      workerDeviceMap[entry.first] = entry.second;
+    }
+  }
+
+  // For each destination worker, where to send the CUDA tensors of each
+  // device. Responses send them back to the devices of the request.
+  std::unordered_map<std::string, DeviceMap> deviceMaps;
 };
 
 // Struct to track the network source metrics
@@ -36,7 +54,8 @@ struct AggregatedNetworkData {
 // TensorPipeAgent leverages tensorpipe (https://github.com/pytorch/tensorpipe)
 // to move tensors and payload through fatested transport and channel
 // transparently. We can see it as a hybrid RPC transport, providing
-// shared memory (linux) and tcp (linux & mac). CUDA will be supported next.
+// shared memory (linux) and tcp (linux & mac). CUDA tensors are sent to the
+// devices given by the device maps of the options, through host memory.
 class TensorPipeAgent : public RpcAgent {
  public:
   TensorPipeAgent(
@@ -93,15 +112,19 @@ class TensorPipeAgent : public RpcAgent {
 
   // TensorPipe read function that could be used to read response messages
   // by client, and read request messages by server.
+  // The tensors of the message are left in host memory, to be moved to the
+  // given devices with tensorpipeMoveToDevices.
   void pipeRead(
       const std::shared_ptr<tensorpipe::Pipe>&,
-      std::function<void(const tensorpipe::Error&, Message&&)>);
+      std::function<
+          void(const tensorpipe::Error&, Message&&, TensorPipeDevices&&)>);
 
   // TensorPipe write function that could be used to write response
   // messages by server, and write request messages by client.
   void pipeWrite(
       const std::shared_ptr<tensorpipe::Pipe>&,
       Message&& message,
+      const DeviceMap& deviceMap,
       std::function<void(const tensorpipe::Error&)>);
 
   // Callback of listener accept()
@@ -112,10 +135,12 @@ class TensorPipeAgent : public RpcAgent {
   // Respond to a call from a peer
   void respond(std::shared_ptr<tensorpipe::Pipe>& pipe);
 
+  // reverseDeviceMap maps the devices of the request back to the client's.
   void sendCompletedResponseMessage(
       std::shared_ptr<tensorpipe::Pipe>& pipe,
       std::shared_ptr<FutureMessage>& futureResponseMessage,
-      uint64_t messageId);
+      uint64_t messageId,
+      const DeviceMap& reverseDeviceMap);
 
   // Collects metrics from successful RPC calls
   void trackNetworkData(
@@ -49,6 +49,9 @@ std::unique_ptr<RpcCommandBase> deserializeRequest(const Message& request) {
     case MessageType::RREF_FORK_REQUEST: {
       return RRefForkRequest::fromMessage(request);
     }
+    case MessageType::RREF_BATCH: {
+      return RRefBatch::fromMessage(request);
+    }
     case MessageType::FORWARD_AUTOGRAD_REQ: {
       return autograd::RpcWithAutograd::fromMessage(request);
     }
@@ -142,6 +145,9 @@ IValue deserializeRespToIValue(const Message& message) {
 
 namespace {
 
+static const char* kMeta = "meta";
+static const char* kPayload = "payload";
+
 // Helper for wireDeserialize() below.
 //
 // The format we use below looks like:
@@ -156,10 +162,16 @@ namespace {
 //    - "meta"    - metadata for the unpickler
 //    - "0" ...   - tensor sections for the unpickler
 //
+// If the tensor data is sent separately, the tensor sections are left out of
+// the sections that follow the header, and their data pointers are null.
+//
 // Note that per the header comments, the format is subject to change,
 // and is best used for rpcs, rather than persistent disk storage.
 std::unordered_map<std::string, std::pair<const char*, size_t>>
-parseWireSections(const void* data, size_t data_size) {
+parseWireSections(
+    const void* data,
+    size_t data_size,
+    bool externalTensorData = false) {
   const char* ptr = static_cast<const char*>(data);
   const char* endp = ptr + data_size;
 
@@ -201,6 +213,11 @@ parseWireSections(const void* data, size_t data_size) {
 
   std::unordered_map<std::string, std::pair<const char*, size_t>> out;
   for (const auto& headerEnt : headerEnts) {
+    if (externalTensorData && headerEnt.first != kPayload &&
+        headerEnt.first != kMeta) {
+      out[headerEnt.first] = {nullptr, headerEnt.second};
+      continue;
+    }
     out[headerEnt.first] = {ptr, headerEnt.second};
     ptr += headerEnt.second;
   }
@@ -209,9 +226,6 @@ parseWireSections(const void* data, size_t data_size) {
   }
   return out;
 }
-
-static const char* kMeta = "meta";
-static const char* kPayload = "payload";
 }; // namespace
 
 c10::List<at::Tensor> cloneSparseTensors(
@@ -240,7 +254,8 @@ c10::List<at::Tensor> cloneSparseTensors(
 
 std::string wireSerialize(
     const std::vector<char>& payload,
-    const std::vector<at::Tensor>& tensors) {
+    const std::vector<at::Tensor>& tensors,
+    std::vector<at::Tensor>* tensorDataOut) {
   for (const auto& tensor : tensors) {
     TORCH_CHECK(
         tensor.device().is_cpu(),
@@ -292,19 +307,52 @@ std::string wireSerialize(
   }
   header.push_back('\n');
 
+  // The tensor sections are the last ones, so leaving them out leaves the
+  // offsets of the others alone.
+  const size_t numInlineEntries = tensorDataOut == nullptr
+      ? entries.size()
+      : entries.size() - tensorData.size();
+  if (tensorDataOut != nullptr) {
+    for (size_t i = 0; i < tensorData.size(); i++) {
+      // The byte tensor keeps the storage it views alive.
+      const auto& data = tensorData[i];
+      tensorDataOut->push_back(at::from_blob(
+          const_cast<char*>(data.data()),
+          {static_cast<int64_t>(data.sizeInBytes())},
+          [data](void*) {},
+          at::TensorOptions(at::kChar)));
+      tot -= data.sizeInBytes();
+    }
+  }
+
   std::string out;
   out.reserve(header.size() + tot);
   out.append(header);
-  for (const auto& e : entries) {
-    out.append(e.data, e.size);
+  for (size_t i = 0; i < numInlineEntries; i++) {
+    out.append(entries[i].data, entries[i].size);
   }
   return out;
 }
 
+std::vector<size_t> wireTensorDataSizes(const void* data, size_t data_size) {
+  auto sections =
+      parseWireSections(data, data_size, /* externalTensorData */ true);
+  std::vector<size_t> sizes;
+  for (size_t i = 0;; i++) {
+    auto it = sections.find(c10::to_string(i));
+    if (it == sections.end()) {
+      break;
+    }
+    sizes.push_back(it->second.second);
+  }
+  return sizes;
+}
+
 std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
     const void* data,
-    size_t data_size) {
-  auto sections = parseWireSections(data, data_size);
+    size_t data_size,
+    std::vector<at::Tensor>* tensorData) {
+  auto sections = parseWireSections(data, data_size, tensorData != nullptr);
 
   std::vector<char> payload;
   auto payloadIt = sections.find(kPayload);
@@ -334,6 +382,17 @@ std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
         throw std::runtime_error("Couldn't find entity " + ename);
       }
       const auto& idat = it->second;
+      if (tensorData != nullptr) {
+        // Take over the memory the tensor data was received into.
+        const auto index = c10::stoll(ename);
+        TORCH_CHECK(
+            index >= 0 && static_cast<size_t>(index) < tensorData->size() &&
+                (*tensorData)[index].nbytes() == idat.second,
+            "Received tensor data doesn't match section ",
+            ename);
+        return (*tensorData)[index].storage().set_data_ptr(
+            at::DataPtr(nullptr, at::Device(at::kCPU)));
+      }
       auto dptr = at::getCPUAllocator()->allocate(idat.second);
       if (idat.second != 0) {
         memcpy(dptr.get(), idat.first, idat.second);
@@ -353,7 +412,9 @@ std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
   return {std::move(payload), std::move(tensors)};
 }
 
-TensorPipeEntry tensorpipeSerialize(const Message& rpcMessage) {
+TensorPipeEntry tensorpipeSerialize(
+    const Message& rpcMessage,
+    const DeviceMap& deviceMap) {
   tensorpipe::Message tpMessage;
   std::vector<torch::Tensor> reservedTensors;
   std::vector<std::vector<uint8_t>> copiedTensors;
@@ -368,8 +429,9 @@ TensorPipeEntry tensorpipeSerialize(const Message& rpcMessage) {
   tpMessage.payloads.push_back(std::move(tpPayload));
 
   // Metadata - encode rpc message type and message id into
-  // 8 bytes respectively
-  tpMessage.metadata.resize(2 * sizeof(int64_t));
+  // 8 bytes respectively, followed by the source and target devices of each
+  // tensor.
+  tpMessage.metadata.resize((2 + 2 * tensors.size()) * sizeof(int64_t));
   int64_t mType = static_cast<int>(rpcMessage.type());
   int64_t mId = rpcMessage.id();
   memcpy((void*)tpMessage.metadata.data(), &mType, sizeof(int64_t));
@@ -380,7 +442,26 @@ TensorPipeEntry tensorpipeSerialize(const Message& rpcMessage) {
 
   // Tensors
   tpMessage.tensors.reserve(tensors.size());
-  for (at::Tensor tensor : tensors) {
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    at::Tensor tensor = tensors.get(i);
+    int64_t devices[2] = {-1, -1};
+    // Only CPU channels are registered, so CUDA tensors go through host
+    // memory and are moved to their target device by the receiver.
+    if (tensor.is_cuda()) {
+      auto it = deviceMap.find(tensor.device().index());
+      TORCH_CHECK(
+          it != deviceMap.end(),
+          "No device map for tensor on ",
+          tensor.device(),
+          ", call set_device_map on TensorPipeRpcBackendOptions to send it");
+      devices[0] = tensor.device().index();
+      devices[1] = it->second;
+      tensor = tensor.to(at::kCPU);
+    }
+    memcpy(
+        (void*)(tpMessage.metadata.data() + (2 + 2 * i) * sizeof(int64_t)),
+        devices,
+        sizeof(devices));
     // Keep original user tensors and cloned sparse tensors
     reservedTensors.push_back(tensor);
     tensorpipe::Message::Tensor tpTensor;
@@ -423,10 +504,12 @@ Message tensorpipeAllocateMessage(tensorpipe::Message& tpMessage) {
       " payloads");
   std::vector<char> payload(tpMessage.payloads[0].length);
   tpMessage.payloads[0].data = (uint8_t*)(payload.data());
+  const size_t metadataSize =
+      (2 + 2 * tpMessage.tensors.size()) * sizeof(int64_t);
   TORCH_INTERNAL_ASSERT(
-      tpMessage.metadata.size() == 2 * sizeof(int64_t),
+      tpMessage.metadata.size() == metadataSize,
       "message metadata must be ",
-      2 * sizeof(int64_t),
+      metadataSize,
       " bytes, whereas it is ",
       tpMessage.metadata.size(),
       " bytes");
@@ -453,7 +536,7 @@ Message tensorpipeAllocateMessage(tensorpipe::Message& tpMessage) {
 
     auto sectionReadFunc = [&](const std::string& ename) -> at::DataPtr {
       TORCH_INTERNAL_ASSERT(ename == "0", "single tensor ename must be \"0\"");
-      // TODO: CUDA memory allocation
+      // CUDA tensors are received in host memory too.
       return at::getCPUAllocator()->allocate(tpTensor.length);
     };
 
@@ -468,6 +551,38 @@ Message tensorpipeAllocateMessage(tensorpipe::Message& tpMessage) {
   return Message(std::move(payload), std::move(tensors), mType, mId);
 }
 
+TensorPipeDevices tensorpipeReadDevices(const tensorpipe::Message& tpMessage) {
+  TensorPipeDevices devices;
+  devices.source.reserve(tpMessage.tensors.size());
+  devices.target.reserve(tpMessage.tensors.size());
+  for (size_t i = 0; i < tpMessage.tensors.size(); ++i) {
+    int64_t tensorDevices[2];
+    memcpy(
+        tensorDevices,
+        tpMessage.metadata.data() + (2 + 2 * i) * sizeof(int64_t),
+        sizeof(tensorDevices));
+    devices.source.push_back(tensorDevices[0]);
+    devices.target.push_back(tensorDevices[1]);
+  }
+  return devices;
+}
+
+DeviceMap tensorpipeMoveToDevices(
+    Message& rpcMessage,
+    const TensorPipeDevices& devices) {
+  auto& tensors = rpcMessage.tensors();
+  TORCH_INTERNAL_ASSERT(devices.target.size() == tensors.size());
+  DeviceMap reverseDeviceMap;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    if (devices.target[i] == -1) {
+      continue;
+    }
+    tensors[i] = tensors[i].to(at::Device(at::kCUDA, devices.target[i]));
+    reverseDeviceMap.emplace(devices.target[i], devices.source[i]);
+  }
+  return reverseDeviceMap;
+}
+
 } // namespace rpc
 } // namespace distributed
 } // namespace torch
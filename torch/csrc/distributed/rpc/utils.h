@@ -3,6 +3,8 @@
 #include <tensorpipe/core/message.h>
 #include <torch/csrc/distributed/rpc/rpc_command_base.h>
 
+#include <unordered_map>
+
 namespace torch {
 namespace distributed {
 namespace rpc {
@@ -32,14 +34,33 @@ TORCH_API IValue deserializeRespToIValue(const Message& message);
 
 // Note: format is subject to change and intended for RPCs.
 // For saving persistently to disk, use torch::save().
+//
+// If `tensorData` is given, the data of the tensor storages is left out of
+// the returned string, and one byte tensor that views the data of each storage
+// is appended to `tensorData` instead, so that it can be sent without copying
+// it. The receiver must pass the received tensors to wireDeserialize().
 TORCH_API std::string wireSerialize(
     const std::vector<char>& payload,
-    const std::vector<at::Tensor>& tensors);
+    const std::vector<at::Tensor>& tensors,
+    std::vector<at::Tensor>* tensorData = nullptr);
 
-TORCH_API std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
+// Returns the sizes in bytes of the tensor data that wireSerialize() left out
+// of `data`, in order.
+TORCH_API std::vector<size_t> wireTensorDataSizes(
     const void* data,
     size_t data_size);
 
+// If `tensorData` is given, it must hold the byte tensors with the tensor
+// data left out of `data`, with the sizes from wireTensorDataSizes(). Their
+// memory is taken over by the returned tensors, without copying it.
+TORCH_API std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
+    const void* data,
+    size_t data_size,
+    std::vector<at::Tensor>* tensorData = nullptr);
+
+// Maps the CUDA devices of the sender of a message to those of its receiver.
+using DeviceMap = std::unordered_map<c10::DeviceIndex, c10::DeviceIndex>;
+
 // TensorPipeEntry represents serialized tensorpipe message,
 // plus reserved tensor datas to keep memory lifetime.
 struct TensorPipeEntry {
@@ -54,14 +75,37 @@ struct TensorPipeEntry {
 // TensorPipe doesn't own any underlying memory. Users are required to
 // keep rpcMessage alive for the returned TensorPipeEntry to be valid,
 // since TensorPipe message just keeps raw pointers to the memory.
-TORCH_API TensorPipeEntry tensorpipeSerialize(const Message& rpcMessage);
+// CUDA tensors are sent from host memory, to the device `deviceMap` maps
+// their device to, which must be in it.
+TORCH_API TensorPipeEntry tensorpipeSerialize(
+    const Message& rpcMessage,
+    const DeviceMap& deviceMap = {});
 
 // The passed-in tensorpipe message is partial, which just contains
 // necessary information for memory allocation, like payload length
 // and tensor metadata. The returned RPC message doesn't have any
 // data, but would be valid after tensorpipe finishs data transfer.
+// Tensors sent from CUDA devices are received in host memory, see
+// tensorpipeMoveToDevices.
 TORCH_API Message tensorpipeAllocateMessage(tensorpipe::Message& tpMessage);
 
+// The devices the tensors of a message were sent from and must arrive on, -1
+// for CPU tensors.
+struct TensorPipeDevices {
+  std::vector<c10::DeviceIndex> source;
+  std::vector<c10::DeviceIndex> target;
+};
+
+// Reads the devices of the tensors from the (partial) tensorpipe message.
+TORCH_API TensorPipeDevices
+tensorpipeReadDevices(const tensorpipe::Message& tpMessage);
+
+// Moves the tensors of a received message to their target devices, once
+// tensorpipe has finished the data transfer. Returns the map from the target
+// devices back to the source devices, to send a response with.
+TORCH_API DeviceMap
+tensorpipeMoveToDevices(Message& rpcMessage, const TensorPipeDevices& devices);
+
 // Some Tensors are effectively views of larger Tensors, where only a small
 // subset of the Storage data is referenced. This normally is good and avoids
 // copies when kept locally, but if we naively push the whole Storage over the
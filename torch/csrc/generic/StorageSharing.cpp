@@ -15,6 +15,11 @@ static PyObject * THPStorage_(sharedDecref)(THPStorage *self, PyObject *noargs)
   if (ctx) {
     ctx->decref();
   }
+#ifndef _WIN32
+  if (THSharedArenaBlock *block = THSharedArenaBlock::fromDataPtr(storage->data_ptr())) {
+    block->decref();
+  }
+#endif
 #endif
   Py_INCREF(self);
   return (PyObject *)self;
@@ -30,6 +35,11 @@ static PyObject * THPStorage_(sharedIncref)(THPStorage *self, PyObject *noargs)
   if (ctx) {
     ctx->incref();
   }
+#ifndef _WIN32
+  if (THSharedArenaBlock *block = THSharedArenaBlock::fromDataPtr(storage->data_ptr())) {
+    block->incref();
+  }
+#endif
 #endif
   Py_RETURN_NONE;
   END_HANDLE_TH_ERRORS
@@ -129,6 +139,113 @@ static PyObject * THPStorage_(newSharedFilename)(PyObject *_unused, PyObject *ar
   END_HANDLE_TH_ERRORS
 }
 
+#ifndef _WIN32
+// Returns a new storage in the shared memory arena of this process, or nullptr
+// if the storage is too large to be allocated in an arena.
+static THWStorage* THPStorage_(newArenaStorage)(ptrdiff_t size)
+{
+  at::DataPtr data_ptr = THSharedArenaBlock::allocate(size * sizeof(scalar_t));
+  if (!data_ptr) {
+    return nullptr;
+  }
+  return THWStorage_(newWithDataAndAllocator)(std::move(data_ptr), size, /* allocator */ nullptr);
+}
+
+static PyObject * THPStorage_(pyNewArenaStorage)(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  long long size;
+  if (!PyArg_ParseTuple(args, "L", &size)) {
+    return nullptr;
+  }
+  THWStorage *storage = THPStorage_(newArenaStorage)(size);
+  if (!storage) {
+    Py_RETURN_NONE;
+  }
+  return THPStorage_(New)(storage);
+  END_HANDLE_TH_ERRORS
+}
+
+// Moves a small storage that isn't in shared memory yet into the shared memory
+// arena of this process, and returns the handle of its block. Returns None for
+// storages that are too large, or already shared in any other way, since
+// moving them would break the sharing.
+static PyObject * THPStorage_(shareArena)(THPStorage *self, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  THWStorage *storage = self->cdata;
+  THSharedArenaBlock *block = THSharedArenaBlock::fromDataPtr(storage->data_ptr());
+  if (!block) {
+    if (THMapAllocator::fromDataPtr(storage->data_ptr()) ||
+        THManagedMapAllocator::fromDataPtr(storage->data_ptr())) {
+      Py_RETURN_NONE;
+    }
+    THWStoragePtr new_storage(
+        THPStorage_(newArenaStorage)(storage->nbytes() / sizeof(scalar_t)));
+    if (!new_storage) {
+      Py_RETURN_NONE;
+    }
+    THWStorage_(copy)(new_storage, storage);
+    THWStorage_(swap)(storage, new_storage);
+    block = THSharedArenaBlock::fromDataPtr(storage->data_ptr());
+    AT_ASSERT(block);
+  }
+
+  THPObjectPtr manager_handle(PyBytes_FromString(block->manager_handle()));
+  if (!manager_handle) return nullptr;
+  THPObjectPtr segment_handle(PyBytes_FromString(block->segment_handle()));
+  if (!segment_handle) return nullptr;
+  THPObjectPtr segment_size(PyLong_FromSize_t(block->segment_size()));
+  if (!segment_size) return nullptr;
+  THPObjectPtr offset(PyLong_FromSize_t(block->offset()));
+  if (!offset) return nullptr;
+  THPObjectPtr size(PyLong_FromLong(storage->nbytes() / sizeof(scalar_t)));
+  if (!size) return nullptr;
+
+  THPObjectPtr tuple(PyTuple_New(5));
+  if (!tuple) return nullptr;
+  PyTuple_SET_ITEM(tuple.get(), 0, manager_handle.release());
+  PyTuple_SET_ITEM(tuple.get(), 1, segment_handle.release());
+  PyTuple_SET_ITEM(tuple.get(), 2, segment_size.release());
+  PyTuple_SET_ITEM(tuple.get(), 3, offset.release());
+  PyTuple_SET_ITEM(tuple.get(), 4, size.release());
+  return tuple.release();
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * THPStorage_(newSharedArena)(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(PyTuple_GET_SIZE(args) == 5, "tuple of 5 items expected");
+  PyObject *_manager_handle = PyTuple_GET_ITEM(args, 0);
+  PyObject *_segment_handle = PyTuple_GET_ITEM(args, 1);
+  PyObject *_segment_size = PyTuple_GET_ITEM(args, 2);
+  PyObject *_offset = PyTuple_GET_ITEM(args, 3);
+  PyObject *_size = PyTuple_GET_ITEM(args, 4);
+  if (!PyBytes_Check(_manager_handle) || !PyBytes_Check(_segment_handle) ||
+      !THPUtils_checkLong(_segment_size) || !THPUtils_checkLong(_offset) ||
+      !THPUtils_checkLong(_size)) {
+    THPUtils_invalidArguments(args, nullptr, "_new_shared_arena", 1,
+        "a manager handle (bytes), a segment handle (bytes), a segment size (int), "
+        "an offset (int) and a storage size (int)");
+    return nullptr;
+  }
+  const char *manager_handle = PyBytes_AS_STRING(_manager_handle);
+  const char *segment_handle = PyBytes_AS_STRING(_segment_handle);
+  int64_t segment_size = THPUtils_unpackLong(_segment_size);
+  int64_t offset = THPUtils_unpackLong(_offset);
+  int64_t size = THPUtils_unpackLong(_size);
+  at::DataPtr data_ptr = THSharedArenaBlock::open(
+      manager_handle, segment_handle, segment_size, offset);
+  THPUtils_assert(
+      THSharedArenaBlock::fromDataPtr(data_ptr)->size() == size * sizeof(scalar_t),
+      "size of the shared arena block doesn't match the storage size");
+  return THPStorage_(New)(
+          THWStorage_(newWithDataAndAllocator)(std::move(data_ptr), size, /* allocator */ nullptr));
+  END_HANDLE_TH_ERRORS
+}
+#endif
+
 static THWStorage* THPStorage_(newFdStorage)(ptrdiff_t size)
 {
   int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM |
@@ -263,7 +380,8 @@ static PyObject * THPStorage_(shareCuda)(THPStorage *self, PyObject *noargs)
 
 #ifndef __HIP_PLATFORM_HCC__
     if (sent_data->event_sync_required_) {
-      THCudaCheck(cudaIpcGetEventHandle(&ipc_event_handle, sent_data->event_));
+      // The handle was taken when the pooled event was created.
+      ipc_event_handle = sent_data->ipc_event_handle_;
     }
 #else
     // ipc_event_handle unused in storage receiver, we can leave it uninitialized.
@@ -314,21 +432,7 @@ static PyObject * THPStorage_(releaseIPCCounter)(PyObject *_unused, PyObject *ar
   std::string ref_counter_handle = PyBytes_AS_STRING(_ref_counter);
   ptrdiff_t ref_counter_offset =
       (ptrdiff_t)THPUtils_unpackLong(_ref_counter_offset);
-  // We don't want to break existing code, so resource deletion is best
-  // effort basis. Exception expected if producer process terminated
-  // before consumer released data.
-  int flags =
-      TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
-  try {
-    auto sptr = THRefcountedMapAllocator::makeDataPtr(
-        ref_counter_handle.c_str(),
-        flags,
-        sizeof(int64_t) * torch::CUDA_IPC_REF_COUNTER_FILE_SIZE,
-        nullptr);
-    *(static_cast<int64_t*>(sptr.get()) + ref_counter_offset) -= 1;
-  } catch (c10::Error& err) {
-    // Already warned inside of producer process
-  }
+  torch::CudaIPCReleaseRefCounter(ref_counter_handle, ref_counter_offset);
   Py_RETURN_NONE;
   END_HANDLE_TH_ERRORS
 }
@@ -380,10 +484,7 @@ static PyObject * THPStorage_(newSharedCuda)(PyObject *_unused, PyObject *args)
     // Ensure that producer prepared all tensor's data
     std::string s_ipc_event_handle =
         THPStorage_(bytesAsHandleString)(_event_handle);
-    auto ipc_event_handle = reinterpret_cast<const cudaIpcEventHandle_t*>(
-        s_ipc_event_handle.c_str());
-    cudaEvent_t event;
-    cudaIpcOpenEventHandle(&event, *ipc_event_handle);
+    cudaEvent_t event = torch::CudaIPCOpenEventHandle(s_ipc_event_handle);
     AT_CUDA_CHECK(
         cudaStreamWaitEvent(c10::cuda::getCurrentCUDAStream(device), event, 0));
   }
@@ -402,39 +503,26 @@ static PyObject * THPStorage_(newSharedCuda)(PyObject *_unused, PyObject *args)
   std::string ref_counter_handle = PyBytes_AS_STRING(_ref_counter);
   ptrdiff_t ref_counter_offset = (ptrdiff_t)THPUtils_unpackLong(_ref_counter_offset);
 
+  // The producer is alive, since it sent the storage, so mapping its
+  // reference counters can't fail.
+  std::shared_ptr<int64_t> ref_counters =
+      torch::CudaIPCMapRefCounters(ref_counter_handle);
   auto c = new torch::CudaIPCReceivedData(std::move(basePtr));
   auto sp = std::shared_ptr<void>(
-      (void*)c, [ref_counter_handle, ref_counter_offset, device](void* ptr) {
+      (void*)c, [ref_counters, ref_counter_offset, device](void* ptr) {
         delete static_cast<torch::CudaIPCReceivedData*>(ptr);
-        // Sync default stream to make sure all operations related to the storage is
-        // finished (otherwise another process may reuse memory and corrupt
-        // data)
+        // Release the counter once all operations related to the storage
+        // queued on the current stream are finished (otherwise another
+        // process may reuse memory and corrupt data). This doesn't block, the
+        // counter is released by a stream callback.
 
         // Ideally all shared memory reference counting could be replaced by
         // sending untriggered CUDA event from the producer to consumer and
         // using this event as the criteria of memory release. However, CUDA (atm 10.1)
         // does not support the creation of untriggered events and performance
         // impact of having thousands of shared events is unknown.
-
-        // TODO: Instead of cudaStreamSynchronize it is possible to add Stream
-        // Callback and release counter inside of it (need to check performance impact)
-        cudaStreamSynchronize(c10::cuda::getCurrentCUDAStream(device));
-
-        // We don't want to break existing code, so resource deletion is best
-        // effort basis. Exception expected if producer process terminated
-        // before consumer released data.
-        int flags =
-            TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
-        try {
-          auto sptr = THRefcountedMapAllocator::makeDataPtr(
-              ref_counter_handle.c_str(),
-              flags,
-              sizeof(int64_t) * torch::CUDA_IPC_REF_COUNTER_FILE_SIZE,
-              nullptr);
-          *(static_cast<int64_t*>(sptr.get()) + ref_counter_offset) -= 1;
-        } catch (c10::Error& err) {
-          // Already warned inside of producer process
-        }
+        torch::CudaIPCReleaseRefCounterAsync(
+            ref_counters, ref_counter_offset, device);
       });
 
   THWStoragePtr base(THWStorage_(newWithDataAndAllocator)(
@@ -518,7 +606,11 @@ PyObject * THPStorage_(isShared)(THPStorage *self, PyObject *noargs)
   Py_RETURN_TRUE;
 #else
   if (THMapAllocator::fromDataPtr(self->cdata->data_ptr()) ||
-      THManagedMapAllocator::fromDataPtr(self->cdata->data_ptr())) {
+      THManagedMapAllocator::fromDataPtr(self->cdata->data_ptr())
+#ifndef _WIN32
+      || THSharedArenaBlock::fromDataPtr(self->cdata->data_ptr())
+#endif
+      ) {
     Py_RETURN_TRUE;
   } else {
     Py_RETURN_FALSE;
@@ -539,6 +631,11 @@ static PyMethodDef THPStorage_(sharingMethods)[] = {
   {"_share_filename_", (PyCFunction)THPStorage_(shareFilename), METH_NOARGS, nullptr},
   {"_new_shared_filename", (PyCFunction)(void(*)(void))THPStorage_(newSharedFilename), METH_VARARGS | METH_STATIC, nullptr},
   {"_new_using_filename", (PyCFunction)(void(*)(void))THPStorage_(pyNewFilenameStorage), METH_VARARGS | METH_STATIC, nullptr},
+#ifndef _WIN32
+  {"_share_arena_", (PyCFunction)THPStorage_(shareArena), METH_NOARGS, nullptr},
+  {"_new_shared_arena", (PyCFunction)(void(*)(void))THPStorage_(newSharedArena), METH_VARARGS | METH_STATIC, nullptr},
+  {"_new_using_arena", (PyCFunction)(void(*)(void))THPStorage_(pyNewArenaStorage), METH_VARARGS | METH_STATIC, nullptr},
+#endif
 #endif
   {"_weak_ref", (PyCFunction)THPStorage_(weakRef), METH_NOARGS, nullptr},
   {"_free_weak_ref", (PyCFunction)(void(*)(void))THPStorage_(freeWeakRef), METH_O | METH_STATIC, nullptr},
@@ -31,6 +31,16 @@ struct TORCH_API Method {
       std::vector<c10::IValue> stack,
       const Kwargs& kwargs = Kwargs());
 
+  // Run method asynchronously. Invocation of this method returns as soon as
+  // the interpreter suspends on a wait() (e.g. for an RPC future or a forked
+  // subtask), without blocking the calling thread. taskLauncher runs the
+  // continuation once the awaited future completes, and runs forked
+  // subtasks.
+  c10::intrusive_ptr<c10::ivalue::Future> run_async(
+      std::vector<c10::IValue> stack,
+      const Kwargs& kwargs = Kwargs(),
+      TaskLauncher taskLauncher = at::launch);
+
   std::shared_ptr<Graph> graph() const {
     return function_->graph();
   }
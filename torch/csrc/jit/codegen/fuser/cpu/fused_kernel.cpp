@@ -3,10 +3,12 @@
 #include <c10/util/Optional.h>
 #include <torch/csrc/jit/codegen/fuser/compiler.h>
 #include <torch/csrc/jit/codegen/fuser/cpu/temp_file.h>
+#include <torch/csrc/jit/codegen/fuser/kernel_disk_cache.h>
 #include <torch/csrc/jit/frontend/code_template.h>
 #include <torch/csrc/utils/memory.h>
 
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -269,6 +271,18 @@ static void runCompiler(
   TORCH_CHECK(r == 0, "Failed to compile a fused CPU kernel");
 }
 
+// The key of a kernel in the disk cache: its code and the command that
+// compiles it, which names the compiler and its flags.
+static std::string diskCacheKey(const std::string& code) {
+  auto& config = getConfig();
+  TemplateEnv env;
+  env.s("cxx", config.cxx);
+  env.s("fopenmp", config.openmp ? config.openmp_flags : "");
+  env.s("cpp_file", "<cpp_file>");
+  env.s("so_file", "<so_file>");
+  return format(compile_string, env) + "\n" + code;
+}
+
 #ifdef _MSC_VER
 static const std::string disas_string =
     "dumpbin /DISASM:NOBYTES \"${so_file}\"";
@@ -299,18 +313,28 @@ FusedKernelCPU::FusedKernelCPU(
           std::move(chunk_desc),
           std::move(concat_desc),
           has_random) {
-  TempFile so_file(so_template, so_suffix_len);
-  TempFile cpp_file(cpp_template, cpp_suffix_len);
-  cpp_file.write(code_);
-  cpp_file.sync();
+  if (auto cached_so = findCachedKernel(diskCacheKey(code_), "so")) {
+    so_lib = make_unique<at::DynamicLibrary>(cached_so->c_str());
+  } else {
+    TempFile so_file(so_template, so_suffix_len);
+    TempFile cpp_file(cpp_template, cpp_suffix_len);
+    cpp_file.write(code_);
+    cpp_file.sync();
 #ifdef _MSC_VER
-  so_file.close();
-  cpp_file.close();
+    so_file.close();
+    cpp_file.close();
 #endif
-  runCompiler(cpp_file.name(), so_file.name());
-  if (debugFuser() >= 2)
-    disas(so_file.name());
-  so_lib = make_unique<at::DynamicLibrary>(so_file.name().c_str());
+    runCompiler(cpp_file.name(), so_file.name());
+    if (debugFuser() >= 2)
+      disas(so_file.name());
+    so_lib = make_unique<at::DynamicLibrary>(so_file.name().c_str());
+    if (kernelDiskCacheEnabled()) {
+      std::ifstream so(so_file.name(), std::ios::in | std::ios::binary);
+      std::ostringstream so_data;
+      so_data << so.rdbuf();
+      storeCachedKernel(diskCacheKey(code_), "so", so_data.str());
+    }
+  }
 #pragma GCC diagnostic ignored "-Wpedantic"
   kernel =
       reinterpret_cast<void (*)(uint32_t, void**)>(so_lib->sym(name_.c_str()));
@@ -10,6 +10,8 @@
 #include <torch/csrc/jit/codegen/fuser/kernel_cache.h>
 #include <torch/csrc/jit/codegen/fuser/kernel_spec.h>
 #include <torch/csrc/jit/codegen/fuser/tensor_info.h>
+#include <torch/csrc/jit/passes/shape_analysis.h>
+#include <torch/csrc/jit/tensorexpr/kernel.h>
 
 #include <algorithm>
 #include <iostream> // TODO: remove, debugging only
@@ -323,6 +325,53 @@ void launchFusion(
   }
 }
 
+#ifdef TORCH_ENABLE_LLVM
+// On CPU, fusion groups are compiled in-process by the tensorexpr LLVM backend,
+// which vectorizes the inner loops, instead of generating C++ source and
+// invoking the system compiler. Concats and random number generation are
+// specific to the legacy code generator, so those kernels still use it.
+static bool canUseTensorExprKernel(const KernelSpec& spec) {
+  if (spec.hasRandom())
+    return false;
+  for (const Node* n : spec.graph()->nodes()) {
+    if (n->kind() == prim::FusedConcat)
+      return false;
+  }
+  return true;
+}
+
+static std::shared_ptr<tensorexpr::TensorExprKernel> compileTensorExprKernel(
+    const KernelSpec& spec,
+    at::TensorList inputs) {
+  auto graph = spec.graph()->copy();
+  for (size_t i = 0; i < inputs.size(); i++) {
+    const auto& t = inputs[i];
+    // Sizes are left symbolic so the kernel serves every input matching the
+    // ArgSpec; the stride order and contiguity let contiguous inputs be read
+    // with unit strides. The kernel checks both before each run and falls
+    // back to the interpreter if they don't hold.
+    const auto type = TensorType::create(t);
+    const size_t rank = t.dim();
+    std::vector<c10::optional<c10::Stride>> strides;
+    for (size_t d = 0; d < rank; d++) {
+      c10::optional<c10::Stride> s = type->stride_properties()[d];
+      if (s) {
+        s->stride_ = c10::nullopt;
+      }
+      strides.push_back(s);
+    }
+    graph->inputs()[i]->setType(TensorType::create(
+        t.scalar_type(),
+        t.device(),
+        c10::VaryingShape<c10::ShapeSymbol>(rank),
+        c10::VaryingShape<c10::Stride>(strides),
+        false));
+  }
+  PropagateInputShapes(graph);
+  return std::make_shared<tensorexpr::TensorExprKernel>(graph);
+}
+#endif
+
 bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
   // Short-circuits if fusion isn't enabled
   if (!canFuseOnCPU() && !canFuseOnGPU())
@@ -378,6 +427,34 @@ bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
 
   // Retrieves the kernel, compiling (and caching) if necessary
   ArgSpec arg_spec{inputs, device.index()};
+
+#ifdef TORCH_ENABLE_LLVM
+  if (device.is_cpu() && !code_out && canUseTensorExprKernel(spec)) {
+    auto maybe_te_kernel = spec.findTensorExprKernel(arg_spec);
+    if (!maybe_te_kernel) {
+      spec.cacheTensorExprKernel(
+          arg_spec, compileTensorExprKernel(spec, inputs));
+      maybe_te_kernel = spec.findTensorExprKernel(arg_spec);
+    }
+    AT_ASSERT(maybe_te_kernel);
+
+    // The kernel consumes the expanded tensor inputs followed by the scalars
+    Stack kernel_stack(inputs.begin(), inputs.end());
+    kernel_stack.insert(
+        kernel_stack.end(),
+        all_inputs.begin() + spec.nTensorInputs(),
+        all_inputs.end());
+    (*maybe_te_kernel)->run(kernel_stack);
+
+    drop(stack, spec.nInputs());
+    stack.insert(
+        stack.end(),
+        std::make_move_iterator(kernel_stack.begin()),
+        std::make_move_iterator(kernel_stack.end()));
+    return true;
+  }
+#endif
+
   auto maybe_kernel = spec.findKernel(arg_spec);
   if (!maybe_kernel) {
     const auto kernel = compileKernel(spec, arg_spec, *maybe_map_size, device);
@@ -0,0 +1,177 @@
+#include <torch/csrc/jit/codegen/fuser/kernel_disk_cache.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+namespace {
+
+#ifndef _WIN32
+bool isDirectory(const std::string& path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+// Creates DIR and its missing parents.
+bool makeDirectories(const std::string& dir) {
+  size_t pos = 0;
+  do {
+    pos = dir.find('/', pos + 1);
+    std::string prefix = dir.substr(0, pos);
+    if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) {
+      return false;
+    }
+  } while (pos != std::string::npos);
+  return isDirectory(dir);
+}
+#endif
+
+c10::optional<std::string> cacheDirectory() {
+#ifdef _WIN32
+  return c10::nullopt;
+#else
+  static const c10::optional<std::string> dir =
+      []() -> c10::optional<std::string> {
+    const char* use_cache = std::getenv("USE_PYTORCH_KERNEL_CACHE");
+    if (use_cache && std::string(use_cache) == "0") {
+      return c10::nullopt;
+    }
+    std::string path;
+    if (const char* cache_path = std::getenv("PYTORCH_KERNEL_CACHE_PATH")) {
+      path = cache_path;
+    } else if (const char* xdg_cache = std::getenv("XDG_CACHE_HOME")) {
+      path = std::string(xdg_cache) + "/torch/kernels";
+    } else if (const char* home = std::getenv("HOME")) {
+      path = std::string(home) + "/.cache/torch/kernels";
+    }
+    if (path.empty() || !makeDirectories(path)) {
+      return c10::nullopt;
+    }
+    return path;
+  }();
+  return dir;
+#endif
+}
+
+// 64-bit FNV-1a, which unlike std::hash gives the same value in every build.
+uint64_t hashKey(const std::string& key) {
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : key) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+// The path of the files of the entry for KEY, without their extension.
+std::string entryPath(const std::string& dir, const std::string& key) {
+  std::ostringstream path;
+  path << dir << "/" << std::hex << std::setw(16) << std::setfill('0')
+       << hashKey(key);
+  return path.str();
+}
+
+c10::optional<std::string> readFile(const std::string& path) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file) {
+    return c10::nullopt;
+  }
+  std::ostringstream data;
+  data << file.rdbuf();
+  if (file.bad()) {
+    return c10::nullopt;
+  }
+  return data.str();
+}
+
+// Writes a temporary file and renames it to PATH, so that other processes
+// never read a partially written file.
+bool writeFile(const std::string& path, const std::string& data) {
+#ifdef _WIN32
+  return false;
+#else
+  std::string tmp_path = path + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream file(
+        tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(data.data(), data.size());
+    file.close();
+    if (!file) {
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+#endif
+}
+
+} // namespace
+
+bool kernelDiskCacheEnabled() {
+  return cacheDirectory().has_value();
+}
+
+c10::optional<std::string> findCachedKernel(
+    const std::string& key,
+    const std::string& suffix) {
+  auto dir = cacheDirectory();
+  if (!dir) {
+    return c10::nullopt;
+  }
+  std::string entry = entryPath(*dir, key);
+  auto stored_key = readFile(entry + ".key");
+  if (!stored_key || *stored_key != key) {
+    return c10::nullopt;
+  }
+  std::string path = entry + "." + suffix;
+  if (!std::ifstream(path)) {
+    return c10::nullopt;
+  }
+  return path;
+}
+
+c10::optional<std::string> loadCachedKernel(
+    const std::string& key,
+    const std::string& suffix) {
+  auto path = findCachedKernel(key, suffix);
+  if (!path) {
+    return c10::nullopt;
+  }
+  return readFile(*path);
+}
+
+void storeCachedKernel(
+    const std::string& key,
+    const std::string& suffix,
+    const std::string& data) {
+  auto dir = cacheDirectory();
+  if (!dir) {
+    return;
+  }
+  // The key is written last, so that a matching key means a complete entry.
+  std::string entry = entryPath(*dir, key);
+  if (writeFile(entry + "." + suffix, data)) {
+    writeFile(entry + ".key", key);
+  }
+}
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <c10/util/Optional.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <string>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+// An on-disk cache of compiled kernels, shared by processes so that they
+// don't compile the same kernels again at startup.
+//
+// Entries are keyed by a string that determines the compiled code, e.g., the
+// source code, the compiler version and flags, and the target device. The
+// files of an entry are named after a hash of its key, and the key itself is
+// stored and compared on lookup to guard against collisions.
+//
+// The cache lives in $PYTORCH_KERNEL_CACHE_PATH, or else in
+// $XDG_CACHE_HOME/torch/kernels or ~/.cache/torch/kernels. Setting
+// USE_PYTORCH_KERNEL_CACHE=0 disables it, and it is always disabled on
+// Windows. Failures to read or write the cache are ignored, so that kernels
+// are compiled as if it didn't exist.
+
+// Whether the cache is enabled and its directory could be created.
+TORCH_API bool kernelDiskCacheEnabled();
+
+// Returns the path of the file holding the compiled kernel for KEY, if the
+// cache has one. SUFFIX is the file extension of the kernel, e.g., "so".
+TORCH_API c10::optional<std::string> findCachedKernel(
+    const std::string& key,
+    const std::string& suffix);
+
+// Returns the compiled kernel for KEY, if the cache has one.
+TORCH_API c10::optional<std::string> loadCachedKernel(
+    const std::string& key,
+    const std::string& suffix);
+
+// Stores the compiled kernel for KEY.
+TORCH_API void storeCachedKernel(
+    const std::string& key,
+    const std::string& suffix,
+    const std::string& data);
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
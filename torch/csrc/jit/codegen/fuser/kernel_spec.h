@@ -18,6 +18,9 @@
 
 namespace torch {
 namespace jit {
+namespace tensorexpr {
+class TensorExprKernel;
+} // namespace tensorexpr
 namespace fuser {
 
 // Helper struct containing partition information: the number of tensors
@@ -128,6 +131,22 @@ struct TORCH_API KernelSpec {
     kernels_.emplace(arg_spec, kernel);
   }
 
+  // CPU kernels compiled by the tensorexpr backend, see executor.cpp
+  c10::optional<std::shared_ptr<tensorexpr::TensorExprKernel>>
+  findTensorExprKernel(const ArgSpec& arg_spec) const {
+    std::lock_guard<std::mutex> guard{mutex_};
+    const auto it = te_kernels_.find(arg_spec);
+    if (it == te_kernels_.end())
+      return c10::nullopt;
+    return it->second;
+  }
+  void cacheTensorExprKernel(
+      const ArgSpec& arg_spec,
+      std::shared_ptr<tensorexpr::TensorExprKernel> kernel) const {
+    std::lock_guard<std::mutex> guard{mutex_};
+    te_kernels_.emplace(arg_spec, kernel);
+  }
+
  private:
   int64_t key_;
   std::shared_ptr<Graph> graph_;
@@ -141,6 +160,11 @@ struct TORCH_API KernelSpec {
   mutable std::
       unordered_map<ArgSpec, std::shared_ptr<FusedKernel>, torch::hash<ArgSpec>>
           kernels_;
+  mutable std::unordered_map<
+      ArgSpec,
+      std::shared_ptr<tensorexpr::TensorExprKernel>,
+      torch::hash<ArgSpec>>
+      te_kernels_;
 };
 
 } // namespace fuser
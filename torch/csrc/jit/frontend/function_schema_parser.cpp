@@ -311,5 +311,14 @@ C10_EXPORT OperatorName parseName(const std::string& name) {
   return parsed.left();
 }
 
+C10_EXPORT OperatorName parseSchemaName(const std::string& schema) {
+  SchemaParser parser(schema);
+  OperatorName name = parser.parseName();
+  TORCH_CHECK(
+      parser.L.cur().kind == '(',
+      "Tried to parse a function schema but only the operator name was given");
+  return name;
+}
+
 } // namespace jit
 } // namespace torch
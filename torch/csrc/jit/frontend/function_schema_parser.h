@@ -12,6 +12,9 @@ CAFFE2_API c10::either<c10::OperatorName, c10::FunctionSchema> parseSchemaOrName
     const std::string& schemaOrName);
 CAFFE2_API c10::FunctionSchema parseSchema(const std::string& schema);
 CAFFE2_API c10::OperatorName parseName(const std::string& name);
+// Parses only the operator name of a function schema; the argument list is
+// not checked, so this is much cheaper than parseSchema(schema).
+CAFFE2_API c10::OperatorName parseSchemaName(const std::string& schema);
 
 } // namespace jit
 } // namespace torch
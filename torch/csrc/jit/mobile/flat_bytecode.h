@@ -0,0 +1,90 @@
+#pragma once
+
+#include <torch/csrc/jit/runtime/instruction.h>
+
+#include <cstdint>
+#include <type_traits>
+
+// The layout of bytecode.bin, a flat form of the methods in bytecode.pkl that
+// the mobile loader reads in place instead of unpickling.
+//
+// The record starts with a FlatHeader. Every other part is found by its
+// offset in bytes from the start of the record, and is aligned to 8 bytes:
+//
+//  - FlatFunction[num_functions] at functions_offset;
+//  - for each function, its Instruction array, FlatOperator array,
+//    FlatConstant array and the string indices of its types;
+//  - the string table: uint64_t[num_strings] offsets at strings_offset, each
+//    to a uint32_t size followed by that many bytes.
+//
+// Constants that aren't None, bool, int, float or str (tensors, tuples,
+// lists, ...) are pickled, in order, as one tuple in bytecode_constants.pkl,
+// and referenced from FlatConstant by index into it.
+//
+// The record is written in the byte order of the exporting machine; loading
+// checks byte_order and falls back to bytecode.pkl if it doesn't match.
+
+namespace torch {
+namespace jit {
+namespace mobile {
+namespace flat {
+
+constexpr char kMagic[8] = {'P', 'T', 'M', 'B', 'C', 'O', 'D', 'E'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kByteOrder = 0x01020304;
+
+struct FlatHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t num_functions;
+  uint32_t num_strings;
+  uint64_t functions_offset;
+  uint64_t strings_offset;
+};
+
+struct FlatFunction {
+  uint32_t name;
+  uint32_t register_size;
+  uint32_t num_instructions;
+  uint32_t num_operators;
+  uint32_t num_constants;
+  uint32_t num_types;
+  uint64_t instructions_offset;
+  uint64_t operators_offset;
+  uint64_t constants_offset;
+  uint64_t types_offset;
+};
+
+struct FlatOperator {
+  uint32_t name;
+  uint32_t overload_name;
+};
+
+enum class ConstantTag : uint32_t {
+  None = 0,
+  Bool = 1,
+  Int = 2,
+  Double = 3,
+  String = 4, // index is into the string table
+  Pickled = 5, // index is into bytecode_constants.pkl
+};
+
+struct FlatConstant {
+  ConstantTag tag;
+  uint32_t index;
+  // The bool or int value, or the bits of the double.
+  int64_t payload;
+};
+
+static_assert(sizeof(FlatHeader) == 40, "FlatHeader must not be padded");
+static_assert(sizeof(FlatFunction) == 56, "FlatFunction must not be padded");
+static_assert(sizeof(FlatConstant) == 16, "FlatConstant must not be padded");
+static_assert(
+    sizeof(Instruction) == 8 && std::is_trivially_copyable<Instruction>::value,
+    "Instructions are stored as they are laid out in memory");
+
+} // namespace flat
+} // namespace mobile
+} // namespace jit
+} // namespace torch
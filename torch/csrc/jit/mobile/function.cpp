@@ -1,4 +1,5 @@
 #include <torch/csrc/jit/mobile/function.h>
+#include <ATen/Functions.h>
 #include <torch/csrc/jit/mobile/interpreter.h>
 #include <torch/csrc/jit/runtime/instruction.h>
 #include <torch/csrc/jit/runtime/operator.h>
@@ -11,6 +12,75 @@ namespace jit {
 
 char const* toString(OpCode op);
 namespace mobile {
+namespace {
+
+c10::optional<at::Tensor> toOptionalTensor(const IValue& v) {
+  return v.isNone() ? c10::nullopt : c10::optional<at::Tensor>(v.toTensor());
+}
+
+// Kernels for common ops that take their arguments off the stack and call
+// the ATen function directly, without boxing them for the dispatcher, which
+// shows on models of many small ops.
+using UnboxedOperation = void (*)(Stack&);
+const std::unordered_map<c10::OperatorName, UnboxedOperation>&
+unboxedOperations() {
+  static const std::unordered_map<c10::OperatorName, UnboxedOperation> ops = {
+      {{"aten::add", "Tensor"},
+       [](Stack& stack) {
+         auto alpha = pop(stack).toScalar();
+         auto other = pop(stack).toTensor();
+         auto self = pop(stack).toTensor();
+         push(stack, at::add(self, other, alpha));
+       }},
+      {{"aten::sub", "Tensor"},
+       [](Stack& stack) {
+         auto alpha = pop(stack).toScalar();
+         auto other = pop(stack).toTensor();
+         auto self = pop(stack).toTensor();
+         push(stack, at::sub(self, other, alpha));
+       }},
+      {{"aten::mul", "Tensor"},
+       [](Stack& stack) {
+         auto other = pop(stack).toTensor();
+         auto self = pop(stack).toTensor();
+         push(stack, at::mul(self, other));
+       }},
+      {{"aten::relu", ""},
+       [](Stack& stack) { push(stack, at::relu(pop(stack).toTensor())); }},
+      {{"aten::sigmoid", ""},
+       [](Stack& stack) { push(stack, at::sigmoid(pop(stack).toTensor())); }},
+      {{"aten::tanh", ""},
+       [](Stack& stack) { push(stack, at::tanh(pop(stack).toTensor())); }},
+      {{"aten::addmm", ""},
+       [](Stack& stack) {
+         auto alpha = pop(stack).toScalar();
+         auto beta = pop(stack).toScalar();
+         auto mat2 = pop(stack).toTensor();
+         auto mat1 = pop(stack).toTensor();
+         auto self = pop(stack).toTensor();
+         push(stack, at::addmm(self, mat1, mat2, beta, alpha));
+       }},
+      {{"aten::linear", ""},
+       [](Stack& stack) {
+         auto bias = toOptionalTensor(pop(stack));
+         auto weight = pop(stack).toTensor();
+         auto input = pop(stack).toTensor();
+         push(
+             stack,
+             at::linear(input, weight, bias ? *bias : at::Tensor()));
+       }},
+      {{"aten::matmul", ""},
+       [](Stack& stack) {
+         auto other = pop(stack).toTensor();
+         auto self = pop(stack).toTensor();
+         push(stack, at::matmul(self, other));
+       }},
+  };
+  return ops;
+}
+
+} // namespace
+
 Function::Function(c10::QualifiedName name)
     : name_(name), code_(std::make_shared<Code>()) {}
 
@@ -22,6 +92,17 @@ void Function::append_instruction(OpCode op, int X, int N) {
   code_->instructions_.emplace_back(op, X, N);
 }
 
+void Function::append_instructions(const Instruction* instructions, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    TORCH_CHECK(
+        isOpSupportedInMobile(instructions[i].op),
+        toString(instructions[i].op),
+        " is not supported in mobile module.");
+  }
+  code_->instructions_.insert(
+      code_->instructions_.end(), instructions, instructions + n);
+}
+
 bool Function::append_operator(
     const std::string& name,
     const std::string& overload_name) {
@@ -33,7 +114,13 @@ bool Function::append_operator(
   std::function<void(Stack&)> fn;
 
   auto jit_op = findOperatorFor(opname);
-  if (jit_op) {
+  auto unboxed = unboxedOperations().find(opname);
+  if (unboxed != unboxedOperations().end() &&
+      (jit_op ||
+       c10::Dispatcher::singleton().findSchema(opname_c10).has_value())) {
+    // Only for ops this build has, so that missing ones still fail here.
+    fn = unboxed->second;
+  } else if (jit_op) {
     fn = [jit_op](Stack& stack) { jit_op->getOperation()(stack); };
   } else {
     auto op = c10::Dispatcher::singleton().findSchema(opname_c10);
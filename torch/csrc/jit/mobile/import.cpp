@@ -1,13 +1,16 @@
 #include <torch/csrc/jit/mobile/import.h>
 #include <ATen/core/ivalue.h>
 #include <caffe2/serialize/inline_container.h>
+#include <caffe2/serialize/mmap_file_adapter.h>
 #include <torch/csrc/jit/api/compilation_unit.h>
+#include <torch/csrc/jit/mobile/flat_bytecode.h>
 #include <torch/csrc/jit/mobile/type_parser.h>
 #include <torch/csrc/jit/runtime/instruction.h>
 #include <torch/csrc/jit/serialization/import_export_constants.h>
 #include <torch/csrc/jit/serialization/unpickler.h>
 #include <torch/custom_class.h>
 
+#include <cstring>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -30,6 +33,10 @@
 //     ('constants', (1, 4)),
 //     ('register_size', 2))),)
 
+// Models exported with this version also have bytecode.bin, the same methods
+// in the flat layout of mobile/flat_bytecode.h, which is read in place instead
+// and preferred when present.
+
 // Note that currently the backward compatibility is not supported by bytecode.
 // This format and process need to be revisted and redesigned if we want to
 // support backward compatibility in future.
@@ -42,6 +49,7 @@ TypePtr parseType(const std::string& pythonStr);
 namespace torch {
 namespace jit {
 using caffe2::serialize::IStreamAdapter;
+using caffe2::serialize::MmapFileAdapter;
 using caffe2::serialize::PyTorchStreamReader;
 using caffe2::serialize::ReadAdapterInterface;
 
@@ -152,6 +160,157 @@ void parseMethods(
   }
 }
 
+// A view of a bytecode.bin record that checks the bounds of what it reads.
+class FlatBytecode {
+ public:
+  FlatBytecode(const char* data, size_t size) : data_(data), size_(size) {
+    header_ = at<mobile::flat::FlatHeader>(0, 1);
+    TORCH_CHECK(
+        std::memcmp(
+            header_->magic,
+            mobile::flat::kMagic,
+            sizeof(mobile::flat::kMagic)) == 0,
+        "bytecode.bin is not a mobile bytecode record");
+  }
+
+  bool hasNativeByteOrder() const {
+    return header_->byte_order == mobile::flat::kByteOrder;
+  }
+
+  const mobile::flat::FlatHeader& header() const {
+    return *header_;
+  }
+
+  template <typename T>
+  const T* at(uint64_t offset, size_t n) const {
+    TORCH_CHECK(
+        offset % alignof(T) == 0 && offset <= size_ &&
+            n <= (size_ - offset) / sizeof(T),
+        "bytecode.bin is corrupt: ",
+        n,
+        " entries at offset ",
+        offset,
+        " are out of bounds of its ",
+        size_,
+        " bytes");
+    return reinterpret_cast<const T*>(data_ + offset);
+  }
+
+  std::string string(uint32_t index) const {
+    TORCH_CHECK(
+        index < header_->num_strings,
+        "bytecode.bin is corrupt: string ",
+        index,
+        " is out of bounds");
+    uint64_t offset =
+        at<uint64_t>(header_->strings_offset, header_->num_strings)[index];
+    uint32_t size = *at<uint32_t>(offset, 1);
+    return std::string(at<char>(offset + sizeof(uint32_t), size), size);
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+  const mobile::flat::FlatHeader* header_;
+};
+
+// Like parseMethods, for the methods in bytecode.bin. Instructions are copied
+// as they are, and only the strings of names and types are materialized.
+void parseFlatMethods(
+    const FlatBytecode& bytecode,
+    const std::vector<IValue>& pickled_constants,
+    mobile::CompilationUnit& mcu) {
+  using namespace mobile::flat;
+  const FlatHeader& header = bytecode.header();
+  TORCH_CHECK(
+      header.version == kVersion,
+      "Unsupported bytecode.bin version ",
+      header.version);
+  const FlatFunction* functions =
+      bytecode.at<FlatFunction>(header.functions_offset, header.num_functions);
+  // Functions share most of their types, so parse each one once.
+  std::unordered_map<uint32_t, TypePtr> types;
+  for (size_t i = 0; i < header.num_functions; ++i) {
+    const FlatFunction& f = functions[i];
+    auto function = std::unique_ptr<mobile::Function>(
+        new mobile::Function(c10::QualifiedName(bytecode.string(f.name))));
+
+    function->append_instructions(
+        bytecode.at<Instruction>(f.instructions_offset, f.num_instructions),
+        f.num_instructions);
+
+    std::unordered_set<std::string> unsupported_op_names;
+    const FlatOperator* operators =
+        bytecode.at<FlatOperator>(f.operators_offset, f.num_operators);
+    for (size_t j = 0; j < f.num_operators; ++j) {
+      auto name = bytecode.string(operators[j].name);
+      auto overload_name = bytecode.string(operators[j].overload_name);
+      if (!function->append_operator(name, overload_name)) {
+        unsupported_op_names.emplace(operator_str(name, overload_name));
+      }
+    }
+    if (!unsupported_op_names.empty()) {
+      print_unsupported_ops_and_throw(unsupported_op_names);
+    }
+
+    const FlatConstant* constants =
+        bytecode.at<FlatConstant>(f.constants_offset, f.num_constants);
+    for (size_t j = 0; j < f.num_constants; ++j) {
+      const FlatConstant& constant = constants[j];
+      switch (constant.tag) {
+        case ConstantTag::None:
+          function->append_constant(IValue());
+          break;
+        case ConstantTag::Bool:
+          function->append_constant(static_cast<bool>(constant.payload));
+          break;
+        case ConstantTag::Int:
+          function->append_constant(constant.payload);
+          break;
+        case ConstantTag::Double: {
+          double value;
+          std::memcpy(&value, &constant.payload, sizeof(value));
+          function->append_constant(value);
+        } break;
+        case ConstantTag::String:
+          function->append_constant(bytecode.string(constant.index));
+          break;
+        case ConstantTag::Pickled:
+          TORCH_CHECK(
+              constant.index < pickled_constants.size(),
+              "bytecode.bin is corrupt: constant ",
+              constant.index,
+              " is not in bytecode_constants.pkl");
+          function->append_constant(pickled_constants[constant.index]);
+          break;
+        default:
+          TORCH_CHECK(
+              false,
+              "bytecode.bin is corrupt: unknown constant tag ",
+              static_cast<uint32_t>(constant.tag));
+      }
+    }
+
+    const uint32_t* type_names =
+        bytecode.at<uint32_t>(f.types_offset, f.num_types);
+    for (size_t j = 0; j < f.num_types; ++j) {
+      auto it = types.find(type_names[j]);
+      if (it == types.end()) {
+        it = types
+                 .emplace(
+                     type_names[j],
+                     c10::parseType(bytecode.string(type_names[j])))
+                 .first;
+      }
+      function->append_type(it->second);
+    }
+
+    function->set_register_size(f.register_size);
+
+    mcu.register_function(std::move(function));
+  }
+}
+
 // The deserializer class which loads the bytecode package from bc files.
 class BytecodeDeserializer final {
  public:
@@ -177,8 +336,27 @@ mobile::Module BytecodeDeserializer::deserialize(
     c10::optional<at::Device> device) {
   device_ = device;
   auto mcu = std::make_shared<mobile::CompilationUnit>();
-  auto bvals = readArchive("bytecode", mcu).toTuple()->elements();
-  parseMethods(bvals, *mcu);
+  bool parsed = false;
+  if (reader_->hasRecord("bytecode.bin")) {
+    at::DataPtr bytecode_ptr;
+    size_t bytecode_size;
+    std::tie(bytecode_ptr, bytecode_size) = reader_->getRecord("bytecode.bin");
+    FlatBytecode bytecode(
+        static_cast<const char*>(bytecode_ptr.get()), bytecode_size);
+    if (bytecode.hasNativeByteOrder()) {
+      std::vector<IValue> pickled_constants;
+      if (reader_->hasRecord("bytecode_constants.pkl")) {
+        pickled_constants =
+            readArchive("bytecode_constants", mcu).toTuple()->elements();
+      }
+      parseFlatMethods(bytecode, pickled_constants, *mcu);
+      parsed = true;
+    }
+  }
+  if (!parsed) {
+    auto bvals = readArchive("bytecode", mcu).toTuple()->elements();
+    parseMethods(bvals, *mcu);
+  }
 
   return mobile::Module(readArchive("data", mcu).toObject(), mcu);
 }
@@ -289,7 +467,9 @@ mobile::Module _load_for_mobile(
 mobile::Module _load_for_mobile(
     const std::string& filename,
     c10::optional<at::Device> device) {
-  std::unique_ptr<FileAdapter> rai = std::make_unique<FileAdapter>(filename);
+  // Mapping the file lets bytecode.bin and the tensor data be used in place.
+  std::unique_ptr<MmapFileAdapter> rai =
+      std::make_unique<MmapFileAdapter>(filename);
   auto module = _load_for_mobile(std::move(rai), device);
   return module;
 }
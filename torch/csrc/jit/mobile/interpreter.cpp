@@ -22,180 +22,239 @@ InterpreterState::InterpreterState(std::shared_ptr<Code> code)
 
 using namespace at;
 
+// Each instruction jumps straight to the handler of the next one through a
+// table of label addresses where the compiler supports computed gotos, rather
+// than back to the top of a switch, which gives every handler its own
+// (better predicted) indirect branch.
+#if defined(__GNUC__) || defined(__clang__)
+#define MOBILE_INTERPRETER_COMPUTED_GOTO
+#endif
+
+#ifdef MOBILE_INTERPRETER_COMPUTED_GOTO
+#define INST(name) L_##name
+#define DISPATCH()                  \
+  do {                              \
+    inst = &instructions[pc];       \
+    goto* dispatch_table[inst->op]; \
+  } while (0)
+#else
+#define INST(name) case name
+#define DISPATCH() continue
+#endif
+
 bool InterpreterState::run(Stack& stack) {
+  // Reserve the stack this code needed on earlier runs.
+  size_t base_capacity = stack.size();
+  stack.reserve(base_capacity + code_->stack_size_hint_.load());
+  const Instruction* instructions = code_->instructions_.data();
+  const Instruction* inst = nullptr;
   size_t pc = 0;
+#ifdef MOBILE_INTERPRETER_COMPUTED_GOTO
+  static void* const dispatch_table[] = {
+#define DISPATCH_TARGET(op, _) &&L_##op,
+      FORALL_OPCODES(DISPATCH_TARGET)
+#undef DISPATCH_TARGET
+  };
+  DISPATCH();
+#else
   while (true) {
-    Instruction inst = code_->instructions_[pc];
-
-    //    std::cout << "RUNNING " << pc << " " << code_->instructions_[pc];
-    //    if (inst.op == OP) {
-    //      std::cout << ", " << code_->op_names_[inst.X].name;
-    //      if (!code_->op_names_[inst.X].overload_name.empty()) {
-    //        std::cout << "." << code_->op_names_[inst.X].overload_name;
-    //      }
-    //    }
-    //    std::cout << std::endl;
-    switch (inst.op) {
-      case OP: {
+    inst = &instructions[pc];
+    switch (inst->op) {
+#endif
+  INST(OP) : {
 #if defined(PYTORCH_MOBILE_OPERATOR_OBSERVER)
-        if (auto debug_info = c10::ThreadLocalDebugInfo::get(
-                c10::DebugInfoKind::MOBILE_RUNTIME_INFO)) {
-          if (auto* mobile_debug_info =
-                  dynamic_cast<MobileDebugInfo*>(debug_info.get())) {
-            mobile_debug_info->setOpIdx(pc);
-          }
-        }
+    if (auto debug_info = c10::ThreadLocalDebugInfo::get(
+            c10::DebugInfoKind::MOBILE_RUNTIME_INFO)) {
+      if (auto* mobile_debug_info =
+              dynamic_cast<MobileDebugInfo*>(debug_info.get())) {
+        mobile_debug_info->setOpIdx(pc);
+      }
+    }
 #endif
-        // TODO(iliacher): remove the workaround after RecordFunction is in
-        // Dispatcher
-        bool prev_value = isRecordFunctionEnabled();
-        if (!prev_value) {
-          // enable only for the RecordFunction
-          enableRecordFunction(true);
-        }
-        RECORD_FUNCTION(code_->op_names_[inst.X].name, stack);
-        if (!prev_value) {
-          enableRecordFunction(false);
-        }
-        code_->operators_[inst.X](stack);
-        ++pc;
-      } break;
-      case OPN: {
-        stack.push_back(inst.N);
-        code_->operators_[inst.X](stack);
-        ++pc;
-      } break;
-      case INTERFACE_CALL: {
-        torch::jit::Function& method =
-            peek(stack, 0, inst.N)
-                .toObject()
-                ->type()
-                ->getMethod(code_->constants_[inst.X].toStringRef());
-        method.run(stack);
-        ++pc;
-      } break;
-      case LOAD:
-        stack.emplace_back(reg(inst.X));
-        ++pc;
-        break;
-      case MOVE:
-        stack.emplace_back(std::move(reg(inst.X)));
-        ++pc;
-        break;
-      case STORE:
-        reg(inst.X) = pop(stack);
-        ++pc;
-        break;
-      case STOREN:
-        for (size_t i = inst.N; i > 0; --i) {
-          reg(inst.X + i - 1) = pop(stack);
-        }
-        ++pc;
-        break;
-      case DROP:
-        pop(stack);
-        ++pc;
-        break;
-      case DROPR:
-        reg(inst.X) = IValue();
-        ++pc;
-        break;
-      case LOADC:
-        stack.emplace_back(code_->constants_[inst.X]);
-        ++pc;
-        break;
-      case GET_ATTR: {
-        auto userObj = pop(stack).toObject();
-        auto value = userObj->getSlot(inst.X);
-        push(stack, std::move(value));
-        ++pc;
-      } break;
-      case SET_ATTR: {
-        auto v = pop(stack);
-        auto userObj = pop(stack).toObject();
-        // Mobile only: since the number of slots is not known, resize the
-        // numAttributes before setSlot.
-        while (userObj->type()->numAttributes() <= inst.X) {
-          std::stringstream ss;
-          ss << userObj->type()->numAttributes();
-          userObj->type()->addAttribute(ss.str(), c10::NoneType::create());
-        }
-        userObj->setSlot(inst.X, std::move(v));
-        ++pc;
-      } break;
-      case JF:
-        pc += (pop(stack).toBool()) ? 1 : inst.X;
-        break;
-      case JMP:
-        pc += inst.X;
-        break;
-      case LOOP: {
-        // stack: iteration_count, max_iter, cond, loop_carried_deps...
-        auto frame = stack.end() - (inst.N + 1);
-        int64_t trip_count = frame[0].toInt();
-        int64_t max_trip_count = frame[1].toInt();
-        bool cond = frame[2].toBool();
-        if (trip_count < max_trip_count && cond) {
-          frame[2] = trip_count;
-          frame[0] = trip_count + 1;
-          ++pc;
-        } else {
-          size_t n_loop_carried = inst.N - 2;
-          for (size_t i = 0; i < n_loop_carried; ++i) {
-            frame[i] = std::move(frame[i + 3]);
-          }
-          drop(stack, 3); // iteration_count, max_iter, cond
-          pc += inst.X;
-        }
-      } break;
-      case RET:
-        return false;
-      case LIST_CONSTRUCT: {
-        auto type = code_->types_[inst.X]->expect<at::ListType>();
-        listConstruct(stack, type, inst.N);
-        ++pc;
-      } break;
-      case LIST_UNPACK: {
-        listUnpack(stack, inst.X);
-        ++pc;
-      } break;
-      case TUPLE_CONSTRUCT: {
-        tupleConstruct(stack, inst.X);
-        ++pc;
-      } break;
-      case TUPLE_SLICE: {
-        tupleSlice(stack, inst.X, inst.X + inst.N);
-        ++pc;
-      } break;
-      case DICT_CONSTRUCT: {
-        auto type = code_->types_[inst.X]->expect<at::DictType>();
-        dictConstruct(stack, type, inst.N);
-        ++pc;
-      } break;
-      case NAMED_TUPLE_CONSTRUCT: {
-        auto type = code_->types_[inst.X]->expect<at::TupleType>();
-        namedTupleConstruct(stack, type, inst.N);
-        ++pc;
-      } break;
-      case WARN: {
-        drop(stack, 1);
-        TORCH_WARN(pop(stack).toStringRef());
-        ++pc;
-      } break;
-      default:
-        AT_ERROR(toString(inst.op), " is invalid.");
+    // TODO(iliacher): remove the workaround after RecordFunction is in
+    // Dispatcher
+    bool prev_value = isRecordFunctionEnabled();
+    if (!prev_value) {
+      // enable only for the RecordFunction
+      enableRecordFunction(true);
+    }
+    RECORD_FUNCTION(code_->op_names_[inst->X].name, stack);
+    if (!prev_value) {
+      enableRecordFunction(false);
+    }
+    code_->operators_[inst->X](stack);
+    ++pc;
+  }
+    DISPATCH();
+  INST(OPN) : {
+    stack.push_back(inst->N);
+    code_->operators_[inst->X](stack);
+    ++pc;
+  }
+    DISPATCH();
+  INST(INTERFACE_CALL) : {
+    torch::jit::Function& method =
+        peek(stack, 0, inst->N)
+            .toObject()
+            ->type()
+            ->getMethod(code_->constants_[inst->X].toStringRef());
+    method.run(stack);
+    ++pc;
+  }
+    DISPATCH();
+  INST(LOAD) : {
+    stack.emplace_back(reg(inst->X));
+    ++pc;
+  }
+    DISPATCH();
+  INST(MOVE) : {
+    stack.emplace_back(std::move(reg(inst->X)));
+    ++pc;
+  }
+    DISPATCH();
+  INST(STORE) : {
+    reg(inst->X) = pop(stack);
+    ++pc;
+  }
+    DISPATCH();
+  INST(STOREN) : {
+    for (size_t i = inst->N; i > 0; --i) {
+      reg(inst->X + i - 1) = pop(stack);
+    }
+    ++pc;
+  }
+    DISPATCH();
+  INST(DROP) : {
+    pop(stack);
+    ++pc;
+  }
+    DISPATCH();
+  INST(DROPR) : {
+    reg(inst->X) = IValue();
+    ++pc;
+  }
+    DISPATCH();
+  INST(LOADC) : {
+    stack.emplace_back(code_->constants_[inst->X]);
+    ++pc;
+  }
+    DISPATCH();
+  INST(GET_ATTR) : {
+    auto userObj = pop(stack).toObject();
+    auto value = userObj->getSlot(inst->X);
+    push(stack, std::move(value));
+    ++pc;
+  }
+    DISPATCH();
+  INST(SET_ATTR) : {
+    auto v = pop(stack);
+    auto userObj = pop(stack).toObject();
+    // Mobile only: since the number of slots is not known, resize the
+    // numAttributes before setSlot.
+    while (userObj->type()->numAttributes() <= inst->X) {
+      std::stringstream ss;
+      ss << userObj->type()->numAttributes();
+      userObj->type()->addAttribute(ss.str(), c10::NoneType::create());
+    }
+    userObj->setSlot(inst->X, std::move(v));
+    ++pc;
+  }
+    DISPATCH();
+  INST(JF) : {
+    pc += (pop(stack).toBool()) ? 1 : inst->X;
+  }
+    DISPATCH();
+  INST(JMP) : {
+    pc += inst->X;
+  }
+    DISPATCH();
+  INST(LOOP) : {
+    // stack: iteration_count, max_iter, cond, loop_carried_deps...
+    auto frame = stack.end() - (inst->N + 1);
+    int64_t trip_count = frame[0].toInt();
+    int64_t max_trip_count = frame[1].toInt();
+    bool cond = frame[2].toBool();
+    if (trip_count < max_trip_count && cond) {
+      frame[2] = trip_count;
+      frame[0] = trip_count + 1;
+      ++pc;
+    } else {
+      size_t n_loop_carried = inst->N - 2;
+      for (size_t i = 0; i < n_loop_carried; ++i) {
+        frame[i] = std::move(frame[i + 3]);
+      }
+      drop(stack, 3); // iteration_count, max_iter, cond
+      pc += inst->X;
+    }
+  }
+    DISPATCH();
+  INST(RET) : {
+    size_t used = stack.capacity() - base_capacity;
+    if (used > code_->stack_size_hint_.load()) {
+      code_->stack_size_hint_ = used;
     }
-    //  for (auto val : stack) {
-    //    if (val.isTensor()) {
-    //      std::cout << val.toTensor().sizes() << std::endl;
-    //    } else {
-    //      std::cout << val << std::endl;
-    //    }
-    //  }
+    return false;
+  }
+  INST(LIST_CONSTRUCT) : {
+    auto type = code_->types_[inst->X]->expect<at::ListType>();
+    listConstruct(stack, type, inst->N);
+    ++pc;
+  }
+    DISPATCH();
+  INST(LIST_UNPACK) : {
+    listUnpack(stack, inst->X);
+    ++pc;
   }
+    DISPATCH();
+  INST(TUPLE_CONSTRUCT) : {
+    tupleConstruct(stack, inst->X);
+    ++pc;
+  }
+    DISPATCH();
+  INST(TUPLE_SLICE) : {
+    tupleSlice(stack, inst->X, inst->X + inst->N);
+    ++pc;
+  }
+    DISPATCH();
+  INST(DICT_CONSTRUCT) : {
+    auto type = code_->types_[inst->X]->expect<at::DictType>();
+    dictConstruct(stack, type, inst->N);
+    ++pc;
+  }
+    DISPATCH();
+  INST(NAMED_TUPLE_CONSTRUCT) : {
+    auto type = code_->types_[inst->X]->expect<at::TupleType>();
+    namedTupleConstruct(stack, type, inst->N);
+    ++pc;
+  }
+    DISPATCH();
+  INST(WARN) : {
+    drop(stack, 1);
+    TORCH_WARN(pop(stack).toStringRef());
+    ++pc;
+  }
+    DISPATCH();
+  // Rejected by Function::append_instruction.
+  INST(WAIT) :
+  INST(CALL) :
+  INST(GUARD) :
+  INST(FAIL_GUARD) :
+  INST(PROFILE_OP) :
+  INST(TAIL_CALL) :
+  INST(CREATE_OBJECT) :
+  INST(ISINSTANCE) :
+  INST(FORK) :
+    AT_ERROR(toString(inst->op), " is invalid.");
+#ifndef MOBILE_INTERPRETER_COMPUTED_GOTO
+    }
+  }
+#endif
   return false;
 }
 
+#undef INST
+#undef DISPATCH
+
 IValue& InterpreterState::reg(size_t reg) {
   return *(registers_.end() - reg);
 }
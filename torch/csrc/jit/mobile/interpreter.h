@@ -4,6 +4,8 @@
 #include <ATen/core/operator_name.h>
 #include <torch/csrc/jit/runtime/instruction.h>
 
+#include <atomic>
+
 namespace torch {
 namespace jit {
 namespace mobile {
@@ -15,6 +17,9 @@ struct Code {
   std::vector<c10::IValue> constants_;
   std::vector<c10::TypePtr> types_;
   size_t register_size_; // Aggregated output size.
+  // The most stack space a run of this code has used so far, reserved by
+  // later runs up front.
+  std::atomic<size_t> stack_size_hint_{0};
 };
 
 struct InterpreterState {
@@ -106,6 +106,17 @@ bool shape_is_fast_for_reduce(const at::Tensor& lhs, const at::Tensor& rhs) {
   return m < 512 || ((l < 256 && r < 256) || (l > 256 && r > 256));
 }
 
+// Shapes differ, so the products can't be concatenated into a single mm, but
+// _grouped_mm still computes all of them in one call. It only handles dense
+// matrices; anything else falls back to one mm per pair.
+bool can_use_grouped_mm(at::TensorList lhs, at::TensorList rhs) {
+  auto is_strided = [](const at::Tensor& t) {
+    return t.layout() == at::kStrided;
+  };
+  return std::all_of(lhs.begin(), lhs.end(), is_strided) &&
+      std::all_of(rhs.begin(), rhs.end(), is_strided);
+}
+
 RegisterOperators mm_tree_reduction_reg({Operator(
     "prim::MMTreeReduce(...) -> Tensor",
     [](Stack& stack) {
@@ -149,6 +160,13 @@ RegisterOperators mm_tree_reduction_reg({Operator(
           rhs = at::cat(rhs_inputs, /*dim=*/0);
         }
         push(stack, at::mm(lhs, rhs));
+      } else if (can_use_grouped_mm(lhs_inputs, rhs_inputs)) {
+        auto products = at::_grouped_mm(lhs_inputs, rhs_inputs);
+        auto acc = std::move(products[0]);
+        for (size_t i = 1; i < side_num_elems; ++i) {
+          acc.add_(products[i]);
+        }
+        push(stack, std::move(acc));
       } else {
         auto acc = at::mm(inputs[0], inputs[side_num_elems]);
         for (size_t i = 1; i < side_num_elems; ++i) {
@@ -347,6 +365,16 @@ RegisterOperators mm_batch_side_reg({Operator(
               stack.end(),
               std::make_move_iterator(outputs.begin()),
               std::make_move_iterator(outputs.end()));
+        } else if (can_use_grouped_mm({side_input}, other_side_inputs)) {
+          std::vector<at::Tensor> side_inputs(
+              num_other_side_inputs, side_input);
+          auto outputs = single_side == Side::LHS
+              ? at::_grouped_mm(side_inputs, other_side_inputs)
+              : at::_grouped_mm(other_side_inputs, side_inputs);
+          stack.insert(
+              stack.end(),
+              std::make_move_iterator(outputs.begin()),
+              std::make_move_iterator(outputs.end()));
         } else {
           if (single_side == Side::LHS) {
             for (at::Tensor& other : other_side_inputs) {
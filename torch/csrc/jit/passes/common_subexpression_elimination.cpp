@@ -89,6 +89,12 @@ void EliminateCommonSubexpression(
 
 void EliminateCommonSubexpression(const std::shared_ptr<Graph>& graph) {
   AliasDb aliasDb(graph);
+  EliminateCommonSubexpression(graph, aliasDb);
+}
+
+void EliminateCommonSubexpression(
+    const std::shared_ptr<Graph>& graph,
+    const AliasDb& aliasDb) {
   GRAPH_DUMP("Before CSE", graph);
   EliminateCommonSubexpression(
       graph->block(), aliasDb, [](Node*) { return nullptr; });
@@ -5,7 +5,16 @@
 namespace torch {
 namespace jit {
 
+class AliasDb;
+
 TORCH_API void EliminateCommonSubexpression(
     const std::shared_ptr<Graph>& graph);
+
+// Reuses `aliasDb`, which must be up to date with `graph`, instead of building
+// a new one. CSE only removes nodes that have no writers, so `aliasDb` stays
+// usable by later passes over `graph`.
+TORCH_API void EliminateCommonSubexpression(
+    const std::shared_ptr<Graph>& graph,
+    const AliasDb& aliasDb);
 }
 } // namespace torch
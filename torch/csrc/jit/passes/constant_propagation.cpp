@@ -107,6 +107,12 @@ struct ConstantPropagator {
     ConstantPropagation(graph_->block());
   }
 
+  // The alias db the propagation ran with, kept up to date with the constants
+  // it inserted, or null for NoAliasDb.
+  AliasDb* aliasDb() const {
+    return aliasDb_.get();
+  }
+
  private:
   ConstantPropagator(std::shared_ptr<Graph> graph, bool aliasing_types)
       : graph_(std::move(graph)) {
@@ -138,6 +144,9 @@ struct ConstantPropagator {
         if (outputs[i].isNone()) {
           (*new_output)->setType(n->outputs()[i]->type());
         }
+        if (aliasDb_ && AliasDb::isMutableType(*new_output)) {
+          aliasDb_->createValue(*new_output);
+        }
         n->outputs()[i]->replaceAllUsesWith(*new_output);
       }
       // If we cannot insert the IValue as a constant, give up replacing the
@@ -348,7 +357,7 @@ struct ConstantPropagator {
 void ConstantPropagation(std::shared_ptr<Graph>& graph) {
   ConstantPropagator cp = ConstantPropagator::WithAliasDb(graph);
   cp.run();
-  EliminateDeadCode(graph);
+  EliminateDeadCode(graph, cp.aliasDb());
   GRAPH_DUMP("After ConstantPropagation: ", graph);
 }
 
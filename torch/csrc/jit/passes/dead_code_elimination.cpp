@@ -20,7 +20,10 @@ class DeadCodeEliminator {
       std::shared_ptr<Graph> graph,
       DCESideEffectPolicy sideEffectPolicy)
       : sideEffectPolicy_(sideEffectPolicy),
-        aliasDb_(torch::make_unique<AliasDb>(std::move(graph))) {}
+        ownedAliasDb_(torch::make_unique<AliasDb>(std::move(graph))),
+        aliasDb_(ownedAliasDb_.get()) {}
+  DeadCodeEliminator(AliasDb* aliasDb, DCESideEffectPolicy sideEffectPolicy)
+      : sideEffectPolicy_(sideEffectPolicy), aliasDb_(aliasDb) {}
   DeadCodeEliminator(DCESideEffectPolicy sideEffectPolicy)
       : sideEffectPolicy_(sideEffectPolicy) {}
 
@@ -404,7 +407,8 @@ class DeadCodeEliminator {
   }
 
   DCESideEffectPolicy sideEffectPolicy_;
-  std::unique_ptr<AliasDb> aliasDb_ = nullptr;
+  std::unique_ptr<AliasDb> ownedAliasDb_ = nullptr;
+  AliasDb* aliasDb_ = nullptr;
   std::unordered_map<Node*, bool> memo_;
   std::unordered_set<Node*> marked_;
   std::unordered_set<const Value*> liveValues_;
@@ -420,6 +424,19 @@ void EliminateDeadCode(
   GRAPH_DUMP("After EliminateDeadCode: ", graph);
 }
 
+void EliminateDeadCode(
+    const std::shared_ptr<Graph>& graph,
+    AliasDb* aliasDb,
+    DCESideEffectPolicy sideEffectPolicy) {
+  if (!aliasDb) {
+    EliminateDeadCode(graph, sideEffectPolicy);
+    return;
+  }
+  DeadCodeEliminator(aliasDb, sideEffectPolicy)
+      .run(graph->block(), /*recurse=*/true);
+  GRAPH_DUMP("After EliminateDeadCode: ", graph);
+}
+
 void EliminateDeadCode(
     Block* block,
     bool recurse,
@@ -5,6 +5,8 @@
 namespace torch {
 namespace jit {
 
+class AliasDb;
+
 // If given a top-level graph, DCE will construct do alias analysis that allows
 // for "smarter" dead code elimination (we will eliminate mutable ops if we can
 // prove the mutated values are not used). Otherwise, we will not allow DCE to
@@ -26,6 +28,14 @@ TORCH_API void EliminateDeadCode(
     const std::shared_ptr<Graph>& graph,
     DCESideEffectPolicy sideEffectPolicy =
         DCESideEffectPolicy::DONT_DELETE_NODES_WITH_SIDE_EFFECTS);
+// Same as above, but reuses `aliasDb`, which must be up to date with `graph`,
+// instead of building a new one, or builds one if it is null. DCE only removes
+// nodes, so `aliasDb` stays usable by later passes over `graph`.
+TORCH_API void EliminateDeadCode(
+    const std::shared_ptr<Graph>& graph,
+    AliasDb* aliasDb,
+    DCESideEffectPolicy sideEffectPolicy =
+        DCESideEffectPolicy::DONT_DELETE_NODES_WITH_SIDE_EFFECTS);
 TORCH_API void EliminateDeadCode(
     Block* block,
     bool recurse = true,
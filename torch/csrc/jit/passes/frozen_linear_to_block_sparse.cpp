@@ -0,0 +1,92 @@
+#include <torch/csrc/jit/passes/frozen_linear_to_block_sparse.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/jit_log.h>
+
+#include <ATen/ATen.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+const Symbol kBlockSparseLinear = Symbol::aten("_block_sparse_linear");
+
+c10::optional<at::Tensor> constantFloatingTensor(Value* v, int64_t dim) {
+  auto ival = toIValue(v);
+  if (!ival || !ival->isTensor()) {
+    return c10::nullopt;
+  }
+  at::Tensor t = ival->toTensor();
+  if (t.layout() != at::kStrided || !t.is_floating_point() ||
+      t.dim() != dim || t.requires_grad()) {
+    return c10::nullopt;
+  }
+  return t;
+}
+
+void rewriteLinear(
+    Node* n,
+    const std::vector<int64_t>& blocksize,
+    double min_sparsity) {
+  // aten::linear(input, weight, bias)
+  auto weight = constantFloatingTensor(n->input(1), 2);
+  if (!weight || weight->size(0) % blocksize[0] != 0 ||
+      weight->size(1) % blocksize[1] != 0) {
+    return;
+  }
+  auto bias = toIValue(n->input(2));
+  if (!bias || (!bias->isNone() && !constantFloatingTensor(n->input(2), 1))) {
+    return;
+  }
+  at::Tensor crow_indices, col_indices, values;
+  std::tie(crow_indices, col_indices, values) =
+      at::_block_sparse_linear_pack(*weight, blocksize);
+  int64_t num_blocks = weight->numel() / (blocksize[0] * blocksize[1]);
+  if (num_blocks == 0 ||
+      values.size(0) > (1 - min_sparsity) * num_blocks) {
+    return;
+  }
+  GRAPH_UPDATE(
+      "Replacing ",
+      getHeader(n),
+      " with a block-sparse linear keeping ",
+      values.size(0),
+      " of ",
+      num_blocks,
+      " blocks");
+
+  Graph* graph = n->owningGraph();
+  WithInsertPoint guard(n);
+  Value* output = graph->insert(
+      kBlockSparseLinear,
+      {n->input(0),
+       graph->insertConstant(crow_indices),
+       graph->insertConstant(col_indices),
+       graph->insertConstant(values),
+       n->input(2)});
+  output->setType(n->output()->type());
+  n->output()->replaceAllUsesWith(output);
+  n->destroy();
+}
+
+} // namespace
+
+void ConvertFrozenLinearToBlockSparse(
+    std::shared_ptr<Graph>& graph,
+    std::vector<int64_t> blocksize,
+    double min_sparsity) {
+  TORCH_CHECK(
+      blocksize.size() == 2 && blocksize[0] > 0 && blocksize[1] > 0,
+      "Expected two positive block sizes");
+  std::vector<Node*> nodes(graph->nodes().begin(), graph->nodes().end());
+  for (Node* n : nodes) {
+    if (n->matches(
+            "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor")) {
+      rewriteLinear(n, blocksize, min_sparsity);
+    }
+  }
+  GRAPH_DUMP("After ConvertFrozenLinearToBlockSparse: ", graph);
+}
+
+} // namespace jit
+} // namespace torch
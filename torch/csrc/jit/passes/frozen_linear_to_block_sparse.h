@@ -0,0 +1,23 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Run the linear layers of a frozen graph whose weights are mostly
+ * zero blocks on the block-sparse kernels.
+ *
+ * aten::linear calls whose weight and bias are constant tensors, as in the
+ * graph of a frozen module, are rewritten to aten::_block_sparse_linear when
+ * at least min_sparsity of the blocksize blocks of the weight are all zero.
+ * The weight is packed with aten::_block_sparse_linear_pack once, here.
+ * Weights that can't be split into such blocks are left alone.
+ */
+TORCH_API void ConvertFrozenLinearToBlockSparse(
+    std::shared_ptr<Graph>& graph,
+    std::vector<int64_t> blocksize = {8, 1},
+    double min_sparsity = 0.7);
+
+} // namespace jit
+} // namespace torch
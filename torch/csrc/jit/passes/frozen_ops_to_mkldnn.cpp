@@ -0,0 +1,194 @@
+#include <torch/csrc/jit/passes/frozen_ops_to_mkldnn.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+
+#include <ATen/ATen.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+const Symbol kToMKLDNN = Symbol::aten("to_mkldnn");
+const Symbol kToDense = Symbol::aten("to_dense");
+const Symbol kMKLDNNConvolution = Symbol::aten("mkldnn_convolution");
+const Symbol kMKLDNNLinear = Symbol::aten("mkldnn_linear");
+
+c10::optional<at::Tensor> constantFloatCPUTensor(Value* v, int64_t dim) {
+  auto ival = toIValue(v);
+  if (!ival || !ival->isTensor()) {
+    return c10::nullopt;
+  }
+  at::Tensor t = ival->toTensor();
+  if (t.is_mkldnn() || t.scalar_type() != at::kFloat ||
+      !t.device().is_cpu() || t.dim() != dim || t.requires_grad()) {
+    return c10::nullopt;
+  }
+  return t;
+}
+
+bool allConstant(at::ArrayRef<Value*> values) {
+  return std::all_of(values.begin(), values.end(), [](Value* v) {
+    return v->node()->kind() == prim::Constant;
+  });
+}
+
+// Replace N by to_dense(op(to_mkldnn(input), ...)).
+void replaceWithMKLDNN(
+    Node* n,
+    Symbol op,
+    std::vector<Value*> weights,
+    at::ArrayRef<Value*> params) {
+  Graph* graph = n->owningGraph();
+  WithInsertPoint guard(n);
+  Value* input = graph->insert(kToMKLDNN, {n->input(0)});
+  std::vector<NamedValue> args = {input};
+  args.insert(args.end(), weights.begin(), weights.end());
+  args.insert(args.end(), params.begin(), params.end());
+  Value* output = graph->insert(op, args);
+  Value* dense = graph->insert(kToDense, {output});
+  dense->setType(n->output()->type());
+  n->output()->replaceAllUsesWith(dense);
+  n->destroy();
+}
+
+void rewriteConv2d(Node* n) {
+  // aten::conv2d(input, weight, bias, stride, padding, dilation, groups)
+  auto weight = constantFloatCPUTensor(n->input(1), 4);
+  if (!weight || !allConstant(n->inputs().slice(2))) {
+    return;
+  }
+  auto bias = toIValue(n->input(2));
+  if (!bias->isNone() && !constantFloatCPUTensor(n->input(2), 1)) {
+    return;
+  }
+  auto stride = toIValue(n->input(3))->toIntVector();
+  auto padding = toIValue(n->input(4))->toIntVector();
+  auto dilation = toIValue(n->input(5))->toIntVector();
+  int64_t groups = toIValue(n->input(6))->toInt();
+  at::Tensor packed = at::mkldnn_reorder_conv2d_weight(
+      weight->contiguous(), padding, stride, dilation, groups);
+
+  Graph* graph = n->owningGraph();
+  WithInsertPoint guard(n);
+  Value* packed_weight = graph->insertConstant(packed);
+  // mkldnn_convolution takes padding before stride.
+  replaceWithMKLDNN(
+      n,
+      kMKLDNNConvolution,
+      {packed_weight, n->input(2)},
+      {n->input(4), n->input(3), n->input(5), n->input(6)});
+}
+
+void rewriteLinear(Node* n) {
+  // aten::linear(input, weight, bias); mkldnn_linear requires a bias.
+  auto weight = constantFloatCPUTensor(n->input(1), 2);
+  auto bias = constantFloatCPUTensor(n->input(2), 1);
+  if (!weight || !bias) {
+    return;
+  }
+  Graph* graph = n->owningGraph();
+  WithInsertPoint guard(n);
+  Value* packed_weight = graph->insertConstant(weight->to_mkldnn());
+  Value* packed_bias = graph->insertConstant(bias->to_mkldnn());
+  replaceWithMKLDNN(n, kMKLDNNLinear, {packed_weight, packed_bias}, {});
+}
+
+// Ops that take and return MKLDNN tensors, and the number of their leading
+// tensor inputs.
+c10::optional<size_t> mkldnnTensorInputs(Node* n) {
+  if (n->matches("aten::relu(Tensor self) -> Tensor") ||
+      n->matches("aten::sigmoid(Tensor self) -> Tensor") ||
+      n->matches(
+          "aten::max_pool2d(Tensor self, int[2] kernel_size, int[2] stride, int[2] padding, int[2] dilation, bool ceil_mode) -> Tensor") ||
+      n->matches(
+          "aten::avg_pool2d(Tensor self, int[2] kernel_size, int[2] stride, int[2] padding, bool ceil_mode, bool count_include_pad, int? divisor_override) -> Tensor") ||
+      n->matches(
+          "aten::adaptive_avg_pool2d(Tensor self, int[2] output_size) -> Tensor")) {
+    return 1;
+  }
+  if (n->matches(
+          "aten::add.Tensor(Tensor self, Tensor other, *, Scalar alpha) -> Tensor") ||
+      n->matches("aten::mul.Tensor(Tensor self, Tensor other) -> Tensor")) {
+    return 2;
+  }
+  if (n->matches(
+          "aten::softmax.int(Tensor self, int dim, ScalarType? dtype) -> Tensor") &&
+      toIValue(n->input(2)) && toIValue(n->input(2))->isNone()) {
+    return 1;
+  }
+  return c10::nullopt;
+}
+
+// Whether the users of V only read it, so that reading the MKLDNN tensor V
+// was converted from instead gives the same result.
+bool onlyRead(Value* v) {
+  for (const Use& use : v->uses()) {
+    Node* user = use.user;
+    if (user->kind() == prim::Return) {
+      continue;
+    }
+    const FunctionSchema* schema = user->maybeSchema();
+    if (!schema || schema->is_mutable()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Move to_dense past N if all its tensor inputs are converted from MKLDNN.
+bool moveToDenseAfter(Node* n) {
+  auto num_inputs = mkldnnTensorInputs(n);
+  if (!num_inputs) {
+    return false;
+  }
+  for (size_t i = 0; i < *num_inputs; ++i) {
+    Node* producer = n->input(i)->node();
+    if (producer->kind() != kToDense || !onlyRead(n->input(i))) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < *num_inputs; ++i) {
+    n->replaceInput(i, n->input(i)->node()->input());
+  }
+  Graph* graph = n->owningGraph();
+  WithInsertPoint guard(n->next());
+  Value* dense = graph->insert(kToDense, {n->output()});
+  dense->setType(n->output()->type());
+  n->output()->replaceAllUsesAfterNodeWith(dense->node(), dense);
+  n->output()->setType(TensorType::get());
+  return true;
+}
+
+} // namespace
+
+void ConvertFrozenOpsToMKLDNN(std::shared_ptr<Graph>& graph) {
+  if (!at::hasMKLDNN()) {
+    return;
+  }
+  std::vector<Node*> nodes(graph->nodes().begin(), graph->nodes().end());
+  for (Node* n : nodes) {
+    if (n->matches(
+            "aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[2] stride, int[2] padding, int[2] dilation, int groups) -> Tensor")) {
+      rewriteConv2d(n);
+    } else if (n->matches(
+                   "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor")) {
+      rewriteLinear(n);
+    }
+  }
+
+  for (auto it = graph->nodes().begin(); it != graph->nodes().end(); ++it) {
+    moveToDenseAfter(*it);
+    // to_mkldnn(to_dense(x)) is x.
+    if (it->kind() == kToMKLDNN &&
+        it->input()->node()->kind() == kToDense) {
+      it->output()->replaceAllUsesWith(it->input()->node()->input());
+    }
+  }
+  EliminateDeadCode(graph);
+  GRAPH_DUMP("After ConvertFrozenOpsToMKLDNN: ", graph);
+}
+
+} // namespace jit
+} // namespace torch
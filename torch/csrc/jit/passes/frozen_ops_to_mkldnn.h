@@ -0,0 +1,26 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Run the convolutions and linear layers of a frozen graph with MKLDNN
+ * on weights laid out for it ahead of time.
+ *
+ * aten::conv2d and aten::linear calls whose weight and bias are constant float
+ * CPU tensors, as in the graph of a frozen module, are rewritten to
+ * aten::mkldnn_convolution and aten::mkldnn_linear on weights reordered into
+ * MKLDNN's blocked layout once, here, instead of on every call. Their
+ * activations are converted to and from the MKLDNN layout around them, and
+ * the conversions are then moved past the ops that support MKLDNN tensors
+ * (relu, sigmoid, add, mul, pooling, softmax) and cancelled out, so that
+ * chains of such ops don't convert between them.
+ *
+ * This is a no-op if ATen isn't built with MKLDNN. The resulting graph holds
+ * MKLDNN tensors as constants and can't be serialized.
+ */
+TORCH_API void ConvertFrozenOpsToMKLDNN(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
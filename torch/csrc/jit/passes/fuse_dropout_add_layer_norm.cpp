@@ -0,0 +1,42 @@
+#include <torch/csrc/jit/passes/fuse_dropout_add_layer_norm.h>
+#include <torch/csrc/jit/ir/subgraph_matcher.h>
+#include <torch/csrc/jit/passes/graph_rewrite_helper.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+
+namespace torch {
+namespace jit {
+
+void FuseDropoutAddLayerNorm(std::shared_ptr<Graph>& graph) {
+  std::string dropout_add_layer_norm_pattern = R"IR(
+    graph(%input, %residual, %p, %train, %alpha, %shape, %weight, %bias, %eps, %cudnn_enable):
+        %dropout = aten::dropout(%input, %p, %train)
+        %sum = aten::add(%residual, %dropout, %alpha)
+        %res = aten::layer_norm(%sum, %shape, %weight, %bias, %eps, %cudnn_enable)
+        return (%res))IR";
+  std::string add_dropout_layer_norm_pattern = R"IR(
+    graph(%input, %residual, %p, %train, %alpha, %shape, %weight, %bias, %eps, %cudnn_enable):
+        %dropout = aten::dropout(%input, %p, %train)
+        %sum = aten::add(%dropout, %residual, %alpha)
+        %res = aten::layer_norm(%sum, %shape, %weight, %bias, %eps, %cudnn_enable)
+        return (%res))IR";
+  std::string fused_dropout_add_layer_norm = R"IR(
+    graph(%input, %residual, %p, %train, %alpha, %shape, %weight, %bias, %eps, %cudnn_enable):
+        %res = aten::_dropout_add_layer_norm(%input, %residual, %shape, %weight, %bias, %p, %train, %eps)
+        return (%res))IR";
+
+  // The fused op has no alpha, so only plain additions can be replaced.
+  auto filter = [](const Match& match,
+                   const std::unordered_map<std::string, Value*>& vmap) {
+    auto alpha = graph_rewrite_helper::getIValue("alpha", match.values_map, vmap);
+    return alpha && alpha->isInt() && alpha->toInt() == 1;
+  };
+
+  SubgraphRewriter rewriter;
+  rewriter.RegisterRewritePattern(
+      dropout_add_layer_norm_pattern, fused_dropout_add_layer_norm);
+  rewriter.RegisterRewritePattern(
+      add_dropout_layer_norm_pattern, fused_dropout_add_layer_norm);
+  rewriter.runOnGraph(graph, filter);
+}
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,17 @@
+/** \brief Fusing the dropout + residual add + layer norm pattern of
+ * transformer blocks into a single op
+ */
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Match layer_norm(residual + dropout(input)) and replace it with
+ * aten::_dropout_add_layer_norm, which runs as one kernel on CUDA and falls
+ * back to the separate ops elsewhere.
+ */
+TORCH_API void FuseDropoutAddLayerNorm(std::shared_ptr<Graph>& graph);
+} // namespace jit
+} // namespace torch
@@ -1243,15 +1243,28 @@ void PeepholeOptimizeShapeExpressions(Block* block, AliasDb* db) {
 
 } // anonymous namespace
 
+bool isFusableByGraphFuser(Node* node) {
+  switch (node->kind()) {
+    case prim::FusionGroup:
+    case prim::ConstantChunk:
+    case aten::chunk:
+    case aten::cat:
+      return true;
+    default:
+      return isSimpleMap(node);
+  }
+}
+
 void FuseGraph(std::shared_ptr<Graph>& graph, bool strict_fuser_check) {
   AliasDb db(graph);
   GraphFuser(&db, graph->block(), strict_fuser_check).run();
   Lint(&db);
-  // After FuseGraph some common subexpressions may come back
-  EliminateCommonSubexpression(graph);
+  // After FuseGraph some common subexpressions may come back. The fuser kept
+  // the alias db up to date, so reuse it rather than rebuilding it.
+  EliminateCommonSubexpression(graph, db);
   // We might have emitted a fair amount of useless shape propagating code, so
   // remove it
-  EliminateDeadCode(graph);
+  EliminateDeadCode(graph, &db);
   // Improve the quality of shape propagation code that was left
   PeepholeOptimizeShapeExpressions(graph->block(), &db);
 }
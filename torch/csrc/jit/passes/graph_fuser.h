@@ -12,6 +12,10 @@ TORCH_API void FuseGraph(
     std::shared_ptr<Graph>& graph,
     bool strict_fuser_check = false);
 
+// Whether FuseGraph may put the node in a fusion group, judging from its kind
+// and schema only, i.e. before the types of its inputs are known.
+TORCH_API bool isFusableByGraphFuser(Node* node);
+
 // \brief Custom fusion pass using a node-level callback to
 // determine the inclusion of nodes in a subgraph.
 //
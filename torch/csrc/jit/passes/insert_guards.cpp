@@ -5,8 +5,33 @@
 namespace torch {
 namespace jit {
 
+// Keeps the stride order and contiguity of T but none of its sizes or
+// strides.
+static TensorTypePtr withDynamicShape(const TensorTypePtr& t) {
+  auto rank = t->dim();
+  if (!rank) {
+    return t;
+  }
+  std::vector<c10::optional<c10::Stride>> strides;
+  for (size_t i = 0; i < *rank; i++) {
+    c10::optional<c10::Stride> s = t->stride_properties()[i];
+    if (s) {
+      s->stride_ = c10::nullopt;
+    }
+    strides.push_back(s);
+  }
+  return TensorType::create(
+      t->scalarType(),
+      t->device(),
+      c10::VaryingShape<c10::ShapeSymbol>(*rank),
+      c10::VaryingShape<c10::Stride>(strides),
+      t->requiresGrad(),
+      t->undefined());
+}
+
 struct GuardInserter {
-  GuardInserter(std::shared_ptr<Graph> graph) : graph_(std::move(graph)) {}
+  GuardInserter(std::shared_ptr<Graph> graph, bool dynamic_shapes)
+      : graph_(std::move(graph)), dynamic_shapes_(dynamic_shapes) {}
 
   void run() {
     insertGuards(graph_->block());
@@ -32,6 +57,9 @@ struct GuardInserter {
       if (n->kind() == prim::profile && n->outputs().size() == 1) {
         auto pttp = n->output()->type()->cast<TensorType>();
         if (pttp) {
+          if (dynamic_shapes_) {
+            pttp = withDynamicShape(pttp);
+          }
           auto guard = graph_->create(prim::Guard, {n->input()}, 1);
           auto go = guard->output();
           go->setType(pttp);
@@ -52,10 +80,11 @@ struct GuardInserter {
   }
 
   std::shared_ptr<Graph> graph_;
+  bool dynamic_shapes_;
 };
 
-void InsertGuards(std::shared_ptr<Graph> graph) {
-  GuardInserter gi(std::move(graph));
+void InsertGuards(std::shared_ptr<Graph> graph, bool dynamic_shapes) {
+  GuardInserter gi(std::move(graph), dynamic_shapes);
   gi.run();
 }
 
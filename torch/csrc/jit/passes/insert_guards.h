@@ -13,7 +13,12 @@
 namespace torch {
 namespace jit {
 
-TORCH_API void InsertGuards(std::shared_ptr<Graph> graph);
+// Replaces profiling nodes with guards on the profiled types. With
+// DYNAMIC_SHAPES, guards drop the sizes and strides of the profiled types and
+// only check their rank, dtype, device, contiguity and requires_grad.
+TORCH_API void InsertGuards(
+    std::shared_ptr<Graph> graph,
+    bool dynamic_shapes = false);
 
 } // namespace jit
 } // namespace torch
@@ -0,0 +1,332 @@
+#include <torch/csrc/jit/passes/memory_planning.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/reuse_dead_outputs.h>
+#include <torch/csrc/jit/runtime/custom_operator.h>
+#include <torch/csrc/jit/runtime/operator.h>
+
+#include <ATen/ATen.h>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Offsets into the slab are aligned for every dtype and for vector loads.
+constexpr int64_t kSlabAlignment = 64;
+
+int64_t alignUp(int64_t n) {
+  return (n + kSlabAlignment - 1) / kSlabAlignment * kSlabAlignment;
+}
+
+const Symbol& getSlabSymbol() {
+  static Symbol s = Symbol::fromQualString("memory_plan::Slab");
+  return s;
+}
+
+const Symbol& getSlabViewSymbol() {
+  static Symbol s = Symbol::fromQualString("memory_plan::SlabView");
+  return s;
+}
+
+// An intermediate tensor, the range of top-level nodes it lives for, and
+// where it goes in the slab of its device.
+struct PlannedTensor {
+  Value* value;
+  at::ScalarType dtype;
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> strides;
+  int64_t nbytes;
+  size_t begin;
+  size_t end;
+  int64_t offset = 0;
+
+  bool overlaps(const PlannedTensor& rhs) const {
+    return begin <= rhs.end && rhs.begin <= end;
+  }
+};
+
+// Offsets for TENSORS such that tensors that are alive at the same time
+// don't share memory, placing the largest tensors first. Returns the size of
+// the slab.
+int64_t assignOffsets(std::vector<PlannedTensor>& tensors) {
+  std::stable_sort(
+      tensors.begin(),
+      tensors.end(),
+      [](const PlannedTensor& a, const PlannedTensor& b) {
+        return a.nbytes > b.nbytes;
+      });
+  int64_t slab_size = 0;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    std::vector<const PlannedTensor*> live;
+    for (size_t j = 0; j < i; ++j) {
+      if (tensors[j].overlaps(tensors[i])) {
+        live.push_back(&tensors[j]);
+      }
+    }
+    std::sort(
+        live.begin(),
+        live.end(),
+        [](const PlannedTensor* a, const PlannedTensor* b) {
+          return a->offset < b->offset;
+        });
+    // First fit between the tensors that are alive at the same time.
+    int64_t offset = 0;
+    for (const PlannedTensor* t : live) {
+      if (offset + tensors[i].nbytes <= t->offset) {
+        break;
+      }
+      offset = std::max(offset, alignUp(t->offset + t->nbytes));
+    }
+    tensors[i].offset = offset;
+    slab_size = std::max(slab_size, alignUp(offset + tensors[i].nbytes));
+  }
+  return slab_size;
+}
+
+class MemoryPlanner {
+ public:
+  explicit MemoryPlanner(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)), aliasDb_(graph_) {}
+
+  void run() {
+    Block* block = graph_->block();
+    std::vector<Node*> nodes(block->nodes().begin(), block->nodes().end());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      position_[nodes[i]] = i;
+    }
+    position_[block->return_node()] = nodes.size();
+    collectValues(block);
+
+    std::vector<std::pair<at::Device, std::vector<PlannedTensor>>> plans;
+    for (Node* n : nodes) {
+      if (n->outputs().size() != 1 || !outVariantSchema(n)) {
+        continue;
+      }
+      auto planned = plannedTensor(n->output());
+      if (!planned) {
+        continue;
+      }
+      auto device = *n->output()->type()->expect<TensorType>()->device();
+      auto it = std::find_if(
+          plans.begin(),
+          plans.end(),
+          [&](const std::pair<at::Device, std::vector<PlannedTensor>>& p) {
+            return p.first == device;
+          });
+      if (it == plans.end()) {
+        plans.emplace_back(device, std::vector<PlannedTensor>());
+        it = plans.end() - 1;
+      }
+      it->second.push_back(std::move(*planned));
+    }
+
+    for (auto& plan : plans) {
+      int64_t slab_size = assignOffsets(plan.second);
+      Node* slab = graph_->create(getSlabSymbol(), 1);
+      slab->i_(Symbol::attr("size"), slab_size);
+      slab->s_(Symbol::attr("device"), plan.first.str());
+      slab->output()->setType(TensorType::get());
+      slab->insertBefore(*block->nodes().begin());
+      for (const PlannedTensor& t : plan.second) {
+        rewrite(slab->output(), t);
+      }
+      if (!slab->output()->hasUses()) {
+        slab->destroy();
+      } else {
+        GRAPH_UPDATE(
+            "Planned ",
+            slab->output()->uses().size(),
+            " tensors in a slab of ",
+            slab_size,
+            " bytes on ",
+            plan.first);
+      }
+    }
+  }
+
+ private:
+  void collectValues(Block* block) {
+    for (Value* input : block->inputs()) {
+      values_.push_back(input);
+    }
+    for (Node* n : block->nodes()) {
+      for (Value* output : n->outputs()) {
+        values_.push_back(output);
+      }
+      for (Block* b : n->blocks()) {
+        collectValues(b);
+      }
+    }
+  }
+
+  // The position of the top-level node that (transitively) uses v last.
+  size_t lastUse(Value* v) {
+    size_t last = position_.at(v->node());
+    for (const Use& use : v->uses()) {
+      Node* user = use.user;
+      while (user->owningBlock() != graph_->block()) {
+        user = user->owningBlock()->owningNode();
+      }
+      last = std::max(last, position_.at(user));
+    }
+    return last;
+  }
+
+  // Whether nothing but v can reach the buffer of v, so that its memory can
+  // be used by other tensors once v is dead.
+  bool isPrivate(Value* v) {
+    if (aliasDb_.hasWriters(v)) {
+      return false;
+    }
+    for (Value* other : values_) {
+      if (other != v && aliasDb_.mayContainAlias(v, other)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  c10::optional<PlannedTensor> plannedTensor(Value* v) {
+    auto type = v->type()->cast<TensorType>();
+    if (!type || !type->isComplete() || type->requiresGrad() != false) {
+      return c10::nullopt;
+    }
+    size_t end = lastUse(v);
+    if (end == position_.at(graph_->block()->return_node()) ||
+        !isPrivate(v)) {
+      return c10::nullopt;
+    }
+    PlannedTensor t;
+    t.value = v;
+    t.dtype = *type->scalarType();
+    t.sizes = *type->sizes().concrete_sizes();
+    t.strides = *type->strides().concrete_sizes();
+    // The extent of the storage the tensor spans, in elements.
+    int64_t extent = 1;
+    for (size_t i = 0; i < t.sizes.size(); ++i) {
+      if (t.sizes[i] == 0 || t.strides[i] < 0) {
+        return c10::nullopt;
+      }
+      extent += (t.sizes[i] - 1) * t.strides[i];
+    }
+    t.nbytes = extent * c10::elementSize(t.dtype);
+    t.begin = position_.at(v->node());
+    t.end = end;
+    return t;
+  }
+
+  void rewrite(Value* slab, const PlannedTensor& t) {
+    Node* n = t.value->node();
+    const FunctionSchema* out_schema = outVariantSchema(n);
+    Node* view = graph_->create(getSlabViewSymbol(), {slab}, 1);
+    view->i_(Symbol::attr("offset"), t.offset);
+    view->is_(Symbol::attr("sizes"), t.sizes);
+    view->is_(Symbol::attr("strides"), t.strides);
+    view->i_(Symbol::attr("dtype"), static_cast<int64_t>(t.dtype));
+    view->output()->setType(t.value->type());
+    view->insertBefore(n);
+    n->addInput(view->output());
+    const FunctionSchema* schema = n->maybeSchema();
+    if (!schema || schema->operator_name() != out_schema->operator_name()) {
+      n->removeInput(n->inputs().size() - 1);
+      view->destroy();
+    }
+  }
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb aliasDb_;
+  std::unordered_map<Node*, size_t> position_;
+  std::vector<Value*> values_;
+};
+
+// The slab of a graph is cached by its operation. A run takes the cached slab
+// only if no other run holds it or any view of it, and allocates its own
+// otherwise.
+Operation createSlabOp(const Node* node) {
+  int64_t size = node->i(Symbol::attr("size"));
+  at::Device device(node->s(Symbol::attr("device")));
+  struct SlabCache {
+    std::mutex mutex;
+    at::Tensor slab;
+  };
+  auto cache = std::make_shared<SlabCache>();
+  return [size, device, cache](Stack& stack) {
+    at::Tensor slab;
+    {
+      std::lock_guard<std::mutex> guard(cache->mutex);
+      if (cache->slab.defined() && cache->slab.use_count() == 1 &&
+          cache->slab.storage().use_count() == 1) {
+        slab = cache->slab;
+      }
+    }
+    if (!slab.defined()) {
+      slab = at::empty({size}, at::TensorOptions(at::kByte).device(device));
+      std::lock_guard<std::mutex> guard(cache->mutex);
+      if (!cache->slab.defined()) {
+        cache->slab = slab;
+      }
+    }
+    push(stack, std::move(slab));
+    return 0;
+  };
+}
+
+void deleteSlabRef(void* ctx) {
+  delete static_cast<c10::Storage*>(ctx);
+}
+
+// A tensor in the slab. Its storage has the dtype of the tensor and keeps
+// the slab alive, without calling the allocator.
+Operation createSlabViewOp(const Node* node) {
+  int64_t offset = node->i(Symbol::attr("offset"));
+  std::vector<int64_t> sizes = node->is(Symbol::attr("sizes"));
+  std::vector<int64_t> strides = node->is(Symbol::attr("strides"));
+  auto dtype = static_cast<at::ScalarType>(node->i(Symbol::attr("dtype")));
+  return [offset, sizes, strides, dtype](Stack& stack) {
+    at::Tensor slab = pop(stack).toTensor();
+    auto meta = c10::scalarTypeToTypeMeta(dtype);
+    int64_t nbytes = slab.nbytes() - offset;
+    auto ref = new c10::Storage(slab.storage());
+    c10::DataPtr data(
+        static_cast<char*>(slab.data_ptr()) + offset,
+        ref,
+        &deleteSlabRef,
+        slab.device());
+    c10::Storage storage(c10::make_intrusive<c10::StorageImpl>(
+        c10::StorageImpl::use_byte_size_t(),
+        meta,
+        nbytes,
+        std::move(data),
+        /*allocator=*/nullptr,
+        /*resizable=*/false));
+    auto tensor = at::detail::make_tensor<c10::TensorImpl>(
+        std::move(storage), slab.key_set());
+    tensor.unsafeGetTensorImpl()->set_sizes_and_strides(sizes, strides);
+    push(stack, std::move(tensor));
+    return 0;
+  };
+}
+
+RegisterOperators reg({
+    Operator(getSlabSymbol(), createSlabOp, AliasAnalysisKind::CONSERVATIVE),
+    Operator(
+        getSlabViewSymbol(),
+        createSlabViewOp,
+        AliasAnalysisKind::CONSERVATIVE),
+});
+
+} // namespace
+
+void PlanMemory(std::shared_ptr<Graph>& graph) {
+  MemoryPlanner(graph).run();
+  GRAPH_DUMP("After PlanMemory: ", graph);
+}
+
+} // namespace jit
+} // namespace torch
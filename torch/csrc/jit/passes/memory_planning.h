@@ -0,0 +1,26 @@
+/** \brief Planning the memory of intermediate tensors of inference graphs
+ * into a single preallocated slab
+ */
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Assign the intermediate tensors of the top-level block to offsets
+ * in one slab of memory per device, and rewrite the ops producing them to
+ * call their out= variant on a view of the slab.
+ *
+ * Like ReuseDeadOutputs, only tensors whose type is complete and doesn't
+ * require grad take part, and only if nothing else in the graph may alias or
+ * write to them; graph outputs are never planned. Tensors whose lifetimes
+ * overlap get disjoint ranges of the slab. The slab is allocated by the
+ * first run and reused by later ones that don't overlap with it, so that
+ * frozen inference graphs don't call the allocator for their intermediates.
+ * This is meant to run last, on graphs after freezing and shape analysis.
+ */
+TORCH_API void PlanMemory(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,287 @@
+#include <torch/csrc/jit/passes/parallelize_branches.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/jit_log.h>
+
+#include <algorithm>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace torch {
+namespace jit {
+
+static bool parallelize_branches_enabled = false;
+
+namespace {
+
+constexpr int64_t kNoRoot = -1;
+
+// A set of top-level nodes. A barrier is a single node that can't be moved,
+// or that joins several branches; a branch is a set of movable nodes that
+// only depend on each other and (through graph inputs and constants) on the
+// barrier it is rooted at.
+struct Group {
+  std::vector<Node*> nodes;
+  bool barrier;
+  int64_t root;
+  size_t size = 0;
+};
+
+size_t countNodes(Node* n) {
+  size_t count = 1;
+  for (Block* b : n->blocks()) {
+    for (Node* inner : b->nodes()) {
+      count += inner->kind() == prim::Constant ? 0 : countNodes(inner);
+    }
+  }
+  return count;
+}
+
+// The values defined in TOP that N or the nodes in its blocks use.
+void collectTopLevelInputs(Node* n, Block* top, std::vector<Value*>& inputs) {
+  for (Value* v : n->inputs()) {
+    if (v->node()->owningBlock() == top &&
+        std::find(inputs.begin(), inputs.end(), v) == inputs.end()) {
+      inputs.push_back(v);
+    }
+  }
+  for (Block* b : n->blocks()) {
+    for (Node* inner : b->nodes()) {
+      collectTopLevelInputs(inner, top, inputs);
+    }
+    collectTopLevelInputs(b->return_node(), top, inputs);
+  }
+}
+
+class BranchParallelizer {
+ public:
+  BranchParallelizer(std::shared_ptr<Graph> graph, size_t min_branch_size)
+      : graph_(std::move(graph)),
+        aliasDb_(graph_),
+        min_branch_size_(min_branch_size) {}
+
+  void run() {
+    Block* block = graph_->block();
+    for (Node* n : block->nodes()) {
+      if (n->kind() != prim::Constant) {
+        addNode(n);
+      }
+    }
+
+    std::unordered_map<int64_t, std::vector<size_t>> branches_by_root;
+    for (size_t i = 0; i < groups_.size(); ++i) {
+      if (!groups_[i].barrier && groups_[i].size >= min_branch_size_) {
+        branches_by_root[groups_[i].root].push_back(i);
+      }
+    }
+    std::vector<size_t> to_fork;
+    for (auto& entry : branches_by_root) {
+      std::vector<size_t>& branches = entry.second;
+      if (branches.size() < 2) {
+        continue;
+      }
+      // The largest branch runs on the calling thread.
+      std::stable_sort(
+          branches.begin(), branches.end(), [&](size_t a, size_t b) {
+            return groups_[a].size > groups_[b].size;
+          });
+      to_fork.insert(to_fork.end(), branches.begin() + 1, branches.end());
+    }
+    std::sort(to_fork.begin(), to_fork.end());
+    for (size_t i : to_fork) {
+      fork(groups_[i]);
+    }
+  }
+
+ private:
+  bool canMove(Node* n) {
+    switch (n->kind()) {
+      case prim::fork:
+      case aten::wait:
+      case prim::Guard:
+      case prim::BailOut:
+      case prim::BailoutTemplate:
+      case prim::profile:
+        return false;
+      default:
+        break;
+    }
+    if (n->hasSideEffects() || aliasDb_.isMutable(n) ||
+        aliasDb_.hasWriters(n)) {
+      return false;
+    }
+    for (Block* b : n->blocks()) {
+      for (Node* inner : b->nodes()) {
+        if (!canMove(inner)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  void addNode(Node* n) {
+    Block* top = graph_->block();
+    std::vector<Value*> inputs;
+    collectTopLevelInputs(n, top, inputs);
+    std::set<size_t> producers;
+    for (Value* v : inputs) {
+      Node* p = v->node();
+      if (p != top->param_node() && p->kind() != prim::Constant) {
+        producers.insert(group_of_.at(p));
+      }
+    }
+
+    bool barrier = !canMove(n) || producers.size() > 1;
+    if (!barrier && producers.size() == 1 &&
+        !groups_[*producers.begin()].barrier) {
+      Group& g = groups_[*producers.begin()];
+      g.nodes.push_back(n);
+      g.size += countNodes(n);
+      group_of_[n] = *producers.begin();
+      return;
+    }
+    Group g;
+    g.nodes.push_back(n);
+    g.barrier = barrier;
+    g.root = producers.empty() ? kNoRoot : *producers.begin();
+    g.size = countNodes(n);
+    group_of_[n] = groups_.size();
+    groups_.push_back(std::move(g));
+  }
+
+  // Move the nodes of BRANCH into the subgraph of a prim::fork at the
+  // position of its first node, and wait for it before the first node that
+  // uses its results.
+  void fork(const Group& branch) {
+    std::unordered_set<Node*> members(
+        branch.nodes.begin(), branch.nodes.end());
+    auto subgraph = std::make_shared<Graph>();
+    std::unordered_map<Value*, Value*> env;
+    std::vector<Value*> fork_inputs;
+    auto value_map = [&](Value* v) -> Value* {
+      auto it = env.find(v);
+      if (it != env.end()) {
+        return it->second;
+      }
+      Value* mapped = nullptr;
+      if (v->node()->kind() == prim::Constant) {
+        mapped = subgraph
+                     ->insertNode(subgraph->createClone(
+                         v->node(), [](Value* v) { return v; }))
+                     ->output();
+      } else {
+        mapped = subgraph->addInput()->copyMetadata(v);
+        fork_inputs.push_back(v);
+      }
+      env[v] = mapped;
+      return mapped;
+    };
+
+    std::vector<Value*> outputs;
+    for (Node* n : branch.nodes) {
+      Node* clone = subgraph->insertNode(subgraph->createClone(n, value_map));
+      for (size_t i = 0; i < n->outputs().size(); ++i) {
+        Value* v = n->outputs()[i];
+        env[v] = clone->outputs()[i];
+        for (const Use& use : v->uses()) {
+          if (!members.count(topLevelUser(use.user))) {
+            outputs.push_back(v);
+            break;
+          }
+        }
+      }
+    }
+    if (outputs.empty()) {
+      return;
+    }
+
+    TypePtr result_type;
+    if (outputs.size() == 1) {
+      subgraph->registerOutput(env.at(outputs[0]));
+      result_type = outputs[0]->type();
+    } else {
+      std::vector<Value*> results;
+      for (Value* v : outputs) {
+        results.push_back(env.at(v));
+      }
+      Node* tuple = subgraph->insertNode(subgraph->createTuple(results));
+      subgraph->registerOutput(tuple->output());
+      result_type = tuple->output()->type();
+    }
+
+    Node* fork_node = graph_->create(prim::fork, fork_inputs, 1)
+                          ->insertBefore(branch.nodes.front());
+    fork_node->g_(attr::Subgraph, subgraph);
+    fork_node->output()->setType(FutureType::create(result_type));
+
+    Node* first_user = fork_node->next();
+    while (first_user != graph_->block()->return_node() &&
+           (members.count(first_user) || !usesAny(first_user, members))) {
+      first_user = first_user->next();
+    }
+    Node* wait = graph_->create(aten::wait, {fork_node->output()}, 1)
+                     ->insertBefore(first_user);
+    wait->output()->setType(result_type);
+    std::vector<Value*> results = {wait->output()};
+    if (outputs.size() > 1) {
+      Node* unpack =
+          graph_->createTupleUnpack(wait->output())->insertBefore(first_user);
+      results.assign(unpack->outputs().begin(), unpack->outputs().end());
+    }
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      results[i]->copyMetadata(outputs[i]);
+      outputs[i]->replaceAllUsesWith(results[i]);
+    }
+    for (auto it = branch.nodes.rbegin(); it != branch.nodes.rend(); ++it) {
+      (*it)->destroy();
+    }
+    GRAPH_UPDATE(
+        "Forked a branch of ",
+        branch.nodes.size(),
+        " nodes: ",
+        *fork_node,
+        *wait);
+  }
+
+  Node* topLevelUser(Node* user) {
+    while (user->owningBlock() != graph_->block()) {
+      user = user->owningBlock()->owningNode();
+    }
+    return user;
+  }
+
+  bool usesAny(Node* n, const std::unordered_set<Node*>& producers) {
+    std::vector<Value*> inputs;
+    collectTopLevelInputs(n, graph_->block(), inputs);
+    return std::any_of(inputs.begin(), inputs.end(), [&](Value* v) {
+      return producers.count(v->node());
+    });
+  }
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb aliasDb_;
+  size_t min_branch_size_;
+  std::vector<Group> groups_;
+  std::unordered_map<Node*, size_t> group_of_;
+};
+
+} // namespace
+
+void ParallelizeBranches(
+    std::shared_ptr<Graph>& graph,
+    size_t min_branch_size) {
+  BranchParallelizer(graph, min_branch_size).run();
+  GRAPH_DUMP("After ParallelizeBranches: ", graph);
+}
+
+void setParallelizeBranchesEnabled(bool enabled) {
+  parallelize_branches_enabled = enabled;
+}
+
+bool parallelizeBranchesEnabled() {
+  return parallelize_branches_enabled;
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Find independent branches of the top-level block, such as the towers of
+// a multi-tower model, and run all but one of them with prim::fork so that
+// the interpreter schedules them on the inter-op thread pool, joining them
+// with aten::wait before their first use. This is the inverse of
+// InlineForkWait.
+//
+// A branch is a set of nodes that depend on each other and on nothing but
+// graph inputs, constants and the node that starts them. Nodes with side
+// effects, that may write to memory or alias values that are written to, and
+// guards of the profiling executor are never moved. Branches with fewer than
+// MIN_BRANCH_SIZE nodes aren't worth the cost of launching a task and stay
+// where they are.
+TORCH_API void ParallelizeBranches(
+    std::shared_ptr<Graph>& graph,
+    size_t min_branch_size = 4);
+
+// Whether the graph executors run ParallelizeBranches on graphs that don't
+// need gradients, after fusion. Off by default.
+TORCH_API void setParallelizeBranchesEnabled(bool enabled);
+TORCH_API bool parallelizeBranchesEnabled();
+
+} // namespace jit
+} // namespace torch
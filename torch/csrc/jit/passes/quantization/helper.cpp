@@ -30,6 +30,7 @@ std::vector<std::string> _static_quantizable_aten_funcs = {
     "linear",
     "addmm",
     "matmul",
+    "bmm",
     "add_",
     "add",
     "cat",
@@ -37,6 +38,7 @@ std::vector<std::string> _static_quantizable_aten_funcs = {
     "mul",
     "mul_",
     "hardswish",
+    "hardswish_",
     "layer_norm",
 };
 
@@ -419,6 +419,36 @@ graph(%a_quant, %weight, %bias, %mean, %var, %training, %eaf, %eps, %7, %scale,
          %r = quantized::batch_norm2d_relu(%a_quant, %weight, %bias, %mean, %var, %eps, %scale, %zero_point)
          return (%r) )";
 
+  // aten::matmul
+  std::string matmul = R"(
+graph(%a_quant, %b_quant, %scale, %zero_point, %dtype):
+         %a_dequant = aten::dequantize(%a_quant)
+         %b_dequant = aten::dequantize(%b_quant)
+         %r_matmul = aten::matmul(%a_dequant, %b_dequant)
+         %r = aten::quantize_per_tensor(%r_matmul, %scale, %zero_point, %dtype)
+         return (%r) )";
+
+  // quantized::matmul
+  std::string quantized_matmul = R"(
+graph(%a_quant, %b_quant, %scale, %zero_point, %dtype):
+         %r = quantized::matmul(%a_quant, %b_quant, %scale, %zero_point)
+         return (%r) )";
+
+  // aten::bmm
+  std::string bmm = R"(
+graph(%a_quant, %b_quant, %scale, %zero_point, %dtype):
+         %a_dequant = aten::dequantize(%a_quant)
+         %b_dequant = aten::dequantize(%b_quant)
+         %r_bmm = aten::bmm(%a_dequant, %b_dequant)
+         %r = aten::quantize_per_tensor(%r_bmm, %scale, %zero_point, %dtype)
+         return (%r) )";
+
+  // quantized::bmm
+  std::string quantized_bmm = R"(
+graph(%a_quant, %b_quant, %scale, %zero_point, %dtype):
+         %r = quantized::bmm(%a_quant, %b_quant, %scale, %zero_point)
+         return (%r) )";
+
   // aten::mul
   std::string mul = R"(
 graph(%a_quant, %b_quant, %scale, %zero_point, %dtype):
@@ -551,6 +581,13 @@ graph(%a_quant, %r_scale, %r_zero_point, %r_dtype):
          %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
          return (%r_quant) )";
 
+  std::string inplace_hardswish = R"(
+graph(%a_quant, %r_scale, %r_zero_point, %r_dtype):
+         %a_dequant = aten::dequantize(%a_quant)
+         %r = aten::hardswish_(%a_dequant)
+         %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+         return (%r_quant) )";
+
   std::string quantized_hardswish = R"(
 graph(%a_quant, %r_scale, %r_zero_point, %r_dtype):
          %r_quant = quantized::hardswish(%a_quant, %r_scale, %r_zero_point)
@@ -674,6 +711,23 @@ graph(%a_quant, %normalized_shape, %weight, %bias, %eps, %cudnn_enabled, %output
 
   auto tanh_ = getFixedQParamOpFusionInfo("aten::tanh_", {}, true);
 
+  // A dequantize that is only quantized again with the qparams of its input,
+  // left behind when the op between them was fused or removed, e.g. in
+  // elementwise chains like add -> relu -> hardswish. This must come after
+  // all the patterns above, so that it doesn't break them up.
+  std::string requantize = R"(
+graph(%a_quant):
+          %a_dequant = aten::dequantize(%a_quant)
+          %r_scale : float = aten::q_scale(%a_quant)
+          %r_zero_point : int = aten::q_zero_point(%a_quant)
+          %r_dtype : int = prim::dtype(%a_quant)
+          %r_quant = aten::quantize_per_tensor(%a_dequant, %r_scale, %r_zero_point, %r_dtype)
+          return (%r_quant) )";
+
+  std::string no_requantize = R"(
+graph(%a_quant):
+          return (%a_quant) )";
+
   return {
       {"quantized::conv1d", conv1d, quantized_conv1d},
       {"quantized::conv1d_relu", conv1d_relu, quantized_conv1d_relu},
@@ -714,6 +768,8 @@ graph(%a_quant, %normalized_shape, %weight, %bias, %eps, %cudnn_enabled, %output
       {"quantized::batch_norm2d_relu",
        batch_norm2d_inplace_relu,
        quantized_batch_norm2d_relu},
+      {"quantized::matmul", matmul, quantized_matmul},
+      {"quantized::bmm", bmm, quantized_bmm},
       {"quantized::mul", mul, quantized_mul},
       {"quantized::mul", inplace_mul, quantized_mul},
       {"quantized::mul_scalar_relu",
@@ -737,6 +793,7 @@ graph(%a_quant, %normalized_shape, %weight, %bias, %eps, %cudnn_enabled, %output
       {"quantized::mul_relu", inplace_mul_relu, quantized_mul_relu},
       {"quantized::mul_relu", inplace_mul_inplace_relu, quantized_mul_relu},
       {"quantized::hardswish", hardswish, quantized_hardswish},
+      {"quantized::hardswish", inplace_hardswish, quantized_hardswish},
       {"quantized::layer_norm", layer_norm, quantized_layer_norm},
       avg_pool1d,
       avg_pool2d,
@@ -766,6 +823,7 @@ graph(%a_quant, %normalized_shape, %weight, %bias, %eps, %cudnn_enabled, %output
       sigmoid_,
       tanh,
       tanh_,
+      {"requantize", requantize, no_requantize},
   };
 }
 
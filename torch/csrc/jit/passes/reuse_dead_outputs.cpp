@@ -0,0 +1,189 @@
+#include <torch/csrc/jit/passes/reuse_dead_outputs.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/runtime/operator.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+// Returns the out= overload of the schema of n: the same arguments followed
+// by a keyword-only, written `out` tensor.
+const FunctionSchema* outVariantSchema(const Node* n) {
+  const FunctionSchema* schema = n->maybeSchema();
+  if (!schema || !schema->overload_name().empty() || schema->is_mutable() ||
+      schema->returns().size() != 1 || n->outputs().size() != 1) {
+    return nullptr;
+  }
+  const auto& args = schema->arguments();
+  for (const auto& op : getAllOperatorsFor(n->kind())) {
+    const FunctionSchema& out_schema = op->schema();
+    const auto& out_args = out_schema.arguments();
+    if (out_schema.overload_name() != "out" ||
+        out_args.size() != args.size() + 1) {
+      continue;
+    }
+    bool same_args = true;
+    for (size_t i = 0; i < args.size() && same_args; ++i) {
+      same_args = out_args[i].name() == args[i].name() &&
+          *out_args[i].type() == *args[i].type();
+    }
+    const Argument& out = out_args.back();
+    if (same_args && out.kwarg_only() && out.alias_info() &&
+        out.alias_info()->isWrite() &&
+        out.type()->kind() == TypeKind::TensorType) {
+      return &out_schema;
+    }
+  }
+  return nullptr;
+}
+
+namespace {
+
+// The complete type of a tensor that can be reused as an output buffer.
+struct BufferType {
+  at::ScalarType dtype;
+  at::Device device;
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> strides;
+
+  bool operator==(const BufferType& rhs) const {
+    return dtype == rhs.dtype && device == rhs.device && sizes == rhs.sizes &&
+        strides == rhs.strides;
+  }
+};
+
+c10::optional<BufferType> bufferType(const Value* v) {
+  auto type = v->type()->cast<TensorType>();
+  if (!type || !type->isComplete() || type->requiresGrad() != false) {
+    return c10::nullopt;
+  }
+  return BufferType{*type->scalarType(),
+                    *type->device(),
+                    *type->sizes().concrete_sizes(),
+                    *type->strides().concrete_sizes()};
+}
+
+class DeadOutputReuser {
+ public:
+  explicit DeadOutputReuser(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)), aliasDb_(graph_) {}
+
+  void run() {
+    Block* block = graph_->block();
+    std::vector<Node*> nodes(block->nodes().begin(), block->nodes().end());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      position_[nodes[i]] = i;
+    }
+    position_[block->return_node()] = nodes.size();
+    collectValues(block);
+
+    // Buffers waiting for their last use, and buffers free for reuse.
+    std::vector<std::pair<Value*, BufferType>> pending;
+    std::vector<std::pair<Value*, BufferType>> free;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      for (auto it = pending.begin(); it != pending.end();) {
+        if (lastUse(it->first) < i) {
+          free.push_back(std::move(*it));
+          it = pending.erase(it);
+        } else {
+          ++it;
+        }
+      }
+
+      Node* n = nodes[i];
+      if (n->outputs().size() != 1) {
+        continue;
+      }
+      Value* output = n->output();
+      auto type = bufferType(output);
+      if (!type) {
+        continue;
+      }
+      if (const FunctionSchema* out_schema = outVariantSchema(n)) {
+        auto it = std::find_if(
+            free.begin(), free.end(), [&](const std::pair<Value*, BufferType>& b) {
+              return b.second == *type;
+            });
+        if (it != free.end() && reuse(n, it->first, *out_schema)) {
+          free.erase(it);
+        }
+      }
+      if (isPrivate(output)) {
+        pending.emplace_back(output, std::move(*type));
+      }
+    }
+  }
+
+ private:
+  void collectValues(Block* block) {
+    for (Value* input : block->inputs()) {
+      values_.push_back(input);
+    }
+    for (Node* n : block->nodes()) {
+      for (Value* output : n->outputs()) {
+        values_.push_back(output);
+      }
+      for (Block* b : n->blocks()) {
+        collectValues(b);
+      }
+    }
+  }
+
+  // The position of the top-level node that (transitively) uses v last.
+  size_t lastUse(Value* v) {
+    size_t last = position_.at(v->node());
+    for (const Use& use : v->uses()) {
+      Node* user = use.user;
+      while (user->owningBlock() != graph_->block()) {
+        user = user->owningBlock()->owningNode();
+      }
+      last = std::max(last, position_.at(user));
+    }
+    return last;
+  }
+
+  // Whether nothing but v can reach the buffer of v, so that it can be
+  // overwritten once v is dead.
+  bool isPrivate(Value* v) {
+    if (aliasDb_.hasWriters(v)) {
+      return false;
+    }
+    for (Value* other : values_) {
+      if (other != v && aliasDb_.mayContainAlias(v, other)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool reuse(Node* n, Value* buffer, const FunctionSchema& out_schema) {
+    n->addInput(buffer);
+    const FunctionSchema* schema = n->maybeSchema();
+    if (!schema || schema->operator_name() != out_schema.operator_name()) {
+      n->removeInput(n->inputs().size() - 1);
+      return false;
+    }
+    GRAPH_UPDATE(
+        "Writing the output of ", *n, " into the buffer of %", buffer->debugName());
+    return true;
+  }
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb aliasDb_;
+  std::unordered_map<Node*, size_t> position_;
+  std::vector<Value*> values_;
+};
+
+} // namespace
+
+void ReuseDeadOutputs(std::shared_ptr<Graph>& graph) {
+  DeadOutputReuser(graph).run();
+  GRAPH_DUMP("After ReuseDeadOutputs: ", graph);
+}
+
+} // namespace jit
+} // namespace torch
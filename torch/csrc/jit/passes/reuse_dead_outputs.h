@@ -0,0 +1,28 @@
+/** \brief Reusing the buffers of dead intermediate tensors as the outputs of
+ * later ops
+ */
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Rewrite functional ops of the top-level block to call their out=
+ * variant on the buffer of an intermediate tensor that is no longer used.
+ *
+ * Only tensors whose type is complete (dtype, device, sizes and strides) and
+ * doesn't require grad take part; a buffer is only reused for an output of
+ * the same type, and only if nothing else in the graph may alias it. This
+ * saves an allocation and a free per rewritten op, e.g., after shape
+ * analysis or freezing of inference graphs.
+ */
+TORCH_API void ReuseDeadOutputs(std::shared_ptr<Graph>& graph);
+
+/** \brief Returns the out= overload of the schema of n, i.e., the same
+ * arguments followed by a keyword-only, written `out` tensor, or nullptr if
+ * n isn't a functional op with such an overload.
+ */
+TORCH_API const FunctionSchema* outVariantSchema(const Node* n);
+} // namespace jit
+} // namespace torch
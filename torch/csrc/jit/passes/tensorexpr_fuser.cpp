@@ -29,6 +29,15 @@ bool tensorExprFuserEnabled() {
   return true;
 }
 
+static bool texpr_dynamic_shapes_enabled_ = false;
+void setTensorExprDynamicShapesEnabled(bool val) {
+  texpr_dynamic_shapes_enabled_ = val;
+}
+
+bool tensorExprDynamicShapesEnabled() {
+  return texpr_dynamic_shapes_enabled_;
+}
+
 const Symbol& getTensorExprSymbol() {
   static Symbol s = Symbol::fromQualString("tensorexpr::Group");
   return s;
@@ -60,21 +69,77 @@ bool allShapesAreKnown(Value* v) {
   return v->isCompleteTensor();
 }
 
+// With dynamic shapes, the kernel binds unknown sizes and strides at runtime,
+// so only the rank, dtype and device of tensors need to be known.
+bool allShapesAreKnownOrDynamic(Value* v) {
+  auto tt = v->type()->cast<TensorType>();
+  if (!tt || v->isCompleteTensor()) {
+    return true;
+  }
+  return tensorExprDynamicShapesEnabled() && tt->scalarType() &&
+      tt->device() && tt->dim();
+}
+
+// Ops whose output shape is computed from static sizes of their inputs.
+bool requiresStaticShapes(Node* node) {
+  switch (node->kind()) {
+    case prim::ConstantChunk:
+    case aten::cat:
+    case aten::slice:
+    case aten::unsqueeze:
+      return true;
+    default:
+      return false;
+  }
+}
+
 bool allShapesAreKnown(Node* node) {
-  // TODO: Relax the checks to support dynamic shapes
+  auto known = requiresStaticShapes(node)
+      ? static_cast<bool (*)(Value*)>(allShapesAreKnown)
+      : allShapesAreKnownOrDynamic;
   for (torch::jit::Value* output : node->outputs()) {
-    if (!allShapesAreKnown(output)) {
+    if (!known(output)) {
       return false;
     }
   }
   for (torch::jit::Value* input : node->inputs()) {
-    if (!allShapesAreKnown(input)) {
+    if (!known(input)) {
       return false;
     }
   }
   return true;
 }
 
+// Reductions are only lowered on CPU, with constant dims and keepdim and
+// without a dtype argument; mean, softmax and log_softmax also need a floating
+// point input.
+bool isSupportedReduction(Node* node) {
+  auto type = node->inputs()[0]->type()->cast<TensorType>();
+  if (!type || !type->device() || !type->device()->is_cpu() ||
+      !type->scalarType()) {
+    return false;
+  }
+  // sum and mean take (self, dtype) or (self, dim, keepdim, dtype); softmax
+  // and log_softmax take (self, dim, dtype).
+  size_t nInputs = node->inputs().size();
+  if (node->kind() == aten::softmax || node->kind() == aten::log_softmax) {
+    if (nInputs != 3) {
+      return false;
+    }
+  } else if (nInputs != 2 && nInputs != 4) {
+    return false;
+  }
+  for (size_t i = 1; i < nInputs; i++) {
+    if (node->inputs()[i]->node()->kind() != prim::Constant) {
+      return false;
+    }
+  }
+  if (!toIValue(node->inputs().back())->isNone()) {
+    return false;
+  }
+  return node->kind() == aten::sum || isFloatingType(*type->scalarType());
+}
+
 bool isSupported(Node* node) {
   // TODO:
   switch (node->kind()) {
@@ -154,11 +219,29 @@ bool isSupported(Node* node) {
         return false;
       }
       return true;
+    case aten::sum:
+    case aten::mean:
+    case aten::softmax:
+    case aten::log_softmax:
+      return isSupportedReduction(node);
     default:
       return false;
   }
 }
 
+bool tensorExprFuserMaySupport(Node* node) {
+  switch (node->kind()) {
+    // isSupportedReduction needs the profiled type of the input
+    case aten::sum:
+    case aten::mean:
+    case aten::softmax:
+    case aten::log_softmax:
+      return true;
+    default:
+      return isSupported(node);
+  }
+}
+
 bool canHandle(Node* node, AliasDb& aliasDb) {
   if (node->kind() == prim::Constant) {
     if (node->output()->type()->cast<TensorType>()) {
@@ -193,9 +276,10 @@ bool canHandle(Node* node, AliasDb& aliasDb) {
   }
 
 bool canMerge(Node* consumer, Node* producer, AliasDb& aliasDb) {
-  // Only handle complete tensor types
+  // Only handle complete tensor types, or ranked ones with dynamic shapes
   for (torch::jit::Value* output : consumer->outputs()) {
-    REQ(output->isCompleteTensor());
+    REQ(output->type()->cast<TensorType>());
+    REQ(allShapesAreKnownOrDynamic(output));
   }
 
   // Only fuse within a block
@@ -8,6 +8,7 @@ namespace torch {
 namespace jit {
 
 struct Graph;
+struct Node;
 
 // Run TensorExpressions-based fuser.
 TORCH_API void FuseTensorExprs(std::shared_ptr<Graph>& graph);
@@ -15,5 +16,16 @@ TORCH_API void FuseTensorExprs(std::shared_ptr<Graph>& graph);
 TORCH_API void setTensorExprFuserEnabled(bool val);
 TORCH_API bool tensorExprFuserEnabled();
 
+// When enabled, the fuser also fuses tensors whose sizes aren't known, as
+// long as their rank, dtype and device are, and the profiling executor only
+// guards on rank, dtype and contiguity, so that kernels are compiled once per
+// rank instead of once per shape.
+TORCH_API void setTensorExprDynamicShapesEnabled(bool val);
+TORCH_API bool tensorExprDynamicShapesEnabled();
+
+// Whether FuseTensorExprs may fuse the node once the types of its inputs are
+// profiled.
+TORCH_API bool tensorExprFuserMaySupport(Node* node);
+
 } // namespace jit
 } // namespace torch
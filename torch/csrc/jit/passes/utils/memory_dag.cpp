@@ -69,29 +69,53 @@ void MemoryDAG::collectAllContainedMemoryLocations(
     const Element* elem,
     MemoryLocations& cont) const {
   // we have already recursed on this element
+  if (cont.test(elem->index)) {
+    return;
+  }
+  cont |= getAllContainedMemoryLocations(elem);
+}
+
+const MemoryLocations& MemoryDAG::getAllContainedMemoryLocations(
+    const Element* elem) const {
+  // Same cache invalidation argument as for `getMemoryLocations`.
+  if (elem->cachedAllContainedMemoryLocations_) {
+    return *elem->cachedAllContainedMemoryLocations_;
+  }
+
+  MemoryLocations ret;
+  collectAllContainedMemoryLocationsImpl(elem, ret);
+  elem->cachedAllContainedMemoryLocations_ = std::move(ret);
+  return *elem->cachedAllContainedMemoryLocations_;
+}
+
+void MemoryDAG::collectAllContainedMemoryLocationsImpl(
+    const Element* elem,
+    MemoryLocations& cont) const {
+  // we have already recursed on this element
   unsigned compIdx = elem->index;
   if (cont.test(compIdx)) {
     return;
   }
+  // Only the element a query started from is cached, once its walk is
+  // complete, so any cached result here is complete too.
+  if (elem->cachedAllContainedMemoryLocations_) {
+    cont |= *elem->cachedAllContainedMemoryLocations_;
+    return;
+  }
   cont.set(compIdx);
 
   for (const auto& mem_loc : getMemoryLocations(elem)) {
-    collectAllContainedMemoryLocations(fromIndex(mem_loc), cont);
+    collectAllContainedMemoryLocationsImpl(fromIndex(mem_loc), cont);
   }
 
   for (const auto& contained : elem->containedElements) {
-    collectAllContainedMemoryLocations(fromIndex(contained), cont);
+    collectAllContainedMemoryLocationsImpl(fromIndex(contained), cont);
   }
 }
 
 bool MemoryDAG::mayContainAliasImpl(const Element* a, const Element* b) const {
-  MemoryLocations all_a_mlocs;
-  MemoryLocations all_b_mlocs;
-
-  collectAllContainedMemoryLocations(a, all_a_mlocs);
-  collectAllContainedMemoryLocations(b, all_b_mlocs);
-
-  return all_a_mlocs.intersects(all_b_mlocs);
+  return getAllContainedMemoryLocations(a).intersects(
+      getAllContainedMemoryLocations(b));
 }
 
 bool MemoryDAG::mayContainAlias(
@@ -103,12 +127,12 @@ bool MemoryDAG::mayContainAlias(
 
   MemoryLocations all_a_mlocs;
   for (const auto& elem : a) {
-    collectAllContainedMemoryLocations(elem, all_a_mlocs);
+    all_a_mlocs |= getAllContainedMemoryLocations(elem);
   }
 
   MemoryLocations all_b_mlocs;
   for (const auto& elem : b) {
-    collectAllContainedMemoryLocations(elem, all_b_mlocs);
+    all_b_mlocs |= getAllContainedMemoryLocations(elem);
   }
 
   return all_a_mlocs.intersects(all_b_mlocs);
@@ -209,6 +233,12 @@ void MemoryDAG::setWildcards(
       e->cachedMemoryLocations_->set(wildcardElement->index);
     }
   }
+
+  // The closures of contained memory locations are cheap to recompute from
+  // the updated caches above, so just drop any that were computed before.
+  for (const std::unique_ptr<Element>& e : this->indexToElementMap_) {
+    e->cachedAllContainedMemoryLocations_ = c10::nullopt;
+  }
 }
 
 Element* MemoryDAG::unsafeMakeFreshValue(const Value* v) {
@@ -95,6 +95,11 @@ class TORCH_API MemoryDAG {
       const Element* elem,
       MemoryLocations& cont) const;
 
+  // Return all the memory locations `Element` might represent or contain,
+  // transitively, and the element itself.
+  const MemoryLocations& getAllContainedMemoryLocations(
+      const Element* elem) const;
+
   /**
    * The following methods are special cases where we need to reach mutate the
    * internals of MemoryDAG for efficiency reasons. Don't call them unless you
@@ -114,6 +119,9 @@ class TORCH_API MemoryDAG {
   bool mayAliasImpl(const Element* a, const Element* b) const;
   bool mayContainAliasImpl(const Element* contained, const Element* container)
       const;
+  void collectAllContainedMemoryLocationsImpl(
+      const Element* elem,
+      MemoryLocations& cont) const;
   std::vector<std::unique_ptr<Element>> indexToElementMap_;
 };
 
@@ -151,6 +159,10 @@ struct Element {
   // A nullopt means that this cache is not yet populated. Since `MemoryDAG` is
   // immutable, this cache should never need to be invalidated.
   mutable c10::optional<MemoryLocations> cachedMemoryLocations_;
+  // Likewise for `getAllContainedMemoryLocations`, which `mayContainAlias`
+  // queries would otherwise recompute by walking the whole DAG below the
+  // element every time.
+  mutable c10::optional<MemoryLocations> cachedAllContainedMemoryLocations_;
 };
 
 } // namespace jit
@@ -267,6 +267,171 @@ void fuseReluWithPackedOps(std::shared_ptr<Graph>& graph) {
   rewriter.runOnGraph(graph, isClampFusable);
 }
 
+// Ops that take activations in any layout and lay their output out like
+// their tensor inputs, and those of them that write to their first input.
+bool isLayoutPreserving(const Node* n) {
+  static const std::unordered_set<Symbol> kinds = [] {
+    std::unordered_set<Symbol> kinds;
+    for (const char* kind : {"prepacked::conv2d_clamp_run",
+                             "aten::relu",
+                             "aten::relu_",
+                             "aten::hardtanh",
+                             "aten::hardtanh_",
+                             "aten::hardswish",
+                             "aten::hardswish_",
+                             "aten::hardsigmoid",
+                             "aten::sigmoid",
+                             "aten::sigmoid_",
+                             "aten::tanh",
+                             "aten::clamp",
+                             "aten::clamp_",
+                             "aten::add",
+                             "aten::add_",
+                             "aten::sub",
+                             "aten::mul",
+                             "aten::mul_",
+                             "aten::div",
+                             "aten::max_pool2d",
+                             "aten::avg_pool2d",
+                             "aten::adaptive_avg_pool2d"}) {
+      kinds.insert(Symbol::fromQualString(kind));
+    }
+    return kinds;
+  }();
+  return kinds.count(n->kind()) != 0;
+}
+
+bool isInPlace(const Node* n) {
+  static const std::unordered_set<Symbol> kinds = [] {
+    std::unordered_set<Symbol> kinds;
+    for (const char* kind : {"aten::relu_",
+                             "aten::hardtanh_",
+                             "aten::hardswish_",
+                             "aten::sigmoid_",
+                             "aten::clamp_",
+                             "aten::add_",
+                             "aten::mul_"}) {
+      kinds.insert(Symbol::fromQualString(kind));
+    }
+    return kinds;
+  }();
+  return kinds.count(n->kind()) != 0;
+}
+
+// Whether the use of a channels last activation is by an op that keeps it
+// channels last, i.e. is within the subgraph kept in NHWC.
+bool isWithinChannelsLast(const Graph& graph, const Use& use) {
+  static const Symbol conv2d_run =
+      Symbol::fromQualString("prepacked::conv2d_clamp_run");
+  return use.user->owningBlock() == graph.block() &&
+      isLayoutPreserving(use.user) &&
+      (use.user->kind() != conv2d_run || use.offset == 0);
+}
+
+void insertChannelsLastConversions(std::shared_ptr<Graph>& graph) {
+  static const Symbol conv2d_run =
+      Symbol::fromQualString("prepacked::conv2d_clamp_run");
+
+  // The activations that are channels last once the prepacked convolutions
+  // take their input channels last, each with the activation whose memory
+  // it is, which differs for the outputs of in-place ops.
+  std::unordered_map<Value*, Value*> channels_last;
+  std::vector<Value*> order;
+  std::vector<Node*> convs;
+  for (Node* n : graph->nodes()) {
+    if (n->kind() == conv2d_run) {
+      convs.push_back(n);
+    } else if (!isLayoutPreserving(n)) {
+      continue;
+    } else if (isInPlace(n)) {
+      auto it = channels_last.find(n->input(0));
+      if (it == channels_last.end()) {
+        continue;
+      }
+      channels_last.emplace(n->output(), it->second);
+      order.push_back(n->output());
+      continue;
+    } else if (std::none_of(
+                   n->inputs().begin(), n->inputs().end(), [&](Value* v) {
+                     return channels_last.count(v) != 0;
+                   })) {
+      continue;
+    }
+    channels_last.emplace(n->output(), n->output());
+    order.push_back(n->output());
+  }
+  if (convs.empty()) {
+    return;
+  }
+
+  // Where activations leave the subgraph, they are converted back to the
+  // layout they had before, on a copy. Give up if that copy could miss
+  // writes to the activation: if it is written to in place, or by the op it
+  // is handed to.
+  std::unordered_set<Value*> written, converted;
+  for (Value* v : order) {
+    for (const Use& use : v->uses()) {
+      if (isWithinChannelsLast(*graph, use)) {
+        if (isInPlace(use.user) && use.offset == 0) {
+          written.insert(channels_last.at(v));
+        }
+        continue;
+      }
+      const FunctionSchema* schema = use.user->maybeSchema();
+      if (schema && schema->is_mutable()) {
+        return;
+      }
+      converted.insert(channels_last.at(v));
+    }
+  }
+  for (Value* memory : written) {
+    if (converted.count(memory)) {
+      return;
+    }
+  }
+
+  for (Value* v : order) {
+    std::vector<Use> exits;
+    for (const Use& use : v->uses()) {
+      if (!isWithinChannelsLast(*graph, use)) {
+        exits.push_back(use);
+      }
+    }
+    if (exits.empty()) {
+      continue;
+    }
+    WithInsertPoint guard(v->node()->next());
+    Value* contiguous = graph->insert(aten::contiguous, {v});
+    contiguous->setType(v->type());
+    for (const Use& use : exits) {
+      use.user->replaceInput(use.offset, contiguous);
+    }
+  }
+
+  // The input of every convolution that doesn't already come from one is
+  // converted to channels last, once.
+  std::unordered_map<Value*, Value*> inputs_channels_last;
+  for (Node* conv : convs) {
+    Value* input = conv->input(0);
+    if (channels_last.count(input)) {
+      continue;
+    }
+    auto it = inputs_channels_last.find(input);
+    if (it == inputs_channels_last.end()) {
+      WithInsertPoint guard(conv);
+      Value* converted_input = graph->insert(
+          aten::contiguous,
+          {input},
+          {NamedValue(
+              "memory_format",
+              static_cast<int64_t>(c10::MemoryFormat::ChannelsLast))});
+      converted_input->setType(input->type());
+      it = inputs_channels_last.emplace(input, converted_input).first;
+    }
+    conv->replaceInput(0, it->second);
+  }
+}
+
 } // namespace
 
 void insertPrePackedOps(std::shared_ptr<Graph>& graph) {
@@ -290,6 +455,11 @@ void fusePrePackedLinearConvWithClamp(script::Module& module) {
   fuseHardtanhWithPackedOps(graph);
 }
 
+void insertChannelsLastConversions(script::Module& module) {
+  auto graph = module.get_method("forward").graph();
+  insertChannelsLastConversions(graph);
+}
+
 void FoldPrePackingOps(script::Module& m) {
   PrePackingOpsFilterFn filter_fn = [](const Node* n) -> bool {
     return (
@@ -308,6 +478,7 @@ c10::optional<script::Module> optimizeForMobile(const script::Module& m) {
   cloned_module = freeze_module(cloned_module);
   fusePrePackedLinearConvWithClamp(cloned_module);
   FoldPrePackingOps(cloned_module);
+  insertChannelsLastConversions(cloned_module);
   return cloned_module;
 }
 
@@ -328,6 +499,11 @@ void fusePrePackedLinearConvWithClamp(script::Module& module) {
       "XNNPACK is not enabled. Please build with USE_XNNPACK=1");
 }
 
+void insertChannelsLastConversions(script::Module& module) {
+  TORCH_INTERNAL_ASSERT(
+      "XNNPACK is not enabled. Please build with USE_XNNPACK=1");
+}
+
 void FoldPrePackingOps(script::Module& m) {
   TORCH_INTERNAL_ASSERT(
       "XNNPACK is not enabled. Please build with USE_XNNPACK=1");
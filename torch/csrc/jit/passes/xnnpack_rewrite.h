@@ -9,6 +9,12 @@ TORCH_API void insertPrePackedOps(std::shared_ptr<Graph>& graph);
 TORCH_API void insertPrePackedOps(script::Module& module);
 TORCH_API void fusePrePackedLinearConvWithClamp(script::Module& module);
 TORCH_API void FoldPrePackingOps(script::Module& module);
+// Keeps the activations of the prepacked convolutions in forward, and of the
+// pooling and elementwise ops between them, channels last (NHWC), which is
+// XNNPACK's layout, instead of converting them back and forth around every
+// convolution. They are converted once where they enter that subgraph and
+// back to their original layout where they leave it.
+TORCH_API void insertChannelsLastConversions(script::Module& module);
 TORCH_API c10::optional<script::Module> optimizeForMobile(
     const script::Module& module);
 } // namespace jit
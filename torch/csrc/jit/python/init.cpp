@@ -20,6 +20,9 @@
 #include <torch/csrc/jit/passes/erase_number_types.h>
 #include <torch/csrc/jit/passes/fold_conv_bn.h>
 #include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/frozen_linear_to_block_sparse.h>
+#include <torch/csrc/jit/passes/frozen_ops_to_mkldnn.h>
+#include <torch/csrc/jit/passes/fuse_dropout_add_layer_norm.h>
 #include <torch/csrc/jit/passes/fuse_linear.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/inline_fork_wait.h>
@@ -27,6 +30,7 @@
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_graph.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
 #include <torch/csrc/jit/passes/onnx.h>
 #include <torch/csrc/jit/passes/onnx/cast_all_constant_to_floating.h>
 #include <torch/csrc/jit/passes/onnx/constant_fold.h>
@@ -38,6 +42,7 @@
 #include <torch/csrc/jit/passes/onnx/prepare_inplace_ops_for_onnx.h>
 #include <torch/csrc/jit/passes/onnx/scalar_type_analysis.h>
 #include <torch/csrc/jit/passes/onnx/unpack_quantized_weights.h>
+#include <torch/csrc/jit/passes/parallelize_branches.h>
 #include <torch/csrc/jit/passes/peephole.h>
 #include <torch/csrc/jit/passes/quantization/dedup_module_uses.h>
 #include <torch/csrc/jit/passes/quantization/finalize.h>
@@ -46,6 +51,7 @@
 #include <torch/csrc/jit/passes/remove_dropout.h>
 #include <torch/csrc/jit/passes/remove_expands.h>
 #include <torch/csrc/jit/passes/remove_inplace_ops.h>
+#include <torch/csrc/jit/passes/reuse_dead_outputs.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/passes/specialize_autogradzero.h>
 #include <torch/csrc/jit/passes/subgraph_rewrite.h>
@@ -63,6 +69,7 @@
 #include <torch/csrc/jit/runtime/autodiff.h>
 #include <torch/csrc/jit/runtime/graph_executor.h>
 #include <torch/csrc/jit/runtime/jit_exception.h>
+#include <torch/csrc/jit/runtime/lazy_tensor.h>
 #include <torch/csrc/jit/runtime/operator.h>
 #include <torch/csrc/jit/runtime/print_handler.h>
 #include <torch/csrc/jit/serialization/export.h>
@@ -221,7 +228,29 @@ void initJITBindings(PyObject* module) {
           "_freeze_module",
           [](Module& module) { return freeze_module(module); },
           py::arg("module"))
+      .def(
+          "_jit_pass_convert_frozen_ops_to_mkldnn", &ConvertFrozenOpsToMKLDNN)
+      .def(
+          "_jit_pass_convert_frozen_linear_to_block_sparse",
+          &ConvertFrozenLinearToBlockSparse,
+          py::arg("graph"),
+          py::arg("blocksize") = std::vector<int64_t>{8, 1},
+          py::arg("min_sparsity") = 0.7)
       .def("_jit_pass_fuse_linear", &FuseLinear)
+      .def("_jit_pass_fuse_dropout_add_layer_norm", &FuseDropoutAddLayerNorm)
+      .def("_jit_pass_reuse_dead_outputs", &ReuseDeadOutputs)
+      .def("_jit_pass_plan_memory", &PlanMemory)
+      .def(
+          "_jit_pass_parallelize_branches",
+          [](std::shared_ptr<Graph>& g, size_t min_branch_size) {
+            ParallelizeBranches(g, min_branch_size);
+          },
+          py::arg("graph"),
+          py::arg("min_branch_size") = 4)
+      .def(
+          "_jit_set_parallelize_branches_enabled",
+          &setParallelizeBranchesEnabled)
+      .def("_jit_parallelize_branches_enabled", &parallelizeBranchesEnabled)
       .def("_jit_pass_dedup_module_uses", &DedupModuleUses)
       .def("_jit_pass_replicate_dequantize", &ReplicateDeQuant)
       .def("_jit_pass_swap_dequantize", &PropagateQuantizationOps)
@@ -415,6 +444,13 @@ void initJITBindings(PyObject* module) {
             getExecutorMode() = profiling_flag;
             return oldState;
           })
+      .def(
+          "_jit_set_background_compilation_mode",
+          [](bool background_flag) {
+            bool oldState = getBackgroundCompilationMode();
+            getBackgroundCompilationMode() = background_flag;
+            return oldState;
+          })
       .def(
           "_jit_set_num_profiled_runs",
           [](size_t num) {
@@ -429,6 +465,11 @@ void initJITBindings(PyObject* module) {
             getBailoutDepth() = depth;
             return old_depth;
           })
+      .def("_jit_to_lazy", &toLazy)
+      .def("_jit_is_lazy", &isLazy)
+      .def("_jit_lazy_materialize", &materialize)
+      .def("_jit_lazy_sync", &syncLazyTensors)
+      .def("_jit_lazy_graph_cache_size", &lazyGraphCacheSize)
       .def(
           "_jit_set_inline_everything_mode",
           [](bool enabled) { getInlineEverythingMode() = enabled; })
@@ -476,6 +517,18 @@ void initJITBindings(PyObject* module) {
             using namespace torch::jit::tensorexpr;
             return getTECudaPointwiseBlockCount() = block_count;
           })
+      .def(
+          "_jit_get_te_generate_parallel_loops",
+          []() -> bool {
+            using namespace torch::jit::tensorexpr;
+            return getTEGenerateParallelLoops();
+          })
+      .def(
+          "_jit_set_te_generate_parallel_loops",
+          [](bool enabled) {
+            using namespace torch::jit::tensorexpr;
+            return getTEGenerateParallelLoops() = enabled;
+          })
       .def(
           "_jit_get_te_cuda_pointwise_block_size",
           []() -> int {
@@ -490,6 +543,12 @@ void initJITBindings(PyObject* module) {
           })
       .def("_jit_set_texpr_fuser_enabled", &setTensorExprFuserEnabled)
       .def("_jit_texpr_fuser_enabled", &tensorExprFuserEnabled)
+      .def(
+          "_jit_set_texpr_dynamic_shapes_enabled",
+          &setTensorExprDynamicShapesEnabled)
+      .def(
+          "_jit_texpr_dynamic_shapes_enabled",
+          &tensorExprDynamicShapesEnabled)
       .def("_jit_texpr_fallback_allowed", &tensorexpr::fallbackAllowed)
       .def("_jit_texpr_set_fallback_allowed", &tensorexpr::setFallbackAllowed)
       .def(
@@ -519,6 +578,11 @@ void initJITBindings(PyObject* module) {
       .def(
           "_jit_pass_fold_prepacking_ops",
           [](script::Module& module) { return FoldPrePackingOps(module); })
+      .def(
+          "_jit_pass_insert_channels_last_conversions",
+          [](script::Module& module) {
+            return insertChannelsLastConversions(module);
+          })
       .def(
           "_jit_pass_optimize_for_mobile",
           [](script::Module& module) { return optimizeForMobile(module); })
@@ -626,8 +690,11 @@ void initJITBindings(PyObject* module) {
 
   py::class_<PyTorchStreamWriter>(m, "PyTorchFileWriter")
       .def(py::init<std::string>())
+      .def(py::init<std::string, size_t>())
       .def(py::init([](const py::object& buffer) {
         auto writer_func = [=](const void* data, size_t size) {
+          // write_record releases the GIL.
+          py::gil_scoped_acquire acquire;
           auto bytes = py::bytes(reinterpret_cast<const char*>(data), size);
           buffer.attr("write")(std::move(bytes));
           return size;
@@ -650,7 +717,8 @@ void initJITBindings(PyObject* module) {
              size_t size) {
             return self.writeRecord(
                 name, reinterpret_cast<const char*>(data), size);
-          });
+          },
+          py::call_guard<py::gil_scoped_release>());
 
   // This allows PyTorchStreamReader to read from a Python buffer. It requires
   // that the buffer implement `seek()`, `tell()`, and `read()`.
@@ -74,7 +74,6 @@ static_assert(
 
 struct ArgumentSpec {
   ArgumentSpec(size_t num_flat_tensor_inputs, size_t num_flat_optional_inputs) {
-    hash_code = hash_combine(num_flat_tensor_inputs, num_flat_optional_inputs);
     tensor_args.reserve(num_flat_tensor_inputs);
     optional_presence.reserve(num_flat_optional_inputs);
   }
@@ -82,7 +81,6 @@ struct ArgumentSpec {
   void addOptional(const IValue& input) {
     bool is_present = !input.isNone();
     optional_presence.push_back(is_present);
-    hash_code = hash_combine(hash_code, is_present);
   }
 
   void addTensor(const IValue& input, bool with_grad) {
@@ -100,18 +98,11 @@ struct ArgumentSpec {
     // show overhead in extra refcounting along this path
     const at::Tensor* t = reinterpret_cast<const at::Tensor*>(&input);
     if ((arg.defined_ = t->defined())) {
-      arg.requires_grad_ = with_grad && autograd::Variable(*t).requires_grad();
+      arg.requires_grad_ = with_grad && t->requires_grad();
       arg.dim_ = t->dim();
       arg.device_ = t->is_cuda() ? t->get_device() : -1;
       arg.type_ = static_cast<unsigned>(t->scalar_type());
     }
-    combineHash(arg);
-  }
-
-  void combineHash(const ArgumentInfo& arg) {
-    ArgumentInfo::plain_data_type arg_data;
-    std::memcpy(&arg_data, &arg, sizeof(ArgumentInfo));
-    hash_code = hash_combine(hash_code, arg_data);
   }
 
   // equality is fast: check ninputs, and then check the raw array data,
@@ -147,12 +138,28 @@ struct ArgumentSpec {
   bool isPresent(size_t i) const {
     return optional_presence[i];
   }
+  // Computed on first use rather than while the spec is built, as the graph
+  // executor first compares a new spec to the one it used last, which
+  // usually matches and needs no hash.
   size_t hashCode() const {
+    if (!hash_code_computed) {
+      hash_code = hash_combine(tensor_args.size(), optional_presence.size());
+      for (bool is_present : optional_presence) {
+        hash_code = hash_combine(hash_code, is_present);
+      }
+      for (const ArgumentInfo& arg : tensor_args) {
+        ArgumentInfo::plain_data_type arg_data;
+        std::memcpy(&arg_data, &arg, sizeof(ArgumentInfo));
+        hash_code = hash_combine(hash_code, arg_data);
+      }
+      hash_code_computed = true;
+    }
     return hash_code;
   }
 
  private:
-  size_t hash_code; // precomputed on construction
+  mutable size_t hash_code = 0;
+  mutable bool hash_code_computed = false;
   std::vector<ArgumentInfo> tensor_args;
   std::vector<bool> optional_presence;
 };
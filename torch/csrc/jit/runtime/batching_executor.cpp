@@ -0,0 +1,403 @@
+#include <torch/csrc/jit/runtime/batching_executor.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/inliner.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Ops whose result for each sample only depends on that sample, as long as
+// only their first input is batched.
+const std::unordered_set<Symbol>& rowwiseOps() {
+  static const std::unordered_set<Symbol> ops = [] {
+    std::unordered_set<Symbol> ops;
+    for (const char* name :
+         {"relu",        "sigmoid",    "tanh",        "gelu",
+          "exp",         "log",        "neg",         "abs",
+          "sqrt",        "rsqrt",      "erf",         "hardtanh",
+          "leaky_relu",  "elu",        "softplus",    "threshold",
+          "clamp",       "clamp_min",  "clamp_max",   "to",
+          "contiguous",  "clone",      "detach",      "linear",
+          "matmul",      "mm",         "conv1d",      "conv2d",
+          "conv3d",      "layer_norm", "prelu",       "reciprocal"}) {
+      ops.insert(Symbol::aten(name));
+    }
+    return ops;
+  }();
+  return ops;
+}
+
+// Elementwise ops, whose tensor inputs may all be batched.
+const std::unordered_set<Symbol>& elementwiseOps() {
+  static const std::unordered_set<Symbol> ops = [] {
+    std::unordered_set<Symbol> ops;
+    for (const char* name : {"add", "sub", "mul", "div", "pow", "where"}) {
+      ops.insert(Symbol::aten(name));
+    }
+    return ops;
+  }();
+  return ops;
+}
+
+// Ops that keep samples separate if their dim arguments, from the second
+// input on, are constants that don't refer to the batch dimension.
+const std::unordered_map<Symbol, size_t>& dimOps() {
+  static const std::unordered_map<Symbol, size_t> ops = {
+      {aten::softmax, 1},
+      {aten::log_softmax, 1},
+      {aten::sum, 1},
+      {aten::mean, 1},
+      {aten::flatten, 1},
+      {aten::unsqueeze, 1},
+      {aten::transpose, 2},
+      {aten::cat, 1},
+      {aten::stack, 1},
+  };
+  return ops;
+}
+
+bool isConstantNonBatchDim(const Value* v) {
+  auto ival = toIValue(v);
+  if (!ival) {
+    return false;
+  }
+  if (ival->isInt()) {
+    return ival->toInt() >= 1;
+  }
+  if (ival->isIntList()) {
+    auto dims = ival->toIntVector();
+    return !dims.empty() &&
+        std::all_of(dims.begin(), dims.end(), [](int64_t d) { return d >= 1; });
+  }
+  return false;
+}
+
+bool isConstantFalse(const Value* v) {
+  auto ival = toIValue(v);
+  return ival && ival->isBool() && !ival->toBool();
+}
+
+class BatchabilityCheck {
+ public:
+  explicit BatchabilityCheck(const std::shared_ptr<Graph>& graph)
+      : graph_(graph) {}
+
+  bool run() {
+    auto inputs = graph_->inputs();
+    for (size_t i = 1; i < inputs.size(); ++i) {
+      if (!inputs[i]->type()->isSubtypeOf(TensorType::get())) {
+        return fail("input ", inputs[i]->debugName(), " isn't a tensor");
+      }
+      batched_.insert(inputs[i]);
+    }
+    for (Node* n : graph_->nodes()) {
+      if (!visit(n)) {
+        return false;
+      }
+    }
+    for (Value* v : graph_->outputs()) {
+      if (!batched_.count(v)) {
+        return fail("output ", v->debugName(), " isn't batched");
+      }
+    }
+    return true;
+  }
+
+ private:
+  template <typename... Args>
+  bool fail(const Args&... args) {
+    GRAPH_DEBUG("Not batchable: ", args...);
+    return false;
+  }
+
+  bool isBatched(const Value* v) const {
+    return batched_.count(v);
+  }
+
+  bool onlyBatched(Node* n, size_t i) const {
+    for (size_t j = 0; j < n->inputs().size(); ++j) {
+      if (isBatched(n->input(j)) != (i == j)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool usesBatched(Node* n) const {
+    for (Value* v : n->inputs()) {
+      if (isBatched(v)) {
+        return true;
+      }
+    }
+    for (Block* b : n->blocks()) {
+      for (Node* inner : b->nodes()) {
+        if (usesBatched(inner)) {
+          return true;
+        }
+      }
+      if (usesBatched(b->return_node())) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void markOutputs(Node* n) {
+    for (Value* v : n->outputs()) {
+      batched_.insert(v);
+    }
+  }
+
+  bool visit(Node* n) {
+    if (!usesBatched(n)) {
+      return true;
+    }
+    if (!n->blocks().empty() || n->hasSideEffects()) {
+      return fail("control flow or side effects on batched values");
+    }
+    Symbol kind = n->kind();
+    bool ok = false;
+    if (kind == prim::ListConstruct || kind == prim::TupleConstruct) {
+      bool all = std::all_of(
+          n->inputs().begin(), n->inputs().end(), [&](const Value* v) {
+            return isBatched(v);
+          });
+      // A tuple with unbatched elements can't be split, but its batched
+      // elements may still be unpacked.
+      if (!all && kind == prim::TupleConstruct) {
+        return true;
+      }
+      ok = all;
+    } else if (kind == prim::TupleUnpack) {
+      ok = true;
+    } else if (elementwiseOps().count(kind)) {
+      ok = true;
+    } else if (rowwiseOps().count(kind)) {
+      ok = onlyBatched(n, 0);
+    } else if (dimOps().count(kind)) {
+      size_t num_dims = dimOps().at(kind);
+      ok = onlyBatched(n, 0) && n->inputs().size() > num_dims;
+      for (size_t i = 1; ok && i <= num_dims; ++i) {
+        ok = isConstantNonBatchDim(n->input(i));
+      }
+    } else if (kind == aten::addmm) {
+      ok = onlyBatched(n, 1);
+    } else if (kind == aten::embedding) {
+      ok = onlyBatched(n, 1);
+    } else if (kind == aten::batch_norm) {
+      ok = onlyBatched(n, 0) && n->inputs().size() > 5 &&
+          isConstantFalse(n->input(5));
+    } else if (kind == aten::dropout || kind == aten::feature_dropout) {
+      ok = onlyBatched(n, 0) && isConstantFalse(n->input(2));
+    }
+    if (!ok) {
+      return fail("unsupported use of batched values by ", *n);
+    }
+    markOutputs(n);
+    return true;
+  }
+
+  std::shared_ptr<Graph> graph_;
+  std::unordered_set<const Value*> batched_;
+};
+
+// Splits OUTPUT, of a batch whose requests have the given sizes along dim 0,
+// into the outputs of the requests.
+bool splitOutput(
+    const IValue& output,
+    const std::vector<int64_t>& sizes,
+    int64_t total,
+    std::vector<IValue>& results) {
+  if (output.isTensor()) {
+    const at::Tensor& t = output.toTensor();
+    if (t.dim() == 0 || t.size(0) != total) {
+      return false;
+    }
+    auto parts = at::split_with_sizes(t, sizes);
+    for (size_t i = 0; i < parts.size(); ++i) {
+      results[i] = std::move(parts[i]);
+    }
+    return true;
+  }
+  if (output.isTuple()) {
+    const auto& elements = output.toTuple()->elements();
+    std::vector<std::vector<IValue>> split(sizes.size());
+    for (const IValue& element : elements) {
+      std::vector<IValue> parts(sizes.size());
+      if (!splitOutput(element, sizes, total, parts)) {
+        return false;
+      }
+      for (size_t i = 0; i < sizes.size(); ++i) {
+        split[i].push_back(std::move(parts[i]));
+      }
+    }
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      results[i] = c10::ivalue::Tuple::create(std::move(split[i]));
+    }
+    return true;
+  }
+  return false;
+}
+
+} // namespace
+
+bool isBatchable(const std::shared_ptr<Graph>& graph) {
+  auto copy = graph->copy();
+  Inline(*copy);
+  return BatchabilityCheck(copy).run();
+}
+
+BatchingExecutor::BatchingExecutor(
+    Module module,
+    BatchingOptions options,
+    const std::string& method_name)
+    : module_(std::move(module)),
+      method_(module_.get_method(method_name)),
+      options_(options),
+      batchable_(isBatchable(method_.graph())) {
+  TORCH_CHECK(options_.max_batch_size > 0, "max_batch_size must be positive");
+  worker_ = std::thread([this] { workerLoop(); });
+}
+
+BatchingExecutor::~BatchingExecutor() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  worker_.join();
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> BatchingExecutor::enqueue(
+    std::vector<IValue> inputs) {
+  auto future = c10::make_intrusive<c10::ivalue::Future>(
+      method_.function().getSchema().returns().at(0).type());
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    TORCH_CHECK(!stop_, "BatchingExecutor is shutting down");
+    queue_.push_back(
+        {std::move(inputs), future, std::chrono::steady_clock::now()});
+  }
+  cv_.notify_one();
+  return future;
+}
+
+IValue BatchingExecutor::run(std::vector<IValue> inputs) {
+  auto future = enqueue(std::move(inputs));
+  future->wait();
+  return future->value();
+}
+
+void BatchingExecutor::workerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    // Wait for a full batch until the oldest request times out.
+    auto deadline = queue_.front().enqueued + options_.timeout;
+    cv_.wait_until(lock, deadline, [this] {
+      return stop_ || queue_.size() >= options_.max_batch_size;
+    });
+    std::vector<Request> batch;
+    while (!queue_.empty() && batch.size() < options_.max_batch_size) {
+      batch.push_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    lock.unlock();
+    runBatch(batch);
+    lock.lock();
+  }
+}
+
+IValue BatchingExecutor::call(std::vector<IValue> inputs) {
+  torch::autograd::AutoGradMode no_grad(false);
+  return method_(std::move(inputs));
+}
+
+void BatchingExecutor::runOne(Request& request) {
+  try {
+    request.future->markCompleted(call(std::move(request.inputs)));
+  } catch (const std::exception& e) {
+    request.future->setError(e.what());
+  }
+}
+
+bool BatchingExecutor::tryRunBatched(std::vector<Request>& batch) {
+  size_t num_inputs = batch[0].inputs.size();
+  std::vector<int64_t> sizes;
+  for (const Request& request : batch) {
+    if (request.inputs.size() != num_inputs || num_inputs == 0) {
+      return false;
+    }
+    const IValue& first = request.inputs[0];
+    if (!first.isTensor() || first.toTensor().dim() == 0) {
+      return false;
+    }
+    sizes.push_back(first.toTensor().size(0));
+  }
+
+  // The inputs of all requests must agree in everything but dim 0, and on
+  // the size of dim 0 along the inputs of a request.
+  std::vector<IValue> inputs;
+  for (size_t i = 0; i < num_inputs; ++i) {
+    std::vector<at::Tensor> parts;
+    for (size_t r = 0; r < batch.size(); ++r) {
+      const IValue& input = batch[r].inputs[i];
+      if (!input.isTensor()) {
+        return false;
+      }
+      const at::Tensor& t = input.toTensor();
+      const at::Tensor* ref = parts.empty() ? &t : &parts[0];
+      if (t.dim() == 0 || t.size(0) != sizes[r] ||
+          t.sizes().slice(1) != ref->sizes().slice(1) ||
+          !t.options().type_equal(ref->options())) {
+        return false;
+      }
+      parts.push_back(t);
+    }
+    inputs.emplace_back(at::cat(parts));
+  }
+
+  int64_t total = 0;
+  for (int64_t size : sizes) {
+    total += size;
+  }
+  std::vector<IValue> results(batch.size());
+  try {
+    if (!splitOutput(call(std::move(inputs)), sizes, total, results)) {
+      return false;
+    }
+  } catch (const std::exception& e) {
+    // Report the errors of the offending requests on their own.
+    GRAPH_DEBUG("Batched run failed, running requests one by one: ", e.what());
+    return false;
+  }
+  for (size_t r = 0; r < batch.size(); ++r) {
+    batch[r].future->markCompleted(std::move(results[r]));
+  }
+  return true;
+}
+
+void BatchingExecutor::runBatch(std::vector<Request>& batch) {
+  if (batchable_ && batch.size() > 1 && tryRunBatched(batch)) {
+    return;
+  }
+  for (Request& request : batch) {
+    runOne(request);
+  }
+}
+
+} // namespace jit
+} // namespace torch
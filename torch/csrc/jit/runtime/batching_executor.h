@@ -0,0 +1,89 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/jit/api/module.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace torch {
+namespace jit {
+
+// Dynamic batching of concurrent calls to a method of a module.
+//
+// Requests are queued and a worker thread runs them in batches: it waits for
+// up to max_batch_size requests, or until the oldest one has waited for
+// timeout, concatenates the inputs of the batch along dim 0, runs the method
+// once and splits its outputs back into the results of the requests.
+//
+// Batching is only correct if every sample of the batch is computed
+// independently of the others. This is checked on the graph of the method:
+// its inputs must be tensors with a batch dimension, its outputs tensors (or
+// tuples of tensors) with a batch dimension, and every op on batched values
+// must be known to keep samples separate (elementwise ops, linear layers,
+// convolutions, norms in eval mode, reductions over other dims, ...).
+// Methods that fail the check, and batches whose inputs don't agree in
+// everything but dim 0, run one request at a time.
+//
+// Requests run without gradients.
+struct TORCH_API BatchingOptions {
+  size_t max_batch_size = 32;
+  std::chrono::microseconds timeout{1000};
+};
+
+// Whether GRAPH, a graph of a method whose first input is self, can run on
+// inputs concatenated along dim 0.
+TORCH_API bool isBatchable(const std::shared_ptr<Graph>& graph);
+
+class TORCH_API BatchingExecutor {
+ public:
+  explicit BatchingExecutor(
+      Module module,
+      BatchingOptions options = BatchingOptions(),
+      const std::string& method_name = "forward");
+  // Finishes the queued requests.
+  ~BatchingExecutor();
+
+  BatchingExecutor(const BatchingExecutor&) = delete;
+  BatchingExecutor& operator=(const BatchingExecutor&) = delete;
+
+  // Queues a call with INPUTS, not including self.
+  c10::intrusive_ptr<c10::ivalue::Future> enqueue(std::vector<IValue> inputs);
+
+  // Queues a call and waits for its result.
+  IValue run(std::vector<IValue> inputs);
+
+  bool batchable() const {
+    return batchable_;
+  }
+
+ private:
+  struct Request {
+    std::vector<IValue> inputs;
+    c10::intrusive_ptr<c10::ivalue::Future> future;
+    std::chrono::steady_clock::time_point enqueued;
+  };
+
+  void workerLoop();
+  void runBatch(std::vector<Request>& batch);
+  bool tryRunBatched(std::vector<Request>& batch);
+  void runOne(Request& request);
+  IValue call(std::vector<IValue> inputs);
+
+  Module module_;
+  Method method_;
+  BatchingOptions options_;
+  bool batchable_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request> queue_;
+  bool stop_ = false;
+  std::thread worker_;
+};
+
+} // namespace jit
+} // namespace torch
@@ -1,5 +1,6 @@
 #include <torch/csrc/jit/runtime/graph_executor.h>
 
+#include <ATen/Parallel.h>
 #include <ATen/core/ivalue.h>
 #include <c10/util/Exception.h>
 #include <torch/csrc/autograd/grad_mode.h>
@@ -22,6 +23,7 @@
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_grad_of.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/parallelize_branches.h>
 #include <torch/csrc/jit/passes/pass_manager.h>
 #include <torch/csrc/jit/passes/peephole.h>
 #include <torch/csrc/jit/passes/remove_expands.h>
@@ -47,6 +49,7 @@
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -75,6 +78,11 @@ thread_local std::weak_ptr<Graph> last_executed_optimized_graph;
 std::shared_ptr<Graph> lastExecutedOptimizedGraph() {
   return last_executed_optimized_graph.lock();
 }
+
+static std::atomic<bool> background_compilation_mode{false};
+std::atomic<bool>& getBackgroundCompilationMode() {
+  return background_compilation_mode;
+}
 namespace {
 
 using tensor_list = std::vector<at::Tensor>;
@@ -482,7 +490,9 @@ void GraphExecutorImplBase::run(Stack& stack) {
   last_executed_optimized_graph = plan.graph;
 }
 
-c10::intrusive_ptr<Future> GraphExecutorImplBase::runAsync(Stack& stack) {
+c10::intrusive_ptr<Future> GraphExecutorImplBase::runAsync(
+    Stack& stack,
+    TaskLauncher taskLauncher) {
   TORCH_CHECK(
       stack.size() >= num_inputs,
       "expected ",
@@ -495,13 +505,14 @@ c10::intrusive_ptr<Future> GraphExecutorImplBase::runAsync(Stack& stack) {
       logging::runtime_counters::GRAPH_EXECUTOR_INVOCATIONS, 1.0);
 
   struct Frame {
-    explicit Frame(ExecutionPlan eplan)
-        : plan(std::move(eplan)), state(plan.code) {}
+    explicit Frame(ExecutionPlan eplan, TaskLauncher taskLauncher)
+        : plan(std::move(eplan)), state(plan.code, std::move(taskLauncher)) {}
     ExecutionPlan plan;
     InterpreterState state;
   };
   auto frame = std::make_shared<Frame>(
-      getPlanFor(stack, GraphExecutor::getDefaultNumBailOuts()));
+      getPlanFor(stack, GraphExecutor::getDefaultNumBailOuts()),
+      std::move(taskLauncher));
   auto res = frame->state.runAsync(stack);
   last_executed_optimized_graph = frame->plan.graph;
   if (!res->completed()) {
@@ -511,6 +522,53 @@ c10::intrusive_ptr<Future> GraphExecutorImplBase::runAsync(Stack& stack) {
   return res;
 }
 
+bool GraphExecutorImplBase::useBackgroundCompilation() const {
+  return getBackgroundCompilationMode() && !background_compilation_failed_;
+}
+
+void GraphExecutorImplBase::compileInBackground(
+    std::function<void()> compile) {
+  {
+    std::lock_guard<std::mutex> lock(background_mutex_);
+    ++pending_background_compilations_;
+  }
+  // The optimization passes read these thread local settings of the caller.
+  const bool inlining = autodiff_subgraph_inlining;
+  const bool optimize = getGraphExecutorOptimize();
+  auto self = shared_from_this();
+  at::launch([self, inlining, optimize, compile = std::move(compile)]() {
+    autodiff_subgraph_inlining = inlining;
+    setGraphExecutorOptimize(optimize);
+    try {
+      compile();
+    } catch (const std::exception& e) {
+      GRAPH_DEBUG("Background compilation failed: ", e.what());
+      self->background_compilation_failed_ = true;
+    }
+    std::lock_guard<std::mutex> lock(self->background_mutex_);
+    if (--self->pending_background_compilations_ == 0) {
+      self->background_done_.notify_all();
+    }
+  });
+}
+
+void GraphExecutorImplBase::waitForBackgroundCompilation() {
+  std::unique_lock<std::mutex> lock(background_mutex_);
+  background_done_.wait(
+      lock, [this] { return pending_background_compilations_ == 0; });
+}
+
+// The plan a thread last got from a GraphExecutorImpl, and the spec it is
+// for. Executors are told apart by id rather than by address, as a new
+// executor may reuse the address of a destroyed one.
+struct LastPlanHit {
+  size_t executor_id = 0;
+  c10::optional<ArgumentSpec> spec;
+  const ExecutionPlan* plan = nullptr;
+};
+thread_local LastPlanHit last_plan_hit;
+std::atomic<size_t> next_executor_id{1};
+
 // a Graph can be created via tracing, or via a language-based frontend
 // GraphExecutor runs it. It can run the same graph on many different sizes
 // and different requires_grad states, and handles specializations for each
@@ -521,7 +579,8 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
       const std::shared_ptr<Graph>& graph,
       std::string function_name)
       : GraphExecutorImplBase(graph, std::move(function_name)),
-        arg_spec_creator_(*graph) {
+        arg_spec_creator_(*graph),
+        executor_id_(next_executor_id++) {
     logging::getLogger()->addStatValue(
         logging::runtime_counters::GRAPH_EXECUTORS_CONSTRUCTED, 1.0);
   }
@@ -533,6 +592,7 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
   }
 
   GraphExecutorState getDebugState() override {
+    std::lock_guard<std::mutex> lock(compile_mutex);
     GraphExecutorState state;
     state.graph = graph.get();
     if (fallback) {
@@ -549,6 +609,11 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
 
   const ExecutionPlan& getOrCompileFallback() {
     std::lock_guard<std::mutex> lock(compile_mutex);
+    return getOrCompileFallbackLocked();
+  }
+
+  // Requires compile_mutex to be held.
+  const ExecutionPlan& getOrCompileFallbackLocked() {
     if (!fallback) {
       auto graph_ = graph->copy();
       runRequiredPasses(graph_);
@@ -559,25 +624,56 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
 
   const ExecutionPlan& getOrCompile(const Stack& stack) {
     // outside lock guard, to minimize the time holding the lock on the fast
-    // path ArgumentSpec even computes its hashCode here.
+    // path
     ArgumentSpec spec =
         arg_spec_creator_.create(autograd::GradMode::is_enabled(), stack);
+    // Most executors get the same kind of inputs call after call, so first
+    // compare the spec to the one this thread ran last, which needs neither
+    // its hash nor the lock. Plans are never removed from plan_cache, so the
+    // pointer is valid as long as this executor is.
+    if (last_plan_hit.executor_id == executor_id_ &&
+        *last_plan_hit.spec == spec) {
+      logging::getLogger()->addStatValue(
+          logging::runtime_counters::EXECUTION_PLAN_CACHE_HIT, 1.0);
+      return *last_plan_hit.plan;
+    }
+    spec.hashCode();
     {
       std::lock_guard<std::mutex> lock(compile_mutex);
       auto it = plan_cache.find(spec);
       if (it != plan_cache.end()) {
         logging::getLogger()->addStatValue(
             logging::runtime_counters::EXECUTION_PLAN_CACHE_HIT, 1.0);
+        rememberPlan(it->first, it->second);
         return it->second;
       }
+      if (useBackgroundCompilation()) {
+        // Run the graph unoptimized until the plan for this spec is ready.
+        if (pending_specs_.insert(spec).second) {
+          compileInBackground([this, spec]() {
+            auto plan = compileSpec(spec);
+            std::lock_guard<std::mutex> lock(compile_mutex);
+            plan_cache.emplace(spec, std::move(plan));
+            pending_specs_.erase(spec);
+          });
+        }
+        return getOrCompileFallbackLocked();
+      }
       auto plan = compileSpec(spec);
       auto r = plan_cache.emplace(std::move(spec), std::move(plan));
       logging::getLogger()->addStatValue(
           logging::runtime_counters::EXECUTION_PLAN_CACHE_MISS, 1.0);
+      rememberPlan(r.first->first, r.first->second);
       return r.first->second;
     }
   }
 
+  void rememberPlan(const ArgumentSpec& spec, const ExecutionPlan& plan) {
+    last_plan_hit.executor_id = executor_id_;
+    last_plan_hit.spec = spec;
+    last_plan_hit.plan = &plan;
+  }
+
   ExecutionPlan compileSpec(const ArgumentSpec& spec) {
     auto opt_graph = graph->copy();
     SOURCE_DUMP("Optimizing the following function:", opt_graph);
@@ -636,6 +732,9 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
           autodiff_subgraph_inlining ? autodiffSubgraphInlineThreshold : 1);
     } else {
       runNondiffOptimization(opt_graph);
+      if (parallelizeBranchesEnabled()) {
+        ParallelizeBranches(opt_graph);
+      }
     }
     // Make sure there are no leftovers from any passes.
     EliminateDeadCode(opt_graph);
@@ -652,6 +751,12 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
   // Mapping from argument configurations to optimized versions of the graph
   // that are specialized to the spec.
   std::unordered_map<ArgumentSpec, ExecutionPlan> plan_cache;
+
+  // The specs that are being compiled in the background.
+  std::unordered_set<ArgumentSpec> pending_specs_;
+
+  // Identifies this executor in last_plan_hit
+  const size_t executor_id_;
 };
 
 GraphExecutor::GraphExecutor(
@@ -670,8 +775,10 @@ void GraphExecutor::run(Stack& inputs) {
   return pImpl->run(inputs);
 }
 
-c10::intrusive_ptr<Future> GraphExecutor::runAsync(Stack& stack) {
-  return pImpl->runAsync(stack);
+c10::intrusive_ptr<Future> GraphExecutor::runAsync(
+    Stack& stack,
+    TaskLauncher taskLauncher) {
+  return pImpl->runAsync(stack, std::move(taskLauncher));
 }
 
 size_t GraphExecutor::getDefaultNumBailOuts() {
@@ -692,6 +799,10 @@ GraphExecutorState GraphExecutor::getDebugState() {
   return pImpl->getDebugState();
 }
 
+void GraphExecutor::waitForBackgroundCompilation() {
+  pImpl->waitForBackgroundCompilation();
+}
+
 TORCH_API bool IsNewExecutorEnabled() {
   static const auto disable_new_executor =
       std::getenv("TORCH_JIT_DISABLE_NEW_EXECUTOR");
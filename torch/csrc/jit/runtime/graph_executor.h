@@ -49,7 +49,9 @@ struct TORCH_API GraphExecutor {
   GraphExecutor(std::shared_ptr<Graph> graph, std::string function_name);
 
   void run(Stack& inputs);
-  c10::intrusive_ptr<Future> runAsync(Stack& stack);
+  c10::intrusive_ptr<Future> runAsync(
+      Stack& stack,
+      TaskLauncher taskLauncher = at::launch);
 
   // `remaining_bailout_depth` stands for the maximum number of profiled and
   // specialized recompilations allowed for the current `GraphExecutor`. if
@@ -70,6 +72,10 @@ struct TORCH_API GraphExecutor {
   std::shared_ptr<Graph> graph() const;
   GraphExecutorState getDebugState();
 
+  // Blocks until the optimizations started in the background, when
+  // getBackgroundCompilationMode() is set, are done.
+  void waitForBackgroundCompilation();
+
   static size_t getDefaultNumBailOuts();
 
  private:
@@ -89,6 +95,12 @@ TORCH_API std::atomic<size_t>& getNumProfiledRuns();
 TORCH_API std::atomic<size_t>& getBailoutDepth();
 TORCH_API bool IsNewExecutorEnabled();
 
+// If set, GraphExecutors don't optimize their graph on the first run: they run
+// it unoptimized and optimize it on the inter-op thread pool, so that several
+// functions are optimized in parallel, and switch to the optimized plan once
+// it is ready.
+TORCH_API std::atomic<bool>& getBackgroundCompilationMode();
+
 struct TORCH_API GraphOptimizerEnabledGuard {
   GraphOptimizerEnabledGuard(bool state)
       : old_state_(getGraphExecutorOptimize()) {
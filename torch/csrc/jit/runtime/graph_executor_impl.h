@@ -18,7 +18,10 @@
 #include <torch/csrc/jit/frontend/ir_emitter.h>
 #include <torch/csrc/jit/runtime/logging.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <mutex>
@@ -48,7 +51,8 @@ const size_t autodiffSubgraphInlineThreshold = 5;
 // and different requires_grad states, and handles specializations for each
 // situation. GraphExecutor is completely unaware of tracing or module
 // parameters to keep the tracing concerns separated.
-struct GraphExecutorImplBase {
+struct GraphExecutorImplBase
+    : public std::enable_shared_from_this<GraphExecutorImplBase> {
   static std::shared_ptr<Graph> prepareGraph(
       const std::shared_ptr<Graph>& graph) {
     auto copy = graph->copy();
@@ -66,7 +70,9 @@ struct GraphExecutorImplBase {
 
   // entry point where execution begins
   void run(Stack& stack);
-  c10::intrusive_ptr<Future> runAsync(Stack& stack);
+  c10::intrusive_ptr<Future> runAsync(
+      Stack& stack,
+      TaskLauncher taskLauncher = at::launch);
 
   virtual ExecutionPlan getPlanFor(
       Stack& stack,
@@ -74,9 +80,25 @@ struct GraphExecutorImplBase {
   virtual GraphExecutorState getDebugState() = 0;
   virtual ~GraphExecutorImplBase() = default;
 
+  // Blocks until the optimizations getPlanFor started in the background are
+  // done.
+  void waitForBackgroundCompilation();
+
  protected:
   friend struct GraphExecutor;
 
+  // Whether getPlanFor should optimize in the background, and run unoptimized
+  // plans until the optimized ones are ready: getBackgroundCompilationMode() is
+  // set and no background optimization of this executor failed. After a
+  // failure, optimization happens in getPlanFor again, so that its error is
+  // reported to the caller.
+  bool useBackgroundCompilation() const;
+
+  // Runs `compile` on the inter-op thread pool, keeping this executor alive
+  // until it is done. `compile` must install the plans it compiles itself,
+  // holding compile_mutex.
+  void compileInBackground(std::function<void()> compile);
+
   // The unoptimized starting graph. This field is effectively const, but we
   // can't make it so because Graph::copy() is not const (and making it const is
   // not that easy at this point).
@@ -91,6 +113,12 @@ struct GraphExecutorImplBase {
   // GraphExecutors can be accessed from multiple threads, so this thread needs
   // to be held every time we access the fallback or plan_cache.
   std::mutex compile_mutex;
+
+ private:
+  std::atomic<bool> background_compilation_failed_{false};
+  std::mutex background_mutex_;
+  std::condition_variable background_done_;
+  size_t pending_background_compilations_ = 0;
 };
 
 } // namespace jit
@@ -3,6 +3,7 @@
 #include <memory>
 #include <vector>
 
+#include <ATen/core/function.h>
 #include <ATen/core/ivalue.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
@@ -64,7 +65,11 @@ struct TORCH_API Code {
 };
 
 struct InterpreterState {
-  TORCH_API InterpreterState(const Code& code);
+  // taskLauncher schedules the continuation when the interpreter resumes
+  // after a suspending wait and runs forked subtasks, which inherit it.
+  TORCH_API InterpreterState(
+      const Code& code,
+      TaskLauncher taskLauncher = at::launch);
   TORCH_API void run(Stack& stack);
   c10::intrusive_ptr<Future> runAsync(Stack& stack);
   c10::intrusive_ptr<Future> getFuture();
@@ -0,0 +1,442 @@
+#include <torch/csrc/jit/runtime/lazy_tensor.h>
+
+#include <ATen/core/dispatch/Dispatcher.h>
+#include <ATen/core/stack.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/passes/canonicalize.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/shape_analysis.h>
+#include <torch/csrc/jit/runtime/graph_executor.h>
+#include <torch/library.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+struct LazyGraph;
+
+// The value of a lazy tensor, shared by all of its shallow copies: the
+// output of a node of a pending graph until that graph runs, and the
+// resulting tensor afterwards. `graph` never changes; it is null for the
+// tensors made by toLazy, which are materialized from the start.
+struct LazyTensorState {
+  std::shared_ptr<LazyGraph> graph;
+  Value* value = nullptr;
+  at::Tensor tensor;
+};
+
+// The ops recorded by one thread since its last materialization. Guarded by
+// mutex, since any thread holding one of its lazy tensors may run it.
+struct LazyGraph {
+  std::mutex mutex;
+  std::shared_ptr<Graph> graph = std::make_shared<Graph>();
+  // The tensors passed for the inputs of graph.
+  std::vector<at::Tensor> inputs;
+  std::vector<std::weak_ptr<LazyTensorState>> outputs;
+  bool flushed = false;
+  std::string error;
+};
+
+std::shared_ptr<LazyGraph>& currentGraph() {
+  thread_local std::shared_ptr<LazyGraph> graph =
+      std::make_shared<LazyGraph>();
+  return graph;
+}
+
+struct LazyTensorImpl : public c10::TensorImpl {
+  LazyTensorImpl(
+      std::shared_ptr<LazyTensorState> state,
+      at::ScalarType dtype,
+      at::Device device,
+      at::IntArrayRef sizes,
+      at::IntArrayRef strides)
+      : TensorImpl(
+            c10::DispatchKeySet(c10::DispatchKey::Lazy),
+            c10::scalarTypeToTypeMeta(dtype),
+            device),
+        state_(std::move(state)) {
+    set_sizes_and_strides(sizes, strides);
+  }
+
+  bool has_storage() const override {
+    return false;
+  }
+
+  const at::Storage& storage() const override {
+    AT_ERROR("lazy tensors do not have storage");
+  }
+
+  int64_t storage_offset() const override {
+    AT_ERROR("lazy tensors do not have storage");
+  }
+
+  c10::intrusive_ptr<TensorImpl> shallow_copy_and_detach(
+      const c10::VariableVersion& version_counter,
+      bool allow_tensor_metadata_change) const override {
+    auto impl = c10::make_intrusive<LazyTensorImpl>(
+        state_,
+        c10::typeMetaToScalarType(dtype()),
+        device(),
+        sizes(),
+        strides());
+    copy_tensor_metadata(
+        /*src_impl=*/this,
+        /*dest_impl=*/impl.get(),
+        /*version_counter=*/version_counter,
+        /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
+    impl->refresh_numel();
+    return impl;
+  }
+
+  void shallow_copy_from(const c10::intrusive_ptr<TensorImpl>& impl) override {
+    AT_ASSERT(has_compatible_shallow_copy_type(impl->key_set()));
+    auto lazy_impl = static_cast<const LazyTensorImpl*>(impl.get());
+    copy_tensor_metadata(
+        /*src_impl=*/lazy_impl,
+        /*dest_impl=*/this,
+        /*version_counter=*/version_counter(),
+        /*allow_tensor_metadata_change=*/allow_tensor_metadata_change());
+    refresh_numel();
+    state_ = lazy_impl->state_;
+  }
+
+  // After an op wrote to the materialized tensor, e.g., resized an out=
+  // argument.
+  void refreshMetadata() {
+    set_sizes_and_strides(state_->tensor.sizes(), state_->tensor.strides());
+  }
+
+  std::shared_ptr<LazyTensorState> state_;
+};
+
+LazyTensorImpl* lazyImpl(const at::Tensor& tensor) {
+  if (!tensor.defined() || !tensor.key_set().has(c10::DispatchKey::Lazy)) {
+    return nullptr;
+  }
+  return static_cast<LazyTensorImpl*>(tensor.unsafeGetTensorImpl());
+}
+
+at::Tensor makeLazyTensor(
+    std::shared_ptr<LazyTensorState> state,
+    const TensorType& type) {
+  return at::detail::make_tensor<LazyTensorImpl>(
+      std::move(state),
+      *type.scalarType(),
+      *type.device(),
+      *type.sizes().concrete_sizes(),
+      *type.strides().concrete_sizes());
+}
+
+struct GraphCache {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<GraphExecutor>> executors;
+};
+
+GraphCache& graphCache() {
+  static GraphCache cache;
+  return cache;
+}
+
+void runCached(const std::shared_ptr<Graph>& graph, Stack& stack) {
+  auto canonical = Canonicalize(graph, /*keep_unique_names=*/false);
+  // The printed graph holds the types and constants of the graph as well.
+  const std::string key = canonical->toString(/*print_source_locations=*/false);
+  std::shared_ptr<GraphExecutor> executor;
+  {
+    auto& cache = graphCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto& entry = cache.executors[key];
+    if (!entry) {
+      entry = std::make_shared<GraphExecutor>(canonical, "lazy_graph");
+    }
+    executor = entry;
+  }
+  executor->run(stack);
+}
+
+// Runs the graph for its live outputs. The mutex of g must be held.
+void flush(LazyGraph& g) {
+  if (g.flushed) {
+    return;
+  }
+  g.flushed = true;
+  std::vector<std::shared_ptr<LazyTensorState>> outputs;
+  for (const auto& weak : g.outputs) {
+    if (auto state = weak.lock()) {
+      g.graph->registerOutput(state->value);
+      outputs.push_back(std::move(state));
+    }
+  }
+  auto graph = std::move(g.graph);
+  Stack stack(g.inputs.begin(), g.inputs.end());
+  g.inputs.clear();
+  g.outputs.clear();
+  if (outputs.empty()) {
+    return;
+  }
+  EliminateDeadCode(graph);
+  try {
+    runCached(graph, stack);
+  } catch (const std::exception& e) {
+    g.error = e.what();
+    throw;
+  }
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    outputs[i]->tensor = std::move(stack[i]).toTensor();
+    outputs[i]->value = nullptr;
+  }
+}
+
+bool isRecordableConstant(const IValue& v) {
+  return v.isNone() || v.isInt() || v.isDouble() || v.isBool() ||
+      v.isString() || v.isIntList() || v.isDoubleList() || v.isBoolList() ||
+      v.isDevice();
+}
+
+// Returns the complete output type of a single node, by running shape
+// analysis on a graph with only that node and its inputs, or nullptr.
+TensorTypePtr inferOutputType(Node* node) {
+  auto graph = std::make_shared<Graph>();
+  std::unordered_map<Value*, Value*> value_map;
+  for (Value* input : node->inputs()) {
+    if (value_map.count(input)) {
+      continue;
+    }
+    if (input->node()->kind() == prim::Constant) {
+      Node* constant = graph->insertNode(graph->createClone(
+          input->node(), [](Value*) -> Value* { return nullptr; }));
+      value_map[input] = constant->output();
+    } else {
+      value_map[input] = graph->addInput()->setType(input->type());
+    }
+  }
+  Node* clone = graph->insertNode(
+      graph->createClone(node, [&](Value* v) { return value_map.at(v); }));
+  graph->registerOutput(clone->output());
+  PropagateInputShapes(graph);
+  auto type = clone->output()->type()->cast<TensorType>();
+  return type && type->isComplete() ? type : nullptr;
+}
+
+// Records the op on the stack into the graph of the current thread and
+// replaces its arguments with a lazy tensor for its output. Returns false,
+// leaving the stack as is, if the op can't be recorded.
+bool lazyRecord(const c10::OperatorHandle& op, Stack* stack) {
+  const auto& schema = op.schema();
+  if (schema.is_vararg() || schema.is_varret() ||
+      schema.returns().size() != 1 ||
+      schema.returns()[0].type()->kind() != TypeKind::TensorType ||
+      schema.returns()[0].alias_info()) {
+    return false;
+  }
+  for (const auto& argument : schema.arguments()) {
+    if (argument.alias_info()) {
+      return false;
+    }
+  }
+  const size_t num_arguments = schema.arguments().size();
+  std::vector<IValue> arguments = last(*stack, num_arguments).vec();
+  for (const auto& argument : arguments) {
+    if (argument.isTensor()) {
+      const at::Tensor& tensor = argument.toTensor();
+      if (!tensor.defined() || tensor.requires_grad()) {
+        return false;
+      }
+    } else if (!isRecordableConstant(argument)) {
+      return false;
+    }
+  }
+
+  // Lazy tensors of other threads go in as regular tensors. Materialize them
+  // before locking the graph of this thread, which other threads might be
+  // waiting for.
+  auto g = currentGraph();
+  for (auto& argument : arguments) {
+    if (!argument.isTensor()) {
+      continue;
+    }
+    auto impl = lazyImpl(argument.toTensor());
+    if (impl && impl->state_->graph != g) {
+      argument = materialize(argument.toTensor());
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(g->mutex);
+  if (g->flushed) {
+    // Another thread ran it in the meantime; the tensors of this graph used
+    // as arguments are materialized now.
+    lock.unlock();
+    g = currentGraph() = std::make_shared<LazyGraph>();
+    lock = std::unique_lock<std::mutex>(g->mutex);
+  }
+  Graph& graph = *g->graph;
+  std::vector<Value*> inputs;
+  inputs.reserve(num_arguments);
+  for (const auto& argument : arguments) {
+    if (!argument.isTensor()) {
+      inputs.push_back(graph.insertConstant(argument));
+      continue;
+    }
+    at::Tensor tensor = argument.toTensor();
+    if (auto impl = lazyImpl(tensor)) {
+      const auto& state = impl->state_;
+      if (state->graph == g && !state->tensor.defined()) {
+        inputs.push_back(state->value);
+        continue;
+      }
+      tensor = state->tensor;
+      if (!tensor.defined()) {
+        // Its graph failed; running eagerly reports the error. Dead code
+        // elimination removes the constants inserted so far.
+        return false;
+      }
+    }
+    inputs.push_back(graph.addInput()->setType(TensorType::create(tensor)));
+    g->inputs.push_back(std::move(tensor));
+  }
+
+  Node* node = graph.insertNode(graph.create(
+      Symbol::fromQualString(schema.name()), inputs, /*num_outputs=*/1));
+  const FunctionSchema* matched = node->maybeSchema();
+  if (!matched || matched->operator_name() != schema.operator_name()) {
+    node->destroy();
+    return false;
+  }
+  auto type = inferOutputType(node);
+  if (!type) {
+    node->destroy();
+    return false;
+  }
+  node->output()->setType(type);
+  auto state = std::make_shared<LazyTensorState>();
+  state->graph = g;
+  state->value = node->output();
+  g->outputs.push_back(state);
+  lock.unlock();
+
+  drop(*stack, num_arguments);
+  push(*stack, makeLazyTensor(std::move(state), *type));
+  return true;
+}
+
+// Runs the op on the stack with its lazy arguments materialized.
+void lazyRunEagerly(const c10::OperatorHandle& op, Stack* stack) {
+  const auto& schema = op.schema();
+  const size_t num_arguments = schema.arguments().size();
+  std::vector<IValue> arguments = last(*stack, num_arguments).vec();
+  for (size_t i = 0; i < num_arguments; ++i) {
+    IValue& argument = (*stack)[stack->size() - num_arguments + i];
+    if (argument.isTensor()) {
+      if (lazyImpl(argument.toTensor())) {
+        argument = materialize(argument.toTensor());
+      }
+    } else if (argument.isTensorList()) {
+      auto list = argument.toTensorList();
+      c10::List<at::Tensor> materialized;
+      materialized.reserve(list.size());
+      for (const at::Tensor& tensor : list) {
+        materialized.push_back(materialize(tensor));
+      }
+      argument = std::move(materialized);
+    }
+  }
+
+  op.callBoxed(stack);
+
+  // In-place and out= ops return the lazy tensor they were given, which
+  // might have been resized.
+  const auto& returns = schema.returns();
+  const size_t num_returns = returns.size();
+  for (size_t i = 0; i < num_arguments; ++i) {
+    const auto& alias_info = schema.arguments()[i].alias_info();
+    if (!alias_info || !alias_info->isWrite() || !arguments[i].isTensor()) {
+      continue;
+    }
+    auto impl = lazyImpl(arguments[i].toTensor());
+    if (!impl) {
+      continue;
+    }
+    impl->refreshMetadata();
+    for (size_t j = 0; j < num_returns; ++j) {
+      if (returns[j].alias_info() && *returns[j].alias_info() == *alias_info) {
+        (*stack)[stack->size() - num_returns + j] = arguments[i];
+      }
+    }
+  }
+}
+
+void lazyFallback(const c10::OperatorHandle& op, Stack* stack) {
+  if (!lazyRecord(op, stack)) {
+    lazyRunEagerly(op, stack);
+  }
+}
+
+} // namespace
+
+at::Tensor toLazy(const at::Tensor& tensor) {
+  if (isLazy(tensor)) {
+    return tensor;
+  }
+  TORCH_CHECK(
+      tensor.defined() && tensor.layout() == at::kStrided,
+      "toLazy: expected a defined strided tensor");
+  TORCH_CHECK(
+      !tensor.requires_grad(),
+      "toLazy: lazy tensors don't support autograd, but the tensor requires grad");
+  auto state = std::make_shared<LazyTensorState>();
+  state->tensor = tensor;
+  return at::detail::make_tensor<LazyTensorImpl>(
+      std::move(state),
+      tensor.scalar_type(),
+      tensor.device(),
+      tensor.sizes(),
+      tensor.strides());
+}
+
+bool isLazy(const at::Tensor& tensor) {
+  return lazyImpl(tensor) != nullptr;
+}
+
+at::Tensor materialize(const at::Tensor& tensor) {
+  auto impl = lazyImpl(tensor);
+  if (!impl) {
+    return tensor;
+  }
+  const auto& state = impl->state_;
+  if (!state->graph) {
+    return state->tensor;
+  }
+  std::lock_guard<std::mutex> lock(state->graph->mutex);
+  flush(*state->graph);
+  TORCH_CHECK(
+      state->tensor.defined(),
+      "Running the graph of a lazy tensor failed: ",
+      state->graph->error);
+  return state->tensor;
+}
+
+void syncLazyTensors() {
+  auto g = currentGraph();
+  std::lock_guard<std::mutex> lock(g->mutex);
+  flush(*g);
+}
+
+size_t lazyGraphCacheSize() {
+  auto& cache = graphCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  return cache.executors.size();
+}
+
+TORCH_LIBRARY_IMPL(_, Lazy, m) {
+  m.fallback(torch::CppFunction::makeFromBoxedFunction<&lazyFallback>());
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+namespace torch {
+namespace jit {
+
+// Deferred execution of eager ops.
+//
+// Lazy tensors have the Lazy dispatch key, whose backend fallback records
+// the functional ops run on them into a JIT graph of the current thread
+// instead of running them. Their outputs are lazy tensors with the dtype,
+// device, sizes and strides given by shape analysis. Materializing any of
+// them runs the whole graph recorded so far through a GraphExecutor, so
+// that eager code gets the optimizations of the executor, the fusers
+// included. Executors are cached by the canonical form of their graph.
+//
+// Ops that can't be recorded materialize their inputs and run eagerly:
+// ops with mutable or aliasing arguments, with anything but a single tensor
+// return, with tensor lists, with tensors that require grad, or whose output
+// type shape analysis can't complete.
+//
+// Lazy tensors don't have storage and don't support autograd.
+
+// Returns a lazy tensor with the value of the given tensor.
+TORCH_API at::Tensor toLazy(const at::Tensor& tensor);
+
+TORCH_API bool isLazy(const at::Tensor& tensor);
+
+// Returns a regular tensor with the value of the given lazy tensor, running
+// its pending graph if needed, or the given tensor if it isn't lazy.
+TORCH_API at::Tensor materialize(const at::Tensor& tensor);
+
+// Runs the pending graph of the current thread.
+TORCH_API void syncLazyTensors();
+
+// The number of cached graph executors.
+TORCH_API size_t lazyGraphCacheSize();
+
+} // namespace jit
+} // namespace torch
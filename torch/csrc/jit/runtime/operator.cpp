@@ -3,6 +3,7 @@
 #include <ATen/core/alias_info.h>
 #include <torch/csrc/jit/frontend/edit_distance.h>
 
+#include <algorithm>
 #include <queue>
 #include <utility>
 #include <vector>
@@ -11,6 +12,8 @@ namespace torch {
 namespace jit {
 
 namespace {
+void checkNonSchematizedOperator(const Operator& op);
+
 using OperatorMap =
     std::unordered_map<Symbol, std::vector<std::shared_ptr<Operator>>>;
 struct OperatorRegistry {
@@ -36,6 +39,12 @@ struct OperatorRegistry {
 
   // XXX - caller must be holding lock
   void registerPendingOperators() {
+    // The schemas are first parsed here rather than in registerOperator, as
+    // most operators are never looked up and parsing all of them would be a
+    // large part of the time static initialization takes.
+    for (const auto& op : to_register) {
+      checkNonSchematizedOperator(*op);
+    }
     for (const auto& op : to_register) {
       Symbol sym = Symbol::fromQualString(op->schema().name());
       operators[sym].push_back(op);
@@ -50,6 +59,26 @@ struct OperatorRegistry {
     to_register.push_back(std::make_shared<Operator>(std::move(op)));
   }
 
+  void deregisterC10Operator(const c10::OperatorHandle& handle) {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      // Operators that are still pending are found by name, so that their
+      // schemas don't get parsed just to deregister them
+      auto pending_it = std::find_if(
+          to_register.begin(),
+          to_register.end(),
+          [&](const std::shared_ptr<Operator>& op) {
+            return op->isC10Op() &&
+                op->c10OperatorName() == handle.operator_name();
+          });
+      if (pending_it != to_register.end()) {
+        to_register.erase(pending_it);
+        return;
+      }
+    }
+    deregisterOperator(handle.schema());
+  }
+
   void deregisterOperator(const FunctionSchema& schema) {
     Symbol sym = Symbol::fromQualString(schema.name());
     auto sig = canonicalSchemaString(schema);
@@ -292,7 +321,10 @@ bool aliasAnalysisHasSpecialCaseFor(Symbol symbol) {
   return handled.count(symbol) || purposefully_not_handled.count(symbol);
 }
 
-void registerOperator(Operator&& op) {
+namespace {
+// Called once the operator is looked up rather than when it's registered, so
+// that registration doesn't need to parse the schema.
+void checkNonSchematizedOperator(const Operator& op) {
   if (op.schema().is_varret()) {
     Symbol s = Symbol::fromQualString(op.schema().name());
     if (!printerHasSpecialCaseFor(s)) {
@@ -318,6 +350,10 @@ void registerOperator(Operator&& op) {
           " is special cased and cannot use explicit alias analysis.");
     }
   }
+}
+} // namespace
+
+void registerOperator(Operator&& op) {
   getRegistry().registerOperator(std::move(op));
 }
 
@@ -325,6 +361,10 @@ void deregisterOperator(const FunctionSchema& schema) {
   getRegistry().deregisterOperator(schema);
 }
 
+void deregisterC10Operator(const c10::OperatorHandle& op) {
+  getRegistry().deregisterC10Operator(op);
+}
+
 const std::vector<std::shared_ptr<Operator>> getAllOperators() {
   return getRegistry().getAllOperators();
 }
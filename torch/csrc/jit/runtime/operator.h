@@ -145,6 +145,12 @@ struct TORCH_API Operator {
     return op_.is_left();
   }
 
+  // Only valid for c10 operators. Unlike schema().operator_name(), this
+  // doesn't need the c10 schema, which may not have been parsed yet.
+  const c10::OperatorName& c10OperatorName() const {
+    return op_.left().handle_.operator_name();
+  }
+
   c10::AliasAnalysisKind aliasAnalysisKind() const {
     const FunctionSchema& schemaRef = schema();
     c10::AliasAnalysisKind alias_analysis = schemaRef.aliasAnalysis();
@@ -197,6 +203,9 @@ TORCH_API std::vector<Symbol> findSimilarOperators(Symbol input_op);
 
 TORCH_API void registerOperator(Operator&& op);
 TORCH_API void deregisterOperator(const FunctionSchema& schema);
+// Like deregisterOperator(op.schema()), but doesn't parse the schema of op
+// if it was never looked up.
+TORCH_API void deregisterC10Operator(const c10::OperatorHandle& op);
 
 // XXX: this function is meant to be used with string literals only!
 TORCH_API std::shared_ptr<Operator> getOperatorForLiteral(
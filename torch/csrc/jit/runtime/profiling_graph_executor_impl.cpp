@@ -17,11 +17,13 @@
 #include <torch/csrc/jit/passes/insert_guards.h>
 #include <torch/csrc/jit/passes/lower_grad_of.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/parallelize_branches.h>
 #include <torch/csrc/jit/passes/peephole.h>
 #include <torch/csrc/jit/passes/remove_expands.h>
 #include <torch/csrc/jit/passes/requires_grad_analysis.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/passes/specialize_autogradzero.h>
+#include <torch/csrc/jit/passes/tensorexpr_fuser.h>
 
 C10_DECLARE_bool();
 
@@ -86,7 +88,8 @@ void ProfilingGraphExecutorImpl::runProfilingOptimizations(
     return;
   }
 
-  InsertGuards(copy);
+  InsertGuards(
+      copy, tensorExprFuserEnabled() && tensorExprDynamicShapesEnabled());
   LowerGradOf(*copy);
   EliminateRedundantGuards(copy);
   InsertBailOuts(copy);
@@ -116,6 +119,9 @@ void ProfilingGraphExecutorImpl::runProfilingOptimizations(
 
   } else {
     runNondiffOptimization(copy, true);
+    if (parallelizeBranchesEnabled()) {
+      ParallelizeBranches(copy);
+    }
   }
   EliminateDeadCode(copy);
   GRAPH_DUMP("Optimized Graph : ", copy);
@@ -164,6 +170,25 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
 
   // simple executor
   if (remaining_bailout_depth == 0) {
+    if (useBackgroundCompilation()) {
+      if (!background_compilation_started_) {
+        background_compilation_started_ = true;
+        compileInBackground([this]() {
+          auto copy = graph->copy();
+          runProfilingInsensitiveOptimizations(copy);
+          GRAPH_DUMP("Optimized SimpleExecutor Graph : ", copy);
+          ExecutionPlan plan(copy, function_name_);
+          std::lock_guard<std::mutex> lock(compile_mutex);
+          optimized_plan_ = std::move(plan);
+        });
+      }
+      if (!unoptimized_plan_) {
+        auto copy = graph->copy();
+        runRequiredPasses(copy);
+        unoptimized_plan_ = ExecutionPlan(copy, function_name_);
+      }
+      return *unoptimized_plan_;
+    }
     auto copy = graph->copy();
     runProfilingInsensitiveOptimizations(copy);
     GRAPH_DUMP("Optimized SimpleExecutor Graph : ", copy);
@@ -187,6 +212,21 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
     return *profiling_plan_;
   }
 
+  // keep running the profiling plan until the optimized one is ready
+  if (useBackgroundCompilation()) {
+    if (!background_compilation_started_) {
+      background_compilation_started_ = true;
+      auto copy = pr_->graph()->copy();
+      compileInBackground([this, copy, remaining_bailout_depth]() mutable {
+        runProfilingOptimizations(copy);
+        ExecutionPlan plan(copy, function_name_, remaining_bailout_depth);
+        std::lock_guard<std::mutex> lock(compile_mutex);
+        optimized_plan_ = std::move(plan);
+      });
+    }
+    return *profiling_plan_;
+  }
+
   auto copy = pr_->graph()->copy();
   runProfilingOptimizations(copy);
   // cache
@@ -196,6 +236,7 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
 }
 
 GraphExecutorState ProfilingGraphExecutorImpl::getDebugState() {
+  std::lock_guard<std::mutex> lock(compile_mutex);
   GraphExecutorState state;
   TORCH_INTERNAL_ASSERT(optimized_plan_);
   auto opt_plan = *optimized_plan_;
@@ -21,6 +21,9 @@ struct ProfilingGraphExecutorImpl : public GraphExecutorImplBase {
   c10::optional<ExecutionPlan>
       profiling_plan_; // plan to run in order to profiling the code
   c10::optional<ExecutionPlan> optimized_plan_;
+  // plan to run while optimized_plan_ is compiled in the background
+  c10::optional<ExecutionPlan> unoptimized_plan_;
+  bool background_compilation_started_ = false;
 };
 
 } // namespace jit
@@ -2,14 +2,204 @@
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/passes/clear_profiling.h>
 #include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/graph_fuser.h>
+#include <torch/csrc/jit/passes/tensorexpr_fuser.h>
 #include <torch/csrc/jit/runtime/graph_executor.h>
 #include <torch/csrc/jit/runtime/interpreter.h>
 
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+
+C10_DEFINE_bool(
+    torch_jit_profile_fusible_only,
+    false,
+    "If set, the profiling executor only profiles the inputs of nodes the "
+    "fusers may fuse, of control flow nodes and of block returns, instead of "
+    "the inputs of every node");
+
+C10_DEFINE_string(
+    torch_jit_profile_dir,
+    "",
+    "If set, the profiling executor saves the types it profiles for a graph "
+    "in this directory, and skips profiling graphs whose types were saved "
+    "there, e.g. by another replica of the same model");
+
 namespace torch {
 namespace jit {
 
+namespace {
+
+std::atomic<size_t> next_record_id{0};
+
+// Whether the optimizations specialize on the types of the inputs of n, when
+// only those are profiled.
+bool needsProfiledInputs(Node* n) {
+  if (!FLAGS_torch_jit_profile_fusible_only) {
+    return true;
+  }
+  if (!n->blocks().empty()) {
+    return true;
+  }
+  return tensorExprFuserEnabled() ? tensorExprFuserMaySupport(n)
+                                  : isFusableByGraphFuser(n);
+}
+
+// Saved profiles have one line per profile node: "-" if it didn't run,
+// otherwise "scalar_type device requires_grad undefined", the rank and the
+// sizes, and the rank and the strides ("index,contiguous,stride"). Unknown
+// fields are "?" and symbolic sizes "s".
+template <typename T>
+std::string optionalStr(const c10::optional<T>& v) {
+  if (!v) {
+    return "?";
+  }
+  std::ostringstream ss;
+  ss << *v;
+  return ss.str();
+}
+
+c10::optional<int64_t> parseOptional(const std::string& s) {
+  if (s == "?") {
+    return c10::nullopt;
+  }
+  return std::stoll(s);
+}
+
+void writeType(std::ostream& out, const TensorTypePtr& type) {
+  auto scalar_type = type->scalarType();
+  out << (scalar_type ? std::to_string(static_cast<int>(*scalar_type)) : "?")
+      << " " << optionalStr(type->device()) << " "
+      << optionalStr(type->requiresGrad()) << " "
+      << optionalStr(type->undefined());
+
+  const auto& sizes = type->symbolic_sizes();
+  out << " " << optionalStr(sizes.size());
+  for (size_t i = 0; sizes.size() && i < *sizes.size(); i++) {
+    const auto& size = sizes[i];
+    out << " "
+        << (!size ? "?"
+                  : size->is_static() ? std::to_string(size->static_size())
+                                      : "s");
+  }
+  const auto& strides = type->stride_properties();
+  out << " " << optionalStr(strides.size());
+  for (size_t i = 0; strides.size() && i < *strides.size(); i++) {
+    const auto& stride = strides[i];
+    out << " ";
+    if (!stride) {
+      out << "?";
+      continue;
+    }
+    out << optionalStr(stride->stride_index_) << ","
+        << optionalStr(stride->contiguous_) << ","
+        << optionalStr(stride->stride_);
+  }
+}
+
+TensorTypePtr readType(std::istream& in) {
+  std::string scalar_type, device, requires_grad, undefined, rank;
+  in >> scalar_type >> device >> requires_grad >> undefined;
+  auto optionalBool = [](const std::string& s) -> c10::optional<bool> {
+    auto v = parseOptional(s);
+    return v ? c10::optional<bool>(*v != 0) : c10::nullopt;
+  };
+
+  in >> rank;
+  VaryingShape<ShapeSymbol> sizes;
+  if (auto r = parseOptional(rank)) {
+    std::vector<c10::optional<ShapeSymbol>> dims;
+    for (int64_t i = 0; i < *r; i++) {
+      std::string size;
+      in >> size;
+      if (size == "?") {
+        dims.emplace_back(c10::nullopt);
+      } else if (size == "s") {
+        dims.emplace_back(ShapeSymbol::newSymbol());
+      } else {
+        dims.emplace_back(ShapeSymbol::fromStaticSize(std::stoll(size)));
+      }
+    }
+    sizes = VaryingShape<ShapeSymbol>(std::move(dims));
+  }
+
+  in >> rank;
+  VaryingShape<Stride> strides;
+  if (auto r = parseOptional(rank)) {
+    std::vector<c10::optional<Stride>> dims;
+    for (int64_t i = 0; i < *r; i++) {
+      std::string stride;
+      in >> stride;
+      if (stride == "?") {
+        dims.emplace_back(c10::nullopt);
+        continue;
+      }
+      auto first = stride.find(',');
+      auto second = stride.find(',', first + 1);
+      TORCH_CHECK(
+          first != std::string::npos && second != std::string::npos,
+          "malformed stride ",
+          stride);
+      auto index = parseOptional(stride.substr(0, first));
+      auto contiguous =
+          optionalBool(stride.substr(first + 1, second - first - 1));
+      auto value = parseOptional(stride.substr(second + 1));
+      dims.emplace_back(Stride(
+          index ? c10::optional<size_t>(*index) : c10::nullopt,
+          contiguous,
+          value ? c10::optional<size_t>(*value) : c10::nullopt));
+    }
+    strides = VaryingShape<Stride>(std::move(dims));
+  }
+  TORCH_CHECK(in, "truncated type");
+
+  auto st = parseOptional(scalar_type);
+  return TensorType::create(
+      st ? c10::optional<at::ScalarType>(static_cast<at::ScalarType>(*st))
+         : c10::nullopt,
+      device == "?" ? c10::nullopt : c10::optional<at::Device>(device),
+      sizes,
+      strides,
+      optionalBool(requires_grad),
+      optionalBool(undefined));
+}
+
+} // namespace
+
 ProfilingRecord::ProfilingRecord(std::shared_ptr<Graph> g)
-    : profiled_graph_(std::move(g)), profiling_count_(getNumProfiledRuns()) {}
+    : profiled_graph_(std::move(g)),
+      profiling_count_(getNumProfiledRuns().load()),
+      id_(next_record_id++) {}
+
+ProfilingRecord::~ProfilingRecord() {
+  // profiles published after the merge, by runs that overlapped it
+  auto profile = published_profiles_.load(std::memory_order_acquire);
+  while (profile) {
+    auto next = profile->next;
+    delete profile;
+    profile = next;
+  }
+}
+
+std::unordered_map<size_t, std::vector<ProfilingRecord::ProfiledType>>&
+ProfilingRecord::threadProfiles() {
+  // Entries are removed when the thread finishes a run, so only the threads
+  // that stopped running a graph halfway through keep one around.
+  static thread_local std::
+      unordered_map<size_t, std::vector<ProfilingRecord::ProfiledType>>
+          profiles;
+  return profiles;
+}
+
+std::vector<ProfilingRecord::ProfiledType>& ProfilingRecord::threadProfile() {
+  auto& profile = threadProfiles()[id_];
+  if (profile.empty()) {
+    profile.resize(profiled_values_.size());
+  }
+  return profile;
+}
 
 ProfileOp* ProfilingRecord::createProfileNode(
     const std::function<void(Stack&)>& fp,
@@ -26,29 +216,30 @@ void ProfilingRecord::insertShapeProfile(Node* n, Value* i) {
   auto pn = createProfileNode(nullptr, {i});
   auto pno = pn->addOutput();
   pno->setType(TensorType::get());
+  size_t index = profiled_values_.size();
+  profiled_values_.push_back(pno);
   std::function<void(Stack&)> shape_profiler = [this,
-                                                pno](Stack& stack) mutable {
-    GRAPH_DEBUG("Profiling %", pno->debugName(), " addr = ", pno);
+                                                index](Stack& stack) mutable {
     int64_t frame_id;
     pop(stack, frame_id);
     IValue t;
     pop(stack, t);
-    if (t.isTensor()) {
+    if (t.isTensor() && !ready()) {
+      auto& profiled = threadProfile()[index];
       if (t.toTensor().defined()) {
         auto pttp = tensorTypeInCurrentExecutionContext(t.toTensor());
-        GRAPH_DEBUG("pttp = ", *pttp);
-        std::lock_guard<std::mutex> lock(this->mutex_);
-        if (auto type = pno->type()->cast<TensorType>()) {
-          auto result = this->seen_.insert(pno);
-          if (!result.second) {
-            GRAPH_DEBUG("Merging ", *pttp, " with ", *type);
-            pttp = pttp->merge(type);
-          }
-          pno->setType(pttp);
-          GRAPH_DEBUG("Setting a new type ", *pttp);
+        GRAPH_DEBUG(
+            "Profiling %",
+            profiled_values_[index]->debugName(),
+            ", pttp = ",
+            *pttp);
+        if (profiled.seen) {
+          pttp = pttp->merge(profiled.type);
         }
+        profiled.type = pttp;
+        profiled.seen = true;
       } else {
-        pno->setType(TensorType::get()->withUndefined());
+        profiled.type = TensorType::get()->withUndefined();
       }
     }
 
@@ -64,13 +255,15 @@ void ProfilingRecord::insertShapeProfile(Node* n, Value* i) {
 void ProfilingRecord::instrumentBlock(Block* block) {
   for (auto it = block->nodes().begin(); it != block->nodes().end(); ++it) {
     auto n = *it;
-    for (auto i : n->inputs()) {
-      if (!i->type()->isSubtypeOf(TensorType::get()) ||
-          i->node()->kind() == prim::profile) {
-        continue;
-      }
+    if (needsProfiledInputs(n)) {
+      for (auto i : n->inputs()) {
+        if (!i->type()->isSubtypeOf(TensorType::get()) ||
+            i->node()->kind() == prim::profile) {
+          continue;
+        }
 
-      insertShapeProfile(n, i);
+        insertShapeProfile(n, i);
+      }
     }
 
     for (auto b : n->blocks()) {
@@ -90,6 +283,146 @@ void ProfilingRecord::instrumentBlock(Block* block) {
   }
 }
 
+void ProfilingRecord::finishRun() {
+  if (ready()) {
+    threadProfiles().erase(id_);
+    return;
+  }
+  auto& profiles = threadProfiles();
+  auto it = profiles.find(id_);
+  if (it != profiles.end()) {
+    auto profile = new PublishedProfile{std::move(it->second), nullptr};
+    profiles.erase(it);
+    profile->next = published_profiles_.load(std::memory_order_relaxed);
+    while (!published_profiles_.compare_exchange_weak(
+        profile->next,
+        profile,
+        std::memory_order_release,
+        std::memory_order_relaxed)) {
+    }
+  }
+
+  // Runs publish their profile before counting themselves, so the run taking
+  // the count to zero sees the profiles of all the counted runs.
+  size_t count = profiling_count_.load(std::memory_order_relaxed);
+  while (count > 0 &&
+         !profiling_count_.compare_exchange_weak(
+             count, count - 1, std::memory_order_acq_rel)) {
+  }
+  if (count == 1) {
+    mergeProfiles();
+    ready_.store(true, std::memory_order_release);
+  }
+}
+
+void ProfilingRecord::mergeProfiles() {
+  std::vector<TensorTypePtr> merged(profiled_values_.size());
+  auto profile =
+      published_profiles_.exchange(nullptr, std::memory_order_acquire);
+  while (profile) {
+    for (size_t i = 0; i < merged.size(); i++) {
+      const auto& type = profile->types[i].type;
+      if (!type) {
+        continue;
+      }
+      if (merged[i]) {
+        GRAPH_DEBUG("Merging ", *type, " with ", *merged[i]);
+        merged[i] = merged[i]->merge(type);
+      } else {
+        merged[i] = type;
+      }
+    }
+    auto next = profile->next;
+    delete profile;
+    profile = next;
+  }
+
+  // saved before setting the types, so that the saved graph is the one
+  // loadProfiles compares it with
+  if (!profile_path_.empty()) {
+    saveProfiles(merged);
+  }
+  for (size_t i = 0; i < merged.size(); i++) {
+    if (merged[i]) {
+      GRAPH_DEBUG(
+          "Setting a new type ",
+          *merged[i],
+          " on %",
+          profiled_values_[i]->debugName());
+      profiled_values_[i]->setType(merged[i]);
+    }
+  }
+}
+
+void ProfilingRecord::saveProfiles(
+    const std::vector<TensorTypePtr>& types) const {
+  // replicas may save the same profiles concurrently
+  std::string tmp_path =
+      profile_path_ + ".tmp" + std::to_string(std::random_device()());
+  {
+    std::ofstream out(tmp_path);
+    out << types.size() << "\n";
+    for (const auto& type : types) {
+      if (type) {
+        writeType(out, type);
+      } else {
+        out << "-";
+      }
+      out << "\n";
+    }
+    out << profiled_graph_->toString(false);
+    if (!out) {
+      TORCH_WARN("Failed to save the profiled types to ", tmp_path);
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), profile_path_.c_str()) != 0) {
+    TORCH_WARN("Failed to save the profiled types to ", profile_path_);
+  }
+}
+
+bool ProfilingRecord::loadProfiles() {
+  std::ifstream in(profile_path_);
+  if (!in) {
+    return false;
+  }
+  std::vector<TensorTypePtr> types;
+  try {
+    std::string line;
+    std::getline(in, line);
+    TORCH_CHECK(
+        std::stoull(line) == profiled_values_.size(),
+        "expected ",
+        profiled_values_.size(),
+        " profiled values");
+    for (size_t i = 0; i < profiled_values_.size(); i++) {
+      std::getline(in, line);
+      if (line == "-") {
+        types.emplace_back(nullptr);
+        continue;
+      }
+      std::istringstream line_in(line);
+      types.push_back(readType(line_in));
+    }
+    std::string graph_str(
+        (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    TORCH_CHECK(
+        graph_str == profiled_graph_->toString(false),
+        "the profiles were saved for a different graph");
+  } catch (const std::exception& e) {
+    TORCH_WARN(
+        "Ignoring the profiled types in ", profile_path_, ": ", e.what());
+    return false;
+  }
+
+  for (size_t i = 0; i < types.size(); i++) {
+    if (types[i]) {
+      profiled_values_[i]->setType(types[i]);
+    }
+  }
+  return true;
+}
+
 std::unique_ptr<ProfilingRecord> ProfilingRecord::instrumentGraph(
     const std::shared_ptr<Graph>& graph) {
   auto new_g = graph->copy();
@@ -101,14 +434,26 @@ std::unique_ptr<ProfilingRecord> ProfilingRecord::instrumentGraph(
   std::function<void(Stack&)> counter = [raw_pr](Stack& stack) {
     int64_t frame_id;
     pop(stack, frame_id);
-    std::lock_guard<std::mutex> lock(raw_pr->mutex_);
-    if (raw_pr->profiling_count_ > 0) {
-      raw_pr->profiling_count_--;
-    }
+    raw_pr->finishRun();
   };
 
   auto pop = pr->createProfileNode(counter, {});
   new_g->appendNode(pop);
+
+  if (!FLAGS_torch_jit_profile_dir.empty()) {
+    std::ostringstream path;
+    path << FLAGS_torch_jit_profile_dir << "/" << std::hex
+         << std::hash<std::string>()(new_g->toString(false)) << ".profile";
+    pr->profile_path_ = path.str();
+    if (pr->loadProfiles()) {
+      GRAPH_DEBUG("Loaded the profiled types from ", pr->profile_path_);
+      pr->profiling_count_ = 0;
+      pr->ready_ = true;
+    }
+  }
+  if (pr->profiling_count_ == 0) {
+    pr->ready_ = true;
+  }
   return pr;
 }
 
@@ -4,45 +4,84 @@
 #include <ATen/core/ivalue.h>
 #include <ATen/core/jit_type.h>
 #include <ATen/core/stack.h>
+#include <c10/util/Flags.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 #include <torch/csrc/jit/ir/ir.h>
 
+#include <atomic>
 #include <list>
-#include <unordered_set>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
+C10_DECLARE_bool(torch_jit_profile_fusible_only);
+C10_DECLARE_string(torch_jit_profile_dir);
+
 namespace torch {
 namespace jit {
 
 using ::c10::TensorTypePtr;
 
+// Profile nodes record the types they see in a profile owned by the running
+// thread, so that they don't synchronize with each other. At the end of a
+// run, the thread publishes its profile, and the run that completes the
+// profiling merges the published profiles into the types of the profile
+// nodes; the graph must not be read before ready() returns true.
 struct ProfilingRecord {
   // N.B. ProfilingRecord's copy and move c-tor are disabled, so we won't
   // end up accidentally copying or moving ProfilingRecords whose addresses
   // are captured in callbacks_
   ProfilingRecord(const ProfilingRecord&) = delete;
   ProfilingRecord(ProfilingRecord&&) noexcept = delete;
+  TORCH_API ~ProfilingRecord();
   TORCH_API static std::unique_ptr<ProfilingRecord> instrumentGraph(
       const std::shared_ptr<Graph>& graph);
 
   std::shared_ptr<Graph> profiled_graph_;
-  std::mutex mutex_;
-  size_t profiling_count_;
-  std::unordered_set<Value*> seen_;
+  std::atomic<size_t> profiling_count_;
   bool ready() const {
-    return profiling_count_ == 0;
+    return ready_.load(std::memory_order_acquire);
   }
   std::shared_ptr<Graph> graph() const {
     return profiled_graph_;
   }
 
  private:
+  // The types seen by a profile node, and whether any of them was a defined
+  // tensor.
+  struct ProfiledType {
+    TensorTypePtr type;
+    bool seen = false;
+  };
+
+  struct PublishedProfile {
+    std::vector<ProfiledType> types;
+    PublishedProfile* next;
+  };
+
   ProfileOp* createProfileNode(
       const std::function<void(Stack&)>& fp,
       at::ArrayRef<Value*> inputs);
   void instrumentBlock(Block* block);
   void insertShapeProfile(Node* n, Value* i);
+  // the profiles of the running thread, by record id
+  static std::unordered_map<size_t, std::vector<ProfiledType>>&
+  threadProfiles();
+  std::vector<ProfiledType>& threadProfile();
+  void finishRun();
+  void mergeProfiles();
+  bool loadProfiles();
+  void saveProfiles(const std::vector<TensorTypePtr>& types) const;
   ProfilingRecord(std::shared_ptr<Graph> g);
+
+  // the outputs of the profile nodes, indexing the profiles
+  std::vector<Value*> profiled_values_;
+  std::atomic<PublishedProfile*> published_profiles_{nullptr};
+  std::atomic<bool> ready_{false};
+  // identifies the record in the profiles of threads
+  const size_t id_;
+  // where the profiles are saved, if FLAGS_torch_jit_profile_dir is set
+  std::string profile_path_;
 };
 
 } // namespace jit
@@ -0,0 +1,165 @@
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/inliner.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+std::shared_ptr<Graph> prepareGraph(std::shared_ptr<Graph> graph) {
+  Inline(*graph);
+  ConstantPropagation(graph);
+  EliminateDeadCode(graph);
+  for (Node* n : graph->nodes()) {
+    TORCH_CHECK(
+        n->blocks().empty(),
+        "StaticRuntime doesn't support control flow, found ",
+        n->kind().toQualString());
+    TORCH_CHECK(
+        n->kind() != prim::fork && !n->hasSideEffects(),
+        "StaticRuntime doesn't support ops with side effects, found ",
+        n->kind().toQualString());
+  }
+  GRAPH_DUMP("StaticRuntime graph: ", graph);
+  return graph;
+}
+
+std::shared_ptr<Graph> forwardGraph(const Module& m) {
+  Module frozen = freeze_module(m);
+  auto graph = frozen.get_method("forward").graph()->copy();
+  Inline(*graph);
+  // After freezing, the forward method no longer reads from self.
+  TORCH_CHECK(
+      !graph->inputs().at(0)->hasUses(),
+      "StaticRuntime expects the frozen forward method not to use self");
+  graph->eraseInput(0);
+  return graph;
+}
+
+} // namespace
+
+ProcessedNode::ProcessedNode(
+    Node* node,
+    std::vector<size_t> inputs,
+    std::vector<size_t> outputs)
+    : node_(node),
+      inputs_(std::move(inputs)),
+      outputs_(std::move(outputs)),
+      kernel_(getStaticKernel(node)) {
+  if (!kernel_) {
+    op_ = node->getOperation();
+    stack_.reserve(std::max(inputs_.size(), outputs_.size()));
+  }
+}
+
+void ProcessedNode::run(std::vector<IValue>& registers) {
+  if (kernel_) {
+    kernel_(inputs_, outputs_, registers);
+    return;
+  }
+  for (size_t i : inputs_) {
+    stack_.push_back(registers[i]);
+  }
+  op_(stack_);
+  TORCH_INTERNAL_ASSERT(stack_.size() == outputs_.size());
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    registers[outputs_[i]] = std::move(stack_[i]);
+  }
+  stack_.clear();
+}
+
+StaticRuntime::StaticRuntime(const Module& m)
+    : StaticRuntime(forwardGraph(m)) {}
+
+StaticRuntime::StaticRuntime(std::shared_ptr<Graph> graph)
+    : graph_(prepareGraph(std::move(graph))) {
+  std::unordered_map<const Value*, size_t> value_to_reg;
+  auto newRegister = [&](const Value* v) {
+    size_t reg = registers_.size();
+    registers_.emplace_back();
+    value_to_reg[v] = reg;
+    return reg;
+  };
+
+  for (const Value* v : graph_->inputs()) {
+    input_regs_.push_back(newRegister(v));
+  }
+  for (Node* n : graph_->nodes()) {
+    if (n->kind() == prim::Constant) {
+      size_t reg = newRegister(n->output());
+      registers_[reg] = toIValue(n->output()).value();
+      continue;
+    }
+    std::vector<size_t> inputs;
+    for (const Value* v : n->inputs()) {
+      inputs.push_back(value_to_reg.at(v));
+    }
+    std::vector<size_t> outputs;
+    for (const Value* v : n->outputs()) {
+      outputs.push_back(newRegister(v));
+    }
+    nodes_.emplace_back(n, std::move(inputs), std::move(outputs));
+  }
+  for (const Value* v : graph_->outputs()) {
+    output_regs_.push_back(value_to_reg.at(v));
+    if (v->node()->kind() != prim::Constant) {
+      released_regs_.push_back(output_regs_.back());
+    }
+  }
+}
+
+std::vector<IValue> StaticRuntime::run(std::vector<IValue> inputs) {
+  TORCH_CHECK(
+      inputs.size() == input_regs_.size(),
+      "StaticRuntime expected ",
+      input_regs_.size(),
+      " inputs but got ",
+      inputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    registers_[input_regs_[i]] = std::move(inputs[i]);
+  }
+
+  for (ProcessedNode& n : nodes_) {
+    n.run(registers_);
+  }
+
+  std::vector<IValue> outputs;
+  outputs.reserve(output_regs_.size());
+  for (size_t reg : output_regs_) {
+    outputs.push_back(registers_[reg]);
+  }
+  // Don't keep the inputs alive, and give the outputs to the caller so that
+  // the next run doesn't write into them. Intermediates stay in their
+  // registers to be reused.
+  for (size_t reg : input_regs_) {
+    registers_[reg] = IValue();
+  }
+  for (size_t reg : released_regs_) {
+    registers_[reg] = IValue();
+  }
+  return outputs;
+}
+
+std::vector<at::Tensor> StaticRuntime::run(
+    const std::vector<at::Tensor>& inputs) {
+  std::vector<IValue> stack(inputs.begin(), inputs.end());
+  std::vector<IValue> outputs = run(std::move(stack));
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(outputs.size());
+  for (IValue& v : outputs) {
+    tensors.push_back(std::move(v).toTensor());
+  }
+  return tensors;
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+#include <torch/csrc/jit/runtime/operator.h>
+#include <torch/csrc/jit/runtime/static/ops.h>
+
+#include <memory>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+// A node of the graph of a static runtime, with the registers of its inputs
+// and outputs. It runs the unboxed kernel of its op if it has one, and the
+// op's boxed operation on a stack that is kept across runs otherwise.
+class ProcessedNode {
+ public:
+  ProcessedNode(
+      Node* node,
+      std::vector<size_t> inputs,
+      std::vector<size_t> outputs);
+
+  void run(std::vector<IValue>& registers);
+
+  Node* node() const {
+    return node_;
+  }
+
+  bool hasStaticKernel() const {
+    return static_cast<bool>(kernel_);
+  }
+
+ private:
+  Node* node_;
+  std::vector<size_t> inputs_;
+  std::vector<size_t> outputs_;
+  StaticKernel kernel_;
+  Operation op_;
+  Stack stack_;
+};
+
+// Runs a straight-line inference graph without the interpreter. Every value
+// of the graph gets a register, constants are loaded once at construction,
+// and the nodes run in order on the registers. Intermediate tensors stay in
+// their registers between runs so that ops with out= kernels write into the
+// memory of the previous run instead of allocating.
+//
+// The graph must have no control flow and no side effects, as after freezing
+// and inlining a module in eval mode. A StaticRuntime is not thread-safe; use
+// one per thread.
+class TORCH_API StaticRuntime {
+ public:
+  explicit StaticRuntime(std::shared_ptr<Graph> graph);
+  // Freezes a copy of M and uses the graph of its forward method.
+  explicit StaticRuntime(const Module& m);
+
+  std::vector<IValue> run(std::vector<IValue> inputs);
+  std::vector<at::Tensor> run(const std::vector<at::Tensor>& inputs);
+
+  const std::shared_ptr<Graph>& graph() const {
+    return graph_;
+  }
+
+  const std::vector<ProcessedNode>& nodes() const {
+    return nodes_;
+  }
+
+ private:
+  std::shared_ptr<Graph> graph_;
+  std::vector<ProcessedNode> nodes_;
+  std::vector<IValue> registers_;
+  std::vector<size_t> input_regs_;
+  std::vector<size_t> output_regs_;
+  // The output registers that are cleared after each run.
+  std::vector<size_t> released_regs_;
+};
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,125 @@
+#include <torch/csrc/jit/runtime/static/ops.h>
+
+#include <ATen/ATen.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// The output tensor of the previous run, if the runtime is its only owner,
+// or a new empty tensor like SELF otherwise. Kernels write into it with out=
+// variants, which resize it as needed.
+at::Tensor reusableOutput(IValue& output, const at::Tensor& self) {
+  if (output.isTensor()) {
+    const at::Tensor& t = output.toTensor();
+    if (t.use_count() == 1 && t.storage().use_count() == 1 &&
+        t.options().type_equal(self.options())) {
+      return t;
+    }
+  }
+  return at::empty({0}, self.options());
+}
+
+template <typename F>
+StaticKernel unaryKernel(F f) {
+  return [f](const std::vector<size_t>& inputs,
+             const std::vector<size_t>& outputs,
+             std::vector<IValue>& registers) {
+    const at::Tensor& self = registers[inputs[0]].toTensor();
+    at::Tensor out = reusableOutput(registers[outputs[0]], self);
+    f(out, self);
+    registers[outputs[0]] = std::move(out);
+  };
+}
+
+} // namespace
+
+StaticKernel getStaticKernel(const Node* n) {
+  // Tensors known to live elsewhere keep the boxed op.
+  for (const Value* v : n->inputs()) {
+    if (auto tt = v->type()->cast<TensorType>()) {
+      if (tt->device() && !tt->device()->is_cpu()) {
+        return nullptr;
+      }
+    }
+  }
+
+  if (n->matches(
+          "aten::add.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor")) {
+    return [](const std::vector<size_t>& inputs,
+              const std::vector<size_t>& outputs,
+              std::vector<IValue>& registers) {
+      const at::Tensor& self = registers[inputs[0]].toTensor();
+      const at::Tensor& other = registers[inputs[1]].toTensor();
+      at::Scalar alpha = registers[inputs[2]].toScalar();
+      if (self.scalar_type() != other.scalar_type()) {
+        registers[outputs[0]] = at::add(self, other, alpha);
+        return;
+      }
+      at::Tensor out = reusableOutput(registers[outputs[0]], self);
+      at::add_out(out, self, other, alpha);
+      registers[outputs[0]] = std::move(out);
+    };
+  }
+  if (n->matches("aten::mul.Tensor(Tensor self, Tensor other) -> Tensor")) {
+    return [](const std::vector<size_t>& inputs,
+              const std::vector<size_t>& outputs,
+              std::vector<IValue>& registers) {
+      const at::Tensor& self = registers[inputs[0]].toTensor();
+      const at::Tensor& other = registers[inputs[1]].toTensor();
+      if (self.scalar_type() != other.scalar_type()) {
+        registers[outputs[0]] = at::mul(self, other);
+        return;
+      }
+      at::Tensor out = reusableOutput(registers[outputs[0]], self);
+      at::mul_out(out, self, other);
+      registers[outputs[0]] = std::move(out);
+    };
+  }
+  if (n->matches(
+          "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor")) {
+    return [](const std::vector<size_t>& inputs,
+              const std::vector<size_t>& outputs,
+              std::vector<IValue>& registers) {
+      const at::Tensor& self = registers[inputs[0]].toTensor();
+      const at::Tensor& mat1 = registers[inputs[1]].toTensor();
+      const at::Tensor& mat2 = registers[inputs[2]].toTensor();
+      at::Scalar beta = registers[inputs[3]].toScalar();
+      at::Scalar alpha = registers[inputs[4]].toScalar();
+      at::Tensor out = reusableOutput(registers[outputs[0]], mat1);
+      at::addmm_out(out, self, mat1, mat2, beta, alpha);
+      registers[outputs[0]] = std::move(out);
+    };
+  }
+  if (n->matches("aten::mm(Tensor self, Tensor mat2) -> Tensor")) {
+    return [](const std::vector<size_t>& inputs,
+              const std::vector<size_t>& outputs,
+              std::vector<IValue>& registers) {
+      const at::Tensor& self = registers[inputs[0]].toTensor();
+      const at::Tensor& mat2 = registers[inputs[1]].toTensor();
+      at::Tensor out = reusableOutput(registers[outputs[0]], self);
+      at::mm_out(out, self, mat2);
+      registers[outputs[0]] = std::move(out);
+    };
+  }
+  if (n->matches("aten::relu(Tensor self) -> Tensor")) {
+    return unaryKernel([](at::Tensor& out, const at::Tensor& self) {
+      at::clamp_min_out(out, self, 0);
+    });
+  }
+  if (n->matches("aten::sigmoid(Tensor self) -> Tensor")) {
+    return unaryKernel([](at::Tensor& out, const at::Tensor& self) {
+      at::sigmoid_out(out, self);
+    });
+  }
+  if (n->matches("aten::tanh(Tensor self) -> Tensor")) {
+    return unaryKernel([](at::Tensor& out, const at::Tensor& self) {
+      at::tanh_out(out, self);
+    });
+  }
+  return nullptr;
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+#include <functional>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+// A kernel of the static runtime. It reads its inputs from and writes its
+// outputs to the value registers of the runtime, at the given indices.
+using StaticKernel = std::function<void(
+    const std::vector<size_t>& inputs,
+    const std::vector<size_t>& outputs,
+    std::vector<IValue>& registers)>;
+
+// Returns a kernel that calls the unboxed out= variant of the op of n,
+// writing into the tensor its output register held from the previous run if
+// nothing else refers to it, or nullptr if n has no such kernel.
+TORCH_API StaticKernel getStaticKernel(const Node* n);
+
+} // namespace jit
+} // namespace torch
@@ -18,6 +18,7 @@
 #include <ATen/ATen.h>
 #include <c10/util/Optional.h>
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
 #include <regex>
@@ -145,6 +146,10 @@ void CloseFile(FILE* fp) {
   fclose(fp);
 }
 
+// Upper bound on the size of the staging copies made while writing tensors
+// that are not contiguous CPU tensors to external data files.
+constexpr int64_t kExternalDataChunkBytes = 64 << 20;
+
 void CreateExternalFile(
     const at::Tensor& tensor,
     const std::string& tensorName,
@@ -158,7 +163,29 @@ void CreateExternalFile(
         std::string("ONNX export failed. Could not open file or directory: ") +
         fullFilePath);
   }
-  fwrite(tensor.data_ptr(), tensor.element_size(), tensor.numel(), fp.get());
+  auto write = [&](const at::Tensor& t) {
+    size_t nbytes = t.element_size() * t.numel();
+    if (fwrite(t.data_ptr(), 1, nbytes, fp.get()) != nbytes) {
+      throw std::runtime_error(
+          std::string("ONNX export failed. Could not write to file: ") +
+          fullFilePath);
+    }
+  };
+  // Contiguous CPU tensors are written straight from their storage. Others
+  // are made contiguous and moved to the CPU a block of rows at a time, so
+  // the export never holds a second full copy of a large parameter.
+  if (tensor.is_quantized() || (tensor.is_cpu() && tensor.is_contiguous())) {
+    write(tensor.contiguous());
+    return;
+  }
+  const int64_t rows = tensor.size(0);
+  const int64_t row_bytes = tensor.numel() / rows * tensor.element_size();
+  const int64_t rows_per_chunk =
+      std::max<int64_t>(1, kExternalDataChunkBytes / row_bytes);
+  for (int64_t start = 0; start < rows; start += rows_per_chunk) {
+    const int64_t length = std::min(rows_per_chunk, rows - start);
+    write(tensor.narrow(0, start, length).contiguous().cpu());
+  }
 } // fclose() called here through CloseFile(), if FILE* is not a null pointer.
 
 class EncoderBase {
@@ -167,7 +194,7 @@ class EncoderBase {
       onnx_torch::OperatorExportTypes operator_export_type,
       bool strip_doc);
 
-  onnx::ModelProto get_model_proto() {
+  const onnx::ModelProto& get_model_proto() const {
     return model_proto_;
   }
 
@@ -670,15 +697,16 @@ void GraphEncoder::EncodeTensor(
     tensor_proto->add_dims(d);
   }
   tensor_proto->set_data_type(ATenTypeToOnnxType(tensor.scalar_type()));
-  at::Tensor t;
-  // CPU's HalfTensor doesn't have contiguous(), so first calling contiguous()
-  // TODO We don't call .cpu() on quantized tensors as it fails when calling
-  // aten::empty() on quantized tensors beyond certain size. Issue #29435.
-  if (tensor.is_quantized()) {
-    t = tensor.contiguous();
-  } else {
-    t = tensor.contiguous().cpu();
-  }
+  auto contiguous_cpu = [&]() {
+    // CPU's HalfTensor doesn't have contiguous(), so first calling
+    // contiguous()
+    // TODO We don't call .cpu() on quantized tensors as it fails when calling
+    // aten::empty() on quantized tensors beyond certain size. Issue #29435.
+    if (tensor.is_quantized()) {
+      return tensor.contiguous();
+    }
+    return tensor.contiguous().cpu();
+  };
 
   // Either defer_weight_export should be true and external_ref must be present,
   // or use_external_data_format should be true, not both at the same time. They
@@ -694,10 +722,9 @@ void GraphEncoder::EncodeTensor(
     // avoid ONNX protobuf changes.
     AT_ASSERT(external_ref.value() == tensor_proto->name());
     AT_ASSERT(raw_data_export_map_.count(external_ref.value()) == 0);
-    raw_data_export_map_[external_ref.value()] = t;
+    raw_data_export_map_[external_ref.value()] = contiguous_cpu();
     tensor_proto->set_raw_data("__EXTERNAL");
   } else {
-    AT_ASSERT(t.is_contiguous());
     size_t tensorSize = static_cast<size_t>(std::accumulate(
         std::begin(tensor.sizes()),
         std::end(tensor.sizes()),
@@ -710,13 +737,16 @@ void GraphEncoder::EncodeTensor(
           (external_ref != c10::nullopt) &&
           (external_ref.value() == tensor_proto->name()));
       auto tensorName = GetExternalFileName(external_ref);
-      CreateExternalFile(t, tensorName, onnx_file_path);
+      // Written from the original tensor, without a contiguous CPU copy.
+      CreateExternalFile(tensor, tensorName, onnx_file_path);
       onnx::StringStringEntryProto* location =
           tensor_proto->mutable_external_data()->Add();
       location->set_key("location");
       location->set_value(tensorName);
       tensor_proto->set_data_location(onnx::TensorProto_DataLocation_EXTERNAL);
     } else {
+      auto t = contiguous_cpu();
+      AT_ASSERT(t.is_contiguous());
       tensor_proto->set_raw_data(std::string(
           static_cast<char*>(t.data_ptr()), t.element_size() * t.numel()));
     }
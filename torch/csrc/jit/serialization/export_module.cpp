@@ -2,6 +2,7 @@
 
 #include <c10/util/Exception.h>
 #include <torch/csrc/jit/ir/type_hashing.h>
+#include <torch/csrc/jit/mobile/flat_bytecode.h>
 #include <torch/csrc/jit/passes/inliner.h>
 #include <torch/csrc/jit/runtime/instruction.h>
 #include <torch/csrc/jit/serialization/import_export_constants.h>
@@ -18,13 +19,16 @@
 
 #include <ATen/core/jit_type.h>
 #include <ATen/core/qualified_name.h>
+#include <cstring>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace torch {
 namespace jit {
 
 char const* toString(OpCode op);
+OpCode parseOpCode(const char* str);
 
 namespace {
 ExportModuleExtraFilesHook& GetExtraFilesHook() {
@@ -143,6 +147,147 @@ void setstateTuple(const IValue& ivalue, std::vector<c10::IValue>& elements) {
     }
   }
 }
+// Lays out the methods in ELEMENTS, as written to bytecode.pkl, in the flat
+// form of mobile/flat_bytecode.h. The constants it can't hold are appended to
+// PICKLED_CONSTANTS.
+std::string flatByteCode(
+    const std::vector<IValue>& elements,
+    std::vector<IValue>& pickled_constants) {
+  using namespace mobile::flat;
+  std::string out(sizeof(FlatHeader), '\0');
+  auto append = [&](const void* data, size_t size) -> uint64_t {
+    out.resize((out.size() + 7) / 8 * 8, '\0');
+    uint64_t offset = out.size();
+    out.append(static_cast<const char*>(data), size);
+    return offset;
+  };
+
+  std::vector<std::string> strings;
+  std::unordered_map<std::string, uint32_t> string_indices;
+  auto intern = [&](const std::string& s) -> uint32_t {
+    auto it = string_indices.find(s);
+    if (it != string_indices.end()) {
+      return it->second;
+    }
+    uint32_t index = strings.size();
+    strings.push_back(s);
+    string_indices.emplace(s, index);
+    return index;
+  };
+
+  std::vector<FlatFunction> functions;
+  functions.reserve(elements.size());
+  for (const auto& element : elements) {
+    const auto& m_tuple = element.toTuple()->elements();
+    IValue table = m_tuple[1];
+    FlatFunction function{};
+    function.name = intern(m_tuple[0].toStringRef());
+
+    const auto& ins_list =
+        expect_field(table, "instructions", BYTECODE_INDEX_INSTRUCTION)
+            .toTuple()
+            ->elements();
+    std::vector<Instruction> instructions;
+    instructions.reserve(ins_list.size());
+    for (const auto& ins : ins_list) {
+      const auto& ins_item = ins.toTuple()->elements();
+      instructions.emplace_back(
+          parseOpCode(ins_item[0].toStringRef().c_str()),
+          ins_item[1].toInt(),
+          ins_item[2].toInt());
+    }
+    function.num_instructions = instructions.size();
+    function.instructions_offset = append(
+        instructions.data(), instructions.size() * sizeof(Instruction));
+
+    const auto& ops_list =
+        expect_field(table, "operators", BYTECODE_INDEX_OPERATOR)
+            .toTuple()
+            ->elements();
+    std::vector<FlatOperator> operators;
+    operators.reserve(ops_list.size());
+    for (const auto& op : ops_list) {
+      const auto& op_item = op.toTuple()->elements();
+      operators.push_back(FlatOperator{intern(op_item[0].toStringRef()),
+                                       intern(op_item[1].toStringRef())});
+    }
+    function.num_operators = operators.size();
+    function.operators_offset =
+        append(operators.data(), operators.size() * sizeof(FlatOperator));
+
+    const auto& consts_list =
+        expect_field(table, "constants", BYTECODE_INDEX_CONSTANT)
+            .toTuple()
+            ->elements();
+    std::vector<FlatConstant> constants;
+    constants.reserve(consts_list.size());
+    for (const auto& constant : consts_list) {
+      FlatConstant flat{};
+      if (constant.isNone()) {
+        flat.tag = ConstantTag::None;
+      } else if (constant.isBool()) {
+        flat.tag = ConstantTag::Bool;
+        flat.payload = constant.toBool();
+      } else if (constant.isInt()) {
+        flat.tag = ConstantTag::Int;
+        flat.payload = constant.toInt();
+      } else if (constant.isDouble()) {
+        flat.tag = ConstantTag::Double;
+        double value = constant.toDouble();
+        std::memcpy(&flat.payload, &value, sizeof(value));
+      } else if (constant.isString()) {
+        flat.tag = ConstantTag::String;
+        flat.index = intern(constant.toStringRef());
+      } else {
+        flat.tag = ConstantTag::Pickled;
+        flat.index = pickled_constants.size();
+        pickled_constants.push_back(constant);
+      }
+      constants.push_back(flat);
+    }
+    function.num_constants = constants.size();
+    function.constants_offset =
+        append(constants.data(), constants.size() * sizeof(FlatConstant));
+
+    const auto& types_list =
+        expect_field(table, "types", BYTECODE_INDEX_TYPE).toTuple()->elements();
+    std::vector<uint32_t> types;
+    types.reserve(types_list.size());
+    for (const auto& t : types_list) {
+      types.push_back(intern(t.toStringRef()));
+    }
+    function.num_types = types.size();
+    function.types_offset =
+        append(types.data(), types.size() * sizeof(uint32_t));
+
+    function.register_size = expect_field(table, "register_size", 4).toInt();
+    functions.push_back(function);
+  }
+
+  FlatHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.byte_order = kByteOrder;
+  header.num_functions = functions.size();
+  header.functions_offset =
+      append(functions.data(), functions.size() * sizeof(FlatFunction));
+
+  std::vector<uint64_t> string_offsets(strings.size());
+  header.num_strings = strings.size();
+  header.strings_offset =
+      append(string_offsets.data(), string_offsets.size() * sizeof(uint64_t));
+  for (size_t i = 0; i < strings.size(); ++i) {
+    uint32_t size = strings[i].size();
+    string_offsets[i] = append(&size, sizeof(size));
+    out.append(strings[i]);
+  }
+  std::memcpy(
+      &out[header.strings_offset],
+      string_offsets.data(),
+      string_offsets.size() * sizeof(uint64_t));
+  std::memcpy(&out[0], &header, sizeof(header));
+  return out;
+}
 } // namespace
 
 void moduleMethodsTuple(
@@ -280,8 +425,17 @@ class ScriptModuleSerializer {
   void writeByteCode(const Module& module) {
     std::vector<c10::IValue> elements;
     moduleMethodsTuple(module, elements);
+    // bytecode.bin holds the same methods, laid out to be read in place by
+    // the mobile loader. bytecode.pkl is still written for loaders that
+    // don't know it.
+    std::vector<IValue> pickled_constants;
+    std::string flat = flatByteCode(elements, pickled_constants);
     auto telements = Tup(std::move(elements));
     writeArchive("bytecode", telements);
+    if (!pickled_constants.empty()) {
+      writeArchive("bytecode_constants", Tup(std::move(pickled_constants)));
+    }
+    writer_.writeRecord("bytecode.bin", flat.data(), flat.size());
   }
 
   void convertNamedType(const c10::NamedTypePtr& class_type) {
@@ -16,6 +16,7 @@
 #include <caffe2/serialize/file_adapter.h>
 #include <caffe2/serialize/inline_container.h>
 #include <caffe2/serialize/istream_adapter.h>
+#include <caffe2/serialize/mmap_file_adapter.h>
 
 #include <ATen/ATen.h>
 #include <fmt/format.h>
@@ -28,8 +29,8 @@
 namespace torch {
 namespace jit {
 
-using caffe2::serialize::FileAdapter;
 using caffe2::serialize::IStreamAdapter;
+using caffe2::serialize::MmapFileAdapter;
 using caffe2::serialize::PyTorchStreamReader;
 using caffe2::serialize::ReadAdapterInterface;
 
@@ -289,7 +290,9 @@ Module import_ir_module(
     const std::string& filename,
     c10::optional<at::Device> device,
     ExtraFilesMap& extra_files) {
-  auto reader = torch::make_unique<PyTorchStreamReader>(filename);
+  // Tensor storages point into the mapped file instead of being read.
+  auto reader = torch::make_unique<PyTorchStreamReader>(
+      std::make_unique<MmapFileAdapter>(filename));
   ScriptModuleDeserializer deserializer(std::move(cu), std::move(reader));
   return deserializer.deserialize(device, extra_files);
 }
@@ -317,7 +320,8 @@ Module load(
     const std::string& filename,
     c10::optional<at::Device> device,
     ExtraFilesMap& extra_files) {
-  std::unique_ptr<FileAdapter> rai = std::make_unique<FileAdapter>(filename);
+  std::unique_ptr<MmapFileAdapter> rai =
+      std::make_unique<MmapFileAdapter>(filename);
   auto module = load(std::move(rai), device, extra_files);
   return module;
 }
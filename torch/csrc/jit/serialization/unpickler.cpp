@@ -149,7 +149,7 @@ void restoreAccurateTypeTags(const IValue& root, const TypePtr& type_tag) {
   }
 }
 
-void restoreContainerTypeTags(IValue& ivalue, TypePtr type) {
+void restoreContainerTypeTags(const IValue& ivalue, const TypePtr& type) {
   if (auto dict_type = type->cast<DictType>()) {
     auto dict = ivalue.toGenericDict();
     dict.unsafeSetKeyType(dict_type->getKeyType());
@@ -210,6 +210,24 @@ void Unpickler::run() {
     }
   }
 }
+// Move the keys and values on the stack from START on into DICT
+void Unpickler::readDictItems(c10::impl::GenericDict dict, size_t start) {
+  dict.reserve(dict.size() + (stack_.size() - start) / 2);
+  for (size_t i = start; i < stack_.size(); i += 2) {
+    dict.insert_or_assign(std::move(stack_[i]), std::move(stack_[i + 1]));
+  }
+  stack_.erase(stack_.begin() + start, stack_.end());
+}
+
+c10::Device Unpickler::parseDevice(const std::string& device_string) {
+  auto it = device_cache_.find(device_string);
+  if (it == device_cache_.end()) {
+    it = device_cache_.emplace(device_string, c10::Device(device_string))
+             .first;
+  }
+  return it->second;
+}
+
 void Unpickler::setInput(size_t memo_id) {
   AT_ASSERT(!stack_.empty());
   if (memo_id >= memo_table_.size()) {
@@ -312,12 +330,10 @@ PickleOpCode Unpickler::readInstruction() {
     case PickleOpCode::TUPLE: {
       size_t start = marks_.back();
       marks_.pop_back();
-      auto tuple = c10::ivalue::Tuple::create({});
-      tuple->elements().reserve(stack_.size() - start);
       auto start_it = stack_.begin() + start;
-      for (auto it = start_it; it != stack_.end(); ++it) {
-        tuple->elements().emplace_back(*it);
-      }
+      auto tuple = c10::ivalue::Tuple::create(std::vector<IValue>(
+          std::make_move_iterator(start_it),
+          std::make_move_iterator(stack_.end())));
       stack_.erase(start_it, stack_.end());
       stack_.emplace_back(tuple);
     } break;
@@ -351,20 +367,13 @@ PickleOpCode Unpickler::readInstruction() {
       size_t start = marks_.back();
       marks_.pop_back();
       auto dict = c10::impl::GenericDict(AnyType::get(), AnyType::get());
-      for (size_t i = start; i < stack_.size(); i += 2) {
-        dict.insert_or_assign(stack_[i], stack_[i + 1]);
-      }
-      stack_.erase(stack_.begin() + start, stack_.end());
+      readDictItems(dict, start);
       stack_.push_back(std::move(dict));
     } break;
     case PickleOpCode::SETITEMS: {
       size_t start = marks_.back();
       marks_.pop_back();
-      auto dict = stack_.at(start - 1).toGenericDict();
-      for (size_t i = start; i < stack_.size(); i += 2) {
-        dict.insert_or_assign(stack_[i], stack_[i + 1]);
-      }
-      stack_.erase(stack_.begin() + start, stack_.end());
+      readDictItems(stack_.at(start - 1).toGenericDict(), start);
     } break;
     case PickleOpCode::BINGET: {
       stack_.push_back(memo_table_.at(read<uint8_t>()));
@@ -397,35 +406,42 @@ PickleOpCode Unpickler::readInstruction() {
       globals_.at(idx)();
     } break;
     case PickleOpCode::BINPERSID: {
-      auto args = pop(stack_).toTuple()->elements();
+      auto tuple = pop(stack_).toTuple();
+      const auto& args = tuple->elements();
       AT_ASSERT(
           args.at(0).toStringRef() == "storage",
           "unknown PERSID key ",
           args.at(0).toStringRef());
       at::ScalarType type = args.at(1).toScalarType();
       const std::string& key = args.at(2).toStringRef();
-      at::Device device(args.at(3).toStringRef());
-      if (device_) {
-        device = *device_;
-      }
-      at::DataPtr storage_ptr = read_record_(key);
+      at::Device device =
+          device_ ? *device_ : parseDevice(args.at(3).toStringRef());
       int64_t numel = args.at(4).toInt();
-      caffe2::TypeMeta dtype = at::CPU(type).typeMeta();
-      at::Storage storage(
-          c10::Storage::use_byte_size_t(),
-          dtype,
-          numel * dtype.itemsize(),
-          std::move(storage_ptr),
-          /*allocator=*/nullptr,
-          /*resizable=*/false); // NB: we didn't set any allocator for the
-                                // tensor
-      auto options = at::CPU(type).options();
+      caffe2::TypeMeta dtype = c10::scalarTypeToTypeMeta(type);
+      auto cached = storage_cache_.find(key);
+      if (cached == storage_cache_.end()) {
+        at::DataPtr storage_ptr = read_record_(key);
+        at::Storage storage(
+            c10::Storage::use_byte_size_t(),
+            dtype,
+            numel * dtype.itemsize(),
+            std::move(storage_ptr),
+            /*allocator=*/nullptr,
+            /*resizable=*/false); // NB: we didn't set any allocator for the
+                                  // tensor
+        cached = storage_cache_.emplace(key, std::move(storage)).first;
+      }
+      const at::Storage& storage = cached->second;
       at::Tensor tensor;
-      if (options.backend() == c10::Backend::QuantizedCPU) {
-        tensor = at::_empty_affine_quantized({}, options, 0, 0)
+      if (c10::isQIntType(type)) {
+        tensor = at::_empty_affine_quantized(
+                     {}, at::CPU(type).options(), 0, 0)
                      .set_(storage, 0, {}, {});
       } else {
-        tensor = at::empty({0}, options).set_(storage);
+        // Same as at::empty({0}).set_(storage), without dispatching.
+        tensor = at::detail::make_tensor<c10::TensorImpl>(
+            c10::Storage(storage), c10::DispatchKey::CPU);
+        tensor.unsafeGetTensorImpl()->set_sizes_contiguous({numel});
       }
 
       if (device.type() == DeviceType::CUDA) {
@@ -484,9 +500,9 @@ void Unpickler::readGlobal(
       });
     } else if (class_name == "restore_type_tag") {
       globals_.emplace_back([this] {
-        auto data = stack_.back().toTuple()->elements();
-        auto type_str = data.at(1).toStringRef();
-        stack_.pop_back();
+        auto tuple = pop(stack_).toTuple();
+        const auto& data = tuple->elements();
+        const std::string& type_str = data.at(1).toStringRef();
         TypePtr type = nullptr;
         auto entry = type_cache_.find(type_str);
         if (entry != type_cache_.end()) {
@@ -546,9 +562,8 @@ void Unpickler::readGlobal(
     });
   } else if (module_name == "torch" && class_name == "device") {
     globals_.emplace_back([this] {
-      auto device_string = stack_.back().toTuple()->elements().at(0);
-      stack_.pop_back();
-      stack_.emplace_back(c10::Device(device_string.toStringRef()));
+      auto device_string = pop(stack_).toTuple()->elements().at(0);
+      stack_.emplace_back(parseDevice(device_string.toStringRef()));
     });
     stack_.emplace_back(int64_t(globals_.size() - 1));
     return;
@@ -643,7 +658,10 @@ void Unpickler::rebuildTensor(bool quantized) {
           break;
       }
     } else {
-      result = at::empty({0}, storage_tensor.options());
+      // Same as at::empty({0}, storage_tensor.options()), without dispatching
+      // or allocating a storage to replace below.
+      result = at::detail::make_tensor<c10::TensorImpl>(
+          c10::Storage(storage_tensor.storage()), storage_tensor.key_set());
     }
     bool requires_grad = elements.at(idx++).toBool();
     // elements[idx++] is empty backwards hooks
@@ -105,7 +105,9 @@ class Unpickler {
   }
   std::string readString();
   void readList(IValue list_ivalue);
+  void readDictItems(c10::impl::GenericDict dict, size_t start);
   void setInput(size_t memo_id);
+  c10::Device parseDevice(const std::string& device_string);
   void run();
 
   // Returns the number of bytes read. This should statefully
@@ -131,6 +133,13 @@ class Unpickler {
   // pickler, so we can just use the actual data pointer of each string.
   std::unordered_map<std::string, c10::TypePtr> type_cache_;
 
+  // Device strings are parsed with a regex, and repeat for every tensor.
+  std::unordered_map<std::string, c10::Device> device_cache_;
+
+  // Storages already read with read_record_, by key, so that tensors that
+  // share a storage in the archive share it when loaded too.
+  std::unordered_map<std::string, at::Storage> storage_cache_;
+
   // optionally nullptr, needs to be present for creating classes
   TypeResolver type_resolver_;
   ObjLoader obj_loader_;
@@ -1,11 +1,14 @@
 #include <torch/csrc/jit/tensorexpr/kernel.h>
 
+#include <c10/core/WrapDimMinimal.h>
 #include <c10/util/string_utils.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/tensorexpr/analysis.h>
 #include <torch/csrc/jit/tensorexpr/ir_printer.h>
 #include <torch/csrc/jit/tensorexpr/ir_simplifier.h>
 #include <torch/csrc/jit/tensorexpr/loopnest.h>
+#include <torch/csrc/jit/tensorexpr/reduction.h>
+#include <torch/csrc/jit/tensorexpr/var_substitutor.h>
 
 using namespace torch::jit;
 using namespace torch::jit::tensorexpr;
@@ -17,6 +20,7 @@ namespace tensorexpr {
 static int te_cuda_pointwise_loop_levels = -1;
 static int te_cuda_pointwise_block_count = -1;
 static int te_cuda_pointwise_block_size = -1;
+static bool te_generate_parallel_loops = true;
 static bool fallback_allowed = true;
 
 bool setFallbackAllowed(bool value) {
@@ -48,6 +52,10 @@ int& getTECudaPointwiseBlockSize() {
   return te_cuda_pointwise_block_size;
 }
 
+bool& getTEGenerateParallelLoops() {
+  return te_generate_parallel_loops;
+}
+
 } // namespace tensorexpr
 } // namespace jit
 } // namespace torch
@@ -60,6 +68,9 @@ static std::vector<ExprHandle> texprSizes(
     const c10::VaryingShape<int64_t>& shape) {
   std::vector<ExprHandle> dims;
   for (size_t i = 0; i < *shape.size(); i++) {
+    if (!shape[i]) {
+      throw malformed_input("expected a static dimension");
+    }
     dims.push_back(IntImm::make(*shape[i]));
   }
   return dims;
@@ -181,6 +192,59 @@ ExprHandle TensorExprKernel::demoteOutput(
   return e;
 }
 
+// The number of times the innermost statements of a loop nest run, or -1 if
+// a loop bound isn't constant.
+static int64_t loopNestSize(Stmt* s) {
+  if (For* f = dynamic_cast<For*>(s)) {
+    auto start = dynamic_cast<const IntImm*>(f->start());
+    auto stop = dynamic_cast<const IntImm*>(f->stop());
+    int64_t bodySize = loopNestSize(f->body());
+    if (!start || !stop || bodySize < 0) {
+      return -1;
+    }
+    return (stop->value() - start->value()) * bodySize;
+  }
+  if (tensorexpr::Block* b = dynamic_cast<tensorexpr::Block*>(s)) {
+    int64_t size = 0;
+    for (Stmt* s2 : *b) {
+      int64_t size2 = loopNestSize(s2);
+      if (size2 < 0) {
+        return -1;
+      }
+      size += size2;
+    }
+    return size;
+  }
+  return 1;
+}
+
+// Whether every store in loop F writes an element whose index depends on the
+// loop variable, so that the iterations of F write disjoint elements and F
+// can be vectorized or parallelized. Loops over reduction axes can't.
+static bool storesDependOnLoopVar(For* f) {
+  class StoreFinder : public IRVisitor {
+   public:
+    void visit(const Store* v) override {
+      stores.push_back(v);
+      IRVisitor::visit(v);
+    }
+    std::vector<const Store*> stores;
+  };
+  StoreFinder finder;
+  f->accept(&finder);
+  VarFinder varFinder;
+  for (const Store* store : finder.stores) {
+    bool dependent = false;
+    for (const Expr* index : store->indices()) {
+      dependent |= varFinder.findVars(index).count(f->var()) != 0;
+    }
+    if (!dependent) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static bool isOne(ExprHandle e) {
   auto const& n = e.AsNode<IntImm>();
   if (!n) {
@@ -189,7 +253,7 @@ static bool isOne(ExprHandle e) {
   return n->value() == 1;
 }
 
-static std::pair<std::vector<ExprHandle>, bool> broadcastShapes(
+std::pair<std::vector<ExprHandle>, bool> TensorExprKernel::broadcastShapes(
     const std::vector<ExprHandle>& a,
     const std::vector<ExprHandle>& b) {
   bool broadcast = false;
@@ -216,6 +280,10 @@ static std::pair<std::vector<ExprHandle>, bool> broadcastShapes(
         dim = *bt;
         broadcast = true;
       }
+    } else if (
+        !isOne(*bt) && at->node() != bt->node() &&
+        !(at->AsNode<IntImm>() && bt->AsNode<IntImm>())) {
+      dynamicDimChecks_.emplace_back(*at, *bt);
     }
     ret.push_back(dim);
     at++;
@@ -225,16 +293,6 @@ static std::pair<std::vector<ExprHandle>, bool> broadcastShapes(
   return {ret, broadcast};
 }
 
-template <typename... Args>
-static std::pair<std::vector<ExprHandle>, bool> broadcastShapes(
-    const std::vector<ExprHandle>& a,
-    const std::vector<ExprHandle>& b,
-    Args... args) {
-  auto const& res = broadcastShapes(a, b);
-  auto const& res2 = broadcastShapes(res.first, args...);
-  return {res2.first, res.second || res2.second};
-}
-
 std::vector<ExprHandle> TensorExprKernel::valueShape(
     const torch::jit::Value* v) {
   auto it = tensors_.find(v->unique());
@@ -413,6 +471,182 @@ Tensor* TensorExprKernel::computeFourOperand(
       });
 }
 
+// Which dimensions of a tensor of rank RANK the int[] constant DIMS reduces;
+// an empty list reduces all of them.
+static std::vector<bool> reducedDims(
+    const torch::jit::Value* dims,
+    size_t rank) {
+  std::vector<int64_t> dimList = toIValue(dims)->toIntVector();
+  std::vector<bool> reduced(rank, dimList.empty());
+  for (int64_t dim : dimList) {
+    reduced[c10::maybe_wrap_dim(dim, rank)] = true;
+  }
+  return reduced;
+}
+
+Tensor* TensorExprKernel::computeSumOrMean(
+    const torch::jit::Value* v,
+    bool mean) {
+  if (pickDeviceType(graph_->inputs()).type() != at::kCPU) {
+    throw std::runtime_error("Reductions are only supported on CPU");
+  }
+
+  // Either sum(Tensor self, *, ScalarType? dtype), which reduces all
+  // dimensions, or sum.dim_IntList(Tensor self, int[1] dim, bool keepdim, *,
+  // ScalarType? dtype); the same for mean.
+  auto const& n = v->node();
+  auto const& inputShape = valueShape(n->inputs()[0]);
+  size_t rank = inputShape.size();
+  std::vector<bool> reduced(rank, true);
+  bool keepdim = false;
+  if (n->inputs().size() == 4) {
+    reduced = reducedDims(n->inputs()[1], rank);
+    keepdim = toIValue(n->inputs()[2])->toBool();
+  }
+
+  std::vector<DimArg> outputDims;
+  std::vector<DimArg> reduceDims;
+  // The number of reduced elements, if all the reduced dimensions are static.
+  int64_t reducedCount = 1;
+  ExprHandle dynamicReducedCount = IntImm::make(1);
+  bool dynamicReduction = false;
+  for (size_t i = 0; i < rank; i++) {
+    std::string axis = c10::to_string(i);
+    if (!reduced[i]) {
+      outputDims.emplace_back(inputShape[i], "i" + axis);
+      continue;
+    }
+    reduceDims.emplace_back(inputShape[i], "r" + axis);
+    if (auto size = inputShape[i].AsNode<IntImm>()) {
+      reducedCount *= size->value();
+    } else {
+      dynamicReducedCount = dynamicReducedCount * inputShape[i];
+      dynamicReduction = true;
+    }
+    if (keepdim) {
+      outputDims.emplace_back(IntImm::make(1), "i" + axis);
+    }
+  }
+
+  // The body gets the output axes followed by the reduction axes.
+  size_t nOutputDims = outputDims.size();
+  std::function<ExprHandle(const std::vector<VarHandle>&)> body =
+      [this, v, reduced, keepdim, nOutputDims](
+          const std::vector<VarHandle>& vars) {
+        std::vector<ExprHandle> indices;
+        size_t outputIdx = 0;
+        size_t reduceIdx = nOutputDims;
+        for (bool r : reduced) {
+          if (r) {
+            indices.push_back(vars[reduceIdx++]);
+            outputIdx += keepdim;
+          } else {
+            indices.push_back(vars[outputIdx++]);
+          }
+        }
+        return demoteOutput(
+            tensorOrConstant(v->node()->inputs()[0], indices), v);
+      };
+  Tensor* sum = Reduce(
+      mean ? "aten_mean_sum" : "aten_sum", outputDims, Sum(), body, reduceDims);
+  if (!mean) {
+    return sum;
+  }
+  ExprHandle count = FloatImm::make(reducedCount);
+  if (dynamicReduction) {
+    count = count * Cast::make(kFloat, dynamicReducedCount);
+  }
+  return Compute(
+      "aten_mean",
+      outputDims,
+      [this, v, sum, count](const std::vector<VarHandle>& axes) {
+        std::vector<ExprHandle> inputs = {sum->call(axes), count};
+        promoteInputs(inputs);
+        return demoteOutput(inputs[0] / inputs[1], v);
+      });
+}
+
+Tensor* TensorExprKernel::computeSoftmax(
+    const torch::jit::Value* v,
+    bool logSoftmax) {
+  if (pickDeviceType(graph_->inputs()).type() != at::kCPU) {
+    throw std::runtime_error("Reductions are only supported on CPU");
+  }
+
+  // Along dim, softmax(x) = exp(x - max(x)) / sum(exp(x - max(x))) and
+  // log_softmax(x) = x - max(x) - log(sum(exp(x - max(x)))). The max and
+  // sum reductions and the exponentials are intermediate tensors; the
+  // producers of x and the consumers of the result are fused as usual.
+  auto const& n = v->node();
+  auto const& inputShape = valueShape(n->inputs()[0]);
+  size_t rank = inputShape.size();
+  size_t dim = c10::maybe_wrap_dim(toIValue(n->inputs()[1])->toInt(), rank);
+  Dtype dtype = ToDtype(
+      static_cast<ScalarType>(*v->type()->cast<TensorType>()->scalarType()));
+
+  std::vector<DimArg> outputDims;
+  std::vector<DimArg> nonSoftmaxDims;
+  for (size_t i = 0; i < rank; i++) {
+    outputDims.emplace_back(inputShape[i], "i" + c10::to_string(i));
+    if (i != dim) {
+      nonSoftmaxDims.emplace_back(inputShape[i], "i" + c10::to_string(i));
+    }
+  }
+  std::vector<DimArg> softmaxDims = {
+      DimArg(inputShape[dim], "r" + c10::to_string(dim))};
+
+  // Reduction bodies get the non-softmax axes followed by the softmax axis.
+  auto reductionIndices = [dim](const std::vector<VarHandle>& vars) {
+    std::vector<ExprHandle> indices(vars.begin(), vars.end() - 1);
+    indices.insert(indices.begin() + dim, vars.back());
+    return indices;
+  };
+  auto nonSoftmaxIndices = [dim](const std::vector<VarHandle>& axes) {
+    std::vector<ExprHandle> indices(axes.begin(), axes.end());
+    indices.erase(indices.begin() + dim);
+    return indices;
+  };
+
+  std::function<ExprHandle(const std::vector<VarHandle>&)> maxBody =
+      [this, n, reductionIndices](const std::vector<VarHandle>& vars) {
+        return tensorOrConstant(n->inputs()[0], reductionIndices(vars));
+      };
+  Tensor* max = Reduce(
+      "aten_softmax_max", nonSoftmaxDims, Maximum(dtype), maxBody, softmaxDims);
+  Tensor* e = Compute(
+      "aten_softmax_exp",
+      outputDims,
+      [this, n, max, nonSoftmaxIndices](const std::vector<VarHandle>& axes) {
+        return exp(
+            tensorOrConstant(n->inputs()[0], axes) -
+            max->call(nonSoftmaxIndices(axes)));
+      });
+  std::function<ExprHandle(const std::vector<VarHandle>&)> sumBody =
+      [e, reductionIndices](const std::vector<VarHandle>& vars) {
+        return e->call(reductionIndices(vars));
+      };
+  Tensor* sum =
+      Reduce("aten_softmax_sum", nonSoftmaxDims, Sum(), sumBody, softmaxDims);
+
+  if (!logSoftmax) {
+    return Compute(
+        "aten_softmax",
+        outputDims,
+        [e, sum, nonSoftmaxIndices](const std::vector<VarHandle>& axes) {
+          return e->call(axes) / sum->call(nonSoftmaxIndices(axes));
+        });
+  }
+  return Compute(
+      "aten_log_softmax",
+      outputDims,
+      [this, n, max, sum, nonSoftmaxIndices](
+          const std::vector<VarHandle>& axes) {
+        auto indices = nonSoftmaxIndices(axes);
+        return tensorOrConstant(n->inputs()[0], axes) - max->call(indices) -
+            log(sum->call(indices));
+      });
+}
+
 Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
   switch (v->node()->kind()) {
     case aten::add: {
@@ -972,6 +1206,22 @@ Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
           });
     }
 
+    case aten::sum: {
+      return computeSumOrMean(v, /*mean=*/false);
+    }
+
+    case aten::mean: {
+      return computeSumOrMean(v, /*mean=*/true);
+    }
+
+    case aten::softmax: {
+      return computeSoftmax(v, /*logSoftmax=*/false);
+    }
+
+    case aten::log_softmax: {
+      return computeSoftmax(v, /*logSoftmax=*/true);
+    }
+
     default: {
       throw std::runtime_error("Unhandled node kind");
     }
@@ -1028,9 +1278,11 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
 
   torch::jit::tensorexpr::LoopNest l(flatTensorOutputs_);
 
-  // Compute non-output tensors_ inline
+  // Compute non-output tensors_ inline, except for reductions, which are
+  // computed into temporary buffers.
   for (auto& p : tensors_) {
-    if (!l.hasLoopBodyFor(p.second)) {
+    if (!l.hasLoopBodyFor(p.second) ||
+        dynamic_cast<const ReduceOp*>(p.second->body())) {
       continue;
     }
     Stmt* loop = l.getLoopBodyFor(p.second);
@@ -1112,6 +1364,8 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
       }
     }
 
+    std::vector<For*> outerLoops = worklist;
+
     // Traverse the For loop nest find inner-most loops, which are
     // vectorization candidates.
     while (worklist.size()) {
@@ -1135,12 +1389,16 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
 
     // vectorize inner loops.
     for (For* loop : innerLoops) {
+      if (!storesDependOnLoopVar(loop)) {
+        continue;
+      }
       For* outer1;
       For* split1;
       For* tail1;
 
       l.splitWithTail(loop, 8, &outer1, &split1, &tail1);
       l.vectorize(split1);
+      std::replace(outerLoops.begin(), outerLoops.end(), loop, outer1);
 
       if (tail1) {
         For* outer2;
@@ -1150,6 +1408,23 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
         l.vectorize(split2);
       }
     }
+
+    // Run the outer-most loops of large outputs on the intra-op thread pool.
+    // The iterations of an output loop write disjoint elements, but random
+    // number generation isn't thread-safe. Sizes count statements after
+    // vectorization, i.e., vectors of 8 elements.
+    const int64_t kMinParallelSize = 1 << 12;
+    if (getTEGenerateParallelLoops() && !hasRandom_) {
+      for (For* loop : outerLoops) {
+        auto start = dynamic_cast<const IntImm*>(loop->start());
+        auto stop = dynamic_cast<const IntImm*>(loop->stop());
+        if (start && stop && stop->value() - start->value() > 1 &&
+            loopNestSize(loop) >= kMinParallelSize &&
+            storesDependOnLoopVar(loop)) {
+          l.parallelize(loop);
+        }
+      }
+    }
   }
 
   Stmt* stmt = l.root_stmt();
@@ -1308,13 +1583,65 @@ void TensorExprKernel::bindInput(const torch::jit::Value* input) {
           "t" + input->debugName(),
           ToDtype(static_cast<ScalarType>(*tt->scalarType())),
           {0});
+      // Sizes and strides that aren't static are passed to the kernel.
+      // Strides of contiguous dimensions are computed from the sizes instead,
+      // so that inner loops keep a unit stride.
+      std::vector<ShapeArg> sizeArgs;
+      std::vector<ShapeArg> strideArgs;
+      size_t rank = *tt->dim();
+      std::vector<ExprHandle> sizes;
+      for (size_t i = 0; i < rank; i++) {
+        if (auto size = tt->sizes()[i]) {
+          sizes.push_back(IntImm::make(*size));
+        } else {
+          VarHandle var(
+              "t" + input->debugName() + "_size" + c10::to_string(i), kInt);
+          sizeArgs.emplace_back(i, var);
+          sizes.push_back(var);
+        }
+      }
+      std::vector<c10::optional<ExprHandle>> strides(rank);
+      for (size_t i = 0; i < rank; i++) {
+        if (auto stride = tt->strides()[i]) {
+          strides[i] = IntImm::make(*stride);
+        }
+      }
+      const auto& strideProps = tt->stride_properties();
+      std::vector<std::pair<size_t, bool>> contiguousDims;
+      bool derivedStrides = false;
+      for (size_t i = 0; i < rank && strideProps.size().has_value(); i++) {
+        auto const& s = strideProps[i];
+        if (!s || !s->stride_index_ || !s->contiguous_ || !*s->contiguous_) {
+          break;
+        }
+        size_t dim = *s->stride_index_;
+        bool derived = !strides[dim];
+        if (derived) {
+          size_t prev = contiguousDims.empty() ? 0 : contiguousDims.back().first;
+          strides[dim] = contiguousDims.empty()
+              ? IntImm::make(1)
+              : *strides[prev] * sizes[prev];
+          derivedStrides = true;
+        }
+        contiguousDims.emplace_back(dim, derived);
+      }
+      if (derivedStrides) {
+        contiguousInputDims_.emplace_back(kernelArgs_.size(), contiguousDims);
+      }
+      for (size_t i = 0; i < rank; i++) {
+        if (!strides[i]) {
+          VarHandle var(
+              "t" + input->debugName() + "_stride" + c10::to_string(i), kInt);
+          strideArgs.emplace_back(i, var);
+          strides[i] = var;
+        }
+      }
+
       std::vector<DimArg> inputTensorDims;
-      for (size_t i = 0; i < *tt->sizes().size(); i++) {
-        auto const size = *tt->sizes()[i];
+      for (size_t i = 0; i < rank; i++) {
         inputTensorDims.emplace_back(
-            DimArg(IntImm::make(size), "i" + c10::to_string(i)));
+            DimArg(sizes[i], "i" + c10::to_string(i)));
       }
-      auto const strides = tt->strides();
       tensors_.emplace(
           input->unique(),
           Compute(
@@ -1323,12 +1650,12 @@ void TensorExprKernel::bindInput(const torch::jit::Value* input) {
               [&](const std::vector<VarHandle>& axes) {
                 ExprHandle idx = 0;
                 for (size_t i = 0; i < axes.size(); i++) {
-                  idx = idx + axes[i] * IntImm::make(*strides[i]);
+                  idx = idx + axes[i] * *strides[i];
                 }
                 return inBuffer(idx);
               }));
       kernelArgs_.emplace_back(
-          inBuffer, std::vector<ShapeArg>(), std::vector<ShapeArg>());
+          inBuffer, std::move(sizeArgs), std::move(strideArgs));
       break;
     }
     case TypeKind::FloatType: {
@@ -1484,6 +1811,48 @@ std::vector<CodeGen::CallArg> TensorExprKernel::prepareRunArgs(
   return runArgs;
 }
 
+bool TensorExprKernel::checkDynamicDims(const at::ArrayRef<IValue>& inputs) {
+  if (dynamicDimChecks_.empty() && contiguousInputDims_.empty()) {
+    return true;
+  }
+  std::unordered_map<const Expr*, int64_t> sizes;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    for (auto const& size : kernelArgs_[i].sizes()) {
+      sizes[size.var.node()] = inputs[i].toTensor().sizes()[size.idx];
+    }
+  }
+  auto value = [&](const ExprHandle& e) {
+    if (auto imm = e.AsNode<IntImm>()) {
+      return static_cast<int64_t>(imm->value());
+    }
+    return sizes.at(e.node());
+  };
+  for (auto const& check : dynamicDimChecks_) {
+    if (value(check.first) != value(check.second)) {
+      GRAPH_DEBUG("Dynamic dimensions don't match, running the fallback");
+      return false;
+    }
+  }
+  // Contiguity flags don't constrain the strides of dimensions of size 1, so
+  // the strides computed from the sizes need to be checked.
+  for (auto const& input : contiguousInputDims_) {
+    auto const& tensor = inputs[input.first].toTensor();
+    int64_t stride = 1;
+    for (auto const& dim : input.second) {
+      if (!dim.second) {
+        stride = tensor.strides()[dim.first];
+      } else if (
+          tensor.sizes()[dim.first] != 1 &&
+          tensor.strides()[dim.first] != stride) {
+        GRAPH_DEBUG("Input strides don't match, running the fallback");
+        return false;
+      }
+      stride *= tensor.sizes()[dim.first];
+    }
+  }
+  return true;
+}
+
 Stmt* TensorExprKernel::getCodeGenStmt() {
   return codegen_->stmt();
 }
@@ -1493,6 +1862,10 @@ void TensorExprKernel::runKernel(Stack& stack) {
 
   // Set up arguments (inputs, then outputs) for kernel call.
   auto inputs = last(stack, nInputs_);
+  if (!checkDynamicDims(inputs)) {
+    fallback(stack);
+    return;
+  }
   std::vector<at::Tensor> outputs;
 
   std::vector<CodeGen::CallArg> runArgs = prepareRunArgs(inputs, outputs);
@@ -13,7 +13,11 @@ template <typename T>
 inline std::vector<int64_t> bufferSizes(const T& t) {
   std::vector<int64_t> sizes;
   for (size_t i = 0; i < t->buf()->ndim(); i++) {
-    sizes.push_back(dynamic_cast<const IntImm*>(t->buf()->dim(i))->value());
+    auto size = dynamic_cast<const IntImm*>(t->buf()->dim(i));
+    if (!size) {
+      throw malformed_input("expected a static dimension", t->buf()->dim(i));
+    }
+    sizes.push_back(size->value());
   }
   return sizes;
 }
@@ -98,6 +102,27 @@ class TORCH_API TensorExprKernel {
 
   std::vector<ExprHandle> valueShape(const torch::jit::Value* v);
 
+  // Returns the broadcast of the shapes and whether any of them had to be
+  // broadcast. Dynamic dimensions are never broadcast: they are assumed to
+  // match, which is checked before running the kernel.
+  std::pair<std::vector<ExprHandle>, bool> broadcastShapes(
+      const std::vector<ExprHandle>& a,
+      const std::vector<ExprHandle>& b);
+
+  template <typename... Args>
+  std::pair<std::vector<ExprHandle>, bool> broadcastShapes(
+      const std::vector<ExprHandle>& a,
+      const std::vector<ExprHandle>& b,
+      Args... args) {
+    auto const& res = broadcastShapes(a, b);
+    auto const& res2 = broadcastShapes(res.first, args...);
+    return {res2.first, res.second || res2.second};
+  }
+
+  // Whether the dynamic dimensions of the inputs satisfy the assumptions the
+  // kernel was compiled with.
+  bool checkDynamicDims(const at::ArrayRef<IValue>& inputs);
+
   void promoteInputs(std::vector<ExprHandle>& inputs);
 
   ExprHandle demoteOutput(const ExprHandle& e, const torch::jit::Value* v);
@@ -153,6 +178,10 @@ class TORCH_API TensorExprKernel {
           const ExprHandle&,
           const ExprHandle&)>& innerExpr);
 
+  Tensor* computeSumOrMean(const torch::jit::Value* v, bool mean);
+
+  Tensor* computeSoftmax(const torch::jit::Value* v, bool logSoftmax);
+
   Tensor* computeValue(const torch::jit::Value* v);
 
   void flattenTensors(BackendType backendType);
@@ -210,6 +239,13 @@ class TORCH_API TensorExprKernel {
   std::vector<Tensor*> flatTensorOutputs_;
   std::unordered_map<int64_t, Tensor*> tensors_;
   std::unordered_map<int64_t, VarHandle> scalars_;
+  // Pairs of dimensions, at least one of them dynamic, that must be equal.
+  std::vector<std::pair<ExprHandle, ExprHandle>> dynamicDimChecks_;
+  // Inputs whose strides are computed from their sizes, with their
+  // contiguous dimensions from the innermost and whether their stride is
+  // computed.
+  std::vector<std::pair<size_t, std::vector<std::pair<size_t, bool>>>>
+      contiguousInputDims_;
   std::unique_ptr<CodeGen> codegen_;
   at::Device device_ = at::kCPU;
   KernelArena kernelArena_;
@@ -224,6 +260,7 @@ class TORCH_API TensorExprKernel {
 TORCH_API int& getTECudaPointwiseLoopLevels();
 TORCH_API int& getTECudaPointwiseBlockCount();
 TORCH_API int& getTECudaPointwiseBlockSize();
+TORCH_API bool& getTEGenerateParallelLoops();
 TORCH_API bool fallbackAllowed();
 TORCH_API bool setFallbackAllowed(bool value);
 
@@ -4,8 +4,11 @@
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
 #include <memory>
+#include <set>
 
+#include <ATen/Parallel.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/IRBuilder.h>
@@ -15,6 +18,7 @@
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 
+#include <torch/csrc/jit/codegen/fuser/kernel_disk_cache.h>
 #include <torch/csrc/jit/tensorexpr/buffer.h>
 #include <torch/csrc/jit/tensorexpr/execution_counter.h>
 #include <torch/csrc/jit/tensorexpr/ir.h>
@@ -37,6 +41,8 @@ class LLVMCodeGenImpl : public IRVisitor {
   llvm::IRBuilder<> irb_;
   std::unique_ptr<llvm::TargetMachine> TM_;
   std::unique_ptr<llvm::orc::PytorchLLVMJIT> jit_;
+  // The kernel compiled to an object file, when the disk cache is enabled.
+  std::unique_ptr<llvm::MemoryBuffer> object_;
   std::unique_ptr<llvm::Module> module_;
   llvm::Function* fn_;
   llvm::BasicBlock* bb_;
@@ -57,6 +63,7 @@ class LLVMCodeGenImpl : public IRVisitor {
   llvm::Type* dtypeToLLVMPtr(Dtype dtype);
   void emitWrapper(const std::vector<llvm::Type*>& params);
   void emitKernel(Stmt* stmt, const std::vector<llvm::Type*>& params);
+  void emitParallelFor(const For* v);
 
  public:
   LLVMCodeGenImpl(
@@ -211,6 +218,20 @@ void** LLVMCodeGenImpl::getArgvAddress() const {
   return argv_.get();
 }
 
+extern "C" void DispatchParallel(
+    int8_t* func,
+    int64_t start,
+    int64_t stop,
+    int8_t* packed_data) noexcept {
+  using ParallelCallee = void (*)(int64_t, int8_t*);
+  auto callee = reinterpret_cast<ParallelCallee>(func);
+  at::parallel_for(start, stop, 1, [&](int64_t f_begin, int64_t f_end) {
+    for (int64_t index = f_begin; index < f_end; index++) {
+      callee(index, packed_data);
+    }
+  });
+}
+
 LLVMCodeGenImpl::LLVMCodeGenImpl(
     Stmt* stmt,
     const std::vector<CodeGen::BufferArg>& args,
@@ -263,8 +284,12 @@ LLVMCodeGenImpl::LLVMCodeGenImpl(
   emitWrapper(params);
   emitKernel(stmt, params);
 
-  cantFail(jit_->addModule(
-      llvm::orc::ThreadSafeModule(std::move(module_), context_)));
+  if (object_) {
+    cantFail(jit_->addObject(std::move(object_)));
+  } else {
+    cantFail(jit_->addModule(
+        llvm::orc::ThreadSafeModule(std::move(module_), context_)));
+  }
   auto sym = jit_->findSymbol("wrapper");
   kernelAddress_ = cantFail(sym.getAddress());
   argv_ = std::make_unique<void*[]>(params.size());
@@ -345,8 +370,41 @@ void LLVMCodeGenImpl::emitKernel(
   if (llvm::verifyFunction(*fn_, &llvm::outs())) {
     throw std::runtime_error("Function verification failed");
   }
+
+  // The object code is cached on disk by the unoptimized IR and the target.
+  std::string cacheKey;
+  if (torch::jit::fuser::kernelDiskCacheEnabled()) {
+    llvm::raw_string_ostream keyStream(cacheKey);
+    keyStream << "LLVM " << LLVM_VERSION_STRING << " "
+              << TM_->getTargetTriple().str() << " " << TM_->getTargetCPU()
+              << " " << TM_->getTargetFeatureString() << "\n"
+              << *module_;
+    keyStream.flush();
+    if (auto cached =
+            torch::jit::fuser::loadCachedKernel(cacheKey, "o")) {
+      object_ = llvm::MemoryBuffer::getMemBufferCopy(*cached, "pytorch");
+      return;
+    }
+  }
+
   optimize(*module_);
 
+  if (!cacheKey.empty()) {
+    llvm::SmallVector<char, 0> objBuffer;
+    llvm::raw_svector_ostream objStream(objBuffer);
+    llvm::legacy::PassManager PM;
+    if (!TM_->addPassesToEmitFile(
+            PM,
+            objStream,
+            nullptr,
+            llvm::TargetMachine::CodeGenFileType::CGFT_ObjectFile)) {
+      PM.run(*module_);
+      std::string object(objBuffer.begin(), objBuffer.end());
+      torch::jit::fuser::storeCachedKernel(cacheKey, "o", object);
+      object_ = llvm::MemoryBuffer::getMemBufferCopy(object, "pytorch");
+    }
+  }
+
 #if DEBUG_PRINT
   llvm::errs() << *module_;
   llvm::SmallVector<char, 0> asmBuffer;
@@ -867,7 +925,119 @@ void LLVMCodeGenImpl::visit(const Load* v) {
   value_ = load;
 }
 
+namespace {
+
+// Finds the Vars used in a statement.
+class StmtVarFinder : public IRVisitor {
+ public:
+  std::set<const Var*> findVars(Stmt* s) {
+    vars_.clear();
+    s->accept(this);
+    return vars_;
+  }
+
+  void visit(const Var* v) override {
+    vars_.insert(v);
+  }
+
+ private:
+  std::set<const Var*> vars_;
+};
+
+} // namespace
+
+// Outlines the body of a parallel loop into a function of the loop index and
+// of a struct holding the values the body uses, and emits a call to
+// DispatchParallel, which runs it over the loop range with at::parallel_for.
+void LLVMCodeGenImpl::emitParallelFor(const For* v) {
+  v->start()->accept(this);
+  auto start = irb_.CreateIntCast(value_, LongTy_, true);
+  v->stop()->accept(this);
+  auto stop = irb_.CreateIntCast(value_, LongTy_, true);
+
+  // Capture the kernel arguments and bound values used by the body.
+  std::vector<const Var*> captured;
+  std::vector<llvm::Value*> capturedValues;
+  std::vector<llvm::Type*> capturedTypes;
+  for (const Var* var : StmtVarFinder().findVars(v->body())) {
+    llvm::Value* value = nullptr;
+    if (varToArg_.count(var)) {
+      value = fn_->arg_begin() + varToArg_.at(var);
+    } else if (varToVal_.count(var)) {
+      value = varToVal_.at(var);
+    } else {
+      continue;
+    }
+    captured.push_back(var);
+    capturedValues.push_back(value);
+    capturedTypes.push_back(value->getType());
+  }
+  auto packedTy = llvm::StructType::create(getContext(), capturedTypes);
+  llvm::IRBuilder<> entryIrb(
+      &fn_->getEntryBlock(), fn_->getEntryBlock().begin());
+  auto packed = entryIrb.CreateAlloca(packedTy);
+  for (size_t i = 0; i < capturedValues.size(); i++) {
+    irb_.CreateStore(
+        capturedValues[i], irb_.CreateStructGEP(packedTy, packed, i));
+  }
+
+  // Emit the body function, with the captured values as its only bindings.
+  auto bytePtrTy = llvm::Type::getInt8PtrTy(getContext());
+  auto bodyFn = llvm::Function::Create(
+      llvm::FunctionType::get(
+          llvm::Type::getVoidTy(getContext()), {LongTy_, bytePtrTy}, false),
+      llvm::Function::PrivateLinkage,
+      "parallel_body",
+      module_.get());
+  auto savedFn = fn_;
+  auto savedInsertBlock = irb_.GetInsertBlock();
+  auto savedVarToArg = std::move(varToArg_);
+  auto savedVarToVal = std::move(varToVal_);
+  varToArg_.clear();
+  varToVal_.clear();
+
+  fn_ = bodyFn;
+  irb_.SetInsertPoint(llvm::BasicBlock::Create(getContext(), "entry", fn_));
+  auto bodyPacked =
+      irb_.CreatePointerCast(fn_->arg_begin() + 1, packedTy->getPointerTo());
+  for (size_t i = 0; i < captured.size(); i++) {
+    varToVal_[captured[i]] = irb_.CreateLoad(
+        capturedTypes[i], irb_.CreateStructGEP(packedTy, bodyPacked, i));
+  }
+  varToVal_[v->var()] = irb_.CreateIntCast(
+      fn_->arg_begin(), dtypeToLLVM(v->var()->dtype()), true);
+  v->body()->accept(this);
+  irb_.CreateRetVoid();
+  if (llvm::verifyFunction(*bodyFn, &llvm::outs())) {
+    throw std::runtime_error("Function verification failed");
+  }
+
+  fn_ = savedFn;
+  irb_.SetInsertPoint(savedInsertBlock);
+  varToArg_ = std::move(savedVarToArg);
+  varToVal_ = std::move(savedVarToVal);
+
+  auto dispatch = module_->getOrInsertFunction(
+      "DispatchParallel",
+      llvm::FunctionType::get(
+          llvm::Type::getVoidTy(getContext()),
+          {bytePtrTy, LongTy_, LongTy_, bytePtrTy},
+          false));
+  irb_.CreateCall(
+      dispatch,
+      {irb_.CreatePointerCast(bodyFn, bytePtrTy),
+       start,
+       stop,
+       irb_.CreatePointerCast(packed, bytePtrTy)});
+  value_ = llvm::ConstantInt::get(IntTy_, 0);
+}
+
 void LLVMCodeGenImpl::visit(const For* v) {
+  if (v->loop_options().is_parallel()) {
+    emitParallelFor(v);
+    return;
+  }
+
   // Create "start" and "stop" values.
   v->start()->accept(this);
   auto start = this->value_;
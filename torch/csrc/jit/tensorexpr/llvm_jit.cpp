@@ -28,6 +28,11 @@ class TORCH_API PytorchLLVMJITImpl {
     // Handle platform-specific symbol mangling
     MangleAndInterner Mangle(LLJ->getExecutionSession(), LLJ->getDataLayout());
 
+    // Register the runtime entry point of parallel loops.
+    cantFail(LLJ->defineAbsolute(
+        *Mangle("DispatchParallel"),
+        {llvm::pointerToJITTargetAddress(&DispatchParallel), {}}));
+
     // Register implementations of intrinsics
     cantFail(LLJ->defineAbsolute(
         *Mangle("log10f"), {llvm::pointerToJITTargetAddress(&log10f), {}}));
@@ -425,6 +430,10 @@ class TORCH_API PytorchLLVMJITImpl {
     return Error::success();
   }
 
+  Error addObject(std::unique_ptr<MemoryBuffer> Obj) {
+    return LLJ->addObjectFile(std::move(Obj));
+  }
+
   JITSymbol findSymbol(const std::string Name) {
     return cantFail(LLJ->lookup(Name));
   }
@@ -443,6 +452,10 @@ Error PytorchLLVMJIT::addModule(ThreadSafeModule M) {
   return impl_->addModule(std::move(M));
 }
 
+Error PytorchLLVMJIT::addObject(std::unique_ptr<MemoryBuffer> Obj) {
+  return impl_->addObject(std::move(Obj));
+}
+
 JITSymbol PytorchLLVMJIT::findSymbol(const std::string Name) {
   return impl_->findSymbol(std::move(Name));
 }
@@ -6,11 +6,20 @@
 #include <llvm/ExecutionEngine/JITSymbol.h>
 #include <llvm/ExecutionEngine/Orc/Core.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Target/TargetMachine.h>
 
 #include <memory>
 #include <string>
 
+// Runs func(index, packed_data) for every index in [start, stop) with
+// at::parallel_for. Kernels call it to run their parallel loops.
+extern "C" TORCH_API void DispatchParallel(
+    int8_t* func,
+    int64_t start,
+    int64_t stop,
+    int8_t* packed_data) noexcept;
+
 namespace llvm {
 namespace orc {
 
@@ -23,6 +32,10 @@ class TORCH_API PytorchLLVMJIT {
 
   Error addModule(ThreadSafeModule M);
 
+  // Adds a relocatable object file compiled for the host, e.g., a module
+  // previously compiled by the TargetMachine of the host.
+  Error addObject(std::unique_ptr<MemoryBuffer> Obj);
+
   JITSymbol findSymbol(const std::string Name);
 
   TargetMachine& getTargetMachine();
@@ -43,6 +43,10 @@ class TORCH_API LoopNest {
   void setGPUBlockIndex(For* f, int idx);
   void setGPUThreadIndex(For* f, int idx);
 
+  // Run the iterations of loop F in parallel on the CPU. The LLVM backend
+  // lowers it to a call into at::parallel_for; other backends run F serially.
+  void parallelize(For* f);
+
   // Insert a temporary computation of statement S in the scope of loop AT.
   // S is assumed to be a Store or a Block containing a Store. Along with the
   // computation itself, this transformation inserts Alloc/Free statements for
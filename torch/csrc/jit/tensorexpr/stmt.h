@@ -467,6 +467,9 @@ class TORCH_API LoopOptions {
   }
 
   void set_gpu_block_index(int index) {
+    if (is_parallel()) {
+      throw std::runtime_error("Cannot set a gpu block index on a parallel loop");
+    }
     if (is_gpu_thread_index()) {
       throw std::runtime_error("Cannot set both gpu block and thread index");
     }
@@ -501,6 +504,10 @@ class TORCH_API LoopOptions {
   }
 
   void set_gpu_thread_index(int index) {
+    if (is_parallel()) {
+      throw std::runtime_error(
+          "Cannot set a gpu thread index on a parallel loop");
+    }
     if (is_gpu_block_index()) {
       throw std::runtime_error("Cannot set both gpu thread and block index");
     }
@@ -510,23 +517,40 @@ class TORCH_API LoopOptions {
     gpu_thread_index_ = index;
   }
 
+  // Parallel loops run their iterations on the intra-op thread pool of the
+  // CPU; the iterations must be independent.
+  bool is_parallel() const {
+    return is_parallel_;
+  }
+
+  void set_parallel() {
+    if (is_gpu_block_index() || is_gpu_thread_index()) {
+      throw std::runtime_error(
+          "Cannot parallelize a loop with a gpu block or thread index");
+    }
+    is_parallel_ = true;
+  }
+
   std::string ToString() const {
     std::ostringstream oss;
     if (is_gpu_block_index()) {
       oss << gpu_block_index_str();
     } else if (is_gpu_thread_index()) {
       oss << gpu_thread_index_str();
+    } else if (is_parallel()) {
+      oss << "parallel";
     }
     return oss.str();
   }
 
   bool isDefault() const {
-    return gpu_block_index_ == -1 && gpu_thread_index_ == -1;
+    return gpu_block_index_ == -1 && gpu_thread_index_ == -1 && !is_parallel_;
   }
 
  private:
   int gpu_block_index_ = -1;
   int gpu_thread_index_ = -1;
+  bool is_parallel_ = false;
 };
 
 class TORCH_API For : public StmtNode<For> {
@@ -620,6 +644,10 @@ class TORCH_API For : public StmtNode<For> {
     loop_options_.set_gpu_thread_index(thread_index);
   }
 
+  void set_parallel() {
+    loop_options_.set_parallel();
+  }
+
   For* cloneWithNewBody(Stmt* body) const {
     return new For(var_, start_, stop_, body, loop_options_);
   }
@@ -28,6 +28,11 @@ class TORCH_API FutureError final : public std::exception {
 template <typename T>
 class TORCH_API Future final {
  public:
+  // Runs a callback on some thread, e.g. by enqueueing it on a thread pool.
+  // Callbacks added with an executor run there instead of inline on the
+  // thread that completes the future.
+  using Executor = std::function<void(std::function<void(void)>)>;
+
   Future() = default;
 
   Future(T value) : completed_(true), value_(std::move(value)) {}
@@ -135,6 +140,53 @@ class TORCH_API Future final {
     addCallback([this, cb = std::move(cb)]() { cb(*this); });
   }
 
+  // The callback is handed to `executor` once the future completes, or right
+  // away if it already has. An empty executor runs it inline.
+  void addCallback(std::function<void(void)> cb, Executor executor) {
+    if (!executor) {
+      addCallback(std::move(cb));
+      return;
+    }
+    addCallback([executor = std::move(executor), cb = std::move(cb)]() {
+      executor(cb);
+    });
+  }
+
+  void addCallback(
+      std::function<void(const Future<T>& future)> cb,
+      Executor executor) {
+    addCallback(
+        std::function<void(void)>(
+            [this, cb = std::move(cb)]() { cb(*this); }),
+        std::move(executor));
+  }
+
+  // Returns a future completed with the result of fn(*this) once this future
+  // completes, with fn run by `executor` if one is given. An error of this
+  // future, or an exception thrown by fn, is set on the returned future
+  // instead. As with addCallback, this future must outlive the callback, which
+  // holds on to it by reference.
+  template <typename U>
+  std::shared_ptr<Future<U>> then(
+      std::function<U(const Future<T>& future)> fn,
+      Executor executor = nullptr) {
+    auto child = std::make_shared<Future<U>>();
+    addCallback(
+        std::function<void(void)>([this, child, fn = std::move(fn)]() {
+          if (hasError()) {
+            child->setError(*error());
+            return;
+          }
+          try {
+            child->markCompleted(fn(*this));
+          } catch (const std::exception& e) {
+            child->setError(e.what());
+          }
+        }),
+        std::move(executor));
+    return child;
+  }
+
  private:
   void setErrorInternal(
       FutureError error,
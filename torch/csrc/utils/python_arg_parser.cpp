@@ -721,6 +721,7 @@ bool FunctionSignature::parse(PyObject* args, PyObject* kwargs, PyObject* dst[],
 PythonArgParser::PythonArgParser(std::vector<std::string> fmts, bool traceable)
  : max_args(0)
  , traceable(traceable)
+ , signature_cache_enabled_(true)
 {
   int index = 0;
   for (auto& fmt : fmts) {
@@ -731,6 +732,10 @@ PythonArgParser::PythonArgParser(std::vector<std::string> fmts, bool traceable)
     if (signature.max_args > max_args) {
       max_args = signature.max_args;
     }
+    if (signature.max_pos_args == 1 &&
+        signature.params[0].type_ == ParameterType::INT_LIST) {
+      signature_cache_enabled_ = false;
+    }
   }
   if (signatures_.size() > 0) {
     function_name = signatures_[0].name;
@@ -761,6 +766,66 @@ void PythonArgParser::check_deprecated(const FunctionSignature & signature) {
   }
 }
 
+namespace {
+
+// The kinds of positional arguments for which FunctionParameter::check only
+// depends on the kind.
+enum class CachedArgKind : uint32_t {
+  Tensor = 1,
+  // 0-dim tensors without requires_grad also pass as numbers.
+  IntScalarTensor,
+  ScalarTensor,
+  Int,
+  Float,
+  Complex,
+  Bool,
+  None,
+};
+
+constexpr ssize_t kMaxCachedArgs = 6;
+
+// Returns the signature cache key of a call, or 0 if it can't be cached.
+uint32_t signature_cache_key(PyObject* args, PyObject* kwargs) {
+  if (kwargs && PyDict_Size(kwargs) > 0) {
+    return 0;
+  }
+  const auto nargs = PyTuple_GET_SIZE(args);
+  if (nargs > kMaxCachedArgs) {
+    return 0;
+  }
+  uint32_t key = (1u << 31) | static_cast<uint32_t>(nargs);
+  for (ssize_t i = 0; i < nargs; ++i) {
+    PyObject* obj = PyTuple_GET_ITEM(args, i);
+    CachedArgKind kind;
+    if (THPVariable_CheckExact(obj)) {
+      const auto& var = reinterpret_cast<THPVariable*>(obj)->cdata;
+      if (var.dim() != 0 || var.requires_grad()) {
+        kind = CachedArgKind::Tensor;
+      } else if (at::isIntegralType(var.scalar_type(), /*includeBool=*/false)) {
+        kind = CachedArgKind::IntScalarTensor;
+      } else {
+        kind = CachedArgKind::ScalarTensor;
+      }
+    } else if (PyBool_Check(obj)) {
+      kind = CachedArgKind::Bool;
+    } else if (PyLong_CheckExact(obj)) {
+      kind = CachedArgKind::Int;
+    } else if (PyFloat_CheckExact(obj)) {
+      kind = CachedArgKind::Float;
+    } else if (PyComplex_CheckExact(obj)) {
+      kind = CachedArgKind::Complex;
+    } else if (obj == Py_None) {
+      kind = CachedArgKind::None;
+    } else {
+      return 0;
+    }
+    key |= static_cast<uint32_t>(kind) << (4 * (i + 1));
+  }
+  return key;
+}
+
+} // namespace
+
 PythonArgs PythonArgParser::raw_parse(PyObject* args, PyObject* kwargs, PyObject* parsed_args[]) {
   if (signatures_.size() == 1) {
     auto& signature = signatures_[0];
@@ -769,8 +834,28 @@ PythonArgs PythonArgParser::raw_parse(PyObject* args, PyObject* kwargs, PyObject
     return PythonArgs(traceable, signature, parsed_args);
   }
 
-  for (auto& signature : signatures_) {
+  const uint32_t key =
+      signature_cache_enabled_ ? signature_cache_key(args, kwargs) : 0;
+  SignatureCacheEntry* entry = nullptr;
+  if (key != 0) {
+    entry = &signature_cache_[(key ^ (key >> 12)) % kSignatureCacheSize];
+    if (entry->key == key) {
+      auto& signature = signatures_[entry->index];
+      if (signature.parse(args, kwargs, parsed_args, false)) {
+        check_deprecated(signature);
+        return PythonArgs(traceable, signature, parsed_args);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < signatures_.size(); ++i) {
+    auto& signature = signatures_[i];
     if (signature.parse(args, kwargs, parsed_args, false)) {
+      // The first signature is tried first anyway.
+      if (entry && i > 0) {
+        entry->key = key;
+        entry->index = i;
+      }
       check_deprecated(signature);
       return PythonArgs(traceable, signature, parsed_args);
     }
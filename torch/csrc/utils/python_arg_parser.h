@@ -108,10 +108,25 @@ private:
   void check_deprecated(const FunctionSignature & signature);
   PythonArgs raw_parse(PyObject* args, PyObject* kwargs, PyObject* parsed_args[]);
 
+  // A call whose positional arguments all have a type whose check() result
+  // doesn't depend on their value (exact tensors, ints, floats, ...) matches
+  // the same signature as every other call with the same argument kinds, so
+  // raw_parse remembers it instead of trying the earlier overloads again.
+  // The key also holds the number of arguments; 0 means no entry.
+  struct SignatureCacheEntry {
+    uint32_t key = 0;
+    size_t index = 0;
+  };
+  static constexpr size_t kSignatureCacheSize = 8;
+
   std::vector<FunctionSignature> signatures_;
   std::string function_name;
   ssize_t max_args;
   bool traceable;
+  // False if a signature takes var-args style IntArrayRefs, which accept
+  // some tensors depending on their number of elements.
+  bool signature_cache_enabled_;
+  std::array<SignatureCacheEntry, kSignatureCacheSize> signature_cache_;
 };
 
 struct PYBIND11_EXPORT FunctionSignature {
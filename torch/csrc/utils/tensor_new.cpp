@@ -188,12 +188,19 @@ ScalarType infer_scalar_type(PyObject *obj) {
     if (length < 0) throw python_error();
     // match NumPy semantics, except use default tensor type instead of double.
     if (length == 0) return torch::tensors::get_default_scalar_type();
-    for (int i = 0; i < length; ++i) {
-      THPObjectPtr handle(PySequence_GetItem(obj, i));
-      if (!handle) throw python_error();
-      auto cur_item = handle.get();
+    auto seq = THPObjectPtr(PySequence_Fast(obj, "not a sequence"));
+    if (!seq) throw python_error();
+    length = PySequence_Fast_GET_SIZE(seq.get());
+    PyObject** items = PySequence_Fast_ITEMS(seq.get());
+    for (Py_ssize_t i = 0; i < length; ++i) {
+      auto cur_item = items[i];
       if (cur_item == obj) throw TypeError("new(): self-referential lists are incompatible");
-      ScalarType item_scalarType = infer_scalar_type(cur_item);
+      // Plain floats and ints are by far the most common leaves; classify
+      // them without going through the generic checks above.
+      ScalarType item_scalarType = PyFloat_CheckExact(cur_item)
+          ? torch::tensors::get_default_scalar_type()
+          : PyLong_CheckExact(cur_item) ? ScalarType::Long
+                                        : infer_scalar_type(cur_item);
       scalarType = (scalarType) ?
           at::promoteTypes(*scalarType, item_scalarType) : item_scalarType;
       if (scalarType == ScalarType::ComplexDouble) {
@@ -224,12 +231,112 @@ void recursive_store(char* data, IntArrayRef sizes, IntArrayRef strides, int64_t
   }
 
   PyObject** items = PySequence_Fast_ITEMS(seq.get());
+  if (dim + 1 == ndim) {
+    // Innermost dimension: store the scalars directly instead of recursing
+    // once per element, and read plain floats without the generic unpacking.
+    auto stride = strides[dim] * elementSize;
+    if (scalarType == ScalarType::Float || scalarType == ScalarType::Double) {
+      for (int64_t i = 0; i < n; i++) {
+        PyObject* item = items[i];
+        if (PyFloat_CheckExact(item)) {
+          double value = PyFloat_AS_DOUBLE(item);
+          if (scalarType == ScalarType::Float) {
+            *(float*)data = (float)value;
+          } else {
+            *(double*)data = value;
+          }
+        } else {
+          torch::utils::store_scalar(data, scalarType, item);
+        }
+        data += stride;
+      }
+    } else {
+      for (int64_t i = 0; i < n; i++) {
+        torch::utils::store_scalar(data, scalarType, items[i]);
+        data += stride;
+      }
+    }
+    return;
+  }
   for (int64_t i = 0; i < n; i++) {
     recursive_store(data, sizes, strides, dim + 1, scalarType, elementSize, items[i]);
     data += strides[dim] * elementSize;
   }
 }
 
+// Maps a struct-module format character of a buffer to the ATen type with the
+// same layout, if there is one.
+c10::optional<ScalarType> buffer_format_to_scalar_type(const Py_buffer& view) {
+  const char* format = view.format ? view.format : "B";
+  if (*format == '@') ++format;
+  if (format[0] == '\0' || format[1] != '\0') return c10::nullopt;
+  ScalarType type;
+  switch (format[0]) {
+    case 'b': type = ScalarType::Char; break;
+    case 'B': type = ScalarType::Byte; break;
+    case 'h': type = ScalarType::Short; break;
+    case 'i': type = ScalarType::Int; break;
+    case 'l': type = view.itemsize == 8 ? ScalarType::Long : ScalarType::Int; break;
+    case 'q': type = ScalarType::Long; break;
+    case 'f': type = ScalarType::Float; break;
+    case 'd': type = ScalarType::Double; break;
+    case '?': type = ScalarType::Bool; break;
+    default: return c10::nullopt;
+  }
+  if (static_cast<Py_ssize_t>(c10::elementSize(type)) != view.itemsize) {
+    return c10::nullopt;
+  }
+  return type;
+}
+
+// One-dimensional sequences that also expose their elements through the
+// buffer protocol (array.array, bytearray, memoryview) are converted with a
+// single copy_ rather than one store_scalar per element. Type inference
+// follows the sequence path: the elements are python floats, ints or bools,
+// so we infer the default scalar type, long or bool respectively.
+bool maybe_store_from_buffer(
+    PyObject* data,
+    at::ScalarType scalar_type,
+    bool type_inference,
+    bool pin_memory,
+    Tensor& tensor,
+    ScalarType& inferred_scalar_type) {
+  if (!PySequence_Check(data) || !PyObject_CheckBuffer(data)) {
+    return false;
+  }
+  Py_buffer view;
+  if (PyObject_GetBuffer(data, &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) != 0) {
+    PyErr_Clear();
+    return false;
+  }
+  struct BufferRelease {
+    ~BufferRelease() { PyBuffer_Release(view); }
+    Py_buffer* view;
+  } release{&view};
+
+  auto buffer_type = buffer_format_to_scalar_type(view);
+  if (view.ndim != 1 || !buffer_type || view.len == 0) {
+    return false;
+  }
+  bool is_floating = at::isFloatingType(*buffer_type);
+  if (type_inference) {
+    inferred_scalar_type = is_floating ? torch::tensors::get_default_scalar_type()
+        : *buffer_type == ScalarType::Bool ? ScalarType::Bool : ScalarType::Long;
+  } else {
+    // store_scalar unpacks floats destined for integral types as python
+    // ints; keep that path so conversion errors are reported the same way.
+    if (is_floating && !at::isFloatingType(scalar_type) &&
+        !at::isComplexType(scalar_type)) {
+      return false;
+    }
+    inferred_scalar_type = scalar_type;
+  }
+  int64_t numel = view.len / view.itemsize;
+  tensor = at::empty({numel}, at::initialTensorOptions().dtype(inferred_scalar_type).pinned_memory(pin_memory));
+  tensor.copy_(at::from_blob(view.buf, {numel}, at::initialTensorOptions().dtype(*buffer_type)));
+  return true;
+}
+
 Tensor internal_new_from_data(
     c10::DispatchKey dispatch_key,
     at::ScalarType scalar_type,
@@ -281,18 +388,22 @@ Tensor internal_new_from_data(
   }
 #endif
 
-  auto sizes = compute_sizes(data);
-  ScalarType inferred_scalar_type = type_inference ? infer_scalar_type(data) : scalar_type;
   // This exists to prevent us from tracing the call to empty().  The actual
   // autograd code doesn't really matter, because requires_grad is always false
   // here.
   Tensor tensor;
+  ScalarType inferred_scalar_type;
   {
     at::AutoNonVariableTypeMode guard;
-    tensor = at::empty(sizes, at::initialTensorOptions().dtype(inferred_scalar_type).pinned_memory(pin_memory));
-    recursive_store(
-        (char*)tensor.data_ptr(), tensor.sizes(), tensor.strides(), 0,
-        inferred_scalar_type, tensor.dtype().itemsize(), data);
+    if (!maybe_store_from_buffer(
+            data, scalar_type, type_inference, pin_memory, tensor, inferred_scalar_type)) {
+      auto sizes = compute_sizes(data);
+      inferred_scalar_type = type_inference ? infer_scalar_type(data) : scalar_type;
+      tensor = at::empty(sizes, at::initialTensorOptions().dtype(inferred_scalar_type).pinned_memory(pin_memory));
+      recursive_store(
+          (char*)tensor.data_ptr(), tensor.sizes(), tensor.strides(), 0,
+          inferred_scalar_type, tensor.dtype().itemsize(), data);
+    }
   }
   auto device = device_opt.has_value() ? *device_opt : at::Device(computeDeviceType(dispatch_key));
   pybind11::gil_scoped_release no_gil;
@@ -425,6 +425,7 @@ if not hasattr(torch._C, 'CudaDoubleStorageBase'):
 
     torch._C.__dict__['_CudaStreamBase'] = _dummy_type('CudaStreamBase')
     torch._C.__dict__['_CudaEventBase'] = _dummy_type('CudaEventBase')
+    torch._C.__dict__['_CUDAGraph'] = _dummy_type('CUDAGraph')
 
 
 @staticmethod
@@ -509,4 +510,5 @@ from . import sparse
 from . import profiler
 from . import nvtx
 from .streams import Stream, Event
+from .graphs import CUDAGraph
 from . import amp
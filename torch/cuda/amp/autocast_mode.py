@@ -122,9 +122,11 @@ class autocast(object):
         torch.autocast_increment_nesting()
 
     def __exit__(self, *args):
-        # Drop the cache when we exit to a nesting level that's outside any instance of autocast.
+        # Casts of weights stay cached while the weights are unchanged, so that later regions (e.g. the next
+        # forward pass of gradient accumulation) reuse them.  Drop the ones that can't hit anymore when we exit to
+        # a nesting level that's outside any instance of autocast.
         if torch.autocast_decrement_nesting() == 0:
-            torch.clear_autocast_cache()
+            torch.prune_autocast_cache()
         torch.set_autocast_enabled(self.prev)
         return False
 
@@ -180,15 +180,20 @@ class GradScaler(object):
         per_device_inv_scale = _MultiDeviceReplicator(inv_scale)
         per_device_found_inf = _MultiDeviceReplicator(found_inf)
 
+        # The gradients of each device are unscaled with a single multi-tensor kernel per dtype.
+        per_device_grads = defaultdict(list)
         for group in optimizer.param_groups:
             for param in group["params"]:
                 if param.grad is not None:
                     if (not allow_fp16) and param.grad.dtype == torch.float16:
                         raise ValueError("Attempting to unscale FP16 gradients.")
                     else:
-                        torch._amp_non_finite_check_and_unscale_(param.grad,
-                                                                 per_device_found_inf.get(param.grad.device),
-                                                                 per_device_inv_scale.get(param.grad.device))
+                        per_device_grads[param.grad.device].append(param.grad)
+
+        for device, grads in per_device_grads.items():
+            torch._amp_foreach_non_finite_check_and_unscale_(grads,
+                                                             per_device_found_inf.get(device),
+                                                             per_device_inv_scale.get(device))
 
         return per_device_found_inf._per_device_tensors
 
@@ -281,6 +286,9 @@ class GradScaler(object):
             # The contract with custom optimizers is that their step() should accept an additional,
             # optional grad_scaler kwarg.  We append self to the kwargs so the custom optimizer has full information:
             # it can query its own state, invoke unscale_ on itself, etc
+            # An optimizer built on the fused kernels (e.g. torch._fused_adam_) can pass the tensors of
+            # _found_inf_per_device(optimizer) as their found_inf, which skips the step on the device
+            # instead of reading found_inf on the host.
             retval = optimizer.step(*args, **dict(kwargs, grad_scaler=self))
             optimizer_state["stage"] = OptState.STEPPED
             return retval
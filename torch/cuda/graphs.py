@@ -0,0 +1,55 @@
+import torch
+
+
+class CUDAGraph(torch._C._CUDAGraph):
+    r"""Wrapper around a CUDA graph.
+
+    Work issued on the current stream between :meth:`capture_begin` and
+    :meth:`capture_end` is recorded into the graph instead of being run, and
+    :meth:`replay` launches all of it at once, which removes the CPU overhead
+    of launching each kernel. This suits static-shape workloads, such as
+    inference or a training step on fixed-size batches.
+
+    A replay reads and writes the same memory as the capture: copy new inputs
+    into the tensors used as inputs during capture, and read the outputs from
+    the tensors created during capture. Memory allocated during capture comes
+    from a private pool of the caching allocator that stays reserved until
+    the graph is reset or destroyed. Dropout draws fresh random numbers on
+    each replay; other random number generator operations raise an error
+    during capture.
+
+    Example::
+
+        >>> static_input = torch.randn(8, 64, device="cuda")
+        >>> s = torch.cuda.Stream()
+        >>> with torch.cuda.stream(s):
+        ...     g = torch.cuda.CUDAGraph()
+        ...     g.capture_begin()
+        ...     static_output = model(static_input)
+        ...     g.capture_end()
+        >>> torch.cuda.current_stream().wait_stream(s)
+        >>> static_input.copy_(new_input)
+        >>> g.replay()  # static_output now holds model(new_input)
+
+    .. warning::
+        Capture must happen on a non-default stream and must not synchronize
+        with the CPU (e.g. by calling ``.item()``). Requires CUDA 11.
+    """
+
+    def capture_begin(self):
+        r"""Begins capturing the work issued on the current stream."""
+        super(CUDAGraph, self).capture_begin()
+
+    def capture_end(self):
+        r"""Ends capture and instantiates the graph. Must be called on the
+        stream capture began on."""
+        super(CUDAGraph, self).capture_end()
+
+    def replay(self):
+        r"""Launches the captured work on the current stream."""
+        super(CUDAGraph, self).replay()
+
+    def reset(self):
+        r"""Deletes the graph and releases its memory pool to the caching
+        allocator. The instance may capture a new graph afterwards."""
+        super(CUDAGraph, self).reset()
@@ -3,7 +3,7 @@ import contextlib
 import warnings
 
 import torch
-from . import is_initialized, _get_device_index
+from . import is_initialized, _get_device_index, _lazy_init
 
 
 def _host_allocator():
@@ -367,6 +367,219 @@ def memory_snapshot():
     return torch._C._cuda_memorySnapshot()
 
 
+def record_memory_history(enabled=True, max_entries=10000):
+    r"""Enables or disables recording of CUDA memory allocation history.
+
+    While enabled, every allocation records the C++ stack trace that made it,
+    its stream and a timestamp. :func:`~torch.cuda.memory_snapshot` reports
+    them under the ``"history"`` key of allocated blocks. In addition, the
+    most recent :attr:`max_entries` allocator events (allocations, frees, and
+    memory obtained from or returned to the driver) of each device are kept
+    and can be read with :func:`~torch.cuda.memory_history`.
+
+    Recording stack traces makes allocations considerably slower, so this is
+    meant for diagnosing memory usage, not for production runs.
+
+    Arguments:
+        enabled (bool, optional): whether to record history (default: True).
+            Disabling keeps the events recorded so far available.
+        max_entries (int, optional): number of events kept per device
+            (default: 10000).
+    """
+    _lazy_init()
+    torch._C._cuda_recordMemoryHistory(enabled, max_entries)
+
+
+def memory_history(device=None):
+    r"""Returns the allocator events recorded by
+    :func:`~torch.cuda.record_memory_history` for a given device, oldest first.
+
+    Each event is a dictionary with the keys ``"action"`` (one of ``"alloc"``,
+    ``"free"``, ``"segment_alloc"``, ``"segment_free"``), ``"addr"``,
+    ``"size"``, ``"stream"``, ``"time_us"`` and ``"context"`` (the stack trace
+    of the allocation, if known).
+
+    Arguments:
+        device (torch.device or int, optional): selected device. Returns
+            events for the current device, given by :func:`~torch.cuda.current_device`,
+            if :attr:`device` is ``None`` (default).
+    """
+    if not is_initialized():
+        return []
+    device = _get_device_index(device, optional=True)
+    return torch._C._cuda_memoryHistory(device)
+
+
+def dump_memory_snapshot(path):
+    r"""Saves :func:`~torch.cuda.memory_snapshot` together with the recorded
+    :func:`~torch.cuda.memory_history` of every device to :attr:`path`.
+
+    The file is a pickled dictionary with the keys ``"segments"`` and
+    ``"device_traces"`` (a list with the events of each device), which can be
+    loaded and inspected without a GPU.
+
+    Arguments:
+        path (str): file to write.
+    """
+    import pickle
+    snapshot = {
+        "segments": memory_snapshot(),
+        "device_traces": [memory_history(device) for device in range(torch.cuda.device_count())]
+        if is_initialized() else [],
+    }
+    with open(path, "wb") as f:
+        pickle.dump(snapshot, f)
+
+
+def create_memory_pool(name, limit=None, device=None):
+    r"""Creates a named memory pool on a given device.
+
+    A memory pool caches its own blocks, separately from the default pools of
+    the caching allocator, and reserves at most :attr:`limit` bytes from the
+    device. Allocations that would exceed the limit raise an out-of-memory
+    error instead of taking memory from other pools. Use
+    :func:`~torch.cuda.memory_pool` to allocate from the pool.
+
+    Arguments:
+        name (str): name of the pool; must be unique on the device.
+        limit (int, optional): maximum number of bytes the pool may reserve.
+            The pool is unbounded if :attr:`limit` is ``None`` (default).
+        device (torch.device or int, optional): selected device. Creates the
+            pool on the current device, given by :func:`~torch.cuda.current_device`,
+            if :attr:`device` is ``None`` (default).
+
+    .. note::
+        See :ref:`cuda-memory-management` for more details about GPU memory
+        management.
+    """
+    _lazy_init()
+    device = _get_device_index(device, optional=True)
+    if limit is None:
+        limit = 2 ** 64 - 1
+    torch._C._cuda_createMemoryPool(device, name, limit)
+
+
+@contextlib.contextmanager
+def memory_pool(name):
+    r"""Context manager that serves CUDA allocations made on the current
+    thread from the named memory pool.
+
+    The pool must have been created with :func:`~torch.cuda.create_memory_pool`
+    on every device allocated from within the context. Memory is returned to
+    the pool it was allocated from, regardless of the pool selected when it is
+    freed.
+
+    Example::
+
+        >>> torch.cuda.create_memory_pool("weights", limit=4 * 1024 ** 3)
+        >>> with torch.cuda.memory_pool("weights"):
+        ...     model.cuda()
+
+    Arguments:
+        name (str): name of the pool, or ``""`` for the default pools.
+    """
+    prev = torch._C._cuda_getMemoryPool()
+    torch._C._cuda_setMemoryPool(name)
+    try:
+        yield
+    finally:
+        torch._C._cuda_setMemoryPool(prev)
+
+
+def memory_pool_reserved(name, device=None):
+    r"""Returns the current GPU memory reserved by the named memory pool in
+    bytes for a given device.
+
+    Arguments:
+        name (str): name of the pool.
+        device (torch.device or int, optional): selected device. Returns
+            statistic for the current device, given by :func:`~torch.cuda.current_device`,
+            if :attr:`device` is ``None`` (default).
+    """
+    device = _get_device_index(device, optional=True)
+    return torch._C._cuda_memoryPoolReserved(device, name)
+
+
+def pinned_memory_stats():
+    r"""Returns a dictionary of statistics of the caching allocator for pinned
+    (page-locked) host memory, used by :meth:`~torch.Tensor.pin_memory` and
+    ``pin_memory=True`` data loaders.
+
+    The statistics are ``"{allocation,segment,allocated_bytes,reserved_bytes}.
+    {current,peak,allocated,freed}"``, as in :func:`~torch.cuda.memory_stats`,
+    where a segment is one block pinned with ``cudaHostAlloc()``, and
+    ``"num_evictions"``: the number of cached blocks released to stay under
+    the limit set by :func:`~torch.cuda.set_pinned_memory_cache_limit`.
+    """
+    result = []
+
+    def _recurse_add_to_result(prefix, obj):
+        if isinstance(obj, dict):
+            if len(prefix) > 0:
+                prefix += "."
+            for k, v in obj.items():
+                _recurse_add_to_result(prefix + k, v)
+        else:
+            result.append((prefix, obj))
+
+    _lazy_init()
+    _recurse_add_to_result("", torch._C._cuda_hostMemoryStats())
+    result.sort()
+    return collections.OrderedDict(result)
+
+
+def reset_accumulated_pinned_memory_stats():
+    r"""Resets the "allocated" and "freed" pinned memory statistics, see
+    :func:`~torch.cuda.pinned_memory_stats`."""
+    torch._C._cuda_resetAccumulatedHostMemoryStats()
+
+
+def reset_peak_pinned_memory_stats():
+    r"""Resets the "peak" pinned memory statistics, see
+    :func:`~torch.cuda.pinned_memory_stats`."""
+    torch._C._cuda_resetPeakHostMemoryStats()
+
+
+def set_pinned_memory_cache_limit(limit):
+    r"""Caps the pinned host memory kept cached by the caching allocator after
+    it is freed.
+
+    Freed pinned blocks are cached to avoid the cost of ``cudaHostAlloc()`` and
+    ``cudaFreeHost()``. Beyond :attr:`limit` bytes of cached blocks, the least
+    recently freed ones are released. Memory in use is not limited.
+
+    Arguments:
+        limit (int, optional): maximum number of bytes to keep cached, or
+            ``None`` for an unbounded cache (default behavior).
+    """
+    _lazy_init()
+    if limit is None:
+        limit = 2 ** 64 - 1
+    torch._C._cuda_setHostCacheLimit(limit)
+
+
+def reserve_pinned_memory(size, count=1):
+    r"""Pins :attr:`count` host memory blocks of :attr:`size` bytes and caches
+    them for later pinned allocations of up to :attr:`size` bytes.
+
+    Calling this at startup, e.g. with the size of a pinned batch and the
+    number of batches prefetched by a data loader, avoids ``cudaHostAlloc()``
+    stalls during the first iterations.
+
+    Arguments:
+        size (int): size of each block in bytes.
+        count (int, optional): number of blocks (default: 1).
+    """
+    _lazy_init()
+    torch._C._cuda_reserveHostMemory(size, count)
+
+
+def empty_pinned_cache():
+    r"""Releases all unoccupied cached pinned host memory."""
+    if is_initialized():
+        torch._C._cuda_emptyHostCache()
+
+
 def memory_summary(device=None, abbreviated=False):
     r"""Returns a human-readable printout of the current memory allocator
     statistics for a given device.
@@ -0,0 +1,293 @@
+"""
+Sharded checkpoints.
+
+A sharded checkpoint is a directory with one file per rank, so that every rank
+writes only its own part of the state, in parallel with the others::
+
+    path/
+        shard_0.pt, shard_1.pt, ...        # zip archives of raw tensor data
+        manifest_0.json, manifest_1.json, ...
+
+The shard files are written with the same writer as :func:`torch.save`, one
+record per tensor. The manifest of each rank maps the names it saved to their
+dtype, global size, and the shards that hold them: the file and record of each
+shard and the region of the tensor it covers. Loading reads the manifests and
+then only the records that overlap the tensors asked for, so a checkpoint can
+be loaded on a different number of ranks, with a different sharding, or
+partially.
+"""
+import json
+import os
+import pickle
+
+import torch
+
+
+class Shard(object):
+    r"""
+    The part of a tensor of size ``size`` held by this rank: ``tensor`` is the
+    region that starts at index ``offsets`` in every dimension.
+
+    In a state dict given to :func:`save_sharded`, a ``Shard`` is saved by the
+    rank that has it. In one given to :func:`load_sharded`, ``tensor`` is
+    filled with that region of the saved tensor.
+    """
+    def __init__(self, tensor, offsets, size):
+        if len(offsets) != tensor.dim() or len(size) != tensor.dim():
+            raise ValueError("Shard offsets and size must have one entry per "
+                             "dimension of the tensor")
+        for offset, length, total in zip(offsets, tensor.size(), size):
+            if offset < 0 or offset + length > total:
+                raise ValueError("Shard of size {} at offsets {} is out of "
+                                 "bounds of size {}".format(
+                                     list(tensor.size()), list(offsets), list(size)))
+        self.tensor = tensor
+        self.offsets = list(offsets)
+        self.size = list(size)
+
+
+def _default_rank_and_world_size(rank, world_size):
+    if rank is None or world_size is None:
+        import torch.distributed as dist
+        initialized = dist.is_available() and dist.is_initialized()
+        if rank is None:
+            rank = dist.get_rank() if initialized else 0
+        if world_size is None:
+            world_size = dist.get_world_size() if initialized else 1
+    return rank, world_size
+
+
+def _manifest_name(rank):
+    return 'manifest_{}.json'.format(rank)
+
+
+def save_sharded(state_dict, path, rank=None, world_size=None, num_write_threads=1):
+    r"""
+    Saves this rank's part of ``state_dict`` to the sharded checkpoint
+    directory ``path``.
+
+    Every rank calls this with its own state dict. :class:`Shard` values are
+    saved by every rank that has them, while tensors and other values are
+    saved by rank 0 only. No collectives are issued, so to load the checkpoint,
+    wait for all ranks to have saved, e.g. with
+    :func:`torch.distributed.barrier`.
+
+    Args:
+        state_dict (dict): names to :class:`Shard`, tensors or other
+            picklable values.
+        path (str): the checkpoint directory, created if needed.
+        rank (int, optional): the rank saving, by default the rank in the
+            default process group if it is initialized, otherwise 0.
+        world_size (int, optional): the number of ranks saving, by default
+            the size of the default process group if it is initialized,
+            otherwise 1.
+        num_write_threads (int): the number of threads that write the data of
+            large tensors.
+    """
+    rank, world_size = _default_rank_and_world_size(rank, world_size)
+    if not 0 <= rank < world_size:
+        raise ValueError("Invalid rank {} for world size {}".format(rank, world_size))
+    if not os.path.isdir(path):
+        os.makedirs(path)
+
+    file_name = 'shard_{}.pt'.format(rank)
+    entries = {}
+    objects = {}
+    writer = torch._C.PyTorchFileWriter(os.path.join(path, file_name), num_write_threads)
+    for name in sorted(state_dict.keys()):
+        value = state_dict[name]
+        if isinstance(value, Shard):
+            tensor, offsets, size = value.tensor, value.offsets, value.size
+        elif rank != 0:
+            continue
+        elif isinstance(value, torch.Tensor):
+            tensor, offsets, size = value, [0] * value.dim(), list(value.size())
+        else:
+            objects[name] = value
+            continue
+
+        tensor = tensor.detach().cpu().contiguous()
+        record = 'data/{}'.format(len(entries))
+        writer.write_record(record, tensor.data_ptr(), tensor.numel() * tensor.element_size())
+        entries[name] = {
+            'dtype': str(tensor.dtype),
+            'size': size,
+            'shards': [{
+                'file': file_name,
+                'record': record,
+                'offsets': offsets,
+                'size': list(tensor.size()),
+            }],
+        }
+    if objects:
+        data = pickle.dumps(objects, protocol=2)
+        writer.write_record('objects.pkl', data, len(data))
+    writer.write_end_of_file()
+
+    # The manifest is written last, so that it only refers to complete files.
+    manifest = {
+        'world_size': world_size,
+        'tensors': entries,
+        'objects': sorted(objects.keys()),
+        'file': file_name,
+    }
+    manifest_path = os.path.join(path, _manifest_name(rank))
+    with open(manifest_path + '.tmp', 'w') as f:
+        json.dump(manifest, f)
+    os.rename(manifest_path + '.tmp', manifest_path)
+
+
+def load_manifest(path):
+    r"""
+    Returns the merged manifest of the sharded checkpoint in ``path``: a dict
+    that maps the name of every saved tensor to a dict with its ``dtype``,
+    global ``size``, and ``shards``, a list of the ``file`` and ``record`` of
+    each shard with its ``offsets`` and ``size``.
+    """
+    tensors, _ = _read_manifests(path)
+    return tensors
+
+
+def _read_manifests(path):
+    # Returns the merged tensor entries, and the names of the other objects
+    # with the file that holds them.
+    with open(os.path.join(path, _manifest_name(0))) as f:
+        world_size = json.load(f)['world_size']
+    tensors = {}
+    objects = {}
+    for rank in range(world_size):
+        manifest_path = os.path.join(path, _manifest_name(rank))
+        if not os.path.exists(manifest_path):
+            raise RuntimeError("Sharded checkpoint {} is missing the manifest of rank {}"
+                               .format(path, rank))
+        with open(manifest_path) as f:
+            manifest = json.load(f)
+        if manifest['world_size'] != world_size:
+            raise RuntimeError("Manifest {} was saved with world size {}, expected {}"
+                               .format(manifest_path, manifest['world_size'], world_size))
+        for name, entry in manifest['tensors'].items():
+            if name not in tensors:
+                tensors[name] = entry
+                continue
+            merged = tensors[name]
+            if merged['dtype'] != entry['dtype'] or merged['size'] != entry['size']:
+                raise RuntimeError("Shards of {} disagree on its dtype or size".format(name))
+            merged['shards'].extend(entry['shards'])
+        for name in manifest['objects']:
+            objects[name] = manifest['file']
+    return tensors, objects
+
+
+class _ShardReader(object):
+    # Opens shard files, and reads records from them, on first use.
+    def __init__(self, path):
+        self.path = path
+        self.readers = {}
+
+    def read(self, file_name, record, dtype, size):
+        if file_name not in self.readers:
+            self.readers[file_name] = torch._C.PyTorchFileReader(os.path.join(self.path, file_name))
+        tensor = torch.empty(size, dtype=dtype)
+        if tensor.numel() == 0:
+            return tensor
+        data = self.readers[file_name].get_record(record)
+        storage = type(tensor.storage()).from_buffer(data, 'native')
+        return tensor.set_(storage).view(size)
+
+    def read_objects(self, file_name):
+        if file_name not in self.readers:
+            self.readers[file_name] = torch._C.PyTorchFileReader(os.path.join(self.path, file_name))
+        return pickle.loads(self.readers[file_name].get_record('objects.pkl'))
+
+
+def _dtype(name):
+    return getattr(torch, name.split('.')[-1])
+
+
+def _copy_region(reader, name, entry, dst, offsets):
+    # Copies the region of the tensor NAME that starts at OFFSETS into DST.
+    if len(offsets) != len(entry['size']):
+        raise RuntimeError("Can't load {} of size {} into a tensor with {} dimensions"
+                           .format(name, entry['size'], len(offsets)))
+    covered = 0
+    for shard in entry['shards']:
+        src_index = []
+        dst_index = []
+        for offset, length, shard_offset, shard_length in zip(
+                offsets, dst.size(), shard['offsets'], shard['size']):
+            begin = max(offset, shard_offset)
+            end = min(offset + length, shard_offset + shard_length)
+            if begin >= end:
+                break
+            src_index.append(slice(begin - shard_offset, end - shard_offset))
+            dst_index.append(slice(begin - offset, end - offset))
+        else:
+            src = reader.read(shard['file'], shard['record'], _dtype(entry['dtype']), shard['size'])
+            region = dst[tuple(dst_index)]
+            region.copy_(src[tuple(src_index)])
+            covered += region.numel()
+    if covered < dst.numel():
+        raise RuntimeError("The checkpoint doesn't hold all of the requested region of {}"
+                           .format(name))
+
+
+def load_sharded(path, state_dict):
+    r"""
+    Loads the values named in ``state_dict`` from the sharded checkpoint
+    ``path``, reading only the shards that overlap them.
+
+    Tensors are filled in place with the saved tensor of the same name, and
+    the tensor of a :class:`Shard` with its region of it, whatever the
+    sharding the checkpoint was saved with. Other values are replaced with the
+    saved ones. Names that aren't in ``state_dict`` aren't read.
+    """
+    tensors, objects = _read_manifests(path)
+    reader = _ShardReader(path)
+    loaded_objects = {}
+    for name, value in state_dict.items():
+        if isinstance(value, (Shard, torch.Tensor)):
+            if name not in tensors:
+                raise KeyError("Tensor {} is not in the checkpoint {}".format(name, path))
+            entry = tensors[name]
+            if isinstance(value, Shard):
+                dst, offsets = value.tensor, value.offsets
+                if value.size != entry['size']:
+                    raise RuntimeError("Shard of {} is of a tensor of size {}, but the "
+                                       "checkpoint has size {}"
+                                       .format(name, value.size, entry['size']))
+            else:
+                dst, offsets = value, [0] * value.dim()
+                if list(value.size()) != entry['size']:
+                    raise RuntimeError("Size mismatch for {}: {} vs {} in the checkpoint"
+                                       .format(name, list(value.size()), entry['size']))
+            with torch.no_grad():
+                _copy_region(reader, name, entry, dst, offsets)
+        else:
+            if name not in objects:
+                raise KeyError("{} is not in the checkpoint {}".format(name, path))
+            file_name = objects[name]
+            if file_name not in loaded_objects:
+                loaded_objects[file_name] = reader.read_objects(file_name)
+            state_dict[name] = loaded_objects[file_name][name]
+
+
+def load_tensors(path, names=None):
+    r"""
+    Returns a dict of the saved values named in ``names``, or of all of them,
+    with tensors assembled from their shards on the CPU.
+    """
+    tensors, objects = _read_manifests(path)
+    if names is None:
+        names = list(tensors.keys()) + list(objects.keys())
+    state_dict = {}
+    for name in names:
+        if name in tensors:
+            entry = tensors[name]
+            state_dict[name] = torch.empty(entry['size'], dtype=_dtype(entry['dtype']))
+        else:
+            state_dict[name] = None
+    for name, value in state_dict.items():
+        if value is None and name not in objects:
+            raise KeyError("{} is not in the checkpoint {}".format(name, path))
+    load_sharded(path, state_dict)
+    return state_dict
@@ -1,3 +1,4 @@
+import socket
 import torch
 import warnings
 from torch._six import string_classes
@@ -20,6 +21,7 @@ from . import (
 )
 from . import ReduceOp
 from . import PrefixStore
+from . import _hierarchical_process_groups
 
 
 _MPI_AVAILABLE = True
@@ -1792,3 +1794,92 @@ def new_group(ranks=None, timeout=default_pg_timeout, backend=None):
     }
 
     return pg
+
+
+def new_hierarchical_group(local_world_size=None,
+                           timeout=default_pg_timeout,
+                           backend=None):
+    """
+    Creates a group of all processes that runs collectives in two levels:
+    within every node, and across the nodes. An ``all_reduce`` reduce-scatters
+    the tensor within the node, all-reduces every shard across the nodes and
+    all-gathers the shards within the node, so that only a fraction of the
+    tensor crosses the (slower) links between the nodes. ``broadcast``,
+    ``all_gather`` and ``barrier`` are supported as well, on a single tensor
+    per process.
+
+    The ranks must be laid out node-major, i.e. the processes of a node must
+    have consecutive ranks, and every node must have the same number of
+    processes.
+
+    This function requires that all processes in the main group enter it, in
+    the same order relative to the other group creations.
+
+    Arguments:
+        local_world_size (int, optional): The number of processes per node.
+            By default, the processes are grouped by their host name.
+        timeout (timedelta, optional): Timeout for operations executed against
+            the process group. Default value equals 30 minutes.
+            This is only applicable for the ``gloo`` backend.
+        backend (str or Backend, optional): The backend of the intra-node and
+            inter-node groups. By default uses the same backend as the global
+            group.
+
+    Returns:
+        A handle of distributed group that can be given to collective calls.
+    """
+
+    _check_default_pg()
+
+    global _group_count
+
+    default_backend, default_store = _pg_map[_default_pg]
+    global_rank = _default_pg.rank()
+    global_world_size = _default_pg.size()
+
+    if not backend:
+        backend = default_backend
+    backend = Backend(backend)
+
+    if local_world_size is None:
+        # Exchange the host names through the store, under a key that is
+        # unique to this call on every process.
+        prefix = "hierarchical/{}/".format(_group_count)
+        _group_count += 1
+        default_store.set(prefix + str(global_rank), socket.gethostname())
+        hosts = [default_store.get(prefix + str(rank)).decode()
+                 for rank in range(global_world_size)]
+        local_world_size = hosts.count(hosts[0])
+        for rank in range(global_world_size):
+            if hosts[rank] != hosts[rank - rank % local_world_size]:
+                raise RuntimeError(
+                    "new_hierarchical_group requires the ranks of every node "
+                    "to be consecutive, and every node to run the same "
+                    "number of processes")
+
+    if local_world_size <= 0 or global_world_size % local_world_size != 0:
+        raise RuntimeError("The world size {} isn't a multiple of the local "
+                           "world size {}".format(global_world_size,
+                                                  local_world_size))
+    num_nodes = global_world_size // local_world_size
+
+    # Every process must create every subgroup, in the same order.
+    intra_node_group = None
+    for node in range(num_nodes):
+        ranks = range(node * local_world_size, (node + 1) * local_world_size)
+        pg = new_group(list(ranks), timeout=timeout, backend=backend)
+        if global_rank in ranks:
+            intra_node_group = pg
+    inter_node_group = None
+    for local_rank in range(local_world_size):
+        ranks = range(local_rank, global_world_size, local_world_size)
+        pg = new_group(list(ranks), timeout=timeout, backend=backend)
+        if global_rank in ranks:
+            inter_node_group = pg
+
+    pg = _hierarchical_process_groups(intra_node_group, inter_node_group)
+    _pg_map[pg] = (backend, default_store)
+    _pg_names[pg] = str(_group_count)
+    _group_count += 1
+    _pg_group_ranks[pg] = {rank: rank for rank in range(global_world_size)}
+    return pg
@@ -0,0 +1,186 @@
+import torch
+import torch.distributed as dist
+from torch.distributed.distributed_c10d import _get_global_rank
+
+
+class ZeroRedundancyOptimizer:
+    """
+    ZeroRedundancyOptimizer shards the state of a local optimizer across the
+    processes of a group, so that every process keeps the optimizer state of
+    roughly ``1 / world_size`` of the parameters, instead of the state of all
+    of them. For optimizers like :class:`~torch.optim.Adam`, whose state is
+    twice the size of the parameters, this removes most of the memory that
+    data parallel training spends on replicated optimizer state.
+
+    Every parameter is owned by one process. :meth:`step` reduce-scatters the
+    gradients, so that every process receives the average gradients of the
+    parameters it owns, lets the local optimizer update these parameters, and
+    allgathers the updated parameters. The parameters and gradients are
+    stored in two flat buffers, laid out so that the parameters of every
+    process form one contiguous chunk, which the collectives run on without
+    copying.
+
+    With the NCCL backend, the collectives are ordered with the computation
+    on the current CUDA stream, so :meth:`step` returns without waiting for
+    the allgather, and the next forward pass is queued behind it. Backends
+    without ``reduce_scatter`` reduce the chunk of every process to it one by
+    one instead.
+
+    The gradients mustn't be averaged already, so the model mustn't be
+    wrapped in :class:`~torch.nn.parallel.DistributedDataParallel`. All
+    parameters must have the same dtype and device.
+
+    Args:
+        params (iterable): an iterable of :class:`torch.Tensor` s or
+            :class:`dict` s, the parameters to optimize or the parameter
+            groups, like for any local optimizer.
+        optimizer_class (optim.Optimizer): the class of the local optimizer.
+        group (ProcessGroup, optional): the process group to shard across.
+            Defaults to the default process group.
+        **defaults: the arguments of the local optimizer.
+
+    Example::
+        >>> import torch.distributed as dist
+        >>> from torch.distributed.optim import ZeroRedundancyOptimizer
+        >>>
+        >>> dist.init_process_group("nccl", ...)
+        >>> model = nn.Linear(2000, 2000).cuda()
+        >>> optimizer = ZeroRedundancyOptimizer(
+        >>>     model.parameters(), optim.Adam, lr=0.01)
+        >>> model(input).sum().backward()
+        >>> optimizer.step()
+    """
+
+    def __init__(self, params, optimizer_class, group=None, **defaults):
+        self.group = group if group is not None else dist.group.WORLD
+        self.rank = dist.get_rank(self.group)
+        self.world_size = dist.get_world_size(self.group)
+        self._use_reduce_scatter = (
+            dist.get_backend(self.group) == dist.Backend.NCCL)
+
+        param_groups = list(params)
+        if len(param_groups) == 0:
+            raise ValueError("ZeroRedundancyOptimizer got an empty parameter list")
+        if not isinstance(param_groups[0], dict):
+            param_groups = [{"params": param_groups}]
+        self._params = [p for group in param_groups for p in group["params"]]
+        first = self._params[0]
+        for p in self._params:
+            if p.dtype != first.dtype or p.device != first.device:
+                raise ValueError("ZeroRedundancyOptimizer requires all "
+                                 "parameters to have the same dtype and device")
+
+        # Every parameter is assigned to the process that owns the fewest
+        # elements so far.
+        owners = []
+        owned_numel = [0] * self.world_size
+        for p in self._params:
+            owner = owned_numel.index(min(owned_numel))
+            owners.append(owner)
+            owned_numel[owner] += p.numel()
+        chunk_numel = max(max(owned_numel), 1)
+
+        self._params_buffer = torch.zeros(
+            self.world_size * chunk_numel, dtype=first.dtype, device=first.device)
+        self._grads_buffer = torch.zeros_like(self._params_buffer)
+        self._grads = []
+        offsets = [owner * chunk_numel for owner in range(self.world_size)]
+        with torch.no_grad():
+            for p, owner in zip(self._params, owners):
+                offset = offsets[owner]
+                offsets[owner] += p.numel()
+                param = self._params_buffer[offset:offset + p.numel()].view_as(p)
+                param.copy_(p)
+                p.data = param
+                grad = self._grads_buffer[offset:offset + p.numel()].view_as(p)
+                if p.grad is not None:
+                    grad.copy_(p.grad)
+                p.grad = grad
+                self._grads.append(grad)
+
+        # All processes start out with the parameters of the first one.
+        dist.broadcast(
+            self._params_buffer, self._global_rank(0), group=self.group)
+
+        owned = {id(p) for p, owner in zip(self._params, owners)
+                 if owner == self.rank}
+        local_param_groups = []
+        for group in param_groups:
+            local_group = dict(group)
+            local_group["params"] = [
+                p for p in group["params"] if id(p) in owned]
+            if len(local_group["params"]) > 0:
+                local_param_groups.append(local_group)
+        self.optim = None
+        if len(local_param_groups) > 0:
+            self.optim = optimizer_class(local_param_groups, **defaults)
+
+    def _global_rank(self, group_rank):
+        if self.group == dist.group.WORLD:
+            return group_rank
+        return _get_global_rank(self.group, group_rank)
+
+    @property
+    def param_groups(self):
+        r"""The parameter groups of the local optimizer, which only holds the
+        parameters that this process owns."""
+        return self.optim.param_groups if self.optim is not None else []
+
+    def zero_grad(self):
+        r"""Zeroes the gradients of all parameters."""
+        self._grads_buffer.zero_()
+        for p, grad in zip(self._params, self._grads):
+            p.grad = grad
+
+    def step(self):
+        r"""Averages the gradients of the parameters this process owns across
+        the group, updates these parameters, and gathers the updated
+        parameters of all processes.
+
+        Afterwards, only the gradients of the parameters this process owns
+        hold the average gradients.
+        """
+        with torch.no_grad():
+            # The gradients were replaced if they were set to None, e.g. by
+            # Module.zero_grad(), or assigned.
+            for p, grad in zip(self._params, self._grads):
+                if p.grad is None:
+                    grad.zero_()
+                elif p.grad.data_ptr() != grad.data_ptr():
+                    grad.copy_(p.grad)
+                p.grad = grad
+
+            grad_chunks = list(self._grads_buffer.chunk(self.world_size))
+            if self._use_reduce_scatter:
+                dist.reduce_scatter(
+                    grad_chunks[self.rank], grad_chunks, group=self.group)
+            else:
+                works = [
+                    dist.reduce(
+                        chunk,
+                        self._global_rank(rank),
+                        group=self.group,
+                        async_op=True)
+                    for rank, chunk in enumerate(grad_chunks)
+                ]
+                for work in works:
+                    work.wait()
+            grad_chunks[self.rank].div_(self.world_size)
+
+        if self.optim is not None:
+            self.optim.step()
+
+        with torch.no_grad():
+            param_chunks = list(self._params_buffer.chunk(self.world_size))
+            dist.all_gather(
+                param_chunks, param_chunks[self.rank], group=self.group)
+
+    def state_dict(self):
+        r"""Returns the state of the local optimizer, i.e. the shard of the
+        optimizer state that this process holds."""
+        return self.optim.state_dict() if self.optim is not None else {}
+
+    def load_state_dict(self, state_dict):
+        r"""Loads a shard returned by :meth:`state_dict` on this process."""
+        if self.optim is not None:
+            self.optim.load_state_dict(state_dict)
@@ -89,6 +89,8 @@ def _process_group_construct_rpc_backend_options_handler(
     rpc_timeout,
     init_method,
     num_send_recv_threads=rpc_constants.DEFAULT_NUM_SEND_RECV_THREADS,
+    num_control_threads=rpc_constants.DEFAULT_NUM_CONTROL_THREADS,
+    max_queued_recvs=rpc_constants.UNBOUNDED_QUEUED_RECVS,
     **kwargs
 ):
     from . import ProcessGroupRpcBackendOptions
@@ -96,7 +98,9 @@ def _process_group_construct_rpc_backend_options_handler(
     return ProcessGroupRpcBackendOptions(
         rpc_timeout=rpc_timeout,
         init_method=init_method,
-        num_send_recv_threads=num_send_recv_threads
+        num_send_recv_threads=num_send_recv_threads,
+        num_control_threads=num_control_threads,
+        max_queued_recvs=max_queued_recvs,
     )
 
 
@@ -141,6 +145,8 @@ def _process_group_init_backend_handler(
             group,
             rpc_backend_options.num_send_recv_threads,
             timedelta(seconds=rpc_backend_options.rpc_timeout),
+            rpc_backend_options.num_control_threads,
+            rpc_backend_options.max_queued_recvs,
         )
     except Exception as ex:
         dist.destroy_process_group()
@@ -4,7 +4,9 @@ from . import (
     _DEFAULT_RPC_TIMEOUT_SEC,
     _UNSET_RPC_TIMEOUT,
     _DEFAULT_INIT_METHOD,
-    _DEFAULT_NUM_SEND_RECV_THREADS
+    _DEFAULT_NUM_SEND_RECV_THREADS,
+    _DEFAULT_NUM_CONTROL_THREADS,
+    _UNBOUNDED_QUEUED_RECVS,
 )
 
 # For any RpcAgent.
@@ -13,6 +15,8 @@ DEFAULT_INIT_METHOD = _DEFAULT_INIT_METHOD
 
 # For ProcessGroupAgent.
 DEFAULT_NUM_SEND_RECV_THREADS = _DEFAULT_NUM_SEND_RECV_THREADS
+DEFAULT_NUM_CONTROL_THREADS = _DEFAULT_NUM_CONTROL_THREADS
+UNBOUNDED_QUEUED_RECVS = _UNBOUNDED_QUEUED_RECVS
 # Same default timeout as in c10d.
 DEFAULT_PROCESS_GROUP_TIMEOUT = default_pg_timeout
 # Value indicating that timeout is not set for RPC call, and the default should be used.
@@ -16,6 +16,7 @@ __all__ = [
     'cartesian_prod',
     'block_diag',
     'cdist',
+    'cdist_topk',
     'chain_matmul',
     'einsum',
     'istft',
@@ -898,6 +899,58 @@ def cdist(x1, x2, p=2., compute_mode='use_mm_for_euclid_dist_if_necessary'):
     else:
         raise ValueError("{} is not a valid value for compute_mode".format(compute_mode))
 
+
+def cdist_topk(x1, x2, k, p=2., compute_mode='use_mm_for_euclid_dist_if_necessary'):
+    # type: (Tensor, Tensor, int, float, str) -> Tuple[Tensor, Tensor]
+    r"""Returns the :attr:`k` nearest rows of :attr:`x2` to every row of :attr:`x1`
+    in the p-norm distance, together with their distances.
+
+    This gives the same result as ``torch.cdist(x1, x2, p).topk(k, largest=False)``,
+    but computes the distances in tiles and merges every tile into the running
+    nearest neighbors, so that the full :math:`P \times R` distance matrix is
+    never held in memory.
+
+    Args:
+        x1 (Tensor): input tensor of shape :math:`B \times P \times M`.
+        x2 (Tensor): input tensor of shape :math:`B \times R \times M`.
+        k (int): the number of nearest neighbors, at most :math:`R`.
+        p: p value for the p-norm distance to calculate between each vector pair
+            :math:`\in [0, \infty]`.
+        compute_mode: how the euclidean distances of every tile are computed, as in
+            :func:`torch.cdist`. Default: use_mm_for_euclid_dist_if_necessary.
+
+    Returns a tuple ``(values, indices)`` of tensors of shape :math:`B \times P \times k`,
+    where ``values`` holds the distances in ascending order and ``indices`` the rows
+    of :attr:`x2` they belong to.
+
+    .. note::
+        When gradients are required the distances of every tile are saved for
+        the backward pass, so the memory savings only hold under :func:`torch.no_grad`.
+
+    Example:
+
+        >>> a = torch.tensor([[0.9041,  0.0196], [-0.3108, -2.4423], [-0.4821,  1.059]])
+        >>> b = torch.tensor([[-2.1763, -0.4713], [-0.6986,  1.3702]])
+        >>> torch.cdist_topk(a, b, 1)
+        (tensor([[2.0959],
+                [2.7138],
+                [0.3791]]), tensor([[1],
+                [0],
+                [1]]))
+    """
+    if not torch.jit.is_scripting():
+        if (type(x1) is not Tensor or type(x2) is not Tensor) and has_torch_function((x1, x2)):
+            return handle_torch_function(
+                cdist_topk, (x1, x2), x1, x2, k, p=p, compute_mode=compute_mode)
+    if compute_mode == 'use_mm_for_euclid_dist_if_necessary':
+        return _VF.cdist_topk(x1, x2, k, p, None)
+    elif compute_mode == 'use_mm_for_euclid_dist':
+        return _VF.cdist_topk(x1, x2, k, p, 1)
+    elif compute_mode == 'donot_use_mm_for_euclid_dist':
+        return _VF.cdist_topk(x1, x2, k, p, 2)
+    else:
+        raise ValueError("{} is not a valid value for compute_mode".format(compute_mode))
+
 # TODO: type dim as BroadcastingList when https://github.com/pytorch/pytorch/issues/33782 is fixed
 @overload  # noqa: 749
 def norm(input, p="fro", dim=None, keepdim=False, out=None, dtype=None):  # noqa: 749
@@ -1114,6 +1114,11 @@ class AsyncSparseAllreduceWork : public ProcessGroupGloo::AsyncWork {
 
 #ifdef USE_CUDA
 
+// Chunks of CUDA tensors are reduced in turn, so that copying the next
+// chunks to host memory, and the previous ones back to the device, overlaps
+// with the reduction of the current one.
+constexpr int64_t kAllreduceCUDAChunkBytes = 4 * 1024 * 1024;
+
 class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
  public:
   AsyncAllreduceCUDAWork(
@@ -1124,36 +1129,74 @@ class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
       : AsyncAllreduceWork(context, inputs, reduceOp, tag) {
     initializeStreamsEvents(inputs, streams, events);
 
-    // Kick off copy from CUDA tensors to pinned CPU tensors.
+    // Copies back to the device run on separate streams, so that they
+    // overlap with the copies to the host still in flight.
+    at::cuda::OptionalCUDAGuard device_guard;
+    h2dStreams.reserve(inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+      device_guard.set_index(inputs[i].device().index());
+      h2dStreams.push_back(at::cuda::getStreamFromPool(
+          /* isHighPriority */ true, inputs[i].device().index()));
+      events[i].block(h2dStreams[i]);
+      c10::cuda::CUDACachingAllocator::recordStream(
+          inputs[i].storage().data_ptr(), h2dStreams[i]);
+    }
+
+    // Tensors that are not contiguous are copied and reduced whole.
+    const int64_t numel = inputs[0].numel();
+    const bool contiguous = std::all_of(
+        inputs.begin(), inputs.end(), [](const at::Tensor& tensor) {
+          return tensor.is_contiguous();
+        });
+    chunkNumel = std::max<int64_t>(
+        1, kAllreduceCUDAChunkBytes / inputs[0].element_size());
+    numChunks = contiguous && numel > chunkNumel
+        ? (numel + chunkNumel - 1) / chunkNumel
+        : 1;
+
+    // Kick off copy from CUDA tensors to pinned CPU tensors, one chunk at
+    // a time, recording when each chunk is ready.
     tmp.reserve(inputs.size());
+    chunkEvents.resize(inputs.size());
     at::cuda::OptionalCUDAStreamGuard guard;
     for (size_t i = 0; i < inputs.size(); i++) {
       guard.reset_stream(streams[i]);
-      tmp.push_back(pinnedLike(inputs[i]).copy_(inputs[i], true));
+      tmp.push_back(pinnedLike(inputs[i]));
+      chunkEvents[i].resize(numChunks);
+      for (int64_t c = 0; c < numChunks; c++) {
+        chunk(tmp[i], c).copy_(chunk(inputs[i], c), true);
+        chunkEvents[i][c].record(streams[i]);
+      }
     }
   }
 
   void run() override {
-    // Synchronize with copy operations.
-    at::cuda::OptionalCUDAGuard device_guard;
-    for (size_t i = 0; i < inputs.size(); i++) {
-      device_guard.set_index(inputs[i].device().index());
-      AT_CUDA_CHECK(cudaStreamSynchronize(streams[i]));
-    }
+    at::cuda::OptionalCUDAStreamGuard stream_guard;
+    for (int64_t c = 0; c < numChunks; c++) {
+      // Synchronize with the copy of this chunk.
+      std::vector<at::Tensor> chunks;
+      chunks.reserve(inputs.size());
+      for (size_t i = 0; i < inputs.size(); i++) {
+        chunkEvents[i][c].synchronize();
+        chunks.push_back(chunk(tmp[i], c));
+      }
 
-    // Run allreduce on host side tensors.
-    allreduce(tmp);
+      // Run allreduce on the host side chunks.
+      allreduce(chunks);
+
+      // Kick off copy of this chunk back to the CUDA tensors.
+      // Only the first output in the tensor list contains the results.
+      // See https://github.com/facebookincubator/gloo/issues/152.
+      // The contents is the same for every entry in the tensor list, so
+      // we can use the first entry as the source of the copy below.
+      for (size_t i = 0; i < inputs.size(); i++) {
+        stream_guard.reset_stream(h2dStreams[i]);
+        chunk(inputs[i], c).copy_(chunks[0], /* non_blocking */ true);
+      }
+    }
 
-    // Kick off copy back to the CUDA tensors.
-    // Only the first output in the tensor list contains the results.
-    // See https://github.com/facebookincubator/gloo/issues/152.
-    // The contents is the same for every entry in the tensor list, so
-    // we can use the first entry as the source of the copy below.
-    at::cuda::OptionalCUDAStreamGuard stream_guard;
     for (size_t i = 0; i < inputs.size(); i++) {
-      stream_guard.reset_stream(streams[i]);
-      inputs[i].copy_(tmp[0], /* non_blocking */ true);
-      events[i].record(streams[i]);
+      events[i].record(h2dStreams[i]);
     }
   }
 
@@ -1168,7 +1211,22 @@ class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
 
   std::vector<at::Tensor> tmp;
   std::vector<at::cuda::CUDAStream> streams;
+  std::vector<at::cuda::CUDAStream> h2dStreams;
   std::vector<at::cuda::CUDAEvent> events;
+  // Events recorded after the copy of each chunk of each input to tmp.
+  std::vector<std::vector<at::cuda::CUDAEvent>> chunkEvents;
+  int64_t chunkNumel;
+  int64_t numChunks;
+
+ private:
+  at::Tensor chunk(at::Tensor& tensor, int64_t c) {
+    if (numChunks == 1) {
+      return tensor;
+    }
+    const int64_t offset = c * chunkNumel;
+    return tensor.view(-1).narrow(
+        0, offset, std::min(chunkNumel, tensor.numel() - offset));
+  }
 };
 
 class AsyncSparseAllreduceCUDAWork : public AsyncSparseAllreduceWork {
@@ -0,0 +1,310 @@
+#include <c10d/ProcessGroupHierarchical.hpp>
+
+namespace c10d {
+
+ProcessGroupHierarchical::AsyncWork::AsyncWork(std::function<void()> run)
+    : run_(std::move(run)) {}
+
+void ProcessGroupHierarchical::AsyncWork::execute(
+    std::shared_ptr<AsyncWork> work) {
+  std::exception_ptr eptr;
+  try {
+    work->run_();
+  } catch (...) {
+    eptr = std::current_exception();
+  }
+  work->finish(eptr);
+}
+
+ProcessGroupHierarchical::ProcessGroupHierarchical(
+    int rank,
+    int size,
+    std::shared_ptr<ProcessGroup> intraNodeGroup,
+    std::shared_ptr<ProcessGroup> interNodeGroup)
+    : ProcessGroup(rank, size),
+      intraNodeGroup_(std::move(intraNodeGroup)),
+      interNodeGroup_(std::move(interNodeGroup)),
+      reduceScatterSupported_(true),
+      stop_(false) {
+  TORCH_CHECK(intraNodeGroup_ && interNodeGroup_);
+  const auto localSize = intraNodeGroup_->getSize();
+  TORCH_CHECK(
+      localSize * interNodeGroup_->getSize() == size_,
+      "ProcessGroupHierarchical expects an intra-node group of size ",
+      localSize,
+      " and an inter-node group of size ",
+      interNodeGroup_->getSize(),
+      " to span ",
+      size_,
+      " processes");
+  TORCH_CHECK(
+      interNodeGroup_->getRank() * localSize + intraNodeGroup_->getRank() ==
+          rank_,
+      "ProcessGroupHierarchical expects the processes to be laid out ",
+      "node-major, but process ",
+      rank_,
+      " is process ",
+      intraNodeGroup_->getRank(),
+      " of its node and process ",
+      interNodeGroup_->getRank(),
+      " of its inter-node group");
+  thread_ = std::thread(&ProcessGroupHierarchical::runLoop, this);
+}
+
+ProcessGroupHierarchical::~ProcessGroupHierarchical() {
+  std::unique_lock<std::mutex> lock(workMutex_);
+  workConsumeCV_.wait(lock, [&] { return workQueue_.empty(); });
+
+  // Queue is empty, signal stop
+  stop_ = true;
+
+  // Release lock to allow the thread to terminate
+  lock.unlock();
+
+  workProduceCV_.notify_all();
+  thread_.join();
+}
+
+void ProcessGroupHierarchical::runLoop() {
+  std::unique_lock<std::mutex> lock(workMutex_);
+
+  while (!stop_) {
+    if (workQueue_.empty()) {
+      workProduceCV_.wait(lock);
+      continue;
+    }
+
+    auto work = std::move(workQueue_.front());
+    workQueue_.pop_front();
+    lock.unlock();
+
+    // Notify after releasing the lock so that the waiter
+    // does not immediately block.
+    workConsumeCV_.notify_one();
+
+    AsyncWork::execute(std::move(work));
+    lock.lock();
+  }
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::enqueue(
+    std::function<void()> run) {
+  auto work = std::make_shared<AsyncWork>(std::move(run));
+  std::unique_lock<std::mutex> lock(workMutex_);
+  workQueue_.push_back(work);
+  lock.unlock();
+
+  // Notify after releasing the lock so that the waiter
+  // does not immediately block.
+  workProduceCV_.notify_one();
+  return work;
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::broadcast(
+    std::vector<at::Tensor>& tensors,
+    const BroadcastOptions& opts) {
+  TORCH_CHECK(
+      tensors.size() == 1,
+      "ProcessGroupHierarchical::broadcast: requires a single tensor");
+  TORCH_CHECK(
+      opts.rootRank >= 0 && opts.rootRank < size_,
+      "ProcessGroupHierarchical::broadcast: invalid root rank ",
+      opts.rootRank);
+  const auto localSize = intraNodeGroup_->getSize();
+  const auto rootNode = opts.rootRank / localSize;
+  const auto rootLocalRank = opts.rootRank % localSize;
+  return enqueue([this, tensors, rootNode, rootLocalRank]() mutable {
+    // The processes with the intra-node rank of the root broadcast across
+    // the nodes, so that every node holds the data of the root.
+    if (intraNodeGroup_->getRank() == rootLocalRank) {
+      BroadcastOptions interOpts;
+      interOpts.rootRank = rootNode;
+      interNodeGroup_->broadcast(tensors, interOpts)->wait();
+    }
+    BroadcastOptions intraOpts;
+    intraOpts.rootRank = rootLocalRank;
+    intraNodeGroup_->broadcast(tensors, intraOpts)->wait();
+  });
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::allreduce(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceOptions& opts) {
+  TORCH_CHECK(
+      tensors.size() == 1,
+      "ProcessGroupHierarchical::allreduce: requires a single tensor");
+  auto tensor = tensors.front();
+  return enqueue(
+      [this, tensor, opts]() mutable { runAllreduce(tensor, opts); });
+}
+
+void ProcessGroupHierarchical::runAllreduce(
+    at::Tensor& tensor,
+    const AllreduceOptions& opts) {
+  const auto localSize = intraNodeGroup_->getSize();
+  const auto localRank = intraNodeGroup_->getRank();
+  const auto numel = tensor.numel();
+  const auto shardSize = (numel + localSize - 1) / localSize;
+
+  // The tensor is flattened and padded to a multiple of the intra-node size,
+  // so that it splits into one shard per process of the node.
+  auto flat = at::zeros({shardSize * localSize}, tensor.options());
+  flat.narrow(0, 0, numel).copy_(tensor.reshape({-1}));
+  std::vector<std::vector<at::Tensor>> shards = {flat.split(shardSize)};
+  std::vector<at::Tensor> shard = {at::empty({shardSize}, tensor.options())};
+
+  if (reduceScatterSupported_) {
+    ReduceScatterOptions reduceScatterOpts;
+    reduceScatterOpts.reduceOp = opts.reduceOp;
+    reduceScatterOpts.timeout = opts.timeout;
+    std::shared_ptr<ProcessGroup::Work> work;
+    try {
+      work = intraNodeGroup_->reduce_scatter(shard, shards, reduceScatterOpts);
+    } catch (const std::exception&) {
+      // Backends that don't implement reduce_scatter throw before they
+      // communicate, and they do so on every process.
+      reduceScatterSupported_ = false;
+    }
+    if (work) {
+      work->wait();
+    }
+  }
+  if (!reduceScatterSupported_) {
+    std::vector<at::Tensor> flats = {flat};
+    intraNodeGroup_->allreduce(flats, opts)->wait();
+    shard.front().copy_(shards.front()[localRank]);
+  }
+
+  interNodeGroup_->allreduce(shard, opts)->wait();
+  intraNodeGroup_->allgather(shards, shard)->wait();
+  tensor.copy_(flat.narrow(0, 0, numel).view(tensor.sizes()));
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::
+    allreduce_coalesced(
+        std::vector<at::Tensor>& /* unused */,
+        const AllreduceCoalescedOptions& /* unused */) {
+  throw std::runtime_error(
+      "ProcessGroupHierarchical does not support allreduce_coalesced");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::reduce(
+    std::vector<at::Tensor>& /* unused */,
+    const ReduceOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support reduce");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::allgather(
+    std::vector<std::vector<at::Tensor>>& outputs,
+    std::vector<at::Tensor>& inputs,
+    const AllgatherOptions& /* unused */) {
+  TORCH_CHECK(
+      inputs.size() == 1 && outputs.size() == 1,
+      "ProcessGroupHierarchical::allgather: requires a single input tensor");
+  TORCH_CHECK(
+      outputs.front().size() == static_cast<size_t>(size_),
+      "ProcessGroupHierarchical::allgather: requires ",
+      size_,
+      " output tensors, got ",
+      outputs.front().size());
+  auto input = inputs.front();
+  auto output = outputs.front();
+  return enqueue([this, input, output]() mutable {
+    const auto localSize = intraNodeGroup_->getSize();
+    const auto numNodes = interNodeGroup_->getSize();
+
+    // Gather the inputs of the node, then exchange them as one block of
+    // localSize inputs per node.
+    std::vector<std::vector<at::Tensor>> local(1);
+    for (int i = 0; i < localSize; i++) {
+      local.front().push_back(at::empty_like(input));
+    }
+    std::vector<at::Tensor> inputs = {input};
+    intraNodeGroup_->allgather(local, inputs)->wait();
+
+    std::vector<at::Tensor> block = {at::stack(local.front())};
+    std::vector<std::vector<at::Tensor>> blocks(1);
+    for (int i = 0; i < numNodes; i++) {
+      blocks.front().push_back(at::empty_like(block.front()));
+    }
+    interNodeGroup_->allgather(blocks, block)->wait();
+
+    for (int node = 0; node < numNodes; node++) {
+      for (int i = 0; i < localSize; i++) {
+        output[node * localSize + i].copy_(blocks.front()[node][i]);
+      }
+    }
+  });
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::allgather_base(
+    at::Tensor& /*unused */,
+    at::Tensor& /*unused */,
+    const AllgatherOptions& /*unused */) {
+  throw std::runtime_error(
+      "no support for allgather_base in Hierarchical process group");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::
+    allgather_coalesced(
+        std::vector<std::vector<at::Tensor>>& /* unused */,
+        std::vector<at::Tensor>& /* unused */,
+        const AllgatherOptions& /* unused */) {
+  throw std::runtime_error(
+      "ProcessGroupHierarchical does not support allgather_coalesced");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::gather(
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    std::vector<at::Tensor>& /* unused */,
+    const GatherOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support gather");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::scatter(
+    std::vector<at::Tensor>& /* unused */,
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    const ScatterOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support scatter");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::reduce_scatter(
+    std::vector<at::Tensor>& /* unused */,
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    const ReduceScatterOptions& /* unused */) {
+  throw std::runtime_error(
+      "ProcessGroupHierarchical does not support reduce_scatter");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::send(
+    std::vector<at::Tensor>& /* unused */,
+    int /* unused */,
+    int /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support send");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::recv(
+    std::vector<at::Tensor>& /* unused */,
+    int /* unused */,
+    int /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support recv");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::recvAnysource(
+    std::vector<at::Tensor>& /* unused */,
+    int /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support recv");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::barrier(
+    const BarrierOptions& opts) {
+  return enqueue([this, opts]() {
+    // Once a process passes the inter-node barrier, the processes with its
+    // intra-node rank have passed the intra-node barriers of their nodes, so
+    // every process has arrived.
+    intraNodeGroup_->barrier(opts)->wait();
+    interNodeGroup_->barrier(opts)->wait();
+  });
+}
+
+} // namespace c10d
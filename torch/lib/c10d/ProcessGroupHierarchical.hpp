@@ -0,0 +1,146 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <c10d/ProcessGroup.hpp>
+
+namespace c10d {
+
+// ProcessGroupHierarchical runs collectives in two levels: among the
+// processes of a node over the (fast) intra-node process group, and among
+// the nodes over the (slow) inter-node process group.
+//
+// The processes must be laid out node-major, i.e. process `rank` must be
+// process `rank % L` of its intra-node group of size L, and process
+// `rank / L` of its inter-node group, which holds the processes with the same
+// intra-node rank on every node. Every node must have the same number of
+// processes.
+//
+// An allreduce reduce-scatters the tensor within the node, allreduces every
+// shard across the nodes, one inter-node group per shard, and allgathers the
+// shards within the node. Every process then only sends 1/L of the tensor
+// across the node boundary. If the intra-node group doesn't support
+// reduce_scatter, the tensor is allreduced within the node instead.
+//
+// The levels of a collective run one after the other on a worker thread, so
+// the collectives on the intra-node and inter-node groups are issued in the
+// order the collectives are called. Every collective completes when its last
+// level has been waited on.
+//
+// All functions of the class are expected to be called in the same order
+// across all processes in the process group. This is the only way that we
+// can guarantee to match up the same calls among all processes.
+//
+class ProcessGroupHierarchical final : public ProcessGroup {
+ public:
+  class AsyncWork : public ProcessGroup::Work {
+   public:
+    explicit AsyncWork(std::function<void()> run);
+
+    static void execute(std::shared_ptr<AsyncWork> work);
+
+   private:
+    std::function<void()> run_;
+  };
+
+  explicit ProcessGroupHierarchical(
+      int rank,
+      int size,
+      std::shared_ptr<ProcessGroup> intraNodeGroup,
+      std::shared_ptr<ProcessGroup> interNodeGroup);
+
+  ~ProcessGroupHierarchical() override;
+
+  std::shared_ptr<ProcessGroup::Work> broadcast(
+      std::vector<at::Tensor>& tensors,
+      const BroadcastOptions& opts = BroadcastOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allreduce(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceOptions& opts = AllreduceOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allreduce_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceCoalescedOptions& opts =
+          AllreduceCoalescedOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> reduce(
+      std::vector<at::Tensor>& tensors,
+      const ReduceOptions& opts = ReduceOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allgather(
+      std::vector<std::vector<at::Tensor>>& outputs,
+      std::vector<at::Tensor>& inputs,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allgather_base(
+      at::Tensor& outputBuffer,
+      at::Tensor& inputBuffer,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allgather_coalesced(
+      std::vector<std::vector<at::Tensor>>& outputTensorLists,
+      std::vector<at::Tensor>& inputTensors,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> gather(
+      std::vector<std::vector<at::Tensor>>& outputs,
+      std::vector<at::Tensor>& inputs,
+      const GatherOptions& opts = GatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> scatter(
+      std::vector<at::Tensor>& outputs,
+      std::vector<std::vector<at::Tensor>>& inputs,
+      const ScatterOptions& opts = ScatterOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> reduce_scatter(
+      std::vector<at::Tensor>& outputs,
+      std::vector<std::vector<at::Tensor>>& inputs,
+      const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> send(
+      std::vector<at::Tensor>& tensors,
+      int dstRank,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> recv(
+      std::vector<at::Tensor>& tensors,
+      int srcRank,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> recvAnysource(
+      std::vector<at::Tensor>& tensors,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> barrier(
+      const BarrierOptions& opts = BarrierOptions()) override;
+
+ private:
+  // Runs the levels of one allreduce; see the class comment.
+  void runAllreduce(at::Tensor& tensor, const AllreduceOptions& opts);
+
+  void runLoop();
+
+  std::shared_ptr<ProcessGroup::Work> enqueue(std::function<void()> run);
+
+  std::shared_ptr<ProcessGroup> intraNodeGroup_;
+  std::shared_ptr<ProcessGroup> interNodeGroup_;
+
+  // Only accessed by the worker thread.
+  bool reduceScatterSupported_;
+
+  std::thread thread_;
+  bool stop_;
+
+  std::deque<std::shared_ptr<AsyncWork>> workQueue_;
+  std::mutex workMutex_;
+  std::condition_variable workProduceCV_;
+  std::condition_variable workConsumeCV_;
+};
+
+} // namespace c10d
@@ -1,9 +1,12 @@
 #include <c10d/ProcessGroupMPI.hpp>
 
+#include <algorithm>
+#include <cstdlib>
 #include <limits>
 #include <map>
 
 #include <c10/core/DeviceGuard.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
 
 #if defined(OPEN_MPI) && OPEN_MPI
 #include <mpi-ext.h> // Needed for CUDA-aware check
@@ -247,11 +250,40 @@ void ProcessGroupMPI::mpiExit() {
   MPI_CHECK(MPI_Finalize());
 }
 
+size_t ProcessGroupMPI::numCommunicatorsFromEnv() {
+  char* env = getenv(MPI_NUM_COMMUNICATORS);
+  if (env == nullptr) {
+    return 1;
+  }
+  int value = 0;
+  try {
+    value = std::stoi(env);
+  } catch (const std::exception&) {
+  }
+  if (value < 1) {
+    throw std::runtime_error(
+        "Invalid value for environment variable: " +
+        std::string(MPI_NUM_COMMUNICATORS));
+  }
+  return value;
+}
+
+std::unique_lock<std::mutex> ProcessGroupMPI::lockMPI() {
+  if (mpiThreadSupport_ >= MPI_THREAD_MULTIPLE) {
+    return std::unique_lock<std::mutex>(pgGlobalMutex_, std::defer_lock);
+  }
+  return std::unique_lock<std::mutex>(pgGlobalMutex_);
+}
+
 void ProcessGroupMPI::initMPIOnce() {
   // Initialize MPI environment
   std::call_once(onceFlagInitMPI, []() {
-    MPI_CHECK(MPI_Init_thread(
-        nullptr, nullptr, MPI_THREAD_SERIALIZED, &mpiThreadSupport_));
+    // Concurrent collectives need MPI calls from several threads at once.
+    const int required = numCommunicatorsFromEnv() > 1
+        ? MPI_THREAD_MULTIPLE
+        : MPI_THREAD_SERIALIZED;
+    MPI_CHECK(
+        MPI_Init_thread(nullptr, nullptr, required, &mpiThreadSupport_));
     if (mpiThreadSupport_ < MPI_THREAD_SERIALIZED) {
       throw std::runtime_error(
           "Used MPI implementation doesn't have the "
@@ -316,8 +348,27 @@ ProcessGroupMPI::ProcessGroupMPI(int rank, int size, MPI_Comm pgComm)
     throw std::runtime_error("pgComm_ must not be MPI_COMM_NULL");
   }
 
-  // Start the worker thread accepting MPI calls
-  workerThread_ = std::thread(&ProcessGroupMPI::runLoop, this);
+  comms_.push_back(pgComm_);
+  const size_t numComms = numCommunicatorsFromEnv();
+  if (numComms > 1 && mpiThreadSupport_ < MPI_THREAD_MULTIPLE) {
+    TORCH_WARN(
+        MPI_NUM_COMMUNICATORS,
+        " is ignored: the MPI implementation doesn't support "
+        "MPI_THREAD_MULTIPLE, collectives run on a single communicator");
+  } else {
+    std::lock_guard<std::mutex> globalLock(pgGlobalMutex_);
+    for (size_t i = 1; i < numComms; i++) {
+      MPI_Comm comm = MPI_COMM_NULL;
+      MPI_CHECK(MPI_Comm_dup(pgComm_, &comm));
+      comms_.push_back(comm);
+    }
+  }
+
+  // Start the worker threads accepting MPI calls
+  queues_.resize(comms_.size());
+  for (size_t i = 0; i < comms_.size(); i++) {
+    workerThreads_.emplace_back(&ProcessGroupMPI::runLoop, this, i);
+  }
 }
 
 ProcessGroupMPI::~ProcessGroupMPI() {
@@ -326,17 +377,35 @@ ProcessGroupMPI::~ProcessGroupMPI() {
 
 void ProcessGroupMPI::destroy() {
   std::unique_lock<std::mutex> lock(pgMutex_);
-  queueConsumeCV_.wait(lock, [&] { return queue_.empty(); });
+  queueConsumeCV_.wait(lock, [&] {
+    return std::all_of(
+        queues_.begin(), queues_.end(), [](const std::deque<WorkType>& queue) {
+          return queue.empty();
+        });
+  });
 
-  // Queue is empty, signal stop
+  // Queues are empty, signal stop
   stop_ = true;
 
   // Release lock to allow threads to terminate
   lock.unlock();
   queueProduceCV_.notify_all();
 
-  // Join the single worker thread
-  workerThread_.join();
+  // Join the worker threads
+  for (auto& workerThread : workerThreads_) {
+    workerThread.join();
+  }
+  workerThreads_.clear();
+
+  // Free the duplicated communicators, unless MPI is already finalized.
+  // This runs in the destructor, so errors are ignored.
+  int finalized = 0;
+  std::lock_guard<std::mutex> globalLock(pgGlobalMutex_);
+  MPI_Finalized(&finalized);
+  for (size_t i = 1; i < comms_.size() && !finalized; i++) {
+    MPI_Comm_free(&comms_[i]);
+  }
+  comms_.resize(1);
 }
 
 void ProcessGroupMPI::abort() {
@@ -344,26 +413,33 @@ void ProcessGroupMPI::abort() {
   MPI_Abort(pgComm_, EXIT_FAILURE);
 }
 
-void ProcessGroupMPI::runLoop() {
+void ProcessGroupMPI::runLoop(size_t worker) {
   std::unique_lock<std::mutex> lock(pgMutex_);
+  auto& queue = queues_[worker];
 
   while (!stop_) {
-    if (queue_.empty()) {
+    if (queue.empty()) {
       queueProduceCV_.wait(lock);
       continue;
     }
 
-    auto workTuple = std::move(queue_.front());
+    auto workTuple = std::move(queue.front());
 
-    queue_.pop_front();
+    queue.pop_front();
 
     auto& workEntry = std::get<0>(workTuple);
     auto& work = std::get<1>(workTuple);
 
     lock.unlock();
-    queueConsumeCV_.notify_one();
+    queueConsumeCV_.notify_all();
 
     try {
+      // Wait for the kernels producing CUDA tensors, which MPI reads directly.
+      for (const auto& event : workEntry->events) {
+        while (!event.query()) {
+          std::this_thread::yield();
+        }
+      }
       workEntry->run(workEntry);
       work->finish();
     } catch (...) {
@@ -376,11 +452,26 @@ void ProcessGroupMPI::runLoop() {
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::enqueue(
     std::unique_ptr<WorkEntry> entry) {
+  for (auto* tensors : {&entry->src, &entry->dst}) {
+    for (const auto& tensor : *tensors) {
+      if (tensor.is_cuda()) {
+        c10::impl::VirtualGuardImpl impl(tensor.device().type());
+        entry->events.emplace_back(tensor.device().type());
+        entry->events.back().record(impl.getStream(tensor.device()));
+      }
+    }
+  }
+
   auto work = std::make_shared<WorkMPI>();
   std::unique_lock<std::mutex> lock(pgMutex_);
-  queue_.push_back(std::make_tuple(std::move(entry), work));
+  // Calls are made in the same order on every process, so every process
+  // assigns a collective to the same communicator.
+  const size_t worker = nextWorker_;
+  nextWorker_ = (nextWorker_ + 1) % queues_.size();
+  entry->comm = comms_[worker];
+  queues_[worker].push_back(std::make_tuple(std::move(entry), work));
   lock.unlock();
-  queueProduceCV_.notify_one();
+  queueProduceCV_.notify_all();
   return work;
 }
 
@@ -392,13 +483,13 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::broadcast(
       [opts, this](std::unique_ptr<WorkEntry>& entry) {
         auto data = (entry->src)[0];
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = lockMPI();
         MPI_CHECK(MPI_Bcast(
             data.data_ptr(),
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             opts.rootRank,
-            pgComm_));
+            entry->comm));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(&tensors, nullptr, std::move(runFunc)));
@@ -414,14 +505,14 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allreduce(
       [opts, this](std::unique_ptr<WorkEntry>& entry) {
         auto data = (entry->src)[0];
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = lockMPI();
         MPI_CHECK(MPI_Allreduce(
             MPI_IN_PLACE,
             data.data_ptr(),
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             mpiOp.at(opts.reduceOp),
-            pgComm_));
+            entry->comm));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(&tensors, nullptr, std::move(runFunc)));
@@ -448,7 +539,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::reduce(
         void* recvbuf = (rank_ == opts.rootRank) ? dataPtr : nullptr;
 
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = lockMPI();
         MPI_CHECK(MPI_Reduce(
             sendbuf,
             recvbuf,
@@ -456,7 +547,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::reduce(
             mpiDatatype.at(data.scalar_type()),
             mpiOp.at(opts.reduceOp),
             opts.rootRank,
-            pgComm_));
+            entry->comm));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(&tensors, nullptr, std::move(runFunc)));
@@ -488,7 +579,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allgather(
         auto flatOutputTensor = newLikeFlat(outputDataVec);
 
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = lockMPI();
         MPI_CHECK(MPI_Allgather(
             data.data_ptr(),
             data.numel(),
@@ -496,7 +587,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allgather(
             flatOutputTensor.data_ptr(),
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
-            pgComm_));
+            entry->comm));
 
         for (size_t i = 0; i < outputDataVec.size(); ++i) {
           outputDataVec[i].copy_(flatOutputTensor[i]);
@@ -551,7 +642,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::gather(
         }
 
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = lockMPI();
         MPI_CHECK(MPI_Gather(
             data.data_ptr(),
             data.numel(),
@@ -560,7 +651,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::gather(
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             opts.rootRank,
-            pgComm_));
+            entry->comm));
 
         if (rank_ == opts.rootRank) {
           std::vector<at::Tensor>& outputDataVec = entry->dst;
@@ -625,7 +716,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::scatter(
         }
 
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = lockMPI();
         MPI_CHECK(MPI_Scatter(
             sendbuf,
             data.numel(),
@@ -634,7 +725,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::scatter(
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             opts.rootRank,
-            pgComm_));
+            entry->comm));
       };
 
   if (rank_ == opts.rootRank) {
@@ -679,7 +770,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::alltoall_base(
           auto srcdata = (entry->src)[0];
           auto dstdata = (entry->dst)[0];
           c10::DeviceGuard guard(srcdata.device());
-          std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+          auto globalLock = lockMPI();
           MPI_CHECK(MPI_Alltoall(
               srcdata.data_ptr(),
               srcdata.numel() / size_,
@@ -687,7 +778,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::alltoall_base(
               dstdata.data_ptr(),
               dstdata.numel() / size_,
               mpiDatatype.at(dstdata.scalar_type()),
-              pgComm_));
+              entry->comm));
         };
     std::vector<at::Tensor> inputTensors = {inputTensor};
     std::vector<at::Tensor> outputTensors = {outputTensor};
@@ -712,7 +803,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::alltoall_base(
           computeLengthsAndOffsets(
               outputSplitSizes, dstdata, &recv_lengths, &recv_offsets);
           c10::DeviceGuard guard(srcdata.device());
-          std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+          auto globalLock = lockMPI();
           MPI_CHECK(MPI_Alltoallv(
               srcdata.data_ptr(),
               send_lengths.data(),
@@ -722,7 +813,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::alltoall_base(
               recv_lengths.data(),
               recv_offsets.data(),
               mpiDatatype.at(dstdata.scalar_type()),
-              pgComm_));
+              entry->comm));
         };
     std::vector<at::Tensor> inputTensors = {inputTensor};
     std::vector<at::Tensor> outputTensors = {outputTensor};
@@ -765,7 +856,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::alltoall(
           srcFlatDataSplits[i].copy_(srcdata[i].view({-1}));
         }
         c10::DeviceGuard guard1(srcdata[0].device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = lockMPI();
         MPI_CHECK(MPI_Alltoallv(
             srcFlatData.data_ptr(),
             send_lengths.data(),
@@ -775,7 +866,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::alltoall(
             recv_lengths.data(),
             recv_offsets.data(),
             mpiDatatype.at(dstdata[0].scalar_type()),
-            pgComm_));
+            entry->comm));
 
         auto dstFlatDataSplits =
             dstFlatData.split_with_sizes(c10::IntArrayRef(recv_lengthsL), 0);
@@ -866,8 +957,8 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::barrier(
     const BarrierOptions& opts) {
   std::function<void(std::unique_ptr<WorkEntry>&)> runFunc =
       [this](std::unique_ptr<WorkEntry>& entry) {
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
-        MPI_CHECK(MPI_Barrier(pgComm_));
+        auto globalLock = lockMPI();
+        MPI_CHECK(MPI_Barrier(entry->comm));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(nullptr, nullptr, std::move(runFunc)));
@@ -8,6 +8,7 @@
 #include <thread>
 #include <vector>
 
+#include <c10/core/Event.h>
 #include <c10d/ProcessGroup.hpp>
 #include <c10d/Types.hpp>
 #include <c10d/Utils.hpp>
@@ -16,6 +17,11 @@
 
 namespace c10d {
 
+// Environment variable which controls how many MPI communicators (and worker
+// threads) collectives are spread over. Values above one require an MPI
+// implementation supporting MPI_THREAD_MULTIPLE.
+constexpr const char* MPI_NUM_COMMUNICATORS = "TORCH_MPI_NUM_COMMUNICATORS";
+
 // WorkEntry is the state associated with a single MPI run instance.
 // It include the source Tensor list and destination Tensor list, as well as
 // The actual run function that will operate either on src or dst or both.
@@ -43,6 +49,11 @@ struct WorkEntry {
   std::vector<at::Tensor> dst;
   // src rank returned, for recv only
   int* srcRank = nullptr;
+  // Communicator to run on, assigned when the entry is enqueued
+  MPI_Comm comm = MPI_COMM_NULL;
+  // Recorded on the current streams of the CUDA tensors when the entry is
+  // enqueued, so that MPI only reads them once the kernels producing them ran
+  std::vector<c10::Event> events;
   std::function<void(std::unique_ptr<WorkEntry>&)> run;
 };
 
@@ -69,7 +80,17 @@ struct WorkEntry {
 // other words, the size of the input Tensor vector should always be 1.
 //
 // CUDA tensor can be supported if the MPI used is CUDA-aware MPI, and
-// ProcessGroupMPI will automatically detect this support.
+// ProcessGroupMPI will automatically detect this support. Device pointers are
+// then passed to MPI directly, once the work queued on the current CUDA
+// streams of the tensors at the time of the call has completed.
+//
+// Collectives run on a single worker thread and communicator by default.
+// When the environment variable TORCH_MPI_NUM_COMMUNICATORS is set to N > 1
+// and MPI supports MPI_THREAD_MULTIPLE, the communicator is duplicated N - 1
+// times and collectives are spread over N worker threads in a round-robin
+// fashion, so that independent collectives run concurrently. Collectives then
+// no longer complete in the order they were issued: use wait() on the works
+// that must be done before proceeding.
 class ProcessGroupMPI : public ProcessGroup {
  public:
   class WorkMPI : public ProcessGroup::Work {
@@ -191,8 +212,8 @@ class ProcessGroupMPI : public ProcessGroup {
  protected:
   using WorkType =
       std::tuple<std::unique_ptr<WorkEntry>, std::shared_ptr<WorkMPI>>;
-  // Worker thread loop
-  void runLoop();
+  // Worker thread loop, running the collectives queued on comms_[worker]
+  void runLoop(size_t worker);
   // Helper function that is called by the destructor
   void destroy();
 
@@ -201,9 +222,11 @@ class ProcessGroupMPI : public ProcessGroup {
   bool stop_;
 
   std::mutex pgMutex_;
-  std::thread workerThread_;
+  std::vector<std::thread> workerThreads_;
 
-  std::deque<WorkType> queue_;
+  // One queue per worker thread
+  std::vector<std::deque<WorkType>> queues_;
+  size_t nextWorker_ = 0;
   std::condition_variable queueProduceCV_;
   std::condition_variable queueConsumeCV_;
 
@@ -215,7 +238,14 @@ class ProcessGroupMPI : public ProcessGroup {
   static std::mutex pgGlobalMutex_;
   static int mpiThreadSupport_;
 
+  // Number of communicators requested through MPI_NUM_COMMUNICATORS
+  static size_t numCommunicatorsFromEnv();
+  // Serializes MPI calls, unless MPI supports MPI_THREAD_MULTIPLE
+  static std::unique_lock<std::mutex> lockMPI();
+
   MPI_Comm pgComm_;
+  // pgComm_ followed by its duplicates, one per worker thread
+  std::vector<MPI_Comm> comms_;
 };
 
 } // namespace c10d
@@ -1,5 +1,6 @@
 #include <c10d/ProcessGroupNCCL.hpp>
 
+#include <algorithm>
 #include <map>
 #include <tuple>
 #include <unordered_set>
@@ -442,8 +443,15 @@ void ProcessGroupNCCL::broadcastUniqueNCCLID(ncclUniqueId* ncclID) {
   // retrieving the contents of that key. A single process group
   // may create multiple NCCL communicators, so we use a sequence
   // number to differentiate between them.
-  std::string storeKey = std::to_string(ncclCommCounter_++);
-  if (rank_ == 0) {
+  broadcastUniqueNCCLID(
+      ncclID, rank_ == 0, std::to_string(ncclCommCounter_++));
+}
+
+void ProcessGroupNCCL::broadcastUniqueNCCLID(
+    ncclUniqueId* ncclID,
+    bool isRoot,
+    const std::string& storeKey) {
+  if (isRoot) {
     auto vec = std::vector<uint8_t>(
         reinterpret_cast<uint8_t*>(ncclID),
         reinterpret_cast<uint8_t*>(ncclID) + NCCL_UNIQUE_ID_BYTES);
@@ -457,7 +465,8 @@ void ProcessGroupNCCL::broadcastUniqueNCCLID(ncclUniqueId* ncclID) {
 
 std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
     const std::string& devicesKey,
-    const std::vector<at::Device>& devices) {
+    const std::vector<at::Device>& devices,
+    int p2pPeer) {
   // Sanity check
   if (devicesKey.empty()) {
     throw std::runtime_error(
@@ -484,12 +493,26 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
   // Create the unique NCCL ID and broadcast it
   ncclUniqueId ncclID;
 
-  if (rank_ == 0) {
+  // The lower rank of a pair plays rank 0 of its communicators.
+  const bool isP2P = p2pPeer != -1;
+  const int commRank = isP2P ? (rank_ < p2pPeer ? 0 : 1) : getRank();
+  const int commSize = isP2P ? 2 : getSize();
+
+  if (commRank == 0) {
     C10D_NCCL_CHECK(ncclGetUniqueId(&ncclID));
   }
 
   // Broadcast so that each process can have a unique NCCL ID
-  broadcastUniqueNCCLID(&ncclID);
+  if (isP2P) {
+    const auto pairKey = std::to_string(std::min(rank_, p2pPeer)) + ":" +
+        std::to_string(std::max(rank_, p2pPeer));
+    broadcastUniqueNCCLID(
+        &ncclID,
+        commRank == 0,
+        "p2p:" + pairKey + ":" + std::to_string(p2pCommCounters_[pairKey]++));
+  } else {
+    broadcastUniqueNCCLID(&ncclID);
+  }
 
   at::cuda::OptionalCUDAGuard gpuGuard;
 
@@ -501,8 +524,8 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
 
   for (size_t i = 0; i < devices.size(); ++i) {
     // GPU world size and GPU rank
-    int numRanks = getSize() * devices.size();
-    int rank = getRank() * devices.size() + i;
+    int numRanks = commSize * devices.size();
+    int rank = commRank * devices.size() + i;
 
     gpuGuard.set_index(devices[i].index());
     ncclComms[i] = NCCLComm::create(numRanks, rank, ncclID);
@@ -574,8 +597,42 @@ void check_gpu_tensors(const std::vector<at::Tensor>& tensors) {
   }
 }
 
+// Returns a view of `tensors' as one tensor with an extra outermost dimension
+// if they already are adjacent in memory, one after the other, e.g. because
+// they are the chunks of one contiguous tensor. Returns an undefined tensor
+// otherwise.
+at::Tensor viewAsFlat(const std::vector<at::Tensor>& tensors) {
+  const auto& first = tensors.front();
+  const auto numel = first.numel();
+  if (numel == 0 || !first.is_contiguous()) {
+    return at::Tensor();
+  }
+  for (size_t i = 1; i < tensors.size(); ++i) {
+    const auto& t = tensors[i];
+    if (!t.is_alias_of(first) || t.scalar_type() != first.scalar_type() ||
+        t.sizes() != first.sizes() || !t.is_contiguous() ||
+        t.storage_offset() !=
+            first.storage_offset() + static_cast<int64_t>(i) * numel) {
+      return at::Tensor();
+    }
+  }
+  std::vector<int64_t> sizes{static_cast<int64_t>(tensors.size())};
+  sizes.insert(sizes.end(), first.sizes().begin(), first.sizes().end());
+  std::vector<int64_t> strides{numel};
+  strides.insert(strides.end(), first.strides().begin(), first.strides().end());
+  return first.as_strided(sizes, strides, first.storage_offset());
+}
+
+// Whether `a' and `b' are views of the same memory, in which case there is
+// nothing to copy between them.
+bool isSameView(const at::Tensor& a, const at::Tensor& b) {
+  return a.is_alias_of(b) && a.storage_offset() == b.storage_offset();
+}
+
 // Flatten each list in `tensor_lists' for a gather or scatter operation, and
-// ensure compatibility with the corresponding tensor in `other'.
+// ensure compatibility with the corresponding tensor in `other'. If a list
+// already is adjacent in memory, the flattened tensor is a view of it, and the
+// copies to and from it can be skipped.
 std::vector<at::Tensor> flatten_for_scatter_gather(
     std::vector<std::vector<at::Tensor>>& tensor_lists,
     std::vector<at::Tensor>& other,
@@ -611,7 +668,10 @@ std::vector<at::Tensor> flatten_for_scatter_gather(
       }
     }
     // Flatten the tensors (from all ranks) into a single big tensor.
-    flattened[i] = newLikeFlat(tensor_lists, i);
+    flattened[i] = viewAsFlat(tensor_lists[i]);
+    if (!flattened[i].defined()) {
+      flattened[i] = newLikeFlat(tensor_lists, i);
+    }
   }
   return flattened;
 }
@@ -724,8 +784,63 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce_coalesced(
     std::vector<at::Tensor>& tensors,
     const AllreduceCoalescedOptions& opts) {
-  throw std::runtime_error(
-      "allreduce_coalesced is currently not supported with NCCL");
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument(
+        "ProcessGroupNCCL::allreduce_coalesced: " + msg);
+  };
+  assertNonEmpty(invalidArgument, tensors);
+  assertLayoutMatch(invalidArgument, tensors);
+  assertDense(invalidArgument, tensors);
+  for (const auto& t : tensors) {
+    if (!t.is_cuda()) {
+      invalidArgument("tensors must be CUDA tensors");
+    }
+    if (t.scalar_type() != tensors[0].scalar_type()) {
+      invalidArgument("tensors must all have the same type");
+    }
+    if (t.device() != tensors[0].device()) {
+      invalidArgument("tensors must all be on the same device");
+    }
+  }
+
+  // Reduce all the tensors with a single collective on a flattened copy of
+  // them, allocated with the caching allocator, so that many small tensors
+  // cost about as much as one tensor of their total size.
+  std::vector<at::Tensor> flattened = {flattenDenseTensors(tensors)};
+
+  return collective(
+      flattened,
+      flattened,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        return ncclAllReduce(
+            input.data_ptr(),
+            output.data_ptr(),
+            input.numel(),
+            getNcclDataType(input.scalar_type()),
+            ncclOp[opts.reduceOp],
+            comm,
+            stream.stream());
+      },
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {},
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {
+        // Copy the reduced values back to the tensors. This is done on the
+        // NCCL stream before the work's event is recorded, so that waiting
+        // on the work also waits for these copies.
+        at::cuda::CUDAStreamGuard guard(ncclStreams[0]);
+        int64_t offset = 0;
+        for (auto& tensor : tensors) {
+          // See [Sync Streams].
+          c10::cuda::CUDACachingAllocator::recordStream(
+              tensor.storage().data_ptr(), ncclStreams[0]);
+          tensor.copy_(
+              flattened[0].narrow(0, offset, tensor.numel()).view_as(tensor),
+              true);
+          offset += tensor.numel();
+        }
+      });
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::broadcast(
@@ -809,6 +924,9 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather(
         for (size_t i = 0; i < outputTensors.size(); ++i) {
           at::cuda::CUDAStreamGuard guard(ncclStreams[i]);
           for (size_t j = 0; j < outputTensors[0].size(); ++j) {
+            if (isSameView(outputTensors[i][j], outputFlattened[i][j])) {
+              continue;
+            }
             // See [Sync Streams].
             c10::cuda::CUDACachingAllocator::recordStream(
                 outputTensors[i][j].storage().data_ptr(), ncclStreams[i]);
@@ -860,6 +978,9 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce_scatter(
         for (size_t i = 0; i < inputTensors.size(); ++i) {
           at::cuda::CUDAStreamGuard guard(ncclStreams[i]);
           for (size_t j = 0; j < inputTensors[0].size(); ++j) {
+            if (isSameView(inputTensors[i][j], inputFlattened[i][j])) {
+              continue;
+            }
             // See [Sync Streams].
             c10::cuda::CUDACachingAllocator::recordStream(
                 inputTensors[i][j].storage().data_ptr(), ncclStreams[i]);
@@ -926,17 +1047,131 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::scatter(
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::send(
-    std::vector<at::Tensor>& /* unused */,
-    int /* unused */,
+    std::vector<at::Tensor>& tensors,
+    int dstRank,
     int /* unused */) {
-  throw std::runtime_error("ProcessGroupNCCL does not support send");
+  if (tensors.size() != 1) {
+    throw std::runtime_error(
+        "ProcessGroupNCCL::send takes a single tensor");
+  }
+  std::vector<P2POp> ops = {{P2POp::Type::SEND, tensors[0], dstRank}};
+  return batchIsendIrecv(ops);
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::recv(
-    std::vector<at::Tensor>& /* unused */,
-    int /* unused */,
+    std::vector<at::Tensor>& tensors,
+    int srcRank,
     int /* unused */) {
-  throw std::runtime_error("ProcessGroupNCCL does not support recv");
+  if (tensors.size() != 1) {
+    throw std::runtime_error(
+        "ProcessGroupNCCL::recv takes a single tensor");
+  }
+  std::vector<P2POp> ops = {{P2POp::Type::RECV, tensors[0], srcRank}};
+  return batchIsendIrecv(ops);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::batchIsendIrecv(
+    std::vector<P2POp>& ops) {
+#ifdef ENABLE_NCCL_P2P_SUPPORT
+  if (ops.empty()) {
+    throw std::runtime_error(
+        "batchIsendIrecv: expected at least one operation");
+  }
+  const auto device = ops[0].tensor.device();
+  for (const auto& op : ops) {
+    if (!op.tensor.is_cuda() || op.tensor.is_sparse() ||
+        !op.tensor.is_contiguous()) {
+      throw std::runtime_error(
+          "batchIsendIrecv: tensors must be CUDA, dense and contiguous");
+    }
+    if (op.tensor.device() != device) {
+      throw std::runtime_error(
+          "batchIsendIrecv: all tensors must be on the same GPU");
+    }
+    if (op.peer < 0 || op.peer >= size_ || op.peer == rank_) {
+      throw std::runtime_error(
+          "batchIsendIrecv: invalid peer rank " + std::to_string(op.peer));
+    }
+  }
+
+  // Creating the communicator of a pair blocks until both ranks take part,
+  // so communicators are looked up by increasing peer rank: every rank then
+  // creates them in the same global order of pairs, which can't deadlock.
+  std::vector<int> peers;
+  for (const auto& op : ops) {
+    peers.push_back(op.peer);
+  }
+  std::sort(peers.begin(), peers.end());
+  peers.erase(std::unique(peers.begin(), peers.end()), peers.end());
+
+  const std::vector<at::Device> devices = {device};
+  std::vector<std::string> keys;
+  std::vector<std::shared_ptr<NCCLComm>> ncclComms;
+  keys.reserve(peers.size());
+  ncclComms.reserve(peers.size());
+  for (int peer : peers) {
+    keys.push_back(
+        "p2p:" + std::to_string(peer) + ":" + getKeyFromDevices(devices));
+    ncclComms.push_back(getNCCLComm(keys.back(), devices, peer)[0]);
+    syncStreams(devices, ncclEvents_[keys.back()], ncclStreams_[keys.back()]);
+  }
+  auto peerIndex = [&](int peer) {
+    return std::lower_bound(peers.begin(), peers.end(), peer) - peers.begin();
+  };
+
+  // One event and communicator per peer
+  auto work = initWork(std::vector<at::Device>(peers.size(), device));
+
+  at::cuda::OptionalCUDAGuard gpuGuard(device);
+
+  // See [Sync Streams].
+  for (const auto& op : ops) {
+    c10::cuda::CUDACachingAllocator::recordStream(
+        op.tensor.storage().data_ptr(),
+        ncclStreams_[keys[peerIndex(op.peer)]][0]);
+  }
+
+  {
+    AutoNcclGroup nccl_group_guard;
+    for (auto& op : ops) {
+      const auto i = peerIndex(op.peer);
+      at::cuda::CUDAStream& ncclStream = ncclStreams_[keys[i]][0];
+      // Rank of the peer in the communicator of the pair
+      const int peerRank = op.peer < rank_ ? 0 : 1;
+      if (op.type == P2POp::Type::SEND) {
+        C10D_NCCL_CHECK(ncclSend(
+            op.tensor.data_ptr(),
+            op.tensor.numel(),
+            getNcclDataType(op.tensor.scalar_type()),
+            peerRank,
+            ncclComms[i]->getNcclComm(),
+            ncclStream.stream()));
+      } else {
+        C10D_NCCL_CHECK(ncclRecv(
+            op.tensor.data_ptr(),
+            op.tensor.numel(),
+            getNcclDataType(op.tensor.scalar_type()),
+            peerRank,
+            ncclComms[i]->getNcclComm(),
+            ncclStream.stream()));
+      }
+    }
+  }
+
+  // Event should only be recorded after the ncclGroupEnd()
+  for (size_t i = 0; i < peers.size(); ++i) {
+    work->cudaEvents_[i].record(ncclStreams_[keys[i]][0]);
+    work->ncclComms_[i] = ncclComms[i];
+  }
+  work->blockingWait_ = blockingWait_;
+  work->opTimeout_ = opTimeout_;
+  work->store_ = store_;
+
+  return work;
+#else
+  throw std::runtime_error(
+      "ProcessGroupNCCL only supports send and recv with NCCL 2.7+");
+#endif
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::recvAnysource(
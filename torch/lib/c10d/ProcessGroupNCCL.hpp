@@ -54,6 +54,15 @@ constexpr const char* NCCL_BLOCKING_WAIT = "NCCL_BLOCKING_WAIT";
 //   // Now continue on other work in the current stream.
 class ProcessGroupNCCL : public ProcessGroup {
  public:
+  // A point-to-point operation of a batch, see batchIsendIrecv().
+  struct P2POp {
+    enum class Type { SEND, RECV };
+
+    Type type;
+    at::Tensor tensor;
+    int peer;
+  };
+
   class WorkNCCL : public ProcessGroup::Work {
    public:
     // Constructor takes a list of CUDA devices
@@ -226,17 +235,35 @@ class ProcessGroupNCCL : public ProcessGroup {
       std::vector<at::Tensor>& tensors,
       int tag) override;
 
+  // Launches a list of sends and receives, possibly to and from several peers,
+  // in a single NCCL group and returns a single work for all of them. All the
+  // tensors must be on the same GPU. Every peer must issue the matching
+  // operations, in the same order for each pair of ranks. Each pair of ranks
+  // uses its own communicator, created on first use by both ranks and cached.
+  // Requires NCCL 2.7+.
+  std::shared_ptr<ProcessGroup::Work> batchIsendIrecv(
+      std::vector<P2POp>& ops);
+
   static const int64_t kProcessGroupNCCLOpTimeoutMillis;
 
  protected:
   // Helper that broadcasts nccl unique ID to all ranks through the store
   void broadcastUniqueNCCLID(ncclUniqueId* ncclID);
 
+  // Helper that shares the nccl unique ID of isRoot through the store, under
+  // storeKey
+  void broadcastUniqueNCCLID(
+      ncclUniqueId* ncclID,
+      bool isRoot,
+      const std::string& storeKey);
+
   // Helper that either looks up the cached NCCL communicators or creates
-  // a new set of NCCL communicators as a cache entry
+  // a new set of NCCL communicators as a cache entry. If p2pPeer is not -1,
+  // the communicators only span this rank and p2pPeer.
   std::vector<std::shared_ptr<NCCLComm>>& getNCCLComm(
       const std::string& devicesKey,
-      const std::vector<at::Device>& devices);
+      const std::vector<at::Device>& devices,
+      int p2pPeer = -1);
 
   // Wrapper method which can be overridden for tests.
   virtual std::exception_ptr checkForNCCLErrors(
@@ -294,6 +321,10 @@ class ProcessGroupNCCL : public ProcessGroup {
   // used to scope keys used in the store.
   uint64_t ncclCommCounter_{0};
 
+  // Same for the communicators of each pair of ranks, which only they create.
+  // The key is "lowRank:highRank".
+  std::unordered_map<std::string, uint64_t> p2pCommCounters_;
+
   // The NCCL communicator that the process group has cached.
   // The key is a list of GPU devices that an operation is operating on
   // The GPU devices are stored in a device sequence and the cache NCCL
@@ -38,6 +38,27 @@ class Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) = 0;
 
+  // Sets every key in `keys` to the value at the same index in `values`.
+  // Stores that can batch the updates override this; by default, the keys are
+  // set one by one.
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
+  // Returns the values of `keys`, waiting for them like get(). Stores that can
+  // batch the lookups override this; by default, the keys are fetched one by
+  // one.
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
+  // Atomically sets `key` to `desiredValue` if its value is `expectedValue`,
+  // where a key that isn't set has an empty value, and returns the value of
+  // `key` afterwards. Throws if the store doesn't support it.
+  virtual std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue);
+
   void setTimeout(const std::chrono::milliseconds& timeout);
 
  protected:
@@ -1,7 +1,12 @@
 #include <c10d/TCPStore.hpp>
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
 #include <poll.h>
+#endif
 
+#include <sys/socket.h>
 #include <unistd.h>
 #include <algorithm>
 #include <system_error>
@@ -10,12 +15,106 @@ namespace c10d {
 
 namespace {
 
-enum class QueryType : uint8_t { SET, GET, ADD, CHECK, WAIT };
+enum class QueryType : uint8_t {
+  SET,
+  GET,
+  ADD,
+  CHECK,
+  WAIT,
+  MULTI_SET,
+  MULTI_GET,
+  COMPARE_SET
+};
 
 enum class CheckResponseType : uint8_t { READY, NOT_READY };
 
 enum class WaitResponseType : uint8_t { STOP_WAITING };
 
+// Waits for events on a set of file descriptors. With epoll, a wait costs
+// time in the number of file descriptors that have events rather than in the
+// number of file descriptors, which matters once thousands of workers have
+// connected to the store.
+class Poller {
+ public:
+  Poller() {
+#ifdef __linux__
+    SYSCHECK_ERR_RETURN_NEG1(epollFd_ = ::epoll_create1(EPOLL_CLOEXEC));
+#endif
+  }
+
+  ~Poller() {
+#ifdef __linux__
+    ::close(epollFd_);
+#endif
+  }
+
+  void add(int fd) {
+#ifdef __linux__
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    SYSCHECK_ERR_RETURN_NEG1(::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event));
+#else
+    fds_.push_back({.fd = fd, .events = POLLIN});
+#endif
+  }
+
+  // Must be called before `fd` is closed.
+  void remove(int fd) {
+#ifdef __linux__
+    SYSCHECK_ERR_RETURN_NEG1(::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr));
+#else
+    fds_.erase(
+        std::remove_if(
+            fds_.begin(),
+            fds_.end(),
+            [fd](const struct pollfd& pfd) { return pfd.fd == fd; }),
+        fds_.end());
+#endif
+  }
+
+  // Blocks until there are events, and returns the file descriptors that
+  // are readable, hung up, or failed.
+  std::vector<int> wait() {
+    std::vector<int> ready;
+#ifdef __linux__
+    constexpr int kMaxEvents = 256;
+    struct epoll_event events[kMaxEvents];
+    int numEvents;
+    SYSCHECK_ERR_RETURN_NEG1(
+        numEvents = ::epoll_wait(epollFd_, events, kMaxEvents, -1));
+    for (int i = 0; i < numEvents; i++) {
+      ready.push_back(events[i].data.fd);
+    }
+#else
+    for (auto& pfd : fds_) {
+      pfd.revents = 0;
+    }
+    SYSCHECK_ERR_RETURN_NEG1(::poll(fds_.data(), fds_.size(), -1));
+    for (const auto& pfd : fds_) {
+      if (pfd.revents != 0) {
+        ready.push_back(pfd.fd);
+      }
+    }
+#endif
+    return ready;
+  }
+
+ private:
+#ifdef __linux__
+  int epollFd_;
+#else
+  std::vector<struct pollfd> fds_;
+#endif
+};
+
+// Whether the socket has received bytes that haven't been read yet, i.e. the
+// client has pipelined another query.
+bool hasPendingData(int socket) {
+  uint8_t byte;
+  return ::recv(socket, &byte, 1, MSG_PEEK | MSG_DONTWAIT) > 0;
+}
+
 } // anonymous namespace
 
 // TCPStoreDaemon class methods
@@ -55,58 +154,38 @@ void TCPStoreDaemon::join() {
 }
 
 void TCPStoreDaemon::run() {
-  std::vector<struct pollfd> fds;
-  fds.push_back({.fd = storeListenSocket_, .events = POLLIN});
-  // Push the read end of the pipe to signal the stopping of the daemon run
-  fds.push_back({.fd = controlPipeFd_[0], .events = POLLHUP});
+  Poller poller;
+  poller.add(storeListenSocket_);
+  // Add the read end of the pipe to signal the stopping of the daemon run.
+  // It hangs up once the write end is closed.
+  poller.add(controlPipeFd_[0]);
 
   // receive the queries
-  bool finished = false;
-  while (!finished) {
-    for (size_t i = 0; i < sockets_.size(); i++) {
-      fds[i].revents = 0;
-    }
-
-    SYSCHECK_ERR_RETURN_NEG1(::poll(fds.data(), fds.size(), -1));
-
-    // TCPStore's listening socket has an event and it should now be able to
-    // accept new connections.
-    if (fds[0].revents != 0) {
-      if (fds[0].revents ^ POLLIN) {
-        throw std::system_error(
-            ECONNABORTED,
-            std::system_category(),
-            "Unexpected poll revent on the master's listening socket: " +
-                std::to_string(fds[0].revents));
-      }
-      int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
-      sockets_.push_back(sockFd);
-      fds.push_back({.fd = sockFd, .events = POLLIN});
-    }
+  while (true) {
+    const auto ready = poller.wait();
     // The pipe receives an event which tells us to shutdown the daemon
-    if (fds[1].revents != 0) {
-      // Will be POLLUP when the pipe is closed
-      if (fds[1].revents ^ POLLHUP) {
-        throw std::system_error(
-            ECONNABORTED,
-            std::system_category(),
-            "Unexpected poll revent on the control pipe's reading fd: " +
-                std::to_string(fds[1].revents));
-      }
-      finished = true;
+    if (std::find(ready.begin(), ready.end(), controlPipeFd_[0]) !=
+        ready.end()) {
       break;
     }
-    // Skipping the fds[0] and fds[1],
-    // fds[0] is master's listening socket
-    // fds[1] is control pipe's reading fd
-    for (size_t fdIdx = 2; fdIdx < fds.size(); ++fdIdx) {
-      if (fds[fdIdx].revents == 0) {
+
+    for (int fd : ready) {
+      // TCPStore's listening socket has an event and it should now be able
+      // to accept new connections.
+      if (fd == storeListenSocket_) {
+        int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
+        sockets_.insert(sockFd);
+        poller.add(sockFd);
         continue;
       }
 
-      // Now query the socket that has the event
+      // Now query the socket that has the event. Clients may have sent
+      // several queries without waiting for the responses, so all queries
+      // that have arrived are answered before polling again.
       try {
-        query(fds[fdIdx].fd);
+        do {
+          query(fd);
+        } while (hasPendingData(fd));
       } catch (...) {
         // There was an error when processing query. Probably an exception
         // occurred in recv/send what would indicate that socket on the other
@@ -115,39 +194,33 @@ void TCPStoreDaemon::run() {
         // exception, other connections will get an exception once they try to
         // use the store. We will go ahead and close this connection whenever
         // we hit an exception here.
-        ::close(fds[fdIdx].fd);
-
-        // Remove all the tracking state of the close FD
-        for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
-          for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
-            if (*vecIt == fds[fdIdx].fd) {
-              vecIt = it->second.erase(vecIt);
-            } else {
-              ++vecIt;
-            }
-          }
-          if (it->second.size() == 0) {
-            it = waitingSockets_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        for (auto it = keysAwaited_.begin(); it != keysAwaited_.end();) {
-          if (it->first == fds[fdIdx].fd) {
-            it = keysAwaited_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        fds.erase(fds.begin() + fdIdx);
-        sockets_.erase(sockets_.begin() + fdIdx - 2);
-        --fdIdx;
-        continue;
+        poller.remove(fd);
+        closeSocket(fd);
       }
     }
   }
 }
 
+void TCPStoreDaemon::closeSocket(int socket) {
+  ::close(socket);
+  sockets_.erase(socket);
+
+  // Remove all the tracking state of the closed FD
+  if (keysAwaited_.erase(socket) == 0) {
+    return;
+  }
+  for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
+    auto& sockets = it->second;
+    sockets.erase(
+        std::remove(sockets.begin(), sockets.end(), socket), sockets.end());
+    if (sockets.empty()) {
+      it = waitingSockets_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 void TCPStoreDaemon::stop() {
   if (controlPipeFd_[1] != -1) {
     // close the write end of the pipe
@@ -159,8 +232,11 @@ void TCPStoreDaemon::stop() {
 // query communicates with the worker. The format
 // of the query is as follows:
 // type of query | size of arg1 | arg1 | size of arg2 | arg2 | ...
-// or, in the case of wait
+// or, in the case of check, wait and multi get
 // type of query | number of args | size of arg1 | arg1 | ...
+// or, in the case of multi set
+// type of query | number of keys | size of key1 | key1 | size of value1 |
+// value1 | ...
 void TCPStoreDaemon::query(int socket) {
   QueryType qt;
   tcputil::recvBytes<QueryType>(socket, &qt, 1);
@@ -180,6 +256,15 @@ void TCPStoreDaemon::query(int socket) {
   } else if (qt == QueryType::WAIT) {
     waitHandler(socket);
 
+  } else if (qt == QueryType::MULTI_SET) {
+    multiSetHandler(socket);
+
+  } else if (qt == QueryType::MULTI_GET) {
+    multiGetHandler(socket);
+
+  } else if (qt == QueryType::COMPARE_SET) {
+    compareSetHandler(socket);
+
   } else {
     throw std::runtime_error("Unexpected query type");
   }
@@ -261,6 +346,42 @@ void TCPStoreDaemon::waitHandler(int socket) {
   }
 }
 
+void TCPStoreDaemon::multiSetHandler(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  for (size_t i = 0; i < nargs; i++) {
+    std::string key = tcputil::recvString(socket);
+    tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
+    wakeupWaitingClients(key);
+  }
+}
+
+void TCPStoreDaemon::multiGetHandler(int socket) const {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  for (size_t i = 0; i < nargs; i++) {
+    std::string key = tcputil::recvString(socket);
+    tcputil::sendVector<uint8_t>(socket, tcpStore_.at(key), (i != (nargs - 1)));
+  }
+}
+
+void TCPStoreDaemon::compareSetHandler(int socket) {
+  std::string key = tcputil::recvString(socket);
+  auto expectedValue = tcputil::recvVector<uint8_t>(socket);
+  auto desiredValue = tcputil::recvVector<uint8_t>(socket);
+
+  auto it = tcpStore_.find(key);
+  const bool matches = (it == tcpStore_.end()) ? expectedValue.empty()
+                                               : (it->second == expectedValue);
+  if (matches) {
+    tcpStore_[key] = desiredValue;
+    tcputil::sendVector<uint8_t>(socket, desiredValue);
+    wakeupWaitingClients(key);
+  } else {
+    tcputil::sendVector<uint8_t>(socket, it->second);
+  }
+}
+
 bool TCPStoreDaemon::checkKeys(const std::vector<std::string>& keys) const {
   return std::all_of(keys.begin(), keys.end(), [this](const std::string& s) {
     return tcpStore_.count(s) > 0;
@@ -423,6 +544,59 @@ void TCPStore::waitHelper_(
   }
 }
 
+void TCPStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument(
+        "multiSet requires as many values as keys, got " +
+        std::to_string(keys.size()) + " keys and " +
+        std::to_string(values.size()) + " values");
+  }
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_SET, true);
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, regularPrefix_ + keys[i], true);
+    tcputil::sendVector<uint8_t>(storeSocket_, values[i], (i != (nkeys - 1)));
+  }
+}
+
+std::vector<std::vector<uint8_t>> TCPStore::multiGet(
+    const std::vector<std::string>& keys) {
+  std::vector<std::string> regKeys;
+  regKeys.reserve(keys.size());
+  for (const auto& key : keys) {
+    regKeys.push_back(regularPrefix_ + key);
+  }
+  waitHelper_(regKeys, timeout_);
+
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_GET, true);
+  SizeType nkeys = regKeys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, regKeys[i], (i != (nkeys - 1)));
+  }
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(nkeys);
+  for (size_t i = 0; i < nkeys; i++) {
+    values.push_back(tcputil::recvVector<uint8_t>(storeSocket_));
+  }
+  return values;
+}
+
+std::vector<uint8_t> TCPStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expectedValue,
+    const std::vector<uint8_t>& desiredValue) {
+  std::string regKey = regularPrefix_ + key;
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::COMPARE_SET, true);
+  tcputil::sendString(storeSocket_, regKey, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, expectedValue, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, desiredValue);
+  return tcputil::recvVector<uint8_t>(storeSocket_);
+}
+
 PortType TCPStore::getPort() {
   return tcpStorePort_;
 }
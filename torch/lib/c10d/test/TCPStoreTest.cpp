@@ -116,3 +116,38 @@ TEST(TCPStoreTest, testHelper) {
 TEST(TCPStoreTest, testHelperPrefix) {
   testHelper("testPrefix");
 }
+
+TEST(TCPStoreTest, testMultiSetGetAndCompareSet) {
+  auto serverTCPStore = std::make_shared<c10d::TCPStore>(
+      "127.0.0.1", 0, 2, true, std::chrono::seconds(30), /* wait */ false);
+  auto clientTCPStore = std::make_shared<c10d::TCPStore>(
+      "127.0.0.1",
+      serverTCPStore->getPort(),
+      2,
+      false,
+      std::chrono::seconds(30),
+      /* wait */ false);
+
+  // multiGet waits for keys that another client sets later.
+  auto getter = std::thread([&] {
+    auto values = clientTCPStore->multiGet({"key2", "key0"});
+    ASSERT_EQ(2, values.size());
+    EXPECT_EQ("value2", std::string(values[0].begin(), values[0].end()));
+    EXPECT_EQ("value0", std::string(values[1].begin(), values[1].end()));
+  });
+  std::vector<std::vector<uint8_t>> values;
+  for (const std::string value : {"value0", "value1", "value2"}) {
+    values.emplace_back(value.begin(), value.end());
+  }
+  serverTCPStore->multiSet({"key0", "key1", "key2"}, values);
+  getter.join();
+  c10d::test::check(*clientTCPStore, "key1", "value1");
+
+  const std::vector<uint8_t> empty;
+  const std::vector<uint8_t> first = {'a'};
+  const std::vector<uint8_t> second = {'b'};
+  EXPECT_EQ(first, clientTCPStore->compareSet("cas", empty, first));
+  EXPECT_EQ(first, serverTCPStore->compareSet("cas", empty, second));
+  EXPECT_EQ(second, serverTCPStore->compareSet("cas", first, second));
+  c10d::test::check(*clientTCPStore, "cas", "b");
+}
@@ -0,0 +1,249 @@
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <unistd.h>
+
+#include <TH/TH.h>
+#include <c10/util/Exception.h>
+#include <libshm/libshm.h>
+
+namespace {
+
+// Blocks start at multiples of this, so that their data is aligned like
+// the data of any other allocation.
+constexpr size_t kBlockAlignment = 64;
+
+// The size of the segments that arenas allocate blocks from. Pages of a
+// segment are only backed by memory once they are written to.
+constexpr size_t kSegmentSize = 32 << 20;
+
+// Precedes the data of every block in its segment.
+struct alignas(kBlockAlignment) BlockHeader {
+  // The number of processes and messages that hold the block.
+  std::atomic<int64_t> refcount;
+  uint64_t size;
+};
+static_assert(sizeof(BlockHeader) == kBlockAlignment, "BlockHeader must fill one alignment unit");
+
+size_t round_up(size_t size) {
+  return (size + kBlockAlignment - 1) / kBlockAlignment * kBlockAlignment;
+}
+
+std::string new_segment_handle() {
+  static std::random_device rd;
+  std::string handle = "/torch_";
+  handle += std::to_string(getpid());
+  handle += "_a";
+  handle += std::to_string(rd());
+  return handle;
+}
+
+} // namespace
+
+struct THSharedArenaSegment {
+  THSharedArenaSegment(const char* manager_handle, std::string handle, int flags, size_t size)
+    : mapping(THManagedMapAllocator::makeDataPtr(manager_handle, handle.c_str(), flags, size)),
+      handle(std::move(handle)),
+      size(size),
+      base(static_cast<uint8_t*>(mapping.get())) {}
+
+  BlockHeader* header(size_t offset) const {
+    return reinterpret_cast<BlockHeader*>(base + offset);
+  }
+
+  THManagedMapAllocator* allocator() const {
+    return THManagedMapAllocator::fromDataPtr(mapping);
+  }
+
+  at::DataPtr mapping;
+  std::string handle;
+  size_t size;
+  uint8_t* base;
+};
+
+namespace {
+
+// Allocates the blocks of this process from its current segment, like a ring
+// buffer: blocks are allocated after the newest one, and the space of the
+// oldest ones is reclaimed once they are freed, which suits the FIFO order in
+// which processes usually consume the storages they receive. Once no space is
+// left, a new segment is allocated; the old one stays alive until all of its
+// blocks are freed.
+class Arena {
+public:
+  at::DataPtr allocate(size_t size) {
+    const size_t block_size = round_up(sizeof(BlockHeader) + size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pid_ != getpid()) {
+      // The state was inherited through fork(), and belongs to the parent.
+      segment_.reset();
+      blocks_.clear();
+      head_ = 0;
+      pid_ = getpid();
+    }
+
+    auto segment = segment_.lock();
+    size_t offset = 0;
+    if (!segment || !find_space(*segment, block_size, &offset)) {
+      segment = std::make_shared<THSharedArenaSegment>(
+          "", new_segment_handle(),
+          TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE,
+          kSegmentSize);
+      segment_ = segment;
+      blocks_.clear();
+      offset = 0;
+    }
+
+    BlockHeader* header = new (segment->header(offset)) BlockHeader();
+    header->size = size;
+    blocks_.emplace_back(offset, block_size);
+    head_ = offset + block_size;
+    auto* block = new THSharedArenaBlock(std::move(segment), offset);
+    return {block->data(), block, &deleteBlock, at::DeviceType::CPU};
+  }
+
+  static void deleteBlock(void* ptr) {
+    delete static_cast<THSharedArenaBlock*>(ptr);
+  }
+
+private:
+  // Finds `block_size` bytes of free space in `segment`, after reclaiming the
+  // oldest blocks that are no longer used.
+  bool find_space(const THSharedArenaSegment& segment, size_t block_size, size_t* offset) {
+    while (!blocks_.empty() &&
+           segment.header(blocks_.front().first)->refcount.load(std::memory_order_acquire) == 0) {
+      blocks_.pop_front();
+    }
+    if (blocks_.empty()) {
+      head_ = 0;
+    }
+    const size_t oldest = blocks_.empty() ? 0 : blocks_.front().first;
+    if (blocks_.empty() || head_ > oldest) {
+      // The live blocks are [oldest, head_), so there is space after head_,
+      // and before oldest once the allocation wraps around.
+      if (head_ + block_size <= segment.size) {
+        *offset = head_;
+        return true;
+      }
+      if (block_size <= oldest) {
+        *offset = 0;
+        return true;
+      }
+      return false;
+    }
+    // The allocation wrapped around, so the only space is [head_, oldest).
+    if (head_ + block_size <= oldest) {
+      *offset = head_;
+      return true;
+    }
+    return false;
+  }
+
+  std::mutex mutex_;
+  pid_t pid_ = 0;
+  std::weak_ptr<THSharedArenaSegment> segment_;
+  // The (offset, size) of the blocks allocated from segment_, oldest first.
+  std::deque<std::pair<size_t, size_t>> blocks_;
+  // The end of the newest block.
+  size_t head_ = 0;
+};
+
+Arena arena;
+
+// The segments of other processes that blocks were opened from, so that
+// blocks of the same segment share one mapping.
+std::mutex opened_segments_mutex;
+std::unordered_map<std::string, std::weak_ptr<THSharedArenaSegment>> opened_segments;
+
+} // namespace
+
+constexpr size_t THSharedArenaBlock::kMaxSize;
+
+at::DataPtr THSharedArenaBlock::allocate(size_t size) {
+  if (size == 0 || size > kMaxSize) {
+    return at::DataPtr(nullptr, at::DeviceType::CPU);
+  }
+  return arena.allocate(size);
+}
+
+at::DataPtr THSharedArenaBlock::open(const char* manager_handle, const char* segment_handle, size_t segment_size, size_t offset) {
+  std::shared_ptr<THSharedArenaSegment> segment;
+  {
+    std::lock_guard<std::mutex> lock(opened_segments_mutex);
+    auto& cached = opened_segments[segment_handle];
+    segment = cached.lock();
+    if (!segment) {
+      segment = std::make_shared<THSharedArenaSegment>(
+          manager_handle, segment_handle,
+          TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE,
+          segment_size);
+      cached = segment;
+    }
+    // Drop the entries of segments that were unmapped since.
+    if (opened_segments.size() > 64) {
+      for (auto it = opened_segments.begin(); it != opened_segments.end();) {
+        it = it->second.expired() ? opened_segments.erase(it) : std::next(it);
+      }
+    }
+  }
+  TORCH_CHECK(
+      segment->size == segment_size &&
+          offset % kBlockAlignment == 0 &&
+          offset <= segment_size - sizeof(BlockHeader) &&
+          segment->header(offset)->size <= segment_size - offset - sizeof(BlockHeader),
+      "invalid shared arena block at offset ", offset, " of ", segment_handle);
+  auto* block = new THSharedArenaBlock(std::move(segment), offset);
+  return {block->data(), block, &Arena::deleteBlock, at::DeviceType::CPU};
+}
+
+THSharedArenaBlock* THSharedArenaBlock::fromDataPtr(const at::DataPtr& dptr) {
+  return dptr.cast_context<THSharedArenaBlock>(&Arena::deleteBlock);
+}
+
+THSharedArenaBlock::THSharedArenaBlock(std::shared_ptr<THSharedArenaSegment> segment, size_t offset)
+  : segment_(std::move(segment)), offset_(offset) {
+  segment_->header(offset_)->refcount.fetch_add(1, std::memory_order_relaxed);
+}
+
+THSharedArenaBlock::~THSharedArenaBlock() {
+  // Releases the writes to the block before the arena may reuse it.
+  segment_->header(offset_)->refcount.fetch_sub(1, std::memory_order_release);
+}
+
+void THSharedArenaBlock::incref() {
+  segment_->header(offset_)->refcount.fetch_add(1, std::memory_order_relaxed);
+  segment_->allocator()->incref();
+}
+
+void THSharedArenaBlock::decref() {
+  segment_->allocator()->decref();
+  segment_->header(offset_)->refcount.fetch_sub(1, std::memory_order_release);
+}
+
+void* THSharedArenaBlock::data() const {
+  return segment_->base + offset_ + sizeof(BlockHeader);
+}
+
+size_t THSharedArenaBlock::size() const {
+  return segment_->header(offset_)->size;
+}
+
+size_t THSharedArenaBlock::segment_size() const {
+  return segment_->size;
+}
+
+const char* THSharedArenaBlock::segment_handle() const {
+  return segment_->handle.c_str();
+}
+
+const char* THSharedArenaBlock::manager_handle() const {
+  return segment_->allocator()->manager_handle();
+}
@@ -4,6 +4,9 @@
 
 #ifdef __cplusplus
 
+#include <cstddef>
+#include <memory>
+
 void libshm_init(const char *manager_exec_path);
 
 // Superclass to run a constructor before THRefcountedMapAllocator
@@ -30,4 +33,52 @@ public:
   const char* manager_handle() const { return manager_handle_.c_str(); }
 };
 
+struct THSharedArenaSegment;
+
+// A block of a shared memory arena. Instead of getting a shared memory segment
+// (and a file descriptor) each, small storages that are moved to shared memory
+// are sub-allocated from a large segment that is owned by the process that
+// allocates them. Blocks are handed to other processes by the handle of their
+// segment and their offset in it, so receiving one only maps its segment if
+// no other block of the segment is mapped already.
+//
+// Every block has a refcount in shared memory, which counts the processes
+// (and messages in flight) that hold it, and the space of a block is reused
+// by its arena once the refcount drops to zero. The segments themselves are
+// THManagedMapAllocators, so they are freed even if processes die.
+class THSharedArenaBlock {
+public:
+  // Storages of more than this many bytes are not allocated in an arena.
+  static constexpr size_t kMaxSize = 1 << 20;
+
+  // Returns a block of `size` bytes in the arena of this process, or a null
+  // DataPtr if `size` is 0 or more than kMaxSize.
+  static at::DataPtr allocate(size_t size);
+
+  // Maps the block at `offset` of a segment of `segment_size` bytes, which was
+  // allocated by another process.
+  static at::DataPtr open(const char* manager_handle, const char* segment_handle, size_t segment_size, size_t offset);
+
+  static THSharedArenaBlock* fromDataPtr(const at::DataPtr&);
+
+  THSharedArenaBlock(std::shared_ptr<THSharedArenaSegment> segment, size_t offset);
+  ~THSharedArenaBlock();
+
+  // Keep the block and its segment alive while the block is sent to another
+  // process, like THRefcountedMapAllocator::incref() and decref().
+  void incref();
+  void decref();
+
+  void* data() const;
+  size_t size() const;
+  size_t offset() const { return offset_; }
+  size_t segment_size() const;
+  const char* segment_handle() const;
+  const char* manager_handle() const;
+
+private:
+  std::shared_ptr<THSharedArenaSegment> segment_;
+  size_t offset_;
+};
+
 #endif
@@ -271,6 +271,12 @@ public:
     return _def(std::move(s));
   }
 
+  // Schema strings only have their operator name parsed here; the rest of
+  // the schema is parsed when the operator is first looked up, which keeps
+  // library initialization cheap.  Being a non-template, this overload is
+  // preferred over the one above for string literals.
+  Library& def(const char* raw_schema) &;
+
   // Convenience method to define an operator for a schema and then register
   // an implementation for it.  def(n, f) is almost equivalent to def(n).impl(f),
   // except that if n is not a schema, then the schema is inferred from the
@@ -337,6 +343,7 @@ private:
 
   // Non-user visible actual implementations of functions.  These aren't
   // public because we only implement & qualifier and not && qualifier
+  void _checkDef(const c10::OperatorName& name) const;
   Library& _def(c10::FunctionSchema&& schema, c10::OperatorName* out_name = nullptr) &;
   Library& _def(c10::either<c10::OperatorName, c10::FunctionSchema>&&, CppFunction&& f) &;
   Library& _impl(const char* name, CppFunction&& f) &;
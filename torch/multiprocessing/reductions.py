@@ -300,14 +300,43 @@ def rebuild_storage_filename(cls, manager, handle, size):
     return storage._shared_decref()
 
 
+def rebuild_storage_arena(cls, manager, handle, segment_size, offset, size):
+    storage = storage_from_cache(cls, (handle, offset))
+    if storage is not None:
+        return storage._shared_decref()
+    storage = cls._new_shared_arena(manager, handle, segment_size, offset, size)
+    shared_cache[(handle, offset)] = StorageWeakRef(storage)
+    return storage._shared_decref()
+
+
 def rebuild_storage_empty(cls):
     return cls()
 
 
+def share_storage_in_arena(storage):
+    r"""Moves a small storage that isn't shared yet into the shared memory arena
+    of this process, and returns the handle of its block, or None if the
+    storage can't be shared this way.
+
+    Small storages are sub-allocated from one large shared memory segment per
+    process, so sharing them takes neither a file descriptor nor a segment of
+    their own, whatever the sharing strategy."""
+    if not hasattr(storage, '_share_arena_'):
+        # Arenas aren't supported on this platform.
+        return None
+    return storage._share_arena_()
+
+
 def reduce_storage(storage):
     from . import get_sharing_strategy
     if storage.is_cuda:
         raise RuntimeError("Cannot pickle CUDA storage; try pickling a CUDA tensor instead")
+    arena_metadata = share_storage_in_arena(storage)
+    if arena_metadata is not None:
+        metadata = arena_metadata
+        cache_key = (metadata[1], metadata[3])
+        rebuild = rebuild_storage_arena
+        storage._shared_incref()
     elif get_sharing_strategy() == 'file_system':
         metadata = storage._share_filename_()
         cache_key = metadata[1]
@@ -173,6 +173,45 @@ class Embedding(Module):
         return embedding
 
 
+class _EmbeddingBagFusedUpdate(torch.autograd.Function):
+    r"""embedding_bag whose backward applies the optimizer to the rows of the
+    weight with ``torch._embedding_bag_fused_update_``, instead of returning
+    the gradient of the weight.
+    """
+
+    @staticmethod
+    def forward(ctx, weight, optimizer_state, input, offsets, per_sample_weights,
+                scale_grad_by_freq, mode, include_last_offset, optimizer, lr, eps):
+        output, offset2bag, bag_size, _ = torch.embedding_bag(
+            weight, input, offsets, scale_grad_by_freq, mode, False,
+            per_sample_weights, include_last_offset)
+        ctx.save_for_backward(weight, optimizer_state, input, offsets, offset2bag,
+                              bag_size, per_sample_weights)
+        ctx.scale_grad_by_freq = scale_grad_by_freq
+        ctx.mode = mode
+        ctx.optimizer = optimizer
+        ctx.lr = lr
+        ctx.eps = eps
+        return output
+
+    @staticmethod
+    def backward(ctx, grad):
+        weight, optimizer_state, input, offsets, offset2bag, bag_size, per_sample_weights = \
+            ctx.saved_tensors
+        grad_per_sample_weights = None
+        if ctx.needs_input_grad[4]:
+            # needs the weight from before the update
+            grad_per_sample_weights = torch._embedding_bag_per_sample_weights_backward(
+                grad, weight, input, offsets, offset2bag, ctx.mode)
+        with torch.no_grad():
+            torch._embedding_bag_fused_update_(
+                weight, optimizer_state, grad, input, offsets, offset2bag, bag_size,
+                ctx.scale_grad_by_freq, ctx.mode, per_sample_weights, ctx.optimizer,
+                ctx.lr, ctx.eps)
+        return (None, None, None, None, grad_per_sample_weights,
+                None, None, None, None, None, None)
+
+
 class EmbeddingBag(Module):
     r"""Computes sums or means of 'bags' of embeddings, without instantiating the
     intermediate embeddings.
@@ -212,10 +251,20 @@ class EmbeddingBag(Module):
         include_last_offset (bool, optional): if ``True``, :attr:`offsets` has one additional element, where the last element
                                       is equivalent to the size of `indices`. This matches the CSR format. Note:
                                       this option is currently only supported when ``mode="sum"``.
+        fused_optimizer (string, optional): ``"sgd"``, ``"adagrad"`` or ``"rowwise_adagrad"``. If given, the
+                                 backward pass applies this optimizer to the rows of :attr:`weight` that are
+                                 used by the mini-batch, instead of computing the gradient of :attr:`weight`,
+                                 which is left as ``None``. See Notes for more details. Default: ``None``
+        fused_lr (float, optional): the learning rate of :attr:`fused_optimizer`. Default: ``0.01``
+        fused_eps (float, optional): the term added to the denominator of ``"adagrad"`` and
+                                 ``"rowwise_adagrad"`` to improve numerical stability. Default: ``1e-10``
 
     Attributes:
         weight (Tensor): the learnable weights of the module of shape `(num_embeddings, embedding_dim)`
                          initialized from :math:`\mathcal{N}(0, 1)`.
+        optimizer_state (Tensor): only with :attr:`fused_optimizer`, the sums of the squared gradients of
+                         ``"adagrad"``, of the same shape as :attr:`weight`, or of their means over each row
+                         of ``"rowwise_adagrad"``, of shape `(num_embeddings,)`.
 
     Inputs: :attr:`input` (LongTensor), :attr:`offsets` (LongTensor, optional), and
         :attr:`per_index_weights` (Tensor, optional)
@@ -253,13 +302,30 @@ class EmbeddingBag(Module):
         >>> embedding_sum(input, offsets)
         tensor([[-0.8861, -5.4350, -0.0523],
                 [ 1.1306, -2.5798, -1.0044]])
+
+    .. note::
+        With :attr:`fused_optimizer`, the update of the rows of :attr:`weight`
+        is applied right after the gradients of the indices that point to the
+        same row are summed, so the (possibly huge) gradient of :attr:`weight`
+        is never materialized, neither dense nor sparse. On CUDA the update is
+        fused into the backward kernel. The update of a row is
+
+        * ``"sgd"``: :math:`w = w - \text{lr} \cdot g`,
+        * ``"adagrad"``: :math:`s = s + g^2`, :math:`w = w - \text{lr} \cdot g / (\sqrt{s} + \epsilon)`,
+        * ``"rowwise_adagrad"``: :math:`s = s + \text{mean}(g^2)`, :math:`w = w - \text{lr} \cdot g / (\sqrt{s} + \epsilon)`,
+
+        where :math:`g` is the gradient of the row and :math:`s` its state in
+        :attr:`optimizer_state`. Only ``mode="sum"`` and ``mode="mean"`` are
+        supported, and the weight must not be passed to another optimizer.
     """
     __constants__ = ['num_embeddings', 'embedding_dim', 'max_norm', 'norm_type',
-                     'scale_grad_by_freq', 'mode', 'sparse', 'include_last_offset']
+                     'scale_grad_by_freq', 'mode', 'sparse', 'include_last_offset',
+                     'fused_optimizer']
 
     def __init__(self, num_embeddings, embedding_dim,
                  max_norm=None, norm_type=2., scale_grad_by_freq=False,
-                 mode='mean', sparse=False, _weight=None, include_last_offset=False):
+                 mode='mean', sparse=False, _weight=None, include_last_offset=False,
+                 fused_optimizer=None, fused_lr=0.01, fused_eps=1e-10):
         super(EmbeddingBag, self).__init__()
         self.num_embeddings = num_embeddings
         self.embedding_dim = embedding_dim
@@ -276,17 +342,63 @@ class EmbeddingBag(Module):
         self.mode = mode
         self.sparse = sparse
         self.include_last_offset = include_last_offset
+        self.fused_optimizer = fused_optimizer
+        if fused_optimizer is not None:
+            if fused_optimizer not in ('sgd', 'adagrad', 'rowwise_adagrad'):
+                raise ValueError("fused_optimizer has to be one of sgd, adagrad or rowwise_adagrad")
+            if mode == 'max' or sparse:
+                raise ValueError("fused_optimizer does not support mode='max' or sparse=True")
+            self.fused_lr = fused_lr
+            self.fused_eps = fused_eps
+            state_dtype = torch.float if self.weight.dtype == torch.half else self.weight.dtype
+            if fused_optimizer == 'adagrad':
+                state_size = [num_embeddings, embedding_dim]
+            elif fused_optimizer == 'rowwise_adagrad':
+                state_size = [num_embeddings]
+            else:
+                state_size = [0]
+            self.register_buffer('optimizer_state', torch.zeros(
+                state_size, dtype=state_dtype, device=self.weight.device))
 
     def reset_parameters(self):
         init.normal_(self.weight)
 
     def forward(self, input, offsets=None, per_sample_weights=None):
         # type: (Tensor, Optional[Tensor], Optional[Tensor]) -> Tensor
+        if self.fused_optimizer is not None:
+            return self._fused_forward(input, offsets, per_sample_weights)
         return F.embedding_bag(input, self.weight, offsets,
                                self.max_norm, self.norm_type,
                                self.scale_grad_by_freq, self.mode, self.sparse,
                                per_sample_weights, self.include_last_offset)
 
+    @torch.jit.unused
+    def _fused_forward(self, input, offsets, per_sample_weights):
+        # type: (Tensor, Optional[Tensor], Optional[Tensor]) -> Tensor
+        if per_sample_weights is not None and input.size() != per_sample_weights.size():
+            raise ValueError("embedding_bag: If per_sample_weights ({}) is not None, "
+                             "then it must have the same shape as the input ({})"
+                             .format(per_sample_weights.shape, input.shape))
+        if input.dim() == 2:
+            if offsets is not None:
+                raise ValueError("if input is 2D, then offsets has to be None")
+            offsets = torch.arange(0, input.numel(), input.size(1),
+                                   dtype=torch.long, device=input.device)
+            input = input.reshape(-1)
+            if per_sample_weights is not None:
+                per_sample_weights = per_sample_weights.reshape(-1)
+        elif input.dim() != 1 or offsets is None or offsets.dim() != 1:
+            raise ValueError("input has to be 2D, or 1D with 1D offsets")
+        if per_sample_weights is not None and self.mode != 'sum':
+            raise NotImplementedError("embedding_bag: per_sample_weights is only "
+                                      "supported for mode='sum'")
+        if self.max_norm is not None:
+            F._no_grad_embedding_renorm_(self.weight, input, self.max_norm, self.norm_type)
+        return _EmbeddingBagFusedUpdate.apply(
+            self.weight, self.optimizer_state, input.contiguous(), offsets.contiguous(),
+            per_sample_weights, self.scale_grad_by_freq, 0 if self.mode == 'sum' else 1,
+            self.include_last_offset, self.fused_optimizer, self.fused_lr, self.fused_eps)
+
     def extra_repr(self):
         s = '{num_embeddings}, {embedding_dim}'
         if self.max_norm is not None:
@@ -296,6 +408,8 @@ class EmbeddingBag(Module):
         if self.scale_grad_by_freq is not False:
             s += ', scale_grad_by_freq={scale_grad_by_freq}'
         s += ', mode={mode}'
+        if self.fused_optimizer is not None:
+            s += ', fused_optimizer={fused_optimizer}, fused_lr={fused_lr}'
         return s.format(**self.__dict__)
 
     @classmethod
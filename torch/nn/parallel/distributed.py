@@ -30,6 +30,28 @@ def _find_tensors(obj):
     return []
 
 
+class _ExecutedModules(object):
+    r"""
+    The indices of the submodules called since the last ``clear()``, recorded
+    by forward pre hooks.
+    """
+    def __init__(self):
+        self.indices = set()
+
+    def clear(self):
+        self.indices = set()
+
+
+class _RecordExecutedModule(object):
+    # A class rather than a closure so that the module can still be pickled.
+    def __init__(self, executed_modules, index):
+        self.executed_modules = executed_modules
+        self.index = index
+
+    def __call__(self, module, inputs):
+        self.executed_modules.indices.add(self.index)
+
+
 class DistributedDataParallel(Module):
     r"""Implements distributed data parallelism that is based on
     ``torch.distributed`` package at the module level.
@@ -190,6 +212,16 @@ class DistributedDataParallel(Module):
                                        module parameters that are otherwise unused can
                                        be detached from the autograd graph using
                                        ``torch.Tensor.detach``. (default: ``False``)
+        cache_unused_parameters (bool): With ``find_unused_parameters``, only
+                                        traverse the autograd graph the first
+                                        time a given set of submodules is called
+                                        by ``forward``, and reuse the parameters
+                                        found unused then whenever the same set
+                                        is called again. Only valid if which
+                                        parameters are used only depends on
+                                        which submodules are called, e.g. when
+                                        ``forward`` skips or picks whole
+                                        submodules. (default: ``False``)
         check_reduction: when setting to ``True``, it enables DistributedDataParallel
                          to automatically check if the previous iteration's
                          backward reductions were successfully issued at the
@@ -212,7 +244,8 @@ class DistributedDataParallel(Module):
                  output_device=None, dim=0, broadcast_buffers=True,
                  process_group=None, bucket_cap_mb=25,
                  find_unused_parameters=False,
-                 check_reduction=False):
+                 check_reduction=False,
+                 cache_unused_parameters=False):
 
         super(DistributedDataParallel, self).__init__()
 
@@ -260,6 +293,7 @@ class DistributedDataParallel(Module):
         self.module = module
         self.broadcast_buffers = broadcast_buffers
         self.find_unused_parameters = find_unused_parameters
+        self.cache_unused_parameters = cache_unused_parameters
         self.require_backward_grad_sync = True
         self.require_forward_param_sync = True
 
@@ -277,6 +311,17 @@ class DistributedDataParallel(Module):
         # reduction bucket size
         self.bucket_bytes_cap = int(bucket_cap_mb * MB)
 
+        # Maps each set of submodules called by forward to the key the reducer
+        # caches its unused parameters under. The hooks are registered before
+        # the module is replicated, so that the replicas share them.
+        self._executed_modules = None
+        self._unused_parameters_graph_keys = {}
+        if find_unused_parameters and cache_unused_parameters:
+            self._executed_modules = _ExecutedModules()
+            for index, submodule in enumerate(self.module.modules()):
+                submodule.register_forward_pre_hook(
+                    _RecordExecutedModule(self._executed_modules, index))
+
         # Sync params and buffers
         module_states = list(self.module.state_dict().values())
         if len(module_states) > 0:
@@ -378,19 +423,23 @@ class DistributedDataParallel(Module):
         # that are defined first, such that their gradients don't spill into
         # a much larger bucket, adding unnecessary latency after gradient
         # computation finishes. Experiments showed 1MB is a reasonable value.
+        bucket_size_limits = [1024 * 1024, self.bucket_bytes_cap]
         bucket_indices = dist._compute_bucket_assignment_by_size(
             parameters[0],
-            [1024 * 1024, self.bucket_bytes_cap],
+            bucket_size_limits,
             expect_sparse_gradient[0])
 
         # Note: reverse list of buckets because we want to approximate the
         # order in which their gradients are produced, and assume they
         # are used in the forward pass in the order they are defined.
+        # The reducer rebuilds the buckets in the order it actually observes
+        # in the first backward pass, see forward().
         self.reducer = dist.Reducer(
             parameters,
             list(reversed(bucket_indices)),
             self.process_group,
-            expect_sparse_gradient)
+            expect_sparse_gradient,
+            bucket_size_limits)
 
         # passing a handle to torch.nn.SyncBatchNorm layer
         self._passing_sync_batchnorm_handle(self._module_copies)
@@ -408,6 +457,9 @@ class DistributedDataParallel(Module):
         super(DistributedDataParallel, self).__setstate__(state)
         self.__dict__.setdefault('require_forward_param_sync', True)
         self.__dict__.setdefault('require_backward_grad_sync', True)
+        self.__dict__.setdefault('cache_unused_parameters', False)
+        self.__dict__.setdefault('_executed_modules', None)
+        self.__dict__.setdefault('_unused_parameters_graph_keys', {})
         self._ddp_init_helper()
 
     def _check_default_group(self):
@@ -448,10 +500,39 @@ class DistributedDataParallel(Module):
         finally:
             self.require_backward_grad_sync = old_require_backward_grad_sync
 
+    def register_comm_hook(self, hook):
+        r"""
+        Makes the gradient buckets be reduced by ``hook``, a
+        :class:`torch.distributed.CommHook`, instead of being allreduced as
+        they are, e.g. to compress them when communication is the bottleneck.
+        Must be called before the first backward pass, at most once.
+
+        The built-in hooks are :class:`torch.distributed.FP16CompressHook`,
+        :class:`torch.distributed.PowerSGDHook` and
+        :class:`torch.distributed.TopKSparsifyHook`. The last two keep the
+        error of their compression and add it to the gradients of the next
+        iteration, and only support one device per process. Buckets of sparse
+        gradients are always allreduced.
+
+        Example::
+
+            >>> ddp = torch.nn.DistributedDataParallel(model, pg)
+            >>> ddp.register_comm_hook(dist.PowerSGDHook(pg, matrix_approximation_rank=4))
+        """
+        self.reducer.register_comm_hook(hook)
+
     def forward(self, *inputs, **kwargs):
+        # After the first backward pass, the reducer knows the order in which
+        # gradients become ready, and reassigns the buckets in that order once.
+        if torch.is_grad_enabled():
+            self.reducer._rebuild_buckets()
+
         if self.require_forward_param_sync:
             self._sync_params()
 
+        if self._executed_modules is not None:
+            self._executed_modules.clear()
+
         if self.device_ids:
             inputs, kwargs = self.scatter(inputs, kwargs, self.device_ids)
             if len(self.device_ids) == 1:
@@ -470,7 +551,13 @@ class DistributedDataParallel(Module):
             # this forward pass, to ensure we short circuit reduction for any
             # unused parameters. Only if `find_unused_parameters` is set.
             if self.find_unused_parameters:
-                self.reducer.prepare_for_backward(list(_find_tensors(output)))
+                graph_key = -1
+                if self._executed_modules is not None:
+                    graph_key = self._unused_parameters_graph_keys.setdefault(
+                        frozenset(self._executed_modules.indices),
+                        len(self._unused_parameters_graph_keys))
+                self.reducer.prepare_for_backward(
+                    list(_find_tensors(output)), graph_key)
             else:
                 self.reducer.prepare_for_backward([])
         else:
@@ -20,7 +20,8 @@ class DistributedDataParallel(Module[T_co]):
     def __init__(self, module: Module[T_co], device_ids: Optional[_devices_t] = ...,
                  output_device: Optional[_device_t] = ..., dim: int = ...,
                  broadcast_buffers: bool = ..., process_group: Optional[Any] = ..., bucket_cap_mb: float = ...,
-                 check_reduction: bool = ...) -> None: ...
+                 find_unused_parameters: bool = ..., check_reduction: bool = ...,
+                 cache_unused_parameters: bool = ...) -> None: ...
 
     def forward(self, *inputs: Any, **kwargs: Any) -> T_co: ...
 
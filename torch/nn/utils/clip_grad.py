@@ -30,8 +30,7 @@ def clip_grad_norm_(parameters, max_norm, norm_type=2):
         total_norm = torch.norm(torch.stack([torch.norm(p.grad.detach(), norm_type) for p in parameters]), norm_type)
     clip_coef = max_norm / (total_norm + 1e-6)
     if clip_coef < 1:
-        for p in parameters:
-            p.grad.detach().mul_(clip_coef)
+        torch._foreach_mul_([p.grad.detach() for p in parameters], clip_coef.item())
     return total_norm
 
 
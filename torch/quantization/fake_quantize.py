@@ -57,6 +57,14 @@ class FakeQuantize(Module):
         self.dtype = self.activation_post_process.dtype
         self.qscheme = self.activation_post_process.qscheme
         self.ch_axis = self.activation_post_process.ch_axis if hasattr(self.activation_post_process, 'ch_axis') else None
+        # Per tensor moving average observers run fused with the
+        # fake-quantization, see torch._fused_moving_avg_obs_fake_quant. It
+        # computes the quantization parameters for [quant_min, quant_max], so
+        # these have to be the range of the dtype, as in the observer.
+        self._fused_observer = (
+            type(self.activation_post_process) == MovingAverageMinMaxObserver and
+            self.qscheme in (torch.per_tensor_affine, torch.per_tensor_symmetric) and
+            quant_min == torch.iinfo(self.dtype).min and quant_max == torch.iinfo(self.dtype).max)
 
     def enable_fake_quant(self, enabled=True):
         self.fake_quant_enabled = enabled
@@ -76,6 +84,14 @@ class FakeQuantize(Module):
         return self.activation_post_process.calculate_qparams()
 
     def forward(self, X):
+        if self._fused_observer and self.fake_quant_enabled and X.dtype == torch.float:
+            observer = self.activation_post_process
+            return torch._fused_moving_avg_obs_fake_quant(
+                X, observer.min_val, observer.max_val, self.scale, self.zero_point,
+                observer.averaging_constant, self.quant_min, self.quant_max,
+                self.observer_enabled, self.qscheme == torch.per_tensor_symmetric,
+                observer.reduce_range)
+
         if self.observer_enabled:
             self.activation_post_process(X.detach())
             _scale, _zero_point = self.calculate_qparams()
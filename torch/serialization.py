@@ -242,8 +242,8 @@ class _open_zipfile_reader(_opener):
 
 
 class _open_zipfile_writer_file(_opener):
-    def __init__(self, name):
-        super(_open_zipfile_writer_file, self).__init__(torch._C.PyTorchFileWriter(name))
+    def __init__(self, name, num_write_threads=1):
+        super(_open_zipfile_writer_file, self).__init__(torch._C.PyTorchFileWriter(name, num_write_threads))
 
     def __exit__(self, *args):
         self.file_like.write_end_of_file()
@@ -259,12 +259,11 @@ class _open_zipfile_writer_buffer(_opener):
         self.buffer.flush()
 
 
-def _open_zipfile_writer(name_or_buffer):
+def _open_zipfile_writer(name_or_buffer, num_write_threads=1):
     if _is_path(name_or_buffer):
-        container = _open_zipfile_writer_file
+        return _open_zipfile_writer_file(name_or_buffer, num_write_threads)
     else:
-        container = _open_zipfile_writer_buffer
-    return container(name_or_buffer)
+        return _open_zipfile_writer_buffer(name_or_buffer)
 
 
 def _is_compressed_file(f):
@@ -327,7 +326,8 @@ def _check_dill_version(pickle_module):
                 pickle_module.__version__
             ))
 
-def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL, _use_new_zipfile_serialization=False):
+def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL, _use_new_zipfile_serialization=False,
+         _num_write_threads=1):
     """Saves an object to a disk file.
 
     See also: :ref:`recommend-saving-models`
@@ -357,7 +357,7 @@ def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL, _use_ne
     _check_dill_version(pickle_module)
 
     if _use_new_zipfile_serialization:
-        with _open_zipfile_writer(f) as opened_file:
+        with _open_zipfile_writer(f, _num_write_threads) as opened_file:
             _save(obj, opened_file, pickle_module, pickle_protocol)
             return
 
@@ -466,21 +466,35 @@ def _save(obj, zip_file, pickle_module, pickle_protocol):
     data_value = data_buf.getvalue()
     zip_file.write_record('data.pkl', data_value, len(data_value))
 
-    # Write each tensor to a file named tensor/the_tensor_key in the zip archive
-    for key in sorted(serialized_storages.keys()):
-        name = 'data/{}'.format(key)
-        storage = serialized_storages[key]
-        if storage.device.type == 'cpu':
-            # If it's on the CPU we can directly copy it into the zip file
-            num_bytes = storage.size() * storage.element_size()
-            buf = io.BytesIO()
-            zip_file.write_record(name, storage.data_ptr(), num_bytes)
-        else:
-            # Copy to a buffer, then serialize that
-            buf = io.BytesIO()
-            storage._write_file(buf, _should_read_directly(buf))
-            buf_value = buf.getvalue()
-            zip_file.write_record(name, buf_value, len(buf_value))
+    # Write each tensor to a file named tensor/the_tensor_key in the zip archive.
+    # Storages on the CPU are written directly from their memory. CUDA storages
+    # are copied to pinned memory, the next one while one is being written.
+    keys = sorted(serialized_storages.keys())
+    staged = _stage_storage(serialized_storages[keys[0]]) if keys else None
+    for i, key in enumerate(keys):
+        storage, copied = staged
+        if i + 1 < len(keys):
+            staged = _stage_storage(serialized_storages[keys[i + 1]])
+        if copied is not None:
+            copied.synchronize()
+        num_bytes = storage.size() * storage.element_size()
+        zip_file.write_record('data/{}'.format(key), storage.data_ptr(), num_bytes)
+
+
+def _stage_storage(storage):
+    # Returns a CPU storage with the data of STORAGE, and the event to wait for
+    # before reading it if it's still being copied.
+    if storage.device.type == 'cpu':
+        return storage, None
+    if storage.device.type != 'cuda':
+        return storage.cpu(), None
+    with torch.cuda.device(storage.device):
+        cpu_type = getattr(torch, type(storage).__name__)
+        staged = cpu_type(storage.size(), allocator=torch.cuda._host_allocator())
+        staged.copy_(storage, non_blocking=True)
+        copied = torch.cuda.Event()
+        copied.record()
+    return staged, copied
 
 
 def load(f, map_location=None, pickle_module=pickle, **pickle_load_args):
@@ -122,6 +122,8 @@ class _StorageBase(object):
         from torch.multiprocessing import get_sharing_strategy
         if self.is_cuda:
             pass  # CUDA doesn't use POSIX shared memory
+        elif self.is_shared():
+            pass  # e.g. a storage that was received in a shared memory arena
         elif get_sharing_strategy() == 'file_system':
             self._share_filename_()
         else:
@@ -134,7 +136,13 @@ class _StorageBase(object):
         from torch.multiprocessing import get_sharing_strategy
         if cls.is_cuda:
             return cls(size)
-        elif get_sharing_strategy() == 'file_system':
+        if hasattr(cls, '_new_using_arena'):
+            # Small storages are allocated in the shared memory arena of this
+            # process, see torch.multiprocessing.reductions.share_storage_in_arena.
+            storage = cls._new_using_arena(size)
+            if storage is not None:
+                return storage
+        if get_sharing_strategy() == 'file_system':
             return cls._new_using_filename(size)
         else:
             return cls._new_using_fd(size)
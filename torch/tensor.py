@@ -223,6 +223,48 @@ class Tensor(torch._C._TensorBase):
         self._backward_hooks[handle.id] = hook
         return handle
 
+    def register_post_accumulate_grad_hook(self, hook):
+        r"""Registers a hook that runs once the gradient of this leaf Tensor
+        has been accumulated into :attr:`grad`.
+
+        The hook is called with the Tensor itself, whose :attr:`grad` holds the
+        accumulated gradient, and should have the following signature::
+
+            hook(tensor) -> None
+
+        Since gradient accumulation happens as soon as the gradient of a leaf
+        is computed, the hook can e.g. apply an optimizer step for the Tensor
+        and free its gradient while the rest of the backward pass runs, which
+        reduces peak memory by the size of the gradients.
+
+        This function returns a handle with a method ``handle.remove()``
+        that removes the hook.
+
+        Example::
+
+            >>> w = torch.ones(3, requires_grad=True)
+            >>> def sgd_step(p):
+            ...     with torch.no_grad():
+            ...         p.add_(p.grad, alpha=-0.1)
+            ...     p.grad = None
+            >>> h = w.register_post_accumulate_grad_hook(sgd_step)
+            >>> (2 * w).sum().backward()
+            >>> w
+            tensor([0.8000, 0.8000, 0.8000], requires_grad=True)
+            >>> h.remove()
+        """
+        if not self.requires_grad:
+            raise RuntimeError("cannot register a hook on a tensor that "
+                               "doesn't require gradient")
+        if self.grad_fn is not None:
+            raise RuntimeError("post accumulate grad hooks can only be "
+                               "registered on leaf tensors")
+        if self._post_accumulate_grad_hooks is None:
+            self._post_accumulate_grad_hooks = OrderedDict()
+        handle = hooks.RemovableHandle(self._post_accumulate_grad_hooks)
+        self._post_accumulate_grad_hooks[handle.id] = hook
+        return handle
+
     def reinforce(self, reward):
         def trim(str):
             return '\n'.join([line.strip() for line in str.split('\n')])
@@ -194,6 +194,10 @@ def my_rref_function(rref_a, rref_b):
     return rref_a.to_here() + rref_b.to_here()
 
 
+def sum_rrefs(rrefs):
+    return sum(rref.to_here() for rref in rrefs)
+
+
 def delayed_add(a, b, seconds=0.05):
     time.sleep(seconds)
     return a + b
@@ -1378,6 +1382,26 @@ class RpcTest(RpcAgentTestFixture):
         )
         self.assertEqual(rref.to_here(), torch.ones(2, 2) + 1)
 
+    @dist_init
+    def test_many_rref_forks_and_deletes(self):
+        # Forks and deletes of many RRefs to the same owner are batched, see
+        # Note [RRef Message Batching].
+        owner = worker_name((self.rank + 1) % self.world_size)
+        user = worker_name((self.rank + 2) % self.world_size)
+        rrefs = [
+            rpc.remote(owner, torch.add, args=(torch.ones(2, 2), i))
+            for i in range(50)
+        ]
+        # Forks every RRef to the user, whose children are confirmed by the
+        # owner and accepted by this worker.
+        ret = rpc.rpc_sync(user, sum_rrefs, args=(rrefs,))
+        self.assertEqual(
+            ret, sum(torch.ones(2, 2) + i for i in range(len(rrefs))))
+
+        del rrefs
+        # The OwnerRRefs of all workers are deleted on graceful shutdown, which
+        # rpc.shutdown() in dist_init checks for leaks.
+
     @dist_init
     def test_rref_forward_chain(self):
         ttl = 8
@@ -2043,6 +2067,47 @@ class RpcTest(RpcAgentTestFixture):
         self.assertEqual(int(info["agent.thread_pool_size"]), NUM_THREADS)
         rpc.shutdown()
 
+    @dist_init(setup_rpc=False)
+    @requires_process_group_agent("PROCESS_GROUP rpc backend specific test, skip")
+    def test_process_group_max_queued_recvs(self):
+        rpc_backend_options = rpc.ProcessGroupRpcBackendOptions(
+            init_method=self.rpc_backend_options.init_method,
+            num_send_recv_threads=1,
+            num_control_threads=2,
+            max_queued_recvs=1,
+        )
+        self.assertEqual(rpc_backend_options.num_control_threads, 2)
+        self.assertEqual(rpc_backend_options.max_queued_recvs, 1)
+        rpc.init_rpc(
+            name=worker_name(self.rank),
+            backend=self.rpc_backend,
+            rank=self.rank,
+            world_size=self.world_size,
+            rpc_backend_options=rpc_backend_options,
+        )
+
+        info = rpc.api._get_current_rpc_agent().get_debug_info()
+        self.assertEqual(int(info["agent.control_thread_pool_size"]), 2)
+
+        # The single thread of every worker is busy with the first request,
+        # and only one more request can wait for it.
+        dst = worker_name((self.rank + 1) % self.world_size)
+        futs = [
+            rpc.rpc_async(dst, my_sleep_func, args=(0.5,)) for _ in range(10)
+        ]
+        num_rejected = 0
+        for fut in futs:
+            try:
+                fut.wait()
+            except RuntimeError as e:
+                self.assertIn("RPC request rejected", str(e))
+                num_rejected += 1
+        self.assertGreater(num_rejected, 0)
+        self.assertLess(num_rejected, len(futs))
+
+        # shutdown() still sees every rejected request as processed.
+        rpc.shutdown()
+
     @dist_init(setup_rpc=False)
     @requires_process_group_agent("PROCESS_GROUP rpc backend specific test, skip")
     def test_process_group_set_default_timeout(self):
@@ -0,0 +1,46 @@
+import ctypes
+
+import torch
+
+
+def _from_arrow_array(array):
+    # Room for the ArrowArray (10 words) and ArrowSchema (9 words) structs of
+    # the Arrow C data interface
+    c_array = (ctypes.c_int64 * 10)()
+    c_schema = (ctypes.c_int64 * 9)()
+    array._export_to_c(ctypes.addressof(c_array), ctypes.addressof(c_schema))
+    return torch._C._from_arrow(ctypes.addressof(c_array), ctypes.addressof(c_schema))
+
+
+def from_arrow(data):
+    r"""from_arrow(data) -> Tensor or dict
+
+    Converts Arrow data to tensors without copying.
+
+    A pyarrow ``Array``, or a ``ChunkedArray`` with a single chunk, becomes a
+    1-D CPU tensor that shares its memory and keeps it alive. A
+    ``RecordBatch`` becomes a dict from column names to such tensors.
+
+    Only arrays without nulls of the types int8, uint8, int16, int32, int64,
+    float16, float32 and float64 are supported.
+
+    Args:
+        data: a pyarrow ``Array``, ``ChunkedArray`` or ``RecordBatch``
+    """
+    if hasattr(data, 'num_chunks'):
+        if data.num_chunks != 1:
+            raise ValueError("from_arrow: expected a ChunkedArray with a single chunk, "
+                             "but got {} chunks".format(data.num_chunks))
+        data = data.chunk(0)
+    if hasattr(data, 'schema') and hasattr(data, 'columns'):
+        return {name: _from_arrow_array(column)
+                for name, column in zip(data.schema.names, data.columns)}
+    return _from_arrow_array(data)
+
+
+def is_arrow_data(data):
+    r"""Returns whether data is an array or record batch that
+    :func:`from_arrow` can convert, without importing pyarrow."""
+    data_type = type(data)
+    return data_type.__module__ == 'pyarrow.lib' and \
+        (data_type.__name__.endswith('Array') or data_type.__name__ == 'RecordBatch')
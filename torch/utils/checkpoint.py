@@ -102,6 +102,81 @@ class CheckpointFunction(torch.autograd.Function):
         return (None, None) + grads
 
 
+def _checkpoint_without_reentrant(function, preserve_rng_state=True, *args):
+    """Checkpointing without re-entrant autograd
+
+    Instead of running :attr:`function` under :func:`torch.no_grad`, this runs
+    it with saved tensor hooks that drop every tensor the forward saves for
+    backward and keep only its position. When backward first needs one of
+    them, :attr:`function` is run again on the original inputs, with hooks that
+    collect the tensors it saves, and backward carries on with those. No
+    nested backward call is made, so the recomputed part of the graph is
+    differentiated by the same engine invocation as the rest, and
+    :func:`torch.autograd.grad` as well as hooks on parameters, like those of
+    DistributedDataParallel, work as without checkpointing.
+    """
+    had_autocast_in_fwd = torch.is_autocast_enabled()
+
+    if preserve_rng_state:
+        fwd_cpu_state = torch.get_rng_state()
+        # Don't eagerly initialize the cuda context by accident, see
+        # CheckpointFunction.forward.
+        had_cuda_in_fwd = False
+        if torch.cuda._initialized:
+            had_cuda_in_fwd = True
+            fwd_gpu_devices, fwd_gpu_states = get_device_states(*args)
+
+    # Tensors saved by the recomputation, by position in the order in which
+    # the forward saved them.
+    storage = {}
+    counter = [0]
+
+    def pack(x):
+        # The original tensor is released; the position is enough to find
+        # the recomputed one.
+        idx = counter[0]
+        counter[0] += 1
+        return idx
+
+    def unpack(idx):
+        if idx not in storage:
+            inner_counter = [0]
+
+            def inner_pack(inner):
+                storage[inner_counter[0]] = inner
+                inner_counter[0] += 1
+                return None
+
+            def inner_unpack(packed):
+                raise RuntimeError("You are calling backwards on a tensor that is never exposed. Please open an issue.")
+
+            rng_devices = []
+            if preserve_rng_state and had_cuda_in_fwd:
+                rng_devices = fwd_gpu_devices
+            with torch.random.fork_rng(devices=rng_devices, enabled=preserve_rng_state):
+                if preserve_rng_state:
+                    torch.set_rng_state(fwd_cpu_state)
+                    if had_cuda_in_fwd:
+                        set_device_states(fwd_gpu_devices, fwd_gpu_states)
+                with torch.enable_grad(), torch.cuda.amp.autocast(had_autocast_in_fwd), \
+                        torch.autograd.graph.saved_tensors_hooks(inner_pack, inner_unpack):
+                    function(*args)
+
+            if idx not in storage:
+                raise RuntimeError(
+                    "The recomputation of a checkpointed function saved fewer tensors for backward than "
+                    "its forward did, which means that it is not deterministic.")
+        # Every saved tensor is unpacked once per backward; dropping it here
+        # frees the recomputed activations as backward goes by. A second
+        # backward with retain_graph=True recomputes them again.
+        return storage.pop(idx)
+
+    with torch.autograd.graph.saved_tensors_hooks(pack, unpack):
+        output = function(*args)
+
+    return output
+
+
 def checkpoint(function, *args, **kwargs):
     r"""Checkpoint a model or part of the model
 
@@ -150,6 +225,12 @@ def checkpoint(function, *args, **kwargs):
             first input as ``activation`` and the second input as ``hidden``
         preserve_rng_state(bool, optional, default=True):  Omit stashing and restoring
             the RNG state during each checkpoint.
+        use_reentrant(bool, optional, default=True): If ``False``, the
+            recomputation is driven by saved tensor hooks instead of a nested
+            backward call, see :class:`torch.autograd.graph.saved_tensors_hooks`.
+            This works with :func:`torch.autograd.grad`, with inputs that do
+            not require grad and with DistributedDataParallel, and only keeps
+            the recomputed activations alive while backward needs them.
         args: tuple containing inputs to the :attr:`function`
 
     Returns:
@@ -157,10 +238,14 @@ def checkpoint(function, *args, **kwargs):
     """
     # Hack to mix *args with **kwargs in a python 2.7-compliant way
     preserve = kwargs.pop('preserve_rng_state', True)
+    use_reentrant = kwargs.pop('use_reentrant', True)
     if kwargs:
         raise ValueError("Unexpected keyword arguments: " + ",".join(arg for arg in kwargs))
 
-    return CheckpointFunction.apply(function, preserve, *args)
+    if use_reentrant:
+        return CheckpointFunction.apply(function, preserve, *args)
+    else:
+        return _checkpoint_without_reentrant(function, preserve, *args)
 
 
 def checkpoint_sequential(functions, segments, input, **kwargs):
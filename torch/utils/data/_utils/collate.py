@@ -8,15 +8,19 @@ static methods.
 import torch
 import re
 from torch._six import container_abcs, string_classes, int_classes
+from torch.utils.arrow import from_arrow, is_arrow_data
 
 np_str_obj_array_pattern = re.compile(r'[SaUO]')
 
 
 def default_convert(data):
-    r"""Converts each NumPy array data field into a tensor"""
+    r"""Converts each NumPy array data field into a tensor, and each Arrow
+    array or record batch field into tensors sharing its memory"""
     elem_type = type(data)
     if isinstance(data, torch.Tensor):
         return data
+    elif is_arrow_data(data):
+        return from_arrow(data)
     elif elem_type.__module__ == 'numpy' and elem_type.__name__ != 'str_' \
             and elem_type.__name__ != 'string_':
         # array of string classes and object
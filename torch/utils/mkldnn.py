@@ -137,7 +137,80 @@ class MkldnnBatchNorm2d(torch.jit.ScriptModule):
         )
 
 
-def to_mkldnn(module):
+# Modules without children whose forward runs on mkldnn tensors, through the
+# MkldnnCPU kernels of the ops they call.
+_MKLDNN_LAYOUT_MODULES = (
+    torch.nn.ReLU,
+    torch.nn.ReLU6,
+    torch.nn.Hardtanh,
+    torch.nn.Sigmoid,
+    torch.nn.Tanh,
+    torch.nn.Softmax,
+    torch.nn.MaxPool2d,
+    torch.nn.AvgPool2d,
+    torch.nn.AdaptiveAvgPool2d,
+    torch.nn.Flatten,
+    torch.nn.Dropout,
+    torch.nn.Identity,
+)
+
+
+def _map_tensors(fn, x):
+    if isinstance(x, torch.Tensor):
+        return fn(x)
+    if isinstance(x, (list, tuple)):
+        return type(x)(_map_tensors(fn, elem) for elem in x)
+    return x
+
+
+def _tensor_to_mkldnn(x):
+    if not x.is_mkldnn and x.layout == torch.strided and x.dtype == torch.float:
+        return x.to_mkldnn()
+    return x
+
+
+def _tensor_to_dense(x):
+    return x.to_dense() if x.is_mkldnn else x
+
+
+class _MkldnnDenseFallback(torch.nn.Module):
+    r"""Runs a module that has no mkldnn support on dense tensors, and returns
+    its outputs as mkldnn tensors again."""
+
+    def __init__(self, module):
+        super(_MkldnnDenseFallback, self).__init__()
+        self.module = module
+
+    def forward(self, *inputs):
+        outputs = self.module(*_map_tensors(_tensor_to_dense, inputs))
+        return _map_tensors(_tensor_to_mkldnn, outputs)
+
+
+class _MkldnnLayoutPropagation(torch.nn.Module):
+    r"""Converts the inputs of a module to mkldnn tensors once, and its outputs
+    back to dense tensors once."""
+
+    def __init__(self, module):
+        super(_MkldnnLayoutPropagation, self).__init__()
+        self.module = module
+
+    def forward(self, *inputs):
+        outputs = self.module(*_map_tensors(_tensor_to_mkldnn, inputs))
+        return _map_tensors(_tensor_to_dense, outputs)
+
+
+def to_mkldnn(module, propagate_layout=False):
+    r"""Converts the Linear, Conv2d and BatchNorm2d submodules of ``module`` to
+    modules with mkldnn weights, for inference on mkldnn tensors.
+
+    With ``propagate_layout=True``, the returned module also takes and returns
+    dense tensors, and keeps the activations between its submodules as mkldnn
+    tensors wherever both the producer and the consumer support them: inputs
+    are converted to mkldnn once, outputs back to dense once, and every other
+    submodule without children that has no mkldnn support runs on dense
+    copies of its inputs. Other ops called directly in a ``forward`` still
+    need to support mkldnn tensors.
+    """
     def m_fn(m):
         if isinstance(m, torch.nn.Linear):
             return MkldnnLinear(m)
@@ -145,6 +218,9 @@ def to_mkldnn(module):
             return MkldnnConv2d(m)
         elif isinstance(m, torch.nn.BatchNorm2d):
             return MkldnnBatchNorm2d(m)
+        elif (propagate_layout and not isinstance(m, _MKLDNN_LAYOUT_MODULES) and
+              next(m.children(), None) is None):
+            return _MkldnnDenseFallback(m)
         else:
             return m
 
@@ -154,4 +230,6 @@ def to_mkldnn(module):
             setattr(new_m, name, m_fn_rec(sub_m))
         return new_m
 
+    if propagate_layout:
+        return _MkldnnLayoutPropagation(m_fn_rec(module))
     return m_fn_rec(module)